@@ -0,0 +1,17 @@
+# Find jemalloc
+# Once done this will define
+#  Jemalloc_FOUND - System has jemalloc
+#  JEMALLOC_INCLUDE_DIRS - The jemalloc include directories
+#  JEMALLOC_LIBRARIES - The libraries needed to use jemalloc
+
+if(JEMALLOC_INCLUDE_DIRS AND JEMALLOC_LIBRARIES)
+  set(Jemalloc_FIND_QUIETLY TRUE)
+endif()
+
+find_path(JEMALLOC_INCLUDE_DIRS jemalloc/jemalloc.h HINTS ${JEMALLOC_ROOT} PATH_SUFFIXES include)
+find_library(JEMALLOC_LIBRARIES NAMES jemalloc HINTS ${JEMALLOC_ROOT} PATH_SUFFIXES lib lib64)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Jemalloc DEFAULT_MSG JEMALLOC_LIBRARIES JEMALLOC_INCLUDE_DIRS)
+
+mark_as_advanced(JEMALLOC_INCLUDE_DIRS JEMALLOC_LIBRARIES)
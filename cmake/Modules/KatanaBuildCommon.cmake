@@ -21,6 +21,8 @@ endif ()
 ###### General features ######
 set(KATANA_ENABLE_PAPI OFF CACHE BOOL "Use PAPI counters for profiling")
 set(KATANA_ENABLE_VTUNE OFF CACHE BOOL "Use VTune for profiling")
+set(KATANA_ENABLE_JEMALLOC OFF CACHE BOOL "Link jemalloc and give the threads of each socket their own arena")
+set(KATANA_ENABLE_MPI OFF CACHE BOOL "Build the MPI communication backend")
 set(KATANA_STRICT_CONFIG OFF CACHE BOOL "Instead of falling back gracefully, fail")
 set(KATANA_GRAPH_LOCATION "" CACHE PATH "Location of inputs for tests if downloaded/stored separately.")
 set(CXX_CLANG_TIDY "" CACHE STRING "Semi-colon separated list of clang-tidy command and arguments")
@@ -226,6 +228,10 @@ if (KATANA_ENABLE_PAPI)
   add_definitions(-DKATANA_ENABLE_PAPI)
 endif ()
 
+if (KATANA_ENABLE_JEMALLOC)
+  find_package(Jemalloc REQUIRED)
+endif ()
+
 find_package(NUMA)
 
 find_package(Threads REQUIRED)
@@ -370,6 +376,7 @@ install(
     "${CMAKE_CURRENT_BINARY_DIR}/KatanaConfigVersion.cmake"
     "${CMAKE_CURRENT_BINARY_DIR}/KatanaConfig.cmake"
     "${CMAKE_CURRENT_LIST_DIR}/FindNUMA.cmake"
+    "${CMAKE_CURRENT_LIST_DIR}/FindJemalloc.cmake"
     DESTINATION "${CMAKE_INSTALL_LIBDIR}/cmake/Katana"
     COMPONENT dev
 )
@@ -9,6 +9,26 @@ if [[ ! -f CMakeCache.txt ]]; then
   exit 1
 fi
 
+# The benchmark suite runs against a fixed set of inputs; make sure they are
+# all part of the tarball.
+manifest="$(dirname "$0")/../lonestar/analytics/cpu/benchmark/inputs.json"
+python3 - "$manifest" inputs/current <<'PYEOF'
+import json
+import os
+import sys
+
+with open(sys.argv[1]) as f:
+    manifest = json.load(f)
+missing = [
+    path
+    for entry in manifest["inputs"]
+    for path in (entry["path"], entry.get("symmetric_path"))
+    if path and not os.path.exists(os.path.join(sys.argv[2], path))
+]
+if missing:
+    sys.exit("benchmark inputs missing from inputs/current: " + " ".join(missing))
+PYEOF
+
 cat<<EOF | tar czvf inputs.tar.gz --directory=inputs/current --owner=root --group=root --exclude-from=- .
 current-*
 extracted
@@ -0,0 +1,433 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+#define KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Chunk.h"
+#include "katana/FlatMap.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+
+namespace katana {
+
+/**
+ * Approximate priority scheduling whose bucket width changes at runtime, in
+ * the style of PMOD (Yesil et al., 2019). Indexer is as for
+ * OrderedByIntegerMetric but must return an integral priority.
+ *
+ * A bucket holds the priorities that only differ in their lowest shift bits,
+ * and threads work on the lowest bucket they know of. Every thread counts
+ * the items it pops from each bucket it visits. After kVisitsPerDecision
+ * visits, it merges buckets (increments shift) if the visits were on average
+ * too short to pay for moving between buckets, and splits buckets
+ * (decrements shift) if they were so long that priority order was mostly
+ * lost. Items already in the worklist stay in their bucket when shift
+ * changes; they are still popped, just in a coarser or finer order.
+ *
+ * If constructed with a region name, the worklist reports the number of
+ * buckets, a histogram of the work done per bucket and its changes of shift
+ * to the StatManager under that region when it is destroyed.
+ *
+ * An example:
+ * \code
+ * typedef katana::AdaptiveOrderedByIntegerMetric<Indexer> WL;
+ * katana::for_each(
+ *     katana::iterate(items), Fn, katana::wl<WL>(Indexer(), 4, "MyLoop"));
+ * \endcode
+ *
+ * @tparam Indexer        Indexer class
+ * @tparam Container      Scheduler for each bucket
+ * @tparam BlockPeriod    Check for higher priority work every 2^BlockPeriod
+ *                        iterations
+ * @tparam BSP            Use back-scan prevention
+ */
+template <
+    class Indexer = DummyIndexer<int>,
+    typename Container = PerSocketChunkFIFO<>, unsigned BlockPeriod = 0,
+    bool BSP = true, typename T = int, typename Index = int,
+    bool Concurrent = true>
+struct AdaptiveOrderedByIntegerMetric : private boost::noncopyable {
+  static_assert(
+      std::is_integral<Index>::value, "only integral index types supported");
+
+  template <typename _T>
+  using retype = AdaptiveOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, BlockPeriod, BSP, _T,
+      typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread = AdaptiveOrderedByIntegerMetric<
+      Indexer, Container, BlockPeriod, BSP, T, Index, _b>;
+
+  template <unsigned _period>
+  struct with_block_period {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, Container, _period, BSP, T, Index, Concurrent>
+        type;
+  };
+
+  template <typename _container>
+  struct with_container {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, _container, BlockPeriod, BSP, T, Index, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef AdaptiveOrderedByIntegerMetric<
+        _indexer, Container, BlockPeriod, BSP, T, Index, Concurrent>
+        type;
+  };
+
+  template <bool _bsp>
+  struct with_back_scan_prevention {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, Container, BlockPeriod, _bsp, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+  //! Number of bucket visits by a thread between changes of shift
+  static constexpr unsigned kVisitsPerDecision = 16;
+  //! Merge buckets if a thread pops fewer items per visit than this
+  static constexpr uint64_t kMinWorkPerVisit = 64;
+  //! Split buckets if a thread pops more items per visit than this
+  static constexpr uint64_t kMaxWorkPerVisit = 64 * kMinWorkPerVisit;
+  static constexpr unsigned kMaxShift = 8 * sizeof(Index) - 2;
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+  typedef std::make_unsigned_t<Index> UIndex;
+
+  struct Bucket {
+    CTy container;
+    //! Items popped from this bucket, added when a thread leaves it
+    std::atomic<uint64_t> work{0};
+  };
+
+  typedef katana::flat_map<Index, Bucket*, std::less<Index>> LMapTy;
+
+  struct ThreadData {
+    LMapTy local;
+    Index curIndex;
+    Index scanStart;
+    Bucket* current;
+    unsigned int lastMasterVersion;
+    unsigned int numPops;
+    //! Items popped from current since this thread entered it
+    uint64_t bucketWork;
+    //! Items popped and buckets visited since the last decision
+    uint64_t windowWork;
+    unsigned windowVisits;
+    //! The shift when the window began; the window is dropped if another
+    //! thread changes the shift first
+    unsigned windowShift;
+
+    ThreadData(Index initial, unsigned shift)
+        : curIndex(initial),
+          scanStart(initial),
+          current(nullptr),
+          lastMasterVersion(0),
+          numPops(0),
+          bucketWork(0),
+          windowWork(0),
+          windowVisits(0),
+          windowShift(shift) {}
+  };
+
+  typedef std::deque<std::pair<Index, Bucket*>> MasterLog;
+
+  // NB: Place dynamically growing masterLog after fixed-size PerThreadStorage
+  // members to give higher likelihood of reclaiming PerThreadStorage
+  PerThreadStorage<ThreadData> data;
+  PaddedLock<Concurrent> masterLock;
+  MasterLog masterLog;
+
+  std::atomic<unsigned int> masterVersion;
+  Indexer indexer;
+
+  std::atomic<unsigned> shift_;
+  std::atomic<uint64_t> merges_{0};
+  std::atomic<uint64_t> splits_{0};
+  unsigned initialShift_;
+  const char* region_;
+
+  /// The lowest priority in the bucket of priority i under the current shift
+  Index BucketOf(Index i) const {
+    unsigned s = shift_.load(std::memory_order_relaxed);
+    UIndex mask = ~((UIndex{1} << s) - 1);
+    return static_cast<Index>(static_cast<UIndex>(i) & mask);
+  }
+
+  /// Ends the visit of the thread to its current bucket and, at the end of
+  /// a window, merges or splits buckets
+  void Leave(ThreadData& p) {
+    if (!p.current) {
+      return;
+    }
+    p.current->work.fetch_add(p.bucketWork, std::memory_order_relaxed);
+    p.windowWork += p.bucketWork;
+    p.bucketWork = 0;
+    if (++p.windowVisits < kVisitsPerDecision) {
+      return;
+    }
+
+    uint64_t mean = p.windowWork / p.windowVisits;
+    unsigned s = p.windowShift;
+    p.windowWork = 0;
+    p.windowVisits = 0;
+    if (mean < kMinWorkPerVisit && s < kMaxShift) {
+      if (shift_.compare_exchange_strong(s, s + 1)) {
+        merges_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else if (mean > kMaxWorkPerVisit && s > 0) {
+      if (shift_.compare_exchange_strong(s, s - 1)) {
+        splits_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    p.windowShift = shift_.load(std::memory_order_relaxed);
+  }
+
+  void MoveTo(ThreadData& p, Index i, Bucket* b) {
+    if (b != p.current) {
+      Leave(p);
+      p.current = b;
+    }
+    p.curIndex = i;
+  }
+
+  bool updateLocal(ThreadData& p) {
+    if (p.lastMasterVersion != masterVersion.load(std::memory_order_relaxed)) {
+      for (;
+           p.lastMasterVersion < masterVersion.load(std::memory_order_relaxed);
+           ++p.lastMasterVersion) {
+        std::pair<Index, Bucket*> logEntry = masterLog[p.lastMasterVersion];
+        p.local[logEntry.first] = logEntry.second;
+        KATANA_LOG_DEBUG_ASSERT(logEntry.second);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<T> slowPop(ThreadData& p) {
+    Index msS = std::numeric_limits<Index>::min();
+
+    updateLocal(p);
+
+    if (BSP) {
+      msS = p.scanStart;
+      if (ThreadPool::isLeader()) {
+        for (unsigned i = 0; i < getActiveThreads(); ++i) {
+          msS = std::min(msS, data.getRemote(i)->scanStart);
+        }
+      } else {
+        msS = std::min(
+            msS, data.getRemote(ThreadPool::getLeader())->scanStart);
+      }
+    }
+
+    for (auto ii = p.local.lower_bound(msS), ei = p.local.end(); ii != ei;
+         ++ii) {
+      std::optional<T> item;
+      if ((item = ii->second->container.pop())) {
+        MoveTo(p, ii->first, ii->second);
+        p.scanStart = ii->first;
+        ++p.bucketWork;
+        return item;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Bucket* slowUpdateLocalOrCreate(ThreadData& p, Index i) {
+    // update local until we find it or we get the write lock
+    do {
+      updateLocal(p);
+      auto it = p.local.find(i);
+      if (it != p.local.end())
+        return it->second;
+    } while (!masterLock.try_lock());
+    // we have the write lock, update again then create
+    updateLocal(p);
+    auto it = p.local.find(i);
+    Bucket* b = (it != p.local.end()) ? it->second : nullptr;
+    if (!b) {
+      b = new Bucket();
+      p.local[i] = b;
+      p.lastMasterVersion = masterVersion.load(std::memory_order_relaxed) + 1;
+      masterLog.push_back(std::make_pair(i, b));
+      masterVersion.fetch_add(1);
+    }
+    masterLock.unlock();
+    return b;
+  }
+
+  inline Bucket* updateLocalOrCreate(ThreadData& p, Index i) {
+    auto it = p.local.find(i);
+    if (it != p.local.end())
+      return it->second;
+    return slowUpdateLocalOrCreate(p, i);
+  }
+
+  void ReportStats() {
+    // Work popped from the bucket a thread was in when the loop ended has
+    // not been added to the bucket yet
+    for (unsigned i = 0; i < data.size(); ++i) {
+      ThreadData& p = *data.getRemote(i);
+      if (p.current) {
+        p.current->work.fetch_add(p.bucketWork, std::memory_order_relaxed);
+        p.bucketWork = 0;
+      }
+    }
+
+    // Buckets by the log2 of the number of items popped from them
+    std::vector<uint64_t> histogram;
+    uint64_t total_work = 0;
+    uint64_t max_work = 0;
+    for (const auto& entry : masterLog) {
+      uint64_t work = entry.second->work.load(std::memory_order_relaxed);
+      total_work += work;
+      max_work = std::max(max_work, work);
+      size_t log_work = 0;
+      while ((work >> log_work) > 1) {
+        ++log_work;
+      }
+      if (histogram.size() <= log_work) {
+        histogram.resize(log_work + 1);
+      }
+      histogram[log_work] += 1;
+    }
+
+    std::string region(region_);
+    ReportStatSingle(region, "Buckets", masterLog.size());
+    ReportStatSingle(region, "BucketWorkTotal", total_work);
+    ReportStatSingle(region, "BucketWorkMax", max_work);
+    for (size_t i = 0; i < histogram.size(); ++i) {
+      ReportStatSingle(
+          region, "BucketsWithWorkBelow2^" + std::to_string(i + 1),
+          histogram[i]);
+    }
+    ReportStatSingle(region, "InitialShift", initialShift_);
+    ReportStatSingle(region, "FinalShift", shift());
+    ReportStatSingle(region, "Merges", num_merges());
+    ReportStatSingle(region, "Splits", num_splits());
+  }
+
+public:
+  /**
+   * @param x             The indexer
+   * @param initial_shift Buckets initially hold 2^initial_shift priorities
+   * @param region        If not null, the region under which to report
+   *                      statistics when destroyed
+   */
+  AdaptiveOrderedByIntegerMetric(
+      const Indexer& x = Indexer(), unsigned initial_shift = 0,
+      const char* region = nullptr)
+      : data(
+            std::numeric_limits<Index>::min(),
+            std::min(initial_shift, kMaxShift)),
+        masterVersion(0),
+        indexer(x),
+        shift_(std::min(initial_shift, kMaxShift)),
+        initialShift_(shift_.load()),
+        region_(region) {}
+
+  ~AdaptiveOrderedByIntegerMetric() {
+    if (region_) {
+      ReportStats();
+    }
+    // Deallocate in LIFO order to give opportunity for simple garbage
+    // collection
+    for (auto ii = masterLog.rbegin(), ei = masterLog.rend(); ii != ei; ++ii) {
+      delete ii->second;
+    }
+  }
+
+  /// Buckets currently hold 2^shift() priorities
+  unsigned shift() const { return shift_.load(std::memory_order_relaxed); }
+
+  uint64_t num_merges() const {
+    return merges_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t num_splits() const {
+    return splits_.load(std::memory_order_relaxed);
+  }
+
+  /// The number of buckets created so far
+  size_t num_buckets() const {
+    return masterVersion.load(std::memory_order_relaxed);
+  }
+
+  void push(const value_type& val) {
+    Index index = BucketOf(indexer(val));
+    ThreadData& p = *data.getLocal();
+
+    // Fast path
+    if (index == p.curIndex && p.current) {
+      p.current->container.push(val);
+      return;
+    }
+
+    // Slow path
+    Bucket* b = updateLocalOrCreate(p, index);
+    if (BSP && index < p.scanStart)
+      p.scanStart = index;
+    // Opportunistically move to higher priority work
+    if (index < p.curIndex) {
+      MoveTo(p, index, b);
+    }
+    b->container.push(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    Bucket* b = p.current;
+
+    if (BlockPeriod && ((p.numPops++ & ((1 << BlockPeriod) - 1)) == 0))
+      return slowPop(p);
+
+    std::optional<value_type> item;
+    if (b && (item = b->container.pop())) {
+      ++p.bucketWork;
+      return item;
+    }
+
+    // Slow path
+    return slowPop(p);
+  }
+};
+KATANA_WLCOMPILECHECK(AdaptiveOrderedByIntegerMetric)
+
+}  // end namespace katana
+
+#endif
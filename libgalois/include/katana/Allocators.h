@@ -36,14 +36,13 @@
 #include "katana/PerThreadStorage.h"
 #include "katana/PtrLock.h"
 #include "katana/SimpleLock.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 
 // TODO(ddn): Merge with Mem.h. Users should not include this file directly.
 
 namespace katana {
 
-extern unsigned activeThreads;
-
 //! Forces the given block to be paged into physical memory
 KATANA_EXPORT void pageIn(void* buf, size_t len, size_t stride);
 
@@ -484,6 +483,96 @@ public:
   inline void deallocate(void*) {}
 };
 
+/**
+ * A bump pointer heap for temporaries that are released together, e.g., the
+ * containers built by one iteration of a parallel loop. Allocations come
+ * from blocks of SourceHeap, or from malloc when they do not fit in a block.
+ * deallocate does nothing; instead, rewind releases everything allocated
+ * after a mark, returning blocks to SourceHeap.
+ */
+template <typename SourceHeap>
+class ArenaHeap : public SourceHeap {
+public:
+  struct Block {
+    Block* next;
+  };
+
+  //! State of the heap to rewind to
+  struct Mark {
+    Block* head;
+    Block* largeHead;
+    size_t offset;
+  };
+
+private:
+  enum {
+    Align = alignof(std::max_align_t),
+    HeaderSize = (sizeof(Block) + Align - 1) & ~(Align - 1)
+  };
+
+  //! Blocks from SourceHeap, current block first
+  Block* head;
+  //! Allocations from malloc, latest first
+  Block* largeHead;
+  size_t offset;
+
+  static void push(void* p, Block*& h) {
+    Block* BP = static_cast<Block*>(p);
+    BP->next = h;
+    h = BP;
+  }
+
+public:
+  enum { AllocSize = 0 };
+
+  ArenaHeap() : SourceHeap(), head(0), largeHead(0), offset(0) {}
+
+  ~ArenaHeap() { clear(); }
+
+  ArenaHeap(const ArenaHeap&) = delete;
+  ArenaHeap& operator=(const ArenaHeap&) = delete;
+
+  inline void* allocate(size_t size) {
+    size_t alignedSize = (size + Align - 1) & ~size_t(Align - 1);
+    if (HeaderSize + alignedSize > SourceHeap::AllocSize) {
+      void* p = malloc(HeaderSize + alignedSize);
+      if (!p) {
+        throw std::bad_alloc();
+      }
+      push(p, largeHead);
+      return static_cast<char*>(p) + HeaderSize;
+    }
+    if (!head || offset + alignedSize > SourceHeap::AllocSize) {
+      push(SourceHeap::allocate(SourceHeap::AllocSize), head);
+      offset = HeaderSize;
+    }
+    char* retval = reinterpret_cast<char*>(head) + offset;
+    offset += alignedSize;
+    return retval;
+  }
+
+  inline void deallocate(void*) {}
+
+  Mark mark() const { return Mark{head, largeHead, offset}; }
+
+  //! Release everything allocated since m was taken
+  void rewind(const Mark& m) {
+    while (head != m.head) {
+      Block* B = head;
+      head = B->next;
+      SourceHeap::deallocate(B);
+    }
+    while (largeHead != m.largeHead) {
+      Block* B = largeHead;
+      largeHead = B->next;
+      free(B);
+    }
+    offset = m.offset;
+  }
+
+  void clear() { rewind(Mark{nullptr, nullptr, 0}); }
+};
+
 //! This is the base source of memory for all allocators.
 //! It maintains a freelist of chunks acquired from the system
 class KATANA_EXPORT SystemHeap {
@@ -641,7 +730,7 @@ public:
   enum { AllocSize = 0 };
 
   void* allocate(size_t size) {
-    auto ptr = largeMallocInterleaved(size + offset, activeThreads);
+    auto ptr = largeMallocInterleaved(size + offset, getActiveThreads());
     LAptr* header = new ((char*)ptr.get()) LAptr{std::move(ptr)};
     return (char*)(header->get()) + offset;
   }
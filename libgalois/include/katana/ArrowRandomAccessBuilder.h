@@ -3,6 +3,7 @@
 #include "katana/ErrorCode.h"
 #include "katana/LargeArray.h"
 #include "katana/Logging.h"
+#include "katana/MappedArray.h"
 #include "katana/Properties.h"
 #include "katana/Result.h"
 
@@ -10,7 +11,15 @@ namespace katana {
 
 namespace {
 
-/// NoNullBuilder uses std::vector for storage
+/// Builders keep fixed size values in a MappedArray, whose pages are zero
+/// until written and only committed then, so that a large builder that is
+/// filled sparsely or late costs no upfront initialization
+template <typename StorageType>
+using BuilderStorage = std::conditional_t<
+    std::is_trivially_copyable_v<StorageType>, MappedArray<StorageType>,
+    std::vector<StorageType>>;
+
+/// NoNullBuilder uses BuilderStorage for storage
 /// Finalize() makes a copy of the data
 /// Does not support null values
 template <typename ValueType, typename StorageType, typename ArrowType>
@@ -36,7 +45,7 @@ public:
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
     ArrowBuilder builder;
     if (data_.size() > 0) {
-      if (auto r = builder.AppendValues(data_); !r.ok()) {
+      if (auto r = builder.AppendValues(data_.data(), data_.size()); !r.ok()) {
         KATANA_LOG_DEBUG("arrow error: {}", r);
         return katana::ErrorCode::ArrowError;
       }
@@ -50,10 +59,10 @@ public:
   }
 
 private:
-  std::vector<StorageType> data_;
+  BuilderStorage<StorageType> data_;
 };
 
-/// NullableBuilder uses std::vector for storage
+/// NullableBuilder uses BuilderStorage for storage
 /// Finalize() makes a copy of the data
 /// Supports null values
 template <typename ValueType, typename StorageType, typename ArrowType>
@@ -62,7 +71,7 @@ public:
   using value_type = ValueType;
   using reference = ValueType&;
 
-  NullableBuilder(size_t length) : data_(length), valid_(length, false) {
+  NullableBuilder(size_t length) : data_(length), valid_(length) {
     static_assert(sizeof(ValueType) == sizeof(StorageType));
   }
 
@@ -114,8 +123,8 @@ public:
   }
 
 private:
-  std::vector<StorageType> data_;
-  std::vector<uint8_t> valid_;
+  BuilderStorage<StorageType> data_;
+  MappedArray<uint8_t> valid_;
 };
 
 template <typename ArrowType>
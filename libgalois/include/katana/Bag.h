@@ -21,7 +21,11 @@
 #define KATANA_LIBGALOIS_KATANA_BAG_H_
 
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
@@ -34,6 +38,9 @@
 
 namespace katana {
 
+template <typename T>
+class LargeArray;
+
 /**
  * Unordered collection of elements. This data structure supports scalable
  * concurrent pushes but reading the bag can only be done serially.
@@ -50,6 +57,18 @@ class InsertBag {
   typedef std::pair<header*, header*> PerThread;
 
 public:
+  /**
+   * A contiguous run of elements of the bag, all pushed by the same thread.
+   */
+  struct Chunk {
+    T* first;
+    T* last;
+
+    T* begin() const { return first; }
+    T* end() const { return last; }
+    size_t size() const { return last - first; }
+  };
+
   template <typename U>
   class Iterator : public boost::iterator_facade<
                        Iterator<U>, U, boost::forward_traversal_tag> {
@@ -156,6 +175,34 @@ private:
     }
   }
 
+  /**
+   * Call fn(x) for each per-thread list x of elements on some active
+   * thread, the thread that pushed to x when it is still active.
+   */
+  template <typename FunctionTy>
+  void on_each_list(FunctionTy fn) const {
+    katana::on_each_gen(
+        [&](const unsigned int tid, const unsigned int num_threads) {
+          for (unsigned x = tid; x < heads.size(); x += num_threads) {
+            fn(x);
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+  }
+
+  //! The number of elements in each per-thread list, counted in parallel
+  std::vector<size_t> list_sizes() const {
+    std::vector<size_t> sizes(heads.size());
+    on_each_list([&](unsigned x) {
+      size_t size = 0;
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        size += h->dend - h->dbegin;
+      }
+      sizes[x] = size;
+    });
+    return sizes;
+  }
+
   void destruct_serial() {
     for (unsigned x = 0; x < heads.size(); ++x) {
       PerThread& hpair = *heads.getRemote(x);
@@ -252,6 +299,70 @@ public:
     }
     return true;
   }
+
+  //! Number of elements in the bag
+  size_t size() const {
+    size_t total = 0;
+    for (size_t size : list_sizes()) {
+      total += size;
+    }
+    return total;
+  }
+
+  /**
+   * The elements of the bag as contiguous runs of at most max_size
+   * elements, which can be iterated with do_all to visit the bag with work
+   * stealing instead of one thread per list of pushes:
+   *
+   *   auto chunks = bag.Chunks(64);
+   *   katana::do_all(katana::iterate(chunks), [&](auto chunk) {
+   *     for (auto& v : chunk) { ... }
+   *   }, katana::steal());
+   *
+   * Listing the chunks is serial but takes one step per chunk rather than
+   * per element.
+   */
+  std::vector<Chunk> Chunks(
+      size_t max_size = std::numeric_limits<size_t>::max()) {
+    std::vector<Chunk> ret;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        for (T* first = h->dbegin; first != h->dend;) {
+          T* last = first + std::min<size_t>(max_size, h->dend - first);
+          ret.emplace_back(Chunk{first, last});
+          first = last;
+        }
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * Copy the elements of the bag into a new array, in the order of
+   * iteration. Each thread sizes its own list of elements, a prefix sum of
+   * the sizes gives the offset of each list, and each thread then copies
+   * its list to its offset.
+   *
+   * Callers must include katana/LargeArray.h.
+   */
+  LargeArray<T> Flatten() const {
+    std::vector<size_t> offsets = list_sizes();
+    size_t total = 0;
+    for (size_t& offset : offsets) {
+      total += std::exchange(offset, total);
+    }
+
+    LargeArray<T> ret;
+    ret.allocateBlocked(total);
+    on_each_list([&](unsigned x) {
+      T* out = ret.data() + offsets[x];
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        out = std::uninitialized_copy(h->dbegin, h->dend, out);
+      }
+    });
+    return ret;
+  }
+
   //! Thread safe bag insertion
   template <typename... Args>
   reference emplace(Args&&... args) {
@@ -22,6 +22,7 @@
 
 #include <memory>
 
+#include "katana/Trace.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -39,10 +40,16 @@ public:
   virtual void Reinit(unsigned val) = 0;
 
   // Wait at this barrier
-  virtual void Wait() = 0;
+  void Wait() {
+    TraceSpan span("barrier", "wait");
+    DoWait();
+  }
 
   // barrier type.
   virtual const char* name() const = 0;
+
+private:
+  virtual void DoWait() = 0;
 };
 
 /**
@@ -69,6 +76,16 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateMCSBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateTopoBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateCountingBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateDisseminationBarrier(unsigned);
+KATANA_EXPORT std::unique_ptr<Barrier> CreateHierarchicalBarrier(unsigned);
+
+/**
+ * Creates the barrier best suited to the machine the thread pool runs on.
+ * A single counter is cheapest when few threads share one socket; beyond
+ * that, a combining tree of socket-local counters keeps most of the traffic
+ * within each socket. The KATANA_BARRIER environment variable overrides the
+ * choice. GetBarrier() returns a barrier created this way.
+ */
+KATANA_EXPORT std::unique_ptr<Barrier> CreateBarrier(unsigned);
 
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
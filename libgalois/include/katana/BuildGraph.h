@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <variant>
@@ -14,6 +15,7 @@
 #include <arrow/stl.h>
 #include <arrow/type.h>
 
+#include "katana/MappedArray.h"
 #include "katana/PropertyGraph.h"
 
 namespace katana {
@@ -112,14 +114,17 @@ struct LabelsState {
 struct TopologyState {
   // maps node IDs to node indexes
   std::unordered_map<std::string, size_t> node_indexes;
+  // The arrays below grow with the input; MappedArray grows them without
+  // copying
+
   // node's start of edge lists
-  std::vector<uint64_t> out_indices;
+  MappedArray<uint64_t> out_indices;
   // edge list of destinations
-  std::vector<uint32_t> out_dests;
+  MappedArray<uint32_t> out_dests;
   // list of sources of edges
-  std::vector<uint32_t> sources;
+  MappedArray<uint32_t> sources;
   // list of destinations of edges
-  std::vector<uint32_t> destinations;
+  MappedArray<uint32_t> destinations;
 
   // for schema mapping
   std::unordered_set<std::string> edge_ids;
@@ -226,6 +231,62 @@ private:
   GraphComponent BuildFinalEdges(bool verbose);
 };
 
+/// A builder for graphs whose elements are added from many threads at once.
+///
+/// Unlike PropertyGraphBuilder, which keeps one element in progress, each
+/// call adds a whole node or edge with its property values and labels, so
+/// AddNode and AddEdge may be called concurrently from katana threads (e.g.,
+/// inside katana::do_all). Each thread appends to its own buffers and string
+/// node IDs go into a sharded hash map. Properties and labels are declared
+/// up front with AddBuilder and AddLabelBuilder, which may not be called
+/// concurrently with anything else.
+///
+/// Finish resolves edge endpoints in parallel, so edges may be added before
+/// their nodes; endpoints that were never added become placeholder nodes as
+/// in PropertyGraphBuilder. Nodes are numbered by thread and then by order
+/// of addition within a thread, followed by the placeholders that thread
+/// created. The edges of a node are ordered the same way, so one thread
+/// adding nodes before their edges builds the same graph as
+/// PropertyGraphBuilder.
+class KATANA_EXPORT ParallelPropertyGraphBuilder {
+public:
+  using PropertyValues = std::vector<std::pair<size_t, ImportData>>;
+  using Labels = std::vector<size_t>;
+
+  ParallelPropertyGraphBuilder();
+  ~ParallelPropertyGraphBuilder();
+
+  /// Declare a node property if key.for_node and an edge property
+  /// otherwise. Returns the index by which values refer to it. List
+  /// properties are not supported.
+  Result<size_t> AddBuilder(const PropertyKey& key);
+  /// Declare a node label if rule.for_node and an edge type otherwise.
+  /// Returns the index by which elements refer to it.
+  size_t AddLabelBuilder(const LabelRule& rule);
+
+  /// Add a node. Returns false, adding nothing, if a node with id was
+  /// already added.
+  bool AddNode(
+      const std::string& id, const PropertyValues& values = {},
+      const Labels& labels = {});
+  /// Add an edge between the nodes with IDs source and target
+  void AddEdge(
+      const std::string& source, const std::string& target,
+      const PropertyValues& values = {}, const Labels& types = {});
+
+  /// Build the graph. The builder is left empty.
+  Result<GraphComponents> Finish();
+
+  /// The number of nodes and edges added so far, not counting
+  /// placeholders; may not be called concurrently with AddNode or AddEdge
+  size_t GetNodes() const;
+  size_t GetEdges() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 KATANA_EXPORT katana::PropertyGraph ConvertKatana(
     const std::string& input_filename);
 
@@ -242,6 +303,10 @@ KATANA_EXPORT std::vector<ImportData> ArrowToImport(
 KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> ImportToArrow(
     arrow::Type::type arrow_type, const std::vector<ImportData>& import_src);
 
+/// The type of the arrow arrays ImportToArrow builds for key's values; lists
+/// are not supported
+KATANA_EXPORT Result<arrow::Type::type> ArrowTypeOf(const PropertyKey& key);
+
 }  // namespace katana
 
 #endif
@@ -24,6 +24,7 @@
 
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
+#include "katana/Threads.h"
 #include "katana/WLCompileCheck.h"
 #include "katana/config.h"
 
@@ -33,6 +34,12 @@ namespace katana {
  * Bulk-synchronous scheduling. Work is processed in rounds, and all newly
  * created work is processed after all the current work in a round is
  * completed.
+ *
+ * Rounds are always kept in queues of work items. Level synchronous graph
+ * algorithms whose work items are nodes should use katana::Frontier and
+ * SynchronousFrontierLoop (Frontier.h) instead, which switch a round to a
+ * dense bitmap of nodes once it holds a large fraction of them and can pull
+ * into dense rounds instead of pushing.
  */
 template <
     class Container = PerSocketChunkFIFO<>, class T = int,
@@ -67,7 +74,7 @@ public:
   typedef T value_type;
 
   BulkSynchronous()
-      : barrier(GetBarrier(activeThreads)), some(false), isEmpty(false) {}
+      : barrier(GetBarrier(getActiveThreads())), some(false), isEmpty(false) {}
 
   void push(const value_type& val) {
     wls[(tlds.getLocal()->round + 1) & 1].push(val);
@@ -0,0 +1,47 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CANCEL_H_
+#define KATANA_LIBGALOIS_KATANA_CANCEL_H_
+
+#include <atomic>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CancelFlag asks a running analytic to stop early. Analytics poll the
+/// flag installed on the thread that called them (see CancelScope) between
+/// rounds, so they stop within one round of Cancel, and return
+/// ErrorCode::Cancelled. The properties they write are then incomplete.
+class KATANA_EXPORT CancelFlag {
+public:
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  void Reset() { cancelled_.store(false, std::memory_order_relaxed); }
+  bool IsCancelled() const {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> cancelled_{false};
+};
+
+/// Installs a CancelFlag on the calling thread for the lifetime of the scope.
+/// Scopes nest; the innermost flag is the one that CancelRequested checks.
+class KATANA_EXPORT CancelScope {
+public:
+  explicit CancelScope(const CancelFlag* flag);
+  ~CancelScope();
+
+  CancelScope(const CancelScope&) = delete;
+  CancelScope& operator=(const CancelScope&) = delete;
+  CancelScope(CancelScope&&) = delete;
+  CancelScope& operator=(CancelScope&&) = delete;
+
+private:
+  const CancelFlag* prev_;
+};
+
+/// Return true if the flag installed on the calling thread was cancelled
+KATANA_EXPORT bool CancelRequested();
+
+}  // namespace katana
+
+#endif
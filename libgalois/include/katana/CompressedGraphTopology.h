@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPRESSEDGRAPHTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_COMPRESSEDGRAPHTOPOLOGY_H_
+
+#include <memory>
+
+#include <arrow/buffer.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/CompressedCSRTopology.h"
+
+namespace katana {
+
+/// A read-only graph topology whose edge destinations stay compressed in
+/// memory (see tsuba/CompressedCSRTopology.h for the format) and are decoded
+/// while iterating over the edges of a node.
+///
+/// Edge ids are the same as in the GraphTopology the compressed topology was
+/// made from, so edge properties can be looked up with the ids from edges().
+/// Use OutDests() to get the destinations. Destinations can only be visited
+/// in order; there is no random access by edge id.
+class KATANA_EXPORT CompressedGraphTopology {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using node_iterator = GraphTopology::node_iterator;
+  using edge_iterator = GraphTopology::edge_iterator;
+  using nodes_range = GraphTopology::nodes_range;
+  using edges_range = GraphTopology::edges_range;
+  using iterator = node_iterator;
+  using dest_iterator = tsuba::CompressedDestIterator;
+  using dests_range = StandardRange<dest_iterator>;
+
+  CompressedGraphTopology() = default;
+
+  /// Compress topology with the given encoding.
+  static Result<CompressedGraphTopology> Make(
+      const GraphTopology& topology, tsuba::TopologyEncoding encoding,
+      uint64_t nodes_per_block = tsuba::kDefaultNodesPerBlock);
+
+  /// Make a compressed topology from the contents of a compressed CSR
+  /// topology file. The buffer is kept alive by the topology.
+  static Result<CompressedGraphTopology> Make(
+      std::shared_ptr<arrow::Buffer> buffer);
+
+  /// Decode the whole topology into a GraphTopology.
+  Result<GraphTopology> Decompress() const;
+
+  uint64_t num_nodes() const { return view_.num_nodes(); }
+  uint64_t num_edges() const { return view_.num_edges(); }
+  tsuba::TopologyEncoding encoding() const { return view_.encoding(); }
+
+  /// Return the number of bytes of the encoded topology, including its
+  /// index and header
+  uint64_t size_bytes() const { return buffer_ ? buffer_->size() : 0; }
+
+  /// Return the encoded topology in the compressed CSR file format
+  const std::shared_ptr<arrow::Buffer>& buffer() const { return buffer_; }
+
+  edges_range edges(Node node) const {
+    auto [begin_edge, end_edge] = view_.edge_range(node);
+    return MakeStandardRange<edge_iterator>(begin_edge, end_edge);
+  }
+
+  /// Gets the destinations of the edges of some node, in edge order.
+  dests_range OutDests(Node node) const {
+    auto [begin, end] = view_.dests(node);
+    return MakeStandardRange(begin, end);
+  }
+
+  uint64_t degree(Node node) const { return view_.degree(node); }
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(num_nodes()); }
+
+  size_t size() const { return num_nodes(); }
+
+  bool empty() const { return num_nodes() == 0; }
+
+private:
+  CompressedGraphTopology(
+      std::shared_ptr<arrow::Buffer> buffer,
+      const tsuba::CompressedCSRTopologyView& view)
+      : buffer_(std::move(buffer)), view_(view) {}
+
+  std::shared_ptr<arrow::Buffer> buffer_;
+  tsuba::CompressedCSRTopologyView view_;
+};
+
+}  // namespace katana
+
+#endif
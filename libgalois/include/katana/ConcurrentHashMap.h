@@ -0,0 +1,295 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Mixes the bits of integer keys so that consecutive IDs, as node and
+/// community IDs often are, do not fill consecutive slots of a table
+template <typename Key>
+struct IntegerHash {
+  size_t operator()(Key key) const {
+    // Finalizer of MurmurHash3
+    uint64_t h = static_cast<uint64_t>(key);
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+  }
+};
+
+/// A lock-free map from integer keys to values that many threads can update
+/// at once, for aggregating values keyed by node or community ID.
+///
+/// The table is open addressed with linear probing and has a fixed capacity
+/// chosen at construction; it does not grow. Each slot holds an atomic key
+/// and an atomic value, so Value must be trivially copyable (e.g., an
+/// integer or floating point number). A slot is claimed by swapping its key
+/// from the empty key, which is the maximum value of Key and cannot be used
+/// as a key, and keys are never removed except by Clear.
+///
+/// Values start as the identity given at construction, and Update combines
+/// a new value into the value of a key with a merge function, as with
+/// Reducible, so that the result does not depend on the order of updates as
+/// long as merge is associative and commutative.
+template <typename Key, typename Value, typename Hash = IntegerHash<Key>>
+class ConcurrentHashMap {
+  static_assert(std::is_integral_v<Key>);
+  static_assert(std::is_trivially_copyable_v<Value>);
+
+public:
+  static constexpr Key kEmptyKey = std::numeric_limits<Key>::max();
+
+  /// Make a map that can hold at least max_keys keys. The table has twice
+  /// as many slots, rounded up to a power of two, to keep probes short.
+  explicit ConcurrentHashMap(size_t max_keys, Value identity = Value{})
+      : identity_(identity) {
+    size_t capacity = 2;
+    while (capacity < 2 * max_keys) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_.allocateInterleaved(capacity);
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity),
+        [&](size_t i) { slots_.constructAt(i, kEmptyKey, identity_); },
+        katana::no_stats());
+  }
+
+  ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+  /// Set the value of key to merge(value of key, value), adding key with
+  /// the identity value if it is not in the map.
+  ///
+  /// \return false if key is not in the map and the map is full
+  template <typename MergeFn>
+  bool Update(Key key, const Value& value, MergeFn merge) {
+    KATANA_LOG_DEBUG_ASSERT(key != kEmptyKey);
+    Slot* slot = Claim(key);
+    if (slot == nullptr) {
+      return false;
+    }
+    Value old_value = slot->value.load(std::memory_order_relaxed);
+    while (!slot->value.compare_exchange_weak(
+        old_value, merge(old_value, value), std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  /// Return the value of key, if it is in the map. While other threads
+  /// update key, the value may not include their updates yet.
+  std::optional<Value> Find(Key key) const {
+    for (size_t i = 0, s = Home(key); i <= mask_; ++i, s = (s + 1) & mask_) {
+      Key k = slots_[s].key.load(std::memory_order_acquire);
+      if (k == key) {
+        return slots_[s].value.load(std::memory_order_relaxed);
+      }
+      if (k == kEmptyKey) {
+        return std::nullopt;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Call fn(key, value) for each key in the map, in parallel unless
+  /// parallel is false. It should not run while the map is updated.
+  template <typename F>
+  void ForEach(F fn, bool parallel = true) const {
+    auto visit = [&](size_t s) {
+      Key k = slots_[s].key.load(std::memory_order_relaxed);
+      if (k != kEmptyKey) {
+        fn(k, slots_[s].value.load(std::memory_order_relaxed));
+      }
+    };
+    if (parallel) {
+      katana::do_all(
+          katana::iterate(size_t{0}, capacity()), visit, katana::no_stats());
+    } else {
+      for (size_t s = 0; s < capacity(); ++s) {
+        visit(s);
+      }
+    }
+  }
+
+  /// Remove all keys. This should not run while the map is used.
+  void Clear() {
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity()),
+        [&](size_t s) {
+          slots_[s].key.store(kEmptyKey, std::memory_order_relaxed);
+          slots_[s].value.store(identity_, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    size_.store(0, std::memory_order_relaxed);
+  }
+
+  /// The number of keys in the map
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+  size_t capacity() const { return mask_ + 1; }
+  const Value& identity() const { return identity_; }
+
+private:
+  struct Slot {
+    Slot(Key k, Value v) : key(k), value(v) {}
+
+    std::atomic<Key> key;
+    std::atomic<Value> value;
+  };
+
+  /// The first slot to probe for key
+  size_t Home(Key key) const { return Hash{}(key) & mask_; }
+
+  /// Find the slot of key, claiming an empty one if key is not in the map
+  Slot* Claim(Key key) {
+    for (size_t i = 0, s = Home(key); i <= mask_; ++i, s = (s + 1) & mask_) {
+      Slot& slot = slots_[s];
+      Key k = slot.key.load(std::memory_order_acquire);
+      if (k == kEmptyKey) {
+        if (slot.key.compare_exchange_strong(
+                k, key, std::memory_order_acq_rel)) {
+          size_.fetch_add(1, std::memory_order_relaxed);
+          return &slot;
+        }
+        // Another thread claimed the slot first; k is its key
+      }
+      if (k == key) {
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  Value identity_;
+  size_t mask_;
+  LargeArray<Slot> slots_;
+  std::atomic<size_t> size_{0};
+};
+
+/// A ConcurrentHashMap reduced with MergeFunc and IdFunc, the merge and
+/// identity of Reducible (e.g., std::plus and identity_value_zero, or gmax
+/// and identity_value_min), in which each thread first combines its updates
+/// in a small private buffer.
+///
+/// Updates to the same key from one thread, such as the weights of the edges
+/// from a node to the members of a community, are combined in the buffer,
+/// so only distinct keys reach the shared map, when the buffer is full and
+/// in reduce. This keeps threads from contending for the slots of popular
+/// keys.
+template <
+    typename Key, typename Value, typename MergeFunc, typename IdFunc,
+    typename Hash = IntegerHash<Key>>
+class ReducibleHashMap {
+public:
+  using Map = ConcurrentHashMap<Key, Value, Hash>;
+
+  /// Keys in each thread's buffer
+  static constexpr size_t kBufferSize = 256;
+
+  ReducibleHashMap(
+      size_t max_keys, MergeFunc merge_func = MergeFunc(),
+      IdFunc id_func = IdFunc())
+      : merge_(merge_func), map_(max_keys, id_func()) {
+    for (unsigned i = 0; i < buffers_.size(); ++i) {
+      buffers_.getRemote(i)->Init(map_.identity());
+    }
+  }
+
+  /// Combine value into the value of key in the thread local buffer
+  void update(Key key, const Value& value) {
+    Buffer& buffer = *buffers_.getLocal();
+    if (!buffer.Update(key, value, merge_)) {
+      Flush(&buffer);
+      buffer.Update(key, value, merge_);
+    }
+  }
+
+  /// Flush all buffers and return the reduced map. Only valid outside the
+  /// parallel region.
+  Map& reduce() {
+    for (unsigned i = 0; i < buffers_.size(); ++i) {
+      Flush(buffers_.getRemote(i));
+    }
+    return map_;
+  }
+
+  void reset() {
+    for (unsigned i = 0; i < buffers_.size(); ++i) {
+      buffers_.getRemote(i)->Clear(map_.identity());
+    }
+    map_.Clear();
+  }
+
+private:
+  /// A sequential open addressed table of half its capacity in keys
+  struct Buffer {
+    static constexpr size_t kCapacity = 2 * kBufferSize;
+
+    std::vector<std::pair<Key, Value>> slots;
+    std::vector<uint32_t> used;
+
+    void Init(const Value& identity) {
+      slots.assign(kCapacity, {Map::kEmptyKey, identity});
+      used.reserve(kBufferSize);
+    }
+
+    bool Update(Key key, const Value& value, MergeFunc& merge) {
+      for (size_t s = Hash{}(key) & (kCapacity - 1);;
+           s = (s + 1) & (kCapacity - 1)) {
+        auto& [k, v] = slots[s];
+        if (k == key) {
+          v = merge(v, value);
+          return true;
+        }
+        if (k == Map::kEmptyKey) {
+          if (used.size() == kBufferSize) {
+            return false;
+          }
+          k = key;
+          v = merge(v, value);
+          used.emplace_back(s);
+          return true;
+        }
+      }
+    }
+
+    void Clear(const Value& identity) {
+      for (uint32_t s : used) {
+        slots[s] = {Map::kEmptyKey, identity};
+      }
+      used.clear();
+    }
+  };
+
+  void Flush(Buffer* buffer) {
+    for (uint32_t s : buffer->used) {
+      const auto& [key, value] = buffer->slots[s];
+      bool updated = map_.Update(key, value, merge_);
+      KATANA_LOG_VASSERT(updated, "more than {} keys", map_.capacity());
+    }
+    buffer->Clear(map_.identity());
+  }
+
+  MergeFunc merge_;
+  Map map_;
+  PerThreadStorage<Buffer> buffers_;
+};
+
+}  // namespace katana
+
+#endif
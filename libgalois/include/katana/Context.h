@@ -20,8 +20,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_CONTEXT_H_
 #define KATANA_LIBGALOIS_KATANA_CONTEXT_H_
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <utility>
+#include <vector>
 
 #include <boost/utility.hpp>
 
@@ -84,11 +88,26 @@ class KATANA_EXPORT Lockable {
   //! allocation overhead. Works for cases where a Lockable needs to be only in
   //! one context's neighborhood list
   Lockable* next;
+  //! Bumped whenever an optimistic iteration that owned this commits, so
+  //! that iterations that read it optimistically can tell it changed
+  std::atomic<uint32_t> version;
   friend class LockManagerBase;
   friend class SimpleRuntimeContext;
 
 public:
-  Lockable() : next(0) {}
+  Lockable() : next(0), version(0) {}
+  Lockable(const Lockable& other)
+      : owner(other.owner),
+        next(other.next),
+        version(other.version.load(std::memory_order_relaxed)) {}
+  Lockable& operator=(const Lockable& other) {
+    owner = other.owner;
+    next = other.next;
+    version.store(
+        other.version.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    return *this;
+  }
 };
 
 class KATANA_EXPORT LockManagerBase : private boost::noncopyable {
@@ -130,10 +149,24 @@ protected:
   }
 };
 
+/**
+ * Conflict detection for one thread of a parallel loop.
+ *
+ * By default, every acquire takes ownership of the Lockable, and an
+ * iteration that finds a Lockable owned by another iteration aborts. In
+ * optimistic mode (see katana::optimistic_conflict_detection), acquires with
+ * MethodFlag::READ only record the version of the Lockable instead. The
+ * versions read are validated when the operator calls
+ * UserContext::cautiousPoint and again before the iteration commits; the
+ * iteration aborts if another iteration changed any of them in between.
+ */
 class KATANA_EXPORT SimpleRuntimeContext : public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
   bool customAcquire;
+  bool optimistic;
+  //! What optimistic reads saw: each Lockable read and its version then
+  std::vector<std::pair<Lockable*, uint32_t>> reads;
 
 protected:
   friend void doAcquire(Lockable*, katana::MethodFlag);
@@ -153,7 +186,10 @@ protected:
 
   void acquire(Lockable* lockable, katana::MethodFlag m) {
     AcquireStatus i;
-    if (customAcquire) {
+    if (optimistic &&
+        (m & katana::MethodFlag::INTERNAL_MASK) == katana::MethodFlag::READ) {
+      readOptimistically(lockable);
+    } else if (customAcquire) {
       subAcquire(lockable, m);
     } else if ((i = tryAcquire(lockable)) != AcquireStatus::FAIL) {
       if (i == AcquireStatus::NEW_OWNER) {
@@ -164,13 +200,53 @@ protected:
     }
   }
 
+  //! Whether lockable is owned, or being acquired, by another context
+  bool ownedByOther(Lockable* lockable) {
+    return lockable->owner.is_locked() &&
+           LockManagerBase::getOwner(lockable) != this;
+  }
+
+  void readOptimistically(Lockable* lockable) {
+    // A Lockable being written cannot be read consistently
+    if (ownedByOther(lockable)) {
+      signalConflict(lockable);
+    }
+    reads.emplace_back(
+        lockable, lockable->version.load(std::memory_order_acquire));
+  }
+
   void release(Lockable* lockable);
 
+  //! Release the locks held and forget the reads; if written, tell
+  //! optimistic readers of the Lockables that they changed
+  unsigned releaseAll(bool written);
+
 public:
-  SimpleRuntimeContext(bool child = false) : locks(0), customAcquire(child) {}
+  SimpleRuntimeContext(bool child = false)
+      : locks(0), customAcquire(child), optimistic(false) {}
   virtual ~SimpleRuntimeContext() {}
 
-  void startIteration() { KATANA_LOG_DEBUG_ASSERT(!locks); }
+  //! Read with MethodFlag::READ optimistically from the next iteration on
+  void setOptimistic(bool value) { optimistic = value; }
+  bool isOptimistic() const { return optimistic; }
+
+  void startIteration() {
+    KATANA_LOG_DEBUG_ASSERT(!locks);
+    KATANA_LOG_DEBUG_ASSERT(reads.empty());
+  }
+
+  //! Abort the iteration if anything it read optimistically has been
+  //! written since, or is being written
+  void validateReads() {
+    for (const auto& [lockable, version] : reads) {
+      // Check the owner first: an owner bumps the version before it
+      // releases the Lockable
+      if (ownedByOther(lockable) ||
+          lockable->version.load(std::memory_order_acquire) != version) {
+        signalConflict(lockable);
+      }
+    }
+  }
 
   unsigned cancelIteration();
   unsigned commitIteration();
@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DISTRIBUTION_H_
+#define KATANA_LIBGALOIS_KATANA_DISTRIBUTION_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/PartitionMetadata.h"
+
+namespace katana {
+
+/// Ways of dividing a graph among hosts. In both, each host owns (is the
+/// master of) a contiguous block of nodes; blocks are chosen so that hosts
+/// own roughly the same number of nodes plus edges. The values are stored in
+/// tsuba::PartitionMetadata::policy_id_.
+enum class PartitionPolicy : uint32_t {
+  /// A host gets all outgoing edges of the nodes it owns
+  kOutgoingEdgeCut = 1,
+  /// Hosts form a grid with at least as many rows as columns, numbered in
+  /// row-major order. Edge (src, dest) goes to the host in the row of the
+  /// owner of src and the column of the owner of dest.
+  kCartesianVertexCut = 2,
+};
+
+struct KATANA_EXPORT PartitionOptions {
+  PartitionPolicy policy{PartitionPolicy::kOutgoingEdgeCut};
+  /// Number of partitions
+  uint32_t num_hosts{1};
+  /// Which partition to make
+  uint32_t host_id{0};
+  /// List of node properties to copy into the partition
+  /// nullptr means all node properties will be copied
+  const std::vector<std::string>* node_properties{nullptr};
+  /// List of edge properties to copy into the partition
+  /// nullptr means all edge properties will be copied
+  const std::vector<std::string>* edge_properties{nullptr};
+  /// Maximum number of nodes and of edges read from storage at a time while
+  /// scanning the whole graph
+  uint64_t scan_size{UINT64_C(1) << 24};
+};
+
+/// Reads and writes the partitioning information of a PropertyGraph: its
+/// tsuba::PartitionMetadata and the master and mirror node tables.
+class KATANA_EXPORT Distribution {
+public:
+  /// Make the partition of opts.host_id of the unpartitioned RDG rdg_name
+  /// without loading the whole graph into memory.
+  ///
+  /// The local nodes of a partition are the nodes it owns (masters) followed
+  /// by the other endpoints of its edges (mirrors), each in increasing order
+  /// of global ID. Mirrors have copies of the node properties of their
+  /// masters. The partition has its master and mirror node tables,
+  /// local_to_global_id and host_to_owned_global_ids filled in; the latter
+  /// holds the first and one past the last global ID owned by each host.
+  ///
+  /// The edges of the partition and their properties are read as one slice
+  /// of rdg_name. Node properties and the edges used to find which hosts
+  /// mirror this partition's masters are read by scanning the whole graph in
+  /// slices of at most opts.scan_size nodes and edges, so the memory needed
+  /// is about that of the partition plus one slice and the index array of
+  /// the topology.
+  ///
+  /// Every host can make its partition independently. To store them, each
+  /// host writes its own with PropertyGraph::Write, so opts.num_hosts and
+  /// opts.host_id must match the CommBackend given to tsuba::Init.
+  static Result<std::unique_ptr<PropertyGraph>> MakePartition(
+      const std::string& rdg_name, const PartitionOptions& opts);
+
+  static const tsuba::PartitionMetadata& partition_metadata(
+      const PropertyGraph& pg) {
+    return pg.partition_metadata();
+  }
+
+  /// master_nodes(pg)[host] holds the local IDs of the masters of pg that
+  /// host mirrors
+  static const std::vector<std::shared_ptr<arrow::ChunkedArray>>&
+  master_nodes(const PropertyGraph& pg) {
+    return pg.master_nodes();
+  }
+
+  /// mirror_nodes(pg)[host] holds the local IDs of the mirrors of pg that
+  /// host owns
+  static const std::vector<std::shared_ptr<arrow::ChunkedArray>>&
+  mirror_nodes(const PropertyGraph& pg) {
+    return pg.mirror_nodes();
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -26,16 +26,21 @@
 #ifndef KATANA_LIBGALOIS_KATANA_DYNAMICBITSET_H_
 #define KATANA_LIBGALOIS_KATANA_DYNAMICBITSET_H_
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
+#include <memory>
 #include <vector>
 
+#include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/mpl/has_xxx.hpp>
 
 #include "katana/AtomicWrapper.h"
 #include "katana/Galois.h"
 #include "katana/PODResizeableArray.h"
+#include "katana/Range.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -257,13 +262,136 @@ public:
     return (old_val & bit_offset);
   }
 
-  // assumes bit_vector is not updated (set) in parallel
+  /**
+   * Returns word w of the bitset with any bits past the size of the bitset
+   * cleared
+   *
+   * @param w Index of the word, less than get_vec().size()
+   */
+  uint64_t GetWord(size_t w) const {
+    uint64_t word = bitvec_[w].load(std::memory_order_relaxed);
+    size_t tail = num_bits_ % kNumBitsInUint64;
+    if (tail != 0 && w + 1 == bitvec_.size()) {
+      word &= (uint64_t{1} << tail) - 1;
+    }
+    return word;
+  }
+
+  /**
+   * Finds the first set bit at or after index, skipping over words with no
+   * bits set.
+   *
+   * @param index Bit to start the search from
+   * @returns the index of the set bit or size() if there is none
+   */
+  size_t FindNextSetBit(size_t index) const {
+    if (index >= num_bits_) {
+      return num_bits_;
+    }
+    size_t w = index / kNumBitsInUint64;
+    uint64_t word = GetWord(w) & (~uint64_t{0} << (index % kNumBitsInUint64));
+    while (word == 0) {
+      if (++w == bitvec_.size()) {
+        return num_bits_;
+      }
+      word = GetWord(w);
+    }
+    return w * kNumBitsInUint64 + __builtin_ctzll(word);
+  }
+
+  /**
+   * Forward iterator over the indices of the set bits of a bitset in
+   * increasing order
+   */
+  class SetBitIterator
+      : public boost::iterator_facade<
+            SetBitIterator, size_t, boost::forward_traversal_tag, size_t> {
+    friend class boost::iterator_core_access;
+
+    const DynamicBitset* bitset_{nullptr};
+    size_t index_{0};
+
+    void increment() { index_ = bitset_->FindNextSetBit(index_ + 1); }
+    bool equal(const SetBitIterator& o) const { return index_ == o.index_; }
+    size_t dereference() const { return index_; }
+
+  public:
+    SetBitIterator() = default;
+    SetBitIterator(const DynamicBitset* bitset, size_t index)
+        : bitset_(bitset), index_(index) {}
+  };
+
+  /**
+   * Returns the range of indices of the set bits of this bitset, for serial
+   * iteration; see ForEachSetBit for parallel iteration
+   */
+  StandardRange<SetBitIterator> SetBits() const {
+    return MakeStandardRange(
+        SetBitIterator(this, FindNextSetBit(0)),
+        SetBitIterator(this, num_bits_));
+  }
+
+  /**
+   * Calls fn(index) in parallel for the index of each set bit, skipping
+   * over words with no bits set.
+   * Assumes bit_vector is not updated (set) in parallel.
+   */
+  template <typename F>
+  void ForEachSetBit(const F& fn) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, bitvec_.size()),
+        [&](size_t w) {
+          uint64_t word = GetWord(w);
+          while (word != 0) {
+            size_t bit = __builtin_ctzll(word);
+            word &= word - 1;
+            fn(w * kNumBitsInUint64 + bit);
+          }
+        },
+        katana::steal(), katana::chunk_size<kSetBitChunkSize>(),
+        katana::no_stats());
+  }
+
+  /**
+   * Returns a boolean array that shares the memory of this bitset; bit i of
+   * the bitset is element i of the array. The array is valid only while the
+   * bitset is not resized, cleared or destroyed.
+   */
+  std::shared_ptr<arrow::BooleanArray> AsArrowView() const;
+
+  /**
+   * Resizes the bitset to the length of array and sets the bits of the
+   * elements that are true and not null.
+   * Assumes bit_vector is not updated (set) in parallel.
+   *
+   * @param array Array to copy
+   */
+  void CopyFromArrow(const arrow::BooleanArray& array);
+
+  // The bulk operations below process blocks of words in parallel with
+  // loops the compiler can vectorize; they all
+  // assume bit_vector is not updated (set) in parallel
+
+  /**
+   * Does an IN-PLACE bitwise or of this bitset and another bitset
+   *
+   * @param other Other bitset to do bitwise or with
+   */
   void bitwise_or(const DynamicBitset& other);
 
-  // assumes bit_vector is not updated (set) in parallel
+  /**
+   * Does an IN-PLACE bitwise not of this bitset; bits past the size of the
+   * bitset stay unset
+   */
   void bitwise_not();
 
-  // assumes bit_vector is not updated (set) in parallel
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of
+   * another bitset, i.e., unsets the bits that are set in other
+   *
+   * @param other Other bitset to do bitwise and not with
+   */
+  void bitwise_andnot(const DynamicBitset& other);
 
   /**
    * Does an IN-PLACE bitwise and of this bitset and another bitset
@@ -324,6 +452,10 @@ public:
 
   //! this is defined to
   using tt_is_copyable = int;
+
+private:
+  //! Words per work item of ForEachSetBit
+  static constexpr unsigned kSetBitChunkSize = 64U;
 };
 
 template <>
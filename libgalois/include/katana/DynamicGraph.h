@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DYNAMICGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_DYNAMICGRAPH_H_
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A graph whose edges are inserted and deleted in parallel batches, e.g.,
+/// from an edge stream.
+///
+/// Each node keeps the destinations of its edges in one sorted array of its
+/// own, which grows and shrinks geometrically, so a batch only touches the
+/// nodes it changes and neighborhoods stay contiguous for reads. A batch is
+/// sorted by source with a parallel radix sort and the nodes it changes are
+/// merged in parallel, one task per node, so updates take no locks. The
+/// graph has no parallel edges: inserting an edge that exists has no effect.
+///
+/// DynamicGraph has the node range and edges/edge_dest interface of
+/// GraphTopology, except that edges are pointers into the arrays rather than
+/// edge ids, so code written against that interface, e.g.,
+///
+///   for (auto n : graph) {
+///     for (auto e : graph.edges(n)) {
+///       Visit(n, graph.edge_dest(e));
+///     }
+///   }
+///
+/// runs over both. Reads may run concurrently with each other but not with
+/// a batch update; a batch invalidates the edges of the nodes it changes.
+class KATANA_EXPORT DynamicGraph {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = const Node*;
+  using node_iterator = GraphTopology::node_iterator;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = GraphTopology::nodes_range;
+  using edges_range = StandardRange<edge_iterator>;
+
+  DynamicGraph() = default;
+
+  /// A graph with num_nodes nodes and no edges
+  explicit DynamicGraph(uint64_t num_nodes) : adjacency_(num_nodes) {}
+
+  /// A graph with the edges of topology, without parallel edges
+  static DynamicGraph FromTopology(const GraphTopology& topology);
+
+  uint64_t num_nodes() const { return adjacency_.size(); }
+  uint64_t num_edges() const { return num_edges_; }
+
+  nodes_range nodes(Node begin, Node end) const {
+    return MakeStandardRange<node_iterator>(begin, end);
+  }
+
+  node_iterator begin() const { return node_iterator(0); }
+  node_iterator end() const { return node_iterator(num_nodes()); }
+  size_t size() const { return num_nodes(); }
+  bool empty() const { return num_nodes() == 0; }
+
+  /// The edges of node, in increasing order of destination
+  edges_range edges(Node node) const {
+    const std::vector<Node>& dests = adjacency_[node];
+    return MakeStandardRange<edge_iterator>(
+        dests.data(), dests.data() + dests.size());
+  }
+
+  Node edge_dest(Edge edge) const { return *edge; }
+
+  uint64_t degree(Node node) const { return adjacency_[node].size(); }
+
+  bool HasEdge(Node src, Node dest) const {
+    const std::vector<Node>& dests = adjacency_[src];
+    return std::binary_search(dests.begin(), dests.end(), dest);
+  }
+
+  /// Add num_nodes nodes without edges; the new nodes are numbered after
+  /// the existing ones
+  void AddNodes(uint64_t num_nodes) {
+    adjacency_.resize(adjacency_.size() + num_nodes);
+  }
+
+  /// Insert the edges of batch that are not in the graph, in parallel.
+  /// Fails without changing the graph if an edge refers to a node that is
+  /// not in the graph.
+  ///
+  /// \returns the number of edges inserted
+  Result<uint64_t> InsertEdges(
+      const std::vector<std::pair<Node, Node>>& batch);
+
+  /// Delete the edges of batch that are in the graph, in parallel. Fails
+  /// without changing the graph if an edge refers to a node that is not in
+  /// the graph.
+  ///
+  /// \returns the number of edges deleted
+  Result<uint64_t> DeleteEdges(
+      const std::vector<std::pair<Node, Node>>& batch);
+
+  /// A CSR topology with the edges of this graph, built in parallel. The
+  /// edges of each node are sorted by destination.
+  Result<GraphTopology> ToTopology() const;
+
+  /// A property graph with the topology of this graph and no properties
+  Result<std::unique_ptr<PropertyGraph>> ToPropertyGraph() const;
+
+private:
+  /// Sorts a copy of batch by source and destination and checks its nodes
+  Result<std::vector<std::pair<Node, Node>>> SortBatch(
+      const std::vector<std::pair<Node, Node>>& batch) const;
+
+  std::vector<std::vector<Node>> adjacency_;
+  uint64_t num_edges_{0};
+};
+
+}  // namespace katana
+
+#endif
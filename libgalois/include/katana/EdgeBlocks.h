@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGEBLOCKS_H_
+#define KATANA_LIBGALOIS_KATANA_EDGEBLOCKS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+/// Call fn(block, begin, end) for each block of list in parallel, where
+/// [begin, end) index list.sources, list.dests and list.edges. Threads take
+/// runs of consecutive blocks along the curve, so the sources or the
+/// destinations of the next block of a thread are usually those of its last
+/// one. args are passed on to do_all.
+template <typename FunctionTy, typename... Args>
+void
+ForEachEdgeBlock(
+    const HilbertEdgeList& list, const FunctionTy& fn, Args&&... args) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, list.num_blocks()),
+      [&](uint64_t block) {
+        auto [begin, end] = list.block_range(block);
+        fn(block, begin, end);
+      },
+      std::forward<Args>(args)...);
+}
+
+/// Set out[n], for each node n of list, to identity combined with op with
+/// value(i) for each edge i of list (an index into list.sources, list.dests
+/// and list.edges) whose destination is n, e.g., to sum the contributions of
+/// the in-neighbors of each node, without atomics.
+///
+/// Each block combines the values of its edges in a per-thread scratch array
+/// of the destinations of its column and writes one partial result per
+/// destination it reaches. Then the partial results of each column are
+/// merged into out by one thread in the order of the curve, so the result
+/// does not depend on the number of threads even when op is floating point
+/// addition. T must be trivially copyable. The partial results take
+/// sizeof(T) + 4 bytes per edge, and the scratch array of each thread 8
+/// bytes per destination of a column.
+template <typename T, typename ValueFn, typename Op = std::plus<T>>
+void
+AccumulateEdgeBlocks(
+    const HilbertEdgeList& list, const ValueFn& value, T* out,
+    T identity = T{}, const Op& op = Op{}) {
+  static_assert(
+      std::is_trivially_copyable_v<T>,
+      "AccumulateEdgeBlocks needs trivially copyable values");
+  constexpr uint64_t kNoSlot = std::numeric_limits<uint64_t>::max();
+  uint32_t bits = list.block_bits;
+  uint64_t column_size =
+      std::min<uint64_t>(uint64_t{1} << bits, list.num_nodes);
+
+  // The partial results of block b are at [begin, partial_ends[b]) where
+  // begin is the first edge of b
+  LargeArray<uint32_t> partial_dests;
+  partial_dests.allocateBlocked(list.num_edges());
+  LargeArray<T> partial_values;
+  partial_values.allocateBlocked(list.num_edges());
+  LargeArray<uint64_t> partial_ends;
+  partial_ends.allocateBlocked(list.num_blocks());
+
+  // The partial result of each destination of the column of the current
+  // block, or kNoSlot
+  katana::PerThreadStorage<std::vector<uint64_t>> slots;
+  ForEachEdgeBlock(
+      list,
+      [&](uint64_t block, uint64_t begin, uint64_t end) {
+        std::vector<uint64_t>& slot = *slots.getLocal();
+        if (slot.empty()) {
+          slot.assign(column_size, kNoSlot);
+        }
+        uint64_t base = (uint64_t{list.dests[begin]} >> bits) << bits;
+        uint64_t next = begin;
+        for (uint64_t i = begin; i < end; ++i) {
+          uint64_t& s = slot[list.dests[i] - base];
+          if (s == kNoSlot) {
+            s = next++;
+            partial_dests[s] = list.dests[i];
+            partial_values[s] = op(identity, value(i));
+          } else {
+            partial_values[s] = op(partial_values[s], value(i));
+          }
+        }
+        for (uint64_t p = begin; p < next; ++p) {
+          slot[partial_dests[p] - base] = kNoSlot;
+        }
+        partial_ends[block] = next;
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, list.num_columns()),
+      [&](uint64_t column) {
+        uint64_t first = column << bits;
+        std::fill(
+            out + first, out + std::min(list.num_nodes, first + column_size),
+            identity);
+        auto [begin, end] = list.column_range(column);
+        for (uint64_t j = begin; j < end; ++j) {
+          uint64_t block = list.column_blocks[j];
+          for (uint64_t p = list.block_range(block).first;
+               p < partial_ends[block]; ++p) {
+            T& total = out[partial_dests[p]];
+            total = op(total, partial_values[p]);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGEDELTA_H_
+#define KATANA_LIBGALOIS_KATANA_EDGEDELTA_H_
+
+#include <utility>
+#include <vector>
+
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Edges added to a graph after its topology was built, stored in CSR form
+/// with the destinations of each node sorted.
+///
+/// The topology of a PropertyGraph is immutable, so new edges are collected
+/// in an EdgeDelta (see EdgeDeltaBuilder) and analytics visit the edges of a
+/// node in the graph and then in the delta, e.g., with ForEachDest. Once the
+/// delta is large enough, ApplyEdgeDelta merges it into the graph.
+class KATANA_EXPORT EdgeDelta {
+public:
+  using Node = GraphTopology::Node;
+  using dest_iterator = const Node*;
+  using dests_range = StandardRange<dest_iterator>;
+
+  EdgeDelta() = default;
+
+  uint64_t num_nodes() const { return indices_.size(); }
+  uint64_t num_edges() const { return dests_.size(); }
+  bool empty() const { return num_edges() == 0; }
+
+  /// Gets the destinations of the edges added to some node, in increasing
+  /// order. An empty delta has no nodes and no edges for any node.
+  dests_range OutDests(Node node) const {
+    if (node >= num_nodes()) {
+      return MakeStandardRange<dest_iterator>(nullptr, nullptr);
+    }
+    uint64_t begin = node > 0 ? indices_[node - 1] : 0;
+    return MakeStandardRange(
+        dests_.data() + begin, dests_.data() + indices_[node]);
+  }
+
+  uint64_t degree(Node node) const { return OutDests(node).size(); }
+
+  /// Number of edges of node in topology and in this delta
+  uint64_t degree(const GraphTopology& topology, Node node) const {
+    auto [begin, end] = topology.edge_range(node);
+    return end - begin + degree(node);
+  }
+
+  /// Call fn(dest) for each edge of node, first those in topology and then
+  /// those in this delta.
+  template <typename F>
+  void ForEachDest(const GraphTopology& topology, Node node, F fn) const {
+    for (auto e : topology.edges(node)) {
+      fn(topology.edge_dest(e));
+    }
+    for (Node dest : OutDests(node)) {
+      fn(dest);
+    }
+  }
+
+private:
+  friend class EdgeDeltaBuilder;
+  friend Result<void> ApplyEdgeDelta(
+      PropertyGraph* pg, const EdgeDelta& delta);
+
+  /// Like GraphTopology::out_indices, indices_[n] is the end of the edges of
+  /// node n in dests_
+  LargeArray<uint64_t> indices_;
+  LargeArray<Node> dests_;
+};
+
+/// Collects edges for an EdgeDelta in per-thread batches.
+///
+/// AddEdge may be called concurrently by the threads of a parallel loop
+/// (e.g., a do_all over a batch of incoming events) and takes no locks.
+/// Finish sorts the collected edges into an EdgeDelta in parallel.
+class KATANA_EXPORT EdgeDeltaBuilder {
+public:
+  using Node = GraphTopology::Node;
+
+  /// Build deltas for a graph with num_nodes nodes
+  explicit EdgeDeltaBuilder(uint64_t num_nodes) : num_nodes_(num_nodes) {}
+
+  void AddEdge(Node src, Node dest) {
+    batches_.getLocal()->emplace_back(src, dest);
+  }
+
+  /// Return a delta with the edges of previous and all edges added since the
+  /// last call to Finish, and empty the batches. Fails if an edge refers to
+  /// a node that is not in the graph; the batches are emptied anyway.
+  Result<EdgeDelta> Finish(const EdgeDelta& previous = EdgeDelta{});
+
+private:
+  uint64_t num_nodes_;
+  PerThreadStorage<std::vector<std::pair<Node, Node>>> batches_;
+};
+
+/// Merge the edges of delta into the topology of pg. The edges of each node
+/// become its edges in pg followed by its edges in delta, so existing edges
+/// keep their relative order. Edge properties of the added edges are null.
+///
+/// The merge is a parallel pass over the topology and edge properties of pg.
+/// Commit or Write pg afterwards to persist the result as a new version of
+/// its RDG.
+KATANA_EXPORT Result<void> ApplyEdgeDelta(
+    PropertyGraph* pg, const EdgeDelta& delta);
+
+}  // namespace katana
+
+#endif
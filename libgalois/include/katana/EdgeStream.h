@@ -0,0 +1,108 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGESTREAM_H_
+#define KATANA_LIBGALOIS_KATANA_EDGESTREAM_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/LargeArray.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace katana {
+
+/// A range of consecutive nodes together with all of their outgoing edges,
+/// as read by EdgeStream::ForEachBlock. It is only valid during the call
+/// that receives it.
+class KATANA_EXPORT EdgeBlock {
+public:
+  using Node = uint32_t;
+  using dests_range = StandardRange<const Node*>;
+
+  Node node_begin() const { return node_begin_; }
+  Node node_end() const { return node_end_; }
+
+  /// Gets the destinations of the edges of node, which must be in
+  /// [node_begin(), node_end())
+  dests_range OutDests(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(node >= node_begin_ && node < node_end_);
+    uint64_t begin = node > 0 ? out_indexes_[node - 1] : 0;
+    return MakeStandardRange(
+        dests_ + (begin - edge_begin_),
+        dests_ + (out_indexes_[node] - edge_begin_));
+  }
+
+private:
+  friend class EdgeStream;
+
+  EdgeBlock(
+      const uint64_t* out_indexes, const Node* dests, Node node_begin,
+      Node node_end)
+      : out_indexes_(out_indexes),
+        dests_(dests),
+        node_begin_(node_begin),
+        node_end_(node_end),
+        edge_begin_(node_begin > 0 ? out_indexes[node_begin - 1] : 0) {}
+
+  const uint64_t* out_indexes_;
+  const Node* dests_;
+  Node node_begin_;
+  Node node_end_;
+  uint64_t edge_begin_;
+};
+
+/// Reads the edges of an unpartitioned RDG from storage in large sequential
+/// blocks, for semi-external algorithms: those that keep their per-node
+/// state in memory but cannot hold the whole topology (see
+/// katana/analytics/SemiExternal.h).
+///
+/// Only the index of the topology, 8 bytes per node, is kept in memory. A
+/// pass over the edges reads blocks in order of their nodes with
+/// tsuba::FileGetAsync, reading the next block while the caller works on the
+/// current one, so memory for edges is bounded by two blocks.
+class KATANA_EXPORT EdgeStream {
+public:
+  using Node = EdgeBlock::Node;
+
+  /// 64 MiB of destinations per block
+  static constexpr uint64_t kDefaultBlockSize = UINT64_C(64) << 20;
+
+  /// Prepare to stream the edges of the RDG rdg_name in blocks of about
+  /// block_size bytes of edge destinations each. Blocks hold whole nodes, so
+  /// a node with more edges than fit in a block gets a block of its own.
+  static Result<EdgeStream> Make(
+      const std::string& rdg_name, uint64_t block_size = kDefaultBlockSize);
+
+  uint64_t num_nodes() const { return prefix_.num_nodes(); }
+  uint64_t num_edges() const { return prefix_.num_edges(); }
+  uint64_t num_blocks() const { return block_starts_.size() - 1; }
+
+  uint64_t degree(Node node) const {
+    const uint64_t* out_indexes = prefix_.out_indexes();
+    return out_indexes[node] - (node > 0 ? out_indexes[node - 1] : 0);
+  }
+
+  /// Make a pass over the edges, calling fn for each block in order. If
+  /// wanted is given, only the blocks for which wanted(node_begin, node_end)
+  /// returns true are read; it is called for every block before the first
+  /// one is read.
+  Result<void> ForEachBlock(
+      const std::function<void(const EdgeBlock&)>& fn,
+      const std::function<bool(Node, Node)>& wanted = nullptr);
+
+private:
+  EdgeStream(tsuba::RDGPrefix&& prefix, std::vector<Node>&& block_starts);
+
+  tsuba::RDGPrefix prefix_;
+  /// Block b holds nodes [block_starts_[b], block_starts_[b + 1])
+  std::vector<Node> block_starts_;
+  /// The block being read and the block being processed
+  LargeArray<Node> buffers_[2];
+};
+
+}  // namespace katana
+
+#endif
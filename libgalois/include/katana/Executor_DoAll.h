@@ -20,16 +20,27 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <type_traits>
+
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/Interleave.h"
+#include "katana/LoopTelemetry.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
+#include "katana/ParaMeter.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
+#include "katana/Trace.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
 
@@ -37,6 +48,60 @@ namespace katana {
 
 namespace internal {
 
+/// Calls the function of a \ref prefetch_ahead option, if there is one, on
+/// the item its distance ahead of the item being processed
+template <typename ArgsTuple, bool = has_trait<prefetch_tag, ArgsTuple>()>
+class Prefetcher {
+public:
+  explicit Prefetcher(const ArgsTuple&) {}
+
+  template <typename Iter>
+  void Start(const Iter&, const Iter&) const {}
+
+  template <typename Iter>
+  void Ahead(const Iter&, const Iter&) const {}
+};
+
+template <typename ArgsTuple>
+class Prefetcher<ArgsTuple, true> {
+  using Option = trait_type_t<prefetch_tag, ArgsTuple>;
+  constexpr static ptrdiff_t kDistance = Option::distance;
+
+  Option option_;
+
+  template <typename Iter>
+  static void CheckIterator() {
+    static_assert(
+        std::is_base_of_v<
+            std::random_access_iterator_tag,
+            typename std::iterator_traits<Iter>::iterator_category>,
+        "prefetching needs a range with random access iterators");
+  }
+
+public:
+  explicit Prefetcher(const ArgsTuple& args)
+      : option_(get_trait_value<prefetch_tag>(args)) {}
+
+  /// Prefetch the first items of [beg, end) before processing it
+  template <typename Iter>
+  void Start(const Iter& beg, const Iter& end) const {
+    CheckIterator<Iter>();
+    ptrdiff_t n = std::min<ptrdiff_t>(kDistance, end - beg);
+    for (ptrdiff_t i = 0; i < n; ++i) {
+      option_.value(*(beg + i));
+    }
+  }
+
+  /// Prefetch the item kDistance past \param it, the next item of
+  /// [it, end) to process, if there is one
+  template <typename Iter>
+  void Ahead(const Iter& it, const Iter& end) const {
+    if (end - it > kDistance) {
+      option_.value(*(it + kDistance));
+    }
+  }
+};
+
 template <typename R, typename F, typename ArgsTuple>
 class DoAllStealingExec {
   typedef typename R::local_iterator Iter;
@@ -49,6 +114,8 @@ class DoAllStealingExec {
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  constexpr static const bool INTERLEAVE =
+      has_trait<interleave_tag, ArgsTuple>();
 
   struct ThreadContext {
     alignas(KATANA_CACHE_LINE_SIZE) SimpleLock work_mutex;
@@ -58,6 +125,7 @@ class DoAllStealingExec {
     Iter shared_end;
     Diff_ty m_size;
     size_t num_iter;
+    size_t num_steals;
 
     // Stats
 
@@ -67,7 +135,8 @@ class DoAllStealingExec {
           shared_beg(),
           shared_end(),
           m_size(0),
-          num_iter(0) {
+          num_iter(0),
+          num_steals(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
@@ -78,22 +147,48 @@ class DoAllStealingExec {
           shared_beg(beg),
           shared_end(end),
           m_size(std::distance(beg, end)),
-          num_iter(0) {}
+          num_iter(0),
+          num_steals(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(
+        F func, const Prefetcher<ArgsTuple>& prefetcher,
+        const unsigned chunk_size) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
       bool didwork = false;
 
-      while (getWork(beg, end, chunk_size)) {
-        didwork = true;
+      if constexpr (INTERLEAVE) {
+        // Tasks stay in flight across chunks; only when the range of this
+        // thread runs out are they drained before stealing
+        using Item = std::decay_t<decltype(*beg)>;
+        end = beg;
+        InterleaveTasks<trait_type_t<interleave_tag, ArgsTuple>::width, Item>(
+            [&](Item* item) {
+              if (beg == end && !getWork(beg, end, chunk_size)) {
+                return false;
+              }
+              didwork = true;
+              if (NEED_STATS) {
+                ++num_iter;
+              }
+              *item = *beg;
+              ++beg;
+              return true;
+            },
+            func);
+      } else {
+        while (getWork(beg, end, chunk_size)) {
+          didwork = true;
 
-        for (; beg != end; ++beg) {
-          if (NEED_STATS) {
-            ++num_iter;
+          prefetcher.Start(beg, end);
+          for (; beg != end; ++beg) {
+            if (NEED_STATS) {
+              ++num_iter;
+            }
+            prefetcher.Ahead(beg, end);
+            func(*beg);
           }
-          func(*beg);
         }
       }
 
@@ -355,6 +450,7 @@ private:
 private:
   R range;
   F func;
+  Prefetcher<ArgsTuple> prefetcher;
   const char* loopname;
   Diff_ty chunk_size;
   PerThreadStorage<ThreadContext> workers;
@@ -372,9 +468,10 @@ public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
       : range(_range),
         func(_func),
+        prefetcher(argsTuple),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -411,6 +508,8 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    TraceSpan loop_span(loopname, "loop");
+    TraceInterval term_span("termination", "wait");
     totalTime.start();
 
     while (true) {
@@ -418,7 +517,7 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, prefetcher, chunk_size)) {
         workHappened = true;
       }
 
@@ -431,11 +530,16 @@ public:
       stealTime.stop();
 
       if (stole) {
+        if (NEED_STATS) {
+          ++ctx.num_steals;
+        }
+        term_span.End();
         continue;
 
       } else {
         KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
         if (USE_TERM) {
+          term_span.Begin();
           termTime.start();
           term.SignalWorked(workHappened);
 
@@ -456,6 +560,9 @@ public:
 
     if (NEED_STATS) {
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      katana::ReportStatSum(loopname, "Steals", ctx.num_steals);
+      internal::ReportLoopTelemetry(
+          loopname, ctx.num_iter, 0, 0, ctx.num_steals);
     }
   }
 };
@@ -468,10 +575,10 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
@@ -489,6 +596,7 @@ struct ChooseDoAllImpl<false> {
 
           const char* const loopname = katana::internal::getLoopName(argsTuple);
 
+          TraceSpan loop_span(loopname, "loop");
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
@@ -505,10 +613,19 @@ struct ChooseDoAllImpl<false> {
 
           size_t iter = 0;
 
-          while (begin != end) {
-            func(*begin++);
-            if (NEED_STATS) {
-              ++iter;
+          if constexpr (has_trait<interleave_tag, ArgsT>()) {
+            iter = std::distance(begin, end);
+            InterleaveTasks<trait_type_t<interleave_tag, ArgsT>::width>(
+                begin, end, func);
+          } else {
+            const Prefetcher<ArgsT> prefetcher(argsTuple);
+            prefetcher.Start(begin, end);
+            while (begin != end) {
+              prefetcher.Ahead(begin, end);
+              func(*begin++);
+              if (NEED_STATS) {
+                ++iter;
+              }
             }
           }
           execTime.stop();
@@ -517,6 +634,7 @@ struct ChooseDoAllImpl<false> {
 
           if (NEED_STATS) {
             katana::ReportStatSum(loopname, "Iterations", iter);
+            internal::ReportLoopTelemetry(loopname, iter, 0, 0, 0);
           }
         },
         std::make_tuple());
@@ -531,6 +649,10 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
   static_assert(!has_trait<char*, ArgsTuple>(), "old loopname");
   static_assert(!has_trait<char const*, ArgsTuple>(), "old loopname");
   static_assert(!has_trait<bool, ArgsTuple>(), "old steal");
+  static_assert(
+      !has_trait<interleave_tag, ArgsTuple>() ||
+          !has_trait<prefetch_tag, ArgsTuple>(),
+      "interleaved tasks prefetch for themselves");
 
   auto argsT = std::tuple_cat(
       argsTuple, get_default_trait_values(
@@ -541,13 +663,37 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
+  internal::LoopTelemetrySpan<TIME_IT> span(
+      katana::internal::getLoopName(argsT), "do_all");
+
+  // A profiled do_all is one step in which all of its range is ready
+  parameter::ProfileScope* profile =
+      TIME_IT ? parameter::CurrentProfileScope() : nullptr;
+  if (profile) {
+    std::atomic<uint64_t> work{0};
+    on_each_gen(
+        [&](unsigned, unsigned) {
+          work += std::distance(range.local_begin(), range.local_end());
+        },
+        std::make_tuple());
+    profile->AddStep(
+        katana::internal::getLoopName(argsT),
+        parameter::LoopProfile::Step{work.load(), work.load()});
+  }
 
   timer.start();
 
   constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
 
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
-  internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  if constexpr (has_trait<edge_balanced_tag, ArgsT>()) {
+    EdgeBalancedRange balanced(
+        range.begin(), range.end(),
+        get_trait_value<edge_balanced_tag>(argsT).value);
+    internal::ChooseDoAllImpl<STEAL>::call(balanced, func_ref, argsT);
+  } else {
+    internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  }
 
   timer.stop();
 }
@@ -29,6 +29,7 @@
 #include "katana/Chunk.h"
 #include "katana/Context.h"
 #include "katana/LoopStatistics.h"
+#include "katana/LoopTelemetry.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/Range.h"
@@ -38,6 +39,7 @@
 #include "katana/ThreadTimer.h"
 #include "katana/Threads.h"
 #include "katana/Timer.h"
+#include "katana/Trace.h"
 #include "katana/Traits.h"
 #include "katana/UserContextAccess.h"
 #include "katana/config.h"
@@ -148,6 +150,8 @@ public:
   static constexpr bool needsPush = !has_trait<no_pushes_tag, ArgsTy>();
   static constexpr bool needsAborts =
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
+  static constexpr bool optimistic =
+      needsAborts && has_trait<optimistic_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
@@ -195,6 +199,9 @@ protected:
   PerThreadTimer<MORE_STATS> execTime;
 
   inline void commitIteration(ThreadLocalData& tld) {
+    // Aborts here discard the pushes of the iteration
+    if (optimistic)
+      tld.ctx.validateReads();
     if (needsPush) {
       // auto ii = tld.facing.getPushBuffer().begin();
       // auto ee = tld.facing.getPushBuffer().end();
@@ -301,12 +308,17 @@ protected:
   void go() {
     execTime.start();
 
+    TraceSpan loop_span(loopname, "loop");
+    TraceInterval term_span("termination", "wait");
+
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
     if (needsBreak)
       tld.facing.setBreakFlag(&broke);
-    if (couldAbort)
+    if (couldAbort) {
+      tld.ctx.setOptimistic(optimistic);
       setThreadContext(&tld.ctx);
+    }
     if (needsPush && !couldAbort)
       tld.facing.setFastPushBack(std::bind(
           &ForEachExecutor::fastPushBack, this, std::placeholders::_1));
@@ -330,6 +342,12 @@ protected:
           didWork = b || didWork;
         }
 
+        if (didWork) {
+          term_span.End();
+        } else {
+          term_span.Begin();
+        }
+
         // Update node color and prop token
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
@@ -345,6 +363,7 @@ protected:
         break;
       }
 
+      term_span.End();
       term.InitializeThread();
       barrier.Wait();
     }
@@ -358,8 +377,8 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
@@ -401,7 +420,7 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -451,12 +470,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
@@ -480,6 +499,8 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
+  internal::LoopTelemetrySpan<TIME_IT> span(
+      katana::internal::getLoopName(xtpl), "for_each");
 
   timer.start();
 
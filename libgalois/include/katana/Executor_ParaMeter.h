@@ -33,6 +33,7 @@
 #include "katana/Executor_ForEach.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
+#include "katana/ParaMeter.h"
 #include "katana/Reduction.h"
 #include "katana/Simple.h"
 #include "katana/Traits.h"
@@ -109,6 +110,11 @@ struct UnorderedStepStats : public StepStatsBase {
 KATANA_EXPORT FILE* getStatsFile();
 KATANA_EXPORT void closeStatsFile();
 
+namespace internal {
+/// Return true if KATANA_PARAMETER_OUTFILE names the stats file
+KATANA_EXPORT bool IsStatsFileSet();
+}  // namespace internal
+
 template <typename T>
 class FIFO_WL {
   using PTcont = katana::PerThreadStorage<katana::gstl::Vector<T>>;
@@ -198,11 +204,9 @@ struct ChooseWL<T, SchedType::RAND> {
   using type = RAND_WL<T>;
 };
 
-template <class T, class FunctionTy, class ArgsTy>
+template <class T, class FunctionTy, class ArgsTy, SchedType SCHED>
 class ParaMeterExecutor {
   using value_type = T;
-  using GenericWL = typename trait_type<wl_tag, ArgsTy>::type::type;
-  using WorkListTy = typename GenericWL::template retype<T>;
   using dbg = katana::debug<1>;
 
   constexpr static bool needsStats = !has_trait<no_stats_tag, ArgsTy>();
@@ -230,7 +234,7 @@ class ParaMeterExecutor {
     }
   };
 
-  using PWL = typename ChooseWL<IterationContext*, WorkListTy::SCHEDULE>::type;
+  using PWL = typename ChooseWL<IterationContext*, SCHED>::type;
 
 private:
   PWL m_wl;
@@ -289,14 +293,12 @@ private:
         [&, this](IterationContext* it) {
           stats.wlSize += 1;
 
-          setThreadContext(&(it->ctx));
-
+          // Without conflict detection, iterations acquire no locks, as in
+          // the for_each executor
           m_func(it->item, it->facing.data());
           stats.parallelism += 1;
           unsigned nh = commitIteration(it);
           stats.nhSize += nh;
-
-          setThreadContext(nullptr);
         },
         std::make_tuple(katana::steal(), katana::loopname("ParaM-Simple")));
   }
@@ -374,6 +376,10 @@ private:
 
     UnorderedStepStats stats;
 
+    // The loops that run the steps are not part of the profile
+    ProfileScope* profile = CurrentProfileScope();
+    internal::SuspendProfile suspend;
+
     while (!m_wl.empty()) {
       m_wl.nextStep();
 
@@ -389,7 +395,14 @@ private:
       KATANA_LOG_DEBUG_VASSERT(
           stats.parallelism.reduce(), "ERROR: No Progress");
 
-      stats.dump(m_statsFile, loopname);
+      if (profile) {
+        profile->AddStep(
+            loopname, LoopProfile::Step{
+                          stats.wlSize.reduce(), stats.parallelism.reduce()});
+      }
+      if (m_statsFile) {
+        stats.dump(m_statsFile, loopname);
+      }
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -398,14 +411,18 @@ private:
 
     }  // end while
 
-    closeStatsFile();
+    if (m_statsFile) {
+      closeStatsFile();
+    }
   }
 
 public:
-  ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args)
+  /// write_csv: whether to write the steps to the ParaMeter stats file
+  ParaMeterExecutor(
+      const FunctionTy& f, const ArgsTy& args, bool write_csv = true)
       : m_func(f),
         loopname(katana::internal::getLoopName(args)),
-        m_statsFile(getStatsFile()) {}
+        m_statsFile(write_csv ? getStatsFile() : nullptr) {}
 
   // called serially once
   template <typename RangeTy>
@@ -443,10 +460,11 @@ public:
 
 // hookup into katana::for_each. Invoke katana::for_each with
 // wl<katana::ParaMeter<> >
-template <class T, class FunctionTy, class ArgsTy>
-struct ForEachExecutor<katana::ParaMeter<T>, FunctionTy, ArgsTy>
-    : public parameter::ParaMeterExecutor<T, FunctionTy, ArgsTy> {
-  using SuperTy = parameter::ParaMeterExecutor<T, FunctionTy, ArgsTy>;
+template <
+    class T, parameter::SchedType SCHED, class FunctionTy, class ArgsTy>
+struct ForEachExecutor<katana::ParaMeter<T, SCHED>, FunctionTy, ArgsTy>
+    : public parameter::ParaMeterExecutor<T, FunctionTy, ArgsTy, SCHED> {
+  using SuperTy = parameter::ParaMeterExecutor<T, FunctionTy, ArgsTy, SCHED>;
   ForEachExecutor(const FunctionTy& f, const ArgsTy& args) : SuperTy(f, args) {}
 };
 
@@ -462,12 +480,33 @@ for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
 
   using Tpl_ty = decltype(tpl);
 
-  using Exec = parameter::ParaMeterExecutor<T, F, Tpl_ty>;
+  using Exec =
+      parameter::ParaMeterExecutor<T, F, Tpl_ty, parameter::SchedType::FIFO>;
   Exec exec(func, tpl);
 
-  exec.execute(range);
+  exec.init(range);
 }
 
+namespace parameter {
+
+//! Run a for_each loop in FIFO steps for the enabled ProfileScope, whatever
+//! its worklist; see ProfileScope
+template <typename R, typename F, typename ArgsTuple>
+void
+ProfileForEach(const R& range, const F& func, const ArgsTuple& argsTuple) {
+  using T = typename std::iterator_traits<typename R::iterator>::value_type;
+
+  auto tpl =
+      std::tuple_cat(argsTuple, typename function_traits<F>::type{});
+  using Tpl_ty = decltype(tpl);
+
+  ParaMeterExecutor<T, F, Tpl_ty, SchedType::FIFO> exec(
+      func, tpl, internal::IsStatsFileSet());
+  exec.init(range);
+}
+
+}  // namespace parameter
+
 }  // end namespace katana
 #endif
 
@@ -0,0 +1,306 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+#define KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/Cancel.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The active nodes of one round of a level synchronous algorithm.
+///
+/// A frontier is stored as a sparse bag of nodes while it is small and as a
+/// dense bitmap over all nodes once it holds more than a fraction of them.
+/// Pushing and iterating a sparse frontier costs time proportional to its
+/// size, while a dense frontier costs a pass over the bitmap but no
+/// allocation and drops duplicate pushes. Adapt switches between the two
+/// based on the current size; SynchronousFrontierLoop and
+/// SynchronousPushPullFrontierLoop call it after every round.
+///
+/// Push may be called concurrently; the other methods may not be called
+/// concurrently with each other or with Push.
+class Frontier {
+public:
+  using Node = GraphTopology::Node;
+
+  /// By default a frontier is dense while it holds more than 1/20 of the
+  /// nodes
+  static constexpr uint64_t kDefaultDenseDivisor = 20;
+
+  explicit Frontier(
+      uint64_t num_nodes, uint64_t dense_divisor = kDefaultDenseDivisor)
+      : num_nodes_(num_nodes),
+        dense_divisor_(dense_divisor),
+        dense_threshold_(num_nodes / std::max<uint64_t>(dense_divisor, 1)) {
+    bits_.resize(num_nodes);
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+
+  uint64_t dense_divisor() const { return dense_divisor_; }
+
+  bool is_dense() const { return is_dense_; }
+
+  /// The number of nodes pushed since the last Clear. A sparse frontier
+  /// counts a node once per push; a dense one counts it once.
+  uint64_t size() const { return size_.reduce(); }
+
+  bool empty() const { return size() == 0; }
+
+  /// Add node to the frontier. Returns false if the frontier is dense and
+  /// already contained node.
+  bool Push(Node node) {
+    if (is_dense_) {
+      if (bits_.set(node)) {
+        return false;
+      }
+    } else {
+      sparse_.push(node);
+    }
+    size_ += 1;
+    return true;
+  }
+
+  /// Whether node was pushed; only valid for dense frontiers
+  bool Contains(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(is_dense_);
+    return bits_.test(node);
+  }
+
+  /// Remove all nodes, keeping the current representation
+  void Clear() {
+    if (is_dense_) {
+      ClearBits();
+    } else {
+      sparse_.clear();
+    }
+    size_.reset();
+  }
+
+  /// Remove all nodes and use the dense representation if dense is true
+  void Clear(bool dense) {
+    Clear();
+    is_dense_ = dense;
+  }
+
+  /// Switch to the dense representation if the frontier holds more than the
+  /// dense threshold and to the sparse one otherwise
+  void Adapt() {
+    uint64_t size = this->size();
+    if (!is_dense_ && size > dense_threshold_) {
+      katana::do_all(
+          katana::iterate(sparse_), [&](Node n) { bits_.set(n); },
+          katana::no_stats());
+      sparse_.clear();
+      is_dense_ = true;
+      size_.reset();
+      size_ += bits_.count();
+    } else if (is_dense_ && size <= dense_threshold_) {
+      ForEachDense([&](Node n) { sparse_.push(n); });
+      ClearBits();
+      is_dense_ = false;
+    }
+  }
+
+  /// Call fn(node) in parallel for every node in the frontier
+  template <typename F>
+  void ForEach(const F& fn) const {
+    if (is_dense_) {
+      ForEachDense(fn);
+    } else {
+      // Iterating the bag directly gives each thread its own pushes, so
+      // split it into runs that idle threads can steal
+      auto chunks = sparse_.Chunks(kChunkSize);
+      katana::do_all(
+          katana::iterate(chunks),
+          [&](const auto& chunk) {
+            for (Node n : chunk) {
+              fn(n);
+            }
+          },
+          katana::steal(), katana::no_stats());
+    }
+  }
+
+private:
+  static constexpr unsigned kChunkSize = 64U;
+
+  template <typename F>
+  void ForEachDense(const F& fn) const {
+    bits_.ForEachSetBit([&](size_t n) { fn(static_cast<Node>(n)); });
+  }
+
+  void ClearBits() {
+    auto& words = bits_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) { words[w] = 0; }, katana::no_stats());
+  }
+
+  uint64_t num_nodes_;
+  uint64_t dense_divisor_;
+  uint64_t dense_threshold_;
+  bool is_dense_{false};
+  DynamicBitset bits_;
+  // Mutable so that ForEach can iterate over the per-thread parts of the bag
+  mutable InsertBag<Node> sparse_;
+  mutable GAccumulator<uint64_t> size_;
+};
+
+/// The default number of edges above which ForEachFrontierEdge splits the
+/// edges of a node into tiles
+constexpr size_t kDefaultFrontierEdgeTileSize = 512;
+
+/// Call fn(src, edge) in parallel for every out edge of every node src in
+/// frontier.
+///
+/// Nodes with at most tile_size edges are expanded by the thread that visits
+/// them. The edges of nodes with more are split into tiles of tile_size
+/// edges that threads steal from each other, so a few hubs do not leave
+/// one thread scanning their edges while the others are idle.
+template <typename Graph, typename F>
+void
+ForEachFrontierEdge(
+    const Graph& graph, const Frontier& frontier, const F& fn,
+    size_t tile_size = kDefaultFrontierEdgeTileSize,
+    const char* loopname = "ForEachFrontierEdge") {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  struct Tile {
+    Node src;
+    Edge begin;
+    Edge end;
+  };
+  tile_size = std::max<size_t>(tile_size, 1);
+
+  InsertBag<Tile> tiles;
+  frontier.ForEach([&](Node src) {
+    auto edges = graph.edges(src);
+    Edge begin = *edges.begin();
+    Edge end = *edges.end();
+    if (end - begin <= tile_size) {
+      for (Edge e = begin; e < end; ++e) {
+        fn(src, e);
+      }
+      return;
+    }
+    while (begin < end) {
+      Edge tile_end = begin + std::min<Edge>(tile_size, end - begin);
+      tiles.push(Tile{src, begin, tile_end});
+      begin = tile_end;
+    }
+  });
+
+  if (tiles.empty()) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(tiles),
+      [&](const Tile& tile) {
+        for (Edge e = tile.begin; e < tile.end; ++e) {
+          fn(tile.src, e);
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::loopname(loopname));
+}
+
+namespace internal {
+
+/// Call round(curr, &next) until a round pushes no nodes into next or
+/// katana::CancelRequested, swapping the frontiers after every round.
+/// Returns the number of rounds.
+template <typename F>
+uint64_t
+RunFrontierRounds(Frontier* frontier, const F& round) {
+  Frontier other(frontier->num_nodes(), frontier->dense_divisor());
+  Frontier* curr = frontier;
+  Frontier* next = &other;
+  uint64_t rounds = 0;
+  curr->Adapt();
+  while (!curr->empty() && !katana::CancelRequested()) {
+    // Frontiers usually grow and shrink gradually, so the next one starts
+    // out in the representation of the current one
+    next->Clear(curr->is_dense());
+    round(*curr, next);
+    next->Adapt();
+    curr->Clear();
+    std::swap(curr, next);
+    ++rounds;
+  }
+  return rounds;
+}
+
+}  // namespace internal
+
+/// Run a level synchronous loop from the nodes in frontier.
+///
+/// Each round calls fn(src, edge, &next) for every out edge of the nodes
+/// in the current frontier, using ForEachFrontierEdge, where fn pushes the
+/// nodes of the following round into next. The loop ends after a round that
+/// pushes no nodes, leaving frontier empty, or once katana::CancelRequested.
+/// Returns the number of rounds.
+template <typename Graph, typename F>
+uint64_t
+SynchronousFrontierLoop(
+    const Graph& graph, Frontier* frontier, const F& fn,
+    size_t tile_size = kDefaultFrontierEdgeTileSize,
+    const char* loopname = "SynchronousFrontierLoop") {
+  return internal::RunFrontierRounds(
+      frontier, [&](const Frontier& curr, Frontier* next) {
+        ForEachFrontierEdge(
+            graph, curr,
+            [&](GraphTopology::Node src, GraphTopology::Edge edge) {
+              fn(src, edge, next);
+            },
+            tile_size, loopname);
+      });
+}
+
+/// Run a level synchronous loop that pushes from sparse frontiers and pulls
+/// into the next frontier from dense ones.
+///
+/// Rounds whose frontier is sparse call push(src, edge, &next) like
+/// SynchronousFrontierLoop. Rounds whose frontier is dense instead call
+/// pull(node, curr, &next) once for every node of graph; pull skips the
+/// nodes that cannot join the next frontier and looks for the others'
+/// parents among their in edges with curr.Contains. A pull round touches
+/// every node but writes each node from one thread only, so it beats
+/// pushing once the frontier holds a large fraction of the nodes; the
+/// dense divisor of frontier sets that fraction.
+template <typename Graph, typename PushFn, typename PullFn>
+uint64_t
+SynchronousPushPullFrontierLoop(
+    const Graph& graph, Frontier* frontier, const PushFn& push,
+    const PullFn& pull, size_t tile_size = kDefaultFrontierEdgeTileSize,
+    const char* loopname = "SynchronousPushPullFrontierLoop") {
+  using Node = GraphTopology::Node;
+  return internal::RunFrontierRounds(
+      frontier, [&](const Frontier& curr, Frontier* next) {
+        if (!curr.is_dense()) {
+          ForEachFrontierEdge(
+              graph, curr,
+              [&](Node src, GraphTopology::Edge edge) {
+                push(src, edge, next);
+              },
+              tile_size, loopname);
+          return;
+        }
+        katana::do_all(
+            katana::iterate(Node{0}, static_cast<Node>(curr.num_nodes())),
+            [&](Node node) { pull(node, curr, next); }, katana::steal(),
+            katana::loopname(loopname));
+      });
+}
+
+}  // namespace katana
+
+#endif
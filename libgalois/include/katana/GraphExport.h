@@ -0,0 +1,80 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHEXPORT_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHEXPORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/ParquetWriter.h"
+
+namespace katana {
+
+/// How ExportGraph lays out the tables of a graph
+struct KATANA_EXPORT ExportOptions {
+  enum Format {
+    kParquet,
+    kCsv,
+  };
+
+  /// 4 Mi rows per file
+  static constexpr uint64_t kDefaultRowsPerShard = UINT64_C(1) << 22;
+
+  Format format{kParquet};
+  /// The number of rows in each file but the last of a table. Shards are
+  /// encoded and stored concurrently, so there should be several per thread.
+  uint64_t rows_per_shard{kDefaultRowsPerShard};
+  /// Write the node table, not just the edges
+  bool nodes{true};
+  /// Write the node and edge properties as columns of their tables
+  bool properties{true};
+  /// The encoding of parquet files
+  tsuba::ParquetWriteOptions parquet{tsuba::ParquetWriteOptions::FromEnv()};
+  /// The field separator of CSV files
+  char csv_delimiter{','};
+  /// Start each CSV file with a line of column names
+  bool csv_header{true};
+
+  /// Space separated "src dst" lines without a header or properties, the
+  /// format of graph-convert's edge lists
+  static ExportOptions EdgeList() {
+    ExportOptions opts;
+    opts.format = kCsv;
+    opts.nodes = false;
+    opts.properties = false;
+    opts.csv_delimiter = ' ';
+    opts.csv_header = false;
+    return opts;
+  }
+};
+
+/// The files written by ExportGraph, in order of their rows
+struct KATANA_EXPORT ExportManifest {
+  std::vector<std::string> node_files;
+  std::vector<std::string> edge_files;
+};
+
+/// Write the nodes and edges of pg as tables sharded into files of
+/// opts.rows_per_shard rows in the directory dir (any tsuba URI), for
+/// systems that read tables rather than RDGs, e.g., Spark.
+///
+/// The node table, in files nodes-00000.parquet (or .csv), ..., has a uint32
+/// column "id" with the node IDs of pg, then a column "user_id" with the
+/// original IDs of the nodes if pg has them (see local_to_user_id), then the
+/// node properties. The edge table, in files edges-00000.parquet, ..., has
+/// uint32 columns "src" and "dst" with node IDs, then the edge properties.
+///
+/// Shards are sliced from the columns of pg without copying them, and are
+/// encoded and stored concurrently, one encoding per hardware thread, with
+/// stores going through FileStorage::PutAsync. CSV values are written as
+/// text; strings with the delimiter, quotes or line breaks are quoted, and
+/// nulls are empty.
+KATANA_EXPORT Result<ExportManifest> ExportGraph(
+    const PropertyGraph& pg, const std::string& dir,
+    const ExportOptions& opts = {});
+
+}  // namespace katana
+
+#endif
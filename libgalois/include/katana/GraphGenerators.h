@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Options shared by the synthetic graph generators.
+///
+/// Every generator draws the edges with random numbers that depend only on
+/// the seed and the number of the edge, and sorts the edges of each node by
+/// destination, so the same parameters give the same graph on any number of
+/// threads. Edges are generated twice, once to count them and once to place
+/// them, rather than being kept in an edge list, so a generator needs little
+/// memory beyond the topology it builds.
+struct GeneratorOptions {
+  uint64_t seed{0};
+  /// Add every edge in both directions
+  bool symmetric{false};
+  /// Drop edges from a node to itself
+  bool remove_self_loops{false};
+  /// If not zero, add a uint32 edge property named weight_property_name with
+  /// weights drawn uniformly from [1, max_weight]. The weight of an edge
+  /// depends only on the seed and its ends, so both directions of a
+  /// symmetric edge weigh the same.
+  uint32_t max_weight{0};
+  std::string weight_property_name{"weight"};
+};
+
+/// The probabilities of the four quadrants of the adjacency matrix that an
+/// R-MAT edge recurses into: a (top left), b (top right), c (bottom left)
+/// and 1 - a - b - c (bottom right).
+struct RmatParameters {
+  double a{0.57};
+  double b{0.19};
+  double c{0.19};
+};
+
+/// Generate an R-MAT graph with 2^scale nodes and num_edges edges (twice as
+/// many if symmetric) as in
+///
+///   Deepayan Chakrabarti, Yiping Zhan, and Christos Faloutsos. R-MAT: A
+///   Recursive Model for Graph Mining. SDM 2004.
+///
+/// If scramble is true, node ids are permuted so that the high degree nodes
+/// are not all at the start.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> GenerateRmat(
+    uint32_t scale, uint64_t num_edges, const RmatParameters& parameters = {},
+    bool scramble = true, const GeneratorOptions& options = {});
+
+/// Generate the Kronecker graph of the Graph500 benchmark: an R-MAT graph
+/// with 2^scale nodes, edge_factor * 2^scale edges, the Graph500 initiator
+/// (0.57, 0.19, 0.19, 0.05) and scrambled node ids.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> GenerateKronecker(
+    uint32_t scale, uint32_t edge_factor = 16,
+    const GeneratorOptions& options = {});
+
+/// Generate an Erdős–Rényi G(n, m) graph: num_edges edges (twice as many if
+/// symmetric) whose ends are drawn uniformly and independently from the
+/// num_nodes nodes.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> GenerateErdosRenyi(
+    uint32_t num_nodes, uint64_t num_edges,
+    const GeneratorOptions& options = {});
+
+/// Generate a graph from a stochastic block model. The nodes are divided
+/// into consecutive blocks of block_sizes[i] nodes, and about
+/// probabilities[i][j] * block_sizes[i] * block_sizes[j] edges go from
+/// block i to block j (twice as many if symmetric), with ends drawn
+/// uniformly within the blocks. The number of edges between two blocks is
+/// fixed rather than drawn edge by edge, so that graphs with billions of
+/// edges can be generated without visiting every pair of nodes.
+///
+/// If block_property_name is not empty, the block of each node is stored
+/// in a uint32 node property of that name.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>>
+GenerateStochasticBlockModel(
+    const std::vector<uint32_t>& block_sizes,
+    const std::vector<std::vector<double>>& probabilities,
+    const std::string& block_property_name = "block",
+    const GeneratorOptions& options = {});
+
+}  // namespace katana
+
+#endif
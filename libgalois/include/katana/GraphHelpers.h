@@ -19,11 +19,13 @@
 #ifndef KATANA_LIBGALOIS_KATANA_GRAPHHELPERS_H_
 #define KATANA_LIBGALOIS_KATANA_GRAPHHELPERS_H_
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
 
+#include "katana/Loops.h"
 #include "katana/PropertyGraph.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -602,6 +604,51 @@ determineUnitRangesFromPrefixSum(
   return returnRanges;
 }
 
+/**
+ * Split the edges of topology into one block of the same number of edges per
+ * thread and call <code>fn(node, edge_begin, edge_end)</code> for the part
+ * [edge_begin, edge_end) of the edges of each node in the block of the
+ * thread. Unlike the \ref edge_balanced option of do_all, which keeps nodes
+ * whole, a node whose edges cross a block boundary, such as a hub with more
+ * edges than a block, is split between the threads, so fn must combine the
+ * results of the parts of a node, e.g., with atomics or accumulators. Nodes
+ * without edges are skipped.
+ *
+ * @param topology graph or topology with <code>num_nodes()</code>,
+ * <code>num_edges()</code> and <code>edges(node)</code>
+ */
+template <typename Topology, typename FunctionTy>
+void
+ForEachEdgeBlock(const Topology& topology, const FunctionTy& fn) {
+  using Node = typename Topology::Node;
+  katana::on_each([&](unsigned tid, unsigned num_threads) {
+    uint64_t num_edges = topology.num_edges();
+    uint64_t edge = num_edges / num_threads * tid +
+                    num_edges % num_threads * tid / num_threads;
+    uint64_t block_end = num_edges / num_threads * (tid + 1) +
+                         num_edges % num_threads * (tid + 1) / num_threads;
+    if (edge == block_end) {
+      return;
+    }
+    auto edges_end = [&](uint64_t node) {
+      return uint64_t{*topology.edges(static_cast<Node>(node)).end()};
+    };
+
+    // The first node with an edge in the block
+    uint64_t node = *std::partition_point(
+        boost::counting_iterator<uint64_t>(0),
+        boost::counting_iterator<uint64_t>(topology.num_nodes()),
+        [&](uint64_t n) { return edges_end(n) <= edge; });
+    for (; edge < block_end; ++node) {
+      uint64_t part_end = std::min(edges_end(node), block_end);
+      if (part_end > edge) {
+        fn(static_cast<Node>(node), edge, part_end);
+        edge = part_end;
+      }
+    }
+  });
+}
+
 }  // end namespace katana
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHPLACEMENT_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHPLACEMENT_H_
+
+#include <functional>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/FileView.h"
+
+namespace katana {
+
+/// Policies for distributing the memory of a graph across NUMA nodes
+enum class MemoryPlacement {
+  /// Leave memory where it is, i.e., on the node of the thread that first
+  /// touched it
+  kFirstTouch,
+  /// Place the entries of node arrays on the node of the thread that
+  /// processes them in a do_all over the nodes of the graph, and the entries
+  /// of edge arrays on the node of the thread that processes their source
+  kBlocked,
+  /// Interleave pages round-robin across the nodes of all active threads
+  kInterleaved,
+};
+
+/// Move the topology and the fixed-width node and edge properties of pg into
+/// memory placed according to placement, so that parallel loops over the
+/// nodes of pg read mostly socket-local memory.
+///
+/// Threads are assigned blocks of nodes the same way that do_all assigns
+/// them initially, so kBlocked should be applied after setting the number of
+/// active threads and only matches loops over the whole graph. Properties
+/// that are not fixed-width (e.g., strings) or that consist of several
+/// chunks are left as they are.
+///
+/// Each array is copied, so this temporarily needs memory for a second copy
+/// of the largest array. If place_topology is false, only the properties are
+/// moved, e.g., because the topology was placed as it loaded (see
+/// TopologyFiller).
+KATANA_EXPORT Result<void> PlaceGraph(
+    PropertyGraph* pg, MemoryPlacement placement, bool place_topology = true);
+
+/// \returns a function for tsuba::RDGLoadOptions::fill_topology that reads a
+/// topology file into memory placed according to placement, or an empty
+/// function for kFirstTouch.
+///
+/// Unlike PlaceGraph, nothing is copied: the active threads fault in the
+/// pages of each range of the file that they own before the range is
+/// fetched into them, the node array first and then the edge array, whose
+/// blocks follow from the node array. Threads own the same blocks as with
+/// PlaceGraph, so the number of active threads should be set before loading.
+/// With kBlocked, the part of the file fetched with its header, which has to
+/// be read to find the arrays, goes to the first thread.
+KATANA_EXPORT std::function<Result<void>(tsuba::FileView*)> TopologyFiller(
+    MemoryPlacement placement);
+
+}  // namespace katana
+
+#endif
@@ -49,9 +49,45 @@ struct KATANA_EXPORT HWTopoInfo {
   std::vector<ThreadTopoInfo> threadTopoInfo;
 };
 
+/// Orders in which the threads of a thread pool are bound to hardware
+/// contexts. Thread i is bound to the i-th context of the order, so the
+/// order decides which contexts a run with fewer threads than contexts uses.
+enum class ThreadPlacement {
+  /// One context of each physical core, filling sockets one after another,
+  /// before any SMT siblings
+  kPhysicalCoresFirst,
+  /// All contexts of a core, including SMT siblings, and all cores of a
+  /// socket before the next socket
+  kCompact,
+  /// Cores round-robin across sockets, one context of each physical core
+  /// before any SMT siblings
+  kScatter,
+  /// Only the contexts of an explicit list of cpus, in the order given
+  kList,
+};
+
+/// Set the placement used by thread pools created afterwards. cpus are the
+/// OS ids of the contexts to use for kList; ids that are not in the cpuset of
+/// the process (see cpuset(7)) are ignored. Contexts outside the cpuset are
+/// never used by any placement.
+///
+/// The default is taken from the environment variable
+/// KATANA_THREAD_PLACEMENT (physical, compact, scatter or a cpu list in the
+/// format accepted by parseCPUList) and is kPhysicalCoresFirst when the
+/// variable is unset.
+KATANA_EXPORT void SetThreadPlacement(
+    ThreadPlacement placement, const std::vector<int>& cpus = {});
+
+/// Return the current placement and, if cpus is not null, its cpu list
+KATANA_EXPORT ThreadPlacement
+GetThreadPlacement(std::vector<int>* cpus = nullptr);
+
+KATANA_EXPORT std::string ThreadPlacementName(ThreadPlacement placement);
+
 /**
  * getHWTopo determines the machine topology from the process information
- * exposed in /proc and /dev filesystems.
+ * exposed in /proc and /dev filesystems. Threads are ordered according to
+ * the current thread placement.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
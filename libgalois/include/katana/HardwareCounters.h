@@ -0,0 +1,71 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HARDWARECOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_HARDWARECOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Count hardware events for every named parallel loop and report them to
+/// the StatManager under the loop name, next to the iteration counts of the
+/// loop. The events are the cycles, last level cache misses, data TLB misses
+/// and remote DRAM accesses (loads that missed the memory of the local NUMA
+/// node) of each thread that runs the loop. When loop telemetry is enabled,
+/// the totals also appear in the telemetry record of the loop.
+///
+/// The counters are read with perf_event_open, so they are only available
+/// on Linux and are subject to kernel.perf_event_paranoid. Each thread
+/// counts its own events in a group; events that the processor does not
+/// support are left out. If the kernel multiplexes the groups, the counts
+/// are scaled by the fraction of the time they were counting.
+///
+/// Counting is initially configured from the environment variable
+/// KATANA_LOOP_HARDWARE_COUNTERS. This function may not be called
+/// concurrently with a parallel loop.
+KATANA_EXPORT Result<void> EnableLoopHardwareCounters();
+
+/// Stop counting hardware events and release the counters.
+KATANA_EXPORT void DisableLoopHardwareCounters();
+
+/// Return true if hardware events are counted for named parallel loops.
+KATANA_EXPORT bool IsLoopHardwareCountersEnabled();
+
+namespace internal {
+
+enum HardwareEvent {
+  kCycles,
+  kLLCMisses,
+  kDTLBMisses,
+  kRemoteDRAMAccesses,
+  kNumHardwareEvents,
+};
+
+/// The StatManager category of each HardwareEvent
+KATANA_EXPORT const char* HardwareEventName(HardwareEvent event);
+
+/// The counts of the events of one thread. Events that could not be counted
+/// are not valid.
+struct HardwareCounterSample {
+  std::array<uint64_t, kNumHardwareEvents> values{};
+  std::array<bool, kNumHardwareEvents> valid{};
+};
+
+/// Open the counters of the first num_threads threads of the thread pool
+/// that do not have them yet. Must be called from outside of parallel
+/// loops.
+KATANA_EXPORT void OpenLoopHardwareCounters(unsigned num_threads);
+
+/// Read the counters of thread tid. Any thread may read the counters of any
+/// other. Returns false if the thread has no counters.
+KATANA_EXPORT bool ReadLoopHardwareCounters(
+    unsigned tid, HardwareCounterSample* sample);
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
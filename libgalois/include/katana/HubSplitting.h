@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HUBSPLITTING_H_
+#define KATANA_LIBGALOIS_KATANA_HUBSPLITTING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Call fn(virtual_node, edge_begin, edge_end) for each virtual node of view
+/// in parallel, where [edge_begin, edge_end) are the out-edges of the
+/// virtual node in the topology; view.node(virtual_node) is the node it is
+/// part of. No call gets more than view.max_degree edges, so the edges of
+/// hubs are spread over threads. args are passed on to do_all.
+template <typename FunctionTy, typename... Args>
+void
+ForEachVirtualNode(
+    const HubSplitView& view, const FunctionTy& fn, Args&&... args) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_virtual_nodes()),
+      [&](uint64_t v) {
+        auto [begin, end] = view.edge_range(v);
+        fn(v, begin, end);
+      },
+      std::forward<Args>(args)...);
+}
+
+/// Call fn(hub, virtual_node) for each virtual node of each hub of view, in
+/// parallel over the hubs, so that fn can merge the per virtual node slots
+/// that pushes updated at HubSplitView::PushTarget into their hub without
+/// synchronization. Nodes that are not split have a single slot and need no
+/// merge.
+template <typename FunctionTy>
+void
+ForEachHubReplica(const HubSplitView& view, const FunctionTy& fn) {
+  katana::do_all(
+      katana::iterate(view.hubs.begin(), view.hubs.end()),
+      [&](uint32_t hub) {
+        auto [begin, end] = view.virtual_nodes(hub);
+        for (uint64_t v = begin; v < end; ++v) {
+          fn(hub, v);
+        }
+      },
+      katana::no_stats(), katana::loopname("ForEachHubReplica"));
+}
+
+/// Replace pg with the graph of the virtual nodes of
+/// pg->SplitHubs(max_degree), so that analytics that know nothing of the
+/// split see no node with more than max_degree out-edges.
+///
+/// Virtual node v gets the out-edges of its part of its node, in the same
+/// order, so edge properties are unchanged. An edge from virtual node v to
+/// node dest goes to HubSplitView::PushTarget(dest, v), so the in-edges of a
+/// hub are spread over its virtual nodes too. Each virtual node gets a copy
+/// of the node properties of its node, and its node is stored in the new
+/// uint32 node property parent_property_name, by which results can be
+/// merged back. Any user and global ids are copied the same way.
+KATANA_EXPORT Result<void> SplitHubNodes(
+    PropertyGraph* pg, uint64_t max_degree,
+    const std::string& parent_property_name);
+
+}  // namespace katana
+
+#endif
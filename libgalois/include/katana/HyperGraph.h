@@ -20,14 +20,68 @@
 #ifndef KATANA_LIBGALOIS_KATANA_HYPERGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_HYPERGRAPH_H_
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "katana/DynamicBitset.h"
 #include "katana/LC_CSR_Graph.h"
+#include "katana/ParallelSTL.h"
 
 namespace katana {
 template <typename NodeTy, bool HasNoLockable = true, bool UseNumaAlloc = true>
 class HyperGraph
     : public katana::LC_CSR_Graph<NodeTy, void, HasNoLockable, UseNumaAlloc> {
 public:
+  /**
+   * Constructs the hypergraph in parallel from its pins, the (hyperedge,
+   * node) pairs of nodes in hyperedges, with hyperedges in [0, hedges) and
+   * nodes in [0, hnodes). As in the rest of HyperGraph, hyperedges are
+   * graph nodes [0, hedges) and nodes are graph nodes [hedges, hedges +
+   * hnodes); the edges of each hyperedge go to its nodes in the order of
+   * pins.
+   *
+   * Pins are sorted by hyperedge with a stable radix sort, so the graph is
+   * filled without per-hyperedge lists or atomics.
+   */
+  void constructFromPins(
+      uint32_t hedges, uint32_t hnodes,
+      std::vector<std::pair<uint32_t, uint32_t>> pins) {
+    using Pin = std::pair<uint32_t, uint32_t>;
+    katana::ParallelSTL::radix_sort(
+        pins.begin(), pins.end(), [](const Pin& p) { return p.first; });
+    KATANA_LOG_DEBUG_ASSERT(pins.empty() || pins.back().first < hedges);
+
+    uint32_t num_nodes = hedges + hnodes;
+    this->allocateFrom(num_nodes, pins.size());
+    this->constructNodes();
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          this->edgeIndData[n] =
+              n < hedges ? std::upper_bound(
+                               pins.begin(), pins.end(), n,
+                               [](uint32_t h, const Pin& p) {
+                                 return h < p.first;
+                               }) -
+                               pins.begin()
+                         : pins.size();
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{pins.size()}),
+        [&](uint64_t e) {
+          KATANA_LOG_DEBUG_ASSERT(pins[e].second < hnodes);
+          this->edgeDst[e] = hedges + pins[e].second;
+        },
+        katana::no_stats());
+
+    this->initializeLocalRanges();
+    SetHedges(hedges);
+    SetHnodes(hnodes);
+  }
+
   uint32_t GetHedges() const { return hedges_; }
   void SetHedges(uint32_t hedges) { hedges_ = hedges; }
 
@@ -0,0 +1,94 @@
+#ifndef KATANA_LIBGALOIS_KATANA_INTERLEAVE_H_
+#define KATANA_LIBGALOIS_KATANA_INTERLEAVE_H_
+
+#include <array>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// How many tasks to keep in flight by default. Enough misses to fill the
+/// line fill buffers of a core, few enough that the data of every task stays
+/// in L1.
+constexpr unsigned kDefaultInterleaveWidth = 8;
+
+/// Run tasks with Width of them in flight, switching from one to the next
+/// after every step, so that the cache misses of different tasks overlap
+/// instead of each waiting on the previous one (asynchronous memory access
+/// chaining).
+///
+/// A task is a callable <code>bool ()</code> made by
+/// <code>make_task(item)</code>. Each call takes one step of the task,
+/// prefetches what the next step reads (e.g., with \ref katana::PrefetchRead)
+/// and returns whether there are steps left; a task should prefetch what its
+/// first step reads when it is made. By the time a task takes its next step,
+/// the other tasks have taken theirs and its data has had time to arrive.
+///
+/// \param next is a callable <code>bool (Item*)</code> that stores the next
+/// item to make a task from and returns true, or returns false if there are
+/// none left
+template <unsigned Width, typename Item, typename Next, typename MakeTask>
+void
+InterleaveTasks(Next&& next, MakeTask&& make_task) {
+  static_assert(Width > 0, "interleave width must be positive");
+  using Task = std::decay_t<std::invoke_result_t<MakeTask&, Item&>>;
+
+  std::array<std::optional<Task>, Width> tasks;
+  unsigned num_active = 0;
+  Item item;
+  for (auto& task : tasks) {
+    if (!next(&item)) {
+      break;
+    }
+    task.emplace(make_task(item));
+    ++num_active;
+  }
+
+  while (num_active > 0) {
+    for (unsigned i = 0; i < num_active;) {
+      if ((*tasks[i])()) {
+        ++i;
+        continue;
+      }
+      // Refill the finished slot, or move the last task into it so that
+      // active tasks stay packed at the front
+      if (next(&item)) {
+        tasks[i].emplace(make_task(item));
+        ++i;
+      } else {
+        --num_active;
+        if (i != num_active) {
+          tasks[i].emplace(std::move(*tasks[num_active]));
+        }
+        tasks[num_active].reset();
+      }
+    }
+  }
+}
+
+/// Run a task made by \param make_task for every item of [beg, end) with
+/// \ref InterleaveTasks
+template <unsigned Width = kDefaultInterleaveWidth, typename Iter,
+          typename MakeTask>
+void
+InterleaveTasks(Iter beg, Iter end, MakeTask&& make_task) {
+  using Item = std::decay_t<decltype(*beg)>;
+  InterleaveTasks<Width, Item>(
+      [&beg, &end](Item* item) {
+        if (beg == end) {
+          return false;
+        }
+        *item = *beg;
+        ++beg;
+        return true;
+      },
+      std::forward<MakeTask>(make_task));
+}
+
+}  // namespace katana
+
+#endif
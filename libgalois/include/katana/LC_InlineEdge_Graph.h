@@ -144,6 +144,7 @@ public:
   typedef NodeInfo* GraphNode;
   typedef EdgeTy edge_data_type;
   typedef FileEdgeTy file_edge_data_type;
+  typedef typename LargeArray<FileEdgeTy>::value_type file_edge_value_type;
   typedef NodeTy node_data_type;
   typedef typename EdgeInfo::reference edge_data_reference;
   typedef typename NodeInfoTypes::reference node_data_reference;
@@ -230,6 +231,44 @@ protected:
     edge->construct();
   }
 
+  template <
+      bool _A1 = EdgeInfo::has_value,
+      bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(
+      const file_edge_value_type* values, uint64_t nn, EdgeInfo* edge,
+      typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    if (!EdgeInfo::has_value)
+      return;
+    if (values)
+      edge->construct(values[nn]);
+    else
+      edge->construct();
+  }
+
+  template <
+      bool _A1 = EdgeInfo::has_value,
+      bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(
+      const file_edge_value_type*, uint64_t, EdgeInfo* edge,
+      typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edge->construct();
+  }
+
+  void allocate(uint64_t nodes, uint64_t edges) {
+    numNodes = nodes;
+    numEdges = edges;
+
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
   size_t getId(GraphNode N) { return std::distance(this->nodeData.data(), N); }
 
   GraphNode getNode(size_t n) { return &nodeData[n]; }
@@ -331,18 +370,11 @@ public:
 #endif
 
   void allocateFrom(FileGraph& graph) {
-    numNodes = graph.size();
-    numEdges = graph.sizeEdges();
+    allocate(graph.size(), graph.sizeEdges());
+  }
 
-    if (UseNumaAlloc) {
-      nodeData.allocateBlocked(numNodes);
-      edgeData.allocateBlocked(numEdges);
-      this->outOfLineAllocateBlocked(numNodes);
-    } else {
-      nodeData.allocateInterleaved(numNodes);
-      edgeData.allocateInterleaved(numEdges);
-      this->outOfLineAllocateInterleaved(numNodes);
-    }
+  void allocateFrom(const GraphTopology& topology) {
+    allocate(topology.num_nodes(), topology.num_edges());
   }
 
   void constructFrom(FileGraph& graph, unsigned tid, unsigned total) {
@@ -371,6 +403,40 @@ public:
       nodeData[*ii].edgeEnd() = curEdge;
     }
   }
+
+  /**
+   * Constructs the share of thread tid of the nodes of topology and their
+   * edges. The value of edge e is values[e], or default constructed if
+   * values is null.
+   */
+  void constructFrom(
+      const GraphTopology& topology, const file_edge_value_type* values,
+      unsigned tid, unsigned total) {
+    const uint64_t* indices = topology.out_indices->raw_values();
+    auto r = divideNodesBinarySearch(
+                 numNodes, numEdges,
+                 NodeData::size_of::value +
+                     LC_InlineEdge_Graph::size_of_out_of_line::value,
+                 EdgeData::size_of::value, tid, total, indices)
+                 .first;
+    this->setLocalRange(*r.first, *r.second);
+    if (r.first == r.second)
+      return;
+
+    EdgeInfo* curEdge = edgeData.data() + *topology.edges(*r.first).begin();
+
+    for (auto ii = r.first, ei = r.second; ii != ei; ++ii) {
+      nodeData.constructAt(*ii);
+      this->outOfLineConstructAt(*ii);
+      nodeData[*ii].edgeBegin() = curEdge;
+      for (auto nn : topology.edges(*ii)) {
+        constructEdgeValue(values, nn, curEdge);
+        setEdgeDst(nodeData, curEdge, topology.edge_dest(nn));
+        ++curEdge;
+      }
+      nodeData[*ii].edgeEnd() = curEdge;
+    }
+  }
 };
 
 }  // namespace katana
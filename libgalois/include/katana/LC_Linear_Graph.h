@@ -149,6 +149,7 @@ public:
   typedef NodeInfo* GraphNode;
   typedef EdgeTy edge_data_type;
   typedef FileEdgeTy file_edge_data_type;
+  typedef typename LargeArray<FileEdgeTy>::value_type file_edge_value_type;
   typedef NodeTy node_data_type;
   typedef typename NodeInfoTypes::reference node_data_reference;
   typedef typename EdgeInfo::reference edge_data_reference;
@@ -208,6 +209,57 @@ protected:
     edge->construct();
   }
 
+  template <
+      bool _A1 = EdgeInfo::has_value,
+      bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(
+      const file_edge_value_type* values, uint64_t nn, EdgeInfo* edge,
+      typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    if (!EdgeInfo::has_value)
+      return;
+    if (values)
+      edge->construct(values[nn]);
+    else
+      edge->construct();
+  }
+
+  template <
+      bool _A1 = EdgeInfo::has_value,
+      bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(
+      const file_edge_value_type*, uint64_t, EdgeInfo* edge,
+      typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edge->construct();
+  }
+
+  void allocate(uint64_t num_nodes, uint64_t num_edges) {
+    numNodes = num_nodes;
+    numEdges = num_edges;
+    if (UseNumaAlloc) {
+      data.allocateLocal(
+          sizeof(NodeInfo) * numNodes * 2 + sizeof(EdgeInfo) * numEdges);
+      nodes.allocateLocal(numNodes);
+      this->outOfLineAllocateLocal(numNodes);
+    } else {
+      data.allocateInterleaved(
+          sizeof(NodeInfo) * numNodes * 2 + sizeof(EdgeInfo) * numEdges);
+      nodes.allocateInterleaved(numNodes);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
+  /// The nodes of topology that thread tid constructs
+  auto divideByNode(
+      const GraphTopology& topology, unsigned tid, unsigned total) {
+    const uint64_t* indices = topology.out_indices->raw_values();
+    return divideNodesBinarySearch(
+               numNodes, numEdges,
+               Nodes::size_of::value + 2 * sizeof(NodeInfo) +
+                   LC_Linear_Graph::size_of_out_of_line::value,
+               sizeof(EdgeInfo), tid, total, indices)
+        .first;
+  }
+
   template <bool _Enable = HasId>
   size_t getId(GraphNode N, typename std::enable_if<_Enable>::type* = 0) {
     return N->getId();
@@ -318,19 +370,11 @@ public:
   }
 
   void allocateFrom(FileGraph& graph, const ReadGraphAuxData&) {
-    numNodes = graph.size();
-    numEdges = graph.sizeEdges();
-    if (UseNumaAlloc) {
-      data.allocateLocal(
-          sizeof(NodeInfo) * numNodes * 2 + sizeof(EdgeInfo) * numEdges);
-      nodes.allocateLocal(numNodes);
-      this->outOfLineAllocateLocal(numNodes);
-    } else {
-      data.allocateInterleaved(
-          sizeof(NodeInfo) * numNodes * 2 + sizeof(EdgeInfo) * numEdges);
-      nodes.allocateInterleaved(numNodes);
-      this->outOfLineAllocateInterleaved(numNodes);
-    }
+    allocate(graph.size(), graph.sizeEdges());
+  }
+
+  void allocateFrom(const GraphTopology& topology, const ReadGraphAuxData&) {
+    allocate(topology.num_nodes(), topology.num_edges());
   }
 
   void constructNodesFrom(
@@ -382,6 +426,53 @@ public:
       }
     }
   }
+
+  /**
+   * Constructs the share of thread tid of the nodes of topology, which are
+   * laid out as for a FileGraph with the same topology
+   */
+  void constructNodesFrom(
+      const GraphTopology& topology, unsigned tid, unsigned total,
+      const ReadGraphAuxData&) {
+    auto r = divideByNode(topology, tid, total);
+
+    this->setLocalRange(*r.first, *r.second);
+    if (r.first == r.second)
+      return;
+    NodeInfo* curNode = reinterpret_cast<NodeInfo*>(data.data());
+
+    size_t id = *r.first;
+    size_t edges = *topology.edges(*r.first).begin();
+    size_t bytes = edges * sizeof(EdgeInfo) + 2 * (id + 1) * sizeof(NodeInfo);
+    curNode += bytes / sizeof(NodeInfo);
+    for (auto ii = r.first, ei = r.second; ii != ei; ++ii, ++id) {
+      nodes.constructAt(*ii);
+      new (curNode) NodeInfo();
+      curNode->setId(id);
+      curNode->numEdges = topology.edges(*ii).size();
+      nodes[*ii] = curNode;
+      curNode = curNode->next();
+    }
+  }
+
+  /**
+   * Constructs the edges of the nodes constructed by thread tid. The value of
+   * edge e is values[e], or default constructed if values is null.
+   */
+  void constructEdgesFrom(
+      const GraphTopology& topology, const file_edge_value_type* values,
+      unsigned tid, unsigned total, const ReadGraphAuxData&) {
+    auto r = divideByNode(topology, tid, total);
+
+    for (auto ii = r.first, ei = r.second; ii != ei; ++ii) {
+      EdgeInfo* edge = nodes[*ii]->edgeBegin();
+      for (auto nn : topology.edges(*ii)) {
+        constructEdgeValue(values, nn, edge);
+        edge->dst = nodes[topology.edge_dest(nn)];
+        ++edge;
+      }
+    }
+  }
 };
 
 }  // namespace katana
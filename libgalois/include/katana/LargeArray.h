@@ -48,10 +48,10 @@ class LargeArray {
     size_ = n;
     switch (t) {
     case AllocType::Blocked:
-      real_data_ = largeMallocBlocked(n * sizeof(T), activeThreads);
+      real_data_ = largeMallocBlocked(n * sizeof(T), getActiveThreads());
       break;
     case AllocType::Interleaved:
-      real_data_ = largeMallocInterleaved(n * sizeof(T), activeThreads);
+      real_data_ = largeMallocInterleaved(n * sizeof(T), getActiveThreads());
       break;
     case AllocType::Local:
       real_data_ = largeMallocLocal(n * sizeof(T));
@@ -163,8 +163,8 @@ public:
   void allocateSpecified(size_type num, RangeArray& ranges) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
 
-    real_data_ =
-        largeMallocSpecified(num * sizeof(T), activeThreads, ranges, sizeof(T));
+    real_data_ = largeMallocSpecified(
+        num * sizeof(T), getActiveThreads(), ranges, sizeof(T));
 
     size_ = num;
     data_ = reinterpret_cast<T*>(real_data_.get());
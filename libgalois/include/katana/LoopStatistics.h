@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 
+#include "katana/LoopTelemetry.h"
 #include "katana/Statistics.h"
 #include "katana/config.h"
 
@@ -43,6 +44,8 @@ public:
     ReportStatSum(loopname, "Commits", (m_iterations - m_conflicts));
     ReportStatSum(loopname, "Pushes", m_pushes);
     ReportStatSum(loopname, "Conflicts", m_conflicts);
+    internal::ReportLoopTelemetry(
+        loopname, m_iterations, m_pushes, m_conflicts, 0);
   }
 
   size_t iterations() const { return m_iterations; }
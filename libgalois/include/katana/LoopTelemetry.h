@@ -0,0 +1,76 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPTELEMETRY_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPTELEMETRY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Stream a JSON record for every named parallel loop to path as soon as the
+/// loop finishes, one record per line. A path of "-" writes to standard
+/// error and an empty path turns telemetry off.
+///
+/// Unlike the statistics collected by StatManager, which are only printed at
+/// PrintStats, these records are written while the program runs so that
+/// long-running processes can be monitored. Each record contains the loop
+/// name, the kind of loop (do_all or for_each), the wall time, and the
+/// per-thread iteration counts together with the imbalance (maximum over
+/// mean of the per-thread iterations), the number of successful steals
+/// (do_all only), and the number of worklist pushes and conflicts (for_each
+/// only). When hardware counters are enabled with
+/// EnableLoopHardwareCounters, records also hold the totals of the counted
+/// events.
+///
+/// Telemetry is initially configured from the environment variable
+/// KATANA_LOOP_TELEMETRY. Only loops with a loopname are reported.
+KATANA_EXPORT void SetLoopTelemetryFile(const std::string& path);
+
+/// Return true if loop telemetry records are being written.
+KATANA_EXPORT bool IsLoopTelemetryEnabled();
+
+namespace internal {
+
+class KATANA_EXPORT LoopTelemetrySpanBase {
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+
+public:
+  LoopTelemetrySpanBase(const char* loopname, const char* kind);
+  ~LoopTelemetrySpanBase();
+
+  LoopTelemetrySpanBase(const LoopTelemetrySpanBase&) = delete;
+  LoopTelemetrySpanBase& operator=(const LoopTelemetrySpanBase&) = delete;
+  LoopTelemetrySpanBase(LoopTelemetrySpanBase&&) = delete;
+  LoopTelemetrySpanBase& operator=(LoopTelemetrySpanBase&&) = delete;
+};
+
+/// LoopTelemetrySpan marks the extent of a parallel loop. When telemetry is
+/// enabled, the record for the loop is written when the span is destroyed.
+/// Spans do not nest; only the outermost loop is reported.
+template <bool Enable>
+class LoopTelemetrySpan : public LoopTelemetrySpanBase {
+public:
+  LoopTelemetrySpan(const char* loopname, const char* kind)
+      : LoopTelemetrySpanBase(loopname, kind) {}
+};
+
+template <>
+class LoopTelemetrySpan<false> {
+public:
+  LoopTelemetrySpan(const char*, const char*) {}
+};
+
+/// Add the counters of the calling thread to the span of loop loopname, if
+/// one is open. Called once per thread at the end of a loop.
+KATANA_EXPORT void ReportLoopTelemetry(
+    const char* loopname, uint64_t iterations, uint64_t pushes,
+    uint64_t conflicts, uint64_t steals);
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
@@ -51,6 +51,10 @@ template <typename Range, typename FunctionTy, typename... Args>
 void
 for_each(const Range& range, FunctionTy&& fn, Args&&... args) {
   auto tpl = std::make_tuple(std::forward<Args>(args)...);
+  if (parameter::IsProfiling()) {
+    parameter::ProfileForEach(range, fn, tpl);
+    return;
+  }
   for_each_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
@@ -48,6 +48,56 @@ typedef katana::BumpWithMallocHeap<katana::FreeListHeap<katana::SystemHeap>>
 typedef katana::ExternalHeapAllocator<char, IterAllocBaseTy> PerIterAllocTy;
 //! [PerIterAllocTy example]
 
+//! Arena of one thread. Freed blocks are kept by the arena for reuse, so
+//! rewinding does not go back to the page pool.
+typedef katana::ArenaHeap<katana::FreeListHeap<katana::SystemHeap>>
+    ArenaHeapTy;
+
+//! STL allocator for T that allocates from an arena
+template <typename T>
+using ArenaAllocator = katana::ExternalHeapAllocator<T, ArenaHeapTy>;
+
+/**
+ * Per-thread arenas for the temporaries of parallel loop bodies. Containers
+ * built inside a body can allocate from the arena of the executing thread
+ * through an ArenaScope instead of going to the global allocator:
+ *
+ *     katana::PerThreadArena arena;
+ *     katana::do_all(katana::iterate(graph), [&](GNode n) {
+ *       katana::ArenaScope scope{arena};
+ *       std::vector<uint32_t, katana::ArenaAllocator<uint32_t>> tmp{
+ *           scope.allocator<uint32_t>()};
+ *       ...
+ *     });
+ *
+ * Memory is only released when the scope ends, so containers that grow
+ * repeatedly keep their old buffers until then.
+ */
+class PerThreadArena {
+  katana::PerThreadStorage<ArenaHeapTy> heaps_;
+
+public:
+  ArenaHeapTy& local() { return *heaps_.getLocal(); }
+};
+
+//! Releases everything allocated from the local arena of a PerThreadArena
+//! during its lifetime. Declare it before the containers that use it.
+class ArenaScope : private boost::noncopyable {
+  ArenaHeapTy* heap_;
+  ArenaHeapTy::Mark mark_;
+
+public:
+  explicit ArenaScope(PerThreadArena& arena)
+      : heap_(&arena.local()), mark_(heap_->mark()) {}
+
+  ~ArenaScope() { heap_->rewind(mark_); }
+
+  template <typename T = char>
+  ArenaAllocator<T> allocator() const {
+    return ArenaAllocator<T>(heap_);
+  }
+};
+
 //! Scalable variable-sized allocator for T that allocates blocks of sizes in
 //! powers of 2 Useful for small and medium sized allocations, e.g. small or
 //! medium vectors, strings, deques
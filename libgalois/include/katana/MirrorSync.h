@@ -0,0 +1,235 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MIRRORSYNC_H_
+#define KATANA_LIBGALOIS_KATANA_MIRRORSYNC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Keeps a per-node value of a partitioned PropertyGraph (see Distribution)
+/// consistent between the masters and mirrors of its nodes, in the manner of
+/// Gluon's bulk-synchronous reduce and broadcast.
+///
+/// Values live in an array indexed by local node ID and a DynamicBitset of
+/// the same size tracks the nodes whose values changed (are dirty) since the
+/// last synchronization. Only dirty values are sent: each call sends at most
+/// one message to each other host, all exchanged with one
+/// CommBackend::AllToAll, and the positions of the dirty values in a message
+/// are encoded as whichever of an implicit "all", a bitmap or a list of
+/// varint deltas is smallest.
+///
+/// All hosts must call the same operations in the same order.
+class KATANA_EXPORT MirrorSync {
+public:
+  /// Prepare to synchronize the values of pg, a partition of a graph with
+  /// one partition per task of comm
+  static Result<MirrorSync> Make(const PropertyGraph& pg, CommBackend* comm);
+
+  /// Send the values of dirty mirrors to their masters and combine them with
+  /// reduce(T& master_value, const T& mirror_value), which returns true if it
+  /// changed the master value. Masters that changed become dirty and the
+  /// mirrors that were sent become clean.
+  ///
+  /// If reset is given, the values of the mirrors that were sent are set to
+  /// it afterwards, as when mirrors accumulate contributions (e.g., sums)
+  /// between rounds.
+  template <typename T, typename ReduceFn>
+  Result<void> Reduce(
+      T* values, DynamicBitset* dirty, ReduceFn reduce,
+      std::optional<T> reset = std::nullopt) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::vector<std::string> outgoing(num_hosts());
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      if (h == host_id()) {
+        continue;
+      }
+      std::vector<uint32_t> positions = DirtyPositions(mirrors_[h], *dirty);
+      Pack(values, mirrors_[h], positions, &outgoing[h]);
+      for (uint32_t p : positions) {
+        uint32_t node = mirrors_[h][p];
+        if (reset) {
+          values[node] = *reset;
+        }
+        dirty->reset(node);
+      }
+    }
+
+    auto incoming_res = Exchange(std::move(outgoing));
+    if (!incoming_res) {
+      return incoming_res.error();
+    }
+    std::vector<std::string> incoming = std::move(incoming_res.value());
+
+    // Each message has at most one value for a master, but messages from
+    // different hosts may update the same master, so they are applied one at
+    // a time
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      if (h == host_id()) {
+        continue;
+      }
+      auto res = Unpack<T>(
+          masters_[h], incoming[h], [&](uint32_t node, const T& value) {
+            if (reduce(values[node], value)) {
+              dirty->set(node);
+            }
+          });
+      if (!res) {
+        return res.error().WithContext("from host {}", h);
+      }
+    }
+    return ResultSuccess();
+  }
+
+  /// Send the values of dirty masters to the hosts that mirror them, which
+  /// store them in their mirrors. The dirty bits are not changed; callers
+  /// usually reset them once they are done with the round.
+  template <typename T>
+  Result<void> Broadcast(T* values, const DynamicBitset& dirty) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::vector<std::string> outgoing(num_hosts());
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      if (h != host_id()) {
+        Pack(
+            values, masters_[h], DirtyPositions(masters_[h], dirty),
+            &outgoing[h]);
+      }
+    }
+
+    auto incoming_res = Exchange(std::move(outgoing));
+    if (!incoming_res) {
+      return incoming_res.error();
+    }
+    std::vector<std::string> incoming = std::move(incoming_res.value());
+
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      if (h == host_id()) {
+        continue;
+      }
+      auto res = Unpack<T>(
+          mirrors_[h], incoming[h],
+          [&](uint32_t node, const T& value) { values[node] = value; });
+      if (!res) {
+        return res.error().WithContext("from host {}", h);
+      }
+    }
+    return ResultSuccess();
+  }
+
+  /// Reduce and then Broadcast, so that every mirror has the value of its
+  /// master
+  template <typename T, typename ReduceFn>
+  Result<void> Sync(
+      T* values, DynamicBitset* dirty, ReduceFn reduce,
+      std::optional<T> reset = std::nullopt) {
+    if (auto res = Reduce(values, dirty, reduce, reset); !res) {
+      return res.error();
+    }
+    return Broadcast(values, *dirty);
+  }
+
+  uint32_t num_hosts() const { return comm_->Num; }
+  uint32_t host_id() const { return comm_->ID; }
+
+  /// Total size of the messages this host sent
+  uint64_t bytes_sent() const { return bytes_sent_; }
+
+private:
+  MirrorSync(
+      CommBackend* comm, std::vector<std::vector<uint32_t>> masters,
+      std::vector<std::vector<uint32_t>> mirrors)
+      : comm_(comm),
+        masters_(std::move(masters)),
+        mirrors_(std::move(mirrors)) {}
+
+  /// Return the positions in nodes of the dirty nodes, in increasing order
+  static std::vector<uint32_t> DirtyPositions(
+      const std::vector<uint32_t>& nodes, const DynamicBitset& dirty);
+
+  /// Append the encoding of positions, a sorted subset of [0, list_size), to
+  /// out
+  static void EncodePositions(
+      const std::vector<uint32_t>& positions, uint64_t list_size,
+      std::string* out);
+
+  /// Decode positions encoded by EncodePositions from the beginning of in,
+  /// advancing in past them
+  static Result<std::vector<uint32_t>> DecodePositions(
+      std::string_view* in, uint64_t list_size);
+
+  template <typename T>
+  static void Pack(
+      const T* values, const std::vector<uint32_t>& nodes,
+      const std::vector<uint32_t>& positions, std::string* out) {
+    EncodePositions(positions, nodes.size(), out);
+    size_t begin = out->size();
+    out->resize(begin + positions.size() * sizeof(T));
+    char* data = out->data() + begin;
+    katana::do_all(
+        katana::iterate(size_t{0}, positions.size()),
+        [&](size_t i) {
+          std::memcpy(
+              data + i * sizeof(T), &values[nodes[positions[i]]], sizeof(T));
+        },
+        katana::no_stats());
+  }
+
+  /// Call fn(node, value) for each value in message, where node is the
+  /// element of nodes the value is for
+  template <typename T, typename F>
+  static Result<void> Unpack(
+      const std::vector<uint32_t>& nodes, std::string_view message, F fn) {
+    if (message.empty()) {
+      return ResultSuccess();
+    }
+    auto positions_res = DecodePositions(&message, nodes.size());
+    if (!positions_res) {
+      return positions_res.error();
+    }
+    const std::vector<uint32_t>& positions = positions_res.value();
+    if (message.size() != positions.size() * sizeof(T)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "message has {} bytes of values for {} positions", message.size(),
+          positions.size());
+    }
+    const char* data = message.data();
+    // Positions are distinct, so each node is visited once
+    katana::do_all(
+        katana::iterate(size_t{0}, positions.size()),
+        [&](size_t i) {
+          T value;
+          std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+          fn(nodes[positions[i]], value);
+        },
+        katana::no_stats());
+    return ResultSuccess();
+  }
+
+  /// AllToAll through comm_, counting the bytes sent
+  Result<std::vector<std::string>> Exchange(std::vector<std::string> outgoing);
+
+  CommBackend* comm_;
+  /// masters_[h] holds the local IDs of the masters that host h mirrors
+  std::vector<std::vector<uint32_t>> masters_;
+  /// mirrors_[h] holds the local IDs of the mirrors that host h owns, in the
+  /// same order as masters_ on host h
+  std::vector<std::vector<uint32_t>> mirrors_;
+  uint64_t bytes_sent_{0};
+};
+
+}  // namespace katana
+
+#endif
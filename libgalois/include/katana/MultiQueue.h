@@ -0,0 +1,244 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SimpleLock.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+template <
+    typename T, typename Compare, int C, int BufferSize, bool Concurrent>
+class MultiQueueMaster {
+  static_assert(C > 0, "MultiQueue needs at least one heap per thread");
+  static_assert(BufferSize > 0, "MultiQueue needs a positive buffer size");
+
+public:
+  template <typename _T>
+  using retype = MultiQueueMaster<_T, Compare, C, BufferSize, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread = MultiQueueMaster<T, Compare, C, BufferSize, _Concurrent>;
+
+  typedef T value_type;
+
+private:
+  struct alignas(KATANA_CACHE_LINE_SIZE) Heap {
+    SimpleLock lock;
+    std::vector<T> items;
+    //! items.size(), readable without the lock
+    std::atomic<size_t> size{0};
+  };
+
+  struct ThreadData {
+    //! Pushes not yet visible to other threads
+    std::vector<T> buffer;
+    uint64_t rng_state;
+  };
+
+  //! The std heap functions keep the greatest element first, so reverse cmp
+  //! to keep the element that comes first under cmp at the top
+  struct HeapCompare {
+    Compare cmp;
+    bool operator()(const T& a, const T& b) const { return cmp(b, a); }
+  };
+
+  HeapCompare heap_cmp_;
+  size_t num_heaps_;
+  std::unique_ptr<Heap[]> heaps_;
+  PerThreadStorage<ThreadData> data_;
+
+  /// xorshift64; good enough to spread threads over heaps
+  size_t RandomHeap(ThreadData& me) {
+    uint64_t x = me.rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    me.rng_state = x;
+    return x % num_heaps_;
+  }
+
+  /// True if the top of a should be popped before the top of b. Both locks
+  /// must be held.
+  bool Before(const Heap& a, const Heap& b) const {
+    if (a.items.empty()) {
+      return false;
+    }
+    return b.items.empty() || heap_cmp_(b.items.front(), a.items.front());
+  }
+
+  std::optional<value_type> PopLocked(Heap& h) {
+    if (h.items.empty()) {
+      return std::nullopt;
+    }
+    std::pop_heap(h.items.begin(), h.items.end(), heap_cmp_);
+    std::optional<value_type> ret(std::move(h.items.back()));
+    h.items.pop_back();
+    h.size.store(h.items.size(), std::memory_order_relaxed);
+    return ret;
+  }
+
+  /// Move the buffered pushes of this thread into one random heap
+  void Flush(ThreadData& me) {
+    if (me.buffer.empty()) {
+      return;
+    }
+    Heap& h = heaps_[RandomHeap(me)];
+    h.lock.lock();
+    for (auto& val : me.buffer) {
+      h.items.emplace_back(std::move(val));
+      std::push_heap(h.items.begin(), h.items.end(), heap_cmp_);
+    }
+    h.size.store(h.items.size(), std::memory_order_relaxed);
+    h.lock.unlock();
+    me.buffer.clear();
+  }
+
+  /// Pop the better top of two random heaps. Locks are taken in index order
+  /// so that concurrent pops cannot deadlock.
+  std::optional<value_type> PopTwoChoice(ThreadData& me) {
+    size_t i = RandomHeap(me);
+    size_t j = RandomHeap(me);
+    if (i == j) {
+      Heap& h = heaps_[i];
+      h.lock.lock();
+      auto ret = PopLocked(h);
+      h.lock.unlock();
+      return ret;
+    }
+    Heap& first = heaps_[std::min(i, j)];
+    Heap& second = heaps_[std::max(i, j)];
+    first.lock.lock();
+    second.lock.lock();
+    auto ret = PopLocked(Before(second, first) ? second : first);
+    second.lock.unlock();
+    first.lock.unlock();
+    return ret;
+  }
+
+  /// Visit every heap, starting at a random one, so that pop only reports
+  /// an empty worklist when all heaps looked empty
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<value_type> PopAny(ThreadData& me) {
+    size_t start = RandomHeap(me);
+    for (size_t k = 0; k < num_heaps_; ++k) {
+      Heap& h = heaps_[(start + k) % num_heaps_];
+      if (h.size.load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      h.lock.lock();
+      auto ret = PopLocked(h);
+      h.lock.unlock();
+      if (ret) {
+        return ret;
+      }
+    }
+    return std::nullopt;
+  }
+
+public:
+  explicit MultiQueueMaster(const Compare& cmp = Compare())
+      : heap_cmp_{cmp},
+        num_heaps_(Concurrent ? size_t{C} * getActiveThreads() : size_t{C}),
+        heaps_(std::make_unique<Heap[]>(num_heaps_)) {
+    for (unsigned tid = 0; tid < data_.size(); ++tid) {
+      ThreadData& d = *data_.getRemote(tid);
+      d.buffer.reserve(BufferSize);
+      // Any nonzero state works for xorshift
+      d.rng_state = 0x9e3779b97f4a7c15ULL * (tid + 1);
+    }
+  }
+
+  MultiQueueMaster(const MultiQueueMaster&) = delete;
+  MultiQueueMaster& operator=(const MultiQueueMaster&) = delete;
+
+  void push(const value_type& val) {
+    ThreadData& me = *data_.getLocal();
+    me.buffer.emplace_back(val);
+    if (me.buffer.size() >= size_t{BufferSize}) {
+      Flush(me);
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& me = *data_.getLocal();
+    me.buffer.insert(me.buffer.end(), b, e);
+    if (me.buffer.size() >= size_t{BufferSize}) {
+      Flush(me);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+    Flush(*data_.getLocal());
+  }
+
+  /// Pop the better of the two-choice pop and the best buffered push of this
+  /// thread. Buffered pushes are only visible to this thread, so it only
+  /// finds the worklist empty once its buffer is empty too.
+  std::optional<value_type> pop() {
+    ThreadData& me = *data_.getLocal();
+    std::optional<value_type> ret = PopTwoChoice(me);
+    if (me.buffer.empty()) {
+      return ret ? ret : PopAny(me);
+    }
+    auto best =
+        std::min_element(me.buffer.begin(), me.buffer.end(), heap_cmp_.cmp);
+    if (ret) {
+      if (heap_cmp_.cmp(*best, *ret)) {
+        std::swap(*best, *ret);
+      }
+      return ret;
+    }
+    std::swap(*best, me.buffer.back());
+    ret = std::move(me.buffer.back());
+    me.buffer.pop_back();
+    return ret;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Relaxed concurrent priority queue (Rihani, Sanders and Dementiev,
+ * "MultiQueues: Simple Relaxed Concurrent Priority Queues", SPAA 2015).
+ * There are C heaps per thread, each behind its own lock. A pop takes the
+ * better of the tops of two random heaps, so items come out close to, but
+ * not exactly in, priority order. A thread collects up to BufferSize pushes
+ * before moving them into a random heap under a single lock; until then its
+ * pops consider them along with the heap tops.
+ *
+ * Unlike \ref OrderedByIntegerMetric, priorities need not be integers:
+ * Compare is any strict weak ordering, with the item that compares first
+ * popped first. Since worklists are retyped, Compare should accept the
+ * retyped value_type; the transparent std::less<> does.
+ *
+ * @tparam Compare ordering of items; the default pops the smallest first
+ * @tparam C heaps per thread
+ * @tparam BufferSize pushes a thread collects before other threads see them
+ */
+template <
+    typename Compare = std::less<>, int C = 2, int BufferSize = 16,
+    typename T = int, bool Concurrent = true>
+using MultiQueue =
+    internal::MultiQueueMaster<T, Compare, C, BufferSize, Concurrent>;
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // end namespace katana
+
+#endif
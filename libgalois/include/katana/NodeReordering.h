@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NODEREORDERING_H_
+#define KATANA_LIBGALOIS_KATANA_NODEREORDERING_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Strategies for relabeling the nodes of a graph to improve the locality of
+/// graph traversals. All of them only look at outgoing edges; for the orders
+/// based on neighborhoods (BFS, RCM, Gorder) a symmetric graph gives the best
+/// results.
+enum class ReorderStrategy {
+  /// Order nodes by decreasing out degree (ties broken by node id)
+  kDegree,
+  /// Order nodes in breadth-first order, starting from node 0 and restarting
+  /// from the lowest unvisited node for each other component
+  kBFS,
+  /// Reverse Cuthill-McKee: a breadth-first order that starts each component
+  /// from a lowest degree node and visits neighbors by increasing degree,
+  /// reversed at the end. Tends to reduce the bandwidth of the adjacency
+  /// matrix.
+  kReverseCuthillMcKee,
+  /// A Gorder-like greedy order: the next node is the one with the most
+  /// edges to and common in-neighbors with the last few placed nodes, so that
+  /// nodes that are accessed together are close together
+  kGorder,
+  /// Hub clustering: nodes with more than the average out degree come first,
+  /// followed by all other nodes. Both groups keep their original relative
+  /// order.
+  kHubCluster,
+};
+
+/// Compute a new order of the nodes of topology.
+///
+/// \returns the permutation that maps each new node id to its old node id
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> ComputeNodeOrder(
+    const GraphTopology& topology, ReorderStrategy strategy);
+
+/// Relabel the nodes of pg with the given permutation.
+///
+/// Node properties are permuted along with the nodes. Edges keep their
+/// relative order within their source node, and edge properties are permuted
+/// along with the edges. Edges are not sorted by destination afterwards; use
+/// SortAllEdgesByDest if an algorithm needs them sorted.
+///
+/// The permutation is recorded in pg->local_to_user_id() (composed with any
+/// mapping already there) so that results can be related to the original
+/// node ids after the graph is written and loaded again.
+///
+/// \param new_to_old maps each new node id to its old node id
+KATANA_EXPORT Result<void> PermuteNodes(
+    PropertyGraph* pg, const std::shared_ptr<arrow::UInt64Array>& new_to_old);
+
+/// Parameters of PermuteNodesExternal
+struct ExternalPermuteOptions {
+  /// Directory for the temporary files; they are unlinked as soon as they
+  /// are created
+  std::string temp_dir{"/tmp"};
+  /// Bytes of memory the edges may use while they are permuted, besides the
+  /// arrays the result is written to. Smaller budgets mean more, smaller
+  /// temporary files.
+  uint64_t memory_budget{uint64_t{1} << 30};
+};
+
+/// Relabel the nodes of pg with the given permutation like PermuteNodes, for
+/// graphs whose edges do not fit in memory.
+///
+/// Only per-node arrays are kept in memory. The edges are streamed once,
+/// bucketed by their new source into temporary files that are written
+/// asynchronously, and the buckets are then merged in parallel into the new
+/// topology and edge permutation. Both live in memory mapped temporary files,
+/// so the operating system pages them out to disk rather than to swap. The
+/// properties and id mappings of pg are permuted as in PermuteNodes.
+///
+/// \param new_to_old maps each new node id to its old node id
+KATANA_EXPORT Result<void> PermuteNodesExternal(
+    PropertyGraph* pg, const std::shared_ptr<arrow::UInt64Array>& new_to_old,
+    const ExternalPermuteOptions& options = {});
+
+/// Relabel the nodes of pg in the order given by strategy. Equivalent to
+/// PermuteNodes(pg, ComputeNodeOrder(pg->topology(), strategy)).
+KATANA_EXPORT Result<void> ReorderNodes(
+    PropertyGraph* pg, ReorderStrategy strategy);
+
+}  // namespace katana
+
+#endif
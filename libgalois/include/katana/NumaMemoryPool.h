@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// NumaMemoryPool is an arrow::MemoryPool that places large buffers on the
+/// NUMA nodes of the threads that will read them, like LargeArray does.
+///
+/// Buffers of at least allocSize() bytes are made of huge pages from
+/// allocPages and faulted in according to the policy. Smaller buffers come
+/// from another pool, by default the default Arrow pool, which also frees
+/// the buffers that this pool did not allocate.
+///
+/// Spreading pages over threads runs a parallel section, so it is only done
+/// for allocations on the thread that attached the pool to the thread pool
+/// (see AttachToThreadPool) outside of parallel sections. Other allocations,
+/// e.g., on the I/O threads of Arrow, are faulted in by the calling thread.
+class KATANA_EXPORT NumaMemoryPool : public arrow::MemoryPool {
+public:
+  enum class Policy {
+    /// Each thread gets the pages of a contiguous block of the buffer, which
+    /// matches the static partitioning of do_all over nodes
+    kBlocked,
+    /// Pages are assigned to threads round robin
+    kInterleaved,
+    /// Pages are faulted in by the allocating thread
+    kLocal,
+  };
+
+  explicit NumaMemoryPool(
+      Policy policy,
+      arrow::MemoryPool* small_pool = arrow::default_memory_pool())
+      : policy_(policy), small_pool_(small_pool) {}
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override;
+  int64_t max_memory() const override {
+    return max_memory_.load(std::memory_order_relaxed);
+  }
+  std::string backend_name() const override { return "katana-numa"; }
+
+  Policy policy() const { return policy_.load(std::memory_order_relaxed); }
+  void set_policy(Policy policy) {
+    policy_.store(policy, std::memory_order_relaxed);
+  }
+
+  /// Let allocations on the calling thread spread pages over the threads of
+  /// the thread pool
+  void AttachToThreadPool() { owner_ = std::this_thread::get_id(); }
+  void DetachFromThreadPool() { owner_ = std::thread::id(); }
+
+private:
+  /// \returns the mapped size of buffer if this pool allocated it from huge
+  /// pages and 0 otherwise
+  size_t LargeSize(uint8_t* buffer);
+
+  std::atomic<Policy> policy_;
+  arrow::MemoryPool* small_pool_;
+  std::atomic<std::thread::id> owner_{};
+
+  std::mutex mutex_;
+  /// Mapped size of each buffer made of huge pages
+  std::unordered_map<uint8_t*, size_t> large_;
+  std::atomic<int64_t> large_bytes_{0};
+  std::atomic<int64_t> max_memory_{0};
+};
+
+/// \returns the pool that the runtime installs for Arrow buffers of tsuba
+/// loads and analytics outputs (see katana::SetArrowMemoryPool). Its policy
+/// is initially the value of the environment variable KATANA_NUMA_POOL_POLICY
+/// (blocked, interleaved or local) and blocked if it is not set.
+KATANA_EXPORT NumaMemoryPool* GetNumaMemoryPool();
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef KATANA_LIBGALOIS_KATANA_OCTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_OCTOPOLOGY_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/FileView.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace katana {
+
+struct OCTopologyOptions {
+  /// About how many edges each segment has; a segment holds whole nodes, so
+  /// a node with more edges gets a segment of its own
+  uint64_t segment_edges{UINT64_C(1) << 24};
+  /// How many bytes of edge destinations may stay in memory. Least recently
+  /// used segments are released beyond it, except those that are bound, so
+  /// the budget is exceeded while more segments are bound than fit in it.
+  uint64_t memory_budget{UINT64_C(1) << 30};
+  /// Start reading segment i + 1 in the background when segment i is bound
+  bool prefetch{true};
+};
+
+/// Counters of an OCTopology
+struct OCTopologyStats {
+  /// Binds of segments that were in memory or being prefetched
+  uint64_t hits{UINT64_C(0)};
+  /// Binds of segments that had to be read
+  uint64_t misses{UINT64_C(0)};
+  uint64_t prefetches{UINT64_C(0)};
+  uint64_t evictions{UINT64_C(0)};
+};
+
+/// The topology of a graph stored as an RDG, read one segment at a time so
+/// that graphs with more edges than fit in memory can be processed. The
+/// indices of the edges of each node are read when the topology is made;
+/// the destinations of the edges are read for the segments that are bound.
+/// This is the counterpart of OCFileGraph for RDGs; only the topology is out
+/// of core, edge properties are loaded with the graph as usual.
+///
+/// Segments can be bound from several threads at once.
+class KATANA_EXPORT OCTopology {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using node_iterator = GraphTopology::node_iterator;
+  using edge_iterator = GraphTopology::edge_iterator;
+  using nodes_range = GraphTopology::nodes_range;
+  using edges_range = GraphTopology::edges_range;
+
+  /// Consecutive nodes and their outgoing edges, which are consecutive too
+  struct Segment {
+    Node node_begin;
+    Node node_end;
+    Edge edge_begin;
+    Edge edge_end;
+
+    uint64_t num_edges() const { return edge_end - edge_begin; }
+  };
+
+  /// A segment whose edge destinations are in memory; it stays in memory as
+  /// long as the binding exists
+  class KATANA_EXPORT Binding {
+  public:
+    Binding(Binding&& other) noexcept;
+    Binding& operator=(Binding&& other) noexcept;
+    Binding(const Binding&) = delete;
+    Binding& operator=(const Binding&) = delete;
+    ~Binding();
+
+    const Segment& segment() const { return *segment_; }
+
+    nodes_range nodes() const {
+      return MakeStandardRange<node_iterator>(
+          segment_->node_begin, segment_->node_end);
+    }
+
+    edges_range edges(Node node) const {
+      KATANA_LOG_DEBUG_ASSERT(
+          node >= segment_->node_begin && node < segment_->node_end);
+      return topology_->edges(node);
+    }
+
+    Node edge_dest(Edge edge) const {
+      KATANA_LOG_DEBUG_ASSERT(
+          edge >= segment_->edge_begin && edge < segment_->edge_end);
+      return dests_[edge];
+    }
+
+  private:
+    friend class OCTopology;
+
+    Binding(OCTopology* topology, size_t index);
+
+    void Release();
+
+    OCTopology* topology_{nullptr};
+    size_t index_{0};
+    const Segment* segment_{nullptr};
+    const Node* dests_{nullptr};
+  };
+
+  /// Open the topology of the RDG \param rdg_name and divide it into
+  /// segments. Only RDGs with one partition and a version 1 topology are
+  /// supported.
+  static Result<std::unique_ptr<OCTopology>> Make(
+      const std::string& rdg_name, const OCTopologyOptions& opts = {});
+
+  OCTopology(const OCTopology&) = delete;
+  OCTopology& operator=(const OCTopology&) = delete;
+
+  uint64_t num_nodes() const { return prefix_.num_nodes(); }
+  uint64_t num_edges() const { return prefix_.num_edges(); }
+
+  /// The edges of \param node; their destinations can only be read through
+  /// a binding of the segment of node
+  edges_range edges(Node node) const {
+    return MakeStandardRange<edge_iterator>(
+        node > 0 ? prefix_[node - 1] : 0, prefix_[node]);
+  }
+
+  const std::vector<Segment>& segments() const { return segments_; }
+
+  /// \returns the index of the segment holding \param node
+  size_t SegmentOf(Node node) const;
+
+  /// Make the edge destinations of segment \param index readable, reading
+  /// them if they are not in memory, and keep them in memory until the
+  /// returned binding is destroyed
+  Result<Binding> Bind(size_t index);
+
+  /// Bytes of edge destinations in memory or being prefetched
+  uint64_t resident_bytes() const;
+
+  OCTopologyStats stats() const;
+
+private:
+  struct Residency {
+    bool resident{false};
+    uint32_t pins{0};
+    /// Position in lru_ if resident
+    std::list<size_t>::iterator lru;
+  };
+
+  OCTopology(tsuba::RDGPrefix&& prefix, const OCTopologyOptions& opts);
+
+  Result<void> Init();
+
+  /// The range of the topology file holding the destinations of segment i
+  uint64_t FileBegin(size_t i) const;
+  uint64_t FileEnd(size_t i) const;
+
+  /// Start reading segment i unless it is in memory. Called with mutex_ held.
+  Result<void> MakeResident(size_t i);
+
+  /// Release unbound segments, least recently used first, until
+  /// resident_bytes_ is within budget. Called with mutex_ held.
+  Result<void> Shrink();
+
+  /// Read segment i, which is pinned, and prefetch the next one. Called
+  /// with mutex_ held.
+  Result<void> Fill(size_t i);
+
+  void Unpin(size_t i);
+
+  tsuba::RDGPrefix prefix_;
+  tsuba::FileView view_;
+  OCTopologyOptions opts_;
+  std::vector<Segment> segments_;
+
+  mutable std::mutex mutex_;
+  std::vector<Residency> residency_;
+  /// Resident segments, most recently used first
+  std::list<size_t> lru_;
+  uint64_t resident_bytes_{0};
+  OCTopologyStats stats_;
+};
+
+}  // namespace katana
+
+#endif
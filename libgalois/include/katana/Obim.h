@@ -29,6 +29,7 @@
 #include "katana/FlatMap.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/TerminationDetection.h"
+#include "katana/Threads.h"
 #include "katana/WorkListHelpers.h"
 
 namespace katana {
@@ -53,7 +54,7 @@ protected:
 
   Barrier& barrier;
 
-  OrderedByIntegerMetricData() : barrier(GetBarrier(activeThreads)) {}
+  OrderedByIntegerMetricData() : barrier(GetBarrier(getActiveThreads())) {}
 
   bool hasStored(ThreadData& p, Index idx) {
     for (auto& e : p.stored) {
@@ -283,7 +284,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader) {
-        for (unsigned i = 0; i < activeThreads; ++i) {
+        for (unsigned i = 0; i < getActiveThreads(); ++i) {
           Index o = data.getRemote(i)->scanStart;
           if (this->compare(o, msS))
             msS = o;
@@ -443,7 +444,7 @@ public:
     Index curIndex = (hasWork) ? p.curIndex : this->identity;
     CTy* C = (hasWork) ? p.current : nullptr;
 
-    for (unsigned i = 0; i < activeThreads; ++i) {
+    for (unsigned i = 0; i < getActiveThreads(); ++i) {
       ThreadData& o = *data.getRemote(i);
       if (o.hasWork && this->compare(o.curIndex, curIndex)) {
         curIndex = o.curIndex;
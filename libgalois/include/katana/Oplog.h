@@ -0,0 +1,92 @@
+#ifndef KATANA_LIBGALOIS_KATANA_OPLOG_H_
+#define KATANA_LIBGALOIS_KATANA_OPLOG_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/BuildGraph.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A batch of node and edge changes read from a change log (oplog), e.g.,
+/// the events of one hour, to be applied to a graph with ApplyOplogBatch.
+///
+/// Nodes are identified by their index in the graph. Operations take effect
+/// in the order they are added: a later operation sees the effects of the
+/// earlier ones in the same batch.
+class KATANA_EXPORT OplogBatch {
+public:
+  using Node = GraphTopology::Node;
+  /// Property values by property name. An ImportData of type kUnsupported
+  /// sets the property to null.
+  using Values = std::vector<std::pair<std::string, ImportData>>;
+
+  enum class OpType { kUpsertNode, kDeleteNode, kUpsertEdge, kDeleteEdge };
+
+  struct Op {
+    OpType type;
+    Node src;
+    Node dest;
+    Values values;
+  };
+
+  /// Set the given properties of node. A node at or past the end of the
+  /// graph adds nodes up to and including it; the properties of added nodes
+  /// that are not set are null.
+  void UpsertNode(Node node, Values values = {}) {
+    ops_.emplace_back(Op{OpType::kUpsertNode, node, node, std::move(values)});
+  }
+
+  /// Remove the edges into and out of node and set its properties to null.
+  /// Nodes are not renumbered, so the node stays in the graph as a
+  /// tombstone until it is upserted again.
+  void DeleteNode(Node node) {
+    ops_.emplace_back(Op{OpType::kDeleteNode, node, node, {}});
+  }
+
+  /// Set the given properties of the first edge from src to dest, adding
+  /// such an edge if there is none
+  void UpsertEdge(Node src, Node dest, Values values = {}) {
+    ops_.emplace_back(Op{OpType::kUpsertEdge, src, dest, std::move(values)});
+  }
+
+  /// Remove all edges from src to dest
+  void DeleteEdge(Node src, Node dest) {
+    ops_.emplace_back(Op{OpType::kDeleteEdge, src, dest, {}});
+  }
+
+  const std::vector<Op>& ops() const { return ops_; }
+  size_t size() const { return ops_.size(); }
+  bool empty() const { return ops_.empty(); }
+  void clear() { ops_.clear(); }
+
+private:
+  std::vector<Op> ops_;
+};
+
+/// Apply the changes in batch to pg so that the next Commit writes them as
+/// a new version of its RDG, rewriting only what the batch changed:
+///
+/// - a property column is replaced only if the batch sets or nulls one of
+///   its values, or if its number of rows changes; unchanged columns keep
+///   their files;
+/// - the topology is replaced only if the batch adds or removes edges or
+///   nodes; added edges of a node follow its remaining edges, and every edge
+///   property is then replaced because its rows move.
+///
+/// Replaced properties move to the end of their schema. Properties named in
+/// the batch that pg does not have are added, with the type of their first
+/// non-null value. Fails without changing pg if an operation refers to a
+/// node not in the graph or a value does not match its property's type.
+/// The batch is summarized as provenance in the lineage of the next
+/// version.
+KATANA_EXPORT Result<void> ApplyOplogBatch(
+    PropertyGraph* pg, const OplogBatch& batch);
+
+}  // namespace katana
+
+#endif
@@ -30,6 +30,7 @@
 #include <utility>
 
 #include "katana/Logging.h"
+#include "katana/MappedArray.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -38,6 +39,10 @@ namespace katana {
  * This is a container that encapsulates a resizeable array
  * of plain-old-datatype (POD) elements.
  * There is no initialization or destruction of elements.
+ *
+ * Small arrays are allocated with malloc. Arrays of at least kMapThreshold
+ * bytes live in anonymous mappings instead, which grow without copying and
+ * commit pages as they are written (see MappedArray).
  */
 template <typename _Tp>
 class PODResizeableArray {
@@ -46,6 +51,65 @@ class PODResizeableArray {
   size_t size_;
 
   constexpr static size_t kMinNonZeroCapacity = 8;
+  constexpr static size_t kMapThreshold = size_t{1} << 20;
+
+  static bool IsMapped(size_t capacity) {
+    return capacity * sizeof(_Tp) >= kMapThreshold;
+  }
+
+  static size_t MappedBytes(size_t capacity) {
+    size_t granularity = MappingGranularity();
+    return (capacity * sizeof(_Tp) + granularity - 1) / granularity *
+           granularity;
+  }
+
+  void Free() {
+    if (data_ == NULL) {
+      return;
+    }
+    if (IsMapped(capacity_)) {
+      if (auto res = UnmapAnonymous(data_, MappedBytes(capacity_)); !res) {
+        KATANA_LOG_ERROR("unmapping array: {}", res.error());
+      }
+    } else {
+      free(data_);
+    }
+  }
+
+  /// Move the elements to storage for new_capacity elements
+  void Reallocate(size_t new_capacity) {
+    KATANA_LOG_DEBUG_ASSERT(new_capacity > 0);
+    void* new_data = NULL;
+    if (data_ == NULL || IsMapped(capacity_) != IsMapped(new_capacity)) {
+      // New storage, possibly of the other kind; copy what is there
+      if (IsMapped(new_capacity)) {
+        auto res = MapAnonymous(MappedBytes(new_capacity));
+        if (!res) {
+          KATANA_LOG_FATAL("growing array: {}", res.error());
+        }
+        new_data = res.value();
+      } else {
+        new_data = malloc(new_capacity * sizeof(_Tp));
+      }
+      KATANA_LOG_DEBUG_ASSERT(new_data);
+      if (data_ != NULL) {
+        memcpy(new_data, data_, std::min(size_, new_capacity) * sizeof(_Tp));
+        Free();
+      }
+    } else if (IsMapped(new_capacity)) {
+      auto res = RemapAnonymous(
+          data_, MappedBytes(capacity_), MappedBytes(new_capacity));
+      if (!res) {
+        KATANA_LOG_FATAL("growing array: {}", res.error());
+      }
+      new_data = res.value();
+    } else {
+      new_data = realloc(data_, new_capacity * sizeof(_Tp));
+      KATANA_LOG_DEBUG_ASSERT(new_data);
+    }
+    data_ = static_cast<_Tp*>(new_data);
+    capacity_ = new_capacity;
+  }
 
 public:
   typedef _Tp value_type;
@@ -90,9 +154,7 @@ public:
 
   //! move assignment operator
   PODResizeableArray& operator=(PODResizeableArray&& v) {
-    if (data_ != NULL) {
-      free(data_);
-    }
+    Free();
     data_ = v.data_;
     capacity_ = v.capacity_;
     size_ = v.size_;
@@ -102,11 +164,7 @@ public:
     return *this;
   }
 
-  ~PODResizeableArray() {
-    if (data_ != NULL) {
-      free(data_);
-    }
-  }
+  ~PODResizeableArray() { Free(); }
 
   // iterators:
   iterator begin() { return iterator(&data_[0]); }
@@ -135,17 +193,11 @@ public:
 
   void shrink_to_fit() {
     if (size_ == 0) {
-      if (data_ != NULL) {
-        free(data_);
-        data_ = NULL;
-        capacity_ = 0;
-      }
+      Free();
+      data_ = NULL;
+      capacity_ = 0;
     } else if (size_ < capacity_) {
-      capacity_ = std::max(size_, kMinNonZeroCapacity);
-      _Tp* new_data_ = static_cast<_Tp*>(
-          realloc(reinterpret_cast<void*>(data_), capacity_ * sizeof(_Tp)));
-      KATANA_LOG_DEBUG_ASSERT(new_data_);
-      data_ = new_data_;
+      Reallocate(std::max(size_, kMinNonZeroCapacity));
     }
   }
 
@@ -154,20 +206,19 @@ public:
       return;
     }
 
-    // When reallocing, don't pay for elements greater than size_
-    shrink_to_fit();
+    // When reallocing, don't pay for elements greater than size_. Remapping
+    // copies nothing, so mapped arrays grow in place.
+    if (!IsMapped(capacity_)) {
+      shrink_to_fit();
+    }
 
-    // reset capacity_ because its previous value need not be a power-of-2
-    capacity_ = kMinNonZeroCapacity;
+    // the previous capacity need not be a power-of-2
+    size_t new_capacity = kMinNonZeroCapacity;
     // increase capacity in powers-of-2
-    while (capacity_ < n) {
-      capacity_ <<= 1;
+    while (new_capacity < n) {
+      new_capacity <<= 1;
     }
-
-    _Tp* new_data_ = static_cast<_Tp*>(
-        realloc(reinterpret_cast<void*>(data_), capacity_ * sizeof(_Tp)));
-    KATANA_LOG_DEBUG_ASSERT(new_data_);
-    data_ = new_data_;
+    Reallocate(new_capacity);
   }
 
   void resize(size_t n) {
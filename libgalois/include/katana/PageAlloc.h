@@ -21,11 +21,42 @@
 #define KATANA_LIBGALOIS_KATANA_PAGEALLOC_H_
 
 #include <cstddef>
+#include <cstdint>
 
 #include "katana/config.h"
 
 namespace katana {
 
+/// How allocPages backs its 2MB pages.
+enum class HugePageMode {
+  /// Regular pages only
+  kOff,
+  /// Ask for transparent huge pages with madvise(MADV_HUGEPAGE)
+  kTransparent,
+  /// Use explicit huge pages (MAP_HUGETLB) from the reserved pool, falling
+  /// back to transparent huge pages and then regular pages
+  kExplicit,
+};
+
+/// Set the huge page mode for subsequent allocations. The default is taken
+/// from the environment variable KATANA_HUGE_PAGES (off, transparent or
+/// explicit) and is explicit when the variable is unset.
+KATANA_EXPORT void SetHugePageMode(HugePageMode mode);
+KATANA_EXPORT HugePageMode GetHugePageMode();
+
+/// Number of 2MB pages allocated by allocPages so far, by how they were
+/// backed. Transparent pages are those madvise accepted; the kernel may still
+/// back some of them with regular pages.
+struct PageAllocCounts {
+  uint64_t explicit_huge;
+  uint64_t transparent_huge;
+  uint64_t regular;
+  /// Pages for which an explicit huge page allocation was tried and failed
+  uint64_t explicit_huge_failures;
+};
+
+KATANA_EXPORT PageAllocCounts GetPageAllocCounts();
+
 // size of pages
 KATANA_EXPORT size_t allocSize();
 
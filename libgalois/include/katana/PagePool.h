@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "katana/CacheLineStorage.h"
+#include "katana/MemoryBudget.h"
 #include "katana/PageAlloc.h"
 #include "katana/PtrLock.h"
 #include "katana/SimpleLock.h"
@@ -65,7 +66,11 @@ class PageAllocState {
   std::unordered_map<void*, int> ownerMap;
   katana::SimpleLock mapLock;
 
+  // Pages stay in the pool once allocated, so they are never released from
+  // the memory budget
   void* allocFromOS() {
+    katana::ChargeMemory(
+        katana::MemorySubsystem::kPagePool, katana::allocSize());
     void* ptr = katana::allocPages(1, true);
     KATANA_LOG_DEBUG_ASSERT(ptr);
     auto tid = katana::ThreadPool::getTID();
@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PARAMETER_H_
+#define KATANA_LIBGALOIS_KATANA_PARAMETER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana::parameter {
+
+/// The parallelism profile of a loop: how much work was available in each
+/// step of an execution in which every step runs all the work that is ready
+/// and defers what it pushes to the next step.
+struct LoopProfile {
+  struct Step {
+    /// Iterations that were ready at the start of the step
+    uint64_t work{0};
+    /// Iterations that committed; the others conflicted with an iteration of
+    /// the same step and were retried in the next step
+    uint64_t committed{0};
+  };
+
+  std::string loopname;
+  std::vector<Step> steps;
+
+  uint64_t TotalWork() const;
+  uint64_t MaxParallelism() const;
+  /// Committed iterations per step: the speedup that unlimited threads
+  /// could get over one thread
+  double MeanParallelism() const;
+  /// The share of iterations that conflicted
+  double ConflictRatio() const;
+};
+
+/// ProfileScope measures the available parallelism of the loops that the
+/// calling thread runs during the lifetime of the scope, e.g., during one
+/// analytics algorithm, the way the ParaMeter worklist does for a single
+/// for_each loop.
+///
+/// While a scope is enabled, for_each loops run under the ParaMeter executor
+/// in FIFO steps, which reports the work and conflicts of each step, and each
+/// named do_all loop counts as one step whose work is the size of its range.
+/// Loops run serially step by step, so profiled code runs much slower, but
+/// the profile does not depend on the number of threads. The profiles of
+/// all scopes are reported by ReportParallelismProfiles. The steps are also
+/// written to the ParaMeter CSV file if KATANA_PARAMETER_OUTFILE is set.
+///
+/// A scope constructed with enable false does nothing, so that callers can
+/// profile conditionally, e.g., on Plan::profile_parallelism.
+class KATANA_EXPORT ProfileScope {
+  ProfileScope* prev_;
+  bool enabled_;
+  std::vector<LoopProfile> profiles_;
+
+public:
+  explicit ProfileScope(bool enable = true);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+  ProfileScope(ProfileScope&&) = delete;
+  ProfileScope& operator=(ProfileScope&&) = delete;
+
+  /// The profiles of the loops run so far, in the order in which they first
+  /// ran
+  const std::vector<LoopProfile>& profiles() const { return profiles_; }
+
+  /// Add a step to the profile of loopname; called by the executors
+  void AddStep(const char* loopname, LoopProfile::Step step);
+};
+
+/// Return the enabled scope of the calling thread or null if loops are not
+/// being profiled
+KATANA_EXPORT ProfileScope* CurrentProfileScope();
+
+inline bool
+IsProfiling() {
+  return CurrentProfileScope() != nullptr;
+}
+
+/// Reports the profiles of the scopes that ended since the last call, merged
+/// by loop, as statistics of the region of each loop: ParallelismSteps,
+/// ParallelismWork, ParallelismMax, ParallelismMean (committed iterations
+/// per step) and ConflictRatio. Called when SharedMemSys is destroyed.
+KATANA_EXPORT void ReportParallelismProfiles();
+
+namespace internal {
+
+/// Suspends profiling on the calling thread for its lifetime, e.g., for the
+/// loops that an executor runs on behalf of a profiled loop
+class KATANA_EXPORT SuspendProfile {
+  ProfileScope* prev_;
+
+public:
+  SuspendProfile();
+  ~SuspendProfile();
+
+  SuspendProfile(const SuspendProfile&) = delete;
+  SuspendProfile& operator=(const SuspendProfile&) = delete;
+  SuspendProfile(SuspendProfile&&) = delete;
+  SuspendProfile& operator=(SuspendProfile&&) = delete;
+};
+
+}  // namespace internal
+
+}  // namespace katana::parameter
+
+#endif
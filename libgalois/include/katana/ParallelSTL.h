@@ -20,7 +20,13 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 #define KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 
+#include <algorithm>
+#include <array>
 #include <iterator>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Chunk.h"
 #include "katana/LoopsDecl.h"
@@ -310,6 +316,47 @@ map_reduce(
   return r.reduce();
 }
 
+//! Number of consecutive integers that deterministic_map_reduce reduces
+//! serially
+constexpr size_t kDeterministicBlockSize = 4096;
+
+/**
+ * Like map_reduce over the integers [first, last), but combines the results
+ * of map_fn in an order that depends only on the range, not on the number of
+ * threads or the schedule, so that operations that are not associative,
+ * such as floating-point addition, give the same result on every run. Each
+ * block of kDeterministicBlockSize integers is reduced serially in order,
+ * and then the results of the blocks are reduced serially in order.
+ */
+template <typename I, class MapFn, class T, class ReduceFn>
+T
+deterministic_map_reduce(
+    I first, I last, MapFn map_fn, ReduceFn reduce_fn, const T& identity) {
+  size_t size = last > first ? last - first : 0;
+  size_t num_blocks =
+      (size + kDeterministicBlockSize - 1) / kDeterministicBlockSize;
+  std::vector<T> partials(num_blocks, identity);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        size_t begin = block * kDeterministicBlockSize;
+        size_t end = std::min(begin + kDeterministicBlockSize, size);
+        T partial = identity;
+        for (size_t i = begin; i < end; ++i) {
+          partial = reduce_fn(partial, map_fn(first + i));
+        }
+        partials[block] = partial;
+      },
+      katana::steal(), katana::no_stats());
+
+  T result = identity;
+  for (const T& partial : partials) {
+    result = reduce_fn(result, partial);
+  }
+  return result;
+}
+
 template <typename I>
 std::enable_if_t<!std::is_scalar<internal::Val_ty<I>>::value>
 destroy(I first, I last) {
@@ -490,6 +537,304 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
   return d_first + prefix_sum.back();
 }
 
+/**
+ * Writes the exclusive prefix reduction of [first, last) with op, starting
+ * from init, to d_first: the i-th output is init combined with the first i
+ * inputs. op must be associative. The input is split into one contiguous
+ * block per thread, which is reduced and then scanned by the same thread,
+ * so each thread reads its block twice while it is still in cache for
+ * blocks that fit. d_first may be first.
+ */
+template <class InputIt, class OutputIt, class T, class BinaryOperation>
+OutputIt
+exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init,
+    BinaryOperation op) {
+  size_t size = std::distance(first, last);
+
+  auto scan = [&op](InputIt begin, InputIt end, OutputIt out, T acc) {
+    for (; begin != end; ++begin, ++out) {
+      T value = *begin;
+      *out = acc;
+      acc = op(acc, value);
+    }
+  };
+
+  if (size < 1024) {
+    scan(first, last, d_first, init);
+    return d_first + size;
+  }
+
+  std::vector<std::optional<T>> block_sums(getActiveThreads());
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first, last, tid, total);
+    if (begin == end) {
+      return;
+    }
+    T sum = *begin;
+    for (auto it = std::next(begin); it != end; ++it) {
+      sum = op(sum, *it);
+    }
+    block_sums[tid] = sum;
+  });
+
+  // block_sums[i] becomes what block i starts from
+  T running = init;
+  for (auto& sum : block_sums) {
+    if (sum) {
+      T next = op(running, *sum);
+      sum = running;
+      running = next;
+    }
+  }
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first, last, tid, total);
+    if (begin != end) {
+      scan(begin, end, d_first + std::distance(first, begin), *block_sums[tid]);
+    }
+  });
+
+  return d_first + size;
+}
+
+template <class InputIt, class OutputIt, class T>
+OutputIt
+exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init) {
+  return katana::ParallelSTL::exclusive_scan(
+      first, last, d_first, init, std::plus<T>());
+}
+
+/**
+ * Sorts [first, last) by key(x), an unsigned integer, of each element x with
+ * a least significant digit radix sort. The sort is stable and takes one
+ * pass over the elements per byte of the largest key, so it beats
+ * comparison sorts for integer keys, e.g., node ids.
+ *
+ * Each pass counts the digits of one block of elements per thread, turns the
+ * counts into where each thread writes each digit, and moves the elements
+ * to an equally sized buffer. Digits are 8 bits so that the counters and the
+ * current output position of every digit stay in the L1 cache. Elements
+ * must be default constructible and movable.
+ */
+template <class RandomAccessIterator, class KeyFn>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyFn key) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using Key = std::decay_t<decltype(key(*first))>;
+  static_assert(
+      std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+      "radix_sort keys must be unsigned integers");
+  constexpr unsigned kDigitBits = 8;
+  constexpr size_t kNumDigits = size_t{1} << kDigitBits;
+
+  size_t size = std::distance(first, last);
+  if (size < 1024) {
+    std::stable_sort(first, last, [&key](const T& a, const T& b) {
+      return key(a) < key(b);
+    });
+    return;
+  }
+
+  unsigned num_threads = getActiveThreads();
+  std::vector<Key> max_keys(num_threads, 0);
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    Key max_key = 0;
+    for (size_t i = begin; i < end; ++i) {
+      max_key = std::max<Key>(max_key, key(first[i]));
+    }
+    max_keys[tid] = max_key;
+  });
+  Key max_key = *std::max_element(max_keys.begin(), max_keys.end());
+
+  std::vector<T> buffer(size);
+  std::vector<std::array<size_t, kNumDigits>> offsets(num_threads);
+
+  auto pass = [&](auto in, auto out, unsigned shift) {
+    auto digit = [&](size_t i) {
+      return static_cast<size_t>(key(in[i]) >> shift) & (kNumDigits - 1);
+    };
+    on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = block_range(size_t{0}, size, tid, total);
+      offsets[tid].fill(0);
+      for (size_t i = begin; i < end; ++i) {
+        ++offsets[tid][digit(i)];
+      }
+    });
+    // Digit by digit, each thread's elements follow those of the threads
+    // before it, which keeps the sort stable
+    size_t running = 0;
+    for (size_t d = 0; d < kNumDigits; ++d) {
+      for (unsigned t = 0; t < num_threads; ++t) {
+        size_t count = offsets[t][d];
+        offsets[t][d] = running;
+        running += count;
+      }
+    }
+    on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = block_range(size_t{0}, size, tid, total);
+      std::array<size_t, kNumDigits>& pos = offsets[tid];
+      for (size_t i = begin; i < end; ++i) {
+        out[pos[digit(i)]++] = std::move(in[i]);
+      }
+    });
+  };
+
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < sizeof(Key) * 8 && (max_key >> shift) != 0;
+       shift += kDigitBits) {
+    if (in_buffer) {
+      pass(buffer.begin(), first, shift);
+    } else {
+      pass(first, buffer.begin(), shift);
+    }
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) {
+    on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = block_range(size_t{0}, size, tid, total);
+      std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+    });
+  }
+}
+
+template <class RandomAccessIterator>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  katana::ParallelSTL::radix_sort(first, last, [](const T& x) { return x; });
+}
+
+/**
+ * Reorders [first, last) so that the elements for which pred is true come
+ * first, keeping the relative order within both groups, and returns the
+ * first element of the second group. pred is called twice per element.
+ *
+ * Each thread counts the matches in its block, and then moves its block
+ * into a buffer at the positions that follow from the counts of the blocks
+ * before it. Elements must be default constructible and movable.
+ */
+template <class RandomAccessIterator, class Predicate>
+RandomAccessIterator
+stable_partition(
+    RandomAccessIterator first, RandomAccessIterator last, Predicate pred) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  size_t size = std::distance(first, last);
+  if (size < 1024) {
+    return std::stable_partition(first, last, pred);
+  }
+
+  unsigned num_threads = getActiveThreads();
+  std::vector<size_t> num_true(num_threads, 0);
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first, last, tid, total);
+    num_true[tid] = std::count_if(begin, end, pred);
+  });
+
+  // The trues of thread t follow those of the threads before it, and its
+  // falses those of the threads before it after all trues
+  std::vector<size_t> true_offsets(num_threads);
+  std::vector<size_t> false_offsets(num_threads);
+  size_t total_true = std::accumulate(num_true.begin(), num_true.end(), 0UL);
+  size_t trues = 0;
+  size_t falses = total_true;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    auto [begin, end] = block_range(size_t{0}, size, t, num_threads);
+    true_offsets[t] = trues;
+    false_offsets[t] = falses;
+    trues += num_true[t];
+    falses += end - begin - num_true[t];
+  }
+
+  std::vector<T> buffer(size);
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first, last, tid, total);
+    size_t true_pos = true_offsets[tid];
+    size_t false_pos = false_offsets[tid];
+    for (auto it = begin; it != end; ++it) {
+      if (pred(*it)) {
+        buffer[true_pos++] = std::move(*it);
+      } else {
+        buffer[false_pos++] = std::move(*it);
+      }
+    }
+  });
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+  });
+
+  return first + total_true;
+}
+
+/**
+ * Merges the sorted ranges [first1, last1) and [first2, last2) into
+ * d_first, like std::merge: stable, and of equal elements those of the
+ * first range come first. Each thread writes one contiguous block of the
+ * output; where its inputs start is found by a binary search over the
+ * diagonal of the merge path, so no thread waits for another.
+ */
+template <
+    class RandomAccessIterator1, class RandomAccessIterator2, class OutputIt,
+    class Compare>
+OutputIt
+merge(
+    RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+    RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+    OutputIt d_first, Compare comp) {
+  size_t size1 = std::distance(first1, last1);
+  size_t size2 = std::distance(first2, last2);
+  size_t size = size1 + size2;
+  if (size < 1024) {
+    return std::merge(first1, last1, first2, last2, d_first, comp);
+  }
+
+  // How many of the first k outputs come from the first range
+  auto split = [&](size_t k) {
+    size_t lo = k > size2 ? k - size2 : 0;
+    size_t hi = std::min(k, size1);
+    while (lo < hi) {
+      size_t i = lo + (hi - lo) / 2;
+      size_t j = k - i;
+      // first1[i] goes before first2[j - 1], so more of the first range is
+      // needed
+      if (!comp(first2[j - 1], first1[i])) {
+        lo = i + 1;
+      } else {
+        hi = i;
+      }
+    }
+    return lo;
+  };
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    if (begin == end) {
+      return;
+    }
+    size_t i_begin = split(begin);
+    size_t i_end = split(end);
+    std::merge(
+        first1 + i_begin, first1 + i_end, first2 + (begin - i_begin),
+        first2 + (end - i_end), d_first + begin, comp);
+  });
+
+  return d_first + size;
+}
+
+template <
+    class RandomAccessIterator1, class RandomAccessIterator2, class OutputIt>
+OutputIt
+merge(
+    RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+    RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+    OutputIt d_first) {
+  return katana::ParallelSTL::merge(
+      first1, last1, first2, last2, d_first, std::less<>());
+}
+
 }  // end namespace ParallelSTL
 }  // end namespace katana
 #endif
@@ -0,0 +1,317 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PERTHREADCHUNKDEQUE_H_
+#define KATANA_LIBGALOIS_KATANA_PERTHREADCHUNKDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/FixedSizeRing.h"
+#include "katana/Mem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// A Chase-Lev work-stealing deque of pointers. The owning thread pushes and
+/// pops at the bottom; any other thread may steal from the top.
+///
+/// The memory orders follow Lê et al., "Correct and Efficient Work-Stealing
+/// for Weak Memory Models", PPoPP 2013. Arrays that are outgrown are kept
+/// until the deque is destroyed because thieves may still be reading them.
+template <typename T>
+class ChaseLevDeque {
+  static_assert(std::is_pointer_v<T>, "ChaseLevDeque holds pointers");
+
+  class Array {
+    int64_t mask_;
+    std::unique_ptr<std::atomic<T>[]> items_;
+
+  public:
+    explicit Array(int64_t size)
+        : mask_(size - 1), items_(new std::atomic<T>[size]) {}
+
+    int64_t size() const { return mask_ + 1; }
+
+    T get(int64_t i) const {
+      return items_[i & mask_].load(std::memory_order_relaxed);
+    }
+
+    void put(int64_t i, T val) {
+      items_[i & mask_].store(val, std::memory_order_relaxed);
+    }
+  };
+
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> top_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> bottom_{0};
+  std::atomic<Array*> array_;
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Array* Grow(Array* old, int64_t bottom, int64_t top) {
+    auto bigger = std::make_unique<Array>(old->size() * 2);
+    for (int64_t i = top; i < bottom; ++i) {
+      bigger->put(i, old->get(i));
+    }
+    Array* ret = bigger.get();
+    arrays_.emplace_back(std::move(bigger));
+    array_.store(ret, std::memory_order_release);
+    return ret;
+  }
+
+public:
+  /// \param initial_size initial capacity; must be a power of two
+  explicit ChaseLevDeque(int64_t initial_size = 64) {
+    KATANA_LOG_DEBUG_ASSERT((initial_size & (initial_size - 1)) == 0);
+    arrays_.emplace_back(std::make_unique<Array>(initial_size));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <=
+           top_.load(std::memory_order_relaxed);
+  }
+
+  /// Push val at the bottom. Only the owner may call this.
+  void push(T val) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->size() - 1) {
+      a = Grow(a, b, t);
+    }
+    a->put(b, val);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Pop from the bottom, returning nullptr if the deque is empty. Only the
+  /// owner may call this.
+  T pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T ret = a->get(b);
+    if (t == b) {
+      // Last item; race against thieves for it
+      if (!top_.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        ret = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  /// Steal from the top, returning nullptr if the deque is empty or another
+  /// thread got there first.
+  T steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Array* a = array_.load(std::memory_order_acquire);
+    T ret = a->get(t);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return ret;
+  }
+};
+
+template <typename T, int ChunkSize, bool Concurrent>
+class PerThreadChunkDequeMaster {
+public:
+  template <typename _T>
+  using retype = PerThreadChunkDequeMaster<_T, ChunkSize, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread = PerThreadChunkDequeMaster<T, ChunkSize, _Concurrent>;
+
+  template <int _chunk_size>
+  using with_chunk_size = PerThreadChunkDequeMaster<T, _chunk_size, Concurrent>;
+
+  typedef T value_type;
+
+private:
+  using Chunk = FixedSizeRing<T, ChunkSize>;
+
+  struct ThreadData {
+    //! Full chunks; the oldest are stolen first
+    ChaseLevDeque<Chunk*> deque;
+    //! Chunk being filled and drained by this thread only
+    Chunk* cur{};
+    //! Threads to steal from, nearest first
+    std::vector<unsigned> victims;
+  };
+
+  FixedSizeAllocator<Chunk> alloc;
+  PerThreadStorage<ThreadData> data;
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  /// Order the other active threads by distance from tid: threads on the
+  /// same socket, then on the same NUMA node, then everyone else. Each group
+  /// starts after tid so that thieves spread out over victims.
+  static std::vector<unsigned> MakeVictims(unsigned tid, unsigned num) {
+    auto& tp = GetThreadPool();
+    std::vector<unsigned> victims;
+    auto add_if = [&](auto pred) {
+      for (unsigned i = 1; i < num; ++i) {
+        unsigned eid = (tid + i) % num;
+        if (pred(eid)) {
+          victims.emplace_back(eid);
+        }
+      }
+    };
+    unsigned socket = tp.getSocket(tid);
+    unsigned numa_node = tp.getNumaNode(tid);
+    add_if([&](unsigned eid) { return tp.getSocket(eid) == socket; });
+    add_if([&](unsigned eid) {
+      return tp.getSocket(eid) != socket && tp.getNumaNode(eid) == numa_node;
+    });
+    add_if([&](unsigned eid) {
+      return tp.getSocket(eid) != socket && tp.getNumaNode(eid) != numa_node;
+    });
+    return victims;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Chunk* steal(ThreadData& me) {
+    for (unsigned eid : me.victims) {
+      if (Chunk* c = data.getRemote(eid)->deque.steal()) {
+        return c;
+      }
+    }
+    return nullptr;
+  }
+
+  void push_internal(ThreadData& me, const value_type& val) {
+    if (me.cur && me.cur->push_back(val)) {
+      return;
+    }
+    if (me.cur) {
+      me.deque.push(me.cur);
+    }
+    me.cur = mkChunk();
+    me.cur->push_back(val);
+  }
+
+public:
+  PerThreadChunkDequeMaster() {
+    if (!Concurrent) {
+      return;
+    }
+    unsigned num = getActiveThreads();
+    for (unsigned tid = 0; tid < num; ++tid) {
+      data.getRemote(tid)->victims = MakeVictims(tid, num);
+    }
+  }
+
+  PerThreadChunkDequeMaster(const PerThreadChunkDequeMaster&) = delete;
+  PerThreadChunkDequeMaster& operator=(const PerThreadChunkDequeMaster&) =
+      delete;
+
+  ~PerThreadChunkDequeMaster() {
+    for (unsigned tid = 0; tid < data.size(); ++tid) {
+      ThreadData& d = *data.getRemote(tid);
+      if (d.cur) {
+        delChunk(d.cur);
+      }
+      while (Chunk* c = d.deque.pop()) {
+        delChunk(c);
+      }
+    }
+  }
+
+  void push(const value_type& val) { push_internal(*data.getLocal(), val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& me = *data.getLocal();
+    while (b != e) {
+      push_internal(me, *b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& me = *data.getLocal();
+    std::optional<value_type> retval;
+    if (me.cur && (retval = me.cur->extract_back())) {
+      return retval;
+    }
+    if (me.cur) {
+      delChunk(me.cur);
+    }
+    me.cur = me.deque.pop();
+    if (!me.cur) {
+      me.cur = steal(me);
+    }
+    if (me.cur) {
+      return me.cur->extract_back();
+    }
+    return std::nullopt;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Per-thread work-stealing chunked worklist. Each thread keeps its chunks in
+ * its own Chase-Lev deque and works on them in LIFO order. An idle thread
+ * steals the oldest chunk of another thread, trying threads on its own
+ * socket first, then its NUMA node, and then the rest of the machine. This
+ * avoids contention on shared socket-level queues when work is skewed.
+ *
+ * Work in the chunk a thread is currently filling is not visible to thieves
+ * until the chunk is full, so smaller chunks expose work sooner.
+ *
+ * @tparam ChunkSize chunk size
+ */
+template <int ChunkSize = 64, typename T = int, bool Concurrent = true>
+using PerThreadChunkDeque =
+    internal::PerThreadChunkDequeMaster<T, ChunkSize, Concurrent>;
+KATANA_WLCOMPILECHECK(PerThreadChunkDeque)
+
+}  // end namespace katana
+
+#endif
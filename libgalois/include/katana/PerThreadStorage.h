@@ -39,6 +39,7 @@ class KATANA_EXPORT PerBackend {
 
   std::atomic<unsigned int> nextLoc{0};
   std::atomic<char*>* heads{nullptr};
+  unsigned numHeads{0};
   Lock freeOffsetsLock;
   std::vector<std::vector<unsigned>> freeOffsets;
   /**
@@ -53,6 +54,13 @@ class KATANA_EXPORT PerBackend {
   void initCommon(unsigned maxT);
   static unsigned nextLog2(unsigned size);
 
+  //! Thread ids in a sub-pool are relative to its first thread (see
+  //! ThreadPool::Team); return the head of the thread that id names
+  unsigned slot(unsigned id) const {
+    unsigned s = id + ThreadPool::getTeamBegin();
+    return s < numHeads ? s : s - numHeads;
+  }
+
 public:
   PerBackend();
 
@@ -67,14 +75,22 @@ public:
 
   char* initPerThread(unsigned maxT);
   char* initPerSocket(unsigned maxT);
+  //! allocate the storage of thread id, which has not started, from the
+  //! calling thread; initPerThread and initPerSocket on thread id reuse it
+  void initRemotePerThread(unsigned id);
+  void initRemotePerSocket(unsigned id, unsigned leader);
 
   unsigned allocOffset(unsigned size);
   void deallocOffset(unsigned offset, unsigned size);
   void* getRemote(unsigned thread, unsigned offset);
+  //! like getRemote but with an absolute thread id, even in a sub-pool
+  void* getMachineRemote(unsigned thread, unsigned offset);
   void* getLocal(unsigned offset, char* base) { return &base[offset]; }
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
-  void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+  void* getLocal(unsigned offset, unsigned id) {
+    return &heads[slot(id)][offset];
+  }
 };
 
 extern thread_local char* ptsBase;
@@ -85,6 +101,13 @@ KATANA_EXPORT PerBackend& getPPSBackend();
 
 KATANA_EXPORT void initPTS(unsigned maxT);
 
+//! Allocate the storage of thread id, whose socket leader is leader, before
+//! the thread starts
+KATANA_EXPORT void initPTSForThread(unsigned id, unsigned leader);
+
+//! Point the calling thread's per-socket storage at that of thread
+KATANA_EXPORT void setPSSBase(unsigned thread);
+
 template <typename T>
 class PerThreadStorage {
   PerBackend* b;
@@ -213,7 +236,8 @@ class PerSocketStorage {
   void destruct() {
     auto& tp = GetThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
+      reinterpret_cast<T*>(
+          b->getMachineRemote(tp.getMachineLeaderForSocket(n), offset))
           ->~T();
     }
     b->deallocOffset(offset, sizeof(T));
@@ -229,7 +253,7 @@ public:
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+      new (b->getMachineRemote(tp.getMachineLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
     }
   }
@@ -0,0 +1,444 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PIPELINE_H_
+#define KATANA_LIBGALOIS_KATANA_PIPELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Waits for a queue by spinning, then yielding, then sleeping, and adds the
+/// time it waited to *waited_ns if waited_ns is not null
+class QueueWaiter {
+public:
+  explicit QueueWaiter(uint64_t* waited_ns)
+      : waited_ns_(waited_ns), start_(std::chrono::steady_clock::now()) {}
+
+  ~QueueWaiter() {
+    if (waited_ns_) {
+      *waited_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+    }
+  }
+
+  QueueWaiter(const QueueWaiter&) = delete;
+  QueueWaiter& operator=(const QueueWaiter&) = delete;
+
+  void Wait() {
+    if (rounds_ < kSpinRounds) {
+      asmPause();
+    } else if (rounds_ < kSpinRounds + kYieldRounds) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    ++rounds_;
+  }
+
+private:
+  static constexpr uint32_t kSpinRounds = 64;
+  static constexpr uint32_t kYieldRounds = 1024;
+
+  uint64_t* waited_ns_;
+  std::chrono::steady_clock::time_point start_;
+  uint32_t rounds_{0};
+};
+
+}  // namespace internal
+
+/// A bounded queue of values of T that any number of threads push to and
+/// pop from without locks. Each slot has a sequence number that tells
+/// producers and consumers whose turn it is, so threads only contend on the
+/// position of their end of the queue:
+///
+///   Dmitry Vyukov. Bounded MPMC queue.
+///   https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+///
+/// The blocking Push and Pop wait for room and for values by spinning, then
+/// yielding, then sleeping for short periods, which suits queues of batches
+/// between pipeline stages whose waits are short when the stages are
+/// balanced. A queue is closed once no more values will be pushed, after
+/// which Pop drains it.
+template <typename T>
+class MPMCQueue {
+public:
+  /// Make a queue of capacity values, rounded up to a power of two of at
+  /// least 2
+  explicit MPMCQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask_ = size - 1;
+  }
+
+  ~MPMCQueue() {
+    size_t end = enqueue_pos_.load(std::memory_order_relaxed);
+    for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos < end;
+         ++pos) {
+      cells_[pos & mask_].value()->~T();
+    }
+  }
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  /// Push value unless the queue is full, in which case value is left as it
+  /// was
+  bool TryPush(T&& value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          new (&cell.storage) T(std::move(value));
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Pop a value unless the queue is empty
+  std::optional<T> TryPop() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      auto diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          T* stored = cell.value();
+          std::optional<T> result(std::move(*stored));
+          stored->~T();
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return result;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Wait for room and push value. Returns false, dropping value, if the
+  /// queue is closed. If waited_ns is not null, the time spent waiting is
+  /// added to it.
+  bool Push(T value, uint64_t* waited_ns = nullptr) {
+    if (closed()) {
+      return false;
+    }
+    if (TryPush(std::move(value))) {
+      return true;
+    }
+    internal::QueueWaiter waiter(waited_ns);
+    while (!closed()) {
+      if (TryPush(std::move(value))) {
+        return true;
+      }
+      waiter.Wait();
+    }
+    return false;
+  }
+
+  /// Wait for a value. Returns nullopt once the queue is closed and empty.
+  /// If waited_ns is not null, the time spent waiting is added to it.
+  std::optional<T> Pop(uint64_t* waited_ns = nullptr) {
+    if (std::optional<T> value = TryPop()) {
+      return value;
+    }
+    internal::QueueWaiter waiter(waited_ns);
+    for (;;) {
+      // Values pushed before the queue was closed are visible once closed
+      // is, so the queue is drained if it is still empty after that
+      bool was_closed = closed();
+      if (std::optional<T> value = TryPop()) {
+        return value;
+      }
+      if (was_closed) {
+        return std::nullopt;
+      }
+      waiter.Wait();
+    }
+  }
+
+  /// Stop accepting values and wake up the threads waiting on the queue
+  void Close() { closed_.store(true, std::memory_order_release); }
+
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  size_t capacity() const { return mask_ + 1; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T* value() { return std::launder(reinterpret_cast<T*>(&storage)); }
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<bool> closed_{false};
+};
+
+/// The statistics of a stage of a Pipeline. Times are summed over the
+/// threads of the stage.
+struct PipelineStageStats {
+  std::string name;
+  unsigned threads{0};
+  /// The values the stage took from its input, or emitted if it has none
+  uint64_t items{0};
+  /// The time spent in the stage function other than waiting on queues
+  uint64_t busy_ns{0};
+  /// The time spent waiting for input
+  uint64_t starved_ns{0};
+  /// The time spent waiting for room in the output, i.e., held back by the
+  /// stages after this one
+  uint64_t blocked_ns{0};
+};
+
+/// Passes the values of a stage of a Pipeline to the next stage
+template <typename T>
+class PipelineEmitter {
+public:
+  /// Pass value on, waiting while the queue of the next stage is full.
+  /// Returns false if the pipeline is stopping because a stage failed, after
+  /// which the stage should return.
+  bool operator()(T value) {
+    ++emitted_;
+    return queue_->Push(std::move(value), &blocked_ns_);
+  }
+
+private:
+  friend class Pipeline;
+
+  explicit PipelineEmitter(MPMCQueue<T>* queue) : queue_(queue) {}
+
+  MPMCQueue<T>* queue_;
+  uint64_t emitted_{0};
+  uint64_t blocked_ns_{0};
+};
+
+/// A Pipeline runs stages concurrently, each on its own threads, connected
+/// by bounded MPMCQueues, so that, e.g., reading input, parsing it and
+/// writing the result overlap instead of running one after another:
+///
+///     katana::Pipeline pipeline("Import");
+///     auto chunks = pipeline.AddSource<Chunk>(
+///         "Read", 1, [&](katana::PipelineEmitter<Chunk>& emit) {
+///           while (auto chunk = ReadChunk()) {
+///             if (!emit(std::move(*chunk))) {
+///               break;
+///             }
+///           }
+///           return katana::ResultSuccess();
+///         });
+///     auto batches = pipeline.AddStage<Batch, Chunk>(
+///         "Parse", chunks, 4,
+///         [&](Chunk chunk, katana::PipelineEmitter<Batch>& emit) {
+///           emit(Parse(chunk));
+///           return katana::ResultSuccess();
+///         });
+///     pipeline.AddSink<Batch>("Write", batches, 1, [&](Batch batch) {
+///       return Write(batch);
+///     });
+///     if (auto res = pipeline.Run(); !res) {
+///       return res.error();
+///     }
+///
+/// Values should be batches large enough that passing one through a queue is
+/// cheap next to processing it. Queues hold queue_capacity values, so a
+/// stage that falls behind holds back the stages before it instead of
+/// letting values pile up in memory. The threads of a stage take values from
+/// its input in any order; a stage that needs them in order should have one
+/// thread, or carry sequence numbers in its values. A stream may feed several
+/// stages, each value going to one of them.
+///
+/// Stages run on threads of their own rather than on the thread pool, so
+/// that a stage that waits on I/O does not hold up the others. If
+/// pin_threads, they are bound to consecutive hardware contexts in the order
+/// of getHWTopo, stage after stage, so that each stage has its own subset of
+/// the machine while there are enough contexts.
+///
+/// The first error returned by a stage function stops the pipeline: every
+/// queue is closed, so emitters return false and stages stop taking input,
+/// and Run returns the error. The statistics of each stage are reported
+/// under the name of the pipeline.
+class KATANA_EXPORT Pipeline {
+public:
+  static constexpr size_t kDefaultQueueCapacity = 64;
+
+  /// The output of a stage, to give to the stages that take it as input
+  template <typename T>
+  class Stream {
+  public:
+    Stream() = default;
+
+  private:
+    friend class Pipeline;
+
+    explicit Stream(std::shared_ptr<MPMCQueue<T>> queue)
+        : queue_(std::move(queue)) {}
+
+    std::shared_ptr<MPMCQueue<T>> queue_;
+  };
+
+  explicit Pipeline(
+      std::string name, size_t queue_capacity = kDefaultQueueCapacity,
+      bool pin_threads = true);
+
+  ~Pipeline();
+
+  Pipeline(const Pipeline&) = delete;
+  Pipeline& operator=(const Pipeline&) = delete;
+
+  /// Add a stage without input that calls fn(emit) on each of threads
+  /// threads and returns the stream of the values they emit. fn returns
+  /// Result<void>.
+  template <typename T, typename Fn>
+  Stream<T> AddSource(const std::string& name, unsigned threads, Fn fn) {
+    auto output = std::make_shared<MPMCQueue<T>>(queue_capacity_);
+    Stage* stage = AddStageRecord(name, threads, [output] { output->Close(); });
+    stage->run = [output, fn](PipelineStageStats* stats) -> Result<void> {
+      PipelineEmitter<T> emit(output.get());
+      Result<void> res = fn(emit);
+      stats->items += emit.emitted_;
+      stats->blocked_ns += emit.blocked_ns_;
+      return res;
+    };
+    return Stream<T>(output);
+  }
+
+  /// Add a stage that calls fn(value, emit) for each value of input, on
+  /// threads threads, and returns the stream of the values it emits. fn
+  /// returns Result<void>.
+  template <typename Out, typename In, typename Fn>
+  Stream<Out> AddStage(
+      const std::string& name, const Stream<In>& input, unsigned threads,
+      Fn fn) {
+    auto output = std::make_shared<MPMCQueue<Out>>(queue_capacity_);
+    Stage* stage = AddStageRecord(name, threads, [output] { output->Close(); });
+    stage->run = [this, input = input.queue_, output,
+                  fn](PipelineStageStats* stats) -> Result<void> {
+      PipelineEmitter<Out> emit(output.get());
+      Result<void> res = ResultSuccess();
+      while (!stopping()) {
+        std::optional<In> value = input->Pop(&stats->starved_ns);
+        if (!value) {
+          break;
+        }
+        ++stats->items;
+        res = fn(std::move(*value), emit);
+        if (!res) {
+          break;
+        }
+      }
+      stats->blocked_ns += emit.blocked_ns_;
+      return res;
+    };
+    return Stream<Out>(output);
+  }
+
+  /// Add a stage that calls fn(value) for each value of input on threads
+  /// threads. fn returns Result<void>.
+  template <typename In, typename Fn>
+  void AddSink(
+      const std::string& name, const Stream<In>& input, unsigned threads,
+      Fn fn) {
+    Stage* stage = AddStageRecord(name, threads, [] {});
+    stage->run = [this, input = input.queue_,
+                  fn](PipelineStageStats* stats) -> Result<void> {
+      while (!stopping()) {
+        std::optional<In> value = input->Pop(&stats->starved_ns);
+        if (!value) {
+          break;
+        }
+        ++stats->items;
+        Result<void> res = fn(std::move(*value));
+        if (!res) {
+          return res;
+        }
+      }
+      return ResultSuccess();
+    };
+  }
+
+  /// Run the stages until every source has returned and every value has
+  /// been consumed, or a stage fails. A pipeline runs once.
+  Result<void> Run();
+
+  /// The statistics of each stage, in the order they were added, once Run
+  /// has returned
+  std::vector<PipelineStageStats> stats() const;
+
+  const std::string& name() const { return name_; }
+
+private:
+  struct Stage {
+    PipelineStageStats stats;
+    /// Runs the stage on one thread, adding to the items, starved_ns and
+    /// blocked_ns of stats
+    std::function<Result<void>(PipelineStageStats*)> run;
+    /// Closes the output of the stage, once its last thread returns
+    std::function<void()> close_output;
+    std::atomic<unsigned> running{0};
+  };
+
+  Stage* AddStageRecord(
+      const std::string& name, unsigned threads,
+      std::function<void()> close_output);
+
+  void RunWorker(Stage* stage, std::optional<unsigned> os_context);
+
+  void Fail(const ErrorInfo& error);
+
+  bool stopping() const { return stopping_.load(std::memory_order_relaxed); }
+
+  std::string name_;
+  size_t queue_capacity_;
+  bool pin_threads_;
+  bool ran_{false};
+  std::vector<std::unique_ptr<Stage>> stages_;
+
+  mutable std::mutex mutex_;
+  std::atomic<bool> stopping_{false};
+  std::optional<CopyableErrorInfo> error_;
+};
+
+}  // namespace katana
+
+#endif
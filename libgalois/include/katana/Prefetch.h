@@ -0,0 +1,165 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+#define KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <boost/iterator/iterator_adaptor.hpp>
+
+#include "katana/PropertyGraph.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How many edges ahead to prefetch by default. Far enough to cover a miss
+/// to memory when a loop body does little more than update its destination,
+/// near enough that the prefetched lines are not evicted before they are
+/// used.
+constexpr unsigned kDefaultPrefetchDistance = 8;
+
+/// Prefetch the cache line of \param addr for reading
+inline void
+PrefetchRead(const void* addr) {
+  __builtin_prefetch(addr, 0, 3);
+}
+
+/// Prefetch the cache line of \param addr for writing
+inline void
+PrefetchWrite(const void* addr) {
+  __builtin_prefetch(addr, 1, 3);
+}
+
+/// An iterator over the edges of an edge range that, when positioned at
+/// edge i, has called a prefetch function on edges [i, i + Distance) of the
+/// range. Iter must be a random access iterator.
+template <unsigned Distance, typename Iter, typename Fn>
+class PrefetchingEdgeIterator
+    : public boost::iterator_adaptor<
+          PrefetchingEdgeIterator<Distance, Iter, Fn>, Iter,
+          boost::use_default, boost::forward_traversal_tag> {
+  static_assert(Distance > 0, "prefetch distance must be positive");
+
+  friend class boost::iterator_core_access;
+
+  using Diff = typename std::iterator_traits<Iter>::difference_type;
+  constexpr static Diff kDistance = Distance;
+
+  Iter end_{};
+  const Fn* fn_{nullptr};
+
+  void increment() {
+    ++this->base_reference();
+    if (end_ - this->base() >= kDistance) {
+      (*fn_)(*(this->base() + (kDistance - 1)));
+    }
+  }
+
+public:
+  PrefetchingEdgeIterator() = default;
+  PrefetchingEdgeIterator(Iter it, Iter end, const Fn* fn)
+      : PrefetchingEdgeIterator::iterator_adaptor_(it), end_(end), fn_(fn) {}
+};
+
+/// An edge range whose iterators prefetch Distance edges ahead with a
+/// function of an edge, e.g., a \ref DestinationPrefetcher. Made with
+/// \ref PrefetchEdges.
+template <unsigned Distance, typename Range, typename Fn>
+class PrefetchingEdgeRange {
+  using BaseIterator = decltype(std::declval<const Range&>().begin());
+  using Diff = typename std::iterator_traits<BaseIterator>::difference_type;
+
+  static_assert(
+      std::is_base_of_v<
+          std::random_access_iterator_tag,
+          typename std::iterator_traits<BaseIterator>::iterator_category>,
+      "prefetching needs a range with random access iterators");
+
+public:
+  using iterator = PrefetchingEdgeIterator<Distance, BaseIterator, Fn>;
+
+  PrefetchingEdgeRange(Range range, Fn fn)
+      : range_(std::move(range)), fn_(std::move(fn)) {}
+
+  /// Prefetches the first Distance edges of the range
+  iterator begin() const {
+    BaseIterator b = range_.begin();
+    BaseIterator e = range_.end();
+    for (BaseIterator it = b; it != e && it - b < Diff{Distance}; ++it) {
+      fn_(*it);
+    }
+    return iterator(b, e, &fn_);
+  }
+
+  iterator end() const { return iterator(range_.end(), range_.end(), &fn_); }
+
+  size_t size() const { return range_.end() - range_.begin(); }
+
+  bool empty() const { return range_.begin() == range_.end(); }
+
+private:
+  Range range_;
+  Fn fn_;
+};
+
+/// \returns a range over the edges of \param range, e.g., graph.edges(n),
+/// that calls \param fn on each edge Distance edges before the loop reaches
+/// it
+template <unsigned Distance = kDefaultPrefetchDistance, typename Range,
+          typename Fn>
+PrefetchingEdgeRange<Distance, Range, Fn>
+PrefetchEdges(Range range, Fn fn) {
+  return PrefetchingEdgeRange<Distance, Range, Fn>(
+      std::move(range), std::move(fn));
+}
+
+/// A function of an edge of a graph that prefetches the NodeIndexes
+/// properties of its destination for writing and, optionally, the bounds of
+/// the destination's edge range, for loops that update or expand their
+/// destinations. The properties must be stored, i.e., GetData must return
+/// references.
+template <typename Graph, typename... NodeIndexes>
+class DestinationPrefetcher {
+public:
+  DestinationPrefetcher(Graph* graph, bool edge_ranges)
+      : graph_(graph),
+        dests_(graph->GetPropertyGraph().topology().out_dests->raw_values()),
+        indices_(
+            edge_ranges ? graph->GetPropertyGraph()
+                              .topology()
+                              .out_indices->raw_values()
+                        : nullptr) {}
+
+  void operator()(GraphTopology::Edge edge) const {
+    GraphTopology::Node dest = dests_[edge];
+    (PrefetchWrite(
+         std::addressof(graph_->template GetData<NodeIndexes>(dest))),
+     ...);
+    if (indices_ != nullptr) {
+      // Entries dest - 1 and dest bound the edges of dest
+      PrefetchRead(indices_ + dest - (dest > 0));
+    }
+  }
+
+private:
+  Graph* graph_;
+  const uint32_t* dests_;
+  const uint64_t* indices_;
+};
+
+/// \returns a \ref DestinationPrefetcher for the NodeIndexes properties of
+/// \param graph that also prefetches destination edge ranges if
+/// \param edge_ranges, e.g.,
+/// <code>PrefetchEdges(graph->edges(n),
+///     PrefetchDestinations<NodeDistance>(graph))</code>
+template <typename... NodeIndexes, typename Graph>
+DestinationPrefetcher<Graph, NodeIndexes...>
+PrefetchDestinations(Graph* graph, bool edge_ranges = false) {
+  return DestinationPrefetcher<Graph, NodeIndexes...>(graph, edge_ranges);
+}
+
+}  // namespace katana
+
+#endif
@@ -2,7 +2,9 @@
 #define KATANA_LIBGALOIS_KATANA_PROPERTIES_H_
 
 #include <cassert>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include <arrow/array.h>
@@ -12,6 +14,7 @@
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
 #include "katana/Result.h"
 #include "katana/Traits.h"
 
@@ -85,6 +88,15 @@ template <typename Prop>
 using PropertyConstReferenceType =
     typename PropertyViewType<Prop>::const_reference;
 
+/// PropertyIsWritable is true if the views of Prop can modify property values
+/// in place, i.e., if they have a reference type. Read-only views do not.
+template <typename Prop, typename = void>
+struct PropertyIsWritable : std::false_type {};
+
+template <typename Prop>
+struct PropertyIsWritable<Prop, std::void_t<PropertyReferenceType<Prop>>>
+    : std::true_type {};
+
 namespace internal {
 
 template <typename>
@@ -275,6 +287,14 @@ public:
 
   const_reference operator[](size_t i) const { return GetValue(i); }
 
+  /// The values of the view as one contiguous array of size() elements, for
+  /// loops that should compile to plain loads and stores
+  T* data() { return values_ + offset_; }
+
+  const T* data() const { return values_ + offset_; }
+
+  size_t size() const { return length_; }
+
 private:
   PODPropertyView(
       T* values, const uint8_t* null_bitmap, size_t length, size_t offset)
@@ -288,6 +308,87 @@ private:
   size_t length_, offset_;
 };
 
+/// FixedSizeListPropertyView provides a property view over
+/// arrow::FixedSizeListArrays whose elements are PODs, such as embeddings of
+/// a fixed dimension. The elements of all lists are stored contiguously, row
+/// after row, so GetValue(i) is a pointer to the width() elements of row i.
+/// The validity of individual elements is ignored.
+///
+/// \tparam T A plain old C datatype like float or int32_t
+template <typename T>
+class FixedSizeListPropertyView {
+public:
+  using value_type = T;
+  using reference = T*;
+  using const_reference = const T*;
+
+  static Result<FixedSizeListPropertyView> Make(
+      const arrow::FixedSizeListArray& array) {
+    const auto& values = array.values()->data();
+    const auto* value_type =
+        dynamic_cast<const arrow::FixedWidthType*>(values->type.get());
+    if (value_type == nullptr || value_type->id() == arrow::Type::BOOL ||
+        value_type->bit_width() != sizeof(T) * 8) {
+      KATANA_LOG_DEBUG(
+          "arrow error: bad list element type: {}", values->type->ToString());
+      return ErrorCode::ArrowError;
+    }
+    if (array.offset() < 0) {
+      KATANA_LOG_DEBUG("arrow error: Offset not supported");
+      return ErrorCode::ArrowError;
+    }
+    if (values->buffers.size() <= 1 || !values->buffers[1]->is_mutable()) {
+      KATANA_LOG_DEBUG("arrow error: immutable buffers not supported");
+      return ErrorCode::ArrowError;
+    }
+    size_t width = array.list_type()->list_size();
+    return FixedSizeListPropertyView(
+        GetMutableValuesWorkAround<T>(values, 1, values->offset) +
+            array.offset() * width,
+        array.data()->template GetValues<uint8_t>(0, 0), array.length(),
+        array.offset(), width);
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    return null_bitmap_ == nullptr ||
+           arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
+
+  reference GetValue(size_t i) { return values_ + i * width_; }
+
+  const_reference GetValue(size_t i) const { return values_ + i * width_; }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+  /// The elements of all lists as one contiguous array of size() * width()
+  /// elements
+  T* data() { return values_; }
+
+  const T* data() const { return values_; }
+
+  size_t size() const { return length_; }
+
+  /// The number of elements of each list
+  size_t width() const { return width_; }
+
+private:
+  FixedSizeListPropertyView(
+      T* values, const uint8_t* null_bitmap, size_t length, size_t offset,
+      size_t width)
+      : values_(values),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset),
+        width_(width) {}
+
+  T* values_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_, width_;
+};
+
 /// BooleanPropertyReadOnlyView provides a read-only property view over
 /// arrow::Arrays of boolean elements.
 class BooleanPropertyReadOnlyView {
@@ -358,12 +459,90 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryStringPropertyReadOnlyView provides a read-only property view
+/// over dictionary encoded strings, i.e., an arrow::DictionaryArray of int32
+/// indices into a string dictionary, which is how low cardinality string
+/// properties are loaded. Operators can compare the codes of values, e.g.,
+/// GetCode(i) == FindCode("Person"), instead of the strings.
+class DictionaryStringPropertyReadOnlyView {
+public:
+  using value_type = std::string;
+
+  static Result<DictionaryStringPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    if (array.indices()->type_id() != arrow::Type::INT32 ||
+        array.dictionary()->type_id() != arrow::Type::STRING) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError,
+          "expected int32 indices into a string dictionary, found {}",
+          array.type()->ToString());
+    }
+    return DictionaryStringPropertyReadOnlyView(array);
+  }
+
+  bool IsValid(size_t i) const { return array_.IsValid(i); }
+
+  /// \returns the index of the value of row i in the dictionary
+  int32_t GetCode(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  /// \returns the index of value in the dictionary, or -1 if the
+  /// dictionary does not have it, so that no row has it
+  int32_t FindCode(std::string_view value) const {
+    for (int64_t code = 0, n = dictionary_.length(); code < n; ++code) {
+      auto view = dictionary_.GetView(code);
+      if (std::string_view(view.data(), view.size()) == value) {
+        return code;
+      }
+    }
+    return -1;
+  }
+
+  std::string_view GetView(size_t i) const {
+    auto view = dictionary_.GetView(GetCode(i));
+    return std::string_view(view.data(), view.size());
+  }
+
+  value_type GetValue(size_t i) const { return std::string(GetView(i)); }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+  const arrow::StringArray& dictionary() const { return dictionary_; }
+
+private:
+  DictionaryStringPropertyReadOnlyView(const arrow::DictionaryArray& array)
+      : array_(array),
+        codes_(static_cast<const arrow::Int32Array&>(*array.indices())
+                   .raw_values()),
+        dictionary_(
+            static_cast<const arrow::StringArray&>(*array.dictionary())) {}
+
+  const arrow::DictionaryArray& array_;
+  const int32_t* codes_;
+  const arrow::StringArray& dictionary_;
+};
+
 template <typename T>
 struct PODProperty {
   using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
   using ViewType = PODPropertyView<T>;
 };
 
+/// FixedSizeListProperty is a property whose values are lists of the same
+/// number of Ts, viewed as rows of a contiguous array
+template <typename T>
+struct FixedSizeListProperty {
+  using ArrowType = arrow::FixedSizeListType;
+  using ViewType = FixedSizeListPropertyView<T>;
+};
+
 struct UInt8Property : public PODProperty<uint8_t> {};
 
 struct UInt16Property : public PODProperty<uint16_t> {};
@@ -387,6 +566,11 @@ struct LargeStringReadOnlyProperty {
   using ViewType = StringPropertyReadOnlyView<arrow::LargeStringArray>;
 };
 
+struct DictionaryStringReadOnlyProperty {
+  using ArrowType = arrow::DictionaryType;
+  using ViewType = DictionaryStringPropertyReadOnlyView;
+};
+
 template <typename Props>
 Result<std::shared_ptr<arrow::Table>>
 AllocateTable(uint64_t num_rows, const std::vector<std::string>& names) {
@@ -395,9 +579,10 @@ AllocateTable(uint64_t num_rows, const std::vector<std::string>& names) {
   std::shared_ptr<arrow::Table> table;
   std::vector<katana::PropertyArrowTuple<Props>> rows(num_rows);
   KATANA_LOG_ASSERT(names.size() == num_tuple_elem);
-  // TODO(gill): Replace this with NUMA allocated buffers.
+  // The budgeted pool places large buffers on NUMA nodes once the runtime
+  // is up (see katana::NumaMemoryPool)
   if (auto r = arrow::stl::TableFromTupleRange(
-          arrow::default_memory_pool(), std::move(rows), names, &table);
+          katana::BudgetedMemoryPool(), std::move(rows), names, &table);
       !r.ok()) {
     KATANA_LOG_DEBUG("arrow error: {}", r);
     return katana::ErrorCode::ArrowError;
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <algorithm>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,10 +16,171 @@
 #include "katana/ErrorCode.h"
 #include "katana/LargeArray.h"
 #include "katana/config.h"
+#include "tsuba/CompressedCSRTopology.h"
+#include "tsuba/PropertyStats.h"
 #include "tsuba/RDG.h"
+#include "tsuba/Snapshot.h"
 
 namespace katana {
 
+/// An index of the edges of each node by type, for a topology whose edges
+/// are sorted by type within each node (see SortAllEdgesByType). The edges
+/// of a node form runs of edges with the same type, and the index keeps the
+/// type and end of each run, so its size is proportional to the number of
+/// distinct (node, type) pairs rather than to nodes times types.
+struct KATANA_EXPORT EdgeTypeIndex {
+  using EdgeType = uint32_t;
+
+  /// Entry n is the end of the runs of node n in run_types and run_ends
+  LargeArray<uint64_t> node_run_ends;
+  /// Type of each run, increasing within the runs of each node
+  LargeArray<EdgeType> run_types;
+  /// Entry r is the end of the edges of run r, which begin where run r - 1
+  /// ends
+  LargeArray<uint64_t> run_ends;
+};
+
+/// The times of the edges of a topology whose edges are sorted by time
+/// within each node (see SortAllEdgesByTime), so that the edges of a node in
+/// a time window are a contiguous range found by binary search.
+struct KATANA_EXPORT EdgeTimeIndex {
+  /// The edge property the times were read from
+  std::string property;
+  /// Entry e is the time of edge e, which does not decrease within the
+  /// edges of each node
+  LargeArray<int64_t> times;
+};
+
+/// The edges of a symmetric topology oriented from lower to higher rank,
+/// where nodes are ranked by degree and then by id. Each undirected edge
+/// appears once, as an out-edge of its lower ranked endpoint, so every
+/// clique is found exactly once from its lowest ranked node and no node has
+/// more than O(sqrt(num_edges)) out-edges. This is the order that relabeling
+/// the nodes by degree gives triangle counting, without permuting the graph.
+struct KATANA_EXPORT DegreeOrderedDag {
+  /// Entry n is the end of the out-edges of node n in out_dests
+  LargeArray<uint64_t> out_indices;
+  /// Destinations of the out-edges of each node in increasing id order,
+  /// without self loops or repeated edges
+  LargeArray<uint32_t> out_dests;
+  /// The largest number of out-edges of a node
+  uint64_t max_out_degree{0};
+
+  uint64_t num_nodes() const { return out_indices.size(); }
+
+  uint64_t num_edges() const { return out_dests.size(); }
+
+  /// The destinations [begin, end) of the out-edges of node
+  std::pair<const uint32_t*, const uint32_t*> OutNeighbors(
+      uint32_t node) const {
+    const uint32_t* dests = out_dests.data();
+    return std::make_pair(
+        dests + (node > 0 ? out_indices[node - 1] : 0),
+        dests + out_indices[node]);
+  }
+};
+
+/// A view of a topology in which every hub, a node with more than max_degree
+/// out-edges or in-edges, is split into virtual nodes with at most
+/// max_degree out-edges each. The virtual nodes of a node are consecutive
+/// and divide its out-edges between them in order, so the view indexes the
+/// edges of the topology and their properties without copying them.
+///
+/// Push-style analytics iterate over the virtual nodes to balance the edges
+/// of hubs between threads. To spread the updates that many sources push
+/// into a hub, they can also accumulate them in one slot per virtual node,
+/// at PushTarget, and merge the slots of each hub into the hub afterwards;
+/// see ForEachHubReplica.
+struct KATANA_EXPORT HubSplitView {
+  /// The largest degree of a node that is not split
+  uint64_t max_degree{0};
+  /// Entry n is the end of the virtual nodes of node n
+  LargeArray<uint64_t> node_indices;
+  /// Entry v is the end, in the edges of the topology, of the out-edges of
+  /// virtual node v
+  LargeArray<uint64_t> edge_indices;
+  /// Entry v is the node that virtual node v is part of
+  LargeArray<uint32_t> virtual_to_node;
+  /// The nodes that are split into more than one virtual node, in
+  /// increasing order
+  LargeArray<uint32_t> hubs;
+
+  uint64_t num_nodes() const { return node_indices.size(); }
+
+  uint64_t num_virtual_nodes() const { return virtual_to_node.size(); }
+
+  uint32_t node(uint64_t virtual_node) const {
+    return virtual_to_node[virtual_node];
+  }
+
+  /// The virtual nodes [begin, end) of node
+  std::pair<uint64_t, uint64_t> virtual_nodes(uint32_t node) const {
+    return std::make_pair(
+        node > 0 ? node_indices[node - 1] : 0, node_indices[node]);
+  }
+
+  /// The out-edges [begin, end) of virtual_node in the topology
+  std::pair<uint64_t, uint64_t> edge_range(uint64_t virtual_node) const {
+    return std::make_pair(
+        virtual_node > 0 ? edge_indices[virtual_node - 1] : 0,
+        edge_indices[virtual_node]);
+  }
+
+  /// The virtual node of dest that a push keyed by key, e.g., the pushing
+  /// virtual node or thread, should update. Different keys spread the pushes
+  /// into a hub over its virtual nodes.
+  uint64_t PushTarget(uint32_t dest, uint64_t key) const {
+    auto [begin, end] = virtual_nodes(dest);
+    return begin + key % (end - begin);
+  }
+};
+
+/// The edges of a topology in coordinate (COO) form, ordered along a Hilbert
+/// curve over square blocks of the adjacency matrix, each spanning
+/// 2^block_bits sources and 2^block_bits destinations. Consecutive blocks
+/// along the curve share their sources or their destinations, so kernels
+/// that go over every edge and touch data of both ends, e.g., edge iterating
+/// triangle counting, find much of that data still in cache, which the
+/// order of the topology only gives them for the sources.
+///
+/// Only blocks with edges are kept. Within a block, edges are in the order
+/// of the topology. See ForEachEdgeBlock and AccumulateEdgeBlocks.
+struct KATANA_EXPORT HilbertEdgeList {
+  /// Blocks span 2^block_bits sources and destinations
+  uint32_t block_bits{0};
+  uint64_t num_nodes{0};
+  /// Entry b is the end of the edges of block b, which begin where block
+  /// b - 1 ends
+  LargeArray<uint64_t> block_ends;
+  /// The source, destination and edge in the topology of each edge
+  LargeArray<uint32_t> sources;
+  LargeArray<uint32_t> dests;
+  LargeArray<uint64_t> edges;
+  /// The blocks of each column of blocks, i.e., of the destinations from
+  /// c << block_bits: entry c of column_ends is the end of the blocks of
+  /// column c in column_blocks, in the order of the curve
+  LargeArray<uint64_t> column_ends;
+  LargeArray<uint64_t> column_blocks;
+
+  uint64_t num_edges() const { return edges.size(); }
+
+  uint64_t num_blocks() const { return block_ends.size(); }
+
+  uint64_t num_columns() const { return column_ends.size(); }
+
+  /// The edges [begin, end) of block
+  std::pair<uint64_t, uint64_t> block_range(uint64_t block) const {
+    return std::make_pair(
+        block > 0 ? block_ends[block - 1] : 0, block_ends[block]);
+  }
+
+  /// The blocks [begin, end) of column in column_blocks
+  std::pair<uint64_t, uint64_t> column_range(uint64_t column) const {
+    return std::make_pair(
+        column > 0 ? column_ends[column - 1] : 0, column_ends[column]);
+  }
+};
+
 /// A graph topology represents the adjacency information for a graph in CSR
 /// format.
 struct KATANA_EXPORT GraphTopology {
@@ -27,9 +191,25 @@ struct KATANA_EXPORT GraphTopology {
   using nodes_range = StandardRange<node_iterator>;
   using edges_range = StandardRange<edge_iterator>;
   using iterator = node_iterator;
+  using EdgeType = EdgeTypeIndex::EdgeType;
 
   std::shared_ptr<arrow::UInt64Array> out_indices;
   std::shared_ptr<arrow::UInt32Array> out_dests;
+  /// Optional index of the edges of each node by type; see
+  /// PropertyGraph::IndexEdgesByType
+  std::shared_ptr<const EdgeTypeIndex> edge_type_index;
+  /// Optional orientation of the edges by degree; see
+  /// PropertyGraph::OrientByDegree
+  std::shared_ptr<const DegreeOrderedDag> degree_ordered_dag;
+  /// Optional index of the edges of each node by time; see
+  /// PropertyGraph::IndexEdgesByTime
+  std::shared_ptr<const EdgeTimeIndex> edge_time_index;
+  /// Optional view of the topology with its hubs split; see
+  /// PropertyGraph::SplitHubs
+  std::shared_ptr<const HubSplitView> hub_split_view;
+  /// Optional edge list ordered along a Hilbert curve; see
+  /// PropertyGraph::OrderEdgesAlongHilbertCurve
+  std::shared_ptr<const HilbertEdgeList> hilbert_edge_list;
 
   uint64_t num_nodes() const { return out_indices ? out_indices->length() : 0; }
 
@@ -64,6 +244,47 @@ struct KATANA_EXPORT GraphTopology {
     auto [begin_edge, end_edge] = edge_range(node);
     return MakeStandardRange<edge_iterator>(begin_edge, end_edge);
   }
+
+  /// Gets the edges of some node that have some type. The topology must
+  /// have an edge_type_index.
+  ///
+  /// \param node node to get the edges of
+  /// \param type edge type to get the edges of
+  /// \returns iterable edge range of the edges of node with type
+  edges_range edges(Node node, EdgeType type) const {
+    KATANA_LOG_DEBUG_ASSERT(edge_type_index);
+    const EdgeTypeIndex& index = *edge_type_index;
+    const EdgeType* types = index.run_types.data();
+    const EdgeType* runs_begin =
+        types + (node > 0 ? index.node_run_ends[node - 1] : 0);
+    const EdgeType* runs_end = types + index.node_run_ends[node];
+    const EdgeType* run = std::lower_bound(runs_begin, runs_end, type);
+    if (run == runs_end || *run != type) {
+      return MakeStandardRange<edge_iterator>(0, 0);
+    }
+    uint64_t r = run - types;
+    return MakeStandardRange<edge_iterator>(
+        r > 0 ? index.run_ends[r - 1] : 0, index.run_ends[r]);
+  }
+
+  /// Gets the edges of some node whose time is in [begin_time, end_time).
+  /// The topology must have an edge_time_index.
+  ///
+  /// \param node node to get the edges of
+  /// \param begin_time first time of the window
+  /// \param end_time time just past the window
+  /// \returns iterable edge range of the edges of node in the window
+  edges_range edges(Node node, int64_t begin_time, int64_t end_time) const {
+    KATANA_LOG_DEBUG_ASSERT(edge_time_index);
+    auto [begin_edge, end_edge] = edge_range(node);
+    const int64_t* times = edge_time_index->times.data();
+    const int64_t* begin =
+        std::lower_bound(times + begin_edge, times + end_edge, begin_time);
+    const int64_t* end = std::lower_bound(
+        begin, times + end_edge, std::max(begin_time, end_time));
+    return MakeStandardRange<edge_iterator>(begin - times, end - times);
+  }
+
   Node edge_dest(Edge eid) const {
     KATANA_LOG_ASSERT(eid < static_cast<Edge>(out_dests->length()));
     return out_dests->Value(eid);
@@ -84,6 +305,50 @@ struct KATANA_EXPORT GraphTopology {
   bool empty() const { return num_nodes() == 0; }
 };
 
+/// PropertyBatch stages changes to the node or edge properties of a
+/// PropertyGraph so that PropertyGraph::UpdateNodeProperties or
+/// UpdateEdgeProperties applies them together with one rebuild of the
+/// property table, rather than one rebuild per added or removed property.
+/// Properties are named by the names they have before the batch is applied.
+class KATANA_EXPORT PropertyBatch {
+public:
+  /// Add the columns of props as new properties
+  void Add(const std::shared_ptr<arrow::Table>& props) {
+    for (int i = 0, n = props->num_columns(); i < n; ++i) {
+      added_fields_.emplace_back(props->schema()->field(i));
+      added_columns_.emplace_back(props->column(i));
+    }
+  }
+
+  /// Remove the property name
+  void Remove(const std::string& name) { removed_.emplace_back(name); }
+
+  /// Replace the values of the property name with values, which must have
+  /// the type of the property
+  void Replace(
+      const std::string& name, std::shared_ptr<arrow::ChunkedArray> values) {
+    replaced_.emplace_back(name, std::move(values));
+  }
+
+  bool empty() const {
+    return added_fields_.empty() && removed_.empty() && replaced_.empty();
+  }
+
+private:
+  friend class PropertyGraph;
+
+  /// Resolve the names of this batch against schema, the schema of
+  /// properties with num_rows values each, or any number if it is negative
+  Result<tsuba::PropertyUpdate> ToUpdate(
+      const arrow::Schema& schema, int64_t num_rows) const;
+
+  arrow::FieldVector added_fields_;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> added_columns_;
+  std::vector<std::string> removed_;
+  std::vector<std::pair<std::string, std::shared_ptr<arrow::ChunkedArray>>>
+      replaced_;
+};
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -111,8 +376,15 @@ class KATANA_EXPORT PropertyGraph {
   std::unique_ptr<tsuba::RDGFile> file_;
 
   // The topology is either backed by rdg_ or shared with the
-  // caller of SetTopology.
-  GraphTopology topology_;
+  // caller of SetTopology. Mutable so that Copy can make the buffers it
+  // shares read-only.
+  mutable GraphTopology topology_;
+
+  // Encoding of the topology file written by DoWrite, if it is compressed
+  std::optional<tsuba::TopologyEncoding> topology_encoding_;
+
+  // Whether DoWrite stores topologies that fit with 32 bit out indices
+  bool compact_topology_{false};
 
   // Keep partition_metadata, master_nodes, mirror_nodes out of the public interface,
   // while allowing Distribution to read/write it for RDG
@@ -205,14 +477,31 @@ public:
       const std::string& rdg_name,
       const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
 
-  /// \return A copy of this with the same set of properties. The copy shares no
-  ///       state with this.
+  /// Make a read-only property graph from the version of an RDG that
+  /// snapshot pins. The snapshot must stay pinned while properties are
+  /// loaded lazily from it.
+  static Result<std::unique_ptr<PropertyGraph>> Make(
+      const tsuba::Snapshot& snapshot,
+      const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
+
+  /// \return A copy of this with the same set of properties. The copy shares
+  ///       the topology and property buffers of this until one of the graphs
+  ///       modifies them; see Copy(node_properties, edge_properties).
   Result<std::unique_ptr<PropertyGraph>> Copy() const;
 
+  /// The copy shares the topology and the property columns of this rather
+  /// than duplicating them. Shared buffers are made read-only in both graphs,
+  /// so a graph that modifies them in place copies them first: the topology
+  /// in, e.g., SortAllEdgesByDest, and properties in
+  /// EnsureNodePropertiesMutable, which TypedPropertyGraph::Make calls for
+  /// properties whose views are writable. Properties keep their storage
+  /// locations, so committing the copy writes only what changed. Like
+  /// loading deferred properties, copying must not race with calls that
+  /// modify this graph.
+  ///
   /// \param node_properties The node properties to copy.
   /// \param edge_properties The edge properties to copy.
-  /// \return A copy of this with a subset of the properties. The copy shares no
-  ///        state with this.
+  /// \return A copy of this with a subset of the properties.
   Result<std::unique_ptr<PropertyGraph>> Copy(
       const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties) const;
@@ -269,6 +558,28 @@ public:
   /// Like \ref Write(const std::string&, const std::string&) but update
   /// the original read location of the graph
   Result<void> Commit(const std::string& command_line);
+
+  /// Record in the lineage of the next version written by Write or Commit
+  /// where that version comes from (see tsuba::RDG::AddProvenance)
+  void AddProvenance(const std::string& key, const std::string& value) {
+    rdg_.AddProvenance(key, value);
+  }
+
+  /// Store the topology in the compressed CSR format with the given encoding
+  /// (see tsuba/CompressedCSRTopology.h) the next time this graph is written,
+  /// or uncompressed if encoding is empty. The topology in memory is not
+  /// affected; compressed topologies are decoded when they are loaded.
+  void set_topology_encoding(
+      std::optional<tsuba::TopologyEncoding> encoding) {
+    topology_encoding_ = encoding;
+  }
+
+  /// Store the topology with 32 bit out indices (see
+  /// katana::CompactGraphTopology) the next time this graph is written if it
+  /// has fewer than 2^32 edges, which takes a third less space than the
+  /// default layout. The topology in memory is not affected. Readers that
+  /// only take the default layout, e.g., the partitioner, cannot read it.
+  void set_compact_topology(bool compact) { compact_topology_ = compact; }
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path) {
     if (!rdg_.rdg_dir().empty()) {
@@ -303,20 +614,13 @@ public:
   }
 
   // num_rows() == num_nodes() (all local nodes)
-  std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const {
-    if (i >= rdg_.node_properties()->num_columns()) {
-      return nullptr;
-    }
-    return rdg_.node_properties()->column(i);
-  }
+  //
+  // If the graph was loaded with RDGLoadOptions::lazy_properties, the first
+  // access to a property reads it from storage.
+  std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const;
 
   // num_rows() == num_edges() (all local edges)
-  std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const {
-    if (i >= rdg_.edge_properties()->num_columns()) {
-      return nullptr;
-    }
-    return rdg_.edge_properties()->column(i);
-  }
+  std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const;
 
   /// Get a node property by name.
   ///
@@ -324,7 +628,7 @@ public:
   /// \return The property data or NULL if the property is not found.
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(
       const std::string& name) const {
-    return rdg_.node_properties()->GetColumnByName(name);
+    return GetNodeProperty(node_schema()->GetFieldIndex(name));
   }
   std::vector<std::string> GetNodePropertyNames() const {
     return node_properties()->ColumnNames();
@@ -332,7 +636,7 @@ public:
 
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(
       const std::string& name) const {
-    return rdg_.edge_properties()->GetColumnByName(name);
+    return GetEdgeProperty(edge_schema()->GetFieldIndex(name));
   }
   std::vector<std::string> GetEdgePropertyNames() const {
     return edge_properties()->ColumnNames();
@@ -382,6 +686,56 @@ public:
     return array;
   }
 
+  /// Read the named node properties from storage if their loads were deferred
+  /// by RDGLoadOptions::lazy_properties. Callers that access
+  /// node_properties() directly rather than through GetNodeProperty should
+  /// call this first.
+  Result<void> EnsureNodePropertiesLoaded(
+      const std::vector<std::string>& names) const;
+  Result<void> EnsureEdgePropertiesLoaded(
+      const std::vector<std::string>& names) const;
+
+  /// Load the named node properties and store each one that is split into
+  /// several arrow::Arrays as a single array, copying the chunks in
+  /// parallel. Afterwards the properties can be addressed as plain
+  /// contiguous buffers, e.g., by typed property views.
+  Result<void> CoalesceNodeProperties(const std::vector<std::string>& names);
+  Result<void> CoalesceEdgeProperties(const std::vector<std::string>& names);
+
+  /// Load the named node properties and copy those whose buffers are
+  /// read-only, e.g., because they are shared with a copy of this graph, so
+  /// that they can be written to in place. The copied properties keep their
+  /// storage locations.
+  Result<void> EnsureNodePropertiesMutable(
+      const std::vector<std::string>& names);
+  Result<void> EnsureEdgePropertiesMutable(
+      const std::vector<std::string>& names);
+
+  /// Start reading the named, deferred node properties in the background so
+  /// that a later first access does not wait on storage. Unknown or already
+  /// loaded properties are ignored.
+  void PrefetchNodeProperties(const std::vector<std::string>& names) const;
+  void PrefetchEdgeProperties(const std::vector<std::string>& names) const;
+
+  /// \returns the statistics of the named node property, including min/max
+  /// zone maps of its blocks (see tsuba::PropertyStats). Statistics recorded
+  /// when the property was written are returned without loading it;
+  /// otherwise they are computed from the loaded column. Use them to skip
+  /// the blocks of rows that cannot match a filter.
+  Result<tsuba::PropertyStats> GetNodePropertyStats(
+      const std::string& name) const;
+  Result<tsuba::PropertyStats> GetEdgePropertyStats(
+      const std::string& name) const;
+
+  /// \returns the statistics recorded when the named node property was
+  /// written, or null if there are none or no such property. Unlike
+  /// GetNodePropertyStats this never scans the column, so it suits callers
+  /// that use the zone maps only to save work.
+  const tsuba::PropertyStats* GetRecordedNodePropertyStats(
+      const std::string& name) const;
+  const tsuba::PropertyStats* GetRecordedEdgePropertyStats(
+      const std::string& name) const;
+
   void MarkAllPropertiesPersistent() {
     return rdg_.MarkAllPropertiesPersistent();
   }
@@ -401,6 +755,15 @@ public:
     return rdg_.MarkEdgePropertiesPersistent(persist_edge_props);
   }
 
+  /// Store the named node property in \param format when this graph is
+  /// written; see tsuba::PropertyFileFormat. Arrow IPC files are larger than
+  /// parquet files but load without decoding or copying, so they suit
+  /// frequently loaded graphs on local storage.
+  Result<void> SetNodePropertyFileFormat(
+      const std::string& name, tsuba::PropertyFileFormat format);
+  Result<void> SetEdgePropertyFileFormat(
+      const std::string& name, tsuba::PropertyFileFormat format);
+
   const GraphTopology& topology() const { return topology_; }
 
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& props);
@@ -412,6 +775,24 @@ public:
   Result<void> RemoveEdgeProperty(int i);
   Result<void> RemoveEdgeProperty(const std::string& prop_name);
 
+  /// Apply the changes staged in batch to the node properties with one
+  /// rebuild of the property table. Either every change is applied or, on
+  /// error, none is.
+  Result<void> UpdateNodeProperties(const PropertyBatch& batch);
+  Result<void> UpdateEdgeProperties(const PropertyBatch& batch);
+
+  /// Prepare the node property name to be overwritten in place with values
+  /// of type, e.g., by an analytics routine that is run again with the same
+  /// output property, so that it need not be allocated again. If the
+  /// property has type and is a single chunk that can be written in place,
+  /// it is kept, to be written to storage again the next time this graph is
+  /// stored, and true is returned. Otherwise the property is removed if it
+  /// exists and false is returned, and the caller should add it anew.
+  Result<bool> PrepareNodePropertyOverwrite(
+      const std::string& name, const std::shared_ptr<arrow::DataType>& type);
+  Result<bool> PrepareEdgePropertyOverwrite(
+      const std::string& name, const std::shared_ptr<arrow::DataType>& type);
+
   PropertyView node_property_view() {
     return PropertyView{
         .g = this,
@@ -438,7 +819,88 @@ public:
 
   Result<void> SetTopology(const GraphTopology& topology);
 
+  /// Store topology, which must be derived from the topology of this graph
+  /// (e.g., by CreateTransposeGraph or SortAllEdgesByDest), as the auxiliary
+  /// topology name the next time this graph is written, so that later jobs
+  /// can load it with LoadAuxTopology instead of recomputing it. Only the
+  /// topology is stored, not properties or permutations. Auxiliary
+  /// topologies are tied to the topology of the graph and are dropped when
+  /// it changes.
+  Result<void> AddAuxTopology(
+      const std::string& name, const GraphTopology& topology);
+
+  /// Like AddAuxTopology, but also store edge_data, edge_data_size bytes for
+  /// each edge of topology, e.g., the weights of derived edges that are not
+  /// edges of this graph. The topology is stored uncompressed. Read the edge
+  /// data back with LoadAuxTopologyEdgeData.
+  Result<void> AddAuxTopology(
+      const std::string& name, const GraphTopology& topology,
+      const std::shared_ptr<arrow::Buffer>& edge_data,
+      uint64_t edge_data_size);
+
+  /// Whether auxiliary topology name of the current topology is in storage
+  bool HasAuxTopology(const std::string& name) const {
+    return rdg_.HasAuxTopology(name);
+  }
+
+  /// Load auxiliary topology name stored by AddAuxTopology. It is read from
+  /// storage on first use; the returned topology refers to memory owned by
+  /// this graph and is valid until the topology of this graph changes.
+  Result<GraphTopology> LoadAuxTopology(const std::string& name) const;
+
+  /// Load the edge data stored with auxiliary topology name, which must have
+  /// edge_data_size bytes per edge. Its lifetime is that of LoadAuxTopology.
+  Result<std::shared_ptr<arrow::Buffer>> LoadAuxTopologyEdgeData(
+      const std::string& name, uint64_t edge_data_size) const;
+
+  /// Index the edges of each node by the integer edge property type_property
+  /// so that GraphTopology::edges(node, type) returns the edges of one type
+  /// without scanning the others. The edges of each node must already be
+  /// sorted by type, e.g., by SortAllEdgesByType when the graph was
+  /// converted, so building the index is a linear scan that can be done
+  /// whenever the graph is loaded. The index is dropped when the topology
+  /// changes.
+  Result<void> IndexEdgesByType(const std::string& type_property);
+
+  /// Index the edges of each node by the integer or timestamp edge property
+  /// time_property so that GraphTopology::edges(node, begin_time, end_time)
+  /// returns the edges of a time window without scanning the others or
+  /// extracting a subgraph. Times are compared in the units of the
+  /// property. The edges of each node must already be sorted by time, e.g.,
+  /// by SortAllEdgesByTime when the graph was converted, so building the
+  /// index is a linear scan that can be done whenever the graph is loaded.
+  /// The index is dropped when the topology changes.
+  Result<void> IndexEdgesByTime(const std::string& time_property);
+
+  /// Return the orientation of the topology by degree, which must be
+  /// symmetric, building it in parallel on first use. The orientation is
+  /// kept with the topology, so analytics that run one after another, e.g.,
+  /// TriangleCount and LocalClusteringCoefficient, build it once between
+  /// them. It is dropped when the topology changes.
+  Result<std::shared_ptr<const DegreeOrderedDag>> OrientByDegree();
+
+  /// Return the view of the topology with the nodes whose out or in degree
+  /// is above max_degree split into virtual nodes, building it in parallel
+  /// unless the view kept with the topology has the same max_degree. It is
+  /// dropped when the topology changes.
+  Result<std::shared_ptr<const HubSplitView>> SplitHubs(uint64_t max_degree);
+
+  /// The default block_bits of OrderEdgesAlongHilbertCurve: the data of 2^16
+  /// sources and 2^16 destinations of a few bytes each fits in the L2 cache
+  static constexpr uint32_t kDefaultHilbertBlockBits = 16;
+
+  /// Return the edges of the topology in coordinate form ordered along a
+  /// Hilbert curve over blocks of 2^block_bits by 2^block_bits nodes,
+  /// building it in parallel unless the edge list kept with the topology
+  /// has the same block_bits. The list takes 16 bytes per edge and is
+  /// dropped when the topology changes.
+  Result<std::shared_ptr<const HilbertEdgeList>> OrderEdgesAlongHilbertCurve(
+      uint32_t block_bits = kDefaultHilbertBlockBits);
+
   /// Return the node property table for local nodes
+  ///
+  /// Properties whose loads were deferred appear as placeholder columns of
+  /// type null; see EnsureNodePropertiesLoaded.
   const std::shared_ptr<arrow::Table>& node_properties() const {
     return rdg_.node_properties();
   }
@@ -492,13 +954,35 @@ public:
 };
 
 /// SortAllEdgesByDest sorts edges for each node by destination
-/// IDs (ascending order).
+/// IDs (ascending order). Edges with the same destination keep their
+/// relative order.
 ///
-/// Returns the permutation vector (mapping from old
-/// indices to the new indices) which results due to the sorting.
+/// Returns the permutation vector which results due to the sorting. Entry i
+/// is the original id of the edge now at index i, so edge properties can be
+/// permuted with arrow::compute::Take.
 KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> SortAllEdgesByDest(
     PropertyGraph* pg);
 
+/// SortAllEdgesByType sorts the edges of each node by the integer edge
+/// property type_property and then by destination, and indexes them with
+/// PropertyGraph::IndexEdgesByType. Edges with the same type and
+/// destination keep their relative order.
+///
+/// All edge properties are permuted along with the edges. Returns the
+/// permutation, as SortAllEdgesByDest does.
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> SortAllEdgesByType(
+    PropertyGraph* pg, const std::string& type_property);
+
+/// SortAllEdgesByTime sorts the edges of each node by the integer or
+/// timestamp edge property time_property and then by destination, and
+/// indexes them with PropertyGraph::IndexEdgesByTime. Edges with the same
+/// time and destination keep their relative order.
+///
+/// All edge properties are permuted along with the edges. Returns the
+/// permutation, as SortAllEdgesByDest does.
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> SortAllEdgesByTime(
+    PropertyGraph* pg, const std::string& time_property);
+
 /// FindEdgeSortedByDest finds the "node_to_find" id in the
 /// sorted edgelist of the "node" using binary search.
 ///
@@ -534,7 +1018,8 @@ CreateSymmetricGraph(PropertyGraph* pg);
 ///
 /// For each edge (a, b) in the graph, this function will
 /// add edge (b, a) without retaining the original edge (a, b) unlike
-/// CreateSymmetricGraph.
+/// CreateSymmetricGraph. The edges of each node of the transpose are sorted
+/// by destination.
 /// \param pg The original property graph
 /// \return The new transposed property graph by reversing the edges
 // TODO(gill): Add tranposed edge properties as well.
@@ -0,0 +1,114 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PROPERTYPREDICATE_H_
+#define KATANA_LIBGALOIS_KATANA_PROPERTYPREDICATE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A predicate over the properties of the nodes or of the edges of a graph,
+/// e.g., `age > 30 AND country == "US"`:
+///
+///     using P = PropertyPredicate;
+///     auto p = P::Compare("age", P::kGreater, int64_t{30}) &&
+///              P::Compare("country", P::kEqual, std::string("US"));
+///
+/// String values must be passed as std::string; a string literal would
+/// convert to bool.
+///
+/// Comparisons are false for null values, and Not negates its operand, so
+/// !(age > 30) holds for the rows where age is null. Integer and floating
+/// point properties may be compared with integer or floating point values,
+/// boolean properties with booleans and string properties with strings.
+/// Timestamps, dates and times are compared by their integer
+/// representation. Dictionary encoded properties compare each distinct
+/// value once and then only look up the codes of rows.
+///
+/// Predicates are cheap to copy; operands are shared.
+class KATANA_EXPORT PropertyPredicate {
+public:
+  using Value = std::variant<bool, int64_t, double, std::string>;
+
+  enum Comparison {
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+  };
+
+  enum Kind {
+    kCompare,
+    kIsNull,
+    kAnd,
+    kOr,
+    kNot,
+  };
+
+  /// Whether the value of property compares to value as comparison says
+  static PropertyPredicate Compare(
+      std::string property, Comparison comparison, Value value);
+  /// Whether the value of property is null
+  static PropertyPredicate IsNull(std::string property);
+
+  friend KATANA_EXPORT PropertyPredicate
+  operator&&(PropertyPredicate a, PropertyPredicate b);
+  friend KATANA_EXPORT PropertyPredicate
+  operator||(PropertyPredicate a, PropertyPredicate b);
+  friend KATANA_EXPORT PropertyPredicate operator!(PropertyPredicate a);
+
+  Kind kind() const;
+  /// The property of a kCompare or kIsNull predicate
+  const std::string& property() const;
+  /// The comparison of a kCompare predicate
+  Comparison comparison() const;
+  /// The value of a kCompare predicate
+  const Value& value() const;
+  /// The operands of a kAnd, kOr or kNot predicate
+  const std::vector<PropertyPredicate>& operands() const;
+
+  std::string ToString() const;
+
+private:
+  struct Node;
+
+  explicit PropertyPredicate(std::shared_ptr<const Node> node)
+      : node_(std::move(node)) {}
+
+  std::shared_ptr<const Node> node_;
+};
+
+/// Set the bits of mask, which is resized to the number of nodes of pg, of
+/// the nodes whose properties satisfy predicate, e.g., to pass to
+/// ExtractSubgraph.
+///
+/// Rows are evaluated in blocks of whole words of mask in parallel, and
+/// comparisons are evaluated a word of rows at a time. The right operand of
+/// an And or an Or is only evaluated for the blocks its left operand does not
+/// decide. Properties whose statistics were recorded when the graph was
+/// written (see PropertyGraph::GetRecordedNodePropertyStats) skip the blocks
+/// whose zone maps rule out a comparison, and are not even loaded if no
+/// block of a lazily loaded property can match.
+KATANA_EXPORT Result<void> EvaluateNodePredicate(
+    const PropertyGraph& pg, const PropertyPredicate& predicate,
+    DynamicBitset* mask);
+
+/// Set the bits of mask, which is resized to the number of edges of pg, of
+/// the edges whose properties satisfy predicate, as EvaluateNodePredicate
+/// does for nodes
+KATANA_EXPORT Result<void> EvaluateEdgePredicate(
+    const PropertyGraph& pg, const PropertyPredicate& predicate,
+    DynamicBitset* mask);
+
+}  // namespace katana
+
+#endif
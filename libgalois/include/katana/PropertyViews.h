@@ -1,13 +1,34 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYVIEWS_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYVIEWS_H_
 
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 
+namespace katana {
+
+/// CoalesceChunks returns the values of chunked_array as one arrow::Array.
+/// Arrays of fixed width values, and fixed size lists of them, are copied in
+/// parallel; other types are concatenated by arrow. An array with a single
+/// chunk is returned without copying.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> CoalesceChunks(
+    const arrow::ChunkedArray& chunked_array);
+
+/// CopyChunks is CoalesceChunks but always copies, e.g., to get values that
+/// can be written to in place from buffers shared by PropertyGraph::Copy
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> CopyChunks(
+    const arrow::ChunkedArray& chunked_array);
+
+}  // namespace katana
+
 namespace katana::internal {
 
 /// ExtractArrays returns the array for each column of a table. It returns an
-/// error if there is more than one array for any column.
+/// error if there is more than one array for any column; see CoalesceChunks.
 KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties);
 
@@ -33,6 +54,32 @@ MakePropertyViews(
   return views_result.value();
 }
 
+template <typename PropTuple, size_t... Is>
+std::vector<std::string>
+WritableProperties(
+    const std::vector<std::string>& properties, std::index_sequence<Is...>) {
+  std::vector<std::string> writable;
+  (
+      [&] {
+        if (PropertyIsWritable<std::tuple_element_t<Is, PropTuple>>::value &&
+            Is < properties.size()) {
+          writable.emplace_back(properties[Is]);
+        }
+      }(),
+      ...);
+  return writable;
+}
+
+/// WritableProperties returns the properties that the views of PropTuple
+/// can modify in place, i.e., properties[i] for each writable element i of
+/// PropTuple
+template <typename PropTuple>
+std::vector<std::string>
+WritableProperties(const std::vector<std::string>& properties) {
+  return WritableProperties<PropTuple>(
+      properties, std::make_index_sequence<std::tuple_size_v<PropTuple>>());
+}
+
 /// MakeNodePropertyViews asserts a typed view on top of runtime properties.
 /// This version selects a specific set of properties to include in the typed
 /// view.
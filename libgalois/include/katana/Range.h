@@ -20,12 +20,15 @@
 #ifndef KATANA_LIBGALOIS_KATANA_RANGE_H_
 #define KATANA_LIBGALOIS_KATANA_RANGE_H_
 
+#include <algorithm>
 #include <iterator>
 #include <type_traits>
+#include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/TwoLevelIterator.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
@@ -139,7 +142,7 @@ public:
 private:
   std::pair<local_iterator, local_iterator> local_pair() const {
     return katana::block_range(
-        begin_, end_, ThreadPool::getTID(), katana::activeThreads);
+        begin_, end_, ThreadPool::getTID(), katana::getActiveThreads());
   }
 
   IterTy begin_;
@@ -177,7 +180,7 @@ private:
    */
   std::pair<local_iterator, local_iterator> local_pair() const {
     uint32_t my_thread_id = ThreadPool::getTID();
-    uint32_t total_threads = activeThreads;
+    uint32_t total_threads = getActiveThreads();
 
     iterator local_begin = thread_beginnings_[my_thread_id];
     iterator local_end = thread_beginnings_[my_thread_id + 1];
@@ -261,6 +264,86 @@ MakeSpecificRange(
   return SpecificRange<IterTy>(begin, end, thread_ranges);
 }
 
+/**
+ * Divides the numeric range [begin, end) into num_blocks blocks of about the
+ * same weight, where the weight of a block is the number of its items times
+ * item_weight plus the number of edges of its items. The item weight keeps
+ * items without edges from piling up in one block.
+ *
+ * The blocks are found by binary search, so this takes O(num_blocks log n)
+ * time. An item with more edges than a block should hold is not split; it
+ * ends up in a block of its own.
+ *
+ * @param edges_before function <code>uint64_t (T)</code> that returns the
+ * number of edges of the items before an item, e.g., from the out indices of
+ * a CSR graph
+ * @returns the first item of each block followed by end
+ */
+template <typename T, typename EdgesBefore>
+std::vector<T>
+EdgeBalancedBlocks(
+    T begin, T end, size_t num_blocks, const EdgesBefore& edges_before,
+    uint64_t item_weight = 1) {
+  uint64_t first_edge = edges_before(begin);
+  auto weight = [&](T item) {
+    return edges_before(item) - first_edge + (item - begin) * item_weight;
+  };
+  uint64_t total = weight(end);
+
+  std::vector<T> block_begins(num_blocks + 1, end);
+  block_begins[0] = begin;
+  for (size_t i = 1; i < num_blocks; ++i) {
+    uint64_t target =
+        total / num_blocks * i + total % num_blocks * i / num_blocks;
+    block_begins[i] = *std::partition_point(
+        boost::counting_iterator<T>(block_begins[i - 1]),
+        boost::counting_iterator<T>(end),
+        [&](T item) { return weight(item) < target; });
+  }
+  return block_begins;
+}
+
+/**
+ * EdgeBalancedRange is a numeric range of the nodes of a graph whose local
+ * ranges hold about the same number of edges rather than the same number of
+ * nodes (see \ref EdgeBalancedBlocks). Use it through the
+ * \ref edge_balanced_by option of \ref katana::do_all.
+ */
+template <typename IterTy>
+class EdgeBalancedRange {
+public:
+  typedef IterTy iterator;
+  typedef iterator local_iterator;
+  typedef typename std::iterator_traits<iterator>::value_type value_type;
+
+  template <typename EdgesBefore>
+  EdgeBalancedRange(IterTy begin, IterTy end, const EdgesBefore& edges_before)
+      : begin_(begin),
+        end_(end),
+        block_begins_(EdgeBalancedBlocks(
+            *begin, *end, katana::getActiveThreads(), edges_before)) {}
+
+  iterator begin() const { return begin_; }
+  iterator end() const { return end_; }
+
+  local_iterator local_begin() const { return local_pair().first; }
+  local_iterator local_end() const { return local_pair().second; }
+
+private:
+  std::pair<local_iterator, local_iterator> local_pair() const {
+    size_t tid = ThreadPool::getTID();
+    if (tid + 1 >= block_begins_.size()) {
+      return std::make_pair(end_, end_);
+    }
+    return std::make_pair(
+        iterator(block_begins_[tid]), iterator(block_begins_[tid + 1]));
+  }
+
+  IterTy begin_;
+  IterTy end_;
+  std::vector<value_type> block_begins_;
+};
+
 template <typename T>
 struct has_local_iterator {
   template <typename U>
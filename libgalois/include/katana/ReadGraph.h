@@ -20,9 +20,14 @@
 #ifndef KATANA_LIBGALOIS_KATANA_READGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_READGRAPH_H_
 
+#include <string>
+#include <type_traits>
+
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 
@@ -129,6 +134,40 @@ readGraphDispatch(GraphTy& graph, read_with_aux_graph_tag, FileGraph& f) {
   katana::on_each(edgeReader);
 }
 
+/**
+ * Constructs a graph from the topology of a PropertyGraph with the edge
+ * values values, which may be null; see readPropertyGraph.
+ */
+template <typename GraphTy>
+void
+readGraphDispatch(
+    GraphTy& graph, read_default_graph_tag, const GraphTopology& topology,
+    const typename GraphTy::file_edge_value_type* values) {
+  graph.allocateFrom(topology);
+
+  katana::on_each([&](unsigned tid, unsigned total) {
+    graph.constructFrom(topology, values, tid, total);
+  });
+}
+
+template <typename GraphTy>
+void
+readGraphDispatch(
+    GraphTy& graph, read_with_aux_graph_tag, const GraphTopology& topology,
+    const typename GraphTy::file_edge_value_type* values) {
+  typedef typename GraphTy::ReadGraphAuxData Aux;
+
+  Aux aux;
+  graph.allocateFrom(topology, aux);
+
+  katana::on_each([&](unsigned tid, unsigned total) {
+    graph.constructNodesFrom(topology, tid, total, aux);
+  });
+  katana::on_each([&](unsigned tid, unsigned total) {
+    graph.constructEdgesFrom(topology, values, tid, total, aux);
+  });
+}
+
 template <typename GraphTy, typename Aux>
 struct ReadGraphConstructOutEdgesFrom {
   GraphTy& graph;
@@ -241,6 +280,62 @@ readGraphDispatch(
   readGraphDispatch(graph, tag1, f1);
 }
 
+/**
+ * Constructs graph from the topology of pg with the values of the edge
+ * property edge_property stored with the edges, in parallel. This lets
+ * graphs that keep edge data next to the adjacency information, such as
+ * LC_InlineEdge_Graph and LC_Linear_Graph, be used with graphs loaded as
+ * PropertyGraphs.
+ *
+ * The property must hold values of type GraphTy::file_edge_data_type in a
+ * single chunk. If edge_property is empty, edge values are default
+ * constructed.
+ */
+template <typename GraphTy>
+Result<void>
+readPropertyGraph(
+    GraphTy& graph, const PropertyGraph& pg,
+    const std::string& edge_property = "") {
+  using FileEdgeTy = typename GraphTy::file_edge_data_type;
+
+  const typename GraphTy::file_edge_value_type* values = nullptr;
+  if constexpr (std::is_void_v<FileEdgeTy>) {
+    if (!edge_property.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "graph without edge data cannot store edge property {}",
+          edge_property);
+    }
+  } else {
+    if (!edge_property.empty()) {
+      auto property = pg.GetEdgeProperty(edge_property);
+      if (!property) {
+        return KATANA_ERROR(
+            ErrorCode::PropertyNotFound, "edge property {} not found",
+            edge_property);
+      }
+      if (property->num_chunks() != 1) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "edge property {} has {} chunks, not 1", edge_property,
+            property->num_chunks());
+      }
+      auto array = std::dynamic_pointer_cast<
+          typename arrow::CTypeTraits<FileEdgeTy>::ArrayType>(
+          property->chunk(0));
+      if (!array) {
+        return KATANA_ERROR(
+            ErrorCode::TypeError, "edge property {} has type {}",
+            edge_property, property->type()->ToString());
+      }
+      values = array->raw_values();
+    }
+  }
+
+  readGraph(graph, pg.topology(), values);
+  return ResultSuccess();
+}
+
 }  // namespace katana
 
 #endif
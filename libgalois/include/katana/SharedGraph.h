@@ -0,0 +1,40 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SHAREDGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_SHAREDGRAPH_H_
+
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Publish the topology and loaded properties of \param graph in shared
+/// memory as \param name, e.g., "/katana-friendster", so that other
+/// processes on this machine can use the graph with AttachSharedGraph
+/// instead of each loading a private copy. The graph is copied into shared
+/// memory once; later changes to graph are not published.
+///
+/// \returns AlreadyExists if a graph is already published as name
+KATANA_EXPORT Result<void> PublishSharedGraph(
+    const PropertyGraph& graph, const std::string& name);
+
+/// Make a graph whose topology and properties are the ones published as
+/// \param name, without copying them. They are read-only: modifying the
+/// graph in place, e.g., with SortAllEdgesByDest, copies what it modifies
+/// first, as for a PropertyGraph::Copy. The shared memory stays mapped as
+/// long as the graph or any of its arrays is alive.
+///
+/// \returns NotFound if no graph is published as name
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> AttachSharedGraph(
+    const std::string& name);
+
+/// Remove the graph published as \param name so that it can no longer be
+/// attached. Graphs that were attached already keep working; the memory is
+/// freed once the last of them is destroyed.
+KATANA_EXPORT Result<void> UnpublishSharedGraph(const std::string& name);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SIZEDGRAPHTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_SIZEDGRAPHTOPOLOGY_H_
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <arrow/buffer.h>
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "tsuba/CSRTopology.h"
+
+namespace katana {
+
+/// A read-only CSR topology whose out indices are Index and whose edge
+/// destinations are NodeType. It views a CSR topology file (see
+/// tsuba/CSRTopology.h) of the matching version without copying it.
+///
+/// GraphTopology always has 64 bit out indices and 32 bit destinations.
+/// CompactGraphTopology takes a third less memory for graphs with fewer than
+/// 2^32 edges, and WideGraphTopology holds graphs with more than 2^32 nodes.
+/// Code written against the interface they share (edges, edge_dest,
+/// OutNeighbors, degree) is compiled for each width; use
+/// VisitSizedGraphTopology to pick the one that matches a topology file.
+template <typename Index, typename NodeType>
+class SizedGraphTopology {
+  static_assert(
+      std::is_unsigned_v<Index> && std::is_unsigned_v<NodeType> &&
+          sizeof(Index) >= sizeof(uint32_t) &&
+          sizeof(NodeType) >= sizeof(uint32_t),
+      "indices and destinations must be 32 or 64 bit unsigned integers");
+
+public:
+  using Node = NodeType;
+  using Edge = Index;
+  using node_iterator = boost::counting_iterator<Node>;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = StandardRange<node_iterator>;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+
+  /// The version of CSR topology files with this layout
+  constexpr static uint64_t kVersion =
+      sizeof(Index) == sizeof(uint32_t) ? tsuba::kCompactCSRTopologyVersion
+      : sizeof(Node) == sizeof(uint32_t) ? tsuba::kCSRTopologyVersion
+                                         : tsuba::kWideCSRTopologyVersion;
+  static_assert(
+      tsuba::CSRTopologyIndexSize(kVersion) == sizeof(Index) &&
+          tsuba::CSRTopologyDestSize(kVersion) == sizeof(Node),
+      "no CSR topology file version has this layout");
+
+  SizedGraphTopology() = default;
+
+  /// View the CSR topology file in \param buffer, which must have version
+  /// kVersion. The buffer is kept alive by the topology.
+  static Result<SizedGraphTopology> Make(std::shared_ptr<arrow::Buffer> buffer);
+
+  /// Copy \param topology into this layout. Fails if its edges do not fit
+  /// in Index.
+  static Result<SizedGraphTopology> Make(const GraphTopology& topology);
+
+  /// Copy the topology into a GraphTopology, sharing the arrays whose widths
+  /// match. Fails if it has more nodes than GraphTopology can hold.
+  Result<GraphTopology> ToGraphTopology() const;
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+
+  /// Return the topology in the CSR file format
+  const std::shared_ptr<arrow::Buffer>& buffer() const { return buffer_; }
+
+  /// Return the number of bytes of the topology, including its header
+  uint64_t size_bytes() const { return buffer_ ? buffer_->size() : 0; }
+
+  edges_range edges(Node node) const {
+    return MakeStandardRange<edge_iterator>(
+        node > 0 ? out_indices_[node - 1] : 0, out_indices_[node]);
+  }
+
+  Node edge_dest(Edge edge) const {
+    KATANA_LOG_DEBUG_ASSERT(edge < num_edges_);
+    return out_dests_[edge];
+  }
+
+  /// The destinations [begin, end) of the out-edges of node
+  std::pair<const Node*, const Node*> OutNeighbors(Node node) const {
+    return std::make_pair(
+        out_dests_ + (node > 0 ? out_indices_[node - 1] : 0),
+        out_dests_ + out_indices_[node]);
+  }
+
+  uint64_t degree(Node node) const {
+    return out_indices_[node] - (node > 0 ? out_indices_[node - 1] : 0);
+  }
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(num_nodes_); }
+
+  size_t size() const { return num_nodes_; }
+
+  bool empty() const { return num_nodes_ == 0; }
+
+private:
+  SizedGraphTopology(
+      std::shared_ptr<arrow::Buffer> buffer,
+      const tsuba::CSRTopologyHeader& header)
+      : buffer_(std::move(buffer)),
+        out_indices_(reinterpret_cast<const Index*>(
+            buffer_->data() + sizeof(tsuba::CSRTopologyHeader))),
+        out_dests_(reinterpret_cast<const Node*>(
+            buffer_->data() + tsuba::CSRTopologyDestsOffset(header))),
+        num_nodes_(header.num_nodes),
+        num_edges_(header.num_edges) {}
+
+  /// Return the n values at \param values, which point into buffer_, as a
+  /// buffer of To that shares buffer_ if From is To and is a converted copy
+  /// otherwise
+  template <typename To, typename From>
+  Result<std::shared_ptr<arrow::Buffer>> ConvertArray(
+      const From* values, uint64_t n) const;
+
+  std::shared_ptr<arrow::Buffer> buffer_;
+  const Index* out_indices_{nullptr};
+  const Node* out_dests_{nullptr};
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+};
+
+/// 32 bit out indices and destinations
+using CompactGraphTopology = SizedGraphTopology<uint32_t, uint32_t>;
+/// 64 bit out indices and destinations
+using WideGraphTopology = SizedGraphTopology<uint64_t, uint64_t>;
+
+template <typename Index, typename NodeType>
+Result<SizedGraphTopology<Index, NodeType>>
+SizedGraphTopology<Index, NodeType>::Make(
+    std::shared_ptr<arrow::Buffer> buffer) {
+  if (static_cast<uint64_t>(buffer->size()) <
+      sizeof(tsuba::CSRTopologyHeader)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology of {} bytes has no header",
+        buffer->size());
+  }
+  tsuba::CSRTopologyHeader header;
+  std::memcpy(&header, buffer->data(), sizeof(header));
+  if (header.version != kVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology version is {}, expected {}",
+        header.version, kVersion);
+  }
+  uint64_t expected_size = tsuba::CSRTopologyDestsOffset(header) +
+                           header.num_edges * sizeof(Node);
+  if (static_cast<uint64_t>(buffer->size()) < expected_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology size: {} expected {}",
+        buffer->size(), expected_size);
+  }
+  return SizedGraphTopology(std::move(buffer), header);
+}
+
+template <typename Index, typename NodeType>
+Result<SizedGraphTopology<Index, NodeType>>
+SizedGraphTopology<Index, NodeType>::Make(const GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  if (num_edges > std::numeric_limits<Index>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} edges do not fit in {} bit indices",
+        num_edges, sizeof(Index) * 8);
+  }
+
+  tsuba::CSRTopologyHeader header{
+      .version = kVersion,
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = num_edges,
+  };
+  uint64_t dests_offset = tsuba::CSRTopologyDestsOffset(header);
+  auto buffer_res =
+      arrow::AllocateBuffer(dests_offset + num_edges * sizeof(Node));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating topology: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  uint8_t* data = buffer->mutable_data();
+
+  std::memcpy(data, &header, sizeof(header));
+  // Zero the padding after the out indices
+  uint64_t indices_end = sizeof(header) + num_nodes * sizeof(Index);
+  std::memset(data + indices_end, 0, dests_offset - indices_end);
+
+  auto* out_indices = reinterpret_cast<Index*>(data + sizeof(header));
+  auto* out_dests = reinterpret_cast<Node*>(data + dests_offset);
+  const uint64_t* in_indices =
+      num_nodes ? topology.out_indices->raw_values() : nullptr;
+  const uint32_t* in_dests =
+      num_edges ? topology.out_dests->raw_values() : nullptr;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { out_indices[n] = in_indices[n]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { out_dests[e] = in_dests[e]; }, katana::no_stats());
+
+  return Make(std::move(buffer));
+}
+
+template <typename Index, typename NodeType>
+template <typename To, typename From>
+Result<std::shared_ptr<arrow::Buffer>>
+SizedGraphTopology<Index, NodeType>::ConvertArray(
+    const From* values, uint64_t n) const {
+  if constexpr (std::is_same_v<To, From>) {
+    return arrow::SliceBuffer(
+        buffer_, reinterpret_cast<const uint8_t*>(values) - buffer_->data(),
+        n * sizeof(To));
+  } else {
+    auto buffer_res = arrow::AllocateBuffer(n * sizeof(To));
+    if (!buffer_res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "allocating {} values: {}", n,
+          buffer_res.status());
+    }
+    std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+    auto* converted = reinterpret_cast<To*>(buffer->mutable_data());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, n),
+        [&](uint64_t i) { converted[i] = static_cast<To>(values[i]); },
+        katana::no_stats());
+    return buffer;
+  }
+}
+
+template <typename Index, typename NodeType>
+Result<GraphTopology>
+SizedGraphTopology<Index, NodeType>::ToGraphTopology() const {
+  if (!buffer_) {
+    return GraphTopology{};
+  }
+  if (num_nodes_ > (uint64_t{1} << 32)) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "GraphTopology holds at most 2^32 nodes, not {}", num_nodes_);
+  }
+
+  auto indices_res = ConvertArray<uint64_t>(out_indices_, num_nodes_);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = ConvertArray<uint32_t>(out_dests_, num_edges_);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+
+  return GraphTopology{
+      .out_indices = std::make_shared<arrow::UInt64Array>(
+          num_nodes_, std::move(indices_res.value())),
+      .out_dests = std::make_shared<arrow::UInt32Array>(
+          num_edges_, std::move(dests_res.value())),
+  };
+}
+
+/// Call \param fn with the SizedGraphTopology that views the CSR topology
+/// file in \param buffer, whichever its version, so that fn is compiled for
+/// each index width and the right one is picked at load time
+template <typename Fn>
+Result<void>
+VisitSizedGraphTopology(std::shared_ptr<arrow::Buffer> buffer, Fn fn) {
+  auto visit = [&fn](auto make_res) -> Result<void> {
+    if (!make_res) {
+      return make_res.error();
+    }
+    fn(make_res.value());
+    return ResultSuccess();
+  };
+
+  tsuba::CSRTopologyHeader header;
+  if (static_cast<uint64_t>(buffer->size()) < sizeof(header)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology of {} bytes has no header",
+        buffer->size());
+  }
+  std::memcpy(&header, buffer->data(), sizeof(header));
+
+  switch (header.version) {
+  case tsuba::kCSRTopologyVersion:
+    return visit(
+        SizedGraphTopology<uint64_t, uint32_t>::Make(std::move(buffer)));
+  case tsuba::kWideCSRTopologyVersion:
+    return visit(WideGraphTopology::Make(std::move(buffer)));
+  case tsuba::kCompactCSRTopologyVersion:
+    return visit(CompactGraphTopology::Make(std::move(buffer)));
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown topology version {}",
+        header.version);
+  }
+}
+
+}  // namespace katana
+
+#endif
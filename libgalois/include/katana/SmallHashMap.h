@@ -0,0 +1,511 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SMALLHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_SMALLHASHMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#define KATANA_SMALLHASHMAP_SSE2 1
+#include <emmintrin.h>
+#else
+#define KATANA_SMALLHASHMAP_SSE2 0
+#endif
+
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Control bytes of SmallHashMap slots. A full slot holds the 7 low bits of
+/// the hash of its key, so its control byte is never negative.
+constexpr int8_t kCtrlEmpty = -128;
+constexpr int8_t kCtrlDeleted = -2;
+/// Slots are probed in aligned groups of this many control bytes
+constexpr size_t kCtrlGroupWidth = 16;
+
+/// A group of kCtrlGroupWidth control bytes. Each Match function returns a
+/// mask with bit i set if control byte i matches.
+class CtrlGroup {
+public:
+  explicit CtrlGroup(const int8_t* ctrl)
+#if KATANA_SMALLHASHMAP_SSE2
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {
+  }
+#else
+      : ctrl_(ctrl) {
+  }
+#endif
+
+  uint32_t Match(int8_t h2) const {
+#if KATANA_SMALLHASHMAP_SSE2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_));
+#else
+    return MatchIf([h2](int8_t c) { return c == h2; });
+#endif
+  }
+
+  uint32_t MatchEmpty() const {
+#if KATANA_SMALLHASHMAP_SSE2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(kCtrlEmpty), ctrl_));
+#else
+    return MatchIf([](int8_t c) { return c == kCtrlEmpty; });
+#endif
+  }
+
+  uint32_t MatchEmptyOrDeleted() const {
+#if KATANA_SMALLHASHMAP_SSE2
+    return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_));
+#else
+    return MatchIf([](int8_t c) { return c < -1; });
+#endif
+  }
+
+private:
+#if KATANA_SMALLHASHMAP_SSE2
+  __m128i ctrl_;
+#else
+  template <typename Pred>
+  uint32_t MatchIf(Pred pred) const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kCtrlGroupWidth; ++i) {
+      mask |= uint32_t{pred(ctrl_[i])} << i;
+    }
+    return mask;
+  }
+
+  const int8_t* ctrl_;
+#endif
+};
+
+}  // namespace internal
+
+/// An open addressing hash map for small maps of trivially copyable keys
+/// and values, e.g., the per-node maps of clustering algorithms.
+///
+/// Lookups compare the 7 bit hash fragments of a group of 16 slots at once
+/// (with SSE2 where available) before comparing any keys, as Swiss tables
+/// do. The first InlineSlots slots are stored in the map itself, so a map of
+/// up to 7/8 of InlineSlots elements never allocates; larger maps allocate
+/// from Allocator, e.g., a katana::ArenaAllocator.
+///
+/// Iteration order is unspecified. Inserting may invalidate iterators and
+/// references; erasing does not.
+template <
+    typename Key, typename T, size_t InlineSlots = internal::kCtrlGroupWidth,
+    typename Hash = std::hash<Key>,
+    typename Allocator = std::allocator<std::pair<Key, T>>>
+class SmallHashMap {
+  static_assert(
+      InlineSlots >= internal::kCtrlGroupWidth &&
+          (InlineSlots & (InlineSlots - 1)) == 0,
+      "inline slots must be a power of 2 of at least a group");
+  static_assert(
+      std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>,
+      "SmallHashMap moves slots as bytes");
+
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = size_t;
+  using hasher = Hash;
+  using allocator_type = Allocator;
+
+  template <bool Const>
+  class Iterator {
+    friend class SmallHashMap;
+    friend class Iterator<!Const>;
+
+    using Slot = std::conditional_t<
+        Const, const std::pair<Key, T>, std::pair<Key, T>>;
+
+    const int8_t* ctrl_{nullptr};
+    const int8_t* ctrl_end_{nullptr};
+    Slot* slot_{nullptr};
+
+    Iterator(const int8_t* ctrl, const int8_t* ctrl_end, Slot* slot)
+        : ctrl_(ctrl), ctrl_end_(ctrl_end), slot_(slot) {}
+
+    void SkipEmpty() {
+      while (ctrl_ != ctrl_end_ && *ctrl_ < 0) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<Key, T>;
+    using difference_type = ptrdiff_t;
+    using pointer = Slot*;
+    using reference = Slot&;
+
+    Iterator() = default;
+
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    Iterator(const Iterator<false>& other)
+        : ctrl_(other.ctrl_), ctrl_end_(other.ctrl_end_), slot_(other.slot_) {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    Iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipEmpty();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) {
+      return a.ctrl_ == b.ctrl_;
+    }
+    friend bool operator!=(const Iterator& a, const Iterator& b) {
+      return a.ctrl_ != b.ctrl_;
+    }
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  explicit SmallHashMap(
+      const Allocator& alloc = Allocator(), const Hash& hash = Hash())
+      : alloc_(alloc), hash_(hash) {
+    UseInline();
+  }
+
+  SmallHashMap(const SmallHashMap& other)
+      : alloc_(other.alloc_), hash_(other.hash_) {
+    UseInline();
+    CopyFrom(other);
+  }
+
+  SmallHashMap(SmallHashMap&& other) noexcept
+      : alloc_(other.alloc_), hash_(other.hash_) {
+    UseInline();
+    MoveFrom(&other);
+  }
+
+  SmallHashMap& operator=(const SmallHashMap& other) {
+    if (this != &other) {
+      clear();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  SmallHashMap& operator=(SmallHashMap&& other) noexcept {
+    if (this != &other) {
+      Free();
+      UseInline();
+      MoveFrom(&other);
+    }
+    return *this;
+  }
+
+  ~SmallHashMap() { Free(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  /// The number of slots, full or not
+  size_t capacity() const { return capacity_; }
+  allocator_type get_allocator() const { return alloc_; }
+
+  iterator begin() { return MakeIterator<false>(0, true); }
+  iterator end() { return MakeIterator<false>(capacity_, false); }
+  const_iterator begin() const { return MakeIterator<true>(0, true); }
+  const_iterator end() const { return MakeIterator<true>(capacity_, false); }
+
+  iterator find(const Key& key) {
+    size_t i = Find(key);
+    return i == kNotFound ? end() : MakeIterator<false>(i, false);
+  }
+
+  const_iterator find(const Key& key) const {
+    size_t i = Find(key);
+    return i == kNotFound ? end() : MakeIterator<true>(i, false);
+  }
+
+  size_t count(const Key& key) const { return Find(key) == kNotFound ? 0 : 1; }
+
+  bool contains(const Key& key) const { return Find(key) != kNotFound; }
+
+  /// Insert key with a value made from \param args unless key is present
+  ///
+  /// \returns an iterator to the element of key and whether it was inserted
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    auto [h1, h2] = Split(hash_(key));
+    if (size_t i = Find(key, h1, h2); i != kNotFound) {
+      return std::make_pair(MakeIterator<false>(i, false), false);
+    }
+    size_t i = Insert(h1, h2);
+    new (slots_ + i) value_type(
+        std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return std::make_pair(MakeIterator<false>(i, false), true);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  /// \returns the value of key, inserting a value initialized one if key is
+  /// not present
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+  size_t erase(const Key& key) {
+    size_t i = Find(key);
+    if (i == kNotFound) {
+      return 0;
+    }
+    // Probes stop at the first group with an empty slot, so a slot in such
+    // a group can become empty again; elsewhere it must stay a tombstone
+    // for the probes that pass it
+    internal::CtrlGroup group(
+        ctrl_ + i / internal::kCtrlGroupWidth * internal::kCtrlGroupWidth);
+    if (group.MatchEmpty() != 0) {
+      ctrl_[i] = internal::kCtrlEmpty;
+      ++growth_left_;
+    } else {
+      ctrl_[i] = internal::kCtrlDeleted;
+    }
+    --size_;
+    return 1;
+  }
+
+  /// Remove all elements, keeping the capacity
+  void clear() {
+    std::memset(ctrl_, internal::kCtrlEmpty, capacity_);
+    size_ = 0;
+    growth_left_ = MaxLoad(capacity_);
+  }
+
+  /// Make room for \param n elements without growing again
+  void reserve(size_t n) {
+    size_t capacity = capacity_;
+    while (MaxLoad(capacity) < n) {
+      capacity *= 2;
+    }
+    if (capacity != capacity_) {
+      Resize(capacity);
+    }
+  }
+
+private:
+  using CtrlAlloc =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<int8_t>;
+  using SlotAlloc = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<value_type>;
+
+  constexpr static size_t kNotFound = ~size_t{0};
+
+  /// Tables are at most 7/8 full, counting tombstones, so every probe
+  /// sequence reaches an empty slot
+  static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+  /// Split a hash into the group a probe starts at and the 7 bits kept in
+  /// the control byte. The hash is mixed first since std::hash of integers
+  /// is the identity.
+  static std::pair<size_t, int8_t> Split(size_t hash) {
+    uint64_t mixed = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+    mixed ^= mixed >> 32;
+    return std::make_pair(
+        static_cast<size_t>(mixed >> 7), static_cast<int8_t>(mixed & 0x7f));
+  }
+
+  size_t Find(const Key& key) const {
+    auto [h1, h2] = Split(hash_(key));
+    return Find(key, h1, h2);
+  }
+
+  size_t Find(const Key& key, size_t h1, int8_t h2) const {
+    constexpr size_t kWidth = internal::kCtrlGroupWidth;
+    size_t mask = capacity_ / kWidth - 1;
+    size_t group_index = h1 & mask;
+    // Triangular probing visits every group of a power of 2 table
+    for (size_t step = 1;; ++step) {
+      internal::CtrlGroup group(ctrl_ + group_index * kWidth);
+      for (uint32_t match = group.Match(h2); match != 0; match &= match - 1) {
+        size_t i = group_index * kWidth + __builtin_ctz(match);
+        if (slots_[i].first == key) {
+          return i;
+        }
+      }
+      if (group.MatchEmpty() != 0) {
+        return kNotFound;
+      }
+      group_index = (group_index + step) & mask;
+    }
+  }
+
+  /// Claim a slot for a key that is not in the map
+  size_t Insert(size_t h1, int8_t h2) {
+    if (growth_left_ == 0) {
+      // Rehash in place if most of the load is tombstones
+      Resize(size_ + 1 > MaxLoad(capacity_) / 2 ? capacity_ * 2 : capacity_);
+    }
+    size_t i = FindInsertSlot(h1);
+    if (ctrl_[i] == internal::kCtrlEmpty) {
+      --growth_left_;
+    }
+    ctrl_[i] = h2;
+    ++size_;
+    return i;
+  }
+
+  size_t FindInsertSlot(size_t h1) const {
+    constexpr size_t kWidth = internal::kCtrlGroupWidth;
+    size_t mask = capacity_ / kWidth - 1;
+    size_t group_index = h1 & mask;
+    for (size_t step = 1;; ++step) {
+      internal::CtrlGroup group(ctrl_ + group_index * kWidth);
+      if (uint32_t match = group.MatchEmptyOrDeleted(); match != 0) {
+        return group_index * kWidth + __builtin_ctz(match);
+      }
+      group_index = (group_index + step) & mask;
+    }
+  }
+
+  bool IsInline() const { return ctrl_ == inline_ctrl_; }
+
+  void UseInline() {
+    ctrl_ = inline_ctrl_;
+    slots_ = reinterpret_cast<value_type*>(inline_slots_);
+    capacity_ = InlineSlots;
+    clear();
+  }
+
+  /// Replace the table with an empty one of \param capacity slots
+  void Allocate(size_t capacity) {
+    if (capacity <= InlineSlots) {
+      UseInline();
+      return;
+    }
+    CtrlAlloc ctrl_alloc(alloc_);
+    SlotAlloc slot_alloc(alloc_);
+    ctrl_ = std::allocator_traits<CtrlAlloc>::allocate(ctrl_alloc, capacity);
+    slots_ = std::allocator_traits<SlotAlloc>::allocate(slot_alloc, capacity);
+    capacity_ = capacity;
+    clear();
+  }
+
+  void Free() {
+    if (IsInline()) {
+      return;
+    }
+    CtrlAlloc ctrl_alloc(alloc_);
+    SlotAlloc slot_alloc(alloc_);
+    std::allocator_traits<CtrlAlloc>::deallocate(ctrl_alloc, ctrl_, capacity_);
+    std::allocator_traits<SlotAlloc>::deallocate(
+        slot_alloc, slots_, capacity_);
+  }
+
+  void Resize(size_t capacity) {
+    int8_t* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    size_t old_capacity = capacity_;
+    bool old_inline = IsInline();
+
+    // The inline slots are reused if the new table is inline too
+    int8_t saved_ctrl[InlineSlots];
+    alignas(value_type) unsigned char saved_slots[sizeof(inline_slots_)];
+    if (old_inline) {
+      std::memcpy(saved_ctrl, inline_ctrl_, sizeof(inline_ctrl_));
+      std::memcpy(saved_slots, inline_slots_, sizeof(inline_slots_));
+      old_ctrl = saved_ctrl;
+      old_slots = reinterpret_cast<value_type*>(saved_slots);
+    }
+
+    Allocate(capacity);
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] >= 0) {
+        auto [h1, h2] = Split(hash_(old_slots[i].first));
+        size_t slot = FindInsertSlot(h1);
+        ctrl_[slot] = h2;
+        std::memcpy(
+            static_cast<void*>(slots_ + slot), old_slots + i,
+            sizeof(value_type));
+        ++size_;
+        --growth_left_;
+      }
+    }
+
+    if (!old_inline) {
+      CtrlAlloc ctrl_alloc(alloc_);
+      SlotAlloc slot_alloc(alloc_);
+      std::allocator_traits<CtrlAlloc>::deallocate(
+          ctrl_alloc, old_ctrl, old_capacity);
+      std::allocator_traits<SlotAlloc>::deallocate(
+          slot_alloc, old_slots, old_capacity);
+    }
+  }
+
+  /// Copy the table of \param other into this empty map
+  void CopyFrom(const SmallHashMap& other) {
+    if (other.capacity_ != capacity_) {
+      Free();
+      Allocate(other.capacity_);
+    }
+    std::memcpy(ctrl_, other.ctrl_, capacity_);
+    std::memcpy(
+        static_cast<void*>(slots_), other.slots_,
+        capacity_ * sizeof(value_type));
+    size_ = other.size_;
+    growth_left_ = other.growth_left_;
+  }
+
+  /// Take the table of \param other, which is left empty, into this empty
+  /// inline map
+  void MoveFrom(SmallHashMap* other) {
+    if (other->IsInline()) {
+      CopyFrom(*other);
+      other->clear();
+      return;
+    }
+    ctrl_ = other->ctrl_;
+    slots_ = other->slots_;
+    capacity_ = other->capacity_;
+    size_ = other->size_;
+    growth_left_ = other->growth_left_;
+    other->UseInline();
+  }
+
+  template <bool Const>
+  Iterator<Const> MakeIterator(size_t i, bool skip_empty) const {
+    Iterator<Const> it(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+    if (skip_empty) {
+      it.SkipEmpty();
+    }
+    return it;
+  }
+
+  Allocator alloc_;
+  Hash hash_;
+  int8_t* ctrl_{nullptr};
+  value_type* slots_{nullptr};
+  size_t capacity_{0};
+  size_t size_{0};
+  /// Empty slots that can be filled before the table is too full
+  size_t growth_left_{0};
+  alignas(internal::kCtrlGroupWidth) int8_t inline_ctrl_[InlineSlots];
+  alignas(value_type) unsigned char inline_slots_[InlineSlots *
+                                                  sizeof(value_type)];
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SOCKETARENAS_H_
+#define KATANA_LIBGALOIS_KATANA_SOCKETARENAS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Katana built with KATANA_ENABLE_JEMALLOC allocates with jemalloc and
+/// gives the threads of each socket of the thread pool (see
+/// ThreadTopoInfo::socket) their own jemalloc arena. Small allocations from
+/// the STL then come from, and are freed back to, memory first touched by
+/// the socket that uses it instead of from arenas shared across sockets.
+///
+/// Setting the environment variable KATANA_DO_NOT_BIND_ARENAS leaves
+/// threads on the default arenas of jemalloc.
+
+/// Allocator statistics of the arena of a socket
+struct KATANA_EXPORT SocketArenaStats {
+  unsigned socket;
+  /// Bytes of live allocations
+  uint64_t allocated;
+  /// Bytes of the pages of active extents
+  uint64_t active;
+  /// Bytes mapped by the arena and not returned to the OS
+  uint64_t resident;
+};
+
+/// \returns whether threads allocate from per-socket arenas
+KATANA_EXPORT bool SocketArenasEnabled();
+
+/// \returns the statistics of the arenas of each socket that has one, which
+/// is empty unless SocketArenasEnabled()
+KATANA_EXPORT std::vector<SocketArenaStats> GetSocketArenaStats();
+
+/// Report GetSocketArenaStats and the totals of the allocator to the
+/// StatManager
+KATANA_EXPORT void ReportSocketArenaStats();
+
+namespace internal {
+
+/// Make the calling thread allocate from the arena of socket, creating the
+/// arena on first use. Called by the thread pool as it starts each thread.
+void BindThreadToSocketArena(unsigned socket);
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
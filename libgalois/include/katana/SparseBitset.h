@@ -0,0 +1,184 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPARSEBITSET_H_
+#define KATANA_LIBGALOIS_KATANA_SPARSEBITSET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * A set of 32-bit integers stored as a sorted array of fixed size blocks of
+ * bits. Only blocks with at least one bit set are stored, so the set takes
+ * space proportional to the number of distinct blocks it touches rather
+ * than to its largest element, and unlike a linked list of words the blocks
+ * are contiguous in memory.
+ *
+ * Not thread safe.
+ */
+class KATANA_EXPORT SparseBitset {
+public:
+  static constexpr uint32_t kWordsPerBlock = 2;
+  static constexpr uint32_t kBitsPerWord = 64;
+  static constexpr uint32_t kBitsPerBlock = kWordsPerBlock * kBitsPerWord;
+
+  struct Block {
+    //! The block holds bits [index * kBitsPerBlock, (index + 1) *
+    //! kBitsPerBlock)
+    uint32_t index;
+    uint64_t words[kWordsPerBlock];
+  };
+
+  /**
+   * Sets bit i.
+   *
+   * @returns true if the bit was not set before
+   */
+  bool set(uint32_t i);
+
+  /**
+   * @returns true if bit i is set
+   */
+  bool test(uint32_t i) const;
+
+  /**
+   * Sets every bit that is set in other, merging the blocks in place.
+   *
+   * @returns true if any bit was not set before
+   */
+  bool UnionWith(const SparseBitset& other);
+
+  /**
+   * Resets every bit that is set in other.
+   *
+   * @returns true if any bit was set before
+   */
+  bool DifferenceWith(const SparseBitset& other);
+
+  /**
+   * @returns true if every bit set in this set is also set in other
+   */
+  bool IsSubsetOf(const SparseBitset& other) const;
+
+  /**
+   * @returns the number of bits set
+   */
+  size_t count() const;
+
+  bool empty() const { return blocks_.empty(); }
+
+  void clear() { blocks_.clear(); }
+
+  /**
+   * @returns the number of blocks stored
+   */
+  size_t num_blocks() const { return blocks_.size(); }
+
+  /**
+   * Releases the memory of the blocks beyond those stored
+   */
+  void shrink_to_fit() { blocks_.shrink_to_fit(); }
+
+  /**
+   * @returns a hash of the set bits; equal sets have equal hashes
+   */
+  size_t Hash() const;
+
+  bool operator==(const SparseBitset& other) const;
+
+  bool operator!=(const SparseBitset& other) const { return !(*this == other); }
+
+  /**
+   * Calls fn(i) for each set bit i in increasing order.
+   */
+  template <typename F>
+  void ForEach(const F& fn) const {
+    for (const Block& block : blocks_) {
+      for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+        uint64_t word = block.words[w];
+        uint32_t base = block.index * kBitsPerBlock + w * kBitsPerWord;
+        while (word != 0) {
+          uint32_t bit = __builtin_ctzll(word);
+          word &= word - 1;
+          fn(base + bit);
+        }
+      }
+    }
+  }
+
+  /**
+   * @returns the set bits in increasing order
+   */
+  std::vector<uint32_t> ToVector() const;
+
+private:
+  std::vector<Block> blocks_;
+};
+
+/**
+ * Hash-conses SparseBitsets: equal sets interned in a pool share one
+ * immutable copy, identified by a Handle that stays valid for the lifetime of
+ * the pool. Two handles from the same pool are equal exactly when their sets
+ * are, so comparing sets is a pointer comparison, and unions of interned
+ * sets are memoized.
+ *
+ * This suits analyses, such as points-to analysis, in which many variables
+ * end up with the same large set: each distinct set is stored once.
+ *
+ * Thread safe.
+ */
+class KATANA_EXPORT SparseBitsetPool {
+public:
+  using Handle = const SparseBitset*;
+
+  SparseBitsetPool();
+  ~SparseBitsetPool();
+
+  SparseBitsetPool(const SparseBitsetPool&) = delete;
+  SparseBitsetPool& operator=(const SparseBitsetPool&) = delete;
+
+  /**
+   * @returns the handle of the empty set
+   */
+  Handle Empty() const { return empty_; }
+
+  /**
+   * @returns the handle of the set equal to set, interning it if needed
+   */
+  Handle Intern(SparseBitset set);
+
+  /**
+   * @returns the handle of the union of a and b
+   */
+  Handle Union(Handle a, Handle b);
+
+  /**
+   * @returns the handle of a with bit i set
+   */
+  Handle Set(Handle a, uint32_t i);
+
+  /**
+   * @returns the number of distinct sets interned
+   */
+  size_t size() const;
+
+  /**
+   * @returns the number of blocks of all distinct sets interned
+   */
+  size_t num_blocks() const;
+
+private:
+  struct Shard;
+
+  Shard& ShardFor(size_t hash) const;
+
+  std::unique_ptr<Shard[]> shards_;
+  Handle empty_;
+};
+
+}  // namespace katana
+
+#endif
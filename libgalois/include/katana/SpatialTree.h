@@ -20,6 +20,14 @@
 #ifndef KATANA_LIBGALOIS_KATANA_SPATIALTREE_H_
 #define KATANA_LIBGALOIS_KATANA_SPATIALTREE_H_
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Allocators.h"
+#include "katana/Loops.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -28,6 +36,7 @@ namespace katana {
 //! Lookup returns an approximation of the closest item
 template <typename T>
 class SpatialTree2d {
+public:
   struct Box2d {
     double xmin;
     double ymin;
@@ -47,7 +56,25 @@ class SpatialTree2d {
       else
         ymax = midy;
     }
+
+    bool contains(double x, double y) const {
+      return xmin <= x && x <= xmax && ymin <= y && y <= ymax;
+    }
+
+    bool intersects(const Box2d& other) const {
+      return xmin <= other.xmax && other.xmin <= xmax && ymin <= other.ymax &&
+             other.ymin <= ymax;
+    }
+
+    //! Squared distance from x,y to the closest point of the box
+    double dist2(double x, double y) const {
+      double dx = std::max({xmin - x, 0.0, x - xmax});
+      double dy = std::max({ymin - y, 0.0, y - ymax});
+      return dx * dx + dy * dy;
+    }
   };
+
+private:
   struct Node {
     // existing item
     T val;
@@ -133,6 +160,126 @@ class SpatialTree2d {
     recinsert(&(*pos)->children[quad], b, node);
   }
 
+  //! Items of the same subtree in a bulk insert
+  struct BulkTask {
+    Node** pos;
+    Box2d b;
+    Node** begin;
+    Node** end;
+  };
+
+  //! Below this many items, a subtree is filled by serial inserts
+  static constexpr ptrdiff_t kBulkCutoff = 64;
+
+  //! Places the nodes of task below task.pos and pushes the subtrees that
+  //! are left to fill
+  template <typename Context>
+  void bulkinsert(BulkTask task, Context& ctx) {
+    Node** begin = task.begin;
+    Node** end = task.end;
+    if (end - begin <= kBulkCutoff) {
+      for (; begin != end; ++begin) {
+        recinsert(task.pos, task.b, *begin);
+      }
+      return;
+    }
+
+    // The item closest to the center of an empty subtree becomes its root,
+    // which is where the median of uniformly spread items would split
+    Node* n = *task.pos;
+    if (!n) {
+      double cx = task.b.xmid();
+      double cy = task.b.ymid();
+      Node** closest = begin;
+      for (Node** it = begin + 1; it != end; ++it) {
+        if (closer(
+                cx, cy, (*it)->x, (*it)->y, (*closest)->x, (*closest)->y)) {
+          closest = it;
+        }
+      }
+      std::iter_swap(begin, closest);
+      n = *begin++;
+      n->setCenter(cx, cy);
+      *task.pos = n;
+    }
+
+    // Split the rest by quadrant: first by y (quads 2 and 3), then by x
+    // (quads 1 and 3) within each half
+    Node** ysplit = std::partition(
+        begin, end, [n](Node* m) { return !(n->getQuad(m->x, m->y) & 2); });
+    Node** splits[5] = {
+        begin,
+        std::partition(
+            begin, ysplit,
+            [n](Node* m) { return !(n->getQuad(m->x, m->y) & 1); }),
+        ysplit,
+        std::partition(
+            ysplit, end,
+            [n](Node* m) { return !(n->getQuad(m->x, m->y) & 1); }),
+        end,
+    };
+    for (int quad = 0; quad < 4; ++quad) {
+      if (splits[quad] == splits[quad + 1]) {
+        continue;
+      }
+      Box2d b = task.b;
+      b.decimate(quad, n->midx, n->midy);
+      ctx.push(
+          BulkTask{&n->children[quad], b, splits[quad], splits[quad + 1]});
+    }
+  }
+
+  //! Unbounded region of the children of a node in quadrant quad of b
+  static Box2d childRegion(const Node* n, const Box2d& b, int quad) {
+    Box2d child = b;
+    child.decimate(quad, n->midx, n->midy);
+    return child;
+  }
+
+  static Box2d everywhere() {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    return Box2d{-inf, -inf, inf, inf};
+  }
+
+  void recrange(
+      Node* n, const Box2d& region, const Box2d& query,
+      std::vector<T*>* out) {
+    if (!n || !region.intersects(query)) {
+      return;
+    }
+    if (query.contains(n->x, n->y)) {
+      out->emplace_back(&n->val);
+    }
+    for (int quad = 0; quad < 4; ++quad) {
+      recrange(n->children[quad], childRegion(n, region, quad), query, out);
+    }
+  }
+
+  //! Candidate of a nearest neighbor search: squared distance and node
+  using Candidate = std::pair<double, Node*>;
+
+  void recnearest(
+      Node* n, const Box2d& region, double x, double y, size_t k,
+      std::priority_queue<Candidate>* best) {
+    if (!n ||
+        (best->size() == k && region.dist2(x, y) > best->top().first)) {
+      return;
+    }
+    double dx = n->x - x;
+    double dy = n->y - y;
+    best->emplace(dx * dx + dy * dy, n);
+    if (best->size() > k) {
+      best->pop();
+    }
+    // The quadrant of x,y first, so that the others are likely pruned
+    int first = n->getQuad(x, y);
+    for (int i = 0; i < 4; ++i) {
+      int quad = first ^ i;
+      recnearest(
+          n->children[quad], childRegion(n, region, quad), x, y, k, best);
+    }
+  }
+
   Node* mkNode(const T& v, double x, double y) {
     Node* n = nodeAlloc.allocate(1);
     nodeAlloc.construct(n, Node(v, x, y));
@@ -185,6 +332,85 @@ public:
   void insert(double x, double y, const T& v) {
     recinsert(&root, bounds, mkNode(v, x, y));
   }
+
+  //! Insert the elements [first, last) in parallel, where coords(v) returns
+  //! the std::pair of the x and y coordinates of v. Rather than one CAS
+  //! descent per element, the elements are partitioned by quadrant top down,
+  //! one task per subtree, and the element closest to the center of each new
+  //! subtree becomes its root, so the tree stays balanced whatever the
+  //! order of the elements. Must not run concurrently with insert.
+  template <typename Iter, typename CoordFn>
+  void bulkInsert(Iter first, Iter last, CoordFn coords) {
+    size_t size = std::distance(first, last);
+    std::vector<Node*> nodes(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          const T& v = *std::next(first, i);
+          auto [x, y] = coords(v);
+          nodes[i] = mkNode(v, x, y);
+        },
+        katana::no_stats());
+
+    typedef katana::PerSocketChunkLIFO<1> WL;
+    katana::for_each(
+        katana::iterate({BulkTask{
+            &root, bounds, nodes.data(), nodes.data() + nodes.size()}}),
+        [&](const BulkTask& task, auto& ctx) { bulkinsert(task, ctx); },
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::wl<WL>());
+  }
+
+  //! Appends the elements in the closed box query to out, in no particular
+  //! order
+  void findInRange(const Box2d& query, std::vector<T*>* out) {
+    recrange(root, everywhere(), query, out);
+  }
+
+  //! Replaces out with the (at most) k elements closest to x,y, closest
+  //! first. Unlike find, the result is exact.
+  void findNearest(double x, double y, size_t k, std::vector<T*>* out) {
+    out->clear();
+    if (k == 0) {
+      return;
+    }
+    std::priority_queue<Candidate> best;
+    recnearest(root, everywhere(), x, y, k, &best);
+    out->resize(best.size());
+    for (auto it = out->rbegin(); it != out->rend(); ++it) {
+      *it = &best.top().second->val;
+      best.pop();
+    }
+  }
+
+  //! findInRange for each box of queries, in parallel; results[i] holds the
+  //! elements in queries[i]
+  void findInRange(
+      const std::vector<Box2d>& queries,
+      std::vector<std::vector<T*>>* results) {
+    results->resize(queries.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, queries.size()),
+        [&](size_t i) {
+          (*results)[i].clear();
+          findInRange(queries[i], &(*results)[i]);
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  //! findNearest for each x,y pair of points, in parallel; results[i] holds
+  //! the k elements closest to points[i]
+  void findNearest(
+      const std::vector<std::pair<double, double>>& points, size_t k,
+      std::vector<std::vector<T*>>* results) {
+    results->resize(points.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, points.size()),
+        [&](size_t i) {
+          findNearest(points[i].first, points[i].second, k, &(*results)[i]);
+        },
+        katana::steal(), katana::no_stats());
+  }
 };
 
 }  // namespace katana
@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_STABLEITERATOR_H_
 
 #include "katana/Chunk.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
 
@@ -129,7 +130,7 @@ private:
     }
     ++data.nextVictim;
     ++data.numStealFailures;
-    data.nextVictim %= activeThreads;
+    data.nextVictim %= getActiveThreads();
     return std::nullopt;
   }
 
@@ -153,7 +154,7 @@ public:
       return *data.localBegin++;
 
     std::optional<value_type> item;
-    if (Steal && 2 * data.numStealFailures > activeThreads)
+    if (Steal && 2 * data.numStealFailures > getActiveThreads())
       if ((item = pop_steal(data)))
         return item;
     if ((item = inner.pop()))
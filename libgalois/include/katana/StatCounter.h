@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_STATCOUNTER_H_
+#define KATANA_LIBGALOIS_KATANA_STATCOUNTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "katana/CacheLineStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// StatCounter is an integer statistic that is cheap enough to update in the
+/// inner loops of parallel operators, e.g., to count relaxed edges or
+/// worklist pushes, and so can stay enabled in production builds.
+///
+/// ReportStatSum and friends look up the statistic by region and category
+/// strings on every call. A StatCounter is registered by name once, when it
+/// is constructed, and afterwards updated through its own array of per-thread
+/// slots, each on a cache line of its own: Add is a relaxed load and store
+/// of the slot of the calling thread, with no lookup, lock or atomic
+/// read-modify-write. The slots are summed only when the StatManager merges
+/// statistics for printing, where the counter is reported like a statistic
+/// reported with ReportStatSum, including its per-thread values, and the
+/// slots are reset.
+///
+/// Counters with the same region and category share their slots, so a
+/// counter may be declared as a function-local static or, at the cost of a
+/// registry lookup per construction, as an ordinary local:
+///
+///   static katana::StatCounter edges_relaxed("SSSP", "EdgesRelaxed");
+///   ...
+///   edges_relaxed.Add(degree);
+///
+/// While counters are disabled (see SetStatCountersEnabled) Add only tests a
+/// flag.
+class KATANA_EXPORT StatCounter {
+public:
+  using Slot = CacheLineStorage<std::atomic<uint64_t>>;
+
+  StatCounter(const std::string& region, const std::string& category);
+
+  /// Add n to the slot of the calling thread
+  void Add(uint64_t n = 1);
+
+  /// Return the sum of the slots. Updates that race with this call may or
+  /// may not be counted.
+  uint64_t Total() const;
+
+  /// The index of this counter among the registered counters
+  uint32_t id() const { return id_; }
+
+private:
+  Slot* slots_;
+  uint32_t id_;
+};
+
+/// Enable or disable all StatCounters. Counters are initially enabled
+/// unless the environment variable KATANA_STAT_COUNTERS is false.
+KATANA_EXPORT void SetStatCountersEnabled(bool enabled);
+
+namespace internal {
+
+KATANA_EXPORT extern std::atomic<bool> stat_counters_enabled;
+
+/// Call fn with the region, category, thread id and value of every non-zero
+/// slot of every registered counter and reset the slots to zero. Called by
+/// StatManager when it merges statistics.
+KATANA_EXPORT void DrainStatCounters(
+    const std::function<void(
+        const std::string& region, const std::string& category,
+        unsigned tid, uint64_t value)>& fn);
+
+}  // namespace internal
+
+/// Return true if StatCounters count.
+inline bool
+AreStatCountersEnabled() {
+  return internal::stat_counters_enabled.load(std::memory_order_relaxed);
+}
+
+inline void
+StatCounter::Add(uint64_t n) {
+  if (AreStatCountersEnabled()) {
+    std::atomic<uint64_t>& slot = slots_[ThreadPool::getTID()].data;
+    slot.store(
+        slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace katana
+
+#endif
@@ -434,7 +434,8 @@ ReportStatAvg(
 //! @param id Identifier to prefix stat with in statistics output
 KATANA_EXPORT void reportRUsage(const std::string& id);
 
-//! Reports Galois system memory stats for all threads
+//! Reports Galois system memory stats for all threads, and how many pages
+//! were backed by explicit, transparent or no huge pages
 KATANA_EXPORT void reportPageAlloc(const char* category);
 
 /// Prints statistics out to standard out or to the file indicated by
@@ -0,0 +1,66 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SUBPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_SUBPOOL_H_
+
+#include <functional>
+#include <memory>
+
+#include "katana/Barrier.h"
+#include "katana/Result.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A SubPool carves threads out of the thread pool so that parallel sections
+/// (do_all, for_each, on_each) can run on them while the rest of the pool
+/// runs others, e.g., to answer a small BFS query while a large PageRank runs.
+///
+/// A sub-pool takes the highest numbered usable threads, so the main pool
+/// has that many fewer until the sub-pool is destroyed. Inside Run, the
+/// sub-pool has its own thread ids, active threads, barrier and termination
+/// detection: ThreadPool::getTID() ranges over [0, num_threads()), and the
+/// threads look like a single socket. Jobs on one sub-pool run one at a
+/// time.
+///
+/// Sub-pools are made and destroyed outside parallel sections, destroyed in
+/// the reverse order in which they were made, and before the SharedMemSys.
+class KATANA_EXPORT SubPool {
+public:
+  /// Carves num_threads threads out of the pool
+  static Result<std::unique_ptr<SubPool>> Make(unsigned num_threads);
+
+  /// Carves out the usable threads on the NUMA node of the highest numbered
+  /// usable thread
+  static Result<std::unique_ptr<SubPool>> MakeForNumaNode();
+
+  ~SubPool();
+
+  SubPool(const SubPool&) = delete;
+  SubPool& operator=(const SubPool&) = delete;
+  SubPool(SubPool&&) = delete;
+  SubPool& operator=(SubPool&&) = delete;
+
+  unsigned num_threads() const { return team_->size; }
+
+  /// Runs fn on the first thread of the sub-pool and waits for it to finish.
+  /// Parallel sections in fn run on the threads of the sub-pool; all of them
+  /// are active until fn calls setActiveThreads, which lasts across runs.
+  /// Rethrows what fn throws. Run may be called from any thread outside the
+  /// sub-pool, including from another sub-pool or a parallel section.
+  void Run(const std::function<void()>& fn);
+
+private:
+  SubPool(
+      ThreadPool::Team* team, std::unique_ptr<Barrier> barrier,
+      std::unique_ptr<TerminationDetection> term)
+      : team_(team), barrier_(std::move(barrier)), term_(std::move(term)) {}
+
+  ThreadPool::Team* team_;
+  std::unique_ptr<Barrier> barrier_;
+  std::unique_ptr<TerminationDetection> term_;
+};
+
+}  // namespace katana
+
+#endif
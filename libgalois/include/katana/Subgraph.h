@@ -0,0 +1,49 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SUBGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_SUBGRAPH_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Which properties ExtractSubgraph copies into the subgraph
+struct SubgraphProperties {
+  /// Node properties to copy; nullptr means all node properties
+  const std::vector<std::string>* node_properties{nullptr};
+  /// Edge properties to copy; nullptr means all edge properties
+  const std::vector<std::string>* edge_properties{nullptr};
+};
+
+/// A graph extracted from another one, with the maps back to the original
+struct KATANA_EXPORT Subgraph {
+  std::unique_ptr<PropertyGraph> graph;
+  /// Entry i is the original ID of node i of graph
+  std::shared_ptr<arrow::UInt32Array> original_nodes;
+  /// Entry i is the original ID of edge i of graph
+  std::shared_ptr<arrow::UInt64Array> original_edges;
+};
+
+/// Extract the subgraph of pg induced by the nodes set in node_mask,
+/// keeping only the edges set in edge_mask if it is not null.
+///
+/// Nodes keep their relative order and are renumbered densely, as are the
+/// edges of each node. The requested properties are gathered with
+/// arrow::compute::Take. Running an analytic on a small projection of a
+/// graph is usually much faster after extracting it, since the analytic
+/// then only touches the projection.
+KATANA_EXPORT Result<Subgraph> ExtractSubgraph(
+    const PropertyGraph& pg, const DynamicBitset& node_mask,
+    const DynamicBitset* edge_mask = nullptr,
+    const SubgraphProperties& properties = SubgraphProperties());
+
+}  // namespace katana
+
+#endif
@@ -21,6 +21,8 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <cstdint>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -37,6 +39,34 @@ class TerminationDetection;
 KATANA_EXPORT TerminationDetection& GetTerminationDetection(
     unsigned active_threads);
 
+/// Creates a new termination detection instance, for a team of threads that
+/// runs beside the one GetTerminationDetection serves (see SubPool.h).
+///
+/// The ring detector is used on a single socket with at most 16 threads and
+/// the hierarchical detector otherwise; the environment variable
+/// KATANA_TERMINATION (ring or hierarchical) overrides the choice.
+KATANA_EXPORT std::unique_ptr<TerminationDetection>
+CreateTerminationDetection();
+
+/// Dijkstra style 2-pass ring: a token visits the threads one at a time, so a
+/// pass takes time linear in the number of threads.
+KATANA_EXPORT std::unique_ptr<TerminationDetection>
+CreateRingTerminationDetection();
+
+/// Dijkstra style 2-pass waves over a two level tree: the threads of a socket
+/// report their colors to a counter of the socket in parallel, and the last
+/// thread of each socket reports the color of the socket to a global counter,
+/// so a pass takes time linear in the number of sockets and threads do not
+/// wait on threads of other sockets.
+KATANA_EXPORT std::unique_ptr<TerminationDetection>
+CreateHierarchicalTerminationDetection();
+
+/// Reports how many times the termination detection instance of the thread
+/// pool detected termination and the mean and maximum detection latency (see
+/// TerminationDetection::DetectionStats) as statistics of region
+/// "Termination".
+KATANA_EXPORT void ReportTerminationLatency();
+
 /// Termination detection is the process of determining whether multiple
 /// threads can safely stop executing because no worker has done any
 /// work.
@@ -68,15 +98,32 @@ KATANA_EXPORT TerminationDetection& GetTerminationDetection(
 ///   } while (term.Working());
 ///
 class KATANA_EXPORT TerminationDetection {
-  // So that GetTerminationDetection can call init.
-  friend TerminationDetection& GetTerminationDetection(unsigned);
-
   CacheLineStorage<std::atomic<int>> global_term_;
 
+public:
+  /// Detection latency is the time from the last SignalWorked(true) of any
+  /// thread to the detection of termination.
+  struct DetectionStats {
+    uint64_t detections{0};
+    uint64_t total_ns{0};
+    uint64_t max_ns{0};
+  };
+
+private:
+  /// The time of the last SignalWorked(true) of each thread
+  PerThreadStorage<uint64_t> last_work_ns_;
+  unsigned num_threads_{0};
+  DetectionStats stats_;
+
 protected:
-  void SetTerminated() { global_term_ = true; }
+  /// Called by the one thread that detects termination
+  void SetTerminated();
 
-  void ResetTerminated() { global_term_ = false; }
+  /// Called by each thread from InitializeThread
+  void ResetTerminated();
+
+  /// Called by SignalWorked when work happened
+  void NoteWork();
 
   virtual void Init(unsigned active_threads) = 0;
 
@@ -106,6 +153,14 @@ public:
 
   /// Working returns false iff all threads should terminate
   bool Working() const { return !global_term_.data; }
+
+  /// Reinitializes the instance for active_threads threads; not thread-safe
+  void Reinit(unsigned active_threads);
+
+  virtual const char* name() const = 0;
+
+  /// The detection latency of this instance so far; not thread-safe
+  DetectionStats GetDetectionStats() const { return stats_; }
 };
 
 namespace internal {
@@ -22,9 +22,14 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -51,9 +56,61 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+class Barrier;
+class TerminationDetection;
+
 class KATANA_EXPORT ThreadPool {
   friend class SharedMem;
 
+public:
+  /// Dispatch latency is the time from the start of a parallel section on
+  /// its first thread until its last thread starts it. Only parallel
+  /// sections on more than one thread count.
+  struct DispatchStats {
+    uint64_t runs{0};
+    uint64_t total_ns{0};
+    uint64_t max_ns{0};
+  };
+
+  //! A job waiting for a sub-pool team
+  struct TeamJob {
+    const std::function<void(void)>* fn;
+    std::exception_ptr error;
+    bool done{false};
+  };
+
+  /// A Team is a range of consecutive threads that run parallel sections
+  /// together. The main team holds the usable threads; each sub-pool (see
+  /// SubPool.h) is a team carved from the top of them, whose first thread
+  /// serves jobs while the main team runs its own parallel sections.
+  ///
+  /// Inside a sub-pool, thread ids are relative to its first thread and the
+  /// team looks like a single socket.
+  struct Team {
+    //! absolute id of the first thread
+    unsigned begin{0};
+    unsigned size{0};
+    unsigned active_threads{1};
+    bool running{false};
+    std::function<void(void)> work;
+    //! steady clock times, in nanoseconds, when the running parallel section
+    //! was dispatched and when its last thread started
+    std::atomic<uint64_t> dispatch_begin{0};
+    std::atomic<uint64_t> dispatch_last{0};
+    DispatchStats dispatch_stats;
+    //! barrier and termination detection of a sub-pool; the main team uses
+    //! the global ones
+    Barrier* barrier{nullptr};
+    unsigned barrier_threads{0};
+    TerminationDetection* term{nullptr};
+    //! jobs for the first thread of a sub-pool
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_cv;
+    std::deque<TeamJob*> jobs;
+    bool closing{false};
+    bool closed{false};
+  };
+
 protected:
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -62,6 +119,9 @@ protected:
   struct dedicated_ty {
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
+  struct team_ty {
+    Team* team;
+  };  //! type to switch to serving a sub-pool
 
   //! Per-thread mailboxes for notification
   struct per_signal {
@@ -70,43 +130,79 @@ protected:
     unsigned wbegin, wend;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    std::atomic<bool> sleeping;
     ThreadTopoInfo topo;
+    //! topo as seen from the team the thread last joined
+    ThreadTopoInfo view;
+    //! team of the parallel section being started, set by the waker
+    Team* team;
+    //! team that view describes
+    Team* adopted;
+    //! absolute id of the first thread of adopted, or zero in the main team
+    unsigned team_begin;
 
     void wakeup(bool fastmode) {
       if (fastmode) {
         done = 0;
         fastRelease = 1;
       } else {
-        std::lock_guard<std::mutex> lg(m);
+        // A thread still spinning in wait sees done without a notify. Either
+        // the sleeper sees done or we see sleeping, since both are seq_cst.
         done = 0;
-        cv.notify_one();
-        // start.release();
+        if (sleeping) {
+          std::lock_guard<std::mutex> lg(m);
+          cv.notify_one();
+        }
       }
     }
 
-    void wait(bool fastmode) {
+    //! wait for wakeup, polling for up to spin_ns before sleeping
+    void wait(bool fastmode, uint64_t spin_ns) {
       if (fastmode) {
         while (!fastRelease.load(std::memory_order_relaxed)) {
           asmPause();
         }
         fastRelease = 0;
       } else {
+        if (spin_ns && spin(spin_ns)) {
+          return;
+        }
         std::unique_lock<std::mutex> lg(m);
+        sleeping = true;
         cv.wait(lg, [=] { return !done; });
-        // start.acquire();
+        sleeping = false;
+      }
+    }
+
+    //! poll done for up to spin_ns; return true if woken
+    bool spin(uint64_t spin_ns) {
+      auto deadline = std::chrono::steady_clock::now() +
+                      std::chrono::nanoseconds(spin_ns);
+      for (unsigned polls = 1; done; ++polls) {
+        asmPause();
+        // reading the clock costs more than a pause
+        if (polls % 64 == 0 && std::chrono::steady_clock::now() > deadline) {
+          return !done;
+        }
       }
+      return true;
     }
   };
 
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  //! the topology of each thread, which is known before the thread starts
+  std::vector<ThreadTopoInfo> topos;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
+  //! threads [0, started) have started
+  unsigned started;
   unsigned reserved;
   unsigned masterFastmode;
-  bool running;
-  std::function<void(void)> work;
+  std::atomic<uint64_t> spinWaitNs;
+  Team mainTeam;
+  std::vector<std::unique_ptr<Team>> subTeams;
 
   //! destroy all threads
   void destroyCommon();
@@ -114,6 +210,10 @@ protected:
   //! Initialize a thread
   void initThread(unsigned tid);
 
+  //! start the threads below num that have not started and wait for them to
+  //! initialize
+  void startThreads(unsigned num);
+
   //! main thread loop
   void threadLoop(unsigned tid);
 
@@ -123,8 +223,18 @@ protected:
   //! spin down after run
   void decascade();
 
-  //! execute work on num threads
-  void runInternal(unsigned num);
+  //! execute team.work on num threads of team
+  void runInternal(Team& team, unsigned num);
+
+  //! switch the view of the calling thread to its team
+  void adoptTeam();
+
+  //! run the jobs of a sub-pool on its first thread until it is released
+  void serveTeam(Team& team);
+
+  Team& currentTeam() {
+    return my_box.team_begin ? *my_box.adopted : mainTeam;
+  }
 
   ThreadPool();
 
@@ -155,11 +265,12 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
+    Team& team = currentTeam();
+    team.work = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
-    runInternal(num);
+    runInternal(team, num);
   }
 
   //! run function in a dedicated thread until the threadpool exits
@@ -170,13 +281,57 @@ public:
   // experimental: leave busy wait
   void beKind();
 
-  bool isRunning() const { return running; }
+  //! carve the num highest usable threads into a sub-pool team that uses
+  //! barrier and term; must be called outside parallel sections
+  Team* carveTeam(
+      unsigned num, Barrier* barrier, TerminationDetection* term);
+  //! return the threads of the most recently carved team to the main team
+  void releaseTeam(Team* team);
+  //! run fn on the first thread of team and wait for it
+  void runOnTeam(Team* team, const std::function<void(void)>& fn);
+
+  //! return the sub-pool team of the calling thread, or null if it is in the
+  //! main team
+  static Team* getCurrentTeam() {
+    return my_box.team_begin ? my_box.adopted : nullptr;
+  }
+  //! return the absolute id of thread 0 of the calling thread's team
+  static unsigned getTeamBegin() { return my_box.team_begin; }
+
+  //! keep idle threads polling for the next parallel section for spin after
+  //! one ends before they sleep. Zero, the default unless the environment
+  //! variable KATANA_SPIN_WAIT_US sets it, sleeps right away; burnPower
+  //! polls forever.
+  void setSpinWait(std::chrono::microseconds spin) {
+    spinWaitNs = std::chrono::nanoseconds(spin).count();
+  }
+  std::chrono::microseconds getSpinWait() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::nanoseconds(spinWaitNs.load()));
+  }
+
+  //! return the dispatch latency of the calling thread's team so far
+  DispatchStats getDispatchStats() const {
+    return my_box.team_begin ? my_box.adopted->dispatch_stats
+                             : mainTeam.dispatch_stats;
+  }
+
+  bool isRunning() const {
+    return my_box.team_begin ? my_box.adopted->running : mainTeam.running;
+  }
 
-  //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  //! return the number of non-reserved threads in the pool, or the size of
+  //! the calling thread's sub-pool
+  unsigned getMaxUsableThreads() const {
+    return my_box.team_begin ? my_box.adopted->size : mi.maxThreads - reserved;
+  }
   //! return the number of threads supported by the thread pool on the current
   //! machine
   unsigned getMaxThreads() const { return mi.maxThreads; }
+  //! return the number of threads that have started. All threads start with
+  //! the pool unless the environment variable KATANA_LAZY_THREADS is true, in
+  //! which case threads start when a parallel section first uses them.
+  unsigned getStartedThreads() const { return started; }
   unsigned getMaxCores() const { return mi.maxCores; }
   unsigned getMaxSockets() const { return mi.maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
@@ -187,29 +342,44 @@ public:
         return i;
     abort();
   }
+  //! like getLeaderForSocket but in absolute thread ids, even in a sub-pool
+  unsigned getMachineLeaderForSocket(unsigned pid) const {
+    for (unsigned i = 0; i < getMaxThreads(); ++i)
+      if (topos[i].socket == pid && topos[i].socketLeader == i)
+        return i;
+    abort();
+  }
+
+  // Thread ids and sockets below are relative to the calling thread's team
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return my_box.team_begin ? tid == 0
+                             : topos[tid].socketLeader == tid;
+  }
+  unsigned getSocket(unsigned tid) const {
+    return my_box.team_begin ? 0 : topos[tid].socket;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return my_box.team_begin ? 0 : topos[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return my_box.team_begin ? 0 : topos[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return topos[tid + my_box.team_begin].numaNode;
+  }
+  unsigned getOSContext(unsigned tid) const {
+    return topos[tid + my_box.team_begin].osContext;
   }
 
-  static unsigned getTID() { return my_box.topo.tid; }
-  static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
-  static unsigned getLeader() { return my_box.topo.socketLeader; }
-  static unsigned getSocket() { return my_box.topo.socket; }
+  static unsigned getTID() { return my_box.view.tid; }
+  static bool isLeader() { return my_box.view.tid == my_box.view.socketLeader; }
+  static unsigned getLeader() { return my_box.view.socketLeader; }
+  static unsigned getSocket() { return my_box.view.socket; }
   static unsigned getCumulativeMaxSocket() {
-    return my_box.topo.cumulativeMaxSocket;
+    return my_box.view.cumulativeMaxSocket;
   }
-  static unsigned getNumaNode() { return my_box.topo.numaNode; }
+  static unsigned getNumaNode() { return my_box.view.numaNode; }
 };
 
 /**
@@ -37,5 +37,19 @@ KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
+/**
+ * Reports the thread placement policy and the OS ids of the hardware contexts
+ * that the active threads are bound to as parameters of the statistics
+ * manager (region "ThreadPool", categories "Placement" and "CPUs").
+ */
+KATANA_EXPORT void reportThreadPlacement();
+
+/**
+ * Reports how many parallel sections the thread pool dispatched to more than
+ * one thread and their mean and maximum dispatch latency (see
+ * ThreadPool::DispatchStats) as statistics of region "ThreadPool".
+ */
+KATANA_EXPORT void reportDispatchLatency();
+
 }  // namespace katana
 #endif
@@ -275,6 +275,18 @@ struct disable_conflict_detection_tag {};
 struct disable_conflict_detection : public trait_has_type<bool>,
                                     disable_conflict_detection_tag {};
 
+/**
+ * Indicates that acquires with MethodFlag::READ should not take ownership
+ * but be validated at the cautious point and before commit, which suits
+ * operators that read much more of their neighborhood than they write. The
+ * operator must be cautious and call UserContext::cautiousPoint once it has
+ * read what it needs and before it writes, unless rerunning its writes is
+ * harmless; see SimpleRuntimeContext.
+ */
+struct optimistic_conflict_detection_tag {};
+struct optimistic_conflict_detection : public trait_has_type<bool>,
+                                       optimistic_conflict_detection_tag {};
+
 /**
  * Indicates that the neighborhood set does not change through out i.e. is not
  * dependent on computed values. Examples of such fixed neighborhood is e.g.
@@ -347,6 +359,86 @@ struct local_state_tag {};
 template <typename T>
 struct local_state : public trait_has_type<T>, local_state_tag {};
 
+/**
+ * Indicates the operator has a function that prefetches the data an item
+ * will touch, which \ref katana::do_all calls on the item Distance items
+ * ahead of the one being processed so that the data is in cache by the time
+ * the item is. Only ranges with random access iterators can be prefetched.
+ *
+ * The function should have the signature <code>void (A)</code> where A is
+ * the type of items, and should only prefetch, e.g., with
+ * \ref katana::PrefetchRead.
+ */
+struct prefetch_tag {};
+template <typename T, unsigned Distance>
+struct prefetch_ahead : public trait_has_value<T>, prefetch_tag {
+  static_assert(Distance > 0, "prefetch distance must be positive");
+  constexpr static unsigned distance = Distance;
+
+  prefetch_ahead(const T& t = T()) : trait_has_value<T>(t) {}
+  prefetch_ahead(T&& t) : trait_has_value<T>(std::move(t)) {}
+};
+
+/**
+ * Make a \ref prefetch_ahead option that calls \param fn on the item
+ * Distance items ahead, e.g.,
+ * <code>katana::prefetch<8>([&](auto n) { ... })</code>
+ */
+template <unsigned Distance = 16, typename T>
+prefetch_ahead<T, Distance>
+prefetch(T fn) {
+  return prefetch_ahead<T, Distance>(std::move(fn));
+}
+
+/**
+ * Indicates the operator of a \ref katana::do_all makes a task for each item
+ * instead of processing it, and that each thread should run Width tasks at
+ * once, switching between them after every step so that their cache misses
+ * overlap. See \ref katana::InterleaveTasks for what a task is. Cannot be
+ * combined with \ref prefetch_ahead, since tasks prefetch for themselves.
+ */
+struct interleave_tag {};
+template <unsigned Width = 8>
+struct interleave : public trait_has_type<bool>, interleave_tag {
+  static_assert(Width > 0, "interleave width must be positive");
+  constexpr static unsigned width = Width;
+};
+
+/**
+ * Indicates that the items of a \ref katana::do_all are the nodes of a graph
+ * and that each thread should start with a block of nodes that have about
+ * the same number of edges, rather than the same number of nodes, so that on
+ * graphs with skewed degrees a few threads do not get most of the edges. The
+ * range must be numeric, e.g., <code>katana::iterate(graph)</code>. With
+ * \ref steal, threads that run out of work steal nodes as usual.
+ *
+ * T is a function <code>uint64_t (N)</code> that returns the number of edges
+ * of the nodes before node N, i.e., the edge prefix sum of the graph.
+ */
+struct edge_balanced_tag {};
+template <typename T>
+struct edge_balanced_by : public trait_has_value<T>, edge_balanced_tag {
+  edge_balanced_by(const T& t = T()) : trait_has_value<T>(t) {}
+  edge_balanced_by(T&& t) : trait_has_value<T>(std::move(t)) {}
+};
+
+/**
+ * Make an \ref edge_balanced_by option for the nodes of \param topology, a
+ * graph or topology with <code>num_nodes()</code>, <code>num_edges()</code>
+ * and <code>edges(node)</code>, which must outlive the loop
+ */
+template <typename Topology>
+auto
+edge_balanced(const Topology& topology) {
+  auto edges_before = [&topology](uint64_t node) -> uint64_t {
+    using Node = typename Topology::Node;
+    return node < topology.num_nodes()
+               ? *topology.edges(static_cast<Node>(node)).begin()
+               : topology.num_edges();
+  };
+  return edge_balanced_by<decltype(edges_before)>(std::move(edges_before));
+}
+
 // TODO: separate to libdist
 /** For distributed Galois **/
 struct op_tag {};
@@ -124,6 +124,35 @@ public:
     return std::get<prop_index>(edge_view_).GetValue(*edge);
   }
 
+  /**
+   * Gets the view of a node property, e.g., to loop over its values with
+   * data() and size().
+   *
+   * @returns reference to the property view
+   */
+  template <typename NodeIndex>
+  PropertyViewType<NodeIndex>& GetNodePropertyView() {
+    return std::get<find_trait<NodeIndex, NodeProps>()>(node_view_);
+  }
+  template <typename NodeIndex>
+  const PropertyViewType<NodeIndex>& GetNodePropertyView() const {
+    return std::get<find_trait<NodeIndex, NodeProps>()>(node_view_);
+  }
+
+  /**
+   * Gets the view of an edge property.
+   *
+   * @returns reference to the property view
+   */
+  template <typename EdgeIndex>
+  PropertyViewType<EdgeIndex>& GetEdgePropertyView() {
+    return std::get<find_trait<EdgeIndex, EdgeProps>()>(edge_view_);
+  }
+  template <typename EdgeIndex>
+  const PropertyViewType<EdgeIndex>& GetEdgePropertyView() const {
+    return std::get<find_trait<EdgeIndex, EdgeProps>()>(edge_view_);
+  }
+
   /**
    * Gets the destination for an edge.
    *
@@ -213,6 +242,25 @@ Result<TypedPropertyGraph<NodeProps, EdgeProps>>
 TypedPropertyGraph<NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  // Views address the values of each property as one contiguous buffer
+  if (auto res = pg->CoalesceNodeProperties(node_properties); !res) {
+    return res.error();
+  }
+  if (auto res = pg->CoalesceEdgeProperties(edge_properties); !res) {
+    return res.error();
+  }
+  // Properties shared with a copy of pg are read-only until copied
+  if (auto res = pg->EnsureNodePropertiesMutable(
+          internal::WritableProperties<NodeProps>(node_properties));
+      !res) {
+    return res.error();
+  }
+  if (auto res = pg->EnsureEdgePropertiesMutable(
+          internal::WritableProperties<EdgeProps>(edge_properties));
+      !res) {
+    return res.error();
+  }
+
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
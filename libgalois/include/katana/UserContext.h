@@ -125,11 +125,16 @@ public:
 
   //! declare that the operator has crossed the cautious point.  This
   //! implies all data has been touched thus no new locks will be
-  //! acquired.
+  //! acquired. Optimistic reads are validated here, before the operator
+  //! writes anything.
   void cautiousPoint() {
     if (isFirstPass()) {
       katana::signalFailSafe();
     }
+    SimpleRuntimeContext* ctx = getThreadContext();
+    if (ctx && ctx->isOptimistic()) {
+      ctx->validateReads();
+    }
   }
 };
 
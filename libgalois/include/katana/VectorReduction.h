@@ -0,0 +1,357 @@
+#ifndef KATANA_LIBGALOIS_KATANA_VECTORREDUCTION_H_
+#define KATANA_LIBGALOIS_KATANA_VECTORREDUCTION_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "katana/LoopsDecl.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/config.h"
+#include "katana/gstl.h"
+
+namespace katana {
+
+/**
+ * A VectorReducible reduces a vector of size() values of type T, such as a
+ * histogram or per-community sums, element by element.
+ *
+ * Each thread starts with a small hash table of the elements it updated and
+ * switches to a dense copy of the vector once it updated more than a
+ * sparse_fraction of the elements. reduce() combines the copies of the
+ * threads of each socket on that socket and then the socket results into
+ * one vector, both steps in parallel over blocks of the elements, so that
+ * each copy crosses sockets at most once.
+ *
+ * MergeFunc and IdFunc are as for Reducible, except that MergeFunc must
+ * take and return values:
+ *
+ *   T operator()(const T& lhs, const T& rhs)
+ *
+ * An example:
+ *
+ *   GVectorAccumulator<uint64_t> histogram(num_bins);
+ *   katana::do_all(katana::iterate(graph), [&](auto n) {
+ *     histogram.update(Bin(n), 1);
+ *   });
+ *   const std::vector<uint64_t>& counts = histogram.reduce();
+ */
+template <typename T, typename MergeFunc, typename IdFunc>
+class VectorReducible : public MergeFunc, public IdFunc {
+  static constexpr uint64_t kEmpty = 0;
+  static constexpr size_t kMinCapacity = 64;
+
+  /// The updates of one thread
+  struct Local {
+    /// All elements, once the thread has promoted to dense
+    std::vector<T> dense;
+    /// Open addressing table of index + 1 (kEmpty if unused) and value
+    std::vector<uint64_t> keys;
+    std::vector<T> values;
+    size_t num_sparse{0};
+    /// The table sorted by index, for reduce()
+    std::vector<std::pair<uint64_t, T>> sorted;
+  };
+
+  /// What reduce() merges: a dense vector or sorted sparse updates
+  struct Source {
+    const T* dense{nullptr};
+    const std::vector<std::pair<uint64_t, T>>* sparse{nullptr};
+    unsigned socket{0};
+  };
+
+  size_t size_;
+  size_t sparse_limit_;
+  PerThreadStorage<Local> data_;
+  PerSocketStorage<std::vector<T>> socket_values_;
+  std::vector<T> result_;
+
+  void merge(T& lhs, const T& rhs) { lhs = MergeFunc::operator()(lhs, rhs); }
+
+  static size_t Slot(uint64_t key, size_t capacity) {
+    // Fibonacci hashing spreads runs of consecutive indices
+    return ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (capacity - 1);
+  }
+
+  void Promote(Local& local) {
+    local.dense.assign(size_, IdFunc::operator()());
+    for (size_t s = 0; s < local.keys.size(); ++s) {
+      if (local.keys[s] != kEmpty) {
+        merge(local.dense[local.keys[s] - 1], local.values[s]);
+      }
+    }
+    local.keys = std::vector<uint64_t>();
+    local.values = std::vector<T>();
+    local.num_sparse = 0;
+  }
+
+  void Grow(Local& local) {
+    size_t capacity = std::max(kMinCapacity, 2 * local.keys.size());
+    std::vector<uint64_t> keys(capacity, kEmpty);
+    std::vector<T> values(capacity);
+    for (size_t s = 0; s < local.keys.size(); ++s) {
+      if (local.keys[s] == kEmpty) {
+        continue;
+      }
+      size_t slot = Slot(local.keys[s], capacity);
+      while (keys[slot] != kEmpty) {
+        slot = (slot + 1) & (capacity - 1);
+      }
+      keys[slot] = local.keys[s];
+      values[slot] = std::move(local.values[s]);
+    }
+    local.keys = std::move(keys);
+    local.values = std::move(values);
+  }
+
+  void UpdateSparse(Local& local, size_t index, const T& rhs) {
+    uint64_t key = index + 1;
+    size_t capacity = local.keys.size();
+    if (capacity > 0) {
+      for (size_t slot = Slot(key, capacity);;
+           slot = (slot + 1) & (capacity - 1)) {
+        if (local.keys[slot] == key) {
+          merge(local.values[slot], rhs);
+          return;
+        }
+        if (local.keys[slot] == kEmpty) {
+          break;
+        }
+      }
+    }
+
+    // A new element; keep the table at most half full
+    if (local.num_sparse + 1 > sparse_limit_) {
+      Promote(local);
+      merge(local.dense[index], rhs);
+      return;
+    }
+    if (2 * (local.num_sparse + 1) > capacity) {
+      Grow(local);
+      capacity = local.keys.size();
+    }
+    size_t slot = Slot(key, capacity);
+    while (local.keys[slot] != kEmpty) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    local.keys[slot] = key;
+    local.values[slot] = IdFunc::operator()();
+    merge(local.values[slot], rhs);
+    local.num_sparse += 1;
+  }
+
+  /// Merge the elements [begin, end) of source into out
+  void MergeRange(const Source& source, T* out, size_t begin, size_t end) {
+    if (source.dense) {
+      for (size_t i = begin; i < end; ++i) {
+        merge(out[i], source.dense[i]);
+      }
+      return;
+    }
+    const auto& sparse = *source.sparse;
+    auto it = std::lower_bound(
+        sparse.begin(), sparse.end(), begin,
+        [](const std::pair<uint64_t, T>& e, size_t i) { return e.first < i; });
+    for (; it != sparse.end() && it->first < end; ++it) {
+      merge(out[it->first], it->second);
+    }
+  }
+
+  void Sort(Local& local) {
+    if (local.num_sparse == 0 || !local.sorted.empty()) {
+      return;
+    }
+    local.sorted.reserve(local.num_sparse);
+    for (size_t s = 0; s < local.keys.size(); ++s) {
+      if (local.keys[s] != kEmpty) {
+        local.sorted.emplace_back(local.keys[s] - 1, local.values[s]);
+      }
+    }
+    std::sort(
+        local.sorted.begin(), local.sorted.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+  }
+
+  void ResetLocal(Local& local) {
+    // Dense copies are kept for the next round
+    std::fill(local.dense.begin(), local.dense.end(), IdFunc::operator()());
+    std::fill(local.keys.begin(), local.keys.end(), kEmpty);
+    local.num_sparse = 0;
+    local.sorted.clear();
+  }
+
+public:
+  using value_type = T;
+
+  /// \param size the number of elements
+  /// \param sparse_fraction threads that update more than this fraction of
+  /// the elements switch to dense copies
+  VectorReducible(
+      size_t size, MergeFunc merge_func, IdFunc id_func,
+      double sparse_fraction = 1.0 / 16)
+      : MergeFunc(merge_func),
+        IdFunc(id_func),
+        size_(size),
+        sparse_limit_(static_cast<size_t>(sparse_fraction * size)) {}
+
+  size_t size() const { return size_; }
+
+  /**
+   * Merges rhs into element index of the thread local values
+   */
+  void update(size_t index, const T& rhs) {
+    Local& local = *data_.getLocal();
+    if (!local.dense.empty()) {
+      merge(local.dense[index], rhs);
+    } else {
+      UpdateSparse(local, index, rhs);
+    }
+  }
+
+  /**
+   * Returns the reduced vector and resets the thread local values. Only
+   * valid outside the parallel region; the vector stays valid until the
+   * next call.
+   */
+  const std::vector<T>& reduce() {
+    auto& tp = GetThreadPool();
+    unsigned num_threads = data_.size();
+    unsigned active = getActiveThreads();
+
+    // Sort the sparse updates of each thread so that they can be merged by
+    // block
+    on_each([&](unsigned, unsigned) { Sort(*data_.getLocal()); });
+
+    std::vector<Source> sources;
+    for (unsigned t = 0; t < num_threads; ++t) {
+      Local& local = *data_.getRemote(t);
+      // Threads that are not active now may have updated before
+      if (t >= active) {
+        Sort(local);
+      }
+      if (!local.dense.empty()) {
+        sources.emplace_back(Source{local.dense.data(), nullptr, 0});
+      } else if (!local.sorted.empty()) {
+        sources.emplace_back(Source{nullptr, &local.sorted, 0});
+      } else {
+        continue;
+      }
+      sources.back().socket = tp.getSocket(t);
+    }
+
+    // Combine the sources of each socket with several of them on the
+    // active threads of that socket
+    unsigned num_sockets = tp.getMaxSockets();
+    std::vector<unsigned> num_sources(num_sockets);
+    std::vector<unsigned> num_workers(num_sockets);
+    std::vector<unsigned> rank(active);
+    for (const Source& source : sources) {
+      num_sources[source.socket] += 1;
+    }
+    for (unsigned t = 0; t < active; ++t) {
+      rank[t] = num_workers[tp.getSocket(t)]++;
+    }
+    std::vector<bool> combined(num_sockets);
+    bool any_combined = false;
+    for (unsigned s = 0; s < num_sockets; ++s) {
+      combined[s] = num_sockets > 1 && num_sources[s] > 1 && num_workers[s] > 0;
+      any_combined = any_combined || combined[s];
+    }
+    if (any_combined) {
+      // The leader of each socket allocates its vector, so that it is on
+      // the socket, and keeps it for later rounds
+      on_each([&](unsigned tid, unsigned) {
+        if (combined[tp.getSocket(tid)] && tp.isLeader(tid)) {
+          socket_values_.getLocal()->resize(size_);
+        }
+      });
+      on_each([&](unsigned tid, unsigned) {
+        unsigned socket = tp.getSocket(tid);
+        if (!combined[socket]) {
+          return;
+        }
+        std::vector<T>& values = *socket_values_.getLocal();
+        auto [begin, end] =
+            block_range(size_t{0}, size_, rank[tid], num_workers[socket]);
+        std::fill(
+            values.begin() + begin, values.begin() + end,
+            IdFunc::operator()());
+        for (const Source& source : sources) {
+          if (source.socket == socket) {
+            MergeRange(source, values.data(), begin, end);
+          }
+        }
+      });
+    }
+
+    std::vector<Source> socket_sources;
+    for (const Source& source : sources) {
+      if (!combined[source.socket]) {
+        socket_sources.emplace_back(source);
+      }
+    }
+    for (unsigned s = 0; s < num_sockets; ++s) {
+      if (combined[s]) {
+        socket_sources.emplace_back(
+            Source{socket_values_.getRemoteByPkg(s)->data(), nullptr, s});
+      }
+    }
+
+    result_.resize(size_);
+    on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = block_range(size_t{0}, size_, tid, total);
+      std::fill(
+          result_.begin() + begin, result_.begin() + end,
+          IdFunc::operator()());
+      for (const Source& source : socket_sources) {
+        MergeRange(source, result_.data(), begin, end);
+      }
+    });
+    // Only once no thread reads the sources anymore
+    on_each([&](unsigned, unsigned) { ResetLocal(*data_.getLocal()); });
+    for (unsigned t = active; t < num_threads; ++t) {
+      ResetLocal(*data_.getRemote(t));
+    }
+
+    return result_;
+  }
+
+  /**
+   * Discards the thread local values
+   */
+  void reset() {
+    for (unsigned t = 0; t < data_.size(); ++t) {
+      ResetLocal(*data_.getRemote(t));
+    }
+  }
+};
+
+/**
+ * make_vector_reducible creates a VectorReducible of size elements from a
+ * merge function and identity function.
+ */
+template <typename MergeFn, typename IdFn>
+auto
+make_vector_reducible(size_t size, const MergeFn& mergeFn, const IdFn& idFn) {
+  return VectorReducible<std::invoke_result_t<IdFn>, MergeFn, IdFn>(
+      size, mergeFn, idFn);
+}
+
+//! Vector accumulator, e.g. a histogram, where accumulation is plus
+template <typename T>
+class GVectorAccumulator
+    : public VectorReducible<T, std::plus<T>, identity_value_zero<T>> {
+  using base_type = VectorReducible<T, std::plus<T>, identity_value_zero<T>>;
+
+public:
+  explicit GVectorAccumulator(size_t size)
+      : base_type(size, std::plus<T>(), identity_value_zero<T>()) {}
+};
+
+}  // namespace katana
+#endif
@@ -22,13 +22,16 @@
 
 #include <optional>
 
+#include "katana/AdaptiveObim.h"
 #include "katana/BulkSynchronous.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
 #include "katana/PerThreadChunk.h"
+#include "katana/PerThreadChunkDeque.h"
 #include "katana/Simple.h"
 #include "katana/StableIterator.h"
 #include "katana/config.h"
@@ -38,8 +41,13 @@ namespace katana {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
  * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
- * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
+ * use \ref OrderedByIntegerMetric, \ref AdaptiveOrderedByIntegerMetric when
+ * a good bucket width is not known in advance, or \ref MultiQueue when
+ * priorities are not naturally integers (e.g., floating-point distances).
+ * For debugging, you may be interested in \ref FIFO or \ref LIFO, which try
+ * to follow serial order exactly. When work is highly skewed across threads,
+ * \ref PerThreadChunkDeque avoids contention on shared socket-level queues by
+ * stealing between per-thread deques.
  *
  * The way to use a worklist is to pass it as a template parameter to
  * \ref for_each(). For example,
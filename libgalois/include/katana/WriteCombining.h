@@ -0,0 +1,120 @@
+#ifndef KATANA_LIBGALOIS_KATANA_WRITECOMBINING_H_
+#define KATANA_LIBGALOIS_KATANA_WRITECOMBINING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+
+namespace katana {
+
+/// Buffers the additions of one thread to an array of atomic counters, e.g.,
+/// the residuals of push-style PageRank, and applies them in batches.
+///
+/// The counters are divided into blocks of consecutive indices and each
+/// block has a small buffer of pending additions. A buffer that fills up is
+/// sorted by index, additions to the same counter are summed, and each sum
+/// is added to its counter with one katana::atomicAdd. Popular counters thus
+/// see one atomic per batch rather than one per addition, which removes most
+/// of the compare-and-swap retries of floating-point atomicAdd, and a batch
+/// touches only the cache lines of its block.
+///
+/// Additions are only visible once they are applied, so every thread must
+/// call Flush before the counters are read. Use one buffer per thread, e.g.,
+/// in a katana::PerThreadStorage, and flush with katana::on_each.
+///
+/// \tparam T the type of the counters
+/// \tparam Target a callable that returns the std::atomic<T>& of an index
+template <typename T, typename Target>
+class WriteCombiningBuffer {
+public:
+  /// Blocks per buffer; with the default capacity, 64 KiB of float updates
+  static constexpr uint32_t kDefaultNumBlocks = 256;
+  /// Pending additions per block
+  static constexpr uint32_t kDefaultBlockCapacity = 32;
+
+  WriteCombiningBuffer(
+      Target target, uint64_t num_targets,
+      uint32_t num_blocks = kDefaultNumBlocks,
+      uint32_t block_capacity = kDefaultBlockCapacity)
+      : target_(std::move(target)), capacity_(std::max(block_capacity, 1U)) {
+    num_blocks = std::max(num_blocks, 1U);
+    while ((num_targets >> shift_) > num_blocks) {
+      ++shift_;
+    }
+    uint64_t blocks = num_targets > 0 ? ((num_targets - 1) >> shift_) + 1 : 1;
+    updates_.resize(blocks * capacity_);
+    sizes_.assign(blocks, 0);
+  }
+
+  /// Add value to the counter of index. When the additions to the block of
+  /// index are applied, applied(index, old, sum) is called for each counter
+  /// they change, with the value old of the counter before sum was added.
+  template <typename Fn>
+  void Add(uint32_t index, T value, const Fn& applied) {
+    uint64_t block = index >> shift_;
+    uint32_t& size = sizes_[block];
+    updates_[block * capacity_ + size] = Update{index, value};
+    if (++size == capacity_) {
+      FlushBlock(block, applied);
+    }
+  }
+
+  void Add(uint32_t index, T value) {
+    Add(index, value, [](uint32_t, T, T) {});
+  }
+
+  /// Apply all pending additions
+  template <typename Fn>
+  void Flush(const Fn& applied) {
+    for (uint64_t block = 0; block < sizes_.size(); ++block) {
+      if (sizes_[block] > 0) {
+        FlushBlock(block, applied);
+      }
+    }
+  }
+
+  void Flush() {
+    Flush([](uint32_t, T, T) {});
+  }
+
+private:
+  struct Update {
+    uint32_t index;
+    T value;
+  };
+
+  template <typename Fn>
+  void FlushBlock(uint64_t block, const Fn& applied) {
+    Update* begin = &updates_[block * capacity_];
+    Update* end = begin + sizes_[block];
+    std::sort(begin, end, [](const Update& a, const Update& b) {
+      return a.index < b.index;
+    });
+    for (Update* u = begin; u != end;) {
+      uint32_t index = u->index;
+      T sum = u->value;
+      for (++u; u != end && u->index == index; ++u) {
+        sum += u->value;
+      }
+      T old = katana::atomicAdd(target_(index), sum);
+      applied(index, old, sum);
+    }
+    sizes_[block] = 0;
+  }
+
+  Target target_;
+  uint32_t capacity_;
+  /// Block b holds the indices [b << shift_, (b + 1) << shift_)
+  unsigned shift_{0};
+  /// The pending additions of block b start at b * capacity_
+  std::vector<Update> updates_;
+  std::vector<uint32_t> sizes_;
+};
+
+}  // namespace katana
+
+#endif
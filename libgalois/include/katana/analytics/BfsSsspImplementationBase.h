@@ -23,7 +23,9 @@
 #include <atomic>
 #include <cstdlib>
 #include <iostream>
+#include <utility>
 
+#include "katana/Bag.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -170,6 +172,21 @@ struct BfsSsspImplementationBase {
     }
   };
 
+  /// Push with P and also log the node pushed in touched. The kernels push
+  /// every node whose distance they lower, so touched ends up holding every
+  /// node they wrote (see AnalyticsWorkspace::TouchedNodes).
+  template <typename P>
+  struct TouchLoggingPushWrap {
+    P push;
+    katana::InsertBag<uint32_t>* touched;
+
+    template <typename C, typename... Args>
+    void operator()(C& cont, const GNode& n, Args&&... args) const {
+      touched->push(n);
+      push(cont, n, std::forward<Args>(args)...);
+    }
+  };
+
   struct OutEdgeRangeFn {
     Graph* graph;
     auto operator()(const GNode& n) const { return graph->edges(n); }
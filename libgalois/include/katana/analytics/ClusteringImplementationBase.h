@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <random>
@@ -27,6 +29,8 @@
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/SmallHashMap.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -55,55 +59,119 @@ struct ClusteringImplementationBase {
   using EdgeTy = _EdgeType;
   using CommunityType = _CommunityType;
 
+  //! Temporaries of loop bodies, allocated from per-thread arenas
+  using ClusterVec = std::vector<uint64_t, katana::ArenaAllocator<uint64_t>>;
+  using CounterVec = std::vector<EdgeTy, katana::ArenaAllocator<EdgeTy>>;
+  using ClusterWeightVec = std::vector<
+      std::pair<uint64_t, EdgeTy>,
+      katana::ArenaAllocator<std::pair<uint64_t, EdgeTy>>>;
+  //! Total edge weight per cluster; small enough to stay inline for most
+  //! nodes
+  using ClusterWeightMap = katana::SmallHashMap<
+      uint64_t, EdgeTy, 16, std::hash<uint64_t>,
+      katana::ArenaAllocator<std::pair<uint64_t, EdgeTy>>>;
+
   constexpr static const uint64_t UNASSIGNED =
       std::numeric_limits<uint64_t>::max();
 
   using CommunityArray = katana::LargeArray<CommunityType>;
 
+  /**
+   * Calls fn(cluster, total weight) once for each cluster in weights, in
+   * increasing order of cluster, so that ties between clusters are broken
+   * the same way whatever the layout of the map. Only the distinct clusters
+   * are sorted, not every edge.
+   */
+  template <typename Fn>
+  static void ForEachClusterWeight(const ClusterWeightMap& weights, Fn fn) {
+    ClusterWeightVec sorted(
+        weights.begin(), weights.end(), weights.get_allocator());
+    std::sort(
+        sorted.begin(), sorted.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [cluster, total] : sorted) {
+      fn(cluster, total);
+    }
+  }
+
+  /**
+   * Groups the nodes of graph by their current cluster with a parallel
+   * counting sort: the nodes of cluster c are stored in
+   * members[offsets[c], offsets[c + 1]), in no particular order. Nodes
+   * whose cluster is UNASSIGNED are left out.
+   */
+  static void GroupNodesByCluster(
+      const Graph& graph, uint64_t num_clusters,
+      katana::LargeArray<uint64_t>* offsets,
+      katana::LargeArray<GNode>* members) {
+    katana::LargeArray<std::atomic<uint64_t>> counts;
+    counts.allocateBlocked(num_clusters);
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_clusters),
+        [&](uint64_t c) { counts.constructAt(c, 0); });
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
+      if (n_data_curr_comm_id != UNASSIGNED) {
+        counts[n_data_curr_comm_id].fetch_add(1);
+      }
+    });
+
+    offsets->allocateBlocked(num_clusters + 1);
+    (*offsets)[0] = 0;
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_clusters),
+        [&](uint64_t c) { (*offsets)[c + 1] = counts[c].exchange(0); });
+    katana::ParallelSTL::partial_sum(
+        offsets->begin(), offsets->end(), offsets->begin());
+
+    members->allocateBlocked((*offsets)[num_clusters]);
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
+      if (n_data_curr_comm_id != UNASSIGNED) {
+        (*members)
+            [(*offsets)[n_data_curr_comm_id] +
+             counts[n_data_curr_comm_id].fetch_add(1)] = n;
+      }
+    });
+  }
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It lists the clusters of neighboring nodes in clusters, starting with
+   * the current cluster of n, their total edge weights in counter as well
+   * as total weight of self edges in self_loop_wt.
    */
   template <typename EdgeWeightType>
   void FindNeighboringClusters(
-      const Graph& graph, GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
+      const Graph& graph, GNode& n, ClusterVec& clusters, CounterVec& counter,
+      EdgeTy& self_loop_wt) {
+    uint64_t n_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
 
-    // Add the node's current cluster to be considered
-    // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityId>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
-
-    // Assuming we have grabbed lock on all the neighbors
+    ClusterWeightMap weights(clusters.get_allocator());
     for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
       auto dst = graph.GetEdgeDest(ii);
-      auto edge_wt = graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(
-          ii);  // Self loop weights is recorded
+      auto edge_wt =
+          graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
       if (*dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityId>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
+      weights[graph.template GetData<CurrentCommunityId>(dst)] += edge_wt;
+    }  // End edge loop
+
+    // Add the node's current cluster to be considered
+    // for movement as well
+    clusters.push_back(n_curr_comm_id);
+    counter.push_back(0);
+    ForEachClusterWeight(weights, [&](uint64_t cluster, EdgeTy total) {
+      if (cluster == n_curr_comm_id) {
+        counter[0] += total;
       } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityId>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
+        clusters.push_back(cluster);
+        counter.push_back(total);
       }
-    }  // End edge loop
-    return;
+    });
   }
 
   /**
@@ -207,9 +275,9 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
-      CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
+      const ClusterVec& clusters, const CounterVec& counter,
+      uint64_t self_loop_wt, CommunityArray& c_info, EdgeTy degree_wt,
+      uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
     double max_gain = 0;
@@ -218,33 +286,30 @@ struct ClusteringImplementationBase {
     double eiy = 0;
     double ay = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        ay = c_info[stored_already->first].degree_wt;  // Degree wt of cluster y
-
-        if (ay < (ax + degree_wt)) {
-          stored_already++;
-          continue;
-        } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-          stored_already++;
-          continue;
-        }
+    for (size_t i = 0; i < clusters.size(); ++i) {  // Explore each cluster
+      uint64_t cluster = clusters[i];
+      if (sc == cluster) {
+        continue;
+      }
+      ay = c_info[cluster].degree_wt;  // Degree wt of cluster y
 
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        cur_gain = 2 * constant * (eiy - eix) +
-                   2 * degree_wt * ((ax - ay) * constant * constant);
+      if (ay < (ax + degree_wt)) {
+        continue;
+      } else if (ay == (ax + degree_wt) && cluster > sc) {
+        continue;
+      }
 
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+      eiy = counter[i];  // Total edges incident on cluster y
+      cur_gain = 2 * constant * (eiy - eix) +
+                 2 * degree_wt * ((ax - ay) * constant * constant);
+
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) &&
+           (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -400,25 +465,43 @@ struct ClusteringImplementationBase {
  * to fill the holes in the cluster id assignments.
  */
   uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    uint64_t num_nodes = graph->num_nodes();
+    if (num_nodes == 0) {
+      return 0;
+    }
 
-    for (GNode n = 0; n < graph->num_nodes(); ++n) {
+    // Clusters are numbered in the order of their first node, i.e., the
+    // order in which a scan over the nodes would first see them
+    katana::LargeArray<std::atomic<uint64_t>> first_node;
+    first_node.allocateBlocked(num_nodes);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      first_node.constructAt(n, UNASSIGNED);
+    });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph->template GetData<CurrentCommunityId>(n);
+      if (n_data_curr_comm_id != UNASSIGNED) {
+        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < num_nodes);
+        katana::atomicMin(first_node[n_data_curr_comm_id], uint64_t{n});
+      }
+    });
+
+    katana::LargeArray<uint64_t> rank;
+    rank.allocateBlocked(num_nodes);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph->template GetData<CurrentCommunityId>(n);
+      rank[n] = n_data_curr_comm_id != UNASSIGNED &&
+                first_node[n_data_curr_comm_id] == n;
+    });
+    katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id =
           graph->template GetData<CurrentCommunityId>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < graph->num_nodes());
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already != cluster_local_map.end()) {
-          n_data_curr_comm_id = stored_already->second;
-        } else {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          n_data_curr_comm_id = num_unique_clusters;
-          num_unique_clusters++;
-        }
+        n_data_curr_comm_id = rank[first_node[n_data_curr_comm_id]] - 1;
       }
-    }
-    return num_unique_clusters;
+    });
+    return rank[num_nodes - 1];
   }
 
   template <typename EdgeWeightType>
@@ -538,49 +621,50 @@ struct ClusteringImplementationBase {
     uint64_t num_nodes_next = num_unique_clusters;
     uint64_t num_edges_next = 0;  // Unknown right now
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // Comment: Serial separation is better than do_all due to contention
-    for (GNode n = 0; n < graph.num_nodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
-      if (n_data_curr_comm_id != UNASSIGNED)
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-    }
+    katana::LargeArray<uint64_t> cluster_offsets;
+    katana::LargeArray<GNode> cluster_members;
+    GroupNodesByCluster(
+        graph, num_unique_clusters, &cluster_offsets, &cluster_members);
 
     std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
     std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
 
     /* First pass to find the number of edges */
+    katana::PerThreadArena arena;
     katana::do_all(
         katana::iterate((uint64_t)0, num_unique_clusters),
         [&](uint64_t c) {
-          std::map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto cb_ii = cluster_bags[c].begin();
-               cb_ii != cluster_bags[c].end(); ++cb_ii) {
+          katana::ArenaScope scope{arena};
+          ClusterWeightMap weights(
+              scope.allocator<typename ClusterWeightMap::value_type>());
+
+          // Visit members in node order so that the result does not depend
+          // on the order of the counting sort
+          GNode* members_begin = cluster_members.data() + cluster_offsets[c];
+          GNode* members_end = members_begin +
+                               (cluster_offsets[c + 1] - cluster_offsets[c]);
+          std::sort(members_begin, members_end);
+          for (GNode* member = members_begin; member != members_end;
+               ++member) {
             KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityId>(*cb_ii) ==
+                graph.template GetData<CurrentCommunityId>(*member) ==
                 c);  // All nodes in this bag must have same cluster id
 
-            for (auto ii = graph.edge_begin(*cb_ii);
-                 ii != graph.edge_end(*cb_ii); ++ii) {
+            for (auto ii = graph.edge_begin(*member);
+                 ii != graph.edge_end(*member); ++ii) {
               auto dst = graph.GetEdgeDest(ii);
               auto dst_data_curr_comm_id =
                   graph.template GetData<CurrentCommunityId>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
+              weights[dst_data_curr_comm_id] +=
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
             }  // End edge loop
           }
+
+          ForEachClusterWeight(weights, [&](uint64_t cluster, EdgeTy total) {
+            edges_id[c].push_back(cluster);
+            edges_data[c].push_back(total);
+          });
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
@@ -0,0 +1,86 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_FUSEDSCAN_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_FUSEDSCAN_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/GraphStats.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The graph-wide results of FusedScan::Run; the per-node results are in
+/// the node properties the kernels were registered with
+struct KATANA_EXPORT FusedScanSummary {
+  /// Set if out-degrees were computed
+  std::optional<DegreeStats> out_degree;
+  /// Set if in-degrees were computed
+  std::optional<DegreeStats> in_degree;
+  /// The number of triangles of the graph, if triangles or local clustering
+  /// coefficients were computed
+  std::optional<uint64_t> num_triangles;
+};
+
+/// Computes several per-node metrics in one parallel scan of the topology
+/// rather than one scan per analytic, for jobs whose analytics are bound by
+/// memory bandwidth. Kernels are registered with the Add methods, each with
+/// the name of the node property its results are written to, and Run visits
+/// every node once, reading its edges once for all of the kernels:
+///
+/// - out-degrees come from the edge ranges and in-degrees are counted from
+///   the destinations of the edges;
+/// - Jaccard similarities with a compare node, as computed by Jaccard, count
+///   the destinations of each node that are neighbors of the compare node
+///   in a bitmap, so the edges need not be sorted;
+/// - triangles and local clustering coefficients, as computed by
+///   LocalClusteringCoefficient, intersect out-neighbors in the orientation
+///   of the topology by degree (see PropertyGraph::OrientByDegree), which is
+///   kept with the topology, so the topology must be symmetric.
+///
+/// Coefficients and degree statistics are derived from the counts of the
+/// scan by a pass over the nodes only. Iterative analytics such as PageRank
+/// read the topology once per round and cannot share a single scan.
+class KATANA_EXPORT FusedScan {
+public:
+  /// The uint64 number of out-edges of each node
+  FusedScan& AddOutDegree(const std::string& property);
+
+  /// The uint64 number of in-edges of each node
+  FusedScan& AddInDegree(const std::string& property);
+
+  /// The double Jaccard similarity between each node and compare_node. May
+  /// be registered for several compare nodes.
+  FusedScan& AddJaccard(uint32_t compare_node, const std::string& property);
+
+  /// The uint64 number of triangles that contain each node
+  FusedScan& AddTriangleCount(const std::string& property);
+
+  /// The double local clustering coefficient of each node, 0 for nodes with
+  /// fewer than two edges
+  FusedScan& AddLocalClusteringCoefficient(const std::string& property);
+
+  /// Run the registered kernels over pg and add their node properties,
+  /// which must not exist before the call. Degree statistics are binned as
+  /// with num_bins in GraphStatsOptions.
+  Result<FusedScanSummary> Run(PropertyGraph* pg, uint32_t num_bins = 0) const;
+
+private:
+  struct JaccardKernel {
+    uint32_t compare_node;
+    std::string property;
+  };
+
+  std::string out_degree_property_;
+  std::string in_degree_property_;
+  std::vector<JaccardKernel> jaccard_kernels_;
+  std::string triangle_property_;
+  std::string clustering_property_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSAMPLING_H_
+
+#include <cstdint>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/Subgraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A computational plan for SampleSubgraph, which draws a smaller graph
+/// that is representative of a larger one, e.g., to estimate statistics or
+/// to tune the plans of analytics before running them on the whole graph.
+///
+/// Samplers keep a fraction of the nodes or of the edges of the graph.
+/// Random choices are drawn from independent streams seeded by seed and the
+/// ID of the node, edge or exploration they decide, so the node and edge
+/// samplers return the same sample for any number of threads. The
+/// exploration samplers (kForestFire, kSnowball and kRandomWalk) run one
+/// exploration per thread, so their sample depends on the schedule unless
+/// the plan is deterministic, in which case they run one at a time.
+///
+///   Jure Leskovec and Christos Faloutsos. Sampling from Large Graphs.
+///   KDD 2006.
+///   Nesreen K. Ahmed, Jennifer Neville, and Ramana Kompella. Network
+///   Sampling: From Static to Streaming Graphs. TKDD 2014.
+class GraphSamplingPlan : public Plan {
+public:
+  enum Algorithm {
+    kRandomNode,
+    kRandomEdge,
+    kInducedEdge,
+    kForestFire,
+    kSnowball,
+    kRandomWalk,
+  };
+
+  static constexpr double kDefaultFraction = 0.1;
+  static constexpr double kDefaultBurnProbability = 0.7;
+  static const uint32_t kDefaultNeighborsPerNode = 3;
+  static constexpr double kDefaultRestartProbability = 0.15;
+  static const uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  double fraction_;
+  double burn_probability_;
+  uint32_t neighbors_per_node_;
+  double restart_probability_;
+  uint64_t seed_;
+
+  GraphSamplingPlan(
+      Architecture architecture, Algorithm algorithm, double fraction,
+      double burn_probability, uint32_t neighbors_per_node,
+      double restart_probability, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        fraction_(fraction),
+        burn_probability_(burn_probability),
+        neighbors_per_node_(neighbors_per_node),
+        restart_probability_(restart_probability),
+        seed_(seed) {}
+
+  GraphSamplingPlan(Algorithm algorithm, double fraction, uint64_t seed)
+      : GraphSamplingPlan(
+            kCPU, algorithm, fraction, kDefaultBurnProbability,
+            kDefaultNeighborsPerNode, kDefaultRestartProbability, seed) {}
+
+public:
+  GraphSamplingPlan() : GraphSamplingPlan(ForestFire()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The fraction of the edges kRandomEdge and kInducedEdge sample, and of
+  /// the nodes the other samplers sample
+  double fraction() const { return fraction_; }
+  /// The probability with which kForestFire burns each further neighbor
+  double burn_probability() const { return burn_probability_; }
+  /// The number of unvisited neighbors kSnowball adds from each node
+  uint32_t neighbors_per_node() const { return neighbors_per_node_; }
+  /// The probability with which each step of kRandomWalk returns to the
+  /// start of its walk
+  double restart_probability() const { return restart_probability_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Keep each node with probability fraction, and the edges among the kept
+  /// nodes. Degrees shrink by fraction, so the sample is sparser than the
+  /// graph.
+  static GraphSamplingPlan RandomNode(
+      double fraction = kDefaultFraction, uint64_t seed = kDefaultSeed) {
+    return {kRandomNode, fraction, seed};
+  }
+
+  /// Keep each edge with probability fraction, and the nodes it is incident
+  /// to. Both directions of an edge get the same coin, so samples of
+  /// symmetric graphs are symmetric. High degree nodes are more likely to
+  /// be kept.
+  static GraphSamplingPlan RandomEdge(
+      double fraction = kDefaultFraction, uint64_t seed = kDefaultSeed) {
+    return {kRandomEdge, fraction, seed};
+  }
+
+  /// Totally induced edge sampling (TIES): the nodes of kRandomEdge and
+  /// every edge among them, which preserves degrees and clustering better
+  /// than either kRandomNode or kRandomEdge.
+  static GraphSamplingPlan InducedEdge(
+      double fraction = kDefaultFraction, uint64_t seed = kDefaultSeed) {
+    return {kInducedEdge, fraction, seed};
+  }
+
+  /// Forest fire: from a random node, burn a geometrically distributed
+  /// number of its unvisited out-neighbors, with mean p / (1 - p) for
+  /// burn_probability p, and spread the fire from each of them. A new fire
+  /// starts at a random node when one dies out. The sample keeps the edges
+  /// among the burned nodes and matches the degree distribution and
+  /// diameter of the graph well.
+  static GraphSamplingPlan ForestFire(
+      double fraction = kDefaultFraction,
+      double burn_probability = kDefaultBurnProbability,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kForestFire,
+            fraction,
+            burn_probability,
+            kDefaultNeighborsPerNode,
+            kDefaultRestartProbability,
+            seed};
+  }
+
+  /// Snowball: a breadth first search that visits up to neighbors_per_node
+  /// random unvisited out-neighbors of each node, restarting at a random
+  /// node when it runs out. The sample keeps the edges among the visited
+  /// nodes.
+  static GraphSamplingPlan Snowball(
+      double fraction = kDefaultFraction,
+      uint32_t neighbors_per_node = kDefaultNeighborsPerNode,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kSnowball,
+            fraction,
+            kDefaultBurnProbability,
+            neighbors_per_node,
+            kDefaultRestartProbability,
+            seed};
+  }
+
+  /// Random walk with restart: walk from a random node to a random
+  /// out-neighbor at each step, returning to the start with
+  /// restart_probability, and start a new walk from a random node if the
+  /// walk stops finding new nodes. The sample keeps the edges among the
+  /// visited nodes.
+  static GraphSamplingPlan RandomWalk(
+      double fraction = kDefaultFraction,
+      double restart_probability = kDefaultRestartProbability,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kRandomWalk,
+            fraction,
+            kDefaultBurnProbability,
+            kDefaultNeighborsPerNode,
+            restart_probability,
+            seed};
+  }
+};
+
+/// Draw a sample of pg with the sampler of plan. Nodes and edges keep their
+/// relative order (see ExtractSubgraph), and the sample maps them back to
+/// pg and carries the requested properties. Exploration samplers follow
+/// out-edges and stop once they visit about fraction * pg.num_nodes()
+/// nodes.
+KATANA_EXPORT Result<Subgraph> SampleSubgraph(
+    const PropertyGraph& pg, GraphSamplingPlan plan = {},
+    const SubgraphProperties& properties = SubgraphProperties());
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSTATS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSTATS_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/JSON.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/PropertyStats.h"
+
+namespace katana::analytics {
+
+/// Parameters of GraphStats::Compute
+struct GraphStatsOptions {
+  /// Number of bins of equal width in the degree histograms; 0 bins degrees
+  /// by powers of two instead
+  uint32_t num_bins{0};
+  /// Estimate the neighborhood function and the diameter of the graph
+  bool estimate_diameter{true};
+  /// Each node gets a HyperLogLog counter of 2^log2_registers one byte
+  /// registers for the diameter estimate. The standard error of the counts
+  /// is about 1.04 / sqrt(2^log2_registers). Must be in [4, 16].
+  uint32_t log2_registers{6};
+  /// Stop the diameter estimate after this many hops
+  uint32_t max_hops{1000};
+  /// Include the statistics of the node and edge properties
+  bool summarize_properties{true};
+};
+
+/// The distribution of the out or in degrees of the nodes of a graph
+struct KATANA_EXPORT DegreeStats {
+  uint64_t min{0};
+  uint64_t max{0};
+  double mean{0};
+  double stddev{0};
+  /// The node with the largest degree; the smallest such node if several
+  uint32_t max_node{0};
+  /// Bin i counts the nodes whose degree is in [bin_starts[i],
+  /// bin_starts[i + 1]); the last bin ends after max
+  std::vector<uint64_t> bin_starts;
+  std::vector<uint64_t> counts;
+
+  /// The distribution of degrees[0, num_nodes), which were already counted,
+  /// e.g., by FusedScan, binned as with GraphStatsOptions::num_bins
+  static DegreeStats Compute(
+      const uint64_t* degrees, uint64_t num_nodes, uint32_t num_bins = 0);
+};
+
+/// An estimate of the neighborhood function of a graph computed with
+/// HyperLogLog counters (HyperANF)
+struct KATANA_EXPORT NeighborhoodStats {
+  /// Entry t estimates the number of pairs of nodes (u, v) such that v can be
+  /// reached from u in at most t hops
+  std::vector<double> pairs;
+  /// The number of hops after which no counter changed, which estimates the
+  /// diameter from below
+  uint32_t diameter{0};
+  /// The interpolated number of hops within which 90% of the reachable pairs
+  /// are reached
+  double effective_diameter{0};
+  /// True if the estimate stopped at GraphStatsOptions::max_hops
+  bool truncated{false};
+};
+
+/// The statistics of the values of a node or edge property. They are read
+/// from storage if they were stored with the property, which spares loading
+/// it; see PropertyGraph::GetNodePropertyStats.
+struct KATANA_EXPORT PropertyStatsSummary {
+  std::string name;
+  std::string type;
+  tsuba::ColumnStats stats;
+};
+
+/// Statistics of a property graph that help choose plans for it, e.g., its
+/// degree skew and its diameter. Degrees are counted in parallel and the
+/// diameter is estimated with sketches, in time linear in the number of
+/// edges per hop and memory linear in the number of nodes.
+struct KATANA_EXPORT GraphStats {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  DegreeStats out_degree;
+  DegreeStats in_degree;
+  std::optional<NeighborhoodStats> neighborhood;
+  std::vector<PropertyStatsSummary> node_properties;
+  std::vector<PropertyStatsSummary> edge_properties;
+
+  static katana::Result<GraphStats> Compute(
+      const katana::PropertyGraph& pg, const GraphStatsOptions& options = {});
+};
+
+KATANA_EXPORT void to_json(nlohmann::json& j, const DegreeStats& stats);
+KATANA_EXPORT void to_json(nlohmann::json& j, const NeighborhoodStats& stats);
+KATANA_EXPORT void to_json(
+    nlohmann::json& j, const PropertyStatsSummary& summary);
+KATANA_EXPORT void to_json(nlohmann::json& j, const GraphStats& stats);
+
+}  // namespace katana::analytics
+
+#endif
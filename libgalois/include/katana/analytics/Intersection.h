@@ -0,0 +1,46 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_INTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_INTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "katana/PropertyGraph.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+// The intersection routines below take two ranges of node ids, [a, a_end)
+// and [b, b_end), each of which must be strictly increasing, e.g., the
+// destinations of a node in a graph without parallel edges whose edges have
+// been sorted with SortAllEdgesByDest. They use AVX-512 or AVX2 when the
+// processor supports it and fall back to a scalar merge otherwise.
+
+/// Return the number of values that are in both [a, a_end) and [b, b_end).
+KATANA_EXPORT uint64_t CountSortedIntersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end);
+
+/// Write the values that are in both [a, a_end) and [b, b_end) to out in
+/// increasing order and return the number of values written. out must have
+/// room for min(a_end - a, b_end - b) values.
+KATANA_EXPORT size_t SortedIntersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end, uint32_t* out);
+
+/// Return the name of the instruction set used by the intersection routines
+/// on this processor: "avx512", "avx2" or "scalar".
+KATANA_EXPORT const char* SortedIntersectionKernel();
+
+/// Return the destinations of the edges of node as a contiguous range
+/// suitable for the intersection routines.
+inline std::pair<const uint32_t*, const uint32_t*>
+EdgeDestRange(const GraphTopology& topology, GraphTopology::Node node) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  auto [begin_edge, end_edge] = topology.edge_range(node);
+  return std::make_pair(dests + begin_edge, dests + end_edge);
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KHOP_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KHOP_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/SmallHashMap.h"
+#include "katana/analytics/Plan.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A computational plan for KHopExpander, which finds the nodes within k
+/// hops of many query nodes at once, e.g., to compute features of their
+/// ego networks online.
+class KHopPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Expand each query on one thread, deduplicating the nodes it reaches
+    /// with a hash map that the thread reuses for its next query
+    kHashed,
+  };
+
+  static const uint32_t kDefaultHops = 2;
+  /// The largest number of hops, so that distances fit in a byte
+  static const uint32_t kMaxHops = 255;
+
+private:
+  Algorithm algorithm_;
+  uint32_t hops_;
+  uint32_t max_fanout_;
+  uint32_t max_nodes_;
+
+  KHopPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t hops,
+      uint32_t max_fanout, uint32_t max_nodes)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        hops_(hops),
+        max_fanout_(max_fanout),
+        max_nodes_(max_nodes) {}
+
+public:
+  KHopPlan() : KHopPlan(Hashed()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t hops() const { return hops_; }
+  /// The number of out-edges followed from each node, the first ones in
+  /// the order of the graph, or 0 to follow all of them
+  uint32_t max_fanout() const { return max_fanout_; }
+  /// The number of nodes at which the expansion of a query stops, or 0 for
+  /// no limit. The hop that reaches the limit keeps the nodes with the
+  /// smallest IDs.
+  uint32_t max_nodes() const { return max_nodes_; }
+
+  /// Expand queries by hops hops with the caps described above
+  static KHopPlan Hashed(
+      uint32_t hops = kDefaultHops, uint32_t max_fanout = 0,
+      uint32_t max_nodes = 0) {
+    return {kCPU, kHashed, hops, max_fanout, max_nodes};
+  }
+};
+
+/// The k-hop neighborhoods of a list of queries. The two list arrays share
+/// their offsets, so entry q of each describes queries[q].
+struct KATANA_EXPORT KHopNeighborhoods {
+  /// Entry q lists the IDs of the nodes within the hops of the plan of
+  /// queries[q]: the query itself, then the nodes at distance 1 in
+  /// increasing order of ID, and so on
+  std::shared_ptr<arrow::LargeListArray> nodes;
+  /// Entry q lists the distance from queries[q] of each node of nodes[q], as
+  /// uint8 values
+  std::shared_ptr<arrow::LargeListArray> distances;
+};
+
+/// The subgraph induced by the k-hop neighborhood of a query
+struct KATANA_EXPORT EgoNetwork {
+  /// The ID in the graph of each node of the subgraph, in the order of
+  /// KHopNeighborhoods::nodes, so node 0 is the query
+  std::shared_ptr<arrow::UInt32Array> nodes;
+  /// Entry h is the number of nodes at most h hops from the query
+  std::vector<uint32_t> hop_sizes;
+  /// The edges among the nodes, in local node indices. Only the edges the
+  /// fanout cap of the plan lets the expansion follow are considered, so
+  /// without a cap this is the induced subgraph.
+  GraphTopology topology;
+  /// The ID in the graph of each edge of topology, e.g., to gather edge
+  /// properties
+  std::shared_ptr<arrow::UInt64Array> edges;
+};
+
+/// Expands batches of query nodes into their k-hop neighborhoods along
+/// out-edges, processing the queries of a batch concurrently on the thread
+/// pool. Each query is expanded by a single thread, so its cost is
+/// proportional to the size of its neighborhood rather than of the graph,
+/// and the result does not depend on the number of threads.
+///
+/// An expander keeps per-thread workspaces that grow to the largest
+/// neighborhood seen and are reused by later queries and batches, so one
+/// expander should serve all the queries of a graph. It is not thread safe.
+class KATANA_EXPORT KHopExpander {
+public:
+  /// The graph must outlive the expander
+  static Result<std::unique_ptr<KHopExpander>> Make(
+      const PropertyGraph* pg, KHopPlan plan = {});
+
+  /// The neighborhoods of queries, which are nodes of the graph and may
+  /// repeat
+  Result<KHopNeighborhoods> Neighborhoods(const std::vector<uint32_t>& queries);
+
+  /// The ego networks of queries, which are nodes of the graph and may
+  /// repeat
+  Result<std::vector<EgoNetwork>> EgoNetworks(
+      const std::vector<uint32_t>& queries);
+
+  const KHopPlan& plan() const { return plan_; }
+
+private:
+  /// The expansion of one query
+  struct Expansion {
+    std::vector<uint32_t> nodes;
+    /// Entry h is the number of nodes at most h hops from the query
+    std::vector<uint32_t> hop_sizes;
+    /// The end in dests of the edges of each node, if edges were collected
+    std::vector<uint64_t> edge_ends;
+    std::vector<uint32_t> dests;
+    std::vector<uint64_t> edges;
+  };
+
+  /// The state a thread reuses across queries
+  struct Workspace {
+    /// The local index of each node reached by the current query
+    SmallHashMap<uint32_t, uint32_t, 64> local;
+    std::vector<uint32_t> next;
+  };
+
+  KHopExpander(const PropertyGraph* pg, KHopPlan plan)
+      : pg_(pg), plan_(std::move(plan)) {}
+
+  Result<void> Expand(const std::vector<uint32_t>& queries, bool with_edges);
+  void ExpandOne(
+      uint32_t query, bool with_edges, Workspace* ws, Expansion* out) const;
+
+  const PropertyGraph* pg_;
+  KHopPlan plan_;
+  PerThreadStorage<Workspace> workspaces_;
+  /// The expansions of the current batch, kept to reuse their capacity
+  std::vector<Expansion> expansions_;
+};
+
+}  // namespace katana::analytics
+
+#endif
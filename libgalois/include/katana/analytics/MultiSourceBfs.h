@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MULTISOURCEBFS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MULTISOURCEBFS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/config.h"
+#include "katana/gstl.h"
+
+namespace katana::analytics {
+
+/// A breadth-first search from up to kMaxSources sources at once, following
+/// the bit-parallel MS-BFS of Then et al. (The More the Merrier: Efficient
+/// Multi-Source Graph Traversal, VLDB 2014).
+///
+/// Each source is assigned a lane, i.e., a bit in a word of Lanes. Every node
+/// keeps the set of lanes that have reached it, so an edge is traversed once
+/// per level for all sources whose frontiers contain its source node instead
+/// of once per source.
+///
+/// The traversal follows outgoing edges. Its result is a sequence of levels:
+/// level d holds each node that is at distance d from some source together
+/// with the lanes of all sources it is at distance d from. A node appears at
+/// most once per level but may appear at several levels.
+class KATANA_EXPORT MultiSourceBfsBatch {
+public:
+  using Node = GraphTopology::Node;
+  using Lanes = uint64_t;
+
+  constexpr static const size_t kMaxSources = sizeof(Lanes) * 8;
+
+  struct Visit {
+    Node node;
+    Lanes lanes;
+  };
+
+  using Level = katana::InsertBag<Visit>;
+
+  explicit MultiSourceBfsBatch(const GraphTopology* topology);
+
+  /// Traverse the graph from sources[0], ..., sources[num_sources - 1], where
+  /// sources[i] is in lane i. The same node may be given more than once.
+  /// This replaces the levels of any previous run.
+  void Run(const uint32_t* sources, size_t num_sources);
+
+  /// The number of non-empty levels found by the last run
+  size_t num_levels() const { return levels_.size(); }
+
+  Level& level(size_t d) { return levels_[d]; }
+
+  /// Remember the lanes with which each node was reached at level d, e.g.,
+  /// to find edges between consecutive levels. Marking a level past the last
+  /// one clears all marks.
+  void MarkLevel(size_t d);
+
+  /// The lanes with which node was reached at the marked level
+  Lanes marked(Node node) const { return marked_[node]; }
+
+private:
+  const GraphTopology* topology_;
+  katana::LargeArray<Lanes> seen_;
+  katana::LargeArray<std::atomic<Lanes>> next_;
+  katana::LargeArray<Lanes> marked_;
+  katana::gstl::Vector<Level> levels_;
+  size_t marked_level_;
+};
+
+}  // namespace katana::analytics
+
+#endif
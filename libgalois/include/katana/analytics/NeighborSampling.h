@@ -0,0 +1,203 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/LargeArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/Plan.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A computational plan for NeighborSampler, which samples the k-hop
+/// neighborhoods of minibatches of seed nodes for training graph neural
+/// networks:
+///
+///   William L. Hamilton, Rex Ying and Jure Leskovec. Inductive
+///   Representation Learning on Large Graphs. NeurIPS 2017.
+///
+/// Random choices are drawn from independent streams seeded by seed, the
+/// number of the minibatch and the position of the node they decide, so a
+/// sampler returns the same minibatches for any number of threads.
+class NeighborSamplingPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Sample out-edges uniformly at random
+    kUniform,
+  };
+
+  static const uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  std::vector<uint32_t> fanouts_;
+  bool replace_;
+  uint64_t seed_;
+
+  NeighborSamplingPlan(
+      Architecture architecture, Algorithm algorithm,
+      std::vector<uint32_t> fanouts, bool replace, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        fanouts_(std::move(fanouts)),
+        replace_(replace),
+        seed_(seed) {}
+
+public:
+  NeighborSamplingPlan() : NeighborSamplingPlan(Uniform({10, 10})) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Entry h is the number of out-edges sampled from each node at hop h,
+  /// with the seeds at hop 0; the number of hops is the size of fanouts
+  const std::vector<uint32_t>& fanouts() const { return fanouts_; }
+  /// Whether an edge may be sampled more than once. Without replacement
+  /// nodes with fewer out-edges than the fanout keep all of them.
+  bool replace() const { return replace_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Sample fanouts[h] out-edges of each node at hop h uniformly at random
+  static NeighborSamplingPlan Uniform(
+      std::vector<uint32_t> fanouts, bool replace = false,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kUniform, std::move(fanouts), replace, seed};
+  }
+};
+
+/// The edges sampled at one hop of a minibatch, in the local node indices of
+/// SampledMinibatch::nodes. Edge i was sampled for node destinations[i] and
+/// leads to node sources[i], so a layer of a GNN aggregates messages along
+/// it from source to destination.
+struct KATANA_EXPORT SampledBlock {
+  std::shared_ptr<arrow::UInt32Array> sources;
+  std::shared_ptr<arrow::UInt32Array> destinations;
+  /// The ID in the graph of each edge, e.g., to gather edge features
+  std::shared_ptr<arrow::UInt64Array> edges;
+};
+
+/// The sampled neighborhood of a minibatch of seed nodes
+struct KATANA_EXPORT SampledMinibatch {
+  /// The ID in the graph of each sampled node. The seeds come first, in the
+  /// order given, followed by the nodes first reached at hop 1, and so on,
+  /// so the nodes a hop needs are a prefix of those of the hop after it.
+  std::shared_ptr<arrow::UInt32Array> nodes;
+  /// Entry h is the number of nodes that are at most h hops from the seeds:
+  /// entry 0 is the number of seeds and the last entry is the number of
+  /// nodes
+  std::vector<uint32_t> hop_sizes;
+  /// Entry h holds the edges sampled for the first hop_sizes[h] nodes, whose
+  /// sources are among the first hop_sizes[h + 1]. A GNN of k layers
+  /// applies its first layer to blocks[k - 1] and its last to blocks[0].
+  std::vector<SampledBlock> blocks;
+  /// Entry i holds feature property i of the sampler gathered for nodes, of
+  /// the type of the property
+  std::vector<std::shared_ptr<arrow::Array>> features;
+};
+
+/// Samples minibatches of a graph for training GNNs: the k-hop neighborhoods
+/// of seed nodes with a fanout per hop, and the features of the sampled
+/// nodes gathered into contiguous buffers.
+///
+/// Feature properties must hold fixed width values without nulls, e.g.,
+/// FixedSizeList<float> embeddings or integer labels, and are made
+/// contiguous once when the sampler is made if they are chunked. Rows are
+/// copied into buffers allocated from the memory pool given to Make, which
+/// start on 64 byte boundaries; a pool of page-locked host memory lets them
+/// be copied to a GPU without staging.
+///
+/// A sampler is not thread safe. It keeps per node state for deduplicating
+/// neighbors, so one sampler should be reused for all the batches of a
+/// graph.
+class KATANA_EXPORT NeighborSampler {
+public:
+  /// The graph and the memory pool must outlive the sampler
+  static Result<std::unique_ptr<NeighborSampler>> Make(
+      const PropertyGraph* pg, NeighborSamplingPlan plan = {},
+      const std::vector<std::string>& feature_properties = {},
+      arrow::MemoryPool* pool = arrow::default_memory_pool());
+
+  /// Sample the neighborhood of seeds, which must be distinct nodes of the
+  /// graph. Each call draws from the next random streams of the plan.
+  Result<SampledMinibatch> Sample(const std::vector<uint32_t>& seeds);
+
+  const NeighborSamplingPlan& plan() const { return plan_; }
+
+private:
+  /// A feature property and where its rows are
+  struct Feature {
+    std::shared_ptr<arrow::Array> array;
+    const uint8_t* rows;
+    uint64_t row_bytes;
+  };
+
+  NeighborSampler(
+      const PropertyGraph* pg, NeighborSamplingPlan plan,
+      std::vector<Feature> features, arrow::MemoryPool* pool);
+
+  Result<void> SampleHop(
+      uint32_t hop, uint64_t stream, std::vector<uint32_t>* nodes,
+      SampledBlock* block);
+  Result<std::shared_ptr<arrow::Array>> Gather(
+      const Feature& feature, const std::vector<uint32_t>& nodes);
+  void Reset(const std::vector<uint32_t>& nodes);
+
+  const PropertyGraph* pg_;
+  NeighborSamplingPlan plan_;
+  std::vector<Feature> features_;
+  arrow::MemoryPool* pool_;
+  uint64_t num_batches_{0};
+  /// The index in the current batch of each node, or kNotSampled
+  LargeArray<uint32_t> local_;
+  /// The first position at which the current hop sampled each node
+  LargeArray<std::atomic<uint64_t>> first_;
+};
+
+/// Feeds a trainer the minibatches of a list of seeds, sampling batch N + 1
+/// in the background while the trainer consumes batch N.
+///
+/// Sampling runs parallel loops on the Katana thread pool, which runs one
+/// loop at a time, so the caller must not run other Katana loops while a
+/// batch is being sampled, i.e., between calls to Next.
+class KATANA_EXPORT MinibatchLoader {
+public:
+  /// Split seeds into batches of batch_size, which must be positive, in
+  /// order, the last of which may be smaller, and start sampling the first.
+  /// The sampler must outlive the loader.
+  MinibatchLoader(
+      NeighborSampler* sampler, std::vector<uint32_t> seeds,
+      uint32_t batch_size);
+  /// Waits for the batch in flight, if any
+  ~MinibatchLoader();
+
+  MinibatchLoader(const MinibatchLoader&) = delete;
+  MinibatchLoader& operator=(const MinibatchLoader&) = delete;
+
+  uint64_t num_batches() const;
+  /// Whether Next has returned every batch
+  bool done() const { return next_batch_ >= num_batches(); }
+
+  /// Wait for the next batch and start sampling the one after it. Returns
+  /// ErrorCode::NotFound once every batch has been returned.
+  Result<SampledMinibatch> Next();
+
+private:
+  void Prefetch();
+
+  NeighborSampler* sampler_;
+  std::vector<uint32_t> seeds_;
+  uint32_t batch_size_;
+  uint64_t next_batch_{0};
+  std::future<Result<SampledMinibatch>> in_flight_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -28,12 +28,32 @@ enum Architecture {
 class Plan {
 protected:
   Architecture architecture_;
+  bool deterministic_{false};
+  bool profile_parallelism_{false};
 
   Plan(Architecture architecture) : architecture_(architecture) {}
 
 public:
   /// The architecture on which the algorithm will run.
   Architecture architecture() const { return architecture_; }
+
+  /// Whether the algorithm must return the same result on every run on the same machine, for any number of threads.
+  /// Algorithms whose results otherwise depend on the schedule (e.g., floating-point sums in the order threads finish
+  /// or ties won by whichever thread gets there first) then reduce and break ties in a fixed order, which costs some
+  /// performance. Algorithms that cannot do so fail with ErrorCode::NotImplemented. False by default.
+  bool deterministic() const { return deterministic_; }
+
+  void set_deterministic(bool deterministic) { deterministic_ = deterministic; }
+
+  /// Whether to measure the available parallelism of the algorithm rather than run it at full speed. The loops of the
+  /// algorithm then run step by step under the ParaMeter executor and report the work available in each step and the
+  /// share of iterations that conflicted as statistics of the region of each loop (see
+  /// katana::parameter::ProfileScope), which tells whether more threads would speed the algorithm up on a graph. The
+  /// result is the same, but the algorithm runs much slower. Honored by Bfs, Sssp, ConnectedComponents, Pagerank,
+  /// KCore and TriangleCount. False by default.
+  bool profile_parallelism() const { return profile_parallelism_; }
+
+  void set_profile_parallelism(bool profile_parallelism) { profile_parallelism_ = profile_parallelism; }
 };
 
 }  // namespace katana::analytics
@@ -0,0 +1,177 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANTUNER_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANTUNER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/Time.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Statistics of the degree distribution of a graph, which identify it for
+/// the purpose of reusing tuned plans (see TunePlan).
+struct KATANA_EXPORT GraphProfile {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  /// Median and maximum out-degree of evenly spaced sample nodes
+  uint64_t sampled_median_degree{0};
+  uint64_t sampled_max_degree{0};
+  /// See IsApproximateDegreeDistributionPowerLaw
+  bool power_law{false};
+  /// A hash of the sizes and a sample of the topology of the graph, which
+  /// is the same each time the graph is loaded
+  uint64_t fingerprint{0};
+
+  double average_degree() const {
+    return num_nodes > 0 ? static_cast<double>(num_edges) / num_nodes : 0;
+  }
+
+  static GraphProfile Compute(const PropertyGraph& pg);
+};
+
+/// Make the subgraph of pg induced by the first num_nodes nodes visited by a
+/// breadth-first search from a random node with edges (or all of pg if it is
+/// smaller), with copies of the named edge properties and no node
+/// properties. If the search runs out of nodes, it continues from unvisited
+/// ones. Searching keeps the neighborhoods of the sample intact, so the
+/// sample has a diameter and degree distribution more like pg's than a
+/// uniformly sampled subgraph would. Node 0 of the sample is the source and
+/// has edges unless all of pg's nodes are isolated.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> SampleGraph(
+    const PropertyGraph& pg, uint64_t num_nodes,
+    const std::vector<std::string>& edge_properties = {});
+
+/// Choices made by TunePlan, keyed by algorithm and graph fingerprint. When
+/// the environment variable KATANA_PLAN_CACHE names a file, choices are
+/// loaded from it and added to it, so that later runs reuse them.
+class KATANA_EXPORT PlanCache {
+public:
+  static PlanCache& Get();
+
+  std::optional<std::string> Find(const std::string& key);
+  Result<void> Insert(const std::string& key, const std::string& choice);
+
+  /// Forget all choices, without changing the file
+  void Clear();
+
+private:
+  Result<void> Load();
+
+  std::mutex mutex_;
+  bool loaded_{false};
+  std::string path_;
+  std::unordered_map<std::string, std::string> choices_;
+};
+
+struct TunerOptions {
+  /// Number of nodes in the sample that candidates run on
+  uint64_t sample_nodes{uint64_t{1} << 18};
+  /// Each candidate is timed by its fastest of this many runs
+  uint32_t trials{2};
+  /// Benchmark candidates even if a choice for the graph is cached
+  bool refresh{false};
+};
+
+template <typename PlanType>
+struct PlanCandidate {
+  /// Identifies the candidate in the cache, so it must be distinct from the
+  /// names of the other candidates for the same algorithm
+  std::string name;
+  PlanType plan;
+};
+
+/// Choose the fastest of candidates for algorithm on pg.
+///
+/// Unless a choice is cached for algorithm and the fingerprint of pg (see
+/// GraphProfile), each candidate is timed by calling run(sample, plan),
+/// which returns Result<void>, on a SampleGraph of pg with edge_properties.
+/// The choice is then cached. Candidates whose runs fail are not chosen,
+/// and run must leave the sample as it found it (e.g., by removing its
+/// output properties).
+template <typename PlanType, typename RunFn>
+Result<PlanType>
+TunePlan(
+    const std::string& algorithm, const PropertyGraph& pg,
+    const std::vector<PlanCandidate<PlanType>>& candidates, RunFn run,
+    const std::vector<std::string>& edge_properties = {},
+    const TunerOptions& opts = {}) {
+  if (candidates.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no candidate plans for {}", algorithm);
+  }
+
+  GraphProfile profile = GraphProfile::Compute(pg);
+  std::string key = fmt::format("{}/{:016x}", algorithm, profile.fingerprint);
+  PlanCache& cache = PlanCache::Get();
+  if (std::optional<std::string> cached = cache.Find(key);
+      cached && !opts.refresh) {
+    for (const auto& candidate : candidates) {
+      if (candidate.name == *cached) {
+        return candidate.plan;
+      }
+    }
+  }
+
+  auto sample_res = SampleGraph(pg, opts.sample_nodes, edge_properties);
+  if (!sample_res) {
+    return sample_res.error().WithContext("sampling graph for {}", algorithm);
+  }
+  std::unique_ptr<PropertyGraph> sample = std::move(sample_res.value());
+
+  const PlanCandidate<PlanType>* best = nullptr;
+  uint64_t best_us = std::numeric_limits<uint64_t>::max();
+  std::optional<CopyableErrorInfo> last_error;
+  for (const auto& candidate : candidates) {
+    uint64_t candidate_us = std::numeric_limits<uint64_t>::max();
+    for (uint32_t t = 0; t < std::max(opts.trials, uint32_t{1}); ++t) {
+      TimePoint start = Now();
+      Result<void> res = run(sample.get(), candidate.plan);
+      if (!res) {
+        last_error = res.error();
+        KATANA_LOG_VERBOSE(
+            "{} candidate {} failed: {}", algorithm, candidate.name,
+            *last_error);
+        candidate_us = std::numeric_limits<uint64_t>::max();
+        break;
+      }
+      candidate_us = std::min(candidate_us, UsSince(start));
+    }
+    if (candidate_us == std::numeric_limits<uint64_t>::max()) {
+      continue;
+    }
+    ReportStatSingle(
+        "PlanTuner", fmt::format("{}/{}", algorithm, candidate.name),
+        candidate_us);
+    if (candidate_us < best_us) {
+      best_us = candidate_us;
+      best = &candidate;
+    }
+  }
+  if (best == nullptr) {
+    return KATANA_ERROR(
+        last_error->error_code(), "no candidate plan for {} ran: {}",
+        algorithm, *last_error);
+  }
+
+  if (auto res = cache.Insert(key, best->name); !res) {
+    KATANA_LOG_WARN("not caching plan for {}: {}", algorithm, res.error());
+  }
+  return best->plan;
+}
+
+}  // namespace katana::analytics
+
+#endif
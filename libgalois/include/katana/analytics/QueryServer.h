@@ -0,0 +1,157 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_QUERYSERVER_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_QUERYSERVER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/Workspace.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A QueryServer keeps property graphs in memory under names and runs
+/// analytics on them on request, so that a series of short queries pays for
+/// loading a graph and starting threads once rather than once per query.
+///
+/// Requests and responses are JSON objects. Every response has "ok", which
+/// is false with a message in "error" if the request failed. Requests have
+/// an "op":
+///
+///   - "load": load the RDG "rdg" as "graph". Optional: "map_topology" to map
+///     the topology file read-only instead of copying it, "node_properties"
+///     and "edge_properties" to load only some properties.
+///   - "unload": drop "graph".
+///   - "list": respond with "graphs", the name, size and properties of each
+///     resident graph.
+///   - "run": run "analytic" on "graph" with the arguments in "args" and
+///     respond with its statistics in "result", its time in "seconds", and
+///     how many parallel loops it ran in "parallel_loops" with their mean
+///     dispatch latency in "dispatch_latency_ns" (see
+///     ThreadPool::DispatchStats).
+///     Analytics are "bfs" (args "source"), "sssp" ("source",
+///     "edge_weight_property"), "connected_components", "pagerank",
+///     "k_core" ("k") and "triangle_count". Optional: "threads" to run with
+///     that many threads, "output_property" to keep the result in the
+///     resident graph under that name, and "memoize" (see below). The
+///     response has "memoized", which is true if the result was reused.
+///   - "fetch": stream rows of a property table of "graph" to the client as
+///     Arrow record batches, so that results need not be written to storage
+///     and read back. "table" is "nodes" (the default), whose rows have a
+///     uint32 "id", a "user_id" if the graph has original IDs, and the node
+///     properties, or "edges", whose rows have uint32 "src" and "dst" and
+///     the edge properties. Optional: "properties" to send only those
+///     properties, "node_range", a [begin, end) pair, to send only those
+///     nodes or the edges of those nodes, like an RDGSlice, "nodes" to send
+///     only the node table rows of these IDs, in this order, "partition"
+///     and "num_partitions" to send only that part of the selected rows
+///     when they are split into num_partitions contiguous parts, and
+///     "batch_rows", the most rows per record batch. The response has
+///     "num_rows" and the column names in "columns". Over a socket, the
+///     response is followed by the rows as an Arrow IPC stream, after which
+///     the server closes the connection (see QueryServerFetch).
+///   - "shutdown": stop Serve after responding.
+///
+/// Each run works in scratch space: the properties it adds to the resident
+/// graph, other than its output_property, are removed when it finishes.
+/// Runs of "bfs" and "sssp" that neither keep nor memoize their output take
+/// it from an AnalyticsWorkspace of the graph, so that repeated runs reuse
+/// and sparsely reset one column instead of allocating and initializing a
+/// new one.
+/// Requests run one at a time, since they share the thread pool. The
+/// exception is the streaming of fetched rows, which happens on a thread
+/// per connection, so that clients may fetch the partitions of a table in
+/// parallel. Sliced columns are sent from the memory of the resident graph
+/// without copying; streams finish before the server handles any request
+/// other than a fetch.
+///
+/// A run with "memoize" set to true keeps its statistics and output column.
+/// A later memoized run of the same analytic with the same args on the same
+/// resident graph returns them without running the analytic, adding the
+/// column as its output_property if it has one. Runs only add properties,
+/// so results stay valid until the graph is unloaded, which drops them.
+class KATANA_EXPORT QueryServer {
+public:
+  QueryServer() = default;
+  QueryServer(const QueryServer&) = delete;
+  QueryServer& operator=(const QueryServer&) = delete;
+  ~QueryServer();
+
+  /// Make pg resident under name, as a load request would
+  Result<void> AddGraph(
+      const std::string& name, std::unique_ptr<PropertyGraph> pg);
+
+  /// Handle one request
+  nlohmann::json Handle(const nlohmann::json& request);
+
+  /// Listen on a unix domain socket at socket_path and handle requests until
+  /// a shutdown request. A client may send any number of requests over a
+  /// connection; each message is its size as a uint64_t in host byte order
+  /// followed by that many bytes of JSON.
+  Result<void> Serve(const std::string& socket_path);
+
+private:
+  Result<nlohmann::json> HandleOrError(const nlohmann::json& request);
+  Result<nlohmann::json> Load(const nlohmann::json& request);
+  Result<nlohmann::json> Unload(const nlohmann::json& request);
+  nlohmann::json List() const;
+  Result<nlohmann::json> Run(const nlohmann::json& request);
+
+  /// The rows selected by a fetch request
+  struct Fetched {
+    std::shared_ptr<arrow::Table> table;
+    int64_t batch_rows;
+  };
+
+  Result<Fetched> Fetch(const nlohmann::json& request);
+
+  /// Stream the rows of table to fd as an Arrow IPC stream on a new thread,
+  /// which closes fd when it is done
+  void StartStream(
+      int fd, std::shared_ptr<arrow::Table> table, int64_t batch_rows);
+  /// Wait for every stream
+  void FinishStreams();
+
+  /// The result of a memoized run
+  struct Memo {
+    nlohmann::json result;
+    /// The output node property, if the analytic has one
+    std::shared_ptr<arrow::ChunkedArray> output;
+  };
+
+  Result<nlohmann::json> Replay(
+      PropertyGraph* pg, const Memo& memo, const std::string& keep);
+
+  std::map<std::string, std::unique_ptr<PropertyGraph>> graphs_;
+  // Memoized runs of each graph, by analytic and args
+  std::map<std::string, std::map<std::string, Memo>> memos_;
+  // Workspaces of each graph; declared after graphs_ so that they are
+  // destroyed before their graphs
+  std::map<std::string, std::unique_ptr<AnalyticsWorkspace>> workspaces_;
+  std::vector<std::thread> streams_;
+  uint64_t num_runs_{0};
+  bool shutdown_{false};
+};
+
+/// Send request to the QueryServer at socket_path and return its response
+KATANA_EXPORT Result<nlohmann::json> QueryServerCall(
+    const std::string& socket_path, const nlohmann::json& request);
+
+/// Send the fetch request to the QueryServer at socket_path and return the
+/// rows it streams back. If num_partitions is more than 1, the rows are
+/// fetched as that many partitions over parallel connections and
+/// concatenated in order.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> QueryServerFetch(
+    const std::string& socket_path, const nlohmann::json& request,
+    uint32_t num_partitions = 1);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SEMIEXTERNAL_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SEMIEXTERNAL_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/EdgeStream.h"
+#include "katana/Result.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+
+/// Analytics for graphs whose topology does not fit in memory. Each keeps a
+/// few words of state per node in memory and reads the edges in passes over
+/// an EdgeStream, so the cost of an algorithm is mostly its number of passes.
+
+namespace katana::analytics {
+
+/// The level of nodes that SemiExternalBfs does not reach
+constexpr uint32_t kSemiExternalUnreached =
+    std::numeric_limits<uint32_t>::max();
+
+/// Compute the BFS level of every node from source. Each level is one pass
+/// that only reads the blocks holding nodes of the frontier.
+KATANA_EXPORT Result<std::vector<uint32_t>> SemiExternalBfs(
+    EdgeStream* stream, uint32_t source);
+
+/// Compute the (weakly) connected components of the graph, ignoring the
+/// direction of edges. The component of a node is the smallest node in it.
+/// This takes a single pass that adds every edge to a concurrent union-find.
+KATANA_EXPORT Result<std::vector<uint32_t>> SemiExternalConnectedComponents(
+    EdgeStream* stream);
+
+/// Compute the PageRank of every node with the topological push algorithm,
+/// one pass per iteration. Only the tolerance, max_iterations and alpha of
+/// plan are used.
+KATANA_EXPORT Result<std::vector<float>> SemiExternalPagerank(
+    EdgeStream* stream, const PagerankPlan& plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,531 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SPMV_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SPMV_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Threads.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+// A sparse matrix-vector product engine over GraphTopology in the style of
+// GraphBLAS. The matrix is the adjacency matrix of a graph: each edge (src,
+// dst) contributes x[src] * w to y[dst], so y = A^T x, where * and the sum
+// over the edges into dst come from a semiring.
+//
+// A semiring is a type with
+//
+//   using value_type = T;
+//   static T Zero();              // identity of Add, annihilator of Multiply
+//   static T Add(T a, T b);       // commutative and associative
+//   static T Multiply(T x, T w);
+//   static void AtomicAdd(T* y, T v);  // *y = Add(*y, v) atomically
+//   static constexpr bool kHasAbsorbing;
+//   static T Absorbing();         // only if kHasAbsorbing
+//
+// The kernels are templates over the semiring, so its operations inline
+// into the edge loops. An absorbing element a with Add(a, b) == a lets pull
+// stop scanning the edges of a node once its sum reaches a.
+//
+// Weights are functors called as weight(src, dst, edge), where edge is an
+// edge of the topology the kernel traverses: the graph for push kernels and
+// its transpose for pull kernels. Weights derived from nodes, such as the
+// inverse out degree of PageRank, can use the same functor for both.
+
+/// Compare and swap *y to Add(*y, v) until it sticks
+template <typename Semiring>
+void
+AtomicAddWithCAS(
+    typename Semiring::value_type* y, typename Semiring::value_type v) {
+  using T = typename Semiring::value_type;
+  T old_value;
+  __atomic_load(y, &old_value, __ATOMIC_RELAXED);
+  T new_value = Semiring::Add(old_value, v);
+  while (new_value != old_value &&
+         !__atomic_compare_exchange(
+             y, &old_value, &new_value, true, __ATOMIC_RELAXED,
+             __ATOMIC_RELAXED)) {
+    new_value = Semiring::Add(old_value, v);
+  }
+}
+
+/// (+, *): PageRank, Katz, HITS, path counts
+template <typename T>
+struct PlusTimes {
+  using value_type = T;
+  static constexpr bool kHasAbsorbing = false;
+  static T Zero() { return T{0}; }
+  static T Add(T a, T b) { return a + b; }
+  static T Multiply(T x, T w) { return x * w; }
+  static void AtomicAdd(T* y, T v) {
+    if constexpr (std::is_integral_v<T>) {
+      __atomic_fetch_add(y, v, __ATOMIC_RELAXED);
+    } else {
+      AtomicAddWithCAS<PlusTimes>(y, v);
+    }
+  }
+};
+
+/// (min, +): shortest path distances and BFS levels. Zero is the largest
+/// value, which Multiply keeps rather than overflowing.
+template <typename T>
+struct MinPlus {
+  using value_type = T;
+  static constexpr bool kHasAbsorbing = false;
+  static T Zero() {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+      return std::numeric_limits<T>::infinity();
+    } else {
+      return std::numeric_limits<T>::max();
+    }
+  }
+  static T Add(T a, T b) { return std::min(a, b); }
+  static T Multiply(T x, T w) { return x == Zero() ? Zero() : x + w; }
+  static void AtomicAdd(T* y, T v) { AtomicAddWithCAS<MinPlus>(y, v); }
+};
+
+/// (min, first): the least label among the in-neighbors, as in label
+/// propagation for connected components; weights are ignored
+template <typename T>
+struct MinFirst {
+  using value_type = T;
+  static constexpr bool kHasAbsorbing = false;
+  static T Zero() { return std::numeric_limits<T>::max(); }
+  static T Add(T a, T b) { return std::min(a, b); }
+  static T Multiply(T x, T) { return x; }
+  static void AtomicAdd(T* y, T v) { AtomicAddWithCAS<MinFirst>(y, v); }
+};
+
+/// (or, and) over 0 and 1: reachability in one step, as in BFS. 1 absorbs,
+/// so pull stops at the first in-neighbor that is set.
+template <typename T = uint8_t>
+struct OrAnd {
+  using value_type = T;
+  static constexpr bool kHasAbsorbing = true;
+  static T Zero() { return T{0}; }
+  static T Absorbing() { return T{1}; }
+  static T Add(T a, T b) { return a | b; }
+  static T Multiply(T x, T w) { return x & w; }
+  static void AtomicAdd(T* y, T v) {
+    if (v != Zero()) {
+      __atomic_store_n(y, v, __ATOMIC_RELAXED);
+    }
+  }
+};
+
+/// Every edge has weight 1
+template <typename T>
+struct UnitWeight {
+  T operator()(uint32_t, uint32_t, uint64_t) const { return T{1}; }
+};
+
+/// Restricts the nodes of y that a product writes; the others keep their
+/// values. With complement set, the nodes in bits are the ones skipped, e.g.,
+/// the visited nodes of a BFS.
+struct SpMVMask {
+  const DynamicBitset* bits{nullptr};
+  bool complement{false};
+
+  bool Allows(uint32_t node) const {
+    return bits == nullptr || bits->test(node) != complement;
+  }
+};
+
+/// A sparse vector over the nodes of a graph. The products that produce one
+/// sort it by index.
+template <typename T>
+struct SparseVector {
+  std::vector<uint32_t> indices;
+  std::vector<T> values;
+
+  size_t size() const { return indices.size(); }
+  void clear() {
+    indices.clear();
+    values.clear();
+  }
+};
+
+/// y = A^T x by pulling along the edges of in, the transpose of the graph.
+/// Every node of y is written by one thread, so no atomics are needed.
+template <typename Semiring, typename Weight>
+void
+PullSpMV(
+    const GraphTopology& in, const typename Semiring::value_type* x,
+    typename Semiring::value_type* y, const SpMVMask& mask,
+    const Weight& weight) {
+  using T = typename Semiring::value_type;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, in.num_nodes()),
+      [&](uint64_t dst) {
+        if (!mask.Allows(dst)) {
+          return;
+        }
+        T sum = Semiring::Zero();
+        for (auto e : in.edges(dst)) {
+          uint32_t src = in.edge_dest(e);
+          sum = Semiring::Add(
+              sum, Semiring::Multiply(x[src], weight(src, dst, e)));
+          if constexpr (Semiring::kHasAbsorbing) {
+            if (sum == Semiring::Absorbing()) {
+              break;
+            }
+          }
+        }
+        y[dst] = sum;
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("PullSpMV"));
+}
+
+/// Set the nodes of y that mask allows to zero
+template <typename Semiring>
+void
+ClearSpMVOutput(
+    uint64_t num_nodes, typename Semiring::value_type* y,
+    const SpMVMask& mask) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (mask.Allows(n)) {
+          y[n] = Semiring::Zero();
+        }
+      },
+      katana::no_stats());
+}
+
+/// y = A^T x by pushing along the edges of out, the graph, with atomic
+/// updates of y. Nodes whose value in x is zero are skipped.
+template <typename Semiring, typename Weight>
+void
+PushSpMV(
+    const GraphTopology& out, const typename Semiring::value_type* x,
+    typename Semiring::value_type* y, const SpMVMask& mask,
+    const Weight& weight) {
+  ClearSpMVOutput<Semiring>(out.num_nodes(), y, mask);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, out.num_nodes()),
+      [&](uint64_t src) {
+        if (x[src] == Semiring::Zero()) {
+          return;
+        }
+        for (auto e : out.edges(src)) {
+          uint32_t dst = out.edge_dest(e);
+          if (mask.Allows(dst)) {
+            Semiring::AtomicAdd(
+                &y[dst], Semiring::Multiply(x[src], weight(src, dst, e)));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("PushSpMV"));
+}
+
+/// The buffers of propagation blocking: per thread, one bin of (dst, value)
+/// updates for each range of 2^bin_bits destinations.
+template <typename T>
+class PropagationBins {
+public:
+  struct Update {
+    uint32_t dst;
+    T value;
+  };
+
+  /// By default a bin covers 2^16 destinations, whose values fit in the L2
+  /// cache for values of up to 8 bytes
+  static constexpr uint32_t kDefaultBinBits = 16;
+
+  explicit PropagationBins(uint32_t bin_bits = kDefaultBinBits)
+      : bin_bits_(bin_bits) {}
+
+  uint32_t bin_bits() const { return bin_bits_; }
+
+  /// The bins of the calling thread, made on first use, since storage is
+  /// made for every thread that could run
+  std::vector<std::vector<Update>>& Local(uint64_t num_bins) {
+    auto& bins = *bins_.getLocal();
+    if (bins.size() != num_bins) {
+      bins.resize(num_bins);
+    }
+    return bins;
+  }
+
+  std::vector<std::vector<Update>>& Remote(unsigned thread) {
+    return *bins_.getRemote(thread);
+  }
+
+private:
+  uint32_t bin_bits_;
+  katana::PerThreadStorage<std::vector<std::vector<Update>>> bins_;
+};
+
+/// y = A^T x by pushing along the edges of out with propagation blocking:
+/// updates are first appended to per-thread bins by destination range and
+/// then each bin is summed into y by one thread. Both phases access memory
+/// sequentially or within one cache-sized range of y, and neither needs
+/// atomics.
+template <typename Semiring, typename Weight>
+void
+BlockedPushSpMV(
+    const GraphTopology& out, const typename Semiring::value_type* x,
+    typename Semiring::value_type* y, const SpMVMask& mask,
+    const Weight& weight,
+    PropagationBins<typename Semiring::value_type>* bins) {
+  uint64_t num_nodes = out.num_nodes();
+  uint32_t bin_bits = bins->bin_bits();
+  uint64_t num_bins = (num_nodes >> bin_bits) + 1;
+
+  ClearSpMVOutput<Semiring>(num_nodes, y, mask);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t src) {
+        if (x[src] == Semiring::Zero()) {
+          return;
+        }
+        auto& local = bins->Local(num_bins);
+        for (auto e : out.edges(src)) {
+          uint32_t dst = out.edge_dest(e);
+          if (mask.Allows(dst)) {
+            local[dst >> bin_bits].push_back(
+                {dst, Semiring::Multiply(x[src], weight(src, dst, e))});
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("BlockedPushSpMVBin"));
+
+  unsigned num_threads = katana::getActiveThreads();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_bins),
+      [&](uint64_t b) {
+        for (unsigned t = 0; t < num_threads; ++t) {
+          auto& thread_bins = bins->Remote(t);
+          if (b >= thread_bins.size()) {
+            continue;
+          }
+          for (const auto& update : thread_bins[b]) {
+            y[update.dst] = Semiring::Add(y[update.dst], update.value);
+          }
+          thread_bins[b].clear();
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("BlockedPushSpMVAccumulate"));
+}
+
+/// The dense accumulator of SpMSpV: a value per node, kept at zero between
+/// products, and the nodes each thread touched.
+template <typename T>
+class SpMSpVAccumulator {
+public:
+  /// Allocate the accumulator for num_nodes nodes if it is not already
+  void Reserve(uint64_t num_nodes, T zero) {
+    if (values_.size() != num_nodes) {
+      values_.assign(num_nodes, zero);
+      touched_flags_.assign(num_nodes, 0);
+    }
+  }
+
+  T* values() { return values_.data(); }
+
+  /// Return true if this is the first call for node since the last Gather
+  bool Touch(uint32_t node) {
+    return __atomic_exchange_n(&touched_flags_[node], 1, __ATOMIC_RELAXED) ==
+           0;
+  }
+
+  std::vector<uint32_t>& LocalTouched() { return *touched_.getLocal(); }
+
+  /// Move the touched nodes whose values are not zero to result, sorted by
+  /// index, and reset the accumulator
+  void Gather(T zero, SparseVector<T>* result) {
+    result->clear();
+    unsigned num_threads = katana::getActiveThreads();
+    for (unsigned t = 0; t < num_threads; ++t) {
+      auto& touched = *touched_.getRemote(t);
+      result->indices.insert(
+          result->indices.end(), touched.begin(), touched.end());
+      touched.clear();
+    }
+    std::sort(result->indices.begin(), result->indices.end());
+
+    result->values.resize(result->indices.size());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{result->indices.size()}),
+        [&](uint64_t i) {
+          uint32_t n = result->indices[i];
+          result->values[i] = values_[n];
+          values_[n] = zero;
+          touched_flags_[n] = 0;
+        },
+        katana::no_stats());
+
+    size_t kept = 0;
+    for (size_t i = 0; i < result->size(); ++i) {
+      if (result->values[i] != zero) {
+        result->indices[kept] = result->indices[i];
+        result->values[kept] = result->values[i];
+        ++kept;
+      }
+    }
+    result->indices.resize(kept);
+    result->values.resize(kept);
+  }
+
+private:
+  std::vector<T> values_;
+  std::vector<uint8_t> touched_flags_;
+  katana::PerThreadStorage<std::vector<uint32_t>> touched_;
+};
+
+/// y = A^T x for a sparse x by pushing along the out edges of its nonzero
+/// nodes only. Costs time proportional to their edges rather than to the
+/// number of nodes, e.g., for the frontiers of a BFS.
+template <typename Semiring, typename Weight>
+void
+SpMSpV(
+    const GraphTopology& out,
+    const SparseVector<typename Semiring::value_type>& x,
+    SparseVector<typename Semiring::value_type>* y, const SpMVMask& mask,
+    const Weight& weight,
+    SpMSpVAccumulator<typename Semiring::value_type>* accumulator) {
+  accumulator->Reserve(out.num_nodes(), Semiring::Zero());
+  auto* values = accumulator->values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{x.size()}),
+      [&](uint64_t i) {
+        uint32_t src = x.indices[i];
+        for (auto e : out.edges(src)) {
+          uint32_t dst = out.edge_dest(e);
+          if (!mask.Allows(dst)) {
+            continue;
+          }
+          Semiring::AtomicAdd(
+              &values[dst],
+              Semiring::Multiply(x.values[i], weight(src, dst, e)));
+          if (accumulator->Touch(dst)) {
+            accumulator->LocalTouched().emplace_back(dst);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("SpMSpV"));
+  accumulator->Gather(Semiring::Zero(), y);
+}
+
+/// Kernels for dense products
+enum class SpMVKernel {
+  /// Pull when the transpose is available, push with propagation blocking
+  /// when the graph has more nodes than a bin covers and push otherwise
+  kAuto,
+  kPull,
+  kPush,
+  kBlockedPush,
+};
+
+/// The adjacency matrix of a graph over Semiring with the buffers its
+/// products reuse. For example, one PageRank iteration is
+///
+///   SemiringMatrix<PlusTimes<double>, InverseDegree> matrix(
+///       pg->topology(), &transpose->topology(), InverseDegree{...});
+///   matrix.Multiply(rank.data(), next.data());
+///
+/// followed by adding the teleport term to next.
+template <
+    typename Semiring,
+    typename Weight = UnitWeight<typename Semiring::value_type>>
+class SemiringMatrix {
+public:
+  using value_type = typename Semiring::value_type;
+
+  /// in, the transpose of out, enables pull products and may be null
+  explicit SemiringMatrix(
+      const GraphTopology& out, const GraphTopology* in = nullptr,
+      Weight weight = Weight{},
+      uint32_t bin_bits = PropagationBins<value_type>::kDefaultBinBits)
+      : out_(out), in_(in), weight_(std::move(weight)), bins_(bin_bits) {}
+
+  uint64_t num_nodes() const { return out_.num_nodes(); }
+
+  /// y = A^T x for dense x and y of num_nodes() values; the nodes of y that
+  /// mask does not allow keep their values
+  void Multiply(
+      const value_type* x, value_type* y, const SpMVMask& mask = {},
+      SpMVKernel kernel = SpMVKernel::kAuto) {
+    if (kernel == SpMVKernel::kAuto) {
+      if (in_ != nullptr) {
+        kernel = SpMVKernel::kPull;
+      } else if ((num_nodes() >> bins_.bin_bits()) > 0) {
+        kernel = SpMVKernel::kBlockedPush;
+      } else {
+        kernel = SpMVKernel::kPush;
+      }
+    }
+    switch (kernel) {
+    case SpMVKernel::kPull:
+      KATANA_LOG_ASSERT(in_ != nullptr);
+      PullSpMV<Semiring>(*in_, x, y, mask, weight_);
+      break;
+    case SpMVKernel::kBlockedPush:
+      BlockedPushSpMV<Semiring>(out_, x, y, mask, weight_, &bins_);
+      break;
+    default:
+      PushSpMV<Semiring>(out_, x, y, mask, weight_);
+      break;
+    }
+  }
+
+  /// y = A^T x for sparse x; y holds the nonzero nodes that mask allows
+  void Multiply(
+      const SparseVector<value_type>& x, SparseVector<value_type>* y,
+      const SpMVMask& mask = {}) {
+    SpMSpV<Semiring>(out_, x, y, mask, weight_, &accumulator_);
+  }
+
+private:
+  const GraphTopology& out_;
+  const GraphTopology* in_;
+  Weight weight_;
+  PropagationBins<value_type> bins_;
+  SpMSpVAccumulator<value_type> accumulator_;
+};
+
+/// Add a node property name of C type T to pg and return a view of it whose
+/// data() can be passed as the output of a product, so the result is
+/// written to the property without a copy. An existing property name of
+/// type T is overwritten in place if it can be (see
+/// PropertyGraph::PrepareNodePropertyOverwrite) and replaced otherwise.
+template <typename T>
+Result<PODPropertyView<T>>
+AddNodeVectorProperty(PropertyGraph* pg, const std::string& name) {
+  auto reuse = pg->PrepareNodePropertyOverwrite(
+      name, arrow::CTypeTraits<T>::type_singleton());
+  if (!reuse) {
+    return reuse.error();
+  }
+  if (!reuse.value()) {
+    if (auto r =
+            ConstructNodeProperties<std::tuple<PODProperty<T>>>(pg, {name});
+        !r) {
+      return r.error();
+    }
+  }
+  auto array = pg->GetNodePropertyTyped<T>(name);
+  if (!array) {
+    return array.error();
+  }
+  return PODPropertyView<T>::Make(*array.value());
+}
+
+}  // namespace katana::analytics
+
+#endif
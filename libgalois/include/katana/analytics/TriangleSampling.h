@@ -0,0 +1,58 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLESAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLESAMPLING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "katana/analytics/Intersection.h"
+
+namespace katana::analytics {
+
+// Helpers shared by the sampling algorithms of triangle count and local
+// clustering coefficient. They expect a symmetric graph whose edges are
+// sorted by destination.
+
+/// The number of wedges (paths of two edges) centered at a node of the
+/// given degree
+inline uint64_t
+NumWedges(uint64_t degree) {
+  return degree < 2 ? 0 : degree * (degree - 1) / 2;
+}
+
+/// Return true if there is an edge from a to b
+inline bool
+HasSortedEdge(const GraphTopology& topology, uint32_t a, uint32_t b) {
+  auto [begin, end] = EdgeDestRange(topology, a);
+  return std::binary_search(begin, end, b);
+}
+
+/// Draw a wedge centered at node uniformly at random and return true if it
+/// is closed, i.e., part of a triangle. node must have degree at least 2.
+template <typename Generator>
+bool
+SampleWedge(const GraphTopology& topology, uint32_t node, Generator* gen) {
+  auto [begin, end] = EdgeDestRange(topology, node);
+  uint64_t degree = end - begin;
+  uint64_t i = std::uniform_int_distribution<uint64_t>(0, degree - 1)(*gen);
+  uint64_t j = std::uniform_int_distribution<uint64_t>(0, degree - 2)(*gen);
+  if (j >= i) {
+    ++j;
+  }
+  return HasSortedEdge(topology, begin[i], begin[j]);
+}
+
+/// Mix seed and stream into the seed of an independent generator, so that
+/// samples depend on the seed of a plan and not on the number of threads
+inline uint64_t
+SampleSeed(uint64_t seed, uint64_t stream) {
+  // SplitMix64 of the combined value
+  uint64_t z = seed + (stream + 1) * UINT64_C(0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return z ^ (z >> 31);
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -4,10 +4,12 @@
 #include <algorithm>
 #include <random>
 
+#include "katana/Cancel.h"
 #include "katana/ErrorCode.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Result.h"
+#include "katana/analytics/Plan.h"
 
 namespace katana::analytics {
 
@@ -33,6 +35,41 @@ public:
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph);
 
+/// Check that plan can run in this build. Only kCPU is implemented; plans
+/// for other architectures fail instead of silently running on the CPU.
+inline katana::Result<void>
+CheckArchitecture(const Plan& plan) {
+  if (plan.architecture() != kCPU) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "architecture {} is not supported",
+        static_cast<int>(plan.architecture()));
+  }
+  return ResultSuccess();
+}
+
+/// Check that plan does not ask for deterministic execution (see
+/// Plan::deterministic), which the algorithm named by algorithm cannot
+/// provide.
+inline katana::Result<void>
+CheckNotDeterministic(const Plan& plan, const char* algorithm) {
+  if (plan.deterministic()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "{} has no deterministic mode", algorithm);
+  }
+  return ResultSuccess();
+}
+
+/// Return ErrorCode::Cancelled if the caller asked the analytic to stop (see
+/// katana::CancelScope). Analytics check between rounds and stop early, then
+/// check again before returning.
+inline katana::Result<void>
+CheckCancelled() {
+  if (katana::CancelRequested()) {
+    return KATANA_ERROR(ErrorCode::Cancelled, "analytic was cancelled");
+  }
+  return ResultSuccess();
+}
+
 template <typename Props>
 std::vector<std::string>
 DefaultPropertyNames() {
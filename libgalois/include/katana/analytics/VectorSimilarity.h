@@ -0,0 +1,33 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_VECTORSIMILARITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_VECTORSIMILARITY_H_
+
+#include <cstddef>
+
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+// The routines below compare dense vectors of floats, e.g., the rows of a
+// FixedSizeListPropertyView<float> of node embeddings. They use AVX-512 or
+// AVX2 with FMA when the processor supports it and fall back to a scalar
+// loop otherwise. Vectors need not be aligned, but rows of properties
+// allocated by arrow start on 64 byte boundaries when the row size is a
+// multiple of 64 bytes, which keeps loads from splitting cache lines.
+
+/// Return the dot product of the n values at a and b. Products are summed
+/// in several partial sums, so the result may differ from a sequential sum
+/// by rounding.
+KATANA_EXPORT float DotProduct(const float* a, const float* b, size_t n);
+
+/// Return the cosine similarity of the n values at a and b, or 0 if either
+/// vector is zero.
+KATANA_EXPORT float CosineSimilarity(
+    const float* a, const float* b, size_t n);
+
+/// Return the name of the instruction set used by the routines above on
+/// this processor: "avx512", "avx2" or "scalar".
+KATANA_EXPORT const char* VectorSimilarityKernel();
+
+}  // namespace katana::analytics
+
+#endif
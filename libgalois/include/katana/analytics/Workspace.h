@@ -0,0 +1,112 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_WORKSPACE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_WORKSPACE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Bag.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// An AnalyticsWorkspace keeps the scratch state of analytics that are run
+/// over and over on one graph, so that a short query does not pay for
+/// allocating and initializing whole-graph arrays each time.
+///
+/// Node property columns given back with ReleaseNodeProperty are kept and
+/// handed out again by AddNodeProperty. A column that is handed out again is
+/// reset to its fill value, either entirely by all threads or, if the
+/// analytic that used it logged the nodes it wrote in TouchedNodes, only at
+/// those nodes, so a query that reaches few nodes costs about as much as the
+/// nodes it reaches. The transpose of the graph is built on first use and
+/// kept until the topology of the graph changes. Released columns are freed
+/// when the memory budget runs short (see AddMemoryReclaimer).
+///
+/// Analytics that take a workspace (e.g., Bfs and Sssp) add their output
+/// property with it. A workspace is not thread safe and must not outlive its
+/// graph.
+class KATANA_EXPORT AnalyticsWorkspace {
+public:
+  explicit AnalyticsWorkspace(PropertyGraph* pg);
+  ~AnalyticsWorkspace();
+
+  AnalyticsWorkspace(const AnalyticsWorkspace&) = delete;
+  AnalyticsWorkspace& operator=(const AnalyticsWorkspace&) = delete;
+
+  PropertyGraph* graph() const { return pg_; }
+
+  /// Add a node property named name with every value equal to fill to the
+  /// graph, reusing a released column of the same type if there is one.
+  template <typename T>
+  Result<void> AddNodeProperty(const std::string& name, T fill) {
+    return AddNodeProperty(
+        name, arrow::CTypeTraits<T>::type_singleton(),
+        std::string(reinterpret_cast<const char*>(&fill), sizeof(T)));
+  }
+
+  /// Remove the node property name, which must have been added by
+  /// AddNodeProperty, from the graph and keep its column for a later
+  /// AddNodeProperty. A column that is still referenced elsewhere, e.g.,
+  /// through a ChunkedArray from PropertyGraph::GetNodeProperty, is dropped
+  /// instead, since it will not be overwritten.
+  Result<void> ReleaseNodeProperty(const std::string& name);
+
+  /// Whether node property name was added by AddNodeProperty and has not
+  /// been released
+  bool HasNodeProperty(const std::string& name) const {
+    return in_use_.count(name) > 0;
+  }
+
+  /// The log of the nodes whose values of node property name have been
+  /// written, or null if name was not added by AddNodeProperty. An analytic
+  /// that calls this must push every node it writes, possibly more than
+  /// once; the column is then reset only at those nodes after it is
+  /// released. Columns of analytics that do not call this are reset
+  /// entirely.
+  katana::InsertBag<uint32_t>* TouchedNodes(const std::string& name);
+
+  /// The transpose of the graph (see CreateTransposeGraph)
+  Result<const GraphTopology*> Transpose();
+
+  /// The number of bytes of columns kept for reuse
+  uint64_t released_bytes() const;
+
+private:
+  struct Column {
+    std::shared_ptr<arrow::DataType> type;
+    std::shared_ptr<arrow::Buffer> values;
+    /// The bytes of the fill value of the column
+    std::string fill;
+    /// Whether the values not at the nodes of touched equal fill
+    bool sparse{false};
+    std::unique_ptr<katana::InsertBag<uint32_t>> touched;
+  };
+
+  Result<void> AddNodeProperty(
+      const std::string& name, const std::shared_ptr<arrow::DataType>& type,
+      const std::string& fill);
+
+  PropertyGraph* pg_;
+  /// Columns in the graph, by property name
+  std::map<std::string, Column> in_use_;
+  /// Columns ready to be reused; guarded by released_mutex_, since the
+  /// memory reclaimer frees them from other threads
+  std::vector<Column> released_;
+  mutable std::mutex released_mutex_;
+  uint64_t reclaimer_id_;
+
+  std::unique_ptr<PropertyGraph> transpose_;
+  /// The destinations of the topology transpose_ was built from
+  std::weak_ptr<arrow::UInt32Array> transpose_of_;
+};
+
+}  // namespace katana::analytics
+
+#endif
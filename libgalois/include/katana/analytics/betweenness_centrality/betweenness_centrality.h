@@ -2,6 +2,7 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITY_H_
 
 #include <iostream>
+#include <string>
 #include <variant>
 
 #include "katana/PropertyGraph.h"
@@ -18,16 +19,36 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
+    kMultiSource,
+    kApproximate,
+    kWeighted,
     // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
     // kAsynchronous,
     // kAutomatic,
   };
 
+  static constexpr double kDefaultEpsilon = 0.01;
+  static constexpr double kDefaultDelta = 0.1;
+  static const uint64_t kDefaultSeed = 0;
+  static const unsigned kDefaultStepShift = 13;
+
 private:
   Algorithm algorithm_;
-
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  double epsilon_;
+  double delta_;
+  uint64_t seed_;
+  std::string edge_weight_property_name_;
+  unsigned step_shift_{kDefaultStepShift};
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint64_t seed = kDefaultSeed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        delta_(delta),
+        seed_(seed) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -50,11 +71,85 @@ public:
   }
 
   Algorithm algorithm() const { return algorithm_; }
+  /// The absolute error bound of kApproximate, relative to the number of
+  /// ordered pairs of nodes
+  double epsilon() const { return epsilon_; }
+  /// The probability that some estimate of kApproximate misses its bound
+  double delta() const { return delta_; }
+  uint64_t seed() const { return seed_; }
+  /// The edge property with the weights of kWeighted
+  const std::string& edge_weight_property_name() const {
+    return edge_weight_property_name_;
+  }
+  /// The log2 of the bucket width of the delta-stepping of kWeighted
+  unsigned step_shift() const { return step_shift_; }
 
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Process sources in batches of 64 that share one bit-parallel
+  /// multi-source BFS (see MultiSourceBfsBatch). This needs 12 bytes per
+  /// node for each source in a batch, but traverses each edge once per level
+  /// for the whole batch instead of once per source.
+  static BetweennessCentralityPlan MultiSource() {
+    return {kCPU, kMultiSource};
+  }
+
+  /**
+   * Estimate the centrality of every node from shortest paths between
+   * random pairs of nodes, as in KADABRA:
+   *
+   *   Michele Borassi and Emanuele Natale. KADABRA is an ADaptive Algorithm
+   *   for Betweenness via Random Approximation. ESA 2016.
+   *
+   * Each sample draws a pair of distinct nodes and a uniformly random
+   * shortest path between them with a balanced bidirectional BFS, which
+   * expands the side whose frontier has fewer edges and usually visits a
+   * small part of the graph. A node's estimate is the fraction of samples
+   * whose path passes through it, scaled by the number of ordered pairs
+   * n (n - 1) to match the exact algorithms. Samples are drawn in parallel
+   * rounds and sampling stops as soon as, with probability at least
+   * 1 - delta, every estimate is within epsilon n (n - 1) of the exact
+   * centrality, or after the number of samples that guarantees this for
+   * any graph. The sources argument must select all nodes, i.e., be
+   * kBetweennessCentralityAllNodes or a number of sources no less than the
+   * number of nodes.
+   *
+   * This builds the transpose of the graph for the backward searches. The
+   * estimates depend on seed but not on the number of threads.
+   *
+   * @param epsilon The error bound, in (0, 1).
+   * @param delta The failure probability, in (0, 1).
+   * @param seed The seed of the samples.
+   */
+  static BetweennessCentralityPlan Approximate(
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kApproximate, epsilon, delta, seed};
+  }
+
+  /**
+   * Brandes' algorithm on a graph with positive edge weights. For each
+   * source, a delta-stepping SSSP (as in Sssp with SsspPlan::DeltaStep)
+   * with buckets of width 2^step_shift finds the distances; then the path
+   * counts and the dependencies are accumulated in parallel over buckets of
+   * nodes whose distances are closer than the smallest weight, and so have
+   * no shortest path edges between them, forward and then in reverse order.
+   *
+   * @param edge_weight_property_name The edge property with the weights,
+   *    which must be positive.
+   * @param step_shift The log2 of the delta-stepping bucket width.
+   */
+  static BetweennessCentralityPlan Weighted(
+      const std::string& edge_weight_property_name,
+      unsigned step_shift = kDefaultStepShift) {
+    BetweennessCentralityPlan plan{kCPU, kWeighted};
+    plan.edge_weight_property_name_ = edge_weight_property_name;
+    plan.step_shift_ = step_shift;
+    return plan;
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -2,9 +2,13 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PlanTuner.h"
 #include "katana/analytics/Utils.h"
+#include "katana/analytics/Workspace.h"
 
 namespace katana::analytics {
 
@@ -16,26 +20,40 @@ public:
     kAsynchronousTile = 0,
     kAsynchronous,
     kSynchronousTile,
-    kSynchronous
+    kSynchronous,
+    kSynchronousDirectOpt
   };
 
   static const int kDefaultEdgeTileSize = 256;
+  static const uint32_t kDefaultAlpha = 15;
+  static const uint32_t kDefaultBeta = 18;
 
 private:
   Algorithm algorithm_;
   ptrdiff_t edge_tile_size_;
+  uint32_t alpha_;
+  uint32_t beta_;
 
   BfsPlan(
-      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size)
+      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size,
+      uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta)
       : Plan(architecture),
         algorithm_(algorithm),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        alpha_(alpha),
+        beta_(beta) {}
 
 public:
   BfsPlan() : BfsPlan{kCPU, kSynchronousTile, kDefaultEdgeTileSize} {}
 
   Algorithm algorithm() const { return algorithm_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// The push phase switches to pull when the edges leaving the frontier
+  /// exceed 1/alpha of the edges not yet explored.
+  uint32_t alpha() const { return alpha_; }
+  /// The pull phase switches back to push when the frontier is shrinking and
+  /// holds fewer than 1/beta of the nodes.
+  uint32_t beta() const { return beta_; }
 
   static BfsPlan AsynchronousTile(
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -50,6 +68,16 @@ public:
   }
 
   static BfsPlan Synchronous() { return {kCPU, kSynchronous, 0}; }
+
+  /// Direction-optimizing BFS (Beamer et al., SC 2012). Levels with large
+  /// frontiers are computed bottom-up by having each unvisited node search
+  /// its in-edges for a parent in the frontier. The in-edges come from a
+  /// transpose of the graph that is built for the duration of the call, so
+  /// this needs memory for a second copy of the topology.
+  static BfsPlan SynchronousDirectOpt(
+      uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
+    return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
+  }
 };
 
 /// Compute BFS level of nodes in the graph pg starting from start_node. The
@@ -61,6 +89,36 @@ KATANA_EXPORT Result<void> Bfs(
     PropertyGraph* pg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo = {});
 
+/// Like Bfs, but add the output property with workspace, which must belong
+/// to pg, and take the transpose for SynchronousDirectOpt from it (see
+/// AnalyticsWorkspace). Give the output property back with
+/// workspace->ReleaseNodeProperty once it is no longer needed so that later
+/// calls reuse it; with the asynchronous and synchronous algorithms, its
+/// reset then only touches the nodes this call reached.
+KATANA_EXPORT Result<void> Bfs(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& output_property_name, AnalyticsWorkspace* workspace,
+    BfsPlan algo = {});
+
+/// Choose a plan for Bfs on pg by timing the tiled and untiled synchronous
+/// and asynchronous algorithms, with several tile sizes, and
+/// direction-optimizing BFS on a sample of pg, or reuse the choice cached
+/// for pg. See TunePlan.
+KATANA_EXPORT Result<BfsPlan> TuneBfsPlan(
+    const PropertyGraph& pg, const TunerOptions& opts = {});
+
+/// Compute the BFS level of every node from each node in sources. The levels
+/// from sources[i] are stored in a property named output_property_names[i],
+/// in the same form as the output of Bfs. The properties are created by this
+/// function and may not exist before the call.
+///
+/// Sources are processed in batches of 64 that share a single bit-parallel
+/// traversal of the graph (see MultiSourceBfsBatch), which is much faster
+/// than calling Bfs for each source when there are many sources.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does not do an exhaustive check.
 /// The results are approximate and may have false-negatives.
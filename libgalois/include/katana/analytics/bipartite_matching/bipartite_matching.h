@@ -0,0 +1,130 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for bipartite matching, specifying the algorithm and
+/// any parameters associated with it.
+///
+/// The graph must be directed from one side to the other: every edge goes
+/// from a left node to a right node, so no node has both in-edges and
+/// out-edges.
+class BipartiteMatchingPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Maximum cardinality matching by parallel depth-first searches for
+    /// vertex-disjoint augmenting paths; for BipartiteMatching
+    kPothenFan,
+    /// Half-approximate maximum weight matching in which left nodes propose
+    /// to right nodes; for WeightedBipartiteMatching
+    kSuitor,
+  };
+
+private:
+  Algorithm algorithm_;
+  bool karp_sipser_initialization_;
+
+  BipartiteMatchingPlan(
+      Architecture architecture, Algorithm algorithm,
+      bool karp_sipser_initialization)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        karp_sipser_initialization_(karp_sipser_initialization) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan(PothenFan()) {}
+
+  BipartiteMatchingPlan& operator=(const BipartiteMatchingPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Start kPothenFan from a Karp-Sipser matching instead of an empty one
+  bool karp_sipser_initialization() const {
+    return karp_sipser_initialization_;
+  }
+
+  /// The PF+ algorithm of:
+  ///
+  ///   Ariful Azad, Mahantesh Halappanavar, Sivasankaran Rajamanickam, Erik
+  ///   G. Boman, Arif Khan and Alex Pothen. Multithreaded Algorithms for
+  ///   Maximum Matching in Bipartite Graphs. IPDPS, 2012.
+  ///
+  /// Unmatched left nodes search for augmenting paths in parallel, each
+  /// right node being visited by at most one search per phase, until a
+  /// phase finds none. The searches look ahead for unmatched right nodes
+  /// and alternate the order in which they scan edges between phases.
+  ///
+  /// The initial matching is a parallel Karp-Sipser greedy matching, which
+  /// first matches the left nodes that have a single unmatched neighbor.
+  static BipartiteMatchingPlan PothenFan(
+      bool karp_sipser_initialization = true) {
+    return {kCPU, kPothenFan, karp_sipser_initialization};
+  }
+
+  /// The suitor algorithm of:
+  ///
+  ///   Fredrik Manne and Mahantesh Halappanavar. New Effective Multithreaded
+  ///   Matching Algorithms. IPDPS, 2014.
+  ///
+  /// restricted to proposals from left nodes. Every edge of positive weight
+  /// ends up next to a matched edge at least as heavy, so the matching has
+  /// at least half the maximum weight.
+  static BipartiteMatchingPlan Suitor() { return {kCPU, kSuitor, false}; }
+};
+
+/// Compute a maximum cardinality matching of pg, whose edges must all go
+/// from left nodes to right nodes. Of several parallel edges, at most one is
+/// matched.
+/// The result is stored in a uint8 edge property named by
+/// output_property_name: 1 for matched edges and 0 otherwise.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan = {});
+
+/// Check that the edges in the property named property_name form a matching
+/// and that there is no augmenting path, so it has maximum cardinality.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+/// Compute a matching of pg of large total weight, whose edges must all go
+/// from left nodes to right nodes, with the weights in the edge property
+/// named edge_weight_property_name. Edges whose weight is not positive are
+/// never matched.
+/// The result is stored as by BipartiteMatching.
+KATANA_EXPORT Result<void> WeightedBipartiteMatching(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan::Suitor());
+
+/// Check that the edges in the property named property_name form a matching
+/// and that every edge of positive weight shares a node with a matched edge
+/// at least as heavy, so the matching has at least half the maximum weight.
+KATANA_EXPORT Result<void> WeightedBipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of matched edges.
+  uint64_t matching_size;
+  /// The number of nodes with out-edges.
+  uint64_t n_left_nodes;
+  /// The number of nodes with in-edges.
+  uint64_t n_right_nodes;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
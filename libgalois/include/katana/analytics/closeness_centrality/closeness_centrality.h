@@ -0,0 +1,105 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for ClosenessCentrality and HarmonicCentrality,
+/// specifying the algorithm and any parameters associated with it.
+///
+/// Both algorithms run breadth-first searches in batches of 64 sources that
+/// share one bit-parallel multi-source BFS (see MultiSourceBfsBatch).
+class ClosenessCentralityPlan : public Plan {
+public:
+  enum Algorithm {
+    /// A search from every node
+    kExact,
+    /// Searches from a sample of the nodes
+    kSampled,
+  };
+
+  static constexpr double kDefaultEpsilon = 0.1;
+
+private:
+  Algorithm algorithm_;
+  double epsilon_;
+
+  ClosenessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon)
+      : Plan(architecture), algorithm_(algorithm), epsilon_(epsilon) {}
+
+public:
+  ClosenessCentralityPlan() : ClosenessCentralityPlan(Exact()) {}
+
+  ClosenessCentralityPlan& operator=(const ClosenessCentralityPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The error bound of kSampled, relative to the diameter of the graph
+  double epsilon() const { return epsilon_; }
+
+  static ClosenessCentralityPlan Exact() {
+    return {kCPU, kExact, kDefaultEpsilon};
+  }
+
+  /// Estimate the centralities from the searches of ceil(ln(n) / epsilon^2)
+  /// pivots picked with SourcePicker, following
+  ///
+  ///   David Eppstein and Joseph Wang. Fast Approximation of Centrality.
+  ///   Journal of Graph Algorithms and Applications, 2004.
+  ///
+  /// With high probability, the estimated average distance to each node is
+  /// within epsilon times the diameter of the graph of the exact one. The
+  /// sample is random, so this plan cannot be deterministic.
+  static ClosenessCentralityPlan Sampled(double epsilon = kDefaultEpsilon) {
+    return {kCPU, kSampled, epsilon};
+  }
+};
+
+/// Compute the closeness centrality of each node in the graph: the number of
+/// other nodes that reach the node divided by the sum of their distances to
+/// it, scaled by the fraction of the other nodes that reach it (Wasserman and
+/// Faust), which keeps values comparable across components. Distances follow
+/// outgoing edges toward each node; in a symmetric graph this is the usual
+/// closeness. Nodes that no other node reaches have centrality 0.
+///
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type double.
+KATANA_EXPORT Result<void> ClosenessCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+/// Compute the harmonic centrality of each node in the graph: the sum of the
+/// reciprocals of the distances from the other nodes to it, where nodes that
+/// do not reach it add 0. Unlike closeness, it is well defined for graphs
+/// that are not strongly connected.
+///
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type double.
+KATANA_EXPORT Result<void> HarmonicCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+struct KATANA_EXPORT ClosenessCentralityStatistics {
+  /// The maximum centrality across all nodes.
+  double max_centrality;
+  /// The minimum centrality across all nodes.
+  double min_centrality;
+  /// The average centrality across all nodes.
+  double average_centrality;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<ClosenessCentralityStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
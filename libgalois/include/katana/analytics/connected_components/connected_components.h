@@ -2,9 +2,14 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PlanTuner.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -155,12 +160,81 @@ public:
 /// The algorithm, neighbor sample size and component sample frequency and tile size
 /// parameters can be specified, but have reasonable defaults. Not all parameters
 /// are used by the algorithms.
+/// The labels of components depend on the algorithm and schedule; if the plan
+/// is deterministic (see Plan::deterministic), each component is labeled with
+/// its smallest node instead.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
 KATANA_EXPORT Result<void> ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Choose a plan for ConnectedComponents on pg by timing the parallel
+/// algorithms, with several tile sizes for the tiled ones, on a sample of
+/// pg, or reuse the choice cached for pg. See TunePlan.
+KATANA_EXPORT Result<ConnectedComponentsPlan> TuneConnectedComponentsPlan(
+    const PropertyGraph& pg, const TunerOptions& opts = {});
+
+/// Connected components of a graph that only gains edges, kept up to date
+/// batch by batch instead of being recomputed after every batch.
+///
+/// The component property is itself a lock-free union-find forest: each
+/// node holds its parent, and the root of each tree is the smallest node of
+/// its component. Inserting edges hooks the roots of their ends together in
+/// parallel. Nodes are pointed directly at their roots again lazily, by
+/// Component or by Compress, so a batch costs about as much as its edges
+/// until the labels are needed. Once compressed, the property holds the
+/// same labels as ConnectedComponents with a deterministic plan.
+///
+/// Since the forest is a node property, writing the graph persists it
+/// (compressed or not) and Make picks it up when the graph is loaded again.
+class KATANA_EXPORT IncrementalConnectedComponents {
+public:
+  /// Keep the components of pg in the uint64 node property named
+  /// property_name. If the property does not exist, it is computed with
+  /// ConnectedComponents using plan. Otherwise it must hold components
+  /// labeled by their smallest node, e.g., the output of a deterministic
+  /// plan or of an Afforest plan, or a forest left by an earlier
+  /// IncrementalConnectedComponents. pg is expected to be symmetric.
+  static Result<IncrementalConnectedComponents> Make(
+      PropertyGraph* pg, const std::string& property_name,
+      ConnectedComponentsPlan plan = {});
+
+  /// Join the components of the ends of each of edges, in parallel. The
+  /// edges are not added to the topology of the graph; callers that want
+  /// them there add them separately.
+  Result<void> InsertEdges(
+      const std::vector<std::pair<uint32_t, uint32_t>>& edges);
+
+  /// The component of node, which is the smallest node of the component.
+  /// node is pointed directly at it on the way.
+  uint64_t Component(uint32_t node);
+
+  /// Point every node directly at the root of its tree so that the
+  /// property holds component labels. Does nothing if no edges were
+  /// inserted since the last call.
+  void Compress();
+
+  /// Whether every node points directly at the root of its tree
+  bool compressed() const { return compressed_; }
+
+  const std::string& property_name() const { return property_name_; }
+
+private:
+  IncrementalConnectedComponents(
+      std::string property_name, std::shared_ptr<arrow::ChunkedArray> property,
+      uint64_t* parent)
+      : property_name_(std::move(property_name)),
+        property_(std::move(property)),
+        parent_(parent) {}
+
+  std::string property_name_;
+  /// Keeps the forest alive even if the property is removed from the graph
+  std::shared_ptr<arrow::ChunkedArray> property_;
+  uint64_t* parent_;
+  bool compressed_{true};
+};
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -0,0 +1,171 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CONTRACTIONHIERARCHY_CONTRACTIONHIERARCHY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CONTRACTIONHIERARCHY_CONTRACTIONHIERARCHY_H_
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace katana::analytics {
+
+/// A computational plan for ContractionHierarchy::Build, specifying the
+/// algorithm and any parameters associated with it.
+class ContractionHierarchyPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Contract an independent set of nodes whose priority (edge
+    /// difference plus contracted neighbors) is lower than that of all of
+    /// their neighbors in each round, in parallel, as in
+    ///
+    ///   Christian Vetter. Parallel Time-Dependent Contraction Hierarchies.
+    ///   Student research project, Karlsruhe Institute of Technology, 2009.
+    kIndependentSet,
+  };
+
+  static const uint32_t kDefaultWitnessSettleLimit = 500;
+
+private:
+  Algorithm algorithm_;
+  uint32_t witness_settle_limit_;
+
+  ContractionHierarchyPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t witness_settle_limit)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        witness_settle_limit_(witness_settle_limit) {}
+
+public:
+  ContractionHierarchyPlan()
+      : ContractionHierarchyPlan(IndependentSet()) {}
+
+  ContractionHierarchyPlan& operator=(const ContractionHierarchyPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of nodes a witness search settles before giving up and
+  /// adding a shortcut. Lower limits build faster but add more shortcuts;
+  /// distances are exact either way.
+  uint32_t witness_settle_limit() const { return witness_settle_limit_; }
+
+  static ContractionHierarchyPlan IndependentSet(
+      uint32_t witness_settle_limit = kDefaultWitnessSettleLimit) {
+    return {kCPU, kIndependentSet, witness_settle_limit};
+  }
+};
+
+/// A contraction hierarchy of a weighted graph answers point-to-point
+/// shortest path queries with two small Dijkstra searches instead of a
+/// search over the whole graph:
+///
+///   Robert Geisberger, Peter Sanders, Dominik Schultes, and Daniel Delling.
+///   Contraction Hierarchies: Faster and Simpler Hierarchical Routing in Road
+///   Networks. WEA 2008.
+///
+/// Nodes are contracted one level at a time, adding shortcut edges that
+/// preserve the distances between the remaining nodes. A query searches
+/// forward from the source and backward from the target only along edges
+/// toward nodes contracted later.
+///
+/// The hierarchy consists of the upward edges of each direction and can be
+/// stored with the graph as two auxiliary topologies (see
+/// PropertyGraph::AddAuxTopology), so that later jobs load it instead of
+/// building it again. It stays valid only as long as the topology and the
+/// weights of the graph do not change.
+class KATANA_EXPORT ContractionHierarchy {
+public:
+  /// The distance between nodes that are not connected
+  static constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+  /// An edge of the hierarchy. Shortcuts remember the contracted node they
+  /// bypass so that paths can be unpacked into edges of the graph.
+  struct ShortcutEdge {
+    double weight;
+    uint32_t middle;
+    uint32_t padding;
+  };
+  static constexpr uint32_t kNoMiddle = std::numeric_limits<uint32_t>::max();
+
+  /// The state of the searches of a query. It is reused between queries to
+  /// avoid allocations; use one per thread.
+  class KATANA_EXPORT Query {
+    friend class ContractionHierarchy;
+
+    /// The distance to a node and the edge of the hierarchy it was reached
+    /// by, which leaves or enters parent
+    struct Label {
+      double distance;
+      uint64_t edge;
+      uint32_t parent;
+    };
+    struct Side {
+      std::vector<Label> labels;
+      std::vector<uint32_t> touched;
+      std::vector<std::pair<double, uint32_t>> heap;
+    };
+    Side sides_[2];
+
+  public:
+    explicit Query(const ContractionHierarchy& hierarchy);
+  };
+
+  /// Build the hierarchy of pg, whose edges are weighted by the edge
+  /// property named edge_weight_property_name. It must be of an integer or
+  /// floating point type and not negative.
+  static Result<ContractionHierarchy> Build(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      ContractionHierarchyPlan plan = {});
+
+  /// Store this hierarchy of pg as the auxiliary topologies name + "-up" and
+  /// name + "-down" the next time pg is written.
+  Result<void> Store(PropertyGraph* pg, const std::string& name = "ch") const;
+
+  /// Load a hierarchy stored with Store. It refers to memory owned by pg.
+  static Result<ContractionHierarchy> Load(
+      const PropertyGraph& pg, const std::string& name = "ch");
+
+  /// The length of the shortest path from source to target, or kInfinity
+  double Distance(uint32_t source, uint32_t target, Query* query) const;
+
+  /// The shortest path from source to target, with the shortcuts replaced
+  /// by the edges of the graph they bypass. The path has no nodes if target
+  /// cannot be reached.
+  WeightedPath ShortestPath(
+      uint32_t source, uint32_t target, Query* query) const;
+
+  uint64_t num_nodes() const { return up_.num_nodes(); }
+  /// The number of edges of the hierarchy, including shortcuts
+  uint64_t num_edges() const { return up_.num_edges() + down_.num_edges(); }
+
+private:
+  ContractionHierarchy(
+      GraphTopology up, std::shared_ptr<arrow::Buffer> up_edges,
+      GraphTopology down, std::shared_ptr<arrow::Buffer> down_edges);
+
+  /// Run both searches and return the node where the shortest path
+  /// meets, or kNoMiddle
+  uint32_t Search(uint32_t source, uint32_t target, Query* query) const;
+
+  /// Append the edges of the graph bypassed by the edge from -> to of the
+  /// hierarchy to path, excluding from
+  void Unpack(
+      uint32_t from, uint32_t to, const ShortcutEdge& edge,
+      std::vector<uint32_t>* path) const;
+
+  /// Edges u -> v of the graph or shortcuts where v was contracted after u
+  GraphTopology up_;
+  std::shared_ptr<arrow::Buffer> up_edges_;
+  /// Edges v -> u, stored at u, where v was contracted after u
+  GraphTopology down_;
+  std::shared_ptr<arrow::Buffer> down_edges_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for HypergraphPartition, specifying the algorithm
+/// and any parameters associated with it.
+class HypergraphPartitionPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Coarsen the hypergraph by merging the nodes of hyperedges, bisect the
+    /// coarsest hypergraph and refine the bisection while projecting it
+    /// back; k-way partitions are made by recursive bisection, with all
+    /// bisections of a level of the recursion done together
+    kBiPart,
+  };
+
+  /// Which hyperedges merge their nodes first during coarsening.
+  enum MatchingPolicy {
+    /// Hyperedges with more nodes
+    kHigherDegree,
+    /// Hyperedges with fewer nodes
+    kLowerDegree,
+    /// Hyperedges whose nodes weigh more
+    kHigherWeight,
+    /// Hyperedges whose nodes weigh less
+    kLowerWeight,
+    /// Hyperedges in the order of a deterministic hash of their ids
+    kRandom,
+  };
+
+  static const MatchingPolicy kDefaultMatchingPolicy = kHigherDegree;
+  static const uint32_t kDefaultMaxCoarseningLevels = 25;
+  static const bool kDefaultDeterministic = false;
+
+private:
+  Algorithm algorithm_;
+  MatchingPolicy matching_policy_;
+  uint32_t max_coarsening_levels_;
+  bool deterministic_;
+
+  HypergraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm,
+      MatchingPolicy matching_policy, uint32_t max_coarsening_levels,
+      bool deterministic)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        matching_policy_(matching_policy),
+        max_coarsening_levels_(max_coarsening_levels),
+        deterministic_(deterministic) {}
+
+public:
+  HypergraphPartitionPlan() : HypergraphPartitionPlan(BiPart()) {}
+
+  HypergraphPartitionPlan& operator=(const HypergraphPartitionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  MatchingPolicy matching_policy() const { return matching_policy_; }
+
+  /// The maximum number of times a hypergraph is coarsened before it is
+  /// bisected.
+  uint32_t max_coarsening_levels() const { return max_coarsening_levels_; }
+
+  /// If true, nodes with (nearly) equal gains are ordered exactly, so the
+  /// partition does not depend on the number of threads or on scheduling.
+  bool deterministic() const { return deterministic_; }
+
+  /// The multilevel hypergraph partitioner of the lonestar bipart
+  /// application:
+  ///
+  ///   Sepideh Maleki, Udit Agarwal, Martin Burtscher, and Keshav Pingali.
+  ///   BiPart: A Parallel and Deterministic Hypergraph Partitioner. PPoPP
+  ///   2021.
+  static HypergraphPartitionPlan BiPart(
+      MatchingPolicy matching_policy = kDefaultMatchingPolicy,
+      uint32_t max_coarsening_levels = kDefaultMaxCoarseningLevels,
+      bool deterministic = kDefaultDeterministic) {
+    return {
+        kCPU, kBiPart, matching_policy, max_coarsening_levels, deterministic};
+  }
+};
+
+/// The partition of a hyperedge whose nodes are in more than one partition.
+constexpr uint32_t kHyperedgeCut = std::numeric_limits<uint32_t>::max();
+
+/// Divide the nodes of the hypergraph pg into num_partitions partitions so
+/// that few hyperedges have nodes in more than one partition and every
+/// partition has about the same number of nodes.
+///
+/// pg is the bipartite form of the hypergraph: the nodes with outgoing edges
+/// are hyperedges and their edges go to the nodes they contain, which have
+/// no outgoing edges. The partition of each node, from 0 to num_partitions -
+/// 1, is stored in a uint32 node property named by output_property_name. A
+/// hyperedge gets the partition of its nodes if they are all in one
+/// partition and kHyperedgeCut otherwise.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> HypergraphPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name,
+    HypergraphPartitionPlan plan = {});
+
+/// Divide the nodes of a hypergraph with num_hyperedges hyperedges and
+/// num_nodes nodes into num_partitions partitions, as above, without
+/// building a property graph. pins are the (hyperedge, node) pairs of nodes
+/// in hyperedges. Returns the partition of each node.
+KATANA_EXPORT Result<std::vector<uint32_t>> HypergraphPartition(
+    uint32_t num_hyperedges, uint32_t num_nodes,
+    std::vector<std::pair<uint32_t, uint32_t>> pins, uint32_t num_partitions,
+    HypergraphPartitionPlan plan = {});
+
+/// Check that every node of the hypergraph pg is in one of num_partitions
+/// partitions and that every hyperedge is in the partition of its nodes or
+/// is cut.
+KATANA_EXPORT Result<void> HypergraphPartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+struct KATANA_EXPORT HypergraphPartitionStatistics {
+  /// The number of partitions.
+  uint32_t num_partitions;
+  /// The number of hyperedges with nodes in more than one partition.
+  uint64_t cut_hyperedges;
+  /// The sum over hyperedges of the number of partitions of their nodes
+  /// minus one, the (connectivity - 1) metric of hMETIS.
+  uint64_t connectivity;
+  /// The number of nodes in the largest partition over the average.
+  double node_imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HypergraphPartitionStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -20,7 +20,8 @@ public:
     // kNondeterministic,
     // kDeterministicBase,
     kPriority,
-    kEdgeTiledPriority
+    kEdgeTiledPriority,
+    kOrderedPriority
   };
 
 private:
@@ -46,6 +47,15 @@ public:
     return {kCPU, kEdgeTiledPriority};
   }
 
+  /// The greedy independent set of the nodes taken in a fixed pseudo-random
+  /// order: a node is in the set unless an earlier neighbor is. A node is
+  /// decided as soon as all of its earlier neighbors are, and ready nodes are
+  /// scheduled in order on katana::AdaptiveOrderedByIntegerMetric. The result
+  /// does not depend on the schedule.
+  static IndependentSetPlan OrderedPriority() {
+    return {kCPU, kOrderedPriority};
+  }
+
   static IndependentSetPlan FromAlgorithm(Algorithm algorithm) {
     return {kCPU, algorithm};
   }
@@ -54,6 +64,9 @@ public:
 /// Find a maximal (not the maximum) independent set in the graph and create an
 /// indicator property that is true for elements of the independent set.
 /// The graph must be symmetric.
+/// If the plan is deterministic (see Plan::deterministic), the pull algorithm
+/// is used in place of the unordered priority algorithms, whose result
+/// depends on the schedule.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call. The created property has type uint8_t.
 KATANA_EXPORT Result<void> IndependentSet(
@@ -74,6 +87,76 @@ struct KATANA_EXPORT IndependentSetStatistics {
       katana::PropertyGraph* pg, const std::string& property_name);
 };
 
+/// A computational plan for GraphColoring, specifying the algorithm and any
+/// parameters associated with it.
+///
+/// Both algorithms give nodes with larger degrees higher priority (largest
+/// degree first) and order nodes of the same degree pseudo-randomly, like the
+/// priority algorithms of IndependentSet.
+class GraphColoringPlan : public Plan {
+public:
+  enum Algorithm {
+    kJonesPlassmann,
+    kSpeculative,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  GraphColoringPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan(kCPU, kSpeculative) {}
+
+  GraphColoringPlan& operator=(const GraphColoringPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Color the graph in rounds. In each round, the uncolored nodes that have
+  /// no uncolored neighbor of higher priority, which form an independent set,
+  /// take the smallest color that none of their neighbors has. The result
+  /// does not depend on the schedule.
+  static GraphColoringPlan JonesPlassmann() { return {kCPU, kJonesPlassmann}; }
+
+  /// Color all uncolored nodes in parallel with the smallest color that none
+  /// of their neighbors has at the time, then uncolor the lower priority node
+  /// of each pair of neighbors that took the same color, and repeat. Usually
+  /// takes fewer rounds than JonesPlassmann.
+  static GraphColoringPlan Speculative() { return {kCPU, kSpeculative}; }
+
+  static GraphColoringPlan FromAlgorithm(Algorithm algorithm) {
+    return {kCPU, algorithm};
+  }
+};
+
+/// Color the nodes of the graph so that no two neighbors have the same color
+/// and create a property with the color of each node. Colors count from 0,
+/// and a node with d neighbors gets a color of at most d.
+/// The graph must be symmetric. Self loops are ignored.
+/// If the plan is deterministic (see Plan::deterministic), Jones-Plassmann is
+/// used in place of the speculative algorithm, whose result depends on the
+/// schedule.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 
 #endif
@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KCLIQUE_KCLIQUE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KCLIQUE_KCLIQUE_H_
+
+#include <functional>
+#include <memory>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for KCliqueCount.
+class KCliquePlan : public Plan {
+public:
+  enum Algorithm {
+    kOrientedListing,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  KCliquePlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KCliquePlan() : KCliquePlan{kCPU, kOrientedListing} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// List the cliques of the orientation of the graph by degree (see
+  /// PropertyGraph::OrientByDegree), so that each clique is found once, from
+  /// its lowest ranked node, by intersecting the out-neighbors of the nodes
+  /// chosen so far. The out-degrees of the orientation bound the candidates
+  /// at every level.
+  ///
+  ///   Norishige Chiba and Takao Nishizeki. Arboricity and Subgraph Listing
+  ///   Algorithms. SIAM Journal on Computing, 1985.
+  ///   Maximilien Danisch, Oana Balalau, and Mauro Sozio. Listing k-cliques
+  ///   in Sparse Real-World Graphs. WWW 2018.
+  static KCliquePlan OrientedListing() { return {kCPU, kOrientedListing}; }
+};
+
+/// Count the cliques of k nodes in the graph. The graph must be symmetric;
+/// self loops and repeated edges are ignored. k = 3 counts triangles.
+///
+/// The orientation of pg by degree is built on first use and kept with pg,
+/// so it is shared with TriangleCount and LocalClusteringCoefficient.
+KATANA_EXPORT Result<uint64_t> KCliqueCount(
+    PropertyGraph* pg, uint32_t k, KCliquePlan plan = {});
+
+/// Called with the k node ids of a clique, which are valid only during the
+/// call
+using CliqueCallback = std::function<void(const uint32_t* nodes)>;
+
+/// Call fn once with each clique of k nodes in the graph, e.g., with each
+/// triangle for k = 3, and return the number of cliques. The nodes of a
+/// clique are in increasing rank of the orientation of pg by degree, not in
+/// increasing id. The cliques are found as by KCliqueCount and are not
+/// stored, so listing needs no more memory than counting. fn is called
+/// concurrently from all threads and must be thread safe.
+KATANA_EXPORT Result<uint64_t> KCliqueList(
+    PropertyGraph* pg, uint32_t k, const CliqueCallback& fn,
+    KCliquePlan plan = {});
+
+/// Called with a batch of cliques from KCliqueListBatches; an error stops
+/// the listing
+using CliqueBatchCallback =
+    std::function<Result<void>(const std::shared_ptr<arrow::RecordBatch>&)>;
+
+/// The default number of cliques of a batch of KCliqueListBatches
+constexpr size_t kDefaultCliqueBatchRows = size_t{1} << 16;
+
+/// Stream the cliques of k nodes in the graph as Arrow record batches with
+/// the uint32 columns node0, ..., node{k-1}, one row per clique, and return
+/// the number of cliques. Each thread fills its own batch and hands it to
+/// consume, from that thread, once it has batch_rows rows; the partial
+/// batches are handed over at the end. So at most batch_rows cliques per
+/// thread are in memory however many there are, and consume, which is
+/// called concurrently, should write the batches out or reduce them. If
+/// consume fails, the listing stops early and returns the first error.
+KATANA_EXPORT Result<uint64_t> KCliqueListBatches(
+    PropertyGraph* pg, uint32_t k, const CliqueBatchCallback& consume,
+    size_t batch_rows = kDefaultCliqueBatchRows, KCliquePlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
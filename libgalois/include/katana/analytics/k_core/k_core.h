@@ -35,10 +35,14 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
-  /// Synchronous k-core algorithm.
+  /// Synchronous k-core algorithm. KCoreDecomposition peels one core
+  /// number at a time.
   static KCorePlan Synchronous() { return {kCPU, kSynchronous}; }
 
-  /// Asynchronous k-core algorithm.
+  /// Asynchronous k-core algorithm. KCoreDecomposition lowers an estimate of
+  /// the core number of each node until it is consistent with its
+  /// neighbors, scheduling nodes with lower estimates first (see
+  /// katana::AdaptiveOrderedByIntegerMetric).
   static KCorePlan Asynchronous() { return {kCPU, kAsynchronous}; }
 };
 
@@ -55,6 +59,19 @@ KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
 
+/// Compute the core number of every node of pg: the largest k such that the
+/// node is in the k-core. The pg must be symmetric. Unlike KCore, this
+/// finds every core in one pass.
+/// The result is stored in a uint32 node property named by
+/// output_property_name, which is created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KCorePlan plan = KCorePlan());
+
+KATANA_EXPORT Result<void> KCoreDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT KCoreStatistics {
   /// Total number of node left in the core.
   uint64_t number_of_nodes_in_kcore;
@@ -67,5 +84,18 @@ struct KATANA_EXPORT KCoreStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KCoreDecompositionStatistics {
+  /// The largest core number of any node, also called the degeneracy.
+  uint32_t max_core_number;
+  /// Total number of nodes in the core of the largest core number.
+  uint64_t nodes_in_max_core;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KCoreDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
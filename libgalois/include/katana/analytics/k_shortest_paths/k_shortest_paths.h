@@ -0,0 +1,94 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for KShortestPaths and KShortestSimplePaths,
+/// specifying the algorithm and any parameters associated with it.
+class KShortestPathsPlan : public Plan {
+public:
+  enum Algorithm {
+    /// KShortestSimplePaths finds the shortest paths from each source with
+    /// delta stepping and the spur paths of Yen's algorithm in parallel.
+    /// KShortestPaths settles every node up to k times in a search from
+    /// each source, searching from different sources in parallel.
+    kDeltaStep,
+  };
+
+  static const unsigned kDefaultDeltaShift = 13;
+
+private:
+  Algorithm algorithm_;
+  unsigned delta_shift_;
+
+  KShortestPathsPlan(
+      Architecture architecture, Algorithm algorithm, unsigned delta_shift)
+      : Plan(architecture), algorithm_(algorithm), delta_shift_(delta_shift) {}
+
+public:
+  KShortestPathsPlan() : KShortestPathsPlan(DeltaStep()) {}
+
+  KShortestPathsPlan& operator=(const KShortestPathsPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The exponent of the delta step size (2 based). A delta shift of 4 gives
+  /// buckets of width 16.
+  unsigned delta_shift() const { return delta_shift_; }
+
+  static KShortestPathsPlan DeltaStep(
+      unsigned delta_shift = kDefaultDeltaShift) {
+    return {kCPU, kDeltaStep, delta_shift};
+  }
+};
+
+/// A path found by KShortestPaths or KShortestSimplePaths.
+struct KATANA_EXPORT WeightedPath {
+  /// The nodes of the path, from the source to the target
+  std::vector<uint32_t> nodes;
+  /// The sum of the weights of the edges of the path
+  double weight;
+};
+
+/// A pair of a source and a target node.
+using PathQuery = std::pair<uint32_t, uint32_t>;
+
+/// Find the k shortest paths from source to target for each of queries,
+/// where paths may visit a node more than once. The edges of pg are
+/// weighted by the edge property named edge_weight_property_name, which
+/// must be of an integer or floating point type and not negative.
+///
+/// The result holds, for each query in order, its paths in order of weight;
+/// a query has fewer than k paths when there are fewer. Queries with the
+/// same source share a search, so a batch of queries costs about as much as
+/// one query per distinct source.
+KATANA_EXPORT Result<std::vector<std::vector<WeightedPath>>> KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan = {});
+
+/// Find the k shortest simple paths, which visit no node twice, from source
+/// to target for each of queries, using Yen's algorithm:
+///
+///   Jin Y. Yen. Finding the K Shortest Loopless Paths in a Network.
+///   Management Science, 1971.
+///
+/// Edge weights and the result are as for KShortestPaths; of paths of equal
+/// weight, which come first is unspecified. Queries with the same source
+/// share one shortest path tree.
+KATANA_EXPORT Result<std::vector<std::vector<WeightedPath>>>
+KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -16,7 +16,7 @@ namespace katana::analytics {
 class KTrussPlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss };
+  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss, kPeeling };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -27,7 +27,7 @@ private:
       : Plan(architecture), algorithm_(algorithm) {}
 
 public:
-  KTrussPlan() : KTrussPlan{kCPU, kBsp} {}
+  KTrussPlan() : KTrussPlan{kCPU, kPeeling} {}
 
   Algorithm algorithm() const { return algorithm_; }
 
@@ -39,6 +39,11 @@ public:
 
   /// Compute k-1 core and then k-truss algorithm.
   static KTrussPlan BspCoreThenTruss() { return {kCPU, kBspCoreThenTruss}; }
+
+  /// Count the support of every edge once, then remove the edges with
+  /// support under k-2 and update only the edges that shared a triangle with
+  /// them, until no such edge is left.
+  static KTrussPlan Peeling() { return {kCPU, kPeeling}; }
 };
 
 /// Compute the k-truss for pg. The pg is expected to be
@@ -55,6 +60,19 @@ KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
 
+/// Compute the truss number of every edge of pg: the largest k such that the
+/// edge is in the k-truss. The pg must be symmetric. Edges that are in no
+/// triangle have truss number 2. Unlike KTruss, this finds every truss in
+/// one pass, peeling edges in increasing order of support.
+/// The result is stored in a uint32 edge property named by
+/// output_property_name, which is created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+KATANA_EXPORT Result<void> KTrussDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT KTrussStatistics {
   /// Total number of edges left in the truss.
   uint64_t number_of_edges_left;
@@ -67,5 +85,18 @@ struct KATANA_EXPORT KTrussStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KTrussDecompositionStatistics {
+  /// The largest truss number of any edge.
+  uint32_t max_truss_number;
+  /// Total number of edges in the truss of the largest truss number.
+  uint64_t edges_in_max_truss;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KTrussDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
@@ -0,0 +1,116 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for LabelPropagation, specifying the algorithm and
+/// any parameters associated with it.
+class LabelPropagationPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Every node in the frontier adopts the most frequent label among its
+    /// neighbors, all reading the labels of the previous round
+    kSynchronous,
+  };
+
+  static const uint32_t kDefaultMaxIterations = 20;
+  static const uint32_t kDefaultHeavyDegree = 1 << 14;
+  static const uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  uint32_t max_iterations_;
+  uint32_t heavy_degree_;
+  uint64_t seed_;
+
+  LabelPropagationPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t max_iterations,
+      uint32_t heavy_degree, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_iterations_(max_iterations),
+        heavy_degree_(heavy_degree),
+        seed_(seed) {}
+
+public:
+  LabelPropagationPlan() : LabelPropagationPlan(Synchronous()) {}
+
+  LabelPropagationPlan& operator=(const LabelPropagationPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of rounds after which propagation stops even if some
+  /// labels are still changing.
+  uint32_t max_iterations() const { return max_iterations_; }
+  /// Nodes with at least this many edges count their neighbors' labels
+  /// with a parallel sort, one node at a time, instead of a sort on one
+  /// thread.
+  uint32_t heavy_degree() const { return heavy_degree_; }
+  /// Seeds the order in which tied labels are preferred.
+  uint64_t seed() const { return seed_; }
+
+  /// Synchronous label propagation:
+  ///
+  ///   Usha Nandini Raghavan, Réka Albert, and Soundar Kumara. Near Linear
+  ///   Time Algorithm to Detect Community Structures in Large-Scale
+  ///   Networks. Physical Review E, 2007.
+  ///
+  /// Only the neighbors of nodes that changed label in a round are
+  /// recomputed in the next one.
+  static LabelPropagationPlan Synchronous(
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint64_t seed = kDefaultSeed,
+      uint32_t heavy_degree = kDefaultHeavyDegree) {
+    return {kCPU, kSynchronous, max_iterations, heavy_degree, seed};
+  }
+};
+
+/// Find communities of pg by label propagation. Every node starts with its
+/// own ID as its label and repeatedly adopts the label most frequent among
+/// its neighbors, keeping its label if it is among the most frequent and
+/// otherwise breaking ties by an order of labels derived from plan.seed().
+/// Propagation stops when no label changes or after plan.max_iterations()
+/// rounds, which bounds the rounds spent on labels that oscillate. The
+/// result is the same for any number of threads. The pg must be symmetric.
+///
+/// This is much cheaper than LouvainClustering, so it is useful as a first
+/// pass on very large graphs, but it optimizes no objective and may leave
+/// communities that are not connected.
+///
+/// The result is stored in a uint32 node property named by
+/// output_property_name: the label of each node, which is the ID of some
+/// node. The property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> LabelPropagation(
+    PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan = {});
+
+/// Check that every label in the property named property_name is a node ID.
+KATANA_EXPORT Result<void> LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT LabelPropagationStatistics {
+  /// Total number of communities, including single nodes.
+  uint64_t n_communities;
+  /// Total number of communities with more than 1 node.
+  uint64_t n_non_trivial_communities;
+  /// The number of nodes in the largest community.
+  uint64_t largest_community_size;
+  /// The proportion of nodes in the largest community.
+  double largest_community_proportion;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<LabelPropagationStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -14,7 +14,11 @@ namespace katana::analytics {
 /// Clustering Coefficient of the nodes in the graph.
 class LocalClusteringCoefficientPlan : public Plan {
 public:
-  enum Algorithm { kOrderedCountAtomics, kOrderedCountPerThread };
+  enum Algorithm {
+    kOrderedCountAtomics,
+    kOrderedCountPerThread,
+    kWedgeSampling
+  };
 
   enum Relabeling {
     kRelabel,
@@ -24,19 +28,26 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static const uint32_t kDefaultSamplesPerNode = 1024;
+  static const uint64_t kDefaultSeed = 0;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  uint32_t samples_per_node_;
+  uint64_t seed_;
 
   LocalClusteringCoefficientPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, uint32_t samples_per_node = kDefaultSamplesPerNode,
+      uint64_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        samples_per_node_(samples_per_node),
+        seed_(seed) {}
 
 public:
   LocalClusteringCoefficientPlan()
@@ -47,6 +58,9 @@ public:
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  /// The number of wedges kWedgeSampling draws at each node
+  uint32_t samples_per_node() const { return samples_per_node_; }
+  uint64_t seed() const { return seed_; }
 
   /**
    * An ordered count algorithm that sorts the nodes by degree before
@@ -68,13 +82,41 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCountPerThread, edges_sorted, relabeling};
   }
+
+  /**
+   * Estimate the coefficient of each node from the fraction of
+   * samples_per_node of its wedges (pairs of its neighbors), drawn uniformly
+   * at random, that are closed by an edge. Nodes with at most
+   * samples_per_node wedges are computed exactly. The standard error of each
+   * estimate is at most 1 / (2 sqrt(samples_per_node)), e.g., 1.6% for the
+   * default.
+   *
+   *   C. Seshadhri, Ali Pinar, and Tamara G. Kolda. Triadic Measures on
+   *   Graphs: The Power of Wedge Sampling. SDM 2013.
+   *
+   * @param samples_per_node The number of wedges to sample at each node.
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param seed The seed of the samples.
+   */
+  static LocalClusteringCoefficientPlan WedgeSampling(
+      uint32_t samples_per_node = kDefaultSamplesPerNode,
+      bool edges_sorted = kDefaultEdgeSorted, uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kWedgeSampling,
+            edges_sorted,
+            kNoRelabel,
+            samples_per_node,
+            seed};
+  }
 };
 
 /**
  * Count the total number of triangles in the graph. The graph must be
  * symmetric!
  *
- * This algorithm copies the graph internally.
+ * Relabeling orients pg by degree (see PropertyGraph::OrientByDegree), which
+ * is kept with pg and shared with TriangleCount. Otherwise, unless the edges
+ * are sorted, this algorithm copies the graph internally.
  *
  * @param pg The graph to process.
  * @param output_property_name name of the output property
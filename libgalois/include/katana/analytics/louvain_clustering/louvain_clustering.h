@@ -19,6 +19,7 @@ public:
   };
 
   static const bool kEnableVF = false;
+  static const bool kEnablePruning = false;
   static constexpr double kModularityThresholdPerRound = 0.01;
   static constexpr double kModularityThresholdTotal = 0.01;
   static const uint32_t kMaxIterations = 10;
@@ -38,22 +39,26 @@ private:
   uint32_t max_iterations_;
   //Minimum coarsened graph size
   uint32_t min_graph_size_;
+  //Flag to only revisit nodes whose neighbors changed clusters.
+  bool enable_pruning_;
 
   LouvainClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
       double modularity_threshold_per_round, double modularity_threshold_total,
-      uint32_t max_iterations, uint32_t min_graph_size)
+      uint32_t max_iterations, uint32_t min_graph_size, bool enable_pruning)
       : Plan(architecture),
         algorithm_(algorithm),
         enable_vf_(enable_vf),
         modularity_threshold_per_round_(modularity_threshold_per_round),
         modularity_threshold_total_(modularity_threshold_total),
         max_iterations_(max_iterations),
-        min_graph_size_(min_graph_size) {}
+        min_graph_size_(min_graph_size),
+        enable_pruning_(enable_pruning) {}
 
 public:
   LouvainClusteringPlan()
-      : LouvainClusteringPlan{kCPU, kDoAll, false, 0.01, 0.01, 10, 100} {}
+      : LouvainClusteringPlan{
+            kCPU, kDoAll, false, 0.01, 0.01, 10, 100, false} {}
 
   Algorithm algorithm() const { return algorithm_; }
   bool is_enable_vf() const { return enable_vf_; }
@@ -65,13 +70,21 @@ public:
   }
   uint32_t max_iterations() const { return max_iterations_; }
   uint32_t min_graph_size() const { return min_graph_size_; }
-
+  bool is_enable_pruning() const { return enable_pruning_; }
+
+  /// Move nodes between clusters in parallel rounds with do_all.
+  ///
+  /// With enable_vf, isolated and degree-one nodes are first merged into the
+  /// clusters of their neighbors (vertex following). With enable_pruning,
+  /// each round only revisits the nodes with a neighbor that moved in the
+  /// previous round, which skips most of the graph once clusters settle.
   static LouvainClusteringPlan DoAll(
       bool enable_vf = kEnableVF,
       double modularity_threshold_per_round = kModularityThresholdPerRound,
       double modularity_threshold_total = kModularityThresholdTotal,
       uint32_t max_iterations = kMaxIterations,
-      uint32_t min_graph_size = kMinGraphSize) {
+      uint32_t min_graph_size = kMinGraphSize,
+      bool enable_pruning = kEnablePruning) {
     return {
         kCPU,
         kDoAll,
@@ -79,7 +92,8 @@ public:
         modularity_threshold_per_round,
         modularity_threshold_total,
         max_iterations,
-        min_graph_size};
+        min_graph_size,
+        enable_pruning};
   }
 };
 
@@ -88,6 +102,7 @@ public:
 /// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
 /// int), and the computed cluster ids are stored in the property named
 /// output_property_name (as uint32_t).
+/// There is no deterministic mode (see Plan::deterministic) yet.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
 KATANA_EXPORT Result<void> LouvainClustering(
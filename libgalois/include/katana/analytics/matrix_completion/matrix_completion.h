@@ -0,0 +1,179 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for matrix completion, specifying the algorithm and
+/// any parameters associated with it.
+///
+/// The ratings matrix is the graph: every edge goes from a left node (a row,
+/// e.g., a user) to a right node (a column, e.g., an item) and carries a
+/// rating, so no node has both in-edges and out-edges. Every node gets a
+/// latent vector, and the rating of an edge is predicted by the dot product
+/// of the latent vectors of its endpoints.
+class MatrixCompletionPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Stochastic gradient descent over tiles of the ratings matrix
+    kSgd,
+    /// Alternating least squares
+    kAls,
+  };
+
+  static const uint32_t kDefaultLatentVectorSize = 20;
+  static constexpr double kDefaultLambda = 0.05;
+  static constexpr double kDefaultLearningRate = 0.012;
+  static constexpr double kDefaultDecayRate = 0.015;
+  static const uint32_t kDefaultMaxIterations = 20;
+  static constexpr double kDefaultTolerance = 1.0e-3;
+  static const uint32_t kDefaultBlocksPerThread = 2;
+
+private:
+  Algorithm algorithm_;
+  uint32_t latent_vector_size_;
+  double lambda_;
+  double learning_rate_;
+  double decay_rate_;
+  uint32_t max_iterations_;
+  double tolerance_;
+  uint32_t blocks_per_thread_;
+
+  MatrixCompletionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t latent_vector_size, double lambda, double learning_rate,
+      double decay_rate, uint32_t max_iterations, double tolerance,
+      uint32_t blocks_per_thread)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        latent_vector_size_(latent_vector_size),
+        lambda_(lambda),
+        learning_rate_(learning_rate),
+        decay_rate_(decay_rate),
+        max_iterations_(max_iterations),
+        tolerance_(tolerance),
+        blocks_per_thread_(blocks_per_thread) {}
+
+public:
+  MatrixCompletionPlan() : MatrixCompletionPlan(Sgd()) {}
+
+  MatrixCompletionPlan& operator=(const MatrixCompletionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of elements of each latent vector
+  uint32_t latent_vector_size() const { return latent_vector_size_; }
+  /// The weight of the L2 regularization of the latent vectors
+  double lambda() const { return lambda_; }
+  /// The base step size of kSgd
+  double learning_rate() const { return learning_rate_; }
+  /// How fast the step size of kSgd decays over epochs
+  double decay_rate() const { return decay_rate_; }
+  /// The maximum number of epochs (kSgd) or alternations (kAls)
+  uint32_t max_iterations() const { return max_iterations_; }
+  /// Stop once an iteration improves the root mean square error of the
+  /// ratings by less than this fraction
+  double tolerance() const { return tolerance_; }
+  /// kSgd splits the rows and the columns of the ratings matrix into
+  /// blocks_per_thread * active threads blocks each
+  uint32_t blocks_per_thread() const { return blocks_per_thread_; }
+
+  /// Stochastic gradient descent with the step size of epoch t being
+  /// learning_rate * 1.5 / (1 + decay_rate * (t + 1) ^ 1.5), as in:
+  ///
+  ///   Hyokun Yun, Hsiang-Fu Yu, Cho-Jui Hsieh, S.V.N. Vishwanathan and
+  ///   Inderjit Dhillon. NOMAD: Non-locking, stOchastic Multi-machine
+  ///   algorithm for Asynchronous and Decentralized matrix completion.
+  ///   VLDB, 2014.
+  ///
+  /// The ratings are copied into tiles of consecutive row and column
+  /// blocks, each balanced by number of ratings. An epoch visits the tiles
+  /// one diagonal at a time (Gemulla et al., KDD 2011): the tiles of a
+  /// diagonal share no rows or columns, so threads update them in parallel
+  /// without locks, each tile touching only the latent vectors of its own
+  /// blocks.
+  ///
+  /// This algorithm has no deterministic mode (see Plan::deterministic).
+  static MatrixCompletionPlan Sgd(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double learning_rate = kDefaultLearningRate,
+      double decay_rate = kDefaultDecayRate, double lambda = kDefaultLambda,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      double tolerance = kDefaultTolerance,
+      uint32_t blocks_per_thread = kDefaultBlocksPerThread) {
+    return {
+        kCPU,
+        kSgd,
+        latent_vector_size,
+        lambda,
+        learning_rate,
+        decay_rate,
+        max_iterations,
+        tolerance,
+        blocks_per_thread};
+  }
+
+  /// Alternating least squares with weighted-lambda regularization:
+  ///
+  ///   Yunhong Zhou, Dennis Wilkinson, Robert Schreiber and Rong Pan.
+  ///   Large-Scale Parallel Collaborative Filtering for the Netflix Prize.
+  ///   AAIM, 2008.
+  ///
+  /// Each alternation solves the normal equations of every left node and
+  /// then of every right node, in parallel, by Cholesky factorization. The
+  /// result does not depend on the number of threads.
+  static MatrixCompletionPlan Als(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      double tolerance = kDefaultTolerance) {
+    return {
+        kCPU,
+        kAls,
+        latent_vector_size,
+        lambda,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        max_iterations,
+        tolerance,
+        kDefaultBlocksPerThread};
+  }
+};
+
+/// Factor the ratings matrix of pg, whose ratings are in the numeric edge
+/// property named rating_property_name.
+/// The latent vector of every node is stored in a node property named by
+/// output_property_name: a fixed size list of latent_vector_size floats.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> MatrixCompletion(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan = {});
+
+/// Check that the latent vectors in the property named property_name are
+/// finite and predict the ratings better than predicting 0 for all of them.
+KATANA_EXPORT Result<void> MatrixCompletionAssertValid(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MatrixCompletionStatistics {
+  /// The root mean square error of the predicted ratings.
+  double rmse;
+  /// The number of ratings.
+  uint64_t num_ratings;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MatrixCompletionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& rating_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MaxFlow, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Parallel push-relabel, discharging the highest nodes first, with
+    /// global relabeling and gap detection
+    kPushRelabel,
+  };
+
+  static const uint32_t kDefaultGlobalRelabelAlpha = 6;
+
+private:
+  Algorithm algorithm_;
+  uint32_t global_relabel_alpha_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t global_relabel_alpha)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_alpha_(global_relabel_alpha) {}
+
+public:
+  MaxFlowPlan() : MaxFlowPlan(PushRelabel()) {}
+
+  MaxFlowPlan& operator=(const MaxFlowPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Heights are recomputed from scratch after about
+  /// global_relabel_alpha * num_nodes + num_edges / 3 units of work, where
+  /// a push is one unit and relabeling a node costs its degree plus 12.
+  uint32_t global_relabel_alpha() const { return global_relabel_alpha_; }
+
+  /// The push-relabel algorithm with the global relabeling and gap
+  /// heuristics of:
+  ///
+  ///   Boris V. Cherkassky and Andrew V. Goldberg. On Implementing the
+  ///   Push-Relabel Method for the Maximum Flow Problem. Algorithmica, 1997.
+  ///
+  /// Active nodes are discharged in parallel without locks, following
+  ///
+  ///   Bo Hong and Zhengyu He. An Asynchronous Multithreaded Algorithm for
+  ///   the Maximum Network Flow Problem with Nonblocking Global Relabeling
+  ///   Heuristic. IEEE TPDS, 2011.
+  ///
+  /// Global relabels are parallel breadth-first searches of the residual
+  /// graph between rounds of discharging.
+  static MaxFlowPlan PushRelabel(
+      uint32_t global_relabel_alpha = kDefaultGlobalRelabelAlpha) {
+    return {kCPU, kPushRelabel, global_relabel_alpha};
+  }
+};
+
+/// Compute a maximum flow from source to sink in pg, whose edges have the
+/// capacities in the edge property named capacity_property_name, which must
+/// be of a non-negative integer type. Parallel and antiparallel edges are
+/// separate arcs of the network.
+/// The result is stored in an edge property named by output_property_name,
+/// of the same type as the capacities: the flow on each edge.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan = {});
+
+/// Check that the flows in the property named property_name respect the
+/// capacities, are conserved at every node other than source and sink, and
+/// leave no augmenting path from source to sink.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The value of the flow: the net flow out of the source.
+  uint64_t flow_value;
+  /// The number of edges that carry some flow.
+  uint64_t n_flow_edges;
+  /// The number of edges whose flow equals their capacity.
+  uint64_t n_saturated_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t source,
+      const std::string& capacity_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MinimumSpanningForest, specifying the algorithm
+/// and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Every component picks its lightest outgoing edge and the components
+    /// are merged along them, in rounds
+    kBoruvka,
+    /// Kruskal's algorithm on edges partitioned around sampled pivots,
+    /// dropping the edges inside a component before sorting them
+    kFilterKruskal,
+  };
+
+  static const uint32_t kDefaultKruskalThreshold = 1 << 16;
+
+private:
+  Algorithm algorithm_;
+  uint32_t kruskal_threshold_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t kruskal_threshold)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        kruskal_threshold_(kruskal_threshold) {}
+
+public:
+  MinimumSpanningForestPlan()
+      : MinimumSpanningForestPlan(
+            kCPU, kFilterKruskal, kDefaultKruskalThreshold) {}
+
+  MinimumSpanningForestPlan& operator=(const MinimumSpanningForestPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of edges at or under which FilterKruskal stops partitioning
+  /// and sorts the edges for Kruskal's algorithm.
+  uint32_t kruskal_threshold() const { return kruskal_threshold_; }
+
+  /// Boruvka's algorithm, in rounds over the edges that still join two
+  /// components.
+  static MinimumSpanningForestPlan Boruvka() {
+    return {kCPU, kBoruvka, kDefaultKruskalThreshold};
+  }
+
+  /// The Filter-Kruskal algorithm:
+  ///
+  ///   Vitaly Osipov, Peter Sanders, and Johannes Singler. The
+  ///   Filter-Kruskal Minimum Spanning Tree Algorithm. ALENEX 2009.
+  ///
+  /// Partitioning and filtering are parallel; the Kruskal steps are serial.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint32_t kruskal_threshold = kDefaultKruskalThreshold) {
+    return {kCPU, kFilterKruskal, kruskal_threshold};
+  }
+};
+
+/// Compute a minimum spanning forest of pg, treating its edges as undirected
+/// and weighted by the edge property named edge_weight_property_name, which
+/// must be of an integer or floating point type. Edges of equal weight are
+/// ordered by edge id, so both plans find the same forest.
+/// The result is stored in a uint8 edge property named by
+/// output_property_name, which is 1 for the edges in the forest and 0 for
+/// the others. Of the two copies of an edge in a symmetric graph, at most
+/// one is in the forest.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the edges in the property named property_name are the forest
+/// found by a serial run of Kruskal's algorithm, breaking ties the same way.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// Total number of edges in the forest.
+  uint64_t forest_edges;
+  /// Total number of trees in the forest, including single nodes.
+  uint64_t trees;
+  /// Total weight of the edges in the forest.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSIMILARITY_NEIGHBORSIMILARITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSIMILARITY_NEIGHBORSIMILARITY_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for NeighborSimilarity, specifying the similarity
+/// measure between the embeddings of the endpoints of an edge.
+class NeighborSimilarityPlan : public Plan {
+public:
+  enum Metric {
+    /// The dot product of the embeddings
+    kDotProduct,
+    /// The cosine of the angle between the embeddings; 0 if either is zero
+    kCosine,
+  };
+
+private:
+  Metric metric_;
+
+  NeighborSimilarityPlan(Architecture architecture, Metric metric)
+      : Plan(architecture), metric_(metric) {}
+
+public:
+  /// Use cosine similarity.
+  NeighborSimilarityPlan() : NeighborSimilarityPlan(kCPU, kCosine) {}
+
+  NeighborSimilarityPlan& operator=(const NeighborSimilarityPlan&) = default;
+
+  Metric metric() const { return metric_; }
+
+  static NeighborSimilarityPlan DotProduct() { return {kCPU, kDotProduct}; }
+
+  static NeighborSimilarityPlan Cosine() { return {kCPU, kCosine}; }
+};
+
+/// The tag for the input property of NeighborSimilarity in PropertyGraphs:
+/// an arrow::FixedSizeListArray of floats with one embedding per node.
+using NodeEmbedding = katana::FixedSizeListProperty<float>;
+
+/// The tag for the output property of NeighborSimilarity in PropertyGraphs.
+using EdgeSimilarity = katana::PODProperty<float>;
+
+/// Compute the similarity of the embeddings of the source and destination of
+/// each edge. The embeddings are read from the node property named by
+/// embedding_property_name, and the result is stored in an edge property
+/// named by output_property_name. The plan selects the similarity measure.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> NeighborSimilarity(
+    PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& output_property_name,
+    NeighborSimilarityPlan plan = {});
+
+KATANA_EXPORT Result<void> NeighborSimilarityAssertValid(
+    PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& property_name, NeighborSimilarityPlan plan = {});
+
+struct KATANA_EXPORT NeighborSimilarityStatistics {
+  /// The maximum similarity of any edge.
+  double max_similarity;
+  /// The minimum similarity of any edge.
+  double min_similarity;
+  /// The average similarity of the edges.
+  double average_similarity;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout);
+
+  static katana::Result<NeighborSimilarityStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -18,27 +20,38 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPullBlocked,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
   static const int kDefaultMaxIterations = 1000;
   static constexpr double kDefaultAlpha = 0.85;
+  /// 1 MiB of float contributions per block
+  static const uint32_t kDefaultBlockNodes = 1U << 18;
+  /// Hubs are not split by default
+  static const uint64_t kDefaultHubDegree = 0;
 
 private:
   Algorithm algorithm_;
   float tolerance_;
   unsigned int max_iterations_;
   float alpha_;
+  uint32_t block_nodes_;
+  uint64_t hub_degree_;
 
 public:
   PagerankPlan(
       Architecture architecture, Algorithm algorithm, float tolerance,
-      unsigned int max_iterations, float alpha)
+      unsigned int max_iterations, float alpha,
+      uint32_t block_nodes = kDefaultBlockNodes,
+      uint64_t hub_degree = kDefaultHubDegree)
       : Plan(architecture),
         algorithm_(algorithm),
         tolerance_(tolerance),
         max_iterations_(max_iterations),
-        alpha_(alpha) {}
+        alpha_(alpha),
+        block_nodes_(block_nodes),
+        hub_degree_(hub_degree) {}
 
   constexpr static const unsigned kChunkSize = 16U;
 
@@ -55,9 +68,16 @@ public:
   unsigned int max_iterations() const { return max_iterations_; }
   float alpha() const { return alpha_; }
   float initial_residual() const { return 1 - alpha_; }
+  uint32_t block_nodes() const { return block_nodes_; }
+  /// The degree above which kPushSynchronous splits nodes (see
+  /// PropertyGraph::SplitHubs); 0 if it does not
+  uint64_t hub_degree() const { return hub_degree_; }
 
   /// Topological pull algorithm
   ///
+  /// Ranks are updated in place, except in deterministic plans (see
+  /// Plan::deterministic), which read the ranks of the previous round.
+  ///
   /// The graph must be transposed to use this algorithm.
   static PagerankPlan PullTopological(
       float tolerance = kDefaultTolerance,
@@ -76,6 +96,29 @@ public:
     return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
   }
 
+  /// Cache-blocked topological pull algorithm
+  ///
+  /// Like PullTopological, but each round first computes the contribution
+  /// rank / out-degree of every node and then sums the contributions of the
+  /// in-neighbors of each node with vector gathers (AVX-512 or AVX2 when the
+  /// processor supports them) and software prefetching. Ranks are updated
+  /// once per round rather than in place.
+  ///
+  /// When the graph has more than block_nodes nodes, in-neighbors are
+  /// processed in blocks of block_nodes consecutive ids, so that the
+  /// contributions read by each pass over the graph stay in cache
+  /// (propagation blocking). Blocking needs the edges of each node to be
+  /// sorted by destination (see SortAllEdgesByDest); otherwise the
+  /// contributions are gathered without blocking.
+  ///
+  /// The graph must be transposed to use this algorithm.
+  static PagerankPlan PullBlocked(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha, uint32_t block_nodes = kDefaultBlockNodes) {
+    return {kCPU, kPullBlocked, tolerance, max_iterations, alpha, block_nodes};
+  }
+
   /// Asynchronous push algorithm
   ///
   /// This implementation is based on the Push-based PageRank computation
@@ -84,6 +127,8 @@ public:
   /// WHANG, Joyce Jiyoung, et al. Scalable data-driven pagerank: Algorithms,
   /// system issues, and lessons learned. In: European Conference on Parallel
   /// Processing. Springer, Berlin, Heidelberg, 2015. p. 438-450.
+  ///
+  /// This algorithm has no deterministic mode (see Plan::deterministic).
   static PagerankPlan PushAsynchronous(
       float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha) {
     return {kCPU, kPushAsynchronous, tolerance, 0, alpha};
@@ -97,11 +142,20 @@ public:
   /// WHANG, Joyce Jiyoung, et al. Scalable data-driven pagerank: Algorithms,
   /// system issues, and lessons learned. In: European Conference on Parallel
   /// Processing. Springer, Berlin, Heidelberg, 2015. p. 438-450.
+  ///
+  /// If hub_degree is not 0, the pushes into each node with more than
+  /// hub_degree in or out-edges are spread over the slots of its virtual
+  /// nodes in PropertyGraph::SplitHubs(hub_degree) and merged into the node
+  /// after each round, so that the threads do not all contend for the
+  /// residuals of the hubs.
+  ///
+  /// This algorithm has no deterministic mode (see Plan::deterministic).
   static PagerankPlan PushSynchronous(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
-      float alpha = kDefaultAlpha) {
-    return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
+      float alpha = kDefaultAlpha, uint64_t hub_degree = kDefaultHubDegree) {
+    return {kCPU,  kPushSynchronous,   tolerance, max_iterations,
+            alpha, kDefaultBlockNodes, hub_degree};
   }
 };
 
@@ -112,6 +166,119 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     PagerankPlan plan = {});
 
+/// Update the Page Rank of each node after edges were added to or removed
+/// from the graph, without recomputing it from scratch.
+///
+/// pg must already contain the inserted edges and no longer contain the
+/// removed ones. The property named rank_property_name must hold the ranks
+/// computed (by any algorithm) before the change; it is updated in place.
+///
+/// Only the sources of changed edges lose or gain rank contributions, so
+/// residuals are seeded just at their out-neighbors and then propagated by
+/// the asynchronous push algorithm. Only the tolerance and alpha of plan are
+/// used. The result is as accurate as the previous ranks plus tolerance.
+/// There is no deterministic mode (see Plan::deterministic).
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& removed_edges = {},
+    PagerankPlan plan = PagerankPlan::PushAsynchronous());
+
+/// A computational plan for PersonalizedPagerank, specifying the algorithm
+/// and any parameters associated with it.
+///
+/// Both algorithms compute each query independently from its seed and only
+/// touch the nodes near it, so their cost does not grow with the size of the
+/// graph. Queries run in parallel, one per task.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+    kMonteCarlo,
+  };
+
+  static constexpr double kDefaultEpsilon = 1.0e-4;
+  static const uint32_t kDefaultNumberOfWalks = 10000;
+  static constexpr double kDefaultAlpha = 0.85;
+
+private:
+  Algorithm algorithm_;
+  double epsilon_;
+  uint32_t number_of_walks_;
+  double alpha_;
+  uint32_t top_k_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon,
+      uint32_t number_of_walks, double alpha, uint32_t top_k)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        number_of_walks_(number_of_walks),
+        alpha_(alpha),
+        top_k_(top_k) {}
+
+public:
+  PersonalizedPagerankPlan() : PersonalizedPagerankPlan(ForwardPush()) {}
+
+  PersonalizedPagerankPlan& operator=(const PersonalizedPagerankPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The residual per out-edge below which ForwardPush stops pushing
+  double epsilon() const { return epsilon_; }
+  /// The number of walks per seed of MonteCarlo
+  uint32_t number_of_walks() const { return number_of_walks_; }
+  /// The probability that a walk continues instead of returning to its seed
+  double alpha() const { return alpha_; }
+  /// Keep only the top_k highest ranks of each query; 0 keeps all of them
+  uint32_t top_k() const { return top_k_; }
+
+  /// Local forward push
+  ///
+  /// Every query keeps sparse maps of ranks and residuals, starting from a
+  /// residual of 1 at its seed, and pushes the residual of any node whose
+  /// residual exceeds epsilon times its out-degree to its out-neighbors.
+  /// Ranks only underestimate, by at most the residual left over, which is
+  /// below epsilon times the out-degree of each node (or epsilon for nodes
+  /// without out-edges). A query pushes at most 1 / (epsilon * (1 - alpha))
+  /// times.
+  ///
+  /// ANDERSEN, Reid, CHUNG, Fan, and LANG, Kevin. Local graph partitioning
+  /// using PageRank vectors. In: 47th Annual IEEE Symposium on Foundations
+  /// of Computer Science. 2006. p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      double epsilon = kDefaultEpsilon, double alpha = kDefaultAlpha,
+      uint32_t top_k = 0) {
+    return {kCPU, kForwardPush, epsilon, 0, alpha, top_k};
+  }
+
+  /// Monte Carlo estimation
+  ///
+  /// Start number_of_walks random walks at each seed that stop at each step
+  /// with probability 1 - alpha; the rank of a node is the fraction of walks
+  /// that stop there. Walks of a query draw from a generator seeded with the
+  /// position of the query, so results are reproducible.
+  static PersonalizedPagerankPlan MonteCarlo(
+      uint32_t number_of_walks = kDefaultNumberOfWalks,
+      double alpha = kDefaultAlpha, uint32_t top_k = 0) {
+    return {kCPU, kMonteCarlo, 0, number_of_walks, alpha, top_k};
+  }
+};
+
+/// The approximate personalized Page Rank of the nodes near one seed, as
+/// (node, rank) pairs sorted by decreasing rank. Nodes that are missing have
+/// rank 0.
+using PersonalizedRanks = std::vector<std::pair<uint32_t, double>>;
+
+/// Compute the Page Rank of the nodes of pg personalized to each seed, i.e.,
+/// with random jumps that return to the seed instead of to any node. Walks
+/// follow outgoing edges and walks from nodes without out-edges jump back to
+/// the seed. The result has one entry per seed, in the order of seeds.
+KATANA_EXPORT Result<std::vector<PersonalizedRanks>> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    PersonalizedPagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -0,0 +1,141 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// What a partition keeps balanced while it minimizes the number of edges
+/// between partitions.
+enum class PartitionObjective {
+  /// Every partition has about the same number of nodes
+  kNodeBalancedCut,
+  /// Every partition has about the same number of nodes plus outgoing edges,
+  /// i.e., the same amount of work in loops over the edges
+  kEdgeBalancedCut,
+};
+
+/// A computational plan for Partition, specifying the algorithm and any
+/// parameters associated with it.
+class PartitionPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Coarsen the graph by heavy edge matching, bisect the coarsest graph
+    /// recursively by greedy graph growing, and move boundary nodes to
+    /// better partitions while projecting the partition back (as in METIS)
+    kMultilevel,
+  };
+
+  static const uint32_t kDefaultCoarseNodesPerPartition = 20;
+  static constexpr double kDefaultImbalance = 0.03;
+  static const uint32_t kDefaultRefinementRounds = 8;
+
+private:
+  Algorithm algorithm_;
+  uint32_t coarse_nodes_per_partition_;
+  double imbalance_;
+  uint32_t refinement_rounds_;
+
+  PartitionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t coarse_nodes_per_partition, double imbalance,
+      uint32_t refinement_rounds)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        coarse_nodes_per_partition_(coarse_nodes_per_partition),
+        imbalance_(imbalance),
+        refinement_rounds_(refinement_rounds) {}
+
+public:
+  PartitionPlan() : PartitionPlan(Multilevel()) {}
+
+  PartitionPlan& operator=(const PartitionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Coarsening stops once the graph has at most this many nodes per
+  /// partition.
+  uint32_t coarse_nodes_per_partition() const {
+    return coarse_nodes_per_partition_;
+  }
+
+  /// How much heavier than the average a partition may be, as a fraction of
+  /// the average.
+  double imbalance() const { return imbalance_; }
+
+  /// The maximum number of rounds of boundary node moves at each level.
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+
+  /// The multilevel partitioner of the lonestar gmetis application:
+  ///
+  ///   George Karypis and Vipin Kumar. A Fast and High Quality Multilevel
+  ///   Scheme for Partitioning Irregular Graphs. SIAM Journal on Scientific
+  ///   Computing, 1998.
+  ///
+  /// Matching, coarse graph construction, projection and refinement are
+  /// parallel; the initial bisections of the coarsest graph are serial.
+  static PartitionPlan Multilevel(
+      uint32_t coarse_nodes_per_partition = kDefaultCoarseNodesPerPartition,
+      double imbalance = kDefaultImbalance,
+      uint32_t refinement_rounds = kDefaultRefinementRounds) {
+    return {
+        kCPU, kMultilevel, coarse_nodes_per_partition, imbalance,
+        refinement_rounds};
+  }
+};
+
+/// Divide the nodes of pg into num_partitions partitions, treating its edges
+/// as undirected and unweighted, so that few edges join different
+/// partitions and the partitions are balanced as objective asks. The
+/// partition of each node, from 0 to num_partitions - 1, is stored in a
+/// uint32 node property named by output_property_name.
+///
+/// Renumbering the nodes in order of partition makes every partition a
+/// contiguous block of nodes, which is the form of partition the RDG
+/// partitioner (katana::Distribution) assigns to hosts.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name,
+    PartitionObjective objective = PartitionObjective::kNodeBalancedCut,
+    PartitionPlan plan = {});
+
+/// Check that every node in the property named property_name is in one of
+/// num_partitions partitions.
+KATANA_EXPORT Result<void> PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+struct KATANA_EXPORT PartitionStatistics {
+  /// The number of partitions.
+  uint32_t num_partitions;
+  /// The number of edges whose endpoints are in different partitions.
+  uint64_t cut_edges;
+  /// The number of (node, partition) pairs such that the node has an
+  /// outgoing edge to the partition and is not in it; that is, the number of
+  /// values sent when every node sends its value to the partitions of its
+  /// neighbors.
+  uint64_t communication_volume;
+  /// The number of nodes in the largest partition over the average.
+  double node_imbalance;
+  /// The number of outgoing edges of the largest partition, by edges, over
+  /// the average.
+  double edge_imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PartitionStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_GOALDIRECTED_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_GOALDIRECTED_H_
+
+#include <atomic>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace katana::analytics {
+
+/// A GoalDirectedSearch answers point to point shortest path queries with
+/// one parallel search from the source that is steered towards the target
+/// by a lower bound h(n) on the distance from each node n to the target:
+///
+///   Peter E. Hart, Nils J. Nilsson and Bertram Raphael. A Formal Basis for
+///   the Heuristic Determination of Minimum Cost Paths. IEEE Transactions on
+///   Systems Science and Cybernetics, 1968.
+///
+/// Nodes are expanded by all threads in the order of g(n) + h(n), where g(n)
+/// is the distance found so far from the source, in buckets of width delta
+/// as Sssp does with Dijkstra order (see SsspPlan::DeltaStep). Nodes whose
+/// g(n) + h(n) exceeds the best distance to the target found so far cannot
+/// be on a shorter path and are dropped. With h = 0 this is delta stepping
+/// that stops at the target; the tighter h, the fewer nodes a query reaches.
+///
+/// The lower bounds are either
+///
+/// - the straight line distance between coordinates of the nodes (MakeAStar),
+///   for graphs embedded in the plane such as road networks, or
+/// - the landmark bounds of ALT (MakeAlt), which follow from the triangle
+///   inequality and precomputed distances to and from a few landmarks:
+///
+///     Andrew V. Goldberg and Chris Harrelson. Computing the Shortest Path:
+///     A* Search Meets Graph Theory. SODA 2005.
+///
+/// Unlike a PointToPointSearch, each query uses every thread, and queries
+/// must not run concurrently on the same search. The state of a query is
+/// proportional to the nodes of the graph but only the nodes it reached are
+/// reset by the next query.
+///
+/// The search refers to the topology of the graph it was made from and to a
+/// copy of its weights, coordinates and landmark distances; it must be made
+/// again if any of them change.
+class KATANA_EXPORT GoalDirectedSearch {
+public:
+  /// The distance between nodes that are not connected
+  static constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+  /// Make an A* search over the edges of pg weighted by the edge property
+  /// named edge_weight_property_name, which must be of an integer or
+  /// floating point type and not negative, or weigh 1 if it is empty.
+  ///
+  /// The node properties named x_property_name and y_property_name are the
+  /// coordinates of each node, of any number type and not null. The lower
+  /// bound is the straight line distance to the target times the smallest
+  /// ratio of the weight of an edge to the straight line distance between
+  /// its ends, so that it never overestimates whatever the units of the
+  /// weights.
+  static Result<GoalDirectedSearch> MakeAStar(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& x_property_name, const std::string& y_property_name);
+
+  /// Make an ALT search over the edges of pg weighted as for MakeAStar,
+  /// bounded by the landmark distances in the node property named
+  /// landmark_property_name, as computed by ComputeLandmarks with the same
+  /// weights.
+  static Result<GoalDirectedSearch> MakeAlt(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& landmark_property_name);
+
+  /// The length of the shortest path from source to target, or kInfinity
+  double Distance(uint32_t source, uint32_t target);
+
+  /// The shortest path from source to target. The path has no nodes if
+  /// target cannot be reached.
+  WeightedPath ShortestPath(uint32_t source, uint32_t target);
+
+  /// The lower bound of the search on the distance from n to target
+  double LowerBound(uint32_t n, uint32_t target) const;
+
+  /// The number of nodes the last query reached
+  uint64_t num_reached() const { return reached_.size(); }
+
+  uint64_t num_nodes() const { return out_.num_nodes(); }
+
+  /// The width of the buckets of g(n) + h(n) that are expanded in parallel,
+  /// by default the mean weight of an edge
+  double delta() const { return delta_; }
+  void set_delta(double delta) { delta_ = delta; }
+
+private:
+  friend KATANA_EXPORT Result<std::vector<uint32_t>> ComputeLandmarks(
+      PropertyGraph*, const std::string&, const std::string&, uint32_t,
+      uint32_t);
+
+  static constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+
+  enum Heuristic {
+    kNone,
+    kEuclidean,
+    kLandmarks,
+  };
+
+  /// Make a search with h = 0
+  static Result<GoalDirectedSearch> Make(
+      PropertyGraph* pg, const std::string& edge_weight_property_name);
+
+  GoalDirectedSearch() = default;
+
+  /// Search from source until no node can improve on the distance to target,
+  /// which may be kNoNode to compute the distances to every node. If
+  /// backward, search along in-edges, computing distances to source instead.
+  void Search(uint32_t source, uint32_t target, bool backward);
+
+  /// The weight of edge e of the graph
+  double weight(uint64_t e) const { return weights_.empty() ? 1 : weights_[e]; }
+
+  GraphTopology out_;
+  /// The weights of the edges of out_, or empty if every edge weighs 1
+  std::vector<double> weights_;
+  /// The in-edges of each node, as in PointToPointSearch
+  std::vector<uint64_t> in_indices_;
+  std::vector<uint32_t> in_sources_;
+  std::vector<uint64_t> in_edges_;
+
+  Heuristic heuristic_{kNone};
+  /// The coordinates of kEuclidean and the ratio of edge weights to their
+  /// straight line distance
+  std::vector<double> x_;
+  std::vector<double> y_;
+  double scale_{0};
+  /// The distances of kLandmarks: the distances from each of the
+  /// num_landmarks_ landmarks to node n followed by the distances from n to
+  /// each landmark, starting at landmarks_[2 * num_landmarks_ * n]
+  std::vector<double> landmarks_;
+  uint32_t num_landmarks_{0};
+
+  double delta_{1};
+  /// The distance from the source of the last query to each node, or
+  /// kInfinity for nodes it did not reach
+  std::vector<std::atomic<double>> distances_;
+  /// The nodes the last query reached
+  std::vector<uint32_t> reached_;
+};
+
+/// Choose num_landmarks landmarks of pg for GoalDirectedSearch::MakeAlt and
+/// store the distances from each landmark to each node and from each node to
+/// each landmark in a FixedSizeList<double> node property of 2 *
+/// num_landmarks values named output_property_name (the first num_landmarks
+/// from the landmarks, then those to them), with kInfinity where there is no
+/// path. Edges are weighted as for GoalDirectedSearch::MakeAStar.
+///
+/// The first landmark is first_landmark, and each next landmark is the node
+/// farthest from the closest landmark chosen so far among the nodes they
+/// reach, which spreads the landmarks to the edges of the graph where their
+/// bounds are tightest (the "farthest" selection of Goldberg and Harrelson).
+/// Fewer landmarks are chosen if the landmarks reach no other nodes.
+///
+/// Each landmark costs two parallel searches over the whole graph.
+///
+/// \returns the landmarks, in the order of their distances in the property
+KATANA_EXPORT Result<std::vector<uint32_t>> ComputeLandmarks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, uint32_t num_landmarks = 16,
+    uint32_t first_landmark = 0);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_POINTTOPOINT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTTOPOINT_POINTTOPOINT_H_
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace katana::analytics {
+
+/// A PointToPointSearch answers "how far is target from source" without
+/// computing the distances from source to every node as Bfs and Sssp do. A
+/// query searches forward from the source along out-edges and backward from
+/// the target along in-edges, and stops as soon as the two searches meet
+/// (breadth first) or cannot improve on the best path through a node both
+/// have reached (Dijkstra):
+///
+///   Ira Pohl. Bi-directional Search. Machine Intelligence 6, 1971.
+///
+/// A query costs about as much as the nodes the two searches reach, which
+/// on graphs of small diameter is a small fraction of the graph. Unlike a
+/// ContractionHierarchy there is no preprocessing beyond building the
+/// in-edges, so the search is the right choice for graphs that change or
+/// are queried too rarely to pay for contracting them.
+///
+/// The search refers to the topology of the graph it was made from and to a
+/// copy of its weights; it must be made again if either changes.
+class KATANA_EXPORT PointToPointSearch {
+public:
+  /// The distance between nodes that are not connected
+  static constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  /// The number of hops between nodes that are not connected
+  static constexpr uint32_t kUnreachable = std::numeric_limits<uint32_t>::max();
+
+  /// The state of the two searches of a query. Nodes are labeled in hash
+  /// maps, so a query touches memory in proportion to the nodes it reaches
+  /// rather than to the nodes of the graph. It is reused between queries to
+  /// avoid allocations; use one per thread.
+  class KATANA_EXPORT Query {
+    friend class PointToPointSearch;
+
+    /// The distance to a node and the edge of the graph it was reached by,
+    /// which leaves or enters parent
+    struct Label {
+      double distance;
+      uint64_t edge;
+      uint32_t parent;
+    };
+    struct Side {
+      std::unordered_map<uint32_t, Label> labels;
+      /// The frontier of a breadth first search
+      std::vector<uint32_t> frontier;
+      std::vector<uint32_t> next;
+      std::vector<std::pair<double, uint32_t>> heap;
+    };
+    Side sides_[2];
+
+  public:
+    /// The number of nodes the last query reached from either end
+    uint64_t num_reached() const {
+      return sides_[0].labels.size() + sides_[1].labels.size();
+    }
+  };
+
+  /// Make a search over the edges of pg weighted by the edge property named
+  /// edge_weight_property_name, which must be of an integer or floating
+  /// point type and not negative. If edge_weight_property_name is empty,
+  /// every edge weighs 1.
+  static Result<PointToPointSearch> Make(
+      PropertyGraph* pg, const std::string& edge_weight_property_name = "");
+
+  /// The number of edges of a path from source to target with the fewest
+  /// edges, or kUnreachable. Weights are ignored.
+  uint32_t Hops(uint32_t source, uint32_t target, Query* query) const;
+
+  /// The length of the shortest path from source to target, or kInfinity
+  double Distance(uint32_t source, uint32_t target, Query* query) const;
+
+  /// The shortest path from source to target. The path has no nodes if
+  /// target cannot be reached.
+  WeightedPath ShortestPath(
+      uint32_t source, uint32_t target, Query* query) const;
+
+  /// The length of the shortest path of each of queries, or kInfinity,
+  /// answering different queries in parallel
+  std::vector<double> Distances(const std::vector<PathQuery>& queries) const;
+
+  /// The number of hops of each of queries (see Hops), answering different
+  /// queries in parallel
+  std::vector<uint32_t> Hops(const std::vector<PathQuery>& queries) const;
+
+  uint64_t num_nodes() const { return out_.num_nodes(); }
+
+private:
+  PointToPointSearch(
+      GraphTopology out, std::vector<double> weights,
+      std::vector<uint64_t> in_indices, std::vector<uint32_t> in_sources,
+      std::vector<uint64_t> in_edges);
+
+  /// Run both Dijkstra searches and return the node where the shortest path
+  /// meets, or kUnreachable
+  uint32_t Search(uint32_t source, uint32_t target, Query* query) const;
+
+  /// The weight of edge e of the graph
+  double weight(uint64_t e) const { return weights_.empty() ? 1 : weights_[e]; }
+
+  GraphTopology out_;
+  /// The weights of the edges of out_, or empty if every edge weighs 1
+  std::vector<double> weights_;
+  /// The in-edges of each node, in the layout of GraphTopology: the in-edges
+  /// of n are the edges in_edges_[e] from in_sources_[e] for e from
+  /// in_indices_[n - 1] to in_indices_[n]
+  std::vector<uint64_t> in_indices_;
+  std::vector<uint32_t> in_sources_;
+  std::vector<uint64_t> in_edges_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_NODEEMBEDDING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_NODEEMBEDDING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for NodeEmbedding, specifying the algorithm and any
+/// parameters associated with it.
+class NodeEmbeddingPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Skip-gram with negative sampling trained on random walks:
+    ///
+    ///   Aditya Grover and Jure Leskovec. node2vec: Scalable Feature
+    ///   Learning for Networks. KDD 2016.
+    kSkipGram,
+  };
+
+  static const uint32_t kDefaultDimensions = 128;
+  static const uint32_t kDefaultWalkLength = 80;
+  static const uint32_t kDefaultNumberOfWalks = 10;
+  static const uint32_t kDefaultWindowSize = 10;
+  static const uint32_t kDefaultNegativeSamples = 5;
+  static constexpr float kDefaultLearningRate = 0.025;
+  static const uint32_t kDefaultWalksPerBatch = 1;
+
+private:
+  Algorithm algorithm_;
+  uint32_t dimensions_;
+  uint32_t walk_length_;
+  uint32_t number_of_walks_;
+  uint32_t window_size_;
+  uint32_t negative_samples_;
+  float learning_rate_;
+  double backward_probability_;
+  double forward_probability_;
+  uint32_t walks_per_batch_;
+
+  NodeEmbeddingPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t dimensions,
+      uint32_t walk_length, uint32_t number_of_walks, uint32_t window_size,
+      uint32_t negative_samples, float learning_rate,
+      double backward_probability, double forward_probability,
+      uint32_t walks_per_batch)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        dimensions_(dimensions),
+        walk_length_(walk_length),
+        number_of_walks_(number_of_walks),
+        window_size_(window_size),
+        negative_samples_(negative_samples),
+        learning_rate_(learning_rate),
+        backward_probability_(backward_probability),
+        forward_probability_(forward_probability),
+        walks_per_batch_(walks_per_batch) {}
+
+public:
+  NodeEmbeddingPlan() : NodeEmbeddingPlan(SkipGram()) {}
+
+  NodeEmbeddingPlan& operator=(const NodeEmbeddingPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of floats in each embedding
+  uint32_t dimensions() const { return dimensions_; }
+  /// The number of steps of each walk
+  uint32_t walk_length() const { return walk_length_; }
+  /// The number of walks that start at each node with edges
+  uint32_t number_of_walks() const { return number_of_walks_; }
+  /// The largest distance along a walk between a node and the nodes it is
+  /// trained to predict. Each position uses a window drawn uniformly from
+  /// 1 to window_size, so that nearer nodes weigh more.
+  uint32_t window_size() const { return window_size_; }
+  /// The number of nodes drawn as negative examples per positive one
+  uint32_t negative_samples() const { return negative_samples_; }
+  /// The initial SGD step size, which decays linearly to near 0 by the end
+  /// of training
+  float learning_rate() const { return learning_rate_; }
+  /// The return parameter p of node2vec (see RandomWalksPlan::Node2Vec)
+  double backward_probability() const { return backward_probability_; }
+  /// The in-out parameter q of node2vec (see RandomWalksPlan::Node2Vec)
+  double forward_probability() const { return forward_probability_; }
+  /// The number of walks per node generated at a time. Only one batch of
+  /// walks is held in memory; larger batches rebuild the second-order tables
+  /// of node2vec less often.
+  uint32_t walks_per_batch() const { return walks_per_batch_; }
+
+  /// Skip-gram on node2vec walks. With backward_probability and
+  /// forward_probability 1 the walks are uniform, which is DeepWalk:
+  ///
+  ///   Bryan Perozzi, Rami Al-Rfou and Steven Skiena. DeepWalk: Online
+  ///   Learning of Social Representations. KDD 2014.
+  static NodeEmbeddingPlan SkipGram(
+      uint32_t dimensions = kDefaultDimensions,
+      uint32_t walk_length = kDefaultWalkLength,
+      uint32_t number_of_walks = kDefaultNumberOfWalks,
+      uint32_t window_size = kDefaultWindowSize,
+      uint32_t negative_samples = kDefaultNegativeSamples,
+      float learning_rate = kDefaultLearningRate,
+      double backward_probability = 1.0, double forward_probability = 1.0,
+      uint32_t walks_per_batch = kDefaultWalksPerBatch) {
+    return {
+        kCPU,
+        kSkipGram,
+        dimensions,
+        walk_length,
+        number_of_walks,
+        window_size,
+        negative_samples,
+        learning_rate,
+        backward_probability,
+        forward_probability,
+        walks_per_batch};
+  }
+};
+
+/// Train an embedding of each node of pg, which is expected to be symmetric,
+/// so that nodes that are near each other on random walks get similar
+/// vectors. Walks are generated as by RandomWalks, which sorts the edges of
+/// pg by destination, a batch at a time, and each batch is trained on by all
+/// threads without locks (Hogwild), so the result is not deterministic.
+/// Negative examples are drawn in proportion to degree^0.75, the frequency
+/// of nodes on walks raised to the power used by word2vec.
+///
+/// The embeddings are stored in a FixedSizeList<float> node property of
+/// plan.dimensions() values named by output_property_name, which may be
+/// compared with CosineSimilarity. Nodes without edges keep their random
+/// initial vectors.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> NodeEmbedding(
+    PropertyGraph* pg, const std::string& output_property_name,
+    NodeEmbeddingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -34,12 +34,14 @@ private:
   // Only need for edge2vec
   // TODO(gill) Find number of edge types automatically
   uint32_t number_of_edge_types_;
+  // Only need for node2vec
+  uint64_t second_order_table_bytes_;
 
   RandomWalksPlan(
       Architecture architecture, Algorithm algorithm, uint32_t walk_length,
       uint32_t number_of_walks, double backward_probability,
       double forward_probability, uint32_t max_iterations,
-      uint32_t number_of_edge_types)
+      uint32_t number_of_edge_types, uint64_t second_order_table_bytes)
       : Plan(architecture),
         algorithm_(algorithm),
         walk_length_(walk_length),
@@ -47,13 +49,19 @@ private:
         backward_probability_(backward_probability),
         forward_probability_(forward_probability),
         max_iterations_(max_iterations),
-        number_of_edge_types_(number_of_edge_types) {}
+        number_of_edge_types_(number_of_edge_types),
+        second_order_table_bytes_(second_order_table_bytes) {}
 
 public:
   // kChunkSize is a fixed const int (default value: 1)
   static const int kChunkSize;
 
-  RandomWalksPlan() : RandomWalksPlan{kCPU, kNode2Vec, 1, 1, 1.0, 1.0, 10, 1} {}
+  static const uint64_t kDefaultSecondOrderTableBytes = uint64_t{1} << 30;
+
+  RandomWalksPlan()
+      : RandomWalksPlan{
+            kCPU, kNode2Vec, 1, 1, 1.0, 1.0, 10, 1,
+            kDefaultSecondOrderTableBytes} {}
 
   Algorithm algorithm() const { return algorithm_; }
   uint32_t walk_length() const { return walk_length_; }
@@ -62,11 +70,20 @@ public:
   double forward_probability() const { return forward_probability_; }
   uint32_t max_iterations() const { return max_iterations_; }
   uint32_t number_of_edge_types() const { return number_of_edge_types_; }
+  /// The memory budget for the precomputed second-order alias tables of
+  /// Node2Vec. A node of degree d needs d * d table entries, one table per
+  /// neighbor the walk can come from, so tables are built for the nodes of
+  /// lowest degree that fit the budget. Steps from other nodes use
+  /// rejection sampling.
+  uint64_t second_order_table_bytes() const {
+    return second_order_table_bytes_;
+  }
 
   /// Node2Vec algorithm to generate random walks on the graph
   static RandomWalksPlan Node2Vec(
       uint32_t walk_length, uint32_t number_of_walks,
-      double backward_probability, double forward_probability) {
+      double backward_probability, double forward_probability,
+      uint64_t second_order_table_bytes = kDefaultSecondOrderTableBytes) {
     return {
         kCPU,
         kNode2Vec,
@@ -75,7 +92,8 @@ public:
         backward_probability,
         forward_probability,
         0,
-        1};
+        1,
+        second_order_table_bytes};
   }
 
   /// Edge2Vec algorithm to generate random walks on the graph.
@@ -92,7 +110,8 @@ public:
         backward_probability,
         forward_probability,
         max_iterations,
-        number_of_edge_types};
+        number_of_edge_types,
+        kDefaultSecondOrderTableBytes};
   }
 };
 
@@ -104,6 +123,14 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Compute the random-walks for pg like RandomWalks, returning them as a list
+/// array of uint32 nodes with one list per walk. Walks are generated in place
+/// in the values buffer of the array, which is only compacted if some walks
+/// end early.
+KATANA_EXPORT Result<std::shared_ptr<arrow::LargeListArray>>
+RandomWalksAsListArray(
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -0,0 +1,99 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SIMILARITYJOIN_SIMILARITYJOIN_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SIMILARITYJOIN_SIMILARITYJOIN_H_
+
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for SimilarityJoin, specifying which pairs of nodes
+/// to find.
+class SimilarityJoinPlan : public Plan {
+public:
+  enum Mode {
+    /// Find, for each node, every node whose similarity is at least the
+    /// threshold.
+    kThreshold,
+    /// Find, for each node, the k most similar nodes whose similarity is at
+    /// least the threshold.
+    kTopK,
+  };
+
+private:
+  Mode mode_;
+  double threshold_;
+  uint32_t k_;
+
+  SimilarityJoinPlan(
+      Architecture architecture, Mode mode, double threshold, uint32_t k)
+      : Plan(architecture), mode_(mode), threshold_(threshold), k_(k) {}
+
+public:
+  /// Find the 10 most similar nodes of each node.
+  SimilarityJoinPlan() : SimilarityJoinPlan(TopK(10)) {}
+
+  SimilarityJoinPlan& operator=(const SimilarityJoinPlan&) = default;
+
+  Mode mode() const { return mode_; }
+
+  /// The least similarity of a pair in the result
+  double threshold() const { return threshold_; }
+
+  /// The most nodes in the result of a node; 0 in threshold mode
+  uint32_t k() const { return k_; }
+
+  /// Pairs whose similarity is at least threshold, which must be in (0, 1].
+  /// A higher threshold prunes more candidate pairs.
+  static SimilarityJoinPlan Threshold(double threshold) {
+    return {kCPU, kThreshold, threshold, 0};
+  }
+
+  /// The k most similar nodes of each node, of those whose similarity is at
+  /// least min_similarity, which must be in [0, 1].
+  static SimilarityJoinPlan TopK(uint32_t k, double min_similarity = 0) {
+    return {kCPU, kTopK, min_similarity, k};
+  }
+};
+
+/// A node and its similarity to another node, found by SimilarityJoin.
+struct KATANA_EXPORT SimilarNode {
+  uint32_t node;
+  double similarity;
+
+  bool operator==(const SimilarNode& other) const {
+    return node == other.node && similarity == other.similarity;
+  }
+};
+
+/// Find similar pairs of nodes across the whole graph, e.g., for
+/// deduplication or link prediction. The similarity of two nodes is the
+/// Jaccard similarity of their sets of out-neighbors, as computed by
+/// Jaccard; parallel edges count once, and the order of the edges does not
+/// matter. Only nodes that share a neighbor are similar, so a node without
+/// edges is similar to no node, and a node is never in its own result.
+///
+/// The result holds, for each node, the nodes selected by the plan in order
+/// of decreasing similarity and then of increasing node id.
+///
+/// Instead of comparing every pair of nodes, candidates for a node are the
+/// nodes that share one of its rarest neighbors, found through an inverted
+/// index of the neighbor sets. As in the all-pairs algorithm of
+///
+///   Bayardo, Ma and Srikant. Scaling Up All Pairs Similarity Search.
+///   WWW 2007.
+///
+/// a node whose similarity to node n is at least t shares one of the first
+/// |N(n)| - t |N(n)| + 1 rarest neighbors of n and has between t |N(n)| and
+/// |N(n)| / t neighbors, so in threshold mode only those neighbors and
+/// candidates are visited. In top-k mode t is the similarity of the k-th
+/// best node found so far. Candidates are verified with the sorted
+/// intersection routines of Intersection.h, and nodes are processed in
+/// parallel.
+KATANA_EXPORT Result<std::vector<std::vector<SimilarNode>>> SimilarityJoin(
+    PropertyGraph* pg, SimilarityJoinPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
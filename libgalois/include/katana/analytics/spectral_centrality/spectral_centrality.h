@@ -0,0 +1,173 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SPECTRALCENTRALITY_SPECTRALCENTRALITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SPECTRALCENTRALITY_SPECTRALCENTRALITY_H_
+
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// The parameters shared by the power iterations of EigenvectorCentrality,
+/// KatzCentrality and Hits.
+///
+/// Every iteration is a product with the adjacency matrix that pulls along
+/// the in-edges of each node from a transposed copy of the graph, so it
+/// needs no atomics. An iteration stops once the sum over the nodes of the
+/// change of their (normalized) values is below num_nodes * tolerance, or
+/// after max_iterations.
+class SpectralCentralityPlan : public Plan {
+public:
+  /// The type of the values computed and of the output properties
+  enum Precision {
+    kFloat32,
+    kFloat64,
+  };
+
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static const unsigned int kDefaultMaxIterations = 100;
+  static const Precision kDefaultPrecision = kFloat64;
+
+private:
+  double tolerance_;
+  unsigned int max_iterations_;
+  Precision precision_;
+
+protected:
+  SpectralCentralityPlan(
+      Architecture architecture, double tolerance,
+      unsigned int max_iterations, Precision precision)
+      : Plan(architecture),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations),
+        precision_(precision) {}
+
+public:
+  double tolerance() const { return tolerance_; }
+  unsigned int max_iterations() const { return max_iterations_; }
+  Precision precision() const { return precision_; }
+};
+
+/// A computational plan for EigenvectorCentrality.
+class EigenvectorCentralityPlan : public SpectralCentralityPlan {
+  using SpectralCentralityPlan::SpectralCentralityPlan;
+
+public:
+  EigenvectorCentralityPlan() : EigenvectorCentralityPlan(PowerIteration()) {}
+
+  EigenvectorCentralityPlan& operator=(const EigenvectorCentralityPlan&) =
+      default;
+
+  /// Power iteration of A^T + I, normalized to unit length after every
+  /// iteration. Adding the identity does not change the eigenvectors but
+  /// makes the iteration converge on bipartite graphs, where the largest
+  /// eigenvalues of A^T have equal magnitudes.
+  static EigenvectorCentralityPlan PowerIteration(
+      double tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      Precision precision = kDefaultPrecision) {
+    return {kCPU, tolerance, max_iterations, precision};
+  }
+};
+
+/// A computational plan for KatzCentrality.
+class KatzCentralityPlan : public SpectralCentralityPlan {
+public:
+  static constexpr double kDefaultAlpha = 0.1;
+  static constexpr double kDefaultBeta = 1.0;
+  static const bool kDefaultNormalized = true;
+
+private:
+  double alpha_;
+  double beta_;
+  bool normalized_;
+
+  KatzCentralityPlan(
+      Architecture architecture, double alpha, double beta, bool normalized,
+      double tolerance, unsigned int max_iterations, Precision precision)
+      : SpectralCentralityPlan(
+            architecture, tolerance, max_iterations, precision),
+        alpha_(alpha),
+        beta_(beta),
+        normalized_(normalized) {}
+
+public:
+  KatzCentralityPlan() : KatzCentralityPlan(PowerIteration()) {}
+
+  KatzCentralityPlan& operator=(const KatzCentralityPlan&) = default;
+
+  /// The attenuation of each step of a walk; the iteration converges only
+  /// if alpha is below the inverse of the largest eigenvalue of A
+  double alpha() const { return alpha_; }
+  /// The centrality every node has regardless of its in-neighbors
+  double beta() const { return beta_; }
+  /// Scale the result to unit length
+  bool normalized() const { return normalized_; }
+
+  /// Iterate x = alpha A^T x + beta from x = 0
+  static KatzCentralityPlan PowerIteration(
+      double alpha = kDefaultAlpha, double beta = kDefaultBeta,
+      bool normalized = kDefaultNormalized,
+      double tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      Precision precision = kDefaultPrecision) {
+    return {kCPU,      alpha,          beta,     normalized,
+            tolerance, max_iterations, precision};
+  }
+};
+
+/// A computational plan for Hits.
+class HitsPlan : public SpectralCentralityPlan {
+  using SpectralCentralityPlan::SpectralCentralityPlan;
+
+public:
+  HitsPlan() : HitsPlan(PowerIteration()) {}
+
+  HitsPlan& operator=(const HitsPlan&) = default;
+
+  /// Alternate authority = A^T hub and hub = A authority, scaling both to a
+  /// largest value of 1 after every iteration and to a sum of 1 at the end.
+  /// Convergence is checked on the hubs.
+  ///
+  /// Jon M. Kleinberg. Authoritative Sources in a Hyperlinked Environment.
+  /// Journal of the ACM, 1999.
+  static HitsPlan PowerIteration(
+      double tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      Precision precision = kDefaultPrecision) {
+    return {kCPU, tolerance, max_iterations, precision};
+  }
+};
+
+/// Compute the eigenvector centrality of each node in the graph: the entry
+/// of the principal eigenvector of the transposed adjacency matrix, so a
+/// node is central if its in-neighbors are.
+/// The property named output_property_name is created by this function or,
+/// if it exists, overwritten. It holds float or double values depending on
+/// plan.precision().
+KATANA_EXPORT Result<void> EigenvectorCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    EigenvectorCentralityPlan plan = {});
+
+/// Compute the Katz centrality of each node in the graph: beta times the
+/// number of walks that end at the node, each attenuated by alpha per step.
+/// The property named output_property_name is created by this function or,
+/// if it exists, overwritten. It holds float or double values depending on
+/// plan.precision().
+KATANA_EXPORT Result<void> KatzCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    KatzCentralityPlan plan = {});
+
+/// Compute the hub and authority scores of each node in the graph. A node is
+/// a good authority if good hubs point to it and a good hub if it points to
+/// good authorities.
+/// The properties named hub_property_name and authority_property_name are
+/// created by this function or, if they exist, overwritten. They hold float
+/// or double values depending on plan.precision().
+KATANA_EXPORT Result<void> Hits(
+    PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name, HitsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,10 +2,14 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PlanTuner.h"
 #include "katana/analytics/Utils.h"
+#include "katana/analytics/Workspace.h"
 
 namespace katana::analytics {
 
@@ -26,6 +30,8 @@ public:
     kTopological,
     kTopologicalTile,
     kAutomatic,
+    kDeltaStepAdaptive,
+    kMultiQueue,
   };
 
   static const int kDefaultDelta = 13;
@@ -106,13 +112,31 @@ public:
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
   }
+
+  /// Delta stepping without a fixed delta. The initial delta is estimated
+  /// from a sample of edge weights and the average degree, and the bucket
+  /// width is doubled or halved during the run whenever buckets turn out to
+  /// hold too little or too much work to keep the threads busy (see
+  /// katana::AdaptiveOrderedByIntegerMetric).
+  static SsspPlan DeltaStepAdaptive() {
+    return {kCPU, kDeltaStepAdaptive, 0, 0};
+  }
+
+  /// Parallel Dijkstra on a relaxed concurrent priority queue (see
+  /// katana::MultiQueue). Items are ordered by their exact distance rather
+  /// than by a bucket, so no delta needs to be chosen, which suits
+  /// floating-point weights.
+  static SsspPlan MultiQueue() { return {kCPU, kMultiQueue, 0, 0}; }
 };
 
 /// Compute the Single-Source Shortest Path for pg starting from start_node.
 /// The edge weights are taken from the property named
-/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
-/// int), and the computed path lengths are stored in the property named
-/// output_property_name (as uint32_t). The algorithm and delta stepping
+/// edge_weight_property_name (which may be an 8- or 16-bit unsigned int, a
+/// 32- or 64-bit signed or unsigned int, or a float or double), and the
+/// computed path lengths are stored in the property named
+/// output_property_name. Path lengths have the type of the weights, except
+/// that 8- and 16-bit weights give uint32 path lengths, or uint64 if the
+/// graph has paths too long for uint32. The algorithm and delta stepping
 /// parameter can be specified, but have reasonable defaults.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
@@ -121,6 +145,104 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan = {});
 
+/// Like Sssp, but add the output property with workspace, which must belong
+/// to pg (see AnalyticsWorkspace). Give the output property back with
+/// workspace->ReleaseNodeProperty once it is no longer needed so that later
+/// calls reuse it; except with the topological algorithms, its reset then
+/// only touches the nodes this call reached.
+KATANA_EXPORT Result<void> Sssp(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, AnalyticsWorkspace* workspace,
+    SsspPlan plan = {});
+
+/// Store the non-negative weights of the property named
+/// edge_weight_property_name as bits-bit (8 or 16) unsigned ints in a new
+/// edge property named output_property_name, so that Sssp reads 1 or 2 bytes
+/// per edge instead of 4 or 8. Like any edge property, the quantized weights
+/// are kept when pg is written.
+///
+/// Returns the scale of the quantized weights: a quantized weight q stands
+/// for about q * scale, and so do path lengths computed from them. Integer
+/// weights that already fit in bits bits are copied exactly and have a scale
+/// of 1. Positive weights are never quantized to 0.
+KATANA_EXPORT Result<double> SsspQuantizeEdgeWeights(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, uint32_t bits = 16);
+
+/// A computational plan for MultiSourceSssp.
+class MultiSourceSsspPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Delta stepping for a batch of sources at once
+    kDeltaStep,
+  };
+
+  static const unsigned kDefaultDelta = SsspPlan::kDefaultDelta;
+  static const uint32_t kDefaultBatchSize = 16;
+  /// The largest batch, whose lanes fit the bits of a word
+  static const uint32_t kMaxBatchSize = 64;
+
+private:
+  Algorithm algorithm_;
+  unsigned delta_;
+  uint32_t batch_size_;
+
+  MultiSourceSsspPlan(
+      Architecture architecture, Algorithm algorithm, unsigned delta,
+      uint32_t batch_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        delta_(delta),
+        batch_size_(batch_size) {}
+
+public:
+  MultiSourceSsspPlan() : MultiSourceSsspPlan(DeltaStep()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The exponent of the delta step size (2 based), as for SsspPlan
+  unsigned delta() const { return delta_; }
+  /// The number of sources searched together. Larger batches share more
+  /// of the traversal but keep more distances per node in cache.
+  uint32_t batch_size() const { return batch_size_; }
+
+  static MultiSourceSsspPlan DeltaStep(
+      unsigned delta = kDefaultDelta,
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kDeltaStep, delta, batch_size};
+  }
+};
+
+/// Compute the shortest path lengths from each of sources to every node of
+/// pg, following out-edges, with the edge weights in the property named
+/// edge_weight_property_name, which may have any type Sssp accepts.
+///
+/// Rather than running Sssp once per source, the sources are searched in
+/// batches that share one delta stepping worklist: each node keeps the
+/// tentative distances from all sources of a batch side by side, a node is
+/// queued once by the smallest distance that improved, and relaxing an edge
+/// updates the distances of every source whose distance to its node
+/// changed since the node was last relaxed.
+///
+/// The distances are stored in the node property named
+/// output_property_name, which is created by this function and may not
+/// exist before the call. It holds a fixed size list per node whose entry
+/// i is the distance from sources[i], of type double for floating-point
+/// weights and uint64 otherwise; nodes a source does not reach get
+/// infinity or the largest uint64 respectively.
+KATANA_EXPORT Result<void> MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MultiSourceSsspPlan plan = {});
+
+/// Choose a plan for Sssp on pg with the weights in edge_weight_property_name
+/// by timing delta stepping with several deltas, with and without tiles and
+/// barriers, and adaptive delta stepping on a sample of pg, or reuse the
+/// choice cached for pg. See TunePlan.
+KATANA_EXPORT Result<SsspPlan> TuneSsspPlan(
+    const PropertyGraph& pg, const std::string& edge_weight_property_name,
+    const TunerOptions& opts = {});
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
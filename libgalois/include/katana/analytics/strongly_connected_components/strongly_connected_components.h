@@ -0,0 +1,105 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for StronglyConnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Trim trivial components, peel off the largest component with a
+    /// forward-backward search from a high degree pivot, and find the rest
+    /// by coloring
+    kMultistep,
+    /// Trim trivial components and find the rest by coloring
+    kColoring,
+  };
+
+  static const uint32_t kDefaultTrimRounds = 3;
+
+private:
+  Algorithm algorithm_;
+  uint32_t trim_rounds_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t trim_rounds)
+      : Plan(architecture), algorithm_(algorithm), trim_rounds_(trim_rounds) {}
+
+public:
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan(kCPU, kMultistep, kDefaultTrimRounds) {
+  }
+
+  StronglyConnectedComponentsPlan& operator=(
+      const StronglyConnectedComponentsPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The maximum number of rounds of each trimming phase. Each round removes
+  /// the nodes with no remaining in-edges or out-edges, each of which is a
+  /// component by itself.
+  uint32_t trim_rounds() const { return trim_rounds_; }
+
+  /// The Multistep algorithm:
+  ///
+  ///   George M. Slota, Sivasankaran Rajamanickam, and Kamesh Madduri. BFS
+  ///   and Coloring-Based Parallel Algorithms for Strongly Connected
+  ///   Components and Related Problems. IPDPS 2014.
+  ///
+  /// Suited to graphs with one large component, as most real graphs have.
+  static StronglyConnectedComponentsPlan Multistep(
+      uint32_t trim_rounds = kDefaultTrimRounds) {
+    return {kCPU, kMultistep, trim_rounds};
+  }
+
+  /// Coloring without the forward-backward step. Suited to graphs with many
+  /// small components.
+  static StronglyConnectedComponentsPlan Coloring(
+      uint32_t trim_rounds = kDefaultTrimRounds) {
+    return {kCPU, kColoring, trim_rounds};
+  }
+};
+
+/// Compute the strongly connected components of pg, treating its edges as
+/// directed. The result is stored in a uint64 node property named by
+/// output_property_name: every node is labeled with the id of a
+/// representative node of its component, which is labeled with itself.
+/// The in-edges of pg are read from a transpose made with
+/// CreateTransposeGraph.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan = {});
+
+/// Check that the components in the property named property_name are
+/// strongly connected and that no two of them should be merged.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHMATCHING_SUBGRAPHMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHMATCHING_SUBGRAPHMATCHING_H_
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for CountPatternMatches and FindPatternMatches,
+/// specifying the algorithm and any parameters associated with it.
+class PatternMatchPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Generic join: the pattern nodes are matched one at a time, and the
+    /// candidates for a node are the intersection of the sorted adjacencies
+    /// of the graph nodes matched to its pattern neighbors.
+    kGenericJoin,
+  };
+
+  static const uint32_t kDefaultSplitDegree = 256;
+
+private:
+  Algorithm algorithm_;
+  uint32_t split_degree_;
+
+  PatternMatchPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t split_degree)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        split_degree_(split_degree) {}
+
+public:
+  PatternMatchPlan() : PatternMatchPlan(GenericJoin()) {}
+
+  PatternMatchPlan& operator=(const PatternMatchPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Graph nodes matched to the first pattern node that have at least this
+  /// many candidates for the second pattern node are split into one work
+  /// item per candidate, so that idle threads can steal the partial matches
+  /// of high degree nodes.
+  uint32_t split_degree() const { return split_degree_; }
+
+  static PatternMatchPlan GenericJoin(
+      uint32_t split_degree = kDefaultSplitDegree) {
+    return {kCPU, kGenericJoin, split_degree};
+  }
+};
+
+/// A small connected pattern to match against a graph. The edges of a
+/// pattern are undirected.
+struct KATANA_EXPORT Pattern {
+  static constexpr uint32_t kMaxNodes = 8;
+
+  struct Edge {
+    uint32_t a;
+    uint32_t b;
+    /// The type the matching graph edges must have, if any; see
+    /// GraphTopology::edges(node, type)
+    std::optional<uint32_t> type;
+  };
+
+  uint32_t num_nodes{0};
+  std::vector<Edge> edges;
+  /// Name of the integer node property that node_labels refer to
+  std::string node_label_property;
+  /// Either empty or, for each pattern node, the value of
+  /// node_label_property the matching graph node must have, if any
+  std::vector<std::optional<int64_t>> node_labels;
+
+  /// A path of num_nodes nodes
+  static Pattern Path(uint32_t num_nodes);
+  /// A node with num_leaves neighbors, which is node 0
+  static Pattern Star(uint32_t num_leaves);
+  /// A cycle of num_nodes nodes
+  static Pattern Cycle(uint32_t num_nodes);
+  /// num_nodes nodes that are all neighbors of each other
+  static Pattern Clique(uint32_t num_nodes);
+};
+
+/// Count the matches of pattern in pg. A match is a one-to-one map of
+/// pattern nodes to graph nodes that preserves edges, edge types and node
+/// labels. Matches are not induced: the matched graph nodes may have edges
+/// besides those of the pattern. Matches that differ only by a symmetry
+/// of the pattern are counted once, so an unlabeled pattern is counted once
+/// per subgraph of pg that it matches.
+///
+/// The graph must be symmetric (including edge types) and without parallel
+/// edges. If the pattern has no edge types, the edges of each node must be
+/// sorted by destination, e.g., by SortAllEdgesByDest. If it does, every
+/// pattern edge must have a type and the edges of each node must be sorted
+/// by type and destination by SortAllEdgesByType.
+///
+/// The matcher is a worst-case optimal generic join:
+///
+///   Hung Q. Ngo, Christopher Ré, and Atri Rudra. Skew Strikes Back: New
+///   Developments in the Theory of Join Algorithms. SIGMOD Record, 2013.
+///
+/// The candidates for each pattern node are computed with the SIMD sorted
+/// intersections of Intersection.h, and symmetries of the pattern are
+/// broken by requiring matches to be ordered as in:
+///
+///   Joshua A. Grochow and Manolis Kellis. Network Motif Discovery Using
+///   Subgraph Enumeration and Symmetry-Breaking. RECOMB 2007.
+KATANA_EXPORT Result<uint64_t> CountPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern, PatternMatchPlan plan = {});
+
+/// Called with each match: entry i of match is the graph node matched to
+/// pattern node i. It is called concurrently from several threads.
+using PatternMatchCallback = std::function<void(const uint32_t* match)>;
+
+/// Call callback with each of the matches of pattern in pg that
+/// CountPatternMatches counts.
+KATANA_EXPORT Result<void> FindPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern,
+    const PatternMatchCallback& callback, PatternMatchPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
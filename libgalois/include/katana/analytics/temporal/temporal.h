@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TEMPORAL_TEMPORAL_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TEMPORAL_TEMPORAL_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace katana::analytics {
+
+/// A computational plan for EarliestArrival.
+class EarliestArrivalPlan : public Plan {
+public:
+  enum Algorithm {
+    kFrontier,
+  };
+
+  /// The arrival time of nodes that cannot be reached in the window
+  static constexpr int64_t kUnreachable = std::numeric_limits<int64_t>::max();
+
+private:
+  Algorithm algorithm_;
+
+  EarliestArrivalPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  EarliestArrivalPlan() : EarliestArrivalPlan{kCPU, kFrontier} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Relax the out-edges of the nodes whose arrival improved, one frontier
+  /// per round. A node relaxes only its edges between its new arrival and
+  /// the arrival it last relaxed from, which is a range of its time sorted
+  /// edges, so every edge is relaxed at most once however often the arrival
+  /// of its source improves.
+  static EarliestArrivalPlan Frontier() { return {kCPU, kFrontier}; }
+};
+
+/// Compute the earliest time at which each node can be reached from source
+/// by a time-respecting path within [begin_time, end_time): a path whose
+/// edges have times in the window that do not decrease along the path. The
+/// source is reached at begin_time and every other node at the time of the
+/// last edge of its earliest path, or at EarliestArrivalPlan::kUnreachable.
+/// The int64 node property output_property_name is created by this
+/// function or, if it exists, overwritten.
+///
+/// The edges of each node must be sorted by the integer or timestamp edge
+/// property time_property (see SortAllEdgesByTime). The graph is indexed by
+/// time_property if it is not already, and the index is kept with it for
+/// later calls.
+KATANA_EXPORT Result<void> EarliestArrival(
+    PropertyGraph* pg, uint32_t source, const std::string& time_property,
+    int64_t begin_time, int64_t end_time,
+    const std::string& output_property_name, EarliestArrivalPlan plan = {});
+
+/// Compute the Page Rank of each node over the edges whose time_property is
+/// in [begin_time, end_time), as Pagerank would on the subgraph of those
+/// edges, but without extracting it. Only the tolerance, max_iterations and
+/// alpha of plan are used; ranks are computed with the synchronous push
+/// algorithm. The float node property output_property_name is created by
+/// this function or, if it exists, overwritten.
+///
+/// The edges of each node must be sorted by time_property, as for
+/// EarliestArrival, so that the out-degree and out-edges of a node in the
+/// window are found by binary search. Rerunning over another window, e.g.,
+/// to refresh a dashboard, only costs the new Page Rank computation.
+KATANA_EXPORT Result<void> TemporalPagerank(
+    PropertyGraph* pg, const std::string& time_property, int64_t begin_time,
+    int64_t end_time, const std::string& output_property_name,
+    PagerankPlan plan = PagerankPlan::PushSynchronous());
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TOPOLOGICALSORT_TOPOLOGICALSORT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TOPOLOGICALSORT_TOPOLOGICALSORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan for TopologicalSort, DagLongestPath and
+/// DagCriticalPath, specifying the algorithm and any parameters associated
+/// with it.
+class TopologicalSortPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Kahn's algorithm a level at a time: every node whose in-edges all
+    /// come from earlier levels forms the next level, and the out-edges of
+    /// a whole level are processed in parallel
+    kFrontier,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  TopologicalSortPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  TopologicalSortPlan() : TopologicalSortPlan(kCPU, kFrontier) {}
+
+  TopologicalSortPlan& operator=(const TopologicalSortPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Level synchronous Kahn's algorithm. The number of rounds is the number
+  /// of nodes on the longest path, so it suits wide DAGs such as build
+  /// dependency and workflow graphs.
+  static TopologicalSortPlan Frontier() { return {kCPU, kFrontier}; }
+};
+
+/// Compute a topological order of pg, treating its edges as directed. The
+/// position of each node in the order is stored in a uint64 node property
+/// named by output_property_name; every edge goes from a smaller position to
+/// a larger one. Nodes are ordered by level, the number of edges on the
+/// longest path ending at them, and then by id, so the order is
+/// deterministic.
+///
+/// If pg has a cycle, including a self loop, this returns
+/// ErrorCode::InvalidArgument and adds no property.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> TopologicalSort(
+    PropertyGraph* pg, const std::string& output_property_name,
+    TopologicalSortPlan plan = {});
+
+/// Check that the positions in the property named property_name are a
+/// permutation of the nodes and that every edge goes forward in it.
+KATANA_EXPORT Result<void> TopologicalSortAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+/// Compute for each node of the DAG pg the length of the longest path that
+/// ends at it, which is its earliest start time when the edge weights are
+/// the durations of the tasks at their sources. Paths may start at any
+/// node, so the length is never negative, even with negative weights. The
+/// lengths are stored in a node property named by output_property_name of
+/// the type of the edge property named by edge_weight_property_name, which
+/// must be an integer or floating point type. If edge_weight_property_name
+/// is empty every edge has weight 1, and the lengths are uint32 levels.
+///
+/// If slack_property_name is not empty, the slack of each node is stored in
+/// a property of that name: the length of the longest path in pg minus that
+/// of the longest path through the node. Nodes on critical paths have slack
+/// 0, up to rounding for floating point weights.
+///
+/// If pg has a cycle this returns ErrorCode::InvalidArgument and adds no
+/// property. The output properties are created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<void> DagLongestPath(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    const std::string& slack_property_name = "",
+    TopologicalSortPlan plan = {});
+
+/// Return the nodes of a longest path of the DAG pg, in order, with the edge
+/// weights of DagLongestPath. Ties are broken towards smaller node ids and
+/// then earlier edges, and the path is empty if pg has no nodes.
+///
+/// If pg has a cycle this returns ErrorCode::InvalidArgument.
+KATANA_EXPORT Result<std::vector<uint32_t>> DagCriticalPath(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    TopologicalSortPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
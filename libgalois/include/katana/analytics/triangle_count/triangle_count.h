@@ -15,6 +15,8 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kEdgeSampling,
+    kWedgeSampling,
   };
 
   enum Relabeling {
@@ -25,19 +27,40 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static constexpr double kDefaultEdgeProbability = 0.1;
+  static constexpr double kDefaultRelativeError = 0.01;
+  static constexpr double kDefaultTimeBudgetSeconds = 60;
+  static const uint64_t kDefaultSeed = 0;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  double edge_probability_;
+  double relative_error_;
+  double time_budget_seconds_;
+  uint64_t seed_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, double edge_probability, double relative_error,
+      double time_budget_seconds, uint64_t seed)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        edge_probability_(edge_probability),
+        relative_error_(relative_error),
+        time_budget_seconds_(time_budget_seconds),
+        seed_(seed) {}
+
+  TriangleCountPlan(
+      Architecture architecture, Algorithm algorithm, bool edges_sorted,
+      Relabeling relabeling)
+      : TriangleCountPlan(
+            architecture, algorithm, edges_sorted, relabeling,
+            kDefaultEdgeProbability, kDefaultRelativeError,
+            kDefaultTimeBudgetSeconds, kDefaultSeed) {}
 
 public:
   TriangleCountPlan()
@@ -47,6 +70,18 @@ public:
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  /// The probability with which kEdgeSampling keeps each edge
+  double edge_probability() const { return edge_probability_; }
+  /// The relative standard error at which kWedgeSampling stops
+  double relative_error() const { return relative_error_; }
+  /// The time after which kWedgeSampling stops regardless of its error
+  double time_budget_seconds() const { return time_budget_seconds_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Whether the algorithm estimates the count rather than computing it
+  bool is_approximate() const {
+    return algorithm_ == kEdgeSampling || algorithm_ == kWedgeSampling;
+  }
 
   /**
    * The node-iterator algorithm from the following:
@@ -82,6 +117,11 @@ public:
    * ordered count algorithm from the following:
    * http://gap.cs.berkeley.edu/benchmark.html
    *
+   * When relabeling, this algorithm counts over
+   * PropertyGraph::OrientByDegree rather than a relabeled copy of the graph.
+   * The orientation is kept with the graph and shared with other analytics
+   * such as LocalClusteringCoefficient and KCliqueCount.
+   *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
    */
@@ -90,13 +130,90 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCount, edges_sorted, relabeling};
   }
+
+  /**
+   * DOULION edge sparsification from the following:
+   *   Charalampos E. Tsourakakis, U Kang, Gary L. Miller, and Christos
+   *   Faloutsos. DOULION: Counting Triangles in Massive Graphs with a Coin.
+   *   KDD 2009.
+   *
+   * Each edge is kept with probability edge_probability and the triangles of
+   * the remaining graph are counted exactly, so the work shrinks roughly with
+   * the cube of edge_probability. The variance is larger for graphs whose
+   * triangles share many edges.
+   *
+   * @param edge_probability The probability of keeping an edge, in (0, 1].
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param seed The seed of the coin flips.
+   */
+  static TriangleCountPlan EdgeSampling(
+      double edge_probability = kDefaultEdgeProbability,
+      bool edges_sorted = kDefaultEdgeSorted, uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kEdgeSampling,
+            edges_sorted,
+            kNoRelabel,
+            edge_probability,
+            kDefaultRelativeError,
+            kDefaultTimeBudgetSeconds,
+            seed};
+  }
+
+  /**
+   * Wedge sampling from the following:
+   *   C. Seshadhri, Ali Pinar, and Tamara G. Kolda. Triadic Measures on
+   *   Graphs: The Power of Wedge Sampling. SDM 2013.
+   *
+   * Wedges (paths of two edges) are drawn uniformly at random, in rounds,
+   * and the fraction that are closed by a third edge scales the total number
+   * of wedges. Sampling stops once the relative standard error of the
+   * estimate is at most relative_error or after time_budget_seconds.
+   *
+   * @param relative_error The target relative standard error, e.g., 0.01.
+   * @param time_budget_seconds The time after which sampling stops.
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param seed The seed of the samples.
+   */
+  static TriangleCountPlan WedgeSampling(
+      double relative_error = kDefaultRelativeError,
+      double time_budget_seconds = kDefaultTimeBudgetSeconds,
+      bool edges_sorted = kDefaultEdgeSorted, uint64_t seed = kDefaultSeed) {
+    return {kCPU,
+            kWedgeSampling,
+            edges_sorted,
+            kNoRelabel,
+            kDefaultEdgeProbability,
+            relative_error,
+            time_budget_seconds,
+            seed};
+  }
+};
+
+/// An estimate of the number of triangles of a graph
+struct KATANA_EXPORT TriangleCountEstimate {
+  /// The estimated number of triangles
+  double triangles;
+  /// The estimated variance of triangles; 0 for exact counts
+  double variance;
+  /// The number of edges or wedges sampled; 0 for exact counts
+  uint64_t num_samples;
+
+  double standard_error() const;
+
+  /// The half width of the confidence interval of triangles at the given
+  /// confidence, e.g., 0.95, by the normal approximation
+  double ConfidenceInterval(double confidence = 0.95) const;
 };
 
 /**
  * Count the total number of triangles in the graph. The graph must be
  * symmetric!
  *
- * This algorithm copies the graph internally.
+ * This algorithm copies the graph internally, except for kOrderedCount with
+ * relabeling, which orients pg by degree instead.
+ *
+ * To list the triangles rather than count them, use KCliqueList or
+ * KCliqueListBatches with k = 3.
  *
  * @param pg The graph to process.
  * @param plan
@@ -104,6 +221,19 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/**
+ * Estimate the total number of triangles in the graph with the sampling
+ * algorithm of plan, kWedgeSampling by default. For exact algorithms the
+ * estimate is the exact count with variance 0. TriangleCount rounds this
+ * estimate when given a sampling plan. The graph must be symmetric!
+ *
+ * @param pg The graph to process.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<TriangleCountEstimate> EstimateTriangleCount(
+    PropertyGraph* pg,
+    TriangleCountPlan plan = TriangleCountPlan::WedgeSampling());
+
 }  // namespace katana::analytics
 
 #endif
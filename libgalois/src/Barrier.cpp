@@ -19,12 +19,23 @@
 
 #include "katana/Barrier.h"
 
+#include <string>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
 
 // anchor vtable
 katana::Barrier::~Barrier() = default;
 
+namespace {
+
+/// The most threads on a single socket for which one shared counter beats a
+/// combining tree
+constexpr unsigned kMaxCountingThreads = 16;
+
+}  // namespace
+
 static katana::Barrier* kBarrier = nullptr;
 static unsigned kBarrierThreads = 0;
 
@@ -48,10 +59,51 @@ katana::GetBarrier(unsigned active_threads) {
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
-  if (active_threads != kBarrierThreads) {
-    kBarrierThreads = active_threads;
-    kBarrier->Reinit(kBarrierThreads);
+  // A sub-pool synchronizes on its own barrier
+  katana::Barrier* barrier = kBarrier;
+  unsigned* barrier_threads = &kBarrierThreads;
+  if (auto* team = ThreadPool::getCurrentTeam()) {
+    barrier = team->barrier;
+    barrier_threads = &team->barrier_threads;
+  }
+
+  if (active_threads != *barrier_threads) {
+    *barrier_threads = active_threads;
+    barrier->Reinit(active_threads);
+  }
+
+  return *barrier;
+}
+
+std::unique_ptr<katana::Barrier>
+katana::CreateBarrier(unsigned active_threads) {
+  std::string kind;
+  if (GetEnv("KATANA_BARRIER", &kind)) {
+    if (kind == "counting") {
+      return CreateCountingBarrier(active_threads);
+    }
+    if (kind == "hierarchical") {
+      return CreateHierarchicalBarrier(active_threads);
+    }
+    if (kind == "mcs") {
+      return CreateMCSBarrier(active_threads);
+    }
+    if (kind == "topo") {
+      return CreateTopoBarrier(active_threads);
+    }
+    if (kind == "dissemination") {
+      return CreateDisseminationBarrier(active_threads);
+    }
+    KATANA_LOG_WARN(
+        "unknown KATANA_BARRIER value {}; expected counting, "
+        "hierarchical, mcs, topo or dissemination",
+        kind);
   }
 
-  return *kBarrier;
+  auto& tp = GetThreadPool();
+  if (tp.getMaxSockets() <= 1 &&
+      tp.getMaxUsableThreads() <= kMaxCountingThreads) {
+    return CreateCountingBarrier(active_threads);
+  }
+  return CreateHierarchicalBarrier(active_threads);
 }
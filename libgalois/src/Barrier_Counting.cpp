@@ -43,7 +43,7 @@ public:
 
   void Reinit(unsigned val) override { _reinit(val); }
 
-  void Wait() override {
+  void DoWait() override {
     bool& lsense = local_sense_.at(katana::ThreadPool::getTID()).get();
     lsense = !lsense;
     if (--count_ == 0) {
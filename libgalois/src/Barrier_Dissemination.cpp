@@ -76,7 +76,7 @@ public:
 
   void Reinit(unsigned val) override { _reinit(val); }
 
-  void Wait() override {
+  void DoWait() override {
     auto& ld = nodes_.at(katana::ThreadPool::getTID()).get();
     auto& sense = ld.sense;
     auto& parity = ld.parity;
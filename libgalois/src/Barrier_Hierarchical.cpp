@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "katana/Barrier.h"
+#include "katana/CacheLineStorage.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// A combining tree barrier whose subtrees follow the socket topology.
+///
+/// The threads of each socket arrive at small leaf counters, and the last
+/// thread to arrive at a node carries on to its parent. Each socket's leaves
+/// combine into a subtree of their own before the socket roots combine, so
+/// only one thread per socket touches cache lines shared with other sockets.
+/// The last arrival at the root releases the tree on the way back down:
+/// every node is released by the thread that completed it, and the waiters
+/// at a node spin on that node's cache line alone.
+class HierarchicalBarrier : public katana::Barrier {
+  /// Threads that share a leaf counter
+  static constexpr unsigned kLeafThreads = 8;
+  /// Children that share an inner node
+  static constexpr unsigned kFanIn = 4;
+  static constexpr size_t kNoParent = ~size_t{0};
+
+  struct Node {
+    std::atomic<unsigned> count{0};
+    std::atomic<bool> sense{false};
+    unsigned fan_in{0};
+    Node* parent{nullptr};
+  };
+
+  struct Spec {
+    unsigned fan_in;
+    size_t parent;
+  };
+
+  std::unique_ptr<katana::CacheLineStorage<Node>[]> nodes_;
+  std::vector<Node*> leaf_of_thread_;
+  std::vector<katana::CacheLineStorage<bool>> local_sense_;
+
+  /// Combine level into parents of up to kFanIn children until one node is
+  /// left and return it
+  static size_t Combine(std::vector<size_t> level, std::vector<Spec>* specs) {
+    while (level.size() > 1) {
+      std::vector<size_t> next;
+      for (size_t i = 0; i < level.size(); i += kFanIn) {
+        size_t end = std::min(level.size(), i + kFanIn);
+        size_t parent = specs->size();
+        specs->push_back(Spec{static_cast<unsigned>(end - i), kNoParent});
+        for (size_t j = i; j < end; ++j) {
+          (*specs)[level[j]].parent = parent;
+        }
+        next.push_back(parent);
+      }
+      level = std::move(next);
+    }
+    return level[0];
+  }
+
+  void _reinit(unsigned P) {
+    auto& tp = katana::GetThreadPool();
+
+    std::vector<std::vector<unsigned>> socket_threads;
+    for (unsigned tid = 0; tid < P; ++tid) {
+      unsigned socket = tp.getSocket(tid);
+      if (socket >= socket_threads.size()) {
+        socket_threads.resize(socket + 1);
+      }
+      socket_threads[socket].push_back(tid);
+    }
+
+    std::vector<Spec> specs;
+    std::vector<size_t> leaf_spec(P);
+    std::vector<size_t> socket_roots;
+    for (const auto& threads : socket_threads) {
+      if (threads.empty()) {
+        continue;
+      }
+      std::vector<size_t> leaves;
+      for (size_t i = 0; i < threads.size(); i += kLeafThreads) {
+        size_t end = std::min(threads.size(), i + kLeafThreads);
+        leaves.push_back(specs.size());
+        specs.push_back(Spec{static_cast<unsigned>(end - i), kNoParent});
+        for (size_t j = i; j < end; ++j) {
+          leaf_spec[threads[j]] = leaves.back();
+        }
+      }
+      socket_roots.push_back(Combine(std::move(leaves), &specs));
+    }
+    if (!socket_roots.empty()) {
+      Combine(std::move(socket_roots), &specs);
+    }
+
+    nodes_ = std::make_unique<katana::CacheLineStorage<Node>[]>(specs.size());
+    for (size_t i = 0; i < specs.size(); ++i) {
+      Node& n = nodes_[i].get();
+      n.count = n.fan_in = specs[i].fan_in;
+      n.sense = false;
+      if (specs[i].parent != kNoParent) {
+        n.parent = &nodes_[specs[i].parent].get();
+      }
+    }
+
+    leaf_of_thread_.resize(P);
+    local_sense_.resize(P);
+    for (unsigned tid = 0; tid < P; ++tid) {
+      leaf_of_thread_[tid] = &nodes_[leaf_spec[tid]].get();
+      local_sense_[tid].get() = false;
+    }
+  }
+
+  static void Arrive(Node* n, bool sense) {
+    if (n->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (n->parent) {
+        Arrive(n->parent, sense);
+      }
+      n->count.store(n->fan_in, std::memory_order_relaxed);
+      n->sense.store(sense, std::memory_order_release);
+    } else {
+      while (n->sense.load(std::memory_order_acquire) != sense) {
+        katana::asmPause();
+      }
+    }
+  }
+
+public:
+  HierarchicalBarrier(unsigned active_threads) { _reinit(active_threads); }
+
+  void Reinit(unsigned val) override { _reinit(val); }
+
+  void DoWait() override {
+    unsigned tid = katana::ThreadPool::getTID();
+    bool& lsense = local_sense_.at(tid).get();
+    lsense = !lsense;
+    Arrive(leaf_of_thread_[tid], lsense);
+  }
+
+  const char* name() const override { return "HierarchicalBarrier"; }
+};
+
+}  // namespace
+
+std::unique_ptr<katana::Barrier>
+katana::CreateHierarchicalBarrier(unsigned active_threads) {
+  return std::make_unique<HierarchicalBarrier>(active_threads);
+}
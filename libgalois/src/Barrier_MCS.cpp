@@ -74,7 +74,7 @@ public:
 
   void Reinit(unsigned val) override { _reinit(val); }
 
-  void Wait() override {
+  void DoWait() override {
     TreeNode& n = nodes_.at(katana::ThreadPool::getTID()).get();
     while (n.child_not_ready[0] || n.child_not_ready[1] ||
            n.child_not_ready[2] || n.child_not_ready[3]) {
@@ -25,7 +25,7 @@
 
 namespace {
 
-class OneWayBarrier : public katana::Barrier {
+class OneWayBarrier {
   std::mutex lock;
   std::condition_variable cond;
   unsigned count;
@@ -34,19 +34,17 @@ class OneWayBarrier : public katana::Barrier {
 public:
   OneWayBarrier(unsigned p) { Reinit(p); }
 
-  void Reinit(unsigned val) override {
+  void Reinit(unsigned val) {
     count = 0;
     total = val;
   }
 
-  void Wait() override {
+  void Wait() {
     std::unique_lock<std::mutex> tmp(lock);
     count += 1;
     cond.wait(tmp, [this]() { return count >= total; });
     cond.notify_all();
   }
-
-  const char* name() const override { return "OneWayBarrier"; }
 };
 
 class SimpleBarrier : public katana::Barrier {
@@ -63,7 +61,7 @@ public:
     barrier2.Reinit(val);
   }
 
-  void Wait() override {
+  void DoWait() override {
     barrier1.Wait();
     if (katana::ThreadPool::getTID() == 0) {
       barrier1.Reinit(total);
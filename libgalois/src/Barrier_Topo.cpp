@@ -79,7 +79,7 @@ public:
   // not safe if any thread is in wait
   void Reinit(unsigned val) override { _reinit(val); }
 
-  void Wait() override {
+  void DoWait() override {
     unsigned id = katana::ThreadPool::getTID();
     TreeNode& n = *nodes_.getLocal();
     unsigned& s = *sense_.getLocal();
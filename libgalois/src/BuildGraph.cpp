@@ -1748,30 +1748,14 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
     std::cout << "Finished topology and ordering edges\n";
   }
 
-  // build topology
+  // build topology; the arrays hand their memory to arrow without a copy
   auto topology = std::make_shared<katana::GraphTopology>();
-  arrow::Status st;
-  std::shared_ptr<arrow::UInt64Builder> topology_indices_builder =
-      std::make_shared<arrow::UInt64Builder>();
-  st = topology_indices_builder->AppendValues(topology_builder_.out_indices);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL("Error building topology");
-  }
-  std::shared_ptr<arrow::UInt32Builder> topology_dests_builder =
-      std::make_shared<arrow::UInt32Builder>();
-  st = topology_dests_builder->AppendValues(topology_builder_.out_dests);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL("Error building topology");
-  }
-
-  st = topology_indices_builder->Finish(&topology->out_indices);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL("Error building arrow array for topology");
-  }
-  st = topology_dests_builder->Finish(&topology->out_dests);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL("Error building arrow array for topology");
-  }
+  size_t num_indices = topology_builder_.out_indices.size();
+  topology->out_indices = std::make_shared<arrow::UInt64Array>(
+      num_indices, std::move(topology_builder_.out_indices).ToBuffer());
+  size_t num_dests = topology_builder_.out_dests.size();
+  topology->out_dests = std::make_shared<arrow::UInt32Array>(
+      num_dests, std::move(topology_builder_.out_dests).ToBuffer());
 
   if (verbose) {
     std::cout << "Finished mongodb conversion to arrow\n";
@@ -1988,7 +1972,7 @@ ToArrowArray(
     auto* pool = arrow::default_memory_pool();
     arrow::TimestampBuilder builder(
         arrow::timestamp(arrow::TimeUnit::MILLI, "UTC"), pool);
-    arrow_dst = BuildImportVec<arrow::TimestampBuilder, bool>(
+    arrow_dst = BuildImportVec<arrow::TimestampBuilder, int64_t>(
         std::move(builder), arrow_dst, import_src);
     break;
   }
@@ -2014,8 +1998,45 @@ katana::ImportToArrow(
   std::shared_ptr<arrow::Array> array = nullptr;
 
   array = ToArrowArray(arrow_type, array, import_src);
+  if (!array) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "building arrow array failed");
+  }
 
   std::vector<std::shared_ptr<arrow::Array>> chunks;
   chunks.push_back(std::move(array));
   return std::make_shared<arrow::ChunkedArray>(chunks);
 }
+
+katana::Result<arrow::Type::type>
+katana::ArrowTypeOf(const katana::PropertyKey& key) {
+  if (key.is_list) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "list property {} is not supported", key.name);
+  }
+  switch (key.type) {
+  case ImportDataType::kString:
+    return arrow::Type::STRING;
+  case ImportDataType::kInt64:
+    return arrow::Type::INT64;
+  case ImportDataType::kInt32:
+    return arrow::Type::INT32;
+  case ImportDataType::kUInt32:
+    return arrow::Type::UINT32;
+  case ImportDataType::kDouble:
+    return arrow::Type::DOUBLE;
+  case ImportDataType::kFloat:
+    return arrow::Type::FLOAT;
+  case ImportDataType::kBoolean:
+    return arrow::Type::BOOL;
+  case ImportDataType::kTimestampMilli:
+    return arrow::Type::TIMESTAMP;
+  case ImportDataType::kStruct:
+    return arrow::Type::UINT8;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "property {} has unknown type {}",
+        key.name, key.type);
+  }
+}
@@ -0,0 +1,19 @@
+#include "katana/Cancel.h"
+
+namespace {
+
+thread_local const katana::CancelFlag* current_flag = nullptr;
+
+}  // namespace
+
+katana::CancelScope::CancelScope(const CancelFlag* flag)
+    : prev_(current_flag) {
+  current_flag = flag;
+}
+
+katana::CancelScope::~CancelScope() { current_flag = prev_; }
+
+bool
+katana::CancelRequested() {
+  return current_flag && current_flag->IsCancelled();
+}
@@ -0,0 +1,99 @@
+#include "katana/CompressedGraphTopology.h"
+
+#include <cstring>
+
+#include "katana/Loops.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+
+katana::Result<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::Make(
+    const GraphTopology& topology, tsuba::TopologyEncoding encoding,
+    uint64_t nodes_per_block) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  tsuba::FileFrame ff;
+  if (auto res = ff.Init(); !res) {
+    return res.error();
+  }
+  if (auto res = tsuba::WriteCompressedCSRTopology(
+          &ff, num_nodes, num_edges,
+          num_nodes ? topology.out_indices->raw_values() : nullptr,
+          num_edges ? topology.out_dests->raw_values() : nullptr, encoding,
+          nodes_per_block);
+      !res) {
+    return res.error();
+  }
+
+  auto size_res = ff.Tell();
+  if (!size_res.ok()) {
+    return tsuba::ArrowToTsuba(size_res.status().code());
+  }
+  int64_t size = size_res.ValueOrDie();
+
+  auto buffer_res = arrow::AllocateBuffer(size);
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating compressed topology: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+
+  auto ptr_res = ff.ptr<uint8_t>();
+  if (!ptr_res) {
+    return ptr_res.error();
+  }
+  std::memcpy(buffer->mutable_data(), ptr_res.value(), size);
+
+  return Make(std::move(buffer));
+}
+
+katana::Result<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::Make(std::shared_ptr<arrow::Buffer> buffer) {
+  auto view_res =
+      tsuba::CompressedCSRTopologyView::Make(buffer->data(), buffer->size());
+  if (!view_res) {
+    return view_res.error();
+  }
+  return CompressedGraphTopology(std::move(buffer), view_res.value());
+}
+
+katana::Result<katana::GraphTopology>
+katana::CompressedGraphTopology::Decompress() const {
+  uint64_t num_nodes = this->num_nodes();
+  uint64_t num_edges = this->num_edges();
+
+  auto indices_res = arrow::AllocateBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating out_indices: {}",
+        indices_res.status());
+  }
+  auto dests_res = arrow::AllocateBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating out_dests: {}",
+        dests_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.ValueOrDie());
+
+  auto* new_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        new_indices[n] = view_.out_indexes()[n];
+        uint32_t* out = new_dests + view_.edge_range(n).first;
+        for (uint32_t dest : OutDests(n)) {
+          *out++ = dest;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return GraphTopology{
+      .out_indices = std::make_shared<arrow::UInt64Array>(num_nodes, indices),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
+  };
+}
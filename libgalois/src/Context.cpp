@@ -66,24 +66,36 @@ katana::SimpleRuntimeContext::release(katana::Lockable* lockable) {
 }
 
 unsigned
-katana::SimpleRuntimeContext::commitIteration() {
+katana::SimpleRuntimeContext::releaseAll(bool written) {
   unsigned numLocks = 0;
   while (locks) {
     // ORDER MATTERS!
     Lockable* lockable = locks;
     locks = lockable->next;
     lockable->next = 0;
+    // Optimistic readers check the owner before the version, so the new
+    // version must be visible before the Lockable is released
+    if (written) {
+      lockable->version.fetch_add(1, std::memory_order_release);
+    }
     compilerBarrier();
     release(lockable);
     ++numLocks;
   }
+  reads.clear();
 
   return numLocks;
 }
 
+unsigned
+katana::SimpleRuntimeContext::commitIteration() {
+  return releaseAll(optimistic);
+}
+
 unsigned
 katana::SimpleRuntimeContext::cancelIteration() {
-  return commitIteration();
+  // A cautious operator has not written anything when it aborts
+  return releaseAll(false);
 }
 
 void
@@ -0,0 +1,592 @@
+#include "katana/Distribution.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The first edge of node n of the graph described by prefix
+uint64_t
+EdgeBegin(const tsuba::RDGPrefix& prefix, uint64_t n) {
+  return n > 0 ? prefix.out_indexes()[n - 1] : 0;
+}
+
+/// Which hosts own which nodes and get which edges
+class Layout {
+public:
+  Layout(const tsuba::RDGPrefix& prefix, const katana::PartitionOptions& opts)
+      : num_hosts_(opts.num_hosts), num_columns_(1) {
+    if (opts.policy == katana::PartitionPolicy::kCartesianVertexCut) {
+      // The most square grid with no more columns than rows
+      for (uint32_t c = 1; c * c <= num_hosts_; ++c) {
+        if (num_hosts_ % c == 0) {
+          num_columns_ = c;
+        }
+      }
+    }
+
+    // Host h owns the nodes n with cost(n) in [h * total / H, (h + 1) *
+    // total / H) where cost(n) counts the nodes and edges before n
+    uint64_t num_nodes = prefix.num_nodes();
+    uint64_t total = num_nodes + prefix.num_edges();
+    owned_begin_.emplace_back(0);
+    for (uint32_t h = 1; h < num_hosts_; ++h) {
+      uint64_t target =
+          (total / num_hosts_) * h + (total % num_hosts_) * h / num_hosts_;
+      uint64_t lo = owned_begin_.back();
+      uint64_t hi = num_nodes;
+      while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (mid + EdgeBegin(prefix, mid) < target) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      owned_begin_.emplace_back(lo);
+    }
+    owned_begin_.emplace_back(num_nodes);
+  }
+
+  uint32_t num_hosts() const { return num_hosts_; }
+  uint32_t num_rows() const { return num_hosts_ / num_columns_; }
+  uint32_t num_columns() const { return num_columns_; }
+
+  uint32_t Owner(uint64_t node) const {
+    auto first_end = owned_begin_.begin() + 1;
+    return std::upper_bound(first_end, owned_begin_.end(), node) - first_end;
+  }
+
+  uint32_t EdgeHost(uint32_t src_owner, uint32_t dest_owner) const {
+    return src_owner / num_columns_ * num_columns_ + dest_owner % num_columns_;
+  }
+
+  /// The nodes owned by host
+  std::pair<uint64_t, uint64_t> Owned(uint32_t host) const {
+    return {owned_begin_[host], owned_begin_[host + 1]};
+  }
+
+  /// The nodes whose edges may go to host, i.e., those owned by its row
+  std::pair<uint64_t, uint64_t> Sources(uint32_t host) const {
+    uint32_t row_begin = host / num_columns_ * num_columns_;
+    return {owned_begin_[row_begin], owned_begin_[row_begin + num_columns_]};
+  }
+
+private:
+  uint32_t num_hosts_;
+  uint32_t num_columns_;
+  std::vector<uint64_t> owned_begin_;
+};
+
+/// The nodes and edges of one host
+struct Partition {
+  uint32_t host;
+  uint64_t owned_begin;
+  uint64_t owned_end;
+  /// Global IDs of the mirrors, in increasing order
+  std::vector<uint64_t> mirrors;
+
+  std::shared_ptr<arrow::UInt64Array> out_indices;
+  std::shared_ptr<arrow::UInt32Array> out_dests;
+  std::shared_ptr<arrow::Table> node_properties;
+  std::shared_ptr<arrow::Table> edge_properties;
+
+  /// mirrored[h] has a bit for each master, set if host h mirrors it
+  std::vector<katana::DynamicBitset> mirrored;
+
+  uint64_t num_owned() const { return owned_end - owned_begin; }
+  uint64_t num_nodes() const { return num_owned() + mirrors.size(); }
+
+  bool IsLocal(uint64_t global) const {
+    return (global >= owned_begin && global < owned_end) ||
+           std::binary_search(mirrors.begin(), mirrors.end(), global);
+  }
+
+  /// The local ID of a node for which IsLocal is true
+  Node LocalId(uint64_t global) const {
+    if (global >= owned_begin && global < owned_end) {
+      return global - owned_begin;
+    }
+    return num_owned() +
+           (std::lower_bound(mirrors.begin(), mirrors.end(), global) -
+            mirrors.begin());
+  }
+
+  /// The range of mirrors owned by host
+  std::pair<uint64_t, uint64_t> MirrorRange(
+      const Layout& layout, uint32_t host) const {
+    auto [begin, end] = layout.Owned(host);
+    return {
+        std::lower_bound(mirrors.begin(), mirrors.end(), begin) -
+            mirrors.begin(),
+        std::lower_bound(mirrors.begin(), mirrors.end(), end) -
+            mirrors.begin()};
+  }
+};
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto res = arrow::compute::Take(table, indices);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "selecting rows: {}", res.status());
+  }
+  return res.ValueOrDie().table();
+}
+
+tsuba::RDGSlice::SliceArg
+MakeSliceArg(
+    const tsuba::RDGPrefix& prefix, uint64_t begin, uint64_t end,
+    bool with_topology) {
+  uint64_t edge_begin = EdgeBegin(prefix, begin);
+  uint64_t edge_end = EdgeBegin(prefix, end);
+  return tsuba::RDGSlice::SliceArg{
+      .node_range = {begin, end},
+      .edge_range = {edge_begin, edge_end},
+      .topo_off = prefix.view_offset() + edge_begin * sizeof(Node),
+      .topo_size = with_topology ? (edge_end - edge_begin) * sizeof(Node) : 0,
+  };
+}
+
+/// Read the edges of part and find its mirrors
+katana::Result<void>
+LoadEdges(
+    tsuba::RDGHandle handle, const tsuba::RDGPrefix& prefix,
+    const Layout& layout, const katana::PartitionOptions& opts,
+    Partition* part) {
+  auto [src_begin, src_end] = layout.Sources(part->host);
+  tsuba::RDGSlice::SliceArg arg =
+      MakeSliceArg(prefix, src_begin, src_end, true);
+  std::vector<std::string> no_properties;
+  auto slice_res =
+      tsuba::RDGSlice::Make(handle, arg, &no_properties, opts.edge_properties);
+  if (!slice_res) {
+    return slice_res.error().WithContext("reading edges");
+  }
+  const tsuba::RDGSlice& slice = slice_res.value();
+  const Node* dests = slice.topology_file_storage().ptr<Node>(arg.topo_off);
+  uint64_t edge_offset = arg.edge_range.first;
+
+  // Call fn(slice_edge, src_owner, dest, dest_owner) for each edge of src
+  // that goes to part
+  auto for_each_local_edge = [&](uint64_t src, auto fn) {
+    uint32_t src_owner = layout.Owner(src);
+    uint64_t end = EdgeBegin(prefix, src + 1);
+    for (uint64_t e = EdgeBegin(prefix, src); e < end; ++e) {
+      uint64_t dest = dests[e - edge_offset];
+      uint32_t dest_owner = layout.Owner(dest);
+      if (layout.EdgeHost(src_owner, dest_owner) == part->host) {
+        fn(e - edge_offset, src_owner, dest, dest_owner);
+      }
+    }
+  };
+
+  katana::DynamicBitset is_mirror;
+  is_mirror.resize(prefix.num_nodes());
+  katana::do_all(
+      katana::iterate(src_begin, src_end),
+      [&](uint64_t src) {
+        for_each_local_edge(
+            src, [&](uint64_t, uint32_t src_owner, uint64_t dest,
+                     uint32_t dest_owner) {
+              if (src_owner != part->host) {
+                is_mirror.set(src);
+              }
+              if (dest_owner != part->host) {
+                is_mirror.set(dest);
+              }
+            });
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("DistributionFindMirrors"));
+  part->mirrors = is_mirror.GetOffsets<uint64_t>();
+
+  uint64_t num_nodes = part->num_nodes();
+  if (num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "partition {} has {} nodes, too many for 32-bit node IDs", part->host,
+        num_nodes);
+  }
+
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = 0; }, katana::no_stats());
+
+  // Every source with local edges is a master or a mirror, so each writes a
+  // different entry of indices
+  katana::do_all(
+      katana::iterate(src_begin, src_end),
+      [&](uint64_t src) {
+        uint64_t degree = 0;
+        for_each_local_edge(
+            src, [&](uint64_t, uint32_t, uint64_t, uint32_t) { ++degree; });
+        if (degree > 0) {
+          indices[part->LocalId(src)] = degree;
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("DistributionCountEdges"));
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  uint64_t num_edges = num_nodes > 0 ? indices[num_nodes - 1] : 0;
+  auto dests_res = Allocate(num_edges * sizeof(Node), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  auto* local_dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+
+  // With one column, a host gets exactly the edges of its masters, which are
+  // already in order; otherwise, row i of the edge properties of part is row
+  // take[i] of those of the slice
+  part->edge_properties = slice.edge_properties();
+  bool permute = part->edge_properties->num_columns() > 0 &&
+                 layout.num_columns() > 1;
+  std::shared_ptr<arrow::Buffer> take_buffer;
+  uint64_t* take = nullptr;
+  if (permute) {
+    auto take_res = Allocate(num_edges * sizeof(uint64_t), "edge map");
+    if (!take_res) {
+      return take_res.error();
+    }
+    take_buffer = take_res.value();
+    take = reinterpret_cast<uint64_t*>(take_buffer->mutable_data());
+  }
+
+  katana::do_all(
+      katana::iterate(src_begin, src_end),
+      [&](uint64_t src) {
+        if (!part->IsLocal(src)) {
+          return;
+        }
+        Node local_src = part->LocalId(src);
+        uint64_t out = local_src > 0 ? indices[local_src - 1] : 0;
+        if (out == indices[local_src]) {
+          return;
+        }
+        for_each_local_edge(
+            src, [&](uint64_t e, uint32_t, uint64_t dest, uint32_t) {
+              local_dests[out] = part->LocalId(dest);
+              if (take != nullptr) {
+                take[out] = e;
+              }
+              ++out;
+            });
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("DistributionCopyEdges"));
+
+  part->out_indices =
+      std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer);
+  part->out_dests =
+      std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer);
+
+  if (permute) {
+    auto rows_res = TakeRows(
+        part->edge_properties,
+        std::make_shared<arrow::UInt64Array>(num_edges, take_buffer));
+    if (!rows_res) {
+      return rows_res.error().WithContext("edge properties");
+    }
+    part->edge_properties = std::move(rows_res.value());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Scan the whole graph to find which hosts mirror the masters of part and
+/// to read the node properties of the nodes of part
+katana::Result<void>
+ScanGraph(
+    tsuba::RDGHandle handle, const tsuba::RDGPrefix& prefix,
+    const Layout& layout, const katana::PartitionOptions& opts,
+    Partition* part) {
+  part->mirrored.resize(layout.num_hosts());
+  for (uint32_t h = 0; h < layout.num_hosts(); ++h) {
+    if (h != part->host) {
+      part->mirrored[h].resize(part->num_owned());
+    }
+  }
+
+  bool want_properties =
+      opts.node_properties == nullptr || !opts.node_properties->empty();
+  bool want_topology = layout.num_hosts() > 1;
+  std::vector<std::string> no_properties;
+  std::vector<std::shared_ptr<arrow::Table>> master_rows;
+  std::vector<std::shared_ptr<arrow::Table>> mirror_rows;
+
+  uint64_t num_nodes = prefix.num_nodes();
+  uint64_t scan_size = std::max<uint64_t>(opts.scan_size, 1);
+  for (uint64_t begin = 0; begin < num_nodes;) {
+    // The most nodes after begin whose edges fit in scan_size, but at least
+    // one
+    const uint64_t* out_indexes = prefix.out_indexes();
+    uint64_t end = std::upper_bound(
+                       out_indexes + begin,
+                       out_indexes + std::min(num_nodes, begin + scan_size),
+                       EdgeBegin(prefix, begin) + scan_size) -
+                   out_indexes;
+    end = std::max(end, begin + 1);
+
+    uint64_t masters_begin = std::clamp(part->owned_begin, begin, end);
+    uint64_t masters_end = std::clamp(part->owned_end, begin, end);
+    auto mirrors_begin =
+        std::lower_bound(part->mirrors.begin(), part->mirrors.end(), begin);
+    auto mirrors_end =
+        std::lower_bound(part->mirrors.begin(), part->mirrors.end(), end);
+    bool read_properties = want_properties && (masters_begin < masters_end ||
+                                               mirrors_begin < mirrors_end);
+    if (!read_properties && !want_topology) {
+      begin = end;
+      continue;
+    }
+
+    tsuba::RDGSlice::SliceArg arg =
+        MakeSliceArg(prefix, begin, end, want_topology);
+    auto slice_res = tsuba::RDGSlice::Make(
+        handle, arg, read_properties ? opts.node_properties : &no_properties,
+        &no_properties);
+    if (!slice_res) {
+      return slice_res.error().WithContext("scanning nodes from {}", begin);
+    }
+    const tsuba::RDGSlice& slice = slice_res.value();
+
+    if (want_topology) {
+      const Node* dests = slice.topology_file_storage().ptr<Node>(arg.topo_off);
+      uint64_t edge_offset = arg.edge_range.first;
+      katana::do_all(
+          katana::iterate(begin, end),
+          [&](uint64_t src) {
+            uint32_t src_owner = layout.Owner(src);
+            for (uint64_t e = EdgeBegin(prefix, src),
+                          e_end = EdgeBegin(prefix, src + 1);
+                 e < e_end; ++e) {
+              uint64_t dest = dests[e - edge_offset];
+              uint32_t dest_owner = layout.Owner(dest);
+              uint32_t host = layout.EdgeHost(src_owner, dest_owner);
+              if (host == part->host) {
+                continue;
+              }
+              if (src_owner == part->host) {
+                part->mirrored[host].set(src - part->owned_begin);
+              }
+              if (dest_owner == part->host) {
+                part->mirrored[host].set(dest - part->owned_begin);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("DistributionFindMirrored"));
+    }
+
+    const std::shared_ptr<arrow::Table>& props = slice.node_properties();
+    if (read_properties && props->num_columns() > 0) {
+      if (masters_begin < masters_end) {
+        master_rows.emplace_back(
+            props->Slice(masters_begin - begin, masters_end - masters_begin));
+      }
+      if (mirrors_begin < mirrors_end) {
+        std::vector<uint64_t> rows(mirrors_begin, mirrors_end);
+        for (uint64_t& r : rows) {
+          r -= begin;
+        }
+        auto rows_res = TakeRows(props, katana::BuildArray(rows));
+        if (!rows_res) {
+          return rows_res.error().WithContext("node properties");
+        }
+        mirror_rows.emplace_back(std::move(rows_res.value()));
+      }
+    }
+
+    begin = end;
+  }
+
+  if (master_rows.empty() && mirror_rows.empty()) {
+    return katana::ResultSuccess();
+  }
+  master_rows.insert(master_rows.end(), mirror_rows.begin(), mirror_rows.end());
+  auto concat_res = arrow::ConcatenateTables(master_rows);
+  if (!concat_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "concatenating node properties: {}",
+        concat_res.status());
+  }
+  auto combine_res = concat_res.ValueOrDie()->CombineChunks();
+  if (!combine_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "combining node properties: {}",
+        combine_res.status());
+  }
+  part->node_properties = std::move(combine_res.ValueOrDie());
+  return katana::ResultSuccess();
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+MakeIdArray(std::vector<uint32_t>* ids) {
+  return std::make_shared<arrow::ChunkedArray>(katana::BuildArray(*ids));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeLocalToGlobalId(const Partition& part) {
+  uint64_t num_nodes = part.num_nodes();
+  auto l2g_res = Allocate(num_nodes * sizeof(uint64_t), "local_to_global_id");
+  if (!l2g_res) {
+    return l2g_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> l2g_buffer = l2g_res.value();
+  auto* l2g = reinterpret_cast<uint64_t*>(l2g_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        l2g[n] = n < part.num_owned() ? part.owned_begin + n
+                                      : part.mirrors[n - part.num_owned()];
+      },
+      katana::no_stats());
+  return std::make_shared<arrow::ChunkedArray>(
+      std::make_shared<arrow::UInt64Array>(num_nodes, l2g_buffer));
+}
+
+tsuba::PartitionMetadata
+MakeMetadata(
+    const tsuba::RDGPrefix& prefix, const Layout& layout,
+    const katana::PartitionOptions& opts, const Partition& part) {
+  tsuba::PartitionMetadata meta;
+  meta.policy_id_ = static_cast<uint32_t>(opts.policy);
+  meta.is_outgoing_edge_cut_ =
+      opts.policy == katana::PartitionPolicy::kOutgoingEdgeCut;
+  meta.num_global_nodes_ = prefix.num_nodes();
+  meta.max_global_node_id_ =
+      prefix.num_nodes() > 0 ? prefix.num_nodes() - 1 : 0;
+  meta.num_global_edges_ = prefix.num_edges();
+  meta.num_edges_ = part.out_dests->length();
+  meta.num_nodes_ = part.num_nodes();
+  meta.num_owned_ = part.num_owned();
+  if (opts.policy == katana::PartitionPolicy::kCartesianVertexCut) {
+    meta.cartesian_grid_ = {layout.num_rows(), layout.num_columns()};
+  }
+  return meta;
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::Distribution::MakePartition(
+    const std::string& rdg_name, const PartitionOptions& opts) {
+  if (opts.num_hosts == 0 || opts.host_id >= opts.num_hosts) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "host {} is not one of {} hosts",
+        opts.host_id, opts.num_hosts);
+  }
+
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error();
+  }
+  const tsuba::RDGPrefix& prefix = prefix_res.value();
+  if (prefix.version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "partitioning topologies of version {} is not supported",
+        prefix.version());
+  }
+
+  Layout layout(prefix, opts);
+  Partition part;
+  part.host = opts.host_id;
+  std::tie(part.owned_begin, part.owned_end) = layout.Owned(part.host);
+
+  if (auto res = LoadEdges(file, prefix, layout, opts, &part); !res) {
+    return res.error().WithContext("partition {}", part.host);
+  }
+  if (auto res = ScanGraph(file, prefix, layout, opts, &part); !res) {
+    return res.error().WithContext("partition {}", part.host);
+  }
+
+  auto pg = std::make_unique<PropertyGraph>();
+  if (auto res = pg->SetTopology(GraphTopology{
+          .out_indices = part.out_indices,
+          .out_dests = part.out_dests,
+      });
+      !res) {
+    return res.error();
+  }
+  if (part.node_properties) {
+    if (auto res = pg->AddNodeProperties(part.node_properties); !res) {
+      return res.error();
+    }
+  }
+  if (auto res = pg->AddEdgeProperties(part.edge_properties); !res) {
+    return res.error();
+  }
+
+  auto l2g_res = MakeLocalToGlobalId(part);
+  if (!l2g_res) {
+    return l2g_res.error();
+  }
+  pg->set_local_to_global_id(std::move(l2g_res.value()));
+
+  std::vector<uint64_t> owned;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes;
+  for (uint32_t h = 0; h < layout.num_hosts(); ++h) {
+    auto [begin, end] = layout.Owned(h);
+    owned.emplace_back(begin);
+    owned.emplace_back(end);
+
+    std::vector<uint32_t> masters;
+    if (h != part.host) {
+      masters = part.mirrored[h].GetOffsets<uint32_t>();
+    }
+    master_nodes.emplace_back(MakeIdArray(&masters));
+
+    auto [mirrors_begin, mirrors_end] = part.MirrorRange(layout, h);
+    std::vector<uint32_t> mirrors(mirrors_end - mirrors_begin);
+    std::iota(mirrors.begin(), mirrors.end(), part.num_owned() + mirrors_begin);
+    mirror_nodes.emplace_back(MakeIdArray(&mirrors));
+  }
+  pg->set_host_to_owned_global_ids(
+      std::make_shared<arrow::ChunkedArray>(katana::BuildArray(owned)));
+  pg->set_master_nodes(std::move(master_nodes));
+  pg->set_mirror_nodes(std::move(mirror_nodes));
+  pg->set_partition_metadata(MakeMetadata(prefix, layout, opts, part));
+
+  return Result<std::unique_ptr<PropertyGraph>>(std::move(pg));
+}
@@ -23,33 +23,98 @@
 
 #include "katana/DynamicBitset.h"
 
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/util/bitmap_ops.h>
+
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+static_assert(
+    sizeof(katana::CopyableAtomic<uint64_t>) == sizeof(uint64_t),
+    "bulk operations access the words of a bitset as plain integers");
+
+/// Words per work item of the bulk operations
+constexpr size_t kBlockWords = 1024;
+
+const uint64_t*
+Words(const katana::DynamicBitset& bitset) {
+  return reinterpret_cast<const uint64_t*>(bitset.get_vec().data());
+}
+
+uint64_t*
+Words(katana::DynamicBitset* bitset) {
+  return reinterpret_cast<uint64_t*>(bitset->get_vec().data());
+}
+
+/// Call fn(begin, end) in parallel for blocks of kBlockWords words. The
+/// words are plain integers in fn, so that its loop over [begin, end) can be
+/// vectorized.
+template <typename F>
+void
+ForEachBlock(size_t num_words, const F& fn) {
+  katana::do_all(
+      katana::iterate(size_t{0}, (num_words + kBlockWords - 1) / kBlockWords),
+      [&](size_t block) {
+        size_t begin = block * kBlockWords;
+        fn(begin, std::min(begin + kBlockWords, num_words));
+      },
+      katana::no_stats());
+}
+
+}  // namespace
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] |= other_words[i];
+    }
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  uint64_t* words = Words(this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] = ~words[i];
+    }
+  });
+  size_t tail = num_bits_ % kNumBitsInUint64;
+  if (tail != 0) {
+    words[bitvec_.size() - 1] &= (uint64_t{1} << tail) - 1;
+  }
+}
+
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] &= ~other_words[i];
+    }
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] &= other_words[i];
+    }
+  });
 }
 
 void
@@ -57,22 +122,26 @@ katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words1 = Words(other1);
+  const uint64_t* other_words2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] = other_words1[i] & other_words2[i];
+    }
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] ^= other_words[i];
+    }
+  });
 }
 
 void
@@ -80,34 +149,59 @@ katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+  uint64_t* words = Words(this);
+  const uint64_t* other_words1 = Words(other1);
+  const uint64_t* other_words2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      words[i] = other_words1[i] ^ other_words2[i];
+    }
+  });
 }
 
 size_t
 katana::DynamicBitset::count() const {
+  if (bitvec_.size() == 0) {
+    return 0;
+  }
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
-  return ret.reduce();
+  const uint64_t* words = Words(*this);
+  // The last word is counted separately since it may have bits past the
+  // size of the bitset set
+  size_t num_full_words = bitvec_.size() - 1;
+  ForEachBlock(num_full_words, [&](size_t begin, size_t end) {
+    size_t block_count = 0;
+    for (size_t i = begin; i < end; ++i) {
+      block_count += __builtin_popcountll(words[i]);
+    }
+    ret += block_count;
+  });
+  return ret.reduce() + __builtin_popcountll(GetWord(num_full_words));
 }
 
+std::shared_ptr<arrow::BooleanArray>
+katana::DynamicBitset::AsArrowView() const {
+  auto buffer = std::make_shared<arrow::Buffer>(
+      reinterpret_cast<const uint8_t*>(bitvec_.data()),
+      bitvec_.size() * sizeof(uint64_t));
+  return std::make_shared<arrow::BooleanArray>(num_bits_, buffer);
+}
+
+void
+katana::DynamicBitset::CopyFromArrow(const arrow::BooleanArray& array) {
+  resize(array.length());
+  if (array.length() == 0) {
+    return;
+  }
+  auto* bytes = reinterpret_cast<uint8_t*>(Words(this));
+  arrow::internal::CopyBitmap(
+      array.values()->data(), array.offset(), array.length(), bytes, 0);
+  if (array.null_count() > 0) {
+    arrow::internal::BitmapAnd(
+        bytes, 0, array.null_bitmap_data(), array.offset(), array.length(), 0,
+        bytes);
+  }
+}
 namespace {
 template <typename Integer>
 void
@@ -116,17 +210,16 @@ ComputeOffsets(
   // TODO uint32_t is somewhat dangerous; change in the future
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
+  size_t num_words = bitset.get_vec().size();
 
-  // count how many bits are set on each thread
+  // count how many bits are set on each thread, a word at a time
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
 
     Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    for (size_t w = start; w < end; ++w) {
+      count += __builtin_popcountll(bitset.GetWord(w));
     }
 
     tPrefixBitCounts[tid] = count;
@@ -141,22 +234,25 @@ ComputeOffsets(
   Integer bitsetCount = tPrefixBitCounts[activeThreads - 1];
 
   // calculate the indices of the set bits and save them to the offset
-  // vector
+  // vector, skipping words with no bits set
   if (bitsetCount > 0) {
     size_t cur_size = offsets->size();
     offsets->resize(cur_size + bitsetCount);
+    Integer* out = offsets->data();
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
       Integer index = cur_size;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
+      for (size_t w = start; w < end; ++w) {
+        uint64_t word = bitset.GetWord(w);
+        while (word != 0) {
+          size_t bit = __builtin_ctzll(word);
+          word &= word - 1;
+          out[index++] = w * katana::DynamicBitset::kNumBitsInUint64 + bit;
         }
       }
     });
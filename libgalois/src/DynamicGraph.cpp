@@ -0,0 +1,241 @@
+#include "katana/DynamicGraph.h"
+
+#include <atomic>
+#include <iterator>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::DynamicGraph::Node;
+using Batch = std::vector<std::pair<Node, Node>>;
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Call fn(begin, end) in parallel for each run [begin, end) of the edges
+/// of a sorted batch with the same source
+template <typename F>
+void
+ForEachRun(const Batch& batch, F fn) {
+  katana::do_all(
+      katana::iterate(size_t{0}, batch.size()),
+      [&](size_t i) {
+        Node src = batch[i].first;
+        if (i > 0 && batch[i - 1].first == src) {
+          return;
+        }
+        auto end = std::partition_point(
+            batch.begin() + i, batch.end(),
+            [src](const std::pair<Node, Node>& e) { return e.first == src; });
+        fn(batch.begin() + i, end);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// Release the spare capacity of dests once it is mostly unused
+void
+MaybeShrink(std::vector<Node>* dests) {
+  if (dests->capacity() > 4 * dests->size() + 16) {
+    dests->shrink_to_fit();
+  }
+}
+
+}  // namespace
+
+katana::DynamicGraph
+katana::DynamicGraph::FromTopology(const GraphTopology& topology) {
+  DynamicGraph graph(topology.num_nodes());
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        std::vector<Node>& dests = graph.adjacency_[n];
+        auto [begin, end] = topology.edge_range(n);
+        const Node* out_dests = topology.out_dests->raw_values();
+        dests.assign(out_dests + begin, out_dests + end);
+        std::sort(dests.begin(), dests.end());
+        dests.erase(std::unique(dests.begin(), dests.end()), dests.end());
+        MaybeShrink(&dests);
+        num_edges += dests.size();
+      },
+      katana::steal(), katana::no_stats());
+  graph.num_edges_ = num_edges.reduce();
+  return graph;
+}
+
+katana::Result<Batch>
+katana::DynamicGraph::SortBatch(const Batch& batch) const {
+  uint64_t num_nodes = adjacency_.size();
+  std::atomic<bool> out_of_range(false);
+  katana::do_all(
+      katana::iterate(size_t{0}, batch.size()),
+      [&](size_t i) {
+        if (batch[i].first >= num_nodes || batch[i].second >= num_nodes) {
+          out_of_range = true;
+        }
+      },
+      katana::no_stats());
+  if (out_of_range) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge refers to a node not in [0, {})",
+        num_nodes);
+  }
+
+  Batch sorted(batch);
+  katana::ParallelSTL::radix_sort(
+      sorted.begin(), sorted.end(), [](const std::pair<Node, Node>& e) {
+        return (uint64_t{e.first} << 32) | e.second;
+      });
+  return Result<Batch>(std::move(sorted));
+}
+
+katana::Result<uint64_t>
+katana::DynamicGraph::InsertEdges(const Batch& batch) {
+  auto sort_res = SortBatch(batch);
+  if (!sort_res) {
+    return sort_res.error();
+  }
+  const Batch& sorted = sort_res.value();
+
+  katana::GAccumulator<uint64_t> num_inserted;
+  ForEachRun(sorted, [&](auto begin, auto end) {
+    std::vector<Node>& dests = adjacency_[begin->first];
+
+    // Count the new destinations, skipping duplicates in the batch, then
+    // merge them in from the back so that existing ones move at most once
+    size_t num_new = 0;
+    auto it = dests.begin();
+    for (auto e = begin; e != end; ++e) {
+      if (e != begin && std::prev(e)->second == e->second) {
+        continue;
+      }
+      it = std::lower_bound(it, dests.end(), e->second);
+      if (it == dests.end() || *it != e->second) {
+        ++num_new;
+      }
+    }
+    if (num_new == 0) {
+      return;
+    }
+
+    size_t old_size = dests.size();
+    dests.resize(old_size + num_new);
+    auto out = dests.rbegin();
+    auto old = dests.rend() - old_size;
+    for (auto e = std::make_reverse_iterator(end),
+              e_end = std::make_reverse_iterator(begin);
+         e != e_end; ++e) {
+      if (std::next(e) != e_end && std::next(e)->second == e->second) {
+        continue;
+      }
+      // Move the old destinations greater than e
+      while (old != dests.rend() && *old > e->second) {
+        *out++ = *old++;
+      }
+      if (old != dests.rend() && *old == e->second) {
+        continue;
+      }
+      *out++ = e->second;
+    }
+    num_inserted += num_new;
+  });
+
+  uint64_t inserted = num_inserted.reduce();
+  num_edges_ += inserted;
+  return inserted;
+}
+
+katana::Result<uint64_t>
+katana::DynamicGraph::DeleteEdges(const Batch& batch) {
+  auto sort_res = SortBatch(batch);
+  if (!sort_res) {
+    return sort_res.error();
+  }
+  const Batch& sorted = sort_res.value();
+
+  katana::GAccumulator<uint64_t> num_deleted;
+  ForEachRun(sorted, [&](auto begin, auto end) {
+    std::vector<Node>& dests = adjacency_[begin->first];
+
+    // Keep the destinations that are not in the batch, in place
+    auto e = begin;
+    auto out = dests.begin();
+    for (auto it = dests.begin(); it != dests.end(); ++it) {
+      while (e != end && e->second < *it) {
+        ++e;
+      }
+      if (e == end || e->second != *it) {
+        *out++ = *it;
+      }
+    }
+    num_deleted += dests.end() - out;
+    dests.erase(out, dests.end());
+    MaybeShrink(&dests);
+  });
+
+  uint64_t deleted = num_deleted.reduce();
+  num_edges_ -= deleted;
+  return deleted;
+}
+
+katana::Result<katana::GraphTopology>
+katana::DynamicGraph::ToTopology() const {
+  uint64_t num_nodes = adjacency_.size();
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = Allocate(num_edges_ * sizeof(Node), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  auto* dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = adjacency_[n].size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? indices[n - 1] : 0;
+        std::copy(adjacency_[n].begin(), adjacency_[n].end(), dests + begin);
+      },
+      katana::steal(), katana::no_stats());
+
+  return GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .out_dests =
+          std::make_shared<arrow::UInt32Array>(num_edges_, dests_buffer),
+  };
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::DynamicGraph::ToPropertyGraph() const {
+  auto topology_res = ToTopology();
+  if (!topology_res) {
+    return topology_res.error();
+  }
+  auto pg = std::make_unique<PropertyGraph>();
+  if (auto res = pg->SetTopology(topology_res.value()); !res) {
+    return res.error();
+  }
+  return Result<std::unique_ptr<PropertyGraph>>(std::move(pg));
+}
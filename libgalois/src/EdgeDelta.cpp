@@ -0,0 +1,268 @@
+#include "katana/EdgeDelta.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <arrow/compute/api.h>
+
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Return the rows of every edge property of pg selected by indices
+katana::Result<std::vector<std::shared_ptr<arrow::ChunkedArray>>>
+TakeEdgeProperties(
+    katana::PropertyGraph* pg, const std::shared_ptr<arrow::Array>& indices) {
+  katana::PropertyGraph::PropertyView view = pg->edge_property_view();
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    std::shared_ptr<arrow::ChunkedArray> property = view.Property(i);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading property {}",
+          schema->field(i)->name());
+    }
+    auto res = arrow::compute::Take(property, indices);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "extending property {}: {}",
+          schema->field(i)->name(), res.status());
+    }
+    columns.emplace_back(res.ValueOrDie().chunked_array());
+  }
+  return columns;
+}
+
+}  // namespace
+
+katana::Result<katana::EdgeDelta>
+katana::EdgeDeltaBuilder::Finish(const EdgeDelta& previous) {
+  unsigned num_batches = batches_.size();
+  auto clear_batches = [&]() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{num_batches}),
+        [&](uint64_t i) { batches_.getRemote(i)->clear(); },
+        katana::no_stats());
+  };
+
+  if (!previous.empty() && previous.num_nodes() != num_nodes_) {
+    clear_batches();
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "previous delta has {} nodes but the graph has {}",
+        previous.num_nodes(), num_nodes_);
+  }
+
+  // Count the edges of each node, starting with those of previous
+  LargeArray<std::atomic<uint64_t>> counts;
+  counts.allocateBlocked(num_nodes_);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes_),
+      [&](uint64_t n) { counts.constructAt(n, previous.degree(n)); },
+      katana::no_stats());
+
+  std::atomic<bool> out_of_range(false);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{num_batches}),
+      [&](uint64_t i) {
+        for (const auto& [src, dest] : *batches_.getRemote(i)) {
+          if (src >= num_nodes_ || dest >= num_nodes_) {
+            out_of_range = true;
+            continue;
+          }
+          counts[src].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (out_of_range) {
+    clear_batches();
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge refers to a node not in [0, {})",
+        num_nodes_);
+  }
+
+  EdgeDelta delta;
+  delta.indices_.allocateBlocked(num_nodes_);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes_),
+      [&](uint64_t n) { delta.indices_[n] = counts[n]; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      delta.indices_.begin(), delta.indices_.end(), delta.indices_.begin());
+
+  uint64_t num_edges = num_nodes_ > 0 ? delta.indices_[num_nodes_ - 1] : 0;
+  delta.dests_.allocateInterleaved(num_edges);
+
+  // Copy the edges of previous and reuse counts as the number of edges of
+  // each node placed so far
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes_),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? delta.indices_[n - 1] : 0;
+        auto dests = previous.OutDests(n);
+        std::copy(dests.begin(), dests.end(), delta.dests_.data() + begin);
+        counts[n] = dests.size();
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{num_batches}),
+      [&](uint64_t i) {
+        for (const auto& [src, dest] : *batches_.getRemote(i)) {
+          uint64_t begin = src > 0 ? delta.indices_[src - 1] : 0;
+          delta.dests_[begin + counts[src].fetch_add(
+                                   1, std::memory_order_relaxed)] = dest;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  clear_batches();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes_),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? delta.indices_[n - 1] : 0;
+        std::sort(
+            delta.dests_.data() + begin,
+            delta.dests_.data() + delta.indices_[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return Result<EdgeDelta>(std::move(delta));
+}
+
+katana::Result<void>
+katana::ApplyEdgeDelta(PropertyGraph* pg, const EdgeDelta& delta) {
+  if (delta.empty()) {
+    return ResultSuccess();
+  }
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  if (delta.num_nodes() != num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "delta has {} nodes but the graph has {}",
+        delta.num_nodes(), num_nodes);
+  }
+  uint64_t num_edges = topology.num_edges() + delta.num_edges();
+
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = Allocate(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  auto* dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+
+  const uint64_t* old_indices = topology.out_indices->raw_values();
+  const Node* old_dests = topology.out_dests->raw_values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = old_indices[n] + delta.indices_[n]; },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? indices[n - 1] : 0;
+        auto [old_begin, old_end] = topology.edge_range(n);
+        Node* out = std::copy(
+            old_dests + old_begin, old_dests + old_end, dests + begin);
+        auto added = delta.OutDests(n);
+        std::copy(added.begin(), added.end(), out);
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::shared_ptr<arrow::Schema> schema = pg->edge_schema();
+  if (schema->num_fields() > 0) {
+    // Row e of the new edge properties is row take[e] of the old ones, or
+    // null for added edges. Each task fills one 64-bit word of the validity
+    // bitmap, so tasks do not share bytes.
+    uint64_t num_words = (num_edges + 63) / 64;
+    auto take_res = Allocate(num_edges * sizeof(uint64_t), "edge map");
+    if (!take_res) {
+      return take_res.error();
+    }
+    auto valid_res = Allocate(num_words * sizeof(uint64_t), "edge map");
+    if (!valid_res) {
+      return valid_res.error();
+    }
+    std::shared_ptr<arrow::Buffer> take_buffer = take_res.value();
+    std::shared_ptr<arrow::Buffer> valid_buffer = valid_res.value();
+    auto* take = reinterpret_cast<uint64_t*>(take_buffer->mutable_data());
+    auto* valid = reinterpret_cast<uint64_t*>(valid_buffer->mutable_data());
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_words),
+        [&](uint64_t w) {
+          uint64_t e = w * 64;
+          uint64_t end = std::min(e + 64, num_edges);
+          uint64_t n = std::upper_bound(indices, indices + num_nodes, e) -
+                       indices;
+          uint64_t word = 0;
+          for (; e < end; ++e) {
+            while (indices[n] <= e) {
+              ++n;
+            }
+            uint64_t offset = e - (n > 0 ? indices[n - 1] : 0);
+            auto [old_begin, old_end] = topology.edge_range(n);
+            if (offset < old_end - old_begin) {
+              take[e] = old_begin + offset;
+              word |= uint64_t{1} << (e % 64);
+            } else {
+              take[e] = 0;
+            }
+          }
+          valid[w] = word;
+        },
+        katana::no_stats());
+
+    auto take_array = std::make_shared<arrow::UInt64Array>(
+        num_edges, take_buffer, valid_buffer, delta.num_edges());
+    auto columns_res = TakeEdgeProperties(pg, take_array);
+    if (!columns_res) {
+      return columns_res.error();
+    }
+    columns = std::move(columns_res.value());
+  }
+
+  if (auto res = pg->SetTopology(GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (columns.empty()) {
+    return ResultSuccess();
+  }
+  for (int i = schema->num_fields() - 1; i >= 0; --i) {
+    if (auto res = pg->RemoveEdgeProperty(i); !res) {
+      return res.error();
+    }
+  }
+  return pg->AddEdgeProperties(arrow::Table::Make(schema, columns));
+}
@@ -0,0 +1,132 @@
+#include "katana/EdgeStream.h"
+
+#include <algorithm>
+#include <future>
+
+#include "katana/ErrorCode.h"
+#include "katana/Statistics.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+using Node = katana::EdgeStream::Node;
+
+std::future<katana::Result<void>>
+ReadyFuture() {
+  std::promise<katana::Result<void>> promise;
+  promise.set_value(katana::ResultSuccess());
+  return promise.get_future();
+}
+
+}  // namespace
+
+katana::EdgeStream::EdgeStream(
+    tsuba::RDGPrefix&& prefix, std::vector<Node>&& block_starts)
+    : prefix_(std::move(prefix)), block_starts_(std::move(block_starts)) {
+  const uint64_t* out_indexes = prefix_.out_indexes();
+  uint64_t max_block_edges = 0;
+  for (uint64_t b = 0; b < num_blocks(); ++b) {
+    Node begin = block_starts_[b];
+    Node end = block_starts_[b + 1];
+    max_block_edges = std::max(
+        max_block_edges,
+        out_indexes[end - 1] - (begin > 0 ? out_indexes[begin - 1] : 0));
+  }
+  for (auto& buffer : buffers_) {
+    buffer.allocateBlocked(max_block_edges);
+  }
+}
+
+katana::Result<katana::EdgeStream>
+katana::EdgeStream::Make(const std::string& rdg_name, uint64_t block_size) {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error();
+  }
+  tsuba::RDGPrefix prefix = std::move(prefix_res.value());
+  if (prefix.topology_path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix.version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "streaming topologies of version {} is not supported",
+        prefix.version());
+  }
+
+  // Greedily add nodes to each block while their edges fit
+  uint64_t block_edges = std::max<uint64_t>(block_size / sizeof(Node), 1);
+  const uint64_t* out_indexes = prefix.out_indexes();
+  uint64_t num_nodes = prefix.num_nodes();
+  std::vector<Node> block_starts{0};
+  for (uint64_t begin = 0; begin < num_nodes;) {
+    uint64_t edge_begin = begin > 0 ? out_indexes[begin - 1] : 0;
+    uint64_t end = std::upper_bound(
+                       out_indexes + begin, out_indexes + num_nodes,
+                       edge_begin + block_edges) -
+                   out_indexes;
+    end = std::max(end, begin + 1);
+    block_starts.emplace_back(end);
+    begin = end;
+  }
+
+  return EdgeStream(std::move(prefix), std::move(block_starts));
+}
+
+katana::Result<void>
+katana::EdgeStream::ForEachBlock(
+    const std::function<void(const EdgeBlock&)>& fn,
+    const std::function<bool(Node, Node)>& wanted) {
+  std::vector<uint64_t> blocks;
+  for (uint64_t b = 0; b < num_blocks(); ++b) {
+    if (!wanted || wanted(block_starts_[b], block_starts_[b + 1])) {
+      blocks.emplace_back(b);
+    }
+  }
+  if (blocks.empty()) {
+    return ResultSuccess();
+  }
+
+  const uint64_t* out_indexes = prefix_.out_indexes();
+  uint64_t bytes_read = 0;
+  auto start_read = [&](uint64_t b, Node* buffer) {
+    Node begin = block_starts_[b];
+    uint64_t edge_begin = begin > 0 ? out_indexes[begin - 1] : 0;
+    uint64_t size =
+        (out_indexes[block_starts_[b + 1] - 1] - edge_begin) * sizeof(Node);
+    if (size == 0) {
+      return ReadyFuture();
+    }
+    bytes_read += size;
+    return tsuba::FileGetAsync(
+        prefix_.topology_path(), reinterpret_cast<uint8_t*>(buffer),
+        prefix_.view_offset() + edge_begin * sizeof(Node), size);
+  };
+
+  std::future<Result<void>> pending = start_read(blocks[0], buffers_[0].data());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (auto res = pending.get(); !res) {
+      return res.error().WithContext(
+          "reading edges of block {} of {}", blocks[i],
+          prefix_.topology_path());
+    }
+    if (i + 1 < blocks.size()) {
+      pending = start_read(blocks[i + 1], buffers_[(i + 1) % 2].data());
+    }
+    uint64_t b = blocks[i];
+    fn(EdgeBlock(
+        out_indexes, buffers_[i % 2].data(), block_starts_[b],
+        block_starts_[b + 1]));
+  }
+
+  katana::ReportStatSum("EdgeStream", "BytesRead", bytes_read);
+  return ResultSuccess();
+}
@@ -31,6 +31,7 @@
 
 #include "katana/Logging.h"
 #include "katana/PageAlloc.h"
+#include "katana/Threads.h"
 #include "katana/gIO.h"
 #include "tsuba/file.h"
 
@@ -455,7 +456,7 @@ FileGraph::partFromFile(
 
   // do interleaved numa allocation with current number of threads
   if (numaMap) {
-    unsigned int numThreads = katana::activeThreads;
+    unsigned int numThreads = katana::getActiveThreads();
     const size_t hugePageSize = 2 * 1024 * 1024;  // 2MB
 
     void* ptr;
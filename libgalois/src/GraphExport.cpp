@@ -0,0 +1,358 @@
+#include "katana/GraphExport.h"
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <arrow/api.h>
+#include <fmt/format.h>
+
+#include "katana/Loops.h"
+#include "katana/Uri.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/WriteGroup.h"
+
+namespace {
+
+/// Encoded CSV is handed to the file frame in pieces of about this size
+constexpr size_t kCsvFlushSize = size_t{1} << 20;
+/// A guess at the length of a CSV value, which only serves to bound how
+/// many shards are outstanding at once
+constexpr uint64_t kCsvValueSize = 24;
+
+const char*
+Extension(katana::ExportOptions::Format format) {
+  return format == katana::ExportOptions::kCsv ? "csv" : "parquet";
+}
+
+/// Append s, quoted if it holds the delimiter, a quote or a line break
+void
+AppendCsvString(fmt::memory_buffer* out, std::string_view s, char delimiter) {
+  const char special[] = {delimiter, '"', '\n', '\r'};
+  if (s.find_first_of(special, 0, sizeof(special)) == std::string_view::npos) {
+    out->append(s.data(), s.data() + s.size());
+    return;
+  }
+  out->push_back('"');
+  for (char c : s) {
+    if (c == '"') {
+      out->push_back('"');
+    }
+    out->push_back(c);
+  }
+  out->push_back('"');
+}
+
+template <typename ArrayType>
+void
+AppendCsvNumber(fmt::memory_buffer* out, const arrow::Array& array, int64_t i) {
+  fmt::format_to(*out, "{}", static_cast<const ArrayType&>(array).Value(i));
+}
+
+/// Append value i of array; nulls are empty
+void
+AppendCsvValue(
+    fmt::memory_buffer* out, const arrow::Array& array, int64_t i,
+    char delimiter) {
+  if (array.IsNull(i)) {
+    return;
+  }
+  switch (array.type_id()) {
+  case arrow::Type::BOOL:
+    fmt::format_to(
+        *out, "{}", static_cast<const arrow::BooleanArray&>(array).Value(i));
+    return;
+  case arrow::Type::INT8:
+    // Printed as numbers rather than as characters
+    fmt::format_to(
+        *out, "{}",
+        int{static_cast<const arrow::Int8Array&>(array).Value(i)});
+    return;
+  case arrow::Type::UINT8:
+    fmt::format_to(
+        *out, "{}",
+        unsigned{static_cast<const arrow::UInt8Array&>(array).Value(i)});
+    return;
+  case arrow::Type::INT16:
+    return AppendCsvNumber<arrow::Int16Array>(out, array, i);
+  case arrow::Type::UINT16:
+    return AppendCsvNumber<arrow::UInt16Array>(out, array, i);
+  case arrow::Type::INT32:
+    return AppendCsvNumber<arrow::Int32Array>(out, array, i);
+  case arrow::Type::UINT32:
+    return AppendCsvNumber<arrow::UInt32Array>(out, array, i);
+  case arrow::Type::INT64:
+    return AppendCsvNumber<arrow::Int64Array>(out, array, i);
+  case arrow::Type::UINT64:
+    return AppendCsvNumber<arrow::UInt64Array>(out, array, i);
+  case arrow::Type::FLOAT:
+    return AppendCsvNumber<arrow::FloatArray>(out, array, i);
+  case arrow::Type::DOUBLE:
+    return AppendCsvNumber<arrow::DoubleArray>(out, array, i);
+  case arrow::Type::STRING: {
+    auto view = static_cast<const arrow::StringArray&>(array).GetView(i);
+    return AppendCsvString(out, {view.data(), view.size()}, delimiter);
+  }
+  case arrow::Type::LARGE_STRING: {
+    auto view = static_cast<const arrow::LargeStringArray&>(array).GetView(i);
+    return AppendCsvString(out, {view.data(), view.size()}, delimiter);
+  }
+  default:
+    break;
+  }
+  // Other types, e.g., timestamps and lists, as arrow prints them
+  auto scalar_res = array.GetScalar(i);
+  if (scalar_res.ok()) {
+    AppendCsvString(out, scalar_res.ValueOrDie()->ToString(), delimiter);
+  }
+}
+
+katana::Result<void>
+Flush(fmt::memory_buffer* out, tsuba::FileFrame* ff) {
+  if (auto status = ff->Write(out->data(), out->size()); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "writing csv: {}", status);
+  }
+  out->clear();
+  return katana::ResultSuccess();
+}
+
+/// Encode table as CSV in memory
+katana::Result<std::shared_ptr<tsuba::FileFrame>>
+EncodeCsv(
+    const std::shared_ptr<arrow::Table>& table,
+    const katana::ExportOptions& opts) {
+  // One chunk per column, so that rows are read by index
+  auto combined_res = table->CombineChunks();
+  if (!combined_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "combining chunks: {}",
+        combined_res.status());
+  }
+  std::shared_ptr<arrow::Table> combined = combined_res.ValueOrDie();
+  int num_columns = combined->num_columns();
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (const auto& column : combined->columns()) {
+    if (column->num_chunks() > 0) {
+      columns.emplace_back(column->chunk(0));
+    }
+  }
+
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error().WithContext("creating output buffer");
+  }
+  fmt::memory_buffer out;
+  if (opts.csv_header) {
+    for (int c = 0; c < num_columns; ++c) {
+      if (c > 0) {
+        out.push_back(opts.csv_delimiter);
+      }
+      AppendCsvString(&out, combined->field(c)->name(), opts.csv_delimiter);
+    }
+    out.push_back('\n');
+  }
+  for (int64_t i = 0, n = combined->num_rows(); i < n; ++i) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+      if (c > 0) {
+        out.push_back(opts.csv_delimiter);
+      }
+      AppendCsvValue(&out, *columns[c], i, opts.csv_delimiter);
+    }
+    out.push_back('\n');
+    if (out.size() >= kCsvFlushSize) {
+      if (auto res = Flush(&out, ff.get()); !res) {
+        return res.error();
+      }
+    }
+  }
+  if (auto res = Flush(&out, ff.get()); !res) {
+    return res.error();
+  }
+  return ff;
+}
+
+/// Start storing table as files named prefix-00000.ext, ... in dir, each
+/// with opts.rows_per_shard rows, and return their names
+katana::Result<std::vector<std::string>>
+StartShards(
+    const std::shared_ptr<arrow::Table>& table, const katana::Uri& dir,
+    const std::string& prefix, const katana::ExportOptions& opts,
+    tsuba::WriteGroup* group) {
+  std::vector<std::string> files;
+  int64_t num_rows = table->num_rows();
+  auto rows_per_shard = static_cast<int64_t>(opts.rows_per_shard);
+  // An empty table still gets a file, so that readers find its schema
+  int64_t offset = 0;
+  do {
+    std::shared_ptr<arrow::Table> shard = table->Slice(offset, rows_per_shard);
+    katana::Uri uri = dir.Join(fmt::format(
+        "{}-{:05}.{}", prefix, files.size(), Extension(opts.format)));
+    if (opts.format == katana::ExportOptions::kParquet) {
+      auto writer_res = tsuba::ParquetWriter::Make(shard, opts.parquet);
+      if (!writer_res) {
+        return writer_res.error().WithContext("preparing {}", uri);
+      }
+      if (auto res = writer_res.value()->WriteToUri(uri, group); !res) {
+        return res.error().WithContext("storing {}", uri);
+      }
+    } else {
+      uint64_t estimated_size =
+          shard->num_rows() * shard->num_columns() * kCsvValueSize;
+      group->StartStore(
+          uri.string(),
+          [shard, opts, path = uri.string()]()
+              -> katana::Result<std::shared_ptr<tsuba::FileFrame>> {
+            auto ff_res = EncodeCsv(shard, opts);
+            if (!ff_res) {
+              return ff_res.error().WithContext("encoding {}", path);
+            }
+            ff_res.value()->Bind(path);
+            return ff_res;
+          },
+          estimated_size);
+    }
+    files.emplace_back(uri.string());
+    offset += rows_per_shard;
+  } while (offset < num_rows);
+  return files;
+}
+
+std::shared_ptr<arrow::UInt32Array>
+MakeNodeIds(uint64_t num_nodes, std::shared_ptr<arrow::Buffer> buffer) {
+  auto* ids = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { ids[n] = n; }, katana::no_stats());
+  return std::make_shared<arrow::UInt32Array>(num_nodes, std::move(buffer));
+}
+
+/// The source of every edge, from the CSR indices of topology
+std::shared_ptr<arrow::UInt32Array>
+MakeEdgeSources(
+    const katana::GraphTopology& topology,
+    std::shared_ptr<arrow::Buffer> buffer) {
+  auto* sources = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        std::fill(sources + begin, sources + end, n);
+      },
+      katana::steal(), katana::no_stats());
+  return std::make_shared<arrow::UInt32Array>(
+      topology.num_edges(), std::move(buffer));
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateIds(uint64_t count) {
+  auto buffer_res = arrow::AllocateBuffer(count * sizeof(uint32_t));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating ids: {}",
+        buffer_res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer_res.ValueOrDie()));
+}
+
+}  // namespace
+
+katana::Result<katana::ExportManifest>
+katana::ExportGraph(
+    const PropertyGraph& pg, const std::string& dir,
+    const ExportOptions& opts) {
+  if (opts.rows_per_shard == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "rows per shard must be positive");
+  }
+  auto dir_res = Uri::Make(dir);
+  if (!dir_res) {
+    return dir_res.error();
+  }
+  const Uri& dir_uri = dir_res.value();
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  std::vector<std::shared_ptr<arrow::Field>> node_fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+  if (opts.nodes) {
+    auto buffer_res = AllocateIds(num_nodes);
+    if (!buffer_res) {
+      return buffer_res.error();
+    }
+    node_fields.emplace_back(arrow::field("id", arrow::uint32()));
+    node_columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        MakeNodeIds(num_nodes, std::move(buffer_res.value()))));
+
+    const auto& user_ids = pg.local_to_user_id();
+    if (user_ids && static_cast<uint64_t>(user_ids->length()) == num_nodes) {
+      node_fields.emplace_back(arrow::field("user_id", user_ids->type()));
+      node_columns.emplace_back(user_ids);
+    }
+    if (opts.properties) {
+      auto schema = pg.node_schema();
+      for (int i = 0, n = schema->num_fields(); i < n; ++i) {
+        node_fields.emplace_back(schema->field(i));
+        node_columns.emplace_back(pg.GetNodeProperty(i));
+      }
+    }
+  }
+
+  auto sources_res = AllocateIds(topology.num_edges());
+  if (!sources_res) {
+    return sources_res.error();
+  }
+  std::vector<std::shared_ptr<arrow::Field>> edge_fields{
+      arrow::field("src", arrow::uint32()),
+      arrow::field("dst", arrow::uint32())};
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns{
+      std::make_shared<arrow::ChunkedArray>(
+          MakeEdgeSources(topology, std::move(sources_res.value()))),
+      std::make_shared<arrow::ChunkedArray>(topology.out_dests)};
+  if (opts.properties) {
+    auto schema = pg.edge_schema();
+    for (int i = 0, n = schema->num_fields(); i < n; ++i) {
+      edge_fields.emplace_back(schema->field(i));
+      edge_columns.emplace_back(pg.GetEdgeProperty(i));
+    }
+  }
+
+  auto group_res = tsuba::WriteGroup::Make();
+  if (!group_res) {
+    return group_res.error();
+  }
+  std::unique_ptr<tsuba::WriteGroup> group = std::move(group_res.value());
+
+  // The shards of both tables are in flight together; group holds on to
+  // the tables until they are stored
+  ExportManifest manifest;
+  auto start = [&]() -> Result<void> {
+    if (opts.nodes) {
+      auto files_res = StartShards(
+          arrow::Table::Make(arrow::schema(node_fields), node_columns),
+          dir_uri, "nodes", opts, group.get());
+      if (!files_res) {
+        return files_res.error();
+      }
+      manifest.node_files = std::move(files_res.value());
+    }
+    auto files_res = StartShards(
+        arrow::Table::Make(arrow::schema(edge_fields), edge_columns), dir_uri,
+        "edges", opts, group.get());
+    if (!files_res) {
+      return files_res.error();
+    }
+    manifest.edge_files = std::move(files_res.value());
+    return ResultSuccess();
+  }();
+
+  // Wait for the stores that started even if a later one could not
+  if (auto res = group->Finish(); !res) {
+    return res.error().WithContext("exporting to {}", dir);
+  }
+  if (!start) {
+    return start.error().WithContext("exporting to {}", dir);
+  }
+  return manifest;
+}
@@ -0,0 +1,339 @@
+#include "katana/GraphGenerators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+/// The finalizer of splitmix64
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// A splitmix64 stream for one generated pair, so that the pair does not
+/// depend on which thread draws it or on what was drawn before it
+class PairRandom {
+public:
+  PairRandom(uint64_t seed, uint64_t pair)
+      : state_(Mix(seed ^ Mix(pair + 0x9e3779b97f4a7c15ULL))) {}
+
+  uint64_t Next() {
+    state_ += 0x9e3779b97f4a7c15ULL;
+    return Mix(state_);
+  }
+
+  /// A double in [0, 1)
+  double NextDouble() { return (Next() >> 11) * 0x1.0p-53; }
+
+  /// A number in [0, n)
+  uint64_t Below(uint64_t n) {
+    return static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(Next()) * n) >> 64);
+  }
+
+private:
+  uint64_t state_;
+};
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Build a graph with num_nodes nodes from num_pairs pairs of (source,
+/// destination), where draw(i) returns pair i. Pairs are drawn once to
+/// count the edges of each source and once more to place them.
+template <typename DrawFn>
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+BuildGenerated(
+    uint64_t num_nodes, uint64_t num_pairs,
+    const katana::GeneratorOptions& options, const DrawFn& draw) {
+  // Call fn(src, dest) for each edge made from pair i
+  auto emit = [&](uint64_t i, auto&& fn) {
+    auto [src, dest] = draw(i);
+    if (options.remove_self_loops && src == dest) {
+      return;
+    }
+    fn(src, dest);
+    if (options.symmetric) {
+      fn(dest, src);
+    }
+  };
+
+  katana::LargeArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { counts[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_pairs),
+      [&](uint64_t i) {
+        emit(i, [&](uint32_t src, uint32_t) {
+          __atomic_fetch_add(&counts[src], 1, __ATOMIC_RELAXED);
+        });
+      },
+      katana::steal(), katana::loopname("GenerateCount"));
+
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  auto* out_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+  katana::ParallelSTL::partial_sum(counts.begin(), counts.end(), out_indices);
+  uint64_t num_edges = num_nodes > 0 ? out_indices[num_nodes - 1] : 0;
+
+  // Reuse counts as the next free place of each source
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { counts[n] = out_indices[n] - counts[n]; },
+      katana::no_stats());
+
+  auto dests_res = Allocate(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.value());
+  auto* out_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_pairs),
+      [&](uint64_t i) {
+        emit(i, [&](uint32_t src, uint32_t dest) {
+          out_dests[__atomic_fetch_add(&counts[src], 1, __ATOMIC_RELAXED)] =
+              dest;
+        });
+      },
+      katana::steal(), katana::loopname("GeneratePlace"));
+
+  // Edges were placed in whatever order threads got to them; sorting makes
+  // the topology deterministic
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? out_indices[n - 1] : 0;
+        std::sort(out_dests + begin, out_dests + out_indices[n]);
+      },
+      katana::steal(), katana::loopname("GenerateSort"));
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  if (auto r = pg->SetTopology(katana::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices),
+          .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
+      });
+      !r) {
+    return r.error();
+  }
+
+  if (options.max_weight > 0) {
+    auto weights_res = Allocate(num_edges * sizeof(uint32_t), "weights");
+    if (!weights_res) {
+      return weights_res.error();
+    }
+    std::shared_ptr<arrow::Buffer> weights = std::move(weights_res.value());
+    auto* values = reinterpret_cast<uint32_t*>(weights->mutable_data());
+    const katana::GraphTopology& topology = pg->topology();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          for (auto e : topology.edges(n)) {
+            uint64_t dest = topology.edge_dest(e);
+            uint64_t key = (std::min(n, dest) << 32) | std::max(n, dest);
+            values[e] = 1 + Mix(options.seed ^ Mix(key)) % options.max_weight;
+          }
+        },
+        katana::steal(), katana::loopname("GenerateWeights"));
+    auto array = std::make_shared<arrow::UInt32Array>(num_edges, weights);
+    if (auto r = pg->AddEdgeProperties(arrow::Table::Make(
+            arrow::schema(
+                {arrow::field(options.weight_property_name, arrow::uint32())}),
+            {array}));
+        !r) {
+      return r.error();
+    }
+  }
+
+  return std::unique_ptr<katana::PropertyGraph>(std::move(pg));
+}
+
+/// A bijection of the numbers below 2^scale, for scale of at most 32
+uint64_t
+Scramble(uint64_t v, uint32_t scale, uint64_t seed) {
+  const uint64_t mask = (uint64_t{1} << scale) - 1;
+  const uint32_t shift = scale / 2 + 1;
+  // Odd multipliers and xor with a right shift are invertible modulo 2^scale
+  v = (v * (Mix(seed) | 1)) & mask;
+  v ^= v >> shift;
+  v = (v * (Mix(seed + 1) | 1)) & mask;
+  v ^= v >> shift;
+  return v;
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::GenerateRmat(
+    uint32_t scale, uint64_t num_edges, const RmatParameters& parameters,
+    bool scramble, const GeneratorOptions& options) {
+  if (scale > 32) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "scale {} has more than 2^32 nodes",
+        scale);
+  }
+  const double a = parameters.a;
+  const double ab = a + parameters.b;
+  const double abc = ab + parameters.c;
+  if (parameters.a < 0 || parameters.b < 0 || parameters.c < 0 || abc > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "R-MAT probabilities {}, {} and {} do not leave a probability for the "
+        "last quadrant",
+        parameters.a, parameters.b, parameters.c);
+  }
+
+  return BuildGenerated(
+      uint64_t{1} << scale, num_edges, options, [&](uint64_t i) {
+        PairRandom random(options.seed, i);
+        uint64_t src = 0;
+        uint64_t dest = 0;
+        for (uint32_t level = 0; level < scale; ++level) {
+          double r = random.NextDouble();
+          src = (src << 1) | (r >= ab);
+          dest = (dest << 1) | (r >= a && (r < ab || r >= abc));
+        }
+        if (scramble) {
+          src = Scramble(src, scale, options.seed);
+          dest = Scramble(dest, scale, options.seed);
+        }
+        return std::make_pair(
+            static_cast<uint32_t>(src), static_cast<uint32_t>(dest));
+      });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::GenerateKronecker(
+    uint32_t scale, uint32_t edge_factor, const GeneratorOptions& options) {
+  return GenerateRmat(
+      scale, uint64_t{edge_factor} << scale, RmatParameters{0.57, 0.19, 0.19},
+      true, options);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::GenerateErdosRenyi(
+    uint32_t num_nodes, uint64_t num_edges, const GeneratorOptions& options) {
+  if (num_nodes == 0 && num_edges > 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "a graph without nodes has no edges");
+  }
+  return BuildGenerated(num_nodes, num_edges, options, [&](uint64_t i) {
+    PairRandom random(options.seed, i);
+    auto src = static_cast<uint32_t>(random.Below(num_nodes));
+    auto dest = static_cast<uint32_t>(random.Below(num_nodes));
+    return std::make_pair(src, dest);
+  });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::GenerateStochasticBlockModel(
+    const std::vector<uint32_t>& block_sizes,
+    const std::vector<std::vector<double>>& probabilities,
+    const std::string& block_property_name, const GeneratorOptions& options) {
+  const uint64_t num_blocks = block_sizes.size();
+  if (probabilities.size() != num_blocks) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} blocks need {} rows of probabilities, not {}", num_blocks,
+        num_blocks, probabilities.size());
+  }
+
+  std::vector<uint64_t> block_begin(num_blocks + 1, 0);
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    block_begin[i + 1] = block_begin[i] + block_sizes[i];
+  }
+  if (block_begin[num_blocks] > (uint64_t{1} << 32)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes are more than 2^32",
+        block_begin[num_blocks]);
+  }
+
+  // pairs_end[i * num_blocks + j] is one past the last pair from block i to
+  // block j
+  std::vector<uint64_t> pairs_end(num_blocks * num_blocks);
+  uint64_t num_pairs = 0;
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    if (probabilities[i].size() != num_blocks) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "row {} of probabilities has {} columns instead of {}", i,
+          probabilities[i].size(), num_blocks);
+    }
+    for (uint64_t j = 0; j < num_blocks; ++j) {
+      double p = probabilities[i][j];
+      if (!(p >= 0 && p <= 1)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "probability {} between blocks {} and {} is not in [0, 1]", p, i,
+            j);
+      }
+      num_pairs += std::llround(
+          p * static_cast<double>(block_sizes[i]) *
+          static_cast<double>(block_sizes[j]));
+      pairs_end[i * num_blocks + j] = num_pairs;
+    }
+  }
+
+  auto pg_res = BuildGenerated(
+      block_begin[num_blocks], num_pairs, options, [&](uint64_t p) {
+        uint64_t blocks =
+            std::upper_bound(pairs_end.begin(), pairs_end.end(), p) -
+            pairs_end.begin();
+        uint64_t i = blocks / num_blocks;
+        uint64_t j = blocks % num_blocks;
+        PairRandom random(options.seed, p);
+        auto src = static_cast<uint32_t>(
+            block_begin[i] + random.Below(block_sizes[i]));
+        auto dest = static_cast<uint32_t>(
+            block_begin[j] + random.Below(block_sizes[j]));
+        return std::make_pair(src, dest);
+      });
+  if (!pg_res || block_property_name.empty()) {
+    return pg_res;
+  }
+
+  std::unique_ptr<PropertyGraph> pg = std::move(pg_res.value());
+  std::vector<uint32_t> blocks(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t i) {
+        std::fill(
+            blocks.begin() + block_begin[i], blocks.begin() + block_begin[i + 1],
+            static_cast<uint32_t>(i));
+      },
+      katana::no_stats());
+  auto array = katana::BuildArray(blocks);
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field(block_property_name, array->type())}),
+          {array}));
+      !r) {
+    return r.error();
+  }
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
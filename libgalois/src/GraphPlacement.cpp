@@ -0,0 +1,346 @@
+#include "katana/GraphPlacement.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Loops.h"
+#include "katana/NumaMem.h"
+#include "katana/Threads.h"
+#include "katana/gstl.h"
+
+namespace {
+
+/// An arrow buffer that owns memory from the largeMalloc allocators
+class LargeBuffer : public arrow::MutableBuffer {
+public:
+  LargeBuffer(katana::LAptr ptr, int64_t size)
+      : arrow::MutableBuffer(static_cast<uint8_t*>(ptr.get()), size),
+        ptr_(std::move(ptr)) {}
+
+private:
+  katana::LAptr ptr_;
+};
+
+/// The placement of one array: either a policy that does not depend on the
+/// array or, for kBlocked, the first element owned by each thread
+struct Placement {
+  katana::MemoryPlacement policy;
+  unsigned num_threads;
+  std::vector<uint64_t> ranges;
+};
+
+/// The blocks of [0, num_nodes) given to each thread by do_all
+Placement
+NodePlacement(katana::MemoryPlacement policy, uint64_t num_nodes) {
+  Placement placement{policy, katana::getActiveThreads(), {}};
+  for (unsigned t = 0; t < placement.num_threads; ++t) {
+    placement.ranges.emplace_back(
+        katana::block_range(uint64_t{0}, num_nodes, t, placement.num_threads)
+            .first);
+  }
+  placement.ranges.emplace_back(num_nodes);
+  return placement;
+}
+
+/// The edges of the nodes in each block of node_placement
+Placement
+EdgePlacement(
+    const Placement& node_placement, const katana::GraphTopology& topology) {
+  Placement placement = node_placement;
+  for (uint64_t& r : placement.ranges) {
+    r = r < topology.num_nodes() ? topology.edge_range(r).first
+                                 : topology.num_edges();
+  }
+  return placement;
+}
+
+/// Copy num_elements values of element_size bytes starting at data into
+/// memory placed according to placement. offset is the index of the element
+/// at data[0] in the ranges of placement.
+katana::Result<std::shared_ptr<arrow::Buffer>>
+PlaceValues(
+    const uint8_t* data, int64_t offset, int64_t num_elements,
+    size_t element_size, const Placement& placement) {
+  size_t bytes = (offset + num_elements) * element_size;
+
+  katana::LAptr ptr;
+  if (placement.policy == katana::MemoryPlacement::kBlocked) {
+    std::vector<uint64_t> ranges = placement.ranges;
+    for (uint64_t& r : ranges) {
+      r += offset;
+    }
+    ranges.front() = 0;
+    ptr = katana::largeMallocSpecified(
+        bytes, placement.num_threads, ranges, element_size);
+  } else {
+    ptr = katana::largeMallocInterleaved(bytes, placement.num_threads);
+  }
+  if (!ptr) {
+    return KATANA_ERROR(
+        std::errc::not_enough_memory, "allocating {} bytes", bytes);
+  }
+
+  // The pages are already placed, so it does not matter which thread copies
+  // which part
+  auto* dest = static_cast<uint8_t*>(ptr.get());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, bytes, tid, total);
+    std::memcpy(dest + begin, data + begin, end - begin);
+  });
+
+  return std::shared_ptr<arrow::Buffer>(
+      std::make_shared<LargeBuffer>(std::move(ptr), bytes));
+}
+
+template <typename ArrayType>
+katana::Result<std::shared_ptr<ArrayType>>
+PlaceTopologyArray(
+    const std::shared_ptr<ArrayType>& array, const Placement& placement) {
+  if (!array || array->length() == 0) {
+    return array;
+  }
+  auto placed_res = PlaceValues(
+      array->data()->buffers[1]->data(), array->offset(), array->length(),
+      sizeof(typename ArrayType::value_type), placement);
+  if (!placed_res) {
+    return placed_res.error();
+  }
+  return std::make_shared<ArrayType>(
+      array->length(), placed_res.value(), nullptr, 0, array->offset());
+}
+
+/// Return a copy of column in placed memory, or column itself if it cannot
+/// be placed
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+PlaceColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const Placement& placement) {
+  if (column->num_chunks() != 1) {
+    return column;
+  }
+  std::shared_ptr<arrow::ArrayData> data = column->chunk(0)->data();
+  const auto* type =
+      dynamic_cast<const arrow::FixedWidthType*>(data->type.get());
+  if (type == nullptr || type->bit_width() % 8 != 0 ||
+      data->buffers.size() != 2 || !data->buffers[1] || data->length == 0) {
+    return column;
+  }
+
+  auto placed_res = PlaceValues(
+      data->buffers[1]->data(), data->offset, data->length,
+      type->bit_width() / 8, placement);
+  if (!placed_res) {
+    return placed_res.error();
+  }
+
+  std::shared_ptr<arrow::ArrayData> placed_data = data->Copy();
+  placed_data->buffers[1] = placed_res.value();
+  return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(placed_data));
+}
+
+/// Replace every property in view with a copy in placed memory
+katana::Result<void>
+PlaceProperties(
+    katana::PropertyGraph::PropertyView view, const Placement& placement) {
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+  int num_fields = schema->num_fields();
+  if (num_fields == 0) {
+    return katana::ResultSuccess();
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < num_fields; ++i) {
+    std::shared_ptr<arrow::ChunkedArray> property = view.Property(i);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading property {}",
+          schema->field(i)->name());
+    }
+    auto placed_res = PlaceColumn(property, placement);
+    if (!placed_res) {
+      return placed_res.error().WithContext(
+          "property {}", schema->field(i)->name());
+    }
+    columns.emplace_back(std::move(placed_res.value()));
+  }
+
+  for (int i = num_fields - 1; i >= 0; --i) {
+    if (auto res = view.RemoveProperty(i); !res) {
+      return res.error();
+    }
+  }
+  return view.AddProperties(arrow::Table::Make(schema, columns));
+}
+
+/// Which thread faults in each page of a file as it is filled
+struct PageOwners {
+  katana::MemoryPlacement policy;
+  /// For kBlocked, thread t owns the pages that start in [bounds[t],
+  /// bounds[t + 1]) of the file; the first and last threads also own the
+  /// pages before and after all bounds
+  std::vector<uint64_t> bounds;
+};
+
+/// Fault in the pages of [offset, offset + size) of a file, at mem, from
+/// the threads that own them. offset and mem are page aligned.
+void
+TouchPages(
+    const PageOwners& owners, uint8_t* mem, uint64_t offset, uint64_t size) {
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  uint64_t num_pages = (size + kPageSize - 1) / kPageSize;
+
+  // Write back what is there so that the pages are allocated where they are
+  // touched without changing them
+  auto touch = [&](uint64_t page) {
+    auto* p = reinterpret_cast<volatile uint8_t*>(mem + page * kPageSize);
+    *p = *p;
+  };
+
+  katana::on_each([&](unsigned tid, unsigned total) {
+    if (owners.policy == katana::MemoryPlacement::kInterleaved) {
+      uint64_t first_page = offset / kPageSize;
+      uint64_t page = (tid + total - first_page % total) % total;
+      for (; page < num_pages; page += total) {
+        touch(page);
+      }
+      return;
+    }
+
+    if (tid >= owners.bounds.size()) {
+      return;
+    }
+    uint64_t lo = tid == 0 ? 0 : owners.bounds[tid];
+    uint64_t hi = tid + 1 == owners.bounds.size()
+                      ? std::numeric_limits<uint64_t>::max()
+                      : owners.bounds[tid + 1];
+    lo = std::clamp(lo, offset, offset + size);
+    hi = std::clamp(hi, offset, offset + size);
+    for (uint64_t page = (lo - offset + kPageSize - 1) / kPageSize;
+         page * kPageSize < hi - offset; ++page) {
+      touch(page);
+    }
+  });
+}
+
+/// Fill view, a bound topology file of which nothing has been read yet, in
+/// memory placed according to policy; see katana::TopologyFiller
+katana::Result<void>
+FillPlaced(tsuba::FileView* view, katana::MemoryPlacement policy) {
+  constexpr uint64_t kHeaderSize = 4 * sizeof(uint64_t);
+  unsigned num_threads = katana::getActiveThreads();
+
+  PageOwners owners{policy, {0}};
+  view->SetPlacement([&owners](uint8_t* mem, uint64_t offset, uint64_t size) {
+    TouchPages(owners, mem, offset, size);
+  });
+  auto fill = [&](uint64_t begin, uint64_t end) -> katana::Result<void> {
+    if (auto res = view->Fill(begin, end, true); !res) {
+      view->SetPlacement(nullptr);
+      return res.error();
+    }
+    return katana::ResultSuccess();
+  };
+
+  // Leave files this does not understand to the caller to read and reject
+  if (view->size() < kHeaderSize) {
+    view->SetPlacement(nullptr);
+    return katana::ResultSuccess();
+  }
+  if (auto res = fill(0, kHeaderSize); !res) {
+    return res.error().WithContext("header");
+  }
+  const auto* header = view->ptr<uint64_t>();
+  uint64_t num_nodes = header[2];
+  uint64_t num_edges = header[3];
+  uint64_t indices_begin = kHeaderSize;
+  uint64_t indices_end = indices_begin + num_nodes * sizeof(uint64_t);
+  uint64_t dests_end = indices_end + num_edges * sizeof(uint32_t);
+  if (header[0] != 1 || num_nodes > view->size() ||
+      num_edges > view->size() || dests_end > view->size()) {
+    view->SetPlacement(nullptr);
+    return katana::ResultSuccess();
+  }
+
+  Placement node_placement = NodePlacement(policy, num_nodes);
+  node_placement.ranges.resize(num_threads);
+  owners.bounds.clear();
+  for (uint64_t r : node_placement.ranges) {
+    owners.bounds.emplace_back(indices_begin + r * sizeof(uint64_t));
+  }
+  if (auto res = fill(indices_begin, indices_end); !res) {
+    return res.error().WithContext("out_indices");
+  }
+
+  // Node n has the edges from out_indices[n - 1] to out_indices[n]
+  const auto* out_indices = view->ptr<uint64_t>(indices_begin);
+  owners.bounds.clear();
+  for (uint64_t r : node_placement.ranges) {
+    uint64_t first_edge =
+        r == 0 ? 0 : std::min(out_indices[r - 1], num_edges);
+    owners.bounds.emplace_back(indices_end + first_edge * sizeof(uint32_t));
+  }
+  if (auto res = fill(indices_end, view->size()); !res) {
+    return res.error().WithContext("out_dests");
+  }
+
+  view->SetPlacement(nullptr);
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+std::function<katana::Result<void>(tsuba::FileView*)>
+katana::TopologyFiller(MemoryPlacement placement) {
+  if (placement == MemoryPlacement::kFirstTouch) {
+    return nullptr;
+  }
+  return [placement](tsuba::FileView* view) {
+    return FillPlaced(view, placement);
+  };
+}
+
+katana::Result<void>
+katana::PlaceGraph(
+    PropertyGraph* pg, MemoryPlacement placement, bool place_topology) {
+  if (placement == MemoryPlacement::kFirstTouch) {
+    return ResultSuccess();
+  }
+
+  const GraphTopology& topology = pg->topology();
+  Placement node_placement = NodePlacement(placement, topology.num_nodes());
+  Placement edge_placement = EdgePlacement(node_placement, topology);
+
+  if (auto res = PlaceProperties(pg->node_property_view(), node_placement);
+      !res) {
+    return res.error();
+  }
+  if (auto res = PlaceProperties(pg->edge_property_view(), edge_placement);
+      !res) {
+    return res.error();
+  }
+  if (!place_topology) {
+    return ResultSuccess();
+  }
+
+  auto indices_res = PlaceTopologyArray(topology.out_indices, node_placement);
+  if (!indices_res) {
+    return indices_res.error().WithContext("out_indices");
+  }
+  auto dests_res = PlaceTopologyArray(topology.out_dests, edge_placement);
+  if (!dests_res) {
+    return dests_res.error().WithContext("out_dests");
+  }
+
+  return pg->SetTopology(GraphTopology{
+      .out_indices = std::move(indices_res.value()),
+      .out_dests = std::move(dests_res.value()),
+  });
+}
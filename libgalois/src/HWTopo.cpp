@@ -1,7 +1,86 @@
 #include "katana/HWTopo.h"
 
+#include <mutex>
 #include <stdexcept>
 
+#include "katana/Env.h"
+#include "katana/Logging.h"
+
+namespace {
+
+struct PlacementConfig {
+  katana::ThreadPlacement placement;
+  std::vector<int> cpus;
+};
+
+PlacementConfig
+DefaultPlacement() {
+  std::string value;
+  if (!katana::GetEnv("KATANA_THREAD_PLACEMENT", &value) ||
+      value == "physical") {
+    return {katana::ThreadPlacement::kPhysicalCoresFirst, {}};
+  }
+  if (value == "compact") {
+    return {katana::ThreadPlacement::kCompact, {}};
+  }
+  if (value == "scatter") {
+    return {katana::ThreadPlacement::kScatter, {}};
+  }
+  std::vector<int> cpus = katana::parseCPUList(value);
+  if (cpus.empty()) {
+    KATANA_LOG_WARN(
+        "unknown KATANA_THREAD_PLACEMENT value {}; expected physical, "
+        "compact, scatter or a cpu list",
+        value);
+    return {katana::ThreadPlacement::kPhysicalCoresFirst, {}};
+  }
+  return {katana::ThreadPlacement::kList, std::move(cpus)};
+}
+
+std::mutex placement_mutex;
+
+PlacementConfig&
+PlacementRef() {
+  static PlacementConfig config{DefaultPlacement()};
+  return config;
+}
+
+}  // namespace
+
+void
+katana::SetThreadPlacement(
+    ThreadPlacement placement, const std::vector<int>& cpus) {
+  std::lock_guard<std::mutex> lock(placement_mutex);
+  PlacementRef() = PlacementConfig{
+      placement,
+      placement == ThreadPlacement::kList ? cpus : std::vector<int>{}};
+}
+
+katana::ThreadPlacement
+katana::GetThreadPlacement(std::vector<int>* cpus) {
+  std::lock_guard<std::mutex> lock(placement_mutex);
+  const PlacementConfig& config = PlacementRef();
+  if (cpus) {
+    *cpus = config.cpus;
+  }
+  return config.placement;
+}
+
+std::string
+katana::ThreadPlacementName(ThreadPlacement placement) {
+  switch (placement) {
+  case ThreadPlacement::kPhysicalCoresFirst:
+    return "physical";
+  case ThreadPlacement::kCompact:
+    return "compact";
+  case ThreadPlacement::kScatter:
+    return "scatter";
+  case ThreadPlacement::kList:
+    return "list";
+  }
+  return "unknown";
+}
+
 std::vector<int>
 katana::parseCPUList(const std::string& line) {
   std::vector<int> vals;
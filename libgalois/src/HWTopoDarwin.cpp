@@ -138,6 +138,12 @@ katana::getHWTopo() {
   static SimpleLock lock;
   static std::unique_ptr<HWTopoInfo> data;
 
+  if (GetThreadPlacement() != ThreadPlacement::kPhysicalCoresFirst) {
+    KATANA_WARN_ONCE(
+        "Thread placement policies are not supported on this platform.  "
+        "Using the default placement.");
+  }
+
   std::lock_guard<SimpleLock> guard(lock);
   if (!data) {
     data = std::make_unique<HWTopoInfo>(makeHWTopo());
@@ -21,13 +21,20 @@
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <tuple>
 
+#include <unistd.h>
+
+#include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/SimpleLock.h"
 #include "katana/gIO.h"
@@ -53,6 +60,7 @@ struct cpuinfo {
   unsigned numaNode;  // from libnuma
   bool valid;         // from cpuset
   bool smt;           // computed
+  unsigned coreRank;  // computed: rank of core among cores of its socket
 };
 
 bool
@@ -138,6 +146,76 @@ parseCPUInfo() {
   return vals;
 }
 
+/// The first line of a topology cache file. The machine is identified by
+/// its host name and number of configured processors so that a cache on a
+/// shared file system is not used on another machine.
+std::string
+cacheHeader() {
+  std::array<char, 256> host{};
+  gethostname(host.data(), host.size() - 1);
+  return std::string("katana-hwtopo 1 ") + host.data() + " " +
+         std::to_string(sysconf(_SC_NPROCESSORS_CONF));
+}
+
+//! Read the cpuinfo written by writeCPUInfoCache, or return false
+bool
+readCPUInfoCache(const std::string& path, std::vector<cpuinfo>* vals) {
+  std::ifstream in(path);
+  std::string header;
+  if (!in || !std::getline(in, header) || header != cacheHeader()) {
+    return false;
+  }
+  cpuinfo c{};
+  while (in >> c.proc >> c.physid >> c.sib >> c.coreid >> c.cpucores >>
+         c.numaNode) {
+    vals->push_back(c);
+  }
+  return in.eof() && !vals->empty();
+}
+
+void
+writeCPUInfoCache(const std::string& path, const std::vector<cpuinfo>& vals) {
+  // Write a temporary file and rename it so that concurrent readers never see
+  // a partial file
+  std::string tmp = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream out(tmp);
+    out << cacheHeader() << "\n";
+    for (const auto& c : vals) {
+      out << c.proc << " " << c.physid << " " << c.sib << " " << c.coreid
+          << " " << c.cpucores << " " << c.numaNode << "\n";
+    }
+    if (!out) {
+      katana::gWarn("failed writing hardware topology cache ", tmp);
+      return;
+    }
+  }
+  if (rename(tmp.c_str(), path.c_str()) != 0) {
+    katana::gWarn(
+        "failed renaming hardware topology cache ", tmp, " (",
+        strerror(errno), ")");
+    unlink(tmp.c_str());
+  }
+}
+
+//! Parse /proc/cpuinfo or, if the environment variable KATANA_HWTOPO_CACHE
+//! names a file written by an earlier run on this machine, read it instead
+std::vector<cpuinfo>
+readCPUInfo() {
+  std::string cache_path;
+  if (!katana::GetEnv("KATANA_HWTOPO_CACHE", &cache_path) ||
+      cache_path.empty()) {
+    return parseCPUInfo();
+  }
+  std::vector<cpuinfo> vals;
+  if (readCPUInfoCache(cache_path, &vals)) {
+    return vals;
+  }
+  vals = parseCPUInfo();
+  writeCPUInfoCache(cache_path, vals);
+  return vals;
+}
+
 unsigned
 countSockets(const std::vector<cpuinfo>& info) {
   std::set<unsigned> pkgs;
@@ -219,11 +297,77 @@ markValid(std::vector<cpuinfo>& info) {
   }
 }
 
+void
+markCoreRank(std::vector<cpuinfo>& info) {
+  std::map<unsigned, std::set<unsigned>> cores;
+  for (auto& c : info)
+    cores[c.physid].insert(c.coreid);
+  for (auto& c : info) {
+    auto& socketCores = cores[c.physid];
+    c.coreRank =
+        std::distance(socketCores.begin(), socketCores.find(c.coreid));
+  }
+}
+
+bool
+compactOrder(const cpuinfo& a, const cpuinfo& b) {
+  return std::tie(a.physid, a.coreid, a.proc) <
+         std::tie(b.physid, b.coreid, b.proc);
+}
+
+//! Reorder info, which is in physical-cores-first order, for placement
+void
+placeThreads(
+    std::vector<cpuinfo>& info, katana::ThreadPlacement placement,
+    const std::vector<int>& cpus) {
+  switch (placement) {
+  case katana::ThreadPlacement::kPhysicalCoresFirst:
+    return;
+  case katana::ThreadPlacement::kCompact:
+    std::sort(info.begin(), info.end(), compactOrder);
+    return;
+  case katana::ThreadPlacement::kScatter:
+    // markSMT needs the contexts of each core to be adjacent
+    std::sort(info.begin(), info.end(), compactOrder);
+    markSMT(info);
+    markCoreRank(info);
+    std::sort(
+        info.begin(), info.end(), [](const cpuinfo& a, const cpuinfo& b) {
+          return std::tie(a.smt, a.coreRank, a.physid, a.proc) <
+                 std::tie(b.smt, b.coreRank, b.physid, b.proc);
+        });
+    return;
+  case katana::ThreadPlacement::kList: {
+    std::vector<cpuinfo> listed;
+    for (int cpu : cpus) {
+      auto isCPU = [cpu](const cpuinfo& c) { return (int)c.proc == cpu; };
+      if (std::any_of(listed.begin(), listed.end(), isCPU)) {
+        continue;
+      }
+      auto it = std::find_if(info.begin(), info.end(), isCPU);
+      if (it == info.end()) {
+        katana::gWarn("Ignoring cpu ", cpu, " that is not in the cpuset");
+        continue;
+      }
+      listed.push_back(*it);
+    }
+    if (listed.empty()) {
+      katana::gWarn(
+          "No cpu of the thread placement list is in the cpuset.  "
+          "Using the default placement.");
+      return;
+    }
+    info = std::move(listed);
+    return;
+  }
+  }
+}
+
 katana::HWTopoInfo
-makeHWTopo() {
+makeHWTopo(katana::ThreadPlacement placement, const std::vector<int>& cpus) {
   katana::MachineTopoInfo retMTI;
 
-  auto info = parseCPUInfo();
+  auto info = readCPUInfo();
   std::sort(info.begin(), info.end());
   markSMT(info);
   markValid(info);
@@ -235,6 +379,7 @@ makeHWTopo() {
 
   std::sort(info.begin(), info.end());
   markSMT(info);
+  placeThreads(info, placement, cpus);
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
@@ -242,18 +387,21 @@ makeHWTopo() {
 
   std::vector<katana::ThreadTopoInfo> retTTI;
   retTTI.reserve(retMTI.maxThreads);
-  // compute renumberings
-  std::set<unsigned> sockets;
+  // compute renumberings. Sockets are numbered in the order in which they
+  // are first used, so that the first n threads always use sockets
+  // [0, cumulativeMaxSocket of thread n - 1].
+  std::vector<unsigned> sockets;
   std::set<unsigned> numaNodes;
   for (auto& i : info) {
-    sockets.insert(i.physid);
+    if (std::find(sockets.begin(), sockets.end(), i.physid) == sockets.end())
+      sockets.push_back(i.physid);
     numaNodes.insert(i.numaNode);
   }
   unsigned mid = 0;  // max socket id
   for (unsigned i = 0; i < info.size(); ++i) {
     unsigned pid = info[i].physid;
-    unsigned repid =
-        std::distance(sockets.begin(), sockets.find(info[i].physid));
+    unsigned repid = std::distance(
+        sockets.begin(), std::find(sockets.begin(), sockets.end(), pid));
     mid = std::max(mid, repid);
     unsigned leader = std::distance(
         info.begin(),
@@ -279,10 +427,17 @@ katana::HWTopoInfo
 katana::getHWTopo() {
   static SimpleLock lock;
   static std::unique_ptr<HWTopoInfo> data;
+  static ThreadPlacement dataPlacement;
+  static std::vector<int> dataCPUs;
+
+  std::vector<int> cpus;
+  ThreadPlacement placement = GetThreadPlacement(&cpus);
 
   std::lock_guard<SimpleLock> guard(lock);
-  if (!data) {
-    data = std::make_unique<HWTopoInfo>(makeHWTopo());
+  if (!data || placement != dataPlacement || cpus != dataCPUs) {
+    data = std::make_unique<HWTopoInfo>(makeHWTopo(placement, cpus));
+    dataPlacement = placement;
+    dataCPUs = std::move(cpus);
   }
   return *data;
 }
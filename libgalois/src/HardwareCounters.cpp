@@ -0,0 +1,261 @@
+#include "katana/HardwareCounters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+using katana::internal::HardwareCounterSample;
+using katana::internal::HardwareEvent;
+using katana::internal::kNumHardwareEvents;
+
+#ifdef __linux__
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t
+CacheMiss(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Indexed by HardwareEvent. There is no generic event for remote DRAM
+// accesses; read misses of the local NUMA node are the closest one.
+constexpr EventConfig kEventConfigs[kNumHardwareEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_NODE)},
+};
+
+int
+PerfEventOpen(const EventConfig& event, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // User space only so that the default perf_event_paranoid setting allows
+  // unprivileged processes to count
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Count the calling thread on whatever CPU it runs
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+/// The counters of one thread. The group runs from when it is opened until
+/// it is destroyed; loops take the difference of two reads.
+class CounterGroup {
+  int fds_[kNumHardwareEvents];
+  // The position of each event in the values of a read, or -1 if the event
+  // could not be opened
+  int positions_[kNumHardwareEvents];
+  int num_open_{0};
+
+  CounterGroup() {
+    for (int i = 0; i < kNumHardwareEvents; ++i) {
+      fds_[i] = -1;
+      positions_[i] = -1;
+    }
+  }
+
+public:
+  ~CounterGroup() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  CounterGroup(const CounterGroup&) = delete;
+  CounterGroup& operator=(const CounterGroup&) = delete;
+
+  /// Open the counters of the calling thread
+  static katana::Result<std::unique_ptr<CounterGroup>> Open() {
+    std::unique_ptr<CounterGroup> group(new CounterGroup());
+    int leader = PerfEventOpen(kEventConfigs[0], -1);
+    if (leader < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented, "perf_event_open: {}",
+          std::strerror(errno));
+    }
+    group->fds_[0] = leader;
+    group->positions_[0] = group->num_open_++;
+
+    for (int i = 1; i < kNumHardwareEvents; ++i) {
+      int fd = PerfEventOpen(kEventConfigs[i], leader);
+      if (fd < 0) {
+        continue;
+      }
+      group->fds_[i] = fd;
+      group->positions_[i] = group->num_open_++;
+    }
+    return group;
+  }
+
+  bool Read(HardwareCounterSample* sample) const {
+    // nr, time_enabled, time_running, then one value per open event
+    uint64_t buf[3 + kNumHardwareEvents];
+    ssize_t expected = sizeof(uint64_t) * (3 + num_open_);
+    if (read(fds_[0], buf, sizeof(buf)) != expected) {
+      return false;
+    }
+    uint64_t enabled = buf[1];
+    uint64_t running = buf[2];
+    double scale = running == 0 ? 0.0 : static_cast<double>(enabled) / running;
+    for (int i = 0; i < kNumHardwareEvents; ++i) {
+      sample->valid[i] = positions_[i] >= 0;
+      sample->values[i] =
+          sample->valid[i] ? static_cast<uint64_t>(
+                                 static_cast<double>(buf[3 + positions_[i]]) *
+                                 scale)
+                           : 0;
+    }
+    return true;
+  }
+};
+
+#else
+
+class CounterGroup {
+public:
+  static katana::Result<std::unique_ptr<CounterGroup>> Open() {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "hardware counters require perf_event_open");
+  }
+
+  bool Read(HardwareCounterSample*) const { return false; }
+};
+
+#endif
+
+struct State {
+  std::atomic<bool> enabled{false};
+  // Indexed by thread id. Only modified outside of parallel loops.
+  std::vector<std::unique_ptr<CounterGroup>> groups;
+
+  State() {
+    bool enable = false;
+    if (!katana::GetEnv("KATANA_LOOP_HARDWARE_COUNTERS", &enable) ||
+        !enable) {
+      return;
+    }
+    if (auto res = CounterGroup::Open(); !res) {
+      KATANA_LOG_WARN("loop hardware counters unavailable: {}", res.error());
+      return;
+    }
+    enabled = true;
+  }
+};
+
+State&
+GetState() {
+  static State state;
+  return state;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::EnableLoopHardwareCounters() {
+  State& state = GetState();
+  // Check that this process may count events before enabling counting for
+  // every loop
+  if (auto res = CounterGroup::Open(); !res) {
+    return res.error();
+  }
+  state.enabled = true;
+  return ResultSuccess();
+}
+
+void
+katana::DisableLoopHardwareCounters() {
+  State& state = GetState();
+  state.enabled = false;
+  state.groups.clear();
+}
+
+bool
+katana::IsLoopHardwareCountersEnabled() {
+  return GetState().enabled.load(std::memory_order_relaxed);
+}
+
+const char*
+katana::internal::HardwareEventName(HardwareEvent event) {
+  switch (event) {
+  case kCycles:
+    return "Cycles";
+  case kLLCMisses:
+    return "LLCMisses";
+  case kDTLBMisses:
+    return "DTLBMisses";
+  case kRemoteDRAMAccesses:
+    return "RemoteDRAMAccesses";
+  default:
+    return "Unknown";
+  }
+}
+
+void
+katana::internal::OpenLoopHardwareCounters(unsigned num_threads) {
+  State& state = GetState();
+  if (GetThreadPool().isRunning()) {
+    return;
+  }
+  if (state.groups.size() < GetThreadPool().getMaxThreads()) {
+    state.groups.resize(GetThreadPool().getMaxThreads());
+  }
+
+  bool missing = false;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    missing |= !state.groups[i];
+  }
+  if (!missing) {
+    return;
+  }
+
+  // Groups count the thread that opens them, so each thread opens its own
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (state.groups[tid]) {
+      return;
+    }
+    auto res = CounterGroup::Open();
+    if (!res) {
+      KATANA_LOG_WARN("thread {}: {}", tid, res.error());
+      return;
+    }
+    state.groups[tid] = std::move(res.value());
+  });
+}
+
+bool
+katana::internal::ReadLoopHardwareCounters(
+    unsigned tid, HardwareCounterSample* sample) {
+  State& state = GetState();
+  if (tid >= state.groups.size() || !state.groups[tid]) {
+    return false;
+  }
+  return state.groups[tid]->Read(sample);
+}
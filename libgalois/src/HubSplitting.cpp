@@ -0,0 +1,171 @@
+#include "katana/HubSplitting.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/Logging.h"
+
+namespace {
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& values,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto res = arrow::compute::Take(values, indices);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "copying rows: {}", res.status());
+  }
+  return res.ValueOrDie().chunked_array();
+}
+
+/// Replace the node properties of pg with the rows of their nodes at
+/// node_ids, plus parent, the node ids themselves
+katana::Result<void>
+SetVirtualNodeProperties(
+    katana::PropertyGraph* pg,
+    const std::shared_ptr<arrow::UInt32Array>& node_ids,
+    const std::string& parent_property_name) {
+  katana::PropertyGraph::PropertyView view = pg->node_property_view();
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+  int num_fields = schema->num_fields();
+
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < num_fields; ++i) {
+    std::shared_ptr<arrow::ChunkedArray> property = view.Property(i);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading property {}",
+          schema->field(i)->name());
+    }
+    auto take_res = TakeRows(property, node_ids);
+    if (!take_res) {
+      return take_res.error().WithContext(
+          "property {}", schema->field(i)->name());
+    }
+    fields.emplace_back(schema->field(i));
+    columns.emplace_back(std::move(take_res.value()));
+  }
+  fields.emplace_back(arrow::field(parent_property_name, arrow::uint32()));
+  columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+      std::static_pointer_cast<arrow::Array>(node_ids)));
+
+  for (int i = num_fields - 1; i >= 0; --i) {
+    if (auto res = view.RemoveProperty(i); !res) {
+      return res.error();
+    }
+  }
+  return view.AddProperties(
+      arrow::Table::Make(arrow::schema(fields), columns));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::SplitHubNodes(
+    PropertyGraph* pg, uint64_t max_degree,
+    const std::string& parent_property_name) {
+  if (pg->node_schema()->GetFieldIndex(parent_property_name) >= 0) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "node property {} already exists",
+        parent_property_name);
+  }
+  auto view_res = pg->SplitHubs(max_degree);
+  if (!view_res) {
+    return view_res.error();
+  }
+  // Keep the view alive after the topology that holds it is replaced
+  std::shared_ptr<const HubSplitView> view = std::move(view_res.value());
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_virtual = view->num_virtual_nodes();
+  uint64_t num_edges = topology.num_edges();
+  if (num_virtual > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} virtual nodes do not fit node ids",
+        num_virtual);
+  }
+
+  auto indices_res = Allocate(num_virtual * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = Allocate(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto node_ids_res = Allocate(num_virtual * sizeof(uint32_t), "parents");
+  if (!node_ids_res) {
+    return node_ids_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> node_ids = std::move(node_ids_res.value());
+  auto* new_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  auto* parents = reinterpret_cast<uint32_t*>(node_ids->mutable_data());
+
+  std::copy(
+      view->edge_indices.begin(), view->edge_indices.end(), new_indices);
+  std::copy(
+      view->virtual_to_node.begin(), view->virtual_to_node.end(), parents);
+  ForEachVirtualNode(
+      *view,
+      [&](uint64_t v, uint64_t begin, uint64_t end) {
+        for (uint64_t e = begin; e < end; ++e) {
+          new_dests[e] = view->PushTarget(topology.edge_dest(e), v);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto parent_ids =
+      std::make_shared<arrow::UInt32Array>(num_virtual, node_ids);
+  const std::shared_ptr<arrow::ChunkedArray> user_ids = pg->local_to_user_id();
+  const std::shared_ptr<arrow::ChunkedArray> global_ids =
+      pg->local_to_global_id();
+
+  if (auto res = pg->SetTopology(GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_virtual, indices),
+          .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
+      });
+      !res) {
+    return res.error();
+  }
+  if (auto res =
+          SetVirtualNodeProperties(pg, parent_ids, parent_property_name);
+      !res) {
+    return res.error().WithContext("copying node properties");
+  }
+
+  uint64_t num_nodes = view->num_nodes();
+  if (user_ids && static_cast<uint64_t>(user_ids->length()) == num_nodes) {
+    auto take_res = TakeRows(user_ids, parent_ids);
+    if (!take_res) {
+      return take_res.error().WithContext("copying local_to_user_id");
+    }
+    pg->set_local_to_user_id(std::move(take_res.value()));
+  }
+  if (global_ids && static_cast<uint64_t>(global_ids->length()) == num_nodes) {
+    auto take_res = TakeRows(global_ids, parent_ids);
+    if (!take_res) {
+      return take_res.error().WithContext("copying local_to_global_id");
+    }
+    pg->set_local_to_global_id(std::move(take_res.value()));
+  }
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,301 @@
+#include "katana/LoopTelemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/HardwareCounters.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using katana::internal::HardwareCounterSample;
+using katana::internal::kNumHardwareEvents;
+
+struct alignas(katana::KATANA_CACHE_LINE_SIZE) ThreadCounters {
+  uint64_t iterations{};
+  uint64_t pushes{};
+  uint64_t conflicts{};
+  uint64_t steals{};
+  HardwareCounterSample hardware_start;
+  HardwareCounterSample hardware;
+  bool hardware_started{};
+  bool hardware_done{};
+};
+
+struct SpanState {
+  const char* loopname{};
+  const char* kind{};
+  unsigned num_threads{};
+  bool write_record{};
+  bool count_hardware{};
+  std::chrono::system_clock::time_point start_wall;
+  std::chrono::steady_clock::time_point start;
+  std::vector<ThreadCounters> threads;
+};
+
+class Sink {
+  std::mutex mutex_;
+  std::ofstream file_;
+  std::ostream* out_{};
+  std::atomic<bool> enabled_{false};
+
+public:
+  Sink() {
+    std::string path;
+    if (katana::GetEnv("KATANA_LOOP_TELEMETRY", &path)) {
+      Open(path);
+    }
+  }
+
+  void Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = false;
+    out_ = nullptr;
+    if (file_.is_open()) {
+      file_.close();
+    }
+
+    if (path.empty()) {
+      return;
+    }
+    if (path == "-") {
+      out_ = &std::cerr;
+    } else {
+      file_.open(path, std::ios::app);
+      if (!file_) {
+        KATANA_LOG_ERROR("could not open loop telemetry file {}", path);
+        return;
+      }
+      out_ = &file_;
+    }
+    enabled_ = true;
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Write(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_) {
+      return;
+    }
+    // Flush each record so that readers see loops as they finish
+    *out_ << line << std::endl;
+  }
+};
+
+Sink&
+GetSink() {
+  static Sink sink;
+  return sink;
+}
+
+std::atomic<SpanState*> current_span{nullptr};
+
+// Indexed by HardwareEvent
+constexpr const char* kHardwareEventKeys[kNumHardwareEvents] = {
+    "cycles",
+    "llc_misses",
+    "dtlb_misses",
+    "remote_dram_accesses",
+};
+
+/// Read the counters of thread tid at the end of span and report the
+/// difference to the StatManager from the calling thread
+void
+FinishHardwareCounters(SpanState* span, unsigned tid) {
+  ThreadCounters& c = span->threads[tid];
+  if (!c.hardware_started || c.hardware_done) {
+    return;
+  }
+  c.hardware_done = true;
+
+  HardwareCounterSample end;
+  if (!katana::internal::ReadLoopHardwareCounters(tid, &end)) {
+    return;
+  }
+  for (int i = 0; i < kNumHardwareEvents; ++i) {
+    if (!end.valid[i]) {
+      continue;
+    }
+    // Scaling multiplexed counts can make them go backwards slightly
+    uint64_t start = c.hardware_start.values[i];
+    c.hardware.valid[i] = true;
+    c.hardware.values[i] = end.values[i] > start ? end.values[i] - start : 0;
+    katana::ReportStatSum(
+        span->loopname,
+        katana::internal::HardwareEventName(
+            static_cast<katana::internal::HardwareEvent>(i)),
+        c.hardware.values[i]);
+  }
+}
+
+nlohmann::json
+MakeRecord(const SpanState& span) {
+  auto wall = std::chrono::steady_clock::now() - span.start;
+
+  std::vector<uint64_t> per_thread;
+  uint64_t iterations = 0;
+  uint64_t pushes = 0;
+  uint64_t conflicts = 0;
+  uint64_t steals = 0;
+  for (unsigned i = 0; i < span.num_threads; ++i) {
+    const ThreadCounters& c = span.threads[i];
+    per_thread.emplace_back(c.iterations);
+    iterations += c.iterations;
+    pushes += c.pushes;
+    conflicts += c.conflicts;
+    steals += c.steals;
+  }
+
+  // Ratio of the busiest thread to the average thread; 1 is perfect balance
+  double imbalance = 1.0;
+  if (iterations > 0) {
+    uint64_t max = *std::max_element(per_thread.begin(), per_thread.end());
+    imbalance = static_cast<double>(max) * span.num_threads / iterations;
+  }
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  nlohmann::json record{
+      {"name", span.loopname},
+      {"kind", span.kind},
+      {"start_time_us",
+       duration_cast<microseconds>(span.start_wall.time_since_epoch())
+           .count()},
+      {"wall_time_us", duration_cast<microseconds>(wall).count()},
+      {"threads", span.num_threads},
+      {"iterations", iterations},
+      {"per_thread_iterations", per_thread},
+      {"imbalance", imbalance},
+      {"steals", steals},
+      {"pushes", pushes},
+      {"conflicts", conflicts},
+  };
+
+  if (span.count_hardware) {
+    nlohmann::json hardware = nlohmann::json::object();
+    for (int i = 0; i < kNumHardwareEvents; ++i) {
+      bool valid = false;
+      uint64_t total = 0;
+      for (unsigned t = 0; t < span.num_threads; ++t) {
+        valid |= span.threads[t].hardware.valid[i];
+        total += span.threads[t].hardware.values[i];
+      }
+      if (valid) {
+        hardware[kHardwareEventKeys[i]] = total;
+      }
+    }
+    record["hardware_counters"] = hardware;
+  }
+  return record;
+}
+
+}  // namespace
+
+struct katana::internal::LoopTelemetrySpanBase::Impl : public SpanState {};
+
+void
+katana::SetLoopTelemetryFile(const std::string& path) {
+  GetSink().Open(path);
+}
+
+bool
+katana::IsLoopTelemetryEnabled() {
+  return GetSink().enabled();
+}
+
+katana::internal::LoopTelemetrySpanBase::LoopTelemetrySpanBase(
+    const char* loopname, const char* kind) {
+  bool write_record = IsLoopTelemetryEnabled();
+  bool count_hardware = IsLoopHardwareCountersEnabled();
+  if (!write_record && !count_hardware) {
+    return;
+  }
+
+  auto impl = std::make_unique<Impl>();
+  impl->loopname = loopname;
+  impl->kind = kind;
+  impl->num_threads = katana::getActiveThreads();
+  impl->write_record = write_record;
+  impl->count_hardware = count_hardware;
+  impl->threads.resize(GetThreadPool().getMaxThreads());
+
+  SpanState* expected = nullptr;
+  if (!current_span.compare_exchange_strong(expected, impl.get())) {
+    // Only the outermost loop is reported
+    return;
+  }
+
+  if (count_hardware) {
+    OpenLoopHardwareCounters(impl->num_threads);
+    for (unsigned i = 0; i < impl->num_threads; ++i) {
+      ThreadCounters& c = impl->threads[i];
+      c.hardware_started = ReadLoopHardwareCounters(i, &c.hardware_start);
+    }
+  }
+
+  impl->start_wall = std::chrono::system_clock::now();
+  impl->start = std::chrono::steady_clock::now();
+  impl_ = std::move(impl);
+}
+
+katana::internal::LoopTelemetrySpanBase::~LoopTelemetrySpanBase() {
+  if (!impl_) {
+    return;
+  }
+
+  current_span.store(nullptr);
+
+  if (impl_->count_hardware) {
+    // Loops without statistics do not report each thread, so read what is
+    // left from here
+    for (unsigned i = 0; i < impl_->num_threads; ++i) {
+      FinishHardwareCounters(impl_.get(), i);
+    }
+  }
+
+  if (!impl_->write_record) {
+    return;
+  }
+
+  auto line = katana::JsonDump(MakeRecord(*impl_));
+  if (!line) {
+    KATANA_LOG_ERROR(
+        "loop telemetry for {}: {}", impl_->loopname, line.error());
+    return;
+  }
+  GetSink().Write(line.value());
+}
+
+void
+katana::internal::ReportLoopTelemetry(
+    const char* loopname, uint64_t iterations, uint64_t pushes,
+    uint64_t conflicts, uint64_t steals) {
+  SpanState* span = current_span.load(std::memory_order_acquire);
+  // The span and the executor take the loop name from the same argument
+  // tuple, so comparing pointers is enough to skip nested loops
+  if (!span || span->loopname != loopname) {
+    return;
+  }
+
+  unsigned tid = ThreadPool::getTID();
+  ThreadCounters& c = span->threads[tid];
+  c.iterations += iterations;
+  c.pushes += pushes;
+  c.conflicts += conflicts;
+  c.steals += steals;
+
+  if (span->count_hardware) {
+    FinishHardwareCounters(span, tid);
+  }
+}
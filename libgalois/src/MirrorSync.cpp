@@ -0,0 +1,248 @@
+#include "katana/MirrorSync.h"
+
+#include <numeric>
+
+#include <arrow/array.h>
+
+#include "katana/Distribution.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+/// How the positions of the values in a message are encoded
+enum class Encoding : uint8_t {
+  /// Every position
+  kAll = 0,
+  /// A bitmap with a bit for each position
+  kBitmap = 1,
+  /// The number of positions and the difference between each position and
+  /// the previous one, as varints
+  kDeltas = 2,
+};
+
+uint64_t
+VarintSize(uint64_t val) {
+  uint64_t size = 1;
+  while (val >= 0x80) {
+    val >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+void
+AppendVarint(uint64_t val, std::string* out) {
+  while (val >= 0x80) {
+    out->push_back(static_cast<char>((val & 0x7f) | 0x80));
+    val >>= 7;
+  }
+  out->push_back(static_cast<char>(val));
+}
+
+katana::Result<uint64_t>
+ReadVarint(std::string_view* in) {
+  uint64_t val = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7) {
+    if (in->empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "truncated message");
+    }
+    auto byte = static_cast<uint8_t>(in->front());
+    in->remove_prefix(1);
+    val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return val;
+    }
+  }
+  return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "invalid varint");
+}
+
+katana::Result<std::vector<uint32_t>>
+ToVector(const std::shared_ptr<arrow::ChunkedArray>& ids, uint64_t num_nodes) {
+  std::vector<uint32_t> nodes;
+  if (!ids) {
+    return nodes;
+  }
+  nodes.reserve(ids->length());
+  for (const auto& chunk : ids->chunks()) {
+    auto array = std::dynamic_pointer_cast<arrow::UInt32Array>(chunk);
+    if (!array) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node table has type {} instead of uint32",
+          chunk->type()->ToString());
+    }
+    for (int64_t i = 0; i < array->length(); ++i) {
+      uint32_t node = array->Value(i);
+      if (node >= num_nodes) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "node table has node {} but the graph has {} nodes", node,
+            num_nodes);
+      }
+      nodes.emplace_back(node);
+    }
+  }
+  return nodes;
+}
+
+}  // namespace
+
+katana::Result<katana::MirrorSync>
+katana::MirrorSync::Make(const PropertyGraph& pg, CommBackend* comm) {
+  const auto& master_nodes = Distribution::master_nodes(pg);
+  const auto& mirror_nodes = Distribution::mirror_nodes(pg);
+  // An unpartitioned graph has no tables, and no mirrors to synchronize
+  if (master_nodes.empty() && mirror_nodes.empty() && comm->Num == 1) {
+    return MirrorSync(
+        comm, std::vector<std::vector<uint32_t>>(1),
+        std::vector<std::vector<uint32_t>>(1));
+  }
+  if (master_nodes.size() != comm->Num || mirror_nodes.size() != comm->Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "graph has master and mirror tables for {} and {} hosts but there are "
+        "{} tasks",
+        master_nodes.size(), mirror_nodes.size(), comm->Num);
+  }
+
+  std::vector<std::vector<uint32_t>> masters;
+  std::vector<std::vector<uint32_t>> mirrors;
+  for (uint32_t h = 0; h < comm->Num; ++h) {
+    auto masters_res = ToVector(master_nodes[h], pg.num_nodes());
+    if (!masters_res) {
+      return masters_res.error().WithContext("masters of host {}", h);
+    }
+    masters.emplace_back(std::move(masters_res.value()));
+    auto mirrors_res = ToVector(mirror_nodes[h], pg.num_nodes());
+    if (!mirrors_res) {
+      return mirrors_res.error().WithContext("mirrors of host {}", h);
+    }
+    mirrors.emplace_back(std::move(mirrors_res.value()));
+  }
+  return MirrorSync(comm, std::move(masters), std::move(mirrors));
+}
+
+std::vector<uint32_t>
+katana::MirrorSync::DirtyPositions(
+    const std::vector<uint32_t>& nodes, const DynamicBitset& dirty) {
+  std::vector<uint32_t> positions;
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    if (dirty.test(nodes[i])) {
+      positions.emplace_back(i);
+    }
+  }
+  return positions;
+}
+
+void
+katana::MirrorSync::EncodePositions(
+    const std::vector<uint32_t>& positions, uint64_t list_size,
+    std::string* out) {
+  if (positions.empty()) {
+    // An empty message means no values
+    return;
+  }
+  if (positions.size() == list_size) {
+    out->push_back(static_cast<char>(Encoding::kAll));
+    return;
+  }
+
+  uint64_t bitmap_size = (list_size + 7) / 8;
+  uint64_t deltas_size = VarintSize(positions.size());
+  uint64_t prev = 0;
+  for (uint32_t p : positions) {
+    deltas_size += VarintSize(p - prev);
+    prev = p;
+  }
+
+  if (bitmap_size <= deltas_size) {
+    out->push_back(static_cast<char>(Encoding::kBitmap));
+    size_t begin = out->size();
+    out->resize(begin + bitmap_size, '\0');
+    for (uint32_t p : positions) {
+      (*out)[begin + p / 8] |= static_cast<char>(1 << (p % 8));
+    }
+    return;
+  }
+
+  out->push_back(static_cast<char>(Encoding::kDeltas));
+  AppendVarint(positions.size(), out);
+  prev = 0;
+  for (uint32_t p : positions) {
+    AppendVarint(p - prev, out);
+    prev = p;
+  }
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::MirrorSync::DecodePositions(std::string_view* in, uint64_t list_size) {
+  if (in->empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "truncated message");
+  }
+  auto encoding = static_cast<Encoding>(in->front());
+  in->remove_prefix(1);
+
+  std::vector<uint32_t> positions;
+  switch (encoding) {
+  case Encoding::kAll:
+    positions.resize(list_size);
+    std::iota(positions.begin(), positions.end(), 0);
+    return positions;
+  case Encoding::kBitmap: {
+    uint64_t bitmap_size = (list_size + 7) / 8;
+    if (in->size() < bitmap_size) {
+      return KATANA_ERROR(ErrorCode::InvalidArgument, "truncated bitmap");
+    }
+    for (uint32_t p = 0; p < list_size; ++p) {
+      if ((static_cast<uint8_t>((*in)[p / 8]) >> (p % 8)) & 1) {
+        positions.emplace_back(p);
+      }
+    }
+    in->remove_prefix(bitmap_size);
+    return positions;
+  }
+  case Encoding::kDeltas: {
+    auto count_res = ReadVarint(in);
+    if (!count_res) {
+      return count_res.error();
+    }
+    if (count_res.value() > list_size) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "{} positions in a list of {}",
+          count_res.value(), list_size);
+    }
+    positions.reserve(count_res.value());
+    uint64_t prev = 0;
+    for (uint64_t i = 0; i < count_res.value(); ++i) {
+      auto delta_res = ReadVarint(in);
+      if (!delta_res) {
+        return delta_res.error();
+      }
+      uint64_t p = prev + delta_res.value();
+      if (p >= list_size || (i > 0 && p == prev)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "invalid position {}", p);
+      }
+      positions.emplace_back(p);
+      prev = p;
+    }
+    return positions;
+  }
+  }
+  return KATANA_ERROR(
+      ErrorCode::InvalidArgument, "unknown encoding {}",
+      static_cast<int>(encoding));
+}
+
+katana::Result<std::vector<std::string>>
+katana::MirrorSync::Exchange(std::vector<std::string> outgoing) {
+  uint64_t size = 0;
+  for (const std::string& message : outgoing) {
+    size += message.size();
+  }
+  size -= outgoing[host_id()].size();
+  bytes_sent_ += size;
+  katana::ReportStatSum("MirrorSync", "BytesSent", size);
+  return comm_->AllToAll(std::move(outgoing));
+}
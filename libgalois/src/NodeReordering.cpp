@@ -0,0 +1,907 @@
+#include "katana/NodeReordering.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <system_error>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Number of most recently placed nodes that the Gorder-like ordering scores
+/// candidates against
+constexpr uint64_t kGorderWindow = 5;
+
+/// Bounds on the number of edges PermuteNodesExternal buffers per thread and
+/// bucket before it writes them out
+constexpr uint64_t kMinBufferRecords = 64;
+constexpr uint64_t kMaxBufferRecords = uint64_t{1} << 20;
+
+uint64_t
+Degree(const katana::GraphTopology& topology, Node n) {
+  auto [begin, end] = topology.edge_range(n);
+  return end - begin;
+}
+
+/// Return all nodes sorted by degree, breaking ties by node id
+std::vector<Node>
+NodesByDegree(const katana::GraphTopology& topology, bool increasing) {
+  std::vector<Node> nodes(topology.num_nodes());
+  std::iota(nodes.begin(), nodes.end(), 0);
+  katana::ParallelSTL::sort(nodes.begin(), nodes.end(), [&](Node a, Node b) {
+    uint64_t da = Degree(topology, a);
+    uint64_t db = Degree(topology, b);
+    if (da != db) {
+      return increasing ? da < db : da > db;
+    }
+    return a < b;
+  });
+  return nodes;
+}
+
+std::vector<uint64_t>
+DegreeOrder(const katana::GraphTopology& topology) {
+  std::vector<Node> nodes = NodesByDegree(topology, false);
+  return std::vector<uint64_t>(nodes.begin(), nodes.end());
+}
+
+std::vector<uint64_t>
+HubClusterOrder(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<uint64_t> order;
+  order.reserve(num_nodes);
+  if (num_nodes == 0) {
+    return order;
+  }
+
+  // degree > num_edges / num_nodes without rounding the average
+  auto is_hub = [&](Node n) {
+    return Degree(topology, n) * num_nodes > topology.num_edges();
+  };
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (is_hub(n)) {
+      order.emplace_back(n);
+    }
+  }
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (!is_hub(n)) {
+      order.emplace_back(n);
+    }
+  }
+  return order;
+}
+
+/// Breadth-first order over all components. Each component starts from the
+/// first unvisited node in roots. If by_degree is true, the unvisited
+/// neighbors of a node are visited by increasing degree.
+std::vector<uint64_t>
+BFSOrder(
+    const katana::GraphTopology& topology, const std::vector<Node>& roots,
+    bool by_degree) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<uint64_t> order;
+  order.reserve(num_nodes);
+  std::vector<uint8_t> visited(num_nodes, 0);
+  std::vector<Node> frontier;
+
+  for (Node root : roots) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = 1;
+    order.emplace_back(root);
+
+    // order doubles as the queue
+    for (uint64_t head = order.size() - 1; head < order.size(); ++head) {
+      frontier.clear();
+      for (auto e : topology.edges(order[head])) {
+        Node dest = topology.edge_dest(e);
+        if (!visited[dest]) {
+          visited[dest] = 1;
+          frontier.emplace_back(dest);
+        }
+      }
+      if (by_degree) {
+        std::sort(frontier.begin(), frontier.end(), [&](Node a, Node b) {
+          uint64_t da = Degree(topology, a);
+          uint64_t db = Degree(topology, b);
+          return da != db ? da < db : a < b;
+        });
+      }
+      order.insert(order.end(), frontier.begin(), frontier.end());
+    }
+  }
+  return order;
+}
+
+std::vector<uint64_t>
+ReverseCuthillMcKeeOrder(const katana::GraphTopology& topology) {
+  std::vector<uint64_t> order =
+      BFSOrder(topology, NodesByDegree(topology, true), true);
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/// Priority queue of nodes keyed by small non-negative scores that change by
+/// one at a time, as in Gorder: each positive score has a doubly linked list
+/// of the nodes with that score, so every update and, amortized, every
+/// extraction is constant time.
+class UnitHeap {
+public:
+  explicit UnitHeap(uint64_t num_nodes)
+      : score_(num_nodes, 0),
+        prev_(num_nodes, kNone),
+        next_(num_nodes, kNone),
+        heads_(1, kNone) {}
+
+  void Add(Node v, int64_t delta) {
+    if (score_[v] > 0) {
+      Unlink(v);
+    }
+    score_[v] += delta;
+    if (score_[v] > 0) {
+      Link(v);
+    }
+  }
+
+  /// Remove v from the heap; its score is ignored afterwards
+  void Erase(Node v) {
+    if (score_[v] > 0) {
+      Unlink(v);
+    }
+    score_[v] = 0;
+  }
+
+  /// Return a node with the highest positive score or kNone if there is no
+  /// such node
+  Node Max() {
+    while (max_ > 0 && heads_[max_] == kNone) {
+      --max_;
+    }
+    return max_ > 0 ? heads_[max_] : kNone;
+  }
+
+  static constexpr Node kNone = std::numeric_limits<Node>::max();
+
+private:
+  void Link(Node v) {
+    auto s = static_cast<uint64_t>(score_[v]);
+    if (s >= heads_.size()) {
+      heads_.resize(s + 1, kNone);
+    }
+    prev_[v] = kNone;
+    next_[v] = heads_[s];
+    if (heads_[s] != kNone) {
+      prev_[heads_[s]] = v;
+    }
+    heads_[s] = v;
+    max_ = std::max(max_, s);
+  }
+
+  void Unlink(Node v) {
+    if (prev_[v] != kNone) {
+      next_[prev_[v]] = next_[v];
+    } else {
+      heads_[score_[v]] = next_[v];
+    }
+    if (next_[v] != kNone) {
+      prev_[next_[v]] = prev_[v];
+    }
+  }
+
+  std::vector<int64_t> score_;
+  std::vector<Node> prev_;
+  std::vector<Node> next_;
+  std::vector<Node> heads_;
+  uint64_t max_{0};
+};
+
+/// Greedy ordering in the style of Gorder [1]. The score of an unplaced node
+/// v is the number of edges between v and the last kGorderWindow placed
+/// nodes plus the number of in-neighbors v shares with them. The next node
+/// placed is the one with the highest score, or, when no node has a positive
+/// score, the unplaced node with the highest in degree.
+///
+/// Like Gorder, shared in-neighbors whose out degree is above sqrt(num_nodes)
+/// are ignored; they relate too many nodes to be informative and would make
+/// score updates quadratic in their degree.
+///
+/// [1] Wei et al., "Speedup Graph Processing by Graph Ordering", SIGMOD 2016
+std::vector<uint64_t>
+GorderOrder(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  // Incoming edges in CSR form: in_sources[in_begin[v], in_begin[v + 1])
+  std::vector<uint64_t> in_begin(num_nodes + 1, 0);
+  std::vector<Node> in_sources(num_edges);
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      ++in_begin[topology.edge_dest(e) + 1];
+    }
+  }
+  std::partial_sum(in_begin.begin(), in_begin.end(), in_begin.begin());
+  {
+    std::vector<uint64_t> fill(in_begin.begin(), in_begin.end() - 1);
+    for (Node n = 0; n < num_nodes; ++n) {
+      for (auto e : topology.edges(n)) {
+        in_sources[fill[topology.edge_dest(e)]++] = n;
+      }
+    }
+  }
+
+  std::vector<Node> fallback(num_nodes);
+  std::iota(fallback.begin(), fallback.end(), 0);
+  std::stable_sort(fallback.begin(), fallback.end(), [&](Node a, Node b) {
+    return in_begin[a + 1] - in_begin[a] > in_begin[b + 1] - in_begin[b];
+  });
+  auto max_sibling_degree = static_cast<uint64_t>(
+      std::sqrt(static_cast<double>(num_nodes)));
+
+  UnitHeap heap(num_nodes);
+  std::vector<uint8_t> placed(num_nodes, 0);
+
+  auto bump = [&](Node v, int64_t delta) {
+    if (!placed[v]) {
+      heap.Add(v, delta);
+    }
+  };
+  auto update_neighborhood = [&](Node u, int64_t delta) {
+    for (auto e : topology.edges(u)) {
+      bump(topology.edge_dest(e), delta);
+    }
+    for (uint64_t i = in_begin[u]; i < in_begin[u + 1]; ++i) {
+      Node w = in_sources[i];
+      bump(w, delta);
+      if (Degree(topology, w) > max_sibling_degree) {
+        continue;
+      }
+      for (auto e : topology.edges(w)) {
+        bump(topology.edge_dest(e), delta);
+      }
+    }
+  };
+
+  std::vector<uint64_t> order;
+  order.reserve(num_nodes);
+  uint64_t cursor = 0;
+  while (order.size() < num_nodes) {
+    Node next = heap.Max();
+    if (next == UnitHeap::kNone) {
+      while (placed[fallback[cursor]]) {
+        ++cursor;
+      }
+      next = fallback[cursor];
+    }
+
+    placed[next] = 1;
+    heap.Erase(next);
+    order.emplace_back(next);
+    update_neighborhood(next, 1);
+    if (order.size() > kGorderWindow) {
+      update_neighborhood(order[order.size() - 1 - kGorderWindow], -1);
+    }
+  }
+  return order;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& values,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto res = arrow::compute::Take(values, indices);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "permuting array: {}", res.status());
+  }
+  return res.ValueOrDie().chunked_array();
+}
+
+/// Replace every property in view with its rows permuted by indices
+katana::Result<void>
+PermuteProperties(
+    katana::PropertyGraph::PropertyView view,
+    const std::shared_ptr<arrow::Array>& indices) {
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+  int num_fields = schema->num_fields();
+  if (num_fields == 0) {
+    return katana::ResultSuccess();
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < num_fields; ++i) {
+    std::shared_ptr<arrow::ChunkedArray> property = view.Property(i);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading property {}",
+          schema->field(i)->name());
+    }
+    auto take_res = TakeRows(property, indices);
+    if (!take_res) {
+      return take_res.error().WithContext(
+          "property {}", schema->field(i)->name());
+    }
+    columns.emplace_back(std::move(take_res.value()));
+  }
+
+  for (int i = num_fields - 1; i >= 0; --i) {
+    if (auto res = view.RemoveProperty(i); !res) {
+      return res.error();
+    }
+  }
+  return view.AddProperties(arrow::Table::Make(schema, columns));
+}
+
+/// Check that new_to_old is a permutation of num_nodes nodes and return its
+/// inverse
+katana::Result<std::vector<Node>>
+InvertPermutation(const arrow::UInt64Array& new_to_old, uint64_t num_nodes) {
+  if (static_cast<uint64_t>(new_to_old.length()) != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "permutation has {} entries but graph has {} nodes",
+        new_to_old.length(), num_nodes);
+  }
+  const uint64_t* old_ids = new_to_old.raw_values();
+
+  std::vector<Node> old_to_new(num_nodes, 0);
+  std::vector<uint8_t> seen(num_nodes, 0);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    uint64_t old = old_ids[n];
+    if (old >= num_nodes || seen[old]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "not a permutation: entry {} is {}", n, old);
+    }
+    seen[old] = 1;
+    old_to_new[old] = n;
+  }
+  return old_to_new;
+}
+
+/// Return the out_indices of topology with its nodes relabeled so that new
+/// node n is old node old_ids[n]
+katana::Result<std::shared_ptr<arrow::Buffer>>
+PermutedIndices(
+    const katana::GraphTopology& topology, const uint64_t* old_ids) {
+  uint64_t num_nodes = topology.num_nodes();
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  auto* new_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_indices[n] = Degree(topology, old_ids[n]); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      new_indices, new_indices + num_nodes, new_indices);
+  return indices;
+}
+
+/// Replace the topology of pg with its permuted version and permute its
+/// properties and id mappings to match. edge_ids[new_edge] is the old id of
+/// new_edge.
+katana::Result<void>
+SetPermutedGraph(
+    katana::PropertyGraph* pg,
+    const std::shared_ptr<arrow::UInt64Array>& new_to_old,
+    const std::shared_ptr<arrow::Buffer>& indices,
+    const std::shared_ptr<arrow::Buffer>& dests,
+    const std::shared_ptr<arrow::Buffer>& edge_ids) {
+  uint64_t num_nodes = new_to_old->length();
+  uint64_t num_edges = dests->size() / sizeof(uint32_t);
+
+  if (auto res = pg->SetTopology(katana::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices),
+          .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (auto res = PermuteProperties(pg->node_property_view(), new_to_old);
+      !res) {
+    return res.error().WithContext("permuting node properties");
+  }
+  auto edge_permutation =
+      std::make_shared<arrow::UInt64Array>(num_edges, edge_ids);
+  if (auto res = PermuteProperties(pg->edge_property_view(), edge_permutation);
+      !res) {
+    return res.error().WithContext("permuting edge properties");
+  }
+
+  // Keep the per-node id mappings in step with the new node ids. For a graph
+  // that has no user ids yet, the user id of a node is its original id.
+  const std::shared_ptr<arrow::ChunkedArray>& user_ids = pg->local_to_user_id();
+  if (user_ids && static_cast<uint64_t>(user_ids->length()) == num_nodes) {
+    auto take_res = TakeRows(user_ids, new_to_old);
+    if (!take_res) {
+      return take_res.error().WithContext("permuting local_to_user_id");
+    }
+    pg->set_local_to_user_id(std::move(take_res.value()));
+  } else if (!user_ids || user_ids->length() == 0) {
+    pg->set_local_to_user_id(std::make_shared<arrow::ChunkedArray>(
+        std::static_pointer_cast<arrow::Array>(new_to_old)));
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "local_to_user_id has {} entries but graph has {} nodes",
+        user_ids->length(), num_nodes);
+  }
+
+  const std::shared_ptr<arrow::ChunkedArray>& global_ids =
+      pg->local_to_global_id();
+  if (global_ids && static_cast<uint64_t>(global_ids->length()) == num_nodes) {
+    auto take_res = TakeRows(global_ids, new_to_old);
+    if (!take_res) {
+      return take_res.error().WithContext("permuting local_to_global_id");
+    }
+    pg->set_local_to_global_id(std::move(take_res.value()));
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// An edge on its way from the old graph to a bucket of the permuted graph
+struct EdgeRecord {
+  uint64_t new_edge;
+  uint64_t old_edge;
+  /// The new id of the destination
+  uint32_t dest;
+};
+
+/// The memory of a MappedBuffer is a shared mapping of an unlinked temporary
+/// file, so its pages are written back to disk rather than to swap when
+/// memory runs short, and the file goes away with the buffer
+class MappedBuffer : public arrow::MutableBuffer {
+public:
+  MappedBuffer(uint8_t* map, int64_t size)
+      : arrow::MutableBuffer(map, size), map_(map) {}
+  ~MappedBuffer() override { munmap(map_, size()); }
+
+private:
+  uint8_t* map_;
+};
+
+/// Descriptors of temporary files, closed when this goes out of scope
+struct TempFiles {
+  std::vector<int> fds;
+
+  ~TempFiles() {
+    for (int fd : fds) {
+      close(fd);
+    }
+  }
+};
+
+/// Create a file in dir and unlink it right away, so that it goes away with
+/// its last descriptor or mapping
+katana::Result<int>
+OpenTempFile(const std::string& dir) {
+  std::string path = dir + "/katana-permute-XXXXXX";
+  int fd = mkstemp(path.data());
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "creating temporary file in {}", dir);
+  }
+  unlink(path.c_str());
+  return fd;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+MapTempBuffer(const std::string& dir, int64_t size, const char* what) {
+  if (size == 0) {
+    return Allocate(0, what);
+  }
+  auto fd_res = OpenTempFile(dir);
+  if (!fd_res) {
+    return fd_res.error().WithContext("allocating {}", what);
+  }
+  int fd = fd_res.value();
+  if (ftruncate(fd, size) != 0) {
+    auto ec = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(ec, "sizing {}", what);
+  }
+  void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    auto ec = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(ec, "mapping {}", what);
+  }
+  // The mapping holds its own reference to the file
+  close(fd);
+  return std::make_shared<MappedBuffer>(static_cast<uint8_t*>(map), size);
+}
+
+std::error_code
+WriteAt(int fd, const void* data, uint64_t size, uint64_t offset) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t written = pwrite(fd, bytes, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return std::error_code(errno, std::system_category());
+    }
+    bytes += written;
+    size -= written;
+    offset += written;
+  }
+  return std::error_code();
+}
+
+std::error_code
+ReadAt(int fd, void* data, uint64_t size, uint64_t offset) {
+  auto* bytes = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    ssize_t count = pread(fd, bytes, size, offset);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return std::error_code(errno, std::system_category());
+    }
+    if (count == 0) {
+      return std::make_error_code(std::errc::io_error);
+    }
+    bytes += count;
+    size -= count;
+    offset += count;
+  }
+  return std::error_code();
+}
+
+/// Split the new nodes into ranges of consecutive nodes with at most
+/// bucket_edges edges in total, unless a single node has more, and return
+/// the first node of each range
+std::vector<Node>
+BucketStarts(
+    const uint64_t* new_indices, uint64_t num_nodes, uint64_t bucket_edges) {
+  std::vector<Node> starts;
+  uint64_t start = 0;
+  while (start < num_nodes) {
+    starts.emplace_back(start);
+    uint64_t first_edge = start == 0 ? 0 : new_indices[start - 1];
+    uint64_t end = std::upper_bound(
+                       new_indices + start, new_indices + num_nodes,
+                       first_edge + bucket_edges) -
+                   new_indices;
+    start = std::max(end, start + 1);
+  }
+  return starts;
+}
+
+/// The state of one thread of PermuteNodesExternal
+struct Shard {
+  /// The records of this thread bound for each bucket
+  std::vector<std::vector<EdgeRecord>> buffers;
+  /// The last write this thread started
+  std::future<std::error_code> in_flight;
+  /// The first error this thread saw
+  std::error_code error;
+
+  void Record(std::error_code ec) {
+    if (ec && !error) {
+      error = ec;
+    }
+  }
+
+  void Wait() {
+    if (in_flight.valid()) {
+      Record(in_flight.get());
+    }
+  }
+};
+
+katana::Result<void>
+FirstError(katana::PerThreadStorage<Shard>& shards) {
+  for (unsigned i = 0; i < shards.size(); ++i) {
+    if (std::error_code ec = shards.getRemote(i)->error; ec) {
+      return KATANA_ERROR(ec, "temporary file I/O");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::ComputeNodeOrder(
+    const GraphTopology& topology, ReorderStrategy strategy) {
+  std::vector<uint64_t> order;
+  switch (strategy) {
+  case ReorderStrategy::kDegree:
+    order = DegreeOrder(topology);
+    break;
+  case ReorderStrategy::kBFS: {
+    std::vector<Node> roots(topology.num_nodes());
+    std::iota(roots.begin(), roots.end(), 0);
+    order = BFSOrder(topology, roots, false);
+    break;
+  }
+  case ReorderStrategy::kReverseCuthillMcKee:
+    order = ReverseCuthillMcKeeOrder(topology);
+    break;
+  case ReorderStrategy::kGorder:
+    order = GorderOrder(topology);
+    break;
+  case ReorderStrategy::kHubCluster:
+    order = HubClusterOrder(topology);
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown reorder strategy {}",
+        static_cast<int>(strategy));
+  }
+  KATANA_LOG_DEBUG_ASSERT(order.size() == topology.num_nodes());
+
+  return std::static_pointer_cast<arrow::UInt64Array>(BuildArray(order));
+}
+
+katana::Result<void>
+katana::PermuteNodes(
+    PropertyGraph* pg, const std::shared_ptr<arrow::UInt64Array>& new_to_old) {
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  auto old_to_new_res = InvertPermutation(*new_to_old, num_nodes);
+  if (!old_to_new_res) {
+    return old_to_new_res.error();
+  }
+  std::vector<Node> old_to_new = std::move(old_to_new_res.value());
+  const uint64_t* old_ids = new_to_old->raw_values();
+
+  auto indices_res = PermutedIndices(topology, old_ids);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = Allocate(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = Allocate(num_edges * sizeof(uint64_t), "edge ids");
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> edge_ids = std::move(edge_ids_res.value());
+
+  const auto* new_indices = reinterpret_cast<const uint64_t*>(indices->data());
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  // edge_ids[new_edge] is the old id of new_edge
+  auto* old_edges = reinterpret_cast<uint64_t*>(edge_ids->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : new_indices[n - 1];
+        for (auto e : topology.edges(old_ids[n])) {
+          new_dests[out] = old_to_new[topology.edge_dest(e)];
+          old_edges[out] = e;
+          ++out;
+        }
+        KATANA_LOG_DEBUG_ASSERT(out == new_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return SetPermutedGraph(pg, new_to_old, indices, dests, edge_ids);
+}
+
+katana::Result<void>
+katana::PermuteNodesExternal(
+    PropertyGraph* pg, const std::shared_ptr<arrow::UInt64Array>& new_to_old,
+    const ExternalPermuteOptions& options) {
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  uint64_t num_threads = katana::getActiveThreads();
+
+  auto old_to_new_res = InvertPermutation(*new_to_old, num_nodes);
+  if (!old_to_new_res) {
+    return old_to_new_res.error();
+  }
+  std::vector<Node> old_to_new = std::move(old_to_new_res.value());
+
+  auto indices_res = PermutedIndices(topology, new_to_old->raw_values());
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  const auto* new_indices = reinterpret_cast<const uint64_t*>(indices->data());
+
+  // The buckets that are merged at the same time should fit in the budget
+  uint64_t bucket_edges = std::max<uint64_t>(
+      1, options.memory_budget /
+             (num_threads * (sizeof(uint32_t) + sizeof(uint64_t))));
+  std::vector<Node> bucket_starts =
+      BucketStarts(new_indices, num_nodes, bucket_edges);
+  uint64_t num_buckets = bucket_starts.size();
+  // So should the buffers of every thread for every bucket, twice over
+  // because a thread keeps filling buffers while one is written
+  uint64_t buffer_records = std::clamp<uint64_t>(
+      options.memory_budget /
+          (2 * num_threads * std::max<uint64_t>(num_buckets, 1) *
+           sizeof(EdgeRecord)),
+      kMinBufferRecords, kMaxBufferRecords);
+
+  TempFiles buckets;
+  for (uint64_t b = 0; b < num_buckets; ++b) {
+    auto fd_res = OpenTempFile(options.temp_dir);
+    if (!fd_res) {
+      return fd_res.error().WithContext("creating bucket {}", b);
+    }
+    buckets.fds.emplace_back(fd_res.value());
+  }
+  std::vector<std::atomic<uint64_t>> bucket_bytes(num_buckets);
+
+  auto dests_res = MapTempBuffer(
+      options.temp_dir, num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = MapTempBuffer(
+      options.temp_dir, num_edges * sizeof(uint64_t), "edge ids");
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> edge_ids = std::move(edge_ids_res.value());
+
+  katana::PerThreadStorage<Shard> shards;
+
+  // Write the full buffer of bucket b in the background, after the previous
+  // write of this thread is done
+  auto flush = [&](Shard* shard, uint64_t b) {
+    shard->Wait();
+    std::vector<EdgeRecord> records;
+    records.reserve(buffer_records);
+    records.swap(shard->buffers[b]);
+    uint64_t bytes = records.size() * sizeof(EdgeRecord);
+    uint64_t offset =
+        bucket_bytes[b].fetch_add(bytes, std::memory_order_relaxed);
+    shard->in_flight = std::async(
+        std::launch::async,
+        [fd = buckets.fds[b], offset, bytes, records = std::move(records)]() {
+          return WriteAt(fd, records.data(), bytes, offset);
+        });
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t old) {
+        Shard* shard = shards.getLocal();
+        if (shard->buffers.empty()) {
+          shard->buffers.resize(num_buckets);
+        }
+        Node src = old_to_new[old];
+        uint64_t b = std::upper_bound(
+                         bucket_starts.begin(), bucket_starts.end(), src) -
+                     bucket_starts.begin() - 1;
+        std::vector<EdgeRecord>& buffer = shard->buffers[b];
+        uint64_t out = src == 0 ? 0 : new_indices[src - 1];
+        for (auto e : topology.edges(old)) {
+          buffer.emplace_back(
+              EdgeRecord{out++, e, old_to_new[topology.edge_dest(e)]});
+          if (buffer.size() >= buffer_records) {
+            flush(shard, b);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PermuteNodesExternal-Bucket"));
+
+  katana::on_each([&](unsigned, unsigned) {
+    Shard* shard = shards.getLocal();
+    for (uint64_t b = 0; b < shard->buffers.size(); ++b) {
+      if (!shard->buffers[b].empty()) {
+        flush(shard, b);
+      }
+    }
+    shard->Wait();
+  });
+  if (auto res = FirstError(shards); !res) {
+    return res.error().WithContext("writing buckets");
+  }
+
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  // edge_ids[new_edge] is the old id of new_edge
+  auto* old_edges = reinterpret_cast<uint64_t*>(edge_ids->mutable_data());
+
+  // Each bucket writes to its own range of the new edges. Its file is read
+  // in chunks, the next one in the background while the current one is
+  // scattered.
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        Shard* shard = shards.getLocal();
+        int fd = buckets.fds[b];
+        uint64_t size = bucket_bytes[b].load(std::memory_order_relaxed);
+        uint64_t chunk_bytes = buffer_records * sizeof(EdgeRecord);
+        std::vector<EdgeRecord> current(buffer_records);
+        std::vector<EdgeRecord> next(buffer_records);
+
+        auto fetch = [&](std::vector<EdgeRecord>* records, uint64_t offset) {
+          uint64_t bytes = std::min(chunk_bytes, size - offset);
+          return std::async(std::launch::async, [=]() {
+            return ReadAt(fd, records->data(), bytes, offset);
+          });
+        };
+
+        std::future<std::error_code> pending;
+        if (size > 0) {
+          pending = fetch(&next, 0);
+        }
+        for (uint64_t offset = 0; offset < size; offset += chunk_bytes) {
+          if (std::error_code ec = pending.get(); ec) {
+            shard->Record(ec);
+            return;
+          }
+          current.swap(next);
+          if (offset + chunk_bytes < size) {
+            pending = fetch(&next, offset + chunk_bytes);
+          }
+          uint64_t count =
+              std::min(chunk_bytes, size - offset) / sizeof(EdgeRecord);
+          for (uint64_t i = 0; i < count; ++i) {
+            const EdgeRecord& record = current[i];
+            new_dests[record.new_edge] = record.dest;
+            old_edges[record.new_edge] = record.old_edge;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PermuteNodesExternal-Merge"));
+  if (auto res = FirstError(shards); !res) {
+    return res.error().WithContext("reading buckets");
+  }
+
+  return SetPermutedGraph(pg, new_to_old, indices, dests, edge_ids);
+}
+
+katana::Result<void>
+katana::ReorderNodes(PropertyGraph* pg, ReorderStrategy strategy) {
+  auto order_res = ComputeNodeOrder(pg->topology(), strategy);
+  if (!order_res) {
+    return order_res.error();
+  }
+  return PermuteNodes(pg, order_res.value());
+}
@@ -21,6 +21,7 @@
 
 #include <cassert>
 
+#include "katana/MemoryBudget.h"
 #include "katana/PageAlloc.h"
 #include "katana/ThreadPool.h"
 #include "katana/gIO.h"
@@ -135,9 +136,18 @@ pageInSpecified(
   }
 }
 
+/* Allocate pages for a large allocation, charging them to the memory budget
+ * first so that reclaimers can make room before they are faulted in */
+static void*
+largeAlloc(size_t bytes, bool preFault) {
+  ChargeMemory(MemorySubsystem::kLargeArray, bytes);
+  return allocPages(bytes / allocSize(), preFault);
+}
+
 static void
 largeFree(void* ptr, size_t bytes) {
   freePages(ptr, bytes / allocSize());
+  ReleaseMemory(MemorySubsystem::kLargeArray, bytes);
 }
 
 void
@@ -167,7 +177,7 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // the alloc would go
 #endif
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = largeAlloc(bytes, false);
 
   // Then page in based on thread number
   if (data)
@@ -182,8 +192,7 @@ katana::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+  return LAptr{largeAlloc(bytes, true), internal::largeFreer{bytes}};
 }
 
 LAptr
@@ -191,8 +200,7 @@ katana::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+  return LAptr{largeAlloc(bytes, false), internal::largeFreer{bytes}};
 }
 
 LAptr
@@ -200,7 +208,7 @@ katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = largeAlloc(bytes, false);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
@@ -228,7 +236,7 @@ katana::largeMallocSpecified(
   // ceiling to nearest page
   bytes = roundup(bytes, allocSize());
 
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = largeAlloc(bytes, false);
 
   // NUMA aware page in based on element distribution specified in threadRanges
   if (data)
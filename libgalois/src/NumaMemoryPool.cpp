@@ -0,0 +1,142 @@
+#include "katana/NumaMemoryPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/NumaMem.h"
+#include "katana/PageAlloc.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+katana::NumaMemoryPool::Policy
+PolicyFromEnv() {
+  std::string value;
+  if (!katana::GetEnv("KATANA_NUMA_POOL_POLICY", &value) ||
+      value == "blocked") {
+    return katana::NumaMemoryPool::Policy::kBlocked;
+  }
+  if (value == "interleaved") {
+    return katana::NumaMemoryPool::Policy::kInterleaved;
+  }
+  if (value == "local") {
+    return katana::NumaMemoryPool::Policy::kLocal;
+  }
+  KATANA_LOG_WARN(
+      "unknown KATANA_NUMA_POOL_POLICY {}; using blocked placement", value);
+  return katana::NumaMemoryPool::Policy::kBlocked;
+}
+
+size_t
+RoundUpToPage(int64_t size) {
+  size_t page = katana::allocSize();
+  return (static_cast<size_t>(size) + page - 1) / page * page;
+}
+
+}  // namespace
+
+size_t
+katana::NumaMemoryPool::LargeSize(uint8_t* buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = large_.find(buffer);
+  return it == large_.end() ? 0 : it->second;
+}
+
+arrow::Status
+katana::NumaMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size requested");
+  }
+  if (static_cast<size_t>(size) < allocSize()) {
+    return small_pool_->Allocate(size, out);
+  }
+
+  size_t bytes = RoundUpToPage(size);
+  Policy placement = policy();
+  if (owner_.load(std::memory_order_relaxed) != std::this_thread::get_id() ||
+      GetThreadPool().isRunning()) {
+    placement = Policy::kLocal;
+  }
+
+  LAptr ptr;
+  switch (placement) {
+  case Policy::kBlocked:
+    ptr = largeMallocBlocked(bytes, getActiveThreads());
+    break;
+  case Policy::kInterleaved:
+    ptr = largeMallocInterleaved(bytes, getActiveThreads());
+    break;
+  case Policy::kLocal:
+    ptr = largeMallocLocal(bytes);
+    break;
+  }
+  if (!ptr) {
+    return arrow::Status::OutOfMemory(
+        "allocating ", bytes, " bytes of huge pages");
+  }
+
+  *out = static_cast<uint8_t*>(ptr.release());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    large_.emplace(*out, bytes);
+  }
+  int64_t total = large_bytes_.fetch_add(bytes) + bytes;
+  int64_t max = max_memory_.load(std::memory_order_relaxed);
+  while (total > max && !max_memory_.compare_exchange_weak(max, total)) {
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::NumaMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  size_t mapped = LargeSize(*ptr);
+  if (mapped == 0 && static_cast<size_t>(new_size) < allocSize()) {
+    return small_pool_->Reallocate(old_size, new_size, ptr);
+  }
+  if (mapped != 0 && static_cast<size_t>(new_size) <= mapped &&
+      static_cast<size_t>(new_size) >= allocSize()) {
+    return arrow::Status::OK();
+  }
+
+  uint8_t* out{};
+  ARROW_RETURN_NOT_OK(Allocate(new_size, &out));
+  std::memcpy(out, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = out;
+  return arrow::Status::OK();
+}
+
+void
+katana::NumaMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  size_t mapped = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = large_.find(buffer); it != large_.end()) {
+      mapped = it->second;
+      large_.erase(it);
+    }
+  }
+  if (mapped == 0) {
+    small_pool_->Free(buffer, size);
+    return;
+  }
+  internal::largeFreer{mapped}(buffer);
+  large_bytes_.fetch_sub(mapped);
+}
+
+int64_t
+katana::NumaMemoryPool::bytes_allocated() const {
+  return large_bytes_.load(std::memory_order_relaxed) +
+         small_pool_->bytes_allocated();
+}
+
+katana::NumaMemoryPool*
+katana::GetNumaMemoryPool() {
+  // Never destroyed, since buffers may be freed at exit
+  static NumaMemoryPool* pool = new NumaMemoryPool(PolicyFromEnv());
+  return pool;
+}
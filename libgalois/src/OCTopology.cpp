@@ -0,0 +1,230 @@
+#include "katana/OCTopology.h"
+
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "tsuba/tsuba.h"
+
+katana::OCTopology::Binding::Binding(OCTopology* topology, size_t index)
+    : topology_(topology),
+      index_(index),
+      segment_(&topology->segments_[index]),
+      dests_(topology->view_.ptr<Node>(topology->prefix_.view_offset())) {}
+
+katana::OCTopology::Binding::Binding(Binding&& other) noexcept
+    : topology_(other.topology_),
+      index_(other.index_),
+      segment_(other.segment_),
+      dests_(other.dests_) {
+  other.topology_ = nullptr;
+}
+
+katana::OCTopology::Binding&
+katana::OCTopology::Binding::operator=(Binding&& other) noexcept {
+  if (this != &other) {
+    Release();
+    topology_ = other.topology_;
+    index_ = other.index_;
+    segment_ = other.segment_;
+    dests_ = other.dests_;
+    other.topology_ = nullptr;
+  }
+  return *this;
+}
+
+katana::OCTopology::Binding::~Binding() { Release(); }
+
+void
+katana::OCTopology::Binding::Release() {
+  if (topology_) {
+    topology_->Unpin(index_);
+    topology_ = nullptr;
+  }
+}
+
+katana::OCTopology::OCTopology(
+    tsuba::RDGPrefix&& prefix, const OCTopologyOptions& opts)
+    : prefix_(std::move(prefix)), opts_(opts) {}
+
+katana::Result<std::unique_ptr<katana::OCTopology>>
+katana::OCTopology::Make(
+    const std::string& rdg_name, const OCTopologyOptions& opts) {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error();
+  }
+  if (prefix_res.value().topology_path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix_res.value().version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "topologies of version {} are not supported",
+        prefix_res.value().version());
+  }
+
+  std::unique_ptr<OCTopology> topology(
+      new OCTopology(std::move(prefix_res.value()), opts));
+  if (auto res = topology->Init(); !res) {
+    return res.error().WithContext("opening topology of {}", rdg_name);
+  }
+  return std::unique_ptr<OCTopology>(std::move(topology));
+}
+
+katana::Result<void>
+katana::OCTopology::Init() {
+  // Nothing is fetched until segments are bound
+  view_.ExpectChecksum(prefix_.topology_checksum());
+  if (auto res = view_.Bind(prefix_.topology_path(), 0, 0, false); !res) {
+    return res.error();
+  }
+
+  uint64_t num_nodes = prefix_.num_nodes();
+  const uint64_t* out_indexes = prefix_.out_indexes();
+  uint64_t segment_edges = std::max<uint64_t>(opts_.segment_edges, 1);
+  for (uint64_t node_begin = 0; node_begin < num_nodes;) {
+    Edge edge_begin = node_begin > 0 ? out_indexes[node_begin - 1] : 0;
+    // The first node whose edges end past the target, and at least one node
+    uint64_t node_end =
+        std::upper_bound(
+            out_indexes + node_begin, out_indexes + num_nodes,
+            edge_begin + segment_edges) -
+        out_indexes;
+    node_end = std::max(node_end, node_begin + 1);
+    segments_.emplace_back(Segment{
+        static_cast<Node>(node_begin), static_cast<Node>(node_end), edge_begin,
+        out_indexes[node_end - 1]});
+    node_begin = node_end;
+  }
+  residency_.resize(segments_.size());
+  return ResultSuccess();
+}
+
+size_t
+katana::OCTopology::SegmentOf(Node node) const {
+  KATANA_LOG_DEBUG_ASSERT(node < num_nodes());
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), node,
+      [](Node n, const Segment& s) { return n < s.node_end; });
+  return it - segments_.begin();
+}
+
+uint64_t
+katana::OCTopology::FileBegin(size_t i) const {
+  return prefix_.view_offset() + segments_[i].edge_begin * sizeof(Node);
+}
+
+uint64_t
+katana::OCTopology::FileEnd(size_t i) const {
+  return prefix_.view_offset() + segments_[i].edge_end * sizeof(Node);
+}
+
+katana::Result<void>
+katana::OCTopology::MakeResident(size_t i) {
+  Residency& r = residency_[i];
+  if (r.resident) {
+    lru_.splice(lru_.begin(), lru_, r.lru);
+    return ResultSuccess();
+  }
+  if (auto res = view_.Fill(FileBegin(i), FileEnd(i), false); !res) {
+    return res.error();
+  }
+  r.resident = true;
+  r.lru = lru_.insert(lru_.begin(), i);
+  resident_bytes_ += segments_[i].num_edges() * sizeof(Node);
+  return Shrink();
+}
+
+katana::Result<void>
+katana::OCTopology::Shrink() {
+  for (auto it = lru_.end();
+       resident_bytes_ > opts_.memory_budget && it != lru_.begin();) {
+    --it;
+    size_t i = *it;
+    Residency& r = residency_[i];
+    if (r.pins > 0) {
+      continue;
+    }
+    // Pages shared with neighboring segments stay, so segments smaller than
+    // a page of the view are only released along with their neighbors
+    if (auto res = view_.Evict(FileBegin(i), FileEnd(i)); !res) {
+      return res.error().WithContext("evicting segment {}", i);
+    }
+    r.resident = false;
+    it = lru_.erase(it);
+    resident_bytes_ -= segments_[i].num_edges() * sizeof(Node);
+    stats_.evictions += 1;
+  }
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::OCTopology::Fill(size_t i) {
+  if (auto res = MakeResident(i); !res) {
+    return res.error().WithContext("reading segment {}", i);
+  }
+  if (auto res = view_.Fill(FileBegin(i), FileEnd(i), true); !res) {
+    return res.error().WithContext("reading segment {}", i);
+  }
+
+  if (opts_.prefetch && i + 1 < segments_.size() &&
+      !residency_[i + 1].resident) {
+    if (auto res = MakeResident(i + 1); !res) {
+      return res.error().WithContext("prefetching segment {}", i + 1);
+    }
+    stats_.prefetches += 1;
+  }
+  return ResultSuccess();
+}
+
+katana::Result<katana::OCTopology::Binding>
+katana::OCTopology::Bind(size_t index) {
+  KATANA_LOG_DEBUG_ASSERT(index < segments_.size());
+  // The view is not thread safe, so reads wait for each other; bound
+  // segments can be read while others are being bound
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  Residency& r = residency_[index];
+  if (r.resident) {
+    stats_.hits += 1;
+  } else {
+    stats_.misses += 1;
+  }
+  // Pin first so that making room for the prefetch does not release it
+  r.pins += 1;
+  if (auto res = Fill(index); !res) {
+    r.pins -= 1;
+    return res.error();
+  }
+  return Result<Binding>(Binding(this, index));
+}
+
+void
+katana::OCTopology::Unpin(size_t i) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  KATANA_LOG_DEBUG_ASSERT(residency_[i].pins > 0);
+  residency_[i].pins -= 1;
+  // Segments bound beyond the budget are released once they are unbound
+  if (auto res = Shrink(); !res) {
+    KATANA_LOG_WARN("releasing segments: {}", res.error());
+  }
+}
+
+uint64_t
+katana::OCTopology::resident_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return resident_bytes_;
+}
+
+katana::OCTopologyStats
+katana::OCTopology::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
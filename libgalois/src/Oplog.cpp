@@ -0,0 +1,700 @@
+#include "katana/Oplog.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include <arrow/compute/api.h>
+
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::ImportData;
+using katana::ImportDataType;
+using katana::OplogBatch;
+
+/// The last value the batch sets for each property of an element
+using ValueMap = std::unordered_map<std::string, ImportData>;
+/// New values of a property by row, sorted by row
+using ColumnUpdates = std::vector<std::pair<uint64_t, ImportData>>;
+using PropertyTypes = std::map<std::string, arrow::Type::type>;
+
+struct EdgeKeyHash {
+  size_t operator()(const std::pair<Node, Node>& key) const {
+    return std::hash<uint64_t>()((uint64_t{key.first} << 32) | key.second);
+  }
+};
+
+/// What a batch does to the edges from one node to another
+struct EdgeChange {
+  bool delete_existing{false};
+  bool insert{false};
+  /// Index of the op that started the insertion
+  size_t insert_op{0};
+  ValueMap values;
+};
+
+/// The net effect of a batch, with later ops overriding earlier ones
+struct Changes {
+  uint64_t num_nodes{0};
+  /// Index of the last op deleting each node
+  std::unordered_map<Node, size_t> deleted_nodes;
+  std::unordered_map<Node, ValueMap> node_values;
+  /// Values of edges already in the graph, by edge id
+  std::unordered_map<uint64_t, ValueMap> edge_values;
+  std::unordered_map<std::pair<Node, Node>, EdgeChange, EdgeKeyHash> edges;
+  PropertyTypes node_types;
+  PropertyTypes edge_types;
+};
+
+struct InsertedEdge {
+  Node src;
+  Node dest;
+  size_t op;
+  const ValueMap* values;
+};
+
+/// A replacement for the topology of a graph
+struct NewTopology {
+  katana::GraphTopology topology;
+  /// Edge id in the old topology of each edge, or -1 for inserted edges
+  katana::LargeArray<int64_t> source;
+  /// Edge id of each InsertedEdge
+  std::vector<uint64_t> inserted_rows;
+  uint64_t num_removed{0};
+};
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+bool
+DeletedSince(const Changes& changes, Node node, size_t op) {
+  auto it = changes.deleted_nodes.find(node);
+  return it != changes.deleted_nodes.end() && it->second > op;
+}
+
+std::optional<uint64_t>
+FindEdge(const katana::GraphTopology& topology, Node src, Node dest) {
+  if (src >= topology.num_nodes()) {
+    return std::nullopt;
+  }
+  for (auto e : topology.edges(src)) {
+    if (topology.edge_dest(e) == dest) {
+      return e;
+    }
+  }
+  return std::nullopt;
+}
+
+bool
+IsValidAt(const arrow::ChunkedArray& column, uint64_t row) {
+  for (const auto& chunk : column.chunks()) {
+    if (row < static_cast<uint64_t>(chunk->length())) {
+      return chunk->IsValid(row);
+    }
+    row -= chunk->length();
+  }
+  return false;
+}
+
+/// Record values in out and the type of each non-null value in types,
+/// checking it against the type of the property in schema and earlier
+/// values
+katana::Result<void>
+MergeValues(
+    const OplogBatch::Values& values, const arrow::Schema& schema,
+    PropertyTypes* types, ValueMap* out) {
+  for (const auto& [name, value] : values) {
+    if (value.type != ImportDataType::kUnsupported) {
+      auto type_res = katana::ArrowTypeOf(
+          katana::PropertyKey(name, value.type, value.is_list));
+      if (!type_res) {
+        return type_res.error();
+      }
+      arrow::Type::type type = type_res.value();
+      std::shared_ptr<arrow::Field> field = schema.GetFieldByName(name);
+      auto [it, inserted] = types->emplace(name, type);
+      if ((field && field->type()->id() != type) ||
+          (!inserted && it->second != type)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "value of property {} has the wrong type {}", name, value.type);
+      }
+    }
+    out->insert_or_assign(name, value);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<Changes>
+Summarize(const katana::PropertyGraph& pg, const OplogBatch& batch) {
+  const katana::GraphTopology& topology = pg.topology();
+  std::shared_ptr<arrow::Schema> node_schema = pg.node_schema();
+  std::shared_ptr<arrow::Schema> edge_schema = pg.edge_schema();
+
+  Changes changes;
+  changes.num_nodes = topology.num_nodes();
+  auto check_node = [&](Node node) -> katana::Result<void> {
+    if (node >= changes.num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "oplog refers to node {} but the graph has {} nodes", node,
+          changes.num_nodes);
+    }
+    return katana::ResultSuccess();
+  };
+
+  const std::vector<OplogBatch::Op>& ops = batch.ops();
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const OplogBatch::Op& op = ops[i];
+    if (op.type == OplogBatch::OpType::kUpsertNode) {
+      changes.num_nodes = std::max(changes.num_nodes, uint64_t{op.src} + 1);
+      if (auto res = MergeValues(
+              op.values, *node_schema, &changes.node_types,
+              &changes.node_values[op.src]);
+          !res) {
+        return res.error();
+      }
+      continue;
+    }
+
+    if (auto res = check_node(op.src); !res) {
+      return res.error();
+    }
+    if (auto res = check_node(op.dest); !res) {
+      return res.error();
+    }
+    if (op.type == OplogBatch::OpType::kDeleteNode) {
+      changes.deleted_nodes[op.src] = i;
+      changes.node_values.erase(op.src);
+      continue;
+    }
+
+    std::pair<Node, Node> key(op.src, op.dest);
+    auto it = changes.edges.find(key);
+    if (op.type == OplogBatch::OpType::kDeleteEdge) {
+      EdgeChange& change = changes.edges[key];
+      change.delete_existing = true;
+      change.insert = false;
+      change.values.clear();
+      continue;
+    }
+
+    // Deleting an endpoint after an edge was inserted removes the edge
+    EdgeChange* change = it != changes.edges.end() ? &it->second : nullptr;
+    if (change && change->insert &&
+        (DeletedSince(changes, op.src, change->insert_op) ||
+         DeletedSince(changes, op.dest, change->insert_op))) {
+      change->insert = false;
+      change->values.clear();
+    }
+
+    ValueMap* values = nullptr;
+    if ((!change || (!change->insert && !change->delete_existing)) &&
+        changes.deleted_nodes.count(op.src) == 0 &&
+        changes.deleted_nodes.count(op.dest) == 0) {
+      if (auto e = FindEdge(topology, op.src, op.dest)) {
+        values = &changes.edge_values[*e];
+      }
+    }
+    if (!values) {
+      if (!change) {
+        change = &changes.edges[key];
+      }
+      if (!change->insert) {
+        change->insert = true;
+        change->insert_op = i;
+      }
+      values = &change->values;
+    }
+    if (auto res = MergeValues(
+            op.values, *edge_schema, &changes.edge_types, values);
+        !res) {
+      return res.error();
+    }
+  }
+  return katana::Result<Changes>(std::move(changes));
+}
+
+/// Build the topology after the batch, or return nothing if the batch does
+/// not change it
+template <typename Removed>
+katana::Result<std::optional<NewTopology>>
+BuildTopology(
+    const katana::GraphTopology& topology, uint64_t num_nodes,
+    bool may_remove, const Removed& removed,
+    const std::vector<InsertedEdge>& inserted) {
+  uint64_t old_num_nodes = topology.num_nodes();
+  if (!may_remove && inserted.empty() && num_nodes == old_num_nodes) {
+    return std::optional<NewTopology>();
+  }
+
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+
+  auto inserted_range = [&](Node n) {
+    return std::equal_range(
+        inserted.begin(), inserted.end(), InsertedEdge{n, 0, 0, nullptr},
+        [](const InsertedEdge& a, const InsertedEdge& b) {
+          return a.src < b.src;
+        });
+  };
+  auto kept = [&](Node n, uint64_t begin, uint64_t end) {
+    uint64_t count = 0;
+    for (uint64_t e = begin; e < end; ++e) {
+      count += !removed(n, topology.edge_dest(e));
+    }
+    return count;
+  };
+
+  katana::GAccumulator<uint64_t> num_removed;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t count = 0;
+        if (n < old_num_nodes) {
+          auto [begin, end] = topology.edge_range(n);
+          count = may_remove ? kept(n, begin, end) : end - begin;
+          num_removed += end - begin - count;
+        }
+        auto [first, last] = inserted_range(n);
+        indices[n] = count + (last - first);
+      },
+      katana::steal(), katana::no_stats());
+  if (num_removed.reduce() == 0 && inserted.empty() &&
+      num_nodes == old_num_nodes) {
+    return std::optional<NewTopology>();
+  }
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  uint64_t num_edges = num_nodes > 0 ? indices[num_nodes - 1] : 0;
+  auto dests_res = Allocate(num_edges * sizeof(Node), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  auto* dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+
+  NewTopology result;
+  result.num_removed = num_removed.reduce();
+  result.source.allocateInterleaved(num_edges);
+  result.inserted_rows.resize(inserted.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n > 0 ? indices[n - 1] : 0;
+        if (n < old_num_nodes) {
+          for (auto e : topology.edges(n)) {
+            Node dest = topology.edge_dest(e);
+            if (!may_remove || !removed(n, dest)) {
+              dests[out] = dest;
+              result.source[out] = e;
+              ++out;
+            }
+          }
+        }
+        auto [first, last] = inserted_range(n);
+        for (auto it = first; it != last; ++it) {
+          dests[out] = it->dest;
+          result.source[out] = -1;
+          result.inserted_rows[it - inserted.begin()] = out;
+          ++out;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  result.topology = katana::GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .out_dests =
+          std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+  };
+  return std::optional<NewTopology>(std::move(result));
+}
+
+/// Return a column of num_rows rows where row r is updates' value for r if
+/// there is one and otherwise row source[r] of old (row r if source is
+/// null), or null if that row is negative or past the end of old
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+RebuildColumn(
+    const std::string& name, const std::shared_ptr<arrow::ChunkedArray>& old,
+    arrow::Type::type type, uint64_t num_rows, const int64_t* source,
+    const ColumnUpdates& updates) {
+  arrow::ArrayVector chunks;
+  std::shared_ptr<arrow::DataType> data_type;
+  if (old) {
+    chunks = old->chunks();
+    data_type = old->type();
+  }
+  if (!updates.empty()) {
+    std::vector<ImportData> values;
+    values.reserve(updates.size());
+    for (const auto& update : updates) {
+      values.emplace_back(update.second);
+    }
+    auto values_res = katana::ImportToArrow(type, values);
+    if (!values_res) {
+      return values_res.error().WithContext("property {}", name);
+    }
+    std::shared_ptr<arrow::ChunkedArray> array = values_res.value();
+    if (data_type && !data_type->Equals(array->type())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "property {} has type {} but its new values have type {}", name,
+          data_type->ToString(), array->type()->ToString());
+    }
+    data_type = array->type();
+    chunks.insert(chunks.end(), array->chunks().begin(), array->chunks().end());
+  }
+  auto combined = std::make_shared<arrow::ChunkedArray>(chunks, data_type);
+
+  // Each task fills one 64-bit word of the validity bitmap, so tasks do not
+  // share bytes
+  uint64_t num_old = old ? old->length() : 0;
+  uint64_t num_words = (num_rows + 63) / 64;
+  auto take_res = Allocate(num_rows * sizeof(uint64_t), "take indices");
+  if (!take_res) {
+    return take_res.error();
+  }
+  auto valid_res = Allocate(num_words * sizeof(uint64_t), "take indices");
+  if (!valid_res) {
+    return valid_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> take_buffer = take_res.value();
+  std::shared_ptr<arrow::Buffer> valid_buffer = valid_res.value();
+  auto* take = reinterpret_cast<uint64_t*>(take_buffer->mutable_data());
+  auto* valid = reinterpret_cast<uint64_t*>(valid_buffer->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_words),
+      [&](uint64_t w) {
+        uint64_t r = w * 64;
+        uint64_t end = std::min(r + 64, num_rows);
+        auto u = std::lower_bound(
+            updates.begin(), updates.end(), r,
+            [](const auto& update, uint64_t row) {
+              return update.first < row;
+            });
+        uint64_t word = 0;
+        for (; r < end; ++r) {
+          int64_t from = -1;
+          if (u != updates.end() && u->first == r) {
+            from = num_old + (u - updates.begin());
+            ++u;
+          } else if (source) {
+            from = source[r];
+          } else if (r < num_old) {
+            from = r;
+          }
+          if (from >= 0) {
+            take[r] = from;
+            word |= uint64_t{1} << (r % 64);
+          } else {
+            take[r] = 0;
+          }
+        }
+        valid[w] = word;
+      },
+      katana::no_stats());
+
+  auto indices =
+      std::make_shared<arrow::UInt64Array>(num_rows, take_buffer, valid_buffer);
+  auto res = arrow::compute::Take(combined, indices);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "rebuilding property {}: {}", name,
+        res.status());
+  }
+  return res.ValueOrDie().chunked_array();
+}
+
+/// The rebuilt columns of one kind of property
+struct NewColumns {
+  std::vector<std::string> replaced;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+};
+
+/// Rebuild the properties in view that have updates, or all of them if
+/// rebuild_all, and add columns for new properties in types
+katana::Result<NewColumns>
+RebuildColumns(
+    const katana::PropertyGraph::PropertyView& view,
+    const PropertyTypes& types, std::map<std::string, ColumnUpdates>* updates,
+    bool rebuild_all, uint64_t num_rows, const int64_t* source) {
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+  NewColumns result;
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    std::shared_ptr<arrow::Field> field = schema->field(i);
+    auto it = updates->find(field->name());
+    if (!rebuild_all && it == updates->end()) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> old = view.Property(i);
+    if (!old) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading property {}",
+          field->name());
+    }
+    ColumnUpdates empty;
+    auto column_res = RebuildColumn(
+        field->name(), old, field->type()->id(), num_rows, source,
+        it != updates->end() ? it->second : empty);
+    if (!column_res) {
+      return column_res.error();
+    }
+    result.replaced.emplace_back(field->name());
+    result.fields.emplace_back(field);
+    result.columns.emplace_back(std::move(column_res.value()));
+    if (it != updates->end()) {
+      updates->erase(it);
+    }
+  }
+
+  // Properties that only ever get null values have no type and are skipped
+  for (const auto& [name, column_updates] : *updates) {
+    auto type_it = types.find(name);
+    if (type_it == types.end()) {
+      continue;
+    }
+    auto column_res = RebuildColumn(
+        name, nullptr, type_it->second, num_rows, nullptr, column_updates);
+    if (!column_res) {
+      return column_res.error();
+    }
+    result.fields.emplace_back(
+        arrow::field(name, column_res.value()->type()));
+    result.columns.emplace_back(std::move(column_res.value()));
+  }
+  return katana::Result<NewColumns>(std::move(result));
+}
+
+void
+SortUpdates(std::map<std::string, ColumnUpdates>* updates) {
+  for (auto& [name, column_updates] : *updates) {
+    std::sort(
+        column_updates.begin(), column_updates.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+  }
+}
+
+std::vector<std::string>
+LoadedNames(
+    const arrow::Schema& schema,
+    const std::map<std::string, ColumnUpdates>& updates, bool all) {
+  std::vector<std::string> names;
+  for (const auto& field : schema.fields()) {
+    if (all || updates.count(field->name()) > 0) {
+      names.emplace_back(field->name());
+    }
+  }
+  return names;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::ApplyOplogBatch(PropertyGraph* pg, const OplogBatch& batch) {
+  if (batch.empty()) {
+    return ResultSuccess();
+  }
+  auto changes_res = Summarize(*pg, batch);
+  if (!changes_res) {
+    return changes_res.error();
+  }
+  Changes& changes = changes_res.value();
+
+  const GraphTopology& topology = pg->topology();
+  uint64_t old_num_nodes = topology.num_nodes();
+  uint64_t num_nodes = changes.num_nodes;
+
+  // Flag deleted nodes and sources of deleted edges so that most edges are
+  // checked without a hash lookup
+  std::vector<uint8_t> deleted(num_nodes, 0);
+  std::vector<uint8_t> has_deleted_edges(num_nodes, 0);
+  bool may_remove = !changes.deleted_nodes.empty();
+  for (const auto& [node, op] : changes.deleted_nodes) {
+    deleted[node] = 1;
+  }
+  std::vector<InsertedEdge> inserted;
+  for (const auto& [key, change] : changes.edges) {
+    if (change.delete_existing) {
+      has_deleted_edges[key.first] = 1;
+      may_remove = true;
+    }
+    if (change.insert && !DeletedSince(changes, key.first, change.insert_op) &&
+        !DeletedSince(changes, key.second, change.insert_op)) {
+      inserted.emplace_back(InsertedEdge{
+          key.first, key.second, change.insert_op, &change.values});
+    }
+  }
+  std::sort(
+      inserted.begin(), inserted.end(),
+      [](const InsertedEdge& a, const InsertedEdge& b) {
+        return a.src < b.src || (a.src == b.src && a.op < b.op);
+      });
+
+  auto removed = [&](Node src, Node dest) {
+    if (deleted[src] || deleted[dest]) {
+      return true;
+    }
+    if (!has_deleted_edges[src]) {
+      return false;
+    }
+    auto it = changes.edges.find({src, dest});
+    return it != changes.edges.end() && it->second.delete_existing;
+  };
+
+  auto new_topology_res =
+      BuildTopology(topology, num_nodes, may_remove, removed, inserted);
+  if (!new_topology_res) {
+    return new_topology_res.error();
+  }
+  std::optional<NewTopology>& new_topology = new_topology_res.value();
+
+  // Gather the new values of each property by row
+  std::map<std::string, ColumnUpdates> node_updates;
+  for (const auto& [node, values] : changes.node_values) {
+    for (const auto& [name, value] : values) {
+      node_updates[name].emplace_back(node, value);
+    }
+  }
+
+  std::map<std::string, ColumnUpdates> edge_updates;
+  const uint64_t* old_indices =
+      old_num_nodes > 0 ? topology.out_indices->raw_values() : nullptr;
+  for (const auto& [e, values] : changes.edge_values) {
+    uint64_t row = e;
+    if (new_topology) {
+      // Edges keep their order among the remaining edges of their source
+      Node src = std::upper_bound(old_indices, old_indices + old_num_nodes, e) -
+                 old_indices;
+      if (removed(src, topology.edge_dest(e))) {
+        continue;
+      }
+      row = new_topology->topology.edge_range(src).first;
+      for (uint64_t other : topology.edges(src)) {
+        if (other == e) {
+          break;
+        }
+        row += !removed(src, topology.edge_dest(other));
+      }
+    }
+    for (const auto& [name, value] : values) {
+      edge_updates[name].emplace_back(row, value);
+    }
+  }
+  for (size_t i = 0; i < inserted.size(); ++i) {
+    for (const auto& [name, value] : *inserted[i].values) {
+      edge_updates[name].emplace_back(new_topology->inserted_rows[i], value);
+    }
+  }
+
+  bool resized = num_nodes != old_num_nodes;
+  std::shared_ptr<arrow::Schema> node_schema = pg->node_schema();
+  std::shared_ptr<arrow::Schema> edge_schema = pg->edge_schema();
+  bool load_all_nodes = resized || !changes.deleted_nodes.empty();
+  if (auto res = pg->EnsureNodePropertiesLoaded(
+          LoadedNames(*node_schema, node_updates, load_all_nodes));
+      !res) {
+    return res.error();
+  }
+  if (auto res = pg->EnsureEdgePropertiesLoaded(
+          LoadedNames(*edge_schema, edge_updates, new_topology.has_value()));
+      !res) {
+    return res.error();
+  }
+
+  // Null the properties of deleted nodes that the batch does not set again
+  for (const auto& [node, op] : changes.deleted_nodes) {
+    if (node >= old_num_nodes) {
+      continue;
+    }
+    const ValueMap* values = nullptr;
+    if (auto it = changes.node_values.find(node);
+        it != changes.node_values.end()) {
+      values = &it->second;
+    }
+    for (const auto& field : node_schema->fields()) {
+      if (values && values->count(field->name()) > 0) {
+        continue;
+      }
+      if (IsValidAt(*pg->GetNodeProperty(field->name()), node)) {
+        node_updates[field->name()].emplace_back(
+            node, ImportData(ImportDataType::kUnsupported, false));
+      }
+    }
+  }
+  SortUpdates(&node_updates);
+  SortUpdates(&edge_updates);
+
+  auto node_columns_res = RebuildColumns(
+      pg->node_property_view(), changes.node_types, &node_updates, resized,
+      num_nodes, nullptr);
+  if (!node_columns_res) {
+    return node_columns_res.error();
+  }
+  uint64_t num_edges = new_topology ? new_topology->topology.num_edges()
+                                    : topology.num_edges();
+  auto edge_columns_res = RebuildColumns(
+      pg->edge_property_view(), changes.edge_types, &edge_updates,
+      new_topology.has_value(), num_edges,
+      new_topology ? new_topology->source.data() : nullptr);
+  if (!edge_columns_res) {
+    return edge_columns_res.error();
+  }
+  NewColumns& node_columns = node_columns_res.value();
+  NewColumns& edge_columns = edge_columns_res.value();
+
+  pg->AddProvenance("oplog_ops", std::to_string(batch.size()));
+  pg->AddProvenance(
+      "oplog_added_nodes", std::to_string(num_nodes - old_num_nodes));
+  pg->AddProvenance(
+      "oplog_deleted_nodes", std::to_string(changes.deleted_nodes.size()));
+  pg->AddProvenance("oplog_added_edges", std::to_string(inserted.size()));
+  pg->AddProvenance(
+      "oplog_removed_edges",
+      std::to_string(new_topology ? new_topology->num_removed : 0));
+
+  if (new_topology) {
+    if (auto res = pg->SetTopology(new_topology->topology); !res) {
+      return res.error();
+    }
+  }
+  for (const std::string& name : node_columns.replaced) {
+    if (auto res = pg->RemoveNodeProperty(name); !res) {
+      return res.error();
+    }
+  }
+  for (const std::string& name : edge_columns.replaced) {
+    if (auto res = pg->RemoveEdgeProperty(name); !res) {
+      return res.error();
+    }
+  }
+  if (auto res = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema(node_columns.fields), node_columns.columns));
+      !res) {
+    return res.error();
+  }
+  return pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(edge_columns.fields), edge_columns.columns));
+}
@@ -19,8 +19,12 @@
 
 #include "katana/PageAlloc.h"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <string>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 
@@ -65,11 +69,104 @@ static const bool doHandMap = true;
 #ifdef MAP_HUGETLB
 static const int _MAP_HUGE_POP = MAP_HUGETLB | _MAP_POP;
 static const int _MAP_HUGE = MAP_HUGETLB | _MAP;
+static const bool hasHugeTLB = true;
 #else
 static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE = _MAP;
+static const bool hasHugeTLB = false;
 #endif
 
+namespace {
+
+std::atomic<uint64_t> explicit_huge_pages;
+std::atomic<uint64_t> transparent_huge_pages;
+std::atomic<uint64_t> regular_pages;
+std::atomic<uint64_t> explicit_huge_failures;
+
+katana::HugePageMode
+DefaultHugePageMode() {
+  std::string mode;
+  if (!katana::GetEnv("KATANA_HUGE_PAGES", &mode) || mode == "explicit") {
+    return katana::HugePageMode::kExplicit;
+  }
+  if (mode == "transparent") {
+    return katana::HugePageMode::kTransparent;
+  }
+  if (mode != "off") {
+    KATANA_LOG_WARN(
+        "unknown KATANA_HUGE_PAGES value {}; expected off, transparent or "
+        "explicit",
+        mode);
+  }
+  return katana::HugePageMode::kOff;
+}
+
+std::atomic<katana::HugePageMode>&
+HugePageModeRef() {
+  static std::atomic<katana::HugePageMode> mode{DefaultHugePageMode()};
+  return mode;
+}
+
+/// Map size bytes (a multiple of hugePageSize) aligned to hugePageSize and
+/// ask the kernel to back them with transparent huge pages. The mapping is
+/// not prefaulted: faults taken before madvise would be served with regular
+/// pages.
+void*
+TryTransparentMmap(size_t size) {
+  char* raw = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!raw) {
+    return nullptr;
+  }
+
+  // Only whole aligned 2MB ranges can be backed by huge pages, so trim the
+  // mapping to an aligned range
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  size_t head = (hugePageSize - addr % hugePageSize) % hugePageSize;
+  size_t tail = hugePageSize - head;
+  {
+    std::lock_guard<katana::SimpleLock> lg(allocLock);
+    if (head) {
+      munmap(raw, head);
+    }
+    if (tail) {
+      munmap(raw + head + size, tail);
+    }
+  }
+  char* ptr = raw + head;
+
+#ifdef MADV_HUGEPAGE
+  if (madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+    transparent_huge_pages += size / hugePageSize;
+    return ptr;
+  }
+  KATANA_DEBUG_WARN_ONCE("madvise(MADV_HUGEPAGE) failed; using regular pages");
+#endif
+  regular_pages += size / hugePageSize;
+  return ptr;
+}
+
+}  // namespace
+
+void
+katana::SetHugePageMode(HugePageMode mode) {
+  HugePageModeRef() = mode;
+}
+
+katana::HugePageMode
+katana::GetHugePageMode() {
+  return HugePageModeRef();
+}
+
+katana::PageAllocCounts
+katana::GetPageAllocCounts() {
+  return PageAllocCounts{
+      .explicit_huge = explicit_huge_pages,
+      .transparent_huge = transparent_huge_pages,
+      .regular = regular_pages,
+      .explicit_huge_failures = explicit_huge_failures,
+  };
+}
+
 size_t
 katana::allocSize() {
   return hugePageSize;
@@ -81,19 +178,41 @@ katana::allocPages(unsigned num, bool preFault) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  size_t size = num * hugePageSize;
+  HugePageMode mode = GetHugePageMode();
+  void* ptr = nullptr;
+  bool hand_map = preFault && doHandMap;
+
+  if (mode == HugePageMode::kExplicit && hasHugeTLB) {
+    ptr = trymmap(size, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    if (ptr) {
+      explicit_huge_pages += num;
+    } else {
+      explicit_huge_failures += num;
+      KATANA_DEBUG_WARN_ONCE(
+          "explicit huge page alloc failed, falling back to transparent huge "
+          "pages");
+    }
+  }
+
+  if (!ptr && mode != HugePageMode::kOff) {
+    ptr = TryTransparentMmap(size);
+    hand_map = preFault;
+  }
+
   if (!ptr) {
-    KATANA_DEBUG_WARN_ONCE(
-        "huge page alloc failed, falling back to regular pages");
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    ptr = trymmap(size, preFault ? _MAP_POP : _MAP);
+    if (ptr) {
+      regular_pages += num;
+    }
   }
 
   if (!ptr) {
     KATANA_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
-    for (size_t x = 0; x < num * hugePageSize; x += 4096) {
+  if (hand_map) {
+    for (size_t x = 0; x < size; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
   }
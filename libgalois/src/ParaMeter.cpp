@@ -17,10 +17,17 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "katana/ParaMeter.h"
+
+#include <algorithm>
 #include <ctime>
+#include <iterator>
+#include <map>
+#include <mutex>
 
 #include "katana/Env.h"
 #include "katana/Executor_ParaMeter.h"
+#include "katana/Statistics.h"
 #include "katana/gIO.h"
 
 struct StatsFileManager {
@@ -98,3 +105,153 @@ void
 katana::parameter::closeStatsFile(void) {
   getStatsFileManager().close();
 }
+
+bool
+katana::parameter::internal::IsStatsFileSet() {
+  return katana::GetEnv("KATANA_PARAMETER_OUTFILE");
+}
+
+namespace {
+
+thread_local katana::parameter::ProfileScope* current_scope = nullptr;
+
+/// The profiles of all scopes so far, by loop
+struct ProfileTotals {
+  struct Totals {
+    uint64_t steps{0};
+    uint64_t work{0};
+    uint64_t committed{0};
+    uint64_t max_parallelism{0};
+  };
+
+  std::mutex mutex;
+  std::map<std::string, Totals> loops;
+
+  void Add(const katana::parameter::LoopProfile& profile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Totals& t = loops[profile.loopname];
+    t.steps += profile.steps.size();
+    for (const auto& step : profile.steps) {
+      t.work += step.work;
+      t.committed += step.committed;
+    }
+    t.max_parallelism = std::max(t.max_parallelism, profile.MaxParallelism());
+  }
+};
+
+ProfileTotals&
+GetProfileTotals() {
+  static ProfileTotals totals;
+  return totals;
+}
+
+}  // namespace
+
+uint64_t
+katana::parameter::LoopProfile::TotalWork() const {
+  uint64_t total = 0;
+  for (const Step& s : steps) {
+    total += s.work;
+  }
+  return total;
+}
+
+uint64_t
+katana::parameter::LoopProfile::MaxParallelism() const {
+  uint64_t max = 0;
+  for (const Step& s : steps) {
+    max = std::max(max, s.committed);
+  }
+  return max;
+}
+
+double
+katana::parameter::LoopProfile::MeanParallelism() const {
+  if (steps.empty()) {
+    return 0;
+  }
+  uint64_t committed = 0;
+  for (const Step& s : steps) {
+    committed += s.committed;
+  }
+  return static_cast<double>(committed) / steps.size();
+}
+
+double
+katana::parameter::LoopProfile::ConflictRatio() const {
+  uint64_t work = TotalWork();
+  if (work == 0) {
+    return 0;
+  }
+  uint64_t committed = 0;
+  for (const Step& s : steps) {
+    committed += s.committed;
+  }
+  return static_cast<double>(work - committed) / work;
+}
+
+katana::parameter::ProfileScope::ProfileScope(bool enable)
+    : prev_(current_scope), enabled_(enable) {
+  if (enabled_) {
+    current_scope = this;
+  }
+}
+
+katana::parameter::ProfileScope::~ProfileScope() {
+  if (!enabled_) {
+    return;
+  }
+  current_scope = prev_;
+  for (const LoopProfile& p : profiles_) {
+    GetProfileTotals().Add(p);
+  }
+}
+
+void
+katana::parameter::ProfileScope::AddStep(
+    const char* loopname, LoopProfile::Step step) {
+  auto it = std::find_if(
+      profiles_.begin(), profiles_.end(),
+      [loopname](const LoopProfile& p) { return p.loopname == loopname; });
+  if (it == profiles_.end()) {
+    profiles_.emplace_back(LoopProfile{loopname, {}});
+    it = std::prev(profiles_.end());
+  }
+  it->steps.emplace_back(step);
+}
+
+katana::parameter::ProfileScope*
+katana::parameter::CurrentProfileScope() {
+  return current_scope;
+}
+
+katana::parameter::internal::SuspendProfile::SuspendProfile()
+    : prev_(current_scope) {
+  current_scope = nullptr;
+}
+
+katana::parameter::internal::SuspendProfile::~SuspendProfile() {
+  current_scope = prev_;
+}
+
+void
+katana::parameter::ReportParallelismProfiles() {
+  ProfileTotals& totals = GetProfileTotals();
+  std::lock_guard<std::mutex> lock(totals.mutex);
+  for (const auto& [loopname, t] : totals.loops) {
+    if (t.steps == 0) {
+      continue;
+    }
+    katana::ReportStatSingle(loopname, "ParallelismSteps", t.steps);
+    katana::ReportStatSingle(loopname, "ParallelismWork", t.work);
+    katana::ReportStatSingle(loopname, "ParallelismMax", t.max_parallelism);
+    katana::ReportStatSingle(
+        loopname, "ParallelismMean",
+        static_cast<double>(t.committed) / t.steps);
+    katana::ReportStatSingle(
+        loopname, "ConflictRatio",
+        t.work == 0 ? 0.0
+                    : static_cast<double>(t.work - t.committed) / t.work);
+  }
+  totals.loops.clear();
+}
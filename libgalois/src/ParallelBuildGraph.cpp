@@ -0,0 +1,444 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/BuildGraph.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
+
+using katana::ImportData;
+using katana::ImportDataType;
+using katana::ParallelPropertyGraphBuilder;
+
+namespace {
+
+constexpr uint32_t kLogNumShards = 8;
+constexpr size_t kNumShards = size_t{1} << kLogNumShards;
+
+// Until Finish numbers the nodes, a node is known by a key holding the
+// thread whose buffer it belongs to and its index among that thread's nodes
+constexpr uint32_t kThreadShift = 48;
+constexpr uint64_t kLocalMask = (uint64_t{1} << kThreadShift) - 1;
+
+uint64_t
+MakeNodeKey(unsigned tid, uint64_t local) {
+  return (uint64_t{tid} << kThreadShift) | local;
+}
+
+struct alignas(katana::KATANA_CACHE_LINE_SIZE) IdShard {
+  katana::SimpleLock lock;
+  std::unordered_map<std::string, uint64_t> ids;
+};
+
+/// The property values and labels of the nodes or edges added by one thread
+struct ElementBuffer {
+  //! (row, value) pairs for each property
+  std::vector<std::vector<std::pair<uint64_t, ImportData>>> values;
+  //! The rows that have each label
+  std::vector<std::vector<uint64_t>> labels;
+
+  void Add(
+      uint64_t row, const ParallelPropertyGraphBuilder::PropertyValues& vals,
+      const ParallelPropertyGraphBuilder::Labels& label_indexes) {
+    for (const auto& [index, value] : vals) {
+      if (index >= values.size()) {
+        values.resize(index + 1);
+      }
+      values[index].emplace_back(row, value);
+    }
+    for (size_t index : label_indexes) {
+      if (index >= labels.size()) {
+        labels.resize(index + 1);
+      }
+      labels[index].emplace_back(row);
+    }
+  }
+};
+
+struct ThreadBuffer {
+  //! Nodes added by AddNode
+  uint64_t num_added_nodes{0};
+  //! Nodes added by AddNode and placeholders
+  uint64_t num_nodes{0};
+  ElementBuffer nodes;
+  ElementBuffer edges;
+  std::vector<std::string> sources;
+  std::vector<std::string> targets;
+  std::vector<uint64_t> source_keys;
+  std::vector<uint64_t> target_keys;
+};
+
+/// Prefix sums of per-thread counts; the last entry is the total
+template <typename F>
+std::vector<uint64_t>
+ThreadOffsets(katana::PerThreadStorage<ThreadBuffer>* buffers, const F& count) {
+  std::vector<uint64_t> offsets(buffers->size() + 1, 0);
+  for (unsigned t = 0; t < buffers->size(); ++t) {
+    offsets[t + 1] = offsets[t] + count(*buffers->getRemote(t));
+  }
+  return offsets;
+}
+
+}  // namespace
+
+struct ParallelPropertyGraphBuilder::Impl {
+  std::unique_ptr<IdShard[]> shards{std::make_unique<IdShard[]>(kNumShards)};
+  katana::PerThreadStorage<ThreadBuffer> buffers;
+
+  struct Property {
+    katana::PropertyKey key;
+    arrow::Type::type arrow_type;
+  };
+  std::vector<Property> node_properties;
+  std::vector<Property> edge_properties;
+  std::vector<std::string> node_labels;
+  std::vector<std::string> edge_types;
+
+  IdShard& ShardFor(const std::string& id) const {
+    // The low bits of the hashes pick buckets of the maps inside a shard, so
+    // pick the shard with the high bits of a multiplicative hash
+    size_t hash = std::hash<std::string>()(id);
+    return shards[(hash * 0x9e3779b97f4a7c15ULL) >> (64 - kLogNumShards)];
+  }
+
+  /// The key of the node with id, adding a placeholder node to the buffer of
+  /// the calling thread if there is none
+  uint64_t Resolve(const std::string& id) {
+    ThreadBuffer& buffer = *buffers.getLocal();
+    IdShard& shard = ShardFor(id);
+    std::lock_guard<katana::SimpleLock> guard(shard.lock);
+    auto [it, inserted] = shard.ids.try_emplace(
+        id, MakeNodeKey(katana::ThreadPool::getTID(), buffer.num_nodes));
+    if (inserted) {
+      ++buffer.num_nodes;
+    }
+    return it->second;
+  }
+
+  katana::Result<std::shared_ptr<arrow::Table>> BuildProperties(
+      const std::vector<Property>& properties,
+      ElementBuffer ThreadBuffer::*part,
+      uint64_t num_rows, const std::vector<uint64_t>& offsets,
+      const std::vector<uint64_t>* positions);
+
+  std::shared_ptr<arrow::Table> BuildLabels(
+      const std::vector<std::string>& labels,
+      ElementBuffer ThreadBuffer::*part,
+      uint64_t num_rows, const std::vector<uint64_t>& offsets,
+      const std::vector<uint64_t>* positions);
+};
+
+// The row of the value at local row r of thread t is offsets[t] + r, and
+// (*positions)[offsets[t] + r] if positions is not null
+katana::Result<std::shared_ptr<arrow::Table>>
+ParallelPropertyGraphBuilder::Impl::BuildProperties(
+    const std::vector<Property>& properties, ElementBuffer ThreadBuffer::*part,
+    uint64_t num_rows, const std::vector<uint64_t>& offsets,
+    const std::vector<uint64_t>* positions) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+
+  for (size_t p = 0; p < properties.size(); ++p) {
+    const Property& property = properties[p];
+    std::vector<ImportData> column(
+        num_rows, ImportData(ImportDataType::kUnsupported, false));
+    katana::GReduceLogicalOr wrong_type;
+    for (unsigned t = 0; t < buffers.size(); ++t) {
+      const ElementBuffer& buffer = (*buffers.getRemote(t)).*part;
+      if (p >= buffer.values.size()) {
+        continue;
+      }
+      const auto& values = buffer.values[p];
+      katana::do_all(
+          katana::iterate(size_t{0}, values.size()),
+          [&](size_t i) {
+            const auto& [row, value] = values[i];
+            if (value.type != property.key.type || value.is_list) {
+              wrong_type.update(true);
+              return;
+            }
+            uint64_t r = offsets[t] + row;
+            column[positions ? (*positions)[r] : r] = value;
+          },
+          katana::no_stats());
+    }
+    if (wrong_type.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "value of property {} does not have type {}", property.key.name,
+          property.key.type);
+    }
+
+    auto array_result = katana::ImportToArrow(property.arrow_type, column);
+    if (!array_result) {
+      return array_result.error();
+    }
+    columns.emplace_back(array_result.value());
+    fields.emplace_back(
+        arrow::field(property.key.name, array_result.value()->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+std::shared_ptr<arrow::Table>
+ParallelPropertyGraphBuilder::Impl::BuildLabels(
+    const std::vector<std::string>& labels, ElementBuffer ThreadBuffer::*part,
+    uint64_t num_rows, const std::vector<uint64_t>& offsets,
+    const std::vector<uint64_t>* positions) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+
+  for (size_t l = 0; l < labels.size(); ++l) {
+    std::vector<uint8_t> flags(num_rows, 0);
+    for (unsigned t = 0; t < buffers.size(); ++t) {
+      const ElementBuffer& buffer = (*buffers.getRemote(t)).*part;
+      if (l >= buffer.labels.size()) {
+        continue;
+      }
+      const auto& rows = buffer.labels[l];
+      katana::do_all(
+          katana::iterate(size_t{0}, rows.size()),
+          [&](size_t i) {
+            uint64_t r = offsets[t] + rows[i];
+            flags[positions ? (*positions)[r] : r] = 1;
+          },
+          katana::no_stats());
+    }
+
+    arrow::BooleanBuilder builder;
+    if (auto st = builder.AppendValues(flags.data(), flags.size()); !st.ok()) {
+      KATANA_LOG_FATAL(
+          "Error building label {}: {}", labels[l], st.ToString());
+    }
+    std::shared_ptr<arrow::Array> array;
+    if (auto st = builder.Finish(&array); !st.ok()) {
+      KATANA_LOG_FATAL(
+          "Error building label {}: {}", labels[l], st.ToString());
+    }
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
+    fields.emplace_back(arrow::field(labels[l], arrow::boolean()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+ParallelPropertyGraphBuilder::ParallelPropertyGraphBuilder()
+    : impl_(std::make_unique<Impl>()) {}
+
+ParallelPropertyGraphBuilder::~ParallelPropertyGraphBuilder() = default;
+
+katana::Result<size_t>
+ParallelPropertyGraphBuilder::AddBuilder(const PropertyKey& key) {
+  auto type_result = katana::ArrowTypeOf(key);
+  if (!type_result) {
+    return type_result.error();
+  }
+  auto& properties =
+      key.for_node ? impl_->node_properties : impl_->edge_properties;
+  properties.emplace_back(Impl::Property{key, type_result.value()});
+  return properties.size() - 1;
+}
+
+size_t
+ParallelPropertyGraphBuilder::AddLabelBuilder(const LabelRule& rule) {
+  auto& labels = rule.for_node ? impl_->node_labels : impl_->edge_types;
+  auto it = std::find(labels.begin(), labels.end(), rule.label);
+  if (it != labels.end()) {
+    return it - labels.begin();
+  }
+  labels.emplace_back(rule.label);
+  return labels.size() - 1;
+}
+
+bool
+ParallelPropertyGraphBuilder::AddNode(
+    const std::string& id, const PropertyValues& values,
+    const Labels& labels) {
+  ThreadBuffer& buffer = *impl_->buffers.getLocal();
+  uint64_t row = buffer.num_nodes;
+  IdShard& shard = impl_->ShardFor(id);
+  {
+    std::lock_guard<katana::SimpleLock> guard(shard.lock);
+    auto [it, inserted] = shard.ids.try_emplace(
+        id, MakeNodeKey(katana::ThreadPool::getTID(), row));
+    if (!inserted) {
+      return false;
+    }
+  }
+  buffer.nodes.Add(row, values, labels);
+  ++buffer.num_nodes;
+  ++buffer.num_added_nodes;
+  return true;
+}
+
+void
+ParallelPropertyGraphBuilder::AddEdge(
+    const std::string& source, const std::string& target,
+    const PropertyValues& values, const Labels& types) {
+  ThreadBuffer& buffer = *impl_->buffers.getLocal();
+  buffer.edges.Add(buffer.sources.size(), values, types);
+  buffer.sources.emplace_back(source);
+  buffer.targets.emplace_back(target);
+}
+
+size_t
+ParallelPropertyGraphBuilder::GetNodes() const {
+  size_t nodes = 0;
+  for (unsigned t = 0; t < impl_->buffers.size(); ++t) {
+    nodes += impl_->buffers.getRemote(t)->num_added_nodes;
+  }
+  return nodes;
+}
+
+size_t
+ParallelPropertyGraphBuilder::GetEdges() const {
+  size_t edges = 0;
+  for (unsigned t = 0; t < impl_->buffers.size(); ++t) {
+    edges += impl_->buffers.getRemote(t)->sources.size();
+  }
+  return edges;
+}
+
+katana::Result<katana::GraphComponents>
+ParallelPropertyGraphBuilder::Finish() {
+  std::unique_ptr<Impl> impl = std::move(impl_);
+  impl_ = std::make_unique<Impl>();
+  auto& buffers = impl->buffers;
+  unsigned num_buffers = buffers.size();
+
+  // Resolve edge endpoints to node keys; the string IDs are not needed after
+  for (unsigned t = 0; t < num_buffers; ++t) {
+    ThreadBuffer& buffer = *buffers.getRemote(t);
+    buffer.source_keys.resize(buffer.sources.size());
+    buffer.target_keys.resize(buffer.targets.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, buffer.sources.size()),
+        [&](size_t i) {
+          buffer.target_keys[i] = impl->Resolve(buffer.targets[i]);
+          buffer.source_keys[i] = impl->Resolve(buffer.sources[i]);
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ResolveEndpoints"));
+    std::vector<std::string>().swap(buffer.sources);
+    std::vector<std::string>().swap(buffer.targets);
+  }
+  impl->shards.reset();
+
+  std::vector<uint64_t> node_offsets = ThreadOffsets(
+      &buffers, [](const ThreadBuffer& b) { return b.num_nodes; });
+  std::vector<uint64_t> edge_offsets = ThreadOffsets(
+      &buffers, [](const ThreadBuffer& b) { return b.source_keys.size(); });
+  uint64_t num_nodes = node_offsets.back();
+  uint64_t num_edges = edge_offsets.back();
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "too many nodes: {}", num_nodes);
+  }
+
+  auto node_index = [&](uint64_t key) {
+    return static_cast<uint32_t>(
+        node_offsets[key >> kThreadShift] + (key & kLocalMask));
+  };
+
+  // Flatten the endpoints in order of edge ID, which is the order of
+  // threads and then of addition
+  std::vector<uint32_t> sources(num_edges);
+  std::vector<uint32_t> targets(num_edges);
+  for (unsigned t = 0; t < num_buffers; ++t) {
+    ThreadBuffer& buffer = *buffers.getRemote(t);
+    katana::do_all(
+        katana::iterate(size_t{0}, buffer.source_keys.size()),
+        [&](size_t i) {
+          sources[edge_offsets[t] + i] = node_index(buffer.source_keys[i]);
+          targets[edge_offsets[t] + i] = node_index(buffer.target_keys[i]);
+        },
+        katana::no_stats());
+    std::vector<uint64_t>().swap(buffer.source_keys);
+    std::vector<uint64_t>().swap(buffer.target_keys);
+  }
+
+  // CSR: count the edges of each node, prefix sum, then scatter edges and
+  // restore the order of edge IDs within each node
+  std::vector<uint64_t> out_indices(num_nodes, 0);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __atomic_fetch_add(&out_indices[sources[e]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats(), katana::loopname("CountEdges"));
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  auto edge_begin = [&](uint32_t n) { return n ? out_indices[n - 1] : 0; };
+
+  std::vector<uint64_t> edge_ids(num_edges);
+  {
+    std::vector<uint64_t> cursors(num_nodes, 0);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          uint32_t src = sources[e];
+          uint64_t offset =
+              __atomic_fetch_add(&cursors[src], 1, __ATOMIC_RELAXED);
+          edge_ids[edge_begin(src) + offset] = e;
+        },
+        katana::no_stats(), katana::loopname("ScatterEdges"));
+  }
+
+  std::vector<uint32_t> out_dests(num_edges);
+  std::vector<uint64_t> positions(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = edge_begin(n);
+        uint64_t end = out_indices[n];
+        std::sort(edge_ids.begin() + begin, edge_ids.begin() + end);
+        for (uint64_t p = begin; p < end; ++p) {
+          out_dests[p] = targets[edge_ids[p]];
+          positions[edge_ids[p]] = p;
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("SortEdges"));
+
+  auto node_properties = impl->BuildProperties(
+      impl->node_properties, &ThreadBuffer::nodes, num_nodes, node_offsets,
+      nullptr);
+  if (!node_properties) {
+    return node_properties.error();
+  }
+  auto edge_properties = impl->BuildProperties(
+      impl->edge_properties, &ThreadBuffer::edges, num_edges, edge_offsets,
+      &positions);
+  if (!edge_properties) {
+    return edge_properties.error();
+  }
+  auto node_labels = impl->BuildLabels(
+      impl->node_labels, &ThreadBuffer::nodes, num_nodes, node_offsets,
+      nullptr);
+  auto edge_types = impl->BuildLabels(
+      impl->edge_types, &ThreadBuffer::edges, num_edges, edge_offsets,
+      &positions);
+
+  auto topology = std::make_shared<katana::GraphTopology>();
+  topology->out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+      katana::BuildArray(out_indices));
+  topology->out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+      katana::BuildArray(out_dests));
+
+  return katana::GraphComponents{
+      katana::GraphComponent{node_properties.value(), node_labels},
+      katana::GraphComponent{edge_properties.value(), edge_types}, topology};
+}
@@ -43,9 +43,8 @@ katana::getPPSBackend() {
 
 const size_t ptAllocSize = katana::allocSize();
 inline void*
-alloc() {
-  // alloc a single page, don't prefault
-  void* toReturn = katana::allocPages(1, true);
+alloc(bool preFault = true) {
+  void* toReturn = katana::allocPages(1, preFault);
   if (toReturn == nullptr) {
     KATANA_DIE("per-thread storage out of memory");
   }
@@ -152,6 +151,11 @@ katana::PerBackend::deallocOffset(const unsigned offset, const unsigned sz) {
 
 void*
 katana::PerBackend::getRemote(unsigned thread, unsigned offset) {
+  return getMachineRemote(slot(thread), offset);
+}
+
+void*
+katana::PerBackend::getMachineRemote(unsigned thread, unsigned offset) {
   char* rbase = heads[thread].load(std::memory_order_relaxed);
   KATANA_LOG_DEBUG_ASSERT(rbase);
   return &rbase[offset];
@@ -162,12 +166,17 @@ katana::PerBackend::initCommon(unsigned maxT) {
   if (!heads) {
     KATANA_LOG_DEBUG_ASSERT(ThreadPool::getTID() == 0);
     heads = new std::atomic<char*>[maxT] {};
+    numHeads = maxT;
   }
 }
 
 char*
 katana::PerBackend::initPerThread(unsigned maxT) {
   initCommon(maxT);
+  if (char* b = heads[ThreadPool::getTID()]; b) {
+    // allocated by initRemotePerThread
+    return b;
+  }
   char* b = heads[ThreadPool::getTID()] = (char*)alloc();
   memset(b, 0, ptAllocSize);
   return b;
@@ -177,6 +186,10 @@ char*
 katana::PerBackend::initPerSocket(unsigned maxT) {
   initCommon(maxT);
   unsigned id = ThreadPool::getTID();
+  if (char* b = heads[id]; b) {
+    // allocated by initRemotePerSocket
+    return b;
+  }
   unsigned leader = ThreadPool::getLeader();
   if (id == leader) {
     char* b = heads[id] = (char*)alloc();
@@ -192,6 +205,24 @@ katana::PerBackend::initPerSocket(unsigned maxT) {
   return heads[id];
 }
 
+void
+katana::PerBackend::initRemotePerThread(unsigned id) {
+  // Fresh pages are zero, and not prefaulting them leaves their first touch,
+  // which decides their NUMA node, to later
+  heads[id] = (char*)alloc(false);
+}
+
+void
+katana::PerBackend::initRemotePerSocket(unsigned id, unsigned leader) {
+  heads[id] = id == leader ? (char*)alloc(false) : heads[leader].load();
+}
+
+void
+katana::initPTSForThread(unsigned id, unsigned leader) {
+  getPTSBackend().initRemotePerThread(id);
+  getPPSBackend().initRemotePerSocket(id, leader);
+}
+
 void
 katana::initPTS(unsigned maxT) {
   if (!ptsBase) {
@@ -203,3 +234,8 @@ katana::initPTS(unsigned maxT) {
     pssBase = getPPSBackend().initPerSocket(maxT);
   }
 }
+
+void
+katana::setPSSBase(unsigned thread) {
+  pssBase = static_cast<char*>(getPPSBackend().getMachineRemote(thread, 0));
+}
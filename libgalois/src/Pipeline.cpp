@@ -0,0 +1,139 @@
+#include "katana/Pipeline.h"
+
+#include <sstream>
+
+#include "katana/ErrorCode.h"
+#include "katana/HWTopo.h"
+#include "katana/Statistics.h"
+
+katana::Pipeline::Pipeline(
+    std::string name, size_t queue_capacity, bool pin_threads)
+    : name_(std::move(name)),
+      queue_capacity_(queue_capacity),
+      pin_threads_(pin_threads) {}
+
+katana::Pipeline::~Pipeline() = default;
+
+katana::Pipeline::Stage*
+katana::Pipeline::AddStageRecord(
+    const std::string& name, unsigned threads,
+    std::function<void()> close_output) {
+  auto stage = std::make_unique<Stage>();
+  stage->stats.name = name;
+  stage->stats.threads = threads;
+  stage->close_output = std::move(close_output);
+  stages_.emplace_back(std::move(stage));
+  return stages_.back().get();
+}
+
+void
+katana::Pipeline::Fail(const ErrorInfo& error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_) {
+    return;
+  }
+  error_ = CopyableErrorInfo(error);
+  stopping_.store(true, std::memory_order_relaxed);
+  // Closing every output closes every queue, which wakes up the stages
+  // waiting on them
+  for (const auto& stage : stages_) {
+    stage->close_output();
+  }
+}
+
+void
+katana::Pipeline::RunWorker(Stage* stage, std::optional<unsigned> os_context) {
+  if (os_context) {
+    bindThreadSelf(*os_context);
+  }
+  PipelineStageStats local;
+  auto start = std::chrono::steady_clock::now();
+  auto res = stage->run(&local);
+  uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  if (!res) {
+    Fail(res.error().WithContext(
+        "pipeline {} stage {}", name_, stage->stats.name));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PipelineStageStats& stats = stage->stats;
+    stats.items += local.items;
+    stats.starved_ns += local.starved_ns;
+    stats.blocked_ns += local.blocked_ns;
+    uint64_t waited_ns = local.starved_ns + local.blocked_ns;
+    stats.busy_ns += elapsed_ns > waited_ns ? elapsed_ns - waited_ns : 0;
+  }
+  // The last thread of a stage tells the next stage there is no more input
+  if (stage->running.fetch_sub(1) == 1) {
+    stage->close_output();
+  }
+}
+
+katana::Result<void>
+katana::Pipeline::Run() {
+  if (ran_) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "pipeline {} has already run", name_);
+  }
+  ran_ = true;
+  for (const auto& stage : stages_) {
+    if (stage->stats.threads == 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "stage {} of pipeline {} has no threads",
+          stage->stats.name, name_);
+    }
+  }
+
+  std::vector<unsigned> os_contexts;
+  if (pin_threads_) {
+    for (const auto& info : getHWTopo().threadTopoInfo) {
+      os_contexts.emplace_back(info.osContext);
+    }
+  }
+
+  std::vector<std::thread> workers;
+  size_t next_context = 0;
+  for (const auto& stage : stages_) {
+    stage->running.store(stage->stats.threads);
+    for (unsigned i = 0; i < stage->stats.threads; ++i) {
+      std::optional<unsigned> os_context;
+      if (!os_contexts.empty()) {
+        os_context = os_contexts[next_context++ % os_contexts.size()];
+      }
+      workers.emplace_back(
+          [this, stage = stage.get(), os_context] {
+            RunWorker(stage, os_context);
+          });
+    }
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (const auto& stage : stages_) {
+    const PipelineStageStats& stats = stage->stats;
+    ReportStatSingle(name_, stats.name + "Items", stats.items);
+    ReportStatSingle(name_, stats.name + "BusyNs", stats.busy_ns);
+    ReportStatSingle(name_, stats.name + "StarvedNs", stats.starved_ns);
+    ReportStatSingle(name_, stats.name + "BlockedNs", stats.blocked_ns);
+  }
+
+  if (!error_) {
+    return ResultSuccess();
+  }
+  std::ostringstream message;
+  message << *error_;
+  return KATANA_ERROR(error_->error_code(), "{}", message.str());
+}
+
+std::vector<katana::PipelineStageStats>
+katana::Pipeline::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<PipelineStageStats> stats;
+  for (const auto& stage : stages_) {
+    stats.emplace_back(stage->stats);
+  }
+  return stats;
+}
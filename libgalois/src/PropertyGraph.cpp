@@ -2,11 +2,29 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Bag.h"
+#include "katana/CompressedGraphTopology.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/PropertyViews.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/SizedGraphTopology.h"
+#include "katana/Statistics.h"
+#include "tsuba/CompressedCSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -39,6 +57,12 @@ GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
 ///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
+///
+/// Compressed topology files (version tsuba::kCompressedCSRTopologyVersion)
+/// are decoded into memory. Topology files with other index widths (see
+/// tsuba/CSRTopology.h) are converted to the widths of GraphTopology, which
+/// copies the out indices of compact files and the destinations of wide
+/// ones.
 katana::Result<katana::GraphTopology>
 MapTopology(const tsuba::FileView& file_view) {
   const auto* data = file_view.ptr<uint64_t>();
@@ -46,7 +70,35 @@ MapTopology(const tsuba::FileView& file_view) {
     return katana::ErrorCode::InvalidArgument;
   }
 
-  if (data[0] != 1) {
+  if (data[0] == tsuba::kCompressedCSRTopologyVersion) {
+    auto compressed = katana::CompressedGraphTopology::Make(
+        std::make_shared<arrow::Buffer>(
+            file_view.ptr<uint8_t>(), file_view.size()));
+    if (!compressed) {
+      return compressed.error();
+    }
+    return compressed.value().Decompress();
+  }
+
+  if (data[0] == tsuba::kCompactCSRTopologyVersion ||
+      data[0] == tsuba::kWideCSRTopologyVersion) {
+    auto buffer = std::make_shared<arrow::Buffer>(
+        file_view.ptr<uint8_t>(), file_view.size());
+    if (data[0] == tsuba::kCompactCSRTopologyVersion) {
+      auto compact = katana::CompactGraphTopology::Make(std::move(buffer));
+      if (!compact) {
+        return compact.error();
+      }
+      return compact.value().ToGraphTopology();
+    }
+    auto wide = katana::WideGraphTopology::Make(std::move(buffer));
+    if (!wide) {
+      return wide.error();
+    }
+    return wide.value().ToGraphTopology();
+  }
+
+  if (data[0] != tsuba::kCSRTopologyVersion) {
     return katana::ErrorCode::InvalidArgument;
   }
 
@@ -65,17 +117,313 @@ MapTopology(const tsuba::FileView& file_view) {
 
   auto* out_dests = reinterpret_cast<uint32_t*>(out_indices + num_nodes);
 
-  auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
-      reinterpret_cast<uint8_t*>(out_indices), num_nodes);
+  std::shared_ptr<arrow::Buffer> indices_buffer;
+  std::shared_ptr<arrow::Buffer> dests_buffer;
+  if (file_view.read_only()) {
+    // The file is mapped directly; writes to it would fault, so only hand out
+    // immutable buffers
+    indices_buffer = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(out_indices),
+        num_nodes * sizeof(uint64_t));
+    dests_buffer = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(out_dests),
+        num_edges * sizeof(uint32_t));
+  } else {
+    indices_buffer = std::make_shared<arrow::MutableBuffer>(
+        reinterpret_cast<uint8_t*>(out_indices), num_nodes * sizeof(uint64_t));
+    dests_buffer = std::make_shared<arrow::MutableBuffer>(
+        reinterpret_cast<uint8_t*>(out_dests), num_edges * sizeof(uint32_t));
+  }
+
+  return katana::GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .out_dests =
+          std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+  };
+}
+
+/// AllChunksMutable returns true if every chunk of column can be written to
+/// in place
+bool
+AllChunksMutable(const arrow::ChunkedArray& column) {
+  return std::all_of(
+      column.chunks().begin(), column.chunks().end(),
+      [](const auto& chunk) { return katana::IsMutable(*chunk->data()); });
+}
+
+/// EnsureTopologyMutable replaces a topology that is backed by a read-only
+/// file mapping with an in-memory copy so that it can be modified in place.
+/// The edge type and time indexes, the degree ordered orientation, the hub
+/// split view and the Hilbert ordered edge list are dropped since the caller
+/// is about to invalidate them.
+katana::Result<void>
+EnsureTopologyMutable(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  if (!topology.out_indices || !topology.out_dests) {
+    return katana::ResultSuccess();
+  }
+  if (topology.out_indices->data()->buffers[1]->is_mutable() &&
+      topology.out_dests->data()->buffers[1]->is_mutable()) {
+    if (!topology.edge_type_index && !topology.edge_time_index &&
+        !topology.degree_ordered_dag && !topology.hub_split_view &&
+        !topology.hilbert_edge_list) {
+      return katana::ResultSuccess();
+    }
+    return pg->SetTopology(katana::GraphTopology{
+        .out_indices = topology.out_indices,
+        .out_dests = topology.out_dests,
+    });
+  }
+
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  auto indices_res = arrow::AllocateBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating out_indices: {}",
+        indices_res.status());
+  }
+  auto dests_res = arrow::AllocateBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating out_dests: {}",
+        dests_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.ValueOrDie());
+
+  const uint64_t* old_indices = topology.out_indices->raw_values();
+  const uint32_t* old_dests = topology.out_dests->raw_values();
+  auto* new_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_indices[n] = old_indices[n]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { new_dests[e] = old_dests[e]; }, katana::no_stats());
+
+  return pg->SetTopology(katana::GraphTopology{
+      .out_indices = std::make_shared<arrow::UInt64Array>(num_nodes, indices),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
+  });
+}
+
+/// Nodes with at least this many edges are sorted by all threads together
+/// after the other nodes have been sorted one per thread
+constexpr uint64_t kParallelSortDegree = uint64_t{1} << 16;
+
+/// Bits of the destination handled by each pass of the radix sort
+constexpr uint32_t kRadixBits = 11;
+
+/// Upper bound on the number of buckets of the first pass of BuildTopology.
+/// Keeps the per-thread histograms in cache.
+constexpr uint64_t kMaxTopologyBuckets = 4096;
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateTopologyBuffer(uint64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Split [0, size) into num_blocks contiguous blocks and return the
+/// first element of block i
+uint64_t
+BlockBegin(uint64_t size, uint64_t i, uint64_t num_blocks) {
+  return size / num_blocks * i + std::min(i, size % num_blocks);
+}
+
+/// Stable parallel LSD radix sort of the edges [0, size) of one node by
+/// destination. Each thread histograms and then scatters a contiguous block
+/// of the edges, so a pass needs no synchronization besides the prefix sum
+/// of the per-thread histograms. perm[i] must hold the original id of edge i
+/// and is permuted along with dests.
+void
+ParallelSortByDest(uint32_t* dests, uint64_t* perm, uint64_t size) {
+  constexpr uint64_t kNumDigits = uint64_t{1} << kRadixBits;
+  constexpr uint32_t kMask = kNumDigits - 1;
+
+  unsigned num_threads = katana::getActiveThreads();
+  std::vector<uint32_t> dests_tmp(size);
+  std::vector<uint64_t> perm_tmp(size);
+  uint32_t* dests_in = dests;
+  uint64_t* perm_in = perm;
+  uint32_t* dests_out = dests_tmp.data();
+  uint64_t* perm_out = perm_tmp.data();
+  std::vector<uint64_t> hist(num_threads * kNumDigits);
+
+  for (uint32_t shift = 0; shift < 32; shift += kRadixBits) {
+    std::fill(hist.begin(), hist.end(), 0);
+    katana::on_each([&](unsigned tid, unsigned) {
+      uint64_t* h = &hist[tid * kNumDigits];
+      for (uint64_t i = BlockBegin(size, tid, num_threads),
+                    end = BlockBegin(size, tid + 1, num_threads);
+           i < end; ++i) {
+        ++h[(dests_in[i] >> shift) & kMask];
+      }
+    });
+
+    // Turn counts into write offsets, digit major so that the pass is stable
+    uint64_t offset = 0;
+    bool one_digit = false;
+    for (uint64_t d = 0; d < kNumDigits; ++d) {
+      uint64_t digit_begin = offset;
+      for (unsigned t = 0; t < num_threads; ++t) {
+        uint64_t count = hist[t * kNumDigits + d];
+        hist[t * kNumDigits + d] = offset;
+        offset += count;
+      }
+      one_digit |= offset - digit_begin == size;
+    }
+    if (one_digit) {
+      // Every edge has the same digit; the pass would not move anything
+      continue;
+    }
+
+    katana::on_each([&](unsigned tid, unsigned) {
+      uint64_t* h = &hist[tid * kNumDigits];
+      for (uint64_t i = BlockBegin(size, tid, num_threads),
+                    end = BlockBegin(size, tid + 1, num_threads);
+           i < end; ++i) {
+        uint64_t pos = h[(dests_in[i] >> shift) & kMask]++;
+        dests_out[pos] = dests_in[i];
+        perm_out[pos] = perm_in[i];
+      }
+    });
+    std::swap(dests_in, dests_out);
+    std::swap(perm_in, perm_out);
+  }
+
+  if (dests_in != dests) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t i) {
+          dests[i] = dests_in[i];
+          perm[i] = perm_in[i];
+        },
+        katana::no_stats());
+  }
+}
+
+/// Build a topology with the same nodes as topology from a list of (source,
+/// destination) pairs. emit(n, fn) must call fn(src, dest) for each pair
+/// generated from node n, in the same order every time it is called. The
+/// edges of each source keep the order in which their pairs were generated
+/// when iterating over nodes in order, so the result is deterministic.
+///
+/// This is a two level counting sort by source: the pairs are first
+/// partitioned into at most kMaxTopologyBuckets buckets of consecutive
+/// sources using per-thread histograms, and then each bucket is sorted on
+/// its own. Both passes only write to a cache sized number of places at a
+/// time, unlike scattering each edge to its final place directly.
+template <typename EmitFn>
+katana::Result<katana::GraphTopology>
+BuildTopology(const katana::GraphTopology& topology, EmitFn emit) {
+  uint64_t num_nodes = topology.num_nodes();
+  KATANA_LOG_DEBUG_ASSERT(num_nodes > 0);
+
+  uint32_t shift = 0;
+  while (((num_nodes - 1) >> shift) >= kMaxTopologyBuckets) {
+    ++shift;
+  }
+  uint64_t num_buckets = ((num_nodes - 1) >> shift) + 1;
+
+  // Give each thread a range of nodes with about the same number of edges
+  unsigned num_threads = katana::getActiveThreads();
+  std::vector<uint64_t> node_begin(num_threads + 1, num_nodes);
+  node_begin[0] = 0;
+  const uint64_t* old_indices = topology.out_indices->raw_values();
+  for (unsigned t = 1; t < num_threads; ++t) {
+    uint64_t first_edge = BlockBegin(topology.num_edges(), t, num_threads);
+    node_begin[t] =
+        std::upper_bound(old_indices, old_indices + num_nodes, first_edge) -
+        old_indices;
+  }
+
+  std::vector<uint64_t> hist(num_threads * num_buckets, 0);
+  katana::on_each([&](unsigned tid, unsigned) {
+    uint64_t* h = &hist[tid * num_buckets];
+    for (uint64_t n = node_begin[tid]; n < node_begin[tid + 1]; ++n) {
+      emit(n, [&](uint32_t src, uint32_t) { ++h[src >> shift]; });
+    }
+  });
+
+  std::vector<uint64_t> bucket_begin(num_buckets + 1);
+  uint64_t num_edges = 0;
+  for (uint64_t b = 0; b < num_buckets; ++b) {
+    bucket_begin[b] = num_edges;
+    for (unsigned t = 0; t < num_threads; ++t) {
+      uint64_t count = hist[t * num_buckets + b];
+      hist[t * num_buckets + b] = num_edges;
+      num_edges += count;
+    }
+  }
+  bucket_begin[num_buckets] = num_edges;
+
+  // (src << 32) | dest of each pair, grouped by bucket
+  katana::LargeArray<uint64_t> pairs;
+  pairs.allocateBlocked(num_edges);
+  katana::on_each([&](unsigned tid, unsigned) {
+    uint64_t* h = &hist[tid * num_buckets];
+    for (uint64_t n = node_begin[tid]; n < node_begin[tid + 1]; ++n) {
+      emit(n, [&](uint32_t src, uint32_t dest) {
+        pairs[h[src >> shift]++] = (uint64_t{src} << 32) | dest;
+      });
+    }
+  });
 
-  auto dests_buffer = std::make_shared<arrow::MutableBuffer>(
-      reinterpret_cast<uint8_t*>(out_dests), num_edges);
+  auto indices_res =
+      AllocateTopologyBuffer(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests = std::move(dests_res.value());
+  auto* new_indices = reinterpret_cast<uint64_t*>(indices->mutable_data());
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests->mutable_data());
+
+  uint64_t bucket_width = uint64_t{1} << shift;
+  katana::PerThreadStorage<std::vector<uint64_t>> offsets;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        uint64_t first = b << shift;
+        uint64_t width = std::min(bucket_width, num_nodes - first);
+        std::vector<uint64_t>& offset = *offsets.getLocal();
+        offset.assign(width, 0);
+
+        for (uint64_t i = bucket_begin[b]; i < bucket_begin[b + 1]; ++i) {
+          ++offset[(pairs[i] >> 32) - first];
+        }
+        uint64_t end = bucket_begin[b];
+        for (uint64_t j = 0; j < width; ++j) {
+          uint64_t count = offset[j];
+          offset[j] = end;
+          end += count;
+          new_indices[first + j] = end;
+        }
+        for (uint64_t i = bucket_begin[b]; i < bucket_begin[b + 1]; ++i) {
+          new_dests[offset[(pairs[i] >> 32) - first]++] =
+              static_cast<uint32_t>(pairs[i]);
+        }
+      },
+      katana::steal(), katana::no_stats());
 
   return katana::GraphTopology{
-      .out_indices = std::make_shared<arrow::UInt64Array>(
-          indices_buffer->size(), indices_buffer),
-      .out_dests = std::make_shared<arrow::UInt32Array>(
-          dests_buffer->size(), dests_buffer),
+      .out_indices = std::make_shared<arrow::UInt64Array>(num_nodes, indices),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests),
   };
 }
 
@@ -92,8 +440,16 @@ LoadTopology(
   return katana::ResultSuccess();
 }
 
+/// Write topology in the format read by MapTopology. When edge_data is
+/// given, it holds edge_data_size bytes per edge and is written after the
+/// destinations; it cannot be combined with a compressed encoding. When
+/// compact, topologies with fewer than 2^32 edges are written with 32 bit
+/// out indices.
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
-WriteTopology(const katana::GraphTopology& topology) {
+WriteTopology(
+    const katana::GraphTopology& topology,
+    std::optional<tsuba::TopologyEncoding> encoding, bool compact,
+    const arrow::Buffer* edge_data = nullptr, uint64_t edge_data_size = 0) {
   auto ff = std::make_unique<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error();
@@ -101,7 +457,50 @@ WriteTopology(const katana::GraphTopology& topology) {
   uint64_t num_nodes = topology.num_nodes();
   uint64_t num_edges = topology.num_edges();
 
-  uint64_t data[4] = {1, 0, num_nodes, num_edges};
+  if (edge_data != nullptr) {
+    if (encoding) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "compressed topologies cannot have edge data");
+    }
+    if (static_cast<uint64_t>(edge_data->size()) !=
+        num_edges * edge_data_size) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge data has {} bytes, not {} per edge", edge_data->size(),
+          edge_data_size);
+    }
+  }
+
+  if (encoding) {
+    if (auto res = tsuba::WriteCompressedCSRTopology(
+            ff.get(), num_nodes, num_edges,
+            num_nodes ? topology.out_indices->raw_values() : nullptr,
+            num_edges ? topology.out_dests->raw_values() : nullptr,
+            encoding.value());
+        !res) {
+      return res.error();
+    }
+    return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+  }
+
+  if (compact && edge_data == nullptr &&
+      tsuba::CSRTopologyVersionFor(num_nodes, num_edges) ==
+          tsuba::kCompactCSRTopologyVersion) {
+    auto compact_res = katana::CompactGraphTopology::Make(topology);
+    if (!compact_res) {
+      return compact_res.error();
+    }
+    arrow::Status aro_sts = ff->Write(compact_res.value().buffer());
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+    return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+  }
+
+  uint64_t data[4] = {
+      tsuba::kCSRTopologyVersion, edge_data != nullptr ? edge_data_size : 0,
+      num_nodes, num_edges};
   arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
   if (!aro_sts.ok()) {
     return tsuba::ArrowToTsuba(aro_sts.code());
@@ -128,6 +527,21 @@ WriteTopology(const katana::GraphTopology& topology) {
       return tsuba::ArrowToTsuba(aro_sts.code());
     }
   }
+
+  if (edge_data != nullptr && num_edges) {
+    if (num_edges % 2 != 0) {
+      uint32_t padding = 0;
+      aro_sts = ff->Write(&padding, sizeof(padding));
+      if (!aro_sts.ok()) {
+        return tsuba::ArrowToTsuba(aro_sts.code());
+      }
+    }
+    aro_sts = ff->Write(
+        std::make_shared<arrow::Buffer>(edge_data->data(), edge_data->size()));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
   return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
@@ -140,10 +554,163 @@ MakePropertyGraph(
     return rdg_result.error();
   }
 
+  // The load timeline shows files that were read one after another
+  for (const tsuba::FileLoadTime& load : rdg_result.value().load_timeline()) {
+    katana::ReportStatSingle(
+        "PropertyGraphLoad", fmt::format("{}StartUs", load.file),
+        load.start_us);
+    katana::ReportStatSingle(
+        "PropertyGraphLoad", fmt::format("{}EndUs", load.file), load.end_us);
+  }
+
   return katana::PropertyGraph::Make(
       std::move(rdg_file), std::move(rdg_result.value()));
 }
 
+/// The values of the integer edge property name as edge types
+katana::Result<std::shared_ptr<arrow::UInt32Array>>
+EdgeTypes(const katana::PropertyGraph& pg, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> property = pg.GetEdgeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "edge property {} not found",
+        name);
+  }
+  if (!arrow::is_integer(property->type()->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "edge type property {} has type {}, not an integer type", name,
+        property->type()->ToString());
+  }
+  if (property->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge type property {} has nulls",
+        name);
+  }
+  if (static_cast<uint64_t>(property->length()) !=
+      pg.topology().num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge type property {} has {} rows but there are {} edges", name,
+        property->length(), pg.topology().num_edges());
+  }
+
+  auto cast_res = arrow::compute::Cast(property, arrow::uint32());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError,
+        "converting edge type property {} to uint32: {}", name,
+        cast_res.status());
+  }
+  auto array_res =
+      katana::CoalesceChunks(*cast_res.ValueOrDie().chunked_array());
+  if (!array_res) {
+    return array_res.error();
+  }
+  return std::static_pointer_cast<arrow::UInt32Array>(array_res.value());
+}
+
+/// The values of the integer or timestamp edge property name as edge times
+katana::Result<std::shared_ptr<arrow::Int64Array>>
+EdgeTimes(const katana::PropertyGraph& pg, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> property = pg.GetEdgeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "edge property {} not found",
+        name);
+  }
+  arrow::Type::type id = property->type()->id();
+  if (!arrow::is_integer(id) && id != arrow::Type::TIMESTAMP) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "edge time property {} has type {}, not an integer or timestamp type",
+        name, property->type()->ToString());
+  }
+  if (property->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge time property {} has nulls",
+        name);
+  }
+  if (static_cast<uint64_t>(property->length()) !=
+      pg.topology().num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge time property {} has {} rows but there are {} edges", name,
+        property->length(), pg.topology().num_edges());
+  }
+
+  auto cast_res = arrow::compute::Cast(property, arrow::int64());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError,
+        "converting edge time property {} to int64: {}", name,
+        cast_res.status());
+  }
+  auto array_res =
+      katana::CoalesceChunks(*cast_res.ValueOrDie().chunked_array());
+  if (!array_res) {
+    return array_res.error();
+  }
+  return std::static_pointer_cast<arrow::Int64Array>(array_res.value());
+}
+
+/// Replace every edge property of pg with its rows permuted by indices
+katana::Result<void>
+PermuteEdgeProperties(
+    katana::PropertyGraph* pg, const std::shared_ptr<arrow::Array>& indices) {
+  std::shared_ptr<arrow::Schema> schema = pg->edge_schema();
+  int num_fields = schema->num_fields();
+  if (num_fields == 0) {
+    return katana::ResultSuccess();
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < num_fields; ++i) {
+    std::shared_ptr<arrow::ChunkedArray> property = pg->GetEdgeProperty(i);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading edge property {}",
+          schema->field(i)->name());
+    }
+    auto res = arrow::compute::Take(property, indices);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "permuting edge property {}: {}",
+          schema->field(i)->name(), res.status());
+    }
+    columns.emplace_back(res.ValueOrDie().chunked_array());
+  }
+
+  for (int i = num_fields - 1; i >= 0; --i) {
+    if (auto res = pg->RemoveEdgeProperty(i); !res) {
+      return res.error();
+    }
+  }
+  return pg->AddEdgeProperties(arrow::Table::Make(schema, columns));
+}
+
+/// The position of cell (x, y) along the Hilbert curve that fills a square
+/// of 2^order by 2^order cells
+uint64_t
+HilbertIndex(uint32_t order, uint64_t x, uint64_t y) {
+  uint64_t side = uint64_t{1} << order;
+  uint64_t d = 0;
+  for (uint64_t s = side / 2; s > 0; s /= 2) {
+    uint64_t rx = (x & s) > 0;
+    uint64_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant so that the curve within it starts at its origin
+    if (ry == 0) {
+      if (rx == 1) {
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
 }  // namespace
 
 katana::PropertyGraph::PropertyGraph() = default;
@@ -169,8 +736,10 @@ katana::PropertyGraph::Validate() {
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
     tsuba::RDGHandle handle, const std::string& command_line) {
-  if (!rdg_.topology_file_storage().Valid()) {
-    auto result = WriteTopology(topology_);
+  if (!rdg_.topology_file_storage().Valid() || topology_encoding_ ||
+      compact_topology_) {
+    auto result =
+        WriteTopology(topology_, topology_encoding_, compact_topology_);
     if (!result) {
       return result.error();
     }
@@ -210,6 +779,18 @@ katana::PropertyGraph::Make(
       std::make_unique<tsuba::RDGFile>(handle.value()), opts);
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::Make(
+    const tsuba::Snapshot& snapshot, const tsuba::RDGLoadOptions& opts) {
+  auto handle = snapshot.Open();
+  if (!handle) {
+    return handle.error();
+  }
+
+  return MakePropertyGraph(
+      std::make_unique<tsuba::RDGFile>(handle.value()), opts);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy() const {
   return Copy(node_schema()->field_names(), edge_schema()->field_names());
@@ -219,13 +800,26 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy(
     const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) const {
-  // TODO(gill): This should copy the RDG in memory without reloading from storage.
-  tsuba::RDGLoadOptions opts;
-  opts.partition_id_to_load = partition_id();
-  opts.node_properties = &node_properties;
-  opts.edge_properties = &edge_properties;
+  auto rdg_res = rdg_.Copy(node_properties, edge_properties);
+  if (!rdg_res) {
+    return rdg_res.error();
+  }
+  auto g = std::unique_ptr<PropertyGraph>(
+      new PropertyGraph(nullptr, std::move(rdg_res.value())));
+
+  // Share the topology read-only as well, so that EnsureTopologyMutable
+  // copies it before either graph rewrites it in place
+  if (topology_.out_indices && topology_.out_dests) {
+    topology_.out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+        arrow::MakeArray(ShareReadOnly(topology_.out_indices->data())));
+    topology_.out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+        arrow::MakeArray(ShareReadOnly(topology_.out_dests->data())));
+  }
+  g->topology_ = topology_;
+  g->topology_encoding_ = topology_encoding_;
+  g->compact_topology_ = compact_topology_;
 
-  return Make(rdg_dir(), opts);
+  return std::unique_ptr<PropertyGraph>(std::move(g));
 }
 
 katana::Result<void>
@@ -273,154 +867,1152 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
   if (edge_props->num_columns() != other_edge_props->num_columns()) {
     return false;
   }
+  // Compare through GetNodeProperty so that deferred properties are loaded
   for (const auto& prop_name : node_props->ColumnNames()) {
-    if (!node_props->GetColumnByName(prop_name)->Equals(
-            other_node_props->GetColumnByName(prop_name))) {
+    auto other_prop = other->GetNodeProperty(prop_name);
+    if (!other_prop || !GetNodeProperty(prop_name)->Equals(other_prop)) {
       return false;
     }
   }
   for (const auto& prop_name : edge_props->ColumnNames()) {
-    if (!edge_props->GetColumnByName(prop_name)->Equals(
-            other_edge_props->GetColumnByName(prop_name))) {
+    auto other_prop = other->GetEdgeProperty(prop_name);
+    if (!other_prop || !GetEdgeProperty(prop_name)->Equals(other_prop)) {
       return false;
     }
   }
   return true;
 }
 
-katana::Result<void>
-katana::PropertyGraph::Write(
-    const std::string& rdg_name, const std::string& command_line) {
-  if (auto res = tsuba::Create(rdg_name); !res) {
-    return res.error();
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetNodeProperty(int i) const {
+  if (i < 0 || i >= rdg_.node_properties()->num_columns()) {
+    return nullptr;
   }
-  return WriteGraph(rdg_name, command_line);
+  if (auto res = rdg_.EnsureNodePropertyLoaded(i); !res) {
+    KATANA_LOG_ERROR("loading node property {}: {}", i, res.error());
+    return nullptr;
+  }
+  return rdg_.node_properties()->column(i);
 }
 
-katana::Result<void>
-katana::PropertyGraph::AddNodeProperties(
-    const std::shared_ptr<arrow::Table>& props) {
-  if (props->num_columns() == 0) {
-    KATANA_LOG_DEBUG("adding empty node prop table");
-    return ResultSuccess();
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetEdgeProperty(int i) const {
+  if (i < 0 || i >= rdg_.edge_properties()->num_columns()) {
+    return nullptr;
   }
-  if (topology_.out_indices &&
-      topology_.out_indices->length() != props->num_rows()) {
-    return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology_.out_indices->length(), props->num_rows());
+  if (auto res = rdg_.EnsureEdgePropertyLoaded(i); !res) {
+    KATANA_LOG_ERROR("loading edge property {}: {}", i, res.error());
+    return nullptr;
   }
-  return rdg_.AddNodeProperties(props);
+  return rdg_.edge_properties()->column(i);
 }
 
 katana::Result<void>
-katana::PropertyGraph::RemoveNodeProperty(int i) {
-  return rdg_.RemoveNodeProperty(i);
+katana::PropertyGraph::EnsureNodePropertiesLoaded(
+    const std::vector<std::string>& names) const {
+  for (const auto& name : names) {
+    int i = node_schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          ErrorCode::PropertyNotFound, "node property {} not found", name);
+    }
+    if (auto res = rdg_.EnsureNodePropertyLoaded(i); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
-katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
-  auto col_names = node_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+katana::PropertyGraph::EnsureEdgePropertiesLoaded(
+    const std::vector<std::string>& names) const {
+  for (const auto& name : names) {
+    int i = edge_schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          ErrorCode::PropertyNotFound, "edge property {} not found", name);
+    }
+    if (auto res = rdg_.EnsureEdgePropertyLoaded(i); !res) {
+      return res.error();
+    }
   }
-  return katana::ErrorCode::PropertyNotFound;
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
-katana::PropertyGraph::AddEdgeProperties(
-    const std::shared_ptr<arrow::Table>& props) {
-  if (props->num_columns() == 0) {
-    KATANA_LOG_DEBUG("adding empty edge prop table");
-    return ResultSuccess();
+katana::PropertyGraph::EnsureNodePropertiesMutable(
+    const std::vector<std::string>& names) {
+  if (auto res = EnsureNodePropertiesLoaded(names); !res) {
+    return res.error();
   }
-  if (topology_.out_dests &&
-      topology_.out_dests->length() != props->num_rows()) {
-    return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology_.out_dests->length(), props->num_rows());
+  for (const auto& name : names) {
+    int i = node_schema()->GetFieldIndex(name);
+    const auto& column = node_properties()->column(i);
+    if (AllChunksMutable(*column)) {
+      continue;
+    }
+    auto array_res = CopyChunks(*column);
+    if (!array_res) {
+      return array_res.error().WithContext("node property {}", name);
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({node_schema()->field(i)}), {array_res.value()});
+    if (auto res = rdg_.ReplaceNodeProperty(i, table); !res) {
+      return res.error();
+    }
   }
-  return rdg_.AddEdgeProperties(props);
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
-katana::PropertyGraph::RemoveEdgeProperty(int i) {
-  return rdg_.RemoveEdgeProperty(i);
+katana::PropertyGraph::EnsureEdgePropertiesMutable(
+    const std::vector<std::string>& names) {
+  if (auto res = EnsureEdgePropertiesLoaded(names); !res) {
+    return res.error();
+  }
+  for (const auto& name : names) {
+    int i = edge_schema()->GetFieldIndex(name);
+    const auto& column = edge_properties()->column(i);
+    if (AllChunksMutable(*column)) {
+      continue;
+    }
+    auto array_res = CopyChunks(*column);
+    if (!array_res) {
+      return array_res.error().WithContext("edge property {}", name);
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({edge_schema()->field(i)}), {array_res.value()});
+    if (auto res = rdg_.ReplaceEdgeProperty(i, table); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
-katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
-  auto col_names = edge_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+katana::PropertyGraph::CoalesceNodeProperties(
+    const std::vector<std::string>& names) {
+  if (auto res = EnsureNodePropertiesLoaded(names); !res) {
+    return res.error();
   }
-  return katana::ErrorCode::PropertyNotFound;
+  for (const auto& name : names) {
+    int i = node_schema()->GetFieldIndex(name);
+    const auto& column = node_properties()->column(i);
+    if (column->num_chunks() == 1) {
+      continue;
+    }
+    auto array_res = CoalesceChunks(*column);
+    if (!array_res) {
+      return array_res.error().WithContext("node property {}", name);
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({node_schema()->field(i)}), {array_res.value()});
+    if (auto res = rdg_.ReplaceNodeProperty(i, table); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
-katana::PropertyGraph::SetTopology(const katana::GraphTopology& topology) {
-  if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+katana::PropertyGraph::CoalesceEdgeProperties(
+    const std::vector<std::string>& names) {
+  if (auto res = EnsureEdgePropertiesLoaded(names); !res) {
     return res.error();
   }
-  topology_ = topology;
-
+  for (const auto& name : names) {
+    int i = edge_schema()->GetFieldIndex(name);
+    const auto& column = edge_properties()->column(i);
+    if (column->num_chunks() == 1) {
+      continue;
+    }
+    auto array_res = CoalesceChunks(*column);
+    if (!array_res) {
+      return array_res.error().WithContext("edge property {}", name);
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({edge_schema()->field(i)}), {array_res.value()});
+    if (auto res = rdg_.ReplaceEdgeProperty(i, table); !res) {
+      return res.error();
+    }
+  }
   return katana::ResultSuccess();
 }
 
-katana::Result<std::shared_ptr<arrow::UInt64Array>>
-katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
-  auto view_result_dests =
-      katana::ConstructPropertyView<katana::UInt32Property>(
-          pg->topology().out_dests.get());
-  if (!view_result_dests) {
-    return view_result_dests.error();
+void
+katana::PropertyGraph::PrefetchNodeProperties(
+    const std::vector<std::string>& names) const {
+  for (const auto& name : names) {
+    if (int i = node_schema()->GetFieldIndex(name); i >= 0) {
+      rdg_.PrefetchNodeProperty(i);
+    }
   }
+}
 
-  auto out_dests_view = std::move(view_result_dests.value());
+void
+katana::PropertyGraph::PrefetchEdgeProperties(
+    const std::vector<std::string>& names) const {
+  for (const auto& name : names) {
+    if (int i = edge_schema()->GetFieldIndex(name); i >= 0) {
+      rdg_.PrefetchEdgeProperty(i);
+    }
+  }
+}
 
-  arrow::UInt64Builder permutation_vec_builder;
-  if (auto r = permutation_vec_builder.Resize(pg->topology().num_edges());
-      !r.ok()) {
-    return ErrorCode::ArrowError;
-  }
-  // Getting a mutable reference to an index is definitely allowed. It's
-  // less clear if taking a pointer to it and using offsets is officially
-  // supported. But, ArrayBuilder::Advance explicitly mentions memcpy into the
-  // internal buffer. So I think it actually is.
-  uint64_t* permutation_vec_data = &permutation_vec_builder[0];
-  std::iota(
-      permutation_vec_data,
-      permutation_vec_data + permutation_vec_builder.capacity(), uint64_t{0});
-  auto comparator = [&](uint64_t a, uint64_t b) {
-    return out_dests_view[a] < out_dests_view[b];
-  };
+katana::Result<tsuba::PropertyStats>
+katana::PropertyGraph::GetNodePropertyStats(const std::string& name) const {
+  int i = node_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} not found", name);
+  }
+  if (const tsuba::PropertyStats* stats = rdg_.NodePropertyStats(i)) {
+    return *stats;
+  }
+  std::shared_ptr<arrow::ChunkedArray> column = GetNodeProperty(i);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} not loaded", name);
+  }
+  return tsuba::ComputePropertyStats(*column);
+}
+
+katana::Result<tsuba::PropertyStats>
+katana::PropertyGraph::GetEdgePropertyStats(const std::string& name) const {
+  int i = edge_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} not found", name);
+  }
+  if (const tsuba::PropertyStats* stats = rdg_.EdgePropertyStats(i)) {
+    return *stats;
+  }
+  std::shared_ptr<arrow::ChunkedArray> column = GetEdgeProperty(i);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} not loaded", name);
+  }
+  return tsuba::ComputePropertyStats(*column);
+}
+
+const tsuba::PropertyStats*
+katana::PropertyGraph::GetRecordedNodePropertyStats(
+    const std::string& name) const {
+  int i = node_schema()->GetFieldIndex(name);
+  return i < 0 ? nullptr : rdg_.NodePropertyStats(i);
+}
+
+const tsuba::PropertyStats*
+katana::PropertyGraph::GetRecordedEdgePropertyStats(
+    const std::string& name) const {
+  int i = edge_schema()->GetFieldIndex(name);
+  return i < 0 ? nullptr : rdg_.EdgePropertyStats(i);
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetNodePropertyFileFormat(
+    const std::string& name, tsuba::PropertyFileFormat format) {
+  int i = node_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} not found", name);
+  }
+  return rdg_.SetNodePropertyFileFormat(i, format);
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetEdgePropertyFileFormat(
+    const std::string& name, tsuba::PropertyFileFormat format) {
+  int i = edge_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} not found", name);
+  }
+  return rdg_.SetEdgePropertyFileFormat(i, format);
+}
+
+katana::Result<void>
+katana::PropertyGraph::Write(
+    const std::string& rdg_name, const std::string& command_line) {
+  if (auto res = tsuba::Create(rdg_name); !res) {
+    return res.error();
+  }
+  return WriteGraph(rdg_name, command_line);
+}
+
+katana::Result<void>
+katana::PropertyGraph::AddNodeProperties(
+    const std::shared_ptr<arrow::Table>& props) {
+  if (props->num_columns() == 0) {
+    KATANA_LOG_DEBUG("adding empty node prop table");
+    return ResultSuccess();
+  }
+  if (topology_.out_indices &&
+      topology_.out_indices->length() != props->num_rows()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        topology_.out_indices->length(), props->num_rows());
+  }
+  return rdg_.AddNodeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveNodeProperty(int i) {
+  return rdg_.RemoveNodeProperty(i);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
+  auto col_names = node_properties()->ColumnNames();
+  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+  if (pos != col_names.cend()) {
+    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+  }
+  return katana::ErrorCode::PropertyNotFound;
+}
+
+katana::Result<void>
+katana::PropertyGraph::AddEdgeProperties(
+    const std::shared_ptr<arrow::Table>& props) {
+  if (props->num_columns() == 0) {
+    KATANA_LOG_DEBUG("adding empty edge prop table");
+    return ResultSuccess();
+  }
+  if (topology_.out_dests &&
+      topology_.out_dests->length() != props->num_rows()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        topology_.out_dests->length(), props->num_rows());
+  }
+  return rdg_.AddEdgeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveEdgeProperty(int i) {
+  return rdg_.RemoveEdgeProperty(i);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
+  auto col_names = edge_properties()->ColumnNames();
+  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+  if (pos != col_names.cend()) {
+    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+  }
+  return katana::ErrorCode::PropertyNotFound;
+}
+
+katana::Result<tsuba::PropertyUpdate>
+katana::PropertyBatch::ToUpdate(
+    const arrow::Schema& schema, int64_t num_rows) const {
+  auto index_of = [&](const std::string& name) -> katana::Result<uint32_t> {
+    int i = schema.GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          ErrorCode::PropertyNotFound, "property {} not found", name);
+    }
+    return static_cast<uint32_t>(i);
+  };
+
+  tsuba::PropertyUpdate update;
+  for (const auto& name : removed_) {
+    auto i_res = index_of(name);
+    if (!i_res) {
+      return i_res.error();
+    }
+    update.removed.emplace_back(i_res.value());
+  }
+  for (const auto& [name, values] : replaced_) {
+    auto i_res = index_of(name);
+    if (!i_res) {
+      return i_res.error();
+    }
+    update.replaced.emplace_back(i_res.value(), values);
+  }
+  if (!added_fields_.empty()) {
+    for (const auto& column : added_columns_) {
+      if (num_rows >= 0 && column->length() != num_rows) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+            num_rows, column->length());
+      }
+    }
+    update.added = arrow::Table::Make(
+        arrow::schema(added_fields_), added_columns_, num_rows);
+  }
+  return update;
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpdateNodeProperties(const PropertyBatch& batch) {
+  if (batch.empty()) {
+    return ResultSuccess();
+  }
+  auto update_res = batch.ToUpdate(
+      *node_schema(), topology_.out_indices ? topology_.out_indices->length()
+                                            : int64_t{-1});
+  if (!update_res) {
+    return update_res.error();
+  }
+  return rdg_.UpdateNodeProperties(update_res.value());
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpdateEdgeProperties(const PropertyBatch& batch) {
+  if (batch.empty()) {
+    return ResultSuccess();
+  }
+  auto update_res = batch.ToUpdate(
+      *edge_schema(),
+      topology_.out_dests ? topology_.out_dests->length() : int64_t{-1});
+  if (!update_res) {
+    return update_res.error();
+  }
+  return rdg_.UpdateEdgeProperties(update_res.value());
+}
+
+katana::Result<bool>
+katana::PropertyGraph::PrepareNodePropertyOverwrite(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type) {
+  int i = node_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return false;
+  }
+  if (auto res = EnsureNodePropertiesLoaded({name}); !res) {
+    return res.error();
+  }
+  const auto& column = node_properties()->column(i);
+  tsuba::PropertyUpdate update;
+  bool reuse = column->type()->Equals(type) && column->num_chunks() == 1 &&
+               column->null_count() == 0 && AllChunksMutable(*column);
+  if (reuse) {
+    // Replacing the column with itself marks it as changed
+    update.replaced.emplace_back(i, column);
+  } else {
+    update.removed.emplace_back(i);
+  }
+  if (auto res = rdg_.UpdateNodeProperties(update); !res) {
+    return res.error();
+  }
+  return reuse;
+}
+
+katana::Result<bool>
+katana::PropertyGraph::PrepareEdgePropertyOverwrite(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type) {
+  int i = edge_schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return false;
+  }
+  if (auto res = EnsureEdgePropertiesLoaded({name}); !res) {
+    return res.error();
+  }
+  const auto& column = edge_properties()->column(i);
+  tsuba::PropertyUpdate update;
+  bool reuse = column->type()->Equals(type) && column->num_chunks() == 1 &&
+               column->null_count() == 0 && AllChunksMutable(*column);
+  if (reuse) {
+    update.replaced.emplace_back(i, column);
+  } else {
+    update.removed.emplace_back(i);
+  }
+  if (auto res = rdg_.UpdateEdgeProperties(update); !res) {
+    return res.error();
+  }
+  return reuse;
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetTopology(const katana::GraphTopology& topology) {
+  if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  topology_ = topology;
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::AddAuxTopology(
+    const std::string& name, const katana::GraphTopology& topology) {
+  auto ff_res = WriteTopology(topology, topology_encoding_, compact_topology_);
+  if (!ff_res) {
+    return ff_res.error();
+  }
+  rdg_.AddAuxTopology(name, std::move(ff_res.value()));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::AddAuxTopology(
+    const std::string& name, const katana::GraphTopology& topology,
+    const std::shared_ptr<arrow::Buffer>& edge_data, uint64_t edge_data_size) {
+  auto ff_res = WriteTopology(
+      topology, std::nullopt, false, edge_data.get(), edge_data_size);
+  if (!ff_res) {
+    return ff_res.error();
+  }
+  rdg_.AddAuxTopology(name, std::move(ff_res.value()));
+  return katana::ResultSuccess();
+}
 
+katana::Result<katana::GraphTopology>
+katana::PropertyGraph::LoadAuxTopology(const std::string& name) const {
+  auto view_res = rdg_.LoadAuxTopology(name);
+  if (!view_res) {
+    return view_res.error();
+  }
+  return MapTopology(*view_res.value());
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::PropertyGraph::LoadAuxTopologyEdgeData(
+    const std::string& name, uint64_t edge_data_size) const {
+  auto view_res = rdg_.LoadAuxTopology(name);
+  if (!view_res) {
+    return view_res.error();
+  }
+  const tsuba::FileView& view = *view_res.value();
+  const auto* data = view.ptr<uint64_t>();
+  if (view.size() < 4 * sizeof(uint64_t) || data[0] != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "auxiliary topology {} is not an uncompressed topology", name);
+  }
+  if (data[1] != edge_data_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "auxiliary topology {} has {} bytes of edge data per edge, not {}",
+        name, data[1], edge_data_size);
+  }
+
+  uint64_t num_edges = data[3];
+  uint64_t offset = GetGraphSize(data[2], num_edges + num_edges % 2);
+  uint64_t size = num_edges * edge_data_size;
+  if (view.size() < offset + size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        view.size(), offset + size);
+  }
+  return std::make_shared<arrow::Buffer>(view.ptr<uint8_t>() + offset, size);
+}
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
+  if (auto res = EnsureTopologyMutable(pg); !res) {
+    return res.error();
+  }
+
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_edges = topology.num_edges();
+
+  auto perm_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint64_t), "permutation");
+  if (!perm_res) {
+    return perm_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> perm_buffer = std::move(perm_res.value());
+  auto* perm = reinterpret_cast<uint64_t*>(perm_buffer->mutable_data());
+  auto view_result_dests =
+      katana::ConstructPropertyView<katana::UInt32Property>(
+          topology.out_dests.get());
+  if (!view_result_dests) {
+    return view_result_dests.error();
+  }
+  auto out_dests_view = std::move(view_result_dests.value());
+  uint32_t* dests = num_edges ? &out_dests_view[0] : nullptr;
+
+  // Sort (dest << 32 | position) keys so that a single sort of plain
+  // integers orders both the destinations and the permutation. Nodes with
+  // many edges are left for ParallelSortByDest.
+  katana::InsertBag<uint32_t> high_degree;
+  katana::PerThreadStorage<std::vector<uint64_t>> keys;
   katana::do_all(
-      katana::iterate(uint64_t{0}, pg->topology().num_nodes()),
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
       [&](uint64_t n) {
-        auto edge_range = pg->topology().edge_range(n);
-        std::sort(
-            permutation_vec_data + edge_range.first,
-            permutation_vec_data + edge_range.second, comparator);
-        std::sort(
-            &out_dests_view[0] + edge_range.first,
-            &out_dests_view[0] + edge_range.second);
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t degree = end - begin;
+        if (degree >= kParallelSortDegree) {
+          high_degree.push(n);
+          return;
+        }
+        if (std::is_sorted(dests + begin, dests + end)) {
+          std::iota(perm + begin, perm + end, begin);
+          return;
+        }
+
+        std::vector<uint64_t>& local = *keys.getLocal();
+        local.resize(degree);
+        for (uint64_t i = 0; i < degree; ++i) {
+          local[i] = (uint64_t{dests[begin + i]} << 32) | i;
+        }
+        std::sort(local.begin(), local.end());
+        for (uint64_t i = 0; i < degree; ++i) {
+          dests[begin + i] = static_cast<uint32_t>(local[i] >> 32);
+          perm[begin + i] = begin + (local[i] & 0xffffffff);
+        }
       },
       katana::steal());
 
-  if (auto r = permutation_vec_builder.Advance(pg->topology().num_edges());
-      !r.ok()) {
-    return ErrorCode::ArrowError;
+  for (uint32_t n : high_degree) {
+    auto [begin, end] = topology.edge_range(n);
+    katana::do_all(
+        katana::iterate(begin, end), [&](uint64_t e) { perm[e] = e; },
+        katana::no_stats());
+    ParallelSortByDest(dests + begin, perm + begin, end - begin);
+  }
+
+  return std::make_shared<arrow::UInt64Array>(num_edges, perm_buffer);
+}
+
+katana::Result<void>
+katana::PropertyGraph::IndexEdgesByType(const std::string& type_property) {
+  auto types_res = EdgeTypes(*this, type_property);
+  if (!types_res) {
+    return types_res.error();
   }
+  const uint32_t* types = types_res.value()->raw_values();
+  uint64_t num_nodes = topology_.num_nodes();
+
+  auto index = std::make_shared<EdgeTypeIndex>();
+  auto& node_run_ends = index->node_run_ends;
+  node_run_ends.allocateBlocked(num_nodes);
 
-  std::shared_ptr<arrow::UInt64Array> out;
-  if (permutation_vec_builder.Finish(&out).ok()) {
-    return out;
+  // First pass: count the runs of each node
+  katana::GReduceLogicalOr unsorted;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology_.edge_range(n);
+        uint64_t runs = begin < end ? 1 : 0;
+        for (uint64_t e = begin + 1; e < end; ++e) {
+          if (types[e] != types[e - 1]) {
+            unsorted.update(types[e] < types[e - 1]);
+            ++runs;
+          }
+        }
+        node_run_ends[n] = runs;
+      },
+      katana::steal(), katana::no_stats());
+  if (unsorted.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges are not sorted by {}; see SortAllEdgesByType", type_property);
+  }
+  katana::ParallelSTL::partial_sum(
+      node_run_ends.begin(), node_run_ends.end(), node_run_ends.begin());
+  uint64_t num_runs = num_nodes > 0 ? node_run_ends[num_nodes - 1] : 0;
+
+  // Second pass: record the type and end of each run
+  index->run_types.allocateBlocked(num_runs);
+  index->run_ends.allocateBlocked(num_runs);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology_.edge_range(n);
+        uint64_t r = n > 0 ? node_run_ends[n - 1] : 0;
+        for (uint64_t e = begin; e < end; ++e) {
+          if (e + 1 == end || types[e + 1] != types[e]) {
+            index->run_types[r] = types[e];
+            index->run_ends[r] = e + 1;
+            ++r;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  topology_.edge_type_index = std::move(index);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::IndexEdgesByTime(const std::string& time_property) {
+  auto times_res = EdgeTimes(*this, time_property);
+  if (!times_res) {
+    return times_res.error();
+  }
+  const int64_t* times = times_res.value()->raw_values();
+  uint64_t num_nodes = topology_.num_nodes();
+
+  auto index = std::make_shared<EdgeTimeIndex>();
+  index->property = time_property;
+  index->times.allocateBlocked(topology_.num_edges());
+  katana::GReduceLogicalOr unsorted;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology_.edge_range(n);
+        for (uint64_t e = begin; e < end; ++e) {
+          unsorted.update(e > begin && times[e] < times[e - 1]);
+          index->times[e] = times[e];
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (unsorted.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges are not sorted by {}; see SortAllEdgesByTime", time_property);
+  }
+
+  topology_.edge_time_index = std::move(index);
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<const katana::DegreeOrderedDag>>
+katana::PropertyGraph::OrientByDegree() {
+  if (topology_.degree_ordered_dag) {
+    return topology_.degree_ordered_dag;
+  }
+  const GraphTopology& topology = topology_;
+  uint64_t num_nodes = topology.num_nodes();
+  auto degree = [&](uint64_t n) {
+    auto [begin, end] = topology.edge_range(n);
+    return end - begin;
+  };
+  // Whether the edge from n to dest points from lower to higher rank
+  auto is_out_edge = [&](uint64_t n, uint64_t n_degree, uint64_t dest) {
+    uint64_t dest_degree = degree(dest);
+    return n_degree < dest_degree || (n_degree == dest_degree && n < dest);
+  };
+
+  // First pass: count the out-edges of each node, repeats included
+  LargeArray<uint64_t> candidate_ends;
+  candidate_ends.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t n_degree = degree(n);
+        uint64_t count = 0;
+        for (auto e : topology.edges(n)) {
+          count += is_out_edge(n, n_degree, topology.edge_dest(e));
+        }
+        candidate_ends[n] = count;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      candidate_ends.begin(), candidate_ends.end(), candidate_ends.begin());
+  uint64_t num_candidates = num_nodes > 0 ? candidate_ends[num_nodes - 1] : 0;
+
+  // Second pass: gather, sort and deduplicate the out-edges of each node
+  auto dag = std::make_shared<DegreeOrderedDag>();
+  dag->out_indices.allocateBlocked(num_nodes);
+  LargeArray<uint32_t> candidates;
+  candidates.allocateBlocked(num_candidates);
+  katana::GReduceMax<uint64_t> max_out_degree;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t n_degree = degree(n);
+        uint32_t* begin =
+            candidates.data() + (n > 0 ? candidate_ends[n - 1] : 0);
+        uint32_t* end = begin;
+        for (auto e : topology.edges(n)) {
+          uint32_t dest = topology.edge_dest(e);
+          if (is_out_edge(n, n_degree, dest)) {
+            *end++ = dest;
+          }
+        }
+        std::sort(begin, end);
+        uint64_t out_degree = std::unique(begin, end) - begin;
+        dag->out_indices[n] = out_degree;
+        max_out_degree.update(out_degree);
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      dag->out_indices.begin(), dag->out_indices.end(),
+      dag->out_indices.begin());
+  dag->max_out_degree = max_out_degree.reduce();
+
+  uint64_t num_out_edges = num_nodes > 0 ? dag->out_indices[num_nodes - 1] : 0;
+  if (num_out_edges == num_candidates) {
+    dag->out_dests = std::move(candidates);
   } else {
-    return ErrorCode::ArrowError;
+    // Third pass: close the gaps left by repeated edges
+    dag->out_dests.allocateBlocked(num_out_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t begin = n > 0 ? dag->out_indices[n - 1] : 0;
+          const uint32_t* from =
+              candidates.data() + (n > 0 ? candidate_ends[n - 1] : 0);
+          std::copy(
+              from, from + (dag->out_indices[n] - begin),
+              dag->out_dests.data() + begin);
+        },
+        katana::steal(), katana::no_stats());
   }
+
+  topology_.degree_ordered_dag = std::move(dag);
+  return topology_.degree_ordered_dag;
+}
+
+katana::Result<std::shared_ptr<const katana::HubSplitView>>
+katana::PropertyGraph::SplitHubs(uint64_t max_degree) {
+  if (max_degree == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "max_degree must be positive");
+  }
+  if (topology_.hub_split_view &&
+      topology_.hub_split_view->max_degree == max_degree) {
+    return topology_.hub_split_view;
+  }
+  const GraphTopology& topology = topology_;
+  uint64_t num_nodes = topology.num_nodes();
+
+  LargeArray<std::atomic<uint64_t>> in_degrees;
+  in_degrees.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_degrees.constructAt(n, 0); }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        for (auto e : topology.edges(n)) {
+          in_degrees[topology.edge_dest(e)].fetch_add(
+              1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Each node gets enough virtual nodes for both its out-edges and the
+  // pushes into it
+  auto view = std::make_shared<HubSplitView>();
+  view->max_degree = max_degree;
+  view->node_indices.allocateBlocked(num_nodes);
+  katana::InsertBag<uint32_t> hubs;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = std::max<uint64_t>(
+            topology.edges(n).size(),
+            in_degrees[n].load(std::memory_order_relaxed));
+        uint64_t count =
+            std::max<uint64_t>(1, (degree + max_degree - 1) / max_degree);
+        view->node_indices[n] = count;
+        if (count > 1) {
+          hubs.push(n);
+        }
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      view->node_indices.begin(), view->node_indices.end(),
+      view->node_indices.begin());
+  uint64_t num_virtual = num_nodes > 0 ? view->node_indices[num_nodes - 1] : 0;
+
+  // The out-edges of a node are divided between its virtual nodes in order,
+  // the first ones getting one more edge when they do not divide evenly
+  view->edge_indices.allocateBlocked(num_virtual);
+  view->virtual_to_node.allocateBlocked(num_virtual);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [v_begin, v_end] = view->virtual_nodes(n);
+        auto [e_begin, e_end] = topology.edge_range(n);
+        uint64_t count = v_end - v_begin;
+        uint64_t share = (e_end - e_begin) / count;
+        uint64_t extra = (e_end - e_begin) % count;
+        for (uint64_t i = 0; i < count; ++i) {
+          view->virtual_to_node[v_begin + i] = n;
+          view->edge_indices[v_begin + i] =
+              e_begin + share * (i + 1) + std::min(i + 1, extra);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint32_t> sorted_hubs(hubs.begin(), hubs.end());
+  std::sort(sorted_hubs.begin(), sorted_hubs.end());
+  view->hubs.allocateBlocked(sorted_hubs.size());
+  std::copy(sorted_hubs.begin(), sorted_hubs.end(), view->hubs.begin());
+
+  topology_.hub_split_view = std::move(view);
+  return topology_.hub_split_view;
+}
+
+katana::Result<std::shared_ptr<const katana::HilbertEdgeList>>
+katana::PropertyGraph::OrderEdgesAlongHilbertCurve(uint32_t block_bits) {
+  if (block_bits > 32) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "block_bits must be at most 32, got {}",
+        block_bits);
+  }
+  if (topology_.hilbert_edge_list &&
+      topology_.hilbert_edge_list->block_bits == block_bits) {
+    return topology_.hilbert_edge_list;
+  }
+  const GraphTopology& topology = topology_;
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  uint64_t num_columns =
+      num_nodes > 0 ? ((num_nodes - 1) >> block_bits) + 1 : 0;
+  // The curve fills the smallest square of blocks that covers the matrix
+  uint32_t order = 0;
+  while ((uint64_t{1} << order) < num_columns) {
+    ++order;
+  }
+
+  // Key each edge by the position of its block along the curve. The sort is
+  // stable, so the edges of each block stay in the order of the topology.
+  struct KeyedEdge {
+    uint64_t key;
+    uint64_t edge;
+    uint32_t source;
+  };
+  LargeArray<KeyedEdge> keyed;
+  keyed.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        for (auto e : topology.edges(n)) {
+          uint64_t dest = topology.edge_dest(e);
+          keyed[e] = KeyedEdge{
+              HilbertIndex(order, n >> block_bits, dest >> block_bits), e,
+              static_cast<uint32_t>(n)};
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::radix_sort(
+      keyed.begin(), keyed.end(), [](const KeyedEdge& k) { return k.key; });
+
+  // Entry i of block_numbers is 1 if edge i begins a block, which summed is
+  // one more than the block of edge i
+  auto list = std::make_shared<HilbertEdgeList>();
+  list->block_bits = block_bits;
+  list->num_nodes = num_nodes;
+  list->sources.allocateBlocked(num_edges);
+  list->dests.allocateBlocked(num_edges);
+  list->edges.allocateBlocked(num_edges);
+  LargeArray<uint64_t> block_numbers;
+  block_numbers.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t i) {
+        list->sources[i] = keyed[i].source;
+        list->dests[i] = topology.edge_dest(keyed[i].edge);
+        list->edges[i] = keyed[i].edge;
+        block_numbers[i] = i == 0 || keyed[i].key != keyed[i - 1].key;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      block_numbers.begin(), block_numbers.end(), block_numbers.begin());
+  uint64_t num_blocks = num_edges > 0 ? block_numbers[num_edges - 1] : 0;
+  list->block_ends.allocateBlocked(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t i) {
+        if (i + 1 == num_edges || keyed[i + 1].key != keyed[i].key) {
+          list->block_ends[block_numbers[i] - 1] = i + 1;
+        }
+      },
+      katana::no_stats());
+
+  // Group the blocks by column, again stably to keep the order of the curve
+  auto column = [&](uint64_t block) -> uint64_t {
+    return list->dests[list->block_range(block).first] >> block_bits;
+  };
+  list->column_blocks.allocateBlocked(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) { list->column_blocks[b] = b; }, katana::no_stats());
+  katana::ParallelSTL::radix_sort(
+      list->column_blocks.begin(), list->column_blocks.end(), column);
+  list->column_ends.allocateBlocked(num_columns);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_columns),
+      [&](uint64_t c) { list->column_ends[c] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t j) {
+        uint64_t c = column(list->column_blocks[j]);
+        if (j + 1 == num_blocks || column(list->column_blocks[j + 1]) != c) {
+          list->column_ends[c] = j + 1;
+        }
+      },
+      katana::no_stats());
+  // Columns without blocks end where the column before them does
+  for (uint64_t c = 1; c < num_columns; ++c) {
+    if (list->column_ends[c] == 0) {
+      list->column_ends[c] = list->column_ends[c - 1];
+    }
+  }
+
+  topology_.hilbert_edge_list = std::move(list);
+  return topology_.hilbert_edge_list;
+}
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::SortAllEdgesByType(
+    katana::PropertyGraph* pg, const std::string& type_property) {
+  auto types_res = EdgeTypes(*pg, type_property);
+  if (!types_res) {
+    return types_res.error();
+  }
+  const uint32_t* types = types_res.value()->raw_values();
+  if (auto res = EnsureTopologyMutable(pg); !res) {
+    return res.error();
+  }
+
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_edges = topology.num_edges();
+
+  auto perm_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint64_t), "permutation");
+  if (!perm_res) {
+    return perm_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> perm_buffer = std::move(perm_res.value());
+  auto* perm = reinterpret_cast<uint64_t*>(perm_buffer->mutable_data());
+  auto view_result_dests =
+      katana::ConstructPropertyView<katana::UInt32Property>(
+          topology.out_dests.get());
+  if (!view_result_dests) {
+    return view_result_dests.error();
+  }
+  auto out_dests_view = std::move(view_result_dests.value());
+  uint32_t* dests = num_edges ? &out_dests_view[0] : nullptr;
+
+  // Sort (type << 32 | dest, edge) pairs; the edge breaks ties so that the
+  // sort is stable. Nodes with many edges are sorted by all threads after
+  // the others.
+  using Key = std::pair<uint64_t, uint64_t>;
+  auto key = [&](uint64_t e) {
+    return Key((uint64_t{types[e]} << 32) | dests[e], e);
+  };
+  auto write_sorted = [&](uint64_t begin, std::vector<Key>* keys) {
+    for (uint64_t i = 0; i < keys->size(); ++i) {
+      dests[begin + i] = static_cast<uint32_t>((*keys)[i].first);
+      perm[begin + i] = (*keys)[i].second;
+    }
+  };
+
+  katana::InsertBag<uint32_t> high_degree;
+  katana::PerThreadStorage<std::vector<Key>> keys;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        if (end - begin >= kParallelSortDegree) {
+          high_degree.push(n);
+          return;
+        }
+        std::vector<Key>& local = *keys.getLocal();
+        local.clear();
+        for (uint64_t e = begin; e < end; ++e) {
+          local.emplace_back(key(e));
+        }
+        if (!std::is_sorted(local.begin(), local.end())) {
+          std::sort(local.begin(), local.end());
+        }
+        write_sorted(begin, &local);
+      },
+      katana::steal());
+
+  for (uint32_t n : high_degree) {
+    auto [begin, end] = topology.edge_range(n);
+    std::vector<Key> node_keys(end - begin);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t e) { node_keys[e - begin] = key(e); },
+        katana::no_stats());
+    katana::ParallelSTL::sort(node_keys.begin(), node_keys.end());
+    write_sorted(begin, &node_keys);
+  }
+
+  auto permutation =
+      std::make_shared<arrow::UInt64Array>(num_edges, perm_buffer);
+  if (auto res = PermuteEdgeProperties(pg, permutation); !res) {
+    return res.error();
+  }
+  if (auto res = pg->IndexEdgesByType(type_property); !res) {
+    return res.error();
+  }
+  return permutation;
+}
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::SortAllEdgesByTime(
+    katana::PropertyGraph* pg, const std::string& time_property) {
+  auto times_res = EdgeTimes(*pg, time_property);
+  if (!times_res) {
+    return times_res.error();
+  }
+  const int64_t* times = times_res.value()->raw_values();
+  if (auto res = EnsureTopologyMutable(pg); !res) {
+    return res.error();
+  }
+
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_edges = topology.num_edges();
+
+  auto perm_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint64_t), "permutation");
+  if (!perm_res) {
+    return perm_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> perm_buffer = std::move(perm_res.value());
+  auto* perm = reinterpret_cast<uint64_t*>(perm_buffer->mutable_data());
+  auto view_result_dests =
+      katana::ConstructPropertyView<katana::UInt32Property>(
+          topology.out_dests.get());
+  if (!view_result_dests) {
+    return view_result_dests.error();
+  }
+  auto out_dests_view = std::move(view_result_dests.value());
+  uint32_t* dests = num_edges ? &out_dests_view[0] : nullptr;
+
+  // Sort (time, dest, edge) keys; the edge breaks ties so that the sort is
+  // stable. Nodes with many edges are sorted by all threads after the
+  // others.
+  using Key = std::tuple<int64_t, uint32_t, uint64_t>;
+  auto key = [&](uint64_t e) { return Key(times[e], dests[e], e); };
+  auto write_sorted = [&](uint64_t begin, std::vector<Key>* keys) {
+    for (uint64_t i = 0; i < keys->size(); ++i) {
+      dests[begin + i] = std::get<1>((*keys)[i]);
+      perm[begin + i] = std::get<2>((*keys)[i]);
+    }
+  };
+
+  katana::InsertBag<uint32_t> high_degree;
+  katana::PerThreadStorage<std::vector<Key>> keys;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        if (end - begin >= kParallelSortDegree) {
+          high_degree.push(n);
+          return;
+        }
+        std::vector<Key>& local = *keys.getLocal();
+        local.clear();
+        for (uint64_t e = begin; e < end; ++e) {
+          local.emplace_back(key(e));
+        }
+        if (!std::is_sorted(local.begin(), local.end())) {
+          std::sort(local.begin(), local.end());
+        }
+        write_sorted(begin, &local);
+      },
+      katana::steal());
+
+  for (uint32_t n : high_degree) {
+    auto [begin, end] = topology.edge_range(n);
+    std::vector<Key> node_keys(end - begin);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t e) { node_keys[e - begin] = key(e); },
+        katana::no_stats());
+    katana::ParallelSTL::sort(node_keys.begin(), node_keys.end());
+    write_sorted(begin, &node_keys);
+  }
+
+  auto permutation =
+      std::make_shared<arrow::UInt64Array>(num_edges, perm_buffer);
+  if (auto res = PermuteEdgeProperties(pg, permutation); !res) {
+    return res.error();
+  }
+  if (auto res = pg->IndexEdgesByTime(time_property); !res) {
+    return res.error();
+  }
+  return permutation;
 }
 
 katana::GraphTopology::Edge
@@ -452,6 +2044,10 @@ katana::FindEdgeSortedByDest(
 
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
+  if (auto res = EnsureTopologyMutable(pg); !res) {
+    return res.error();
+  }
+
   uint64_t num_nodes = pg->topology().num_nodes();
   uint64_t num_edges = pg->topology().num_edges();
 
@@ -547,98 +2143,24 @@ katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
     return std::unique_ptr<PropertyGraph>(std::move(symmetric));
   }
 
-  // New symmetric graph topology
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-
-  out_indices->allocateInterleaved(topology.num_nodes());
-  // Store the out-degree of nodes from original graph
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()), [&](uint64_t n) {
-        auto edges = topology.edges(n);
-        (*out_indices)[n] = (*edges.end() - *edges.begin());
-      });
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t n) {
-        auto edges = topology.edges(n);
-        // update the out_indices for the symmetric topology
-        for (auto e = edges.begin(); e != edges.end(); ++e) {
-          auto dest = topology.edge_dest(*e);
-          // Do not add reverse edge for self-loops
-          if (n != dest) {
-            __sync_fetch_and_add(&((*out_indices)[dest]), 1);
-          }
-        }
-      },
-      katana::steal());
-
-  // Compute prefix sum
-  for (uint64_t n = 1; n < topology.num_nodes(); ++n) {
-    (*out_indices)[n] += (*out_indices)[n - 1];
+  // Each edge (n, dest) is kept and, unless it is a self-loop, paired with
+  // a reverse edge (dest, n)
+  auto topology_res = BuildTopology(topology, [&](uint64_t n, auto&& fn) {
+    auto src = static_cast<uint32_t>(n);
+    for (auto e : topology.edges(n)) {
+      auto dest = topology.edge_dest(e);
+      fn(src, dest);
+      if (dest != src) {
+        fn(dest, src);
+      }
+    }
+  });
+  if (!topology_res) {
+    return topology_res.error();
   }
 
-  uint64_t num_nodes_symmetric = topology.num_nodes();
-  uint64_t num_edges_symmetric = (*out_indices)[num_nodes_symmetric - 1];
-
-  katana::LargeArray<uint64_t> out_dests_offset;
-  out_dests_offset.allocateInterleaved(topology.num_nodes());
-  // Temp LargeArray for computing new destination positions
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(uint64_t{1}, topology.num_nodes()),
-      [&](uint64_t n) { out_dests_offset[n] = (*out_indices)[n - 1]; },
-      katana::no_stats());
-
-  out_dests->allocateInterleaved(num_edges_symmetric);
-  // Update graph topology with the original edges + reverse edges
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t src) {
-        auto edges = topology.edges(src);
-        // e = start index into edge array for a particular node
-        auto e = edges.begin();
-
-        // get all outgoing edges (excluding self edges) of a particular
-        // node and add reverse edges.
-        while (e < edges.end()) {
-          // destination node
-          auto dest = topology.edge_dest(*e);
-
-          // Add original edge
-          auto e_new_src = __sync_fetch_and_add(&(out_dests_offset[src]), 1);
-          (*out_dests)[e_new_src] = dest;
-
-          // Do not add reverse edge for self-loops
-          if (dest != src) {
-            // Add reverse edge
-            auto e_new_dst = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
-            (*out_dests)[e_new_dst] = src;
-            // TODO(gill) copy edge data to "new" array
-          }
-          e++;
-        }
-      },
-      katana::no_stats());
-
-  auto numeric_array_out_indices =
-      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(num_nodes_symmetric),
-          arrow::MutableBuffer::Wrap(
-              out_indices.release()->data(), num_nodes_symmetric));
-
-  auto numeric_array_out_dests =
-      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(num_edges_symmetric),
-          arrow::MutableBuffer::Wrap(
-              out_dests.release()->data(), num_edges_symmetric));
-
-  if (auto r = symmetric->SetTopology(katana::GraphTopology{
-          .out_indices = std::move(numeric_array_out_indices),
-          .out_dests = std::move(numeric_array_out_dests),
-      });
-      !r) {
+  // TODO(gill): Add edge properties for the new reversed edges.
+  if (auto r = symmetric->SetTopology(topology_res.value()); !r) {
     return r.error();
   }
 
@@ -653,86 +2175,20 @@ katana::CreateTransposeGraph(katana::PropertyGraph* pg) {
     return std::unique_ptr<PropertyGraph>(std::move(transpose));
   }
 
-  // New transpose graph topology
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-
-  out_indices->allocateInterleaved(topology.num_nodes());
-
-  // Initialize the new topology indices
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t n) { (*out_indices)[n] = uint64_t{0}; }, katana::no_stats());
-
-  // Keep a copy of old destinaton ids and compute number of
-  // in-coming edges for the new prefix sum of out_indices.
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_edges()),
-      [&](uint64_t e) {
-        // Counting outgoing edges in the tranpose graph by
-        // counting incoming edges in the original graph
-        auto dest = topology.edge_dest(e);
-        __sync_add_and_fetch(&((*out_indices)[dest]), 1);
-      },
-      katana::no_stats());
-
-  // Prefix sum calculation of the edge index array
-  for (uint64_t n = 1; n < topology.num_nodes(); ++n) {
-    (*out_indices)[n] += (*out_indices)[n - 1];
+  // Since sources are visited in order, the edges of each node of the
+  // transpose end up sorted by destination
+  auto topology_res = BuildTopology(topology, [&](uint64_t n, auto&& fn) {
+    auto src = static_cast<uint32_t>(n);
+    for (auto e : topology.edges(n)) {
+      fn(topology.edge_dest(e), src);
+    }
+  });
+  if (!topology_res) {
+    return topology_res.error();
   }
 
-  katana::LargeArray<uint64_t> out_dests_offset;
-  out_dests_offset.allocateInterleaved(topology.num_nodes());
-  // Reuse out_indices_tmp for computing new destination positions
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(uint64_t{1}, topology.num_nodes()),
-      [&](uint64_t n) { out_dests_offset[n] = (*out_indices)[n - 1]; },
-      katana::no_stats());
-
-  out_dests->allocateInterleaved(topology.num_edges());
-  // Update large_array_out_dests_ with the new destination ids
-  // of the transposed graphs
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t src) {
-        auto edges = topology.edges(src);
-        // e = start index into edge array for a particular node
-        auto e = edges.begin();
-
-        // get all outgoing edges of a particular
-        // node and reverse the edges.
-        while (e < edges.end()) {
-          // Destination node
-          auto dest = topology.edge_dest(*e);
-          // Location to save edge
-          auto e_new = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
-          // Save src as destination
-          (*out_dests)[e_new] = src;
-          // TODO (gill) copy edge data to the transposed graph
-          e++;
-        }
-      },
-      katana::no_stats());
-
-  // Set new topology
-  auto numeric_array_out_indices =
-      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(topology.num_nodes()),
-          arrow::MutableBuffer::Wrap(
-              out_indices.release()->data(), topology.num_nodes()));
-
-  auto numeric_array_out_dests =
-      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(topology.num_edges()),
-          arrow::MutableBuffer::Wrap(
-              out_dests.release()->data(), topology.num_edges()));
-
-  if (auto r = transpose->SetTopology(katana::GraphTopology{
-          .out_indices = std::move(numeric_array_out_indices),
-          .out_dests = std::move(numeric_array_out_dests),
-      });
-      !r) {
+  // TODO(gill): Add tranposed edge properties as well.
+  if (auto r = transpose->SetTopology(topology_res.value()); !r) {
     return r.error();
   }
 
@@ -0,0 +1,801 @@
+#include "katana/PropertyPredicate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+
+struct katana::PropertyPredicate::Node {
+  Kind kind;
+  std::string property;
+  Comparison comparison{kEqual};
+  Value value;
+  std::vector<PropertyPredicate> operands;
+};
+
+namespace {
+
+using katana::PropertyPredicate;
+
+/// Rows are evaluated in blocks of this many words of the mask
+constexpr int64_t kBlockWords = 64;
+constexpr int64_t kBlockRows = kBlockWords * 64;
+
+/// Set bit first_bit + i of words for each i in [0, length) for which
+/// pred(i) holds. Bits are gathered a word at a time so that the compiler
+/// can vectorize pred.
+template <typename Pred>
+void
+FillBits(int64_t length, int64_t first_bit, uint64_t* words, const Pred& pred) {
+  int64_t i = 0;
+  for (; i < length && (first_bit + i) % 64 != 0; ++i) {
+    words[(first_bit + i) / 64] |= uint64_t{pred(i)} << ((first_bit + i) % 64);
+  }
+  for (; i + 64 <= length; i += 64) {
+    uint64_t word = 0;
+    for (int64_t j = 0; j < 64; ++j) {
+      word |= uint64_t{pred(i + j)} << j;
+    }
+    words[(first_bit + i) / 64] |= word;
+  }
+  for (; i < length; ++i) {
+    words[(first_bit + i) / 64] |= uint64_t{pred(i)} << ((first_bit + i) % 64);
+  }
+}
+
+/// Set the bits of the rows [begin, begin + length) of array for which
+/// pred(values, i) holds and the row is not null
+template <typename Pred>
+void
+FillValid(
+    const arrow::Array& array, int64_t begin, int64_t length,
+    int64_t first_bit, uint64_t* words, const Pred& pred) {
+  if (array.null_count() == 0) {
+    FillBits(length, first_bit, words, [&](int64_t i) {
+      return pred(begin + i);
+    });
+  } else {
+    FillBits(length, first_bit, words, [&](int64_t i) {
+      return array.IsValid(begin + i) && pred(begin + i);
+    });
+  }
+}
+
+/// Call fn with the function object of comparison
+template <typename Fn>
+void
+WithComparison(PropertyPredicate::Comparison comparison, const Fn& fn) {
+  switch (comparison) {
+  case PropertyPredicate::kEqual:
+    return fn(std::equal_to<>{});
+  case PropertyPredicate::kNotEqual:
+    return fn(std::not_equal_to<>{});
+  case PropertyPredicate::kLess:
+    return fn(std::less<>{});
+  case PropertyPredicate::kLessEqual:
+    return fn(std::less_equal<>{});
+  case PropertyPredicate::kGreater:
+    return fn(std::greater<>{});
+  case PropertyPredicate::kGreaterEqual:
+    return fn(std::greater_equal<>{});
+  }
+}
+
+/// Sets the bits of the rows [begin, begin + length) of an array that
+/// satisfy a leaf of a predicate, starting at bit first_bit of words
+using Kernel = std::function<void(
+    const arrow::Array& array, int64_t begin, int64_t length,
+    int64_t first_bit, uint64_t* words)>;
+
+template <typename ArrowType>
+katana::Result<Kernel>
+MakeNumericKernel(
+    PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  using CType = typename ArrowType::c_type;
+  using ArrayType = arrow::NumericArray<ArrowType>;
+  Kernel kernel;
+  auto make = [&](auto literal) {
+    WithComparison(comparison, [&](auto cmp) {
+      kernel = [cmp, literal](
+                   const arrow::Array& array, int64_t begin, int64_t length,
+                   int64_t first_bit, uint64_t* words) {
+        const CType* values =
+            static_cast<const ArrayType&>(array).raw_values();
+        FillValid(array, begin, length, first_bit, words, [&](int64_t i) {
+          return cmp(values[i], literal);
+        });
+      };
+    });
+  };
+
+  if (const auto* real = std::get_if<double>(&value)) {
+    make(*real);
+  } else if (const auto* integer = std::get_if<int64_t>(&value)) {
+    if constexpr (std::is_floating_point_v<CType>) {
+      make(static_cast<double>(*integer));
+    } else if constexpr (std::is_unsigned_v<CType>) {
+      if (*integer < 0) {
+        // Every value is greater than a negative one
+        bool greater = comparison == PropertyPredicate::kNotEqual ||
+                       comparison == PropertyPredicate::kGreater ||
+                       comparison == PropertyPredicate::kGreaterEqual;
+        kernel = [greater](
+                     const arrow::Array& array, int64_t begin, int64_t length,
+                     int64_t first_bit, uint64_t* words) {
+          FillValid(array, begin, length, first_bit, words, [&](int64_t) {
+            return greater;
+          });
+        };
+      } else {
+        make(static_cast<uint64_t>(*integer));
+      }
+    } else {
+      make(*integer);
+    }
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "numeric properties can only be compared with numbers");
+  }
+  return kernel;
+}
+
+template <typename ArrayType>
+katana::Result<Kernel>
+MakeStringKernel(
+    PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  const auto* literal = std::get_if<std::string>(&value);
+  if (!literal) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "string properties can only be compared with strings");
+  }
+  Kernel kernel;
+  WithComparison(comparison, [&](auto cmp) {
+    kernel = [cmp, literal = *literal](
+                 const arrow::Array& array, int64_t begin, int64_t length,
+                 int64_t first_bit, uint64_t* words) {
+      const auto& strings = static_cast<const ArrayType&>(array);
+      std::string_view view(literal);
+      FillValid(array, begin, length, first_bit, words, [&](int64_t i) {
+        auto s = strings.GetView(i);
+        return cmp(std::string_view(s.data(), s.size()), view);
+      });
+    };
+  });
+  return kernel;
+}
+
+katana::Result<Kernel>
+MakeBooleanKernel(
+    PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  const auto* literal = std::get_if<bool>(&value);
+  if (!literal) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "boolean properties can only be compared with booleans");
+  }
+  Kernel kernel;
+  WithComparison(comparison, [&](auto cmp) {
+    kernel = [cmp, literal = *literal](
+                 const arrow::Array& array, int64_t begin, int64_t length,
+                 int64_t first_bit, uint64_t* words) {
+      const auto& booleans = static_cast<const arrow::BooleanArray&>(array);
+      FillValid(array, begin, length, first_bit, words, [&](int64_t i) {
+        return cmp(booleans.Value(i), literal);
+      });
+    };
+  });
+  return kernel;
+}
+
+katana::Result<Kernel>
+MakeCompareKernel(
+    const arrow::DataType& type, PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  switch (type.id()) {
+  case arrow::Type::INT8:
+    return MakeNumericKernel<arrow::Int8Type>(comparison, value);
+  case arrow::Type::UINT8:
+    return MakeNumericKernel<arrow::UInt8Type>(comparison, value);
+  case arrow::Type::INT16:
+    return MakeNumericKernel<arrow::Int16Type>(comparison, value);
+  case arrow::Type::UINT16:
+    return MakeNumericKernel<arrow::UInt16Type>(comparison, value);
+  case arrow::Type::INT32:
+  case arrow::Type::DATE32:
+  case arrow::Type::TIME32:
+    return MakeNumericKernel<arrow::Int32Type>(comparison, value);
+  case arrow::Type::UINT32:
+    return MakeNumericKernel<arrow::UInt32Type>(comparison, value);
+  case arrow::Type::INT64:
+  case arrow::Type::DATE64:
+  case arrow::Type::TIME64:
+  case arrow::Type::TIMESTAMP:
+  case arrow::Type::DURATION:
+    return MakeNumericKernel<arrow::Int64Type>(comparison, value);
+  case arrow::Type::UINT64:
+    return MakeNumericKernel<arrow::UInt64Type>(comparison, value);
+  case arrow::Type::FLOAT:
+    return MakeNumericKernel<arrow::FloatType>(comparison, value);
+  case arrow::Type::DOUBLE:
+    return MakeNumericKernel<arrow::DoubleType>(comparison, value);
+  case arrow::Type::BOOL:
+    return MakeBooleanKernel(comparison, value);
+  case arrow::Type::STRING:
+    return MakeStringKernel<arrow::StringArray>(comparison, value);
+  case arrow::Type::LARGE_STRING:
+    return MakeStringKernel<arrow::LargeStringArray>(comparison, value);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "cannot compare properties of type {}",
+        type.ToString());
+  }
+}
+
+template <typename IndexType>
+void
+FillDictionary(
+    const arrow::DictionaryArray& array, int64_t begin, int64_t length,
+    int64_t first_bit, uint64_t* words, const uint64_t* matches) {
+  const auto* codes =
+      static_cast<const arrow::NumericArray<IndexType>&>(*array.indices())
+          .raw_values();
+  FillValid(array, begin, length, first_bit, words, [&](int64_t i) {
+    uint64_t code = codes[i];
+    return (matches[code / 64] >> (code % 64)) & 1;
+  });
+}
+
+/// Dictionary encoded properties are compared by comparing the values of
+/// the dictionary of each chunk of column once, and then looking up the
+/// codes of the rows
+katana::Result<Kernel>
+MakeDictionaryKernel(
+    const arrow::ChunkedArray& column, PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  const auto& type = static_cast<const arrow::DictionaryType&>(*column.type());
+  auto value_kernel_res =
+      MakeCompareKernel(*type.value_type(), comparison, value);
+  if (!value_kernel_res) {
+    return value_kernel_res.error();
+  }
+  const Kernel& value_kernel = value_kernel_res.value();
+
+  // The bits of the dictionary values that match, by chunk
+  auto matches = std::make_shared<
+      std::unordered_map<const arrow::Array*, std::vector<uint64_t>>>();
+  for (const auto& chunk : column.chunks()) {
+    const arrow::Array& dictionary =
+        *static_cast<const arrow::DictionaryArray&>(*chunk).dictionary();
+    std::vector<uint64_t> bits((dictionary.length() + 63) / 64);
+    value_kernel(dictionary, 0, dictionary.length(), 0, bits.data());
+    matches->emplace(chunk.get(), std::move(bits));
+  }
+
+  arrow::Type::type index_type = type.index_type()->id();
+  return Kernel([matches, index_type](
+                    const arrow::Array& array, int64_t begin, int64_t length,
+                    int64_t first_bit, uint64_t* words) {
+    const auto& dict_array = static_cast<const arrow::DictionaryArray&>(array);
+    const uint64_t* bits = matches->at(&array).data();
+    switch (index_type) {
+    case arrow::Type::INT8:
+      return FillDictionary<arrow::Int8Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::INT16:
+      return FillDictionary<arrow::Int16Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::INT32:
+      return FillDictionary<arrow::Int32Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::INT64:
+      return FillDictionary<arrow::Int64Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::UINT8:
+      return FillDictionary<arrow::UInt8Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::UINT16:
+      return FillDictionary<arrow::UInt16Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    case arrow::Type::UINT32:
+      return FillDictionary<arrow::UInt32Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    default:
+      return FillDictionary<arrow::UInt64Type>(
+          dict_array, begin, length, first_bit, words, bits);
+    }
+  });
+}
+
+/// The [lo, hi] range of values a comparison may hold for, for checking
+/// zone maps. Zone map bounds are doubles rounded outward, so integers are
+/// widened by a unit in the last place in case they are not exact.
+std::pair<double, double>
+ZoneRange(
+    PropertyPredicate::Comparison comparison,
+    const PropertyPredicate::Value& value) {
+  constexpr double kInf = std::numeric_limits<double>::infinity();
+  double v = 0;
+  double lo = 0;
+  double hi = 0;
+  if (const auto* real = std::get_if<double>(&value)) {
+    v = lo = hi = *real;
+  } else if (const auto* integer = std::get_if<int64_t>(&value)) {
+    v = static_cast<double>(*integer);
+    lo = std::nextafter(v, -kInf);
+    hi = std::nextafter(v, kInf);
+  } else {
+    return {-kInf, kInf};
+  }
+  if (std::isnan(v)) {
+    return {-kInf, kInf};
+  }
+  switch (comparison) {
+  case PropertyPredicate::kEqual:
+    return {lo, hi};
+  case PropertyPredicate::kLess:
+  case PropertyPredicate::kLessEqual:
+    return {-kInf, hi};
+  case PropertyPredicate::kGreater:
+  case PropertyPredicate::kGreaterEqual:
+    return {lo, kInf};
+  default:
+    return {-kInf, kInf};
+  }
+}
+
+/// A predicate resolved against the columns of a graph
+struct Bound {
+  enum Type { kConstant, kLeaf, kAnd, kOr, kNot };
+
+  Type type{kConstant};
+  bool constant{false};
+
+  // Leaves
+  std::shared_ptr<arrow::ChunkedArray> column;
+  /// Chunk i of column holds the rows [chunk_begins[i], chunk_begins[i + 1])
+  std::vector<int64_t> chunk_begins;
+  Kernel kernel;
+  /// The sorted [begin, end) ranges of rows that may satisfy the leaf,
+  /// from zone maps; all rows may if there are no zone maps
+  bool has_zones{false};
+  std::vector<std::pair<int64_t, int64_t>> zones;
+
+  std::vector<Bound> operands;
+
+  static Bound Constant(bool value) {
+    Bound b;
+    b.constant = value;
+    return b;
+  }
+
+  bool MayMatch(int64_t begin, int64_t end) const {
+    if (!has_zones) {
+      return true;
+    }
+    // The last zone that starts before end
+    auto it = std::upper_bound(
+        zones.begin(), zones.end(), end,
+        [](int64_t row, const auto& zone) { return row <= zone.first; });
+    return it != zones.begin() && std::prev(it)->second > begin;
+  }
+};
+
+class Binder {
+public:
+  Binder(const katana::PropertyGraph& pg, bool nodes)
+      : pg_(pg),
+        nodes_(nodes),
+        num_rows_(nodes ? pg.num_nodes() : pg.num_edges()) {}
+
+  int64_t num_rows() const { return num_rows_; }
+
+  katana::Result<Bound> Bind(const PropertyPredicate& predicate) {
+    switch (predicate.kind()) {
+    case PropertyPredicate::kCompare:
+    case PropertyPredicate::kIsNull:
+      return BindLeaf(predicate);
+    case PropertyPredicate::kNot: {
+      auto operand = Bind(predicate.operands()[0]);
+      if (!operand) {
+        return operand.error();
+      }
+      if (operand.value().type == Bound::kConstant) {
+        return Bound::Constant(!operand.value().constant);
+      }
+      Bound b;
+      b.type = Bound::kNot;
+      b.operands.emplace_back(std::move(operand.value()));
+      return b;
+    }
+    case PropertyPredicate::kAnd:
+    case PropertyPredicate::kOr: {
+      bool is_and = predicate.kind() == PropertyPredicate::kAnd;
+      Bound b;
+      b.type = is_and ? Bound::kAnd : Bound::kOr;
+      // An operand that is constantly false for And or true for Or decides
+      // the predicate, and the operands after it are not even loaded
+      for (const PropertyPredicate& p : predicate.operands()) {
+        auto operand = Bind(p);
+        if (!operand) {
+          return operand.error();
+        }
+        if (operand.value().type == Bound::kConstant) {
+          if (operand.value().constant != is_and) {
+            return Bound::Constant(!is_and);
+          }
+          continue;
+        }
+        b.operands.emplace_back(std::move(operand.value()));
+      }
+      if (b.operands.empty()) {
+        return Bound::Constant(is_and);
+      }
+      if (b.operands.size() == 1) {
+        return std::move(b.operands[0]);
+      }
+      return b;
+    }
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown predicate kind");
+  }
+
+private:
+  katana::Result<Bound> BindLeaf(const PropertyPredicate& predicate) {
+    const std::string& name = predicate.property();
+    const auto& schema = nodes_ ? pg_.node_schema() : pg_.edge_schema();
+    int index = schema->GetFieldIndex(name);
+    if (index < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no {} property {}",
+          nodes_ ? "node" : "edge", name);
+    }
+
+    Bound b;
+    b.type = Bound::kLeaf;
+    bool is_null = predicate.kind() == PropertyPredicate::kIsNull;
+    const tsuba::PropertyStats* stats =
+        nodes_ ? pg_.GetRecordedNodePropertyStats(name)
+               : pg_.GetRecordedEdgePropertyStats(name);
+    if (stats && stats->column.length == num_rows_) {
+      auto [lo, hi] = is_null ? std::make_pair(0.0, 0.0)
+                              : ZoneRange(predicate.comparison(),
+                                          predicate.value());
+      std::vector<tsuba::ColumnStats> blocks = stats->blocks;
+      if (blocks.empty()) {
+        blocks.emplace_back(stats->column);
+      }
+      for (const tsuba::ColumnStats& block : blocks) {
+        bool may = is_null ? block.null_count > 0 : block.MayContain(lo, hi);
+        if (!may) {
+          continue;
+        }
+        int64_t end = block.offset + block.length;
+        if (!b.zones.empty() && b.zones.back().second == block.offset) {
+          b.zones.back().second = end;
+        } else {
+          b.zones.emplace_back(block.offset, end);
+        }
+      }
+      if (b.zones.empty()) {
+        return Bound::Constant(false);
+      }
+      b.has_zones =
+          !(b.zones.size() == 1 && b.zones[0].first == 0 &&
+            b.zones[0].second == num_rows_);
+    }
+
+    // Only now load the column, which may be deferred
+    b.column = nodes_ ? pg_.GetNodeProperty(index) : pg_.GetEdgeProperty(index);
+    if (!b.column) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "property {} is not loaded",
+          name);
+    }
+    int64_t begin = 0;
+    for (const auto& chunk : b.column->chunks()) {
+      b.chunk_begins.emplace_back(begin);
+      begin += chunk->length();
+    }
+    b.chunk_begins.emplace_back(begin);
+
+    if (is_null) {
+      b.kernel = [](const arrow::Array& array, int64_t begin, int64_t length,
+                    int64_t first_bit, uint64_t* words) {
+        if (array.null_count() > 0) {
+          FillBits(length, first_bit, words, [&](int64_t i) {
+            return array.IsNull(begin + i);
+          });
+        }
+      };
+      return b;
+    }
+    auto kernel_res =
+        b.column->type()->id() == arrow::Type::DICTIONARY
+            ? MakeDictionaryKernel(
+                  *b.column, predicate.comparison(), predicate.value())
+            : MakeCompareKernel(
+                  *b.column->type(), predicate.comparison(),
+                  predicate.value());
+    if (!kernel_res) {
+      return kernel_res.error().WithContext("property {}", name);
+    }
+    b.kernel = std::move(kernel_res.value());
+    return b;
+  }
+
+  const katana::PropertyGraph& pg_;
+  bool nodes_;
+  int64_t num_rows_;
+};
+
+/// Clear the bits of words past the first length
+void
+ClearTail(int64_t length, uint64_t* words) {
+  int64_t num_words = (length + 63) / 64;
+  std::fill(words + num_words, words + kBlockWords, 0);
+  if (length % 64 != 0) {
+    words[num_words - 1] &= (uint64_t{1} << (length % 64)) - 1;
+  }
+}
+
+bool
+AllZero(int64_t length, const uint64_t* words) {
+  int64_t num_words = (length + 63) / 64;
+  return std::all_of(
+      words, words + num_words, [](uint64_t w) { return w == 0; });
+}
+
+bool
+AllOne(int64_t length, const uint64_t* words) {
+  int64_t full = length / 64;
+  if (!std::all_of(
+          words, words + full, [](uint64_t w) { return w == ~uint64_t{0}; })) {
+    return false;
+  }
+  return length % 64 == 0 ||
+         words[full] == (uint64_t{1} << (length % 64)) - 1;
+}
+
+/// Set words to the bits of the rows [begin, end) of the block that satisfy
+/// b; end - begin is at most kBlockRows
+void
+Evaluate(const Bound& b, int64_t begin, int64_t end, uint64_t* words) {
+  int64_t length = end - begin;
+  std::fill(words, words + kBlockWords, 0);
+  switch (b.type) {
+  case Bound::kConstant:
+    if (b.constant) {
+      std::fill(words, words + kBlockWords, ~uint64_t{0});
+      ClearTail(length, words);
+    }
+    return;
+  case Bound::kLeaf: {
+    if (!b.MayMatch(begin, end)) {
+      return;
+    }
+    // The last chunk that starts at or before begin
+    size_t c = std::upper_bound(
+                   b.chunk_begins.begin(), b.chunk_begins.end() - 1, begin) -
+               b.chunk_begins.begin() - 1;
+    for (; c + 1 < b.chunk_begins.size() && b.chunk_begins[c] < end; ++c) {
+      int64_t lo = std::max(begin, b.chunk_begins[c]);
+      int64_t hi = std::min(end, b.chunk_begins[c + 1]);
+      if (lo < hi) {
+        b.kernel(
+            *b.column->chunk(c), lo - b.chunk_begins[c], hi - lo, lo - begin,
+            words);
+      }
+    }
+    return;
+  }
+  case Bound::kNot:
+    Evaluate(b.operands[0], begin, end, words);
+    for (int64_t w = 0; w < kBlockWords; ++w) {
+      words[w] = ~words[w];
+    }
+    ClearTail(length, words);
+    return;
+  case Bound::kAnd:
+  case Bound::kOr: {
+    bool is_and = b.type == Bound::kAnd;
+    uint64_t other[kBlockWords];
+    Evaluate(b.operands[0], begin, end, words);
+    for (size_t i = 1; i < b.operands.size(); ++i) {
+      if (is_and ? AllZero(length, words) : AllOne(length, words)) {
+        return;
+      }
+      Evaluate(b.operands[i], begin, end, other);
+      for (int64_t w = 0; w < kBlockWords; ++w) {
+        words[w] = is_and ? words[w] & other[w] : words[w] | other[w];
+      }
+    }
+    return;
+  }
+  }
+}
+
+katana::Result<void>
+EvaluatePredicate(
+    const katana::PropertyGraph& pg, const PropertyPredicate& predicate,
+    bool nodes, katana::DynamicBitset* mask) {
+  Binder binder(pg, nodes);
+  auto bound_res = binder.Bind(predicate);
+  if (!bound_res) {
+    return bound_res.error();
+  }
+  const Bound& bound = bound_res.value();
+  int64_t num_rows = binder.num_rows();
+  mask->resize(num_rows);
+  if (bound.type == Bound::kConstant && !bound.constant) {
+    return katana::ResultSuccess();
+  }
+
+  auto& vec = mask->get_vec();
+  int64_t num_blocks = (num_rows + kBlockRows - 1) / kBlockRows;
+  katana::do_all(
+      katana::iterate(int64_t{0}, num_blocks),
+      [&](int64_t block) {
+        int64_t begin = block * kBlockRows;
+        int64_t end = std::min(begin + kBlockRows, num_rows);
+        uint64_t words[kBlockWords];
+        Evaluate(bound, begin, end, words);
+        int64_t first_word = begin / 64;
+        for (int64_t w = 0; w < (end - begin + 63) / 64; ++w) {
+          vec[first_word + w].store(words[w], std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::loopname("EvaluatePredicate"));
+  return katana::ResultSuccess();
+}
+
+std::string
+ValueToString(const PropertyPredicate::Value& value) {
+  return std::visit(
+      [](const auto& v) -> std::string {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+          return fmt::format("\"{}\"", v);
+        } else {
+          return fmt::format("{}", v);
+        }
+      },
+      value);
+}
+
+}  // namespace
+
+PropertyPredicate
+PropertyPredicate::Compare(
+    std::string property, Comparison comparison, Value value) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{kCompare, std::move(property), comparison, std::move(value), {}}));
+}
+
+PropertyPredicate
+PropertyPredicate::IsNull(std::string property) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{kIsNull, std::move(property), kEqual, Value{}, {}}));
+}
+
+namespace katana {
+
+PropertyPredicate
+operator&&(PropertyPredicate a, PropertyPredicate b) {
+  // Chains of And are flattened so that each operand can end the chain
+  std::vector<PropertyPredicate> operands;
+  if (a.kind() == PropertyPredicate::kAnd) {
+    operands = a.operands();
+  } else {
+    operands.emplace_back(std::move(a));
+  }
+  operands.emplace_back(std::move(b));
+  return PropertyPredicate(
+      std::make_shared<const PropertyPredicate::Node>(PropertyPredicate::Node{
+          PropertyPredicate::kAnd, "", PropertyPredicate::kEqual,
+          PropertyPredicate::Value{}, std::move(operands)}));
+}
+
+PropertyPredicate
+operator||(PropertyPredicate a, PropertyPredicate b) {
+  std::vector<PropertyPredicate> operands;
+  if (a.kind() == PropertyPredicate::kOr) {
+    operands = a.operands();
+  } else {
+    operands.emplace_back(std::move(a));
+  }
+  operands.emplace_back(std::move(b));
+  return PropertyPredicate(
+      std::make_shared<const PropertyPredicate::Node>(PropertyPredicate::Node{
+          PropertyPredicate::kOr, "", PropertyPredicate::kEqual,
+          PropertyPredicate::Value{}, std::move(operands)}));
+}
+
+PropertyPredicate
+operator!(PropertyPredicate a) {
+  return PropertyPredicate(
+      std::make_shared<const PropertyPredicate::Node>(PropertyPredicate::Node{
+          PropertyPredicate::kNot, "", PropertyPredicate::kEqual,
+          PropertyPredicate::Value{}, {std::move(a)}}));
+}
+
+}  // namespace katana
+
+PropertyPredicate::Kind
+PropertyPredicate::kind() const {
+  return node_->kind;
+}
+
+const std::string&
+PropertyPredicate::property() const {
+  return node_->property;
+}
+
+PropertyPredicate::Comparison
+PropertyPredicate::comparison() const {
+  return node_->comparison;
+}
+
+const PropertyPredicate::Value&
+PropertyPredicate::value() const {
+  return node_->value;
+}
+
+const std::vector<PropertyPredicate>&
+PropertyPredicate::operands() const {
+  return node_->operands;
+}
+
+std::string
+PropertyPredicate::ToString() const {
+  static const char* kComparisons[] = {"==", "!=", "<", "<=", ">", ">="};
+  switch (kind()) {
+  case kCompare:
+    return fmt::format(
+        "{} {} {}", property(), kComparisons[comparison()],
+        ValueToString(value()));
+  case kIsNull:
+    return fmt::format("{} IS NULL", property());
+  case kNot:
+    return fmt::format("NOT ({})", operands()[0].ToString());
+  case kAnd:
+  case kOr: {
+    std::string s;
+    for (const auto& operand : operands()) {
+      if (!s.empty()) {
+        s += kind() == kAnd ? " AND " : " OR ";
+      }
+      s += fmt::format("({})", operand.ToString());
+    }
+    return s;
+  }
+  }
+  return "";
+}
+
+katana::Result<void>
+katana::EvaluateNodePredicate(
+    const PropertyGraph& pg, const PropertyPredicate& predicate,
+    DynamicBitset* mask) {
+  return EvaluatePredicate(pg, predicate, true, mask);
+}
+
+katana::Result<void>
+katana::EvaluateEdgePredicate(
+    const PropertyGraph& pg, const PropertyPredicate& predicate,
+    DynamicBitset* mask) {
+  return EvaluatePredicate(pg, predicate, false, mask);
+}
@@ -1,5 +1,65 @@
 #include <katana/PropertyViews.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include <arrow/array/concatenate.h>
+#include <arrow/util/bitmap_ops.h>
+
+#include "katana/Loops.h"
+
+namespace {
+
+/// Values are copied in blocks of this many bytes so that a column of a few
+/// large chunks is still copied by all threads
+constexpr int64_t kCopyBlockBytes = int64_t{1} << 20;
+
+/// The byte width of the values of arrays of type, or 0 if they are not
+/// stored as one contiguous buffer of whole bytes. Fixed size lists of such
+/// values count as a value of list_size elements.
+int64_t
+ContiguousByteWidth(const arrow::DataType& type) {
+  if (type.id() == arrow::Type::FIXED_SIZE_LIST) {
+    const auto& list_type = static_cast<const arrow::FixedSizeListType&>(type);
+    if (list_type.value_type()->id() == arrow::Type::FIXED_SIZE_LIST) {
+      return 0;
+    }
+    return list_type.list_size() * ContiguousByteWidth(*list_type.value_type());
+  }
+  const auto* fixed = dynamic_cast<const arrow::FixedWidthType*>(&type);
+  if (fixed == nullptr || type.id() == arrow::Type::BOOL ||
+      type.id() == arrow::Type::DICTIONARY || fixed->bit_width() % 8 != 0) {
+    return 0;
+  }
+  return fixed->bit_width() / 8;
+}
+
+/// The ArrayData that holds the values of array; for fixed size lists it is
+/// the child array
+const arrow::ArrayData&
+ValuesData(const arrow::Array& array) {
+  if (array.type_id() == arrow::Type::FIXED_SIZE_LIST) {
+    return *array.data()->child_data[0];
+  }
+  return *array.data();
+}
+
+/// The first value byte of array
+const uint8_t*
+ValuesBegin(const arrow::Array& array, int64_t byte_width) {
+  const arrow::ArrayData& values = ValuesData(array);
+  int64_t values_per_row = 1;
+  if (array.type_id() == arrow::Type::FIXED_SIZE_LIST) {
+    values_per_row =
+        static_cast<const arrow::FixedSizeListType&>(*array.type()).list_size();
+  }
+  int64_t value_width = byte_width / values_per_row;
+  return values.buffers[1]->data() +
+         (values.offset + array.offset() * values_per_row) * value_width;
+}
+
+}  // namespace
+
 katana::Result<std::vector<arrow::Array*>>
 katana::internal::ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties) {
@@ -10,12 +70,125 @@ katana::internal::ExtractArrays(
       return ErrorCode::PropertyNotFound;
     }
     if (column->num_chunks() != 1) {
-      // Katana form graphs only contain single chunk property columns.
-      return ErrorCode::TODO;
-      // TODO: Maybe we need an InvalidGraph error
+      // Katana form graphs only contain single chunk property columns; see
+      // PropertyGraph::CoalesceNodeProperties for others
+      return KATANA_ERROR(
+          ErrorCode::TODO, "property {} has {} chunks instead of one",
+          property, column->num_chunks());
     }
     ret.emplace_back(column->chunks()[0].get());
   }
 
   return ret;
 }
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::CoalesceChunks(const arrow::ChunkedArray& chunked_array) {
+  const arrow::ArrayVector& chunks = chunked_array.chunks();
+  if (chunks.size() == 1) {
+    return chunks[0];
+  }
+  return CopyChunks(chunked_array);
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::CopyChunks(const arrow::ChunkedArray& chunked_array) {
+  const arrow::ArrayVector& chunks = chunked_array.chunks();
+  int64_t byte_width = ContiguousByteWidth(*chunked_array.type());
+  bool contiguous = byte_width > 0;
+  for (const auto& chunk : chunks) {
+    if (chunk->type_id() == arrow::Type::FIXED_SIZE_LIST &&
+        ValuesData(*chunk).GetNullCount() > 0) {
+      contiguous = false;
+    }
+  }
+  if (!contiguous) {
+    auto res = arrow::Concatenate(chunks, arrow::default_memory_pool());
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "concatenating chunks: {}", res.status());
+    }
+    return res.ValueOrDie();
+  }
+
+  int64_t length = chunked_array.length();
+  int64_t null_count = chunked_array.null_count();
+  auto values_res = arrow::AllocateBuffer(length * byte_width);
+  if (!values_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating values: {}", values_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> values = std::move(values_res.ValueOrDie());
+
+  // Split the chunks into blocks and copy the blocks in parallel
+  struct Block {
+    const uint8_t* src;
+    int64_t dest_begin;
+    int64_t bytes;
+  };
+  std::vector<Block> blocks;
+  std::vector<int64_t> chunk_offsets;
+  int64_t offset = 0;
+  for (const auto& chunk : chunks) {
+    chunk_offsets.emplace_back(offset);
+    if (chunk->length() == 0) {
+      continue;
+    }
+    const uint8_t* src = ValuesBegin(*chunk, byte_width);
+    int64_t chunk_bytes = chunk->length() * byte_width;
+    for (int64_t b = 0; b < chunk_bytes; b += kCopyBlockBytes) {
+      blocks.emplace_back(Block{
+          src + b, offset * byte_width + b,
+          std::min(kCopyBlockBytes, chunk_bytes - b)});
+    }
+    offset += chunk->length();
+  }
+  uint8_t* dest = values->mutable_data();
+  katana::do_all(
+      katana::iterate(blocks.begin(), blocks.end()),
+      [&](const Block& block) {
+        std::memcpy(dest + block.dest_begin, block.src, block.bytes);
+      },
+      katana::no_stats());
+
+  // Validity bitmaps are small and chunks need not start on byte
+  // boundaries of the result, so they are copied serially
+  std::shared_ptr<arrow::Buffer> null_bitmap;
+  if (null_count > 0) {
+    auto bitmap_res =
+        arrow::AllocateBuffer(arrow::BitUtil::BytesForBits(length));
+    if (!bitmap_res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "allocating null bitmap: {}",
+          bitmap_res.status());
+    }
+    null_bitmap = std::move(bitmap_res.ValueOrDie());
+    uint8_t* bitmap = null_bitmap->mutable_data();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      const auto& chunk = chunks[i];
+      if (chunk->null_count() == 0) {
+        arrow::BitUtil::SetBitsTo(
+            bitmap, chunk_offsets[i], chunk->length(), true);
+      } else {
+        arrow::internal::CopyBitmap(
+            chunk->null_bitmap_data(), chunk->offset(), chunk->length(),
+            bitmap, chunk_offsets[i]);
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::ArrayData> data;
+  if (chunked_array.type()->id() == arrow::Type::FIXED_SIZE_LIST) {
+    const auto& list_type =
+        static_cast<const arrow::FixedSizeListType&>(*chunked_array.type());
+    auto child = arrow::ArrayData::Make(
+        list_type.value_type(), length * list_type.list_size(),
+        {nullptr, values}, 0);
+    data = arrow::ArrayData::Make(
+        chunked_array.type(), length, {null_bitmap}, {child}, null_count);
+  } else {
+    data = arrow::ArrayData::Make(
+        chunked_array.type(), length, {null_bitmap, values}, null_count);
+  }
+  return arrow::MakeArray(data);
+}
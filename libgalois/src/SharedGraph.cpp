@@ -0,0 +1,124 @@
+#include "katana/SharedGraph.h"
+
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/array/concatenate.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// The tables of a shared graph, in the order they are published
+enum SharedGraphTable {
+  kOutIndices,
+  kOutDests,
+  kNodeProperties,
+  kEdgeProperties,
+  kNumSharedGraphTables,
+};
+
+std::shared_ptr<arrow::Table>
+TopologyTable(const std::string& name, const std::shared_ptr<arrow::Array>& a) {
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, a->type())}), {a}, a->length());
+}
+
+/// The topology array stored in table, which has one column of ArrayType
+template <typename ArrayType>
+katana::Result<std::shared_ptr<ArrayType>>
+TopologyArray(const arrow::Table& table) {
+  using TypeClass = typename ArrayType::TypeClass;
+  if (table.num_columns() != 1 ||
+      table.column(0)->type()->id() != TypeClass::type_id) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unexpected topology schema {}",
+        table.schema()->ToString());
+  }
+  const auto& chunks = table.column(0)->chunks();
+  if (chunks.size() == 1) {
+    return std::static_pointer_cast<ArrayType>(chunks[0]);
+  }
+  if (chunks.empty()) {
+    auto empty = std::make_shared<arrow::Buffer>(nullptr, 0);
+    return std::make_shared<ArrayType>(0, empty);
+  }
+  // Only arrays published in pieces are copied
+  auto array_res = arrow::Concatenate(chunks);
+  if (!array_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "joining topology: {}",
+        array_res.status());
+  }
+  return std::static_pointer_cast<ArrayType>(array_res.ValueOrDie());
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::PublishSharedGraph(
+    const PropertyGraph& graph, const std::string& name) {
+  std::vector<std::shared_ptr<arrow::Table>> tables(kNumSharedGraphTables);
+  tables[kOutIndices] =
+      TopologyTable("out_indices", graph.topology().out_indices);
+  tables[kOutDests] = TopologyTable("out_dests", graph.topology().out_dests);
+  tables[kNodeProperties] = graph.node_properties();
+  tables[kEdgeProperties] = graph.edge_properties();
+  if (auto res = PublishSharedTables(name, tables); !res) {
+    return res.error().WithContext("publishing graph {}", name);
+  }
+  return ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::AttachSharedGraph(const std::string& name) {
+  auto tables_res = MapSharedTables(name);
+  if (!tables_res) {
+    return tables_res.error().WithContext("attaching graph {}", name);
+  }
+  std::vector<std::shared_ptr<arrow::Table>> tables =
+      std::move(tables_res.value());
+  if (tables.size() != kNumSharedGraphTables) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has {} tables, not a graph", name,
+        tables.size());
+  }
+
+  auto indices_res = TopologyArray<arrow::UInt64Array>(*tables[kOutIndices]);
+  if (!indices_res) {
+    return indices_res.error().WithContext("attaching graph {}", name);
+  }
+  auto dests_res = TopologyArray<arrow::UInt32Array>(*tables[kOutDests]);
+  if (!dests_res) {
+    return dests_res.error().WithContext("attaching graph {}", name);
+  }
+
+  auto pg = std::make_unique<PropertyGraph>();
+  if (auto res = pg->SetTopology(GraphTopology{
+          .out_indices = std::move(indices_res.value()),
+          .out_dests = std::move(dests_res.value()),
+      });
+      !res) {
+    return res.error();
+  }
+  if (tables[kNodeProperties]->num_columns() > 0) {
+    if (auto res = pg->AddNodeProperties(tables[kNodeProperties]); !res) {
+      return res.error().WithContext("attaching graph {}", name);
+    }
+  }
+  if (tables[kEdgeProperties]->num_columns() > 0) {
+    if (auto res = pg->AddEdgeProperties(tables[kEdgeProperties]); !res) {
+      return res.error().WithContext("attaching graph {}", name);
+    }
+  }
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
+
+katana::Result<void>
+katana::UnpublishSharedGraph(const std::string& name) {
+  if (auto res = UnlinkSharedTables(name); !res) {
+    return res.error().WithContext("unpublishing graph {}", name);
+  }
+  return ResultSuccess();
+}
@@ -20,13 +20,20 @@
 #include "katana/SharedMem.h"
 
 #include <memory>
+#include <string>
 
 #include "katana/Barrier.h"
+#include "katana/Env.h"
 #include "katana/PagePool.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
 
 namespace {
+
+/// Above this many threads the token of the ring takes longer to go around
+/// than a wave of the hierarchical detector, even on one socket
+constexpr unsigned kMaxRingThreads = 16;
+
 // Dijkstra style 2-pass ring termination detection
 class LocalTerminationDetection : public katana::TerminationDetection {
   struct TokenHolder {
@@ -56,6 +63,8 @@ protected:
   }
 
 public:
+  const char* name() const override { return "ring"; }
+
   void InitializeThread() override {
     TokenHolder& th = *data_.getLocal();
     th.token_is_black = false;
@@ -72,6 +81,9 @@ public:
     KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
     TokenHolder& th = *data_.getLocal();
     th.process_is_black |= work_happened;
+    if (work_happened) {
+      NoteWork();
+    }
     if (th.has_token) {
       if (IsSysMaster()) {
         bool failed = th.token_is_black || th.process_is_black;
@@ -168,6 +180,8 @@ protected:
   }
 
 public:
+  const char* name() const override { return "tree"; }
+
   void InitializeThread() override {
     TokenHolder& th = *data_.getLocal();
     th.down_token = false;
@@ -198,15 +212,186 @@ public:
     KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
     TokenHolder& th = *data_.getLocal();
     th.process_is_black |= work_happened;
+    if (work_happened) {
+      NoteWork();
+    }
     ProcessToken();
   }
 };
 
+// Dijkstra style 2-pass termination detection in waves over a two level
+// tree. Each thread reports its color once per wave to the counter of its
+// socket; the last thread of a socket to report passes the color of the
+// socket on to the global counter, and the last socket to report ends the
+// wave and, unless it detected termination, starts the next one. Any thread
+// may end a wave, so no thread waits for a token to reach it.
+class HierarchicalTerminationDetection : public katana::TerminationDetection {
+  struct Counter {
+    std::atomic<unsigned> reports{0};
+    std::atomic<bool> is_black{false};
+    // The number of reports that complete a wave
+    std::atomic<unsigned> expected{0};
+  };
+
+  struct ThreadState {
+    uint64_t reported_wave{0};
+    uint64_t generation{0};
+    unsigned socket{0};
+    bool process_is_black{true};
+  };
+
+  katana::PerThreadStorage<ThreadState> data_;
+  std::unique_ptr<katana::CacheLineStorage<Counter>[]> sockets_;
+  unsigned num_sockets_;
+  katana::CacheLineStorage<Counter> global_;
+  katana::CacheLineStorage<std::atomic<uint64_t>> wave_;
+  // Incremented by Init so that threads count themselves once per loop
+  uint64_t generation_{0};
+  // Only used by the thread that ends a wave
+  bool last_was_white_{false};
+
+  bool IsSysMaster() const { return katana::ThreadPool::getTID() == 0; }
+
+  void ResetCounts() {
+    for (unsigned i = 0; i < num_sockets_; ++i) {
+      sockets_[i].get().reports.store(0, std::memory_order_relaxed);
+      sockets_[i].get().is_black.store(false, std::memory_order_relaxed);
+    }
+    global_.get().reports.store(0, std::memory_order_relaxed);
+    global_.get().is_black.store(false, std::memory_order_relaxed);
+  }
+
+  /// Adds a report of the given color to counter; returns true if it was
+  /// the last report of the wave and sets *is_black to the color of the
+  /// wave
+  static bool Report(Counter& counter, bool* is_black) {
+    if (*is_black) {
+      counter.is_black.store(true, std::memory_order_relaxed);
+    }
+    unsigned reports =
+        counter.reports.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (reports < counter.expected.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    // The counter is not reported to again before the next wave, which
+    // starts after this report
+    *is_black = counter.is_black.load(std::memory_order_relaxed);
+    counter.is_black.store(false, std::memory_order_relaxed);
+    counter.reports.store(0, std::memory_order_relaxed);
+    return true;
+  }
+
+protected:
+  void Init(unsigned) override {
+    for (unsigned i = 0; i < num_sockets_; ++i) {
+      sockets_[i].get().expected.store(0, std::memory_order_relaxed);
+    }
+    global_.get().expected.store(0, std::memory_order_relaxed);
+    ResetCounts();
+    generation_ += 1;
+  }
+
+public:
+  HierarchicalTerminationDetection()
+      : num_sockets_(katana::GetThreadPool().getMaxSockets()) {
+    sockets_ =
+        std::make_unique<katana::CacheLineStorage<Counter>[]>(num_sockets_);
+  }
+
+  const char* name() const override { return "hierarchical"; }
+
+  void InitializeThread() override {
+    ThreadState& th = *data_.getLocal();
+    th.process_is_black = true;
+    ResetTerminated();
+    // Threads learn the sockets that take part from the threads that
+    // initialize rather than from the thread pool, since the threads of a
+    // sub-pool are numbered from zero
+    if (th.generation != generation_) {
+      th.generation = generation_;
+      th.socket = katana::ThreadPool::getSocket();
+      Counter& socket = sockets_[th.socket].get();
+      if (socket.expected.fetch_add(1, std::memory_order_relaxed) == 0) {
+        global_.get().expected.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (IsSysMaster()) {
+      // No thread reports before all threads initialize
+      ResetCounts();
+      last_was_white_ = false;
+      wave_.get().fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  void SignalWorked(bool work_happened) override {
+    KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
+    ThreadState& th = *data_.getLocal();
+    th.process_is_black |= work_happened;
+    if (work_happened) {
+      NoteWork();
+    }
+
+    uint64_t wave = wave_.get().load(std::memory_order_acquire);
+    if (wave == th.reported_wave) {
+      return;
+    }
+    th.reported_wave = wave;
+    bool is_black = th.process_is_black;
+    th.process_is_black = false;
+    if (!Report(sockets_[th.socket].get(), &is_black)) {
+      return;
+    }
+    if (!Report(global_.get(), &is_black)) {
+      return;
+    }
+
+    if (last_was_white_ && !is_black) {
+      // This was the second success
+      SetTerminated();
+      return;
+    }
+    last_was_white_ = !is_black;
+    wave_.get().fetch_add(1, std::memory_order_release);
+  }
+};
+
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::CreateRingTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
+std::unique_ptr<katana::TerminationDetection>
+katana::CreateHierarchicalTerminationDetection() {
+  return std::make_unique<HierarchicalTerminationDetection>();
+}
+
+std::unique_ptr<katana::TerminationDetection>
+katana::CreateTerminationDetection() {
+  std::string kind;
+  if (GetEnv("KATANA_TERMINATION", &kind)) {
+    if (kind == "ring") {
+      return CreateRingTerminationDetection();
+    }
+    if (kind == "hierarchical") {
+      return CreateHierarchicalTerminationDetection();
+    }
+    KATANA_LOG_WARN(
+        "unknown KATANA_TERMINATION value {}; expected ring or hierarchical",
+        kind);
+  }
+
+  auto& tp = GetThreadPool();
+  if (tp.getMaxSockets() <= 1 && tp.getMaxUsableThreads() <= kMaxRingThreads) {
+    return CreateRingTerminationDetection();
+  }
+  return CreateHierarchicalTerminationDetection();
+}
+
 struct katana::SharedMem::Impl {
   struct Dependents {
-    LocalTerminationDetection term;
+    std::unique_ptr<TerminationDetection> term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
   };
@@ -222,10 +407,11 @@ katana::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
   impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+      katana::CreateBarrier(impl_->thread_pool.getMaxUsableThreads());
+  impl_->deps->term = katana::CreateTerminationDetection();
 
   internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
+  internal::SetTerminationDetection(impl_->deps->term.get());
   internal::setPagePoolState(&impl_->deps->page_pool);
 }
 
@@ -19,10 +19,19 @@
 
 #include "katana/SharedMemSys.h"
 
+#include <chrono>
+
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+#include "katana/NumaMemoryPool.h"
+#include "katana/ParaMeter.h"
 #include "katana/SharedMem.h"
+#include "katana/SocketArenas.h"
 #include "katana/Statistics.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "tsuba/FileStorage.h"
 #include "tsuba/tsuba.h"
 
@@ -33,6 +42,8 @@ katana::NullCommBackend comm_backend;
 }  // namespace
 
 struct katana::SharedMemSys::Impl {
+  // Initialized first, to time the initialization of the others
+  std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
   katana::SharedMem shared_mem;
   katana::StatManager stat_manager;
 };
@@ -43,11 +54,29 @@ katana::SharedMemSys::SharedMemSys() : impl_(std::make_unique<Impl>()) {
   }
 
   katana::internal::setSysStatManager(&impl_->stat_manager);
+  // Place the Arrow buffers of loads and analytics outputs like LargeArrays
+  katana::GetNumaMemoryPool()->AttachToThreadPool();
+  katana::SetArrowMemoryPool(katana::GetNumaMemoryPool());
+  katana::ReportStatSingle(
+      "SharedMemSys", "StartupTime_ns",
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - impl_->start)
+          .count());
 }
 
 katana::SharedMemSys::~SharedMemSys() {
+  katana::ReportStatSingle(
+      "ThreadPool", "ThreadsStarted",
+      katana::GetThreadPool().getStartedThreads());
+  katana::reportDispatchLatency();
+  katana::ReportTerminationLatency();
+  katana::parameter::ReportParallelismProfiles();
+  katana::ReportSocketArenaStats();
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
+  // The pool stays installed to free its buffers, but it can no longer use
+  // the thread pool
+  katana::GetNumaMemoryPool()->DetachFromThreadPool();
 
   if (auto fini_good = tsuba::Fini(); !fini_good) {
     KATANA_LOG_ERROR("tsuba::Fini: {}", fini_good.error());
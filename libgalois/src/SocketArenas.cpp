@@ -0,0 +1,134 @@
+#include "katana/SocketArenas.h"
+
+#include <cctype>
+#include <mutex>
+#include <string>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+#ifdef KATANA_ENABLE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+namespace {
+
+#ifdef KATANA_ENABLE_JEMALLOC
+
+/// The arena of each socket, indexed by socket ID, or kNoArena
+constexpr unsigned kNoArena = ~0U;
+
+std::mutex arenas_mutex;
+std::vector<unsigned> socket_arenas;
+
+template <typename T>
+bool
+ReadCtl(const std::string& name, T* value) {
+  size_t size = sizeof(T);
+  return mallctl(name.c_str(), value, &size, nullptr, 0) == 0;
+}
+
+/// Refresh the statistics of jemalloc, which are cached until the epoch
+/// advances
+void
+RefreshStats() {
+  uint64_t epoch = 1;
+  size_t size = sizeof(epoch);
+  mallctl("epoch", &epoch, &size, &epoch, size);
+}
+
+uint64_t
+ArenaStat(unsigned arena, const char* stat) {
+  size_t value = 0;
+  if (!ReadCtl(fmt::format("stats.arenas.{}.{}", arena, stat), &value)) {
+    return 0;
+  }
+  return value;
+}
+
+#endif
+
+}  // namespace
+
+bool
+katana::SocketArenasEnabled() {
+#ifdef KATANA_ENABLE_JEMALLOC
+  return !GetEnv("KATANA_DO_NOT_BIND_ARENAS");
+#else
+  return false;
+#endif
+}
+
+void
+katana::internal::BindThreadToSocketArena([[maybe_unused]] unsigned socket) {
+#ifdef KATANA_ENABLE_JEMALLOC
+  if (!SocketArenasEnabled()) {
+    return;
+  }
+  unsigned arena = kNoArena;
+  {
+    std::lock_guard<std::mutex> lock(arenas_mutex);
+    if (socket >= socket_arenas.size()) {
+      socket_arenas.resize(socket + 1, kNoArena);
+    }
+    if (socket_arenas[socket] == kNoArena) {
+      if (!ReadCtl("arenas.create", &socket_arenas[socket])) {
+        KATANA_WARN_ONCE("could not create jemalloc arenas for sockets");
+        socket_arenas[socket] = kNoArena;
+        return;
+      }
+    }
+    arena = socket_arenas[socket];
+  }
+  if (mallctl("thread.arena", nullptr, nullptr, &arena, sizeof(arena)) != 0) {
+    KATANA_WARN_ONCE("could not bind thread to jemalloc arena {}", arena);
+  }
+#endif
+}
+
+std::vector<katana::SocketArenaStats>
+katana::GetSocketArenaStats() {
+  std::vector<SocketArenaStats> stats;
+#ifdef KATANA_ENABLE_JEMALLOC
+  RefreshStats();
+  size_t page_size = 0;
+  ReadCtl("arenas.page", &page_size);
+  std::lock_guard<std::mutex> lock(arenas_mutex);
+  for (unsigned socket = 0; socket < socket_arenas.size(); ++socket) {
+    unsigned arena = socket_arenas[socket];
+    if (arena == kNoArena) {
+      continue;
+    }
+    stats.emplace_back(SocketArenaStats{
+        socket,
+        ArenaStat(arena, "small.allocated") +
+            ArenaStat(arena, "large.allocated"),
+        ArenaStat(arena, "pactive") * page_size,
+        ArenaStat(arena, "resident"),
+    });
+  }
+#endif
+  return stats;
+}
+
+void
+katana::ReportSocketArenaStats() {
+#ifdef KATANA_ENABLE_JEMALLOC
+  for (const SocketArenaStats& s : GetSocketArenaStats()) {
+    std::string prefix = fmt::format("Socket{}", s.socket);
+    ReportStatSingle("SocketArenas", prefix + "Allocated", s.allocated);
+    ReportStatSingle("SocketArenas", prefix + "Active", s.active);
+    ReportStatSingle("SocketArenas", prefix + "Resident", s.resident);
+  }
+  // Totals over all arenas, including those of threads outside the pool
+  size_t value = 0;
+  for (const char* name : {"allocated", "active", "resident", "mapped"}) {
+    if (ReadCtl(fmt::format("stats.{}", name), &value)) {
+      std::string key = name;
+      key[0] = std::toupper(key[0]);
+      ReportStatSingle("SocketArenas", "Total" + key, value);
+    }
+  }
+#endif
+}
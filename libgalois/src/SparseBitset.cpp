@@ -0,0 +1,349 @@
+#include "katana/SparseBitset.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/SimpleLock.h"
+
+namespace {
+
+using Block = katana::SparseBitset::Block;
+
+constexpr uint32_t kWordsPerBlock = katana::SparseBitset::kWordsPerBlock;
+constexpr uint32_t kBitsPerWord = katana::SparseBitset::kBitsPerWord;
+constexpr uint32_t kBitsPerBlock = katana::SparseBitset::kBitsPerBlock;
+
+bool
+IsEmpty(const Block& block) {
+  for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+    if (block.words[w] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+HashCombine(size_t* seed, uint64_t value) {
+  *seed ^= value + 0x9e3779b97f4a7c15ULL + (*seed << 6) + (*seed >> 2);
+}
+
+/// Finds the block with the given index, or where it would be inserted
+template <typename Iterator>
+Iterator
+FindBlock(Iterator first, Iterator last, uint32_t index) {
+  return std::lower_bound(
+      first, last, index,
+      [](const Block& block, uint32_t i) { return block.index < i; });
+}
+
+}  // namespace
+
+bool
+katana::SparseBitset::set(uint32_t i) {
+  uint32_t index = i / kBitsPerBlock;
+  auto it = FindBlock(blocks_.begin(), blocks_.end(), index);
+  if (it == blocks_.end() || it->index != index) {
+    it = blocks_.insert(it, Block{index, {}});
+  }
+  uint64_t& word = it->words[(i % kBitsPerBlock) / kBitsPerWord];
+  uint64_t mask = uint64_t{1} << (i % kBitsPerWord);
+  bool was_set = (word & mask) != 0;
+  word |= mask;
+  return !was_set;
+}
+
+bool
+katana::SparseBitset::test(uint32_t i) const {
+  uint32_t index = i / kBitsPerBlock;
+  auto it = FindBlock(blocks_.begin(), blocks_.end(), index);
+  if (it == blocks_.end() || it->index != index) {
+    return false;
+  }
+  uint64_t word = it->words[(i % kBitsPerBlock) / kBitsPerWord];
+  return (word & (uint64_t{1} << (i % kBitsPerWord))) != 0;
+}
+
+bool
+katana::SparseBitset::UnionWith(const SparseBitset& other) {
+  if (&other == this) {
+    return false;
+  }
+
+  // Count the blocks of other missing from this set
+  size_t missing = 0;
+  for (size_t i = 0, j = 0; j < other.blocks_.size();) {
+    if (i == blocks_.size() || blocks_[i].index > other.blocks_[j].index) {
+      ++missing;
+      ++j;
+    } else if (blocks_[i].index < other.blocks_[j].index) {
+      ++i;
+    } else {
+      ++i;
+      ++j;
+    }
+  }
+
+  bool changed = missing > 0;
+  if (missing == 0) {
+    // Every block of other is already here: or the words in place
+    auto it = blocks_.begin();
+    for (const Block& b : other.blocks_) {
+      it = FindBlock(it, blocks_.end(), b.index);
+      for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+        changed |= (b.words[w] & ~it->words[w]) != 0;
+        it->words[w] |= b.words[w];
+      }
+    }
+    return changed;
+  }
+
+  // Grow once and merge from the back so that every block moves at most
+  // once and no temporary array is needed
+  int64_t i = static_cast<int64_t>(blocks_.size()) - 1;
+  int64_t j = static_cast<int64_t>(other.blocks_.size()) - 1;
+  blocks_.resize(blocks_.size() + missing);
+  int64_t k = static_cast<int64_t>(blocks_.size()) - 1;
+  while (j >= 0) {
+    const Block& b = other.blocks_[j];
+    if (i >= 0 && blocks_[i].index > b.index) {
+      blocks_[k--] = blocks_[i--];
+    } else if (i >= 0 && blocks_[i].index == b.index) {
+      Block merged = blocks_[i--];
+      for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+        merged.words[w] |= b.words[w];
+      }
+      blocks_[k--] = merged;
+      --j;
+    } else {
+      blocks_[k--] = b;
+      --j;
+    }
+  }
+  // The remaining blocks [0, i] are already in place since k == i
+  return changed;
+}
+
+bool
+katana::SparseBitset::DifferenceWith(const SparseBitset& other) {
+  if (&other == this) {
+    bool changed = !blocks_.empty();
+    blocks_.clear();
+    return changed;
+  }
+
+  bool changed = false;
+  size_t out = 0;
+  auto it = other.blocks_.begin();
+  for (Block& b : blocks_) {
+    it = FindBlock(it, other.blocks_.end(), b.index);
+    if (it != other.blocks_.end() && it->index == b.index) {
+      for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+        changed |= (b.words[w] & it->words[w]) != 0;
+        b.words[w] &= ~it->words[w];
+      }
+      if (IsEmpty(b)) {
+        continue;
+      }
+    }
+    blocks_[out++] = b;
+  }
+  blocks_.resize(out);
+  return changed;
+}
+
+bool
+katana::SparseBitset::IsSubsetOf(const SparseBitset& other) const {
+  if (blocks_.size() > other.blocks_.size()) {
+    return false;
+  }
+  auto it = other.blocks_.begin();
+  for (const Block& b : blocks_) {
+    it = FindBlock(it, other.blocks_.end(), b.index);
+    if (it == other.blocks_.end() || it->index != b.index) {
+      return false;
+    }
+    for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+      if ((b.words[w] & ~it->words[w]) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+size_t
+katana::SparseBitset::count() const {
+  size_t count = 0;
+  for (const Block& b : blocks_) {
+    for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+      count += __builtin_popcountll(b.words[w]);
+    }
+  }
+  return count;
+}
+
+size_t
+katana::SparseBitset::Hash() const {
+  size_t seed = blocks_.size();
+  for (const Block& b : blocks_) {
+    HashCombine(&seed, b.index);
+    for (uint32_t w = 0; w < kWordsPerBlock; ++w) {
+      HashCombine(&seed, b.words[w]);
+    }
+  }
+  return seed;
+}
+
+bool
+katana::SparseBitset::operator==(const SparseBitset& other) const {
+  return std::equal(
+      blocks_.begin(), blocks_.end(), other.blocks_.begin(),
+      other.blocks_.end(), [](const Block& a, const Block& b) {
+        return a.index == b.index &&
+               std::equal(a.words, a.words + kWordsPerBlock, b.words);
+      });
+}
+
+std::vector<uint32_t>
+katana::SparseBitset::ToVector() const {
+  std::vector<uint32_t> bits;
+  bits.reserve(count());
+  ForEach([&](uint32_t i) { bits.emplace_back(i); });
+  return bits;
+}
+
+namespace {
+
+constexpr uint32_t kLogNumShards = 6;
+constexpr size_t kNumShards = size_t{1} << kLogNumShards;
+
+using HandlePair = std::pair<
+    katana::SparseBitsetPool::Handle, katana::SparseBitsetPool::Handle>;
+
+struct HandlePairHash {
+  size_t operator()(const HandlePair& p) const {
+    size_t seed = std::hash<const void*>()(p.first);
+    HashCombine(&seed, std::hash<const void*>()(p.second));
+    return seed;
+  }
+};
+
+}  // namespace
+
+struct alignas(katana::KATANA_CACHE_LINE_SIZE) katana::SparseBitsetPool::Shard {
+  katana::SimpleLock lock;
+  //! The interned sets; a deque never moves its elements
+  std::deque<SparseBitset> sets;
+  size_t num_blocks{0};
+  //! The interned sets by hash
+  std::unordered_multimap<size_t, Handle> index;
+  //! Memoized unions by pair of operands, smaller handle first
+  std::unordered_map<HandlePair, Handle, HandlePairHash> unions;
+};
+
+katana::SparseBitsetPool::SparseBitsetPool()
+    : shards_(std::make_unique<Shard[]>(kNumShards)) {
+  empty_ = Intern(SparseBitset{});
+}
+
+katana::SparseBitsetPool::~SparseBitsetPool() = default;
+
+katana::SparseBitsetPool::Shard&
+katana::SparseBitsetPool::ShardFor(size_t hash) const {
+  // The low bits of the hashes pick buckets of the maps inside a shard, so
+  // pick the shard with the high bits of a multiplicative hash
+  return shards_[(hash * 0x9e3779b97f4a7c15ULL) >> (64 - kLogNumShards)];
+}
+
+katana::SparseBitsetPool::Handle
+katana::SparseBitsetPool::Intern(SparseBitset set) {
+  size_t hash = set.Hash();
+  Shard& shard = ShardFor(hash);
+  std::lock_guard<katana::SimpleLock> guard(shard.lock);
+  auto [first, last] = shard.index.equal_range(hash);
+  for (auto it = first; it != last; ++it) {
+    if (*it->second == set) {
+      return it->second;
+    }
+  }
+  set.shrink_to_fit();
+  shard.num_blocks += set.num_blocks();
+  Handle handle = &shard.sets.emplace_back(std::move(set));
+  shard.index.emplace(hash, handle);
+  return handle;
+}
+
+katana::SparseBitsetPool::Handle
+katana::SparseBitsetPool::Union(Handle a, Handle b) {
+  if (a == b || b == empty_) {
+    return a;
+  }
+  if (a == empty_) {
+    return b;
+  }
+  if (b < a) {
+    std::swap(a, b);
+  }
+
+  HandlePair key{a, b};
+  size_t hash = HandlePairHash()(key);
+  Shard& shard = ShardFor(hash);
+  {
+    std::lock_guard<katana::SimpleLock> guard(shard.lock);
+    if (auto it = shard.unions.find(key); it != shard.unions.end()) {
+      return it->second;
+    }
+  }
+
+  Handle result;
+  if (a->IsSubsetOf(*b)) {
+    result = b;
+  } else if (b->IsSubsetOf(*a)) {
+    result = a;
+  } else {
+    // Copy the larger operand so that fewer blocks are inserted
+    bool a_larger = a->num_blocks() >= b->num_blocks();
+    SparseBitset set = a_larger ? *a : *b;
+    set.UnionWith(a_larger ? *b : *a);
+    result = Intern(std::move(set));
+  }
+
+  std::lock_guard<katana::SimpleLock> guard(shard.lock);
+  shard.unions.emplace(key, result);
+  return result;
+}
+
+katana::SparseBitsetPool::Handle
+katana::SparseBitsetPool::Set(Handle a, uint32_t i) {
+  if (a->test(i)) {
+    return a;
+  }
+  SparseBitset set = *a;
+  set.set(i);
+  return Intern(std::move(set));
+}
+
+size_t
+katana::SparseBitsetPool::size() const {
+  size_t size = 0;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    std::lock_guard<katana::SimpleLock> guard(shards_[i].lock);
+    size += shards_[i].sets.size();
+  }
+  return size;
+}
+
+size_t
+katana::SparseBitsetPool::num_blocks() const {
+  size_t num_blocks = 0;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    std::lock_guard<katana::SimpleLock> guard(shards_[i].lock);
+    num_blocks += shards_[i].num_blocks;
+  }
+  return num_blocks;
+}
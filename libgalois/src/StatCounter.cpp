@@ -0,0 +1,102 @@
+#include "katana/StatCounter.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/HWTopo.h"
+
+namespace {
+
+bool
+InitiallyEnabled() {
+  bool enabled = true;
+  katana::GetEnv("KATANA_STAT_COUNTERS", &enabled);
+  return enabled;
+}
+
+class Registry {
+  struct Counter {
+    std::string region;
+    std::string category;
+    std::unique_ptr<katana::StatCounter::Slot[]> slots;
+  };
+
+  std::mutex mutex_;
+  std::vector<Counter> counters_;
+  std::map<std::pair<std::string, std::string>, uint32_t> ids_;
+  unsigned num_slots_;
+
+public:
+  Registry() : num_slots_(katana::getHWTopo().machineTopoInfo.maxThreads) {}
+
+  std::pair<katana::StatCounter::Slot*, uint32_t> Register(
+      const std::string& region, const std::string& category) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] =
+        ids_.emplace(std::make_pair(region, category), counters_.size());
+    if (inserted) {
+      counters_.emplace_back(Counter{
+          .region = region,
+          .category = category,
+          .slots = std::make_unique<katana::StatCounter::Slot[]>(num_slots_),
+      });
+    }
+    return {counters_[it->second].slots.get(), it->second};
+  }
+
+  unsigned num_slots() const { return num_slots_; }
+
+  template <typename F>
+  void Drain(const F& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Counter& counter : counters_) {
+      for (unsigned tid = 0; tid < num_slots_; ++tid) {
+        uint64_t value = counter.slots[tid].data.exchange(0);
+        if (value != 0) {
+          fn(counter.region, counter.category, tid, value);
+        }
+      }
+    }
+  }
+};
+
+Registry&
+GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+}  // namespace
+
+std::atomic<bool> katana::internal::stat_counters_enabled{InitiallyEnabled()};
+
+katana::StatCounter::StatCounter(
+    const std::string& region, const std::string& category) {
+  std::tie(slots_, id_) = GetRegistry().Register(region, category);
+}
+
+uint64_t
+katana::StatCounter::Total() const {
+  uint64_t total = 0;
+  for (unsigned tid = 0, n = GetRegistry().num_slots(); tid < n; ++tid) {
+    total += slots_[tid].data.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void
+katana::SetStatCountersEnabled(bool enabled) {
+  internal::stat_counters_enabled = enabled;
+}
+
+void
+katana::internal::DrainStatCounters(
+    const std::function<void(
+        const std::string& region, const std::string& category,
+        unsigned tid, uint64_t value)>& fn) {
+  GetRegistry().Drain(fn);
+}
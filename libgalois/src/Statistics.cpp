@@ -22,13 +22,16 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/PageAlloc.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/StatCounter.h"
 
 namespace {
 
@@ -65,6 +68,15 @@ struct StatImpl {
     perThreadManagers_.getLocal()->addToStat(region, category, val, type);
   }
 
+  /// Add val to the statistics of thread tid. Only safe while no other
+  /// thread adds statistics.
+  void AddForThread(
+      unsigned tid, const katana::gstl::Str& region,
+      const katana::gstl::Str& category, const T& val,
+      const katana::StatTotal::Type& type) {
+    perThreadManagers_.getRemote(tid)->addToStat(region, category, val, type);
+  }
+
   void Merge() {
     if (merged_) {
       return;
@@ -196,6 +208,18 @@ katana::StatManager::param_cend() const -> param_const_iterator {
 
 void
 katana::StatManager::MergeStats() {
+  if (!impl_->int_stats_.merged_) {
+    unsigned num_threads = impl_->int_stats_.perThreadManagers_.size();
+    internal::DrainStatCounters([&](const std::string& region,
+                                    const std::string& category, unsigned tid,
+                                    uint64_t value) {
+      // Threads beyond those the statistics were collected for are counted
+      // with the last one
+      impl_->int_stats_.AddForThread(
+          std::min(tid, num_threads - 1), gstl::makeStr(region),
+          gstl::makeStr(category), value, StatTotal::TSUM);
+    });
+  }
   impl_->int_stats_.Merge();
   impl_->fp_stats_.Merge();
   impl_->str_stats_.Merge();
@@ -292,6 +316,15 @@ katana::reportPageAlloc(const char* category) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+
+  PageAllocCounts counts = GetPageAllocCounts();
+  std::string prefix(category);
+  ReportStatSingle("PageAlloc", prefix + "_HugeTLBPages", counts.explicit_huge);
+  ReportStatSingle(
+      "PageAlloc", prefix + "_TransparentHugePages", counts.transparent_huge);
+  ReportStatSingle("PageAlloc", prefix + "_RegularPages", counts.regular);
+  ReportStatSingle(
+      "PageAlloc", prefix + "_HugeTLBFailures", counts.explicit_huge_failures);
 }
 
 void
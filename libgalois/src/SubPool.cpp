@@ -0,0 +1,60 @@
+#include "katana/SubPool.h"
+
+#include "katana/ErrorCode.h"
+
+katana::Result<std::unique_ptr<katana::SubPool>>
+katana::SubPool::Make(unsigned num_threads) {
+  ThreadPool& tp = GetThreadPool();
+  if (ThreadPool::getCurrentTeam() || tp.isRunning()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "sub-pools cannot be made inside a parallel section or a sub-pool");
+  }
+  unsigned usable = tp.getMaxUsableThreads();
+  if (num_threads == 0 || num_threads >= usable) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot carve {} of {} usable threads; the main pool needs at least "
+        "one",
+        num_threads, usable);
+  }
+
+  auto barrier = CreateCountingBarrier(num_threads);
+  auto term = CreateTerminationDetection();
+  ThreadPool::Team* team =
+      tp.carveTeam(num_threads, barrier.get(), term.get());
+  return std::unique_ptr<SubPool>(
+      new SubPool(team, std::move(barrier), std::move(term)));
+}
+
+katana::Result<std::unique_ptr<katana::SubPool>>
+katana::SubPool::MakeForNumaNode() {
+  ThreadPool& tp = GetThreadPool();
+  if (ThreadPool::getCurrentTeam()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "sub-pools cannot be made inside a sub-pool");
+  }
+  unsigned usable = tp.getMaxUsableThreads();
+  unsigned node = tp.getNumaNode(usable - 1);
+  unsigned num_threads = 0;
+  while (num_threads < usable &&
+         tp.getNumaNode(usable - 1 - num_threads) == node) {
+    ++num_threads;
+  }
+  if (num_threads == usable) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "all {} usable threads are on NUMA node {}; the main pool needs at "
+        "least one",
+        usable, node);
+  }
+  return Make(num_threads);
+}
+
+katana::SubPool::~SubPool() { GetThreadPool().releaseTeam(team_); }
+
+void
+katana::SubPool::Run(const std::function<void()>& fn) {
+  GetThreadPool().runOnTeam(team_, fn);
+}
@@ -0,0 +1,254 @@
+#include "katana/Subgraph.h"
+
+#include <arrow/compute/api.h>
+
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Dense IDs of the nodes set in a node mask, from a parallel prefix sum of
+/// the number of set bits in each word of the mask
+class NodeCompaction {
+public:
+  explicit NodeCompaction(const katana::DynamicBitset& mask) : mask_(mask) {
+    size_t num_words = mask.get_vec().size();
+    word_ends_.allocateBlocked(num_words);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_words),
+        [&](size_t w) {
+          word_ends_[w] = __builtin_popcountll(mask.GetWord(w));
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        word_ends_.begin(), word_ends_.end(), word_ends_.begin());
+  }
+
+  uint64_t num_nodes() const {
+    return word_ends_.size() > 0 ? word_ends_[word_ends_.size() - 1] : 0;
+  }
+
+  bool contains(Node n) const { return mask_.test(n); }
+
+  /// The new ID of node n, which must be in the mask
+  Node NewId(Node n) const {
+    size_t w = n / katana::DynamicBitset::kNumBitsInUint64;
+    size_t b = n % katana::DynamicBitset::kNumBitsInUint64;
+    uint64_t below = mask_.GetWord(w) & ((uint64_t{1} << b) - 1);
+    return WordBegin(w) + __builtin_popcountll(below);
+  }
+
+  /// Write the original ID of each new node to original[new ID]
+  void FillOriginal(Node* original) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, word_ends_.size()),
+        [&](size_t w) {
+          uint64_t word = mask_.GetWord(w);
+          uint64_t out = WordBegin(w);
+          while (word != 0) {
+            size_t b = __builtin_ctzll(word);
+            original[out++] = w * katana::DynamicBitset::kNumBitsInUint64 + b;
+            word &= word - 1;
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  uint64_t WordBegin(size_t w) const { return w > 0 ? word_ends_[w - 1] : 0; }
+
+  const katana::DynamicBitset& mask_;
+  katana::LargeArray<uint64_t> word_ends_;
+};
+
+/// Gather the rows at indices of the named properties, where property(i)
+/// returns property i of schema, or of all properties if names is null
+template <typename PropertyFn>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::vector<std::string>* names, PropertyFn property,
+    const std::shared_ptr<arrow::Array>& indices, const char* kind) {
+  std::vector<int> selected;
+  if (names) {
+    for (const std::string& name : *names) {
+      int i = schema->GetFieldIndex(name);
+      if (i < 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::PropertyNotFound, "{} property {} not found",
+            kind, name);
+      }
+      selected.emplace_back(i);
+    }
+  } else {
+    for (int i = 0; i < schema->num_fields(); ++i) {
+      selected.emplace_back(i);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i : selected) {
+    std::shared_ptr<arrow::ChunkedArray> column = property(i);
+    if (!column) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "loading {} property {}", kind,
+          schema->field(i)->name());
+    }
+    auto res = arrow::compute::Take(column, indices);
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "gathering {} property {}: {}", kind,
+          schema->field(i)->name(), res.status());
+    }
+    fields.emplace_back(schema->field(i));
+    columns.emplace_back(res.ValueOrDie().chunked_array());
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+}  // namespace
+
+katana::Result<katana::Subgraph>
+katana::ExtractSubgraph(
+    const PropertyGraph& pg, const DynamicBitset& node_mask,
+    const DynamicBitset* edge_mask, const SubgraphProperties& properties) {
+  const GraphTopology& topology = pg.topology();
+  if (node_mask.size() != topology.num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node mask has {} bits but {} nodes",
+        node_mask.size(), topology.num_nodes());
+  }
+  if (edge_mask && edge_mask->size() != topology.num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge mask has {} bits but {} edges",
+        edge_mask->size(), topology.num_edges());
+  }
+
+  NodeCompaction nodes(node_mask);
+  uint64_t num_nodes = nodes.num_nodes();
+
+  auto original_nodes_res =
+      Allocate(num_nodes * sizeof(Node), "original nodes");
+  if (!original_nodes_res) {
+    return original_nodes_res.error();
+  }
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> original_nodes_buffer =
+      original_nodes_res.value();
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  auto* original_nodes =
+      reinterpret_cast<Node*>(original_nodes_buffer->mutable_data());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  nodes.FillOriginal(original_nodes);
+
+  auto keep = [&](GraphTopology::Edge e) {
+    return (!edge_mask || edge_mask->test(e)) &&
+           nodes.contains(topology.edge_dest(e));
+  };
+
+  // First pass: count the edges kept for each node
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = 0;
+        for (auto e : topology.edges(original_nodes[n])) {
+          degree += keep(e);
+        }
+        indices[n] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+  uint64_t num_edges = num_nodes > 0 ? indices[num_nodes - 1] : 0;
+
+  auto dests_res = Allocate(num_edges * sizeof(Node), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto original_edges_res =
+      Allocate(num_edges * sizeof(uint64_t), "original edges");
+  if (!original_edges_res) {
+    return original_edges_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  std::shared_ptr<arrow::Buffer> original_edges_buffer =
+      original_edges_res.value();
+  auto* dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+  auto* original_edges =
+      reinterpret_cast<uint64_t*>(original_edges_buffer->mutable_data());
+
+  // Second pass: write the kept edges with their destinations renumbered
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n > 0 ? indices[n - 1] : 0;
+        for (auto e : topology.edges(original_nodes[n])) {
+          if (keep(e)) {
+            dests[out] = nodes.NewId(topology.edge_dest(e));
+            original_edges[out] = e;
+            ++out;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  Subgraph subgraph;
+  subgraph.original_nodes =
+      std::make_shared<arrow::UInt32Array>(num_nodes, original_nodes_buffer);
+  subgraph.original_edges =
+      std::make_shared<arrow::UInt64Array>(num_edges, original_edges_buffer);
+  subgraph.graph = std::make_unique<PropertyGraph>();
+  if (auto res = subgraph.graph->SetTopology(GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+      });
+      !res) {
+    return res.error();
+  }
+
+  auto node_props_res = TakeProperties(
+      pg.node_schema(), properties.node_properties,
+      [&](int i) { return pg.GetNodeProperty(i); }, subgraph.original_nodes,
+      "node");
+  if (!node_props_res) {
+    return node_props_res.error();
+  }
+  if (auto res = subgraph.graph->AddNodeProperties(node_props_res.value());
+      !res) {
+    return res.error();
+  }
+
+  auto edge_props_res = TakeProperties(
+      pg.edge_schema(), properties.edge_properties,
+      [&](int i) { return pg.GetEdgeProperty(i); }, subgraph.original_edges,
+      "edge");
+  if (!edge_props_res) {
+    return edge_props_res.error();
+  }
+  if (auto res = subgraph.graph->AddEdgeProperties(edge_props_res.value());
+      !res) {
+    return res.error();
+  }
+
+  return Result<Subgraph>(std::move(subgraph));
+}
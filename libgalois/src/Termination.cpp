@@ -17,12 +17,62 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <chrono>
+
 #include "katana/Logging.h"
+#include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
 
+void
+katana::TerminationDetection::SetTerminated() {
+  // Every thread reported its last work before the report that let this
+  // thread detect termination, so no thread writes its time concurrently
+  uint64_t now = NowNs();
+  uint64_t last_work = 0;
+  for (unsigned i = 0; i < num_threads_; ++i) {
+    last_work = std::max(last_work, *last_work_ns_.getRemote(i));
+  }
+  uint64_t latency = now > last_work ? now - last_work : 0;
+  stats_.detections += 1;
+  stats_.total_ns += latency;
+  stats_.max_ns = std::max(stats_.max_ns, latency);
+
+  global_term_ = true;
+}
+
+void
+katana::TerminationDetection::ResetTerminated() {
+  *last_work_ns_.getLocal() = NowNs();
+  global_term_ = false;
+}
+
+void
+katana::TerminationDetection::NoteWork() {
+  *last_work_ns_.getLocal() = NowNs();
+}
+
+void
+katana::TerminationDetection::Reinit(unsigned active_threads) {
+  num_threads_ = active_threads;
+  Init(active_threads);
+}
+
 static katana::TerminationDetection* kTerminationDetection = nullptr;
 
 void
@@ -35,6 +85,29 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+  // A sub-pool detects termination on its own instance
+  katana::TerminationDetection* term = kTerminationDetection;
+  if (auto* team = ThreadPool::getCurrentTeam()) {
+    term = team->term;
+  }
+  term->Reinit(active_threads);
+  return *term;
+}
+
+void
+katana::ReportTerminationLatency() {
+  if (!kTerminationDetection) {
+    return;
+  }
+  auto stats = kTerminationDetection->GetDetectionStats();
+  if (stats.detections == 0) {
+    return;
+  }
+  katana::ReportParam("Termination", "Detector", kTerminationDetection->name());
+  katana::ReportStatSingle("Termination", "Detections", stats.detections);
+  katana::ReportStatSingle(
+      "Termination", "DetectionLatencyMean_ns",
+      stats.total_ns / stats.detections);
+  katana::ReportStatSingle(
+      "Termination", "DetectionLatencyMax_ns", stats.max_ns);
 }
@@ -20,17 +20,22 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
+#include "katana/SocketArenas.h"
+#include "katana/Trace.h"
 
 // Forward declare this to avoid including PerThreadStorage.
 // We avoid this to stress that the thread Pool MUST NOT depend on PTS.
 namespace katana {
 
 extern void initPTS(unsigned);
+extern void initPTSForThread(unsigned, unsigned);
+extern void setPSSBase(unsigned);
 
 }
 
@@ -38,25 +43,60 @@ using katana::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
+namespace {
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
-      masterFastmode(false),
-      running(false) {
+    : started(0), reserved(0), masterFastmode(false), spinWaitNs(0) {
+  HWTopoInfo topo = getHWTopo();
+  mi = topo.machineTopoInfo;
+  topos = std::move(topo.threadTopoInfo);
+
+  int spin_us = 0;
+  if (GetEnv("KATANA_SPIN_WAIT_US", &spin_us) && spin_us > 0) {
+    setSpinWait(std::chrono::microseconds(spin_us));
+  }
   signals.resize(mi.maxThreads);
   initThread(0);
+  started = 1;
+
+  bool lazy = false;
+  if (GetEnv("KATANA_LAZY_THREADS", &lazy) && lazy) {
+    // Per-thread storage is laid out for all threads when it is allocated,
+    // so threads that start later need theirs now
+    for (unsigned i = 1; i < mi.maxThreads; ++i) {
+      initPTSForThread(i, topos[i].socketLeader);
+    }
+  } else {
+    startThreads(mi.maxThreads);
+  }
+}
 
-  for (unsigned i = 1; i < mi.maxThreads; ++i) {
+void
+ThreadPool::startThreads(unsigned num) {
+  if (num <= started) {
+    return;
+  }
+  for (unsigned i = started; i < num; ++i) {
     std::thread t(&ThreadPool::threadLoop, this, i);
     threads.emplace_back(std::move(t));
   }
 
   // we don't want signals to have to contain atomics, since they are set once
-  while (std::any_of(signals.begin(), signals.end(), [](per_signal* p) {
-    return !p || !p->done;
-  })) {
+  while (std::any_of(
+      signals.begin() + started, signals.begin() + num,
+      [](per_signal* p) { return !p || !p->done; })) {
     std::atomic_thread_fence(std::memory_order_seq_cst);
   }
+  started = num;
 }
 
 ThreadPool::~ThreadPool() {
@@ -68,12 +108,18 @@ ThreadPool::~ThreadPool() {
 
 void
 ThreadPool::destroyCommon() {
+  KATANA_LOG_VASSERT(
+      subTeams.empty(), "SubPools must be destroyed before the thread pool");
   beKind();  // reset fastmode
-  run(mi.maxThreads, []() { throw shutdown_ty(); });
+  run(started, []() { throw shutdown_ty(); });
 }
 
 void
 ThreadPool::burnPower(unsigned num) {
+  // sub-pools never spin
+  if (getCurrentTeam()) {
+    return;
+  }
   num = std::min(num, getMaxUsableThreads());
 
   // changing number of threads?  just do a reset
@@ -88,7 +134,7 @@ ThreadPool::burnPower(unsigned num) {
 
 void
 ThreadPool::beKind() {
-  if (masterFastmode) {
+  if (masterFastmode && !getCurrentTeam()) {
     run(masterFastmode, []() { throw fastmode_ty{false}; });
     masterFastmode = 0;
   }
@@ -129,9 +175,12 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = topos[tid];
+  my_box.view = my_box.topo;
+  my_box.team = my_box.adopted = &mainTeam;
   // Initialize
   initPTS(mi.maxThreads);
+  SetTraceThreadName(fmt::format("worker {}", tid));
 
   if (!GetEnv("KATANA_DO_NOT_BIND_THREADS")) {
     bool bind_main = false;
@@ -149,6 +198,9 @@ ThreadPool::initThread(unsigned tid) {
       bindThreadSelf(my_box.topo.osContext);
     }
   }
+  // After binding, so that the arena of the socket is created and first
+  // touched by one of its threads
+  katana::internal::BindThreadToSocketArena(my_box.topo.socket);
   my_box.done = 1;
 }
 
@@ -158,10 +210,20 @@ ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, spinWaitNs.load(std::memory_order_relaxed));
+    if (me.adopted != me.team) {
+      adoptTeam();
+    }
+    // record when the last thread started
+    uint64_t now = NowNs();
+    auto& last = me.team->dispatch_last;
+    uint64_t prev = last.load(std::memory_order_relaxed);
+    while (prev < now &&
+           !last.compare_exchange_weak(prev, now, std::memory_order_relaxed)) {
+    }
     cascade(fastmode);
     try {
-      work();
+      me.team->work();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -170,6 +232,11 @@ ThreadPool::threadLoop(unsigned tid) {
       me.done = 1;
       dt.fn();
       return;
+    } catch (const team_ty& t) {
+      // serveTeam signals done itself and leaves done set when the team is
+      // released, so skip decascade
+      serveTeam(*t.team);
+      continue;
     } catch (const std::exception& exc) {
       // catch anything thrown within try block that derives from std::exception
       std::cerr << exc.what();
@@ -214,12 +281,14 @@ ThreadPool::cascade(bool fastmode) {
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
 
   auto* child1 = signals[me.wbegin];
+  child1->team = me.team;
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
     auto* child2 = signals[midpoint];
+    child2->team = me.team;
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
     child2->wakeup(fastmode);
@@ -227,32 +296,175 @@ ThreadPool::cascade(bool fastmode) {
 }
 
 void
-ThreadPool::runInternal(unsigned num) {
+ThreadPool::runInternal(Team& team, unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  KATANA_LOG_VASSERT(
+      !team.running, "Recursive thread pool execution not supported");
+  team.running = true;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
-  // my_box is tid 0
+  startThreads(team.begin + num);
+  // my_box is tid 0 of team
   auto& me = my_box;
-  me.wbegin = 1;
-  me.wend = num;
+  me.team = &team;
+  me.wbegin = team.begin + 1;
+  me.wend = team.begin + num;
+
+  if (num > 1) {
+    uint64_t now = NowNs();
+    team.dispatch_begin.store(now, std::memory_order_relaxed);
+    team.dispatch_last.store(now, std::memory_order_relaxed);
+  }
 
-  KATANA_LOG_DEBUG_ASSERT(!masterFastmode || masterFastmode == num);
+  bool fastmode = false;
+  if (&team == &mainTeam) {
+    KATANA_LOG_DEBUG_ASSERT(!masterFastmode || masterFastmode == num);
+    fastmode = masterFastmode;
+  }
   // launch threads
-  cascade(masterFastmode);
+  cascade(fastmode);
   // Do master thread work
   try {
-    work();
+    team.work();
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
   }
   // wait for children
   decascade();
+  if (num > 1) {
+    uint64_t latency = team.dispatch_last.load(std::memory_order_relaxed) -
+                       team.dispatch_begin.load(std::memory_order_relaxed);
+    DispatchStats& stats = team.dispatch_stats;
+    stats.runs += 1;
+    stats.total_ns += latency;
+    stats.max_ns = std::max(stats.max_ns, latency);
+  }
   // Clean up
-  work = nullptr;
-  running = false;
+  team.work = nullptr;
+  team.running = false;
+}
+
+void
+ThreadPool::adoptTeam() {
+  auto& me = my_box;
+  me.adopted = me.team;
+  me.view = me.topo;
+  me.team_begin = 0;
+  if (me.team != &mainTeam) {
+    me.team_begin = me.team->begin;
+    me.view.tid = me.topo.tid - me.team_begin;
+    me.view.socketLeader = 0;
+    me.view.socket = 0;
+    me.view.cumulativeMaxSocket = 0;
+  }
+  // a sub-pool shares the per-socket storage of its first thread
+  setPSSBase(me.team_begin ? me.team_begin : me.topo.tid);
+}
+
+void
+ThreadPool::serveTeam(Team& team) {
+  auto& me = my_box;
+  me.team = &team;
+  adoptTeam();
+  me.done = 1;
+
+  std::unique_lock<std::mutex> lg(team.jobs_mutex);
+  while (true) {
+    team.jobs_cv.wait(lg, [&] { return team.closing || !team.jobs.empty(); });
+    if (team.jobs.empty()) {
+      break;
+    }
+    TeamJob* job = team.jobs.front();
+    team.jobs.pop_front();
+    lg.unlock();
+    try {
+      (*job->fn)();
+    } catch (...) {
+      job->error = std::current_exception();
+    }
+    lg.lock();
+    job->done = true;
+    team.jobs_cv.notify_all();
+  }
+
+  me.team = &mainTeam;
+  adoptTeam();
+  team.closed = true;
+  team.jobs_cv.notify_all();
+}
+
+ThreadPool::Team*
+ThreadPool::carveTeam(
+    unsigned num, Barrier* barrier, TerminationDetection* term) {
+  KATANA_LOG_VASSERT(
+      !getCurrentTeam() && !mainTeam.running,
+      "Can't carve a sub-pool inside a parallel section or a sub-pool");
+  KATANA_LOG_VASSERT(
+      num > 0 && num < getMaxUsableThreads(), "Can't carve {} of {} threads",
+      num, getMaxUsableThreads());
+  beKind();
+
+  startThreads(mi.maxThreads - reserved);
+  auto team = std::make_unique<Team>();
+  team->begin = mi.maxThreads - reserved - num;
+  team->size = num;
+  team->active_threads = num;
+  team->barrier = barrier;
+  team->barrier_threads = num;
+  team->term = term;
+  reserved += num;
+
+  Team* t = team.get();
+  mainTeam.work = [t]() { throw team_ty{t}; };
+  auto* child = signals[t->begin];
+  child->team = &mainTeam;
+  child->wbegin = 0;
+  child->wend = 0;
+  child->done = 0;
+  child->wakeup(false);
+  while (!child->done) {
+    asmPause();
+  }
+  mainTeam.work = nullptr;
+
+  subTeams.emplace_back(std::move(team));
+  return t;
+}
+
+void
+ThreadPool::releaseTeam(Team* team) {
+  KATANA_LOG_VASSERT(
+      !subTeams.empty() && subTeams.back().get() == team &&
+          team->begin == mi.maxThreads - reserved,
+      "SubPools must be destroyed in the reverse order of creation");
+  {
+    std::unique_lock<std::mutex> lg(team->jobs_mutex);
+    team->closing = true;
+    team->jobs_cv.notify_all();
+    team->jobs_cv.wait(lg, [=] { return team->closed; });
+  }
+  // The other threads are idle; make them adopt the main team when next
+  // woken, even if a later team reuses this address
+  for (unsigned i = team->begin + 1; i < team->begin + team->size; ++i) {
+    signals[i]->adopted = nullptr;
+  }
+  reserved -= team->size;
+  subTeams.pop_back();
+}
+
+void
+ThreadPool::runOnTeam(Team* team, const std::function<void(void)>& fn) {
+  KATANA_LOG_VASSERT(
+      getCurrentTeam() != team, "A SubPool job can't wait on its own SubPool");
+  TeamJob job{&fn};
+  std::unique_lock<std::mutex> lg(team->jobs_mutex);
+  team->jobs.push_back(&job);
+  team->jobs_cv.notify_all();
+  team->jobs_cv.wait(lg, [&] { return job.done; });
+  if (job.error) {
+    std::rethrow_exception(job.error);
+  }
 }
 
 void
@@ -261,12 +473,15 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   // thread but we don't want to depend on katana symbols and too many
   // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
-      !running, "Can't start dedicated thread during parallel section");
+      !getCurrentTeam() && !mainTeam.running,
+      "Can't start dedicated thread during parallel section");
+  startThreads(mi.maxThreads - reserved);
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
-  work = [&f]() { throw dedicated_ty{f}; };
+  mainTeam.work = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
+  child->team = &mainTeam;
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
@@ -274,7 +489,7 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   while (!child->done) {
     asmPause();
   }
-  work = nullptr;
+  mainTeam.work = nullptr;
 }
 
 static katana::ThreadPool* TPOOL = nullptr;
@@ -20,7 +20,10 @@
 #include "katana/Threads.h"
 
 #include <algorithm>
+#include <string>
 
+#include "katana/HWTopo.h"
+#include "katana/Statistics.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -30,11 +33,47 @@ unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (auto* team = katana::ThreadPool::getCurrentTeam()) {
+    team->active_threads = num;
+  } else {
+    katana::activeThreads = num;
+  }
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
+  if (auto* team = katana::ThreadPool::getCurrentTeam()) {
+    return team->active_threads;
+  }
   return katana::activeThreads;
 }
+
+void
+katana::reportThreadPlacement() {
+  auto& tp = katana::GetThreadPool();
+  std::string cpus;
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    if (i > 0) {
+      cpus += ",";
+    }
+    cpus += std::to_string(tp.getOSContext(i));
+  }
+  katana::ReportParam(
+      "ThreadPool", "Placement",
+      katana::ThreadPlacementName(katana::GetThreadPlacement()));
+  katana::ReportParam("ThreadPool", "CPUs", cpus);
+}
+
+void
+katana::reportDispatchLatency() {
+  auto stats = katana::GetThreadPool().getDispatchStats();
+  if (stats.runs == 0) {
+    return;
+  }
+  katana::ReportStatSingle("ThreadPool", "ParallelRuns", stats.runs);
+  katana::ReportStatSingle(
+      "ThreadPool", "DispatchLatencyMean_ns", stats.total_ns / stats.runs);
+  katana::ReportStatSingle(
+      "ThreadPool", "DispatchLatencyMax_ns", stats.max_ns);
+}
@@ -0,0 +1,324 @@
+#include "katana/analytics/FusedScan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+
+#include "katana/DynamicBitset.h"
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/Intersection.h"
+
+namespace {
+
+constexpr unsigned kChunkSize = 64U;
+
+/// The scratch space of a thread
+struct ScanWorkspace {
+  /// The common out-neighbors of two nodes in the orientation
+  std::vector<uint32_t> common;
+  /// Entry k counts the neighbors shared with compare node k
+  std::vector<uint32_t> shared;
+};
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t bytes) {
+  auto res = arrow::AllocateBuffer(bytes);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", bytes,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+template <typename T>
+T*
+Values(const std::shared_ptr<arrow::Buffer>& buffer) {
+  return reinterpret_cast<T*>(buffer->mutable_data());
+}
+
+/// An array of counters that threads increment concurrently
+katana::LargeArray<std::atomic<uint64_t>>
+MakeCounters(uint64_t num_nodes) {
+  katana::LargeArray<std::atomic<uint64_t>> counters;
+  counters.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { counters.constructAt(n, 0); }, katana::no_stats());
+  return counters;
+}
+
+}  // namespace
+
+katana::analytics::FusedScan&
+katana::analytics::FusedScan::AddOutDegree(const std::string& property) {
+  out_degree_property_ = property;
+  return *this;
+}
+
+katana::analytics::FusedScan&
+katana::analytics::FusedScan::AddInDegree(const std::string& property) {
+  in_degree_property_ = property;
+  return *this;
+}
+
+katana::analytics::FusedScan&
+katana::analytics::FusedScan::AddJaccard(
+    uint32_t compare_node, const std::string& property) {
+  jaccard_kernels_.emplace_back(JaccardKernel{compare_node, property});
+  return *this;
+}
+
+katana::analytics::FusedScan&
+katana::analytics::FusedScan::AddTriangleCount(const std::string& property) {
+  triangle_property_ = property;
+  return *this;
+}
+
+katana::analytics::FusedScan&
+katana::analytics::FusedScan::AddLocalClusteringCoefficient(
+    const std::string& property) {
+  clustering_property_ = property;
+  return *this;
+}
+
+katana::Result<katana::analytics::FusedScanSummary>
+katana::analytics::FusedScan::Run(
+    PropertyGraph* pg, uint32_t num_bins) const {
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  std::vector<std::string> names;
+  for (const std::string* name :
+       {&out_degree_property_, &in_degree_property_, &triangle_property_,
+        &clustering_property_}) {
+    if (!name->empty()) {
+      names.emplace_back(*name);
+    }
+  }
+  for (const auto& kernel : jaccard_kernels_) {
+    if (kernel.property.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "Jaccard property name is empty");
+    }
+    if (kernel.compare_node >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "compare node {} is not in the graph",
+          kernel.compare_node);
+    }
+    names.emplace_back(kernel.property);
+  }
+  std::set<std::string> unique;
+  for (const auto& name : names) {
+    if (!unique.emplace(name).second) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "property {} is registered twice", name);
+    }
+    if (pg->node_schema()->GetFieldIndex(name) != -1) {
+      return KATANA_ERROR(
+          ErrorCode::AlreadyExists, "node property {} already exists", name);
+    }
+  }
+
+  bool want_out_degrees = !out_degree_property_.empty();
+  bool want_in_degrees = !in_degree_property_.empty();
+  bool want_triangles =
+      !triangle_property_.empty() || !clustering_property_.empty();
+  uint64_t num_jaccard = jaccard_kernels_.size();
+
+  std::shared_ptr<const DegreeOrderedDag> dag;
+  if (want_triangles) {
+    auto dag_res = pg->OrientByDegree();
+    if (!dag_res) {
+      return dag_res.error().WithContext("orienting the topology");
+    }
+    dag = std::move(dag_res.value());
+  }
+
+  std::shared_ptr<arrow::Buffer> out_degrees;
+  if (want_out_degrees) {
+    auto res = Allocate(num_nodes * sizeof(uint64_t));
+    if (!res) {
+      return res.error();
+    }
+    out_degrees = std::move(res.value());
+  }
+  std::vector<std::shared_ptr<arrow::Buffer>> similarities;
+  std::vector<DynamicBitset> compare_neighbors(num_jaccard);
+  for (uint64_t k = 0; k < num_jaccard; ++k) {
+    auto res = Allocate(num_nodes * sizeof(double));
+    if (!res) {
+      return res.error();
+    }
+    similarities.emplace_back(std::move(res.value()));
+    compare_neighbors[k].resize(num_nodes);
+    for (auto e : topology.edges(jaccard_kernels_[k].compare_node)) {
+      compare_neighbors[k].set(topology.edge_dest(e));
+    }
+  }
+  LargeArray<std::atomic<uint64_t>> in_degrees;
+  if (want_in_degrees) {
+    in_degrees = MakeCounters(num_nodes);
+  }
+  LargeArray<std::atomic<uint64_t>> triangles;
+  if (want_triangles) {
+    triangles = MakeCounters(num_nodes);
+  }
+
+  PerThreadStorage<ScanWorkspace> workspaces;
+  GAccumulator<uint64_t> num_triangles;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        ScanWorkspace* ws = workspaces.getLocal();
+        uint64_t degree = topology.edges(n).size();
+        if (want_out_degrees) {
+          Values<uint64_t>(out_degrees)[n] = degree;
+        }
+
+        if (want_in_degrees || num_jaccard > 0) {
+          ws->shared.assign(num_jaccard, 0);
+          auto [begin, end] = EdgeDestRange(topology, n);
+          for (const uint32_t* dest = begin; dest != end; ++dest) {
+            if (want_in_degrees) {
+              in_degrees[*dest].fetch_add(1, std::memory_order_relaxed);
+            }
+            for (uint64_t k = 0; k < num_jaccard; ++k) {
+              ws->shared[k] += compare_neighbors[k].test(*dest);
+            }
+          }
+          for (uint64_t k = 0; k < num_jaccard; ++k) {
+            uint32_t compare_node = jaccard_kernels_[k].compare_node;
+            uint64_t union_size = topology.edges(compare_node).size() +
+                                  degree - ws->shared[k];
+            Values<double>(similarities[k])[n] =
+                union_size > 0
+                    ? static_cast<double>(ws->shared[k]) / union_size
+                    : 1;
+          }
+        }
+
+        if (want_triangles) {
+          // Each triangle is found once, from its lowest ranked node, and
+          // credited to all three of its nodes
+          auto [n_begin, n_end] = dag->OutNeighbors(n);
+          uint64_t found = 0;
+          for (const uint32_t* v = n_begin; v != n_end; ++v) {
+            auto [v_begin, v_end] = dag->OutNeighbors(*v);
+            size_t capacity = std::min(v_end - v_begin, n_end - n_begin);
+            if (ws->common.size() < capacity) {
+              ws->common.resize(capacity);
+            }
+            size_t num = SortedIntersection(
+                v_begin, v_end, n_begin, n_end, ws->common.data());
+            if (num == 0) {
+              continue;
+            }
+            found += num;
+            triangles[*v].fetch_add(num, std::memory_order_relaxed);
+            for (size_t i = 0; i < num; ++i) {
+              triangles[ws->common[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+          if (found > 0) {
+            triangles[n].fetch_add(found, std::memory_order_relaxed);
+            num_triangles += found;
+          }
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("FusedScan"));
+
+  // The counts are final, so the remaining results read only per-node
+  // values
+  FusedScanSummary summary;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  auto add_uint64 = [&](const std::string& name,
+                        const std::shared_ptr<arrow::Buffer>& values) {
+    fields.emplace_back(arrow::field(name, arrow::uint64()));
+    columns.emplace_back(
+        std::make_shared<arrow::UInt64Array>(num_nodes, values));
+  };
+  auto add_double = [&](const std::string& name,
+                        const std::shared_ptr<arrow::Buffer>& values) {
+    fields.emplace_back(arrow::field(name, arrow::float64()));
+    columns.emplace_back(
+        std::make_shared<arrow::DoubleArray>(num_nodes, values));
+  };
+  // Copy the counters into a column
+  auto counts = [&](const LargeArray<std::atomic<uint64_t>>& counters)
+      -> Result<std::shared_ptr<arrow::Buffer>> {
+    auto res = Allocate(num_nodes * sizeof(uint64_t));
+    if (!res) {
+      return res.error();
+    }
+    uint64_t* values = Values<uint64_t>(res.value());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          values[n] = counters[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    return res;
+  };
+
+  if (want_out_degrees) {
+    summary.out_degree = DegreeStats::Compute(
+        Values<uint64_t>(out_degrees), num_nodes, num_bins);
+    add_uint64(out_degree_property_, out_degrees);
+  }
+  if (want_in_degrees) {
+    auto res = counts(in_degrees);
+    if (!res) {
+      return res.error();
+    }
+    summary.in_degree = DegreeStats::Compute(
+        Values<uint64_t>(res.value()), num_nodes, num_bins);
+    add_uint64(in_degree_property_, res.value());
+  }
+  for (uint64_t k = 0; k < num_jaccard; ++k) {
+    add_double(jaccard_kernels_[k].property, similarities[k]);
+  }
+  if (want_triangles) {
+    summary.num_triangles = num_triangles.reduce();
+    auto res = counts(triangles);
+    if (!res) {
+      return res.error();
+    }
+    std::shared_ptr<arrow::Buffer> triangle_counts = std::move(res.value());
+    if (!triangle_property_.empty()) {
+      add_uint64(triangle_property_, triangle_counts);
+    }
+    if (!clustering_property_.empty()) {
+      auto coefficients_res = Allocate(num_nodes * sizeof(double));
+      if (!coefficients_res) {
+        return coefficients_res.error();
+      }
+      const uint64_t* counted = Values<uint64_t>(triangle_counts);
+      double* coefficients = Values<double>(coefficients_res.value());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes),
+          [&](uint64_t n) {
+            double degree = topology.edges(n).size();
+            coefficients[n] = degree < 2 ? 0.0
+                                         : 2.0 * counted[n] /
+                                               (degree * (degree - 1));
+          },
+          katana::no_stats());
+      add_double(clustering_property_, coefficients_res.value());
+    }
+  }
+
+  if (!fields.empty()) {
+    if (auto res = pg->AddNodeProperties(
+            arrow::Table::Make(arrow::schema(fields), columns));
+        !res) {
+      return res.error().WithContext("adding the results");
+    }
+  }
+  return summary;
+}
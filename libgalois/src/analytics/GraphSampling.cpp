@@ -0,0 +1,294 @@
+#include "katana/analytics/GraphSampling.h"
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/analytics/TriangleSampling.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::GraphSamplingPlan;
+using katana::analytics::SampleSeed;
+
+/// Steps a random walk may take without visiting a new node before a new
+/// walk starts from another random node
+constexpr uint64_t kStaleSteps = 1000;
+
+/// Comes up with probability p for each stream of a seed
+class Coin {
+public:
+  Coin(double p, uint64_t seed)
+      : all_(p >= 1),
+        // 2^64 itself is not representable, so p = 1 is handled by all_
+        threshold_(static_cast<uint64_t>(std::ldexp(p, 64))),
+        seed_(seed) {}
+
+  bool operator()(uint64_t stream) const {
+    return all_ || SampleSeed(seed_, stream) < threshold_;
+  }
+
+private:
+  bool all_;
+  uint64_t threshold_;
+  uint64_t seed_;
+};
+
+katana::Result<void>
+CheckPlan(const GraphSamplingPlan& plan) {
+  if (auto r = katana::analytics::CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (!(plan.fraction() > 0 && plan.fraction() <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "fraction must be in (0, 1], got {}", plan.fraction());
+  }
+  if (!(plan.burn_probability() >= 0 && plan.burn_probability() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "burn probability must be in [0, 1), got {}",
+        plan.burn_probability());
+  }
+  if (plan.neighbors_per_node() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "neighbors per node must be positive");
+  }
+  if (!(plan.restart_probability() >= 0 && plan.restart_probability() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "restart probability must be in [0, 1), got {}",
+        plan.restart_probability());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Set the edges whose coin comes up in edge_mask and their endpoints in
+/// node_mask. The coin of an edge is a hash of its endpoints, so both
+/// directions of an edge get the same coin.
+void
+SampleEdges(
+    const katana::GraphTopology& topology, const GraphSamplingPlan& plan,
+    katana::DynamicBitset* node_mask, katana::DynamicBitset* edge_mask) {
+  Coin coin(plan.fraction(), plan.seed());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        for (auto e : topology.edges(n)) {
+          uint64_t dest = topology.edge_dest(e);
+          uint64_t lo = std::min(n, dest);
+          uint64_t hi = std::max(n, dest);
+          if (coin((hi << 32) | lo)) {
+            edge_mask->set(e);
+            node_mask->set(n);
+            node_mask->set(dest);
+          }
+        }
+      },
+      katana::steal(), katana::loopname("SampleSubgraph_Edges"));
+}
+
+/// The nodes visited by the explorations of one sample
+class Exploration {
+public:
+  Exploration(const katana::GraphTopology& topology, uint64_t target)
+      : topology_(topology), target_(target) {
+    visited_.resize(topology.num_nodes());
+  }
+
+  const katana::GraphTopology& topology() const { return topology_; }
+
+  const katana::DynamicBitset& visited() const { return visited_; }
+
+  bool IsVisited(Node n) const { return visited_.test(n); }
+
+  /// Mark n visited and return true if it was not visited before
+  bool Visit(Node n) {
+    if (visited_.set(n)) {
+      return false;
+    }
+    num_visited_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool done() const {
+    return num_visited_.load(std::memory_order_relaxed) >= target_;
+  }
+
+  /// A node drawn uniformly at random to start an exploration from
+  template <typename Generator>
+  Node RandomNode(Generator* gen) const {
+    return std::uniform_int_distribution<Node>(
+        0, topology_.num_nodes() - 1)(*gen);
+  }
+
+private:
+  const katana::GraphTopology& topology_;
+  uint64_t target_;
+  katana::DynamicBitset visited_;
+  std::atomic<uint64_t> num_visited_{0};
+};
+
+/// Run explore(exploration, gen) until enough nodes are visited. Each run
+/// gets a generator of its own, seeded by the seed of plan and the index of
+/// the run. Runs are spread over the threads unless plan is deterministic.
+template <typename ExploreFn>
+void
+RunExplorations(
+    const GraphSamplingPlan& plan, Exploration* exploration,
+    const ExploreFn& explore) {
+  std::atomic<uint64_t> next_run{0};
+  auto run = [&]() {
+    while (!exploration->done()) {
+      std::mt19937_64 gen(SampleSeed(plan.seed(), next_run++));
+      explore(exploration, &gen);
+    }
+  };
+  if (plan.deterministic()) {
+    run();
+  } else {
+    katana::on_each([&](unsigned, unsigned) { run(); });
+  }
+}
+
+/// One fire of kForestFire or one search of kSnowball: from a random node,
+/// visit num_burned(gen) random unvisited out-neighbors of each visited
+/// node in breadth first order
+template <typename NumBurnedFn>
+void
+Burn(
+    Exploration* exploration, std::mt19937_64* gen,
+    const NumBurnedFn& num_burned) {
+  const katana::GraphTopology& topology = exploration->topology();
+  Node start = exploration->RandomNode(gen);
+  exploration->Visit(start);
+  std::vector<Node> queue{start};
+  std::vector<Node> candidates;
+  for (size_t head = 0; head < queue.size() && !exploration->done(); ++head) {
+    candidates.clear();
+    for (auto e : topology.edges(queue[head])) {
+      Node dest = topology.edge_dest(e);
+      if (!exploration->IsVisited(dest)) {
+        candidates.emplace_back(dest);
+      }
+    }
+    uint64_t count = std::min<uint64_t>(num_burned(gen), candidates.size());
+    // Draw count candidates without replacement by a partial shuffle
+    for (uint64_t i = 0; i < count && !exploration->done(); ++i) {
+      uint64_t j = std::uniform_int_distribution<uint64_t>(
+          i, candidates.size() - 1)(*gen);
+      std::swap(candidates[i], candidates[j]);
+      if (exploration->Visit(candidates[i])) {
+        queue.emplace_back(candidates[i]);
+      }
+    }
+  }
+}
+
+/// One walk of kRandomWalk
+void
+Walk(
+    Exploration* exploration, std::mt19937_64* gen,
+    double restart_probability) {
+  const katana::GraphTopology& topology = exploration->topology();
+  std::uniform_real_distribution<double> unit(0, 1);
+  Node start = exploration->RandomNode(gen);
+  exploration->Visit(start);
+  Node current = start;
+  uint64_t stale = 0;
+  while (!exploration->done() && stale < kStaleSteps) {
+    auto [begin, end] = topology.edge_range(current);
+    if (begin == end && current == start) {
+      // The walk cannot leave its start
+      return;
+    }
+    if (begin == end || unit(*gen) < restart_probability) {
+      current = start;
+      ++stale;
+      continue;
+    }
+    auto e = std::uniform_int_distribution<uint64_t>(begin, end - 1)(*gen);
+    current = topology.edge_dest(e);
+    stale = exploration->Visit(current) ? 0 : stale + 1;
+  }
+}
+
+}  // namespace
+
+katana::Result<katana::Subgraph>
+katana::analytics::SampleSubgraph(
+    const PropertyGraph& pg, GraphSamplingPlan plan,
+    const SubgraphProperties& properties) {
+  if (auto r = CheckPlan(plan); !r) {
+    return r.error();
+  }
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  switch (plan.algorithm()) {
+  case GraphSamplingPlan::kRandomNode: {
+    DynamicBitset node_mask;
+    node_mask.resize(num_nodes);
+    Coin coin(plan.fraction(), plan.seed());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          if (coin(n)) {
+            node_mask.set(n);
+          }
+        },
+        katana::loopname("SampleSubgraph_Nodes"));
+    return ExtractSubgraph(pg, node_mask, nullptr, properties);
+  }
+  case GraphSamplingPlan::kRandomEdge:
+  case GraphSamplingPlan::kInducedEdge: {
+    DynamicBitset node_mask;
+    node_mask.resize(num_nodes);
+    DynamicBitset edge_mask;
+    edge_mask.resize(topology.num_edges());
+    SampleEdges(topology, plan, &node_mask, &edge_mask);
+    bool induced = plan.algorithm() == GraphSamplingPlan::kInducedEdge;
+    return ExtractSubgraph(
+        pg, node_mask, induced ? nullptr : &edge_mask, properties);
+  }
+  case GraphSamplingPlan::kForestFire:
+  case GraphSamplingPlan::kSnowball:
+  case GraphSamplingPlan::kRandomWalk:
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  auto target = static_cast<uint64_t>(std::ceil(plan.fraction() * num_nodes));
+  Exploration exploration(topology, std::min(target, num_nodes));
+  if (plan.algorithm() == GraphSamplingPlan::kForestFire) {
+    // The number of failures before the first success of a coin that comes
+    // up with 1 - p, whose mean is p / (1 - p)
+    double success = 1 - plan.burn_probability();
+    RunExplorations(
+        plan, &exploration, [&](Exploration* e, std::mt19937_64* gen) {
+          Burn(e, gen, [&](std::mt19937_64* g) {
+            return std::geometric_distribution<uint64_t>(success)(*g);
+          });
+        });
+  } else if (plan.algorithm() == GraphSamplingPlan::kSnowball) {
+    uint64_t neighbors = plan.neighbors_per_node();
+    RunExplorations(
+        plan, &exploration, [&](Exploration* e, std::mt19937_64* gen) {
+          Burn(e, gen, [&](std::mt19937_64*) { return neighbors; });
+        });
+  } else {
+    RunExplorations(
+        plan, &exploration, [&](Exploration* e, std::mt19937_64* gen) {
+          Walk(e, gen, plan.restart_probability());
+        });
+  }
+  return ExtractSubgraph(pg, exploration.visited(), nullptr, properties);
+}
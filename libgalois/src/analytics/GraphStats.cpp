@@ -0,0 +1,388 @@
+#include "katana/analytics/GraphStats.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+#include "katana/VectorReduction.h"
+
+namespace {
+
+using katana::analytics::DegreeStats;
+using katana::analytics::GraphStatsOptions;
+using katana::analytics::NeighborhoodStats;
+using katana::analytics::PropertyStatsSummary;
+
+/// The histogram bin of degree when bins are powers of two: bin 0 holds 0
+/// and bin b > 0 holds [2^(b - 1), 2^b)
+uint64_t
+LogBin(uint64_t degree) {
+  return degree == 0 ? 0 : 64 - __builtin_clzll(degree);
+}
+
+template <typename DegreeFn>
+DegreeStats
+ComputeDegreeStats(uint64_t num_nodes, uint32_t num_bins, DegreeFn degree) {
+  DegreeStats stats;
+  if (num_nodes == 0) {
+    return stats;
+  }
+
+  katana::GReduceMin<uint64_t> min;
+  katana::GReduceMax<uint64_t> max;
+  katana::GAccumulator<uint64_t> sum;
+  katana::GAccumulator<double> squares;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t d = degree(n);
+        min.update(d);
+        max.update(d);
+        sum += d;
+        squares += static_cast<double>(d) * d;
+      },
+      katana::no_stats());
+  stats.min = min.reduce();
+  stats.max = max.reduce();
+  stats.mean = static_cast<double>(sum.reduce()) / num_nodes;
+  double variance = squares.reduce() / num_nodes - stats.mean * stats.mean;
+  stats.stddev = std::sqrt(std::max(variance, 0.0));
+
+  uint64_t width = 0;
+  uint64_t bins = LogBin(stats.max) + 1;
+  if (num_bins > 0) {
+    width = (stats.max + num_bins) / num_bins;
+    bins = stats.max / width + 1;
+  }
+  for (uint64_t b = 0; b < bins; ++b) {
+    uint64_t start = b * width;
+    if (num_bins == 0) {
+      start = b == 0 ? 0 : uint64_t{1} << (b - 1);
+    }
+    stats.bin_starts.emplace_back(start);
+  }
+
+  katana::GVectorAccumulator<uint64_t> counts(bins);
+  katana::GReduceMin<uint32_t> max_node;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t d = degree(n);
+        counts.update(num_bins > 0 ? d / width : LogBin(d), 1);
+        if (d == stats.max) {
+          max_node.update(static_cast<uint32_t>(n));
+        }
+      },
+      katana::no_stats());
+  stats.counts = counts.reduce();
+  stats.max_node = max_node.reduce();
+  return stats;
+}
+
+/// HyperLogLog counters of 2^log2_registers one byte registers, one per node
+class HyperLogLog {
+public:
+  explicit HyperLogLog(uint32_t log2_registers)
+      : log2_registers_(log2_registers),
+        num_registers_(uint64_t{1} << log2_registers) {
+    for (size_t r = 0; r < inverse_powers_.size(); ++r) {
+      inverse_powers_[r] = std::ldexp(1.0, -static_cast<int>(r));
+    }
+    switch (num_registers_) {
+    case 16:
+      alpha_ = 0.673;
+      break;
+    case 32:
+      alpha_ = 0.697;
+      break;
+    case 64:
+      alpha_ = 0.709;
+      break;
+    default:
+      alpha_ = 0.7213 / (1 + 1.079 / num_registers_);
+    }
+  }
+
+  uint64_t num_registers() const { return num_registers_; }
+
+  /// Set counter to the counter of the set {element}
+  void Init(uint8_t* counter, uint64_t element) const {
+    std::fill(counter, counter + num_registers_, 0);
+    uint64_t hash = Hash(element);
+    uint64_t rest = hash << log2_registers_;
+    uint8_t rank =
+        rest == 0 ? 64 - log2_registers_ + 1 : __builtin_clzll(rest) + 1;
+    counter[hash >> (64 - log2_registers_)] = rank;
+  }
+
+  /// Add the elements of other to counter; \returns true if counter changed
+  bool Merge(uint8_t* counter, const uint8_t* other) const {
+    bool changed = false;
+    for (uint64_t r = 0; r < num_registers_; ++r) {
+      if (other[r] > counter[r]) {
+        counter[r] = other[r];
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  /// \returns the estimated number of distinct elements of counter
+  double Estimate(const uint8_t* counter) const {
+    double sum = 0;
+    uint64_t zeros = 0;
+    for (uint64_t r = 0; r < num_registers_; ++r) {
+      sum += inverse_powers_[counter[r]];
+      zeros += counter[r] == 0;
+    }
+    double m = num_registers_;
+    double estimate = alpha_ * m * m / sum;
+    // Linear counting is more accurate for small counts
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+private:
+  /// SplitMix64 finalizer, which spreads consecutive node ids over all bits
+  static uint64_t Hash(uint64_t x) {
+    x += UINT64_C(0x9e3779b97f4a7c15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+  }
+
+  uint32_t log2_registers_;
+  uint64_t num_registers_;
+  double alpha_;
+  std::array<double, 65> inverse_powers_;
+};
+
+/// Estimate the neighborhood function as HyperANF does: after hop t, the
+/// counter of node u holds the nodes reachable from u within t hops, which
+/// is the union of its own counter and those of its out-neighbors after hop
+/// t - 1. Since counters only grow, only neighbors whose counters changed in
+/// the previous hop need to be merged.
+NeighborhoodStats
+EstimateNeighborhood(
+    const katana::GraphTopology& topology, const GraphStatsOptions& options) {
+  NeighborhoodStats stats;
+  uint64_t num_nodes = topology.num_nodes();
+  if (num_nodes == 0) {
+    return stats;
+  }
+
+  HyperLogLog hll(options.log2_registers);
+  uint64_t m = hll.num_registers();
+  std::array<katana::LargeArray<uint8_t>, 2> counters;
+  std::array<katana::LargeArray<uint8_t>, 2> changed;
+  katana::LargeArray<double> estimates;
+  for (int i = 0; i < 2; ++i) {
+    counters[i].allocateInterleaved(num_nodes * m);
+    changed[i].allocateInterleaved(num_nodes);
+  }
+  estimates.allocateInterleaved(num_nodes);
+
+  katana::GAccumulator<double> initial;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        hll.Init(&counters[0][n * m], n);
+        changed[0][n] = true;
+        estimates[n] = hll.Estimate(&counters[0][n * m]);
+        initial += estimates[n];
+      },
+      katana::no_stats());
+  stats.pairs.emplace_back(initial.reduce());
+
+  int cur = 0;
+  for (uint32_t hop = 1; hop <= options.max_hops; ++hop) {
+    int next = 1 - cur;
+    katana::GReduceLogicalOr any_changed;
+    katana::GAccumulator<double> growth;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint8_t* counter = &counters[next][n * m];
+          std::copy_n(&counters[cur][n * m], m, counter);
+          bool node_changed = false;
+          for (auto e : topology.edges(n)) {
+            auto dest = topology.edge_dest(e);
+            if (changed[cur][dest] &&
+                hll.Merge(counter, &counters[cur][dest * m])) {
+              node_changed = true;
+            }
+          }
+          changed[next][n] = node_changed;
+          if (node_changed) {
+            double estimate = hll.Estimate(counter);
+            growth += estimate - estimates[n];
+            estimates[n] = estimate;
+            any_changed.update(true);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("EstimateNeighborhood"));
+    if (!any_changed.reduce()) {
+      break;
+    }
+    stats.pairs.emplace_back(stats.pairs.back() + growth.reduce());
+    stats.diameter = hop;
+    stats.truncated = hop == options.max_hops;
+    cur = next;
+  }
+
+  double target = 0.9 * stats.pairs.back();
+  auto reached =
+      std::lower_bound(stats.pairs.begin(), stats.pairs.end(), target);
+  size_t t = reached - stats.pairs.begin();
+  if (t > 0) {
+    double step = stats.pairs[t] - stats.pairs[t - 1];
+    stats.effective_diameter =
+        t - 1 + (step > 0 ? (target - stats.pairs[t - 1]) / step : 1);
+  }
+  return stats;
+}
+
+template <typename StatsFn>
+katana::Result<std::vector<PropertyStatsSummary>>
+SummarizeProperties(const arrow::Schema& schema, StatsFn get_stats) {
+  std::vector<PropertyStatsSummary> summaries;
+  for (const auto& field : schema.fields()) {
+    auto stats_res = get_stats(field->name());
+    if (!stats_res) {
+      return stats_res.error();
+    }
+    summaries.emplace_back(PropertyStatsSummary{
+        .name = field->name(),
+        .type = field->type()->ToString(),
+        .stats = std::move(stats_res.value().column),
+    });
+  }
+  return summaries;
+}
+
+}  // namespace
+
+katana::analytics::DegreeStats
+katana::analytics::DegreeStats::Compute(
+    const uint64_t* degrees, uint64_t num_nodes, uint32_t num_bins) {
+  return ComputeDegreeStats(
+      num_nodes, num_bins, [&](uint64_t n) { return degrees[n]; });
+}
+
+katana::Result<katana::analytics::GraphStats>
+katana::analytics::GraphStats::Compute(
+    const katana::PropertyGraph& pg, const GraphStatsOptions& options) {
+  if (options.estimate_diameter &&
+      (options.log2_registers < 4 || options.log2_registers > 16)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "log2_registers {} is not in [4, 16]",
+        options.log2_registers);
+  }
+
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  GraphStats stats;
+  stats.num_nodes = num_nodes;
+  stats.num_edges = topology.num_edges();
+
+  stats.out_degree =
+      ComputeDegreeStats(num_nodes, options.num_bins, [&](uint64_t n) {
+        return topology.edges(n).size();
+      });
+
+  LargeArray<std::atomic<uint64_t>> in_degrees;
+  in_degrees.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_degrees.constructAt(n, 0); }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        for (auto e : topology.edges(n)) {
+          in_degrees[topology.edge_dest(e)].fetch_add(
+              1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  stats.in_degree =
+      ComputeDegreeStats(num_nodes, options.num_bins, [&](uint64_t n) {
+        return in_degrees[n].load(std::memory_order_relaxed);
+      });
+
+  if (options.estimate_diameter) {
+    stats.neighborhood = EstimateNeighborhood(topology, options);
+  }
+
+  if (options.summarize_properties) {
+    auto node_res = SummarizeProperties(
+        *pg.node_schema(),
+        [&](const std::string& name) { return pg.GetNodePropertyStats(name); });
+    if (!node_res) {
+      return node_res.error().WithContext("summarizing node properties");
+    }
+    stats.node_properties = std::move(node_res.value());
+    auto edge_res = SummarizeProperties(
+        *pg.edge_schema(),
+        [&](const std::string& name) { return pg.GetEdgePropertyStats(name); });
+    if (!edge_res) {
+      return edge_res.error().WithContext("summarizing edge properties");
+    }
+    stats.edge_properties = std::move(edge_res.value());
+  }
+
+  return stats;
+}
+
+void
+katana::analytics::to_json(nlohmann::json& j, const DegreeStats& stats) {
+  j = nlohmann::json{
+      {"min", stats.min},
+      {"max", stats.max},
+      {"mean", stats.mean},
+      {"stddev", stats.stddev},
+      {"max_node", stats.max_node},
+      {"bin_starts", stats.bin_starts},
+      {"counts", stats.counts},
+  };
+}
+
+void
+katana::analytics::to_json(nlohmann::json& j, const NeighborhoodStats& stats) {
+  j = nlohmann::json{
+      {"pairs", stats.pairs},
+      {"diameter", stats.diameter},
+      {"effective_diameter", stats.effective_diameter},
+      {"truncated", stats.truncated},
+  };
+}
+
+void
+katana::analytics::to_json(
+    nlohmann::json& j, const PropertyStatsSummary& summary) {
+  j = nlohmann::json{
+      {"name", summary.name},
+      {"type", summary.type},
+      {"stats", summary.stats},
+  };
+}
+
+void
+katana::analytics::to_json(nlohmann::json& j, const GraphStats& stats) {
+  j = nlohmann::json{
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"out_degree", stats.out_degree},
+      {"in_degree", stats.in_degree},
+      {"node_properties", stats.node_properties},
+      {"edge_properties", stats.edge_properties},
+  };
+  if (stats.neighborhood) {
+    j["neighborhood"] = *stats.neighborhood;
+  }
+}
@@ -0,0 +1,192 @@
+#include "katana/analytics/Intersection.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_INTERSECTION_X86 1
+#include <immintrin.h>
+#else
+#define KATANA_INTERSECTION_X86 0
+#endif
+
+namespace {
+
+// Each kernel returns the size of the intersection and, if kWrite is true,
+// also writes the common values to out.
+
+template <bool kWrite>
+size_t
+ScalarIntersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end, uint32_t* out) {
+  size_t num = 0;
+  while (a != a_end && b != b_end) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
+      if constexpr (kWrite) {
+        out[num] = *a;
+      }
+      ++num;
+      ++a;
+      ++b;
+    }
+  }
+  return num;
+}
+
+#if KATANA_INTERSECTION_X86
+
+// The vector kernels compare a block of a against a block of b by comparing
+// the a block with every rotation of the b block, which gives the lanes of
+// the a block that appear anywhere in the b block. Because values are
+// distinct, no value is counted twice. Afterwards, whichever block has the
+// smaller maximum cannot intersect any later block of the other range, so
+// it is consumed. What is left when either range has less than a full block
+// is merged with a narrower kernel.
+
+template <bool kWrite>
+__attribute__((target("avx2"))) size_t
+Avx2Intersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end, uint32_t* out) {
+  constexpr ptrdiff_t kLanes = 8;
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+  size_t num = 0;
+  while (a_end - a >= kLanes && b_end - b >= kLanes) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i match = _mm256_cmpeq_epi32(va, vb);
+    for (ptrdiff_t r = 1; r < kLanes; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+    }
+    auto mask = static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(match)));
+
+    if constexpr (kWrite) {
+      for (; mask; mask &= mask - 1) {
+        out[num++] = a[__builtin_ctz(mask)];
+      }
+    } else {
+      num += __builtin_popcount(mask);
+    }
+
+    uint32_t a_max = a[kLanes - 1];
+    uint32_t b_max = b[kLanes - 1];
+    if (a_max <= b_max) {
+      a += kLanes;
+    }
+    if (b_max <= a_max) {
+      b += kLanes;
+    }
+  }
+
+  if constexpr (kWrite) {
+    return num + ScalarIntersection<kWrite>(a, a_end, b, b_end, out + num);
+  } else {
+    return num + ScalarIntersection<kWrite>(a, a_end, b, b_end, out);
+  }
+}
+
+// Wider blocks are slower than AVX2 on short ranges because of the longer
+// chain of rotations per block and the larger tail, so short ranges are left
+// to the AVX2 loop.
+constexpr ptrdiff_t kMinAvx512Size = 128;
+
+template <bool kWrite>
+__attribute__((target("avx512f"))) size_t
+Avx512Intersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end, uint32_t* out) {
+  constexpr ptrdiff_t kLanes = 16;
+  const __m512i rotate = _mm512_setr_epi32(
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+
+  size_t num = 0;
+  while (a_end - a >= kMinAvx512Size && b_end - b >= kMinAvx512Size) {
+    __m512i va = _mm512_loadu_si512(a);
+    __m512i vb = _mm512_loadu_si512(b);
+    __mmask16 match = _mm512_cmpeq_epi32_mask(va, vb);
+    for (ptrdiff_t r = 1; r < kLanes; ++r) {
+      vb = _mm512_permutex2var_epi32(vb, rotate, vb);
+      match |= _mm512_cmpeq_epi32_mask(va, vb);
+    }
+
+    if constexpr (kWrite) {
+      _mm512_mask_compressstoreu_epi32(out + num, match, va);
+    }
+    num += __builtin_popcount(match);
+
+    uint32_t a_max = a[kLanes - 1];
+    uint32_t b_max = b[kLanes - 1];
+    if (a_max <= b_max) {
+      a += kLanes;
+    }
+    if (b_max <= a_max) {
+      b += kLanes;
+    }
+  }
+
+  if constexpr (kWrite) {
+    return num + Avx2Intersection<kWrite>(a, a_end, b, b_end, out + num);
+  } else {
+    return num + Avx2Intersection<kWrite>(a, a_end, b, b_end, out);
+  }
+}
+
+#endif
+
+using Kernel = size_t (*)(
+    const uint32_t*, const uint32_t*, const uint32_t*, const uint32_t*,
+    uint32_t*);
+
+struct Kernels {
+  const char* name;
+  Kernel count;
+  Kernel write;
+};
+
+Kernels
+SelectKernels() {
+#if KATANA_INTERSECTION_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return Kernels{
+        "avx512", &Avx512Intersection<false>, &Avx512Intersection<true>};
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return Kernels{"avx2", &Avx2Intersection<false>, &Avx2Intersection<true>};
+  }
+#endif
+  return Kernels{
+      "scalar", &ScalarIntersection<false>, &ScalarIntersection<true>};
+}
+
+const Kernels&
+GetKernels() {
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+}  // namespace
+
+uint64_t
+katana::analytics::CountSortedIntersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end) {
+  return GetKernels().count(a, a_end, b, b_end, nullptr);
+}
+
+size_t
+katana::analytics::SortedIntersection(
+    const uint32_t* a, const uint32_t* a_end, const uint32_t* b,
+    const uint32_t* b_end, uint32_t* out) {
+  return GetKernels().write(a, a_end, b, b_end, out);
+}
+
+const char*
+katana::analytics::SortedIntersectionKernel() {
+  return GetKernels().name;
+}
@@ -0,0 +1,257 @@
+#include "katana/analytics/KHop.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/analytics/Utils.h"
+
+using katana::analytics::EgoNetwork;
+using katana::analytics::KHopExpander;
+using katana::analytics::KHopNeighborhoods;
+using katana::analytics::KHopPlan;
+
+namespace {
+
+/// Queries per chunk of work; a query is expensive enough to steal alone
+/// but most are small
+constexpr unsigned kChunkSize = 4;
+
+/// The local index of nodes that were reached after the node limit
+constexpr uint32_t kNotKept = std::numeric_limits<uint32_t>::max();
+
+/// The edges of node that the expansion follows: the first max_fanout
+katana::GraphTopology::edges_range
+FollowedEdges(
+    const katana::GraphTopology& topology, uint32_t node,
+    uint64_t max_fanout) {
+  auto [begin, end] = topology.edge_range(node);
+  if (end - begin > max_fanout) {
+    end = begin + max_fanout;
+  }
+  return katana::MakeStandardRange<katana::GraphTopology::edge_iterator>(
+      begin, end);
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t bytes) {
+  auto res = arrow::AllocateBuffer(bytes);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", bytes,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+template <typename ArrayType, typename T>
+katana::Result<std::shared_ptr<ArrayType>>
+ToArray(const std::vector<T>& values) {
+  auto buffer_res = Allocate(values.size() * sizeof(T));
+  if (!buffer_res) {
+    return buffer_res.error();
+  }
+  if (!values.empty()) {
+    std::memcpy(
+        buffer_res.value()->mutable_data(), values.data(),
+        values.size() * sizeof(T));
+  }
+  return std::make_shared<ArrayType>(values.size(), buffer_res.value());
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<KHopExpander>>
+KHopExpander::Make(const PropertyGraph* pg, KHopPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.hops() > KHopPlan::kMaxHops) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "at most {} hops are supported, not {}",
+        KHopPlan::kMaxHops, plan.hops());
+  }
+  return std::unique_ptr<KHopExpander>(new KHopExpander(pg, std::move(plan)));
+}
+
+katana::Result<void>
+KHopExpander::Expand(const std::vector<uint32_t>& queries, bool with_edges) {
+  for (uint32_t query : queries) {
+    if (query >= pg_->num_nodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "query {} is not a node", query);
+    }
+  }
+
+  // Shrinking keeps the capacity of the remaining expansions
+  expansions_.resize(queries.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, queries.size()),
+      [&](uint64_t q) {
+        ExpandOne(
+            queries[q], with_edges, workspaces_.getLocal(), &expansions_[q]);
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("KHop-Expand"));
+  return katana::ResultSuccess();
+}
+
+void
+KHopExpander::ExpandOne(
+    uint32_t query, bool with_edges, Workspace* ws, Expansion* out) const {
+  const GraphTopology& topology = pg_->topology();
+  constexpr uint64_t kUnlimited = std::numeric_limits<uint64_t>::max();
+  uint64_t max_fanout = plan_.max_fanout() ? plan_.max_fanout() : kUnlimited;
+  uint64_t max_nodes = plan_.max_nodes() ? plan_.max_nodes() : kUnlimited;
+
+  auto& local = ws->local;
+  auto& next = ws->next;
+  local.clear();
+  local.try_emplace(query, kNotKept);
+  out->nodes.assign(1, query);
+  out->hop_sizes.assign(1, 1);
+
+  uint64_t frontier = 0;
+  bool full = max_nodes <= 1;
+  for (uint32_t hop = 1; hop <= plan_.hops(); ++hop) {
+    uint64_t end = out->nodes.size();
+    if (!full) {
+      next.clear();
+      for (uint64_t i = frontier; i < end; ++i) {
+        for (auto e : FollowedEdges(topology, out->nodes[i], max_fanout)) {
+          uint32_t dest = topology.edge_dest(e);
+          if (local.try_emplace(dest, kNotKept).second) {
+            next.emplace_back(dest);
+          }
+        }
+      }
+      // Order each hop by ID so that the result, and which nodes the limit
+      // keeps, does not depend on the order in which edges were followed
+      std::sort(next.begin(), next.end());
+      if (next.size() >= max_nodes - end) {
+        next.resize(max_nodes - end);
+        full = true;
+      }
+      out->nodes.insert(out->nodes.end(), next.begin(), next.end());
+    }
+    frontier = end;
+    out->hop_sizes.emplace_back(out->nodes.size());
+  }
+
+  if (!with_edges) {
+    return;
+  }
+  for (uint64_t i = 0; i < out->nodes.size(); ++i) {
+    local.find(out->nodes[i])->second = i;
+  }
+  out->edge_ends.clear();
+  out->dests.clear();
+  out->edges.clear();
+  for (uint32_t node : out->nodes) {
+    for (auto e : FollowedEdges(topology, node, max_fanout)) {
+      auto it = local.find(topology.edge_dest(e));
+      if (it != local.end() && it->second != kNotKept) {
+        out->dests.emplace_back(it->second);
+        out->edges.emplace_back(e);
+      }
+    }
+    out->edge_ends.emplace_back(out->dests.size());
+  }
+}
+
+katana::Result<KHopNeighborhoods>
+KHopExpander::Neighborhoods(const std::vector<uint32_t>& queries) {
+  if (auto r = Expand(queries, false); !r) {
+    return r.error();
+  }
+  uint64_t num_queries = queries.size();
+
+  auto offsets_res = Allocate((num_queries + 1) * sizeof(int64_t));
+  if (!offsets_res) {
+    return offsets_res.error();
+  }
+  auto* offsets =
+      reinterpret_cast<int64_t*>(offsets_res.value()->mutable_data());
+  offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t q) { offsets[q + 1] = expansions_[q].nodes.size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets + 1, offsets + num_queries + 1, offsets + 1);
+  uint64_t num_values = offsets[num_queries];
+
+  auto nodes_res = Allocate(num_values * sizeof(uint32_t));
+  auto distances_res = Allocate(num_values * sizeof(uint8_t));
+  if (!nodes_res) {
+    return nodes_res.error();
+  }
+  if (!distances_res) {
+    return distances_res.error();
+  }
+  auto* nodes = reinterpret_cast<uint32_t*>(nodes_res.value()->mutable_data());
+  uint8_t* distances = distances_res.value()->mutable_data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t q) {
+        const Expansion& expansion = expansions_[q];
+        std::copy(
+            expansion.nodes.begin(), expansion.nodes.end(),
+            nodes + offsets[q]);
+        uint64_t begin = 0;
+        for (uint64_t h = 0; h < expansion.hop_sizes.size(); ++h) {
+          uint64_t end = expansion.hop_sizes[h];
+          std::fill(
+              distances + offsets[q] + begin, distances + offsets[q] + end,
+              h);
+          begin = end;
+        }
+      },
+      katana::no_stats());
+
+  KHopNeighborhoods neighborhoods;
+  neighborhoods.nodes = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_queries, offsets_res.value(),
+      std::make_shared<arrow::UInt32Array>(num_values, nodes_res.value()));
+  neighborhoods.distances = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint8()), num_queries, offsets_res.value(),
+      std::make_shared<arrow::UInt8Array>(num_values, distances_res.value()));
+  return neighborhoods;
+}
+
+katana::Result<std::vector<EgoNetwork>>
+KHopExpander::EgoNetworks(const std::vector<uint32_t>& queries) {
+  if (auto r = Expand(queries, true); !r) {
+    return r.error();
+  }
+
+  std::vector<EgoNetwork> networks(queries.size());
+  for (uint64_t q = 0; q < queries.size(); ++q) {
+    const Expansion& expansion = expansions_[q];
+    EgoNetwork& network = networks[q];
+    auto nodes_res = ToArray<arrow::UInt32Array>(expansion.nodes);
+    if (!nodes_res) {
+      return nodes_res.error();
+    }
+    auto indices_res = ToArray<arrow::UInt64Array>(expansion.edge_ends);
+    if (!indices_res) {
+      return indices_res.error();
+    }
+    auto dests_res = ToArray<arrow::UInt32Array>(expansion.dests);
+    if (!dests_res) {
+      return dests_res.error();
+    }
+    auto edges_res = ToArray<arrow::UInt64Array>(expansion.edges);
+    if (!edges_res) {
+      return edges_res.error();
+    }
+    network.nodes = std::move(nodes_res.value());
+    network.hop_sizes = expansion.hop_sizes;
+    network.topology.out_indices = std::move(indices_res.value());
+    network.topology.out_dests = std::move(dests_res.value());
+    network.edges = std::move(edges_res.value());
+  }
+  return networks;
+}
@@ -0,0 +1,109 @@
+#include "katana/analytics/MultiSourceBfs.h"
+
+#include <limits>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+
+namespace {
+
+constexpr unsigned kChunkSize = 256U;
+
+}  // namespace
+
+katana::analytics::MultiSourceBfsBatch::MultiSourceBfsBatch(
+    const GraphTopology* topology)
+    : topology_(topology), marked_level_(0) {
+  seen_.allocateBlocked(topology_->num_nodes());
+  next_.allocateBlocked(topology_->num_nodes());
+  marked_.allocateBlocked(topology_->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology_->num_nodes()),
+      [&](Node n) {
+        next_[n] = 0;
+        marked_[n] = 0;
+      },
+      katana::no_stats(), katana::loopname("MultiSourceBfsAllocate"));
+}
+
+void
+katana::analytics::MultiSourceBfsBatch::Run(
+    const uint32_t* sources, size_t num_sources) {
+  KATANA_LOG_ASSERT(num_sources <= kMaxSources);
+
+  MarkLevel(std::numeric_limits<size_t>::max());
+  levels_.clear();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology_->num_nodes()),
+      [&](Node n) { seen_[n] = 0; }, katana::no_stats(),
+      katana::loopname("MultiSourceBfsInitialize"));
+
+  std::vector<Node> unique_sources;
+  for (size_t i = 0; i < num_sources; ++i) {
+    Node src = sources[i];
+    if (seen_[src] == 0) {
+      unique_sources.emplace_back(src);
+    }
+    seen_[src] |= Lanes{1} << i;
+  }
+  if (unique_sources.empty()) {
+    return;
+  }
+  levels_.emplace_back();
+  for (Node src : unique_sources) {
+    levels_.back().push(Visit{src, seen_[src]});
+  }
+
+  while (true) {
+    katana::InsertBag<Node> discovered;
+
+    // Collect in next_ the lanes that reach each node for the first time.
+    // The first thread to set any lane of a node is the one to record it.
+    katana::do_all(
+        katana::iterate(levels_.back()),
+        [&](const Visit& visit) {
+          for (auto e : topology_->edges(visit.node)) {
+            auto dest = topology_->edge_dest(e);
+            Lanes new_lanes = visit.lanes & ~seen_[dest];
+            if (new_lanes != 0 && next_[dest].fetch_or(new_lanes) == 0) {
+              discovered.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(), katana::no_stats(),
+        katana::loopname("MultiSourceBfsLevel"));
+
+    if (discovered.empty()) {
+      break;
+    }
+
+    Level next;
+    katana::do_all(
+        katana::iterate(discovered),
+        [&](Node n) {
+          Lanes lanes = next_[n].exchange(0);
+          seen_[n] |= lanes;
+          next.push(Visit{n, lanes});
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBfsAdvance"));
+    levels_.emplace_back(std::move(next));
+  }
+}
+
+void
+katana::analytics::MultiSourceBfsBatch::MarkLevel(size_t d) {
+  if (marked_level_ < levels_.size()) {
+    katana::do_all(
+        katana::iterate(levels_[marked_level_]),
+        [&](const Visit& visit) { marked_[visit.node] = 0; },
+        katana::no_stats(), katana::loopname("MultiSourceBfsUnmark"));
+  }
+  marked_level_ = d;
+  if (marked_level_ < levels_.size()) {
+    katana::do_all(
+        katana::iterate(levels_[marked_level_]),
+        [&](const Visit& visit) { marked_[visit.node] = visit.lanes; },
+        katana::no_stats(), katana::loopname("MultiSourceBfsMark"));
+  }
+}
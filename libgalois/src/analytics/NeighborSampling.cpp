@@ -0,0 +1,423 @@
+#include "katana/analytics/NeighborSampling.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <arrow/array/concatenate.h>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/analytics/TriangleSampling.h"
+#include "katana/analytics/Utils.h"
+
+using katana::analytics::MinibatchLoader;
+using katana::analytics::NeighborSampler;
+using katana::analytics::NeighborSamplingPlan;
+using katana::analytics::SampledBlock;
+using katana::analytics::SampledMinibatch;
+using katana::analytics::SampleSeed;
+
+namespace {
+
+constexpr uint32_t kNotSampled = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t kUnseen = std::numeric_limits<uint64_t>::max();
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t bytes, arrow::MemoryPool* pool) {
+  auto res = arrow::AllocateBuffer(bytes, pool);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", bytes,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+template <typename T>
+T*
+Values(const std::shared_ptr<arrow::Buffer>& buffer) {
+  return reinterpret_cast<T*>(buffer->mutable_data());
+}
+
+/// Return the width in bytes of the values of a type, or 0 if they are not
+/// of a fixed width in whole bytes
+uint64_t
+ValueBytes(const arrow::DataType& type) {
+  const auto* fixed = dynamic_cast<const arrow::FixedWidthType*>(&type);
+  if (!fixed || fixed->bit_width() % 8 != 0 ||
+      type.id() == arrow::Type::FIXED_SIZE_LIST) {
+    return 0;
+  }
+  return fixed->bit_width() / 8;
+}
+
+/// Draw k distinct out-edges of a node uniformly at random with Floyd's
+/// algorithm, in increasing order
+void
+SampleDistinct(
+    uint64_t first_edge, uint64_t degree, uint64_t seed, uint64_t k,
+    uint64_t* out) {
+  for (uint64_t j = degree - k, c = 0; j < degree; ++j, ++c) {
+    uint64_t e = first_edge + SampleSeed(seed, c) % (j + 1);
+    if (std::find(out, out + c, e) != out + c) {
+      e = first_edge + j;
+    }
+    out[c] = e;
+  }
+  std::sort(out, out + k);
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+NeighborSampler::Make(
+    const PropertyGraph* pg, NeighborSamplingPlan plan,
+    const std::vector<std::string>& feature_properties,
+    arrow::MemoryPool* pool) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.fanouts().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "at least one fanout is required");
+  }
+  for (uint32_t fanout : plan.fanouts()) {
+    if (fanout == 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "fanouts must be positive");
+    }
+  }
+
+  std::vector<Feature> features;
+  for (const std::string& name : feature_properties) {
+    std::shared_ptr<arrow::ChunkedArray> chunked = pg->GetNodeProperty(name);
+    if (!chunked) {
+      return KATANA_ERROR(
+          ErrorCode::PropertyNotFound, "no node property {}", name);
+    }
+    std::shared_ptr<arrow::Array> array;
+    if (chunked->num_chunks() == 1) {
+      array = chunked->chunk(0);
+    } else {
+      auto concat_res = arrow::Concatenate(chunked->chunks(), pool);
+      if (!concat_res.ok()) {
+        return KATANA_ERROR(
+            ErrorCode::ArrowError, "concatenating {}: {}", name,
+            concat_res.status());
+      }
+      array = std::move(concat_res.ValueOrDie());
+    }
+    if (array->null_count() > 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "feature property {} has nulls", name);
+    }
+
+    // The rows of a list are those of its values
+    const arrow::Array* values = array.get();
+    uint64_t width = 1;
+    if (array->type_id() == arrow::Type::FIXED_SIZE_LIST) {
+      const auto& list = static_cast<const arrow::FixedSizeListArray&>(*array);
+      values = list.values().get();
+      width = list.value_length();
+      if (values->null_count() > 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "feature property {} has nulls",
+            name);
+      }
+    }
+    uint64_t value_bytes = ValueBytes(*values->type());
+    if (value_bytes == 0) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError,
+          "feature property {} has type {}; expected fixed width values or "
+          "fixed size lists of them",
+          name, array->type()->ToString());
+    }
+    uint64_t row_bytes = value_bytes * width;
+    const uint8_t* rows =
+        values->data()->buffers[1]->data() + values->offset() * value_bytes;
+    if (values != array.get()) {
+      rows += array->offset() * row_bytes;
+    }
+    features.emplace_back(Feature{array, rows, row_bytes});
+  }
+
+  return std::unique_ptr<NeighborSampler>(
+      new NeighborSampler(pg, std::move(plan), std::move(features), pool));
+}
+
+NeighborSampler::NeighborSampler(
+    const PropertyGraph* pg, NeighborSamplingPlan plan,
+    std::vector<Feature> features, arrow::MemoryPool* pool)
+    : pg_(pg),
+      plan_(std::move(plan)),
+      features_(std::move(features)),
+      pool_(pool) {
+  uint64_t num_nodes = pg_->num_nodes();
+  local_.allocateInterleaved(num_nodes);
+  first_.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        local_[n] = kNotSampled;
+        first_.constructAt(n, kUnseen);
+      },
+      katana::no_stats());
+}
+
+katana::Result<SampledMinibatch>
+NeighborSampler::Sample(const std::vector<uint32_t>& seeds) {
+  uint64_t stream = SampleSeed(plan_.seed(), num_batches_++);
+
+  std::vector<uint32_t> nodes;
+  nodes.reserve(seeds.size());
+  for (uint32_t seed : seeds) {
+    if (seed >= pg_->num_nodes() || local_[seed] != kNotSampled) {
+      Reset(nodes);
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "seed {} is not a node or appears more than once", seed);
+    }
+    local_[seed] = nodes.size();
+    nodes.emplace_back(seed);
+  }
+
+  SampledMinibatch batch;
+  batch.hop_sizes.emplace_back(nodes.size());
+  for (uint32_t hop = 0; hop < plan_.fanouts().size(); ++hop) {
+    SampledBlock block;
+    if (auto r = SampleHop(hop, stream, &nodes, &block); !r) {
+      Reset(nodes);
+      return r.error();
+    }
+    batch.blocks.emplace_back(std::move(block));
+    batch.hop_sizes.emplace_back(nodes.size());
+  }
+  Reset(nodes);
+
+  auto nodes_res = Allocate(nodes.size() * sizeof(uint32_t), pool_);
+  if (!nodes_res) {
+    return nodes_res.error();
+  }
+  std::memcpy(
+      nodes_res.value()->mutable_data(), nodes.data(),
+      nodes.size() * sizeof(uint32_t));
+  batch.nodes =
+      std::make_shared<arrow::UInt32Array>(nodes.size(), nodes_res.value());
+
+  for (const Feature& feature : features_) {
+    auto gathered = Gather(feature, nodes);
+    if (!gathered) {
+      return gathered.error();
+    }
+    batch.features.emplace_back(std::move(gathered.value()));
+  }
+  return batch;
+}
+
+katana::Result<void>
+NeighborSampler::SampleHop(
+    uint32_t hop, uint64_t stream, std::vector<uint32_t>* nodes,
+    SampledBlock* block) {
+  const GraphTopology& topology = pg_->topology();
+  uint64_t fanout = plan_.fanouts()[hop];
+  bool replace = plan_.replace();
+  uint64_t hop_stream = SampleSeed(stream, hop);
+  uint64_t num_destinations = nodes->size();
+
+  // Entry i + 1 is the number of edges sampled for node i
+  std::vector<uint64_t> offsets(num_destinations + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_destinations),
+      [&](uint64_t i) {
+        uint64_t degree = topology.edges((*nodes)[i]).size();
+        offsets[i + 1] =
+            degree == 0 ? 0 : (replace ? fanout : std::min(degree, fanout));
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+  uint64_t num_sampled = offsets.back();
+
+  auto edges_res = Allocate(num_sampled * sizeof(uint64_t), pool_);
+  auto sources_res = Allocate(num_sampled * sizeof(uint32_t), pool_);
+  auto destinations_res = Allocate(num_sampled * sizeof(uint32_t), pool_);
+  if (!edges_res) {
+    return edges_res.error();
+  }
+  if (!sources_res) {
+    return sources_res.error();
+  }
+  if (!destinations_res) {
+    return destinations_res.error();
+  }
+  uint64_t* edges = Values<uint64_t>(edges_res.value());
+  uint32_t* sources = Values<uint32_t>(sources_res.value());
+  uint32_t* destinations = Values<uint32_t>(destinations_res.value());
+
+  // Sample the edges of each node, and keep the nodes they lead to in
+  // sources until they get local indices
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_destinations),
+      [&](uint64_t i) {
+        auto range = topology.edges((*nodes)[i]);
+        uint64_t first_edge = *range.begin();
+        uint64_t degree = range.size();
+        uint64_t begin = offsets[i];
+        uint64_t k = offsets[i + 1] - begin;
+        uint64_t seed = SampleSeed(hop_stream, i);
+        uint64_t* out = edges + begin;
+        if (replace) {
+          for (uint64_t c = 0; c < k; ++c) {
+            out[c] = first_edge + SampleSeed(seed, c) % degree;
+          }
+        } else if (k == degree) {
+          std::iota(out, out + k, first_edge);
+        } else {
+          SampleDistinct(first_edge, degree, seed, k, out);
+        }
+        for (uint64_t c = 0; c < k; ++c) {
+          destinations[begin + c] = i;
+          sources[begin + c] = topology.edge_dest(out[c]);
+        }
+      },
+      katana::steal(), katana::loopname("NeighborSampling-Sample"));
+
+  // Number the new nodes in the order of their first appearance, so that
+  // the numbering does not depend on the schedule
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sampled),
+      [&](uint64_t p) {
+        uint32_t node = sources[p];
+        if (local_[node] == kNotSampled) {
+          katana::atomicMin(first_[node], p);
+        }
+      },
+      katana::no_stats());
+  std::vector<uint64_t> new_offsets(num_sampled + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sampled),
+      [&](uint64_t p) {
+        uint32_t node = sources[p];
+        new_offsets[p + 1] = local_[node] == kNotSampled &&
+                             first_[node].load(std::memory_order_relaxed) == p;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      new_offsets.begin(), new_offsets.end(), new_offsets.begin());
+
+  uint64_t num_old = nodes->size();
+  nodes->resize(num_old + new_offsets.back());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sampled),
+      [&](uint64_t p) {
+        if (new_offsets[p + 1] != new_offsets[p]) {
+          uint32_t node = sources[p];
+          local_[node] = num_old + new_offsets[p];
+          (*nodes)[num_old + new_offsets[p]] = node;
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sampled),
+      [&](uint64_t p) { sources[p] = local_[sources[p]]; },
+      katana::no_stats());
+
+  block->edges =
+      std::make_shared<arrow::UInt64Array>(num_sampled, edges_res.value());
+  block->sources =
+      std::make_shared<arrow::UInt32Array>(num_sampled, sources_res.value());
+  block->destinations = std::make_shared<arrow::UInt32Array>(
+      num_sampled, destinations_res.value());
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+NeighborSampler::Gather(
+    const Feature& feature, const std::vector<uint32_t>& nodes) {
+  uint64_t row_bytes = feature.row_bytes;
+  auto buffer_res = Allocate(nodes.size() * row_bytes, pool_);
+  if (!buffer_res) {
+    return buffer_res.error();
+  }
+  uint8_t* out = buffer_res.value()->mutable_data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, nodes.size()),
+      [&](uint64_t i) {
+        std::memcpy(
+            out + i * row_bytes, feature.rows + nodes[i] * row_bytes,
+            row_bytes);
+      },
+      katana::no_stats());
+
+  const std::shared_ptr<arrow::DataType>& type = feature.array->type();
+  if (type->id() != arrow::Type::FIXED_SIZE_LIST) {
+    return arrow::MakeArray(arrow::ArrayData::Make(
+        type, nodes.size(), {nullptr, buffer_res.value()}));
+  }
+  const auto& list_type = static_cast<const arrow::FixedSizeListType&>(*type);
+  auto values = arrow::MakeArray(arrow::ArrayData::Make(
+      list_type.value_type(), nodes.size() * list_type.list_size(),
+      {nullptr, buffer_res.value()}));
+  return std::make_shared<arrow::FixedSizeListArray>(
+      type, nodes.size(), values);
+}
+
+void
+NeighborSampler::Reset(const std::vector<uint32_t>& nodes) {
+  katana::do_all(
+      katana::iterate(nodes.begin(), nodes.end()),
+      [&](uint32_t node) {
+        local_[node] = kNotSampled;
+        first_[node].store(kUnseen, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+}
+
+MinibatchLoader::MinibatchLoader(
+    NeighborSampler* sampler, std::vector<uint32_t> seeds,
+    uint32_t batch_size)
+    : sampler_(sampler), seeds_(std::move(seeds)), batch_size_(batch_size) {
+  KATANA_LOG_ASSERT(batch_size_ > 0);
+  Prefetch();
+}
+
+MinibatchLoader::~MinibatchLoader() {
+  if (in_flight_.valid()) {
+    in_flight_.wait();
+  }
+}
+
+uint64_t
+MinibatchLoader::num_batches() const {
+  return (seeds_.size() + batch_size_ - 1) / batch_size_;
+}
+
+katana::Result<SampledMinibatch>
+MinibatchLoader::Next() {
+  if (done()) {
+    return KATANA_ERROR(ErrorCode::NotFound, "no batches left");
+  }
+  Result<SampledMinibatch> batch = in_flight_.get();
+  ++next_batch_;
+  Prefetch();
+  return batch;
+}
+
+void
+MinibatchLoader::Prefetch() {
+  if (done()) {
+    return;
+  }
+  uint64_t begin = next_batch_ * batch_size_;
+  uint64_t end = std::min<uint64_t>(begin + batch_size_, seeds_.size());
+  in_flight_ = std::async(std::launch::async, [this, begin, end]() {
+    std::vector<uint32_t> batch(seeds_.begin() + begin, seeds_.begin() + end);
+    return sampler_->Sample(batch);
+  });
+}
@@ -0,0 +1,234 @@
+#include "katana/analytics/PlanTuner.h"
+
+#include <fstream>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint64_t kProfileSamples = 1024;
+constexpr uint64_t kFnvOffset = UINT64_C(0xcbf29ce484222325);
+constexpr uint64_t kFnvPrime = UINT64_C(0x100000001b3);
+constexpr Node kUnsampled = std::numeric_limits<Node>::max();
+
+/// Add the bytes of value to an FNV-1a hash
+uint64_t
+Mix(uint64_t hash, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeEdgeProperties(
+    const katana::PropertyGraph& pg, const std::vector<std::string>& names,
+    std::vector<uint64_t>* edges) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    std::shared_ptr<arrow::ChunkedArray> column =
+        pg.edge_properties()->GetColumnByName(name);
+    if (!column) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no edge property {}", name);
+    }
+    fields.emplace_back(pg.edge_schema()->GetFieldByName(name));
+    columns.emplace_back(std::move(column));
+  }
+
+  auto res = arrow::compute::Take(
+      arrow::Table::Make(arrow::schema(fields), columns),
+      katana::BuildArray(*edges));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "selecting edges: {}", res.status());
+  }
+  return res.ValueOrDie().table();
+}
+
+}  // namespace
+
+katana::analytics::GraphProfile
+katana::analytics::GraphProfile::Compute(const PropertyGraph& pg) {
+  GraphProfile profile;
+  profile.num_nodes = pg.num_nodes();
+  profile.num_edges = pg.num_edges();
+  profile.power_law = IsApproximateDegreeDistributionPowerLaw(pg);
+
+  uint64_t hash = Mix(Mix(kFnvOffset, profile.num_nodes), profile.num_edges);
+  uint64_t num_samples = std::min(kProfileSamples, profile.num_nodes);
+  std::vector<uint64_t> degrees;
+  degrees.reserve(num_samples);
+  for (uint64_t i = 0; i < num_samples; ++i) {
+    Node node = i * profile.num_nodes / num_samples;
+    auto [begin, end] = pg.topology().edge_range(node);
+    degrees.emplace_back(end - begin);
+    hash = Mix(hash, end);
+    if (begin != end) {
+      hash = Mix(hash, pg.topology().edge_dest(begin));
+    }
+  }
+  profile.fingerprint = hash;
+
+  if (!degrees.empty()) {
+    std::sort(degrees.begin(), degrees.end());
+    profile.sampled_median_degree = degrees[degrees.size() / 2];
+    profile.sampled_max_degree = degrees.back();
+  }
+  return profile;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SampleGraph(
+    const PropertyGraph& pg, uint64_t num_nodes,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pg.topology();
+  uint64_t target = std::min(num_nodes, pg.num_nodes());
+
+  // Visit nodes breadth first, in order of their new IDs. When a search runs
+  // out of nodes, the next one starts from the first unvisited node.
+  std::vector<Node> new_id(pg.num_nodes(), kUnsampled);
+  std::vector<Node> sampled;
+  sampled.reserve(target);
+  auto visit = [&](Node node) {
+    new_id[node] = sampled.size();
+    sampled.emplace_back(node);
+  };
+  Node next_source = 0;
+  if (target > 0) {
+    visit(pg.num_edges() > 0 ? SourcePicker(pg).PickNext() : 0);
+  }
+  for (uint64_t head = 0; sampled.size() < target; ++head) {
+    if (head == sampled.size()) {
+      while (new_id[next_source] != kUnsampled) {
+        ++next_source;
+      }
+      visit(next_source);
+    }
+    for (auto e : topology.edges(sampled[head])) {
+      Node dest = topology.edge_dest(e);
+      if (new_id[dest] == kUnsampled && sampled.size() < target) {
+        visit(dest);
+      }
+    }
+  }
+
+  std::vector<uint64_t> out_indices;
+  out_indices.reserve(sampled.size());
+  std::vector<uint32_t> out_dests;
+  std::vector<uint64_t> taken_edges;
+  for (Node node : sampled) {
+    for (auto e : topology.edges(node)) {
+      Node dest = new_id[topology.edge_dest(e)];
+      if (dest != kUnsampled) {
+        out_dests.emplace_back(dest);
+        taken_edges.emplace_back(e);
+      }
+    }
+    out_indices.emplace_back(out_dests.size());
+  }
+
+  auto sample = std::make_unique<PropertyGraph>();
+  if (auto res = sample->SetTopology(GraphTopology{
+          .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+              katana::BuildArray(out_indices)),
+          .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+              katana::BuildArray(out_dests)),
+      });
+      !res) {
+    return res.error();
+  }
+  if (!edge_properties.empty()) {
+    auto props_res = TakeEdgeProperties(pg, edge_properties, &taken_edges);
+    if (!props_res) {
+      return props_res.error();
+    }
+    if (auto res = sample->AddEdgeProperties(props_res.value()); !res) {
+      return res.error();
+    }
+  }
+  return std::unique_ptr<PropertyGraph>(std::move(sample));
+}
+
+katana::analytics::PlanCache&
+katana::analytics::PlanCache::Get() {
+  static PlanCache cache;
+  return cache;
+}
+
+katana::Result<void>
+katana::analytics::PlanCache::Load() {
+  if (loaded_) {
+    return ResultSuccess();
+  }
+  loaded_ = true;
+  if (!GetEnv("KATANA_PLAN_CACHE", &path_) || path_.empty()) {
+    return ResultSuccess();
+  }
+
+  std::ifstream in(path_);
+  if (!in) {
+    // Nothing has been cached yet
+    return ResultSuccess();
+  }
+  // Each line is a key and a choice separated by a space; later lines
+  // replace earlier ones
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t space = line.find(' ');
+    if (space == std::string::npos) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "malformed line in {}: {}", path_, line);
+    }
+    choices_[line.substr(0, space)] = line.substr(space + 1);
+  }
+  return ResultSuccess();
+}
+
+std::optional<std::string>
+katana::analytics::PlanCache::Find(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto res = Load(); !res) {
+    KATANA_LOG_WARN("ignoring plan cache: {}", res.error());
+  }
+  auto it = choices_.find(key);
+  if (it == choices_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+katana::Result<void>
+katana::analytics::PlanCache::Insert(
+    const std::string& key, const std::string& choice) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto res = Load(); !res) {
+    KATANA_LOG_WARN("ignoring plan cache: {}", res.error());
+  }
+  choices_[key] = choice;
+  if (path_.empty()) {
+    return ResultSuccess();
+  }
+
+  std::ofstream out(path_, std::ios::app);
+  out << key << ' ' << choice << '\n';
+  if (!out) {
+    return KATANA_ERROR(katana::ResultErrno(), "writing {}", path_);
+  }
+  return ResultSuccess();
+}
+
+void
+katana::analytics::PlanCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  loaded_ = true;
+  choices_.clear();
+}
@@ -0,0 +1,1122 @@
+#include "katana/analytics/QueryServer.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include <arrow/compute/api.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+/// Get field key of obj, or fail if it is missing or of another type
+template <typename T>
+katana::Result<T>
+Field(const json& obj, const char* key) {
+  auto it = obj.find(key);
+  if (it == obj.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "request has no {}", key);
+  }
+  try {
+    return it->get<T>();
+  } catch (const json::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} of request: {}", key,
+        exp.what());
+  }
+}
+
+/// Get field key of obj, or default_value if it is missing
+template <typename T>
+katana::Result<T>
+OptionalField(const json& obj, const char* key, T default_value) {
+  if (!obj.is_object() || !obj.contains(key)) {
+    return default_value;
+  }
+  return Field<T>(obj, key);
+}
+
+/// Run analytic on pg. If workspace is not null, analytics that can take it
+/// add output with it.
+katana::Result<json>
+RunAnalytic(
+    katana::PropertyGraph* pg, const std::string& analytic, const json& args,
+    const std::string& output,
+    katana::analytics::AnalyticsWorkspace* workspace) {
+  using namespace katana::analytics;
+
+  if (analytic == "bfs") {
+    auto source = Field<uint32_t>(args, "source");
+    if (!source) {
+      return source.error();
+    }
+    auto r = workspace ? Bfs(pg, source.value(), output, workspace)
+                       : Bfs(pg, source.value(), output);
+    if (!r) {
+      return r.error();
+    }
+    auto stats = BfsStatistics::Compute(pg, output);
+    if (!stats) {
+      return stats.error();
+    }
+    return json{
+        {"source_node", stats.value().source_node},
+        {"max_distance", stats.value().max_distance},
+        {"total_distance", stats.value().total_distance},
+        {"n_reached_nodes", stats.value().n_reached_nodes}};
+  }
+  if (analytic == "sssp") {
+    auto source = Field<uint32_t>(args, "source");
+    if (!source) {
+      return source.error();
+    }
+    auto weight = Field<std::string>(args, "edge_weight_property");
+    if (!weight) {
+      return weight.error();
+    }
+    auto r = workspace
+                 ? Sssp(pg, source.value(), weight.value(), output, workspace)
+                 : Sssp(pg, source.value(), weight.value(), output);
+    if (!r) {
+      return r.error();
+    }
+    auto stats = SsspStatistics::Compute(pg, output);
+    if (!stats) {
+      return stats.error();
+    }
+    return json{
+        {"max_distance", stats.value().max_distance},
+        {"total_distance", stats.value().total_distance},
+        {"n_reached_nodes", stats.value().n_reached_nodes}};
+  }
+  if (analytic == "connected_components") {
+    if (auto r = ConnectedComponents(pg, output); !r) {
+      return r.error();
+    }
+    auto stats = ConnectedComponentsStatistics::Compute(pg, output);
+    if (!stats) {
+      return stats.error();
+    }
+    return json{
+        {"total_components", stats.value().total_components},
+        {"total_non_trivial_components",
+         stats.value().total_non_trivial_components},
+        {"largest_component_size", stats.value().largest_component_size},
+        {"largest_component_ratio", stats.value().largest_component_ratio}};
+  }
+  if (analytic == "pagerank") {
+    if (auto r = Pagerank(pg, output); !r) {
+      return r.error();
+    }
+    auto stats = PagerankStatistics::Compute(pg, output);
+    if (!stats) {
+      return stats.error();
+    }
+    return json{
+        {"max_rank", stats.value().max_rank},
+        {"min_rank", stats.value().min_rank},
+        {"average_rank", stats.value().average_rank}};
+  }
+  if (analytic == "k_core") {
+    auto k = Field<uint32_t>(args, "k");
+    if (!k) {
+      return k.error();
+    }
+    if (auto r = KCore(pg, k.value(), output); !r) {
+      return r.error();
+    }
+    auto stats = KCoreStatistics::Compute(pg, k.value(), output);
+    if (!stats) {
+      return stats.error();
+    }
+    return json{
+        {"number_of_nodes_in_kcore", stats.value().number_of_nodes_in_kcore}};
+  }
+  if (analytic == "triangle_count") {
+    auto triangles = TriangleCount(pg);
+    if (!triangles) {
+      return triangles.error();
+    }
+    return json{{"triangles", triangles.value()}};
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unknown analytic {}", analytic);
+}
+
+/// Remove the properties of pg not in node_names or edge_names, except keep
+katana::Result<void>
+RemoveScratchProperties(
+    katana::PropertyGraph* pg, const std::set<std::string>& node_names,
+    const std::set<std::string>& edge_names, const std::string& keep) {
+  for (const auto& name : pg->GetNodePropertyNames()) {
+    if (name != keep && !node_names.count(name)) {
+      if (auto r = pg->RemoveNodeProperty(name); !r) {
+        return r.error();
+      }
+    }
+  }
+  for (const auto& name : pg->GetEdgePropertyNames()) {
+    if (name != keep && !edge_names.count(name)) {
+      if (auto r = pg->RemoveEdgeProperty(name); !r) {
+        return r.error();
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+SendAll(int fd, const void* buf, size_t size) {
+  const auto* ptr = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t ret = send(fd, ptr, size, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "sending");
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+RecvAll(int fd, void* buf, size_t size) {
+  auto* ptr = static_cast<char*>(buf);
+  while (size > 0) {
+    ssize_t ret = recv(fd, ptr, size, 0);
+    if (ret == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "connection closed by peer");
+    }
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "receiving");
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+SendMessage(int fd, const json& message) {
+  auto data = katana::JsonDump(message);
+  if (!data) {
+    return data.error();
+  }
+  uint64_t size = data.value().size();
+  if (auto r = SendAll(fd, &size, sizeof(size)); !r) {
+    return r.error();
+  }
+  return SendAll(fd, data.value().data(), size);
+}
+
+katana::Result<json>
+RecvMessage(int fd) {
+  uint64_t size{};
+  if (auto r = RecvAll(fd, &size, sizeof(size)); !r) {
+    return r.error();
+  }
+  std::string data(size, '\0');
+  if (auto r = RecvAll(fd, data.data(), size); !r) {
+    return r.error();
+  }
+  return katana::JsonParse<json>(data);
+}
+
+/// Rows per record batch of a fetch by default
+constexpr int64_t kDefaultBatchRows = INT64_C(1) << 16;
+
+/// An arrow output stream that sends what is written to a socket. Record
+/// batches are written buffer by buffer, so columns are sent from where
+/// they lie.
+class SocketOutputStream : public arrow::io::OutputStream {
+public:
+  explicit SocketOutputStream(int fd) : fd_(fd) {}
+
+  arrow::Status Close() override {
+    closed_ = true;
+    return arrow::Status::OK();
+  }
+  bool closed() const override { return closed_; }
+  arrow::Result<int64_t> Tell() const override { return position_; }
+
+  arrow::Status Write(const void* data, int64_t nbytes) override {
+    if (auto r = SendAll(fd_, data, nbytes); !r) {
+      return arrow::Status::IOError(fmt::format("{}", r.error()));
+    }
+    position_ += nbytes;
+    return arrow::Status::OK();
+  }
+
+private:
+  int fd_;
+  int64_t position_{0};
+  bool closed_{false};
+};
+
+/// An arrow input stream that receives from a socket until the peer closes
+/// it
+class SocketInputStream : public arrow::io::InputStream {
+public:
+  explicit SocketInputStream(int fd) : fd_(fd) {}
+
+  arrow::Status Close() override {
+    closed_ = true;
+    return arrow::Status::OK();
+  }
+  bool closed() const override { return closed_; }
+  arrow::Result<int64_t> Tell() const override { return position_; }
+
+  arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
+    auto* ptr = static_cast<char*>(out);
+    int64_t received = 0;
+    while (received < nbytes) {
+      ssize_t ret = recv(fd_, ptr + received, nbytes - received, 0);
+      if (ret == 0) {
+        break;
+      }
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return arrow::Status::IOError("receiving: ", std::strerror(errno));
+      }
+      received += ret;
+    }
+    position_ += received;
+    return received;
+  }
+
+  arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override {
+    auto buffer_res = arrow::AllocateResizableBuffer(nbytes);
+    if (!buffer_res.ok()) {
+      return buffer_res.status();
+    }
+    std::shared_ptr<arrow::ResizableBuffer> buffer =
+        std::move(buffer_res.ValueOrDie());
+    auto read_res = Read(nbytes, buffer->mutable_data());
+    if (!read_res.ok()) {
+      return read_res.status();
+    }
+    if (auto status = buffer->Resize(read_res.ValueOrDie(), false);
+        !status.ok()) {
+      return status;
+    }
+    return buffer;
+  }
+
+private:
+  int fd_;
+  int64_t position_{0};
+  bool closed_{false};
+};
+
+/// Send table to fd as an Arrow IPC stream of batches of batch_rows rows
+katana::Result<void>
+SendTable(int fd, const arrow::Table& table, int64_t batch_rows) {
+  SocketOutputStream sink(fd);
+  auto writer_res = arrow::ipc::MakeStreamWriter(&sink, table.schema());
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "starting stream: {}",
+        writer_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      writer_res.ValueOrDie();
+  arrow::TableBatchReader reader(table);
+  reader.set_chunksize(batch_rows);
+  for (;;) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    if (auto status = reader.ReadNext(&batch); !status.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "slicing batch: {}", status);
+    }
+    if (!batch) {
+      break;
+    }
+    if (auto status = writer->WriteRecordBatch(*batch); !status.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "sending batch: {}", status);
+    }
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "ending stream: {}", status);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Receive the Arrow IPC stream that SendTable sends on fd
+katana::Result<std::shared_ptr<arrow::Table>>
+RecvTable(int fd) {
+  SocketInputStream source(fd);
+  auto reader_res = arrow::ipc::RecordBatchStreamReader::Open(&source);
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "opening stream: {}",
+        reader_res.status());
+  }
+  std::shared_ptr<arrow::Table> table;
+  if (auto status = reader_res.ValueOrDie()->ReadAll(&table); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "receiving batches: {}", status);
+  }
+  return table;
+}
+
+json
+FetchResponse(const arrow::Table& table) {
+  return json{
+      {"num_rows", table.num_rows()}, {"columns", table.ColumnNames()}};
+}
+
+bool
+IsFetch(const json& request) {
+  if (!request.is_object()) {
+    return false;
+  }
+  auto it = request.find("op");
+  return it != request.end() && it->is_string() && *it == "fetch";
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& values,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto res = arrow::compute::Take(values, indices);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "selecting rows: {}", res.status());
+  }
+  return res.ValueOrDie().chunked_array();
+}
+
+katana::Result<sockaddr_un>
+UnixAddress(const std::string& socket_path) {
+  sockaddr_un addr{};
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "socket path {} is too long",
+        socket_path);
+  }
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  return addr;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::QueryServer::AddGraph(
+    const std::string& name, std::unique_ptr<PropertyGraph> pg) {
+  if (graphs_.count(name)) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "graph {} is already loaded", name);
+  }
+  graphs_.emplace(name, std::move(pg));
+  return ResultSuccess();
+}
+
+json
+katana::analytics::QueryServer::Handle(const json& request) {
+  auto res = HandleOrError(request);
+  if (!res) {
+    return json{{"ok", false}, {"error", fmt::format("{}", res.error())}};
+  }
+  json response = std::move(res.value());
+  response["ok"] = true;
+  return response;
+}
+
+katana::Result<json>
+katana::analytics::QueryServer::HandleOrError(const json& request) {
+  if (!request.is_object()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "request is not a JSON object");
+  }
+  auto op = Field<std::string>(request, "op");
+  if (!op) {
+    return op.error();
+  }
+  if (op.value() == "load") {
+    return Load(request);
+  }
+  if (op.value() == "unload") {
+    return Unload(request);
+  }
+  if (op.value() == "list") {
+    return List();
+  }
+  if (op.value() == "run") {
+    return Run(request);
+  }
+  if (op.value() == "fetch") {
+    // Without a socket to stream to, describe the rows
+    auto fetched = Fetch(request);
+    if (!fetched) {
+      return fetched.error();
+    }
+    return FetchResponse(*fetched.value().table);
+  }
+  if (op.value() == "shutdown") {
+    shutdown_ = true;
+    return json::object();
+  }
+  return KATANA_ERROR(
+      ErrorCode::InvalidArgument, "unknown op {}", op.value());
+}
+
+katana::Result<json>
+katana::analytics::QueryServer::Load(const json& request) {
+  auto name = Field<std::string>(request, "graph");
+  if (!name) {
+    return name.error();
+  }
+  auto rdg = Field<std::string>(request, "rdg");
+  if (!rdg) {
+    return rdg.error();
+  }
+  auto map_topology = OptionalField<bool>(request, "map_topology", false);
+  if (!map_topology) {
+    return map_topology.error();
+  }
+  if (graphs_.count(name.value())) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "graph {} is already loaded", name.value());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.map_topology_read_only = map_topology.value();
+  std::vector<std::string> node_properties;
+  if (request.contains("node_properties")) {
+    auto r = Field<std::vector<std::string>>(request, "node_properties");
+    if (!r) {
+      return r.error();
+    }
+    node_properties = std::move(r.value());
+    opts.node_properties = &node_properties;
+  }
+  std::vector<std::string> edge_properties;
+  if (request.contains("edge_properties")) {
+    auto r = Field<std::vector<std::string>>(request, "edge_properties");
+    if (!r) {
+      return r.error();
+    }
+    edge_properties = std::move(r.value());
+    opts.edge_properties = &edge_properties;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto pg = PropertyGraph::Make(rdg.value(), opts);
+  if (!pg) {
+    return pg.error().WithContext("loading {}", rdg.value());
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  graphs_.emplace(name.value(), std::move(pg.value()));
+  return json{{"seconds", elapsed.count()}};
+}
+
+katana::Result<json>
+katana::analytics::QueryServer::Unload(const json& request) {
+  auto name = Field<std::string>(request, "graph");
+  if (!name) {
+    return name.error();
+  }
+  if (graphs_.erase(name.value()) == 0) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "graph {} is not loaded", name.value());
+  }
+  memos_.erase(name.value());
+  workspaces_.erase(name.value());
+  return json::object();
+}
+
+json
+katana::analytics::QueryServer::List() const {
+  json graphs = json::array();
+  for (const auto& [name, pg] : graphs_) {
+    graphs.push_back(json{
+        {"name", name},
+        {"num_nodes", pg->num_nodes()},
+        {"num_edges", pg->num_edges()},
+        {"node_properties", pg->GetNodePropertyNames()},
+        {"edge_properties", pg->GetEdgePropertyNames()}});
+  }
+  return json{{"graphs", std::move(graphs)}};
+}
+
+katana::Result<json>
+katana::analytics::QueryServer::Run(const json& request) {
+  auto name = Field<std::string>(request, "graph");
+  if (!name) {
+    return name.error();
+  }
+  auto it = graphs_.find(name.value());
+  if (it == graphs_.end()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "graph {} is not loaded", name.value());
+  }
+  PropertyGraph* pg = it->second.get();
+  auto analytic = Field<std::string>(request, "analytic");
+  if (!analytic) {
+    return analytic.error();
+  }
+  auto args = OptionalField<json>(request, "args", json::object());
+  if (!args) {
+    return args.error();
+  }
+  auto output = OptionalField<std::string>(
+      request, "output_property", fmt::format("__query_{}", num_runs_++));
+  if (!output) {
+    return output.error();
+  }
+  auto threads = OptionalField<uint32_t>(request, "threads", 0);
+  if (!threads) {
+    return threads.error();
+  }
+  auto memoize = OptionalField<bool>(request, "memoize", false);
+  if (!memoize) {
+    return memoize.error();
+  }
+
+  auto node_names = pg->GetNodePropertyNames();
+  auto edge_names = pg->GetEdgePropertyNames();
+  std::string keep = request.contains("output_property") ? output.value() : "";
+
+  // Objects dump with sorted keys, so equal args have equal keys
+  std::string memo_key;
+  if (memoize.value()) {
+    auto dumped = katana::JsonDump(args.value());
+    if (!dumped) {
+      return dumped.error();
+    }
+    memo_key = analytic.value() + dumped.value();
+    const auto& memos = memos_[name.value()];
+    if (auto m = memos.find(memo_key); m != memos.end()) {
+      return Replay(pg, m->second, keep);
+    }
+  }
+
+  unsigned previous_threads = katana::getActiveThreads();
+  if (threads.value() > 0) {
+    katana::setActiveThreads(threads.value());
+  }
+  // Outputs that are not kept are scratch space and come from the workspace
+  // of the graph, which keeps their columns for later runs
+  AnalyticsWorkspace* workspace = nullptr;
+  if (keep.empty() && !memoize.value()) {
+    auto& ws = workspaces_[name.value()];
+    if (!ws) {
+      ws = std::make_unique<AnalyticsWorkspace>(pg);
+    }
+    workspace = ws.get();
+  }
+
+  auto dispatch_before = katana::GetThreadPool().getDispatchStats();
+  auto start = std::chrono::steady_clock::now();
+  auto result = RunAnalytic(
+      pg, analytic.value(), args.value(), output.value(), workspace);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  auto dispatch_after = katana::GetThreadPool().getDispatchStats();
+  katana::setActiveThreads(previous_threads);
+
+  if (result && memoize.value()) {
+    memos_[name.value()][memo_key] = Memo{
+        .result = result.value(),
+        .output = pg->GetNodeProperty(output.value()),
+    };
+  }
+
+  if (workspace && workspace->HasNodeProperty(output.value())) {
+    if (auto r = workspace->ReleaseNodeProperty(output.value()); !r) {
+      return r.error();
+    }
+  }
+  if (auto r = RemoveScratchProperties(
+          pg, std::set<std::string>(node_names.begin(), node_names.end()),
+          std::set<std::string>(edge_names.begin(), edge_names.end()), keep);
+      !r) {
+    return r.error();
+  }
+  if (!result) {
+    return result.error();
+  }
+  uint64_t loops = dispatch_after.runs - dispatch_before.runs;
+  uint64_t dispatch_ns = dispatch_after.total_ns - dispatch_before.total_ns;
+  return json{
+      {"result", std::move(result.value())},
+      {"seconds", elapsed.count()},
+      {"parallel_loops", loops},
+      {"dispatch_latency_ns", loops ? dispatch_ns / loops : 0},
+      {"memoized", false}};
+}
+
+katana::Result<json>
+katana::analytics::QueryServer::Replay(
+    PropertyGraph* pg, const Memo& memo, const std::string& keep) {
+  auto start = std::chrono::steady_clock::now();
+  if (!keep.empty() && memo.output) {
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(keep, memo.output->type())}),
+        {memo.output});
+    if (auto r = pg->AddNodeProperties(table); !r) {
+      return r.error();
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return json{
+      {"result", memo.result},
+      {"seconds", elapsed.count()},
+      {"parallel_loops", 0},
+      {"dispatch_latency_ns", 0},
+      {"memoized", true}};
+}
+
+katana::Result<katana::analytics::QueryServer::Fetched>
+katana::analytics::QueryServer::Fetch(const json& request) {
+  auto name = Field<std::string>(request, "graph");
+  if (!name) {
+    return name.error();
+  }
+  auto it = graphs_.find(name.value());
+  if (it == graphs_.end()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "graph {} is not loaded", name.value());
+  }
+  const PropertyGraph& pg = *it->second;
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  auto table_name = OptionalField<std::string>(request, "table", "nodes");
+  if (!table_name) {
+    return table_name.error();
+  }
+  if (table_name.value() != "nodes" && table_name.value() != "edges") {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "table must be nodes or edges, not {}",
+        table_name.value());
+  }
+  bool is_nodes = table_name.value() == "nodes";
+  auto batch_rows =
+      OptionalField<int64_t>(request, "batch_rows", kDefaultBatchRows);
+  if (!batch_rows) {
+    return batch_rows.error();
+  }
+  if (batch_rows.value() <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "batch_rows must be positive");
+  }
+  auto partition = OptionalField<uint64_t>(request, "partition", 0);
+  if (!partition) {
+    return partition.error();
+  }
+  auto num_partitions = OptionalField<uint64_t>(request, "num_partitions", 1);
+  if (!num_partitions) {
+    return num_partitions.error();
+  }
+  if (partition.value() >= num_partitions.value()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "partition {} of {} does not exist",
+        partition.value(), num_partitions.value());
+  }
+  auto node_range = OptionalField<std::vector<uint64_t>>(
+      request, "node_range", {0, num_nodes});
+  if (!node_range) {
+    return node_range.error();
+  }
+  const std::vector<uint64_t>& range = node_range.value();
+  if (range.size() != 2 || range[0] > range[1] || range[1] > num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node_range must be [begin, end] with begin <= end <= {}", num_nodes);
+  }
+
+  std::vector<uint32_t> ids;
+  bool has_ids = request.contains("nodes");
+  if (has_ids) {
+    if (!is_nodes || request.contains("node_range")) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "nodes selects rows of the node table and excludes node_range");
+    }
+    auto r = Field<std::vector<uint32_t>>(request, "nodes");
+    if (!r) {
+      return r.error();
+    }
+    ids = std::move(r.value());
+    for (uint32_t id : ids) {
+      if (id >= num_nodes) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "node {} does not exist", id);
+      }
+    }
+  }
+
+  std::vector<std::string> properties;
+  if (request.contains("properties")) {
+    auto r = Field<std::vector<std::string>>(request, "properties");
+    if (!r) {
+      return r.error();
+    }
+    properties = std::move(r.value());
+  } else {
+    properties =
+        is_nodes ? pg.GetNodePropertyNames() : pg.GetEdgePropertyNames();
+  }
+
+  // The selected rows, then the partition of them to send
+  auto edge_begin = [&](uint64_t n) -> uint64_t {
+    return n > 0 ? topology.out_indices->Value(n - 1) : 0;
+  };
+  uint64_t rows_begin = 0;
+  uint64_t rows_end = ids.size();
+  if (!has_ids) {
+    rows_begin = is_nodes ? range[0] : edge_begin(range[0]);
+    rows_end = is_nodes ? range[1] : edge_begin(range[1]);
+  }
+  uint64_t num_rows = rows_end - rows_begin;
+  uint64_t begin =
+      rows_begin + num_rows * partition.value() / num_partitions.value();
+  uint64_t end =
+      rows_begin + num_rows * (partition.value() + 1) / num_partitions.value();
+  auto length = static_cast<int64_t>(end - begin);
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::shared_ptr<arrow::Array> indices;
+  if (is_nodes) {
+    std::vector<uint32_t> node_ids(length);
+    if (has_ids) {
+      std::copy(ids.begin() + begin, ids.begin() + end, node_ids.begin());
+    } else {
+      std::iota(node_ids.begin(), node_ids.end(), begin);
+    }
+    auto id_array = BuildArray(node_ids);
+    if (has_ids) {
+      indices = id_array;
+    }
+    fields.emplace_back(arrow::field("id", arrow::uint32()));
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(id_array));
+  } else {
+    // The source of each edge, from the node that owns the first one
+    std::vector<uint32_t> sources(length);
+    const auto& out_indices = *topology.out_indices;
+    uint64_t n = std::upper_bound(
+                     out_indices.raw_values(),
+                     out_indices.raw_values() + num_nodes, begin) -
+                 out_indices.raw_values();
+    for (uint64_t e = begin; e < end; ++n) {
+      uint64_t node_end = std::min<uint64_t>(out_indices.Value(n), end);
+      std::fill(
+          sources.begin() + (e - begin), sources.begin() + (node_end - begin),
+          n);
+      e = node_end;
+    }
+    fields.emplace_back(arrow::field("src", arrow::uint32()));
+    columns.emplace_back(
+        std::make_shared<arrow::ChunkedArray>(BuildArray(sources)));
+    fields.emplace_back(arrow::field("dst", arrow::uint32()));
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        topology.out_dests->Slice(begin, length)));
+  }
+
+  // Slices share the memory of the graph; only selected nodes are copied
+  auto add_column = [&](const std::string& column_name,
+                        const std::shared_ptr<arrow::ChunkedArray>& values)
+      -> Result<void> {
+    std::shared_ptr<arrow::ChunkedArray> rows;
+    if (indices) {
+      auto take_res = TakeRows(values, indices);
+      if (!take_res) {
+        return take_res.error();
+      }
+      rows = std::move(take_res.value());
+    } else {
+      rows = values->Slice(begin, length);
+    }
+    fields.emplace_back(arrow::field(column_name, rows->type()));
+    columns.emplace_back(std::move(rows));
+    return ResultSuccess();
+  };
+  const auto& user_ids = pg.local_to_user_id();
+  if (is_nodes && user_ids &&
+      static_cast<uint64_t>(user_ids->length()) == num_nodes) {
+    if (auto r = add_column("user_id", user_ids); !r) {
+      return r.error();
+    }
+  }
+  for (const std::string& property : properties) {
+    auto values = is_nodes ? pg.GetNodeProperty(property)
+                           : pg.GetEdgeProperty(property);
+    if (!values) {
+      return KATANA_ERROR(
+          ErrorCode::PropertyNotFound, "graph {} has no {} property {}",
+          name.value(), is_nodes ? "node" : "edge", property);
+    }
+    if (auto r = add_column(property, values); !r) {
+      return r.error();
+    }
+  }
+
+  return Fetched{
+      .table = arrow::Table::Make(arrow::schema(fields), columns, length),
+      .batch_rows = batch_rows.value(),
+  };
+}
+
+void
+katana::analytics::QueryServer::StartStream(
+    int fd, std::shared_ptr<arrow::Table> table, int64_t batch_rows) {
+  streams_.emplace_back([fd, table = std::move(table), batch_rows]() {
+    if (auto r = SendTable(fd, *table, batch_rows); !r) {
+      KATANA_LOG_WARN("streaming fetched rows: {}", r.error());
+    }
+    close(fd);
+  });
+}
+
+void
+katana::analytics::QueryServer::FinishStreams() {
+  for (std::thread& stream : streams_) {
+    stream.join();
+  }
+  streams_.clear();
+}
+
+katana::analytics::QueryServer::~QueryServer() { FinishStreams(); }
+
+katana::Result<void>
+katana::analytics::QueryServer::Serve(const std::string& socket_path) {
+  auto addr = UnixAddress(socket_path);
+  if (!addr) {
+    return addr.error();
+  }
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    return KATANA_ERROR(ResultErrno(), "creating socket");
+  }
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr.value()),
+           sizeof(addr.value())) != 0 ||
+      listen(listen_fd, SOMAXCONN) != 0) {
+    auto err = ResultErrno();
+    close(listen_fd);
+    return KATANA_ERROR(err, "listening at {}", socket_path);
+  }
+
+  // Wait for requests on the listening socket and every open connection and
+  // handle them as they come, one at a time
+  std::vector<pollfd> fds{{listen_fd, POLLIN, 0}};
+  Result<void> result = ResultSuccess();
+  shutdown_ = false;
+  while (!shutdown_) {
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      result = KATANA_ERROR(ResultErrno(), "waiting for requests");
+      break;
+    }
+    for (size_t i = 1; i < fds.size() && !shutdown_; ++i) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      auto request = RecvMessage(fds[i].fd);
+      bool ok = static_cast<bool>(request);
+      if (ok && IsFetch(request.value())) {
+        auto fetched = Fetch(request.value());
+        if (fetched) {
+          // Stream the rows on a thread of their own, which takes over the
+          // connection
+          json response = FetchResponse(*fetched.value().table);
+          response["ok"] = true;
+          if (SendMessage(fds[i].fd, response)) {
+            StartStream(
+                fds[i].fd, std::move(fetched.value().table),
+                fetched.value().batch_rows);
+          } else {
+            close(fds[i].fd);
+          }
+          fds[i].fd = -1;
+          continue;
+        }
+        ok = static_cast<bool>(SendMessage(
+            fds[i].fd, json{
+                           {"ok", false},
+                           {"error", fmt::format("{}", fetched.error())}}));
+      } else if (ok) {
+        // Other requests may change the graphs that streams read
+        FinishStreams();
+        ok = static_cast<bool>(SendMessage(fds[i].fd, Handle(request.value())));
+      } else if (request.error() == ErrorCode::JsonParseFailed) {
+        ok = static_cast<bool>(SendMessage(
+            fds[i].fd,
+            json{{"ok", false}, {"error", "request is not valid JSON"}}));
+      }
+      if (!ok) {
+        close(fds[i].fd);
+        fds[i].fd = -1;
+      }
+    }
+    fds.erase(
+        std::remove_if(
+            fds.begin() + 1, fds.end(),
+            [](const pollfd& p) { return p.fd < 0; }),
+        fds.end());
+    if (fds[0].revents & POLLIN) {
+      if (int fd = accept(listen_fd, nullptr, nullptr); fd >= 0) {
+        fds.push_back(pollfd{fd, POLLIN, 0});
+      }
+    }
+  }
+
+  FinishStreams();
+  for (const auto& p : fds) {
+    close(p.fd);
+  }
+  unlink(socket_path.c_str());
+  return result;
+}
+
+katana::Result<json>
+katana::analytics::QueryServerCall(
+    const std::string& socket_path, const json& request) {
+  auto addr = UnixAddress(socket_path);
+  if (!addr) {
+    return addr.error();
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return KATANA_ERROR(ResultErrno(), "creating socket");
+  }
+  if (connect(
+          fd, reinterpret_cast<const sockaddr*>(&addr.value()),
+          sizeof(addr.value())) != 0) {
+    auto err = ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "connecting to {}", socket_path);
+  }
+  auto response = [&]() -> Result<json> {
+    if (auto r = SendMessage(fd, request); !r) {
+      return r.error();
+    }
+    return RecvMessage(fd);
+  }();
+  close(fd);
+  return response;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::QueryServerFetch(
+    const std::string& socket_path, const json& request,
+    uint32_t num_partitions) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "at least one partition is required");
+  }
+  auto addr = UnixAddress(socket_path);
+  if (!addr) {
+    return addr.error();
+  }
+
+  auto fetch_partition =
+      [&](uint32_t partition) -> Result<std::shared_ptr<arrow::Table>> {
+    json partition_request = request;
+    partition_request["op"] = "fetch";
+    if (num_partitions > 1) {
+      partition_request["partition"] = partition;
+      partition_request["num_partitions"] = num_partitions;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+      return KATANA_ERROR(ResultErrno(), "creating socket");
+    }
+    auto table = [&]() -> Result<std::shared_ptr<arrow::Table>> {
+      if (connect(
+              fd, reinterpret_cast<const sockaddr*>(&addr.value()),
+              sizeof(addr.value())) != 0) {
+        return KATANA_ERROR(ResultErrno(), "connecting to {}", socket_path);
+      }
+      if (auto r = SendMessage(fd, partition_request); !r) {
+        return r.error();
+      }
+      auto response = RecvMessage(fd);
+      if (!response) {
+        return response.error();
+      }
+      if (!response.value().value("ok", false)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "fetch failed: {}",
+            response.value().value("error", ""));
+      }
+      return RecvTable(fd);
+    }();
+    close(fd);
+    return table;
+  };
+
+  // Each partition is streamed over its own connection
+  std::vector<std::future<Result<std::shared_ptr<arrow::Table>>>> parts;
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    parts.emplace_back(std::async(std::launch::async, fetch_partition, p));
+  }
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  Result<void> result = ResultSuccess();
+  for (auto& part : parts) {
+    auto table = part.get();
+    if (!table) {
+      result = table.error();
+    } else {
+      tables.emplace_back(std::move(table.value()));
+    }
+  }
+  if (!result) {
+    return result.error();
+  }
+  if (tables.size() == 1) {
+    return tables.front();
+  }
+  auto concat_res = arrow::ConcatenateTables(tables);
+  if (!concat_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "concatenating partitions: {}",
+        concat_res.status());
+  }
+  return concat_res.ValueOrDie();
+}
@@ -0,0 +1,220 @@
+#include "katana/analytics/SemiExternal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+using Node = katana::EdgeStream::Node;
+
+constexpr unsigned kChunkSize = 64U;
+
+/// Find the root of node, halving the path to it. Parents are never larger
+/// than their children, so roots are the smallest node of their trees.
+Node
+Find(katana::LargeArray<std::atomic<Node>>* parent, Node node) {
+  while (true) {
+    Node p = (*parent)[node].load(std::memory_order_relaxed);
+    if (p == node) {
+      return node;
+    }
+    Node grandparent = (*parent)[p].load(std::memory_order_relaxed);
+    if (grandparent != p) {
+      (*parent)[node].compare_exchange_weak(
+          p, grandparent, std::memory_order_relaxed);
+    }
+    node = grandparent;
+  }
+}
+
+void
+Union(katana::LargeArray<std::atomic<Node>>* parent, Node a, Node b) {
+  while (true) {
+    a = Find(parent, a);
+    b = Find(parent, b);
+    if (a == b) {
+      return;
+    }
+    if (a < b) {
+      std::swap(a, b);
+    }
+    // Link the larger root under the smaller one, unless another thread
+    // linked it first
+    Node expected = a;
+    if ((*parent)[a].compare_exchange_strong(
+            expected, b, std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::SemiExternalBfs(EdgeStream* stream, uint32_t source) {
+  uint64_t num_nodes = stream->num_nodes();
+  if (source >= num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "source {} is not one of {} nodes", source,
+        num_nodes);
+  }
+
+  std::vector<uint32_t> levels(num_nodes, kSemiExternalUnreached);
+  katana::DynamicBitset visited;
+  visited.resize(num_nodes);
+  katana::DynamicBitset next;
+  next.resize(num_nodes);
+
+  levels[source] = 0;
+  visited.set(source);
+  std::vector<Node> frontier{source};
+  uint32_t level = 0;
+  while (!frontier.empty()) {
+    // The frontier is sorted, so the frontier nodes of a block are a range
+    // of it
+    auto frontier_range = [&](Node begin, Node end) {
+      return std::make_pair(
+          std::lower_bound(frontier.begin(), frontier.end(), begin),
+          std::lower_bound(frontier.begin(), frontier.end(), end));
+    };
+    auto res = stream->ForEachBlock(
+        [&](const EdgeBlock& block) {
+          auto [begin, end] =
+              frontier_range(block.node_begin(), block.node_end());
+          katana::do_all(
+              katana::iterate(begin, end),
+              [&](Node src) {
+                for (Node dest : block.OutDests(src)) {
+                  if (!visited.set(dest)) {
+                    levels[dest] = level + 1;
+                    next.set(dest);
+                  }
+                }
+              },
+              katana::steal(), katana::chunk_size<kChunkSize>(),
+              katana::no_stats(), katana::loopname("SemiExternalBfs"));
+        },
+        [&](Node begin, Node end) {
+          auto [first, last] = frontier_range(begin, end);
+          return first != last;
+        });
+    if (!res) {
+      return res.error().WithContext("level {}", level);
+    }
+
+    frontier = next.GetOffsets<Node>();
+    next.reset();
+    level += 1;
+  }
+
+  katana::ReportStatSingle("SemiExternalBfs", "Levels", level);
+  return levels;
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::SemiExternalConnectedComponents(EdgeStream* stream) {
+  uint64_t num_nodes = stream->num_nodes();
+  katana::LargeArray<std::atomic<Node>> parent;
+  parent.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { parent[n].store(n, std::memory_order_relaxed); },
+      katana::no_stats(), katana::loopname("SemiExternalCCInit"));
+
+  auto res = stream->ForEachBlock([&](const EdgeBlock& block) {
+    katana::do_all(
+        katana::iterate(block.node_begin(), block.node_end()),
+        [&](Node src) {
+          for (Node dest : block.OutDests(src)) {
+            Union(&parent, src, dest);
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(), katana::no_stats(),
+        katana::loopname("SemiExternalCC"));
+  });
+  if (!res) {
+    return res.error();
+  }
+
+  std::vector<uint32_t> components(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { components[n] = Find(&parent, n); }, katana::no_stats(),
+      katana::loopname("SemiExternalCCFinish"));
+  return components;
+}
+
+katana::Result<std::vector<float>>
+katana::analytics::SemiExternalPagerank(
+    EdgeStream* stream, const PagerankPlan& plan) {
+  uint64_t num_nodes = stream->num_nodes();
+  std::vector<float> ranks(num_nodes, 1.0f / num_nodes);
+  katana::LargeArray<float> contrib;
+  contrib.allocateBlocked(num_nodes);
+  katana::LargeArray<std::atomic<float>> sums;
+  sums.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        uint64_t degree = stream->degree(n);
+        contrib[n] = degree > 0 ? ranks[n] / degree : 0;
+        sums[n].store(0, std::memory_order_relaxed);
+      },
+      katana::no_stats(), katana::loopname("SemiExternalPagerankInit"));
+
+  unsigned int iteration = 0;
+  katana::GAccumulator<float> accum;
+  float base_score = (1.0f - plan.alpha()) / num_nodes;
+  while (num_nodes > 0) {
+    auto res = stream->ForEachBlock([&](const EdgeBlock& block) {
+      katana::do_all(
+          katana::iterate(block.node_begin(), block.node_end()),
+          [&](Node src) {
+            float c = contrib[src];
+            if (c == 0) {
+              return;
+            }
+            for (Node dest : block.OutDests(src)) {
+              katana::atomicAdd(sums[dest], c);
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::no_stats(), katana::loopname("SemiExternalPagerank"));
+    });
+    if (!res) {
+      return res.error().WithContext("iteration {}", iteration);
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](Node n) {
+          float value =
+              sums[n].exchange(0, std::memory_order_relaxed) * plan.alpha() +
+              base_score;
+          accum += std::fabs(value - ranks[n]);
+          ranks[n] = value;
+          uint64_t degree = stream->degree(n);
+          contrib[n] = degree > 0 ? value / degree : 0;
+        },
+        katana::no_stats(), katana::loopname("SemiExternalPagerankUpdate"));
+
+    iteration += 1;
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("SemiExternalPagerank", "Iterations", iteration);
+  return ranks;
+}
@@ -0,0 +1,144 @@
+#include "katana/analytics/VectorSimilarity.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_SIMILARITY_X86 1
+#include <immintrin.h>
+#else
+#define KATANA_SIMILARITY_X86 0
+#endif
+
+namespace {
+
+// Each kernel keeps several independent partial sums so that consecutive
+// multiply-adds do not wait on each other.
+
+float
+ScalarDotProduct(const float* a, const float* b, size_t n) {
+  float sums[4] = {0, 0, 0, 0};
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (size_t k = 0; k < 4; ++k) {
+      sums[k] += a[i + k] * b[i + k];
+    }
+  }
+  for (; i < n; ++i) {
+    sums[0] += a[i] * b[i];
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+#if KATANA_SIMILARITY_X86
+
+__attribute__((target("avx2,fma"))) float
+Avx2DotProduct(const float* a, const float* b, size_t n) {
+  constexpr size_t kLanes = 8;
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    sum0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    sum1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i + kLanes), _mm256_loadu_ps(b + i + kLanes),
+        sum1);
+  }
+  if (i + kLanes <= n) {
+    sum0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    i += kLanes;
+  }
+  __m256 sum = _mm256_add_ps(sum0, sum1);
+  __m128 half = _mm_add_ps(
+      _mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_movehdup_ps(half));
+  float total = _mm_cvtss_f32(half);
+  for (; i < n; ++i) {
+    total += a[i] * b[i];
+  }
+  return total;
+}
+
+__attribute__((target("avx512f"))) float
+Avx512DotProduct(const float* a, const float* b, size_t n) {
+  constexpr size_t kLanes = 16;
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    sum0 = _mm512_fmadd_ps(
+        _mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    sum1 = _mm512_fmadd_ps(
+        _mm512_loadu_ps(a + i + kLanes), _mm512_loadu_ps(b + i + kLanes),
+        sum1);
+  }
+  // The tail of less than two blocks is loaded under masks, which do not
+  // touch memory past the end of the vectors
+  for (; i < n; i += kLanes) {
+    size_t left = n - i < kLanes ? n - i : kLanes;
+    auto mask = static_cast<__mmask16>((1u << left) - 1);
+    sum0 = _mm512_fmadd_ps(
+        _mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i),
+        sum0);
+  }
+  alignas(64) float lanes[kLanes];
+  _mm512_store_ps(lanes, _mm512_add_ps(sum0, sum1));
+  float total = 0;
+  for (float lane : lanes) {
+    total += lane;
+  }
+  return total;
+}
+
+#endif
+
+using Kernel = float (*)(const float*, const float*, size_t);
+
+struct Kernels {
+  const char* name;
+  Kernel dot_product;
+};
+
+Kernels
+SelectKernels() {
+#if KATANA_SIMILARITY_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return Kernels{"avx512", &Avx512DotProduct};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return Kernels{"avx2", &Avx2DotProduct};
+  }
+#endif
+  return Kernels{"scalar", &ScalarDotProduct};
+}
+
+const Kernels&
+GetKernels() {
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+}  // namespace
+
+float
+katana::analytics::DotProduct(const float* a, const float* b, size_t n) {
+  return GetKernels().dot_product(a, b, n);
+}
+
+float
+katana::analytics::CosineSimilarity(const float* a, const float* b, size_t n) {
+  Kernel dot_product = GetKernels().dot_product;
+  float norms = dot_product(a, a, n) * dot_product(b, b, n);
+  if (norms == 0) {
+    return 0;
+  }
+  return dot_product(a, b, n) / std::sqrt(norms);
+}
+
+const char*
+katana::analytics::VectorSimilarityKernel() {
+  return GetKernels().name;
+}
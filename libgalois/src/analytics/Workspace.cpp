@@ -0,0 +1,220 @@
+#include "katana/analytics/Workspace.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/MemoryBudget.h"
+
+namespace {
+
+template <typename T>
+void
+FillTyped(void* data, uint64_t num_values, const std::string& fill) {
+  T value;
+  std::memcpy(&value, fill.data(), sizeof(T));
+  auto* values = static_cast<T*>(data);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_values),
+      [&](uint64_t i) { values[i] = value; }, katana::no_stats(),
+      katana::loopname("WorkspaceFill"));
+}
+
+template <typename T>
+void
+ResetTyped(
+    void* data, const katana::InsertBag<uint32_t>& touched,
+    const std::string& fill) {
+  T value;
+  std::memcpy(&value, fill.data(), sizeof(T));
+  auto* values = static_cast<T*>(data);
+  katana::do_all(
+      katana::iterate(touched), [&](uint32_t n) { values[n] = value; },
+      katana::no_stats(), katana::loopname("WorkspaceSparseReset"));
+}
+
+/// Set num_values values of fill.size() bytes at data to fill
+katana::Result<void>
+Fill(void* data, uint64_t num_values, const std::string& fill) {
+  switch (fill.size()) {
+  case 1:
+    FillTyped<uint8_t>(data, num_values, fill);
+    break;
+  case 2:
+    FillTyped<uint16_t>(data, num_values, fill);
+    break;
+  case 4:
+    FillTyped<uint32_t>(data, num_values, fill);
+    break;
+  case 8:
+    FillTyped<uint64_t>(data, num_values, fill);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported value size {}",
+        fill.size());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Set the values of the nodes in touched to fill
+void
+Reset(
+    void* data, const katana::InsertBag<uint32_t>& touched,
+    const std::string& fill) {
+  switch (fill.size()) {
+  case 1:
+    ResetTyped<uint8_t>(data, touched, fill);
+    break;
+  case 2:
+    ResetTyped<uint16_t>(data, touched, fill);
+    break;
+  case 4:
+    ResetTyped<uint32_t>(data, touched, fill);
+    break;
+  case 8:
+    ResetTyped<uint64_t>(data, touched, fill);
+    break;
+  default:
+    KATANA_LOG_FATAL("unsupported value size {}", fill.size());
+  }
+}
+
+}  // namespace
+
+katana::analytics::AnalyticsWorkspace::AnalyticsWorkspace(PropertyGraph* pg)
+    : pg_(pg) {
+  reclaimer_id_ = katana::AddMemoryReclaimer([this](uint64_t bytes) {
+    std::unique_lock<std::mutex> lock(released_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return;
+    }
+    uint64_t freed = 0;
+    while (freed < bytes && !released_.empty()) {
+      freed += released_.back().values->size();
+      released_.pop_back();
+    }
+  });
+}
+
+katana::analytics::AnalyticsWorkspace::~AnalyticsWorkspace() {
+  katana::RemoveMemoryReclaimer(reclaimer_id_);
+}
+
+katana::Result<void>
+katana::analytics::AnalyticsWorkspace::AddNodeProperty(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type,
+    const std::string& fill) {
+  if (in_use_.count(name)) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "workspace property {} is in use", name);
+  }
+  const uint64_t num_nodes = pg_->num_nodes();
+
+  Column column;
+  {
+    std::lock_guard<std::mutex> lock(released_mutex_);
+    auto it =
+        std::find_if(released_.begin(), released_.end(), [&](const Column& c) {
+          return c.type->Equals(*type) &&
+                 c.values->size() ==
+                     static_cast<int64_t>(num_nodes * fill.size());
+        });
+    if (it != released_.end()) {
+      column = std::move(*it);
+      released_.erase(it);
+    }
+  }
+  if (column.values) {
+    if (column.sparse && column.fill == fill) {
+      Reset(column.values->mutable_data(), *column.touched, fill);
+    } else if (auto r = Fill(column.values->mutable_data(), num_nodes, fill);
+               !r) {
+      return r.error();
+    }
+    column.touched->clear();
+  } else {
+    auto res = arrow::AllocateBuffer(
+        num_nodes * fill.size(), katana::BudgetedMemoryPool());
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "allocating {}: {}", name, res.status());
+    }
+    column.type = type;
+    column.values = std::move(res.ValueOrDie());
+    column.touched = std::make_unique<katana::InsertBag<uint32_t>>();
+    if (auto r = Fill(column.values->mutable_data(), num_nodes, fill); !r) {
+      return r.error();
+    }
+  }
+  column.fill = fill;
+  column.sparse = false;
+
+  auto array = arrow::MakeArray(
+      arrow::ArrayData::Make(type, num_nodes, {nullptr, column.values}));
+  auto table =
+      arrow::Table::Make(arrow::schema({arrow::field(name, type)}), {array});
+  if (auto r = pg_->AddNodeProperties(table); !r) {
+    return r.error();
+  }
+  in_use_.emplace(name, std::move(column));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::AnalyticsWorkspace::ReleaseNodeProperty(
+    const std::string& name) {
+  auto it = in_use_.find(name);
+  if (it == in_use_.end()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "{} was not added by the workspace", name);
+  }
+  Column column = std::move(it->second);
+  in_use_.erase(it);
+  if (auto r = pg_->RemoveNodeProperty(name); !r) {
+    return r.error();
+  }
+  // Only the workspace may refer to a column it overwrites
+  if (column.values.use_count() == 1) {
+    std::lock_guard<std::mutex> lock(released_mutex_);
+    released_.emplace_back(std::move(column));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::InsertBag<uint32_t>*
+katana::analytics::AnalyticsWorkspace::TouchedNodes(const std::string& name) {
+  auto it = in_use_.find(name);
+  if (it == in_use_.end()) {
+    return nullptr;
+  }
+  it->second.sparse = true;
+  return it->second.touched.get();
+}
+
+katana::Result<const katana::GraphTopology*>
+katana::analytics::AnalyticsWorkspace::Transpose() {
+  auto current = pg_->topology().out_dests;
+  if (!transpose_ || transpose_of_.lock() != current) {
+    transpose_.reset();
+    auto res = katana::CreateTransposeGraph(pg_);
+    if (!res) {
+      return res.error();
+    }
+    transpose_ = std::move(res.value());
+    transpose_of_ = current;
+  }
+  return &transpose_->topology();
+}
+
+uint64_t
+katana::analytics::AnalyticsWorkspace::released_bytes() const {
+  std::lock_guard<std::mutex> lock(released_mutex_);
+  uint64_t bytes = 0;
+  for (const auto& column : released_) {
+    bytes += column.values->size();
+  }
+  return bytes;
+}
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/TriangleSampling.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+using NodeDataApproximate = std::tuple<NodeBC>;
+using EdgeDataApproximate = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeDataApproximate, EdgeDataApproximate>
+    ApproximateGraph;
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// The fewest samples drawn in a round; later rounds draw an eighth of the
+/// samples drawn so far, so the stopping condition is checked O(log n)
+/// times
+constexpr uint64_t kMinRoundSamples = 1024;
+
+/// Draws a uniformly random shortest path between two nodes with a balanced
+/// bidirectional BFS; side 0 searches forward from the source and side 1
+/// backward from the target. State is reset after each sample by visiting
+/// only the nodes it touched.
+class PathSampler {
+  const katana::GraphTopology& out_;
+  const katana::GraphTopology& in_;
+  std::vector<uint32_t> dist_[2];
+  std::vector<double> sigma_[2];
+  std::vector<Node> frontier_[2];
+  std::vector<Node> next_;
+  std::vector<Node> touched_;
+  std::vector<Node> meeting_;
+
+  const katana::GraphTopology& adjacency(int side) const {
+    return side == 0 ? out_ : in_;
+  }
+
+  void Visit(int side, Node node, uint32_t dist, double sigma) {
+    if (dist_[0][node] == kUnvisited && dist_[1][node] == kUnvisited) {
+      touched_.emplace_back(node);
+    }
+    dist_[side][node] = dist;
+    sigma_[side][node] = sigma;
+  }
+
+  /// Return the sum of the degrees of the frontier of side
+  uint64_t FrontierEdges(int side) const {
+    uint64_t edges = 0;
+    for (Node n : frontier_[side]) {
+      auto [begin, end] = adjacency(side).edge_range(n);
+      edges += end - begin;
+    }
+    return edges;
+  }
+
+  /// Expand the frontier of side by one level; return true if it met the
+  /// other side
+  bool Expand(int side, uint32_t depth) {
+    const katana::GraphTopology& topology = adjacency(side);
+    int other = 1 - side;
+    next_.clear();
+    meeting_.clear();
+    for (Node n : frontier_[side]) {
+      for (auto e : topology.edges(n)) {
+        Node dest = topology.edge_dest(e);
+        if (dist_[side][dest] == kUnvisited) {
+          Visit(side, dest, depth + 1, sigma_[side][n]);
+          next_.emplace_back(dest);
+          if (dist_[other][dest] != kUnvisited) {
+            meeting_.emplace_back(dest);
+          }
+        } else if (dist_[side][dest] == depth + 1) {
+          sigma_[side][dest] += sigma_[side][n];
+        }
+      }
+    }
+    frontier_[side].swap(next_);
+    return !meeting_.empty();
+  }
+
+  /// Walk from node back to the origin of side, choosing each step with
+  /// probability proportional to its number of shortest paths, and append
+  /// the nodes between node and the origin to path
+  template <typename Gen>
+  void Walk(int side, Node node, Gen* gen, std::vector<Node>* path) const {
+    // Predecessors of side 0 are in-neighbors and those of side 1 are
+    // out-neighbors
+    const katana::GraphTopology& topology = adjacency(1 - side);
+    const std::vector<uint32_t>& dist = dist_[side];
+    const std::vector<double>& sigma = sigma_[side];
+    while (dist[node] > 1) {
+      double r = std::uniform_real_distribution<double>(0, sigma[node])(*gen);
+      Node chosen = node;
+      for (auto e : topology.edges(node)) {
+        Node pred = topology.edge_dest(e);
+        if (dist[pred] != dist[node] - 1) {
+          continue;
+        }
+        chosen = pred;
+        r -= sigma[pred];
+        if (r < 0) {
+          break;
+        }
+      }
+      node = chosen;
+      path->emplace_back(node);
+    }
+  }
+
+public:
+  PathSampler(
+      const katana::GraphTopology& out, const katana::GraphTopology& in)
+      : out_(out), in_(in) {}
+
+  /// Set path to the inner nodes of a uniformly random shortest path from
+  /// source to target, or to nothing if target is not reachable
+  template <typename Gen>
+  void Sample(Node source, Node target, Gen* gen, std::vector<Node>* path) {
+    path->clear();
+    // Allocated on first use, since storage is made for every thread that
+    // could run
+    if (dist_[0].empty()) {
+      for (int side : {0, 1}) {
+        dist_[side].assign(out_.num_nodes(), kUnvisited);
+        sigma_[side].resize(out_.num_nodes());
+      }
+    }
+    Visit(0, source, 0, 1);
+    Visit(1, target, 0, 1);
+    frontier_[0].assign(1, source);
+    frontier_[1].assign(1, target);
+    uint32_t depth[2] = {0, 0};
+
+    bool met = false;
+    while (!met && !frontier_[0].empty() && !frontier_[1].empty()) {
+      int side = FrontierEdges(0) <= FrontierEdges(1) ? 0 : 1;
+      met = Expand(side, depth[side]);
+      ++depth[side];
+    }
+
+    if (met) {
+      // Every shortest path passes through exactly one meeting node, which
+      // is chosen in proportion to the paths through it
+      double total = 0;
+      for (Node n : meeting_) {
+        total += sigma_[0][n] * sigma_[1][n];
+      }
+      double r = std::uniform_real_distribution<double>(0, total)(*gen);
+      Node middle = meeting_.back();
+      for (Node n : meeting_) {
+        r -= sigma_[0][n] * sigma_[1][n];
+        if (r < 0) {
+          middle = n;
+          break;
+        }
+      }
+      if (middle != source && middle != target) {
+        path->emplace_back(middle);
+      }
+      Walk(0, middle, gen, path);
+      Walk(1, middle, gen, path);
+    }
+
+    for (Node n : touched_) {
+      dist_[0][n] = kUnvisited;
+      dist_[1][n] = kUnvisited;
+    }
+    touched_.clear();
+  }
+};
+
+/// The adaptive error bounds of KADABRA: after num_samples of at most omega
+/// samples, the normalized centrality of a node whose estimate is estimate
+/// is at least estimate - LowerError with probability 1 - delta_l, and at
+/// most estimate + UpperError with probability 1 - delta_u.
+double
+LowerError(double estimate, double delta_l, double omega, double num_samples) {
+  double log_delta = std::log(1 / delta_l);
+  double a = omega / num_samples - 1.0 / 3;
+  double error = log_delta / num_samples *
+                 (-a + std::sqrt(a * a + 2 * estimate * omega / log_delta));
+  return std::min(error, estimate);
+}
+
+double
+UpperError(double estimate, double delta_u, double omega, double num_samples) {
+  double log_delta = std::log(1 / delta_u);
+  double a = omega / num_samples + 1.0 / 3;
+  double error = log_delta / num_samples *
+                 (a + std::sqrt(a * a + 2 * estimate * omega / log_delta));
+  return std::min(error, 1 - estimate);
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan) {
+  double epsilon = plan.epsilon();
+  double delta = plan.delta();
+  if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon and delta must be in (0, 1), got {} and {}", epsilon, delta);
+  }
+  if (!std::holds_alternative<uint32_t>(sources) ||
+      std::get<uint32_t>(sources) < pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "approximate betweenness centrality samples all nodes as sources");
+  }
+
+  if (auto result = ConstructNodeProperties<NodeDataApproximate>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  auto pg_result = ApproximateGraph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  ApproximateGraph graph = pg_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { graph.GetData<NodeBC>(n) = 0; }, katana::no_stats(),
+      katana::loopname("InitializeGraph"));
+
+  uint64_t num_nodes = pg->num_nodes();
+  if (num_nodes < 2) {
+    return katana::ResultSuccess();
+  }
+
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  std::unique_ptr<katana::PropertyGraph> transpose =
+      std::move(transpose_result.value());
+
+  katana::StatTimer exec_time("Approximate", "BetweennessCentrality");
+  exec_time.start();
+
+  // Half of delta bounds the number of samples that suffices for any graph,
+  // which depends on the vertex diameter, here bounded by num_nodes. The
+  // other half is split evenly among the lower and upper bounds of the
+  // nodes.
+  double omega =
+      0.5 / (epsilon * epsilon) *
+      (std::floor(std::log2(std::max<double>(num_nodes - 2, 1))) + 1 +
+       std::log(4 / delta));
+  double node_delta = delta / (4 * num_nodes);
+  auto max_samples = static_cast<uint64_t>(std::ceil(omega));
+
+  std::vector<std::atomic<uint64_t>> counts(num_nodes);
+  katana::PerThreadStorage<PathSampler> samplers(
+      pg->topology(), transpose->topology());
+  katana::PerThreadStorage<std::vector<Node>> paths;
+
+  uint64_t num_samples = 0;
+  while (num_samples < max_samples) {
+    uint64_t round = std::min(
+        max_samples - num_samples,
+        std::max(kMinRoundSamples, num_samples / 8));
+    katana::do_all(
+        katana::iterate(num_samples, num_samples + round),
+        [&](uint64_t i) {
+          std::mt19937_64 gen(SampleSeed(plan.seed(), i));
+          std::uniform_int_distribution<uint64_t> node_dist(0, num_nodes - 1);
+          Node source = node_dist(gen);
+          Node target = node_dist(gen);
+          while (target == source) {
+            target = node_dist(gen);
+          }
+          std::vector<Node>& path = *paths.getLocal();
+          samplers.getLocal()->Sample(source, target, &gen, &path);
+          for (Node n : path) {
+            counts[n].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::loopname("ApproximateBCSample"));
+    num_samples += round;
+
+    katana::GReduceLogicalOr unbounded;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          double estimate =
+              static_cast<double>(counts[n].load(std::memory_order_relaxed)) /
+              num_samples;
+          if (LowerError(estimate, node_delta, omega, num_samples) > epsilon ||
+              UpperError(estimate, node_delta, omega, num_samples) > epsilon) {
+            unbounded.update(true);
+          }
+        },
+        katana::no_stats(), katana::loopname("ApproximateBCStop"));
+    if (!unbounded.reduce()) {
+      break;
+    }
+  }
+
+  double scale = static_cast<double>(num_nodes) * (num_nodes - 1);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        graph.GetData<NodeBC>(n) =
+            static_cast<double>(counts[n].load(std::memory_order_relaxed)) /
+            num_samples * scale;
+      },
+      katana::no_stats(), katana::loopname("ApproximateBCScale"));
+
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "ApproximateSamples", num_samples);
+
+  return katana::ResultSuccess();
+}
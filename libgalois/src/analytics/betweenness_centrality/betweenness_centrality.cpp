@@ -41,6 +41,15 @@ katana::analytics::BetweennessCentrality(
     return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kMultiSource:
+    return BetweennessCentralityMultiSource(
+        pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kApproximate:
+    return BetweennessCentralityApproximate(
+        pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kWeighted:
+    return BetweennessCentralityWeighted(
+        pg, sources, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
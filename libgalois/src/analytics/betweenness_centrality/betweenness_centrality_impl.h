@@ -16,4 +16,22 @@ katana::Result<void> BetweennessCentralityLevel(
     const std::string& output_property_name,
     katana::analytics::BetweennessCentralityPlan plan);
 
+katana::Result<void> BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
+katana::Result<void> BetweennessCentralityWeighted(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
+katana::Result<void> BetweennessCentralityMultiSource(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
 #endif
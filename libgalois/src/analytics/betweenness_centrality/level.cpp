@@ -1,5 +1,6 @@
 #include "betweenness_centrality_impl.h"
 #include "katana/AtomicHelpers.h"
+#include "katana/Frontier.h"
 #include "katana/Properties.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -85,59 +86,74 @@ LevelInitializeIteration(LevelGraph* graph, LevelGNode src_node) {
 /**
  * Forward phase: SSSP to determine DAG and get shortest path counts.
  *
- * Worklist-based push. Save worklists on a stack for reuse in backward
- * Brandes dependency propagation.
+ * Frontier-based: sparse levels push path counts along out-edges, dense
+ * levels have each unvisited node pull them from its parents in the
+ * frontier along in-edges, which are the out-edges of transpose. Returns the
+ * nodes of each level for reuse in backward Brandes dependency propagation.
  */
 katana::gstl::Vector<LevelWorklistType>
-LevelSSSP(LevelGraph* graph, LevelGNode src_node) {
-  katana::gstl::Vector<LevelWorklistType> vector_of_worklists;
-  uint32_t current_level = 0;
-
-  // construct first level worklist which consists only of source
-  vector_of_worklists.emplace_back();
-  vector_of_worklists[0].emplace(src_node);
-
-  // loop as long as current level's worklist is non-empty
-  while (!vector_of_worklists[current_level].empty()) {
-    // create worklist for next level
-    vector_of_worklists.emplace_back();
-    uint32_t next_level = current_level + 1;
-
-    katana::do_all(
-        katana::iterate(vector_of_worklists[current_level]),
-        [&](LevelGNode n) {
-          KATANA_LOG_ASSERT(
-              graph->GetData<NodeCurrentDist>(n) == current_level);
-
-          for (auto e : graph->edges(n)) {
-            auto dest = graph->GetEdgeDest(e);
-
-            if (graph->GetData<NodeCurrentDist>(dest) == kInfinity) {
-              auto expected = kInfinity;
-              bool performed_set =
-                  graph->GetData<NodeCurrentDist>(dest).compare_exchange_strong(
-                      expected, next_level);
-              // only 1 thread should add to worklist
-              if (performed_set) {
-                vector_of_worklists[next_level].emplace(*dest);
-              }
+LevelSSSP(
+    LevelGraph* graph, const katana::GraphTopology& transpose,
+    LevelGNode src_node) {
+  katana::Frontier frontier(graph->num_nodes());
+  frontier.Push(src_node);
+
+  uint64_t num_levels = katana::SynchronousPushPullFrontierLoop(
+      *graph, &frontier,
+      [&](LevelGNode n, LevelGraph::Edge e, katana::Frontier* next) {
+        auto dest = *graph->GetEdgeDest(e);
+        auto& dest_dist = graph->GetData<NodeCurrentDist>(dest);
+        uint32_t next_level = graph->GetData<NodeCurrentDist>(n) + 1;
+
+        if (dest_dist == kInfinity) {
+          auto expected = kInfinity;
+          // only 1 thread should add to frontier
+          if (dest_dist.compare_exchange_strong(expected, next_level)) {
+            next->Push(dest);
+          }
+        }
+        if (dest_dist == next_level) {
+          katana::atomicAdd(
+              graph->GetData<NodeNumShortestPaths>(dest),
+              graph->GetData<NodeNumShortestPaths>(n).load());
+        }
+      },
+      [&](LevelGNode n, const katana::Frontier& curr,
+          katana::Frontier* next) {
+        auto& dist = graph->GetData<NodeCurrentDist>(n);
+        if (dist != kInfinity) {
+          return;
+        }
 
-              katana::atomicAdd(
-                  graph->GetData<NodeNumShortestPaths>(dest),
-                  graph->GetData<NodeNumShortestPaths>(n).load());
-            } else if (graph->GetData<NodeCurrentDist>(dest) == next_level) {
-              katana::atomicAdd(
-                  graph->GetData<NodeNumShortestPaths>(dest),
-                  graph->GetData<NodeNumShortestPaths>(n).load());
-            }
+        uint32_t level = kInfinity;
+        LevelShortPathType num_paths = 0;
+        for (auto e : transpose.edges(n)) {
+          auto parent = transpose.edge_dest(e);
+          if (curr.Contains(parent)) {
+            level = graph->GetData<NodeCurrentDist>(parent) + 1;
+            num_paths += graph->GetData<NodeNumShortestPaths>(parent).load();
           }
-        },
-        katana::steal(), katana::chunk_size<kLevelChunkSize>(),
-        katana::no_stats(), katana::loopname("LevelSSSP"));
+        }
+        if (level != kInfinity) {
+          dist = level;
+          graph->GetData<NodeNumShortestPaths>(n) = num_paths;
+          next->Push(n);
+        }
+      },
+      katana::kDefaultFrontierEdgeTileSize, "LevelSSSP");
 
-    // move on to next level
-    current_level++;
-  }
+  // bucket the reached nodes by level; a cancelled loop may have set the
+  // distance of nodes past the last level it finished
+  katana::gstl::Vector<LevelWorklistType> vector_of_worklists(num_levels);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](LevelGNode n) {
+        uint32_t dist = graph->GetData<NodeCurrentDist>(n);
+        if (dist < num_levels) {
+          vector_of_worklists[dist].emplace(n);
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("LevelBuckets"));
   return vector_of_worklists;
 }
 
@@ -151,10 +167,10 @@ void
 LevelBackwardBrandes(
     LevelGraph* graph,
     katana::gstl::Vector<LevelWorklistType>* vector_of_worklists) {
-  // minus 3 because last one is empty, one after is leaf nodes, and one
-  // to correct indexing to 0 index
-  if (vector_of_worklists->size() >= 3) {
-    uint32_t current_level = vector_of_worklists->size() - 3;
+  // minus 2 because last one is leaf nodes, which have no successors, and
+  // one to correct indexing to 0 index
+  if (vector_of_worklists->size() >= 2) {
+    uint32_t current_level = vector_of_worklists->size() - 2;
 
     // last level is ignored since it's just the source
     while (current_level > 0) {
@@ -234,6 +250,14 @@ BetweennessCentralityLevel(
   }
   LevelGraph graph = pg_result.value();
 
+  // in-edges for the pull levels of the forward phase
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  std::unique_ptr<katana::PropertyGraph> transpose =
+      std::move(transpose_result.value());
+
   graph_construct_timer.stop();
 
   // preallocate pages in memory so allocation doesn't occur during compute
@@ -283,9 +307,9 @@ BetweennessCentralityLevel(
     // here begins main computation
     exec_time.start();
     LevelInitializeIteration(&graph, src_node);
-    // worklist; last one will be empty
+    // nodes of each level, source first
     katana::gstl::Vector<LevelWorklistType> worklists =
-        LevelSSSP(&graph, src_node);
+        LevelSSSP(&graph, transpose->topology(), src_node);
     LevelBackwardBrandes(&graph, &worklists);
     exec_time.stop();
   }
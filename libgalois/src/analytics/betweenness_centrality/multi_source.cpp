@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <numeric>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/MultiSourceBfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+using NodeDataMultiSource = std::tuple<NodeBC>;
+using EdgeDataMultiSource = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeDataMultiSource, EdgeDataMultiSource>
+    MultiSourceGraph;
+
+using Lanes = MultiSourceBfsBatch::Lanes;
+using Visit = MultiSourceBfsBatch::Visit;
+
+constexpr static const unsigned kMultiSourceChunkSize = 256u;
+
+/// Call fn with the index of each set bit of lanes
+template <typename Fn>
+void
+ForEachLane(Lanes lanes, const Fn& fn) {
+  while (lanes != 0) {
+    fn(static_cast<size_t>(__builtin_ctzll(lanes)));
+    lanes &= lanes - 1;
+  }
+}
+
+/**
+ * Brandes' algorithm for a batch of sources that share the traversals of one
+ * multi-source BFS. The number of shortest paths and the dependency of each
+ * (node, source) pair are stored in arrays with one row per node and one
+ * column per lane.
+ */
+class BCMultiSource {
+  MultiSourceGraph* graph_;
+  const katana::GraphTopology& topology_;
+  MultiSourceBfsBatch bfs_;
+  size_t width_;
+  katana::LargeArray<std::atomic<double>> sigma_;
+  katana::LargeArray<float> delta_;
+
+  size_t Index(uint32_t node, size_t lane) const {
+    return node * width_ + lane;
+  }
+
+  /// Count the shortest paths from each source to each node level by level
+  void Forward() {
+    katana::do_all(
+        katana::iterate(bfs_.level(0)),
+        [&](const Visit& visit) {
+          ForEachLane(visit.lanes, [&](size_t s) {
+            sigma_[Index(visit.node, s)] = 1;
+          });
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBCInitialize"));
+
+    for (size_t d = 0; d + 1 < bfs_.num_levels(); ++d) {
+      katana::do_all(
+          katana::iterate(bfs_.level(d + 1)),
+          [&](const Visit& visit) {
+            ForEachLane(visit.lanes, [&](size_t s) {
+              sigma_[Index(visit.node, s)] = 0;
+            });
+          },
+          katana::no_stats(), katana::loopname("MultiSourceBCReset"));
+      bfs_.MarkLevel(d + 1);
+
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& visit) {
+            for (auto e : topology_.edges(visit.node)) {
+              auto dest = topology_.edge_dest(e);
+              ForEachLane(visit.lanes & bfs_.marked(dest), [&](size_t s) {
+                katana::atomicAdd(
+                    sigma_[Index(dest, s)],
+                    sigma_[Index(visit.node, s)].load());
+              });
+            }
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceBCForward"));
+    }
+  }
+
+  /// Accumulate dependencies from the deepest level back to the sources
+  void Backward() {
+    for (size_t d = bfs_.num_levels() - 1; d > 0; --d) {
+      bfs_.MarkLevel(d + 1);
+
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& visit) {
+            uint32_t n = visit.node;
+            ForEachLane(
+                visit.lanes, [&](size_t s) { delta_[Index(n, s)] = 0; });
+
+            for (auto e : topology_.edges(n)) {
+              auto dest = topology_.edge_dest(e);
+              ForEachLane(visit.lanes & bfs_.marked(dest), [&](size_t s) {
+                delta_[Index(n, s)] += ((float)1 + delta_[Index(dest, s)]) /
+                                       sigma_[Index(dest, s)];
+              });
+            }
+
+            float bc = 0;
+            ForEachLane(visit.lanes, [&](size_t s) {
+              delta_[Index(n, s)] *= sigma_[Index(n, s)];
+              bc += delta_[Index(n, s)];
+            });
+            graph_->GetData<NodeBC>(n) += bc;
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceBCBackward"));
+    }
+  }
+
+public:
+  BCMultiSource(MultiSourceGraph* graph, size_t width)
+      : graph_(graph),
+        topology_(graph->GetPropertyGraph().topology()),
+        bfs_(&topology_),
+        width_(width) {
+    sigma_.allocateBlocked(graph_->num_nodes() * width_);
+    delta_.allocateBlocked(graph_->num_nodes() * width_);
+  }
+
+  /// Add the dependencies of sources[0], ..., sources[num_sources - 1] to
+  /// the centrality of each node
+  void Run(const uint32_t* sources, size_t num_sources) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= width_);
+    bfs_.Run(sources, num_sources);
+    if (bfs_.num_levels() == 0) {
+      return;
+    }
+    Forward();
+    Backward();
+  }
+};
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityMultiSource(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan [[maybe_unused]]) {
+  if (auto result = ConstructNodeProperties<NodeDataMultiSource>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = MultiSourceGraph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  MultiSourceGraph graph = pg_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { graph.GetData<NodeBC>(n) = 0; }, katana::no_stats(),
+      katana::loopname("InitializeGraph"));
+
+  std::vector<uint32_t> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else {
+    uint64_t num_sources = pg->num_nodes();
+    if (sources != kBetweennessCentralityAllNodes) {
+      num_sources =
+          std::min<uint64_t>(num_sources, std::get<uint32_t>(sources));
+    }
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+  for (uint32_t src : source_vector) {
+    if (src >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node", src);
+    }
+  }
+  if (source_vector.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  katana::StatTimer exec_time("MultiSource", "BetweennessCentrality");
+  exec_time.start();
+
+  BCMultiSource bc(
+      &graph,
+      std::min(source_vector.size(), MultiSourceBfsBatch::kMaxSources));
+  for (size_t i = 0; i < source_vector.size();
+       i += MultiSourceBfsBatch::kMaxSources) {
+    bc.Run(
+        &source_vector[i],
+        std::min(
+            source_vector.size() - i, MultiSourceBfsBatch::kMaxSources));
+  }
+
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <type_traits>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/BfsSsspImplementationBase.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+template <typename Weight>
+using WeightedEdgeWeight = katana::PODProperty<Weight>;
+
+/// Brandes' algorithm on positive edge weights. The distances from each
+/// source come from a delta-stepping SSSP. Every shortest path edge (u, v)
+/// has dist(v) - dist(u) >= min_weight, so once the reached nodes are sorted
+/// by distance and cut into buckets narrower than min_weight, no shortest
+/// path edge joins two nodes of the same bucket: the path counts can be
+/// pushed out of a whole bucket in parallel, and the dependencies pulled
+/// into a whole bucket in parallel, visiting the buckets in order and in
+/// reverse order respectively.
+template <typename Weight>
+class BCWeighted {
+public:
+  using Dist =
+      std::conditional_t<std::is_floating_point_v<Weight>, double, uint64_t>;
+  using EdgeWeight = WeightedEdgeWeight<Weight>;
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeWeight>>;
+  using GNode = typename Graph::Node;
+
+  using Base = katana::analytics::BfsSsspImplementationBase<Graph, Dist, true>;
+  using UpdateRequest = typename Base::UpdateRequest;
+  using UpdateRequestIndexer = typename Base::UpdateRequestIndexer;
+  using OBIM = katana::OrderedByIntegerMetric<
+      UpdateRequestIndexer, katana::PerSocketChunkFIFO<64>>;
+
+  static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
+
+  BCWeighted(const Graph& graph, Dist bucket_width, unsigned step_shift)
+      : graph_(graph), bucket_width_(bucket_width), step_shift_(step_shift) {
+    size_t num_nodes = graph_.num_nodes();
+    distance_.allocateInterleaved(num_nodes);
+    sigma_.allocateInterleaved(num_nodes);
+    delta_.allocateInterleaved(num_nodes);
+    bc_.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          distance_.constructAt(n, kDistanceInfinity);
+          sigma_.constructAt(n, 0.0);
+          delta_.constructAt(n, 0.0);
+          bc_.constructAt(n, 0.0f);
+        },
+        katana::no_stats(), katana::loopname("WeightedInitializeGraph"));
+  }
+
+  /// Add the dependencies of all nodes on source to their centralities
+  void ComputeBC(GNode source) {
+    SSSP(source);
+
+    katana::ParallelSTL::sort(
+        reached_.begin(), reached_.end(), [&](GNode a, GNode b) {
+          Dist da = distance_[a].load(std::memory_order_relaxed);
+          Dist db = distance_[b].load(std::memory_order_relaxed);
+          return da == db ? a < b : da < db;
+        });
+
+    // bucket i is reached_[bucket_begins_[i], bucket_begins_[i + 1])
+    bucket_begins_.clear();
+    Dist bucket_start = 0;
+    for (size_t i = 0; i < reached_.size(); ++i) {
+      Dist d = distance_[reached_[i]].load(std::memory_order_relaxed);
+      if (i == 0 || d - bucket_start >= bucket_width_) {
+        bucket_begins_.emplace_back(i);
+        bucket_start = d;
+      }
+    }
+    bucket_begins_.emplace_back(reached_.size());
+    size_t num_buckets = bucket_begins_.size() - 1;
+
+    sigma_[source] = 1;
+    for (size_t i = 0; i < num_buckets; ++i) {
+      PushPathCounts(bucket_begins_[i], bucket_begins_[i + 1]);
+    }
+    for (size_t i = num_buckets; i > 0; --i) {
+      PullDependencies(source, bucket_begins_[i - 1], bucket_begins_[i]);
+    }
+
+    // only the reached nodes were touched
+    katana::do_all(
+        katana::iterate(reached_),
+        [&](GNode n) {
+          distance_[n].store(kDistanceInfinity, std::memory_order_relaxed);
+          sigma_[n].store(0, std::memory_order_relaxed);
+          delta_[n] = 0;
+        },
+        katana::no_stats(), katana::loopname("WeightedResetIteration"));
+  }
+
+  katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues() {
+    arrow::FloatBuilder builder;
+    if (auto r = builder.AppendValues(bc_.begin(), bc_.end()); !r.ok()) {
+      return katana::ErrorCode::ArrowError;
+    }
+    std::shared_ptr<arrow::FloatArray> ret;
+    if (auto r = builder.Finish(&ret); !r.ok()) {
+      return katana::ErrorCode::ArrowError;
+    }
+    return ret;
+  }
+
+private:
+  bool IsShortestPathEdge(GNode src, typename Graph::edge_iterator e) const {
+    Dist src_dist = distance_[src].load(std::memory_order_relaxed);
+    Dist dest_dist =
+        distance_[*graph_.GetEdgeDest(e)].load(std::memory_order_relaxed);
+    return src_dist + static_cast<Dist>(
+                          graph_.template GetEdgeData<EdgeWeight>(e)) ==
+           dest_dist;
+  }
+
+  /// Delta-stepping as in SsspPlan::DeltaStep, which also collects the
+  /// reached nodes in reached_
+  void SSSP(GNode source) {
+    katana::InsertBag<GNode> reached;
+    katana::InsertBag<UpdateRequest> init_bag;
+    distance_[source] = 0;
+    reached.push(source);
+    init_bag.push(UpdateRequest(source, 0));
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const UpdateRequest& item, auto& ctx) {
+          Dist sdist = distance_[item.src].load(std::memory_order_relaxed);
+          if (sdist < item.dist) {
+            return;
+          }
+          for (auto e : graph_.edges(item.src)) {
+            GNode dest = *graph_.GetEdgeDest(e);
+            const Dist new_dist =
+                sdist +
+                static_cast<Dist>(graph_.template GetEdgeData<EdgeWeight>(e));
+            Dist old_dist = katana::atomicMin(distance_[dest], new_dist);
+            if (new_dist < old_dist) {
+              if (old_dist == kDistanceInfinity) {
+                reached.push(dest);
+              }
+              ctx.push(UpdateRequest(dest, new_dist));
+            }
+          }
+        },
+        katana::wl<OBIM>(UpdateRequestIndexer{step_shift_}),
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::loopname("WeightedSSSP"));
+
+    reached_.assign(reached.begin(), reached.end());
+  }
+
+  void PushPathCounts(size_t begin, size_t end) {
+    katana::do_all(
+        katana::iterate(reached_.begin() + begin, reached_.begin() + end),
+        [&](GNode n) {
+          double n_sigma = sigma_[n].load(std::memory_order_relaxed);
+          for (auto e : graph_.edges(n)) {
+            if (IsShortestPathEdge(n, e)) {
+              katana::atomicAdd(sigma_[*graph_.GetEdgeDest(e)], n_sigma);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("WeightedPushPathCounts"));
+  }
+
+  void PullDependencies(GNode source, size_t begin, size_t end) {
+    katana::do_all(
+        katana::iterate(reached_.begin() + begin, reached_.begin() + end),
+        [&](GNode n) {
+          double n_sigma = sigma_[n].load(std::memory_order_relaxed);
+          double n_delta = 0;
+          for (auto e : graph_.edges(n)) {
+            if (IsShortestPathEdge(n, e)) {
+              GNode dest = *graph_.GetEdgeDest(e);
+              n_delta += n_sigma /
+                         sigma_[dest].load(std::memory_order_relaxed) *
+                         (1 + delta_[dest]);
+            }
+          }
+          delta_[n] = n_delta;
+          if (n != source) {
+            bc_[n] += n_delta;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("WeightedPullDependencies"));
+  }
+
+  const Graph& graph_;
+  Dist bucket_width_;
+  unsigned step_shift_;
+
+  katana::LargeArray<std::atomic<Dist>> distance_;
+  katana::LargeArray<std::atomic<double>> sigma_;
+  katana::LargeArray<double> delta_;
+  katana::LargeArray<float> bc_;
+
+  std::vector<GNode> reached_;
+  std::vector<size_t> bucket_begins_;
+};
+
+template <typename Weight>
+katana::Result<void>
+BetweennessCentralityWeightedImpl(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& source_vector,
+    uint64_t loop_end, const std::string& output_property_name,
+    const BetweennessCentralityPlan& plan) {
+  using Impl = BCWeighted<Weight>;
+  using Dist = typename Impl::Dist;
+
+  auto pg_result =
+      Impl::Graph::Make(pg, {}, {plan.edge_weight_property_name()});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  typename Impl::Graph graph = pg_result.value();
+
+  katana::GReduceMin<Weight> min_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t i) {
+        min_weight.update(
+            graph.template GetEdgeData<typename Impl::EdgeWeight>(
+                katana::GraphTopology::edge_iterator(i)));
+      },
+      katana::no_stats(), katana::loopname("WeightedMinWeight"));
+  Weight smallest = min_weight.reduce();
+  if (pg->num_edges() > 0 && !(smallest > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "weighted betweenness centrality needs positive edge weights, but "
+        "{} has {}",
+        plan.edge_weight_property_name(), smallest);
+  }
+
+  // floating point distances may round an edge to just under its weight
+  Dist bucket_width = std::is_floating_point_v<Weight>
+                          ? static_cast<Dist>(smallest) / 2
+                          : static_cast<Dist>(smallest);
+  Impl bc_weighted(graph, bucket_width, plan.step_shift());
+
+  katana::StatTimer exec_time("Weighted", "BetweennessCentrality");
+  exec_time.start();
+  for (uint64_t i = 0; i < loop_end; i++) {
+    uint32_t src_node = source_vector.empty() ? i : source_vector[i];
+    if (src_node >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          src_node);
+    }
+    bc_weighted.ComputeBC(src_node);
+  }
+  exec_time.stop();
+
+  auto data_result = bc_weighted.ExtractBCValues();
+  if (!data_result) {
+    return data_result.error();
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+      {data_result.value()});
+  if (auto r = pg->AddNodeProperties(table); !r) {
+    return r.error();
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityWeighted(
+    katana::PropertyGraph* pg, BetweennessCentralitySources sources,
+    const std::string& output_property_name, BetweennessCentralityPlan plan) {
+  std::vector<uint32_t> source_vector;
+  uint64_t loop_end;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+    loop_end = source_vector.size();
+  } else if (sources == kBetweennessCentralityAllNodes) {
+    loop_end = pg->num_nodes();
+  } else {
+    loop_end = std::min<uint64_t>(std::get<uint32_t>(sources), pg->num_nodes());
+  }
+
+  auto weights = pg->GetEdgeProperty(plan.edge_weight_property_name());
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no edge property {}",
+        plan.edge_weight_property_name());
+  }
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return BetweennessCentralityWeightedImpl<uint32_t>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return BetweennessCentralityWeightedImpl<int32_t>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return BetweennessCentralityWeightedImpl<uint64_t>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return BetweennessCentralityWeightedImpl<int64_t>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return BetweennessCentralityWeightedImpl<float>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return BetweennessCentralityWeightedImpl<double>(
+        pg, source_vector, loop_end, output_property_name, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type: {}",
+        weights->type()->ToString());
+  }
+}
@@ -19,11 +19,16 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
 #include <deque>
 #include <type_traits>
 
+#include "katana/DynamicBitset.h"
+#include "katana/Frontier.h"
+#include "katana/ParaMeter.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/MultiSourceBfs.h"
 
 using namespace katana::analytics;
 
@@ -62,13 +67,6 @@ struct EdgeTile {
   Graph::edge_iterator end;
 };
 
-struct EdgeTileMaker {
-  EdgeTile operator()(
-      const Graph::edge_iterator& beg, const Graph::edge_iterator& end) const {
-    return EdgeTile{beg, end};
-  }
-};
-
 struct NodePushWrap {
   template <typename C>
   void operator()(
@@ -82,22 +80,6 @@ struct NodePushWrap {
   }
 };
 
-struct EdgeTilePushWrap {
-  Graph* graph;
-  BfsImplementation& impl;
-
-  template <typename C>
-  void operator()(
-      C& cont, const Graph::Node& n, const char* const /*tag*/) const {
-    impl.PushEdgeTilesParallel(cont, graph, n, EdgeTileMaker{});
-  }
-
-  template <typename C>
-  void operator()(C& cont, const Graph::Node& n) const {
-    impl.PushEdgeTiles(cont, graph, n, EdgeTileMaker{});
-  }
-};
-
 struct OneTilePushWrap {
   Graph* graph;
 
@@ -223,7 +205,7 @@ SynchronousAlgo(
 
   KATANA_LOG_DEBUG_ASSERT(!next->empty());
 
-  while (!next->empty()) {
+  while (!next->empty() && !katana::CancelRequested()) {
     std::swap(curr, next);
     next->clear();
     ++next_level;
@@ -246,37 +228,188 @@ SynchronousAlgo(
   }
 }
 
-template <bool CONCURRENT>
+/// Level synchronous BFS over a katana::Frontier, which splits the edges of
+/// high degree nodes into tiles of edge_tile_size edges
 void
-RunAlgo(BfsPlan algo, Graph* graph, const Graph::Node& source) {
+SynchronousTileAlgo(
+    Graph* graph, Graph::Node source, ptrdiff_t edge_tile_size) {
+  graph->GetData<BfsNodeDistance>(source) = 0U;
+  katana::Frontier frontier(graph->num_nodes());
+  frontier.Push(source);
+
+  katana::SynchronousFrontierLoop(
+      *graph, &frontier,
+      [&](Graph::Node src, Graph::Edge e, katana::Frontier* next) {
+        auto dest = *graph->GetEdgeDest(e);
+        auto& dest_data = graph->GetData<BfsNodeDistance>(dest);
+        if (dest_data == BfsImplementation::kDistanceInfinity &&
+            __sync_bool_compare_and_swap(
+                &dest_data, BfsImplementation::kDistanceInfinity,
+                graph->GetData<BfsNodeDistance>(src) + 1)) {
+          next->Push(dest);
+        }
+      },
+      edge_tile_size, "SynchronousTile");
+}
+
+/// Direction-optimizing BFS. Push levels expand the frontier along out-edges
+/// as in SynchronousAlgo. Once the frontier is large, pull levels instead scan
+/// every unvisited node and look for a parent in the frontier among its
+/// in-edges, which are the out-edges of transpose.
+void
+SynchronousDirectOptAlgo(
+    Graph* graph, const katana::GraphTopology& transpose, Graph::Node source,
+    uint32_t alpha, uint32_t beta) {
+  auto curr = std::make_unique<katana::InsertBag<Graph::Node>>();
+  auto next = std::make_unique<katana::InsertBag<Graph::Node>>();
+
+  katana::DynamicBitset front_bitset;
+  katana::DynamicBitset next_bitset;
+  front_bitset.resize(graph->num_nodes());
+  next_bitset.resize(graph->num_nodes());
+
+  Dist next_level = 0U;
+  graph->GetData<BfsNodeDistance>(source) = 0U;
+  next->push(source);
+
+  int64_t edges_to_check = graph->num_edges();
+  int64_t scout_count = graph->edge_end(source) - graph->edge_begin(source);
+  const uint64_t num_nodes = graph->num_nodes();
+
+  while (!next->empty() && !katana::CancelRequested()) {
+    std::swap(curr, next);
+    next->clear();
+
+    if (scout_count > edges_to_check / alpha) {
+      katana::GAccumulator<uint64_t> awake;
+      katana::do_all(
+          katana::iterate(*curr),
+          [&](const Graph::Node& n) {
+            front_bitset.set(n);
+            awake += 1;
+          },
+          katana::no_stats());
+
+      uint64_t awake_count = awake.reduce();
+      uint64_t old_awake_count = 0;
+      do {
+        ++next_level;
+        old_awake_count = awake_count;
+        awake.reset();
+
+        katana::do_all(
+            katana::iterate(graph->begin(), graph->end()),
+            [&](const Graph::Node& dest) {
+              auto& dest_data = graph->GetData<BfsNodeDistance>(dest);
+              if (dest_data != BfsImplementation::kDistanceInfinity) {
+                return;
+              }
+              for (auto e : transpose.edges(dest)) {
+                if (front_bitset.test(transpose.edge_dest(e))) {
+                  dest_data = next_level;
+                  next_bitset.set(dest);
+                  awake += 1;
+                  break;
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<kChunkSize>(),
+            katana::loopname("SynchronousDirectOpt-pull"));
+
+        std::swap(front_bitset, next_bitset);
+        next_bitset.reset();
+        awake_count = awake.reduce();
+      } while ((awake_count >= old_awake_count ||
+                awake_count > num_nodes / beta) &&
+               !katana::CancelRequested());
+
+      katana::do_all(
+          katana::iterate(graph->begin(), graph->end()),
+          [&](const Graph::Node& n) {
+            if (front_bitset.test(n)) {
+              next->push(n);
+            }
+          },
+          katana::steal(), katana::no_stats());
+      front_bitset.reset();
+      scout_count = 1;
+    } else {
+      ++next_level;
+      edges_to_check -= scout_count;
+
+      katana::GAccumulator<int64_t> scout;
+      katana::do_all(
+          katana::iterate(*curr),
+          [&](const Graph::Node& src) {
+            for (auto e : graph->edges(src)) {
+              auto dest = *graph->GetEdgeDest(e);
+              auto& dest_data = graph->GetData<BfsNodeDistance>(dest);
+              if (dest_data == BfsImplementation::kDistanceInfinity &&
+                  __sync_bool_compare_and_swap(
+                      &dest_data, BfsImplementation::kDistanceInfinity,
+                      next_level)) {
+                next->push(dest);
+                scout += graph->edge_end(dest) - graph->edge_begin(dest);
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("SynchronousDirectOpt-push"));
+      scout_count = scout.reduce();
+    }
+  }
+}
+
+/// Whether the kernel of algo pushes every node it writes, so that the nodes
+/// can be logged for a sparse reset
+bool
+PushesWrittenNodes(const BfsPlan& algo) {
+  switch (algo.algorithm()) {
+  case BfsPlan::kAsynchronousTile:
+  case BfsPlan::kAsynchronous:
+  case BfsPlan::kSynchronous:
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <bool CONCURRENT, typename Wrap>
+void
+RunAlgo(
+    BfsPlan algo, Graph* graph, const Graph::Node& source, const Wrap& wrap) {
   BfsImplementation impl{algo.edge_tile_size()};
   switch (algo.algorithm()) {
   case BfsPlan::kAsynchronousTile:
     AsynchronousAlgo<CONCURRENT, SrcEdgeTile>(
-        graph, source, SrcEdgeTilePushWrap{graph, impl}, TileRangeFn());
+        graph, source, wrap(SrcEdgeTilePushWrap{graph, impl}), TileRangeFn());
     break;
   case BfsPlan::kAsynchronous:
     AsynchronousAlgo<CONCURRENT, UpdateRequest>(
-        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
+        graph, source, wrap(ReqPushWrap()), OutEdgeRangeFn{graph});
     break;
   case BfsPlan::kSynchronousTile:
-    SynchronousAlgo<CONCURRENT, EdgeTile>(
-        graph, source, EdgeTilePushWrap{graph, impl}, TileRangeFn());
+    SynchronousTileAlgo(graph, source, algo.edge_tile_size());
     break;
   case BfsPlan::kSynchronous:
     SynchronousAlgo<CONCURRENT, Graph::Node>(
-        graph, source, NodePushWrap(), OutEdgeRangeFn{graph});
+        graph, source, wrap(NodePushWrap()), OutEdgeRangeFn{graph});
     break;
   default:
     std::cerr << "ERROR: unkown algo type\n";
   }
 }
 
+/// Compute levels from start_node into graph. If initialized, the levels
+/// are already kDistanceInfinity. If touched is not null, the nodes written
+/// are logged in it; algo must then push every node it writes (see
+/// PushesWrittenNodes).
 katana::Result<void>
 BfsImpl(
     katana::TypedPropertyGraph<std::tuple<BfsNodeDistance>, std::tuple<>>&
         graph,
-    size_t start_node, BfsPlan algo) {
+    size_t start_node, BfsPlan algo, const katana::GraphTopology* transpose,
+    bool initialized = false, katana::InsertBag<uint32_t>* touched = nullptr) {
   if (start_node >= graph.size()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -288,18 +421,32 @@ BfsImpl(
   size_t approxNodeData = 4 * (graph.num_nodes() + graph.num_edges());
   katana::Prealloc(8, approxNodeData);
 
-  katana::do_all(katana::iterate(graph.begin(), graph.end()), [&graph](auto n) {
-    graph.GetData<BfsNodeDistance>(n) = BfsImplementation::kDistanceInfinity;
-  });
+  if (!initialized) {
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.end()), [&graph](auto n) {
+          graph.GetData<BfsNodeDistance>(n) =
+              BfsImplementation::kDistanceInfinity;
+        });
+  }
 
   katana::StatTimer execTime("BFS");
   execTime.start();
 
-  RunAlgo<true>(algo, &graph, source);
+  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt) {
+    SynchronousDirectOptAlgo(
+        &graph, *transpose, source, algo.alpha(), algo.beta());
+  } else if (touched) {
+    RunAlgo<true>(algo, &graph, source, [touched](auto push) {
+      return BfsImplementation::TouchLoggingPushWrap<decltype(push)>{
+          push, touched};
+    });
+  } else {
+    RunAlgo<true>(algo, &graph, source, [](auto push) { return push; });
+  }
 
   execTime.stop();
 
-  return katana::ResultSuccess();
+  return CheckCancelled();
 }
 
 }  // namespace
@@ -308,6 +455,10 @@ katana::Result<void>
 katana::analytics::Bfs(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo) {
+  katana::parameter::ProfileScope profile(algo.profile_parallelism());
+  if (auto r = CheckArchitecture(algo); !r) {
+    return r.error();
+  }
   if (auto result = ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
           pg, {output_property_name});
       !result) {
@@ -319,7 +470,164 @@ katana::analytics::Bfs(
     return pg_result.error();
   }
 
-  return BfsImpl(pg_result.value(), start_node, algo);
+  std::unique_ptr<katana::PropertyGraph> transpose;
+  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt) {
+    if (algo.alpha() == 0 || algo.beta() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "alpha and beta must be nonzero");
+    }
+    auto transpose_result = katana::CreateTransposeGraph(pg);
+    if (!transpose_result) {
+      return transpose_result.error();
+    }
+    transpose = std::move(transpose_result.value());
+  }
+
+  return BfsImpl(
+      pg_result.value(), start_node, algo,
+      transpose ? &transpose->topology() : nullptr);
+}
+
+katana::Result<void>
+katana::analytics::Bfs(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::string& output_property_name, AnalyticsWorkspace* workspace,
+    BfsPlan algo) {
+  katana::parameter::ProfileScope profile(algo.profile_parallelism());
+  if (auto r = CheckArchitecture(algo); !r) {
+    return r.error();
+  }
+  if (workspace->graph() != pg) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the workspace belongs to another graph");
+  }
+  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt &&
+      (algo.alpha() == 0 || algo.beta() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha and beta must be nonzero");
+  }
+  if (auto r = workspace->AddNodeProperty<uint32_t>(
+          output_property_name, BfsImplementation::kDistanceInfinity);
+      !r) {
+    return r.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  const katana::GraphTopology* transpose = nullptr;
+  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt) {
+    auto transpose_result = workspace->Transpose();
+    if (!transpose_result) {
+      return transpose_result.error();
+    }
+    transpose = transpose_result.value();
+  }
+
+  katana::InsertBag<uint32_t>* touched = nullptr;
+  if (PushesWrittenNodes(algo)) {
+    touched = workspace->TouchedNodes(output_property_name);
+  }
+  return BfsImpl(pg_result.value(), start_node, algo, transpose, true, touched);
+}
+
+katana::Result<katana::analytics::BfsPlan>
+katana::analytics::TuneBfsPlan(
+    const PropertyGraph& pg, const TunerOptions& opts) {
+  std::vector<PlanCandidate<BfsPlan>> candidates{
+      {"SynchronousDirectOpt", BfsPlan::SynchronousDirectOpt()},
+      {"Synchronous", BfsPlan::Synchronous()},
+      {"Asynchronous", BfsPlan::Asynchronous()},
+  };
+  for (ptrdiff_t tile_size : {64, 256, 1024}) {
+    candidates.push_back(
+        {fmt::format("SynchronousTile/{}", tile_size),
+         BfsPlan::SynchronousTile(tile_size)});
+    candidates.push_back(
+        {fmt::format("AsynchronousTile/{}", tile_size),
+         BfsPlan::AsynchronousTile(tile_size)});
+  }
+
+  return TunePlan(
+      "Bfs", pg, candidates,
+      [](PropertyGraph* sample, const BfsPlan& plan) {
+        TemporaryPropertyGuard output(sample);
+        return Bfs(sample, 0, output.name(), plan);
+      },
+      {}, opts);
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  for (uint32_t src : sources) {
+    if (src >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node", src);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  std::vector<uint32_t*> distances;
+  for (const auto& name : output_property_names) {
+    auto res = arrow::AllocateBuffer(pg->num_nodes() * sizeof(uint32_t));
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "allocating {}: {}", name,
+          res.status());
+    }
+    std::shared_ptr<arrow::Buffer> buffer = std::move(res.ValueOrDie());
+    distances.emplace_back(reinterpret_cast<uint32_t*>(buffer->mutable_data()));
+    fields.emplace_back(arrow::field(name, arrow::uint32()));
+    columns.emplace_back(
+        std::make_shared<arrow::UInt32Array>(pg->num_nodes(), buffer));
+  }
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t n) {
+        for (uint32_t* d : distances) {
+          d[n] = BfsImplementation::kDistanceInfinity;
+        }
+      },
+      katana::no_stats(), katana::loopname("MultiSourceBfsInitialize"));
+
+  MultiSourceBfsBatch bfs(&pg->topology());
+  for (size_t i = 0; i < sources.size();
+       i += MultiSourceBfsBatch::kMaxSources) {
+    bfs.Run(
+        &sources[i],
+        std::min(sources.size() - i, MultiSourceBfsBatch::kMaxSources));
+    for (size_t level = 0; level < bfs.num_levels(); ++level) {
+      katana::do_all(
+          katana::iterate(bfs.level(level)),
+          [&](const MultiSourceBfsBatch::Visit& visit) {
+            for (auto lanes = visit.lanes; lanes != 0; lanes &= lanes - 1) {
+              distances[i + __builtin_ctzll(lanes)][visit.node] = level;
+            }
+          },
+          katana::no_stats(), katana::loopname("MultiSourceBfsDistances"));
+    }
+  }
+
+  exec_time.stop();
+
+  return pg->AddNodeProperties(
+      arrow::Table::Make(arrow::schema(fields), columns));
 }
 
 katana::Result<void>
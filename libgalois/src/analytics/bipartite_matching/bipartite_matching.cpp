@@ -0,0 +1,772 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+using MatchMask = katana::PODProperty<uint8_t>;
+using Graph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<MatchMask>>;
+
+template <typename Weight>
+using EdgeWeight = katana::PODProperty<Weight>;
+
+template <typename Weight>
+using WeightedGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeWeight<Weight>, MatchMask>>;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+constexpr Edge kNoEdge = std::numeric_limits<Edge>::max();
+//! Marks a left node that a Karp-Sipser step is trying to match
+constexpr Edge kBusy = kNoEdge - 1;
+
+/// Call fn with a value of the C type of the edge property named
+/// edge_weight_property_name, or fail if it is not a number.
+template <typename Fn>
+auto
+DispatchWeightType(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name, const Fn& fn)
+    -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type {}",
+        property->type()->ToString());
+  }
+}
+
+/// Fail unless every edge goes from a left node to a right node, i.e., no
+/// edge ends at a node with out-edges
+katana::Result<void>
+CheckBipartite(const katana::GraphTopology& topology) {
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        for (Edge e : topology.edges(src)) {
+          auto [first, last] = topology.edge_range(topology.edge_dest(e));
+          if (first != last) {
+            not_bipartite.update(true);
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph is not directed from left nodes to right nodes: some edge "
+        "ends at a node with out-edges");
+  }
+  return katana::ResultSuccess();
+}
+
+/**
+ * Parallel Pothen-Fan (PF+). The matched edge of each left node is in
+ * mate_edge_ and the matched left node of each right node in mate_node_.
+ *
+ * Every phase, each unmatched left node starts a depth-first search for an
+ * augmenting path, which alternates between unmatched edges and the
+ * matched edges back from right nodes. A search claims the right nodes it
+ * visits for the phase, so concurrent searches find vertex-disjoint paths
+ * and can flip them without locks. Each left node keeps a lookahead cursor
+ * to find an unmatched neighbor without searching; since matched nodes
+ * stay matched, every edge is looked ahead at most once overall.
+ */
+class PothenFan {
+  struct Frame {
+    Node left;
+    //! Edges of left not yet scanned are [next, end)
+    Edge next;
+    Edge end;
+    //! The edge taken to the frame above
+    Edge taken;
+  };
+
+public:
+  explicit PothenFan(const katana::GraphTopology& topology)
+      : topology_(topology) {
+    uint64_t num_nodes = topology.num_nodes();
+    mate_edge_.allocateBlocked(num_nodes);
+    mate_node_.allocateBlocked(num_nodes);
+    visited_.allocateBlocked(num_nodes);
+    lookahead_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          mate_edge_.constructAt(n, kNoEdge);
+          mate_node_.constructAt(n, kNoNode);
+          visited_.constructAt(n, 0);
+          lookahead_[n] = topology_.edge_range(n).first;
+        },
+        katana::no_stats());
+  }
+
+  /// Match greedily, taking first the left nodes that have exactly one
+  /// unmatched neighbor left, as matching them never costs a larger
+  /// matching. Left nodes whose degree drops to one are matched next.
+  void KarpSipser() {
+    uint64_t num_nodes = topology_.num_nodes();
+
+    // The left ends of the edges of each right node, to update degrees
+    katana::LargeArray<uint64_t> in_begin;
+    katana::LargeArray<std::atomic<uint64_t>> cursor;
+    katana::LargeArray<Node> in_src;
+    katana::LargeArray<std::atomic<uint32_t>> degree;
+    in_begin.allocateBlocked(num_nodes + 1);
+    cursor.allocateBlocked(num_nodes);
+    degree.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          auto [first, last] = topology_.edge_range(n);
+          cursor.constructAt(n, 0);
+          degree.constructAt(n, last - first);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            cursor[topology_.edge_dest(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    in_begin[0] = 0;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          in_begin[n + 1] = cursor[n].load(std::memory_order_relaxed);
+          cursor[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        in_begin.begin() + 1, in_begin.end(), in_begin.begin() + 1);
+    in_src.allocateBlocked(in_begin[num_nodes]);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            Node dest = topology_.edge_dest(e);
+            in_src[in_begin[dest] +
+                   cursor[dest].fetch_add(1, std::memory_order_relaxed)] =
+                src;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    auto match = [&](Node u, auto& ctx) {
+      Edge no_edge = kNoEdge;
+      if (!mate_edge_[u].compare_exchange_strong(
+              no_edge, kBusy, std::memory_order_relaxed)) {
+        return;
+      }
+      for (Edge e : topology_.edges(u)) {
+        Node v = topology_.edge_dest(e);
+        Node no_node = kNoNode;
+        if (mate_node_[v].load(std::memory_order_relaxed) != kNoNode ||
+            !mate_node_[v].compare_exchange_strong(
+                no_node, u, std::memory_order_relaxed)) {
+          continue;
+        }
+        mate_edge_[u].store(e, std::memory_order_relaxed);
+        for (uint64_t i = in_begin[v]; i != in_begin[v + 1]; ++i) {
+          Node w = in_src[i];
+          if (degree[w].fetch_sub(1, std::memory_order_relaxed) == 2 &&
+              mate_edge_[w].load(std::memory_order_relaxed) == kNoEdge) {
+            ctx.push(w);
+          }
+        }
+        return;
+      }
+      mate_edge_[u].store(kNoEdge, std::memory_order_relaxed);
+    };
+
+    katana::InsertBag<Node> degree_one;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          if (degree[n].load(std::memory_order_relaxed) == 1) {
+            degree_one.push(n);
+          }
+        },
+        katana::no_stats());
+    katana::for_each(
+        katana::iterate(degree_one), match,
+        katana::disable_conflict_detection(),
+        katana::loopname("BipartiteMatching KarpSipserDegreeOne"));
+
+    katana::for_each(
+        katana::iterate(topology_),
+        [&](Node n, auto& ctx) {
+          if (degree[n].load(std::memory_order_relaxed) > 0) {
+            match(n, ctx);
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::loopname("BipartiteMatching KarpSipser"));
+  }
+
+  /// Augment in phases until a phase finds no augmenting path
+  void Run() {
+    katana::InsertBag<Node> roots;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          auto [first, last] = topology_.edge_range(n);
+          if (first != last &&
+              mate_edge_[n].load(std::memory_order_relaxed) == kNoEdge) {
+            roots.push(n);
+          }
+        },
+        katana::no_stats());
+
+    katana::PerThreadStorage<std::vector<Frame>> stacks;
+    uint32_t phase = 0;
+    uint64_t total_augmented = 0;
+    while (!roots.empty() && !katana::CancelRequested()) {
+      ++phase;
+      // Fairness: scan edges in the opposite order in alternate phases
+      bool forward = phase % 2 == 1;
+      katana::GAccumulator<uint64_t> augmented;
+      katana::InsertBag<Node> next_roots;
+      katana::do_all(
+          katana::iterate(roots),
+          [&](Node root) {
+            if (mate_edge_[root].load(std::memory_order_relaxed) != kNoEdge) {
+              return;
+            }
+            if (Search(root, phase, forward, stacks.getLocal())) {
+              augmented += 1;
+            } else {
+              next_roots.push(root);
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatching Phase"));
+      uint64_t phase_augmented = augmented.reduce();
+      if (phase_augmented == 0) {
+        break;
+      }
+      total_augmented += phase_augmented;
+      roots.swap(next_roots);
+    }
+
+    katana::ReportStatSingle("BipartiteMatching", "Phases", phase);
+    katana::ReportStatSingle(
+        "BipartiteMatching", "Augmentations", total_augmented);
+  }
+
+  void WriteMatching(uint8_t* matched) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology_.num_edges()),
+        [&](Edge e) { matched[e] = 0; }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          Edge e = mate_edge_[n].load(std::memory_order_relaxed);
+          if (e != kNoEdge) {
+            matched[e] = 1;
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  /// Claim right node v for this phase
+  bool Visit(Node v, uint32_t phase) {
+    return visited_[v].load(std::memory_order_relaxed) != phase &&
+           visited_[v].exchange(phase, std::memory_order_relaxed) != phase;
+  }
+
+  /// The next edge of u to an unmatched right node, claimed for this phase
+  Edge LookAhead(Node u, uint32_t phase) {
+    Edge last = topology_.edge_range(u).second;
+    for (Edge& e = lookahead_[u]; e != last;) {
+      Edge candidate = e++;
+      Node v = topology_.edge_dest(candidate);
+      if (mate_node_[v].load(std::memory_order_relaxed) == kNoNode &&
+          Visit(v, phase)) {
+        return candidate;
+      }
+    }
+    return kNoEdge;
+  }
+
+  /// Search for an augmenting path from root and flip it if there is one.
+  /// Every left node on the path is the root or the mate of a right node
+  /// claimed by this search, so no other search touches it this phase.
+  bool Search(
+      Node root, uint32_t phase, bool forward, std::vector<Frame>* stack) {
+    stack->clear();
+    auto push_frame = [&](Node left) {
+      auto [first, last] = topology_.edge_range(left);
+      stack->emplace_back(Frame{left, first, last, kNoEdge});
+    };
+    push_frame(root);
+
+    while (!stack->empty()) {
+      Node u = stack->back().left;
+      if (Edge e = LookAhead(u, phase); e != kNoEdge) {
+        Augment(*stack, e);
+        return true;
+      }
+
+      Node next = kNoNode;
+      Frame& frame = stack->back();
+      while (frame.next != frame.end) {
+        Edge e = forward ? frame.next++ : --frame.end;
+        Node v = topology_.edge_dest(e);
+        if (!Visit(v, phase)) {
+          continue;
+        }
+        Node mate = mate_node_[v].load(std::memory_order_relaxed);
+        if (mate == kNoNode) {
+          Augment(*stack, e);
+          return true;
+        }
+        frame.taken = e;
+        next = mate;
+        break;
+      }
+      if (next == kNoNode) {
+        stack->pop_back();
+      } else {
+        push_frame(next);
+      }
+    }
+    return false;
+  }
+
+  /// Flip the path of stack, which ends with edge last to an unmatched
+  /// right node
+  void Augment(const std::vector<Frame>& stack, Edge last) {
+    Edge e = last;
+    for (size_t i = stack.size(); i-- > 0;) {
+      Node u = stack[i].left;
+      mate_node_[topology_.edge_dest(e)].store(u, std::memory_order_relaxed);
+      mate_edge_[u].store(e, std::memory_order_relaxed);
+      if (i > 0) {
+        e = stack[i - 1].taken;
+      }
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  katana::LargeArray<std::atomic<Edge>> mate_edge_;
+  katana::LargeArray<std::atomic<Node>> mate_node_;
+  //! The last phase that visited each right node
+  katana::LargeArray<std::atomic<uint32_t>> visited_;
+  katana::LargeArray<Edge> lookahead_;
+};
+
+/**
+ * Suitor matching with proposals from left nodes only. Each right node
+ * keeps the heaviest edge proposed to it so far; a left node proposes along
+ * its heaviest edge that beats the current suitor edge of its right end,
+ * and a left node that is displaced proposes again. Ties in weight go to
+ * the smaller edge id, so edges are totally ordered.
+ */
+template <typename Weight>
+class Suitor {
+public:
+  Suitor(const katana::GraphTopology& topology, const Weight* weight)
+      : topology_(topology), weight_(weight) {
+    uint64_t num_nodes = topology.num_nodes();
+    suitor_edge_.allocateBlocked(num_nodes);
+    suitor_node_.allocateBlocked(num_nodes);
+    locks_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          suitor_edge_.constructAt(n, kNoEdge);
+          suitor_node_[n] = kNoNode;
+          locks_.constructAt(n);
+        },
+        katana::no_stats());
+  }
+
+  void Run() {
+    katana::do_all(
+        katana::iterate(topology_), [&](Node n) { Propose(n); },
+        katana::steal(), katana::loopname("BipartiteMatching Suitor"));
+  }
+
+  void WriteMatching(uint8_t* matched) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology_.num_edges()),
+        [&](Edge e) { matched[e] = 0; }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          Edge e = suitor_edge_[n].load(std::memory_order_relaxed);
+          if (e != kNoEdge) {
+            matched[e] = 1;
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  /// True if edge a is heavier than edge b, which may be kNoEdge
+  bool Heavier(Edge a, Edge b) const {
+    if (b == kNoEdge) {
+      return true;
+    }
+    return weight_[a] > weight_[b] || (weight_[a] == weight_[b] && a < b);
+  }
+
+  bool BeatsSuitor(Edge e) const {
+    Node v = topology_.edge_dest(e);
+    return Heavier(e, suitor_edge_[v].load(std::memory_order_relaxed));
+  }
+
+  void Propose(Node u) {
+    Node current = u;
+    while (current != kNoNode) {
+      Edge best = kNoEdge;
+      for (Edge e : topology_.edges(current)) {
+        if (weight_[e] > Weight{0} && Heavier(e, best) && BeatsSuitor(e)) {
+          best = e;
+        }
+      }
+      if (best == kNoEdge) {
+        return;
+      }
+
+      Node v = topology_.edge_dest(best);
+      locks_[v].lock();
+      if (BeatsSuitor(best)) {
+        Node displaced = suitor_node_[v];
+        suitor_edge_[v].store(best, std::memory_order_relaxed);
+        suitor_node_[v] = current;
+        current = displaced;
+      }
+      // Otherwise a heavier proposal got there first; current tries again
+      locks_[v].unlock();
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const Weight* weight_;
+  katana::LargeArray<std::atomic<Edge>> suitor_edge_;
+  //! The left end of suitor_edge_, only accessed under locks_
+  katana::LargeArray<Node> suitor_node_;
+  katana::LargeArray<katana::SimpleLock> locks_;
+};
+
+/// The matched edge at each node, or fail if some node has two
+katana::Result<std::vector<Edge>>
+MatchedEdges(
+    const katana::GraphTopology& topology, const uint8_t* matched) {
+  std::vector<Edge> matched_edge(topology.num_nodes(), kNoEdge);
+  for (Node src = 0; src < topology.num_nodes(); ++src) {
+    for (Edge e : topology.edges(src)) {
+      if (!matched[e]) {
+        continue;
+      }
+      for (Node n : {src, topology.edge_dest(e)}) {
+        if (matched_edge[n] != kNoEdge) {
+          return KATANA_ERROR(
+              katana::ErrorCode::AssertionFailed,
+              "node {} has matched edges {} and {}", n, matched_edge[n], e);
+        }
+        matched_edge[n] = e;
+      }
+    }
+  }
+  return matched_edge;
+}
+
+template <typename Weight>
+katana::Result<void>
+WeightedBipartiteMatchingImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  if (auto r = ConstructEdgeProperties<std::tuple<MatchMask>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = WeightedGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Weight* weight =
+      graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data();
+  uint8_t* matched = graph.template GetEdgePropertyView<MatchMask>().data();
+
+  katana::StatTimer exec_time("WeightedBipartiteMatching");
+  exec_time.start();
+  Suitor<Weight> algo(pg->topology(), weight);
+  algo.Run();
+  algo.WriteMatching(matched);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+WeightedBipartiteMatchingAssertValidImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto pg_result = WeightedGraph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Weight* weight =
+      graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data();
+  const uint8_t* matched =
+      graph.template GetEdgePropertyView<MatchMask>().data();
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto matched_edge_result = MatchedEdges(topology, matched);
+  if (!matched_edge_result) {
+    return matched_edge_result.error();
+  }
+  const std::vector<Edge>& matched_edge = matched_edge_result.value();
+
+  auto dominated_at = [&](Node n, Edge e) {
+    return matched_edge[n] != kNoEdge && weight[matched_edge[n]] >= weight[e];
+  };
+  for (Node src = 0; src < topology.num_nodes(); ++src) {
+    for (Edge e : topology.edges(src)) {
+      if (!(weight[e] > Weight{0})) {
+        continue;
+      }
+      if (!dominated_at(src, e) && !dominated_at(topology.edge_dest(e), e)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "edge {} of weight {} has no matched edge at least as heavy next "
+            "to it",
+            e, weight[e]);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    PropertyGraph* pg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() != BipartiteMatchingPlan::kPothenFan) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "plan does not compute a maximum cardinality matching; use "
+        "WeightedBipartiteMatching");
+  }
+  if (auto r = CheckBipartite(pg->topology()); !r) {
+    return r.error();
+  }
+
+  if (auto r = ConstructEdgeProperties<std::tuple<MatchMask>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  uint8_t* matched = graph.GetEdgePropertyView<MatchMask>().data();
+
+  katana::StatTimer exec_time("BipartiteMatching");
+  exec_time.start();
+  PothenFan algo(pg->topology());
+  if (plan.karp_sipser_initialization()) {
+    algo.KarpSipser();
+  }
+  algo.Run();
+  algo.WriteMatching(matched);
+  exec_time.stop();
+
+  return CheckCancelled();
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  if (auto r = CheckBipartite(pg->topology()); !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const uint8_t* matched = graph.GetEdgePropertyView<MatchMask>().data();
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto matched_edge_result = MatchedEdges(topology, matched);
+  if (!matched_edge_result) {
+    return matched_edge_result.error();
+  }
+  const std::vector<Edge>& matched_edge = matched_edge_result.value();
+
+  // Search alternating paths from every unmatched left node at once; any
+  // that reaches an unmatched right node is augmenting
+  std::vector<bool> reached(topology.num_nodes());
+  std::deque<Node> queue;
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    auto [first, last] = topology.edge_range(n);
+    if (first != last && matched_edge[n] == kNoEdge) {
+      reached[n] = true;
+      queue.push_back(n);
+    }
+  }
+  std::vector<Node> matched_src(topology.num_nodes(), kNoNode);
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    if (matched_edge[n] != kNoEdge &&
+        topology.edge_dest(matched_edge[n]) != n) {
+      matched_src[topology.edge_dest(matched_edge[n])] = n;
+    }
+  }
+  while (!queue.empty()) {
+    Node u = queue.front();
+    queue.pop_front();
+    for (Edge e : topology.edges(u)) {
+      Node v = topology.edge_dest(e);
+      if (e == matched_edge[u] || reached[v]) {
+        continue;
+      }
+      reached[v] = true;
+      Node mate = matched_src[v];
+      if (mate == kNoNode) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "the matching is not maximum: there is an augmenting path to "
+            "node {}",
+            v);
+      }
+      if (!reached[mate]) {
+        reached[mate] = true;
+        queue.push_back(mate);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::WeightedBipartiteMatching(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, BipartiteMatchingPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() != BipartiteMatchingPlan::kSuitor) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "plan does not compute a weighted matching; use BipartiteMatching");
+  }
+  if (auto r = CheckBipartite(pg->topology()); !r) {
+    return r.error();
+  }
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<void> {
+        return WeightedBipartiteMatchingImpl<decltype(zero)>(
+            pg, edge_weight_property_name, output_property_name);
+      });
+}
+
+katana::Result<void>
+katana::analytics::WeightedBipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  if (auto r = CheckBipartite(pg->topology()); !r) {
+    return r.error();
+  }
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<void> {
+        return WeightedBipartiteMatchingAssertValidImpl<decltype(zero)>(
+            pg, edge_weight_property_name, property_name);
+      });
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const uint8_t* matched = graph.GetEdgePropertyView<MatchMask>().data();
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::DynamicBitset right;
+  right.resize(topology.num_nodes());
+  katana::GAccumulator<uint64_t> matching_size;
+  katana::GAccumulator<uint64_t> left;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        auto [first, last] = topology.edge_range(src);
+        left += first != last;
+        for (Edge e = first; e != last; ++e) {
+          right.set(topology.edge_dest(e));
+          matching_size += matched[e] != 0;
+        }
+      },
+      katana::steal(), katana::loopname("BipartiteMatching Statistics"),
+      katana::no_stats());
+
+  return BipartiteMatchingStatistics{
+      matching_size.reduce(), left.reduce(), right.count()};
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Matching size = " << matching_size << std::endl;
+  os << "Number of left nodes = " << n_left_nodes << std::endl;
+  os << "Number of right nodes = " << n_right_nodes << std::endl;
+}
@@ -0,0 +1,244 @@
+#include "katana/analytics/closeness_centrality/closeness_centrality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "katana/LargeArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/MultiSourceBfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeCentrality : public katana::PODProperty<double> {};
+
+using NodeData = std::tuple<NodeCentrality>;
+using EdgeData = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+
+using Visit = MultiSourceBfsBatch::Visit;
+
+constexpr static const unsigned kChunkSize = 256u;
+
+enum class Measure { kCloseness, kHarmonic };
+
+/// The distances from a set of sources to each node, summed over the
+/// sources. A node appears at most once per level of a batch, so the levels
+/// can update the sums without atomics.
+class DistanceSums {
+  const katana::GraphTopology& topology_;
+  MultiSourceBfsBatch bfs_;
+
+public:
+  /// The number of sources that reach each node, excluding the node itself
+  katana::LargeArray<uint64_t> reached;
+  /// The sum of the distances from those sources
+  katana::LargeArray<uint64_t> distances;
+  /// The sum of the reciprocals of those distances
+  katana::LargeArray<double> reciprocals;
+
+  explicit DistanceSums(const katana::GraphTopology& topology)
+      : topology_(topology), bfs_(&topology) {
+    size_t num_nodes = topology_.num_nodes();
+    reached.allocateBlocked(num_nodes);
+    distances.allocateBlocked(num_nodes);
+    reciprocals.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          reached[n] = 0;
+          distances[n] = 0;
+          reciprocals[n] = 0;
+        },
+        katana::no_stats(), katana::loopname("ClosenessInitialize"));
+  }
+
+  /// Add the distances from sources[0], ..., sources[num_sources - 1]
+  void Run(const uint32_t* sources, size_t num_sources) {
+    bfs_.Run(sources, num_sources);
+    for (size_t d = 1; d < bfs_.num_levels(); ++d) {
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& visit) {
+            uint64_t count = __builtin_popcountll(visit.lanes);
+            reached[visit.node] += count;
+            distances[visit.node] += count * d;
+            reciprocals[visit.node] += static_cast<double>(count) / d;
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::no_stats(), katana::loopname("ClosenessLevel"));
+    }
+  }
+};
+
+/// Pick the sources of plan: every node, or ceil(ln(n) / epsilon^2) pivots
+/// with out-edges. Returns the factor that scales the sums of the pivots to
+/// estimates of the sums over every node.
+katana::Result<double>
+PickSources(
+    katana::PropertyGraph* pg, const ClosenessCentralityPlan& plan,
+    std::vector<uint32_t>* sources) {
+  uint64_t num_nodes = pg->num_nodes();
+  if (plan.algorithm() == ClosenessCentralityPlan::kExact) {
+    sources->resize(num_nodes);
+    std::iota(sources->begin(), sources->end(), 0);
+    return 1.0;
+  }
+
+  if (!(plan.epsilon() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "epsilon must be positive: {}",
+        plan.epsilon());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::GAccumulator<uint64_t> accum_with_edges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint32_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        if (begin != end) {
+          accum_with_edges += 1;
+        }
+      },
+      katana::no_stats(), katana::loopname("ClosenessCountSources"));
+  uint64_t with_edges = accum_with_edges.reduce();
+  if (with_edges == 0) {
+    return 1.0;
+  }
+
+  double epsilon = plan.epsilon();
+  double log_n = std::log(std::max<double>(num_nodes, 2));
+  uint64_t num_pivots = std::min<uint64_t>(
+      std::ceil(log_n / (epsilon * epsilon)), with_edges);
+
+  SourcePicker picker(*pg);
+  sources->resize(num_pivots);
+  for (uint32_t& source : *sources) {
+    source = picker.PickNext();
+  }
+  return static_cast<double>(with_edges) / num_pivots;
+}
+
+katana::Result<void>
+Centrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const ClosenessCentralityPlan& plan, Measure measure) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() == ClosenessCentralityPlan::kSampled) {
+    if (auto r = CheckNotDeterministic(plan, "sampled closeness"); !r) {
+      return r.error();
+    }
+  }
+
+  std::vector<uint32_t> sources;
+  auto scale_res = PickSources(pg, plan, &sources);
+  if (!scale_res) {
+    return scale_res.error();
+  }
+  double scale = scale_res.value();
+
+  if (auto result =
+          ConstructNodeProperties<NodeData>(pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  katana::StatTimer exec_time(
+      measure == Measure::kCloseness ? "ClosenessCentrality"
+                                     : "HarmonicCentrality");
+  exec_time.start();
+
+  DistanceSums sums(pg->topology());
+  for (size_t i = 0; i < sources.size();
+       i += MultiSourceBfsBatch::kMaxSources) {
+    if (katana::CancelRequested()) {
+      break;
+    }
+    sums.Run(
+        &sources[i],
+        std::min(sources.size() - i, MultiSourceBfsBatch::kMaxSources));
+  }
+
+  double others = pg->num_nodes() > 1 ? pg->num_nodes() - 1 : 1;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        double& centrality = graph.GetData<NodeCentrality>(n);
+        if (measure == Measure::kHarmonic) {
+          centrality = sums.reciprocals[n] * scale;
+        } else if (sums.distances[n] == 0) {
+          centrality = 0;
+        } else {
+          double reached = sums.reached[n];
+          centrality = reached / sums.distances[n] *
+                       std::min(1.0, reached * scale / others);
+        }
+      },
+      katana::no_stats(), katana::loopname("ClosenessFinalize"));
+
+  exec_time.stop();
+
+  return CheckCancelled();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ClosenessCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  return Centrality(pg, output_property_name, plan, Measure::kCloseness);
+}
+
+katana::Result<void>
+katana::analytics::HarmonicCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  return Centrality(pg, output_property_name, plan, Measure::kHarmonic);
+}
+
+void
+ClosenessCentralityStatistics::Print(std::ostream& os) const {
+  os << "Maximum centrality = " << max_centrality << std::endl;
+  os << "Minimum centrality = " << min_centrality << std::endl;
+  os << "Average centrality = " << average_centrality << std::endl;
+}
+
+katana::Result<ClosenessCentralityStatistics>
+ClosenessCentralityStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto values_result = pg->GetNodePropertyTyped<double>(output_property_name);
+  if (!values_result) {
+    return values_result.error();
+  }
+  auto values = values_result.value();
+
+  katana::GReduceMax<double> accum_max;
+  katana::GReduceMin<double> accum_min;
+  katana::GAccumulator<double> accum_sum;
+
+  katana::do_all(
+      katana::iterate((uint64_t)0, pg->num_nodes()),
+      [&](uint32_t n) {
+        accum_max.update(values->Value(n));
+        accum_min.update(values->Value(n));
+        accum_sum += values->Value(n);
+      },
+      katana::no_stats(), katana::loopname("Closeness Centrality Statistics"));
+
+  return ClosenessCentralityStatistics{
+      accum_max.reduce(), accum_min.reduce(),
+      accum_sum.reduce() / pg->num_nodes()};
+}
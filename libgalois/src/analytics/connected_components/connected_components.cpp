@@ -20,6 +20,10 @@
 #include "katana/analytics/connected_components/connected_components.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/LargeArray.h"
+#include "katana/ParaMeter.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -137,7 +141,9 @@ struct ConnectedComponentsLabelPropAlgo {
 
               changed.update(true);
 
-              for (auto e : graph->edges(src)) {
+              for (auto e : katana::PrefetchEdges(
+                       graph->edges(src),
+                       katana::PrefetchDestinations<NodeComponent>(graph))) {
                 auto dest = graph->GetEdgeDest(e);
                 auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
                 ComponentType label_new = sdata_current_comp;
@@ -147,7 +153,7 @@ struct ConnectedComponentsLabelPropAlgo {
           },
           katana::disable_conflict_detection(), katana::steal(),
           katana::loopname("ConnectedComponentsLabelPropAlgo"));
-    } while (changed.reduce());
+    } while (changed.reduce() && !katana::CancelRequested());
   }
 };
 
@@ -212,7 +218,7 @@ struct ConnectedComponentsSynchronousAlgo {
       }
     });
 
-    while (!current_bag->empty()) {
+    while (!current_bag->empty() && !katana::CancelRequested()) {
       katana::do_all(
           katana::iterate(*current_bag),
           [&](const Edge& edge) {
@@ -610,98 +616,147 @@ struct ConnectedComponentsEdgeTiledAsynchronousAlgo {
   }
 };
 
-template <typename ComponentType, typename Graph, typename NodeIndex>
-ComponentType
-approxLargestComponent(Graph* graph, uint32_t component_sample_frequency) {
-  using map_type = std::unordered_map<
-      ComponentType, int, std::hash<ComponentType>,
-      std::equal_to<ComponentType>,
-      katana::gstl::Pow2Alloc<std::pair<const ComponentType, int>>>;
-  using pair_type = std::pair<ComponentType, int>;
+/// The component property of the Afforest algorithms
+struct AfforestParent : public katana::PODProperty<uint64_t> {};
 
-  map_type comp_freq(component_sample_frequency);
+/// Lock-free union-find over the component property itself, which holds the
+/// parent of every node. Trees are always hooked from the larger root to the
+/// smaller one, so once every node is compressed it holds the smallest node
+/// id of its component and the property is the final output.
+class ParentUnionFind {
+public:
+  static constexpr uint64_t kNoNode = std::numeric_limits<uint64_t>::max();
+
+  explicit ParentUnionFind(uint64_t* parent) : parent_(parent) {}
+
+  uint64_t parent(uint64_t node) const {
+    return __atomic_load_n(&parent_[node], __ATOMIC_RELAXED);
+  }
+
+  /// Join the trees of u and v
+  void Link(uint64_t u, uint64_t v) { Hook(u, v, kNoNode); }
+
+  /// Join the trees of u and v. If a root was hooked under giant, return
+  /// that root so that its edges can be revisited; otherwise return kNoNode.
+  uint64_t HookMin(uint64_t u, uint64_t v, uint64_t giant) {
+    return Hook(u, v, giant);
+  }
+
+  /// Point node directly at the root of its tree
+  void Compress(uint64_t node) {
+    uint64_t root = parent(node);
+    while (parent(root) != root) {
+      root = parent(root);
+    }
+    __atomic_store_n(&parent_[node], root, __ATOMIC_RELAXED);
+  }
+
+  /// \ref Compress as a task of katana::InterleaveTasks, which climbs one
+  /// level of the tree of node per step. Nodes that already point at their
+  /// root are not written, since for typical graphs that is most of them
+  /// after linking.
+  auto CompressTask(uint64_t node) {
+    katana::PrefetchRead(&parent_[node]);
+    return [this, node, root = node]() mutable {
+      uint64_t up = parent(root);
+      if (up != root) {
+        root = up;
+        katana::PrefetchRead(&parent_[root]);
+        return true;
+      }
+      if (parent(node) != root) {
+        __atomic_store_n(&parent_[node], root, __ATOMIC_RELAXED);
+      }
+      return false;
+    };
+  }
+
+private:
+  uint64_t Hook(uint64_t u, uint64_t v, uint64_t giant) {
+    uint64_t a = parent(u);
+    uint64_t b = parent(v);
+    while (a != b) {
+      if (a < b) {
+        std::swap(a, b);
+      }
+      // Now a > b
+      uint64_t ac = parent(a);
+      if (ac == a && __sync_bool_compare_and_swap(&parent_[a], a, b)) {
+        return b == giant ? a : kNoNode;
+      }
+      if (ac == b) {
+        return kNoNode;
+      }
+      a = parent(parent(a));
+      b = parent(b);
+    }
+    return kNoNode;
+  }
+
+  uint64_t* parent_;
+};
+
+/// Approximate the largest intermediate component by sampling the parents of
+/// random nodes. Returns kNoNode for empty graphs.
+uint64_t
+ApproxLargestComponent(
+    const ParentUnionFind& uf, uint64_t num_nodes,
+    uint32_t component_sample_frequency) {
+  if (num_nodes == 0) {
+    return ParentUnionFind::kNoNode;
+  }
+  std::unordered_map<uint64_t, uint32_t> comp_freq(component_sample_frequency);
   std::random_device rd;
   std::mt19937 rng(rd());
-  std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
+  std::uniform_int_distribution<uint64_t> dist(0, num_nodes - 1);
   for (uint32_t i = 0; i < component_sample_frequency; i++) {
-    ComponentType ndata = graph->template GetData<NodeIndex>(dist(rng));
-    comp_freq[ndata->component()]++;
+    comp_freq[uf.parent(dist(rng))]++;
   }
 
   KATANA_LOG_DEBUG_ASSERT(!comp_freq.empty());
   auto most_frequent = std::max_element(
       comp_freq.begin(), comp_freq.end(),
-      [](const pair_type& a, const pair_type& b) {
-        return a.second < b.second;
-      });
-
-  //katana::gDebug(
-  //    "Approximate largest intermediate component: ", most_frequent->first,
-  //    " (hit rate ",
-  //    100.0 * (most_frequent->second) / component_sample_frequency, "%)");
-
+      [](const auto& a, const auto& b) { return a.second < b.second; });
   return most_frequent->first;
 }
 
-struct ConnectedComponentsAfforestAlgo {
-  struct NodeAfforest : public katana::UnionFindNode<NodeAfforest> {
-    using ComponentType = NodeAfforest*;
-
-    NodeAfforest() : katana::UnionFindNode<NodeAfforest>(this) {}
-    NodeAfforest(const NodeAfforest& o)
-        : katana::UnionFindNode<NodeAfforest>(o.m_component) {}
-
-    ComponentType component() { return this->get(); }
-    bool isRepComp(unsigned int) { return false; }  // verify
-
-  public:
-    void link(NodeAfforest* b) {
-      NodeAfforest* a = m_component.load(std::memory_order_relaxed);
-      b = b->m_component.load(std::memory_order_relaxed);
-      while (a != b) {
-        if (a < b)
-          std::swap(a, b);
-        // Now a > b
-        NodeAfforest* ac = a->m_component.load(std::memory_order_relaxed);
-        if ((ac == a && a->m_component.compare_exchange_strong(a, b)) ||
-            (b == ac))
-          break;
-        a = (a->m_component.load(std::memory_order_relaxed))
-                ->m_component.load(std::memory_order_relaxed);
-        b = b->m_component.load(std::memory_order_relaxed);
-      }
-    }
-  };
+/// Start every node in its own tree
+template <typename Graph>
+void
+AfforestInitialize(Graph* graph, ParentUnionFind* uf) {
+  uint64_t* parent =
+      graph->template GetNodePropertyView<AfforestParent>().data();
+  *uf = ParentUnionFind(parent);
+  katana::do_all(
+      katana::iterate(*graph), [&](const auto& node) { parent[node] = node; });
+}
 
-  struct NodeComponent {
-    using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
-    using ViewType = katana::PODPropertyView<NodeAfforest::ComponentType>;
-  };
+/// Compress every node in parallel, interleaving the climbs of several
+/// nodes per thread so that their misses on parents overlap
+template <typename Graph>
+void
+AfforestFinalize(Graph* graph, ParentUnionFind* uf, const char* loopname) {
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const auto& src) { return uf->CompressTask(src); },
+      katana::interleave<>(), katana::steal(), katana::loopname(loopname));
+}
 
+struct ConnectedComponentsAfforestAlgo {
+  using NodeComponent = AfforestParent;
   using NodeData = std::tuple<NodeComponent>;
   using EdgeData = std::tuple<>;
   typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
 
   ConnectedComponentsPlan& plan_;
+  ParentUnionFind uf_{nullptr};
   ConnectedComponentsAfforestAlgo(ConnectedComponentsPlan& plan)
       : plan_(plan) {}
 
-  void Initialize(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      graph->GetData<NodeComponent>(node) = new NodeAfforest();
-    });
-  }
+  void Initialize(Graph* graph) { AfforestInitialize(graph, &uf_); }
 
-  void Deallocate(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& sdata = graph->GetData<NodeComponent>(node);
-      auto component_ptr = sdata->component();
-      delete sdata;
-      sdata = component_ptr;
-    });
-  }
-  using ComponentType = NodeAfforest::ComponentType;
+  void Deallocate(Graph*) {}
 
   void operator()(Graph* graph) {
     // (bozhi) should NOT go through single direction in sampling step: nodes
@@ -714,9 +769,7 @@ struct ConnectedComponentsAfforestAlgo {
             Graph::edge_iterator ei = graph->edge_end(src);
             for (std::advance(ii, r); ii < ei; ii++) {
               auto dest = graph->GetEdgeDest(ii);
-              auto& sdata = graph->GetData<NodeComponent>(src);
-              ComponentType ddata = graph->GetData<NodeComponent>(dest);
-              sdata->link(ddata);
+              uf_.Link(src, *dest);
               break;
             }
           },
@@ -724,90 +777,42 @@ struct ConnectedComponentsAfforestAlgo {
 
       katana::do_all(
           katana::iterate(*graph),
-          [&](const GNode& src) {
-            auto& sdata = graph->GetData<NodeComponent>(src);
-            sdata->compress();
-          },
-          katana::steal(), katana::loopname("Afforest-VNS-Compress"));
+          [&](const GNode& src) { return uf_.CompressTask(src); },
+          katana::interleave<>(), katana::steal(),
+          katana::loopname("Afforest-VNS-Compress"));
     }
 
     katana::StatTimer StatTimer_Sampling("Afforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, plan_.component_sample_frequency());
+    const uint64_t c = ApproxLargestComponent(
+        uf_, graph->num_nodes(), plan_.component_sample_frequency());
     StatTimer_Sampling.stop();
 
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          if (sdata->component() == c)
+          if (uf_.parent(src) == c)
             return;
-          Graph::edge_iterator ii = graph->edge_begin(src);
-          Graph::edge_iterator ei = graph->edge_end(src);
-          for (std::advance(ii, plan_.neighbor_sample_size()); ii < ei; ++ii) {
-            auto dest = graph->GetEdgeDest(ii);
-            auto& ddata = graph->GetData<NodeComponent>(dest);
-            sdata->link(ddata);
+          auto edges = graph->edges(src);
+          // The first edges were linked while sampling
+          Graph::edge_iterator ii =
+              edges.begin() +
+              std::min<uint64_t>(plan_.neighbor_sample_size(), edges.size());
+          for (auto e : katana::PrefetchEdges(
+                   katana::MakeStandardRange(ii, edges.end()),
+                   katana::PrefetchDestinations<NodeComponent>(graph))) {
+            auto dest = graph->GetEdgeDest(e);
+            uf_.Link(src, *dest);
           }
         },
         katana::steal(), katana::loopname("Afforest-LCS-Link"));
 
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          sdata->compress();
-        },
-        katana::steal(), katana::loopname("Afforest-LCS-Compress"));
+    AfforestFinalize(graph, &uf_, "Afforest-LCS-Compress");
   }
 };
 
 struct ConnectedComponentsEdgeAfforestAlgo {
-  struct NodeAfforestEdge : public katana::UnionFindNode<NodeAfforestEdge> {
-    using ComponentType = NodeAfforestEdge*;
-
-    NodeAfforestEdge()
-        : katana::UnionFindNode<NodeAfforestEdge>(
-              const_cast<NodeAfforestEdge*>(this)) {}
-    NodeAfforestEdge(const NodeAfforestEdge& o)
-        : katana::UnionFindNode<NodeAfforestEdge>(o.m_component) {}
-
-    ComponentType component() { return this->get(); }
-    bool isRepComp(unsigned int) { return false; }  // verify
-
-  public:
-    NodeAfforestEdge* hook_min(NodeAfforestEdge* b, NodeAfforestEdge* c = 0) {
-      NodeAfforestEdge* a = m_component.load(std::memory_order_relaxed);
-      b = b->m_component.load(std::memory_order_relaxed);
-      while (a != b) {
-        if (a < b)
-          std::swap(a, b);
-        // Now a > b
-        NodeAfforestEdge* ac = a->m_component.load(std::memory_order_relaxed);
-        if (ac == a && a->m_component.compare_exchange_strong(a, b)) {
-          if (b == c)
-            return a;  //! return victim
-          return 0;
-        }
-        if (b == ac) {
-          return 0;
-        }
-        a = (a->m_component.load(std::memory_order_relaxed))
-                ->m_component.load(std::memory_order_relaxed);
-        b = b->m_component.load(std::memory_order_relaxed);
-      }
-      return 0;
-    }
-  };
-
-  using ComponentType = NodeAfforestEdge::ComponentType;
-  struct NodeComponent {
-    using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
-    using ViewType = katana::PODPropertyView<NodeAfforestEdge::ComponentType>;
-  };
-
+  using NodeComponent = AfforestParent;
   using NodeData = std::tuple<NodeComponent>;
   using EdgeData = std::tuple<>;
   typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
@@ -816,23 +821,14 @@ struct ConnectedComponentsEdgeAfforestAlgo {
   using Edge = std::pair<GNode, GNode>;
 
   ConnectedComponentsPlan& plan_;
+  ParentUnionFind uf_{nullptr};
   ConnectedComponentsEdgeAfforestAlgo(ConnectedComponentsPlan& plan)
       : plan_(plan) {}
 
-  void Initialize(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      graph->GetData<NodeComponent>(node) = new NodeAfforestEdge();
-    });
-  }
+  void Initialize(Graph* graph) { AfforestInitialize(graph, &uf_); }
+
+  void Deallocate(Graph*) {}
 
-  void Deallocate(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& sdata = graph->GetData<NodeComponent>(node);
-      auto component_ptr = sdata->component();
-      delete sdata;
-      sdata = component_ptr;
-    });
-  }
   void operator()(Graph* graph) {
     // (bozhi) should NOT go through single direction in sampling step: nodes
     // with edges less than NEIGHBOR_SAMPLES will fail
@@ -845,36 +841,29 @@ struct ConnectedComponentsEdgeAfforestAlgo {
             std::advance(ii, r);
             if (ii < ei) {
               auto dest = graph->GetEdgeDest(ii);
-              auto& sdata = graph->GetData<NodeComponent>(src);
-              auto& ddata = graph->GetData<NodeComponent>(dest);
-              sdata->hook_min(ddata);
+              uf_.HookMin(src, *dest, ParentUnionFind::kNoNode);
             }
           },
           katana::steal(), katana::loopname("EdgeAfforest-VNS-Link"));
     }
     katana::do_all(
         katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          sdata->compress();
-        },
-        katana::steal(), katana::loopname("EdgeAfforest-VNS-Compress"));
+        [&](const GNode& src) { return uf_.CompressTask(src); },
+        katana::interleave<>(), katana::steal(),
+        katana::loopname("EdgeAfforest-VNS-Compress"));
 
     katana::StatTimer StatTimer_Sampling("EdgeAfforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, plan_.component_sample_frequency());
+    const uint64_t c = ApproxLargestComponent(
+        uf_, graph->num_nodes(), plan_.component_sample_frequency());
     StatTimer_Sampling.stop();
-    const ComponentType c0 = (graph->GetData<NodeComponent>(0));
 
     katana::InsertBag<Edge> works;
 
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          if (sdata->component() == c)
+          if (uf_.parent(src) == c)
             return;
           auto beg = graph->edge_begin(src);
           const auto end = graph->edge_end(src);
@@ -882,8 +871,7 @@ struct ConnectedComponentsEdgeAfforestAlgo {
           for (std::advance(beg, plan_.neighbor_sample_size()); beg < end;
                beg++) {
             auto dest = graph->GetEdgeDest(beg);
-            auto& ddata = graph->GetData<NodeComponent>(dest);
-            if (src < *dest || c == ddata->component()) {
+            if (src < *dest || c == uf_.parent(*dest)) {
               works.push_back(std::make_pair(src, *dest));
             }
           }
@@ -893,13 +881,13 @@ struct ConnectedComponentsEdgeAfforestAlgo {
     katana::for_each(
         katana::iterate(works),
         [&](const Edge& e, auto& ctx) {
-          auto& sdata = graph->GetData<NodeComponent>(e.first);
-          if (sdata->component() == c)
+          if (uf_.parent(e.first) == c)
             return;
-          auto& ddata = graph->GetData<NodeComponent>(e.second);
-          ComponentType victim = sdata->hook_min(ddata, c);
-          if (victim) {
-            auto src = victim - c0;  // TODO (bozhi) tricky!
+          uint64_t victim = uf_.HookMin(e.first, e.second, c);
+          if (victim != ParentUnionFind::kNoNode) {
+            // The tree rooted at victim joined the giant component, so
+            // revisit the edges of its root from the other side
+            GNode src = victim;
             for (auto ii : graph->edges(src)) {
               auto dest = graph->GetEdgeDest(ii);
               ctx.push_back(std::make_pair(*dest, src));
@@ -909,78 +897,25 @@ struct ConnectedComponentsEdgeAfforestAlgo {
         katana::disable_conflict_detection(),
         katana::loopname("EdgeAfforest-LCS-Link"));
 
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          sdata->compress();
-        },
-        katana::steal(), katana::loopname("EdgeAfforest-LCS-Compress"));
+    AfforestFinalize(graph, &uf_, "EdgeAfforest-LCS-Compress");
   }
 };
 
 struct ConnectedComponentsEdgeTiledAfforestAlgo {
-  struct NodeAfforest : public katana::UnionFindNode<NodeAfforest> {
-    using ComponentType = NodeAfforest*;
-
-    NodeAfforest()
-        : katana::UnionFindNode<NodeAfforest>(const_cast<NodeAfforest*>(this)) {
-    }
-    NodeAfforest(const NodeAfforest& o)
-        : katana::UnionFindNode<NodeAfforest>(o.m_component) {}
-
-    ComponentType component() { return this->get(); }
-    bool isRepComp(unsigned int) { return false; }  // verify
-
-  public:
-    void link(NodeAfforest* b) {
-      NodeAfforest* a = m_component.load(std::memory_order_relaxed);
-      b = b->m_component.load(std::memory_order_relaxed);
-      while (a != b) {
-        if (a < b)
-          std::swap(a, b);
-        // Now a > b
-        NodeAfforest* ac = a->m_component.load(std::memory_order_relaxed);
-        if ((ac == a && a->m_component.compare_exchange_strong(a, b)) ||
-            (b == ac))
-          break;
-        a = (a->m_component.load(std::memory_order_relaxed))
-                ->m_component.load(std::memory_order_relaxed);
-        b = b->m_component.load(std::memory_order_relaxed);
-      }
-    }
-  };
-
-  struct NodeComponent {
-    using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
-    using ViewType = katana::PODPropertyView<NodeAfforest::ComponentType>;
-  };
-
+  using NodeComponent = AfforestParent;
   using NodeData = std::tuple<NodeComponent>;
   using EdgeData = std::tuple<>;
   typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
 
   ConnectedComponentsPlan& plan_;
+  ParentUnionFind uf_{nullptr};
   ConnectedComponentsEdgeTiledAfforestAlgo(ConnectedComponentsPlan& plan)
       : plan_(plan) {}
 
-  void Initialize(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      graph->GetData<NodeComponent>(node) = new NodeAfforest();
-    });
-  }
+  void Initialize(Graph* graph) { AfforestInitialize(graph, &uf_); }
 
-  void Deallocate(Graph* graph) {
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& sdata = graph->GetData<NodeComponent>(node);
-      auto component_ptr = sdata->component();
-      delete sdata;
-      sdata = component_ptr;
-    });
-  }
-
-  using ComponentType = NodeAfforest::ComponentType;
+  void Deallocate(Graph*) {}
 
   struct EdgeTile {
     GNode src;
@@ -999,34 +934,28 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
           for (uint32_t r = 0; r < plan_.neighbor_sample_size() && ii < end;
                ++r, ++ii) {
             auto dest = graph->GetEdgeDest(ii);
-            auto& sdata = graph->GetData<NodeComponent>(src);
-            auto& ddata = graph->GetData<NodeComponent>(dest);
-            sdata->link(ddata);
+            uf_.Link(src, *dest);
           }
         },
         katana::steal(), katana::loopname("EdgetiledAfforest-VNS-Link"));
 
     katana::do_all(
         katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          sdata->compress();
-        },
-        katana::steal(), katana::loopname("EdgetiledAfforest-VNS-Compress"));
+        [&](const GNode& src) { return uf_.CompressTask(src); },
+        katana::interleave<>(), katana::steal(),
+        katana::loopname("EdgetiledAfforest-VNS-Compress"));
 
     katana::StatTimer StatTimer_Sampling("EdgetiledAfforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, plan_.component_sample_frequency());
+    const uint64_t c = ApproxLargestComponent(
+        uf_, graph->num_nodes(), plan_.component_sample_frequency());
     StatTimer_Sampling.stop();
 
     katana::InsertBag<EdgeTile> works;
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          if (sdata->component() == c)
+          if (uf_.parent(src) == c)
             return;
           auto beg = graph->edge_begin(src);
           const auto end = graph->edge_end(src);
@@ -1048,29 +977,84 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
     katana::do_all(
         katana::iterate(works),
         [&](const EdgeTile& tile) {
-          auto& sdata = graph->GetData<NodeComponent>(tile.src);
-          if (sdata->component() == c)
+          if (uf_.parent(tile.src) == c)
             return;
           for (auto ii = tile.beg; ii < tile.end; ++ii) {
             auto dest = graph->GetEdgeDest(ii);
-            auto& ddata = graph->GetData<NodeComponent>(dest);
-            sdata->link(ddata);
+            uf_.Link(tile.src, *dest);
           }
         },
         katana::steal(),
         katana::chunk_size<ConnectedComponentsPlan::kChunkSize>(),
         katana::loopname("EdgetiledAfforest-LCS-Link"));
 
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<NodeComponent>(src);
-          sdata->compress();
-        },
-        katana::steal(), katana::loopname("EdgetiledAfforest-LCS-Compress"));
+    AfforestFinalize(graph, &uf_, "EdgetiledAfforest-LCS-Compress");
   }
 };
 
+/// Relabel each component with its smallest node, so that the labels do not
+/// depend on which node or object an algorithm happened to pick to
+/// represent a component
+katana::Result<void>
+CanonicalizeComponents(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  struct NodeComponent : public katana::PODProperty<uint64_t> {};
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodeComponent>, std::tuple<>>;
+
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  uint64_t num_nodes = graph.size();
+  if (num_nodes == 0) {
+    return katana::ResultSuccess();
+  }
+
+  // Sorting (component, node) pairs groups the nodes of each component,
+  // smallest first
+  katana::LargeArray<std::pair<uint64_t, uint32_t>> pairs;
+  pairs.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        pairs.constructAt(n, graph.GetData<NodeComponent>(n), n);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(pairs.begin(), pairs.end());
+
+  // runs[i] - 1 is the rank of the component of pairs[i]
+  katana::LargeArray<uint64_t> runs;
+  runs.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        runs[i] = i == 0 || pairs[i].first != pairs[i - 1].first;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(runs.begin(), runs.end(), runs.begin());
+
+  katana::LargeArray<uint32_t> smallest;
+  smallest.allocateBlocked(runs[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        if (i == 0 || runs[i] != runs[i - 1]) {
+          smallest[runs[i] - 1] = pairs[i].second;
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        graph.GetData<NodeComponent>(pairs[i].second) = smallest[runs[i] - 1];
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
 }  //namespace
 
 template <typename Algorithm>
@@ -1078,6 +1062,9 @@ static katana::Result<void>
 ConnectedComponentsWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
     ConnectedComponentsPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
   if (auto r = ConstructNodeProperties<
           std::tuple<typename Algorithm::NodeComponent>>(
           pg, {output_property_name});
@@ -1105,13 +1092,20 @@ ConnectedComponentsWithWrap(
 
   execTime.stop();
 
-  return katana::ResultSuccess();
+  if (plan.deterministic()) {
+    if (auto r = CanonicalizeComponents(pg, output_property_name); !r) {
+      return r.error();
+    }
+  }
+
+  return CheckCancelled();
 }
 
 katana::Result<void>
 katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan) {
+  katana::parameter::ProfileScope profile(plan.profile_parallelism());
   switch (plan.algorithm()) {
   case ConnectedComponentsPlan::kSerial:
     return ConnectedComponentsWithWrap<ConnectedComponentsSerialAlgo>(
@@ -1151,6 +1145,144 @@ katana::analytics::ConnectedComponents(
   }
 }
 
+katana::Result<IncrementalConnectedComponents>
+IncrementalConnectedComponents::Make(
+    PropertyGraph* pg, const std::string& property_name,
+    ConnectedComponentsPlan plan) {
+  if (!pg->GetNodeProperty(property_name)) {
+    if (auto r = ConnectedComponents(pg, property_name, plan); !r) {
+      return r.error();
+    }
+    // Only the Afforest algorithms label components by their smallest node
+    // on their own
+    bool afforest = plan.algorithm() == ConnectedComponentsPlan::kAfforest ||
+                    plan.algorithm() == ConnectedComponentsPlan::kEdgeAfforest ||
+                    plan.algorithm() ==
+                        ConnectedComponentsPlan::kEdgeTiledAfforest;
+    if (!afforest && !plan.deterministic()) {
+      if (auto r = CanonicalizeComponents(pg, property_name); !r) {
+        return r.error();
+      }
+    }
+  }
+
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<AfforestParent>, std::tuple<>>;
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  uint64_t* parent = graph.GetNodePropertyView<AfforestParent>().data();
+
+  // Parents never larger than their children make every tree end at its
+  // smallest node
+  katana::GReduceLogicalOr not_forest;
+  katana::GReduceLogicalOr not_compressed;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        if (parent[n] > n) {
+          not_forest.update(true);
+        } else if (parent[parent[n]] != parent[n]) {
+          not_compressed.update(true);
+        }
+      },
+      katana::no_stats());
+  if (not_forest.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} does not label components by their smallest node; compute it "
+        "with a deterministic plan",
+        property_name);
+  }
+
+  IncrementalConnectedComponents components(
+      property_name, pg->GetNodeProperty(property_name), parent);
+  components.compressed_ = !not_compressed.reduce();
+  return components;
+}
+
+katana::Result<void>
+IncrementalConnectedComponents::InsertEdges(
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+  uint64_t num_nodes = property_->length();
+  for (const auto& [u, v] : edges) {
+    if (u >= num_nodes || v >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "edge {} -> {} is outside of the {} nodes of the components", u, v,
+          num_nodes);
+    }
+  }
+
+  ParentUnionFind uf(parent_);
+  katana::do_all(
+      katana::iterate(edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        uf.Link(edge.first, edge.second);
+      },
+      katana::steal(), katana::loopname("IncrementalCC-Link"));
+  compressed_ = compressed_ && edges.empty();
+  return katana::ResultSuccess();
+}
+
+uint64_t
+IncrementalConnectedComponents::Component(uint32_t node) {
+  ParentUnionFind uf(parent_);
+  uf.Compress(node);
+  return uf.parent(node);
+}
+
+void
+IncrementalConnectedComponents::Compress() {
+  if (compressed_) {
+    return;
+  }
+  ParentUnionFind uf(parent_);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, static_cast<uint64_t>(property_->length())),
+      [&](uint64_t n) {
+        // Children of roots, usually most nodes, need no write
+        if (uf.parent(uf.parent(n)) != uf.parent(n)) {
+          uf.Compress(n);
+        }
+      },
+      katana::steal(), katana::loopname("IncrementalCC-Compress"));
+  compressed_ = true;
+}
+
+katana::Result<katana::analytics::ConnectedComponentsPlan>
+katana::analytics::TuneConnectedComponentsPlan(
+    const PropertyGraph& pg, const TunerOptions& opts) {
+  using CcPlan = ConnectedComponentsPlan;
+  std::vector<PlanCandidate<CcPlan>> candidates{
+      {"LabelProp", CcPlan::LabelProp()},
+      {"Synchronous", CcPlan::Synchronous()},
+      {"Asynchronous", CcPlan::Asynchronous()},
+      {"EdgeAsynchronous", CcPlan::EdgeAsynchronous()},
+      {"BlockedAsynchronous", CcPlan::BlockedAsynchronous()},
+      {"Afforest", CcPlan::Afforest()},
+      {"EdgeAfforest", CcPlan::EdgeAfforest()},
+  };
+  for (ptrdiff_t tile_size : {128, 512, 2048}) {
+    candidates.push_back(
+        {fmt::format("EdgeTiledAsynchronous/{}", tile_size),
+         CcPlan::EdgeTiledAsynchronous(tile_size)});
+    candidates.push_back(
+        {fmt::format("EdgeTiledAfforest/{}", tile_size),
+         CcPlan::EdgeTiledAfforest(tile_size)});
+  }
+
+  return TunePlan(
+      "ConnectedComponents", pg, candidates,
+      [](PropertyGraph* sample, const CcPlan& plan) {
+        TemporaryPropertyGuard output(sample);
+        return ConnectedComponents(sample, output.name(), plan);
+      },
+      {}, opts);
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
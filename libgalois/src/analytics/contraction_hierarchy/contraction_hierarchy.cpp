@@ -0,0 +1,728 @@
+#include "katana/analytics/contraction_hierarchy/contraction_hierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+using katana::analytics::ContractionHierarchy;
+using katana::analytics::ContractionHierarchyPlan;
+using katana::analytics::WeightedPath;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using ShortcutEdge = ContractionHierarchy::ShortcutEdge;
+
+static_assert(
+    sizeof(ShortcutEdge) == 16 && std::is_trivially_copyable_v<ShortcutEdge>,
+    "ShortcutEdge is stored as is");
+
+constexpr Node kNoNode = ContractionHierarchy::kNoMiddle;
+
+/// An edge of the graph being contracted. Every edge is kept at both of its
+/// ends: at its source with node as its destination and at its destination
+/// with node as its source.
+struct Arc {
+  Node node;
+  Node middle;
+  double weight;
+};
+
+/// A shortcut from -> to added by contracting middle
+struct Shortcut {
+  Node from;
+  Node to;
+  double weight;
+  Node middle;
+};
+
+/// Call fn with a value of the C type of the edge property named
+/// edge_weight_property_name, or fail if it is not a number.
+template <typename Fn>
+auto
+DispatchWeightType(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name, const Fn& fn)
+    -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "edge weights of type {} are not numbers",
+        property->type()->ToString());
+  }
+}
+
+/// A permutation of node ids that breaks ties between equal priorities.
+/// Breaking them by id would contract a path one node per round.
+uint64_t
+TieBreak(Node n) {
+  uint64_t x = n + 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Add arc to arcs, or lower the weight of the arc to the same node
+void
+AddArc(std::vector<Arc>* arcs, const Arc& arc) {
+  for (Arc& a : *arcs) {
+    if (a.node == arc.node) {
+      if (arc.weight < a.weight) {
+        a = arc;
+      }
+      return;
+    }
+  }
+  arcs->emplace_back(arc);
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(int64_t size, const char* what) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {}: {}", what,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// The edges of a hierarchy in one direction and their weights and middles
+struct UpwardGraph {
+  katana::GraphTopology topology;
+  std::shared_ptr<arrow::Buffer> edges;
+};
+
+/// Build the topology whose node n has the edges arcs[n]
+katana::Result<UpwardGraph>
+MakeUpwardGraph(const std::vector<std::vector<Arc>>& arcs) {
+  uint64_t num_nodes = arcs.size();
+  auto indices_res = Allocate(num_nodes * sizeof(uint64_t), "out_indices");
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto* indices =
+      reinterpret_cast<uint64_t*>(indices_res.value()->mutable_data());
+  uint64_t num_edges = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    num_edges += arcs[n].size();
+    indices[n] = num_edges;
+  }
+
+  auto dests_res = Allocate(num_edges * sizeof(uint32_t), "out_dests");
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edges_res = Allocate(num_edges * sizeof(ShortcutEdge), "edges");
+  if (!edges_res) {
+    return edges_res.error();
+  }
+  auto* dests = reinterpret_cast<uint32_t*>(dests_res.value()->mutable_data());
+  auto* edges =
+      reinterpret_cast<ShortcutEdge*>(edges_res.value()->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t e = n == 0 ? 0 : indices[n - 1];
+        for (const Arc& arc : arcs[n]) {
+          dests[e] = arc.node;
+          edges[e] = ShortcutEdge{arc.weight, arc.middle, 0};
+          ++e;
+        }
+      },
+      katana::no_stats(), katana::loopname("ContractionHierarchyCSR"));
+
+  return UpwardGraph{
+      .topology =
+          katana::GraphTopology{
+              .out_indices = std::make_shared<arrow::UInt64Array>(
+                  num_nodes, indices_res.value()),
+              .out_dests = std::make_shared<arrow::UInt32Array>(
+                  num_edges, dests_res.value()),
+          },
+      .edges = edges_res.value(),
+  };
+}
+
+/// The graph being contracted and the upward edges of the nodes contracted
+/// so far
+class Contraction {
+  /// The state of the witness searches of a thread
+  struct Scratch {
+    std::unordered_map<Node, double> distance;
+    std::vector<std::pair<double, Node>> heap;
+  };
+
+  const ContractionHierarchyPlan& plan_;
+  std::vector<std::vector<Arc>> out_;
+  std::vector<std::vector<Arc>> in_;
+  std::vector<int64_t> priority_;
+  std::vector<uint32_t> deleted_neighbors_;
+  std::vector<uint8_t> dirty_;
+  std::vector<uint8_t> selected_;
+  std::vector<Node> remaining_;
+  katana::PerThreadStorage<Scratch> scratch_;
+
+  /// Dijkstra from source over the remaining nodes except skip (and the
+  /// nodes selected for this round if skip_selected) up to distance bound
+  /// or until the settle limit of the plan is reached. Distances to the
+  /// nodes it did not settle are upper bounds.
+  void WitnessSearch(
+      Node source, Node skip, double bound, bool skip_selected,
+      Scratch* s) const {
+    auto& distance = s->distance;
+    auto& heap = s->heap;
+    distance.clear();
+    heap.clear();
+    distance[source] = 0;
+    heap.emplace_back(0, source);
+
+    uint32_t settled = 0;
+    while (!heap.empty() && settled < plan_.witness_settle_limit()) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+      auto [d, n] = heap.back();
+      heap.pop_back();
+      if (d > distance[n]) {
+        continue;
+      }
+      if (d > bound) {
+        break;
+      }
+      ++settled;
+      for (const Arc& arc : out_[n]) {
+        if (arc.node == skip || (skip_selected && selected_[arc.node])) {
+          continue;
+        }
+        double next = d + arc.weight;
+        auto [it, inserted] = distance.try_emplace(arc.node, next);
+        if (inserted || next < it->second) {
+          it->second = next;
+          heap.emplace_back(next, arc.node);
+          std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        }
+      }
+    }
+  }
+
+  /// Call fn with each shortcut needed to contract u: each path x -> u -> y
+  /// with no shorter witness path from x to y that avoids u
+  template <typename Fn>
+  void ForEachShortcut(Node u, bool skip_selected, Scratch* s, const Fn& fn) {
+    const std::vector<Arc>& outs = out_[u];
+    if (outs.empty()) {
+      return;
+    }
+    for (const Arc& in : in_[u]) {
+      double bound = 0;
+      for (const Arc& out : outs) {
+        if (out.node != in.node) {
+          bound = std::max(bound, in.weight + out.weight);
+        }
+      }
+      WitnessSearch(in.node, u, bound, skip_selected, s);
+      for (const Arc& out : outs) {
+        if (out.node == in.node) {
+          continue;
+        }
+        double via = in.weight + out.weight;
+        auto it = s->distance.find(out.node);
+        if (it == s->distance.end() || it->second > via) {
+          fn(Shortcut{in.node, out.node, via, u});
+        }
+      }
+    }
+  }
+
+  /// The edge difference of contracting u plus its contracted neighbors,
+  /// which spreads contraction evenly over the graph
+  void UpdatePriority(Node u, Scratch* s) {
+    int64_t shortcuts = 0;
+    ForEachShortcut(u, false, s, [&](const Shortcut&) { ++shortcuts; });
+    priority_[u] = shortcuts - static_cast<int64_t>(in_[u].size()) -
+                   static_cast<int64_t>(out_[u].size()) +
+                   deleted_neighbors_[u];
+  }
+
+  bool IsLocalMinimum(Node u) const {
+    auto key = [&](Node n) {
+      return std::make_pair(priority_[n], TieBreak(n));
+    };
+    auto u_key = key(u);
+    for (const auto* arcs : {&out_[u], &in_[u]}) {
+      for (const Arc& arc : *arcs) {
+        if (key(arc.node) < u_key) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// Contract the selected nodes: freeze their arcs as upward edges, remove
+  /// them from their neighbors and add the shortcuts
+  void Apply(std::vector<Shortcut>* shortcuts) {
+    auto by_from = [](const Shortcut& a, const Shortcut& b) {
+      return std::tie(a.from, a.to, a.weight, a.middle) <
+             std::tie(b.from, b.to, b.weight, b.middle);
+    };
+    auto by_to = [](const Shortcut& a, const Shortcut& b) {
+      return std::tie(a.to, a.from, a.weight, a.middle) <
+             std::tie(b.to, b.from, b.weight, b.middle);
+    };
+    std::vector<Shortcut> to_sorted(*shortcuts);
+    katana::ParallelSTL::sort(shortcuts->begin(), shortcuts->end(), by_from);
+    katana::ParallelSTL::sort(to_sorted.begin(), to_sorted.end(), by_to);
+
+    katana::do_all(
+        katana::iterate(remaining_),
+        [&](Node n) {
+          if (selected_[n]) {
+            return;
+          }
+          auto is_selected = [&](const Arc& arc) {
+            return selected_[arc.node] != 0;
+          };
+          size_t removed = 0;
+          for (auto* arcs : {&out_[n], &in_[n]}) {
+            auto end = std::remove_if(arcs->begin(), arcs->end(), is_selected);
+            removed += arcs->end() - end;
+            arcs->erase(end, arcs->end());
+          }
+
+          auto from_begin = std::lower_bound(
+              shortcuts->begin(), shortcuts->end(), n,
+              [](const Shortcut& s, Node node) { return s.from < node; });
+          auto to_begin = std::lower_bound(
+              to_sorted.begin(), to_sorted.end(), n,
+              [](const Shortcut& s, Node node) { return s.to < node; });
+          bool added = false;
+          for (auto it = from_begin; it != shortcuts->end() && it->from == n;
+               ++it) {
+            AddArc(&out_[n], Arc{it->to, it->middle, it->weight});
+            added = true;
+          }
+          for (auto it = to_begin; it != to_sorted.end() && it->to == n; ++it) {
+            AddArc(&in_[n], Arc{it->from, it->middle, it->weight});
+            added = true;
+          }
+
+          if (removed != 0 || added) {
+            deleted_neighbors_[n] += removed;
+            dirty_[n] = 1;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ContractionHierarchyApply"));
+
+    remaining_.erase(
+        std::remove_if(
+            remaining_.begin(), remaining_.end(),
+            [&](Node n) { return selected_[n] != 0; }),
+        remaining_.end());
+  }
+
+public:
+  /// The out-arcs of each contracted node when it was contracted, all of
+  /// which lead to nodes contracted later
+  std::vector<std::vector<Arc>> up;
+  /// The in-arcs of each contracted node when it was contracted
+  std::vector<std::vector<Arc>> down;
+
+  explicit Contraction(const ContractionHierarchyPlan& plan) : plan_(plan) {}
+
+  /// Copy the edges of pg, without self loops and keeping the lightest of
+  /// parallel edges
+  template <typename Weight>
+  katana::Result<void> Init(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+    auto weights_res =
+        pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+    if (!weights_res) {
+      return weights_res.error();
+    }
+    const Weight* weights = weights_res.value()->raw_values();
+    const katana::GraphTopology& topology = pg->topology();
+    uint64_t num_nodes = topology.num_nodes();
+
+    if constexpr (
+        std::is_signed_v<Weight> || std::is_floating_point_v<Weight>) {
+      katana::GReduceLogicalOr invalid;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, topology.num_edges()),
+          [&](uint64_t e) { invalid.update(!(weights[e] >= 0)); },
+          katana::no_stats());
+      if (invalid.reduce()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge weights must not be negative");
+      }
+    }
+
+    out_.resize(num_nodes);
+    in_.resize(num_nodes);
+    up.resize(num_nodes);
+    down.resize(num_nodes);
+    priority_.resize(num_nodes);
+    deleted_neighbors_.assign(num_nodes, 0);
+    dirty_.assign(num_nodes, 1);
+    selected_.assign(num_nodes, 0);
+    remaining_.resize(num_nodes);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          remaining_[n] = n;
+          for (auto e : topology.edges(n)) {
+            Node dest = topology.edge_dest(e);
+            if (dest != n) {
+              AddArc(
+                  &out_[n],
+                  Arc{dest, kNoNode, static_cast<double>(weights[e])});
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ContractionHierarchyInit"));
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      for (const Arc& arc : out_[n]) {
+        in_[arc.node].emplace_back(
+            Arc{static_cast<Node>(n), kNoNode, arc.weight});
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Contract all nodes, one independent set per round
+  katana::Result<void> Run() {
+    uint32_t rounds = 0;
+    while (!remaining_.empty()) {
+      if (auto r = katana::analytics::CheckCancelled(); !r) {
+        return r.error();
+      }
+      ++rounds;
+
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](Node n) {
+            if (dirty_[n]) {
+              UpdatePriority(n, scratch_.getLocal());
+              dirty_[n] = 0;
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("ContractionHierarchyPriority"));
+
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](Node n) { selected_[n] = IsLocalMinimum(n); }, katana::no_stats(),
+          katana::loopname("ContractionHierarchySelect"));
+
+      katana::PerThreadStorage<std::vector<Shortcut>> local_shortcuts;
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](Node n) {
+            if (!selected_[n]) {
+              return;
+            }
+            auto& local = *local_shortcuts.getLocal();
+            ForEachShortcut(
+                n, true, scratch_.getLocal(),
+                [&](const Shortcut& s) { local.emplace_back(s); });
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("ContractionHierarchyShortcuts"));
+
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](Node n) {
+            if (selected_[n]) {
+              up[n] = std::move(out_[n]);
+              down[n] = std::move(in_[n]);
+            }
+          },
+          katana::no_stats(), katana::loopname("ContractionHierarchyFreeze"));
+
+      std::vector<Shortcut> shortcuts;
+      for (unsigned t = 0; t < local_shortcuts.size(); ++t) {
+        const auto& local = *local_shortcuts.getRemote(t);
+        shortcuts.insert(shortcuts.end(), local.begin(), local.end());
+      }
+      Apply(&shortcuts);
+    }
+    katana::ReportStatSingle("ContractionHierarchy", "Rounds", rounds);
+    return katana::ResultSuccess();
+  }
+};
+
+/// The edge of graph stored at node at whose destination is dest
+const ShortcutEdge&
+FindEdge(const UpwardGraph& graph, Node at, Node dest) {
+  const auto* edges =
+      reinterpret_cast<const ShortcutEdge*>(graph.edges->data());
+  for (auto e : graph.topology.edges(at)) {
+    if (graph.topology.edge_dest(e) == dest) {
+      return edges[e];
+    }
+  }
+  KATANA_LOG_FATAL("no edge between {} and {} in the hierarchy", at, dest);
+}
+
+}  // namespace
+
+ContractionHierarchy::ContractionHierarchy(
+    GraphTopology up, std::shared_ptr<arrow::Buffer> up_edges,
+    GraphTopology down, std::shared_ptr<arrow::Buffer> down_edges)
+    : up_(std::move(up)),
+      up_edges_(std::move(up_edges)),
+      down_(std::move(down)),
+      down_edges_(std::move(down_edges)) {}
+
+ContractionHierarchy::Query::Query(const ContractionHierarchy& hierarchy) {
+  for (Side& side : sides_) {
+    side.labels.assign(hierarchy.num_nodes(), Label{kInfinity, 0, kNoMiddle});
+  }
+}
+
+katana::Result<ContractionHierarchy>
+ContractionHierarchy::Build(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    ContractionHierarchyPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+
+  Contraction contraction(plan);
+  auto init_res = DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto weight) {
+        return contraction.Init<decltype(weight)>(
+            pg, edge_weight_property_name);
+      });
+  if (!init_res) {
+    return init_res.error();
+  }
+
+  katana::StatTimer exec_time("ContractionHierarchy");
+  exec_time.start();
+  auto run_res = contraction.Run();
+  exec_time.stop();
+  if (!run_res) {
+    return run_res.error();
+  }
+
+  auto up_res = MakeUpwardGraph(contraction.up);
+  if (!up_res) {
+    return up_res.error();
+  }
+  auto down_res = MakeUpwardGraph(contraction.down);
+  if (!down_res) {
+    return down_res.error();
+  }
+  return ContractionHierarchy(
+      up_res.value().topology, up_res.value().edges,
+      down_res.value().topology, down_res.value().edges);
+}
+
+katana::Result<void>
+ContractionHierarchy::Store(PropertyGraph* pg, const std::string& name) const {
+  if (pg->num_nodes() != num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "hierarchy of {} nodes does not belong to a graph of {} nodes",
+        num_nodes(), pg->num_nodes());
+  }
+  if (auto r = pg->AddAuxTopology(
+          name + "-up", up_, up_edges_, sizeof(ShortcutEdge));
+      !r) {
+    return r.error();
+  }
+  return pg->AddAuxTopology(
+      name + "-down", down_, down_edges_, sizeof(ShortcutEdge));
+}
+
+katana::Result<ContractionHierarchy>
+ContractionHierarchy::Load(const PropertyGraph& pg, const std::string& name) {
+  UpwardGraph graphs[2];
+  const char* suffixes[2] = {"-up", "-down"};
+  for (int i = 0; i < 2; ++i) {
+    std::string aux_name = name + suffixes[i];
+    auto topology_res = pg.LoadAuxTopology(aux_name);
+    if (!topology_res) {
+      return topology_res.error();
+    }
+    auto edges_res =
+        pg.LoadAuxTopologyEdgeData(aux_name, sizeof(ShortcutEdge));
+    if (!edges_res) {
+      return edges_res.error();
+    }
+    if (topology_res.value().num_nodes() != pg.num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} has {} nodes but the graph has {}", aux_name,
+          topology_res.value().num_nodes(), pg.num_nodes());
+    }
+    graphs[i] = UpwardGraph{topology_res.value(), edges_res.value()};
+  }
+  return ContractionHierarchy(
+      graphs[0].topology, graphs[0].edges, graphs[1].topology,
+      graphs[1].edges);
+}
+
+uint32_t
+ContractionHierarchy::Search(
+    uint32_t source, uint32_t target, Query* query) const {
+  KATANA_LOG_DEBUG_ASSERT(source < num_nodes() && target < num_nodes());
+  const GraphTopology* graphs[2] = {&up_, &down_};
+  const ShortcutEdge* edges[2] = {
+      reinterpret_cast<const ShortcutEdge*>(up_edges_->data()),
+      reinterpret_cast<const ShortcutEdge*>(down_edges_->data())};
+  uint32_t starts[2] = {source, target};
+
+  for (int i = 0; i < 2; ++i) {
+    Query::Side& side = query->sides_[i];
+    for (uint32_t n : side.touched) {
+      side.labels[n].distance = kInfinity;
+    }
+    side.touched.clear();
+    side.heap.clear();
+    side.labels[starts[i]] = Query::Label{0, 0, kNoMiddle};
+    side.touched.emplace_back(starts[i]);
+    side.heap.emplace_back(0, starts[i]);
+  }
+
+  // Both searches stop once they cannot improve on the best path found;
+  // they take turns so that neither explores far beyond the other
+  double best = kInfinity;
+  uint32_t meet = kNoMiddle;
+  bool forward = true;
+  while (true) {
+    bool done[2];
+    for (int i = 0; i < 2; ++i) {
+      const auto& heap = query->sides_[i].heap;
+      done[i] = heap.empty() || heap.front().first >= best;
+    }
+    if (done[0] && done[1]) {
+      break;
+    }
+    int i = done[0] ? 1 : done[1] ? 0 : !forward;
+    forward = !forward;
+
+    Query::Side& side = query->sides_[i];
+    const Query::Side& other = query->sides_[1 - i];
+    std::pop_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+    auto [d, n] = side.heap.back();
+    side.heap.pop_back();
+    if (d > side.labels[n].distance) {
+      continue;
+    }
+    if (d + other.labels[n].distance < best) {
+      best = d + other.labels[n].distance;
+      meet = n;
+    }
+    for (auto e : graphs[i]->edges(n)) {
+      uint32_t dest = graphs[i]->edge_dest(e);
+      double next = d + edges[i][e].weight;
+      Query::Label& label = side.labels[dest];
+      if (next < label.distance) {
+        if (label.distance == kInfinity) {
+          side.touched.emplace_back(dest);
+        }
+        label = Query::Label{next, e, n};
+        side.heap.emplace_back(next, dest);
+        std::push_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+      }
+    }
+  }
+  return meet;
+}
+
+double
+ContractionHierarchy::Distance(
+    uint32_t source, uint32_t target, Query* query) const {
+  uint32_t meet = Search(source, target, query);
+  if (meet == kNoMiddle) {
+    return kInfinity;
+  }
+  return query->sides_[0].labels[meet].distance +
+         query->sides_[1].labels[meet].distance;
+}
+
+void
+ContractionHierarchy::Unpack(
+    uint32_t from, uint32_t to, const ShortcutEdge& edge,
+    std::vector<uint32_t>* path) const {
+  UpwardGraph up{up_, up_edges_};
+  UpwardGraph down{down_, down_edges_};
+  std::vector<std::tuple<uint32_t, uint32_t, ShortcutEdge>> stack{
+      {from, to, edge}};
+  while (!stack.empty()) {
+    auto [a, b, e] = stack.back();
+    stack.pop_back();
+    if (e.middle == kNoMiddle) {
+      path->emplace_back(b);
+      continue;
+    }
+    // The middle was contracted before both ends, so a -> middle is a down
+    // edge and middle -> b an up edge of the middle
+    uint32_t m = e.middle;
+    stack.emplace_back(m, b, FindEdge(up, m, b));
+    stack.emplace_back(a, m, FindEdge(down, m, a));
+  }
+}
+
+WeightedPath
+ContractionHierarchy::ShortestPath(
+    uint32_t source, uint32_t target, Query* query) const {
+  uint32_t meet = Search(source, target, query);
+  if (meet == kNoMiddle) {
+    return WeightedPath{{}, kInfinity};
+  }
+  const auto* up_edges =
+      reinterpret_cast<const ShortcutEdge*>(up_edges_->data());
+  const auto* down_edges =
+      reinterpret_cast<const ShortcutEdge*>(down_edges_->data());
+  const auto& forward = query->sides_[0].labels;
+  const auto& backward = query->sides_[1].labels;
+
+  std::vector<uint32_t> forward_nodes;
+  for (uint32_t n = meet; forward[n].parent != kNoMiddle;
+       n = forward[n].parent) {
+    forward_nodes.emplace_back(n);
+  }
+
+  WeightedPath path{{source}, forward[meet].distance + backward[meet].distance};
+  for (auto it = forward_nodes.rbegin(); it != forward_nodes.rend(); ++it) {
+    const Query::Label& label = forward[*it];
+    Unpack(label.parent, *it, up_edges[label.edge], &path.nodes);
+  }
+  for (uint32_t n = meet; backward[n].parent != kNoMiddle;
+       n = backward[n].parent) {
+    const Query::Label& label = backward[n];
+    Unpack(n, label.parent, down_edges[label.edge], &path.nodes);
+  }
+  return path;
+}
@@ -0,0 +1,149 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_HYPERGRAPHPARTITION_BIPART_H_
+#define KATANA_LIBGALOIS_ANALYTICS_HYPERGRAPHPARTITION_BIPART_H_
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/HyperGraph.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+#include "katana/gstl.h"
+
+/// The BiPart multilevel hypergraph bipartitioner, shared by the coarsening,
+/// initial partitioning and refinement phases of HypergraphPartition.
+namespace katana::analytics::bipart {
+
+struct MetisNode;
+
+using HyperGraph = katana::HyperGraph<MetisNode>;
+using GNode = HyperGraph::GraphNode;
+using GNodeBag = katana::InsertBag<GNode>;
+
+// Nodes in the metis graph.
+struct MetisNode {
+  using GainTy = int;
+  using NetvalTy = int;
+  using NetnumTy = uint32_t;
+  using WeightTy = uint32_t;
+
+  uint32_t partition;
+  GNode parent;
+  GNode node_id;
+  GNode child_id;
+  uint32_t graph_index;
+  uint32_t counter;
+  uint32_t list_index;
+  bool not_alone;
+  bool matched;
+  WeightTy weight;
+  GainTy positive_gain;
+  GainTy negative_gain;
+  katana::CopyableAtomic<uint32_t> degree;
+  // Net-val and -rand have the same type.
+  katana::CopyableAtomic<NetvalTy> netrand;
+  katana::CopyableAtomic<NetvalTy> netval;
+  katana::CopyableAtomic<NetnumTy> netnum;
+
+  inline GainTy GetGain() const {
+    return (positive_gain - (negative_gain + counter));
+  }
+
+  inline void SetMatched() { matched = true; }
+  inline void UnsetMatched() { matched = false; }
+  inline bool IsMatched() const { return matched; }
+
+  inline bool IsNotAlone() const { return not_alone; }
+  inline void SetNotAlone() { not_alone = true; }
+  inline void UnsetNotAlone() { not_alone = false; }
+
+  inline uint32_t GetCounter() const { return counter; }
+  inline void ResetCounter() { counter = 0; }
+  inline void IncCounter() { counter++; }
+
+  explicit MetisNode(WeightTy weight) : weight(weight) { Init(); }
+
+  MetisNode() : weight(1) { Init(); }
+
+  void InitRefine(uint32_t p = 0) {
+    partition = p;
+    counter = 0;
+  }
+
+  void Init() {
+    matched = false;
+    parent = 0;
+    netval = 0;
+    counter = 0;
+    partition = 0;
+  }
+}; /* Metis Node Done. */
+
+// Structure to keep track of graph hirarchy.
+struct MetisGraph {
+  // Coarse root: leaf.
+  MetisGraph* coarsened_graph;
+  MetisGraph* parent_graph;
+  HyperGraph graph;
+
+  MetisGraph() : coarsened_graph(nullptr), parent_graph(nullptr) {}
+
+  explicit MetisGraph(MetisGraph* fg)
+      : coarsened_graph(nullptr), parent_graph(fg) {
+    parent_graph->coarsened_graph = this;
+  }
+};
+
+constexpr static const uint32_t kChunkSize = 512u;
+constexpr static const uint32_t kInfPartition = kHyperedgeCut;
+
+using EdgeDstVecTy = katana::gstl::Vector<katana::PODResizeableArray<uint32_t>>;
+using LargeArrayUint64Ty = katana::LargeArray<uint64_t>;
+using GainTy = MetisNode::GainTy;
+using NetvalTy = MetisNode::NetvalTy;
+using NetnumTy = MetisNode::NetnumTy;
+using WeightTy = MetisNode::WeightTy;
+using MatchingPolicy = HypergraphPartitionPlan::MatchingPolicy;
+
+// Coarsening
+void Coarsen(std::vector<MetisGraph*>*, const uint32_t, const MatchingPolicy);
+
+// Partitioning
+void PartitionCoarsestGraphs(
+    const std::vector<MetisGraph*>&, const std::vector<uint32_t>&,
+    const bool deterministic);
+
+// Refinement
+void Refine(
+    std::vector<MetisGraph*>*, const std::vector<uint32_t>&,
+    const bool deterministic);
+
+void ConstructCombinedLists(
+    const std::vector<MetisGraph*>&,
+    std::vector<std::pair<uint32_t, uint32_t>>*,
+    std::vector<std::pair<uint32_t, uint32_t>>*);
+
+// Helpers
+void InitNodes(HyperGraph* graph, uint32_t num_hedges);
+void PrioritizeHigherDegree(GNode node, HyperGraph* fine_graph);
+void PrioritizeRandom(GNode node, HyperGraph* fine_graph);
+void PrioritizeLowerDegree(GNode node, HyperGraph* fine_graph);
+void PrioritizeHigherWeight(GNode node, HyperGraph* fine_graph);
+void PrioritizeDegree(GNode node, HyperGraph* fine_graph);
+void SortNodesByGainAndWeight(
+    HyperGraph* graph, std::vector<GNode>* nodes, uint32_t end_offset,
+    const bool deterministic);
+void InitGain(HyperGraph* g);
+void InitGain(
+    const std::vector<std::pair<uint32_t, uint32_t>>& combined_edgelist,
+    const std::vector<std::pair<uint32_t, uint32_t>>& combined_nodelist,
+    const std::vector<HyperGraph*>& g);
+
+}  // namespace katana::analytics::bipart
+
+#endif
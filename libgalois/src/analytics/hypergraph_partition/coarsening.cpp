@@ -24,12 +24,11 @@
  *  partitioning algorithm
  */
 
-#include "Helper.h"
+#include "bipart.h"
 #include "katana/AtomicHelpers.h"
 #include "katana/DynamicBitset.h"
 
-// maximum weight limit for a coarsened node
-WeightTy kLimitWeights[100];
+namespace katana::analytics::bipart {
 
 using MatchingPolicyFunction = void(GNode, HyperGraph*);
 
@@ -187,6 +186,7 @@ ParallelPrioRand(
  * needs to be added to the coarsened graph
  * @param weight Vector of vectors containing the weight value of the
  * coarsened nodes
+ * @param limit_weights Maximum weight of a coarsened node of each graph
  */
 template <MatchingPolicyFunction Matcher>
 void
@@ -194,7 +194,8 @@ ParallelHMatchAndCreateNodes(
     const std::vector<MetisGraph*>& graph,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_edge_list,
     std::vector<GNodeBag>* nodes, std::vector<katana::DynamicBitset>* hedges,
-    std::vector<std::vector<WeightTy>>* weight) {
+    std::vector<std::vector<WeightTy>>* weight,
+    const std::vector<WeightTy>& limit_weights) {
   ParallelPrioRand<Matcher>(graph, combined_edge_list);
 
   uint32_t total_hedge_size = combined_edge_list.size();
@@ -233,7 +234,7 @@ ParallelHMatchAndCreateNodes(
           }
           if (dst_node_data.netnum == hedge_data.netnum) {
             WeightTy dst_node_weight = dst_node_data.weight;
-            if (total_node_weight + dst_node_weight > kLimitWeights[index]) {
+            if (total_node_weight + dst_node_weight > limit_weights[index]) {
               break;
             }
             edges.push_back(dst);
@@ -880,6 +881,7 @@ ParallelCreateEdges(
  * @param combined_node_list Concatenated list of nodes of the
  * finer-graphs
  * @param matching_policy matching policy to be used
+ * @param limit_weights Maximum weight of a coarsened node of each graph
  */
 void
 FindMatching(
@@ -887,7 +889,8 @@ FindMatching(
     const std::vector<MetisGraph*>& fine_mgraph,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_edge_list,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_node_list,
-    const MatchingPolicy matching_policy) {
+    const MatchingPolicy matching_policy,
+    const std::vector<WeightTy>& limit_weights) {
   KATANA_LOG_DEBUG_ASSERT(coarse_mgraph.size() == fine_mgraph.size());
   uint32_t num_fine_hedges = fine_mgraph.size();
   std::vector<GNodeBag> nodes(num_fine_hedges);
@@ -908,25 +911,30 @@ FindMatching(
   }
 
   switch (matching_policy) {
-  case HigherDegree:
+  case HypergraphPartitionPlan::kHigherDegree:
     ParallelHMatchAndCreateNodes<PrioritizeHigherDegree>(
-        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight);
+        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight,
+        limit_weights);
     break;
-  case Random:
+  case HypergraphPartitionPlan::kRandom:
     ParallelHMatchAndCreateNodes<PrioritizeRandom>(
-        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight);
+        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight,
+        limit_weights);
     break;
-  case LowerDegree:
+  case HypergraphPartitionPlan::kLowerDegree:
     ParallelHMatchAndCreateNodes<PrioritizeLowerDegree>(
-        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight);
+        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight,
+        limit_weights);
     break;
-  case HigherWeight:
+  case HypergraphPartitionPlan::kHigherWeight:
     ParallelHMatchAndCreateNodes<PrioritizeHigherWeight>(
-        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight);
+        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight,
+        limit_weights);
     break;
-  case LowerWeight:
+  case HypergraphPartitionPlan::kLowerWeight:
     ParallelHMatchAndCreateNodes<PrioritizeDegree>(
-        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight);
+        coarse_mgraph, combined_edge_list, &nodes, &hedges, &weight,
+        limit_weights);
     break;
   default:
     abort();
@@ -948,6 +956,7 @@ FindMatching(
  * @param combined_node_list Concatenated list of nodes of the
  * finer-graphs
  * @param matching_policy matching policy to be used
+ * @param limit_weights Maximum weight of a coarsened node of each graph
  */
 void
 CoarsenOnce(
@@ -955,7 +964,8 @@ CoarsenOnce(
     const std::vector<MetisGraph*>& fine_metis_graph,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_edge_list,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_node_list,
-    const MatchingPolicy matching_policy) {
+    const MatchingPolicy matching_policy,
+    const std::vector<WeightTy>& limit_weights) {
   uint32_t num_partitions = fine_metis_graph.size();
   KATANA_LOG_DEBUG_ASSERT(next_coarse_graph->size() == num_partitions);
   for (uint32_t i = 0; i < num_partitions; ++i) {
@@ -969,7 +979,7 @@ CoarsenOnce(
 
   FindMatching(
       *next_coarse_graph, fine_metis_graph, combined_edge_list,
-      combined_node_list, matching_policy);
+      combined_node_list, matching_policy, limit_weights);
 }
 
 /**
@@ -1004,13 +1014,15 @@ Coarsen(
 
   const float ratio = 52.5 / 47.5;
   const float tol = ratio - 1;
+  // Maximum weight limit for a coarsened node.
+  std::vector<WeightTy> limit_weights(num_partitions);
 
   for (uint32_t i = 0; i < num_partitions; ++i) {
     if (metis_graphs->at(i) == nullptr) {
       continue;
     }
     const WeightTy hi = (1 + tol) * current_num_nodes[i] / (2 + tol);
-    kLimitWeights[i] = hi / 4;
+    limit_weights[i] = hi / 4;
   }
 
   uint32_t iter_num{0};
@@ -1075,7 +1087,7 @@ Coarsen(
 
     CoarsenOnce(
         &next_coarse_graph, *metis_graphs, combined_edgelist, combined_nodelist,
-        matching_policy);
+        matching_policy, limit_weights);
 
     for (uint32_t i = 0; i < num_partitions; ++i) {
       if (!graph_is_done.test(i)) {
@@ -1106,4 +1118,5 @@ Coarsen(
     metis_graphs->at(i) = final_graph[i];
   }
 }
-// #endif
+
+}  // namespace katana::analytics::bipart
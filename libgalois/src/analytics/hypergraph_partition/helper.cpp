@@ -1,4 +1,9 @@
-#include "Helper.h"
+#include <algorithm>
+#include <cmath>
+
+#include "bipart.h"
+
+namespace katana::analytics::bipart {
 
 /**
  * Initialize the nodes in the graph
@@ -25,121 +30,6 @@ InitNodes(HyperGraph* graph, const uint32_t num_hedges) {
       katana::loopname("Init-Nodes"));
 }
 
-/**
- * Constructs LC_CSR graph from the input file
- *
- * @param graph Graph to be constructed
- * @param filename Input graph file name
- */
-void
-ConstructGraph(
-    HyperGraph* graph, const std::string filename,
-    const bool skip_isolated_hedges) {
-  std::ifstream f(filename.c_str());
-  std::string line;
-  std::getline(f, line);
-  std::stringstream ss(line);
-  uint32_t num_hedges{0}, num_hnodes{0}, total_num_nodes{0};
-  uint64_t num_fedges{0};
-
-  ss >> num_hedges >> num_hnodes;
-
-  katana::gPrint(" Number of hedges: ", num_hedges, "\n");
-  katana::gPrint(" Number of nodes: ", num_hnodes, "\n");
-
-  katana::StatTimer timer_graph_construt("MetisGraphConstruct");
-  timer_graph_construt.start();
-  // Inspection phase: count the number of hyper edges.
-  uint32_t num_read_hedges{0};
-  while (std::getline(f, line)) {
-    if (num_read_hedges >= num_hedges) {
-      KATANA_LOG_FATAL("ERROR: too many lines in input file");
-    }
-    std::stringstream ss(line);
-    uint32_t node_id;
-    uint32_t num_nodes_in_hedge{0};
-    while (ss >> node_id) {
-      if ((node_id < 1) || (node_id > num_hnodes)) {
-        KATANA_LOG_FATAL("ERROR: node value {} out of bounds", node_id);
-      }
-      num_nodes_in_hedge++;
-    }
-
-    if (num_nodes_in_hedge > 1) {
-      num_read_hedges++;
-    }
-  }
-  num_hedges = num_read_hedges;
-  total_num_nodes = num_hedges + num_hnodes;
-
-  // Reset the file descriptor for execution phase.
-  f.clear();
-  f.seekg(0);
-  std::getline(f, line);
-
-  // Execution phase: construct hyper graph.
-  EdgeDstVecTy edges_id(total_num_nodes);
-  LargeArrayUint64Ty prefix_edges;
-  prefix_edges.allocateInterleaved(total_num_nodes);
-  num_read_hedges = 0;
-  while (std::getline(f, line)) {
-    if (num_read_hedges > num_hedges) {
-      KATANA_LOG_FATAL("ERROR: too many lines in input file");
-    }
-    std::stringstream ss(line);
-    GNode node_id;
-    GNode first_new_node_id{0};
-    uint32_t num_nodes_in_hedge{0};
-    while (ss >> node_id) {
-      if (node_id < 1 || node_id > num_hnodes) {
-        KATANA_LOG_FATAL("ERROR: node id {} out of bounds", node_id);
-      }
-      // Node is relocated to the next slots of the hyper edge.
-      GNode new_node_id = num_hedges + (node_id - 1);
-      if (!skip_isolated_hedges) {
-        edges_id[num_read_hedges].push_back(new_node_id);
-      } else {
-        if (num_nodes_in_hedge > 0) {
-          if (num_nodes_in_hedge == 1) {
-            edges_id[num_read_hedges].push_back(first_new_node_id);
-          }
-          edges_id[num_read_hedges].push_back(new_node_id);
-        } else {
-          // If user passes the option to ignore hyperedges with only one node,
-          // then do not push the first node now.
-          // Just postpone pushing this and push it if the current hyperedge
-          // has at least 2 nodes.
-          first_new_node_id = new_node_id;
-        }
-        num_nodes_in_hedge++;
-      }
-    }
-
-    if (skip_isolated_hedges && num_nodes_in_hedge < 2) {
-      continue;
-    }
-    prefix_edges[num_read_hedges] = num_nodes_in_hedge;
-    num_fedges += prefix_edges[num_read_hedges++];
-  }
-  f.close();
-  graph->SetHedges(num_hedges);
-  graph->SetHnodes(num_hnodes);
-
-  katana::ParallelSTL::partial_sum(
-      prefix_edges.begin(), prefix_edges.end(), prefix_edges.begin());
-
-  // # nodes = (# of hyper edges + # of nodes), which means each hyper edge
-  // is considered as a node.
-  // # edges = (# of normal edges).
-  graph->constructFrom(
-      total_num_nodes, num_fedges, std::move(prefix_edges), edges_id);
-  InitNodes(graph, num_hedges);
-
-  timer_graph_construt.stop();
-  katana::gPrint(
-      " Time to construct Metis Graph ", timer_graph_construt.get(), "\n");
-}
-
 /**
  * Priority assinging functions.
  */
@@ -183,9 +73,28 @@ PrioritizeDegree(GNode node, HyperGraph* fine_graph) {
 
 void
 SortNodesByGainAndWeight(
-    HyperGraph* graph, std::vector<GNode>* nodes, uint32_t end_offset = 0) {
+    HyperGraph* graph, std::vector<GNode>* nodes, uint32_t end_offset,
+    const bool deterministic) {
   auto end_iter =
       (end_offset == 0) ? nodes->end() : nodes->begin() + end_offset;
+  if (deterministic) {
+    // Compare gain / weight exactly so that the order is a strict total
+    // order and the sorted nodes do not depend on the order they were
+    // gathered in from the parallel bags.
+    std::sort(nodes->begin(), end_iter, [&graph](GNode& l_opr, GNode& r_opr) {
+      MetisNode& l_data = graph->getData(l_opr);
+      MetisNode& r_data = graph->getData(r_opr);
+      int64_t l_cost = int64_t{l_data.GetGain()} * r_data.weight;
+      int64_t r_cost = int64_t{r_data.GetGain()} * l_data.weight;
+
+      if (l_cost == r_cost) {
+        return l_data.node_id < r_data.node_id;
+      }
+
+      return l_cost > r_cost;
+    });
+    return;
+  }
   std::sort(nodes->begin(), end_iter, [&graph](GNode& l_opr, GNode& r_opr) {
     MetisNode& l_data = graph->getData(l_opr);
     MetisNode& r_data = graph->getData(r_opr);
@@ -387,3 +296,5 @@ InitGain(
       },
       katana::loopname("Reduce-Gains"));
 }
+
+}  // namespace katana::analytics::bipart
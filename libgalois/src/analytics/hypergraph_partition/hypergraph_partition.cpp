@@ -0,0 +1,743 @@
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "bipart.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+using namespace katana::analytics::bipart;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+using PartitionID = katana::PODProperty<uint32_t>;
+using Graph =
+    katana::TypedPropertyGraph<std::tuple<PartitionID>, std::tuple<>>;
+
+/**
+ * Main Partitioning function for creating bi-partitions for all
+ * graphs at a given level of the k-way recursion tree
+ *
+ * @param metis_graphs Vector containing metis graphs
+ * @param target_partitions Vector containing target number of partitions for
+ * each of the graphs in the specified param metis_graphs
+ * @param plan Plan with the coarsening and refinement parameters
+ */
+void
+Partition(
+    std::vector<MetisGraph*>* metis_graphs,
+    const std::vector<uint32_t>& target_partitions,
+    const HypergraphPartitionPlan& plan) {
+  KATANA_LOG_DEBUG_ASSERT(metis_graphs->size() == target_partitions.size());
+  katana::StatTimer exec_timer("Total-Partition");
+  exec_timer.start();
+
+  katana::StatTimer timer_coarsing("Total-Coarsening");
+  timer_coarsing.start();
+  Coarsen(
+      metis_graphs, plan.max_coarsening_levels(), plan.matching_policy());
+  timer_coarsing.stop();
+
+  katana::StatTimer timer_partitioning("Total-Partitioning-CoarsestGraph");
+  timer_partitioning.start();
+  PartitionCoarsestGraphs(
+      *metis_graphs, target_partitions, plan.deterministic());
+  timer_partitioning.stop();
+
+  katana::StatTimer timer_refining("Total-Refining");
+  timer_refining.start();
+  Refine(metis_graphs, target_partitions, plan.deterministic());
+  timer_refining.stop();
+
+  exec_timer.stop();
+}
+
+/**
+ * Frees the coarsened graphs of a metis graph, which Partition leaves behind
+ *
+ * @param metis_graph Metis graph whose coarsened graphs are freed
+ */
+void
+DeleteCoarsenedGraphs(MetisGraph* metis_graph) {
+  MetisGraph* coarse = metis_graph->coarsened_graph;
+  while (coarse != nullptr) {
+    MetisGraph* next = coarse->coarsened_graph;
+    delete coarse;
+    coarse = next;
+  }
+  metis_graph->coarsened_graph = nullptr;
+}
+
+/**
+ * Computes the edge cut value
+ *
+ * @param g Graph
+ *
+ * @returns The value of edge cut for graph g with the current partitioning
+ * assignment
+ */
+uint32_t
+ComputingCut(HyperGraph* g) {
+  katana::GAccumulator<uint32_t> edgecut;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, g->GetHedges()),
+      [&](GNode n) {
+        uint32_t first_edge_partition_id =
+            g->getData(g->getEdgeDst(g->edge_begin(n))).partition;
+        bool edges_are_cut = false;
+        for (auto e = g->edge_begin(n) + 1; e < g->edge_end(n); e++) {
+          GNode dst = g->getEdgeDst(e);
+          uint32_t partition_id = g->getData(dst).partition;
+          if (partition_id != first_edge_partition_id) {
+            edges_are_cut = true;
+            break;
+          }
+        }
+        if (edges_are_cut) {
+          edgecut += 1;
+        }
+      },
+      katana::loopname("Compute-CutSize"));
+  return edgecut.reduce();
+}
+
+/**
+ * Assigns a partition to each hyperedge based on the current partitioning
+ * assignment of the nodes. Hyperedges of partitions that are not split
+ * further are assigned kInfPartition as well, so they are left out of the
+ * graphs of the next level.
+ *
+ * @param graph Graph
+ * @param num_hedges Number of hyperedges in the specified param graph
+ * @param to_process_partitions Number of partitions each partition is split
+ * into
+ */
+void
+SetCompleteHEdgePartition(
+    HyperGraph* graph, const uint32_t num_hedges,
+    const std::vector<uint32_t>& to_process_partitions) {
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_hedges),
+      [&](uint32_t hedge) {
+        auto f_edge = *(graph->edges(hedge).begin());
+        GNode f_dst = graph->getEdgeDst(f_edge);
+        uint32_t f_partition = graph->getData(f_dst).partition;
+        bool flag{true};
+
+        for (auto& fedge : graph->edges(hedge)) {
+          GNode dst = graph->getEdgeDst(fedge);
+          uint32_t partition = graph->getData(dst).partition;
+
+          if (partition != f_partition) {
+            flag = false;
+            break;
+          }
+        }
+        // The `flag` would be false if any member node
+        // of the hyperedge are in the different partitions.
+        // If the `flag` is true, then the current hedge is still
+        // valid and partitionable.
+
+        uint32_t h_partition{kInfPartition};
+        if (flag && to_process_partitions[f_partition] > 1) {
+          h_partition = f_partition;
+        }
+
+        graph->getData(hedge).partition = h_partition;
+      },
+      katana::steal(), katana::loopname("Set-CompleteHEdge-Partition"));
+}
+
+/**
+ * Assigns an id to the nodes and hyperedges in each child partition
+ *
+ * @param current_level_indices Indexes of current child partitions
+ * @param mem_nodes_of_parts Vector of InsertBags containing nodes for
+ * each child partition
+ * @param mem_hedges_of_parts Vector of InsertBags containing hyperedges for
+ * each child partition
+ * @param pgraph_index Index of the graph of each child partition
+ * @param num_hnodes_per_partition Number of nodes of each child graph
+ * @param num_hedges_per_partition Number of hyperedges of each child graph
+ * @param graph Graph
+ */
+void
+SetChildId(
+    const std::vector<uint32_t>& current_level_indices,
+    const std::vector<katana::InsertBag<GNode>>& mem_nodes_of_parts,
+    const std::vector<katana::InsertBag<GNode>>& mem_hedges_of_parts,
+    const std::vector<uint32_t>& pgraph_index,
+    std::vector<uint32_t>* num_hnodes_per_partition,
+    std::vector<uint32_t>* num_hedges_per_partition, HyperGraph* graph) {
+  katana::do_all(
+      katana::iterate(current_level_indices),
+      [&](uint32_t i) {
+        uint32_t ed = 0;
+        for (GNode h : mem_hedges_of_parts[i]) {
+          graph->getData(h).child_id = ed++;
+        }
+
+        uint32_t id = ed;
+        for (GNode n : mem_nodes_of_parts[i]) {
+          graph->getData(n).child_id = id++;
+        }
+
+        num_hedges_per_partition->at(pgraph_index[i]) = ed;
+        num_hnodes_per_partition->at(pgraph_index[i]) = id - ed;
+      },
+      katana::steal(), katana::loopname("Set-Child-IDs"));
+}
+
+void
+ConstructNewGraph(
+    const std::vector<uint32_t>& current_level_indices,
+    const std::vector<uint32_t>& pgraph_index,
+    const std::vector<uint32_t>& num_hnodes_per_partition,
+    const std::vector<uint32_t>& num_hedges_per_partition,
+    const uint32_t num_hedges, HyperGraph* graph,
+    const std::vector<HyperGraph*>& gr) {
+  uint32_t num_graphs = gr.size();
+  std::vector<EdgeDstVecTy> edges_ids(num_graphs);
+  std::vector<LargeArrayUint64Ty> edges_prefixsum(num_graphs);
+
+  for (uint32_t i : current_level_indices) {
+    uint32_t index = pgraph_index[i];
+    uint32_t total_nodes =
+        num_hedges_per_partition[index] + num_hnodes_per_partition[index];
+    edges_ids[index].resize(total_nodes);
+    edges_prefixsum[index].allocateInterleaved(total_nodes);
+  }
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_hedges),
+      [&](GNode src) {
+        MetisNode& src_node = graph->getData(src);
+        uint32_t partition = src_node.partition;
+        if (partition == kInfPartition) {
+          return;
+        }
+        uint32_t index = pgraph_index[partition];
+        GNode slot_id = src_node.child_id;
+
+        for (auto& e : graph->edges(src)) {
+          GNode dst = graph->getEdgeDst(e);
+          GNode dst_slot_id = graph->getData(dst).child_id;
+          edges_ids[index][slot_id].push_back(dst_slot_id);
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("Build-EdgeIds"));
+
+  for (uint32_t i : current_level_indices) {
+    uint32_t index = pgraph_index[i];
+    uint32_t ipart_num_nodes =
+        num_hedges_per_partition[index] + num_hnodes_per_partition[index];
+    uint64_t edges{0};
+    for (uint32_t c = 0; c < ipart_num_nodes; ++c) {
+      edges += edges_ids[index][c].size();
+      edges_prefixsum[index][c] = edges;
+    }
+
+    HyperGraph* cur_graph = gr[index];
+    cur_graph->constructFrom(
+        ipart_num_nodes, edges, std::move(edges_prefixsum[index]),
+        edges_ids[index]);
+    cur_graph->SetHedges(num_hedges_per_partition[index]);
+    cur_graph->SetHnodes(num_hnodes_per_partition[index]);
+    InitNodes(cur_graph, cur_graph->GetHedges());
+  }
+}
+
+/**
+ * Create k partitions by recursive bisection. All bisections of a level of
+ * the recursion are coarsened, partitioned and refined together, so the
+ * parallel loops of each phase run over the hyperedges of every graph of the
+ * level at once.
+ *
+ * @param metis_graph Metis graph representing the original input graph
+ * @param num_partitions Number of partitions to create
+ * @param plan Plan with the coarsening and refinement parameters
+ */
+void
+CreateKPartitions(
+    MetisGraph* metis_graph, const uint32_t num_partitions,
+    const HypergraphPartitionPlan& plan) {
+  katana::StatTimer initial_partition_timer("Initial-Partition");
+  katana::StatTimer intermediate_partition_timer("Intermediate-Partition");
+  HyperGraph* graph = &metis_graph->graph;
+  uint32_t total_num_nodes = graph->size();
+  uint32_t num_hedges = graph->GetHedges();
+
+  initial_partition_timer.start();
+  // Initial partitioning into two cgraphs.
+  {
+    std::vector<MetisGraph*> metis_graphs{metis_graph};
+    Partition(&metis_graphs, {num_partitions}, plan);
+    DeleteCoarsenedGraphs(metis_graph);
+  }
+  initial_partition_timer.stop();
+
+  // Partition p of the current level becomes partitions [p, p +
+  // to_process_partitions[p]) of the final partition.
+  std::vector<uint32_t> to_process_partitions(num_partitions, 0);
+  uint32_t second_partition = (num_partitions + 1) / 2;
+  to_process_partitions[0] = second_partition;
+  to_process_partitions[second_partition] = num_partitions / 2;
+
+  katana::do_all(
+      katana::iterate(num_hedges, total_num_nodes),
+      [&](uint32_t n) {
+        MetisNode& node = graph->getData(n);
+        uint32_t partition_of_node = node.partition;
+        // Change the second partition as the middle.
+        if (partition_of_node == 1) {
+          node.partition = second_partition;
+        }
+      },
+      katana::loopname("Initial-Assign-Partition"));
+
+  // Partitions that are split further; the others are final.
+  std::vector<uint32_t> current_level_indices;
+  for (uint32_t p : {uint32_t{0}, second_partition}) {
+    if (to_process_partitions[p] > 1) {
+      current_level_indices.emplace_back(p);
+    }
+  }
+
+  std::vector<katana::InsertBag<GNode>> mem_nodes_of_parts(num_partitions);
+  std::vector<katana::InsertBag<GNode>> mem_hedges_of_parts(num_partitions);
+  std::vector<uint32_t> pgraph_index(num_partitions);
+
+  while (!current_level_indices.empty()) {
+    for (uint32_t i : current_level_indices) {
+      mem_nodes_of_parts[i].clear();
+      mem_hedges_of_parts[i].clear();
+    }
+
+    // Assign index to each subgraph of the partitions.
+    // Note that pgraph_index does not need to be reset.
+    // It is always overwritten by the new index values.
+    uint32_t num_graphs{0};
+    for (uint32_t i : current_level_indices) {
+      pgraph_index[i] = num_graphs++;
+    }
+
+    for (uint32_t n = num_hedges; n < total_num_nodes; n++) {
+      MetisNode& node = graph->getData(n);
+      uint32_t partition = node.partition;
+      if (to_process_partitions[partition] > 1) {
+        mem_nodes_of_parts[partition].emplace(n);
+        node.graph_index = pgraph_index[partition];
+      }
+    }
+
+    SetCompleteHEdgePartition(graph, num_hedges, to_process_partitions);
+
+    for (uint32_t h = 0; h < num_hedges; h++) {
+      uint32_t partition = graph->getData(h).partition;
+      if (partition != kInfPartition) {
+        mem_hedges_of_parts[partition].emplace(h);
+        graph->getData(h).graph_index = pgraph_index[partition];
+      }
+    }
+
+    std::vector<MetisGraph*> metis_graph_vec(num_graphs);
+    std::vector<HyperGraph*> gr(num_graphs);
+    std::vector<uint32_t> target_partitions(num_graphs);
+    std::vector<uint32_t> num_hedges_per_partition(num_graphs);
+    std::vector<uint32_t> num_hnodes_per_partition(num_graphs);
+
+    for (uint32_t i : current_level_indices) {
+      uint32_t index = pgraph_index[i];
+      metis_graph_vec[index] = new MetisGraph();
+      gr[index] = &metis_graph_vec[index]->graph;
+      target_partitions[index] = to_process_partitions[i];
+    }
+
+    // Assign slot id for hyper edge and its member nodes.
+    SetChildId(
+        current_level_indices, mem_nodes_of_parts, mem_hedges_of_parts,
+        pgraph_index, &num_hnodes_per_partition, &num_hedges_per_partition,
+        graph);
+
+    ConstructNewGraph(
+        current_level_indices, pgraph_index, num_hnodes_per_partition,
+        num_hedges_per_partition, num_hedges, graph, gr);
+
+    intermediate_partition_timer.start();
+    {
+      // Partition replaces the graphs with their coarsened graphs.
+      std::vector<MetisGraph*> level_graphs = metis_graph_vec;
+      Partition(&level_graphs, target_partitions, plan);
+    }
+    intermediate_partition_timer.stop();
+
+    std::vector<uint32_t> next_level_indices;
+    for (uint32_t i : current_level_indices) {
+      uint32_t tmp = to_process_partitions[i];
+      uint32_t second = (tmp + 1) / 2;
+      to_process_partitions[i] = second;
+      to_process_partitions[i + second] = tmp / 2;
+      for (uint32_t p : {i, i + second}) {
+        if (to_process_partitions[p] > 1) {
+          next_level_indices.emplace_back(p);
+        }
+      }
+
+      HyperGraph* child = gr[pgraph_index[i]];
+      katana::do_all(
+          katana::iterate(mem_nodes_of_parts[i]),
+          [&](GNode src) {
+            MetisNode& src_data = graph->getData(src);
+            uint32_t partition = child->getData(src_data.child_id).partition;
+            if (partition == 1) {
+              src_data.partition = i + second;
+            }
+          },
+          katana::loopname("Reassign-Partition"));
+    }
+
+    for (MetisGraph* mcg : metis_graph_vec) {
+      DeleteCoarsenedGraphs(mcg);
+      delete mcg;
+    }
+
+    std::sort(next_level_indices.begin(), next_level_indices.end());
+    current_level_indices = std::move(next_level_indices);
+  }
+
+  katana::ReportStatSingle("BiPart", "Edge-Cut", ComputingCut(graph));
+  katana::ReportStatSingle("BiPart", "Partitions", num_partitions);
+}
+
+katana::Result<std::vector<uint32_t>>
+HypergraphPartitionImpl(
+    uint32_t num_hyperedges, uint32_t num_nodes,
+    std::vector<std::pair<uint32_t, uint32_t>> pins, uint32_t num_partitions,
+    const HypergraphPartitionPlan& plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of partitions must be positive");
+  }
+  if (plan.algorithm() != HypergraphPartitionPlan::kBiPart) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  katana::GAccumulator<uint64_t> bad_pins;
+  std::vector<uint32_t> hedge_id(num_hyperedges, 0);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{pins.size()}),
+      [&](uint64_t i) {
+        if (pins[i].first >= num_hyperedges || pins[i].second >= num_nodes) {
+          bad_pins += 1;
+          return;
+        }
+        __atomic_store_n(&hedge_id[pins[i].first], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  if (bad_pins.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} pins are not in [0, {}) x [0, {})", bad_pins.reduce(),
+        num_hyperedges, num_nodes);
+  }
+
+  if (num_nodes == 0) {
+    return std::vector<uint32_t>{};
+  }
+  if (num_partitions == 1) {
+    return std::vector<uint32_t>(num_nodes, 0);
+  }
+
+  // Number the hyperedges that have nodes; BiPart expects no empty
+  // hyperedges.
+  katana::ParallelSTL::partial_sum(
+      hedge_id.begin(), hedge_id.end(), hedge_id.begin());
+  uint32_t num_hedges = hedge_id.empty() ? 0 : hedge_id.back();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{pins.size()}),
+      [&](uint64_t i) { pins[i].first = hedge_id[pins[i].first] - 1; },
+      katana::no_stats());
+  hedge_id = std::vector<uint32_t>();
+
+  katana::StatTimer exec_time("HypergraphPartition");
+  exec_time.start();
+
+  MetisGraph metis_graph;
+  HyperGraph* graph = &metis_graph.graph;
+  graph->constructFromPins(num_hedges, num_nodes, std::move(pins));
+  InitNodes(graph, num_hedges);
+
+  CreateKPartitions(&metis_graph, num_partitions, plan);
+
+  std::vector<uint32_t> parts(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { parts[n] = graph->getData(num_hedges + n).partition; },
+      katana::no_stats());
+
+  exec_time.stop();
+
+  return parts;
+}
+
+/// The hyperedge number or node number of each node of the bipartite form of
+/// a hypergraph, with is_hyperedge telling which it is.
+struct BipartiteIndex {
+  std::vector<uint32_t> index;
+  std::vector<uint8_t> is_hyperedge;
+  uint32_t num_hyperedges{0};
+  uint32_t num_nodes{0};
+};
+
+katana::Result<BipartiteIndex>
+MakeBipartiteIndex(const katana::GraphTopology& topology) {
+  uint32_t num_vertices = topology.num_nodes();
+  BipartiteIndex bi;
+  bi.index.resize(num_vertices);
+  bi.is_hyperedge.resize(num_vertices);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node v) {
+        bi.is_hyperedge[v] = topology.edges(v).size() > 0;
+        bi.index[v] = bi.is_hyperedge[v];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      bi.index.begin(), bi.index.end(), bi.index.begin());
+  bi.num_hyperedges = bi.index.empty() ? 0 : bi.index.back();
+  bi.num_nodes = num_vertices - bi.num_hyperedges;
+
+  katana::GAccumulator<uint64_t> bad_edges;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node v) {
+        if (bi.is_hyperedge[v]) {
+          bi.index[v] -= 1;
+          for (Edge e : topology.edges(v)) {
+            if (topology.edges(topology.edge_dest(e)).size() > 0) {
+              bad_edges += 1;
+            }
+          }
+        } else {
+          bi.index[v] = v - bi.index[v];
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (bad_edges.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edges go from a hyperedge to a hyperedge; the graph is not the "
+        "bipartite form of a hypergraph",
+        bad_edges.reduce());
+  }
+  return bi;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::HypergraphPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, HypergraphPartitionPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  auto bi_result = MakeBipartiteIndex(topology);
+  if (!bi_result) {
+    return bi_result.error();
+  }
+  BipartiteIndex bi = std::move(bi_result.value());
+
+  std::vector<std::pair<uint32_t, uint32_t>> pins(topology.num_edges());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node v) {
+        for (Edge e : topology.edges(v)) {
+          pins[e] = {bi.index[v], bi.index[topology.edge_dest(e)]};
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto parts_result = HypergraphPartitionImpl(
+      bi.num_hyperedges, bi.num_nodes, std::move(pins), num_partitions, plan);
+  if (!parts_result) {
+    return parts_result.error();
+  }
+  std::vector<uint32_t> parts = std::move(parts_result.value());
+
+  if (auto r = ConstructNodeProperties<std::tuple<PartitionID>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node v) {
+        if (!bi.is_hyperedge[v]) {
+          graph.GetData<PartitionID>(v) = parts[bi.index[v]];
+          return;
+        }
+        auto edges = topology.edges(v);
+        uint32_t part = parts[bi.index[topology.edge_dest(*edges.begin())]];
+        for (Edge e : edges) {
+          if (parts[bi.index[topology.edge_dest(e)]] != part) {
+            part = kHyperedgeCut;
+            break;
+          }
+        }
+        graph.GetData<PartitionID>(v) = part;
+      },
+      katana::steal(), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::HypergraphPartition(
+    uint32_t num_hyperedges, uint32_t num_nodes,
+    std::vector<std::pair<uint32_t, uint32_t>> pins, uint32_t num_partitions,
+    HypergraphPartitionPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  return HypergraphPartitionImpl(
+      num_hyperedges, num_nodes, std::move(pins), num_partitions, plan);
+}
+
+katana::Result<void>
+katana::analytics::HypergraphPartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  const katana::GraphTopology& topology = pg->topology();
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::GAccumulator<uint64_t> bad_nodes;
+  katana::GAccumulator<uint64_t> bad_hyperedges;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node v) {
+        uint32_t part = graph.GetData<PartitionID>(v);
+        auto edges = topology.edges(v);
+        if (edges.size() == 0) {
+          if (part >= num_partitions) {
+            bad_nodes += 1;
+          }
+          return;
+        }
+        bool cut = false;
+        uint32_t first =
+            graph.GetData<PartitionID>(topology.edge_dest(*edges.begin()));
+        for (Edge e : edges) {
+          if (graph.GetData<PartitionID>(topology.edge_dest(e)) != first) {
+            cut = true;
+            break;
+          }
+        }
+        if (part != (cut ? kHyperedgeCut : first)) {
+          bad_hyperedges += 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (bad_nodes.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes are not in one of the {} partitions", bad_nodes.reduce(),
+        num_partitions);
+  }
+  if (bad_hyperedges.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} hyperedges are not in the partition of their nodes",
+        bad_hyperedges.reduce());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<HypergraphPartitionStatistics>
+katana::analytics::HypergraphPartitionStatistics::Compute(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  if (auto r = HypergraphPartitionAssertValid(
+          pg, num_partitions, property_name);
+      !r) {
+    return r.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  std::vector<uint64_t> part_nodes(num_partitions, 0);
+  katana::GAccumulator<uint64_t> num_nodes;
+  katana::GAccumulator<uint64_t> cut_hyperedges;
+  katana::GAccumulator<uint64_t> connectivity;
+  katana::PerThreadStorage<std::vector<uint32_t>> seen;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node v) {
+        auto edges = topology.edges(v);
+        if (edges.size() == 0) {
+          num_nodes += 1;
+          __atomic_fetch_add(
+              &part_nodes[graph.GetData<PartitionID>(v)], 1,
+              __ATOMIC_RELAXED);
+          return;
+        }
+        if (graph.GetData<PartitionID>(v) != kHyperedgeCut) {
+          return;
+        }
+        cut_hyperedges += 1;
+        std::vector<uint32_t>& parts = *seen.getLocal();
+        parts.clear();
+        for (Edge e : edges) {
+          parts.emplace_back(graph.GetData<PartitionID>(topology.edge_dest(e)));
+        }
+        std::sort(parts.begin(), parts.end());
+        connectivity +=
+            std::unique(parts.begin(), parts.end()) - parts.begin() - 1;
+      },
+      katana::steal(), katana::loopname("HypergraphPartition-Statistics"));
+
+  double node_imbalance = 1.0;
+  if (num_nodes.reduce() > 0) {
+    uint64_t largest = *std::max_element(part_nodes.begin(), part_nodes.end());
+    node_imbalance =
+        static_cast<double>(largest) * num_partitions / num_nodes.reduce();
+  }
+
+  return HypergraphPartitionStatistics{
+      num_partitions, cut_hyperedges.reduce(), connectivity.reduce(),
+      node_imbalance};
+}
+
+void
+katana::analytics::HypergraphPartitionStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of partitions = " << num_partitions << std::endl;
+  os << "Number of cut hyperedges = " << cut_hyperedges << std::endl;
+  os << "Connectivity - 1 = " << connectivity << std::endl;
+  os << "Node imbalance = " << node_imbalance << std::endl;
+}
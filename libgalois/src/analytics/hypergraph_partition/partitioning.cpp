@@ -17,9 +17,11 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "Helper.h"
+#include "bipart.h"
 #include "katana/AtomicHelpers.h"
 
+namespace katana::analytics::bipart {
+
 /**
  * Computes the degrees of the nodes
  *
@@ -76,13 +78,15 @@ ComputeDegrees(
  * Finds an initial partition of the coarsest graphs
  *
  * @param metis_graphs Vector of metis graphs
- * @param K Vector corresponding to the number of target partitions that needs
- * to be created for the graphs in specified param metis_graphs
+ * @param target_partitions Vector corresponding to the number of target
+ * partitions that needs to be created for the graphs in specified param
+ * metis_graphs
+ * @param deterministic Whether nodes are sorted in a strict total order
  */
 void
 PartitionCoarsestGraphs(
     const std::vector<MetisGraph*>& metis_graphs,
-    const std::vector<unsigned>& target_partitions) {
+    const std::vector<uint32_t>& target_partitions, const bool deterministic) {
   KATANA_LOG_DEBUG_ASSERT(metis_graphs.size() == target_partitions.size());
   uint32_t num_partitions = metis_graphs.size();
   std::vector<katana::GAccumulator<WeightTy>> nzero_accum(num_partitions);
@@ -227,7 +231,7 @@ PartitionCoarsestGraphs(
       aggregate_node_timer.stop();
 
       sort_timer.start();
-      SortNodesByGainAndWeight(cur_graph, &node_vec, idx);
+      SortNodesByGainAndWeight(cur_graph, &node_vec, idx, deterministic);
       sort_timer.stop();
 
       find_partitionone_timer.start();
@@ -259,3 +263,5 @@ PartitionCoarsestGraphs(
     }
   }
 }
+
+}  // namespace katana::analytics::bipart
@@ -17,7 +17,9 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "Helper.h"
+#include "bipart.h"
+
+namespace katana::analytics::bipart {
 
 void
 ProjectPart(MetisGraph* metis_graph) {
@@ -188,7 +190,9 @@ ParallelSwaps(
 }
 
 void
-ParallelMakingbalance(HyperGraph* g, const float tol) {
+ParallelMakingbalance(
+    HyperGraph* g, const float tol, const uint32_t target_partitions,
+    const bool deterministic) {
   uint32_t total_hnodes = g->GetHnodes();
   uint32_t total_hedges = g->GetHedges();
   uint32_t graph_size = g->size();
@@ -208,8 +212,13 @@ ParallelMakingbalance(HyperGraph* g, const float tol) {
       },
       katana::loopname("Refining-Make-Balance"));
 
-  const WeightTy hi = (1 + tol) * node_size.reduce() / (2 + tol);
-  const WeightTy lo = node_size.reduce() - hi;
+  // Partition 1 is split into target_partitions / 2 of the target
+  // partitions later, so it gets that share of the weight; for an even
+  // number of target partitions this is the usual balanced bisection.
+  const float share =
+      2.0f * static_cast<float>(target_partitions / 2) / target_partitions;
+  const WeightTy hi = share * (1 + tol) * node_size.reduce() / (2 + tol);
+  const WeightTy lo = share * node_size.reduce() / (2 + tol);
   WeightTy balance = accum.reduce();
 
   katana::StatTimer init_gain_timer("Refining-Init-Gains");
@@ -306,7 +315,8 @@ ParallelMakingbalance(HyperGraph* g, const float tol) {
             cand_nodes_vec_arr[idx].push_back(cand_node);
           }
 
-          SortNodesByGainAndWeight(g, &cand_nodes_vec_arr[idx], 0);
+          SortNodesByGainAndWeight(
+              g, &cand_nodes_vec_arr[idx], 0, deterministic);
         },
         katana::loopname("Refining-Sort-Bucket"));
 
@@ -364,7 +374,7 @@ ParallelMakingbalance(HyperGraph* g, const float tol) {
     }
 
     sort_timer.start();
-    SortNodesByGainAndWeight(g, &neg_cand_nodes_vec, 0);
+    SortNodesByGainAndWeight(g, &neg_cand_nodes_vec, 0, deterministic);
     sort_timer.stop();
 
     make_balance_timer.start();
@@ -399,7 +409,9 @@ ParallelMakingbalance(HyperGraph* g, const float tol) {
 }
 
 void
-Refine(std::vector<MetisGraph*>* coarse_graph) {
+Refine(
+    std::vector<MetisGraph*>* coarse_graph,
+    const std::vector<uint32_t>& target_partitions, const bool deterministic) {
   uint32_t num_partitions = coarse_graph->size();
 
   std::vector<float> ratio(num_partitions, 0.0f);
@@ -451,7 +463,8 @@ Refine(std::vector<MetisGraph*>* coarse_graph) {
     // running time.
     for (uint32_t i = 0; i < num_partitions; i++) {
       if (gg[i] != nullptr) {
-        ParallelMakingbalance(gg[i], tol[i]);
+        ParallelMakingbalance(
+            gg[i], tol[i], target_partitions[i], deterministic);
       }
     }
     make_balance_timer.stop();
@@ -481,3 +494,5 @@ Refine(std::vector<MetisGraph*>* coarse_graph) {
     total_hedges = 0;
   }
 }
+
+}  // namespace katana::analytics::bipart
@@ -19,14 +19,19 @@
 
 #include "katana/analytics/independent_set/independent_set.h"
 
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/LargeArray.h"
 #include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
@@ -47,6 +52,14 @@ hash(unsigned int val) {
   return (val >> 16) ^ val;
 }
 
+/// The degree of a node lowered by a pseudo-random fraction, which orders
+/// nodes of the same degree pseudo-randomly. The priorities of the priority
+/// independent set algorithms and of the coloring algorithms derive from it.
+float
+HashedDegree(float degree, unsigned int node) {
+  return degree - hash(node) * kHashScale;
+}
+
 enum MatchFlag : char {
   KOtherMatched = false,
   kMatched = true,
@@ -326,6 +339,96 @@ struct PullAlgo {
   }
 };
 
+/// The greedy independent set in the order given by Before. Each node
+/// counts its undecided earlier neighbors; the node that decides last
+/// schedules the neighbor, so each node is decided exactly once and always
+/// after all of its earlier neighbors.
+struct OrderedPrioAlgo {
+  struct NodeFlag {
+    using ArrowType = arrow::CTypeTraits<uint8_t>::ArrowType;
+    using ViewType = katana::PODPropertyView<MatchFlag>;
+  };
+  using NodeData = std::tuple<NodeFlag>;
+  using EdgeData = std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  struct Indexer {
+    unsigned int operator()(const GNode& n) const { return hash(n); }
+  };
+
+  static bool Before(GNode a, GNode b) {
+    unsigned int hash_a = hash(a);
+    unsigned int hash_b = hash(b);
+    return hash_a < hash_b || (hash_a == hash_b && a < b);
+  }
+
+  void Initialize(Graph* graph) {
+    for (auto n : *graph) {
+      graph->GetData<NodeFlag>(n) = MatchFlag::KUnMatched;
+    }
+  }
+
+  void operator()(Graph* graph) {
+    using WL = katana::AdaptiveOrderedByIntegerMetric<
+        Indexer, katana::PerSocketChunkFIFO<kChunkSize>>;
+
+    katana::LargeArray<std::atomic<uint32_t>> waiting;
+    waiting.allocateBlocked(graph->size());
+    katana::InsertBag<GNode> ready;
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          uint32_t count = 0;
+          for (auto edge : graph->edges(src)) {
+            if (Before(*graph->GetEdgeDest(edge), src)) {
+              count += 1;
+            }
+          }
+          waiting.constructAt(src, count);
+          if (count == 0) {
+            ready.push(src);
+          }
+        },
+        katana::loopname("IndependentSet-ordered-init"), katana::steal());
+
+    // Start with buckets that hold about kChunkSize nodes
+    unsigned initial_shift = std::numeric_limits<unsigned int>::digits;
+    for (uint64_t n = graph->size(); n > kChunkSize && initial_shift > 0;
+         n /= 2) {
+      initial_shift -= 1;
+    }
+
+    katana::for_each(
+        katana::iterate(ready),
+        [&](const GNode& src, auto& ctx) {
+          MatchFlag flag = MatchFlag::kMatched;
+          for (auto edge : graph->edges(src)) {
+            auto dest = *graph->GetEdgeDest(edge);
+            if (Before(dest, src) &&
+                graph->GetData<NodeFlag>(dest) == MatchFlag::kMatched) {
+              flag = MatchFlag::KOtherMatched;
+              break;
+            }
+          }
+          graph->GetData<NodeFlag>(src) = flag;
+
+          for (auto edge : graph->edges(src)) {
+            auto dest = *graph->GetEdgeDest(edge);
+            if (Before(src, dest) && waiting[dest].fetch_sub(1) == 1) {
+              ctx.push(dest);
+            }
+          }
+        },
+        katana::wl<WL>(
+            Indexer(), initial_shift, "IndependentSet-OrderedPrioAlgo"),
+        katana::disable_conflict_detection(),
+        katana::loopname("IndependentSet-ordered"));
+  }
+};
+
 const auto kPermanentYes = uint8_t{0xfe};
 const auto kUndecided = uint8_t{0x01};
 const auto kTemporaryYes = uint8_t{0x02};
@@ -363,7 +466,7 @@ struct PrioAlgo {
         [&](const GNode& src) {
           auto& src_flag = graph->GetData<NodeFlag>(src);
           float degree = graph->edges(src).size();
-          float x = degree - hash(src) * kHashScale;
+          float x = HashedDegree(degree, src);
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 1;
           src_flag = val;
@@ -466,7 +569,7 @@ struct EdgeTiledPrioAlgo {
           const auto end = graph->edge_end(src);
 
           float degree = float(graph->edges(src).size());
-          float x = degree - hash(src) * kHashScale;
+          float x = HashedDegree(degree, src);
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 0x03;
 
@@ -676,12 +779,238 @@ Run(katana::PropertyGraph* pg, const std::string& output_property_name) {
   return katana::ResultSuccess();
 }
 
+
+/// Scratch space of a thread for finding the smallest free color of a node.
+/// A color is taken if its mark is the current stamp, so marks never need
+/// to be cleared.
+struct ColorMarks {
+  std::vector<uint64_t> marks;
+  uint64_t stamp{0};
+};
+
+struct ColoringAlgo {
+  struct NodeColor : public katana::PODProperty<uint32_t> {};
+
+  using NodeData = std::tuple<NodeColor>;
+  using EdgeData = std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  using Bag = katana::InsertBag<GNode>;
+
+  static constexpr uint32_t kNoColor = std::numeric_limits<uint32_t>::max();
+
+  void Initialize(Graph* graph) {
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& n) { graph->GetData<NodeColor>(n) = kNoColor; },
+        katana::no_stats());
+  }
+
+  /// Whether a is colored before b when they are neighbors
+  static bool HigherPriority(const Graph& graph, GNode a, GNode b) {
+    float priority_a = HashedDegree(graph.edges(a).size(), a);
+    float priority_b = HashedDegree(graph.edges(b).size(), b);
+    return priority_a > priority_b || (priority_a == priority_b && a < b);
+  }
+
+  /// The smallest color that no neighbor of src has
+  static uint32_t SmallestFreeColor(
+      const Graph& graph, GNode src, ColorMarks* scratch) {
+    uint64_t degree = graph.edges(src).size();
+    if (scratch->marks.size() <= degree) {
+      scratch->marks.resize(degree + 1, 0);
+    }
+    uint64_t stamp = ++scratch->stamp;
+    for (auto edge : graph.edges(src)) {
+      auto dest = graph.GetEdgeDest(edge);
+      // Uncolored neighbors have kNoColor, which is never below degree
+      uint32_t color = graph.GetData<NodeColor>(dest);
+      if (*dest != src && color <= degree) {
+        scratch->marks[color] = stamp;
+      }
+    }
+    uint32_t color = 0;
+    while (scratch->marks[color] == stamp) {
+      ++color;
+    }
+    return color;
+  }
+};
+
+/// Jones-Plassmann coloring in rounds. Each node counts its neighbors of
+/// higher priority, as OrderedPrioAlgo counts earlier neighbors; the ones
+/// without any form the independent set of the first round. The neighbor
+/// that is colored last moves a node to the next round.
+struct JonesPlassmannAlgo : public ColoringAlgo {
+  void operator()(Graph* graph) {
+    katana::LargeArray<std::atomic<uint32_t>> waiting;
+    waiting.allocateBlocked(graph->size());
+    katana::PerThreadStorage<ColorMarks> scratch;
+
+    auto cur = std::make_unique<Bag>();
+    auto next = std::make_unique<Bag>();
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          uint32_t count = 0;
+          for (auto edge : graph->edges(src)) {
+            auto dest = *graph->GetEdgeDest(edge);
+            if (dest != src && HigherPriority(*graph, dest, src)) {
+              count += 1;
+            }
+          }
+          waiting.constructAt(src, count);
+          if (count == 0) {
+            cur->push(src);
+          }
+        },
+        katana::loopname("GraphColoring-JonesPlassmann-init"),
+        katana::steal());
+
+    size_t rounds = 0;
+    while (!cur->empty()) {
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](const GNode& src) {
+            graph->GetData<NodeColor>(src) =
+                SmallestFreeColor(*graph, src, scratch.getLocal());
+            for (auto edge : graph->edges(src)) {
+              auto dest = *graph->GetEdgeDest(edge);
+              if (dest != src && HigherPriority(*graph, src, dest) &&
+                  waiting[dest].fetch_sub(1) == 1) {
+                next->push(dest);
+              }
+            }
+          },
+          katana::loopname("GraphColoring-JonesPlassmann"), katana::steal());
+
+      cur->clear();
+      std::swap(cur, next);
+      rounds += 1;
+    }
+
+    katana::ReportStatSingle(
+        "GraphColoring-JonesPlassmannAlgo", "rounds", rounds);
+  }
+};
+
+/// Speculative greedy coloring with conflict resolution. Nodes of the same
+/// round may read each other's colors while they are being chosen, so
+/// neighbors can end up with the same color; the lower priority one of them
+/// is colored again in the next round. The highest priority node of a
+/// conflict always keeps its color, so every round makes progress.
+struct SpeculativeAlgo : public ColoringAlgo {
+  template <typename R>
+  void Color(const R& range, Graph* graph, Bag* conflicts) {
+    katana::PerThreadStorage<ColorMarks> scratch;
+    katana::do_all(
+        range,
+        [&](const GNode& src) {
+          graph->GetData<NodeColor>(src) =
+              SmallestFreeColor(*graph, src, scratch.getLocal());
+        },
+        katana::loopname("GraphColoring-speculate"), katana::steal());
+
+    katana::do_all(
+        range,
+        [&](const GNode& src) {
+          uint32_t color = graph->GetData<NodeColor>(src);
+          for (auto edge : graph->edges(src)) {
+            auto dest = *graph->GetEdgeDest(edge);
+            if (dest != src && graph->GetData<NodeColor>(dest) == color &&
+                HigherPriority(*graph, dest, src)) {
+              conflicts->push(src);
+              return;
+            }
+          }
+        },
+        katana::loopname("GraphColoring-resolve"), katana::steal());
+  }
+
+  void operator()(Graph* graph) {
+    auto cur = std::make_unique<Bag>();
+    auto next = std::make_unique<Bag>();
+
+    Color(katana::iterate(*graph), graph, cur.get());
+    size_t rounds = 1;
+    while (!cur->empty()) {
+      Color(katana::iterate(*cur), graph, next.get());
+      cur->clear();
+      std::swap(cur, next);
+      rounds += 1;
+    }
+
+    katana::ReportStatSingle("GraphColoring-SpeculativeAlgo", "rounds", rounds);
+  }
+};
+
+struct IsBadColoring : public ColoringAlgo {
+  const Graph& graph_;
+
+  IsBadColoring(const Graph& g) : graph_(g) {}
+
+  bool operator()(const GNode& n) const {
+    uint32_t color = graph_.GetData<NodeColor>(n);
+    if (color > graph_.edges(n).size()) {
+      // Fail if a node is uncolored or has a color it did not need
+      return true;
+    }
+    for (auto ii : graph_.edges(n)) {
+      auto dest = graph_.GetEdgeDest(ii);
+      if (*dest != n && graph_.GetData<NodeColor>(dest) == color) {
+        // Fail if two neighbors have the same color
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+template <typename Algo>
+katana::Result<void>
+RunColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto result = ConstructNodeProperties<typename Algo::NodeData>(
+      pg, {output_property_name});
+  if (!result) {
+    return result.error();
+  }
+
+  auto pg_result = Algo::Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  typename Algo::Graph graph = pg_result.value();
+
+  Algo impl;
+
+  impl.Initialize(&graph);
+
+  katana::StatTimer exec_time("GraphColoring");
+
+  exec_time.start();
+  impl(&graph);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
 katana::analytics::IndependentSet(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     IndependentSetPlan plan) {
+  // The unordered priority algorithms read flags that other threads update
+  // in the same round; the pull algorithm only reads flags of earlier rounds
+  // and the ordered one only flags that are final
+  if (plan.deterministic() && plan.algorithm() != IndependentSetPlan::kSerial &&
+      plan.algorithm() != IndependentSetPlan::kOrderedPriority) {
+    return Run<PullAlgo>(pg, output_property_name);
+  }
   switch (plan.algorithm()) {
   case IndependentSetPlan::kSerial:
     return Run<SerialAlgo>(pg, output_property_name);
@@ -691,6 +1020,8 @@ katana::analytics::IndependentSet(
     return Run<PrioAlgo>(pg, output_property_name);
   case IndependentSetPlan::kEdgeTiledPriority:
     return Run<EdgeTiledPrioAlgo>(pg, output_property_name);
+  case IndependentSetPlan::kOrderedPriority:
+    return Run<OrderedPrioAlgo>(pg, output_property_name);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -734,3 +1065,62 @@ katana::analytics::IndependentSetStatistics::Compute(
       [&property](size_t i) { return property->Value(i); });
   return IndependentSetStatistics{uint32_t(count)};
 }
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan) {
+  if (plan.deterministic()) {
+    return RunColoring<JonesPlassmannAlgo>(pg, output_property_name);
+  }
+  switch (plan.algorithm()) {
+  case GraphColoringPlan::kJonesPlassmann:
+    return RunColoring<JonesPlassmannAlgo>(pg, output_property_name);
+  case GraphColoringPlan::kSpeculative:
+    return RunColoring<SpeculativeAlgo>(pg, output_property_name);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = IsBadColoring::Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  IsBadColoring::Graph graph = pg_result.value();
+
+  bool ok = katana::ParallelSTL::find_if(
+                graph.begin(), graph.end(), IsBadColoring(graph)) ==
+            graph.end();
+  if (!ok) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+}
+
+katana::Result<GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property_result = pg->GetNodePropertyTyped<uint32_t>(property_name);
+  if (!property_result) {
+    return property_result.error();
+  }
+  auto property = property_result.value();
+
+  katana::GReduceMax<uint32_t> max_color;
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) { max_color.update(property->Value(i)); },
+      katana::no_stats());
+  uint32_t num_colors = property->length() > 0 ? max_color.reduce() + 1 : 0;
+  return GraphColoringStatistics{num_colors};
+}
@@ -19,7 +19,9 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Intersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -42,27 +44,11 @@ public:
       : base_(base), graph_(graph) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
-    }
-    return intersection_size;
+    const katana::GraphTopology& topology =
+        graph_.GetPropertyGraph().topology();
+    auto [n2_begin, n2_end] = EdgeDestRange(topology, n2);
+    auto [base_begin, base_end] = EdgeDestRange(topology, base_);
+    return CountSortedIntersection(n2_begin, n2_end, base_begin, base_end);
   }
 };
 
@@ -110,6 +96,15 @@ JaccardImpl(
 
   IntersectAlgorithm intersect_with_base{graph, base};
 
+  // Each node reads its edge range and its neighbors, which start far from
+  // those of the previous node, so fetch them ahead of time
+  const katana::GraphTopology& topology = graph.GetPropertyGraph().topology();
+  const uint64_t* indices = topology.out_indices->raw_values();
+  const uint32_t* dests = topology.out_dests->raw_values();
+  auto prefetch_neighbors = [=](const GNode& n) {
+    katana::PrefetchRead(dests + (n > 0 ? indices[n - 1] : 0));
+  };
+
   // Compute the similarity for each node
   katana::do_all(
       katana::iterate(graph),
@@ -126,6 +121,7 @@ JaccardImpl(
         // Store the similarity back into the graph.
         n2_data = similarity;
       },
+      katana::prefetch<katana::kDefaultPrefetchDistance>(prefetch_neighbors),
       katana::loopname("Jaccard"));
 
   return katana::ResultSuccess();
@@ -0,0 +1,395 @@
+#include "katana/analytics/k_clique/k_clique.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/analytics/Intersection.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr static const unsigned kChunkSize = 64U;
+
+/// Count the cliques of remaining nodes among the candidates [begin, end),
+/// which are the common out-neighbors of the nodes chosen so far. Entry i of
+/// scratch holds the candidates of the cliques with i nodes left to choose.
+uint64_t
+CountCliques(
+    const katana::DegreeOrderedDag& dag, const uint32_t* begin,
+    const uint32_t* end, uint32_t remaining,
+    std::vector<std::vector<uint32_t>>* scratch) {
+  if (remaining == 1) {
+    return end - begin;
+  }
+  uint64_t count = 0;
+  if (remaining == 2) {
+    for (const uint32_t* it = begin; it != end; ++it) {
+      auto [v_begin, v_end] = dag.OutNeighbors(*it);
+      count += CountSortedIntersection(begin, end, v_begin, v_end);
+    }
+    return count;
+  }
+
+  uint32_t* common = (*scratch)[remaining - 1].data();
+  for (const uint32_t* it = begin; it != end; ++it) {
+    auto [v_begin, v_end] = dag.OutNeighbors(*it);
+    if (static_cast<uint64_t>(v_end - v_begin) < remaining - 1) {
+      continue;
+    }
+    size_t num = SortedIntersection(begin, end, v_begin, v_end, common);
+    if (num >= remaining - 1) {
+      count += CountCliques(dag, common, common + num, remaining - 1, scratch);
+    }
+  }
+  return count;
+}
+
+uint64_t
+OrientedListingAlgo(const katana::DegreeOrderedDag& dag, uint32_t k) {
+  katana::PerThreadStorage<std::vector<std::vector<uint32_t>>> scratch;
+  katana::GAccumulator<uint64_t> num_cliques;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, dag.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = dag.OutNeighbors(n);
+        if (static_cast<uint64_t>(end - begin) < k - 1) {
+          return;
+        }
+        // No set of candidates is larger than the out-degree of a node
+        std::vector<std::vector<uint32_t>>& local = *scratch.getLocal();
+        if (local.empty()) {
+          local.resize(k, std::vector<uint32_t>(dag.max_out_degree));
+        }
+        num_cliques += CountCliques(dag, begin, end, k - 1, &local);
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("KCliqueCount"));
+  return num_cliques.reduce();
+}
+
+/// Call sink->Emit with each clique that extends the nodes chosen[0, depth)
+/// by remaining nodes among the candidates [begin, end). Entry i of scratch
+/// holds the candidates of the cliques with i nodes left to choose.
+template <typename Sink>
+void
+ListCliques(
+    const katana::DegreeOrderedDag& dag, const uint32_t* begin,
+    const uint32_t* end, uint32_t remaining, uint32_t* chosen, uint32_t depth,
+    std::vector<std::vector<uint32_t>>* scratch, Sink* sink) {
+  if (remaining == 1) {
+    for (const uint32_t* it = begin; it != end; ++it) {
+      chosen[depth] = *it;
+      sink->Emit(chosen);
+    }
+    return;
+  }
+
+  uint32_t* common = (*scratch)[remaining - 1].data();
+  for (const uint32_t* it = begin; it != end; ++it) {
+    auto [v_begin, v_end] = dag.OutNeighbors(*it);
+    if (static_cast<uint64_t>(v_end - v_begin) < remaining - 1) {
+      continue;
+    }
+    size_t num = SortedIntersection(begin, end, v_begin, v_end, common);
+    if (num >= remaining - 1) {
+      chosen[depth] = *it;
+      ListCliques(
+          dag, common, common + num, remaining - 1, chosen, depth + 1, scratch,
+          sink);
+    }
+  }
+}
+
+struct ListingScratch {
+  std::vector<std::vector<uint32_t>> candidates;
+  std::vector<uint32_t> chosen;
+};
+
+/// List the cliques of k nodes into the sink of each thread, skipping the
+/// remaining nodes once stop is set
+template <typename Sink>
+uint64_t
+OrientedListingAlgo(
+    const katana::DegreeOrderedDag& dag, uint32_t k,
+    katana::PerThreadStorage<Sink>* sinks, const std::atomic<bool>& stop) {
+  katana::PerThreadStorage<ListingScratch> scratch;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, dag.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = dag.OutNeighbors(n);
+        if (static_cast<uint64_t>(end - begin) < k - 1 ||
+            stop.load(std::memory_order_relaxed)) {
+          return;
+        }
+        ListingScratch& local = *scratch.getLocal();
+        if (local.chosen.empty()) {
+          local.candidates.resize(k, std::vector<uint32_t>(dag.max_out_degree));
+          local.chosen.resize(k);
+        }
+        local.chosen[0] = n;
+        Sink* sink = sinks->getLocal();
+        if (k == 1) {
+          sink->Emit(local.chosen.data());
+        } else {
+          ListCliques(
+              dag, begin, end, k - 1, local.chosen.data(), 1,
+              &local.candidates, sink);
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("KCliqueList"));
+
+  uint64_t num_cliques = 0;
+  for (unsigned i = 0; i < sinks->size(); ++i) {
+    num_cliques += sinks->getRemote(i)->num_cliques();
+  }
+  return num_cliques;
+}
+
+/// Passes each clique to the callback of KCliqueList
+class CallbackSink {
+public:
+  CallbackSink(const katana::analytics::CliqueCallback* fn) : fn_(fn) {}
+
+  void Emit(const uint32_t* nodes) {
+    (*fn_)(nodes);
+    ++num_cliques_;
+  }
+
+  uint64_t num_cliques() const { return num_cliques_; }
+
+private:
+  const katana::analytics::CliqueCallback* fn_;
+  uint64_t num_cliques_{0};
+};
+
+/// The first error of the consumers of KCliqueListBatches, which stops the
+/// listing
+class BatchFailure {
+public:
+  void Set(const katana::ErrorInfo& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) {
+      error_ = katana::CopyableErrorInfo(error);
+      stop_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  const std::atomic<bool>& stop() const { return stop_; }
+
+  katana::Result<void> result() const {
+    if (!error_) {
+      return katana::ResultSuccess();
+    }
+    std::ostringstream message;
+    message << *error_;
+    return KATANA_ERROR(
+        error_->error_code(), "consuming clique batch: {}", message.str());
+  }
+
+private:
+  std::mutex mutex_;
+  std::atomic<bool> stop_{false};
+  std::optional<katana::CopyableErrorInfo> error_;
+};
+
+/// Collects the cliques of a thread into columns and hands them to the
+/// consumer of KCliqueListBatches as record batches of batch_rows rows
+class BatchSink {
+public:
+  BatchSink(
+      const std::shared_ptr<arrow::Schema>* schema, size_t batch_rows,
+      const katana::analytics::CliqueBatchCallback* consume,
+      BatchFailure* failure)
+      : schema_(schema),
+        batch_rows_(batch_rows),
+        consume_(consume),
+        failure_(failure) {}
+
+  void Emit(const uint32_t* nodes) {
+    if (columns_.empty()) {
+      columns_.resize((*schema_)->num_fields());
+      for (auto& column : columns_) {
+        column.reserve(batch_rows_);
+      }
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      columns_[i].emplace_back(nodes[i]);
+    }
+    ++num_cliques_;
+    if (columns_[0].size() == batch_rows_) {
+      Flush();
+    }
+  }
+
+  /// Hand the cliques collected so far to the consumer
+  void Flush() {
+    if (columns_.empty() || columns_[0].empty()) {
+      return;
+    }
+    if (auto r = Consume(); !r) {
+      failure_->Set(r.error());
+    }
+    for (auto& column : columns_) {
+      column.clear();
+    }
+  }
+
+  uint64_t num_cliques() const { return num_cliques_; }
+
+private:
+  katana::Result<void> Consume() {
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    for (const auto& column : columns_) {
+      arrow::UInt32Builder builder;
+      if (auto st = builder.AppendValues(column); !st.ok()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::ArrowError, "building clique batch: {}", st);
+      }
+      std::shared_ptr<arrow::Array> array;
+      if (auto st = builder.Finish(&array); !st.ok()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::ArrowError, "building clique batch: {}", st);
+      }
+      arrays.emplace_back(std::move(array));
+    }
+    return (*consume_)(arrow::RecordBatch::Make(
+        *schema_, static_cast<int64_t>(columns_[0].size()), arrays));
+  }
+
+  const std::shared_ptr<arrow::Schema>* schema_;
+  size_t batch_rows_;
+  const katana::analytics::CliqueBatchCallback* consume_;
+  BatchFailure* failure_;
+  std::vector<std::vector<uint32_t>> columns_;
+  uint64_t num_cliques_{0};
+};
+
+katana::Result<std::shared_ptr<const katana::DegreeOrderedDag>>
+OrientForCliques(
+    katana::PropertyGraph* pg, uint32_t k, const KCliquePlan& plan,
+    const char* region) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+  if (plan.algorithm() != KCliquePlan::kOrientedListing) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  katana::StatTimer timer_orient("OrientByDegree", region);
+  timer_orient.start();
+  auto dag_result = pg->OrientByDegree();
+  timer_orient.stop();
+  return dag_result;
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::KCliqueList(
+    katana::PropertyGraph* pg, uint32_t k, const CliqueCallback& fn,
+    KCliquePlan plan) {
+  auto dag_result = OrientForCliques(pg, k, plan, "KCliqueList");
+  if (!dag_result) {
+    return dag_result.error();
+  }
+
+  katana::StatTimer exec_time("KCliqueList", "KCliqueList");
+  exec_time.start();
+  katana::PerThreadStorage<CallbackSink> sinks(&fn);
+  std::atomic<bool> stop{false};
+  uint64_t num_cliques =
+      OrientedListingAlgo(*dag_result.value(), k, &sinks, stop);
+  exec_time.stop();
+
+  return num_cliques;
+}
+
+katana::Result<uint64_t>
+katana::analytics::KCliqueListBatches(
+    katana::PropertyGraph* pg, uint32_t k, const CliqueBatchCallback& consume,
+    size_t batch_rows, KCliquePlan plan) {
+  if (batch_rows == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "batch_rows must be positive");
+  }
+  auto dag_result = OrientForCliques(pg, k, plan, "KCliqueListBatches");
+  if (!dag_result) {
+    return dag_result.error();
+  }
+
+  arrow::FieldVector fields;
+  for (uint32_t i = 0; i < k; ++i) {
+    fields.emplace_back(
+        arrow::field("node" + std::to_string(i), arrow::uint32()));
+  }
+  std::shared_ptr<arrow::Schema> schema = arrow::schema(fields);
+
+  katana::StatTimer exec_time("KCliqueListBatches", "KCliqueListBatches");
+  exec_time.start();
+  BatchFailure failure;
+  katana::PerThreadStorage<BatchSink> sinks(
+      &schema, batch_rows, &consume, &failure);
+  uint64_t num_cliques =
+      OrientedListingAlgo(*dag_result.value(), k, &sinks, failure.stop());
+  for (unsigned i = 0; i < sinks.size(); ++i) {
+    if (failure.stop()) {
+      break;
+    }
+    sinks.getRemote(i)->Flush();
+  }
+  exec_time.stop();
+
+  if (auto r = failure.result(); !r) {
+    return r.error();
+  }
+  return num_cliques;
+}
+
+katana::Result<uint64_t>
+katana::analytics::KCliqueCount(
+    katana::PropertyGraph* pg, uint32_t k, KCliquePlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+  if (k == 1) {
+    return pg->num_nodes();
+  }
+
+  katana::StatTimer timer_orient("OrientByDegree", "KCliqueCount");
+  timer_orient.start();
+  auto dag_result = pg->OrientByDegree();
+  if (!dag_result) {
+    return dag_result.error();
+  }
+  const katana::DegreeOrderedDag& dag = *dag_result.value();
+  timer_orient.stop();
+
+  katana::StatTimer exec_time("KCliqueCount", "KCliqueCount");
+  exec_time.start();
+  uint64_t num_cliques = 0;
+  switch (plan.algorithm()) {
+  case KCliquePlan::kOrientedListing:
+    num_cliques = OrientedListingAlgo(dag, k);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return num_cliques;
+}
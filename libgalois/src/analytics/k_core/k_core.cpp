@@ -19,7 +19,14 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
+#include "katana/ParaMeter.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -38,6 +45,11 @@ struct KCoreNodeCurrentDegree {
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreNumber {
+  using ArrowType = arrow::CTypeTraits<uint32_t>::ArrowType;
+  using ViewType = katana::PODPropertyView<std::atomic<uint32_t>>;
+};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
@@ -49,13 +61,14 @@ typedef typename Graph::Node GNode;
  *
  * @param graph Graph to initialize degrees in
  */
+template <typename GraphTy>
 void
-DegreeCounting(Graph* graph) {
+DegreeCounting(GraphTy* graph) {
   katana::do_all(
       katana::iterate(*graph),
       [&](const GNode& node) {
         auto& node_current_degree =
-            graph->GetData<KCoreNodeCurrentDegree>(node);
+            graph->template GetData<KCoreNodeCurrentDegree>(node);
         node_current_degree.store(
             std::distance(graph->edge_begin(node), graph->edge_end(node)));
       },
@@ -87,46 +100,65 @@ SetupInitialWorklist(
 }
 
 /**
- * Starting with initial dead nodes as current worklist; decrement degree;
- * add to next worklist; switch next with current and repeat until worklist
- * is empty (i.e. no more dead nodes).
+ * Starting with initial dead nodes as current frontier; decrement degree of
+ * their neighbors; neighbors that drop below the threshold form the next
+ * frontier; repeat until the frontier is empty (i.e. no more dead nodes).
+ *
+ * Sparse rounds push decrements along the edges of the dead nodes. Dense
+ * rounds have each live node count its dead neighbors instead, which needs
+ * no atomics; since the graph is symmetric, out edges are also in edges.
  *
  * @param graph Graph to operate on
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number
  */
 void
 SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  katana::Frontier frontier(graph->num_nodes());
 
-  //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
+  //! Setup frontier.
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) {
+        if (graph->GetData<KCoreNodeCurrentDegree>(node) < k_core_number) {
+          frontier.Push(node);
+        }
+      },
+      katana::loopname("InitialWorklistSetup"), katana::no_stats());
 
-  while (!next->empty()) {
-    //! Make "next" into current.
-    std::swap(current, next);
-    next->clear();
+  katana::SynchronousPushPullFrontierLoop(
+      *graph, &frontier,
+      [&](GNode, Graph::Edge e, katana::Frontier* next) {
+        auto dest = *graph->GetEdgeDest(e);
+        auto& dest_current_degree =
+            graph->GetData<KCoreNodeCurrentDegree>(dest);
+        uint32_t old_degree = katana::atomicSub(dest_current_degree, 1u);
+
+        if (old_degree == k_core_number) {
+          //! This thread was responsible for putting degree of destination
+          //! below threshold; add to frontier.
+          next->Push(dest);
+        }
+      },
+      [&](GNode node, const katana::Frontier& dead, katana::Frontier* next) {
+        auto& node_current_degree =
+            graph->GetData<KCoreNodeCurrentDegree>(node);
+        uint32_t old_degree = node_current_degree.load();
+        if (old_degree < k_core_number) {
+          return;
+        }
 
-    katana::do_all(
-        katana::iterate(*current),
-        [&](const GNode& dead_node) {
-          //! Decrement degree of all neighbors.
-          for (auto e : graph->edges(dead_node)) {
-            auto dest = graph->GetEdgeDest(e);
-            auto& dest_current_degree =
-                graph->GetData<KCoreNodeCurrentDegree>(dest);
-            uint32_t old_degree = katana::atomicSub(dest_current_degree, 1u);
-
-            if (old_degree == k_core_number) {
-              //! This thread was responsible for putting degree of destination
-              //! below threshold; add to worklist.
-              next->emplace(*dest);
-            }
+        uint32_t num_dead = 0;
+        for (auto e : graph->edges(node)) {
+          if (dead.Contains(*graph->GetEdgeDest(e))) {
+            ++num_dead;
           }
-        },
-        katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
-        katana::loopname("KCore Synchronous"));
-  }
+        }
+        node_current_degree.store(old_degree - num_dead);
+        if (old_degree - num_dead < k_core_number) {
+          next->Push(node);
+        }
+      },
+      katana::kDefaultFrontierEdgeTileSize, "KCore Synchronous");
 }
 
 /**
@@ -221,13 +253,14 @@ KCoreImpl(
   }
   exec_time.stop();
 
-  return katana::ResultSuccess();
+  return CheckCancelled();
 }
 
 katana::Result<void>
 katana::analytics::KCore(
     katana::PropertyGraph* pg, uint32_t k_core_number,
     const std::string& output_property_name, KCorePlan algo) {
+  katana::parameter::ProfileScope profile(algo.profile_parallelism());
   katana::analytics::TemporaryPropertyGuard temporary_property{pg};
   if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
           pg, {temporary_property.name()});
@@ -262,6 +295,263 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+using DecompositionGraph = katana::TypedPropertyGraph<
+    std::tuple<KCoreNodeCoreNumber, KCoreNodeCurrentDegree>, std::tuple<>>;
+
+constexpr uint32_t kNoCoreNumber = std::numeric_limits<uint32_t>::max();
+
+/// Only the kNumOpenBuckets degrees from the start of the current window
+/// have buckets. Nodes of higher degree are only kept in the set of
+/// remaining nodes, which is scanned again once the window is used up.
+constexpr uint32_t kNumOpenBuckets = 128;
+
+/**
+ * Peel the graph in increasing order of core number. Nodes are kept in
+ * buckets by their current degree; a node is pushed to a new bucket every
+ * time its degree drops, and the entries left behind in higher buckets are
+ * skipped once the node is peeled. Peeling the nodes of degree k can drop
+ * the degree of their neighbors to k, so each level is peeled in rounds
+ * until no node of degree k is left.
+ *
+ * Degrees are not decremented below the current level, so when a node is
+ * peeled its degree is its core number.
+ *
+ * @param graph Graph to operate on
+ */
+void
+BucketedKCoreDecomposition(DecompositionGraph* graph) {
+  using Bag = katana::InsertBag<GNode>;
+  auto core_number = [&](GNode n) -> std::atomic<uint32_t>& {
+    return graph->GetData<KCoreNodeCoreNumber>(n);
+  };
+  auto degree = [&](GNode n) -> std::atomic<uint32_t>& {
+    return graph->GetData<KCoreNodeCurrentDegree>(n);
+  };
+
+  auto remaining = std::make_unique<Bag>();
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) {
+        core_number(node).store(kNoCoreNumber);
+        remaining->push(node);
+      },
+      katana::no_stats());
+
+  std::vector<Bag> buckets(kNumOpenBuckets);
+  uint64_t num_remaining = graph->num_nodes();
+  uint32_t level = 0;
+  uint32_t window_begin = 0;
+
+  // Drop peeled nodes from remaining, jump to the lowest remaining degree
+  // and bucket the nodes with degrees in the new window
+  auto open_window = [&]() {
+    auto unpeeled = std::make_unique<Bag>();
+    katana::GReduceMin<uint32_t> min_degree;
+    katana::GAccumulator<uint64_t> count;
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const GNode& node) {
+          if (core_number(node).load() == kNoCoreNumber) {
+            unpeeled->push(node);
+            min_degree.update(degree(node).load());
+            count += 1;
+          }
+        },
+        katana::no_stats());
+    remaining = std::move(unpeeled);
+    num_remaining = count.reduce();
+    if (num_remaining == 0) {
+      return;
+    }
+
+    level = std::max(level, min_degree.reduce());
+    window_begin = level;
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const GNode& node) {
+          uint32_t slot = degree(node).load() - window_begin;
+          if (slot < kNumOpenBuckets) {
+            buckets[slot].push(node);
+          }
+        },
+        katana::no_stats());
+  };
+
+  open_window();
+  auto current = std::make_unique<Bag>();
+  auto next = std::make_unique<Bag>();
+  while (num_remaining > 0 && !katana::CancelRequested()) {
+    current->swap(buckets[level - window_begin]);
+    katana::GAccumulator<uint64_t> peeled;
+    while (!current->empty()) {
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const GNode& node) {
+            uint32_t expected = kNoCoreNumber;
+            if (!core_number(node).compare_exchange_strong(expected, level)) {
+              //! Already peeled through another entry.
+              return;
+            }
+            peeled += 1;
+            for (auto e : graph->edges(node)) {
+              auto dest = *graph->GetEdgeDest(e);
+              auto& dest_degree = degree(dest);
+              uint32_t old_degree = dest_degree.load();
+              while (old_degree > level && !dest_degree.compare_exchange_weak(
+                                               old_degree, old_degree - 1)) {
+              }
+              if (old_degree <= level) {
+                continue;
+              }
+              uint32_t slot = old_degree - 1 - window_begin;
+              if (old_degree - 1 == level) {
+                next->push(dest);
+              } else if (slot < kNumOpenBuckets) {
+                buckets[slot].push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+          katana::loopname("KCore Decomposition"));
+      current->clear();
+      std::swap(current, next);
+    }
+    num_remaining -= peeled.reduce();
+
+    level += 1;
+    if (level - window_begin == kNumOpenBuckets) {
+      open_window();
+    }
+  }
+}
+
+/**
+ * Lower an estimate of the core number of each node, starting from its
+ * degree, to the h-index of the estimates of its neighbors: the largest h
+ * such that at least h neighbors have an estimate of at least h. The
+ * estimates converge to the core numbers whatever the order of the updates
+ * (Montresor et al., 2013), so levels need not be peeled one at a time. A
+ * node is updated again whenever a neighbor that it was counted for drops
+ * below it. Nodes with lower estimates are scheduled first, as in peeling,
+ * but on an adaptive priority worklist so the number of distinct estimates
+ * being worked on at a time is not fixed.
+ *
+ * @param graph Graph to operate on
+ */
+void
+AsyncKCoreDecomposition(DecompositionGraph* graph) {
+  auto estimate = [&](GNode n) -> std::atomic<uint32_t>& {
+    return graph->GetData<KCoreNodeCoreNumber>(n);
+  };
+
+  struct Indexer {
+    DecompositionGraph* graph;
+    uint32_t operator()(const GNode& n) const {
+      return graph->GetData<KCoreNodeCoreNumber>(n).load(
+          std::memory_order_relaxed);
+    }
+  };
+  using WL = katana::AdaptiveOrderedByIntegerMetric<
+      Indexer, katana::PerSocketChunkFIFO<KCorePlan::kChunkSize>>;
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) {
+        estimate(node).store(
+            graph->GetData<KCoreNodeCurrentDegree>(node).load());
+      },
+      katana::no_stats());
+
+  katana::PerThreadStorage<std::vector<uint32_t>> counts;
+  katana::GAccumulator<uint64_t> updates;
+  katana::for_each(
+      katana::iterate(*graph),
+      [&](const GNode& node, auto& ctx) {
+        uint32_t old_estimate = estimate(node).load();
+        if (old_estimate == 0) {
+          return;
+        }
+
+        //! count[i] is the number of neighbors whose estimate, capped at
+        //! old_estimate, is i.
+        std::vector<uint32_t>& count = *counts.getLocal();
+        count.assign(old_estimate + 1, 0);
+        for (auto e : graph->edges(node)) {
+          uint32_t dest_estimate = estimate(*graph->GetEdgeDest(e)).load();
+          count[std::min(dest_estimate, old_estimate)] += 1;
+        }
+        uint32_t h = old_estimate;
+        for (uint32_t at_least = count[h]; at_least < h;) {
+          h -= 1;
+          at_least += count[h];
+        }
+
+        uint32_t previous = katana::atomicMin(estimate(node), h);
+        if (previous <= h) {
+          return;
+        }
+        updates += 1;
+        for (auto e : graph->edges(node)) {
+          auto dest = *graph->GetEdgeDest(e);
+          uint32_t dest_estimate = estimate(dest).load();
+          if (h < dest_estimate && dest_estimate <= previous) {
+            ctx.push(dest);
+          }
+        }
+      },
+      katana::wl<WL>(Indexer{graph}, 0, "KCoreDecomposition-Asynchronous"),
+      katana::disable_conflict_detection(),
+      katana::loopname("KCore Asynchronous Decomposition"));
+
+  katana::ReportStatSingle(
+      "KCoreDecomposition-Asynchronous", "Updates", updates.reduce());
+}
+
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    KCorePlan plan) {
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+  if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
+          pg, {temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+  if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCoreNumber>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = DecompositionGraph::Make(
+      pg, {output_property_name, temporary_property.name()}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  DegreeCounting(&graph);
+
+  katana::StatTimer exec_time("KCoreDecomposition");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case KCorePlan::kSynchronous:
+    BucketedKCoreDecomposition(&graph);
+    break;
+  case KCorePlan::kAsynchronous:
+    AsyncKCoreDecomposition(&graph);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return CheckCancelled();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -274,6 +564,78 @@ katana::analytics::KCoreAssertValid(
   return katana::ResultSuccess();
 }
 
+/// Check the core numbers against a serial run of
+///
+///   Vladimir Batagelj and Matjaz Zaversnik. An O(m) Algorithm for Cores
+///   Decomposition of Networks. 2003.
+katana::Result<void>
+katana::analytics::KCoreDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = katana::TypedPropertyGraph<
+      std::tuple<KCoreNodeCoreNumber>, std::tuple<>>::
+      Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  uint32_t num_nodes = graph.num_nodes();
+
+  // Sort the nodes by degree with a counting sort, then peel them in that
+  // order, moving each neighbor whose degree drops one bin down
+  std::vector<uint32_t> degree(num_nodes);
+  uint32_t max_degree = 0;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    degree[n] = std::distance(graph.edge_begin(n), graph.edge_end(n));
+    max_degree = std::max(max_degree, degree[n]);
+  }
+  std::vector<uint32_t> bin(max_degree + 2);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    bin[degree[n] + 1] += 1;
+  }
+  for (uint32_t d = 1; d < bin.size(); ++d) {
+    bin[d] += bin[d - 1];
+  }
+  std::vector<uint32_t> order(num_nodes);
+  std::vector<uint32_t> position(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    position[n] = bin[degree[n]]++;
+    order[position[n]] = n;
+  }
+  for (uint32_t d = max_degree + 1; d > 0; --d) {
+    bin[d] = bin[d - 1];
+  }
+  bin[0] = 0;
+
+  for (uint32_t i = 0; i < num_nodes; ++i) {
+    uint32_t n = order[i];
+    for (auto e : graph.edges(n)) {
+      uint32_t dest = *graph.GetEdgeDest(e);
+      if (degree[dest] <= degree[n]) {
+        continue;
+      }
+      // Swap dest with the first node of its bin and shrink the bin
+      uint32_t first = order[bin[degree[dest]]];
+      if (first != dest) {
+        std::swap(order[position[dest]], order[bin[degree[dest]]]);
+        std::swap(position[dest], position[first]);
+      }
+      bin[degree[dest]] += 1;
+      degree[dest] -= 1;
+    }
+  }
+
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t core_number = graph.GetData<KCoreNodeCoreNumber>(n).load();
+    if (core_number != degree[n]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} has core number {} instead of {}", n, core_number,
+          degree[n]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<KCoreStatistics>
 katana::analytics::KCoreStatistics::Compute(
     katana::PropertyGraph* pg, [[maybe_unused]] uint32_t k_core_number,
@@ -301,6 +663,40 @@ katana::analytics::KCoreStatistics::Compute(
 
   return KCoreStatistics{alive_nodes.reduce()};
 }
+
+katana::Result<KCoreDecompositionStatistics>
+katana::analytics::KCoreDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = katana::TypedPropertyGraph<
+      std::tuple<KCoreNodeCoreNumber>, std::tuple<>>::
+      Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::GReduceMax<uint32_t> max_core_number;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        max_core_number.update(
+            graph.GetData<KCoreNodeCoreNumber>(node).load());
+      },
+      katana::no_stats());
+  uint32_t degeneracy = graph.empty() ? 0 : max_core_number.reduce();
+
+  katana::GAccumulator<uint64_t> nodes_in_max_core;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        if (graph.GetData<KCoreNodeCoreNumber>(node).load() == degeneracy) {
+          nodes_in_max_core += 1;
+        }
+      },
+      katana::no_stats());
+
+  return KCoreDecompositionStatistics{degeneracy, nodes_in_max_core.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
@@ -308,3 +704,10 @@ katana::analytics::KCoreStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_nodes_in_kcore
      << std::endl;
 }
+
+void
+katana::analytics::KCoreDecompositionStatistics::Print(std::ostream& os) const {
+  os << "Maximum core number = " << max_core_number << std::endl;
+  os << "Number of nodes in the maximum core = " << nodes_in_max_core
+     << std::endl;
+}
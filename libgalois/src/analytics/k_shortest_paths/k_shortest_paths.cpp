@@ -0,0 +1,628 @@
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <optional>
+#include <queue>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+template <typename Weight>
+using EdgeWeight = katana::PODProperty<Weight>;
+
+template <typename Weight>
+using Graph =
+    katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeWeight<Weight>>>;
+
+using PathLists = std::vector<std::vector<WeightedPath>>;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+/// Call fn with a value of the C type of the edge property named
+/// edge_weight_property_name, or fail if it is not a number.
+template <typename Fn>
+auto
+DispatchWeightType(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name, const Fn& fn)
+    -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "edge weights of type {} are not numbers",
+        property->type()->ToString());
+  }
+}
+
+/// The edge weights of a graph and what the searches need to know about its
+/// topology
+template <typename Weight>
+class WeightedTopology {
+public:
+  WeightedTopology(const katana::GraphTopology& topology, const Weight* weight)
+      : topology_(topology), weight_(weight) {}
+
+  Node num_nodes() const { return topology_.num_nodes(); }
+
+  template <typename Fn>
+  void ForEachEdge(Node n, const Fn& fn) const {
+    for (Edge e : topology_.edges(n)) {
+      fn(topology_.edge_dest(e), weight_[e]);
+    }
+  }
+
+  const katana::GraphTopology& topology() const { return topology_; }
+  const Weight* weight() const { return weight_; }
+
+private:
+  const katana::GraphTopology& topology_;
+  const Weight* weight_;
+};
+
+/// A path being built: its nodes and the distance from the first node to
+/// each of them.
+template <typename Weight>
+struct PartialPath {
+  std::vector<Node> nodes;
+  std::vector<Weight> distances;
+
+  Weight weight() const { return distances.back(); }
+
+  WeightedPath ToWeightedPath() const {
+    return WeightedPath{
+        std::vector<uint32_t>(nodes.begin(), nodes.end()),
+        static_cast<double>(weight())};
+  }
+};
+
+/// Shortest path tree from one source. Distances come from delta stepping;
+/// the tree is then grown from the source along edges on shortest paths,
+/// which, unlike recording parents while relaxing, cannot form cycles of
+/// zero weight edges.
+template <typename Weight>
+class ShortestPathTree {
+  struct UpdateRequest {
+    Node node;
+    Weight distance;
+  };
+
+  struct UpdateRequestIndexer {
+    unsigned shift;
+
+    unsigned int operator()(const UpdateRequest& req) const {
+      auto bucket = static_cast<uint64_t>(req.distance) >> shift;
+      return static_cast<unsigned int>(std::min<uint64_t>(
+          bucket, std::numeric_limits<unsigned int>::max()));
+    }
+  };
+
+  using OBIM = katana::OrderedByIntegerMetric<
+      UpdateRequestIndexer, katana::PerSocketChunkFIFO<64>>;
+
+public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  ShortestPathTree(const WeightedTopology<Weight>& graph, unsigned delta_shift)
+      : graph_(graph),
+        delta_shift_(delta_shift),
+        distance_(graph.num_nodes()),
+        parent_(graph.num_nodes()) {}
+
+  void Compute(Node source) {
+    katana::do_all(
+        katana::iterate(Node{0}, graph_.num_nodes()),
+        [&](Node n) {
+          distance_[n].store(kInfinity, std::memory_order_relaxed);
+          parent_[n] = kNoNode;
+        },
+        katana::no_stats());
+
+    distance_[source] = 0;
+    katana::InsertBag<UpdateRequest> init_bag;
+    init_bag.push(UpdateRequest{source, 0});
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const UpdateRequest& item, auto& ctx) {
+          if (distance_[item.node].load(std::memory_order_relaxed) <
+              item.distance) {
+            return;
+          }
+          graph_.ForEachEdge(item.node, [&](Node dest, Weight w) {
+            Weight new_distance = item.distance + w;
+            if (new_distance <
+                katana::atomicMin(distance_[dest], new_distance)) {
+              ctx.push(UpdateRequest{dest, new_distance});
+            }
+          });
+        },
+        katana::wl<OBIM>(UpdateRequestIndexer{delta_shift_}),
+        katana::disable_conflict_detection(),
+        katana::loopname("KShortestPaths-Tree"));
+
+    parent_[source] = source;
+    katana::InsertBag<Node> frontier;
+    frontier.push(source);
+    while (!frontier.empty()) {
+      katana::InsertBag<Node> next;
+      katana::do_all(
+          katana::iterate(frontier),
+          [&](Node n) {
+            Weight d = distance(n);
+            graph_.ForEachEdge(n, [&](Node dest, Weight w) {
+              if (d + w == distance(dest) &&
+                  __sync_bool_compare_and_swap(&parent_[dest], kNoNode, n)) {
+                next.push(dest);
+              }
+            });
+          },
+          katana::steal(), katana::loopname("KShortestPaths-TreeParents"));
+      frontier.swap(next);
+    }
+  }
+
+  bool Reached(Node n) const { return parent_[n] != kNoNode; }
+
+  /// The path in the tree from the source to target, which must be reached
+  PartialPath<Weight> PathTo(Node target) const {
+    PartialPath<Weight> path;
+    for (Node n = target;; n = parent_[n]) {
+      path.nodes.emplace_back(n);
+      path.distances.emplace_back(distance(n));
+      if (parent_[n] == n) {
+        break;
+      }
+    }
+    std::reverse(path.nodes.begin(), path.nodes.end());
+    std::reverse(path.distances.begin(), path.distances.end());
+    return path;
+  }
+
+private:
+  Weight distance(Node n) const {
+    return distance_[n].load(std::memory_order_relaxed);
+  }
+
+  const WeightedTopology<Weight>& graph_;
+  unsigned delta_shift_;
+  std::vector<std::atomic<Weight>> distance_;
+  std::vector<Node> parent_;
+};
+
+/// Serial Dijkstra from source to target that does not visit banned_nodes
+/// and does not take an edge from source to banned_next. Returns the path,
+/// with distances starting at offset, if there is one.
+template <typename Weight>
+std::optional<PartialPath<Weight>>
+SpurPath(
+    const WeightedTopology<Weight>& graph, Node source, Node target,
+    Weight offset, const std::unordered_set<Node>& banned_nodes,
+    const std::unordered_set<Node>& banned_next) {
+  using Entry = std::pair<Weight, Node>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  std::unordered_map<Node, std::pair<Weight, Node>> reached;
+  std::unordered_set<Node> settled;
+
+  reached[source] = {0, source};
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (!settled.insert(n).second) {
+      continue;
+    }
+    if (n == target) {
+      PartialPath<Weight> path;
+      for (Node m = target;; m = reached[m].second) {
+        path.nodes.emplace_back(m);
+        path.distances.emplace_back(offset + reached[m].first);
+        if (m == source) {
+          break;
+        }
+      }
+      std::reverse(path.nodes.begin(), path.nodes.end());
+      std::reverse(path.distances.begin(), path.distances.end());
+      return path;
+    }
+    graph.ForEachEdge(n, [&](Node dest, Weight w) {
+      if (banned_nodes.count(dest) ||
+          (n == source && banned_next.count(dest)) || settled.count(dest)) {
+        return;
+      }
+      Weight new_distance = d + w;
+      auto it = reached.find(dest);
+      if (it == reached.end() || new_distance < it->second.first) {
+        reached[dest] = {new_distance, n};
+        queue.emplace(new_distance, dest);
+      }
+    });
+  }
+  return std::nullopt;
+}
+
+/// The state of Yen's algorithm for one query
+template <typename Weight>
+struct YenQuery {
+  Node target;
+  /// Paths found so far, and for each the index of the node where it
+  /// leaves the path it was found from
+  std::vector<PartialPath<Weight>> paths;
+  std::vector<size_t> deviations;
+  /// Candidates for the next path, by weight and then by nodes
+  std::map<
+      std::pair<Weight, std::vector<Node>>,
+      std::pair<PartialPath<Weight>, size_t>>
+      candidates;
+  std::set<std::vector<Node>> seen;
+  bool done{false};
+};
+
+/// One spur path computation: the spur path of query at node index
+/// spur_index of its last path
+struct SpurTask {
+  size_t query;
+  size_t spur_index;
+};
+
+template <typename Weight>
+katana::Result<void>
+CheckWeights(const WeightedTopology<Weight>& graph) {
+  if constexpr (std::is_signed_v<Weight> || std::is_floating_point_v<Weight>) {
+    katana::GReduceLogicalOr negative;
+    const Weight* weight = graph.weight();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph.topology().num_edges()),
+        [&](uint64_t e) { negative.update(weight[e] < 0); },
+        katana::no_stats());
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights must not be negative");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckQueries(
+    const katana::PropertyGraph& pg, const std::vector<PathQuery>& queries) {
+  for (const auto& [source, target] : queries) {
+    if (source >= pg.num_nodes() || target >= pg.num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query ({}, {}) is not a pair of nodes of a graph of {} nodes",
+          source, target, pg.num_nodes());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Group the indices of queries by source
+std::map<Node, std::vector<size_t>>
+QueriesBySource(const std::vector<PathQuery>& queries) {
+  std::map<Node, std::vector<size_t>> by_source;
+  for (size_t i = 0; i < queries.size(); ++i) {
+    by_source[queries[i].first].emplace_back(i);
+  }
+  return by_source;
+}
+
+template <typename Weight>
+katana::Result<PathLists>
+KShortestSimplePathsImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k,
+    const KShortestPathsPlan& plan) {
+  auto pg_result = Graph<Weight>::Make(pg, {}, {edge_weight_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto typed_graph = pg_result.value();
+  WeightedTopology<Weight> graph(
+      pg->topology(),
+      typed_graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data());
+  if (auto r = CheckWeights(graph); !r) {
+    return r.error();
+  }
+
+  katana::StatTimer exec_time("KShortestSimplePaths");
+  exec_time.start();
+
+  std::vector<YenQuery<Weight>> states(queries.size());
+  {
+    ShortestPathTree<Weight> tree(graph, plan.delta_shift());
+    for (const auto& [source, indices] : QueriesBySource(queries)) {
+      tree.Compute(source);
+      for (size_t i : indices) {
+        YenQuery<Weight>& state = states[i];
+        state.target = queries[i].second;
+        if (k == 0 || !tree.Reached(state.target)) {
+          state.done = true;
+          continue;
+        }
+        state.paths.emplace_back(tree.PathTo(state.target));
+        state.deviations.emplace_back(0);
+        state.seen.insert(state.paths.back().nodes);
+      }
+    }
+  }
+
+  // Each round finds one more path of every query that needs one. The spur
+  // paths of all of them are independent, so they are found in one parallel
+  // loop. As in Lawler's refinement of Yen's algorithm, a path only needs
+  // spur paths from where it left the path it was found from.
+  while (true) {
+    std::vector<SpurTask> tasks;
+    for (size_t q = 0; q < states.size(); ++q) {
+      YenQuery<Weight>& state = states[q];
+      if (state.done || state.paths.size() >= k) {
+        state.done = true;
+        continue;
+      }
+      const PartialPath<Weight>& last = state.paths.back();
+      for (size_t i = state.deviations.back(); i + 1 < last.nodes.size(); ++i) {
+        tasks.emplace_back(SpurTask{q, i});
+      }
+    }
+    if (tasks.empty() &&
+        std::all_of(states.begin(), states.end(), [](const auto& s) {
+          return s.done || s.candidates.empty();
+        })) {
+      break;
+    }
+
+    std::vector<std::optional<PartialPath<Weight>>> spurs(tasks.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, tasks.size()),
+        [&](size_t t) {
+          const YenQuery<Weight>& state = states[tasks[t].query];
+          const PartialPath<Weight>& last = state.paths.back();
+          size_t i = tasks[t].spur_index;
+
+          std::unordered_set<Node> banned_nodes(
+              last.nodes.begin(), last.nodes.begin() + i);
+          std::unordered_set<Node> banned_next;
+          for (const auto& path : state.paths) {
+            if (path.nodes.size() > i + 1 &&
+                std::equal(
+                    path.nodes.begin(), path.nodes.begin() + i + 1,
+                    last.nodes.begin())) {
+              banned_next.insert(path.nodes[i + 1]);
+            }
+          }
+
+          auto spur = SpurPath(
+              graph, last.nodes[i], state.target, last.distances[i],
+              banned_nodes, banned_next);
+          if (!spur) {
+            return;
+          }
+          PartialPath<Weight> candidate;
+          candidate.nodes.assign(last.nodes.begin(), last.nodes.begin() + i);
+          candidate.distances.assign(
+              last.distances.begin(), last.distances.begin() + i);
+          candidate.nodes.insert(
+              candidate.nodes.end(), spur->nodes.begin(), spur->nodes.end());
+          candidate.distances.insert(
+              candidate.distances.end(), spur->distances.begin(),
+              spur->distances.end());
+          spurs[t] = std::move(candidate);
+        },
+        katana::steal(), katana::loopname("KShortestSimplePaths-Spur"));
+
+    for (size_t t = 0; t < tasks.size(); ++t) {
+      if (!spurs[t]) {
+        continue;
+      }
+      YenQuery<Weight>& state = states[tasks[t].query];
+      if (!state.seen.insert(spurs[t]->nodes).second) {
+        continue;
+      }
+      auto key = std::make_pair(spurs[t]->weight(), spurs[t]->nodes);
+      state.candidates.emplace(
+          std::move(key),
+          std::make_pair(std::move(*spurs[t]), tasks[t].spur_index));
+    }
+
+    for (YenQuery<Weight>& state : states) {
+      if (state.done) {
+        continue;
+      }
+      if (state.candidates.empty()) {
+        state.done = true;
+        continue;
+      }
+      auto best = state.candidates.begin();
+      state.paths.emplace_back(std::move(best->second.first));
+      state.deviations.emplace_back(best->second.second);
+      state.candidates.erase(best);
+    }
+  }
+
+  exec_time.stop();
+
+  PathLists result(queries.size());
+  for (size_t q = 0; q < states.size(); ++q) {
+    for (const auto& path : states[q].paths) {
+      result[q].emplace_back(path.ToWeightedPath());
+    }
+  }
+  return result;
+}
+
+/// Settle nodes from source in order of distance, each up to k times, until
+/// every target has been settled k times. The paths that settle a node are
+/// its k shortest paths.
+template <typename Weight>
+void
+KShortestWalks(
+    const WeightedTopology<Weight>& graph, Node source,
+    const std::vector<PathQuery>& queries, const std::vector<size_t>& indices,
+    uint32_t k, PathLists* result) {
+  struct Label {
+    Node node;
+    Weight distance;
+    size_t previous;
+  };
+  constexpr size_t kNoLabel = std::numeric_limits<size_t>::max();
+
+  std::unordered_map<Node, std::vector<size_t>> queries_of_target;
+  for (size_t i : indices) {
+    queries_of_target[queries[i].second].emplace_back(i);
+  }
+  size_t unfinished_targets = queries_of_target.size();
+
+  std::vector<Label> labels;
+  std::unordered_map<Node, uint32_t> settled;
+  using Entry = std::pair<Weight, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+  labels.emplace_back(Label{source, 0, kNoLabel});
+  queue.emplace(0, 0);
+  while (!queue.empty() && unfinished_targets > 0) {
+    size_t l = queue.top().second;
+    queue.pop();
+    Label label = labels[l];
+    uint32_t& times = settled[label.node];
+    if (times >= k) {
+      continue;
+    }
+    ++times;
+
+    if (auto it = queries_of_target.find(label.node);
+        it != queries_of_target.end()) {
+      WeightedPath path{{}, static_cast<double>(label.distance)};
+      for (size_t m = l; m != kNoLabel; m = labels[m].previous) {
+        path.nodes.emplace_back(labels[m].node);
+      }
+      std::reverse(path.nodes.begin(), path.nodes.end());
+      for (size_t i : it->second) {
+        (*result)[i].emplace_back(path);
+      }
+      if (times == k) {
+        --unfinished_targets;
+      }
+    }
+
+    graph.ForEachEdge(label.node, [&](Node dest, Weight w) {
+      auto it = settled.find(dest);
+      if (it != settled.end() && it->second >= k) {
+        return;
+      }
+      labels.emplace_back(Label{dest, label.distance + w, l});
+      queue.emplace(label.distance + w, labels.size() - 1);
+    });
+  }
+}
+
+template <typename Weight>
+katana::Result<PathLists>
+KShortestPathsImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k) {
+  auto pg_result = Graph<Weight>::Make(pg, {}, {edge_weight_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto typed_graph = pg_result.value();
+  WeightedTopology<Weight> graph(
+      pg->topology(),
+      typed_graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data());
+  if (auto r = CheckWeights(graph); !r) {
+    return r.error();
+  }
+
+  PathLists result(queries.size());
+  if (k == 0) {
+    return result;
+  }
+
+  katana::StatTimer exec_time("KShortestPaths");
+  exec_time.start();
+
+  auto by_source = QueriesBySource(queries);
+  std::vector<std::pair<Node, std::vector<size_t>>> groups(
+      by_source.begin(), by_source.end());
+  katana::do_all(
+      katana::iterate(size_t{0}, groups.size()),
+      [&](size_t g) {
+        KShortestWalks(
+            graph, groups[g].first, queries, groups[g].second, k, &result);
+      },
+      katana::steal(), katana::loopname("KShortestPaths"));
+
+  exec_time.stop();
+  return result;
+}
+
+}  // namespace
+
+katana::Result<PathLists>
+katana::analytics::KShortestPaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckQueries(*pg, queries); !r) {
+    return r.error();
+  }
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<PathLists> {
+        return KShortestPathsImpl<decltype(zero)>(
+            pg, edge_weight_property_name, queries, k);
+      });
+}
+
+katana::Result<PathLists>
+katana::analytics::KShortestSimplePaths(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<PathQuery>& queries, uint32_t k,
+    KShortestPathsPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckQueries(*pg, queries); !r) {
+    return r.error();
+  }
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<PathLists> {
+        return KShortestSimplePathsImpl<decltype(zero)>(
+            pg, edge_weight_property_name, queries, k, plan);
+      });
+}
@@ -19,8 +19,14 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/DynamicBitset.h"
+#include "katana/LargeArray.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Intersection.h"
 
 using namespace katana::analytics;
 
@@ -92,6 +98,15 @@ IsValidDegreeNoLessThanJ(const Graph& g, GNode n, unsigned int j) {
  */
 bool
 IsSupportNoLessThanJ(const Graph& g, GNode src, GNode dest, unsigned int j) {
+  // Removed edges can only lower the support, so the common neighbors of src
+  // and dest, counted without looking at edge flags, bound it from above
+  const katana::GraphTopology& topology = g.GetPropertyGraph().topology();
+  auto [src_begin, src_end] = EdgeDestRange(topology, src);
+  auto [dst_begin, dst_end] = EdgeDestRange(topology, dest);
+  if (CountSortedIntersection(src_begin, src_end, dst_begin, dst_end) < j) {
+    return false;
+  }
+
   size_t numValidEqual = 0;
   auto srcI = g.edge_begin(src), srcE = g.edge_end(src),
        dstI = g.edge_begin(dest), dstE = g.edge_end(dest);
@@ -336,6 +351,222 @@ BSPCoreThenTrussAlgo(Graph* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+/// An edge (src, dest) with src < dest. edge is the copy in the edge list of
+/// src.
+struct TrussEdge {
+  GNode src;
+  GNode dest;
+  katana::GraphTopology::Edge edge;
+};
+
+using TrussEdgeVec = katana::InsertBag<TrussEdge>;
+
+/**
+ * Edge-centric truss peeling. The support of an edge, the number of
+ * triangles it is in, is counted once and kept on the copy of the edge in
+ * the edge list of its smaller endpoint. Removing an edge only decrements
+ * the support of the other edges of its triangles.
+ *
+ * Removed edges are marked in a bitset over all edge ids. Both copies of an
+ * edge are marked, so either endpoint can test an edge without a search.
+ */
+class TrussPeeling {
+public:
+  using Edge = katana::GraphTopology::Edge;
+
+  explicit TrussPeeling(const katana::GraphTopology& topology)
+      : topology_(topology), dests_(topology.out_dests->raw_values()) {
+    support_.allocateInterleaved(topology.num_edges());
+    removed_.resize(topology.num_edges());
+    peeling_.resize(topology.num_edges());
+  }
+
+  /// Count the support of every edge and add each edge to edges.
+  void CountSupport(TrussEdgeVec* edges) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology_.num_nodes()),
+        [&](GNode src) {
+          auto [src_begin, src_end] = EdgeDestRange(topology_, src);
+          for (const uint32_t* d = src_begin; d != src_end; ++d) {
+            if (*d <= src) {
+              continue;
+            }
+            auto [dest_begin, dest_end] = EdgeDestRange(topology_, *d);
+            Edge edge = d - dests_;
+            support_[edge].store(
+                CountSortedIntersection(
+                    src_begin, src_end, dest_begin, dest_end),
+                std::memory_order_relaxed);
+            edges->push(TrussEdge{src, *d, edge});
+          }
+        },
+        katana::steal(), katana::loopname("KTruss Support"));
+  }
+
+  /**
+   * Remove the edges of frontier, and in later rounds every edge whose
+   * support drops to level or below as a result. The support of an edge is
+   * never decremented below level. frontier is empty on return.
+   *
+   * @param frontier edges with support at most level that are not removed
+   * @param level the largest support of an edge that is removed
+   * @param on_remove called with each removed edge and the id of its other
+   * copy
+   */
+  template <typename RemoveFn>
+  void Peel(TrussEdgeVec* frontier, uint32_t level, const RemoveFn& on_remove) {
+    TrussEdgeVec next;
+    while (!frontier->empty()) {
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](const TrussEdge& e) {
+            peeling_.set(e.edge);
+            peeling_.set(FindEdge(e.dest, e.src));
+          },
+          katana::no_stats());
+
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](const TrussEdge& e) { RemoveTriangles(e, level, &next); },
+          katana::steal(), katana::loopname("KTruss Peeling"));
+
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](const TrussEdge& e) {
+            Edge reverse = FindEdge(e.dest, e.src);
+            removed_.set(e.edge);
+            removed_.set(reverse);
+            peeling_.reset(e.edge);
+            peeling_.reset(reverse);
+            on_remove(e, reverse);
+          },
+          katana::no_stats());
+
+      frontier->clear();
+      frontier->swap(next);
+    }
+  }
+
+  uint32_t support(Edge edge) const {
+    return support_[edge].load(std::memory_order_relaxed);
+  }
+
+  bool IsRemoved(Edge edge) const { return removed_.test(edge); }
+
+private:
+  /// Return the id of the edge (node, dest); the edge must exist.
+  Edge FindEdge(GNode node, GNode dest) const {
+    auto [begin, end] = EdgeDestRange(topology_, node);
+    return std::lower_bound(begin, end, dest) - dests_;
+  }
+
+  /// Order the edges of a triangle by their endpoints so that when several
+  /// of them are removed in the same round only the first one updates the
+  /// rest.
+  static bool Precedes(GNode a, GNode b, const TrussEdge& e) {
+    return std::make_pair(std::min(a, b), std::max(a, b)) <
+           std::make_pair(e.src, e.dest);
+  }
+
+  void RemoveTriangles(const TrussEdge& e, uint32_t level, TrussEdgeVec* next) {
+    auto [a, a_end] = EdgeDestRange(topology_, e.src);
+    auto [b, b_end] = EdgeDestRange(topology_, e.dest);
+    while (a != a_end && b != b_end) {
+      if (*a < *b) {
+        ++a;
+      } else if (*b < *a) {
+        ++b;
+      } else {
+        GNode w = *a;
+        Edge src_w = a - dests_;
+        Edge dest_w = b - dests_;
+        ++a;
+        ++b;
+
+        //! The triangle is already gone.
+        if (removed_.test(src_w) || removed_.test(dest_w)) {
+          continue;
+        }
+        bool src_w_peeling = peeling_.test(src_w);
+        bool dest_w_peeling = peeling_.test(dest_w);
+        if ((src_w_peeling && Precedes(e.src, w, e)) ||
+            (dest_w_peeling && Precedes(e.dest, w, e))) {
+          continue;
+        }
+        if (!src_w_peeling) {
+          DecrementSupport(e.src, w, src_w, level, next);
+        }
+        if (!dest_w_peeling) {
+          DecrementSupport(e.dest, w, dest_w, level, next);
+        }
+      }
+    }
+  }
+
+  void DecrementSupport(
+      GNode node, GNode dest, Edge edge, uint32_t level, TrussEdgeVec* next) {
+    if (dest < node) {
+      std::swap(node, dest);
+      edge = FindEdge(node, dest);
+    }
+    auto& support = support_[edge];
+    uint32_t old_support = support.load(std::memory_order_relaxed);
+    while (old_support > level &&
+           !support.compare_exchange_weak(
+               old_support, old_support - 1, std::memory_order_relaxed)) {
+    }
+    if (old_support == level + 1) {
+      next->push(TrussEdge{node, dest, edge});
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const uint32_t* dests_;
+  katana::LargeArray<std::atomic<uint32_t>> support_;
+  katana::DynamicBitset removed_;
+  //! Edges being removed in the current round
+  katana::DynamicBitset peeling_;
+};
+
+/// PeelingTrussAlgo:
+/// 1. Count the support of every edge.
+/// 2. Remove edges with support under k-2, decrementing the support of the
+///    other edges of their triangles.
+/// 3. Repeat 2 with the edges whose support dropped under k-2 until none
+///    are left.
+katana::Result<void>
+PeelingTrussAlgo(Graph* g, uint32_t k) {
+  if (k <= 2) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  TrussPeeling peeling(g->GetPropertyGraph().topology());
+  TrussEdgeVec edges;
+  peeling.CountSupport(&edges);
+
+  uint32_t level = k - 3;
+  TrussEdgeVec frontier;
+  katana::do_all(
+      katana::iterate(edges),
+      [&](const TrussEdge& e) {
+        if (peeling.support(e.edge) <= level) {
+          frontier.push(e);
+        }
+      },
+      katana::no_stats());
+  peeling.Peel(&frontier, level, [](const TrussEdge&, TrussPeeling::Edge) {});
+
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->edges(n)) {
+          g->GetEdgeData<EdgeFlag>(e) = peeling.IsRemoved(*e) ? removed : valid;
+        }
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::PropertyGraph* pg, uint32_t k_truss_number,
@@ -370,11 +601,113 @@ katana::analytics::KTruss(
     return BSPTrussJacobiAlgo(&graph, k_truss_number);
   case KTrussPlan::kBspCoreThenTruss:
     return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+  case KTrussPlan::kPeeling:
+    return PeelingTrussAlgo(&graph, k_truss_number);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+struct KTrussEdgeTrussNumber : public katana::PODProperty<uint32_t> {};
+
+using DecompositionGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<KTrussEdgeTrussNumber>>;
+
+/**
+ * Peel the edges in increasing order of support. Each level removes the
+ * remaining edges of least support, then, through TrussPeeling::Peel, the
+ * edges whose support drops to that level. The support of an edge is its
+ * truss number minus 2 when it is removed.
+ *
+ * The remaining edges are scanned once per level to drop removed edges and
+ * to find the next level, so levels with no edges are skipped.
+ *
+ * @param graph Graph to operate on
+ */
+void
+PeelingTrussDecomposition(DecompositionGraph* graph) {
+  auto truss_number = [&](TrussPeeling::Edge e) -> uint32_t& {
+    return graph->GetEdgeData<KTrussEdgeTrussNumber>(
+        katana::GraphTopology::edge_iterator(e));
+  };
+
+  //! Edges in no triangle are only in the 2-truss.
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](GNode n) {
+        for (auto e : graph->edges(n)) {
+          truss_number(*e) = 2;
+        }
+      },
+      katana::no_stats());
+
+  TrussPeeling peeling(graph->GetPropertyGraph().topology());
+  auto remaining = std::make_unique<TrussEdgeVec>();
+  peeling.CountSupport(remaining.get());
+
+  TrussEdgeVec frontier;
+  while (true) {
+    auto unpeeled = std::make_unique<TrussEdgeVec>();
+    katana::GReduceMin<uint32_t> min_support;
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const TrussEdge& e) {
+          if (!peeling.IsRemoved(e.edge)) {
+            unpeeled->push(e);
+            min_support.update(peeling.support(e.edge));
+          }
+        },
+        katana::no_stats());
+    remaining = std::move(unpeeled);
+    if (remaining->empty()) {
+      break;
+    }
+
+    uint32_t level = min_support.reduce();
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const TrussEdge& e) {
+          if (peeling.support(e.edge) == level) {
+            frontier.push(e);
+          }
+        },
+        katana::no_stats());
+    peeling.Peel(
+        &frontier, level, [&](const TrussEdge& e, TrussPeeling::Edge reverse) {
+          truss_number(e.edge) = level + 2;
+          truss_number(reverse) = level + 2;
+        });
+  }
+}
+
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  if (auto result = ConstructEdgeProperties<std::tuple<KTrussEdgeTrussNumber>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  // TODO(amp): Don't mutate the users topology!
+  if (auto result = katana::SortAllEdgesByDest(pg); !result) {
+    return result.error();
+  }
+
+  auto pg_result = DecompositionGraph::Make(pg, {}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::StatTimer exec_time("KTrussDecomposition");
+  exec_time.start();
+  PeelingTrussDecomposition(&graph);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -387,6 +720,84 @@ katana::analytics::KTrussAssertValid(
   return katana::ResultSuccess();
 }
 
+/// Check the truss numbers against a serial computation that finds the
+/// k-truss for k = 3, 4, ... by removing edges with support under k-2 from
+/// the (k-1)-truss until every remaining edge has enough support.
+katana::Result<void>
+katana::analytics::KTrussDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = DecompositionGraph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  std::vector<bool> alive(graph.num_edges(), true);
+  std::vector<uint32_t> expected(graph.num_edges(), 2);
+  auto alive_support = [&](GNode src, GNode dest) {
+    auto [a, a_end] = EdgeDestRange(topology, src);
+    auto [b, b_end] = EdgeDestRange(topology, dest);
+    uint32_t support = 0;
+    while (a != a_end && b != b_end) {
+      if (*a < *b) {
+        ++a;
+      } else if (*b < *a) {
+        ++b;
+      } else {
+        support += alive[a - dests] && alive[b - dests];
+        ++a;
+        ++b;
+      }
+    }
+    return support;
+  };
+
+  for (uint32_t k = 3;; ++k) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (GNode n = 0; n < graph.num_nodes(); ++n) {
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          if (dest > n && alive[*e] && alive_support(n, dest) < k - 2) {
+            alive[*e] = false;
+            alive[*katana::FindEdgeSortedByDest(graph, dest, n)] = false;
+            changed = true;
+          }
+        }
+      }
+    }
+
+    bool any_alive = false;
+    for (GNode n = 0; n < graph.num_nodes(); ++n) {
+      for (auto e : graph.edges(n)) {
+        if (*graph.GetEdgeDest(e) != n && alive[*e]) {
+          expected[*e] = k;
+          any_alive = true;
+        }
+      }
+    }
+    if (!any_alive) {
+      break;
+    }
+  }
+
+  for (GNode n = 0; n < graph.num_nodes(); ++n) {
+    for (auto e : graph.edges(n)) {
+      uint32_t truss_number = graph.GetEdgeData<KTrussEdgeTrussNumber>(e);
+      if (truss_number != expected[*e]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "edge ({}, {}) has truss number {} instead of {}", n,
+            *graph.GetEdgeDest(e), truss_number, expected[*e]);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<KTrussStatistics>
 katana::analytics::KTrussStatistics::Compute(
     katana::PropertyGraph* pg, [[maybe_unused]] uint32_t k_truss_number,
@@ -416,9 +827,54 @@ katana::analytics::KTrussStatistics::Compute(
 
   return KTrussStatistics{alive_edges.reduce()};
 }
+
+katana::Result<KTrussDecompositionStatistics>
+katana::analytics::KTrussDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = DecompositionGraph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::GReduceMax<uint32_t> max_truss_number;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          max_truss_number.update(graph.GetEdgeData<KTrussEdgeTrussNumber>(e));
+        }
+      },
+      katana::no_stats());
+  uint32_t max_truss = graph.num_edges() == 0 ? 0 : max_truss_number.reduce();
+
+  katana::GAccumulator<uint64_t> edges_in_max_truss;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.edges(node)) {
+          if (node < *graph.GetEdgeDest(e) &&
+              graph.GetEdgeData<KTrussEdgeTrussNumber>(e) == max_truss) {
+            edges_in_max_truss += 1;
+          }
+        }
+      },
+      katana::no_stats());
+
+  return KTrussDecompositionStatistics{
+      max_truss, edges_in_max_truss.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
 katana::analytics::KTrussStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_edges_left << std::endl;
 }
+
+void
+katana::analytics::KTrussDecompositionStatistics::Print(
+    std::ostream& os) const {
+  os << "Maximum truss number = " << max_truss_number << std::endl;
+  os << "Number of edges in the maximum truss = " << edges_in_max_truss
+     << std::endl;
+}
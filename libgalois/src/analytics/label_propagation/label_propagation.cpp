@@ -0,0 +1,296 @@
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Label = uint32_t;
+using NodeLabel = katana::PODProperty<Label>;
+using Graph = katana::TypedPropertyGraph<std::tuple<NodeLabel>, std::tuple<>>;
+
+/// The rank of label among tied labels; for a fixed seed, distinct labels
+/// have distinct ranks. This is the splitmix64 finalizer.
+uint64_t
+TieRank(Label label, uint64_t seed) {
+  uint64_t z = label + seed * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/// The label that wins the sorted votes [begin, end) of the neighbors of a
+/// node whose label is current. The node keeps current if it is among the
+/// most frequent labels, including if it has no neighbors.
+Label
+Elect(const Label* begin, const Label* end, Label current, uint64_t seed) {
+  Label best = current;
+  uint64_t best_count = 0;
+  uint64_t current_count = 0;
+  for (const Label* run = begin; run != end;) {
+    const Label* next = run + 1;
+    while (next != end && *next == *run) {
+      ++next;
+    }
+    uint64_t count = next - run;
+    if (*run == current) {
+      current_count = count;
+    }
+    if (count > best_count ||
+        (count == best_count && TieRank(*run, seed) < TieRank(best, seed))) {
+      best = *run;
+      best_count = count;
+    }
+    run = next;
+  }
+  return current_count == best_count ? current : best;
+}
+
+/// Synchronous label propagation over a frontier of the nodes whose
+/// neighbors changed label in the previous round
+class SynchronousPropagation {
+public:
+  SynchronousPropagation(
+      const katana::GraphTopology& topology, Label* labels,
+      const LabelPropagationPlan& plan)
+      : topology_(topology), labels_(labels), plan_(plan) {}
+
+  void Run() {
+    uint32_t num_nodes = topology_.num_nodes();
+    activated_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          labels_[n] = n;
+          activated_.constructAt(n, 0);
+        },
+        katana::no_stats());
+
+    auto frontier = std::make_unique<katana::InsertBag<Node>>();
+    for (uint32_t round = 1;
+         round <= plan_.max_iterations() && !katana::CancelRequested();
+         ++round) {
+      katana::InsertBag<Change> changes;
+      katana::InsertBag<Node> heavy;
+      auto visit = [&](Node n) {
+        if (Degree(n) >= plan_.heavy_degree()) {
+          heavy.push(n);
+          return;
+        }
+        Label label = Vote(n, scratch_.getLocal());
+        if (label != labels_[n]) {
+          changes.push(Change{n, label});
+        }
+      };
+      if (round == 1) {
+        katana::do_all(
+            katana::iterate(uint32_t{0}, num_nodes), visit, katana::steal(),
+            katana::loopname("LabelPropagation Vote"));
+      } else {
+        katana::do_all(
+            katana::iterate(*frontier), visit, katana::steal(),
+            katana::loopname("LabelPropagation Vote"));
+      }
+      // One heavy node at a time, each counting its votes in parallel
+      for (Node n : heavy) {
+        Label label = VoteHeavy(n);
+        if (label != labels_[n]) {
+          changes.push(Change{n, label});
+        }
+      }
+      if (changes.empty()) {
+        break;
+      }
+
+      // Only the neighbors of nodes that changed can change next round
+      auto next = std::make_unique<katana::InsertBag<Node>>();
+      katana::do_all(
+          katana::iterate(changes),
+          [&](const Change& change) {
+            labels_[change.node] = change.label;
+            for (auto e : topology_.edges(change.node)) {
+              Node dest = topology_.edge_dest(e);
+              if (activated_[dest].exchange(round) != round) {
+                next->push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::loopname("LabelPropagation Apply"));
+      frontier = std::move(next);
+    }
+  }
+
+private:
+  struct Change {
+    Node node;
+    Label label;
+  };
+
+  uint64_t Degree(Node n) const {
+    auto [begin, end] = topology_.edge_range(n);
+    return end - begin;
+  }
+
+  Label Vote(Node n, std::vector<Label>* votes) const {
+    votes->clear();
+    for (auto e : topology_.edges(n)) {
+      votes->emplace_back(labels_[topology_.edge_dest(e)]);
+    }
+    std::sort(votes->begin(), votes->end());
+    return Elect(
+        votes->data(), votes->data() + votes->size(), labels_[n],
+        plan_.seed());
+  }
+
+  Label VoteHeavy(Node n) {
+    auto [begin, end] = topology_.edge_range(n);
+    heavy_votes_.resize(end - begin);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t e) {
+          heavy_votes_[e - begin] = labels_[topology_.edge_dest(e)];
+        },
+        katana::no_stats());
+    katana::ParallelSTL::sort(heavy_votes_.begin(), heavy_votes_.end());
+    return Elect(
+        heavy_votes_.data(), heavy_votes_.data() + heavy_votes_.size(),
+        labels_[n], plan_.seed());
+  }
+
+  const katana::GraphTopology& topology_;
+  Label* labels_;
+  const LabelPropagationPlan& plan_;
+
+  /// The last round in which each node was added to the next frontier
+  katana::LargeArray<std::atomic<uint32_t>> activated_;
+  katana::PerThreadStorage<std::vector<Label>> scratch_;
+  std::vector<Label> heavy_votes_;
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LabelPropagation(
+    PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = ConstructNodeProperties<std::tuple<NodeLabel>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  Label* labels = graph.GetNodePropertyView<NodeLabel>().data();
+
+  katana::StatTimer exec_time("LabelPropagation");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case LabelPropagationPlan::kSynchronous: {
+    SynchronousPropagation algo(pg->topology(), labels, plan);
+    algo.Run();
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return CheckCancelled();
+}
+
+katana::Result<void>
+katana::analytics::LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Label* labels = graph.GetNodePropertyView<NodeLabel>().data();
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t n) { out_of_range.update(labels[n] >= pg->num_nodes()); },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "a label is not a node ID");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<LabelPropagationStatistics>
+katana::analytics::LabelPropagationStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  if (auto r = LabelPropagationAssertValid(pg, property_name); !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Label* labels = graph.GetNodePropertyView<NodeLabel>().data();
+  uint64_t num_nodes = pg->num_nodes();
+
+  katana::LargeArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { sizes.constructAt(n, 0); }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        sizes[labels[n]].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::GAccumulator<uint64_t> communities;
+  katana::GAccumulator<uint64_t> non_trivial;
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = sizes[n].load(std::memory_order_relaxed);
+        communities += size > 0;
+        non_trivial += size > 1;
+        largest.update(size);
+      },
+      katana::loopname("LabelPropagation Statistics"), katana::no_stats());
+
+  uint64_t largest_size = largest.reduce();
+  return LabelPropagationStatistics{
+      communities.reduce(), non_trivial.reduce(), largest_size,
+      num_nodes > 0 ? static_cast<double>(largest_size) / num_nodes : 0.0};
+}
+
+void
+katana::analytics::LabelPropagationStatistics::Print(std::ostream& os) const {
+  os << "Total number of communities = " << n_communities << std::endl;
+  os << "Total number of non trivial communities = "
+     << n_non_trivial_communities << std::endl;
+  os << "Number of nodes in the largest community = "
+     << largest_community_size << std::endl;
+  os << "Ratio of nodes in the largest community = "
+     << largest_community_proportion << std::endl;
+}
@@ -0,0 +1,670 @@
+#include "katana/analytics/leiden_clustering/leiden_clustering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+
+using namespace katana::analytics;
+namespace {
+
+template <typename EdgeWeightType>
+struct LeidenClusteringImplementation
+    : public katana::analytics::ClusteringImplementationBase<
+          katana::TypedPropertyGraph<
+              std::tuple<
+                  PreviousCommunityId, CurrentCommunityId,
+                  DegreeWeight<EdgeWeightType>>,
+              std::tuple<EdgeWeight<EdgeWeightType>>>,
+          EdgeWeightType, CommunityType<EdgeWeightType>> {
+  using NodeData = std::tuple<
+      PreviousCommunityId, CurrentCommunityId, DegreeWeight<EdgeWeightType>>;
+  using EdgeData = std::tuple<EdgeWeight<EdgeWeightType>>;
+  using CommTy = CommunityType<EdgeWeightType>;
+  using CommunityArray = katana::LargeArray<CommTy>;
+
+  using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+  using GNode = typename Graph::Node;
+
+  using Base = katana::analytics::ClusteringImplementationBase<
+      Graph, EdgeWeightType, CommTy>;
+
+  /**
+   * Moves nodes between clusters until the modularity gain of a round drops
+   * below modularity_threshold_per_round. Unlike Louvain, the nodes start in
+   * the clusters given by CurrentCommunityId: on coarsened graphs, these are
+   * the clusters that the sub-clusters were refined from.
+   */
+  katana::Result<double> LeidenLocalMovingDoAll(
+      katana::PropertyGraph* pfg, double lower,
+      double modularity_threshold_per_round, uint32_t& iter) {
+    katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
+    TimerClusteringTotal.start();
+
+    auto graph_result = Graph::Make(pfg);
+    if (!graph_result) {
+      return graph_result.error();
+    }
+    Graph graph = graph_result.value();
+
+    CommunityArray c_info;  // Community info
+
+    /* Variables needed for Modularity calculation */
+    double constant_for_second_term;
+    double prev_mod = lower;
+    double curr_mod = -1;
+    uint32_t num_iter = iter;
+
+    /*** Initialization ***/
+    c_info.allocateBlocked(graph.num_nodes());
+
+    /* Calculate the weighted degree sum for each vertex */
+    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+
+    /* Sum the degrees of the initial clusters */
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      c_info[n].degree_wt = 0;
+      c_info[n].size = 0;
+    });
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
+      katana::atomicAdd(
+          c_info[n_data_curr_comm_id].degree_wt,
+          graph.template GetData<DegreeWeight<EdgeWeightType>>(n));
+      katana::atomicAdd(c_info[n_data_curr_comm_id].size, (uint64_t)1);
+    });
+
+    /* Compute the total weight (2m) and 1/2m terms */
+    constant_for_second_term =
+        Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
+
+    katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+    TimerClusteringWhile.start();
+    katana::PerThreadArena arena;
+    while (true) {
+      num_iter++;
+
+      katana::do_all(
+          katana::iterate(graph),
+          [&](GNode n) {
+            auto& n_data_curr_comm_id =
+                graph.template GetData<CurrentCommunityId>(n);
+            auto& n_data_degree_wt =
+                graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
+
+            if (graph.edge_begin(n) == graph.edge_end(n)) {
+              return;
+            }
+
+            katana::ArenaScope scope{arena};
+            // Each neighbor's cluster, starting with the current one
+            typename Base::ClusterVec clusters(scope.allocator<uint64_t>());
+            // Number of edges to each unique cluster
+            typename Base::CounterVec counter(
+                scope.allocator<EdgeWeightType>());
+            EdgeWeightType self_loop_wt = 0;
+
+            Base::template FindNeighboringClusters<EdgeWeightType>(
+                graph, n, clusters, counter, self_loop_wt);
+            // Find the max gain in modularity
+            uint64_t local_target = Base::MaxModularityWithoutSwaps(
+                clusters, counter, self_loop_wt, c_info, n_data_degree_wt,
+                n_data_curr_comm_id, constant_for_second_term);
+
+            /* Update cluster info */
+            if (local_target != n_data_curr_comm_id &&
+                local_target != Base::UNASSIGNED) {
+              katana::atomicAdd(
+                  c_info[local_target].degree_wt, n_data_degree_wt);
+              katana::atomicAdd(c_info[local_target].size, (uint64_t)1);
+              katana::atomicSub(
+                  c_info[n_data_curr_comm_id].degree_wt, n_data_degree_wt);
+              katana::atomicSub(c_info[n_data_curr_comm_id].size, (uint64_t)1);
+
+              /* Set the new cluster id */
+              n_data_curr_comm_id = local_target;
+            }
+          },
+          katana::loopname("leiden algo: Phase 1"));
+
+      /* Calculate the overall modularity */
+      double e_xx = 0;
+      double a2_x = 0;
+
+      curr_mod = Base::template CalModularity<EdgeWeightType>(
+          graph, c_info, e_xx, a2_x, constant_for_second_term);
+
+      if ((curr_mod - prev_mod) < modularity_threshold_per_round) {
+        prev_mod = curr_mod;
+        break;
+      }
+
+      prev_mod = curr_mod;
+
+    }  // End while
+    TimerClusteringWhile.stop();
+
+    iter = num_iter;
+
+    c_info.destroy();
+    c_info.deallocate();
+
+    TimerClusteringTotal.stop();
+    return prev_mod;
+  }
+
+  /**
+   * Splits every cluster of graph (numbered contiguously from 0 to
+   * num_clusters) into sub-clusters, stores the sub-cluster of each node in
+   * CurrentCommunityId (numbered contiguously) and returns the number of
+   * sub-clusters. Each cluster is represented by its sub-cluster with the
+   * smallest id, which is stored in parents for each of its sub-clusters.
+   *
+   * Nodes start in singleton sub-clusters. A node that is still a singleton
+   * and is well connected to the rest of its cluster joins the neighboring
+   * sub-cluster of the same cluster with the largest modularity gain, if
+   * that sub-cluster is itself well connected to the rest of the cluster.
+   * A set of nodes S is well connected to the rest of its cluster C if
+   * E(S, C - S) >= deg(S) * (deg(C) - deg(S)) / 2m. Since sub-clusters only
+   * grow by absorbing their neighbors, they stay connected.
+   *
+   * The nodes of each cluster are visited serially in increasing order, and
+   * clusters are refined in parallel. The Leiden paper picks the sub-cluster
+   * at random, with probabilities increasing with the gain; this always
+   * takes the best one, which keeps results reproducible.
+   */
+  uint64_t RefinePartition(
+      Graph* graph, uint64_t num_clusters,
+      katana::LargeArray<uint64_t>* parents) {
+    uint64_t num_nodes = graph->num_nodes();
+    double constant_for_second_term =
+        Base::template CalConstantForSecondTerm<EdgeWeightType>(*graph);
+
+    katana::LargeArray<uint64_t> offsets;
+    katana::LargeArray<GNode> members;
+    Base::GroupNodesByCluster(*graph, num_clusters, &offsets, &members);
+
+    // Sub-clusters are identified by one of their nodes. For each
+    // sub-cluster: its degree, size and weight of edges to the rest of its
+    // cluster
+    katana::LargeArray<uint64_t> clusters;
+    katana::LargeArray<uint64_t> sub_clusters;
+    katana::LargeArray<EdgeWeightType> sub_degree_wt;
+    katana::LargeArray<uint64_t> sub_size;
+    katana::LargeArray<EdgeWeightType> sub_external_wt;
+    clusters.allocateBlocked(num_nodes);
+    sub_clusters.allocateBlocked(num_nodes);
+    sub_degree_wt.allocateBlocked(num_nodes);
+    sub_size.allocateBlocked(num_nodes);
+    sub_external_wt.allocateBlocked(num_nodes);
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      clusters[n] = graph->template GetData<CurrentCommunityId>(n);
+    });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      EdgeWeightType external_wt = 0;
+      for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n); ++ii) {
+        auto dst = *graph->GetEdgeDest(ii);
+        if (dst != n && clusters[dst] == clusters[n]) {
+          external_wt +=
+              graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+        }
+      }
+      sub_clusters[n] = n;
+      sub_degree_wt[n] =
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+      sub_size[n] = 1;
+      sub_external_wt[n] = external_wt;
+    });
+
+    katana::PerThreadArena arena;
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_clusters),
+        [&](uint64_t c) {
+          GNode* members_begin = members.data() + offsets[c];
+          GNode* members_end = members.data() + offsets[c + 1];
+          std::sort(members_begin, members_end);
+
+          double cluster_degree_wt = 0;
+          for (GNode* v = members_begin; v != members_end; ++v) {
+            cluster_degree_wt += sub_degree_wt[*v];
+          }
+          auto is_well_connected = [&](double external_wt, double degree_wt) {
+            return external_wt >= degree_wt * (cluster_degree_wt - degree_wt) *
+                                      constant_for_second_term;
+          };
+
+          for (GNode* v = members_begin; v != members_end; ++v) {
+            GNode n = *v;
+            if (sub_clusters[n] != n || sub_size[n] != 1 ||
+                !is_well_connected(sub_external_wt[n], sub_degree_wt[n])) {
+              continue;
+            }
+
+            katana::ArenaScope scope{arena};
+            typename Base::ClusterWeightMap weights(
+                scope.allocator<typename Base::ClusterWeightMap::value_type>());
+            for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n);
+                 ++ii) {
+              auto dst = *graph->GetEdgeDest(ii);
+              if (dst != n && clusters[dst] == c) {
+                weights[sub_clusters[dst]] +=
+                    graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(
+                        ii);
+              }
+            }
+
+            EdgeWeightType n_degree_wt = sub_degree_wt[n];
+            uint64_t target = n;
+            EdgeWeightType target_wt = 0;
+            double max_gain = 0;
+            Base::ForEachClusterWeight(
+                weights, [&](uint64_t sub, EdgeWeightType wt) {
+                  if (!is_well_connected(
+                          sub_external_wt[sub], sub_degree_wt[sub])) {
+                    return;
+                  }
+                  double gain = wt - double(n_degree_wt) * sub_degree_wt[sub] *
+                                         constant_for_second_term;
+                  if (gain > max_gain) {
+                    max_gain = gain;
+                    target = sub;
+                    target_wt = wt;
+                  }
+                });
+            if (target == n) {
+              continue;
+            }
+
+            // The edges between n and target are now internal
+            sub_external_wt[target] =
+                sub_external_wt[target] + sub_external_wt[n] - 2 * target_wt;
+            sub_degree_wt[target] += n_degree_wt;
+            sub_size[target] += 1;
+            sub_size[n] = 0;
+            sub_clusters[n] = target;
+          }
+        },
+        katana::steal(), katana::loopname("leiden algo: Refinement"));
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      graph->template GetData<CurrentCommunityId>(n) = sub_clusters[n];
+    });
+    uint64_t num_sub_clusters = Base::RenumberClustersContiguously(graph);
+
+    katana::LargeArray<std::atomic<uint64_t>> representatives;
+    representatives.allocateBlocked(num_clusters);
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_clusters),
+        [&](uint64_t c) { representatives.constructAt(c, Base::UNASSIGNED); });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      katana::atomicMin(
+          representatives[clusters[n]],
+          uint64_t{graph->template GetData<CurrentCommunityId>(n)});
+    });
+
+    // A sub-cluster is still identified by one of its nodes in sub_clusters,
+    // so that node writes the parent of the sub-cluster
+    parents->allocateBlocked(num_sub_clusters);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      if (sub_clusters[n] == n) {
+        (*parents)[graph->template GetData<CurrentCommunityId>(n)] =
+            representatives[clusters[n]];
+      }
+    });
+    return num_sub_clusters;
+  }
+
+public:
+  katana::Result<void> LeidenClustering(
+      katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+      const std::vector<std::string>& temp_node_property_names,
+      katana::LargeArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan) {
+    /*
+     * Construct temp property graph. This graph gets coarsened as the
+     * computation proceeds.
+     */
+    auto pfg_mutable = std::make_unique<katana::PropertyGraph>();
+    katana::LargeArray<uint64_t> out_indices_next;
+    katana::LargeArray<uint32_t> out_dests_next;
+
+    out_indices_next.allocateInterleaved(pfg->topology().num_nodes());
+    out_dests_next.allocateInterleaved(pfg->topology().num_edges());
+
+    auto numeric_array_out_indices =
+        std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
+            static_cast<int64_t>(pfg->topology().num_nodes()),
+            arrow::MutableBuffer::Wrap(
+                out_indices_next.data(), pfg->topology().num_nodes()));
+    auto numeric_array_out_dests =
+        std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
+            static_cast<int64_t>(pfg->topology().num_edges()),
+            arrow::MutableBuffer::Wrap(
+                out_dests_next.data(), pfg->topology().num_edges()));
+
+    if (auto r = pfg_mutable->SetTopology(katana::GraphTopology{
+            .out_indices = std::move(numeric_array_out_indices),
+            .out_dests = std::move(numeric_array_out_dests),
+        });
+        !r) {
+      return r.error();
+    }
+    if (auto result = ConstructNodeProperties<NodeData>(
+            pfg_mutable.get(), temp_node_property_names);
+        !result) {
+      return result.error();
+    }
+    std::vector<std::string> temp_edge_property_names = {
+        "_katana_temporary_property_" + edge_weight_property_name};
+    if (auto result = ConstructEdgeProperties<EdgeData>(
+            pfg_mutable.get(), temp_edge_property_names);
+        !result) {
+      return result.error();
+    }
+
+    auto graph_result = Graph::Make(pfg);
+    if (!graph_result) {
+      return graph_result.error();
+    }
+    Graph graph_curr = graph_result.value();
+
+    /*
+    * Vertex following optimization
+    */
+    if (plan.is_enable_vf()) {
+      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
+
+      uint64_t num_unique_clusters =
+          Base::RenumberClustersContiguously(&graph_curr);
+
+      /*
+     * Initialize node cluster id.
+     */
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        clusters_orig[n] = graph_curr.template GetData<CurrentCommunityId>(n);
+      });
+
+      // Build new graph to remove the isolated nodes
+      auto coarsened_graph_result =
+          Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
+              graph_curr, pfg_mutable.get(), num_unique_clusters,
+              temp_node_property_names, temp_edge_property_names);
+      if (!coarsened_graph_result) {
+        return coarsened_graph_result.error();
+      }
+
+      auto pfg_next = std::move(coarsened_graph_result.value());
+      pfg_mutable = std::move(pfg_next);
+
+    } else {
+      /*
+       * Initialize node cluster id.
+       */
+      katana::do_all(
+          katana::iterate(graph_curr), [&](GNode n) { clusters_orig[n] = n; });
+
+      if (auto r = Base::CreateDuplicateGraph(
+              pfg, pfg_mutable.get(), edge_weight_property_name,
+              temp_edge_property_names[0]);
+          !r) {
+        return r.error();
+      }
+
+      if (auto result = ConstructNodeProperties<NodeData>(pfg_mutable.get());
+          !result) {
+        return result.error();
+      }
+    }
+
+    double prev_mod = -1;  // Previous modularity
+    double curr_mod = -1;  // Current modularity
+
+    std::unique_ptr<katana::PropertyGraph> pfg_curr = std::move(pfg_mutable);
+    uint32_t iter = 0;
+    uint64_t num_nodes_orig = clusters_orig.size();
+
+    // Nodes of the first graph start in their own clusters; nodes of
+    // coarsened graphs start in the cluster their sub-cluster was refined
+    // from
+    katana::LargeArray<uint64_t> initial_clusters;
+    while (true) {
+      iter++;
+
+      auto graph_result = Graph::Make(pfg_curr.get());
+      if (!graph_result) {
+        return graph_result.error();
+      }
+      Graph graph_curr = graph_result.value();
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        graph_curr.template GetData<CurrentCommunityId>(n) =
+            initial_clusters.size() == 0 ? n : initial_clusters[n];
+      });
+
+      if (graph_curr.num_nodes() > plan.min_graph_size()) {
+        switch (plan.algorithm()) {
+        case LeidenClusteringPlan::kDoAll: {
+          auto curr_mod_result = LeidenLocalMovingDoAll(
+              pfg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+              iter);
+          if (!curr_mod_result) {
+            return curr_mod_result.error();
+          }
+          curr_mod = curr_mod_result.value();
+          break;
+        }
+        default:
+          return katana::ErrorCode::InvalidArgument;
+        }
+      }
+
+      uint64_t num_unique_clusters =
+          Base::RenumberClustersContiguously(&graph_curr);
+
+      if (iter >= plan.max_iterations() ||
+          (curr_mod - prev_mod) <= plan.modularity_threshold_total()) {
+        // The clusters of this graph are at least as good as the ones it
+        // started from, so keep them
+        katana::do_all(
+            katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+              if (clusters_orig[n] != Base::UNASSIGNED) {
+                clusters_orig[n] =
+                    graph_curr.template GetData<CurrentCommunityId>(
+                        clusters_orig[n]);
+              }
+            });
+        break;
+      }
+      prev_mod = curr_mod;
+
+      katana::LargeArray<uint64_t> next_initial_clusters;
+      uint64_t num_sub_clusters = RefinePartition(
+          &graph_curr, num_unique_clusters, &next_initial_clusters);
+
+      katana::do_all(
+          katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+            if (clusters_orig[n] != Base::UNASSIGNED) {
+              KATANA_LOG_DEBUG_ASSERT(
+                  clusters_orig[n] < graph_curr.num_nodes());
+              clusters_orig[n] =
+                  graph_curr.template GetData<CurrentCommunityId>(
+                      clusters_orig[n]);
+            }
+          });
+
+      auto coarsened_graph_result =
+          Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
+              graph_curr, pfg_curr.get(), num_sub_clusters,
+              temp_node_property_names, temp_edge_property_names);
+      if (!coarsened_graph_result) {
+        return coarsened_graph_result.error();
+      }
+
+      pfg_curr = std::move(coarsened_graph_result.value());
+      initial_clusters = std::move(next_initial_clusters);
+    }
+    return katana::ResultSuccess();
+  }
+};
+
+template <typename EdgeWeightType>
+static katana::Result<void>
+LeidenClusteringWithWrap(
+    katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LeidenClusteringPlan plan) {
+  static_assert(
+      std::is_integral_v<EdgeWeightType> ||
+      std::is_floating_point_v<EdgeWeightType>);
+
+  //! The property name with prefixed with "_katana_temporary_property"
+  //! are reserved for internal use only.
+  std::vector<std::string> temp_node_property_names = {
+      "_katana_temporary_property_CurrentId",
+      "_katana_temporary_property_PreviousId",
+      "_katana_temporary_property_DegreeWt"};
+  using Impl = LeidenClusteringImplementation<EdgeWeightType>;
+  if (auto result = ConstructNodeProperties<typename Impl::NodeData>(
+          pfg, temp_node_property_names);
+      !result) {
+    return result.error();
+  }
+
+  /*
+   * To keep track of communities for nodes in the original graph.
+   * Community will be set to -1 for isolated nodes
+   */
+  katana::LargeArray<uint64_t> clusters_orig;
+  clusters_orig.allocateBlocked(pfg->num_nodes());
+
+  LeidenClusteringImplementation<EdgeWeightType> impl{};
+  if (auto r = impl.LeidenClustering(
+          pfg, edge_weight_property_name, temp_node_property_names,
+          clusters_orig, plan);
+      !r) {
+    return r.error();
+  }
+
+  for (auto property : temp_node_property_names) {
+    if (auto r = pfg->RemoveNodeProperty(property); !r) {
+      return r.error();
+    }
+  }
+
+  if (auto r = ConstructNodeProperties<std::tuple<CurrentCommunityId>>(
+          pfg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<CurrentCommunityId>, std::tuple<>>::
+          Make(pfg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t i) {
+        graph.GetData<CurrentCommunityId>(i) = clusters_orig[i];
+      },
+      katana::loopname("Add clusterIds"), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+}  // anonymous namespace
+
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LeidenClusteringPlan plan) {
+  if (auto r = CheckNotDeterministic(plan, "LeidenClustering"); !r) {
+    return r.error();
+  }
+  switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return LeidenClusteringWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return LeidenClusteringWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return LeidenClusteringWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return LeidenClusteringWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return LeidenClusteringWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return LeidenClusteringWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::LeidenClusteringAssertValid(
+    katana::PropertyGraph* pg,
+    [[maybe_unused]] const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<CurrentCommunityId>, std::tuple<>>;
+  auto graph_result = Graph::Make(pg, {property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+
+  // Every node is either isolated or in a cluster named by the id of a
+  // node of the graph
+  std::atomic<bool> out_of_range(false);
+  katana::do_all(katana::iterate(graph), [&](uint32_t n) {
+    uint64_t cluster = graph.GetData<CurrentCommunityId>(n);
+    if (cluster != std::numeric_limits<uint64_t>::max() &&
+        cluster >= graph.num_nodes()) {
+      out_of_range = true;
+    }
+  });
+  if (out_of_range) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::LeidenClusteringStatistics::Print(std::ostream& os) const {
+  os << "Total number of clusters = " << n_clusters << std::endl;
+  os << "Total number of non trivial clusters = " << n_non_trivial_clusters
+     << std::endl;
+  os << "Number of nodes in the largest cluster = " << largest_cluster_size
+     << std::endl;
+  os << "Ratio of nodes in the largest cluster = " << largest_cluster_proportion
+     << std::endl;
+  os << "Leiden modularity = " << modularity << std::endl;
+}
+
+katana::Result<katana::analytics::LeidenClusteringStatistics>
+katana::analytics::LeidenClusteringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  // The statistics only depend on the clusters, not on how they were found
+  auto stats_result = LouvainClusteringStatistics::Compute(
+      pg, edge_weight_property_name, property_name);
+  if (!stats_result) {
+    return stats_result.error();
+  }
+  const LouvainClusteringStatistics& stats = stats_result.value();
+  return LeidenClusteringStatistics{
+      stats.n_clusters, stats.n_non_trivial_clusters,
+      stats.largest_cluster_size, stats.largest_cluster_proportion,
+      stats.modularity};
+}
@@ -19,13 +19,89 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+#include <random>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/Intersection.h"
+#include "katana/analytics/TriangleSampling.h"
 
 using namespace katana::analytics;
 
 namespace {
 constexpr static const unsigned kChunkSize = 64U;
 
+/**
+ * Finds the triangles (n, v, vv) with n >= v >= vv. For each neighbor v of
+ * n, calls fn(v, begin, end) where [begin, end) holds the common neighbors
+ * vv of n and v. common is scratch space for the common neighbors.
+ */
+template <typename Fn>
+void
+ForEachOrderedTriangle(
+    const katana::GraphTopology& topology, uint32_t n,
+    std::vector<uint32_t>* common, Fn fn) {
+  auto [n_begin, n_end] = EdgeDestRange(topology, n);
+  for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+    auto v = *it_v;
+    if (v > n) {
+      break;
+    }
+    auto [v_begin, v_end] = EdgeDestRange(topology, v);
+    v_end = std::upper_bound(v_begin, v_end, v);
+    const uint32_t* n_v_end = std::upper_bound(n_begin, n_end, v);
+
+    size_t capacity = std::min(v_end - v_begin, n_v_end - n_begin);
+    if (common->size() < capacity) {
+      common->resize(capacity);
+    }
+    size_t num =
+        SortedIntersection(v_begin, v_end, n_begin, n_v_end, common->data());
+    fn(v, common->data(), common->data() + num);
+  }
+}
+
+/**
+ * Finds the triangles (n, v, vv) whose lowest ranked node is n in the
+ * orientation of the graph by degree. For each out-neighbor v of n, calls
+ * fn(v, begin, end) where [begin, end) holds the common out-neighbors vv of
+ * n and v. common is scratch space for the common neighbors.
+ */
+template <typename Fn>
+void
+ForEachOrientedTriangle(
+    const katana::DegreeOrderedDag& dag, uint32_t n,
+    std::vector<uint32_t>* common, Fn fn) {
+  auto [n_begin, n_end] = dag.OutNeighbors(n);
+  for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+    auto [v_begin, v_end] = dag.OutNeighbors(*it_v);
+    size_t capacity = std::min(v_end - v_begin, n_end - n_begin);
+    if (common->size() < capacity) {
+      common->resize(capacity);
+    }
+    size_t num =
+        SortedIntersection(v_begin, v_end, n_begin, n_end, common->data());
+    fn(*it_v, common->data(), common->data() + num);
+  }
+}
+
+/**
+ * Finds each triangle once: from the orientation dag if it is set and
+ * otherwise from the ordering of the node ids of topology, whose edges must
+ * be sorted.
+ */
+template <typename Fn>
+void
+ForEachTriangle(
+    const katana::GraphTopology& topology, const katana::DegreeOrderedDag* dag,
+    uint32_t n, std::vector<uint32_t>* common, Fn fn) {
+  if (dag) {
+    ForEachOrientedTriangle(*dag, n, common, fn);
+  } else {
+    ForEachOrderedTriangle(topology, n, common, fn);
+  }
+}
+
 struct LocalClusteringCoefficientAtomics {
   struct NodeTriangleCount {
     using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
@@ -42,6 +118,8 @@ struct LocalClusteringCoefficientAtomics {
 
   using Node = Graph::Node;
 
+  const katana::DegreeOrderedDag* dag_{nullptr};
+
   /**
  * Counts the number of triangles for each node
  * in the graph using atomics.
@@ -50,32 +128,23 @@ struct LocalClusteringCoefficientAtomics {
  * triangles. It assumes that edgelist of each node
  * is sorted.
  */
-  void OrderedCountFunc(Graph* graph, Node n) {
-    for (auto it_v : graph->edges(n)) {
-      auto v = *graph->GetEdgeDest(it_v);
-      if (v > n) {
-        break;
-      }
-      Graph::edge_iterator it_n = graph->edges(n).begin();
-
-      for (auto it_vv : graph->edges(v)) {
-        auto vv = *graph->GetEdgeDest(it_vv);
-        if (vv > v) {
-          break;
-        }
-        while (*graph->GetEdgeDest(it_n) < vv) {
-          it_n++;
-        }
-        if (vv == *graph->GetEdgeDest(it_n)) {
-          katana::atomicAdd<uint64_t>(
-              graph->GetData<NodeTriangleCount>(n), (uint64_t)1);
+  void OrderedCountFunc(Graph* graph, Node n, std::vector<uint32_t>* common) {
+    ForEachTriangle(
+        graph->GetPropertyGraph().topology(), dag_, n, common,
+        [&](Node v, const uint32_t* vv_begin, const uint32_t* vv_end) {
+          uint64_t num = vv_end - vv_begin;
+          if (num == 0) {
+            return;
+          }
           katana::atomicAdd<uint64_t>(
-              graph->GetData<NodeTriangleCount>(v), (uint64_t)1);
+              graph->GetData<NodeTriangleCount>(n), num);
           katana::atomicAdd<uint64_t>(
-              graph->GetData<NodeTriangleCount>(vv), (uint64_t)1);
-        }
-      }
-    }
+              graph->GetData<NodeTriangleCount>(v), num);
+          for (const uint32_t* vv = vv_begin; vv != vv_end; ++vv) {
+            katana::atomicAdd<uint64_t>(
+                graph->GetData<NodeTriangleCount>(*vv), (uint64_t)1);
+          }
+        });
   }
 
   /*
@@ -84,9 +153,10 @@ struct LocalClusteringCoefficientAtomics {
  * This uses an atomic implementation.
  */
   void OrderedCountAlgo(Graph* graph) {
+    katana::PerThreadStorage<std::vector<uint32_t>> common;
     katana::do_all(
         katana::iterate(*graph),
-        [&](const Node& n) { OrderedCountFunc(graph, n); },
+        [&](const Node& n) { OrderedCountFunc(graph, n, common.getLocal()); },
         katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
   }
@@ -148,6 +218,7 @@ struct LocalClusteringCoefficientPerThread {
 
   typedef typename Graph::Node Node;
 
+  const katana::DegreeOrderedDag* dag_{nullptr};
   katana::LargeArray<uint64_t> node_triangle_count_;
 
   /**
@@ -159,29 +230,18 @@ struct LocalClusteringCoefficientPerThread {
  * is sorted.
  */
   void OrderedCountFunc(
-      Graph* graph, Node n, std::vector<uint64_t>* node_triangle_count) {
-    for (auto it_v : graph->edges(n)) {
-      auto v = *graph->GetEdgeDest(it_v);
-      if (v > n) {
-        break;
-      }
-      Graph::edge_iterator it_n = graph->edges(n).begin();
-
-      for (auto it_vv : graph->edges(v)) {
-        auto vv = *graph->GetEdgeDest(it_vv);
-        if (vv > v) {
-          break;
-        }
-        while (*graph->GetEdgeDest(it_n) < vv) {
-          it_n++;
-        }
-        if (vv == *graph->GetEdgeDest(it_n)) {
-          (*node_triangle_count)[n] += 1;
-          (*node_triangle_count)[v] += 1;
-          (*node_triangle_count)[vv] += 1;
-        }
-      }
-    }
+      Graph* graph, Node n, std::vector<uint64_t>* node_triangle_count,
+      std::vector<uint32_t>* common) {
+    ForEachTriangle(
+        graph->GetPropertyGraph().topology(), dag_, n, common,
+        [&](Node v, const uint32_t* vv_begin, const uint32_t* vv_end) {
+          uint64_t num = vv_end - vv_begin;
+          (*node_triangle_count)[n] += num;
+          (*node_triangle_count)[v] += num;
+          for (const uint32_t* vv = vv_begin; vv != vv_end; ++vv) {
+            (*node_triangle_count)[*vv] += 1;
+          }
+        });
   }
 
   /*
@@ -192,6 +252,7 @@ struct LocalClusteringCoefficientPerThread {
   void OrderedCountAlgo(Graph* graph) {
     katana::PerThreadStorage<std::vector<uint64_t>>
         per_thread_node_triangle_count;
+    katana::PerThreadStorage<std::vector<uint32_t>> common;
     uint64_t num_nodes = graph->size();
     uint32_t num_threads = katana::getActiveThreads();
 
@@ -204,7 +265,8 @@ struct LocalClusteringCoefficientPerThread {
         katana::iterate(*graph),
         [&](const Node& n) {
           OrderedCountFunc(
-              graph, n, &(*per_thread_node_triangle_count.getLocal()));
+              graph, n, &(*per_thread_node_triangle_count.getLocal()),
+              common.getLocal());
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -269,6 +331,79 @@ struct LocalClusteringCoefficientPerThread {
     return katana::ResultSuccess();
   }
 };
+struct LocalClusteringCoefficientWedgeSampling {
+  struct NodeClusteringCoefficient : public katana::PODProperty<double> {};
+
+  using NodeData = typename std::tuple<NodeClusteringCoefficient>;
+  using EdgeData = typename std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+
+  typedef typename Graph::Node Node;
+
+  uint32_t samples_per_node_;
+  uint64_t seed_;
+
+  /**
+   * The fraction of the wedges at n that are closed: exactly, by
+   * intersecting the neighbors of n with those of each neighbor, if n has at
+   * most samples_per_node_ wedges, and otherwise from a sample of that many
+   * wedges.
+   */
+  double ClusteringCoefficient(const katana::GraphTopology& topology, Node n) {
+    auto [n_begin, n_end] = EdgeDestRange(topology, n);
+    uint64_t num_wedges = NumWedges(n_end - n_begin);
+    if (num_wedges <= samples_per_node_) {
+      uint64_t closed = 0;
+      for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+        auto [v_begin, v_end] = EdgeDestRange(topology, *it_v);
+        closed += CountSortedIntersection(v_begin, v_end, n_begin, n_end);
+      }
+      // Each closed wedge is found from both of its ends
+      return (closed / 2.0) / num_wedges;
+    }
+
+    std::mt19937_64 gen(SampleSeed(seed_, n));
+    uint64_t closed = 0;
+    for (uint32_t i = 0; i < samples_per_node_; ++i) {
+      closed += SampleWedge(topology, n, &gen);
+    }
+    return static_cast<double>(closed) / samples_per_node_;
+  }
+
+  katana::Result<void> operator()(
+      katana::PropertyGraph* pg, const std::string& output_property_name) {
+    if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+            pg, {output_property_name});
+        !result) {
+      return result.error();
+    }
+
+    auto graph_result = Graph::Make(pg, {output_property_name}, {});
+    if (!graph_result) {
+      return graph_result.error();
+    }
+
+    Graph graph = graph_result.value();
+    const katana::GraphTopology& topology = pg->topology();
+
+    katana::StatTimer execTime(
+        "LocalClusteringCoefficient", "LocalClusteringCoefficient");
+    execTime.start();
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const Node& n) {
+          graph.GetData<NodeClusteringCoefficient>(n) =
+              ClusteringCoefficient(topology, n);
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("LocalClusteringCoefficient_WedgeSampling"));
+
+    execTime.stop();
+    return katana::ResultSuccess();
+  }
+};
 }  // namespace
 
 template <typename Algorithm>
@@ -307,8 +442,23 @@ katana::analytics::LocalClusteringCoefficient(
     return katana::ErrorCode::AssertionFailed;
   }
 
+  katana::PropertyGraph* user_pg = pg;
   std::unique_ptr<katana::PropertyGraph> mutable_pfg;
-  if (relabel || !plan.edges_sorted()) {
+  std::shared_ptr<const katana::DegreeOrderedDag> dag;
+  if (relabel &&
+      plan.algorithm() != LocalClusteringCoefficientPlan::kWedgeSampling) {
+    // The orientation by degree stands in for a relabeled copy and is kept
+    // with the users graph for the next analytic
+    katana::StatTimer timer_relabel(
+        "GraphRelabelTimer", "LocalClusteringCoefficient");
+    timer_relabel.start();
+    auto dag_result = pg->OrientByDegree();
+    if (!dag_result) {
+      return dag_result.error();
+    }
+    dag = std::move(dag_result.value());
+    timer_relabel.stop();
+  } else if (!plan.edges_sorted()) {
     // Copy the graph so we don't mutate the users graph.
     auto mutable_pfg_result = pg->Copy({}, {});
     if (!mutable_pfg_result) {
@@ -316,20 +466,6 @@ katana::analytics::LocalClusteringCoefficient(
     }
     mutable_pfg = std::move(mutable_pfg_result.value());
     pg = mutable_pfg.get();
-  }
-
-  if (relabel) {
-    katana::StatTimer timer_relabel(
-        "GraphRelabelTimer", "LocalClusteringCoefficient");
-    timer_relabel.start();
-    if (auto r = katana::SortNodesByDegree(pg); !r) {
-      return r.error();
-    }
-    timer_relabel.stop();
-  }
-
-  // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
     if (auto r = katana::SortAllEdgesByDest(pg); !r) {
       return r.error();
     }
@@ -339,16 +475,42 @@ katana::analytics::LocalClusteringCoefficient(
 
   katana::Prealloc(1, 16 * (pg->num_nodes() + pg->num_edges()));
 
+  katana::Result<void> result = katana::ResultSuccess();
   switch (plan.algorithm()) {
   case LocalClusteringCoefficientPlan::kOrderedCountAtomics: {
-    LocalClusteringCoefficientAtomics algo;
-    return algo(pg, output_property_name);
+    LocalClusteringCoefficientAtomics algo{dag.get()};
+    result = algo(pg, output_property_name);
+    break;
   }
   case LocalClusteringCoefficientPlan::kOrderedCountPerThread: {
-    LocalClusteringCoefficientPerThread algo_per_thread;
-    return algo_per_thread(pg, output_property_name);
+    LocalClusteringCoefficientPerThread algo_per_thread{dag.get()};
+    result = algo_per_thread(pg, output_property_name);
+    break;
+  }
+  case LocalClusteringCoefficientPlan::kWedgeSampling: {
+    if (plan.samples_per_node() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "samples per node must be positive");
+    }
+    LocalClusteringCoefficientWedgeSampling algo_sampling{
+        plan.samples_per_node(), plan.seed()};
+    result = algo_sampling(pg, output_property_name);
+    break;
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+  if (!result) {
+    return result.error();
+  }
+  if (pg == user_pg) {
+    return katana::ResultSuccess();
+  }
+  // Only the edges of the copy were sorted, so its nodes are those of the
+  // user graph and the result can be moved over as is
+  auto field = pg->node_schema()->GetFieldByName(output_property_name);
+  auto table = arrow::Table::Make(
+      arrow::schema({field}), {pg->GetNodeProperty(output_property_name)});
+  return user_pg->AddNodeProperties(table);
 }
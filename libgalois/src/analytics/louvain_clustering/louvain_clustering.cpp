@@ -19,6 +19,7 @@
 
 #include "katana/analytics/louvain_clustering/louvain_clustering.h"
 
+#include <atomic>
 #include <deque>
 #include <type_traits>
 
@@ -51,7 +52,8 @@ struct LouvainClusteringImplementation
 
   katana::Result<double> LouvainWithoutLockingDoAll(
       katana::PropertyGraph* pfg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
+      double modularity_threshold_per_round, bool enable_pruning,
+      uint32_t& iter) {
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     TimerClusteringTotal.start();
 
@@ -89,6 +91,18 @@ struct LouvainClusteringImplementation
 
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
+    katana::PerThreadArena arena;
+
+    // With pruning, only nodes with a neighbor that moved in the previous
+    // round are visited
+    katana::LargeArray<std::atomic<bool>> active;
+    if (enable_pruning) {
+      active.allocateBlocked(graph.num_nodes());
+      katana::do_all(katana::iterate(graph), [&](GNode n) {
+        active.constructAt(n, true);
+      });
+    }
+
     while (true) {
       num_iter++;
 
@@ -100,6 +114,11 @@ struct LouvainClusteringImplementation
       katana::do_all(
           katana::iterate(graph),
           [&](GNode n) {
+            if (enable_pruning &&
+                !active[n].exchange(false, std::memory_order_relaxed)) {
+              return;
+            }
+
             auto& n_data_curr_comm_id =
                 graph.template GetData<CurrentCommunityId>(n);
             auto& n_data_degree_wt =
@@ -108,19 +127,20 @@ struct LouvainClusteringImplementation
             uint64_t degree =
                 std::distance(graph.edge_begin(n), graph.edge_end(n));
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
+            katana::ArenaScope scope{arena};
+            // Each neighbor's cluster, starting with the current one
+            typename Base::ClusterVec clusters(scope.allocator<uint64_t>());
+            // Number of edges to each unique cluster
+            typename Base::CounterVec counter(
+                scope.allocator<EdgeWeightType>());
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  graph, n, cluster_local_map, counter, self_loop_wt);
+                  graph, n, clusters, counter, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
+                  clusters, counter, self_loop_wt, c_info,
                   n_data_degree_wt, n_data_curr_comm_id,
                   constant_for_second_term);
 
@@ -140,6 +160,16 @@ struct LouvainClusteringImplementation
 
               /* Set the new cluster id */
               n_data_curr_comm_id = local_target;
+
+              // The neighborhoods of the neighbors changed, so they may
+              // want to move in the next round
+              if (enable_pruning) {
+                for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n);
+                     ++ii) {
+                  active[*graph.GetEdgeDest(ii)].store(
+                      true, std::memory_order_relaxed);
+                }
+              }
             }
           },
           katana::loopname("louvain algo: Phase 1"));
@@ -297,7 +327,7 @@ public:
         case LouvainClusteringPlan::kDoAll: {
           auto curr_mod_result = LouvainWithoutLockingDoAll(
               pfg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
-              iter);
+              plan.is_enable_pruning(), iter);
           if (!curr_mod_result) {
             return curr_mod_result.error();
           }
@@ -429,6 +459,9 @@ katana::Result<void>
 katana::analytics::LouvainClustering(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, LouvainClusteringPlan plan) {
+  if (auto r = CheckNotDeterministic(plan, "LouvainClustering"); !r) {
+    return r.error();
+  }
   switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
     return LouvainClusteringWithWrap<uint32_t>(
@@ -0,0 +1,741 @@
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+using LatentVectors = katana::FixedSizeListProperty<float>;
+
+template <typename Rating>
+using EdgeRating = katana::PODProperty<Rating>;
+
+/// Call fn with a value of the C type of the edge property named
+/// rating_property_name, or fail if it is not a number.
+template <typename Fn>
+auto
+DispatchRatingType(
+    const katana::PropertyGraph* pg, const std::string& rating_property_name,
+    const Fn& fn) -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(rating_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        rating_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported rating type {}",
+        property->type()->ToString());
+  }
+}
+
+/// Copy the ratings of pg into ratings as floats
+katana::Result<void>
+ReadRatings(
+    katana::PropertyGraph* pg, const std::string& rating_property_name,
+    katana::LargeArray<float>* ratings) {
+  return DispatchRatingType(
+      pg, rating_property_name, [&](auto zero) -> katana::Result<void> {
+        using Rating = decltype(zero);
+        using Graph = katana::TypedPropertyGraph<
+            std::tuple<>, std::tuple<EdgeRating<Rating>>>;
+        auto pg_result = Graph::Make(pg, {}, {rating_property_name});
+        if (!pg_result) {
+          return pg_result.error();
+        }
+        auto graph = pg_result.value();
+        const Rating* values =
+            graph.template GetEdgePropertyView<EdgeRating<Rating>>().data();
+        ratings->allocateBlocked(pg->num_edges());
+        katana::do_all(
+            katana::iterate(uint64_t{0}, pg->num_edges()),
+            [&](Edge e) { (*ratings)[e] = static_cast<float>(values[e]); },
+            katana::no_stats());
+        return katana::ResultSuccess();
+      });
+}
+
+/// Fail unless every edge goes from a left node to a right node, i.e., no
+/// edge ends at a node with out-edges
+katana::Result<void>
+CheckBipartite(const katana::GraphTopology& topology) {
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        for (Edge e : topology.edges(src)) {
+          auto [first, last] = topology.edge_range(topology.edge_dest(e));
+          if (first != last) {
+            not_bipartite.update(true);
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph is not directed from left nodes to right nodes: some edge "
+        "ends at a node with out-edges");
+  }
+  return katana::ResultSuccess();
+}
+
+float
+Dot(const float* a, const float* b, uint32_t k) {
+  float sum = 0;
+  for (uint32_t i = 0; i < k; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+/// The sum of the squared errors of the predicted ratings; the order of the
+/// sum does not depend on the number of threads
+double
+SquaredError(
+    const katana::GraphTopology& topology, const float* ratings,
+    const float* latent, uint32_t k) {
+  return katana::ParallelSTL::deterministic_map_reduce(
+      Node{0}, static_cast<Node>(topology.num_nodes()),
+      [&](Node src) {
+        double sum = 0;
+        for (Edge e : topology.edges(src)) {
+          const float* x = latent + uint64_t{src} * k;
+          const float* y = latent + uint64_t{topology.edge_dest(e)} * k;
+          double error = Dot(x, y, k) - ratings[e];
+          sum += error * error;
+        }
+        return sum;
+      },
+      std::plus<double>(), 0.0);
+}
+
+uint64_t
+SplitMix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Fill the latent vectors with values drawn uniformly from [0, 2s), with s
+/// chosen so that the expected prediction is the mean rating. The values
+/// only depend on the node and the element.
+void
+InitializeLatent(
+    const katana::GraphTopology& topology, const float* ratings,
+    float* latent, uint32_t k) {
+  uint64_t num_edges = topology.num_edges();
+  double sum = katana::ParallelSTL::deterministic_map_reduce(
+      uint64_t{0}, num_edges, [&](Edge e) { return double{ratings[e]}; },
+      std::plus<double>(), 0.0);
+  double mean = num_edges > 0 ? sum / num_edges : 0.0;
+  double scale = mean > 0 ? 2 * std::sqrt(mean / k) : 1 / std::sqrt(k);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes() * k),
+      [&](uint64_t i) {
+        // The top 24 bits give a float in [0, 1)
+        double unit = static_cast<double>(SplitMix64(i) >> 40) / (1 << 24);
+        latent[i] = static_cast<float>(scale * unit);
+      },
+      katana::no_stats());
+}
+
+/**
+ * Stochastic gradient descent over tiles. Left nodes are split into row
+ * blocks and right nodes into column blocks of consecutive ids, balanced by
+ * number of ratings, and the ratings are copied tile by tile so that
+ * processing a tile streams through memory and only touches the latent
+ * vectors of one row block and one column block. Diagonal s consists of the
+ * tiles (r, (r + s) mod B); an epoch processes the B diagonals in turn, the
+ * tiles of each in parallel.
+ */
+class TiledSgd {
+  struct Rating {
+    Node src;
+    Node dest;
+    float value;
+  };
+
+public:
+  TiledSgd(
+      const katana::GraphTopology& topology, const float* ratings,
+      float* latent, const MatrixCompletionPlan& plan)
+      : topology_(topology),
+        ratings_(ratings),
+        latent_(latent),
+        plan_(plan),
+        k_(plan.latent_vector_size()),
+        num_blocks_(std::max<uint64_t>(
+            1, uint64_t{plan.blocks_per_thread()} *
+                   katana::getActiveThreads())) {}
+
+  void Run() {
+    BuildTiles();
+
+    uint64_t num_ratings = std::max<uint64_t>(1, topology_.num_edges());
+    double previous_rmse = 0;
+    uint32_t epoch = 0;
+    while (epoch < plan_.max_iterations() && !katana::CancelRequested()) {
+      double step = plan_.learning_rate() * 1.5 /
+                    (1.0 + plan_.decay_rate() * std::pow(epoch + 1, 1.5));
+      // Each rating contributes its error before its own update
+      double rmse = std::sqrt(Epoch(step) / num_ratings);
+      ++epoch;
+      if (epoch > 1 &&
+          previous_rmse - rmse < plan_.tolerance() * previous_rmse) {
+        break;
+      }
+      previous_rmse = rmse;
+    }
+
+    katana::ReportStatSingle("MatrixCompletion", "Epochs", epoch);
+    katana::ReportStatSingle("MatrixCompletion", "Tiles", num_tiles());
+  }
+
+private:
+  uint64_t num_tiles() const { return num_blocks_ * num_blocks_; }
+
+  void BuildTiles() {
+    uint64_t num_nodes = topology_.num_nodes();
+    uint64_t num_edges = topology_.num_edges();
+
+    // The block of a left node follows its first edge and the block of a
+    // right node the number of in-edges of the nodes before it
+    katana::LargeArray<std::atomic<uint64_t>> in_degree;
+    katana::LargeArray<uint64_t> in_before;
+    in_degree.allocateBlocked(num_nodes);
+    in_before.allocateBlocked(num_nodes + 1);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) { in_degree.constructAt(n, 0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            in_degree[topology_.edge_dest(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    in_before[0] = 0;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          in_before[n + 1] = in_degree[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        in_before.begin() + 1, in_before.end(), in_before.begin() + 1);
+
+    block_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          auto [first, last] = topology_.edge_range(n);
+          uint64_t before = first != last ? first : in_before[n];
+          block_[n] = std::min(
+              num_blocks_ - 1, before * num_blocks_ / std::max<uint64_t>(
+                                                         1, num_edges));
+        },
+        katana::no_stats());
+
+    // Count the ratings of each tile, then reuse the counts as cursors
+    katana::LargeArray<std::atomic<uint64_t>> cursor;
+    cursor.allocateBlocked(num_tiles());
+    tile_begin_.allocateBlocked(num_tiles() + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_tiles()),
+        [&](uint64_t t) { cursor.constructAt(t, 0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            cursor[Tile(src, topology_.edge_dest(e))].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    tile_begin_[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_tiles()),
+        [&](uint64_t t) {
+          tile_begin_[t + 1] = cursor[t].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        tile_begin_.begin() + 1, tile_begin_.end(), tile_begin_.begin() + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_tiles()),
+        [&](uint64_t t) {
+          cursor[t].store(tile_begin_[t], std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    tiled_.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            Node dest = topology_.edge_dest(e);
+            uint64_t slot = cursor[Tile(src, dest)].fetch_add(
+                1, std::memory_order_relaxed);
+            tiled_[slot] = Rating{src, dest, ratings_[e]};
+          }
+        },
+        katana::steal(), katana::loopname("MatrixCompletion BuildTiles"));
+  }
+
+  uint64_t Tile(Node src, Node dest) const {
+    return block_[src] * num_blocks_ + block_[dest];
+  }
+
+  /// One pass over all ratings; returns the sum of their squared errors
+  double Epoch(double step) {
+    auto lambda = static_cast<float>(plan_.lambda());
+    auto step_size = static_cast<float>(step);
+    uint32_t k = k_;
+    katana::GAccumulator<double> squared_error;
+    for (uint64_t s = 0; s < num_blocks_; ++s) {
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_blocks_),
+          [&](uint64_t row) {
+            uint64_t t = row * num_blocks_ + (row + s) % num_blocks_;
+            double tile_error = 0;
+            for (uint64_t i = tile_begin_[t]; i != tile_begin_[t + 1]; ++i) {
+              const Rating& r = tiled_[i];
+              float* x = latent_ + uint64_t{r.src} * k;
+              float* y = latent_ + uint64_t{r.dest} * k;
+              float error = Dot(x, y, k) - r.value;
+              for (uint32_t j = 0; j < k; ++j) {
+                float xj = x[j];
+                float yj = y[j];
+                x[j] -= step_size * (error * yj + lambda * xj);
+                y[j] -= step_size * (error * xj + lambda * yj);
+              }
+              tile_error += double{error} * error;
+            }
+            squared_error += tile_error;
+          },
+          katana::steal(), katana::loopname("MatrixCompletion SgdDiagonal"));
+    }
+    return squared_error.reduce();
+  }
+
+  const katana::GraphTopology& topology_;
+  const float* ratings_;
+  float* latent_;
+  const MatrixCompletionPlan& plan_;
+  uint32_t k_;
+  uint64_t num_blocks_;
+
+  //! The row block of each left node and the column block of each right
+  //! node
+  katana::LargeArray<uint64_t> block_;
+  //! The ratings of tile t are [tile_begin_[t], tile_begin_[t + 1])
+  katana::LargeArray<uint64_t> tile_begin_;
+  katana::LargeArray<Rating> tiled_;
+};
+
+/**
+ * Alternating least squares. The latent vector of a node minimizes the
+ * squared error of its ratings plus lambda times its number of ratings
+ * times its squared norm, given the latent vectors of its neighbors: it
+ * solves (sum y y^T + lambda n I) x = sum r y over its ratings r with
+ * neighbors y.
+ */
+class Als {
+public:
+  Als(const katana::GraphTopology& topology, const float* ratings,
+      float* latent, const MatrixCompletionPlan& plan)
+      : topology_(topology),
+        ratings_(ratings),
+        latent_(latent),
+        plan_(plan),
+        k_(plan.latent_vector_size()) {}
+
+  void Run() {
+    BuildInEdges();
+
+    uint64_t num_ratings = std::max<uint64_t>(1, topology_.num_edges());
+    double previous_rmse = std::sqrt(
+        SquaredError(topology_, ratings_, latent_, k_) / num_ratings);
+    uint32_t iteration = 0;
+    while (iteration < plan_.max_iterations() && !katana::CancelRequested()) {
+      ++iteration;
+      katana::do_all(
+          katana::iterate(topology_),
+          [&](Node n) {
+            auto [first, last] = topology_.edge_range(n);
+            if (first != last) {
+              SolveLeft(n, first, last);
+            }
+          },
+          katana::steal(), katana::loopname("MatrixCompletion AlsLeft"));
+      katana::do_all(
+          katana::iterate(topology_),
+          [&](Node n) {
+            if (in_begin_[n] != in_begin_[n + 1]) {
+              SolveRight(n);
+            }
+          },
+          katana::steal(), katana::loopname("MatrixCompletion AlsRight"));
+
+      double rmse = std::sqrt(
+          SquaredError(topology_, ratings_, latent_, k_) / num_ratings);
+      if (previous_rmse - rmse < plan_.tolerance() * previous_rmse) {
+        break;
+      }
+      previous_rmse = rmse;
+    }
+
+    katana::ReportStatSingle("MatrixCompletion", "Iterations", iteration);
+  }
+
+private:
+  void BuildInEdges() {
+    uint64_t num_nodes = topology_.num_nodes();
+    katana::LargeArray<std::atomic<uint64_t>> cursor;
+    cursor.allocateBlocked(num_nodes);
+    in_begin_.allocateBlocked(num_nodes + 1);
+    katana::do_all(
+        katana::iterate(topology_), [&](Node n) { cursor.constructAt(n, 0); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            cursor[topology_.edge_dest(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    in_begin_[0] = 0;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          in_begin_[n + 1] = cursor[n].load(std::memory_order_relaxed);
+          cursor[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        in_begin_.begin() + 1, in_begin_.end(), in_begin_.begin() + 1);
+
+    in_src_.allocateBlocked(in_begin_[num_nodes]);
+    in_rating_.allocateBlocked(in_begin_[num_nodes]);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            Node dest = topology_.edge_dest(e);
+            uint64_t i = in_begin_[dest] +
+                         cursor[dest].fetch_add(1, std::memory_order_relaxed);
+            in_src_[i] = src;
+            in_rating_[i] = ratings_[e];
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // Sort the in-edges of each node so that the sums of SolveRight do not
+    // depend on the schedule above
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          uint64_t first = in_begin_[n];
+          uint64_t last = in_begin_[n + 1];
+          std::vector<std::pair<Node, float>> edges;
+          edges.reserve(last - first);
+          for (uint64_t i = first; i != last; ++i) {
+            edges.emplace_back(in_src_[i], in_rating_[i]);
+          }
+          std::sort(edges.begin(), edges.end());
+          for (uint64_t i = first; i != last; ++i) {
+            std::tie(in_src_[i], in_rating_[i]) = edges[i - first];
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  void SolveLeft(Node n, Edge first, Edge last) {
+    Solve(n, last - first, [&](auto&& fn) {
+      for (Edge e = first; e != last; ++e) {
+        fn(topology_.edge_dest(e), ratings_[e]);
+      }
+    });
+  }
+
+  void SolveRight(Node n) {
+    Solve(n, in_begin_[n + 1] - in_begin_[n], [&](auto&& fn) {
+      for (uint64_t i = in_begin_[n]; i != in_begin_[n + 1]; ++i) {
+        fn(in_src_[i], in_rating_[i]);
+      }
+    });
+  }
+
+  /// Solve the normal equations of node n, whose count ratings are visited
+  /// by for_each_rating
+  template <typename ForEachRating>
+  void Solve(Node n, uint64_t count, const ForEachRating& for_each_rating) {
+    uint32_t k = k_;
+    std::vector<double>& scratch = *scratch_.getLocal();
+    scratch.assign(uint64_t{k} * k + k, 0.0);
+    double* a = scratch.data();
+    double* b = a + uint64_t{k} * k;
+
+    for_each_rating([&](Node other, float rating) {
+      const float* y = latent_ + uint64_t{other} * k;
+      for (uint32_t i = 0; i < k; ++i) {
+        b[i] += double{rating} * y[i];
+        for (uint32_t j = 0; j <= i; ++j) {
+          a[i * k + j] += double{y[i]} * y[j];
+        }
+      }
+    });
+    double regularization = plan_.lambda() * count;
+    for (uint32_t i = 0; i < k; ++i) {
+      a[i * k + i] += regularization;
+    }
+
+    // Cholesky factorization of the lower triangle in place, a = L L^T
+    for (uint32_t j = 0; j < k; ++j) {
+      double pivot = a[j * k + j];
+      for (uint32_t p = 0; p < j; ++p) {
+        pivot -= a[j * k + p] * a[j * k + p];
+      }
+      if (!(pivot > 0)) {
+        // Singular without regularization; keep the old vector
+        return;
+      }
+      pivot = std::sqrt(pivot);
+      a[j * k + j] = pivot;
+      for (uint32_t i = j + 1; i < k; ++i) {
+        double v = a[i * k + j];
+        for (uint32_t p = 0; p < j; ++p) {
+          v -= a[i * k + p] * a[j * k + p];
+        }
+        a[i * k + j] = v / pivot;
+      }
+    }
+    // Solve L z = b, then L^T x = z, in place in b
+    for (uint32_t i = 0; i < k; ++i) {
+      double v = b[i];
+      for (uint32_t p = 0; p < i; ++p) {
+        v -= a[i * k + p] * b[p];
+      }
+      b[i] = v / a[i * k + i];
+    }
+    for (uint32_t i = k; i-- > 0;) {
+      double v = b[i];
+      for (uint32_t p = i + 1; p < k; ++p) {
+        v -= a[p * k + i] * b[p];
+      }
+      b[i] = v / a[i * k + i];
+    }
+
+    float* x = latent_ + uint64_t{n} * k;
+    for (uint32_t i = 0; i < k; ++i) {
+      x[i] = static_cast<float>(b[i]);
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const float* ratings_;
+  float* latent_;
+  const MatrixCompletionPlan& plan_;
+  uint32_t k_;
+
+  //! The in-edges of node n are [in_begin_[n], in_begin_[n + 1]), sorted by
+  //! source
+  katana::LargeArray<uint64_t> in_begin_;
+  katana::LargeArray<Node> in_src_;
+  katana::LargeArray<float> in_rating_;
+  katana::PerThreadStorage<std::vector<double>> scratch_;
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MatrixCompletion(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() == MatrixCompletionPlan::kSgd) {
+    if (auto r = CheckNotDeterministic(plan, "SGD matrix completion"); !r) {
+      return r.error();
+    }
+  }
+  if (plan.latent_vector_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "latent vectors must have at least one element");
+  }
+  if (pg->GetNodeProperty(output_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+  if (auto r = CheckBipartite(pg->topology()); !r) {
+    return r.error();
+  }
+
+  katana::LargeArray<float> ratings;
+  if (auto r = ReadRatings(pg, rating_property_name, &ratings); !r) {
+    return r.error();
+  }
+
+  uint32_t k = plan.latent_vector_size();
+  uint64_t num_values = pg->num_nodes() * k;
+  auto buffer_res = arrow::AllocateBuffer(num_values * sizeof(float));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating latent vectors: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* latent = reinterpret_cast<float*>(buffer->mutable_data());
+
+  katana::StatTimer exec_time("MatrixCompletion");
+  exec_time.start();
+  InitializeLatent(pg->topology(), ratings.data(), latent, k);
+  switch (plan.algorithm()) {
+  case MatrixCompletionPlan::kSgd: {
+    TiledSgd algo(pg->topology(), ratings.data(), latent, plan);
+    algo.Run();
+    break;
+  }
+  case MatrixCompletionPlan::kAls: {
+    Als algo(pg->topology(), ratings.data(), latent, plan);
+    algo.Run();
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  if (auto r = CheckCancelled(); !r) {
+    return r.error();
+  }
+
+  auto vectors = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::float32(), k), pg->num_nodes(),
+      std::make_shared<arrow::FloatArray>(num_values, buffer));
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, vectors->type())}),
+      {vectors}));
+}
+
+namespace {
+
+/// The sum of the squared errors of the latent vectors in property_name and
+/// of predicting 0
+katana::Result<std::pair<double, double>>
+SquaredErrors(
+    katana::PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& property_name) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<LatentVectors>, std::tuple<>>;
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const auto& vectors = graph.GetNodePropertyView<LatentVectors>();
+
+  katana::LargeArray<float> ratings;
+  if (auto r = ReadRatings(pg, rating_property_name, &ratings); !r) {
+    return r.error();
+  }
+
+  auto k = static_cast<uint32_t>(vectors.width());
+  double model =
+      SquaredError(pg->topology(), ratings.data(), vectors.data(), k);
+  double zero = katana::ParallelSTL::deterministic_map_reduce(
+      uint64_t{0}, pg->num_edges(),
+      [&](Edge e) { return double{ratings[e]} * ratings[e]; },
+      std::plus<double>(), 0.0);
+  return std::make_pair(model, zero);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MatrixCompletionAssertValid(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& property_name) {
+  auto errors_result = SquaredErrors(pg, rating_property_name, property_name);
+  if (!errors_result) {
+    return errors_result.error();
+  }
+  auto [model, zero] = errors_result.value();
+  if (!std::isfinite(model)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the latent vectors predict non-finite ratings");
+  }
+  if (zero > 0 && model >= zero) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the squared error of the predictions, {}, is no better than the {} "
+        "of predicting 0",
+        model, zero);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MatrixCompletionStatistics>
+katana::analytics::MatrixCompletionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& property_name) {
+  auto errors_result = SquaredErrors(pg, rating_property_name, property_name);
+  if (!errors_result) {
+    return errors_result.error();
+  }
+  uint64_t num_ratings = pg->num_edges();
+  double model = errors_result.value().first;
+  return MatrixCompletionStatistics{
+      num_ratings > 0 ? std::sqrt(model / num_ratings) : 0.0, num_ratings};
+}
+
+void
+katana::analytics::MatrixCompletionStatistics::Print(std::ostream& os) const {
+  os << "Root mean square error = " << rmse << std::endl;
+  os << "Number of ratings = " << num_ratings << std::endl;
+}
@@ -0,0 +1,696 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/WorkList.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Arc = uint64_t;
+
+template <typename Capacity>
+using EdgeCapacity = katana::PODProperty<Capacity>;
+
+template <typename Capacity>
+struct EdgeFlow {
+  using ArrowType = typename arrow::CTypeTraits<Capacity>::ArrowType;
+  using ViewType = katana::PODPropertyView<Capacity>;
+};
+
+template <typename Capacity>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeCapacity<Capacity>, EdgeFlow<Capacity>>>;
+
+/// The work charged for relabeling a node on top of scanning its arcs
+constexpr uint64_t kRelabelWork = 12;
+
+/// Call fn with a value of the C type of the edge property named
+/// capacity_property_name, or fail if it is not an integer.
+template <typename Fn>
+auto
+DispatchCapacityType(
+    const katana::PropertyGraph* pg, const std::string& capacity_property_name,
+    const Fn& fn) -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(capacity_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        capacity_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "edge capacities of type {} are not integers",
+        property->type()->ToString());
+  }
+}
+
+/// Capacities are summed as int64_t
+template <typename Capacity>
+bool
+IsValidCapacity(Capacity c) {
+  if constexpr (std::is_signed_v<Capacity>) {
+    return c >= 0;
+  } else {
+    return static_cast<uint64_t>(c) <=
+           static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  }
+}
+
+katana::Result<void>
+CheckTerminals(
+    const katana::PropertyGraph& pg, uint32_t source, uint32_t sink) {
+  if (source >= pg.num_nodes() || sink >= pg.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or sink {} is not a node", source, sink);
+  }
+  if (source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source and sink are both {}",
+        source);
+  }
+  return katana::ResultSuccess();
+}
+
+/**
+ * Parallel push-relabel on the residual network of the graph. Every edge
+ * u->v becomes a forward arc of u, holding the capacity of the edge, and a
+ * backward arc of v, holding none; the arcs of a node are contiguous.
+ *
+ * Discharging is lock-free (Hong and He): a node with excess is owned by
+ * the one thread that moved its excess from zero, which pushes to the
+ * lowest residual neighbor or relabels until the excess is gone. Other
+ * threads only add to the excess of the node and the residual capacity of
+ * its arcs. Nodes are discharged highest first.
+ *
+ * Discharging stops for a global relabel, a breadth-first search from the
+ * sink and then from the source over residual arcs, after a fixed amount of
+ * work or when a relabel leaves no node at some height under num_nodes
+ * (a gap), since the nodes above the gap can no longer reach the sink.
+ * Heights go up to 2 * num_nodes so that excess that cannot reach the sink
+ * flows back to the source and the result is a flow, not just a preflow.
+ */
+template <typename Capacity>
+class PushRelabel {
+  struct HeightIndexer {
+    const std::atomic<uint32_t>* height;
+    uint32_t unreached;
+
+    unsigned int operator()(Node n) const {
+      return unreached - height[n].load(std::memory_order_relaxed);
+    }
+  };
+
+  using OBIM = katana::OrderedByIntegerMetric<
+      HeightIndexer, katana::PerSocketChunkFIFO<16>>;
+
+public:
+  PushRelabel(
+      const katana::GraphTopology& topology, const Capacity* capacity,
+      Node source, Node sink, const MaxFlowPlan& plan)
+      : topology_(topology),
+        capacity_(capacity),
+        source_(source),
+        sink_(sink),
+        plan_(plan),
+        num_nodes_(topology.num_nodes()),
+        unreached_(2 * num_nodes_) {}
+
+  void Run() {
+    BuildResidualNetwork();
+    SaturateSource();
+
+    uint64_t interval = uint64_t{plan_.global_relabel_alpha()} * num_nodes_ +
+                        topology_.num_edges() / 3;
+    uint64_t local_interval =
+        std::max<uint64_t>(1, interval / katana::getActiveThreads());
+    katana::PerThreadStorage<uint64_t> work;
+    uint64_t global_relabels = 0;
+
+    while (!katana::CancelRequested()) {
+      GlobalRelabel();
+      ++global_relabels;
+
+      katana::InsertBag<Node> active;
+      katana::do_all(
+          katana::iterate(topology_),
+          [&](Node n) {
+            if (n != source_ && n != sink_ &&
+                height_[n].load(std::memory_order_relaxed) < unreached_ &&
+                excess_[n].load(std::memory_order_relaxed) > 0) {
+              active.push(n);
+            }
+          },
+          katana::no_stats());
+      if (active.empty()) {
+        break;
+      }
+
+      katana::on_each([&](unsigned, unsigned) { *work.getLocal() = 0; });
+      relabel_needed_.store(false, std::memory_order_relaxed);
+      katana::for_each(
+          katana::iterate(active),
+          [&](Node n, auto& ctx) {
+            uint64_t& my_work = *work.getLocal();
+            Discharge(n, ctx, &my_work);
+            if (my_work >= local_interval ||
+                relabel_needed_.load(std::memory_order_relaxed)) {
+              relabel_needed_.store(true, std::memory_order_relaxed);
+              ctx.breakLoop();
+            }
+          },
+          katana::wl<OBIM>(HeightIndexer{height_.data(), unreached_}),
+          katana::parallel_break(), katana::disable_conflict_detection(),
+          katana::loopname("MaxFlow Discharge"));
+      if (!relabel_needed_.load(std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    katana::ReportStatSingle("MaxFlow", "GlobalRelabels", global_relabels);
+  }
+
+  /// The flow on each edge is what its forward arc lost
+  void WriteFlows(Capacity* flow) const {
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          auto [first, last] = topology_.edge_range(src);
+          for (Edge e = first; e != last; ++e) {
+            int64_t residual = residual_[arc_begin_[src] + (e - first)].load(
+                std::memory_order_relaxed);
+            flow[e] = static_cast<Capacity>(
+                static_cast<int64_t>(capacity_[e]) - residual);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+private:
+  void BuildResidualNetwork() {
+    // Count in-degrees in cursor_, then reuse it to place backward arcs
+    cursor_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(topology_), [&](Node n) { cursor_.constructAt(n, 0); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            cursor_[topology_.edge_dest(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    arc_begin_.allocateBlocked(num_nodes_ + 1);
+    arc_begin_[0] = 0;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          auto [first, last] = topology_.edge_range(n);
+          arc_begin_[n + 1] =
+              (last - first) + cursor_[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        arc_begin_.begin() + 1, arc_begin_.end(), arc_begin_.begin() + 1);
+
+    uint64_t num_arcs = arc_begin_[num_nodes_];
+    arc_dest_.allocateBlocked(num_arcs);
+    arc_reverse_.allocateBlocked(num_arcs);
+    residual_.allocateBlocked(num_arcs);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          auto [first, last] = topology_.edge_range(n);
+          cursor_[n].store(
+              arc_begin_[n] + (last - first), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          auto [first, last] = topology_.edge_range(src);
+          for (Edge e = first; e != last; ++e) {
+            Node dest = topology_.edge_dest(e);
+            Arc forward = arc_begin_[src] + (e - first);
+            Arc backward =
+                cursor_[dest].fetch_add(1, std::memory_order_relaxed);
+            arc_dest_[forward] = dest;
+            arc_dest_[backward] = src;
+            arc_reverse_[forward] = backward;
+            arc_reverse_[backward] = forward;
+            residual_.constructAt(forward, static_cast<int64_t>(capacity_[e]));
+            residual_.constructAt(backward, 0);
+          }
+        },
+        katana::steal(), katana::loopname("MaxFlow BuildResidual"));
+    cursor_.destroy();
+    cursor_.deallocate();
+
+    excess_.allocateBlocked(num_nodes_);
+    height_.allocateBlocked(num_nodes_);
+    height_count_.allocateBlocked(unreached_ + 1);
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          excess_.constructAt(n, 0);
+          height_.constructAt(n, 0);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{unreached_} + 1),
+        [&](uint64_t h) { height_count_.constructAt(h, 0); },
+        katana::no_stats());
+  }
+
+  /// Push as much as the arcs of the source allow
+  void SaturateSource() {
+    katana::do_all(
+        katana::iterate(arc_begin_[source_], arc_begin_[source_ + 1]),
+        [&](Arc a) {
+          Node dest = arc_dest_[a];
+          int64_t amount = residual_[a].load(std::memory_order_relaxed);
+          if (dest == source_ || amount == 0) {
+            return;
+          }
+          residual_[a].store(0, std::memory_order_relaxed);
+          residual_[arc_reverse_[a]].fetch_add(
+              amount, std::memory_order_relaxed);
+          excess_[dest].fetch_add(amount, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  /// Set every height to the residual distance to the sink or, failing
+  /// that, num_nodes plus the residual distance to the source
+  void GlobalRelabel() {
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          height_[n].store(unreached_, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    height_[sink_].store(0, std::memory_order_relaxed);
+    height_[source_].store(num_nodes_, std::memory_order_relaxed);
+    SearchFrom(sink_);
+    SearchFrom(source_);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{unreached_} + 1),
+        [&](uint64_t h) {
+          height_count_[h].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          height_count_[height_[n].load(std::memory_order_relaxed)].fetch_add(
+              1, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  /// Breadth-first search backwards over residual arcs from root, giving
+  /// each unreached node one more than the height of its parent
+  void SearchFrom(Node root) {
+    katana::InsertBag<Node> frontier;
+    katana::InsertBag<Node> next;
+    frontier.push(root);
+    while (!frontier.empty()) {
+      katana::do_all(
+          katana::iterate(frontier),
+          [&](Node n) {
+            uint32_t h = height_[n].load(std::memory_order_relaxed) + 1;
+            for (Arc a = arc_begin_[n]; a != arc_begin_[n + 1]; ++a) {
+              if (residual_[arc_reverse_[a]].load(std::memory_order_relaxed) ==
+                  0) {
+                continue;
+              }
+              Node dest = arc_dest_[a];
+              uint32_t expected = unreached_;
+              if (height_[dest].load(std::memory_order_relaxed) == expected &&
+                  height_[dest].compare_exchange_strong(
+                      expected, h, std::memory_order_relaxed)) {
+                next.push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::loopname("MaxFlow GlobalRelabel"));
+      frontier.clear();
+      frontier.swap(next);
+    }
+  }
+
+  /// Push the excess of n to its lowest residual neighbors, relabeling n
+  /// when none is lower, until n has no excess. Only the owner of n calls
+  /// this.
+  template <typename Context>
+  void Discharge(Node n, Context& ctx, uint64_t* work) {
+    const Arc first = arc_begin_[n];
+    const Arc last = arc_begin_[n + 1];
+    while (true) {
+      uint32_t height = height_[n].load(std::memory_order_relaxed);
+      Arc lowest = last;
+      uint32_t lowest_height = unreached_;
+      for (Arc a = first; a != last; ++a) {
+        if (residual_[a].load(std::memory_order_relaxed) == 0) {
+          continue;
+        }
+        uint32_t h = height_[arc_dest_[a]].load(std::memory_order_relaxed);
+        if (h < lowest_height) {
+          lowest = a;
+          lowest_height = h;
+        }
+      }
+      // Excess came in over an arc whose reverse is still residual
+      KATANA_LOG_DEBUG_ASSERT(lowest != last);
+      if (lowest == last) {
+        return;
+      }
+
+      if (height > lowest_height) {
+        int64_t amount = std::min(
+            excess_[n].load(std::memory_order_acquire),
+            residual_[lowest].load(std::memory_order_relaxed));
+        residual_[lowest].fetch_sub(amount, std::memory_order_relaxed);
+        residual_[arc_reverse_[lowest]].fetch_add(
+            amount, std::memory_order_relaxed);
+        *work += 1;
+
+        Node dest = arc_dest_[lowest];
+        if (excess_[dest].fetch_add(amount, std::memory_order_acq_rel) == 0 &&
+            dest != source_ && dest != sink_) {
+          ctx.push(dest);
+        }
+        if (excess_[n].fetch_sub(amount, std::memory_order_acq_rel) ==
+            amount) {
+          return;
+        }
+        continue;
+      }
+
+      uint32_t new_height = lowest_height + 1;
+      height_[n].store(new_height, std::memory_order_relaxed);
+      height_count_[new_height].fetch_add(1, std::memory_order_relaxed);
+      if (height_count_[height].fetch_sub(1, std::memory_order_relaxed) == 1 &&
+          height < num_nodes_) {
+        relabel_needed_.store(true, std::memory_order_relaxed);
+      }
+      *work += (last - first) + kRelabelWork;
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const Capacity* capacity_;
+  Node source_;
+  Node sink_;
+  const MaxFlowPlan& plan_;
+  uint32_t num_nodes_;
+  //! Height of the nodes that cannot reach the sink or the source
+  uint32_t unreached_;
+
+  //! The arcs of node n are [arc_begin_[n], arc_begin_[n + 1])
+  katana::LargeArray<Arc> arc_begin_;
+  katana::LargeArray<Node> arc_dest_;
+  katana::LargeArray<Arc> arc_reverse_;
+  katana::LargeArray<std::atomic<int64_t>> residual_;
+  katana::LargeArray<std::atomic<uint64_t>> cursor_;
+
+  katana::LargeArray<std::atomic<int64_t>> excess_;
+  katana::LargeArray<std::atomic<uint32_t>> height_;
+  //! The number of nodes at each height, for gap detection
+  katana::LargeArray<std::atomic<uint32_t>> height_count_;
+  std::atomic<bool> relabel_needed_{false};
+};
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowImpl(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, const MaxFlowPlan& plan) {
+  if (auto r = ConstructEdgeProperties<std::tuple<EdgeFlow<Capacity>>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph<Capacity>::Make(
+      pg, {}, {capacity_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Capacity* capacity =
+      graph.template GetEdgePropertyView<EdgeCapacity<Capacity>>().data();
+  Capacity* flow =
+      graph.template GetEdgePropertyView<EdgeFlow<Capacity>>().data();
+
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) { invalid.update(!IsValidCapacity(capacity[e])); },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge capacities must be non-negative int64 values");
+  }
+
+  katana::StatTimer exec_time("MaxFlow");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case MaxFlowPlan::kPushRelabel: {
+    PushRelabel<Capacity> algo(pg->topology(), capacity, source, sink, plan);
+    algo.Run();
+    algo.WriteFlows(flow);
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return CheckCancelled();
+}
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowAssertValidImpl(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& property_name) {
+  auto pg_result =
+      Graph<Capacity>::Make(pg, {}, {capacity_property_name, property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Capacity* capacity =
+      graph.template GetEdgePropertyView<EdgeCapacity<Capacity>>().data();
+  const Capacity* flow =
+      graph.template GetEdgePropertyView<EdgeFlow<Capacity>>().data();
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  std::vector<int64_t> net_inflow(num_nodes);
+  std::vector<uint64_t> in_begin(num_nodes + 1);
+  for (Node src = 0; src < num_nodes; ++src) {
+    for (Edge e : topology.edges(src)) {
+      if (!IsValidCapacity(flow[e]) || flow[e] > capacity[e]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "flow {} on edge {} is outside of [0, {}]", flow[e], e,
+            capacity[e]);
+      }
+      Node dest = topology.edge_dest(e);
+      net_inflow[dest] += static_cast<int64_t>(flow[e]);
+      net_inflow[src] -= static_cast<int64_t>(flow[e]);
+      in_begin[dest + 1] += 1;
+    }
+  }
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (n != source && n != sink && net_inflow[n] != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "flow is not conserved at node {}: {} more in than out", n,
+          net_inflow[n]);
+    }
+  }
+
+  // The in-edges of each node, to search the residual graph backwards
+  std::partial_sum(in_begin.begin(), in_begin.end(), in_begin.begin());
+  std::vector<uint64_t> in_cursor(in_begin.begin(), in_begin.end() - 1);
+  std::vector<Edge> in_edges(topology.num_edges());
+  std::vector<Node> in_srcs(topology.num_edges());
+  for (Node src = 0; src < num_nodes; ++src) {
+    for (Edge e : topology.edges(src)) {
+      uint64_t i = in_cursor[topology.edge_dest(e)]++;
+      in_edges[i] = e;
+      in_srcs[i] = src;
+    }
+  }
+
+  std::vector<bool> reached(num_nodes);
+  std::deque<Node> queue{source};
+  reached[source] = true;
+  auto visit = [&](Node n) {
+    if (!reached[n]) {
+      reached[n] = true;
+      queue.push_back(n);
+    }
+  };
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (Edge e : topology.edges(n)) {
+      if (flow[e] < capacity[e]) {
+        visit(topology.edge_dest(e));
+      }
+    }
+    for (uint64_t i = in_begin[n]; i != in_begin[n + 1]; ++i) {
+      if (flow[in_edges[i]] > 0) {
+        visit(in_srcs[i]);
+      }
+    }
+  }
+  if (reached[sink]) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the flow is not maximum: there is an augmenting path");
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+katana::Result<MaxFlowStatistics>
+MaxFlowStatisticsImpl(
+    katana::PropertyGraph* pg, uint32_t source,
+    const std::string& capacity_property_name,
+    const std::string& property_name) {
+  auto pg_result =
+      Graph<Capacity>::Make(pg, {}, {capacity_property_name, property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Capacity* capacity =
+      graph.template GetEdgePropertyView<EdgeCapacity<Capacity>>().data();
+  const Capacity* flow =
+      graph.template GetEdgePropertyView<EdgeFlow<Capacity>>().data();
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::GAccumulator<int64_t> source_outflow;
+  katana::GAccumulator<uint64_t> flow_edges;
+  katana::GAccumulator<uint64_t> saturated_edges;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        for (Edge e : topology.edges(src)) {
+          if (src == source) {
+            source_outflow += static_cast<int64_t>(flow[e]);
+          }
+          if (topology.edge_dest(e) == source) {
+            source_outflow -= static_cast<int64_t>(flow[e]);
+          }
+          flow_edges += flow[e] > 0;
+          saturated_edges += flow[e] > 0 && flow[e] == capacity[e];
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow Statistics"),
+      katana::no_stats());
+
+  return MaxFlowStatistics{
+      static_cast<uint64_t>(std::max<int64_t>(0, source_outflow.reduce())),
+      flow_edges.reduce(), saturated_edges.reduce()};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckTerminals(*pg, source, sink); !r) {
+    return r.error();
+  }
+  return DispatchCapacityType(
+      pg, capacity_property_name, [&](auto zero) -> Result<void> {
+        return MaxFlowImpl<decltype(zero)>(
+            pg, source, sink, capacity_property_name, output_property_name,
+            plan);
+      });
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& property_name) {
+  if (auto r = CheckTerminals(*pg, source, sink); !r) {
+    return r.error();
+  }
+  return DispatchCapacityType(
+      pg, capacity_property_name, [&](auto zero) -> Result<void> {
+        return MaxFlowAssertValidImpl<decltype(zero)>(
+            pg, source, sink, capacity_property_name, property_name);
+      });
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t source,
+    const std::string& capacity_property_name,
+    const std::string& property_name) {
+  if (source >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source {} is not a node",
+        source);
+  }
+  return DispatchCapacityType(
+      pg, capacity_property_name,
+      [&](auto zero) -> Result<MaxFlowStatistics> {
+        return MaxFlowStatisticsImpl<decltype(zero)>(
+            pg, source, capacity_property_name, property_name);
+      });
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Flow value = " << flow_value << std::endl;
+  os << "Number of edges with flow = " << n_flow_edges << std::endl;
+  os << "Number of saturated edges = " << n_saturated_edges << std::endl;
+}
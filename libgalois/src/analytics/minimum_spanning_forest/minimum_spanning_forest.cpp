@@ -0,0 +1,532 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+template <typename Weight>
+using EdgeWeight = katana::PODProperty<Weight>;
+using ForestMask = katana::PODProperty<uint8_t>;
+
+template <typename Weight>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeWeight<Weight>, ForestMask>>;
+
+constexpr Edge kNoEdge = std::numeric_limits<Edge>::max();
+
+/// The number of edges sampled to pick each FilterKruskal pivot
+constexpr uint32_t kPivotSamples = 1024;
+
+/// Call fn with a value of the C type of the edge property named
+/// edge_weight_property_name, or fail if it is not a number.
+template <typename Fn>
+auto
+DispatchWeightType(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name, const Fn& fn)
+    -> decltype(fn(uint32_t{})) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "edge weights of type {} are not numbers",
+        property->type()->ToString());
+  }
+}
+
+/// Lock-free union-find over the nodes. Roots are always hooked from the
+/// larger id to the smaller one, so concurrent unions cannot form a cycle.
+class ForestUnionFind {
+public:
+  explicit ForestUnionFind(uint64_t num_nodes) {
+    parent_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { parent_[n] = n; }, katana::no_stats());
+  }
+
+  Node Find(Node n) const {
+    Node p = parent(n);
+    while (p != n) {
+      n = p;
+      p = parent(n);
+    }
+    return n;
+  }
+
+  /// Join the trees of u and v. Return false if they were already joined.
+  bool Union(Node u, Node v) {
+    while (true) {
+      Node a = Find(u);
+      Node b = Find(v);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      if (__sync_bool_compare_and_swap(&parent_[a], a, b)) {
+        return true;
+      }
+    }
+  }
+
+  /// Point node directly at the root of its tree
+  void Compress(Node n) {
+    __atomic_store_n(&parent_[n], Find(n), __ATOMIC_RELAXED);
+  }
+
+private:
+  Node parent(Node n) const {
+    return __atomic_load_n(&parent_[n], __ATOMIC_RELAXED);
+  }
+
+  katana::LargeArray<Node> parent_;
+};
+
+/// Edges are ordered by weight and then by id. Every edge is distinct in
+/// this order, so the minimum spanning forest is unique.
+template <typename Weight>
+class EdgeOrder {
+public:
+  explicit EdgeOrder(const Weight* weight) : weight_(weight) {}
+
+  bool Lighter(Edge a, Edge b) const {
+    return weight_[a] < weight_[b] || (weight_[a] == weight_[b] && a < b);
+  }
+
+private:
+  const Weight* weight_;
+};
+
+/**
+ * Boruvka's algorithm. Each round every component picks its lightest edge
+ * to another component and the components are joined along the picked
+ * edges; since edges are totally ordered, no two components pick different
+ * edges between them and the picked edges form no cycles. Each round only
+ * revisits the edges that joined two components in the round before.
+ */
+template <typename Weight>
+class BoruvkaForest {
+  struct Candidate {
+    Node src;
+    Node dest;
+    Edge edge;
+  };
+  using CandidateBag = katana::InsertBag<Candidate>;
+
+public:
+  BoruvkaForest(
+      const katana::GraphTopology& topology, const Weight* weight,
+      uint8_t* in_forest)
+      : topology_(topology),
+        order_(weight),
+        in_forest_(in_forest),
+        uf_(topology.num_nodes()) {
+    lightest_.allocateBlocked(topology.num_nodes());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) { lightest_[n].store(kNoEdge, std::memory_order_relaxed); },
+        katana::no_stats());
+  }
+
+  void Run() {
+    CandidateBag current;
+    CandidateBag next;
+    size_t rounds = 0;
+
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          Node src_root = uf_.Find(src);
+          for (Edge e : topology_.edges(src)) {
+            Visit(src_root, Candidate{src, topology_.edge_dest(e), e}, &next);
+          }
+        },
+        katana::steal(), katana::loopname("Boruvka-FindLightest"));
+
+    while (!next.empty()) {
+      rounds += 1;
+      Link();
+
+      current.clear();
+      current.swap(next);
+      katana::do_all(
+          katana::iterate(current),
+          [&](const Candidate& c) { Visit(uf_.Find(c.src), c, &next); },
+          katana::steal(), katana::loopname("Boruvka-FindLightest"));
+    }
+
+    katana::ReportStatSingle("Boruvka", "rounds", rounds);
+  }
+
+private:
+  /// Keep c if it joins two components and offer it to both of them
+  void Visit(Node src_root, const Candidate& c, CandidateBag* next) {
+    Node dest_root = uf_.Find(c.dest);
+    if (src_root == dest_root) {
+      return;
+    }
+    next->push(c);
+    UpdateLightest(src_root, c.edge);
+    UpdateLightest(dest_root, c.edge);
+  }
+
+  void UpdateLightest(Node root, Edge e) {
+    Edge old = lightest_[root].load(std::memory_order_relaxed);
+    while ((old == kNoEdge || order_.Lighter(e, old)) &&
+           !lightest_[root].compare_exchange_weak(
+               old, e, std::memory_order_relaxed)) {
+    }
+  }
+
+  /// Join the components along their lightest edges. Two components that
+  /// picked the same edge join once, so it is only added once.
+  void Link() {
+    const uint64_t* indices = topology_.out_indices->raw_values();
+    const uint32_t* dests = topology_.out_dests->raw_values();
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node root) {
+          Edge e = lightest_[root].load(std::memory_order_relaxed);
+          if (e == kNoEdge) {
+            return;
+          }
+          lightest_[root].store(kNoEdge, std::memory_order_relaxed);
+          Node src =
+              std::upper_bound(indices, indices + topology_.num_nodes(), e) -
+              indices;
+          if (uf_.Union(src, dests[e])) {
+            in_forest_[e] = 1;
+          }
+        },
+        katana::loopname("Boruvka-Link"));
+    katana::do_all(
+        katana::iterate(topology_), [&](Node n) { uf_.Compress(n); },
+        katana::no_stats());
+  }
+
+  const katana::GraphTopology& topology_;
+  EdgeOrder<Weight> order_;
+  uint8_t* in_forest_;
+  ForestUnionFind uf_;
+  //! The lightest edge leaving each component, indexed by its root
+  katana::LargeArray<std::atomic<Edge>> lightest_;
+};
+
+template <typename Weight>
+struct WeightedEdge {
+  Weight weight;
+  Node src;
+  Node dest;
+  Edge edge;
+
+  bool operator<(const WeightedEdge& other) const {
+    return weight < other.weight ||
+           (weight == other.weight && edge < other.edge);
+  }
+};
+
+/**
+ * Filter-Kruskal. The edges are partitioned around a pivot; the light side
+ * is solved first, after which the heavy edges inside one component can be
+ * dropped without being sorted. Parts of at most kruskal_threshold edges are
+ * sorted and run through Kruskal's algorithm.
+ */
+template <typename Weight>
+class FilterKruskalForest {
+  using WEdge = WeightedEdge<Weight>;
+
+public:
+  FilterKruskalForest(
+      const katana::GraphTopology& topology, const Weight* weight,
+      uint8_t* in_forest, uint32_t kruskal_threshold)
+      : topology_(topology),
+        weight_(weight),
+        in_forest_(in_forest),
+        kruskal_threshold_(std::max(kruskal_threshold, kPivotSamples)),
+        uf_(topology.num_nodes()) {}
+
+  void Run() {
+    katana::LargeArray<WEdge> edges;
+    edges.allocateInterleaved(topology_.num_edges());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            edges[e] = WEdge{weight_[e], src, topology_.edge_dest(e), e};
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    Solve(edges.data(), edges.data() + topology_.num_edges());
+  }
+
+private:
+  void Solve(WEdge* first, WEdge* last) {
+    if (last - first <= kruskal_threshold_) {
+      Kruskal(first, last);
+      return;
+    }
+
+    WEdge pivot = SamplePivot(first, last);
+    WEdge* mid = katana::ParallelSTL::partition(
+        first, last, [&](const WEdge& e) { return !(pivot < e); });
+    if (mid == last) {
+      Kruskal(first, last);
+      return;
+    }
+    Solve(first, mid);
+
+    WEdge* kept = katana::ParallelSTL::partition(
+        mid, last,
+        [&](const WEdge& e) { return uf_.Find(e.src) != uf_.Find(e.dest); });
+    Solve(mid, kept);
+  }
+
+  /// The median of a sample of the edges; the sample is taken from a fixed
+  /// seed so that runs are repeatable
+  WEdge SamplePivot(WEdge* first, WEdge* last) {
+    std::uniform_int_distribution<uint64_t> dist(0, last - first - 1);
+    std::vector<WEdge> sample(kPivotSamples);
+    for (auto& s : sample) {
+      s = first[dist(gen_)];
+    }
+    std::nth_element(
+        sample.begin(), sample.begin() + sample.size() / 2, sample.end());
+    return sample[sample.size() / 2];
+  }
+
+  void Kruskal(WEdge* first, WEdge* last) {
+    katana::ParallelSTL::sort(first, last);
+    for (; first != last; ++first) {
+      if (uf_.Union(first->src, first->dest)) {
+        in_forest_[first->edge] = 1;
+      }
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const Weight* weight_;
+  uint8_t* in_forest_;
+  int64_t kruskal_threshold_;
+  ForestUnionFind uf_;
+  std::mt19937 gen_{0};
+};
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    const MinimumSpanningForestPlan& plan) {
+  if (auto r = ConstructEdgeProperties<std::tuple<ForestMask>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Weight* weight =
+      graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data();
+  uint8_t* in_forest = graph.template GetEdgePropertyView<ForestMask>().data();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) { in_forest[e] = 0; }, katana::no_stats());
+
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case MinimumSpanningForestPlan::kBoruvka: {
+    BoruvkaForest<Weight> algo(pg->topology(), weight, in_forest);
+    algo.Run();
+    break;
+  }
+  case MinimumSpanningForestPlan::kFilterKruskal: {
+    FilterKruskalForest<Weight> algo(
+        pg->topology(), weight, in_forest, plan.kruskal_threshold());
+    algo.Run();
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestAssertValidImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto pg_result =
+      Graph<Weight>::Make(pg, {}, {edge_weight_property_name, property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Weight* weight =
+      graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data();
+  const uint8_t* in_forest =
+      graph.template GetEdgePropertyView<ForestMask>().data();
+  const katana::GraphTopology& topology = pg->topology();
+
+  std::vector<WeightedEdge<Weight>> edges;
+  edges.reserve(topology.num_edges());
+  for (Node src = 0; src < topology.num_nodes(); ++src) {
+    for (Edge e : topology.edges(src)) {
+      edges.emplace_back(
+          WeightedEdge<Weight>{weight[e], src, topology.edge_dest(e), e});
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+
+  std::vector<Node> parent(topology.num_nodes());
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    parent[n] = n;
+  }
+  auto find = [&](Node n) {
+    while (parent[n] != n) {
+      parent[n] = parent[parent[n]];
+      n = parent[n];
+    }
+    return n;
+  };
+
+  for (const auto& e : edges) {
+    Node a = find(e.src);
+    Node b = find(e.dest);
+    bool expected = a != b;
+    if (expected) {
+      parent[a] = b;
+    }
+    if (expected != bool(in_forest[e.edge])) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "edge {} ({}, {}) is {}in the forest but should {}be", e.edge,
+          e.src, e.dest, expected ? "not " : "", expected ? "" : "not ");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<MinimumSpanningForestStatistics>
+MinimumSpanningForestStatisticsImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto pg_result =
+      Graph<Weight>::Make(pg, {}, {edge_weight_property_name, property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const Weight* weight =
+      graph.template GetEdgePropertyView<EdgeWeight<Weight>>().data();
+  const uint8_t* in_forest =
+      graph.template GetEdgePropertyView<ForestMask>().data();
+
+  katana::GAccumulator<uint64_t> forest_edges;
+  katana::GAccumulator<double> total_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) {
+        if (in_forest[e]) {
+          forest_edges += 1;
+          total_weight += static_cast<double>(weight[e]);
+        }
+      },
+      katana::loopname("MinimumSpanningForest Statistics"), katana::no_stats());
+
+  // Every edge of a forest joins two trees
+  uint64_t num_forest_edges = forest_edges.reduce();
+  return MinimumSpanningForestStatistics{
+      num_forest_edges, pg->num_nodes() - num_forest_edges,
+      total_weight.reduce()};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<void> {
+        return MinimumSpanningForestImpl<decltype(zero)>(
+            pg, edge_weight_property_name, output_property_name, plan);
+      });
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  return DispatchWeightType(
+      pg, edge_weight_property_name, [&](auto zero) -> Result<void> {
+        return MinimumSpanningForestAssertValidImpl<decltype(zero)>(
+            pg, edge_weight_property_name, property_name);
+      });
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  return DispatchWeightType(
+      pg, edge_weight_property_name,
+      [&](auto zero) -> Result<MinimumSpanningForestStatistics> {
+        return MinimumSpanningForestStatisticsImpl<decltype(zero)>(
+            pg, edge_weight_property_name, property_name);
+      });
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of edges in the forest = " << forest_edges << std::endl;
+  os << "Number of trees in the forest = " << trees << std::endl;
+  os << "Total weight of the forest = " << total_weight << std::endl;
+}
@@ -0,0 +1,187 @@
+#include "katana/analytics/neighbor_similarity/neighbor_similarity.h"
+
+#include <cmath>
+
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/VectorSimilarity.h"
+
+using namespace katana::analytics;
+
+using NodeData = std::tuple<NodeEmbedding>;
+using EdgeData = std::tuple<EdgeSimilarity>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+namespace {
+
+/// Score every edge with the dot product of the embeddings of its endpoints
+/// or, if kCosine, the dot product divided by their norms. Edges with a null
+/// embedding at either end score 0.
+template <bool kCosine>
+void
+ScoreEdges(Graph* graph) {
+  const auto& embeddings = graph->GetNodePropertyView<NodeEmbedding>();
+  size_t width = embeddings.width();
+
+  // The norm of each embedding is needed by each of its edges, so compute
+  // it once per node
+  katana::LargeArray<float> norms;
+  if constexpr (kCosine) {
+    norms.allocateBlocked(graph->size());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& n) {
+          const float* row = embeddings.GetValue(n);
+          norms[n] = std::sqrt(DotProduct(row, row, width));
+        },
+        katana::no_stats(), katana::loopname("NeighborSimilarityNorms"));
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& src) {
+        const float* src_row = embeddings.GetValue(src);
+        bool src_valid = embeddings.IsValid(src);
+        for (auto e : graph->edges(src)) {
+          GNode dest = *graph->GetEdgeDest(e);
+          float score = 0;
+          if (src_valid && embeddings.IsValid(dest)) {
+            score = DotProduct(src_row, embeddings.GetValue(dest), width);
+            if constexpr (kCosine) {
+              float norm = norms[src] * norms[dest];
+              score = norm > 0 ? score / norm : 0;
+            }
+          }
+          graph->GetEdgeData<EdgeSimilarity>(e) = score;
+        }
+      },
+      katana::steal(), katana::loopname("NeighborSimilarity"));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::NeighborSimilarity(
+    PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& output_property_name, NeighborSimilarityPlan plan) {
+  if (auto result =
+          ConstructEdgeProperties<EdgeData>(pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result =
+      Graph::Make(pg, {embedding_property_name}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  switch (plan.metric()) {
+  case NeighborSimilarityPlan::kDotProduct:
+    ScoreEdges<false>(&pg_result.value());
+    break;
+  case NeighborSimilarityPlan::kCosine:
+    ScoreEdges<true>(&pg_result.value());
+    break;
+  }
+
+  return katana::ResultSuccess();
+}
+
+constexpr static const double EPSILON = 1e-4;
+
+katana::Result<void>
+katana::analytics::NeighborSimilarityAssertValid(
+    katana::PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& property_name, NeighborSimilarityPlan plan) {
+  auto pg_result = Graph::Make(pg, {embedding_property_name}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const Graph& graph = pg_result.value();
+  const auto& embeddings = graph.GetNodePropertyView<NodeEmbedding>();
+  size_t width = embeddings.width();
+
+  // Recompute each score sequentially in double precision. The error of the
+  // float kernels grows with the norms of the embeddings.
+  auto is_bad = [&](const GNode& src) {
+    for (auto e : graph.edges(src)) {
+      GNode dest = *graph.GetEdgeDest(e);
+      double expected = 0;
+      double norm = 1;
+      if (embeddings.IsValid(src) && embeddings.IsValid(dest)) {
+        const float* a = embeddings.GetValue(src);
+        const float* b = embeddings.GetValue(dest);
+        double dot = 0;
+        double a_norm = 0;
+        double b_norm = 0;
+        for (size_t i = 0; i < width; ++i) {
+          dot += double{a[i]} * b[i];
+          a_norm += double{a[i]} * a[i];
+          b_norm += double{b[i]} * b[i];
+        }
+        norm = std::sqrt(a_norm * b_norm);
+        expected = dot;
+        if (plan.metric() == NeighborSimilarityPlan::kCosine) {
+          expected = norm > 0 ? dot / norm : 0;
+          norm = 1;
+        }
+      }
+      double score = graph.GetEdgeData<EdgeSimilarity>(e);
+      if (std::abs(score - expected) > EPSILON * (1 + norm)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<NeighborSimilarityStatistics>
+katana::analytics::NeighborSimilarityStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = katana::TypedPropertyGraph<std::tuple<>, EdgeData>::Make(
+      pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const float* similarities =
+      pg_result.value().GetEdgePropertyView<EdgeSimilarity>().data();
+
+  katana::GReduceMax<double> max_similarity;
+  katana::GReduceMin<double> min_similarity;
+  katana::GAccumulator<double> total_similarity;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) {
+        double similarity = similarities[e];
+        max_similarity.update(similarity);
+        min_similarity.update(similarity);
+        total_similarity += similarity;
+      },
+      katana::loopname("NeighborSimilarity Statistics"), katana::no_stats());
+
+  uint64_t num_edges = pg->num_edges();
+  return NeighborSimilarityStatistics{
+      max_similarity.reduce(), min_similarity.reduce(),
+      num_edges > 0 ? total_similarity.reduce() / num_edges : 0};
+}
+
+void
+katana::analytics::NeighborSimilarityStatistics::Print(std::ostream& os) {
+  os << "Maximum similarity = " << max_similarity << std::endl;
+  os << "Minimum similarity = " << min_similarity << std::endl;
+  os << "Average similarity = " << average_similarity << std::endl;
+}
@@ -37,6 +37,10 @@ katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
 
+katana::Result<void> PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan);
+
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
@@ -49,4 +53,10 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
 
+katana::Result<void> PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& removed_edges,
+    katana::analytics::PagerankPlan plan);
+
 #endif
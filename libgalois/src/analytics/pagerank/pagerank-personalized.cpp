@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using katana::analytics::PersonalizedPagerankPlan;
+using katana::analytics::PersonalizedRanks;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The rank and the residual of a node touched by a forward push query
+struct PushEntry {
+  double rank{0};
+  double residual{0};
+  bool queued{false};
+};
+
+/// The per-thread state of a query, kept between queries so that its
+/// storage is reused
+struct Scratch {
+  std::unordered_map<Node, PushEntry> entries;
+  std::unordered_map<Node, uint32_t> counts;
+  std::vector<Node> queue;
+};
+
+/// Keep the top_k highest ranks of ranks (all if top_k is 0), sorted by
+/// decreasing rank and then by node
+void
+SortRanks(uint32_t top_k, PersonalizedRanks* ranks) {
+  auto higher = [](const auto& a, const auto& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  };
+  if (top_k != 0 && top_k < ranks->size()) {
+    std::partial_sort(
+        ranks->begin(), ranks->begin() + top_k, ranks->end(), higher);
+    ranks->resize(top_k);
+  } else {
+    std::sort(ranks->begin(), ranks->end(), higher);
+  }
+}
+
+void
+ForwardPush(
+    const katana::GraphTopology& topology, Node seed,
+    const PersonalizedPagerankPlan& plan, Scratch* scratch,
+    PersonalizedRanks* ranks) {
+  auto& entries = scratch->entries;
+  auto& queue = scratch->queue;
+  entries.clear();
+  queue.clear();
+
+  double alpha = plan.alpha();
+  auto above_threshold = [&](Node n, const PushEntry& entry) {
+    uint64_t degree = topology.edges(n).size();
+    return entry.residual >= plan.epsilon() * std::max<uint64_t>(degree, 1);
+  };
+
+  PushEntry& start = entries[seed];
+  start.residual = 1;
+  start.queued = true;
+  queue.emplace_back(seed);
+
+  for (size_t head = 0; head < queue.size(); ++head) {
+    Node n = queue[head];
+    PushEntry& entry = entries[n];
+    double residual = entry.residual;
+    entry.residual = 0;
+    entry.queued = false;
+    entry.rank += (1 - alpha) * residual;
+
+    auto add_residual = [&](Node dest, double amount) {
+      PushEntry& dest_entry = entries[dest];
+      dest_entry.residual += amount;
+      if (!dest_entry.queued && above_threshold(dest, dest_entry)) {
+        dest_entry.queued = true;
+        queue.emplace_back(dest);
+      }
+    };
+
+    auto edges = topology.edges(n);
+    if (edges.size() == 0) {
+      add_residual(seed, alpha * residual);
+      continue;
+    }
+    double share = alpha * residual / edges.size();
+    for (auto e : edges) {
+      add_residual(topology.edge_dest(e), share);
+    }
+  }
+
+  ranks->clear();
+  for (const auto& [n, entry] : entries) {
+    if (entry.rank > 0) {
+      ranks->emplace_back(n, entry.rank);
+    }
+  }
+}
+
+void
+MonteCarlo(
+    const katana::GraphTopology& topology, Node seed, uint64_t query,
+    const PersonalizedPagerankPlan& plan, Scratch* scratch,
+    PersonalizedRanks* ranks) {
+  auto& counts = scratch->counts;
+  counts.clear();
+
+  std::mt19937 gen(query);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  const uint64_t* indices = topology.out_indices->raw_values();
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  for (uint32_t w = 0; w < plan.number_of_walks(); ++w) {
+    Node n = seed;
+    while (dist(gen) < plan.alpha()) {
+      uint64_t begin = n == 0 ? 0 : indices[n - 1];
+      uint64_t degree = indices[n] - begin;
+      if (degree == 0) {
+        n = seed;
+      } else {
+        n = dests[begin + std::uniform_int_distribution<uint64_t>(
+                              0, degree - 1)(gen)];
+      }
+    }
+    counts[n] += 1;
+  }
+
+  ranks->clear();
+  for (const auto& [n, count] : counts) {
+    ranks->emplace_back(
+        n, static_cast<double>(count) / plan.number_of_walks());
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<PersonalizedRanks>>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    PersonalizedPagerankPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (!(plan.alpha() >= 0 && plan.alpha() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be in [0, 1): {}",
+        plan.alpha());
+  }
+  switch (plan.algorithm()) {
+  case PersonalizedPagerankPlan::kForwardPush:
+    if (!(plan.epsilon() > 0)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "epsilon must be positive: {}",
+          plan.epsilon());
+    }
+    break;
+  case PersonalizedPagerankPlan::kMonteCarlo:
+    if (plan.number_of_walks() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "number_of_walks must be >= 1");
+    }
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  for (uint32_t seed : seeds) {
+    if (seed >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node", seed);
+    }
+  }
+
+  katana::StatTimer exec_time("PersonalizedPagerank");
+  exec_time.start();
+
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<PersonalizedRanks> results(seeds.size());
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, seeds.size()),
+      [&](uint64_t q) {
+        if (katana::CancelRequested()) {
+          return;
+        }
+        Scratch& s = *scratch.getLocal();
+        if (plan.algorithm() == PersonalizedPagerankPlan::kForwardPush) {
+          ForwardPush(topology, seeds[q], plan, &s, &results[q]);
+        } else {
+          MonteCarlo(topology, seeds[q], q, plan, &s, &results[q]);
+        }
+        SortRanks(plan.top_k(), &results[q]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PersonalizedPagerank"));
+
+  exec_time.stop();
+
+  if (auto r = CheckCancelled(); !r) {
+    return r.error();
+  }
+  return results;
+}
@@ -17,10 +17,27 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "katana/GraphHelpers.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/gstl.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_PAGERANK_X86 1
+#include <immintrin.h>
+#else
+#define KATANA_PAGERANK_X86 0
+#endif
+
 namespace {
 struct NodeNout : public katana::PODProperty<uint32_t> {};
 
@@ -81,17 +98,15 @@ ComputeOutDeg(Graph* graph) {
       [&](const GNode& src) { vec.constructAt(src, 0ul); }, katana::no_stats(),
       katana::loopname("InitDegVec"));
 
-  katana::do_all(
-      katana::iterate(*graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph->edges(src)) {
-          auto dest = graph->GetEdgeDest(nbr);
-          vec[*dest].fetch_add(1ul);
+  // Counting is per edge, so hubs are split between threads
+  const uint32_t* dests =
+      graph->GetPropertyGraph().topology().out_dests->raw_values();
+  katana::ForEachEdgeBlock(
+      *graph, [&](const GNode&, uint64_t begin, uint64_t end) {
+        for (uint64_t e = begin; e < end; ++e) {
+          vec[dests[e]].fetch_add(1ul);
         }
-      },
-      katana::steal(),
-      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-      katana::no_stats(), katana::loopname("ComputeOutDeg"));
+      });
 
   katana::do_all(
       katana::iterate(*graph),
@@ -163,7 +178,8 @@ ComputePRResidual(
     std::cout << "iteration: " << iterations << "\n";
 #endif
     iterations++;
-    if (iterations >= plan.max_iterations() || !accum.reduce()) {
+    if (iterations >= plan.max_iterations() || !accum.reduce() ||
+        katana::CancelRequested()) {
       break;
     }
     accum.reset();
@@ -171,6 +187,28 @@ ComputePRResidual(
   //! [scalarreduction]
 }
 
+/// Call update(n), which returns the change in the rank of n, for every
+/// node and return the sum of the changes. The sum is taken in a fixed order
+/// if plan is deterministic. args are more options for the loop.
+template <typename F, typename... Args>
+float
+SumRankChanges(
+    uint64_t num_nodes, const katana::analytics::PagerankPlan& plan,
+    const char* loopname, const F& update, Args... args) {
+  if (plan.deterministic()) {
+    return katana::ParallelSTL::deterministic_map_reduce(
+        uint64_t{0}, num_nodes, update, std::plus<float>(), 0.0f);
+  }
+  katana::GAccumulator<float> accum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { accum += update(n); }, katana::no_stats(),
+      katana::steal(),
+      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+      katana::loopname(loopname), args...);
+  return accum.reduce();
+}
+
 /**
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
@@ -178,19 +216,34 @@ ComputePRResidual(
 void
 ComputePRTopological(Graph* graph, katana::analytics::PagerankPlan plan) {
   unsigned int iteration = 0;
-  katana::GAccumulator<float> accum;
+
+  // Ranks are updated in place, so a node may read the rank of a neighbor
+  // from this round or the previous one depending on the schedule.
+  // Deterministic plans read a copy of the ranks of the previous round.
+  katana::LargeArray<PRTy> previous;
+  if (plan.deterministic()) {
+    previous.allocateBlocked(graph->size());
+  }
 
   float base_score = (1.0f - plan.alpha()) / graph->size();
   while (true) {
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
+    if (plan.deterministic()) {
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& n) { previous[n] = graph->GetData<NodeValue>(n); },
+          katana::no_stats(), katana::loopname("Pagerank Snapshot"));
+    }
+
+    float delta = SumRankChanges(
+        graph->size(), plan, "Pagerank Topological", [&](const GNode& src) {
           auto& sdata_value = graph->GetData<NodeValue>(src);
           float sum = 0.0;
 
           for (auto jj : graph->edges(src)) {
             auto dest = graph->GetEdgeDest(jj);
-            auto& ddata_value = graph->GetData<NodeValue>(dest);
+            float ddata_value = plan.deterministic()
+                                    ? previous[*dest]
+                                    : graph->GetData<NodeValue>(dest);
             auto& ddata_nout = graph->GetData<NodeNout>(dest);
             sum += ddata_value / ddata_nout;
           }
@@ -204,28 +257,342 @@ ComputePRTopological(Graph* graph, katana::analytics::PagerankPlan plan) {
           //! Do not update pagerank before the diff is computed since
           //! there is a data dependence on the pagerank value.
           sdata_value = value;
-          accum += diff;
+          return diff;
         },
-        katana::no_stats(), katana::steal(),
-        katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("Pagerank Topological"));
+        katana::edge_balanced(*graph));
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
 #endif
 
     iteration += 1;
-    if (accum.reduce() <= plan.tolerance() ||
-        iteration >= plan.max_iterations()) {
+    if (delta <= plan.tolerance() || iteration >= plan.max_iterations() ||
+        katana::CancelRequested()) {
       break;
     }
-    accum.reset();
-
   }  ///< End while(true).
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
 }
 
+// Each kernel returns the sum of values[i] for the indices i in
+// [idx, idx_end). The indices of a node are mostly far apart, so the values
+// are prefetched kPrefetchDistance indices ahead.
+
+constexpr ptrdiff_t kPrefetchDistance = 32;
+
+float
+ScalarGatherSum(
+    const float* values, const uint32_t* idx, const uint32_t* idx_end) {
+  constexpr ptrdiff_t kLanes = 4;
+  float sums[kLanes] = {};
+  for (; idx_end - idx >= kLanes; idx += kLanes) {
+    if (idx_end - idx >= kPrefetchDistance + kLanes) {
+      for (ptrdiff_t j = 0; j < kLanes; ++j) {
+        __builtin_prefetch(&values[idx[kPrefetchDistance + j]]);
+      }
+    }
+    for (ptrdiff_t j = 0; j < kLanes; ++j) {
+      sums[j] += values[idx[j]];
+    }
+  }
+  float sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  for (; idx != idx_end; ++idx) {
+    sum += values[*idx];
+  }
+  return sum;
+}
+
+#if KATANA_PAGERANK_X86
+
+// The gathers take signed 32-bit indices, so these kernels are only used
+// when every node id fits in an int32_t.
+
+__attribute__((target("avx2"))) float
+HorizontalSum(__m256 v) {
+  __m128 sum4 =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  sum4 = _mm_hadd_ps(sum4, sum4);
+  sum4 = _mm_hadd_ps(sum4, sum4);
+  return _mm_cvtss_f32(sum4);
+}
+
+__attribute__((target("avx2"))) float
+Avx2GatherSum(
+    const float* values, const uint32_t* idx, const uint32_t* idx_end) {
+  constexpr ptrdiff_t kLanes = 8;
+  __m256 acc = _mm256_setzero_ps();
+  for (; idx_end - idx >= kLanes; idx += kLanes) {
+    if (idx_end - idx >= kPrefetchDistance + kLanes) {
+      for (ptrdiff_t j = 0; j < kLanes; ++j) {
+        __builtin_prefetch(&values[idx[kPrefetchDistance + j]]);
+      }
+    }
+    __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx));
+    acc = _mm256_add_ps(acc, _mm256_i32gather_ps(values, vi, 4));
+  }
+  return HorizontalSum(acc) + ScalarGatherSum(values, idx, idx_end);
+}
+
+__attribute__((target("avx512f"))) float
+Avx512GatherSum(
+    const float* values, const uint32_t* idx, const uint32_t* idx_end) {
+  constexpr ptrdiff_t kLanes = 16;
+  const __m512 zero = _mm512_setzero_ps();
+  __m512 acc = zero;
+  // Masked gathers with a zero source avoid the undefined source vector of
+  // the unmasked intrinsic, which GCC warns about
+  __mmask16 mask = 0xffff;
+  for (; idx_end - idx >= kLanes; idx += kLanes) {
+    if (idx_end - idx >= kPrefetchDistance + kLanes) {
+      for (ptrdiff_t j = 0; j < kLanes; ++j) {
+        __builtin_prefetch(&values[idx[kPrefetchDistance + j]]);
+      }
+    }
+    __m512i vi = _mm512_loadu_si512(idx);
+    acc = _mm512_add_ps(
+        acc, _mm512_mask_i32gather_ps(zero, mask, vi, values, 4));
+  }
+  if (idx != idx_end) {
+    mask = static_cast<__mmask16>((1U << (idx_end - idx)) - 1);
+    __m512i vi = _mm512_maskz_loadu_epi32(mask, idx);
+    acc = _mm512_add_ps(
+        acc, _mm512_mask_i32gather_ps(zero, mask, vi, values, 4));
+  }
+  // Summed through memory for the same reason
+  alignas(64) float lanes[kLanes];
+  _mm512_store_ps(lanes, acc);
+  __m256 sum8 = _mm256_add_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8));
+  return HorizontalSum(sum8);
+}
+
+#endif
+
+using GatherSumFn = float (*)(const float*, const uint32_t*, const uint32_t*);
+
+struct GatherKernel {
+  const char* name;
+  GatherSumFn sum;
+};
+
+GatherKernel
+SelectGatherKernel(uint64_t num_nodes) {
+#if KATANA_PAGERANK_X86
+  if (num_nodes <= uint64_t{std::numeric_limits<int32_t>::max()}) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return GatherKernel{"avx512", &Avx512GatherSum};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return GatherKernel{"avx2", &Avx2GatherSum};
+    }
+  }
+#else
+  (void)num_nodes;
+#endif
+  return GatherKernel{"scalar", &ScalarGatherSum};
+}
+
+bool
+EdgesSortedByDest(const katana::GraphTopology& topology) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  katana::GReduceLogicalAnd sorted;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        sorted.update(std::is_sorted(dests + begin, dests + end));
+      },
+      katana::no_stats(), katana::loopname("CheckEdgesSorted"));
+  return sorted.reduce();
+}
+
+/// The edges of each node split into runs whose destinations fall in the
+/// same block of block_nodes nodes. The runs of block b are
+/// [offsets[b], offsets[b + 1]) ordered by node; run i ends before edge
+/// ends[i] of node nodes[i] and starts where the previous run of that node
+/// ended.
+struct Segments {
+  std::vector<uint64_t> offsets;
+  katana::LargeArray<uint32_t> nodes;
+  katana::LargeArray<uint64_t> ends;
+};
+
+Segments
+MakeSegments(
+    const katana::GraphTopology& topology, uint32_t block_nodes,
+    uint64_t num_blocks) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  unsigned num_threads = katana::getActiveThreads();
+
+  // Calls fn(node, block, end) for every run of the nodes of thread tid
+  auto for_each_run = [&](unsigned tid, auto fn) {
+    auto [node_begin, node_end] = katana::block_range(
+        uint64_t{0}, topology.num_nodes(), tid, num_threads);
+    for (uint64_t n = node_begin; n < node_end; ++n) {
+      auto [begin, end] = topology.edge_range(n);
+      while (begin < end) {
+        uint64_t block = dests[begin] / block_nodes;
+        uint64_t block_end = (block + 1) * block_nodes;
+        begin = std::lower_bound(dests + begin, dests + end, block_end) - dests;
+        fn(n, block, begin);
+      }
+    }
+  };
+
+  // counts[b * num_threads + t] is the number of runs of the nodes of thread
+  // t in block b, and becomes where thread t writes them
+  std::vector<uint64_t> counts(num_blocks * num_threads);
+  katana::on_each([&](unsigned tid, unsigned) {
+    for_each_run(tid, [&](uint64_t, uint64_t block, uint64_t) {
+      counts[block * num_threads + tid] += 1;
+    });
+  });
+
+  Segments segments;
+  segments.offsets.resize(num_blocks + 1);
+  uint64_t total = 0;
+  for (uint64_t b = 0; b < num_blocks; ++b) {
+    segments.offsets[b] = total;
+    for (unsigned t = 0; t < num_threads; ++t) {
+      uint64_t count = counts[b * num_threads + t];
+      counts[b * num_threads + t] = total;
+      total += count;
+    }
+  }
+  segments.offsets[num_blocks] = total;
+
+  segments.nodes.allocateBlocked(total);
+  segments.ends.allocateBlocked(total);
+  katana::on_each([&](unsigned tid, unsigned) {
+    for_each_run(tid, [&](uint64_t n, uint64_t block, uint64_t end) {
+      uint64_t& pos = counts[block * num_threads + tid];
+      segments.nodes[pos] = n;
+      segments.ends[pos] = end;
+      pos += 1;
+    });
+  });
+  return segments;
+}
+
+/**
+ * PageRank pull topological with cache blocking.
+ * Like ComputePRTopological, but sums precomputed contributions
+ * (rank / out-degree) with vector gathers and, when the graph has more than
+ * one block of nodes, sums the contributions of one block at a time.
+ */
+void
+ComputePRBlocked(
+    Graph* graph, const katana::GraphTopology& topology,
+    katana::analytics::PagerankPlan plan) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  uint64_t num_nodes = topology.num_nodes();
+  GatherKernel kernel = SelectGatherKernel(num_nodes);
+  katana::ReportParam("PageRank", "GatherKernel", kernel.name);
+
+  uint32_t block_nodes = std::max(plan.block_nodes(), 1U);
+  uint64_t num_blocks = (num_nodes + block_nodes - 1) / block_nodes;
+  if (num_blocks > 1 && !EdgesSortedByDest(topology)) {
+    KATANA_WARN_ONCE(
+        "edges are not sorted by destination; not blocking PageRank "
+        "(see SortAllEdgesByDest)");
+    num_blocks = 1;
+  }
+  katana::ReportStatSingle("PageRank", "Blocks", num_blocks);
+
+  Segments segments;
+  katana::LargeArray<uint64_t> cursor;
+  katana::LargeArray<float> sum;
+  if (num_blocks > 1) {
+    segments = MakeSegments(topology, block_nodes, num_blocks);
+    cursor.allocateBlocked(num_nodes);
+    sum.allocateBlocked(num_nodes);
+  }
+
+  katana::LargeArray<float> contrib;
+  contrib.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& n) {
+        auto nout = graph->GetData<NodeNout>(n);
+        contrib[n] = nout > 0 ? graph->GetData<NodeValue>(n) / nout : 0;
+      },
+      katana::no_stats(), katana::loopname("InitContributions"));
+
+  // Without blocking, contributions are read and updated in the same loop,
+  // so deterministic plans write them to a second array
+  katana::LargeArray<float> next_contrib;
+  bool double_buffer = num_blocks == 1 && plan.deterministic();
+  if (double_buffer) {
+    next_contrib.allocateBlocked(num_nodes);
+  }
+
+  unsigned int iteration = 0;
+  float base_score = (1.0f - plan.alpha()) / num_nodes;
+
+  // Ranks are read only through contrib, so they can be updated in place
+  auto update = [&](const GNode& n, float in_sum) {
+    auto& sdata_value = graph->GetData<NodeValue>(n);
+    auto nout = graph->GetData<NodeNout>(n);
+    float value = in_sum * plan.alpha() + base_score;
+    float diff = std::fabs(value - sdata_value);
+    sdata_value = value;
+    (double_buffer ? next_contrib : contrib)[n] = nout > 0 ? value / nout : 0;
+    return diff;
+  };
+
+  while (true) {
+    float delta = 0;
+    if (num_blocks == 1) {
+      delta = SumRankChanges(
+          num_nodes, plan, "PagerankBlocked", [&](const GNode& n) {
+            auto [begin, end] = topology.edge_range(n);
+            return update(
+                n, kernel.sum(contrib.data(), dests + begin, dests + end));
+          },
+          katana::edge_balanced(topology));
+      if (double_buffer) {
+        std::swap(contrib, next_contrib);
+      }
+    } else {
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes),
+          [&](uint64_t n) {
+            cursor[n] = topology.edge_range(n).first;
+            sum[n] = 0;
+          },
+          katana::no_stats(), katana::loopname("PagerankBlockedReset"));
+
+      for (uint64_t b = 0; b < num_blocks; ++b) {
+        katana::do_all(
+            katana::iterate(segments.offsets[b], segments.offsets[b + 1]),
+            [&](uint64_t i) {
+              uint32_t n = segments.nodes[i];
+              uint64_t end = segments.ends[i];
+              sum[n] += kernel.sum(
+                  contrib.data(), dests + cursor[n], dests + end);
+              cursor[n] = end;
+            },
+            katana::no_stats(), katana::steal(),
+            katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+            katana::loopname("PagerankBlocked"));
+      }
+
+      delta = SumRankChanges(
+          num_nodes, plan, "PagerankBlockedUpdate",
+          [&](const GNode& n) { return update(n, sum[n]); });
+    }
+
+    iteration += 1;
+    if (delta <= plan.tolerance() || iteration >= plan.max_iterations() ||
+        katana::CancelRequested()) {
+      break;
+    }
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -257,7 +624,7 @@ PagerankPullTopological(
   ComputePRTopological(&graph, plan);
   exec_time.stop();
 
-  return katana::ResultSuccess();
+  return katana::analytics::CheckCancelled();
 }
 
 katana::Result<void>
@@ -294,5 +661,37 @@ PagerankPullResidual(
   ComputePRResidual(&graph, delta, residual, plan);
   exec_time.stop();
 
-  return katana::ResultSuccess();
+  return katana::analytics::CheckCancelled();
+}
+
+katana::Result<void>
+PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  katana::Prealloc(2, 5 * pg->num_nodes() * sizeof(NodeData));
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  InitNodeDataTopological(&graph);
+  ComputeOutDeg(&graph);
+
+  katana::StatTimer exec_time("PagerankPullBlocked");
+  exec_time.start();
+  ComputePRBlocked(&graph, pg->topology(), plan);
+  exec_time.stop();
+
+  return katana::analytics::CheckCancelled();
 }
@@ -17,8 +17,15 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/HubSplitting.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/WriteCombining.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
@@ -47,6 +54,49 @@ InitializeNodeResidual(Graph& graph, katana::analytics::PagerankPlan plan) {
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
+/// Run the asynchronous push algorithm from the nodes in range until no
+/// residual is above the tolerance. Residuals may be negative (e.g., when an
+/// incremental update takes rank away from a node), in which case they are
+/// pushed like positive ones.
+template <typename Range>
+void
+PushResiduals(
+    Graph* graph, katana::analytics::PagerankPlan plan, const Range& range) {
+  typedef katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>
+      WL;
+  katana::for_each(
+      range,
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) > plan.tolerance()) {
+          PRTy old_residual = src_residual.exchange(0.0);
+          auto& src_value = graph->GetData<NodeValue>(src);
+          src_value += old_residual;
+          int src_nout = graph->edges(src).size();
+          if (src_nout > 0) {
+            PRTy delta = old_residual * plan.alpha() / src_nout;
+            //! For each out-going neighbors.
+            for (const auto& jj : katana::PrefetchEdges(
+                     graph->edges(src),
+                     katana::PrefetchDestinations<NodeResidual>(graph))) {
+              auto dest = graph->GetEdgeDest(jj);
+              auto& dest_residual = graph->GetData<NodeResidual>(dest);
+              if (delta != 0) {
+                auto old = atomicAdd(dest_residual, delta);
+                if ((std::fabs(old) < plan.tolerance()) &&
+                    (std::fabs(old + delta) >= plan.tolerance())) {
+                  ctx.push(*dest);
+                }
+              }
+            }
+          }
+        }
+      },
+      katana::loopname("PushResidualAsynchronous"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -72,37 +122,7 @@ PagerankPushAsynchronous(
 
   InitializeNodeResidual(graph, plan);
 
-  typedef katana::PerSocketChunkFIFO<
-      katana::analytics::PagerankPlan::kChunkSize>
-      WL;
-  katana::for_each(
-      katana::iterate(graph),
-      [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
-          PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
-          src_value += old_residual;
-          int src_nout = graph.edges(src).size();
-          if (src_nout > 0) {
-            PRTy delta = old_residual * plan.alpha() / src_nout;
-            //! For each out-going neighbors.
-            for (const auto& jj : graph.edges(src)) {
-              auto dest = graph.GetEdgeDest(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
-                auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
-                  ctx.push(*dest);
-                }
-              }
-            }
-          }
-        }
-      },
-      katana::loopname("PushResidualAsynchronous"),
-      katana::disable_conflict_detection(), katana::wl<WL>());
+  PushResiduals(&graph, plan, katana::iterate(graph));
 
   return katana::ResultSuccess();
 }
@@ -141,6 +161,41 @@ PagerankPushSynchronous(
   katana::InsertBag<Update> updates;
   katana::InsertBag<GNode> active_nodes;
 
+  auto activate = [&](GNode n, PRTy old, PRTy delta) {
+    //! If fabs(old) is greater than tolerance, then it would
+    //! already have been processed in the previous do_all
+    //! loop.
+    if ((old <= plan.tolerance()) && (old + delta >= plan.tolerance())) {
+      active_nodes.push(n);
+    }
+  };
+
+  // Pushes into hubs go to one of the slots of their virtual nodes, chosen
+  // by thread, and are merged into the hubs after each round
+  std::shared_ptr<const katana::HubSplitView> hub_view;
+  katana::LargeArray<std::atomic<PRTy>> hub_residuals;
+  if (plan.hub_degree() > 0) {
+    auto view_result = pg->SplitHubs(plan.hub_degree());
+    if (!view_result) {
+      return view_result.error();
+    }
+    hub_view = std::move(view_result.value());
+    hub_residuals.allocateBlocked(hub_view->num_virtual_nodes());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, hub_view->num_virtual_nodes()),
+        [&](uint64_t v) { hub_residuals.constructAt(v, 0); },
+        katana::no_stats());
+  }
+
+  // Pushes to other nodes are combined per thread, so that nodes with many
+  // in-edges take one atomic add per batch rather than one per edge
+  auto residual_of = [&graph](uint32_t n) -> std::atomic<PRTy>& {
+    return graph.GetData<NodeResidual>(n);
+  };
+  using PushBuffer = katana::WriteCombiningBuffer<PRTy, decltype(residual_of)>;
+  katana::PerThreadStorage<PushBuffer> push_buffers(
+      residual_of, graph.num_nodes());
+
   katana::do_all(
       katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
       katana::no_stats());
@@ -188,25 +243,149 @@ PagerankPushSynchronous(
     katana::do_all(
         katana::iterate(updates),
         [&](const Update& up) {
+          PushBuffer& push_buffer = *push_buffers.getLocal();
           //! For each out-going neighbors.
-          for (auto jj = up.beg; jj != up.end; ++jj) {
+          for (auto jj : katana::PrefetchEdges(
+                   katana::MakeStandardRange(up.beg, up.end),
+                   katana::PrefetchDestinations<NodeResidual>(&graph))) {
             auto dest = graph.GetEdgeDest(jj);
-            auto& ddata_residual = graph.GetData<NodeResidual>(dest);
-            auto old = atomicAdd(ddata_residual, up.delta);
-            //! If fabs(old) is greater than tolerance, then it would
-            //! already have been processed in the previous do_all
-            //! loop.
-            if ((old <= plan.tolerance()) &&
-                (old + up.delta >= plan.tolerance())) {
-              active_nodes.push(*dest);
+            if (hub_view) {
+              auto [v_begin, v_end] = hub_view->virtual_nodes(*dest);
+              if (v_end - v_begin > 1) {
+                atomicAdd(
+                    hub_residuals[hub_view->PushTarget(
+                        *dest, katana::ThreadPool::getTID())],
+                    up.delta);
+                continue;
+              }
             }
+            push_buffer.Add(*dest, up.delta, activate);
           }
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("PushResidualSynchronous"));
+    katana::on_each([&](unsigned, unsigned) {
+      push_buffers.getLocal()->Flush(activate);
+    });
+
+    if (hub_view) {
+      katana::ForEachHubReplica(*hub_view, [&](uint32_t hub, uint64_t v) {
+        PRTy delta = hub_residuals[v].exchange(0, std::memory_order_relaxed);
+        if (delta != 0) {
+          auto& residual = graph.GetData<NodeResidual>(hub);
+          activate(hub, atomicAdd(residual, delta), delta);
+        }
+      });
+    }
 
     updates.clear();
   }
   return katana::ResultSuccess();
 }
+
+katana::Result<void>
+PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& removed_edges,
+    katana::analytics::PagerankPlan plan) {
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  if (auto result = katana::analytics::ConstructNodeProperties<
+          std::tuple<NodeResidual>>(pg, {temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {rank_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeResidual>(n) = 0; },
+      katana::no_stats(), katana::loopname("Initialize"));
+
+  // Group the changed edges by source
+  std::vector<std::pair<uint32_t, uint32_t>> inserted(inserted_edges);
+  std::vector<std::pair<uint32_t, uint32_t>> removed(removed_edges);
+  std::sort(inserted.begin(), inserted.end());
+  std::sort(removed.begin(), removed.end());
+
+  struct ChangedSource {
+    GNode src;
+    size_t inserted_begin;
+    size_t inserted_end;
+    size_t removed_begin;
+    size_t removed_end;
+  };
+  std::vector<ChangedSource> sources;
+  for (size_t i = 0, r = 0; i < inserted.size() || r < removed.size();) {
+    GNode src = std::min(
+        i < inserted.size() ? inserted[i].first : pg->num_nodes(),
+        r < removed.size() ? removed[r].first : pg->num_nodes());
+    ChangedSource changed{src, i, i, r, r};
+    while (i < inserted.size() && inserted[i].first == src) {
+      ++i;
+    }
+    while (r < removed.size() && removed[r].first == src) {
+      ++r;
+    }
+    changed.inserted_end = i;
+    changed.removed_end = r;
+
+    uint64_t num_inserted = changed.inserted_end - changed.inserted_begin;
+    if (graph.edges(src).size() < num_inserted) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} has {} edges but {} were inserted", src,
+          graph.edges(src).size(), num_inserted);
+    }
+    sources.emplace_back(changed);
+  }
+
+  // A source u with rank x_u and d edges contributes alpha * x_u / d to the
+  // residual of the destination of each of its edges. Replace the
+  // contributions of each changed source over its old edges with those over
+  // its current edges.
+  katana::InsertBag<GNode> active;
+  auto add_residual = [&](GNode n, PRTy delta) {
+    auto old = atomicAdd(graph.GetData<NodeResidual>(n), delta);
+    if ((std::fabs(old) < plan.tolerance()) &&
+        (std::fabs(old + delta) >= plan.tolerance())) {
+      active.push(n);
+    }
+  };
+  katana::do_all(
+      katana::iterate(sources),
+      [&](const ChangedSource& changed) {
+        PRTy rank = graph.GetData<NodeValue>(changed.src);
+        uint64_t new_degree = graph.edges(changed.src).size();
+        uint64_t old_degree =
+            new_degree - (changed.inserted_end - changed.inserted_begin) +
+            (changed.removed_end - changed.removed_begin);
+        PRTy new_share = new_degree ? plan.alpha() * rank / new_degree : 0;
+        PRTy old_share = old_degree ? plan.alpha() * rank / old_degree : 0;
+
+        // Current edges are the old edges plus the inserted ones minus the
+        // removed ones
+        for (const auto& e : graph.edges(changed.src)) {
+          add_residual(*graph.GetEdgeDest(e), new_share - old_share);
+        }
+        for (size_t i = changed.inserted_begin; i < changed.inserted_end; ++i) {
+          add_residual(inserted[i].second, old_share);
+        }
+        for (size_t i = changed.removed_begin; i < changed.removed_end; ++i) {
+          add_residual(removed[i].second, -old_share);
+        }
+      },
+      katana::steal(), katana::loopname("SeedResiduals"));
+
+  PushResiduals(&graph, plan, katana::iterate(active));
+
+  return katana::ResultSuccess();
+}
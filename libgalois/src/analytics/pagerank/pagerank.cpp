@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "katana/ParaMeter.h"
 #include "katana/TypedPropertyGraph.h"
 #include "pagerank-impl.h"
 
@@ -24,20 +25,55 @@ katana::Result<void>
 katana::analytics::Pagerank(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan) {
+  katana::parameter::ProfileScope profile(plan.profile_parallelism());
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
   switch (plan.algorithm()) {
   case PagerankPlan::kPullResidual:
     return PagerankPullResidual(pg, output_property_name, plan);
   case PagerankPlan::kPullTopological:
     return PagerankPullTopological(pg, output_property_name, plan);
   case PagerankPlan::kPushAsynchronous:
+    if (auto r = CheckNotDeterministic(plan, "PushAsynchronous"); !r) {
+      return r.error();
+    }
     return PagerankPushAsynchronous(pg, output_property_name, plan);
+  case PagerankPlan::kPullBlocked:
+    return PagerankPullBlocked(pg, output_property_name, plan);
   case PagerankPlan::kPushSynchronous:
+    if (auto r = CheckNotDeterministic(plan, "PushSynchronous"); !r) {
+      return r.error();
+    }
     return PagerankPushSynchronous(pg, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& removed_edges,
+    katana::analytics::PagerankPlan plan) {
+  if (auto r = CheckNotDeterministic(plan, "PagerankIncremental"); !r) {
+    return r.error();
+  }
+  for (const auto* edges : {&inserted_edges, &removed_edges}) {
+    for (const auto& [src, dest] : *edges) {
+      if (src >= pg->num_nodes() || dest >= pg->num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge ({}, {}) is not in a graph of {} nodes", src, dest,
+            pg->num_nodes());
+      }
+    }
+  }
+  return PagerankPushIncremental(
+      pg, rank_property_name, inserted_edges, removed_edges, plan);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
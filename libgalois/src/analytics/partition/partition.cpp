@@ -0,0 +1,807 @@
+#include "katana/analytics/partition/partition.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+using PartitionID = katana::PODProperty<uint32_t>;
+using Graph =
+    katana::TypedPropertyGraph<std::tuple<PartitionID>, std::tuple<>>;
+
+constexpr Node kUnmatched = std::numeric_limits<Node>::max();
+
+/// The number of rounds of proposals in a heavy edge matching
+constexpr uint32_t kMatchingRounds = 4;
+/// Coarsening stops when a level has more than this fraction of the nodes of
+/// the level before
+constexpr double kMinCoarseningRatio = 0.95;
+/// The number of seeds tried for each initial bisection
+constexpr uint32_t kBisectionTries = 4;
+
+/// One level of the multilevel hierarchy: an undirected graph stored with
+/// both directions of every edge and without self loops or parallel edges.
+/// A node or edge of a coarse graph weighs as much as the nodes or edges of
+/// the finer graph it stands for.
+struct LevelGraph {
+  /// offsets[n] is the first edge of n; there are num_nodes() + 1 offsets
+  std::vector<uint64_t> offsets;
+  std::vector<Node> dests;
+  std::vector<uint64_t> edge_weights;
+  std::vector<uint64_t> node_weights;
+
+  Node num_nodes() const { return node_weights.size(); }
+  uint64_t edge_begin(Node n) const { return offsets[n]; }
+  uint64_t edge_end(Node n) const { return offsets[n + 1]; }
+};
+
+using WeightedNeighbor = std::pair<Node, uint64_t>;
+
+/// Build the edges of g from the adjacency lists in scratch, where the
+/// neighbors of n are the lengths[n] entries from scratch_offsets[n] and may
+/// repeat. Repeated neighbors become one edge weighing as much as all of
+/// them.
+void
+MergeEdges(
+    std::vector<WeightedNeighbor>* scratch,
+    const std::vector<uint64_t>& scratch_offsets,
+    const std::vector<uint64_t>& lengths, LevelGraph* g) {
+  Node num_nodes = g->num_nodes();
+  g->offsets.assign(num_nodes + 1, 0);
+
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        auto first = scratch->begin() + scratch_offsets[n];
+        auto last = first + lengths[n];
+        std::sort(first, last, [](const auto& a, const auto& b) {
+          return a.first < b.first;
+        });
+        auto out = first;
+        for (auto it = first; it != last; ++it) {
+          if (out != first && (out - 1)->first == it->first) {
+            (out - 1)->second += it->second;
+          } else {
+            *out++ = *it;
+          }
+        }
+        g->offsets[n + 1] = out - first;
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      g->offsets.begin() + 1, g->offsets.end(), g->offsets.begin() + 1);
+
+  g->dests.resize(g->offsets[num_nodes]);
+  g->edge_weights.resize(g->offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        uint64_t from = scratch_offsets[n];
+        for (uint64_t e = g->edge_begin(n); e != g->edge_end(n); ++e, ++from) {
+          g->dests[e] = (*scratch)[from].first;
+          g->edge_weights[e] = (*scratch)[from].second;
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The undirected graph of topology. Each edge of topology weighs one, so
+/// two opposite edges become one edge of weight two.
+LevelGraph
+MakeFinestLevel(
+    const katana::GraphTopology& topology, PartitionObjective objective) {
+  Node num_nodes = topology.num_nodes();
+  LevelGraph g;
+  g.node_weights.resize(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        g.node_weights[n] = objective == PartitionObjective::kEdgeBalancedCut
+                                ? 1 + topology.edges(n).size()
+                                : 1;
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> lengths(num_nodes, 0);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          Node dest = topology.edge_dest(e);
+          if (dest != n) {
+            __atomic_fetch_add(&lengths[n], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&lengths[dest], 1, __ATOMIC_RELAXED);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> scratch_offsets(num_nodes + 1, 0);
+  katana::ParallelSTL::partial_sum(
+      lengths.begin(), lengths.end(), scratch_offsets.begin() + 1);
+  std::vector<uint64_t> cursor(
+      scratch_offsets.begin(), scratch_offsets.end() - 1);
+
+  std::vector<WeightedNeighbor> scratch(scratch_offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          Node dest = topology.edge_dest(e);
+          if (dest != n) {
+            scratch[__atomic_fetch_add(&cursor[n], 1, __ATOMIC_RELAXED)] = {
+                dest, 1};
+            scratch[__atomic_fetch_add(&cursor[dest], 1, __ATOMIC_RELAXED)] =
+                {n, 1};
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  MergeEdges(&scratch, scratch_offsets, lengths, &g);
+  return g;
+}
+
+/// A hash of n that changes every round, to break ties between equally
+/// heavy edges differently in each round
+uint64_t
+TieBreak(Node n, uint32_t round) {
+  uint64_t x = (uint64_t{n} << 8) ^ round;
+  x ^= x >> 33;
+  x *= UINT64_C(0xff51afd7ed558ccd);
+  x ^= x >> 33;
+  return x;
+}
+
+/// Match every node of fine with at most one other node, preferring heavy
+/// edges, so that no pair weighs more than max_node_weight. match[n] is n's
+/// partner, or n itself if it has none.
+///
+/// In each round every unmatched node proposes to its heaviest unmatched
+/// neighbor and mutual proposals are matched. Then, as in the two-hop
+/// matching of gmetis, unmatched nodes whose heaviest neighbor is the same
+/// are matched with each other, and so are unmatched nodes without
+/// neighbors.
+std::vector<Node>
+HeavyEdgeMatching(const LevelGraph& fine, uint64_t max_node_weight) {
+  Node num_nodes = fine.num_nodes();
+  std::vector<Node> match(num_nodes, kUnmatched);
+  std::vector<Node> proposal(num_nodes, kUnmatched);
+
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::GAccumulator<uint64_t> matched;
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          proposal[n] = kUnmatched;
+          if (match[n] != kUnmatched) {
+            return;
+          }
+          uint64_t best_weight = 0;
+          uint64_t best_tie = 0;
+          for (uint64_t e = fine.edge_begin(n); e != fine.edge_end(n); ++e) {
+            Node dest = fine.dests[e];
+            if (match[dest] != kUnmatched ||
+                fine.node_weights[n] + fine.node_weights[dest] >
+                    max_node_weight) {
+              continue;
+            }
+            uint64_t tie = TieBreak(dest, round);
+            if (fine.edge_weights[e] > best_weight ||
+                (fine.edge_weights[e] == best_weight && tie < best_tie)) {
+              best_weight = fine.edge_weights[e];
+              best_tie = tie;
+              proposal[n] = dest;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("Partition-Propose"));
+
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          Node p = proposal[n];
+          if (p != kUnmatched && proposal[p] == n) {
+            match[n] = p;
+            matched += 1;
+          }
+        },
+        katana::loopname("Partition-Match"));
+
+    if (matched.reduce() == 0) {
+      break;
+    }
+  }
+
+  // Pair the rest by their heaviest neighbor
+  katana::InsertBag<std::pair<Node, Node>> loners;
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        if (match[n] != kUnmatched) {
+          return;
+        }
+        Node hub = kUnmatched;
+        uint64_t best_weight = 0;
+        for (uint64_t e = fine.edge_begin(n); e != fine.edge_end(n); ++e) {
+          if (fine.edge_weights[e] > best_weight) {
+            best_weight = fine.edge_weights[e];
+            hub = fine.dests[e];
+          }
+        }
+        loners.push(std::make_pair(hub, n));
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<std::pair<Node, Node>> sorted_loners(
+      loners.begin(), loners.end());
+  katana::ParallelSTL::sort(sorted_loners.begin(), sorted_loners.end());
+  for (size_t i = 0; i < sorted_loners.size(); ++i) {
+    Node n = sorted_loners[i].second;
+    match[n] = n;
+    if (i + 1 < sorted_loners.size() &&
+        sorted_loners[i + 1].first == sorted_loners[i].first) {
+      Node m = sorted_loners[i + 1].second;
+      if (fine.node_weights[n] + fine.node_weights[m] <= max_node_weight) {
+        match[n] = m;
+        match[m] = n;
+        ++i;
+      }
+    }
+  }
+
+  return match;
+}
+
+/// Contract every matched pair of fine into one node of *coarse. Returns
+/// the node of *coarse standing for each node of fine.
+std::vector<Node>
+Coarsen(const LevelGraph& fine, uint64_t max_node_weight, LevelGraph* coarse) {
+  Node num_fine = fine.num_nodes();
+  std::vector<Node> match = HeavyEdgeMatching(fine, max_node_weight);
+
+  // Of each pair, the node with the smaller id stands for both
+  std::vector<Node> coarse_of(num_fine + 1, 0);
+  katana::do_all(
+      katana::iterate(Node{0}, num_fine),
+      [&](Node n) { coarse_of[n + 1] = match[n] >= n ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      coarse_of.begin() + 1, coarse_of.end(), coarse_of.begin() + 1);
+  Node num_coarse = coarse_of[num_fine];
+  coarse_of.pop_back();
+
+  std::vector<Node> representative(num_coarse);
+  katana::do_all(
+      katana::iterate(Node{0}, num_fine),
+      [&](Node n) {
+        if (match[n] >= n) {
+          representative[coarse_of[n]] = n;
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(Node{0}, num_fine),
+      [&](Node n) {
+        if (match[n] < n) {
+          coarse_of[n] = coarse_of[match[n]];
+        }
+      },
+      katana::no_stats());
+
+  coarse->node_weights.resize(num_coarse);
+  std::vector<uint64_t> lengths(num_coarse);
+  katana::do_all(
+      katana::iterate(Node{0}, num_coarse),
+      [&](Node c) {
+        Node a = representative[c];
+        Node b = match[a];
+        coarse->node_weights[c] = fine.node_weights[a];
+        lengths[c] = fine.edge_end(a) - fine.edge_begin(a);
+        if (b != a) {
+          coarse->node_weights[c] += fine.node_weights[b];
+          lengths[c] += fine.edge_end(b) - fine.edge_begin(b);
+        }
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> scratch_offsets(num_coarse + 1, 0);
+  katana::ParallelSTL::partial_sum(
+      lengths.begin(), lengths.end(), scratch_offsets.begin() + 1);
+  std::vector<WeightedNeighbor> scratch(scratch_offsets[num_coarse]);
+
+  katana::do_all(
+      katana::iterate(Node{0}, num_coarse),
+      [&](Node c) {
+        uint64_t out = scratch_offsets[c];
+        auto add_edges = [&](Node child) {
+          for (uint64_t e = fine.edge_begin(child); e != fine.edge_end(child);
+               ++e) {
+            Node dest = coarse_of[fine.dests[e]];
+            if (dest != c) {
+              scratch[out++] = {dest, fine.edge_weights[e]};
+            }
+          }
+        };
+        Node a = representative[c];
+        add_edges(a);
+        if (match[a] != a) {
+          add_edges(match[a]);
+        }
+        lengths[c] = out - scratch_offsets[c];
+      },
+      katana::steal(), katana::loopname("Partition-CoarseEdges"));
+
+  MergeEdges(&scratch, scratch_offsets, lengths, coarse);
+  return coarse_of;
+}
+
+/// Split nodes, all in part first_part of *part, into num_parts parts
+/// numbered from first_part with weights in proportion to their number, by
+/// recursive bisection. Each bisection grows the second half from a random
+/// seed, always adding the node that reduces the cut the most (GGGP in
+/// gmetis), and keeps the best of several seeds.
+void
+RecursiveBisection(
+    const LevelGraph& g, std::vector<Node> nodes, uint32_t first_part,
+    uint32_t num_parts, std::mt19937* gen, std::vector<uint8_t>* side,
+    std::vector<int64_t>* gain, std::vector<uint32_t>* part) {
+  if (num_parts == 1 || nodes.empty()) {
+    for (Node n : nodes) {
+      (*part)[n] = first_part;
+    }
+    return;
+  }
+
+  uint32_t left_parts = num_parts / 2;
+  uint32_t right_parts = num_parts - left_parts;
+  uint64_t total_weight = 0;
+  for (Node n : nodes) {
+    total_weight += g.node_weights[n];
+  }
+  uint64_t target = total_weight * right_parts / num_parts;
+
+  // side is 0 for nodes outside this bisection, 1 for the left and 2 for
+  // the right half
+  constexpr uint8_t kOutside = 0;
+  constexpr uint8_t kLeft = 1;
+  constexpr uint8_t kRight = 2;
+
+  std::vector<uint8_t> best_side;
+  uint64_t best_cut = std::numeric_limits<uint64_t>::max();
+  std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+
+  for (uint32_t attempt = 0; attempt < kBisectionTries; ++attempt) {
+    for (Node n : nodes) {
+      (*side)[n] = kLeft;
+    }
+    for (Node n : nodes) {
+      int64_t g_n = 0;
+      for (uint64_t e = g.edge_begin(n); e != g.edge_end(n); ++e) {
+        if ((*side)[g.dests[e]] != kOutside) {
+          g_n -= g.edge_weights[e];
+        }
+      }
+      (*gain)[n] = g_n;
+    }
+
+    std::priority_queue<std::pair<int64_t, Node>> boundary;
+    uint64_t right_weight = 0;
+    while (right_weight < target) {
+      if (boundary.empty()) {
+        // Start from a new seed, in another component if need be
+        size_t start = pick(*gen);
+        size_t i = start;
+        while ((*side)[nodes[i]] != kLeft) {
+          i = (i + 1) % nodes.size();
+          if (i == start) {
+            break;
+          }
+        }
+        if ((*side)[nodes[i]] != kLeft) {
+          break;
+        }
+        boundary.emplace((*gain)[nodes[i]], nodes[i]);
+      }
+      auto [node_gain, n] = boundary.top();
+      boundary.pop();
+      if ((*side)[n] != kLeft || node_gain != (*gain)[n]) {
+        continue;
+      }
+      (*side)[n] = kRight;
+      right_weight += g.node_weights[n];
+      for (uint64_t e = g.edge_begin(n); e != g.edge_end(n); ++e) {
+        Node dest = g.dests[e];
+        if ((*side)[dest] == kLeft) {
+          (*gain)[dest] += 2 * static_cast<int64_t>(g.edge_weights[e]);
+          boundary.emplace((*gain)[dest], dest);
+        }
+      }
+    }
+
+    uint64_t cut = 0;
+    for (Node n : nodes) {
+      if ((*side)[n] != kRight) {
+        continue;
+      }
+      for (uint64_t e = g.edge_begin(n); e != g.edge_end(n); ++e) {
+        if ((*side)[g.dests[e]] == kLeft) {
+          cut += g.edge_weights[e];
+        }
+      }
+    }
+    if (cut < best_cut) {
+      best_cut = cut;
+      best_side.resize(nodes.size());
+      for (size_t i = 0; i < nodes.size(); ++i) {
+        best_side[i] = (*side)[nodes[i]];
+      }
+    }
+  }
+
+  std::vector<Node> left;
+  std::vector<Node> right;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    (*side)[nodes[i]] = kOutside;
+    (best_side[i] == kRight ? right : left).emplace_back(nodes[i]);
+  }
+  nodes.clear();
+  nodes.shrink_to_fit();
+
+  RecursiveBisection(
+      g, std::move(left), first_part, left_parts, gen, side, gain, part);
+  RecursiveBisection(
+      g, std::move(right), first_part + left_parts, right_parts, gen, side,
+      gain, part);
+}
+
+/// The partition of each node of g and the total node weight of each
+/// partition
+struct LevelPartition {
+  std::vector<uint32_t> part;
+  std::vector<uint64_t> part_weights;
+};
+
+/// Move nodes on the boundary of their partition to the neighboring
+/// partition they have the heaviest edges to, as refine_BKL2 in gmetis
+/// does. A move must reduce the cut, or keep it and make the partitions more
+/// even, and may not make the partition it goes to heavier than
+/// max_part_weight, except that nodes of partitions that are already too
+/// heavy move to the best partition with room. To keep two neighbors from
+/// swapping partitions in the same round, even rounds only move nodes to
+/// partitions with higher numbers and odd rounds to lower ones.
+void
+Refine(
+    const LevelGraph& g, uint32_t num_partitions, uint64_t max_part_weight,
+    uint32_t rounds, LevelPartition* lp) {
+  Node num_nodes = g.num_nodes();
+  uint32_t* part = lp->part.data();
+  uint64_t* part_weights = lp->part_weights.data();
+
+  struct Connectivity {
+    std::vector<uint64_t> weight;
+    std::vector<uint32_t> touched;
+  };
+  katana::PerThreadStorage<Connectivity> connectivity;
+
+  uint32_t idle_rounds = 0;
+  for (uint32_t round = 0; round < rounds && idle_rounds < 2; ++round) {
+    bool upward = round % 2 == 0;
+    katana::GAccumulator<uint64_t> moves;
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          uint32_t own = __atomic_load_n(&part[n], __ATOMIC_RELAXED);
+          Connectivity& conn = *connectivity.getLocal();
+          if (conn.weight.size() != num_partitions) {
+            conn.weight.assign(num_partitions, 0);
+          }
+          bool boundary = false;
+          for (uint64_t e = g.edge_begin(n); e != g.edge_end(n); ++e) {
+            uint32_t p = __atomic_load_n(&part[g.dests[e]], __ATOMIC_RELAXED);
+            if (conn.weight[p] == 0) {
+              conn.touched.emplace_back(p);
+            }
+            conn.weight[p] += g.edge_weights[e];
+            boundary |= p != own;
+          }
+
+          uint64_t weight = g.node_weights[n];
+          uint64_t own_weight =
+              __atomic_load_n(&part_weights[own], __ATOMIC_RELAXED);
+          bool overweight = own_weight > max_part_weight;
+          uint32_t best = own;
+          int64_t best_gain = 0;
+          uint64_t best_weight = own_weight - weight;
+          if (boundary) {
+            for (uint32_t p : conn.touched) {
+              if (p == own || (!overweight && (p > own) != upward)) {
+                continue;
+              }
+              uint64_t p_weight =
+                  __atomic_load_n(&part_weights[p], __ATOMIC_RELAXED);
+              if (p_weight + weight > max_part_weight) {
+                continue;
+              }
+              int64_t gain = static_cast<int64_t>(conn.weight[p]) -
+                             static_cast<int64_t>(conn.weight[own]);
+              bool better = best == own
+                                ? overweight || gain > 0 ||
+                                      (gain == 0 && p_weight < best_weight)
+                                : gain > best_gain ||
+                                      (gain == best_gain &&
+                                       p_weight < best_weight);
+              if (better) {
+                best = p;
+                best_gain = gain;
+                best_weight = p_weight;
+              }
+            }
+          }
+          for (uint32_t p : conn.touched) {
+            conn.weight[p] = 0;
+          }
+          conn.touched.clear();
+
+          if (best == own) {
+            return;
+          }
+          if (__atomic_add_fetch(
+                  &part_weights[best], weight, __ATOMIC_RELAXED) >
+              max_part_weight) {
+            __atomic_sub_fetch(&part_weights[best], weight, __ATOMIC_RELAXED);
+            return;
+          }
+          __atomic_sub_fetch(&part_weights[own], weight, __ATOMIC_RELAXED);
+          __atomic_store_n(&part[n], best, __ATOMIC_RELAXED);
+          moves += 1;
+        },
+        katana::steal(), katana::loopname("Partition-Refine"));
+
+    idle_rounds = moves.reduce() == 0 ? idle_rounds + 1 : 0;
+  }
+}
+
+/// The heaviest a partition of g may be: imbalance over the average, but at
+/// least enough to move the heaviest node of g
+uint64_t
+MaxPartWeight(
+    const LevelGraph& g, uint64_t total_weight, uint32_t num_partitions,
+    double imbalance) {
+  uint64_t max_node_weight = katana::ParallelSTL::map_reduce(
+      g.node_weights.begin(), g.node_weights.end(),
+      [](uint64_t w) { return w; },
+      [](uint64_t a, uint64_t b) { return std::max(a, b); }, uint64_t{0});
+  uint64_t average = (total_weight + num_partitions - 1) / num_partitions;
+  return std::max(
+      static_cast<uint64_t>(average * (1 + imbalance)),
+      average + max_node_weight);
+}
+
+katana::Result<void>
+PartitionImpl(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionObjective objective,
+    const PartitionPlan& plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of partitions must be positive");
+  }
+  if (plan.algorithm() != PartitionPlan::kMultilevel) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  if (auto r = ConstructNodeProperties<std::tuple<PartitionID>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::StatTimer exec_time("Partition");
+  exec_time.start();
+
+  katana::StatTimer coarsen_time("Partition-Coarsen");
+  coarsen_time.start();
+  std::vector<LevelGraph> levels;
+  std::vector<std::vector<Node>> coarse_of;
+  levels.emplace_back(MakeFinestLevel(pg->topology(), objective));
+  uint64_t total_weight = katana::ParallelSTL::accumulate(
+      levels[0].node_weights.begin(), levels[0].node_weights.end(),
+      uint64_t{0});
+  uint64_t coarse_nodes =
+      uint64_t{plan.coarse_nodes_per_partition()} * num_partitions;
+  // Keep coarse nodes light, as METIS does, so that the coarsest graph can
+  // be split evenly
+  uint64_t max_node_weight = std::max<uint64_t>(
+      1, 3 * total_weight / (2 * std::max<uint64_t>(1, coarse_nodes)));
+  while (levels.back().num_nodes() > coarse_nodes) {
+    LevelGraph coarse;
+    std::vector<Node> map = Coarsen(levels.back(), max_node_weight, &coarse);
+    if (coarse.num_nodes() >
+        kMinCoarseningRatio * levels.back().num_nodes()) {
+      break;
+    }
+    coarse_of.emplace_back(std::move(map));
+    levels.emplace_back(std::move(coarse));
+  }
+  coarsen_time.stop();
+
+  katana::StatTimer initial_time("Partition-Initial");
+  initial_time.start();
+  const LevelGraph& coarsest = levels.back();
+  LevelPartition lp;
+  lp.part.assign(coarsest.num_nodes(), 0);
+  {
+    std::vector<Node> nodes(coarsest.num_nodes());
+    std::iota(nodes.begin(), nodes.end(), Node{0});
+    std::vector<uint8_t> side(coarsest.num_nodes(), 0);
+    std::vector<int64_t> gain(coarsest.num_nodes(), 0);
+    std::mt19937 gen(0);
+    RecursiveBisection(
+        coarsest, std::move(nodes), 0, num_partitions, &gen, &side, &gain,
+        &lp.part);
+  }
+  lp.part_weights.assign(num_partitions, 0);
+  for (Node n = 0; n < coarsest.num_nodes(); ++n) {
+    lp.part_weights[lp.part[n]] += coarsest.node_weights[n];
+  }
+  initial_time.stop();
+
+  katana::StatTimer refine_time("Partition-Refine");
+  refine_time.start();
+  for (size_t level = levels.size(); level-- > 0;) {
+    const LevelGraph& g = levels[level];
+    if (level + 1 < levels.size()) {
+      std::vector<uint32_t> fine_part(g.num_nodes());
+      const std::vector<Node>& map = coarse_of[level];
+      katana::do_all(
+          katana::iterate(Node{0}, g.num_nodes()),
+          [&](Node n) { fine_part[n] = lp.part[map[n]]; },
+          katana::loopname("Partition-Project"));
+      lp.part = std::move(fine_part);
+      levels.resize(level + 1);
+      coarse_of.resize(level);
+    }
+    Refine(
+        g, num_partitions,
+        MaxPartWeight(g, total_weight, num_partitions, plan.imbalance()),
+        plan.refinement_rounds(), &lp);
+  }
+  refine_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<PartitionID>(n) = lp.part[n]; },
+      katana::no_stats());
+
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionObjective objective,
+    PartitionPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  return PartitionImpl(
+      pg, num_partitions, output_property_name, objective, plan);
+}
+
+katana::Result<void>
+katana::analytics::PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::GReduceMax<uint32_t> max_part;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { max_part.update(graph.GetData<PartitionID>(n)); },
+      katana::no_stats());
+
+  if (graph.num_nodes() > 0 && max_part.reduce() >= num_partitions) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "node in partition {} but there are only {} partitions",
+        max_part.reduce(), num_partitions);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<PartitionStatistics>
+katana::analytics::PartitionStatistics::Compute(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  if (auto r = PartitionAssertValid(pg, num_partitions, property_name); !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+
+  std::vector<uint64_t> part_nodes(num_partitions, 0);
+  std::vector<uint64_t> part_edges(num_partitions, 0);
+  katana::GAccumulator<uint64_t> cut_edges;
+  katana::GAccumulator<uint64_t> communication_volume;
+  katana::PerThreadStorage<std::vector<uint32_t>> seen;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        uint32_t own = graph.GetData<PartitionID>(n);
+        __atomic_fetch_add(&part_nodes[own], 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(
+            &part_edges[own], topology.edges(n).size(), __ATOMIC_RELAXED);
+
+        std::vector<uint32_t>& parts = *seen.getLocal();
+        parts.clear();
+        for (Edge e : topology.edges(n)) {
+          uint32_t p = graph.GetData<PartitionID>(topology.edge_dest(e));
+          if (p != own) {
+            cut_edges += 1;
+            parts.emplace_back(p);
+          }
+        }
+        std::sort(parts.begin(), parts.end());
+        communication_volume +=
+            std::unique(parts.begin(), parts.end()) - parts.begin();
+      },
+      katana::steal(), katana::loopname("Partition-Statistics"));
+
+  auto imbalance = [&](const std::vector<uint64_t>& sizes, uint64_t total) {
+    if (total == 0) {
+      return 1.0;
+    }
+    uint64_t largest = *std::max_element(sizes.begin(), sizes.end());
+    return static_cast<double>(largest) * num_partitions / total;
+  };
+
+  return PartitionStatistics{
+      num_partitions, cut_edges.reduce(), communication_volume.reduce(),
+      imbalance(part_nodes, topology.num_nodes()),
+      imbalance(part_edges, topology.num_edges())};
+}
+
+void
+katana::analytics::PartitionStatistics::Print(std::ostream& os) const {
+  os << "Number of partitions = " << num_partitions << std::endl;
+  os << "Number of cut edges = " << cut_edges << std::endl;
+  os << "Communication volume = " << communication_volume << std::endl;
+  os << "Node imbalance = " << node_imbalance << std::endl;
+  os << "Edge imbalance = " << edge_imbalance << std::endl;
+}
@@ -0,0 +1,148 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_POINTTOPOINT_EDGEWEIGHTS_H_
+#define KATANA_LIBGALOIS_ANALYTICS_POINTTOPOINT_EDGEWEIGHTS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+/// Call fn with a value of the C type of property, or fail if it is not a
+/// number. what names the values in errors.
+template <typename Fn>
+auto
+DispatchNumberType(
+    const arrow::ChunkedArray& property, const std::string& what,
+    const Fn& fn) -> decltype(fn(uint32_t{})) {
+  switch (property.type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return fn(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return fn(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return fn(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return fn(int64_t{});
+  case arrow::FloatType::type_id:
+    return fn(float{});
+  case arrow::DoubleType::type_id:
+    return fn(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} of type {} are not numbers", what,
+        property.type()->ToString());
+  }
+}
+
+/// Copy property, whose values are of type T and not null, to doubles
+template <typename T>
+katana::Result<std::vector<double>>
+CopyToDoubles(const arrow::ChunkedArray& property, const std::string& what) {
+  using ArrayType = typename arrow::CTypeTraits<T>::ArrayType;
+  if (property.null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} must not be null", what);
+  }
+  std::vector<double> values;
+  values.reserve(property.length());
+  for (const auto& chunk : property.chunks()) {
+    auto array = std::static_pointer_cast<ArrayType>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.emplace_back(static_cast<double>(array->Value(i)));
+    }
+  }
+  return values;
+}
+
+/// Copy the node property named property_name, which must be a number, to
+/// doubles
+inline katana::Result<std::vector<double>>
+CopyNodeNumbers(
+    const katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property = pg->GetNodeProperty(property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        property_name);
+  }
+  std::string what = "values of node property " + property_name;
+  return DispatchNumberType(*property, what, [&](auto value) {
+    return CopyToDoubles<decltype(value)>(*property, what);
+  });
+}
+
+/// Copy the edge property named edge_weight_property_name, which must be a
+/// number and not negative, to doubles
+inline katana::Result<std::vector<double>>
+CopyEdgeWeights(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  auto weights_res =
+      DispatchNumberType(*property, "edge weights", [&](auto weight) {
+        return CopyToDoubles<decltype(weight)>(*property, "edge weights");
+      });
+  if (!weights_res) {
+    return weights_res.error();
+  }
+  for (double weight : weights_res.value()) {
+    if (!(weight >= 0)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights must not be negative");
+    }
+  }
+  return weights_res;
+}
+
+/// The in-edges of each node, in the layout of GraphTopology: the in-edges
+/// of n are the edges edges[e] from sources[e] for e from indices[n - 1] to
+/// indices[n]. The in-edges of each node are sorted by source.
+struct InEdges {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> sources;
+  std::vector<uint64_t> edges;
+};
+
+/// Counting sort the edges of topology by destination
+inline InEdges
+BuildInEdges(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  InEdges in;
+  in.indices.assign(num_nodes, 0);
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    ++in.indices[topology.edge_dest(e)];
+  }
+  uint64_t total = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    uint64_t degree = in.indices[n];
+    in.indices[n] = total;
+    total += degree;
+  }
+  // Since sources are visited in order, the in-edges of each node end up
+  // sorted by source
+  in.sources.resize(num_edges);
+  in.edges.resize(num_edges);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      uint64_t slot = in.indices[topology.edge_dest(e)]++;
+      in.sources[slot] = n;
+      in.edges[slot] = e;
+    }
+  }
+  // Each index now points at the end of the in-edges of its node
+  return in;
+}
+
+#endif
@@ -0,0 +1,420 @@
+#include "katana/analytics/point_to_point/goal_directed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include <arrow/api.h>
+
+#include "edge_weights.h"
+#include "katana/Galois.h"
+
+using katana::analytics::GoalDirectedSearch;
+using katana::analytics::WeightedPath;
+
+namespace {
+
+/// Lower bounds are shrunk by this fraction so that rounding in the
+/// distances they are computed from cannot make them overestimate
+constexpr double kRoundingSlack = 1e-9;
+
+/// A node reached at distance from the source with priority distance plus
+/// its lower bound
+struct Request {
+  uint32_t node;
+  double distance;
+  double priority;
+};
+
+struct RequestIndexer {
+  double delta;
+
+  unsigned int operator()(const Request& req) const {
+    constexpr double kLastBucket = std::numeric_limits<unsigned int>::max();
+    return static_cast<unsigned int>(
+        std::min(req.priority / delta, kLastBucket));
+  }
+};
+
+constexpr unsigned kChunkSize = 64;
+using OBIM = katana::OrderedByIntegerMetric<
+    RequestIndexer, katana::PerSocketChunkFIFO<kChunkSize>>;
+
+}  // namespace
+
+katana::Result<GoalDirectedSearch>
+GoalDirectedSearch::Make(
+    PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  Result<GoalDirectedSearch> search_res = GoalDirectedSearch();
+  GoalDirectedSearch& search = search_res.value();
+  search.out_ = pg->topology();
+  if (!edge_weight_property_name.empty()) {
+    auto weights_res = CopyEdgeWeights(pg, edge_weight_property_name);
+    if (!weights_res) {
+      return weights_res.error();
+    }
+    search.weights_ = std::move(weights_res.value());
+  }
+  InEdges in = BuildInEdges(search.out_);
+  search.in_indices_ = std::move(in.indices);
+  search.in_sources_ = std::move(in.sources);
+  search.in_edges_ = std::move(in.edges);
+
+  double total = 0;
+  for (double weight : search.weights_) {
+    total += weight;
+  }
+  if (total > 0) {
+    search.delta_ = total / search.weights_.size();
+  }
+
+  search.distances_ = std::vector<std::atomic<double>>(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, search.distances_.size()),
+      [&](size_t n) {
+        search.distances_[n].store(kInfinity, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  return search_res;
+}
+
+katana::Result<GoalDirectedSearch>
+GoalDirectedSearch::MakeAStar(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& x_property_name, const std::string& y_property_name) {
+  auto search_res = Make(pg, edge_weight_property_name);
+  if (!search_res) {
+    return search_res.error();
+  }
+  GoalDirectedSearch& search = search_res.value();
+  auto x_res = CopyNodeNumbers(pg, x_property_name);
+  if (!x_res) {
+    return x_res.error();
+  }
+  auto y_res = CopyNodeNumbers(pg, y_property_name);
+  if (!y_res) {
+    return y_res.error();
+  }
+  search.x_ = std::move(x_res.value());
+  search.y_ = std::move(y_res.value());
+
+  // The straight line distance times the smallest ratio of weight to length
+  // of any edge is at most the weight of every edge, and so by the triangle
+  // inequality at most the length of every path
+  katana::GReduceMin<double> ratio;
+  katana::do_all(
+      katana::iterate(search.out_),
+      [&](uint32_t n) {
+        for (auto e : search.out_.edges(n)) {
+          uint32_t dest = search.out_.edge_dest(e);
+          double length = std::hypot(
+              search.x_[dest] - search.x_[n], search.y_[dest] - search.y_[n]);
+          if (length > 0) {
+            ratio.update(search.weight(e) / length);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  double scale = ratio.reduce();
+  if (scale == std::numeric_limits<double>::max()) {
+    // No edge joins distinct points, so only 0 is a lower bound
+    scale = 0;
+  }
+  search.scale_ = scale * (1 - kRoundingSlack);
+  search.heuristic_ = kEuclidean;
+  return search_res;
+}
+
+katana::Result<GoalDirectedSearch>
+GoalDirectedSearch::MakeAlt(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& landmark_property_name) {
+  auto property = pg->GetNodeProperty(landmark_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no node property {}",
+        landmark_property_name);
+  }
+  auto type =
+      std::dynamic_pointer_cast<arrow::FixedSizeListType>(property->type());
+  if (!type || type->value_type()->id() != arrow::Type::DOUBLE ||
+      type->list_size() == 0 || type->list_size() % 2 != 0) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError,
+        "landmark distances must be an even number of doubles, got {}",
+        property->type()->ToString());
+  }
+
+  auto search_res = Make(pg, edge_weight_property_name);
+  if (!search_res) {
+    return search_res.error();
+  }
+  GoalDirectedSearch& search = search_res.value();
+  uint32_t width = type->list_size();
+  search.num_landmarks_ = width / 2;
+  search.landmarks_.reserve(property->length() * width);
+  for (const auto& chunk : property->chunks()) {
+    auto lists = std::static_pointer_cast<arrow::FixedSizeListArray>(chunk);
+    auto values = std::static_pointer_cast<arrow::DoubleArray>(lists->values());
+    for (int64_t i = 0; i < lists->length(); ++i) {
+      // A node without distances gets no bound
+      if (lists->IsNull(i)) {
+        search.landmarks_.insert(search.landmarks_.end(), width, kInfinity);
+        continue;
+      }
+      const double* begin = values->raw_values() + lists->value_offset(i);
+      search.landmarks_.insert(search.landmarks_.end(), begin, begin + width);
+    }
+  }
+  search.heuristic_ = kLandmarks;
+  return search_res;
+}
+
+double
+GoalDirectedSearch::LowerBound(uint32_t n, uint32_t target) const {
+  switch (heuristic_) {
+  case kEuclidean:
+    return scale_ * std::hypot(x_[target] - x_[n], y_[target] - y_[n]);
+  case kLandmarks: {
+    // For each landmark L, d(n, t) >= d(L, t) - d(L, n) and
+    // d(n, t) >= d(n, L) - d(t, L). Terms of two infinities are NaN and
+    // ignored; an infinite bound means that t cannot be reached from n.
+    uint32_t k = num_landmarks_;
+    const double* from_n = &landmarks_[2 * k * static_cast<uint64_t>(n)];
+    const double* from_t = &landmarks_[2 * k * static_cast<uint64_t>(target)];
+    double bound = 0;
+    for (uint32_t i = 0; i < k; ++i) {
+      double forward = from_t[i] - from_n[i];
+      double backward = from_n[k + i] - from_t[k + i];
+      if (forward > bound) {
+        bound = forward;
+      }
+      if (backward > bound) {
+        bound = backward;
+      }
+    }
+    return bound * (1 - kRoundingSlack);
+  }
+  case kNone:
+  default:
+    return 0;
+  }
+}
+
+void
+GoalDirectedSearch::Search(uint32_t source, uint32_t target, bool backward) {
+  katana::do_all(
+      katana::iterate(reached_),
+      [&](uint32_t n) {
+        distances_[n].store(kInfinity, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  reached_.clear();
+
+  distances_[source].store(0, std::memory_order_relaxed);
+  reached_.emplace_back(source);
+  double source_bound = target == kNoNode ? 0 : LowerBound(source, target);
+  if (source == target || source_bound == kInfinity) {
+    return;
+  }
+
+  // Nodes are only dropped if their priority exceeds (not equals) the best
+  // distance to target. With a consistent bound (h(n) <= w(n, m) + h(m)),
+  // which both of ours are, this leaves every node with priority at most the
+  // distance to target expanded at its final distance, so that each node on
+  // the way to target has an in-edge from a node of the search that is
+  // exactly as much closer to the source as it weighs, which ShortestPath
+  // follows back to the source.
+  auto pruned = [&](double priority) {
+    return target != kNoNode &&
+           priority > distances_[target].load(std::memory_order_relaxed);
+  };
+
+  katana::InsertBag<uint32_t> reached;
+  katana::InsertBag<Request> initial;
+  initial.push(Request{source, 0, source_bound});
+  katana::for_each(
+      katana::iterate(initial),
+      [&](const Request& item, auto& ctx) {
+        if (distances_[item.node].load(std::memory_order_relaxed) <
+                item.distance ||
+            pruned(item.priority)) {
+          return;
+        }
+        auto relax = [&](uint32_t dest, uint64_t e) {
+          double next = item.distance + weight(e);
+          double bound = target == kNoNode ? 0 : LowerBound(dest, target);
+          if (bound == kInfinity || pruned(next + bound)) {
+            return;
+          }
+          double old = katana::atomicMin(distances_[dest], next);
+          if (next < old) {
+            if (old == kInfinity) {
+              reached.push(dest);
+            }
+            if (dest != target) {
+              ctx.push(Request{dest, next, next + bound});
+            }
+          }
+        };
+        if (!backward) {
+          for (auto e : out_.edges(item.node)) {
+            relax(out_.edge_dest(e), e);
+          }
+        } else {
+          uint64_t begin = item.node > 0 ? in_indices_[item.node - 1] : 0;
+          for (uint64_t e = begin; e < in_indices_[item.node]; ++e) {
+            relax(in_sources_[e], in_edges_[e]);
+          }
+        }
+      },
+      katana::wl<OBIM>(RequestIndexer{delta_}),
+      katana::disable_conflict_detection(),
+      katana::loopname("GoalDirectedSearch"));
+
+  reached_.insert(reached_.end(), reached.begin(), reached.end());
+}
+
+double
+GoalDirectedSearch::Distance(uint32_t source, uint32_t target) {
+  KATANA_LOG_DEBUG_ASSERT(source < num_nodes() && target < num_nodes());
+  Search(source, target, false);
+  return distances_[target].load(std::memory_order_relaxed);
+}
+
+WeightedPath
+GoalDirectedSearch::ShortestPath(uint32_t source, uint32_t target) {
+  double distance = Distance(source, target);
+  if (distance == kInfinity) {
+    return WeightedPath{{}, kInfinity};
+  }
+  auto distance_of = [&](uint32_t n) {
+    return distances_[n].load(std::memory_order_relaxed);
+  };
+
+  // Edges of weight 0 may form cycles of such edges, so walk back breadth
+  // first, remembering the next node towards target of each node
+  std::unordered_map<uint32_t, uint32_t> successors{{target, kNoNode}};
+  std::vector<uint32_t> frontier{target};
+  std::vector<uint32_t> next;
+  while (!frontier.empty() && successors.count(source) == 0) {
+    next.clear();
+    for (uint32_t n : frontier) {
+      uint64_t begin = n > 0 ? in_indices_[n - 1] : 0;
+      for (uint64_t e = begin; e < in_indices_[n]; ++e) {
+        uint32_t from = in_sources_[e];
+        if (distance_of(from) + weight(in_edges_[e]) == distance_of(n) &&
+            successors.emplace(from, n).second) {
+          next.emplace_back(from);
+        }
+      }
+    }
+    std::swap(frontier, next);
+  }
+  KATANA_LOG_DEBUG_ASSERT(successors.count(source) > 0);
+
+  WeightedPath path{{}, distance};
+  if (successors.count(source) == 0) {
+    return path;
+  }
+  for (uint32_t n = source; n != kNoNode; n = successors.at(n)) {
+    path.nodes.emplace_back(n);
+  }
+  return path;
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::ComputeLandmarks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, uint32_t num_landmarks,
+    uint32_t first_landmark) {
+  uint64_t num_nodes = pg->num_nodes();
+  if (num_landmarks == 0 || first_landmark >= num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "need at least one landmark and a first landmark of the {} nodes",
+        num_nodes);
+  }
+  // Fail before searching rather than after
+  if (pg->node_schema()->GetFieldIndex(output_property_name) >= 0) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+  auto search_res = GoalDirectedSearch::Make(pg, edge_weight_property_name);
+  if (!search_res) {
+    return search_res.error();
+  }
+  GoalDirectedSearch& search = search_res.value();
+
+  std::vector<uint32_t> landmarks;
+  // The distances from and to each landmark
+  std::vector<std::vector<double>> from;
+  std::vector<std::vector<double>> to;
+  // The distance to each node from its closest landmark
+  std::vector<double> closest(num_nodes, GoalDirectedSearch::kInfinity);
+  uint32_t landmark = first_landmark;
+  while (landmark != GoalDirectedSearch::kNoNode &&
+         landmarks.size() < num_landmarks) {
+    if (auto r = CheckCancelled(); !r) {
+      return r.error();
+    }
+    landmarks.emplace_back(landmark);
+    for (bool backward : {false, true}) {
+      search.Search(landmark, GoalDirectedSearch::kNoNode, backward);
+      std::vector<double>& distances = (backward ? to : from).emplace_back();
+      distances.assign(num_nodes, GoalDirectedSearch::kInfinity);
+      katana::do_all(
+          katana::iterate(search.reached_),
+          [&](uint32_t n) {
+            distances[n] =
+                search.distances_[n].load(std::memory_order_relaxed);
+          },
+          katana::no_stats());
+    }
+
+    // Landmarks are at distance 0 from themselves and so never chosen again
+    landmark = GoalDirectedSearch::kNoNode;
+    double farthest = 0;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      closest[n] = std::min(closest[n], from.back()[n]);
+      if (closest[n] != GoalDirectedSearch::kInfinity &&
+          closest[n] > farthest) {
+        farthest = closest[n];
+        landmark = n;
+      }
+    }
+  }
+
+  uint32_t k = landmarks.size();
+  uint32_t width = 2 * k;
+  auto buffer_res = arrow::AllocateBuffer(num_nodes * width * sizeof(double));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating landmark distances: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* values = reinterpret_cast<double*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        for (uint32_t i = 0; i < k; ++i) {
+          values[n * width + i] = from[i][n];
+          values[n * width + k + i] = to[i][n];
+        }
+      },
+      katana::no_stats());
+
+  auto distances = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::float64(), width), num_nodes,
+      std::make_shared<arrow::DoubleArray>(num_nodes * width, buffer));
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema(
+              {arrow::field(output_property_name, distances->type())}),
+          {distances}));
+      !r) {
+    return r.error();
+  }
+  return landmarks;
+}
@@ -0,0 +1,238 @@
+#include "katana/analytics/point_to_point/point_to_point.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "edge_weights.h"
+#include "katana/Galois.h"
+
+using katana::analytics::PathQuery;
+using katana::analytics::PointToPointSearch;
+using katana::analytics::WeightedPath;
+
+namespace {
+
+constexpr uint32_t kNoNode = PointToPointSearch::kUnreachable;
+
+}  // namespace
+
+PointToPointSearch::PointToPointSearch(
+    GraphTopology out, std::vector<double> weights,
+    std::vector<uint64_t> in_indices, std::vector<uint32_t> in_sources,
+    std::vector<uint64_t> in_edges)
+    : out_(std::move(out)),
+      weights_(std::move(weights)),
+      in_indices_(std::move(in_indices)),
+      in_sources_(std::move(in_sources)),
+      in_edges_(std::move(in_edges)) {}
+
+katana::Result<PointToPointSearch>
+PointToPointSearch::Make(
+    PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  std::vector<double> weights;
+  if (!edge_weight_property_name.empty()) {
+    auto weights_res = CopyEdgeWeights(pg, edge_weight_property_name);
+    if (!weights_res) {
+      return weights_res.error();
+    }
+    weights = std::move(weights_res.value());
+  }
+  InEdges in = BuildInEdges(pg->topology());
+
+  return PointToPointSearch(
+      pg->topology(), std::move(weights), std::move(in.indices),
+      std::move(in.sources), std::move(in.edges));
+}
+
+uint32_t
+PointToPointSearch::Hops(uint32_t source, uint32_t target, Query* query)
+    const {
+  KATANA_LOG_DEBUG_ASSERT(source < num_nodes() && target < num_nodes());
+  uint32_t starts[2] = {source, target};
+  for (int i = 0; i < 2; ++i) {
+    Query::Side& side = query->sides_[i];
+    side.labels.clear();
+    side.frontier.clear();
+    side.labels.emplace(starts[i], Query::Label{0, 0, kNoNode});
+    side.frontier.emplace_back(starts[i]);
+  }
+  if (source == target) {
+    return 0;
+  }
+
+  // Expand whole levels of the side with the smaller frontier. The first
+  // node reached by both searches lies on a path with the fewest edges:
+  // until then every path is longer than the two depths together.
+  uint32_t depths[2] = {0, 0};
+  while (!query->sides_[0].frontier.empty() &&
+         !query->sides_[1].frontier.empty()) {
+    int i = query->sides_[0].frontier.size() <= query->sides_[1].frontier.size()
+                ? 0
+                : 1;
+    Query::Side& side = query->sides_[i];
+    const Query::Side& other = query->sides_[1 - i];
+    uint32_t depth = ++depths[i];
+    side.next.clear();
+    // The node both searches have reached, if any
+    uint32_t meet = kNoNode;
+    auto visit = [&](uint32_t n, uint32_t dest, uint64_t e) {
+      if (side.labels
+              .emplace(dest, Query::Label{static_cast<double>(depth), e, n})
+              .second) {
+        side.next.emplace_back(dest);
+        if (other.labels.count(dest) > 0) {
+          meet = dest;
+        }
+      }
+    };
+    for (uint32_t n : side.frontier) {
+      if (i == 0) {
+        for (auto e : out_.edges(n)) {
+          visit(n, out_.edge_dest(e), e);
+        }
+      } else {
+        uint64_t begin = n > 0 ? in_indices_[n - 1] : 0;
+        for (uint64_t e = begin; e < in_indices_[n]; ++e) {
+          visit(n, in_sources_[e], in_edges_[e]);
+        }
+      }
+      if (meet != kNoNode) {
+        return depth + static_cast<uint32_t>(other.labels.at(meet).distance);
+      }
+    }
+    std::swap(side.frontier, side.next);
+  }
+  return kUnreachable;
+}
+
+uint32_t
+PointToPointSearch::Search(
+    uint32_t source, uint32_t target, Query* query) const {
+  KATANA_LOG_DEBUG_ASSERT(source < num_nodes() && target < num_nodes());
+  uint32_t starts[2] = {source, target};
+  for (int i = 0; i < 2; ++i) {
+    Query::Side& side = query->sides_[i];
+    side.labels.clear();
+    side.heap.clear();
+    side.labels.emplace(starts[i], Query::Label{0, 0, kNoNode});
+    side.heap.emplace_back(0, starts[i]);
+  }
+
+  double best = kInfinity;
+  uint32_t meet = kNoNode;
+  if (source == target) {
+    best = 0;
+    meet = source;
+  }
+  // Every path not found yet is at least as long as the sum of the smallest
+  // distances left in the two heaps; advance the side with the smaller heap
+  while (!query->sides_[0].heap.empty() && !query->sides_[1].heap.empty() &&
+         query->sides_[0].heap.front().first +
+                 query->sides_[1].heap.front().first <
+             best) {
+    int i = query->sides_[0].heap.size() <= query->sides_[1].heap.size() ? 0
+                                                                          : 1;
+    Query::Side& side = query->sides_[i];
+    const Query::Side& other = query->sides_[1 - i];
+    std::pop_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+    auto [d, n] = side.heap.back();
+    side.heap.pop_back();
+    if (d > side.labels.at(n).distance) {
+      continue;
+    }
+
+    auto relax = [&](uint32_t dest, uint64_t e) {
+      double next = d + weight(e);
+      auto [it, inserted] =
+          side.labels.emplace(dest, Query::Label{next, e, n});
+      if (!inserted) {
+        if (next >= it->second.distance) {
+          return;
+        }
+        it->second = Query::Label{next, e, n};
+      }
+      side.heap.emplace_back(next, dest);
+      std::push_heap(side.heap.begin(), side.heap.end(), std::greater<>());
+      if (auto o = other.labels.find(dest);
+          o != other.labels.end() && next + o->second.distance < best) {
+        best = next + o->second.distance;
+        meet = dest;
+      }
+    };
+    if (i == 0) {
+      for (auto e : out_.edges(n)) {
+        relax(out_.edge_dest(e), e);
+      }
+    } else {
+      uint64_t begin = n > 0 ? in_indices_[n - 1] : 0;
+      for (uint64_t e = begin; e < in_indices_[n]; ++e) {
+        relax(in_sources_[e], in_edges_[e]);
+      }
+    }
+  }
+  return meet;
+}
+
+double
+PointToPointSearch::Distance(
+    uint32_t source, uint32_t target, Query* query) const {
+  uint32_t meet = Search(source, target, query);
+  if (meet == kNoNode) {
+    return kInfinity;
+  }
+  return query->sides_[0].labels.at(meet).distance +
+         query->sides_[1].labels.at(meet).distance;
+}
+
+WeightedPath
+PointToPointSearch::ShortestPath(
+    uint32_t source, uint32_t target, Query* query) const {
+  uint32_t meet = Search(source, target, query);
+  if (meet == kNoNode) {
+    return WeightedPath{{}, kInfinity};
+  }
+  const auto& forward = query->sides_[0].labels;
+  const auto& backward = query->sides_[1].labels;
+
+  WeightedPath path{
+      {}, forward.at(meet).distance + backward.at(meet).distance};
+  for (uint32_t n = meet; n != kNoNode; n = forward.at(n).parent) {
+    path.nodes.emplace_back(n);
+  }
+  std::reverse(path.nodes.begin(), path.nodes.end());
+  for (uint32_t n = backward.at(meet).parent; n != kNoNode;
+       n = backward.at(n).parent) {
+    path.nodes.emplace_back(n);
+  }
+  return path;
+}
+
+std::vector<double>
+PointToPointSearch::Distances(const std::vector<PathQuery>& queries) const {
+  std::vector<double> distances(queries.size());
+  katana::PerThreadStorage<Query> local_queries;
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t q) {
+        distances[q] = Distance(
+            queries[q].first, queries[q].second, local_queries.getLocal());
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("PointToPointDistances"));
+  return distances;
+}
+
+std::vector<uint32_t>
+PointToPointSearch::Hops(const std::vector<PathQuery>& queries) const {
+  std::vector<uint32_t> hops(queries.size());
+  katana::PerThreadStorage<Query> local_queries;
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t q) {
+        hops[q] = Hops(
+            queries[q].first, queries[q].second, local_queries.getLocal());
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("PointToPointHops"));
+  return hops;
+}
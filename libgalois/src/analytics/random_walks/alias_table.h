@@ -0,0 +1,62 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_RANDOMWALKS_ALIASTABLE_H_
+#define KATANA_LIBGALOIS_ANALYTICS_RANDOMWALKS_ALIASTABLE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+/// One slot of a table for sampling from a discrete distribution in
+/// constant time:
+///
+///   Michael D. Vose. A Linear Algorithm for Generating Random Numbers with a
+///   Given Distribution. IEEE Transactions on Software Engineering, 1991.
+///
+/// A uniformly chosen slot i is kept with probability prob, and is replaced
+/// by alias otherwise.
+struct AliasSlot {
+  float prob;
+  uint32_t alias;
+};
+
+/// Fill slots with the alias table of weights, which are overwritten.
+/// small and large are scratch space.
+inline void
+BuildAliasTable(
+    std::vector<double>* weights, AliasSlot* slots,
+    std::vector<uint32_t>* small, std::vector<uint32_t>* large) {
+  uint32_t n = weights->size();
+  double total = std::accumulate(weights->begin(), weights->end(), 0.0);
+  small->clear();
+  large->clear();
+  for (uint32_t i = 0; i < n; ++i) {
+    (*weights)[i] *= n / total;
+    ((*weights)[i] < 1.0 ? small : large)->emplace_back(i);
+  }
+  while (!small->empty() && !large->empty()) {
+    uint32_t s = small->back();
+    small->pop_back();
+    uint32_t l = large->back();
+    slots[s] = AliasSlot{static_cast<float>((*weights)[s]), l};
+    (*weights)[l] -= 1.0 - (*weights)[s];
+    if ((*weights)[l] < 1.0) {
+      large->pop_back();
+      small->emplace_back(l);
+    }
+  }
+  // What is left has weight 1 up to rounding
+  for (auto* rest : {small, large}) {
+    for (uint32_t i : *rest) {
+      slots[i] = AliasSlot{1.0f, i};
+    }
+  }
+}
+
+inline uint32_t
+SampleAlias(const AliasSlot* slots, uint32_t n, double u) {
+  double x = u * n;
+  uint32_t i = std::min(static_cast<uint32_t>(x), n - 1);
+  return x - i < slots[i].prob ? i : slots[i].alias;
+}
+
+#endif
@@ -0,0 +1,255 @@
+#include "katana/analytics/random_walks/node_embedding.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "alias_table.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/analytics/VectorSimilarity.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The step size decays linearly but never below this fraction of the
+/// initial one, as in word2vec
+constexpr float kMinLearningRateFraction = 1e-4;
+
+/// Beyond this the sigmoid is taken to be 0 or 1 and the gradient of the
+/// pair is dropped, as in word2vec
+constexpr float kMaxExponent = 6;
+
+/// y += a * x over n values; a plain loop that the compiler vectorizes
+void
+Axpy(float a, const float* x, float* y, uint32_t n) {
+  for (uint32_t i = 0; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+/// Skip-gram with negative sampling over the walks of a graph. Each node has
+/// an input vector, its embedding, and an output vector used to score it as
+/// the target of another node's prediction. Threads update both without
+/// synchronization (Hogwild): two walks rarely update the same vector at
+/// once, and a lost update only loses one step of SGD.
+class SkipGram {
+public:
+  SkipGram(const NodeEmbeddingPlan& plan, uint64_t num_nodes, float* input)
+      : plan_(plan),
+        dims_(plan.dimensions()),
+        num_nodes_(num_nodes),
+        input_(input) {
+    output_.allocateInterleaved(num_nodes_ * dims_);
+    // Threads start from different seeds so that they draw different
+    // initial vectors and samples
+    katana::on_each([&](unsigned tid, unsigned) {
+      generators_.getLocal()->seed(tid + 1);
+      updates_.getLocal()->resize(dims_);
+    });
+  }
+
+  /// Start every input vector at small random values and every output vector
+  /// at 0
+  void InitializeVectors() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          std::mt19937& gen = *generators_.getLocal();
+          std::uniform_real_distribution<float> dist(
+              -0.5f / dims_, 0.5f / dims_);
+          for (uint32_t d = 0; d < dims_; ++d) {
+            input_[n * dims_ + d] = dist(gen);
+            output_[n * dims_ + d] = 0;
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Build the table negative examples are drawn from, weighting each node
+  /// by degree^0.75. Returns false if no node has edges.
+  bool BuildNegativeTable(const katana::GraphTopology& topology) {
+    std::vector<double> weights(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          weights[n] = std::pow(topology.edges(n).size(), 0.75);
+        },
+        katana::no_stats());
+    if (std::all_of(
+            weights.begin(), weights.end(), [](double w) { return w == 0; })) {
+      return false;
+    }
+    negative_table_.allocateBlocked(num_nodes_);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    BuildAliasTable(&weights, negative_table_.data(), &small, &large);
+    return true;
+  }
+
+  /// Train on each walk of walks once, in parallel. The step size decays
+  /// with the number of walks trained on out of total_walks.
+  void Train(const arrow::LargeListArray& walks, uint64_t total_walks) {
+    const int64_t* offsets = walks.raw_value_offsets();
+    const uint32_t* nodes =
+        std::static_pointer_cast<arrow::UInt32Array>(walks.values())
+            ->raw_values();
+    katana::do_all(
+        katana::iterate(int64_t{0}, walks.length()),
+        [&](int64_t w) {
+          uint64_t done = walks_done_.fetch_add(1, std::memory_order_relaxed);
+          float fraction = std::max(
+              kMinLearningRateFraction,
+              1.0f - static_cast<float>(done) / total_walks);
+          TrainWalk(
+              nodes + offsets[w], offsets[w + 1] - offsets[w],
+              plan_.learning_rate() * fraction);
+        },
+        katana::steal(), katana::loopname("NodeEmbedding-Train"));
+  }
+
+private:
+  void TrainWalk(const uint32_t* walk, uint64_t length, float learning_rate) {
+    std::mt19937& gen = *generators_.getLocal();
+    std::uniform_int_distribution<uint32_t> window_dist(
+        1, plan_.window_size());
+    for (uint64_t i = 0; i < length; ++i) {
+      uint64_t window = window_dist(gen);
+      uint64_t begin = i > window ? i - window : 0;
+      uint64_t end = std::min(length, i + window + 1);
+      for (uint64_t j = begin; j < end; ++j) {
+        if (j != i) {
+          TrainPair(walk[j], walk[i], learning_rate, gen);
+        }
+      }
+    }
+  }
+
+  /// One SGD step on predicting target from the input vector of context,
+  /// against plan_.negative_samples() random nodes
+  void TrainPair(Node context, Node target, float learning_rate,
+                 std::mt19937& gen) {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    float* in = input_ + uint64_t{context} * dims_;
+    float* update = updates_.getLocal()->data();
+    std::fill(update, update + dims_, 0.0f);
+
+    for (uint32_t s = 0; s <= plan_.negative_samples(); ++s) {
+      Node sample = target;
+      float label = 1;
+      if (s > 0) {
+        sample = SampleAlias(negative_table_.data(), num_nodes_, dist(gen));
+        if (sample == target) {
+          continue;
+        }
+        label = 0;
+      }
+      float* out = &output_[uint64_t{sample} * dims_];
+      float x = DotProduct(in, out, dims_);
+      float prediction = x > kMaxExponent    ? 1
+                         : x < -kMaxExponent ? 0
+                                             : 1 / (1 + std::exp(-x));
+      float gradient = (label - prediction) * learning_rate;
+      Axpy(gradient, out, update, dims_);
+      Axpy(gradient, in, out, dims_);
+    }
+    Axpy(1, update, in, dims_);
+  }
+
+  const NodeEmbeddingPlan& plan_;
+  uint32_t dims_;
+  uint64_t num_nodes_;
+  float* input_;
+  katana::LargeArray<float> output_;
+  katana::LargeArray<AliasSlot> negative_table_;
+  katana::PerThreadStorage<std::mt19937> generators_;
+  katana::PerThreadStorage<std::vector<float>> updates_;
+  std::atomic<uint64_t> walks_done_{0};
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::NodeEmbedding(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    NodeEmbeddingPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckNotDeterministic(plan, "NodeEmbedding"); !r) {
+    return r.error();
+  }
+  if (plan.dimensions() == 0 || plan.window_size() == 0 ||
+      plan.walks_per_batch() == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "dimensions, window size and walks per batch must be positive");
+  }
+  // Fail before training rather than after
+  if (pg->node_schema()->GetFieldIndex(output_property_name) >= 0) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+
+  uint64_t num_nodes = pg->num_nodes();
+  uint32_t dims = plan.dimensions();
+  auto buffer_res = arrow::AllocateBuffer(num_nodes * dims * sizeof(float));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating embeddings: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+
+  SkipGram skip_gram(
+      plan, num_nodes, reinterpret_cast<float*>(buffer->mutable_data()));
+  skip_gram.InitializeVectors();
+
+  katana::StatTimer train_time("NodeEmbedding");
+  train_time.start();
+  if (skip_gram.BuildNegativeTable(pg->topology())) {
+    katana::GAccumulator<uint64_t> num_starts;
+    katana::do_all(
+        katana::iterate(pg->topology()),
+        [&](Node n) { num_starts += pg->topology().edges(n).size() > 0; },
+        katana::no_stats());
+    uint64_t total_walks = num_starts.reduce() * plan.number_of_walks();
+
+    for (uint32_t done = 0; done < plan.number_of_walks();
+         done += plan.walks_per_batch()) {
+      if (auto r = CheckCancelled(); !r) {
+        return r.error();
+      }
+      uint32_t count =
+          std::min(plan.walks_per_batch(), plan.number_of_walks() - done);
+      auto walks = RandomWalksAsListArray(
+          pg, RandomWalksPlan::Node2Vec(
+                  plan.walk_length(), count, plan.backward_probability(),
+                  plan.forward_probability()));
+      if (!walks) {
+        return walks.error().WithContext("generating walks");
+      }
+      skip_gram.Train(*walks.value(), total_walks);
+    }
+  }
+  train_time.stop();
+
+  auto vectors = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::float32(), dims), num_nodes,
+      std::make_shared<arrow::FloatArray>(num_nodes * dims, buffer));
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, vectors->type())}),
+      {vectors}));
+}
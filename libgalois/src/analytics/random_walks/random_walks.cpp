@@ -19,6 +19,14 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "alias_table.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -27,146 +35,425 @@ const int RandomWalksPlan::kChunkSize = 1;
 
 namespace {
 
-struct Node2VecAlgo {
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<>;
+/// The number of walks advanced together by one task. Every walk of a batch
+/// takes a step before any takes the next one, so that the loads of their
+/// edges overlap instead of each waiting on the previous one.
+constexpr uint32_t kWalkBatchSize = 64;
+
+/// Nodes of higher degree never get second-order tables, whatever the budget
+constexpr uint64_t kMaxSecondOrderTableDegree = 1024;
+
+/// Walks of at most max_length nodes, written with a fixed stride into one
+/// buffer until they are packed into the output
+class WalkBuffer {
+public:
+  static katana::Result<WalkBuffer> Make(
+      uint64_t num_walks, uint32_t max_length) {
+    auto res = arrow::AllocateBuffer(num_walks * max_length * sizeof(uint32_t));
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "allocating walks: {}", res.status());
+    }
+    WalkBuffer walks;
+    walks.num_walks_ = num_walks;
+    walks.max_length_ = max_length;
+    walks.buffer_ = std::move(res.ValueOrDie());
+    walks.lengths_.allocateBlocked(num_walks);
+    return katana::Result<WalkBuffer>(std::move(walks));
+  }
 
-  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
-  typedef typename Graph::Node GNode;
+  /// Pack walks that were generated into a bag
+  static katana::Result<WalkBuffer> Make(
+      const katana::InsertBag<std::vector<uint32_t>>& walks,
+      uint32_t max_length) {
+    uint64_t num_walks = std::distance(walks.begin(), walks.end());
+    auto res = Make(num_walks, max_length);
+    if (!res) {
+      return res.error();
+    }
+    WalkBuffer buffer = std::move(res.value());
+    uint64_t w = 0;
+    for (const auto& walk : walks) {
+      KATANA_LOG_DEBUG_ASSERT(walk.size() <= max_length);
+      std::copy(walk.begin(), walk.end(), buffer.walk(w));
+      buffer.set_length(w, walk.size());
+      ++w;
+    }
+    return katana::Result<WalkBuffer>(std::move(buffer));
+  }
 
-  const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  uint64_t num_walks() const { return num_walks_; }
+  uint32_t max_length() const { return max_length_; }
 
-  GNode FindSampleNeighbor(
-      const Graph& graph, const GNode& n,
-      const katana::LargeArray<uint64_t>& degree, double prob) {
-    if (degree[n] == 0) {
-      return graph.num_nodes();
-    }
-    double total_wt = degree[n];
-    prob = prob * total_wt;
+  uint32_t* walk(uint64_t w) {
+    return reinterpret_cast<uint32_t*>(buffer_->mutable_data()) +
+           w * max_length_;
+  }
+  const uint32_t* walk(uint64_t w) const {
+    return reinterpret_cast<const uint32_t*>(buffer_->data()) +
+           w * max_length_;
+  }
 
-    uint32_t edge_index = std::floor(prob);
-    auto edge = graph.edge_begin(n) + edge_index;
-    return *graph.GetEdgeDest(edge);
+  uint32_t length(uint64_t w) const { return lengths_[w]; }
+  void set_length(uint64_t w, uint32_t length) { lengths_[w] = length; }
+
+  std::vector<std::vector<uint32_t>> ToVectors() const {
+    std::vector<std::vector<uint32_t>> walks(num_walks_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walks_),
+        [&](uint64_t w) {
+          walks[w].assign(walk(w), walk(w) + length(w));
+        },
+        katana::no_stats());
+    return walks;
   }
 
-  void GraphRandomWalk(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
+  katana::Result<std::shared_ptr<arrow::LargeListArray>> ToListArray() {
+    auto offsets_res =
+        arrow::AllocateBuffer((num_walks_ + 1) * sizeof(int64_t));
+    if (!offsets_res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "allocating walk offsets: {}",
+          offsets_res.status());
+    }
+    std::shared_ptr<arrow::Buffer> offsets_buffer =
+        std::move(offsets_res.ValueOrDie());
+    auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walks_),
+        [&](uint64_t w) { offsets[w + 1] = length(w); }, katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets + 1, offsets + num_walks_ + 1, offsets + 1);
+    uint64_t num_values = offsets[num_walks_];
+
+    // Unless some walks ended early, the walks are already packed
+    std::shared_ptr<arrow::Buffer> values = buffer_;
+    if (num_values != num_walks_ * max_length_) {
+      auto values_res = arrow::AllocateBuffer(num_values * sizeof(uint32_t));
+      if (!values_res.ok()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::ArrowError, "allocating walk values: {}",
+            values_res.status());
+      }
+      values = std::move(values_res.ValueOrDie());
+      auto* packed = reinterpret_cast<uint32_t*>(values->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_walks_),
+          [&](uint64_t w) {
+            std::copy(walk(w), walk(w) + length(w), packed + offsets[w]);
+          },
+          katana::no_stats());
     }
 
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
+    return std::make_shared<arrow::LargeListArray>(
+        arrow::large_list(arrow::uint32()), num_walks_, offsets_buffer,
+        std::make_shared<arrow::UInt32Array>(num_values, values));
+  }
 
-    double upper_bound = 1.0;
+private:
+  uint64_t num_walks_{0};
+  uint32_t max_length_{0};
+  std::shared_ptr<arrow::Buffer> buffer_;
+  katana::LargeArray<uint32_t> lengths_;
+};
 
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
+struct Node2VecAlgo {
+  using GNode = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
 
-    double lower_bound = 1.0;
+  const RandomWalksPlan& plan_;
+  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
+  double prob_backward_{1.0};
+  double prob_forward_{1.0};
+  double upper_bound_{1.0};
+  double lower_bound_{1.0};
+
+  /// Nodes of at most this degree have second-order tables
+  uint64_t max_table_degree_{0};
+  /// The tables of node n start at table_offsets_[n]: for each neighbor
+  /// prev of n in edge order, an alias table over the edges of n for a walk
+  /// that came from prev
+  katana::LargeArray<uint64_t> table_offsets_;
+  katana::LargeArray<AliasSlot> tables_;
+
+  bool IsAdjacent(const katana::GraphTopology& graph, GNode a, GNode b) const {
+    auto edges = graph.edges(a);
+    const uint32_t* dests = graph.out_dests->raw_values();
+    return std::binary_search(
+        dests + *edges.begin(), dests + *edges.end(), b);
+  }
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+  /// The weight of moving to next for a walk that came from prev
+  double Weight(const katana::GraphTopology& graph, GNode prev, GNode next)
+      const {
+    if (next == prev) {
+      return prob_backward_;
+    }
+    if (IsAdjacent(graph, prev, next)) {
+      return 1.0;
+    }
+    return prob_forward_;
+  }
 
+  /// Pick the largest degree such that the tables of all nodes up to that
+  /// degree fit in the budget of the plan, and build them
+  void BuildSecondOrderTables(const katana::GraphTopology& graph) {
+    uint64_t num_nodes = graph.num_nodes();
+    uint64_t max_degree = std::min(
+        kMaxSecondOrderTableDegree, static_cast<uint64_t>(std::sqrt(
+                                        plan_.second_order_table_bytes() /
+                                        sizeof(AliasSlot))));
+    katana::PerThreadStorage<std::vector<uint64_t>> histograms;
     katana::do_all(
-        katana::iterate((uint64_t)0, total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t degree = graph.edges(n).size();
+          if (degree > max_degree) {
+            return;
+          }
+          auto& histogram = *histograms.getLocal();
+          if (histogram.empty()) {
+            histogram.resize(max_degree + 1);
+          }
+          histogram[degree] += 1;
+        },
+        katana::no_stats());
+
+    uint64_t slots = 0;
+    for (uint64_t d = 1; d <= max_degree; ++d) {
+      uint64_t count = 0;
+      for (unsigned t = 0; t < histograms.size(); ++t) {
+        const auto& histogram = *histograms.getRemote(t);
+        count += histogram.empty() ? 0 : histogram[d];
+      }
+      if ((slots + count * d * d) * sizeof(AliasSlot) >
+          plan_.second_order_table_bytes()) {
+        break;
+      }
+      slots += count * d * d;
+      max_table_degree_ = d;
+    }
+    if (max_table_degree_ == 0) {
+      return;
+    }
 
-          //check if n has no neighbor
-          if (degree[n] == 0) {
+    table_offsets_.allocateBlocked(num_nodes + 1);
+    table_offsets_[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t degree = graph.edges(n).size();
+          table_offsets_[n + 1] =
+              degree <= max_table_degree_ ? degree * degree : 0;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        table_offsets_.begin() + 1, table_offsets_.end(),
+        table_offsets_.begin() + 1);
+    tables_.allocateBlocked(table_offsets_[num_nodes]);
+
+    struct Scratch {
+      std::vector<double> weights;
+      std::vector<uint32_t> small;
+      std::vector<uint32_t> large;
+    };
+    katana::PerThreadStorage<Scratch> scratch;
+    const uint32_t* dests = graph.out_dests->raw_values();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          auto edges = graph.edges(n);
+          uint64_t degree = edges.size();
+          if (degree == 0 || degree > max_table_degree_) {
             return;
           }
+          Scratch& s = *scratch.getLocal();
+          const uint32_t* neighbors = dests + *edges.begin();
+          for (uint64_t j = 0; j < degree; ++j) {
+            s.weights.resize(degree);
+            for (uint64_t k = 0; k < degree; ++k) {
+              s.weights[k] = Weight(graph, neighbors[j], neighbors[k]);
+            }
+            BuildAliasTable(
+                &s.weights, &tables_[table_offsets_[n] + j * degree], &s.small,
+                &s.large);
+          }
+        },
+        katana::steal(), katana::loopname("Node2vec second-order tables"));
+  }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+  /// The second-order table of curr for a walk that came from prev, or
+  /// nullptr if there is none
+  const AliasSlot* FindTable(
+      const katana::GraphTopology& graph, GNode prev, GNode curr) const {
+    auto edges = graph.edges(curr);
+    uint64_t degree = edges.size();
+    if (degree > max_table_degree_) {
+      return nullptr;
+    }
+    const uint32_t* neighbors = graph.out_dests->raw_values() + *edges.begin();
+    const uint32_t* found =
+        std::lower_bound(neighbors, neighbors + degree, prev);
+    if (found == neighbors + degree || *found != prev) {
+      return nullptr;
+    }
+    return &tables_[table_offsets_[curr] + (found - neighbors) * degree];
+  }
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+  Edge UniformEdge(Edge begin, Edge end, double u) const {
+    return begin + std::min<Edge>(u * (end - begin), end - begin - 1);
+  }
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+  /// Acceptance-rejection sampling of the step from curr, starting from
+  /// the proposed edge
+  template <typename Random>
+  GNode RejectionStep(
+      const katana::GraphTopology& graph, GNode prev, GNode curr, Edge edge,
+      Random& random) const {
+    auto edges = graph.edges(curr);
+    while (true) {
+      GNode next = graph.edge_dest(edge);
+      double y = random() * upper_bound_;
+      if (y <= lower_bound_ || Weight(graph, prev, next) >= y) {
+        return next;
+      }
+      edge = UniformEdge(*edges.begin(), *edges.end(), random());
+    }
+  }
 
-          //Assumption: All edges have weight 1
-          Graph::Node nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+  katana::Result<WalkBuffer> operator()(const katana::GraphTopology& graph) {
+    prob_forward_ = 1.0 / plan_.forward_probability();
+    prob_backward_ = 1.0 / plan_.backward_probability();
+    upper_bound_ = std::max({1.0, prob_forward_, prob_backward_});
+    lower_bound_ = std::min({1.0, prob_forward_, prob_backward_});
+    // With equal weights every step is first-order
+    bool second_order = upper_bound_ != lower_bound_;
+    if (second_order) {
+      BuildSecondOrderTables(graph);
+    }
 
-          walk.push_back(std::move(nbr));
+    // Only nodes with edges start walks
+    uint64_t num_nodes = graph.num_nodes();
+    katana::LargeArray<uint64_t> start_index;
+    start_index.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { start_index[n] = graph.edges(n).size() > 0; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        start_index.begin(), start_index.end(), start_index.begin());
+    uint64_t num_starts = num_nodes > 0 ? start_index[num_nodes - 1] : 0;
+    katana::LargeArray<GNode> starts;
+    starts.allocateBlocked(num_starts);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          if (graph.edges(n).size() > 0) {
+            starts[start_index[n] - 1] = n;
+          }
+        },
+        katana::no_stats());
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+    uint64_t num_walks = num_starts * plan_.number_of_walks();
+    uint32_t max_length = std::max(plan_.walk_length(), 1U) + 1;
+    auto buffer_res = WalkBuffer::Make(num_walks, max_length);
+    if (!buffer_res) {
+      return buffer_res.error();
+    }
+    WalkBuffer walks = std::move(buffer_res.value());
 
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
+    const uint64_t* indices = graph.out_indices->raw_values();
+    const uint32_t* dests = graph.out_dests->raw_values();
+    katana::PerThreadStorage<std::mt19937> generator;
+    uint64_t num_batches = (num_walks + kWalkBatchSize - 1) / kWalkBatchSize;
 
-              Graph::Node nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_batches),
+        [&](uint64_t batch) {
+          std::mt19937& gen = *generator.getLocal();
+          std::uniform_real_distribution<double> dist(0.0, 1.0);
+          auto random = [&]() { return dist(gen); };
+
+          uint64_t first = batch * kWalkBatchSize;
+          uint32_t size = std::min<uint64_t>(kWalkBatchSize, num_walks - first);
+          std::array<GNode, kWalkBatchSize> prev;
+          std::array<GNode, kWalkBatchSize> curr;
+          std::array<Edge, kWalkBatchSize> proposal;
+          std::array<const AliasSlot*, kWalkBatchSize> table;
+          std::array<uint32_t, kWalkBatchSize> active;
+          uint32_t num_active = size;
+          for (uint32_t i = 0; i < size; ++i) {
+            GNode n = starts[(first + i) % num_starts];
+            walks.walk(first + i)[0] = n;
+            prev[i] = n;
+            curr[i] = n;
+            active[i] = i;
+          }
 
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+          for (uint32_t step = 1; step < max_length && num_active > 0;
+               ++step) {
+            for (uint32_t a = 0; a < num_active; ++a) {
+              __builtin_prefetch(&indices[curr[active[a]]]);
+            }
 
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
+            // Propose a step for every walk and prefetch what resolving it
+            // reads
+            for (uint32_t a = 0; a < num_active; ++a) {
+              uint32_t i = active[a];
+              auto edges = graph.edges(curr[i]);
+              table[i] = nullptr;
+              if (edges.size() == 0) {
+                continue;
+              }
+              if (second_order && step > 1) {
+                table[i] = FindTable(graph, prev[i], curr[i]);
+              }
+              if (table[i] != nullptr) {
+                __builtin_prefetch(table[i]);
               } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (
-                    katana::FindEdgeSortedByDest(graph, prev, nbr) !=
-                    graph.edge_end(prev)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
+                proposal[i] =
+                    UniformEdge(*edges.begin(), *edges.end(), random());
+                __builtin_prefetch(&dests[proposal[i]]);
+              }
+            }
 
-                if (alpha >= y) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
+            uint32_t still_active = 0;
+            for (uint32_t a = 0; a < num_active; ++a) {
+              uint32_t i = active[a];
+              uint64_t w = first + i;
+              auto edges = graph.edges(curr[i]);
+              if (edges.size() == 0) {
+                walks.set_length(w, step);
+                continue;
+              }
+              GNode next;
+              if (table[i] != nullptr) {
+                uint32_t k = SampleAlias(table[i], edges.size(), random());
+                next = dests[*edges.begin() + k];
+              } else if (second_order && step > 1) {
+                next = RejectionStep(
+                    graph, prev[i], curr[i], proposal[i], random);
+              } else {
+                next = dests[proposal[i]];
               }
+              walks.walk(w)[step] = next;
+              prev[i] = curr[i];
+              curr[i] = next;
+              active[still_active++] = i;
             }
+            num_active = still_active;
+          }
+          for (uint32_t a = 0; a < num_active; ++a) {
+            walks.set_length(first + active[a], max_length);
           }
-
-          (*walks).push(std::move(walk));
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
-  }
-
-  void operator()(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+    return katana::Result<WalkBuffer>(std::move(walks));
   }
 };
 
@@ -233,91 +520,109 @@ struct Edge2VecAlgo {
 
     uint64_t total_walks = graph.size() * plan_.number_of_walks();
 
+    uint32_t max_length = std::max(plan_.walk_length(), 1U) + 1;
+    const uint64_t* indices =
+        graph.GetPropertyGraph().topology().out_indices->raw_values();
+
+    // Every walk is a task that takes one step at a time, so that the walks
+    // of a thread take turns and the misses of their steps overlap
     katana::do_all(
         katana::iterate((uint64_t)0, total_walks),
         [&](uint64_t idx) {
           GNode n = idx % graph.size();
+          katana::PrefetchRead(&degree[n]);
 
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
-          }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          return [&, n, walk = std::vector<uint32_t>(),
+                  types_vec = std::vector<uint32_t>()]() mutable {
+            std::uniform_real_distribution<double>* dist =
+                *distribution.getLocal();
 
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
+            if (walk.empty()) {
+              //check if n has no neighbor
+              if (degree[n] == 0) {
+                return false;
+              }
 
-          walk.push_back(n);
+              walk.reserve(max_length);
+              types_vec.reserve(max_length - 1);
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+              walk.push_back(n);
 
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
+              //random value between 0 and 1
+              double prob = (*dist)(*generator.getLocal());
 
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
+              //Assumption: All edges have weight 1
+              auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
+              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              return;
-            }
-            uint32_t prev = walk[walk.size() - 2];
+              walk.push_back(std::move(nbr_pair.first));
+              types_vec.push_back(nbr_pair.second);
+            } else {
+              uint32_t curr = walk[walk.size() - 1];
+              //check if n has no neighbor
+              if (degree[curr] == 0) {
+                return false;
+              }
+              uint32_t prev = walk[walk.size() - 2];
 
-            uint32_t p1 = types_vec.back();  //last element of types_vec
+              uint32_t p1 = types_vec.back();  //last element of types_vec
 
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
+              //acceptance-rejection sampling
+              while (true) {
+                //sample x
+                double prob = (*dist)(*generator.getLocal());
 
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
+                auto nbr_type_pair =
+                    FindSampleNeighbor(graph, curr, degree, prob);
+                KATANA_LOG_ASSERT(nbr_type_pair.first < graph.num_nodes());
 
-              Graph::Node nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
+                Graph::Node nbr = nbr_type_pair.first;
+                EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
 
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+                //sample y
+                double y = (*dist)(*generator.getLocal());
+                y = y * upper_bound;
 
-              //compute transition probability
-              double alpha;
+                //compute transition probability
+                double alpha;
 
-              //check if nbr is same as the previous node on this walk
-              if (nbr == prev) {
-                alpha = prob_backward;
-              }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (
-                  katana::FindEdgeSortedByDest(graph, prev, nbr) !=
-                  graph.edge_end(prev)) {
-                alpha = 1.0;
-              } else {
-                alpha = prob_forward;
-              }
+                //check if nbr is same as the previous node on this walk
+                if (nbr == prev) {
+                  alpha = prob_backward;
+                }  //check if nbr is also a neighbor of the previous node
+                else if (
+                    katana::FindEdgeSortedByDest(graph, prev, nbr) !=
+                    graph.edge_end(prev)) {
+                  alpha = 1.0;
+                } else {
+                  alpha = prob_forward;
+                }
 
-              alpha = alpha * transition_matrix_[p1][p2];
-              if (alpha >= y) {
-                //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
-                break;
-              }
-            }  //end while
+                alpha = alpha * transition_matrix_[p1][p2];
+                if (alpha >= y) {
+                  //accept y
+                  walk.push_back(std::move(nbr));
+                  types_vec.push_back(p2);
+                  break;
+                }
+              }  //end while
+            }
 
-          }  //end for
+            if (walk.size() >= max_length) {
+              (*walks).push(std::move(walk));
+              (*types_walks).push(std::move(types_vec));
+              return false;
+            }
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+            // Prefetch what sampling from the new last node reads
+            uint32_t next = walk.back();
+            katana::PrefetchRead(&degree[next]);
+            katana::PrefetchRead(indices + next - (next > 0));
+            return true;
+          };
         },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+        katana::interleave<>(), katana::steal(),
+        katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
   }
 
@@ -343,7 +648,7 @@ struct Edge2VecAlgo {
         });
 
     for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
+      for (auto& num_edge_types :
            *per_thread_num_edge_types_walks.getRemote(j)) {
         num_edge_types_walks.push_back(std::move(num_edge_types));
       }
@@ -395,8 +700,8 @@ struct Edge2VecAlgo {
       const std::vector<std::vector<uint32_t>>&
           transformed_num_edge_types_walks,
       const std::vector<double>& means) {
-    std::vector<uint32_t> x = transformed_num_edge_types_walks[i];
-    std::vector<uint32_t> y = transformed_num_edge_types_walks[j];
+    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
+    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
 
     double sum = 0.0;
     double sig1 = 0.0;
@@ -478,56 +783,68 @@ InitializeDegrees(const Graph& graph, katana::LargeArray<uint64_t>* degree) {
 
 }  //namespace
 
-template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
-RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
-  if (auto res = katana::SortAllEdgesByDest(pg); !res) {
-    return res.error();
-  }
-
-  auto pg_result = Algorithm::Graph::Make(pg);
+static katana::Result<WalkBuffer>
+Edge2VecWalks(katana::PropertyGraph* pg, const RandomWalksPlan& plan) {
+  auto pg_result = Edge2VecAlgo::Graph::Make(pg);
   if (!pg_result) {
     return pg_result.error();
   }
 
   auto graph = pg_result.value();
 
-  Algorithm algo(plan);
+  Edge2VecAlgo algo(plan);
 
   katana::LargeArray<uint64_t> degree;
   degree.allocateBlocked(graph.size());
-  InitializeDegrees<typename Algorithm::Graph>(graph, &degree);
+  InitializeDegrees<Edge2VecAlgo::Graph>(graph, &degree);
 
-  katana::StatTimer execTime("RandomWalks");
-  execTime.start();
   katana::InsertBag<std::vector<uint32_t>> walks;
   algo(graph, &walks, degree);
-  execTime.stop();
-
-  execTime.stop();
 
-  degree.destroy();
-  degree.deallocate();
+  return WalkBuffer::Make(walks, std::max(plan.walk_length(), 1U) + 1);
+}
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(pg->num_nodes() * plan.number_of_walks());
-  // Copy to vector of vectors.
-  for (auto walk : walks) {
-    walks_in_vector.push_back(walk);
+static katana::Result<WalkBuffer>
+RandomWalksImpl(katana::PropertyGraph* pg, const RandomWalksPlan& plan) {
+  if (auto res = katana::SortAllEdgesByDest(pg); !res) {
+    return res.error();
   }
-  return walks_in_vector;
-}
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  katana::StatTimer execTime("RandomWalks");
+  execTime.start();
+  katana::Result<WalkBuffer> walks = katana::ErrorCode::InvalidArgument;
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec:
-    return RandomWalksWithWrap<Node2VecAlgo>(pg, plan);
+    walks = Node2VecAlgo(plan)(pg->topology());
+    break;
   case RandomWalksPlan::kEdge2Vec:
-    return RandomWalksWithWrap<Edge2VecAlgo>(pg, plan);
+    walks = Edge2VecWalks(pg, plan);
+    break;
   default:
-    return ErrorCode::InvalidArgument;
+    break;
+  }
+  execTime.stop();
+
+  return walks;
+}
+
+katana::Result<std::vector<std::vector<uint32_t>>>
+katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  auto walks = RandomWalksImpl(pg, plan);
+  if (!walks) {
+    return walks.error();
+  }
+  return walks.value().ToVectors();
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+katana::analytics::RandomWalksAsListArray(
+    PropertyGraph* pg, RandomWalksPlan plan) {
+  auto walks = RandomWalksImpl(pg, plan);
+  if (!walks) {
+    return walks.error();
   }
+  return walks.value().ToListArray();
 }
 
 /// \cond DO_NOT_DOCUMENT
@@ -0,0 +1,283 @@
+#include "katana/analytics/similarity_join/similarity_join.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/analytics/Intersection.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using SimilarNodeLists = std::vector<std::vector<SimilarNode>>;
+
+/// Pruning bounds are loosened by this much so that rounding never prunes a
+/// pair whose similarity is exactly the bound; candidates are still verified
+/// exactly
+constexpr double kSlack = 1e-9;
+
+/// Return true if a is more similar than b or as similar with a lower id,
+/// i.e., a comes before b in a result
+bool
+Better(const SimilarNode& a, const SimilarNode& b) {
+  if (a.similarity != b.similarity) {
+    return a.similarity > b.similarity;
+  }
+  return a.node < b.node;
+}
+
+/// The neighbor sets of the nodes without repeated neighbors, with each
+/// neighbor replaced by its rank in increasing order of the number of sets
+/// that hold it, so that the first elements of a set are its rarest, and an
+/// inverted index from each rank to the nodes whose sets hold it, ordered by
+/// set size.
+class NeighborSets {
+  std::vector<uint64_t> set_begin_;
+  std::vector<uint32_t> sets_;
+  std::vector<uint64_t> index_begin_;
+  std::vector<Node> index_;
+
+public:
+  explicit NeighborSets(const katana::GraphTopology& topology);
+
+  uint64_t size(Node n) const { return set_begin_[n + 1] - set_begin_[n]; }
+
+  const uint32_t* begin(Node n) const { return sets_.data() + set_begin_[n]; }
+  const uint32_t* end(Node n) const { return sets_.data() + set_begin_[n + 1]; }
+
+  /// The nodes whose sets hold rank, in increasing order of set size and
+  /// then of node id
+  const Node* index_begin(uint32_t rank) const {
+    return index_.data() + index_begin_[rank];
+  }
+  const Node* index_end(uint32_t rank) const {
+    return index_.data() + index_begin_[rank + 1];
+  }
+};
+
+NeighborSets::NeighborSets(const katana::GraphTopology& topology)
+    : set_begin_(topology.num_nodes() + 1, 0),
+      index_begin_(topology.num_nodes() + 1, 0) {
+  uint64_t num_nodes = topology.num_nodes();
+
+  // Sort the neighbors of each node in place and drop repeats
+  std::vector<uint32_t> dests(topology.num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        auto [begin, end] = EdgeDestRange(topology, n);
+        uint32_t* out = dests.data() + topology.edge_range(n).first;
+        std::copy(begin, end, out);
+        std::sort(out, out + (end - begin));
+        set_begin_[n + 1] = std::unique(out, out + (end - begin)) - out;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      set_begin_.begin(), set_begin_.end(), set_begin_.begin());
+
+  sets_.resize(set_begin_[num_nodes]);
+  std::vector<std::atomic<uint64_t>> frequency(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        const uint32_t* begin = dests.data() + topology.edge_range(n).first;
+        std::copy(begin, begin + size(n), sets_.data() + set_begin_[n]);
+        for (const uint32_t* it = this->begin(n); it != end(n); ++it) {
+          frequency[*it].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  dests = std::vector<uint32_t>();
+
+  std::vector<Node> order(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { order[n] = n; }, katana::no_stats());
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](Node a, Node b) {
+    uint64_t fa = frequency[a].load(std::memory_order_relaxed);
+    uint64_t fb = frequency[b].load(std::memory_order_relaxed);
+    return fa < fb || (fa == fb && a < b);
+  });
+  std::vector<uint32_t> rank(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        rank[order[i]] = i;
+        index_begin_[i + 1] = frequency[order[i]];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      index_begin_.begin(), index_begin_.end(), index_begin_.begin());
+
+  // Relabel the sets with ranks and fill the index; the cursors reuse the
+  // frequencies
+  index_.resize(index_begin_[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { frequency[i] = index_begin_[i]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        uint32_t* begin = sets_.data() + set_begin_[n];
+        uint32_t* end = begin + size(n);
+        for (uint32_t* it = begin; it != end; ++it) {
+          *it = rank[*it];
+          index_[frequency[*it].fetch_add(1, std::memory_order_relaxed)] = n;
+        }
+        std::sort(begin, end);
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        Node* begin = index_.data() + index_begin_[i];
+        Node* end = index_.data() + index_begin_[i + 1];
+        std::sort(begin, end, [&](Node a, Node b) {
+          return size(a) < size(b) || (size(a) == size(b) && a < b);
+        });
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The per-thread state of a query
+struct Scratch {
+  /// seen[n] is set if n has been a candidate of the current query
+  std::vector<uint8_t> seen;
+  std::vector<Node> candidates;
+  /// The result of the current query; a heap whose front is the worst node
+  /// in top-k mode
+  std::vector<SimilarNode> best;
+};
+
+/// Find the similar nodes of node
+void
+Query(
+    const NeighborSets& sets, const SimilarityJoinPlan& plan, Node node,
+    Scratch* scratch, std::vector<SimilarNode>* result) {
+  uint64_t node_size = sets.size(node);
+  if (node_size == 0) {
+    return;
+  }
+  bool top_k = plan.mode() == SimilarityJoinPlan::kTopK;
+  auto& best = scratch->best;
+  best.clear();
+
+  // The least similarity a new candidate must have
+  auto bound = [&]() {
+    if (top_k && best.size() == plan.k()) {
+      return best.front().similarity;
+    }
+    return plan.threshold();
+  };
+
+  for (uint64_t i = 0; i < node_size; ++i) {
+    double loose = std::max(0.0, bound() - kSlack);
+    // A node that shares none of the first i neighbors shares at most
+    // node_size - i
+    if (static_cast<double>(node_size - i) < loose * node_size) {
+      break;
+    }
+    auto min_size = static_cast<uint64_t>(std::ceil(loose * node_size));
+    double max_size = loose > 0 ? node_size / loose
+                                : std::numeric_limits<double>::infinity();
+
+    uint32_t rank = sets.begin(node)[i];
+    const Node* it = std::lower_bound(
+        sets.index_begin(rank), sets.index_end(rank), min_size,
+        [&](Node n, uint64_t s) { return sets.size(n) < s; });
+    for (; it != sets.index_end(rank); ++it) {
+      Node other = *it;
+      uint64_t other_size = sets.size(other);
+      if (other_size > max_size) {
+        break;
+      }
+      if (other == node || scratch->seen[other]) {
+        continue;
+      }
+      scratch->seen[other] = 1;
+      scratch->candidates.emplace_back(other);
+
+      uint64_t common = CountSortedIntersection(
+          sets.begin(node), sets.end(node), sets.begin(other),
+          sets.end(other));
+      SimilarNode candidate{
+          other, static_cast<double>(common) /
+                     static_cast<double>(node_size + other_size - common)};
+      if (candidate.similarity < plan.threshold()) {
+        continue;
+      }
+      if (!top_k) {
+        best.emplace_back(candidate);
+      } else if (best.size() < plan.k()) {
+        best.emplace_back(candidate);
+        std::push_heap(best.begin(), best.end(), Better);
+      } else if (Better(candidate, best.front())) {
+        std::pop_heap(best.begin(), best.end(), Better);
+        best.back() = candidate;
+        std::push_heap(best.begin(), best.end(), Better);
+      }
+    }
+  }
+
+  for (Node n : scratch->candidates) {
+    scratch->seen[n] = 0;
+  }
+  scratch->candidates.clear();
+  std::sort(best.begin(), best.end(), Better);
+  result->assign(best.begin(), best.end());
+}
+
+}  // namespace
+
+katana::Result<std::vector<std::vector<SimilarNode>>>
+katana::analytics::SimilarityJoin(
+    katana::PropertyGraph* pg, SimilarityJoinPlan plan) {
+  double threshold = plan.threshold();
+  if (plan.mode() == SimilarityJoinPlan::kThreshold &&
+      !(threshold > 0 && threshold <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "threshold must be in (0, 1], got {}", threshold);
+  }
+  if (plan.mode() == SimilarityJoinPlan::kTopK) {
+    if (plan.k() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "k must be positive");
+    }
+    if (!(threshold >= 0 && threshold <= 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "minimum similarity must be in [0, 1], got {}", threshold);
+    }
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  katana::StatTimer exec_time("SimilarityJoin", "SimilarityJoin");
+  exec_time.start();
+
+  NeighborSets sets(topology);
+  SimilarNodeLists result(num_nodes);
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        Scratch& local = *scratch.getLocal();
+        if (local.seen.size() != num_nodes) {
+          local.seen.assign(num_nodes, 0);
+        }
+        Query(sets, plan, n, &local, &result[n]);
+      },
+      katana::steal(), katana::chunk_size<16>(),
+      katana::loopname("SimilarityJoin"));
+
+  exec_time.stop();
+  return katana::Result<SimilarNodeLists>(std::move(result));
+}
@@ -0,0 +1,305 @@
+#include "katana/analytics/spectral_centrality/spectral_centrality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/analytics/SpMV.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Sums are taken over blocks of this many nodes and then over the blocks
+/// in order, so results do not depend on the number of threads
+constexpr uint64_t kSumBlock = 4096;
+
+/// Return the sum of f(n) over the nodes n < num_nodes
+template <typename F>
+double
+BlockedSum(uint64_t num_nodes, const F& f) {
+  std::vector<double> partial((num_nodes + kSumBlock - 1) / kSumBlock);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{partial.size()}),
+      [&](uint64_t b) {
+        double sum = 0;
+        uint64_t end = std::min(num_nodes, (b + 1) * kSumBlock);
+        for (uint64_t n = b * kSumBlock; n < end; ++n) {
+          sum += f(n);
+        }
+        partial[b] = sum;
+      },
+      katana::no_stats());
+  double sum = 0;
+  for (double s : partial) {
+    sum += s;
+  }
+  return sum;
+}
+
+/// Return the largest of values, which must not be negative
+template <typename T>
+double
+Max(const std::vector<T>& values) {
+  katana::GReduceMax<double> max;
+  max.update(0);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{values.size()}),
+      [&](uint64_t n) { max.update(values[n]); }, katana::no_stats());
+  return max.reduce();
+}
+
+/// Divide values by norm unless it is 0
+template <typename T>
+void
+Scale(std::vector<T>* values, double norm) {
+  if (norm == 0) {
+    return;
+  }
+  auto scale = static_cast<T>(1 / norm);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{values->size()}),
+      [&](uint64_t n) { (*values)[n] *= scale; }, katana::no_stats());
+}
+
+/// Return the sum of the absolute differences of prev and next
+template <typename T>
+double
+Change(const std::vector<T>& prev, const std::vector<T>& next) {
+  return BlockedSum(prev.size(), [&](uint64_t n) {
+    return std::abs(static_cast<double>(next[n]) - prev[n]);
+  });
+}
+
+template <typename T>
+double
+L2Norm(const std::vector<T>& values) {
+  return std::sqrt(BlockedSum(values.size(), [&](uint64_t n) {
+    return static_cast<double>(values[n]) * values[n];
+  }));
+}
+
+template <typename T>
+double
+Sum(const std::vector<T>& values) {
+  return BlockedSum(values.size(), [&](uint64_t n) { return values[n]; });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Transpose(katana::PropertyGraph* pg) {
+  return katana::CreateTransposeGraph(pg);
+}
+
+katana::Result<void>
+CheckPlan(const SpectralCentralityPlan& plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (!(plan.tolerance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "tolerance must not be negative, got {}", plan.tolerance());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Copy values to a new node property name of pg
+template <typename T>
+katana::Result<void>
+WriteProperty(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<T>& values) {
+  auto view = AddNodeVectorProperty<T>(pg, name);
+  if (!view) {
+    return view.error();
+  }
+  T* out = view.value().data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{values.size()}),
+      [&](uint64_t n) { out[n] = values[n]; }, katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+template <typename T>
+katana::Result<void>
+EigenvectorCentralityImpl(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const EigenvectorCentralityPlan& plan) {
+  auto transpose = Transpose(pg);
+  if (!transpose) {
+    return transpose.error();
+  }
+  uint64_t num_nodes = pg->num_nodes();
+
+  katana::StatTimer exec_time("EigenvectorCentrality", "EigenvectorCentrality");
+  exec_time.start();
+
+  SemiringMatrix<PlusTimes<T>> matrix(
+      pg->topology(), &transpose.value()->topology());
+  std::vector<T> prev(num_nodes, T(1) / num_nodes);
+  std::vector<T> next(num_nodes);
+  unsigned int iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    ++iteration;
+    matrix.Multiply(prev.data(), next.data());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { next[n] += prev[n]; }, katana::no_stats());
+    Scale(&next, L2Norm(next));
+    double change = Change(prev, next);
+    std::swap(prev, next);
+    if (change < num_nodes * plan.tolerance()) {
+      break;
+    }
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("EigenvectorCentrality", "Iterations", iteration);
+  return WriteProperty(pg, output_property_name, prev);
+}
+
+template <typename T>
+katana::Result<void>
+KatzCentralityImpl(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const KatzCentralityPlan& plan) {
+  auto transpose = Transpose(pg);
+  if (!transpose) {
+    return transpose.error();
+  }
+  uint64_t num_nodes = pg->num_nodes();
+
+  katana::StatTimer exec_time("KatzCentrality", "KatzCentrality");
+  exec_time.start();
+
+  auto alpha = static_cast<T>(plan.alpha());
+  auto beta = static_cast<T>(plan.beta());
+  SemiringMatrix<PlusTimes<T>> matrix(
+      pg->topology(), &transpose.value()->topology());
+  std::vector<T> prev(num_nodes, T(0));
+  std::vector<T> next(num_nodes);
+  unsigned int iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    ++iteration;
+    matrix.Multiply(prev.data(), next.data());
+    double change = BlockedSum(num_nodes, [&](uint64_t n) {
+      next[n] = alpha * next[n] + beta;
+      return std::abs(static_cast<double>(next[n]) - prev[n]);
+    });
+    std::swap(prev, next);
+    if (change < num_nodes * plan.tolerance()) {
+      break;
+    }
+  }
+  if (plan.normalized()) {
+    Scale(&prev, L2Norm(prev));
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("KatzCentrality", "Iterations", iteration);
+  return WriteProperty(pg, output_property_name, prev);
+}
+
+template <typename T>
+katana::Result<void>
+HitsImpl(
+    katana::PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name, const HitsPlan& plan) {
+  auto transpose = Transpose(pg);
+  if (!transpose) {
+    return transpose.error();
+  }
+  const katana::GraphTopology& out = pg->topology();
+  const katana::GraphTopology& in = transpose.value()->topology();
+  uint64_t num_nodes = pg->num_nodes();
+
+  katana::StatTimer exec_time("Hits", "Hits");
+  exec_time.start();
+
+  // authority = A^T hub pulls along in-edges and hub = A authority along
+  // out-edges, so each matrix is the transpose of the other
+  SemiringMatrix<PlusTimes<T>> to_authority(out, &in);
+  SemiringMatrix<PlusTimes<T>> to_hub(in, &out);
+  std::vector<T> hub(num_nodes, T(1) / num_nodes);
+  std::vector<T> next_hub(num_nodes);
+  std::vector<T> authority(num_nodes);
+  unsigned int iteration = 0;
+  while (iteration < plan.max_iterations()) {
+    ++iteration;
+    to_authority.Multiply(hub.data(), authority.data());
+    to_hub.Multiply(authority.data(), next_hub.data());
+    Scale(&next_hub, Max(next_hub));
+    double change = Change(hub, next_hub);
+    std::swap(hub, next_hub);
+    if (change < num_nodes * plan.tolerance()) {
+      break;
+    }
+  }
+  // The authorities of the last hubs, so the two agree
+  to_authority.Multiply(hub.data(), authority.data());
+  Scale(&hub, Sum(hub));
+  Scale(&authority, Sum(authority));
+
+  exec_time.stop();
+  katana::ReportStatSingle("Hits", "Iterations", iteration);
+  if (auto r = WriteProperty(pg, hub_property_name, hub); !r) {
+    return r.error();
+  }
+  return WriteProperty(pg, authority_property_name, authority);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::EigenvectorCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    EigenvectorCentralityPlan plan) {
+  if (auto r = CheckPlan(plan); !r) {
+    return r.error();
+  }
+  if (plan.precision() == SpectralCentralityPlan::kFloat32) {
+    return EigenvectorCentralityImpl<float>(pg, output_property_name, plan);
+  }
+  return EigenvectorCentralityImpl<double>(pg, output_property_name, plan);
+}
+
+katana::Result<void>
+katana::analytics::KatzCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    KatzCentralityPlan plan) {
+  if (auto r = CheckPlan(plan); !r) {
+    return r.error();
+  }
+  if (!(plan.alpha() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be positive, got {}",
+        plan.alpha());
+  }
+  if (plan.precision() == SpectralCentralityPlan::kFloat32) {
+    return KatzCentralityImpl<float>(pg, output_property_name, plan);
+  }
+  return KatzCentralityImpl<double>(pg, output_property_name, plan);
+}
+
+katana::Result<void>
+katana::analytics::Hits(
+    katana::PropertyGraph* pg, const std::string& hub_property_name,
+    const std::string& authority_property_name, HitsPlan plan) {
+  if (auto r = CheckPlan(plan); !r) {
+    return r.error();
+  }
+  if (hub_property_name == authority_property_name) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "hub and authority properties must differ, both are {}",
+        hub_property_name);
+  }
+  if (plan.precision() == SpectralCentralityPlan::kFloat32) {
+    return HitsImpl<float>(
+        pg, hub_property_name, authority_property_name, plan);
+  }
+  return HitsImpl<double>(pg, hub_property_name, authority_property_name, plan);
+}
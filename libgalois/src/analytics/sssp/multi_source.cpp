@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/WorkList.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Lanes = uint64_t;
+
+/// Call fn with the index of each set bit of lanes
+template <typename Fn>
+void
+ForEachLane(Lanes lanes, const Fn& fn) {
+  while (lanes != 0) {
+    fn(static_cast<uint32_t>(__builtin_ctzll(lanes)));
+    lanes &= lanes - 1;
+  }
+}
+
+/// Lower key to k if it is larger and return its old value. Unlike
+/// katana::atomicMin this is sequentially consistent, which the hand-off
+/// between the threads queueing a node and the one relaxing it relies on.
+template <typename T>
+T
+LowerKey(std::atomic<T>& key, T k) {
+  T old = key.load();
+  while (old > k && !key.compare_exchange_weak(old, k)) {
+  }
+  return old;
+}
+
+/// Multi-source delta stepping for weights of type Weight. Distances are
+/// doubles for floating-point weights and uint64 otherwise.
+template <typename Weight>
+struct MultiSourceSsspImpl {
+  using Distance =
+      std::conditional_t<std::is_floating_point_v<Weight>, double, uint64_t>;
+  using EdgeWeight = katana::PODProperty<Weight>;
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeWeight>>;
+
+  static constexpr Distance kInfinity =
+      std::numeric_limits<Distance>::has_infinity
+          ? std::numeric_limits<Distance>::infinity()
+          : std::numeric_limits<Distance>::max();
+  static constexpr unsigned kChunkSize = 64;
+
+  /// A node to relax, queued by the smallest distance of it that improved
+  /// since it was last relaxed
+  struct Request {
+    uint32_t node;
+    Distance key;
+  };
+
+  struct RequestIndexer {
+    Distance divisor;
+
+    explicit RequestIndexer(unsigned shift)
+        : divisor(static_cast<Distance>(uint64_t{1} << shift)) {}
+
+    unsigned int operator()(const Request& req) const {
+      return static_cast<unsigned int>(req.key / divisor);
+    }
+  };
+
+  using OBIM = katana::OrderedByIntegerMetric<
+      RequestIndexer, katana::PerSocketChunkFIFO<kChunkSize>>;
+
+  Graph* graph;
+  /// Row n holds the distances of node n from every source
+  std::atomic<Distance>* distances;
+  uint64_t num_sources;
+  /// The lanes of each node whose distance improved since it was last
+  /// relaxed
+  katana::LargeArray<std::atomic<Lanes>> dirty;
+  /// The key by which each node is queued, or kInfinity if it is not
+  katana::LargeArray<std::atomic<Distance>> queued;
+
+  MultiSourceSsspImpl(
+      Graph* graph, std::atomic<Distance>* distances, uint64_t num_sources)
+      : graph(graph), distances(distances), num_sources(num_sources) {
+    uint64_t num_nodes = graph->num_nodes();
+    dirty.allocateInterleaved(num_nodes);
+    queued.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes * num_sources),
+        [&](uint64_t i) {
+          distances[i].store(kInfinity, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          dirty.constructAt(n, 0);
+          queued.constructAt(n, kInfinity);
+        },
+        katana::no_stats());
+  }
+
+  /// Search from sources[first], ..., sources[first + count - 1], which use
+  /// the lanes 0 to count - 1 of the columns from first on. dirty and
+  /// queued are all clear before and after.
+  void RunBatch(
+      const std::vector<uint32_t>& sources, uint64_t first, uint32_t count,
+      unsigned shift) {
+    katana::InsertBag<Request> initial;
+    for (uint32_t l = 0; l < count; ++l) {
+      uint32_t source = sources[first + l];
+      distances[source * num_sources + first + l].store(
+          0, std::memory_order_relaxed);
+      // The same node may be the source of several lanes
+      if (dirty[source].fetch_or(Lanes{1} << l) == 0) {
+        queued[source].store(0);
+        initial.push(Request{source, 0});
+      }
+    }
+
+    katana::for_each(
+        katana::iterate(initial),
+        [&](const Request& req, auto& ctx) {
+          uint32_t n = req.node;
+          // Clear the key before taking the lanes, so that a lane that
+          // improves after they are taken queues the node again
+          queued[n].store(kInfinity);
+          Lanes lanes = dirty[n].exchange(0);
+          if (lanes == 0) {
+            // Relaxed by an earlier request
+            return;
+          }
+
+          // The lane arithmetic is on plain arrays so that it vectorizes;
+          // only the lanes that improved touch the atomics
+          Distance from[MultiSourceSsspPlan::kMaxBatchSize];
+          Distance to[MultiSourceSsspPlan::kMaxBatchSize];
+          std::atomic<Distance>* row = distances + n * num_sources + first;
+          for (uint32_t l = 0; l < count; ++l) {
+            from[l] = row[l].load(std::memory_order_relaxed);
+          }
+
+          for (auto e : graph->edges(n)) {
+            uint32_t dest = *graph->GetEdgeDest(e);
+            Distance weight = graph->template GetEdgeData<EdgeWeight>(e);
+            std::atomic<Distance>* dest_row =
+                distances + dest * num_sources + first;
+            for (uint32_t l = 0; l < count; ++l) {
+              to[l] = dest_row[l].load(std::memory_order_relaxed);
+            }
+            // Lanes that are not dirty may be infinite and overflow; they
+            // are masked out
+            Lanes improved = 0;
+            for (uint32_t l = 0; l < count; ++l) {
+              improved |= static_cast<Lanes>(from[l] + weight < to[l]) << l;
+            }
+            improved &= lanes;
+            if (improved == 0) {
+              continue;
+            }
+
+            Lanes changed = 0;
+            Distance key = kInfinity;
+            ForEachLane(improved, [&](uint32_t l) {
+              Distance d = from[l] + weight;
+              if (d < katana::atomicMin(dest_row[l], d)) {
+                changed |= Lanes{1} << l;
+                key = std::min(key, d);
+              }
+            });
+            if (changed == 0) {
+              continue;
+            }
+            // Mark the lanes before queueing, so that whoever relaxes the
+            // node sees them
+            dirty[dest].fetch_or(changed);
+            if (key < LowerKey(queued[dest], key)) {
+              ctx.push(Request{dest, key});
+            }
+          }
+        },
+        katana::wl<OBIM>(RequestIndexer{shift}),
+        katana::disable_conflict_detection(),
+        katana::loopname("MultiSourceSssp"));
+  }
+};
+
+template <typename Weight>
+katana::Result<void>
+MultiSourceSsspWithWeights(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MultiSourceSsspPlan plan) {
+  using Impl = MultiSourceSsspImpl<Weight>;
+  using Distance = typename Impl::Distance;
+  using ArrowType = typename arrow::CTypeTraits<Distance>::ArrowType;
+
+  auto graph_res = Impl::Graph::Make(pg, {}, {edge_weight_property_name});
+  if (!graph_res) {
+    return graph_res.error();
+  }
+
+  uint64_t num_nodes = pg->num_nodes();
+  uint64_t num_sources = sources.size();
+  auto buffer_res =
+      arrow::AllocateBuffer(num_nodes * num_sources * sizeof(Distance));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating distances: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  static_assert(sizeof(std::atomic<Distance>) == sizeof(Distance));
+  auto* distances =
+      reinterpret_cast<std::atomic<Distance>*>(buffer->mutable_data());
+
+  {
+    Impl impl(&graph_res.value(), distances, num_sources);
+    for (uint64_t first = 0; first < num_sources; first += plan.batch_size()) {
+      if (auto r = katana::analytics::CheckCancelled(); !r) {
+        return r.error();
+      }
+      uint32_t count =
+          std::min<uint64_t>(plan.batch_size(), num_sources - first);
+      impl.RunBatch(sources, first, count, plan.delta());
+    }
+  }
+
+  auto values = std::make_shared<arrow::NumericArray<ArrowType>>(
+      num_nodes * num_sources, buffer);
+  auto lists = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(values->type(), num_sources), num_nodes, values);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, lists->type())}),
+      {lists}));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MultiSourceSsspPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.batch_size() == 0 ||
+      plan.batch_size() > MultiSourceSsspPlan::kMaxBatchSize) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "batch size must be in [1, {}], not {}",
+        MultiSourceSsspPlan::kMaxBatchSize, plan.batch_size());
+  }
+  if (sources.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "at least one source is required");
+  }
+  for (uint32_t source : sources) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "source {} is not a node", source);
+    }
+  }
+  // Fail before searching rather than after
+  if (pg->node_schema()->GetFieldIndex(output_property_name) >= 0) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt8Type::type_id:
+    return MultiSourceSsspWithWeights<uint8_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt16Type::type_id:
+    return MultiSourceSsspWithWeights<uint16_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt32Type::type_id:
+    return MultiSourceSsspWithWeights<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MultiSourceSsspWithWeights<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MultiSourceSsspWithWeights<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MultiSourceSsspWithWeights<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MultiSourceSsspWithWeights<float>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MultiSourceSsspWithWeights<double>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "edge property {} has unsupported type {}",
+        edge_weight_property_name, weights->type()->ToString());
+  }
+}
@@ -19,6 +19,14 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "katana/ParaMeter.h"
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
 
@@ -26,22 +34,25 @@ using namespace katana::analytics;
 
 namespace {
 
-template <typename Weight>
+template <typename Distance>
 struct SsspNodeDistance {
-  using ArrowType = typename arrow::CTypeTraits<Weight>::ArrowType;
-  using ViewType = katana::PODPropertyView<std::atomic<Weight>>;
+  using ArrowType = typename arrow::CTypeTraits<Distance>::ArrowType;
+  using ViewType = katana::PODPropertyView<std::atomic<Distance>>;
 };
 
 template <typename Weight>
 using SsspEdgeWeight = katana::PODProperty<Weight>;
 
-template <typename Weight>
+/// The kernels are instantiated for each pair of edge weight and distance
+/// type, so the weights are read at their stored width and widened to the
+/// distance type in registers.
+template <typename Weight, typename Distance = Weight>
 struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
                                 katana::TypedPropertyGraph<
-                                    std::tuple<SsspNodeDistance<Weight>>,
+                                    std::tuple<SsspNodeDistance<Distance>>,
                                     std::tuple<SsspEdgeWeight<Weight>>>,
-                                Weight, true> {
-  using NodeDistance = SsspNodeDistance<Weight>;
+                                Distance, true> {
+  using NodeDistance = SsspNodeDistance<Distance>;
   using EdgeWeight = SsspEdgeWeight<Weight>;
 
   using NodeData = typename std::tuple<NodeDistance>;
@@ -49,7 +60,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
 
   using Base =
-      katana::analytics::BfsSsspImplementationBase<Graph, Weight, true>;
+      katana::analytics::BfsSsspImplementationBase<Graph, Distance, true>;
 
   using Dist = typename Base::Dist;
   using UpdateRequest = typename Base::UpdateRequest;
@@ -58,8 +69,30 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using SrcEdgeTileMaker = typename Base::SrcEdgeTileMaker;
   using SrcEdgeTilePushWrap = typename Base::SrcEdgeTilePushWrap;
   using ReqPushWrap = typename Base::ReqPushWrap;
-  using OutEdgeRangeFn = typename Base::OutEdgeRangeFn;
-  using TileRangeFn = typename Base::TileRangeFn;
+
+  /// Edge ranges of nodes, requests and tiles that prefetch the distances
+  /// of their destinations
+  struct PrefetchingEdgeRangeFn {
+    Graph* graph;
+
+    auto operator()(const typename Graph::Node& n) const {
+      return Prefetch(graph->edges(n));
+    }
+
+    auto operator()(const UpdateRequest& req) const {
+      return Prefetch(graph->edges(req.src));
+    }
+
+    auto operator()(const SrcEdgeTile& tile) const {
+      return Prefetch(katana::MakeStandardRange(tile.beg, tile.end));
+    }
+
+    template <typename Range>
+    auto Prefetch(Range range) const {
+      return katana::PrefetchEdges(
+          std::move(range), katana::PrefetchDestinations<NodeDistance>(graph));
+    }
+  };
 
   static constexpr bool kTrackWork = Base::kTrackWork;
   static constexpr unsigned kChunkSize = 64;
@@ -125,6 +158,139 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  /// Initial bucket width for DeltaStepAdaptiveAlgo, as a power of 2. With
+  /// weights spread up to about twice their mean, buckets of width
+  /// mean_weight / avg_degree hold about one light edge per node
+  /// (Meyer and Sanders, 2003).
+  static unsigned EstimateDeltaShift(const Graph& graph) {
+    constexpr uint64_t kMaxSampledEdges = 1U << 16U;
+
+    const uint64_t num_edges = graph.num_edges();
+    if (num_edges == 0 || graph.num_nodes() == 0) {
+      return 0;
+    }
+    const uint64_t stride = std::max<uint64_t>(1, num_edges / kMaxSampledEdges);
+
+    katana::GAccumulator<double> weight_sum;
+    katana::GAccumulator<uint64_t> sampled;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, (num_edges + stride - 1) / stride),
+        [&](uint64_t i) {
+          typename Graph::edge_iterator e(i * stride);
+          weight_sum += static_cast<double>(
+              graph.template GetEdgeData<EdgeWeight>(e));
+          sampled += 1;
+        },
+        katana::no_stats());
+
+    double mean_weight = weight_sum.reduce() / sampled.reduce();
+    double avg_degree = static_cast<double>(num_edges) / graph.num_nodes();
+    double delta = 2 * mean_weight / std::max(avg_degree, 1.0);
+    if (!(delta > 1)) {
+      return 0;
+    }
+    return static_cast<unsigned>(std::log2(delta));
+  }
+
+  /// Delta stepping on katana::AdaptiveOrderedByIntegerMetric, which starts
+  /// from the bucket width estimated by EstimateDeltaShift and merges or
+  /// splits buckets as it runs whenever they turn out to hold too little or
+  /// too much work to keep the threads busy.
+  ///
+  /// Changing the width only reorders work. Items already in the worklist keep
+  /// their bucket, and since the worklist always moves to lower buckets as
+  /// soon as something is pushed there, every item is still processed and
+  /// distances are still exact.
+  template <typename T, typename P, typename R>
+  static void DeltaStepAdaptiveAlgo(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange) {
+    using WL = katana::AdaptiveOrderedByIntegerMetric<
+        UpdateRequestIndexer, PSchunk>;
+
+    unsigned initial_shift = EstimateDeltaShift(*graph);
+
+    graph->template GetData<NodeDistance>(source) = 0;
+
+    katana::InsertBag<T> init_bag;
+    pushWrap(init_bag, source, 0, "parallel");
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const T& item, auto& ctx) {
+          const auto& sdata = graph->template GetData<NodeDistance>(item.src);
+          if (sdata < item.dist) {
+            return;
+          }
+
+          for (auto ii : edgeRange(item)) {
+            auto dest = graph->GetEdgeDest(ii);
+            auto& ddist = graph->template GetData<NodeDistance>(dest);
+            Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
+            const Dist new_dist = sdata + ew;
+            Dist old_dist = katana::atomicMin(ddist, new_dist);
+            if (new_dist < old_dist) {
+              pushWrap(ctx, *dest, new_dist);
+            }
+          }
+        },
+        katana::wl<WL>(UpdateRequestIndexer{0}, initial_shift, "SSSP-Adaptive"),
+        katana::disable_conflict_detection(), katana::loopname("SSSP"));
+  }
+
+  /// Parallel Dijkstra on a MultiQueue: items leave the worklist in nearly
+  /// increasing distance order, and an item whose node has since found a
+  /// shorter distance is skipped, so distances are still exact.
+  template <typename T, typename P, typename R>
+  static void MultiQueueAlgo(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange) {
+    using WL = katana::MultiQueue<std::less<>>;
+
+    katana::GAccumulator<size_t> BadWork;
+    katana::GAccumulator<size_t> WLEmptyWork;
+
+    graph->template GetData<NodeDistance>(source) = 0;
+
+    katana::InsertBag<T> init_bag;
+    pushWrap(init_bag, source, 0, "parallel");
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const T& item, auto& ctx) {
+          const auto& sdata = graph->template GetData<NodeDistance>(item.src);
+
+          if (sdata < item.dist) {
+            if (kTrackWork) {
+              WLEmptyWork += 1;
+            }
+            return;
+          }
+
+          for (auto ii : edgeRange(item)) {
+            auto dest = graph->GetEdgeDest(ii);
+            auto& ddist = graph->template GetData<NodeDistance>(dest);
+            Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
+            const Dist new_dist = sdata + ew;
+            Dist old_dist = katana::atomicMin(ddist, new_dist);
+            if (new_dist < old_dist) {
+              if (kTrackWork && old_dist != kDistanceInfinity) {
+                BadWork += 1;
+              }
+              pushWrap(ctx, *dest, new_dist);
+            }
+          }
+        },
+        katana::wl<WL>(), katana::disable_conflict_detection(),
+        katana::loopname("SSSP"));
+
+    if (kTrackWork) {
+      katana::ReportStatSingle("SSSP-MultiQueue", "BadWork", BadWork.reduce());
+      katana::ReportStatSingle(
+          "SSSP-MultiQueue", "WLEmptyWork", WLEmptyWork.reduce());
+    }
+  }
+
   template <typename T, typename P, typename R>
   static void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
@@ -153,7 +319,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           auto dest = graph->GetEdgeDest(e);
           auto& ddata = graph->template GetData<NodeDistance>(dest);
 
-          const auto new_dist =
+          const Dist new_dist =
               item.dist + graph->template GetEdgeData<EdgeWeight>(e);
 
           if (new_dist < ddata) {
@@ -199,7 +365,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
         auto dest = graph->GetEdgeDest(e);
         auto& ddata = graph->template GetData<NodeDistance>(dest);
 
-        const auto new_dist =
+        const Dist new_dist =
             item.dist + graph->template GetEdgeData<EdgeWeight>(e);
 
         if (new_dist < ddata) {
@@ -239,8 +405,10 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
               old_dist[n] = sdata;
               changed.update(true);
 
-              for (auto e : graph->edges(n)) {
-                const Weight new_dist =
+              for (auto e : katana::PrefetchEdges(
+                       graph->edges(n),
+                       katana::PrefetchDestinations<NodeDistance>(graph))) {
+                const Dist new_dist =
                     sdata + graph->template GetEdgeData<EdgeWeight>(e);
                 auto dest = graph->GetEdgeDest(e);
                 auto& ddata = graph->template GetData<NodeDistance>(dest);
@@ -250,7 +418,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           },
           katana::steal(), katana::loopname("Update"));
 
-    } while (changed.reduce());
+    } while (changed.reduce() && !katana::CancelRequested());
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
@@ -285,7 +453,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
               changed.update(true);
 
               for (auto e = t.beg; e != t.end; ++e) {
-                const Weight new_dist =
+                const Dist new_dist =
                     sdata + graph->template GetEdgeData<EdgeWeight>(e);
                 auto dest = graph->GetEdgeDest(e);
                 auto& ddata = graph->template GetData<NodeDistance>(dest);
@@ -295,64 +463,51 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           },
           katana::steal(), katana::loopname("Update"));
 
-    } while (changed.reduce());
+    } while (changed.reduce() && !katana::CancelRequested());
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
-public:
-  katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
-    if (start_node >= graph.size()) {
-      return katana::ErrorCode::InvalidArgument;
-    }
-
-    auto it = graph.begin();
-    std::advance(it, start_node);
-    typename Graph::Node source = *it;
-
-    size_t approxNodeData = graph.size() * 64;
-    katana::Prealloc(1, approxNodeData);
-
-    katana::do_all(
-        katana::iterate(graph), [&graph](const typename Graph::Node& n) {
-          graph.template GetData<NodeDistance>(n) = kDistanceInfinity;
-        });
-
-    graph.template GetData<NodeDistance>(source) = 0;
-
-    katana::StatTimer execTime("SSSP");
-    execTime.start();
-
-    if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
-    }
+  /// Whether the kernel of plan pushes every node it writes, so that the
+  /// nodes can be logged for a sparse reset
+  static bool PushesWrittenNodes(const SsspPlan& plan) {
+    return plan.algorithm() != SsspPlan::kTopological &&
+           plan.algorithm() != SsspPlan::kTopologicalTile;
+  }
 
+  template <typename Wrap>
+  katana::Result<void> RunAlgo(
+      Graph& graph, typename Graph::Node source, const SsspPlan& plan,
+      const Wrap& wrap) {
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          &graph, source, wrap(SrcEdgeTilePushWrap{&graph, *this}),
+          PrefetchingEdgeRangeFn{&graph}, plan.delta());
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph},
+          plan.delta());
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          &graph, source, wrap(SrcEdgeTilePushWrap{&graph, *this}),
+          PrefetchingEdgeRangeFn{&graph}, plan.delta());
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph},
+          plan.delta());
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn());
+          &graph, source, wrap(SrcEdgeTilePushWrap{&graph, *this}),
+          PrefetchingEdgeRangeFn{&graph});
       break;
     case SsspPlan::kDijkstra:
       DijkstraAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph});
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph});
       break;
     case SsspPlan::kTopological:
       TopoAlgo(&graph, source);
@@ -362,43 +517,116 @@ public:
       break;
     case SsspPlan::kDeltaStepBarrier:
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph},
+          plan.delta());
+      break;
+    case SsspPlan::kDeltaStepAdaptive:
+      DeltaStepAdaptiveAlgo<UpdateRequest>(
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph});
+      break;
+    case SsspPlan::kMultiQueue:
+      MultiQueueAlgo<UpdateRequest>(
+          &graph, source, wrap(ReqPushWrap()), PrefetchingEdgeRangeFn{&graph});
       break;
     default:
       return katana::ErrorCode::InvalidArgument;
     }
+    return katana::ResultSuccess();
+  }
+
+public:
+  /// Compute distances from start_node into graph. If initialized, the
+  /// distances are already kDistanceInfinity. If touched is not null, the
+  /// nodes written are logged in it; plan must then push every node it
+  /// writes (see PushesWrittenNodes).
+  katana::Result<void> SSSP(
+      Graph& graph, size_t start_node, SsspPlan plan, bool initialized = false,
+      katana::InsertBag<uint32_t>* touched = nullptr) {
+    if (start_node >= graph.size()) {
+      return katana::ErrorCode::InvalidArgument;
+    }
+
+    auto it = graph.begin();
+    std::advance(it, start_node);
+    typename Graph::Node source = *it;
+
+    size_t approxNodeData = graph.size() * 64;
+    katana::Prealloc(1, approxNodeData);
+
+    if (!initialized) {
+      katana::do_all(
+          katana::iterate(graph), [&graph](const typename Graph::Node& n) {
+            graph.template GetData<NodeDistance>(n) = kDistanceInfinity;
+          });
+    }
+
+    graph.template GetData<NodeDistance>(source) = 0;
+
+    katana::StatTimer execTime("SSSP");
+    execTime.start();
+
+    if (plan.algorithm() == SsspPlan::kAutomatic) {
+      plan = SsspPlan(&graph.GetPropertyGraph());
+    }
+
+    katana::Result<void> res = katana::ResultSuccess();
+    if (touched) {
+      KATANA_LOG_DEBUG_ASSERT(PushesWrittenNodes(plan));
+      res = RunAlgo(graph, source, plan, [touched](auto push) {
+        return typename Base::template TouchLoggingPushWrap<decltype(push)>{
+            push, touched};
+      });
+    } else {
+      res = RunAlgo(graph, source, plan, [](auto push) { return push; });
+    }
+    if (!res) {
+      return res.error();
+    }
 
     execTime.stop();
 
-    return katana::ResultSuccess();
+    return CheckCancelled();
   }
 };
 
-template <typename Weight>
+template <typename Weight, typename Distance>
 katana::Result<void>
 Sssp(
     katana::TypedPropertyGraph<
-        std::tuple<SsspNodeDistance<Weight>>,
+        std::tuple<SsspNodeDistance<Distance>>,
         std::tuple<SsspEdgeWeight<Weight>>>& pg,
-    size_t start_node, SsspPlan plan) {
+    size_t start_node, SsspPlan plan, bool initialized,
+    katana::InsertBag<uint32_t>* touched) {
   static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
-  SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
-  return impl.SSSP(pg, start_node, plan);
+  SsspImplementation<Weight, Distance> impl{{plan.edge_tile_size()}};
+  return impl.SSSP(pg, start_node, plan, initialized, touched);
 }
 
-template <typename Weight>
+template <typename Weight, typename Distance = Weight>
 static katana::Result<void>
 SSSPWithWrap(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
-  if (auto r = ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
-          pg, {output_property_name});
-      !r) {
+    const std::string& output_property_name, SsspPlan plan,
+    AnalyticsWorkspace* workspace) {
+  using Impl = SsspImplementation<Weight, Distance>;
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (workspace) {
+    if (auto r = workspace->AddNodeProperty<Distance>(
+            output_property_name, Impl::kDistanceInfinity);
+        !r) {
+      return r.error();
+    }
+  } else if (auto r = ConstructNodeProperties<
+                 std::tuple<SsspNodeDistance<Distance>>>(
+                 pg, {output_property_name});
+             !r) {
     return r.error();
   }
   auto graph = katana::TypedPropertyGraph<
-      std::tuple<SsspNodeDistance<Weight>>,
+      std::tuple<SsspNodeDistance<Distance>>,
       std::tuple<SsspEdgeWeight<Weight>>>::
       Make(pg, {output_property_name}, {edge_weight_property_name});
   if (!graph && graph.error() == katana::ErrorCode::TypeError) {
@@ -413,49 +641,326 @@ SSSPWithWrap(
     return graph.error();
   }
 
-  return Sssp(graph.value(), start_node, plan);
+  katana::InsertBag<uint32_t>* touched = nullptr;
+  if (workspace) {
+    if (plan.algorithm() == SsspPlan::kAutomatic) {
+      plan = SsspPlan(pg);
+    }
+    if (Impl::PushesWrittenNodes(plan)) {
+      touched = workspace->TouchedNodes(output_property_name);
+    }
+  }
+  return Sssp<Weight, Distance>(
+      graph.value(), start_node, plan, workspace != nullptr, touched);
+}
+
+/// Whether every shortest path length in pg fits below the distance infinity
+/// of Distance. A shortest path uses each edge at most once and has at most
+/// num_nodes - 1 edges, so its length is at most the smaller of the sum of
+/// all weights and num_nodes - 1 times the largest weight.
+template <typename Weight, typename Distance>
+static katana::Result<bool>
+DistancesFit(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  static_assert(std::is_unsigned_v<Weight> && std::is_unsigned_v<Distance>);
+  auto graph = katana::TypedPropertyGraph<
+      std::tuple<>, std::tuple<SsspEdgeWeight<Weight>>>::
+      Make(pg, {}, {edge_weight_property_name});
+  if (!graph) {
+    return graph.error();
+  }
+
+  katana::GReduceMax<Weight> max_weight;
+  katana::GAccumulator<uint64_t> sum_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t i) {
+        Weight w = graph.value().template GetEdgeData<SsspEdgeWeight<Weight>>(
+            katana::GraphTopology::edge_iterator(i));
+        max_weight.update(w);
+        sum_weight += w;
+      },
+      katana::no_stats(), katana::loopname("SsspDistancesFit"));
+
+  uint64_t max_edges = pg->num_nodes() > 0 ? pg->num_nodes() - 1 : 0;
+  uint64_t longest = std::min<uint64_t>(
+      sum_weight.reduce(), max_edges * max_weight.reduce());
+  return longest <
+         static_cast<uint64_t>(
+             SsspImplementation<Weight, Distance>::kDistanceInfinity);
+}
+
+/// 8- and 16-bit weights keep 32-bit distances whenever no path can
+/// overflow them, and otherwise fall back to 64-bit distances.
+template <typename Weight>
+static katana::Result<void>
+SSSPWithNarrowWeights(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan,
+    AnalyticsWorkspace* workspace) {
+  auto fits = DistancesFit<Weight, uint32_t>(pg, edge_weight_property_name);
+  if (!fits) {
+    return fits.error();
+  }
+  if (fits.value()) {
+    return SSSPWithWrap<Weight, uint32_t>(
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
+  }
+  return SSSPWithWrap<Weight, uint64_t>(
+      pg, start_node, edge_weight_property_name, output_property_name, plan,
+      workspace);
+}
+
+template <typename Weight, typename Quantized>
+static katana::Result<double>
+QuantizeEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  using QuantizedWeight = katana::PODProperty<Quantized>;
+  constexpr Quantized kMaxQuantized = std::numeric_limits<Quantized>::max();
+
+  auto input = katana::TypedPropertyGraph<
+      std::tuple<>, std::tuple<SsspEdgeWeight<Weight>>>::
+      Make(pg, {}, {edge_weight_property_name});
+  if (!input) {
+    return input.error();
+  }
+
+  katana::GReduceMax<Weight> max_weight;
+  katana::GAccumulator<uint64_t> negative;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t i) {
+        Weight w = input.value().template GetEdgeData<SsspEdgeWeight<Weight>>(
+            katana::GraphTopology::edge_iterator(i));
+        max_weight.update(w);
+        if constexpr (std::is_signed_v<Weight>) {
+          if (w < 0) {
+            negative += 1;
+          }
+        }
+      },
+      katana::no_stats(), katana::loopname("SsspQuantizeRange"));
+  if (negative.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edges of {} have negative weights", negative.reduce(),
+        edge_weight_property_name);
+  }
+
+  // Integer weights that already fit are copied as they are
+  double max = 0;
+  if (pg->num_edges() > 0) {
+    max = static_cast<double>(max_weight.reduce());
+  }
+  double scale = 1;
+  if (!std::is_integral_v<Weight> || max > kMaxQuantized) {
+    scale = max > 0 ? max / kMaxQuantized : 1;
+  }
+
+  if (auto r = katana::analytics::ConstructEdgeProperties<
+          std::tuple<QuantizedWeight>>(pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto graph = katana::TypedPropertyGraph<
+      std::tuple<>, std::tuple<SsspEdgeWeight<Weight>, QuantizedWeight>>::
+      Make(pg, {}, {edge_weight_property_name, output_property_name});
+  if (!graph) {
+    return graph.error();
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t i) {
+        katana::GraphTopology::edge_iterator e(i);
+        double w = static_cast<double>(
+            graph.value().template GetEdgeData<SsspEdgeWeight<Weight>>(e));
+        Quantized q = 0;
+        // Positive weights stay positive so that no edge becomes free
+        if (w > 0) {
+          q = static_cast<Quantized>(std::clamp<double>(
+              std::round(w / scale), 1, kMaxQuantized));
+        }
+        graph.value().template GetEdgeData<QuantizedWeight>(e) = q;
+      },
+      katana::no_stats(), katana::loopname("SsspQuantize"));
+
+  return scale;
+}
+
+template <typename Quantized>
+static katana::Result<double>
+QuantizeEdgeWeightsTo(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt8Type::type_id:
+    return QuantizeEdgeWeights<uint8_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt16Type::type_id:
+    return QuantizeEdgeWeights<uint16_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt32Type::type_id:
+    return QuantizeEdgeWeights<uint32_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return QuantizeEdgeWeights<int32_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return QuantizeEdgeWeights<uint64_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return QuantizeEdgeWeights<int64_t, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return QuantizeEdgeWeights<float, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return QuantizeEdgeWeights<double, Quantized>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
 }
 
 }  // namespace
 
+namespace {
+
 katana::Result<void>
-katana::analytics::Sssp(
-    PropertyGraph* pg, size_t start_node,
+SsspDispatch(
+    katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
+    const std::string& output_property_name, SsspPlan plan,
+    AnalyticsWorkspace* workspace) {
+  katana::parameter::ProfileScope profile(plan.profile_parallelism());
   switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt8Type::type_id:
+    return SSSPWithNarrowWeights<uint8_t>(
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
+  case arrow::UInt16Type::type_id:
+    return SSSPWithNarrowWeights<uint16_t>(
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::UInt32Type::type_id:
     return SSSPWithWrap<uint32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::Int32Type::type_id:
     return SSSPWithWrap<int32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::UInt64Type::type_id:
     return SSSPWithWrap<uint64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::Int64Type::type_id:
     return SSSPWithWrap<int64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::FloatType::type_id:
     return SSSPWithWrap<float>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   case arrow::DoubleType::type_id:
     return SSSPWithWrap<double>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
+        pg, start_node, edge_weight_property_name, output_property_name, plan,
+        workspace);
   default:
     return katana::ErrorCode::TypeError;
   }
 }
 
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Sssp(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  return SsspDispatch(
+      pg, start_node, edge_weight_property_name, output_property_name, plan,
+      nullptr);
+}
+
+katana::Result<void>
+katana::analytics::Sssp(
+    PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, AnalyticsWorkspace* workspace,
+    SsspPlan plan) {
+  if (workspace->graph() != pg) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the workspace belongs to another graph");
+  }
+  return SsspDispatch(
+      pg, start_node, edge_weight_property_name, output_property_name, plan,
+      workspace);
+}
+
+katana::Result<double>
+katana::analytics::SsspQuantizeEdgeWeights(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, uint32_t bits) {
+  switch (bits) {
+  case 8:
+    return QuantizeEdgeWeightsTo<uint8_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case 16:
+    return QuantizeEdgeWeightsTo<uint16_t>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "quantized weights must have 8 or 16 bits, not {}", bits);
+  }
+}
+
+katana::Result<katana::analytics::SsspPlan>
+katana::analytics::TuneSsspPlan(
+    const PropertyGraph& pg, const std::string& edge_weight_property_name,
+    const TunerOptions& opts) {
+  // Deltas are exponents, so these cover bucket widths from 16 to 64K
+  std::vector<PlanCandidate<SsspPlan>> candidates{
+      {"DeltaStepAdaptive", SsspPlan::DeltaStepAdaptive()},
+      {"MultiQueue", SsspPlan::MultiQueue()},
+  };
+  for (unsigned delta : {4, 7, 10, 13, 16}) {
+    candidates.push_back(
+        {fmt::format("DeltaStep/{}", delta), SsspPlan::DeltaStep(delta)});
+    candidates.push_back(
+        {fmt::format("DeltaStepBarrier/{}", delta),
+         SsspPlan::DeltaStepBarrier(delta)});
+    for (ptrdiff_t tile_size : {128, 512}) {
+      candidates.push_back(
+          {fmt::format("DeltaTile/{}/{}", delta, tile_size),
+           SsspPlan::DeltaTile(delta, tile_size)});
+    }
+  }
+
+  return TunePlan(
+      fmt::format("Sssp/{}", edge_weight_property_name), pg, candidates,
+      [&](PropertyGraph* sample, const SsspPlan& plan) {
+        TemporaryPropertyGuard output(sample);
+        return Sssp(sample, 0, edge_weight_property_name, output.name(), plan);
+      },
+      {edge_weight_property_name}, opts);
+}
+
 namespace {
 
-template <typename Weight>
+template <typename Weight, typename Distance = Weight>
 static katana::Result<void>
 SsspValidateImpl(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name) {
-  using Impl = SsspImplementation<Weight>;
+  using Impl = SsspImplementation<Weight, Distance>;
   auto pg_result = Impl::Graph::Make(
       pg, {output_property_name}, {edge_weight_property_name});
   if (!pg_result) {
@@ -464,15 +969,16 @@ SsspValidateImpl(
 
   typename Impl::Graph graph = pg_result.value();
 
-  if (graph.template GetData<SsspNodeDistance<Weight>>(start_node) != 0) {
+  if (graph.template GetData<SsspNodeDistance<Distance>>(start_node) != 0) {
     return katana::ErrorCode::AssertionFailed;
   }
 
   std::atomic<bool> not_consistent(false);
   do_all(
-      iterate(graph), typename Impl::template NotConsistent<
-                          SsspNodeDistance<Weight>, typename Impl::EdgeWeight>(
-                          &graph, not_consistent));
+      iterate(graph),
+      typename Impl::template NotConsistent<
+          SsspNodeDistance<Distance>, typename Impl::EdgeWeight>(
+          &graph, not_consistent));
 
   if (not_consistent) {
     return katana::ErrorCode::AssertionFailed;
@@ -481,6 +987,24 @@ SsspValidateImpl(
   return katana::ResultSuccess();
 }
 
+template <typename Weight>
+static katana::Result<void>
+SsspValidateNarrowWeights(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  switch (pg->GetNodeProperty(output_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspValidateImpl<Weight, uint32_t>(
+        pg, start_node, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return SsspValidateImpl<Weight, uint64_t>(
+        pg, start_node, edge_weight_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -488,6 +1012,17 @@ katana::analytics::SsspAssertValid(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name) {
+  switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt8Type::type_id:
+    return SsspValidateNarrowWeights<uint8_t>(
+        pg, start_node, edge_weight_property_name, output_property_name);
+  case arrow::UInt16Type::type_id:
+    return SsspValidateNarrowWeights<uint16_t>(
+        pg, start_node, edge_weight_property_name, output_property_name);
+  default:
+    break;
+  }
+
   switch (pg->GetNodeProperty(output_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
     return SsspValidateImpl<uint32_t>(
@@ -514,12 +1049,12 @@ katana::analytics::SsspAssertValid(
 
 namespace {
 
-template <typename Weight>
+template <typename Distance>
 static katana::Result<SsspStatistics>
 ComputeStatistics(
     katana::PropertyGraph* pg, const std::string& output_property_name) {
   auto pg_result = katana::TypedPropertyGraph<
-      typename SsspImplementation<Weight>::NodeData,
+      typename SsspImplementation<Distance>::NodeData,
       std::tuple<>>::Make(pg, {output_property_name}, {});
   if (!pg_result) {
     return pg_result.error();
@@ -527,17 +1062,17 @@ ComputeStatistics(
 
   auto graph = pg_result.value();
 
-  katana::GReduceMax<Weight> max_dist;
-  katana::GAccumulator<Weight> sum_dist;
+  katana::GReduceMax<Distance> max_dist;
+  katana::GAccumulator<Distance> sum_dist;
   katana::GAccumulator<uint32_t> num_visited;
 
   do_all(
       katana::iterate(graph),
       [&](uint64_t i) {
-        Weight my_distance =
-            graph.template GetData<SsspNodeDistance<Weight>>(i);
+        Distance my_distance =
+            graph.template GetData<SsspNodeDistance<Distance>>(i);
 
-        if (my_distance < SsspImplementation<Weight>::kDistanceInfinity) {
+        if (my_distance < SsspImplementation<Distance>::kDistanceInfinity) {
           max_dist.update(my_distance);
           sum_dist += my_distance;
           num_visited += 1;
@@ -0,0 +1,544 @@
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Frontier.h"
+#include "katana/LargeArray.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using NodeComponent = katana::PODProperty<uint64_t>;
+using Graph =
+    katana::TypedPropertyGraph<std::tuple<NodeComponent>, std::tuple<>>;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint64_t kUnassigned = std::numeric_limits<uint64_t>::max();
+
+/// Once this few nodes remain they are finished with Tarjan's algorithm,
+/// which unlike coloring needs no more than one pass over them
+constexpr uint64_t kSerialThreshold = 1 << 16;
+
+uint64_t
+Load(const uint64_t* p) {
+  return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+void
+Store(uint64_t* p, uint64_t v) {
+  __atomic_store_n(p, v, __ATOMIC_RELAXED);
+}
+
+/// Find strongly connected components by repeatedly removing whole
+/// components from the set of remaining nodes. Since the remaining nodes
+/// always form a union of components, each phase can work on the subgraph
+/// they induce.
+class SccEngine {
+public:
+  SccEngine(
+      const katana::GraphTopology& out, const katana::GraphTopology& in,
+      uint64_t* component)
+      : out_(out), in_(in), component_(component) {}
+
+  void Run(const StronglyConnectedComponentsPlan& plan) {
+    katana::do_all(
+        katana::iterate(out_), [&](Node n) { component_[n] = kUnassigned; },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(out_), [&](Node n) { remaining_->push(n); },
+        katana::no_stats());
+    num_remaining_ = out_.num_nodes();
+
+    Trim(plan.trim_rounds());
+    if (plan.algorithm() == StronglyConnectedComponentsPlan::kMultistep &&
+        num_remaining_ > kSerialThreshold) {
+      ForwardBackward();
+      Trim(plan.trim_rounds());
+    }
+    if (num_remaining_ > kSerialThreshold) {
+      color_.allocateBlocked(out_.num_nodes());
+    }
+    while (num_remaining_ > kSerialThreshold) {
+      Color();
+      Trim(plan.trim_rounds());
+    }
+    Tarjan();
+  }
+
+private:
+  bool IsUnassigned(Node n) const {
+    return Load(&component_[n]) == kUnassigned;
+  }
+
+  /// Drop the nodes that have been assigned a component from remaining_
+  void Compact() {
+    auto next = std::make_unique<katana::InsertBag<Node>>();
+    katana::GAccumulator<uint64_t> count;
+    katana::do_all(
+        katana::iterate(*remaining_),
+        [&](Node n) {
+          if (IsUnassigned(n)) {
+            next->push(n);
+            count += 1;
+          }
+        },
+        katana::no_stats());
+    remaining_ = std::move(next);
+    num_remaining_ = count.reduce();
+  }
+
+  /// Remove nodes without remaining in-edges or out-edges, which cannot
+  /// share a component with any other node. Each round can expose more such
+  /// nodes, so stop after rounds rounds or once a round removes nothing.
+  void Trim(uint32_t rounds) {
+    auto has_remaining_neighbor = [&](const katana::GraphTopology& topology,
+                                      Node n) {
+      for (Edge e : topology.edges(n)) {
+        Node dest = topology.edge_dest(e);
+        if (dest != n && IsUnassigned(dest)) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    for (uint32_t r = 0; r < rounds && num_remaining_ > 0; ++r) {
+      katana::GAccumulator<uint64_t> trimmed;
+      // Nodes trimmed concurrently are components by themselves, so a
+      // node is only trimmed if it really is one too
+      katana::do_all(
+          katana::iterate(*remaining_),
+          [&](Node n) {
+            if (!has_remaining_neighbor(out_, n) ||
+                !has_remaining_neighbor(in_, n)) {
+              Store(&component_[n], n);
+              trimmed += 1;
+            }
+          },
+          katana::steal(), katana::loopname("SCC-Trim"));
+      if (trimmed.reduce() == 0) {
+        break;
+      }
+      Compact();
+    }
+  }
+
+  /// Assign the component of a pivot likely to be in the largest component:
+  /// the nodes both reachable from the pivot and reaching it
+  void ForwardBackward() {
+    // Pick the node with the largest product of in- and out-degree; the low
+    // bits break ties by node id
+    katana::GReduceMax<uint64_t> best;
+    katana::do_all(
+        katana::iterate(*remaining_),
+        [&](Node n) {
+          uint64_t out_degree = out_.edges(n).size();
+          uint64_t in_degree = in_.edges(n).size();
+          uint64_t score = std::min<uint64_t>(
+              out_degree * in_degree, std::numeric_limits<uint32_t>::max());
+          best.update((score << 32) | n);
+        },
+        katana::no_stats());
+    Node pivot = static_cast<Node>(best.reduce());
+
+    katana::DynamicBitset reached;
+    reached.resize(out_.num_nodes());
+    reached.set(pivot);
+    katana::Frontier forward(out_.num_nodes());
+    forward.Push(pivot);
+    katana::SynchronousFrontierLoop(
+        out_, &forward,
+        [&](Node, Edge e, katana::Frontier* next) {
+          Node dest = out_.edge_dest(e);
+          if (IsUnassigned(dest) && !reached.set(dest)) {
+            next->Push(dest);
+          }
+        },
+        katana::kDefaultFrontierEdgeTileSize, "SCC-Forward");
+
+    Store(&component_[pivot], pivot);
+    katana::Frontier backward(out_.num_nodes());
+    backward.Push(pivot);
+    katana::SynchronousFrontierLoop(
+        in_, &backward,
+        [&](Node, Edge e, katana::Frontier* next) {
+          Node dest = in_.edge_dest(e);
+          if (reached.test(dest) &&
+              __sync_bool_compare_and_swap(
+                  &component_[dest], kUnassigned, pivot)) {
+            next->Push(dest);
+          }
+        },
+        katana::kDefaultFrontierEdgeTileSize, "SCC-Backward");
+
+    Compact();
+  }
+
+  /// Propagate the largest node id forward until every node holds the
+  /// largest id that reaches it. A node that keeps its own id is the root
+  /// of a color, and the nodes of that color that reach it back form its
+  /// component.
+  void Color() {
+    katana::Frontier frontier(out_.num_nodes());
+    katana::do_all(
+        katana::iterate(*remaining_),
+        [&](Node n) {
+          color_[n] = n;
+          frontier.Push(n);
+        },
+        katana::no_stats());
+    katana::SynchronousFrontierLoop(
+        out_, &frontier,
+        [&](Node src, Edge e, katana::Frontier* next) {
+          Node dest = out_.edge_dest(e);
+          if (!IsUnassigned(dest)) {
+            return;
+          }
+          uint64_t color = Load(&color_[src]);
+          uint64_t old = Load(&color_[dest]);
+          while (old < color) {
+            if (__sync_bool_compare_and_swap(&color_[dest], old, color)) {
+              next->Push(dest);
+              break;
+            }
+            old = Load(&color_[dest]);
+          }
+        },
+        katana::kDefaultFrontierEdgeTileSize, "SCC-Color");
+
+    katana::Frontier roots(out_.num_nodes());
+    katana::do_all(
+        katana::iterate(*remaining_),
+        [&](Node n) {
+          if (color_[n] == n) {
+            Store(&component_[n], n);
+            roots.Push(n);
+          }
+        },
+        katana::no_stats());
+    katana::SynchronousFrontierLoop(
+        in_, &roots,
+        [&](Node src, Edge e, katana::Frontier* next) {
+          Node dest = in_.edge_dest(e);
+          uint64_t color = Load(&component_[src]);
+          if (color_[dest] == color &&
+              __sync_bool_compare_and_swap(
+                  &component_[dest], kUnassigned, color)) {
+            next->Push(dest);
+          }
+        },
+        katana::kDefaultFrontierEdgeTileSize, "SCC-ColorBackward");
+
+    Compact();
+  }
+
+  /// Tarjan's algorithm on the remaining nodes, with an explicit call stack
+  void Tarjan() {
+    constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+    std::vector<Node> nodes(remaining_->begin(), remaining_->end());
+    std::unordered_map<Node, uint32_t> local;
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+      local.emplace(nodes[i], i);
+    }
+
+    std::vector<uint32_t> index(nodes.size(), kUnvisited);
+    std::vector<uint32_t> low(nodes.size());
+    std::vector<bool> on_stack(nodes.size());
+    std::vector<uint32_t> stack;
+    struct Frame {
+      uint32_t v;
+      Edge next;
+      Edge end;
+    };
+    std::vector<Frame> calls;
+    uint32_t counter = 0;
+
+    auto visit = [&](uint32_t v) {
+      index[v] = low[v] = counter++;
+      stack.emplace_back(v);
+      on_stack[v] = true;
+      auto edges = out_.edges(nodes[v]);
+      calls.emplace_back(Frame{v, *edges.begin(), *edges.end()});
+    };
+
+    for (uint32_t s = 0; s < nodes.size(); ++s) {
+      if (index[s] != kUnvisited) {
+        continue;
+      }
+      visit(s);
+      while (!calls.empty()) {
+        Frame& frame = calls.back();
+        uint32_t v = frame.v;
+        if (frame.next < frame.end) {
+          Node dest = out_.edge_dest(frame.next++);
+          if (!IsUnassigned(dest)) {
+            continue;
+          }
+          uint32_t w = local.at(dest);
+          if (index[w] == kUnvisited) {
+            visit(w);
+          } else if (on_stack[w]) {
+            low[v] = std::min(low[v], index[w]);
+          }
+          continue;
+        }
+
+        calls.pop_back();
+        if (!calls.empty()) {
+          uint32_t parent = calls.back().v;
+          low[parent] = std::min(low[parent], low[v]);
+        }
+        if (low[v] == index[v]) {
+          uint32_t w;
+          do {
+            w = stack.back();
+            stack.pop_back();
+            on_stack[w] = false;
+            component_[nodes[w]] = nodes[v];
+          } while (w != v);
+        }
+      }
+    }
+
+    remaining_->clear();
+    num_remaining_ = 0;
+  }
+
+  const katana::GraphTopology& out_;
+  const katana::GraphTopology& in_;
+  uint64_t* component_;
+  katana::LargeArray<uint64_t> color_;
+  std::unique_ptr<katana::InsertBag<Node>> remaining_{
+      std::make_unique<katana::InsertBag<Node>>()};
+  uint64_t num_remaining_{0};
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+
+  katana::StatTimer transpose_time("SCC-Transpose");
+  transpose_time.start();
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  std::unique_ptr<PropertyGraph> transpose =
+      std::move(transpose_result.value());
+  transpose_time.stop();
+
+  if (auto r = ConstructNodeProperties<std::tuple<NodeComponent>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  uint64_t* component =
+      pg_result.value().GetNodePropertyView<NodeComponent>().data();
+
+  katana::StatTimer exec_time("StronglyConnectedComponents");
+  exec_time.start();
+  SccEngine engine(pg->topology(), transpose->topology(), component);
+  engine.Run(plan);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const uint64_t* component =
+      pg_result.value().GetNodePropertyView<NodeComponent>().data();
+  uint64_t num_nodes = pg->num_nodes();
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  const katana::GraphTopology& transpose =
+      transpose_result.value()->topology();
+
+  // Every label is a node that represents itself
+  std::vector<uint64_t> sizes(num_nodes);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    uint64_t label = component[n];
+    if (label >= num_nodes || component[label] != label) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} has label {} that is not a representative", n, label);
+    }
+    sizes[label] += 1;
+  }
+
+  // Each component is strongly connected: its representative reaches all of
+  // it and is reached from all of it
+  for (const katana::GraphTopology* t : {&topology, &transpose}) {
+    std::vector<bool> visited(num_nodes);
+    std::vector<Node> stack;
+    for (uint64_t rep = 0; rep < num_nodes; ++rep) {
+      if (component[rep] != rep) {
+        continue;
+      }
+      uint64_t count = 1;
+      visited[rep] = true;
+      stack.emplace_back(rep);
+      while (!stack.empty()) {
+        Node n = stack.back();
+        stack.pop_back();
+        for (Edge e : t->edges(n)) {
+          Node dest = t->edge_dest(e);
+          if (component[dest] == rep && !visited[dest]) {
+            visited[dest] = true;
+            count += 1;
+            stack.emplace_back(dest);
+          }
+        }
+      }
+      if (count != sizes[rep]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "component {} of {} nodes is not strongly connected", rep,
+            sizes[rep]);
+      }
+    }
+  }
+
+  // The graph of components is acyclic, so no components should be merged
+  std::vector<uint64_t> in_degree(num_nodes);
+  std::vector<std::vector<Node>> members(num_nodes);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    members[component[n]].emplace_back(n);
+    for (Edge e : topology.edges(n)) {
+      uint64_t dest_label = component[topology.edge_dest(e)];
+      if (dest_label != component[n]) {
+        in_degree[dest_label] += 1;
+      }
+    }
+  }
+  std::vector<uint64_t> ready;
+  uint64_t num_components = 0;
+  for (uint64_t rep = 0; rep < num_nodes; ++rep) {
+    if (component[rep] == rep) {
+      num_components += 1;
+      if (in_degree[rep] == 0) {
+        ready.emplace_back(rep);
+      }
+    }
+  }
+  uint64_t num_sorted = 0;
+  while (!ready.empty()) {
+    uint64_t rep = ready.back();
+    ready.pop_back();
+    num_sorted += 1;
+    for (Node n : members[rep]) {
+      for (Edge e : topology.edges(n)) {
+        uint64_t dest_label = component[topology.edge_dest(e)];
+        if (dest_label != rep && --in_degree[dest_label] == 0) {
+          ready.emplace_back(dest_label);
+        }
+      }
+    }
+  }
+  if (num_sorted != num_components) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} components are on cycles of components",
+        num_components - num_sorted);
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const uint64_t* component =
+      pg_result.value().GetNodePropertyView<NodeComponent>().data();
+  uint64_t num_nodes = pg->num_nodes();
+
+  katana::LargeArray<uint64_t> sizes;
+  sizes.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { sizes[n] = 0; }, katana::no_stats());
+
+  katana::GAccumulator<uint64_t> invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (component[n] >= num_nodes) {
+          invalid += 1;
+          return;
+        }
+        __atomic_fetch_add(&sizes[component[n]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  if (invalid.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} nodes have invalid labels",
+        invalid.reduce());
+  }
+
+  katana::GAccumulator<uint64_t> total_components;
+  katana::GAccumulator<uint64_t> non_trivial_components;
+  katana::GReduceMax<uint64_t> largest_component_size;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (sizes[n] > 0) {
+          total_components += 1;
+          largest_component_size.update(sizes[n]);
+        }
+        if (sizes[n] > 1) {
+          non_trivial_components += 1;
+        }
+      },
+      katana::loopname("SCC Statistics"), katana::no_stats());
+
+  uint64_t largest = num_nodes > 0 ? largest_component_size.reduce() : 0;
+  double ratio = num_nodes > 0 ? double(largest) / num_nodes : 0;
+  return StronglyConnectedComponentsStatistics{
+      total_components.reduce(), non_trivial_components.reduce(), largest,
+      ratio};
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = " << largest_component_size
+     << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
@@ -0,0 +1,670 @@
+#include "katana/analytics/subgraph_matching/subgraph_matching.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#include <arrow/compute/api.h>
+
+#include "katana/Galois.h"
+#include "katana/PropertyViews.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/Intersection.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using NodeRange = std::pair<const Node*, const Node*>;
+
+constexpr uint32_t kMaxNodes = Pattern::kMaxNodes;
+constexpr int64_t kNoType = -1;
+constexpr unsigned kChunkSize = 16;
+
+/// A pattern in the form the matcher uses: types[a][b] holds the sorted
+/// types of the edges between a and b, with kNoType for an untyped edge
+struct PatternInfo {
+  uint32_t num_nodes;
+  std::array<std::array<std::vector<int64_t>, kMaxNodes>, kMaxNodes> types;
+  std::array<std::optional<int64_t>, kMaxNodes> labels;
+  bool typed{false};
+  bool labeled{false};
+
+  uint32_t degree(uint32_t a) const {
+    uint32_t d = 0;
+    for (uint32_t b = 0; b < num_nodes; ++b) {
+      d += types[a][b].size();
+    }
+    return d;
+  }
+};
+
+katana::Result<PatternInfo>
+MakePatternInfo(const Pattern& pattern) {
+  PatternInfo info;
+  info.num_nodes = pattern.num_nodes;
+  if (pattern.num_nodes == 0 || pattern.num_nodes > kMaxNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "patterns must have between 1 and {} nodes, not {}", kMaxNodes,
+        pattern.num_nodes);
+  }
+
+  bool untyped = false;
+  for (const Pattern::Edge& edge : pattern.edges) {
+    if (edge.a >= pattern.num_nodes || edge.b >= pattern.num_nodes ||
+        edge.a == edge.b) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern edge ({}, {}) is not between two of its {} nodes", edge.a,
+          edge.b, pattern.num_nodes);
+    }
+    int64_t type = edge.type ? int64_t{*edge.type} : kNoType;
+    info.types[edge.a][edge.b].emplace_back(type);
+    info.types[edge.b][edge.a].emplace_back(type);
+    info.typed |= edge.type.has_value();
+    untyped |= !edge.type;
+  }
+  if (info.typed && untyped) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "either all or none of the pattern edges must have types");
+  }
+  for (auto& row : info.types) {
+    for (auto& types : row) {
+      std::sort(types.begin(), types.end());
+      types.erase(std::unique(types.begin(), types.end()), types.end());
+    }
+  }
+
+  if (!pattern.node_labels.empty()) {
+    if (pattern.node_labels.size() != pattern.num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern has {} node labels but {} nodes", pattern.node_labels.size(),
+          pattern.num_nodes);
+    }
+    for (uint32_t a = 0; a < pattern.num_nodes; ++a) {
+      info.labels[a] = pattern.node_labels[a];
+      info.labeled |= pattern.node_labels[a].has_value();
+    }
+  }
+  if (info.labeled && pattern.node_label_property.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "pattern has node labels but no node label property");
+  }
+
+  // Check that the pattern is connected
+  std::array<bool, kMaxNodes> reached{};
+  std::vector<uint32_t> stack{0};
+  reached[0] = true;
+  uint32_t num_reached = 1;
+  while (!stack.empty()) {
+    uint32_t a = stack.back();
+    stack.pop_back();
+    for (uint32_t b = 0; b < info.num_nodes; ++b) {
+      if (!reached[b] && !info.types[a][b].empty()) {
+        reached[b] = true;
+        ++num_reached;
+        stack.emplace_back(b);
+      }
+    }
+  }
+  if (num_reached != info.num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "pattern is not connected");
+  }
+  return info;
+}
+
+using Permutation = std::array<uint32_t, kMaxNodes>;
+
+/// Add the automorphisms of info that agree with perm on [0, a) to out
+void
+SearchAutomorphisms(
+    const PatternInfo& info, uint32_t a, Permutation* perm,
+    std::array<bool, kMaxNodes>* used, std::vector<Permutation>* out) {
+  if (a == info.num_nodes) {
+    out->emplace_back(*perm);
+    return;
+  }
+  for (uint32_t b = 0; b < info.num_nodes; ++b) {
+    if ((*used)[b] || info.labels[a] != info.labels[b]) {
+      continue;
+    }
+    bool preserves_edges = true;
+    for (uint32_t c = 0; c < a && preserves_edges; ++c) {
+      preserves_edges = info.types[a][c] == info.types[b][(*perm)[c]];
+    }
+    if (!preserves_edges) {
+      continue;
+    }
+    (*perm)[a] = b;
+    (*used)[b] = true;
+    SearchAutomorphisms(info, a + 1, perm, used, out);
+    (*used)[b] = false;
+  }
+}
+
+/// Pairs (a, b) such that requiring the match of a to be less than that of
+/// b for all pairs leaves exactly one of the matches that differ by an
+/// automorphism of the pattern (Grochow and Kellis)
+std::vector<std::pair<uint32_t, uint32_t>>
+SymmetryBreakingConditions(const PatternInfo& info) {
+  std::vector<Permutation> automorphisms;
+  Permutation perm{};
+  std::array<bool, kMaxNodes> used{};
+  SearchAutomorphisms(info, 0, &perm, &used, &automorphisms);
+
+  std::vector<std::pair<uint32_t, uint32_t>> conditions;
+  while (automorphisms.size() > 1) {
+    // Fix the node with the largest orbit
+    uint32_t fixed = 0;
+    std::vector<uint32_t> fixed_orbit;
+    for (uint32_t a = 0; a < info.num_nodes; ++a) {
+      std::vector<uint32_t> orbit;
+      for (const Permutation& p : automorphisms) {
+        orbit.emplace_back(p[a]);
+      }
+      std::sort(orbit.begin(), orbit.end());
+      orbit.erase(std::unique(orbit.begin(), orbit.end()), orbit.end());
+      if (orbit.size() > fixed_orbit.size()) {
+        fixed = a;
+        fixed_orbit = std::move(orbit);
+      }
+    }
+    for (uint32_t b : fixed_orbit) {
+      if (b != fixed) {
+        conditions.emplace_back(fixed, b);
+      }
+    }
+    automorphisms.erase(
+        std::remove_if(
+            automorphisms.begin(), automorphisms.end(),
+            [&](const Permutation& p) { return p[fixed] != fixed; }),
+        automorphisms.end());
+  }
+  return conditions;
+}
+
+/// How to match one pattern node given the matches of those before it
+struct Level {
+  uint32_t pattern_node{0};
+  /// Earlier levels whose pattern nodes share an edge of the given type
+  /// (or kNoType) with this one
+  std::vector<std::pair<uint32_t, int64_t>> back_edges;
+  /// Earlier levels whose matches must be less than this level's
+  std::vector<uint32_t> after;
+  /// Earlier levels whose matches must be greater than this level's
+  std::vector<uint32_t> before;
+  std::optional<int64_t> label;
+  uint64_t min_degree{0};
+};
+
+/// Order the pattern nodes so that each one after the first shares an
+/// edge with an earlier one, preferring those that share the most, which
+/// makes the candidate sets small early on
+std::vector<Level>
+MakeLevels(const PatternInfo& info) {
+  std::vector<uint32_t> order;
+  std::array<bool, kMaxNodes> ordered{};
+  while (order.size() < info.num_nodes) {
+    uint32_t best = info.num_nodes;
+    std::pair<uint32_t, uint32_t> best_score{0, 0};
+    for (uint32_t a = 0; a < info.num_nodes; ++a) {
+      if (ordered[a]) {
+        continue;
+      }
+      uint32_t back = 0;
+      for (uint32_t b : order) {
+        back += info.types[a][b].size();
+      }
+      if (!order.empty() && back == 0) {
+        continue;
+      }
+      std::pair<uint32_t, uint32_t> score{back, info.degree(a)};
+      if (best == info.num_nodes || score > best_score) {
+        best = a;
+        best_score = score;
+      }
+    }
+    ordered[best] = true;
+    order.emplace_back(best);
+  }
+
+  std::array<uint32_t, kMaxNodes> level_of{};
+  for (uint32_t l = 0; l < order.size(); ++l) {
+    level_of[order[l]] = l;
+  }
+
+  std::vector<Level> levels(order.size());
+  for (uint32_t l = 0; l < order.size(); ++l) {
+    Level& level = levels[l];
+    uint32_t a = order[l];
+    level.pattern_node = a;
+    level.label = info.labels[a];
+    level.min_degree = info.degree(a);
+    for (uint32_t k = 0; k < l; ++k) {
+      for (int64_t type : info.types[a][order[k]]) {
+        level.back_edges.emplace_back(k, type);
+      }
+    }
+  }
+  for (auto [a, b] : SymmetryBreakingConditions(info)) {
+    uint32_t la = level_of[a];
+    uint32_t lb = level_of[b];
+    if (la < lb) {
+      levels[lb].after.emplace_back(la);
+    } else {
+      levels[la].before.emplace_back(lb);
+    }
+  }
+  return levels;
+}
+
+/// Per-thread buffers for the candidates of each level
+struct Scratch {
+  std::array<std::vector<Node>, kMaxNodes> candidates;
+  std::array<std::vector<Node>, kMaxNodes> tmp;
+};
+
+class Matcher {
+public:
+  Matcher(
+      const katana::GraphTopology& topology, std::vector<Level> levels,
+      std::shared_ptr<arrow::Int64Array> labels)
+      : topology_(topology),
+        dests_(topology.out_dests->raw_values()),
+        levels_(std::move(levels)),
+        labels_(std::move(labels)) {}
+
+  uint32_t num_levels() const { return levels_.size(); }
+
+  uint32_t pattern_node(uint32_t level) const {
+    return levels_[level].pattern_node;
+  }
+
+  /// Whether node can be matched at level given the matches of the earlier
+  /// levels, apart from the conditions that Candidates already checks
+  bool Accepts(uint32_t level, const Node* match, Node node) const {
+    const Level& l = levels_[level];
+    if (Degree(node) < l.min_degree) {
+      return false;
+    }
+    if (l.label && !HasLabel(node, *l.label)) {
+      return false;
+    }
+    for (uint32_t k = 0; k < level; ++k) {
+      if (match[k] == node) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// The nodes that share the edges of level with the earlier matches and
+  /// satisfy its symmetry breaking conditions, in increasing order
+  NodeRange Candidates(
+      uint32_t level, const Node* match, Scratch* scratch) const {
+    std::array<NodeRange, kMaxNodes * kMaxNodes> ranges;
+    size_t num_ranges = BoundedRanges(level, match, ranges.data());
+    if (num_ranges == 0) {
+      return NodeRange(nullptr, nullptr);
+    }
+    return Intersect(level, ranges.data(), num_ranges, scratch);
+  }
+
+  /// The number of nodes that Accepts and Candidates allow at the last
+  /// level, which must not have a label
+  uint64_t CountLast(
+      uint32_t level, const Node* match, Scratch* scratch) const {
+    std::array<NodeRange, kMaxNodes * kMaxNodes> ranges;
+    size_t num_ranges = BoundedRanges(level, match, ranges.data());
+    if (num_ranges == 0) {
+      return 0;
+    }
+    uint64_t count = 0;
+    if (num_ranges == 1) {
+      count = ranges[0].second - ranges[0].first;
+    } else {
+      NodeRange last = ranges[num_ranges - 1];
+      NodeRange rest = Intersect(level, ranges.data(), num_ranges - 1, scratch);
+      count = CountSortedIntersection(
+          rest.first, rest.second, last.first, last.second);
+    }
+
+    // Matches of earlier levels may not be matched again
+    for (uint32_t k = 0; k < level; ++k) {
+      bool in_all = true;
+      for (size_t i = 0; i < num_ranges && in_all; ++i) {
+        in_all = std::binary_search(
+            ranges[i].first, ranges[i].second, match[k]);
+      }
+      count -= in_all;
+    }
+    return count;
+  }
+
+  bool CanCountLast() const { return !levels_.back().label; }
+
+  /// Extend the matches of the levels before level in every way and call
+  /// emit with each complete match. With kCountOnly, emit is not called for
+  /// the last level, which is counted with CountLast instead. Returns the
+  /// number of matches.
+  template <bool kCountOnly, typename EmitFn>
+  uint64_t Extend(
+      uint32_t level, Node* match, Scratch* scratch,
+      const EmitFn& emit) const {
+    bool last = level + 1 == num_levels();
+    if (kCountOnly && last && CanCountLast()) {
+      return CountLast(level, match, scratch);
+    }
+    auto [begin, end] = Candidates(level, match, scratch);
+    uint64_t count = 0;
+    for (const Node* c = begin; c != end; ++c) {
+      if (!Accepts(level, match, *c)) {
+        continue;
+      }
+      match[level] = *c;
+      if (last) {
+        emit(match);
+        ++count;
+      } else {
+        count += Extend<kCountOnly>(level + 1, match, scratch, emit);
+      }
+    }
+    return count;
+  }
+
+private:
+  uint64_t Degree(Node n) const {
+    auto [begin, end] = topology_.edge_range(n);
+    return end - begin;
+  }
+
+  bool HasLabel(Node n, int64_t label) const {
+    return labels_->IsValid(n) && labels_->Value(n) == label;
+  }
+
+  /// Write the destinations of the back edges of level, restricted to the
+  /// bounds of its symmetry breaking conditions, to ranges, smallest first.
+  /// Returns the number of ranges, or 0 if one of them is empty.
+  size_t BoundedRanges(
+      uint32_t level, const Node* match, NodeRange* ranges) const {
+    const Level& l = levels_[level];
+    uint64_t lo = 0;
+    uint64_t hi = std::numeric_limits<uint64_t>::max();
+    for (uint32_t k : l.after) {
+      lo = std::max<uint64_t>(lo, uint64_t{match[k]} + 1);
+    }
+    for (uint32_t k : l.before) {
+      hi = std::min<uint64_t>(hi, match[k]);
+    }
+    if (lo >= hi) {
+      return 0;
+    }
+
+    size_t num_ranges = 0;
+    for (auto [k, type] : l.back_edges) {
+      NodeRange range;
+      if (type == kNoType) {
+        range = EdgeDestRange(topology_, match[k]);
+      } else {
+        auto edges = topology_.edges(match[k], static_cast<uint32_t>(type));
+        range = NodeRange(dests_ + *edges.begin(), dests_ + *edges.end());
+      }
+      if (lo > 0) {
+        range.first = std::lower_bound(range.first, range.second, lo);
+      }
+      if (hi <= std::numeric_limits<Node>::max()) {
+        range.second = std::lower_bound(range.first, range.second, hi);
+      }
+      if (range.first == range.second) {
+        return 0;
+      }
+      ranges[num_ranges++] = range;
+    }
+    std::sort(
+        ranges, ranges + num_ranges,
+        [](const NodeRange& a, const NodeRange& b) {
+          return a.second - a.first < b.second - b.first;
+        });
+    return num_ranges;
+  }
+
+  /// The intersection of ranges, in the buffers of level
+  NodeRange Intersect(
+      uint32_t level, const NodeRange* ranges, size_t num_ranges,
+      Scratch* scratch) const {
+    if (num_ranges == 1) {
+      return ranges[0];
+    }
+    // The first range is the smallest, which bounds the intersection
+    size_t max_size = ranges[0].second - ranges[0].first;
+    if (scratch->candidates[level].size() < max_size) {
+      scratch->candidates[level].resize(max_size);
+      scratch->tmp[level].resize(max_size);
+    }
+    Node* out = scratch->candidates[level].data();
+    Node* tmp = scratch->tmp[level].data();
+    size_t size = SortedIntersection(
+        ranges[0].first, ranges[0].second, ranges[1].first, ranges[1].second,
+        out);
+    for (size_t i = 2; i < num_ranges && size > 0; ++i) {
+      size = SortedIntersection(
+          out, out + size, ranges[i].first, ranges[i].second, tmp);
+      std::swap(out, tmp);
+    }
+    return NodeRange(out, out + size);
+  }
+
+  const katana::GraphTopology& topology_;
+  const Node* dests_;
+  std::vector<Level> levels_;
+  std::shared_ptr<arrow::Int64Array> labels_;
+};
+
+katana::Result<std::shared_ptr<arrow::Int64Array>>
+NodeLabels(const katana::PropertyGraph& pg, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> property = pg.GetNodeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "node property {} not found",
+        name);
+  }
+  if (!arrow::is_integer(property->type()->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "node label property {} has type {}, not an integer type", name,
+        property->type()->ToString());
+  }
+  auto cast_res = arrow::compute::Cast(property, arrow::int64());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError,
+        "converting node label property {} to int64: {}", name,
+        cast_res.status());
+  }
+  auto array_res =
+      katana::CoalesceChunks(*cast_res.ValueOrDie().chunked_array());
+  if (!array_res) {
+    return array_res.error();
+  }
+  return std::static_pointer_cast<arrow::Int64Array>(array_res.value());
+}
+
+katana::Result<Matcher>
+MakeMatcher(const katana::PropertyGraph& pg, const Pattern& pattern) {
+  auto info_res = MakePatternInfo(pattern);
+  if (!info_res) {
+    return info_res.error();
+  }
+  const PatternInfo& info = info_res.value();
+
+  const katana::GraphTopology& topology = pg.topology();
+  if (info.typed && !topology.edge_type_index) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "pattern edges have types but the graph edges are not indexed by "
+        "type; see SortAllEdgesByType");
+  }
+  if (!info.typed && topology.edge_type_index && pattern.num_nodes > 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the graph edges are sorted by type, so pattern edges need types");
+  }
+
+  std::shared_ptr<arrow::Int64Array> labels;
+  if (info.labeled) {
+    auto labels_res = NodeLabels(pg, pattern.node_label_property);
+    if (!labels_res) {
+      return labels_res.error();
+    }
+    labels = std::move(labels_res.value());
+  }
+  return Matcher(topology, MakeLevels(info), std::move(labels));
+}
+
+/// Match the pattern of matcher in every way and call emit with each match,
+/// in level order. Work items are the graph nodes matched to the first
+/// level and, for nodes with at least plan.split_degree() candidates for
+/// the second level, the pairs matched to the first two levels, encoded as
+/// (second + 1) << 32 | first.
+template <bool kCountOnly, typename EmitFn>
+uint64_t
+MatchAll(
+    const katana::GraphTopology& topology, const Matcher* matcher,
+    const PatternMatchPlan& plan, const EmitFn& emit) {
+  katana::GAccumulator<uint64_t> total;
+  katana::PerThreadStorage<Scratch> scratch;
+
+  if (matcher->num_levels() == 1) {
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          Node match[kMaxNodes] = {n};
+          if (matcher->Accepts(0, match, n)) {
+            if (!kCountOnly) {
+              emit(match);
+            }
+            total += 1;
+          }
+        },
+        katana::steal(), katana::loopname("PatternMatch"));
+    return total.reduce();
+  }
+
+  katana::for_each(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t item, auto& ctx) {
+        Scratch* local = scratch.getLocal();
+        Node match[kMaxNodes];
+        match[0] = static_cast<Node>(item);
+        if (uint64_t second = item >> 32; second != 0) {
+          match[1] = static_cast<Node>(second - 1);
+          total += matcher->Extend<kCountOnly>(2, match, local, emit);
+          return;
+        }
+
+        if (!matcher->Accepts(0, match, match[0])) {
+          return;
+        }
+        if (matcher->num_levels() == 2) {
+          total += matcher->Extend<kCountOnly>(1, match, local, emit);
+          return;
+        }
+        auto [begin, end] = matcher->Candidates(1, match, local);
+        bool split =
+            static_cast<uint64_t>(end - begin) >= plan.split_degree();
+        for (const Node* c = begin; c != end; ++c) {
+          if (!matcher->Accepts(1, match, *c)) {
+            continue;
+          }
+          if (split) {
+            ctx.push((uint64_t{*c} + 1) << 32 | match[0]);
+          } else {
+            match[1] = *c;
+            total += matcher->Extend<kCountOnly>(2, match, local, emit);
+          }
+        }
+      },
+      katana::wl<katana::PerSocketChunkFIFO<kChunkSize>>(),
+      katana::disable_conflict_detection(), katana::loopname("PatternMatch"));
+  return total.reduce();
+}
+
+}  // namespace
+
+Pattern
+Pattern::Path(uint32_t num_nodes) {
+  Pattern pattern;
+  pattern.num_nodes = num_nodes;
+  for (uint32_t a = 0; a + 1 < num_nodes; ++a) {
+    pattern.edges.emplace_back(Edge{a, a + 1, std::nullopt});
+  }
+  return pattern;
+}
+
+Pattern
+Pattern::Star(uint32_t num_leaves) {
+  Pattern pattern;
+  pattern.num_nodes = num_leaves + 1;
+  for (uint32_t a = 1; a <= num_leaves; ++a) {
+    pattern.edges.emplace_back(Edge{0, a, std::nullopt});
+  }
+  return pattern;
+}
+
+Pattern
+Pattern::Cycle(uint32_t num_nodes) {
+  Pattern pattern = Path(num_nodes);
+  if (num_nodes > 2) {
+    pattern.edges.emplace_back(Edge{num_nodes - 1, 0, std::nullopt});
+  }
+  return pattern;
+}
+
+Pattern
+Pattern::Clique(uint32_t num_nodes) {
+  Pattern pattern;
+  pattern.num_nodes = num_nodes;
+  for (uint32_t a = 0; a < num_nodes; ++a) {
+    for (uint32_t b = a + 1; b < num_nodes; ++b) {
+      pattern.edges.emplace_back(Edge{a, b, std::nullopt});
+    }
+  }
+  return pattern;
+}
+
+katana::Result<uint64_t>
+katana::analytics::CountPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern, PatternMatchPlan plan) {
+  auto matcher_res = MakeMatcher(*pg, pattern);
+  if (!matcher_res) {
+    return matcher_res.error();
+  }
+  return MatchAll<true>(
+      pg->topology(), &matcher_res.value(), plan, [](const Node*) {});
+}
+
+katana::Result<void>
+katana::analytics::FindPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern,
+    const PatternMatchCallback& callback, PatternMatchPlan plan) {
+  auto matcher_res = MakeMatcher(*pg, pattern);
+  if (!matcher_res) {
+    return matcher_res.error();
+  }
+  Matcher& matcher = matcher_res.value();
+  MatchAll<false>(pg->topology(), &matcher, plan, [&](const Node* match) {
+    std::array<uint32_t, kMaxNodes> by_pattern_node;
+    for (uint32_t l = 0; l < matcher.num_levels(); ++l) {
+      by_pattern_node[matcher.pattern_node(l)] = match[l];
+    }
+    callback(by_pattern_node.data());
+  });
+  return katana::ResultSuccess();
+}
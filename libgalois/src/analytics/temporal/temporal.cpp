@@ -0,0 +1,238 @@
+#include "katana/analytics/temporal/temporal.h"
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/StatCounter.h"
+#include "katana/analytics/SpMV.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Edges of nodes with more out-edges in the window than this are pushed in
+/// tiles of this many edges
+constexpr uint64_t kEdgeTileSize = 128;
+
+/// Return the time index of pg by time_property, building it if pg has no
+/// index or an index by another property
+katana::Result<const katana::EdgeTimeIndex*>
+EnsureTimeIndex(katana::PropertyGraph* pg, const std::string& time_property) {
+  const auto& index = pg->topology().edge_time_index;
+  if (!index || index->property != time_property) {
+    if (auto r = pg->IndexEdgesByTime(time_property); !r) {
+      return r.error();
+    }
+  }
+  return pg->topology().edge_time_index.get();
+}
+
+katana::Result<void>
+CheckWindow(int64_t begin_time, int64_t end_time) {
+  if (begin_time > end_time) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "window begins at {} after it ends at {}", begin_time, end_time);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::EarliestArrival(
+    katana::PropertyGraph* pg, uint32_t source,
+    const std::string& time_property, int64_t begin_time, int64_t end_time,
+    const std::string& output_property_name, EarliestArrivalPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckWindow(begin_time, end_time); !r) {
+    return r.error();
+  }
+  if (source >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} is not a node of a graph of {} nodes", source,
+        pg->num_nodes());
+  }
+  auto index_res = EnsureTimeIndex(pg, time_property);
+  if (!index_res) {
+    return index_res.error();
+  }
+  const int64_t* times = index_res.value()->times.data();
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  katana::StatTimer exec_time("EarliestArrival", "EarliestArrival");
+  exec_time.start();
+
+  // scanned[n] is the earliest time from which the window edges of n were
+  // relaxed, so the edges with times in [scanned[n], end_time) are done
+  std::vector<std::atomic<int64_t>> arrival(num_nodes);
+  std::vector<std::atomic<int64_t>> scanned(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        arrival[n].store(
+            EarliestArrivalPlan::kUnreachable, std::memory_order_relaxed);
+        scanned[n].store(end_time, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  arrival[source] = begin_time;
+
+  static katana::StatCounter edges_relaxed("EarliestArrival", "EdgesRelaxed");
+
+  katana::InsertBag<Node> frontier;
+  katana::InsertBag<Node> next;
+  frontier.push(source);
+  unsigned int round = 0;
+  while (!frontier.empty()) {
+    ++round;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          int64_t from = arrival[n].load(std::memory_order_relaxed);
+          int64_t to = scanned[n].load(std::memory_order_relaxed);
+          // Claim [from, to) so that no two threads relax the same edges
+          do {
+            if (from >= to) {
+              return;
+            }
+          } while (!scanned[n].compare_exchange_weak(
+              to, from, std::memory_order_relaxed));
+          auto edges = topology.edges(n, from, to);
+          edges_relaxed.Add(*edges.end() - *edges.begin());
+          for (auto e : edges) {
+            Node dest = topology.edge_dest(e);
+            if (katana::atomicMin(arrival[dest], times[e]) > times[e]) {
+              next.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("EarliestArrival"));
+    frontier.clear();
+    std::swap(frontier, next);
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("EarliestArrival", "Rounds", round);
+
+  auto view = AddNodeVectorProperty<int64_t>(pg, output_property_name);
+  if (!view) {
+    return view.error();
+  }
+  int64_t* out = view.value().data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { out[n] = arrival[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::TemporalPagerank(
+    katana::PropertyGraph* pg, const std::string& time_property,
+    int64_t begin_time, int64_t end_time,
+    const std::string& output_property_name, PagerankPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = CheckWindow(begin_time, end_time); !r) {
+    return r.error();
+  }
+  auto index_res = EnsureTimeIndex(pg, time_property);
+  if (!index_res) {
+    return index_res.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  katana::StatTimer exec_time("TemporalPagerank", "TemporalPagerank");
+  exec_time.start();
+
+  // The window edges of each node, found once
+  std::vector<std::pair<uint64_t, uint64_t>> window(num_nodes);
+  std::vector<float> rank(num_nodes);
+  std::vector<std::atomic<float>> residual(num_nodes);
+  katana::InsertBag<Node> active;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto edges = topology.edges(n, begin_time, end_time);
+        window[n] = std::make_pair(*edges.begin(), *edges.end());
+        rank[n] = 0;
+        residual[n].store(plan.initial_residual(), std::memory_order_relaxed);
+        active.push(n);
+      },
+      katana::no_stats());
+
+  struct Update {
+    float delta;
+    uint64_t begin;
+    uint64_t end;
+  };
+  katana::InsertBag<Update> updates;
+  unsigned int iteration = 0;
+  for (; !active.empty() && iteration < plan.max_iterations(); ++iteration) {
+    katana::do_all(
+        katana::iterate(active),
+        [&](Node n) {
+          if (residual[n].load(std::memory_order_relaxed) <=
+              plan.tolerance()) {
+            return;
+          }
+          float old_residual =
+              residual[n].exchange(0, std::memory_order_relaxed);
+          rank[n] += old_residual;
+          auto [begin, end] = window[n];
+          if (begin == end) {
+            return;
+          }
+          float delta = old_residual * plan.alpha() / (end - begin);
+          for (; end - begin > kEdgeTileSize; begin += kEdgeTileSize) {
+            updates.push(Update{delta, begin, begin + kEdgeTileSize});
+          }
+          updates.push(Update{delta, begin, end});
+        },
+        katana::steal(), katana::loopname("TemporalPagerank_Tiles"),
+        katana::no_stats());
+    active.clear();
+
+    katana::do_all(
+        katana::iterate(updates),
+        [&](const Update& update) {
+          for (uint64_t e = update.begin; e < update.end; ++e) {
+            Node dest = topology.edge_dest(e);
+            float old = katana::atomicAdd(residual[dest], update.delta);
+            // Residuals only grow in this loop, so each node crosses the
+            // tolerance at most once and is activated at most once
+            if (old <= plan.tolerance() &&
+                old + update.delta > plan.tolerance()) {
+              active.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("TemporalPagerank_Push"));
+    updates.clear();
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("TemporalPagerank", "Iterations", iteration);
+
+  auto view = AddNodeVectorProperty<float>(pg, output_property_name);
+  if (!view) {
+    return view.error();
+  }
+  float* out = view.value().data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { out[n] = rank[n]; }, katana::no_stats());
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,432 @@
+#include "katana/analytics/topological_sort/topological_sort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+using NodePosition = katana::PODProperty<uint64_t>;
+
+template <typename Weight>
+using EdgeWeight = katana::PODProperty<Weight>;
+
+/// The nodes of a DAG grouped by level, the number of edges on the longest
+/// path ending at a node: level i is order[level_begins[i],
+/// level_begins[i + 1]), in increasing node id order. All in-edges of a node
+/// come from earlier levels.
+struct Levels {
+  katana::LargeArray<Node> order;
+  std::vector<uint64_t> level_begins;
+
+  uint64_t num_levels() const { return level_begins.size() - 1; }
+
+  std::pair<uint64_t, uint64_t> level(uint64_t i) const {
+    return std::make_pair(level_begins[i], level_begins[i + 1]);
+  }
+};
+
+/// Move the nodes collected by the threads in next to the end of levels as
+/// a new level
+void
+AppendLevel(katana::PerThreadStorage<std::vector<Node>>* next, Levels* levels) {
+  std::vector<uint64_t> thread_begins(next->size() + 1);
+  thread_begins[0] = levels->level_begins.back();
+  for (unsigned i = 0; i < next->size(); ++i) {
+    thread_begins[i + 1] = thread_begins[i] + next->getRemote(i)->size();
+  }
+  katana::on_each([&](unsigned tid, unsigned) {
+    std::vector<Node>& local = *next->getLocal();
+    std::copy(local.begin(), local.end(), &levels->order[thread_begins[tid]]);
+    local.clear();
+  });
+
+  uint64_t begin = levels->level_begins.back();
+  uint64_t end = thread_begins.back();
+  katana::ParallelSTL::sort(
+      levels->order.begin() + begin, levels->order.begin() + end);
+  levels->level_begins.emplace_back(end);
+}
+
+/// Kahn's algorithm a level at a time: a node joins the next level when the
+/// last of its in-edges is removed by the current one
+katana::Result<Levels>
+SortByLevel(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  katana::LargeArray<uint64_t> in_degree;
+  in_degree.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_degree[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          __atomic_fetch_add(
+              &in_degree[topology.edge_dest(e)], 1, __ATOMIC_RELAXED);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  Levels levels;
+  levels.order.allocateInterleaved(num_nodes);
+  levels.level_begins.emplace_back(0);
+  katana::PerThreadStorage<std::vector<Node>> next;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        if (in_degree[n] == 0) {
+          next.getLocal()->emplace_back(n);
+        }
+      },
+      katana::no_stats());
+  AppendLevel(&next, &levels);
+
+  for (uint64_t i = 0; levels.level_begins[i] < levels.level_begins[i + 1];
+       ++i) {
+    if (auto r = CheckCancelled(); !r) {
+      return r.error();
+    }
+    auto [begin, end] = levels.level(i);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t pos) {
+          for (Edge e : topology.edges(levels.order[pos])) {
+            Node dest = topology.edge_dest(e);
+            if (__atomic_sub_fetch(&in_degree[dest], 1, __ATOMIC_RELAXED) ==
+                0) {
+              next.getLocal()->emplace_back(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("TopologicalSort-Level"));
+    AppendLevel(&next, &levels);
+  }
+  // The last level is empty
+  levels.level_begins.pop_back();
+
+  uint64_t num_sorted = levels.level_begins.back();
+  if (num_sorted != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph is not acyclic: {} nodes are on or after cycles",
+        num_nodes - num_sorted);
+  }
+  return levels;
+}
+
+/// Add a node property of type T named name with value(n) for each node n
+template <typename T, typename ValueFn>
+katana::Result<void>
+AddNodeProperty(
+    katana::PropertyGraph* pg, const std::string& name, const ValueFn& value) {
+  using Property = katana::PODProperty<T>;
+  using Graph = katana::TypedPropertyGraph<std::tuple<Property>, std::tuple<>>;
+  if (auto r = ConstructNodeProperties<std::tuple<Property>>(pg, {name});
+      !r) {
+    return r.error();
+  }
+  auto graph = Graph::Make(pg, {name}, {});
+  if (!graph) {
+    return graph.error();
+  }
+  T* data = graph.value().template GetNodePropertyView<Property>().data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t n) { data[n] = value(n); }, katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// The lengths of the longest paths ending at and starting from each node of
+/// a DAG, where paths may start and end at any node
+template <typename Weight>
+struct LongestPaths {
+  katana::LargeArray<std::atomic<Weight>> ending_at;
+  katana::LargeArray<Weight> starting_at;
+  Weight longest{0};
+};
+
+/// Push the lengths ending at each level forward along its out-edges, then
+/// pull the lengths starting at each level from later levels in reverse
+template <typename Weight, typename WeightFn>
+LongestPaths<Weight>
+ComputeLongestPaths(
+    const katana::GraphTopology& topology, const Levels& levels,
+    const WeightFn& weight) {
+  uint64_t num_nodes = topology.num_nodes();
+  LongestPaths<Weight> paths;
+  paths.ending_at.allocateInterleaved(num_nodes);
+  paths.starting_at.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { paths.ending_at.constructAt(n, Weight{0}); },
+      katana::no_stats());
+
+  for (uint64_t i = 0; i < levels.num_levels(); ++i) {
+    auto [begin, end] = levels.level(i);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t pos) {
+          Node n = levels.order[pos];
+          Weight length = paths.ending_at[n].load(std::memory_order_relaxed);
+          for (Edge e : topology.edges(n)) {
+            katana::atomicMax(
+                paths.ending_at[topology.edge_dest(e)],
+                static_cast<Weight>(length + weight(e)));
+          }
+        },
+        katana::steal(), katana::loopname("DagLongestPath-Forward"));
+  }
+
+  katana::PerThreadStorage<Weight> longest(Weight{0});
+  for (uint64_t i = levels.num_levels(); i-- > 0;) {
+    auto [begin, end] = levels.level(i);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t pos) {
+          Node n = levels.order[pos];
+          Weight length{0};
+          for (Edge e : topology.edges(n)) {
+            Weight through = static_cast<Weight>(
+                weight(e) + paths.starting_at[topology.edge_dest(e)]);
+            length = std::max(length, through);
+          }
+          paths.starting_at[n] = length;
+          Weight& local = *longest.getLocal();
+          local = std::max(local, length);
+        },
+        katana::steal(), katana::loopname("DagLongestPath-Backward"));
+  }
+  for (unsigned i = 0; i < longest.size(); ++i) {
+    paths.longest = std::max(paths.longest, *longest.getRemote(i));
+  }
+  return paths;
+}
+
+/// Return fn(weight), where weight(e) is the weight of edge e in the edge
+/// property named edge_weight_property_name, or 1 as a uint32 if it is
+/// empty
+template <typename ResultType, typename Fn>
+katana::Result<ResultType>
+WithWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const Fn& fn) {
+  if (edge_weight_property_name.empty()) {
+    return fn([](Edge) { return uint32_t{1}; });
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  auto typed = [&](auto zero) -> katana::Result<ResultType> {
+    using Weight = decltype(zero);
+    using Graph = katana::TypedPropertyGraph<
+        std::tuple<>, std::tuple<EdgeWeight<Weight>>>;
+    auto graph = Graph::Make(pg, {}, {edge_weight_property_name});
+    if (!graph) {
+      return graph.error();
+    }
+    const Weight* data = graph.value()
+                             .template GetEdgePropertyView<EdgeWeight<Weight>>()
+                             .data();
+    return fn([data](Edge e) { return data[e]; });
+  };
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return typed(uint32_t{0});
+  case arrow::Int32Type::type_id:
+    return typed(int32_t{0});
+  case arrow::UInt64Type::type_id:
+    return typed(uint64_t{0});
+  case arrow::Int64Type::type_id:
+    return typed(int64_t{0});
+  case arrow::FloatType::type_id:
+    return typed(float{0});
+  case arrow::DoubleType::type_id:
+    return typed(double{0});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type: {}",
+        weights->type()->ToString());
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::TopologicalSort(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    TopologicalSortPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  auto levels = SortByLevel(pg->topology());
+  if (!levels) {
+    return levels.error();
+  }
+  const katana::LargeArray<Node>& order = levels.value().order;
+
+  katana::LargeArray<uint64_t> positions;
+  positions.allocateInterleaved(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t pos) { positions[order[pos]] = pos; }, katana::no_stats());
+  return AddNodeProperty<uint64_t>(
+      pg, output_property_name, [&](uint64_t n) { return positions[n]; });
+}
+
+katana::Result<void>
+katana::analytics::TopologicalSortAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodePosition>, std::tuple<>>;
+  auto graph = Graph::Make(pg, {property_name}, {});
+  if (!graph) {
+    return graph.error();
+  }
+  const uint64_t* position =
+      graph.value().GetNodePropertyView<NodePosition>().data();
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  katana::DynamicBitset seen;
+  seen.resize(num_nodes);
+  katana::GAccumulator<uint64_t> invalid;
+  katana::GAccumulator<uint64_t> backward;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        if (position[n] >= num_nodes || seen.set(position[n])) {
+          invalid += 1;
+        }
+        for (Edge e : topology.edges(n)) {
+          if (position[topology.edge_dest(e)] <= position[n]) {
+            backward += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (invalid.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes have invalid or repeated positions", invalid.reduce());
+  }
+  if (backward.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} edges do not go forward",
+        backward.reduce());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::DagLongestPath(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    const std::string& slack_property_name, TopologicalSortPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  auto levels = SortByLevel(pg->topology());
+  if (!levels) {
+    return levels.error();
+  }
+
+  return WithWeights<void>(
+      pg, edge_weight_property_name,
+      [&](const auto& weight) -> katana::Result<void> {
+        using Weight = decltype(weight(Edge{0}));
+        LongestPaths<Weight> paths = ComputeLongestPaths<Weight>(
+            pg->topology(), levels.value(), weight);
+        if (auto r = AddNodeProperty<Weight>(
+                pg, output_property_name,
+                [&](uint64_t n) {
+                  return paths.ending_at[n].load(std::memory_order_relaxed);
+                });
+            !r) {
+          return r.error();
+        }
+        if (slack_property_name.empty()) {
+          return katana::ResultSuccess();
+        }
+        return AddNodeProperty<Weight>(
+            pg, slack_property_name, [&](uint64_t n) {
+              return static_cast<Weight>(
+                  paths.longest -
+                  paths.ending_at[n].load(std::memory_order_relaxed) -
+                  paths.starting_at[n]);
+            });
+      });
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::DagCriticalPath(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    TopologicalSortPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  auto levels = SortByLevel(topology);
+  if (!levels) {
+    return levels.error();
+  }
+  if (topology.num_nodes() == 0) {
+    return std::vector<uint32_t>();
+  }
+
+  return WithWeights<std::vector<uint32_t>>(
+      pg, edge_weight_property_name,
+      [&](const auto& weight) -> katana::Result<std::vector<uint32_t>> {
+        using Weight = decltype(weight(Edge{0}));
+        LongestPaths<Weight> paths =
+            ComputeLongestPaths<Weight>(topology, levels.value(), weight);
+
+        katana::GReduceMin<Node> first;
+        katana::do_all(
+            katana::iterate(topology),
+            [&](Node n) {
+              if (paths.starting_at[n] == paths.longest) {
+                first.update(n);
+              }
+            },
+            katana::no_stats());
+
+        // Each step takes the first edge that the longest path starting at
+        // the node was computed from, so the comparison is exact
+        std::vector<uint32_t> path{first.reduce()};
+        for (bool extended = true; extended;) {
+          extended = false;
+          Node n = path.back();
+          for (Edge e : topology.edges(n)) {
+            Node dest = topology.edge_dest(e);
+            if (static_cast<Weight>(weight(e) + paths.starting_at[dest]) ==
+                paths.starting_at[n]) {
+              path.emplace_back(dest);
+              extended = true;
+              break;
+            }
+          }
+        }
+        return path;
+      });
+}
@@ -19,6 +19,17 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "katana/EdgeBlocks.h"
+#include "katana/LargeArray.h"
+#include "katana/ParaMeter.h"
+#include "katana/ParallelSTL.h"
+#include "katana/analytics/Intersection.h"
+#include "katana/analytics/TriangleSampling.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -28,80 +39,6 @@ using Node = katana::PropertyGraph::Node;
 
 constexpr static const unsigned kChunkSize = 64U;
 
-/**
- * Like std::lower_bound but doesn't dereference iterators. Returns the first
- * element for which comp is not true.
- */
-template <typename Iterator, typename Compare>
-Iterator
-LowerBound(Iterator first, Iterator last, Compare comp) {
-  using difference_type =
-      typename std::iterator_traits<Iterator>::difference_type;
-
-  Iterator it;
-  difference_type count;
-  difference_type half;
-
-  count = std::distance(first, last);
-  while (count > 0) {
-    it = first;
-    half = count / 2;
-    std::advance(it, half);
-    if (comp(it)) {
-      first = ++it;
-      count -= half + 1;
-    } else {
-      count = half;
-    }
-  }
-  return first;
-}
-
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = *g.GetEdgeDest(aa);
-    typename G::Node b = *g.GetEdgeDest(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
-template <typename G>
-struct LessThan {
-  const G& g;
-  typename G::Node n;
-  LessThan(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) {
-    return *g.GetEdgeDest(it) < n;
-  }
-};
-
-template <typename G>
-struct GreaterThanOrEqual {
-  const G& g;
-  typename G::Node n;
-  GreaterThanOrEqual(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) {
-    return n >= *g.GetEdgeDest(it);
-  }
-};
-
 template <typename G>
 struct GetDegree {
   typedef typename G::Node N;
@@ -135,34 +72,29 @@ struct IdLess {
 size_t
 NodeIteratingAlgo(katana::PropertyGraph* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  const katana::GraphTopology& topology = graph->topology();
 
   katana::do_all(
       katana::iterate(*graph),
       [&](const PropertyGraph::Node& n) {
         // Partition neighbors
         // [first, ea) [n] [bb, last)
-        PropertyGraph::edge_iterator first = graph->edges(n).begin();
-        PropertyGraph::edge_iterator last = graph->edges(n).end();
-        PropertyGraph::edge_iterator ea =
-            LowerBound(first, last, LessThan<PropertyGraph>(*graph, n));
-        PropertyGraph::edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<PropertyGraph>(*graph, n));
-
-        for (; bb != last; ++bb) {
-          Node B = *graph->GetEdgeDest(bb);
-          for (auto aa = first; aa != ea; ++aa) {
-            Node A = *graph->GetEdgeDest(aa);
-            PropertyGraph::edge_iterator vv = graph->edges(A).begin();
-            PropertyGraph::edge_iterator ev = graph->edges(A).end();
-            PropertyGraph::edge_iterator it =
-                LowerBound(vv, ev, LessThan<PropertyGraph>(*graph, B));
-            if (it != ev && *graph->GetEdgeDest(it) == B) {
-              numTriangles += 1;
-            }
-          }
+        auto [first, last] = EdgeDestRange(topology, n);
+        const uint32_t* ea = std::lower_bound(first, last, n);
+        const uint32_t* bb = std::upper_bound(ea, last, n);
+
+        // Each (a, b) edge with a < n < b closes a triangle, so count the
+        // neighbors of a that are greater than n and are neighbors of n
+        size_t numTriangles_local = 0;
+        for (const uint32_t* aa = first; aa != ea; ++aa) {
+          auto [vv, ev] = EdgeDestRange(topology, *aa);
+          vv = std::upper_bound(vv, ev, n);
+          numTriangles_local += CountSortedIntersection(vv, ev, bb, last);
         }
+        numTriangles += numTriangles_local;
       },
       katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::edge_balanced(*graph),
       katana::loopname("TriangleCount_NodeIteratingAlgo"));
 
   return numTriangles.reduce();
@@ -174,26 +106,19 @@ NodeIteratingAlgo(katana::PropertyGraph* graph) {
 void
 OrderedCountFunc(
     PropertyGraph* graph, Node n, katana::GAccumulator<size_t>& numTriangles) {
+  const katana::GraphTopology& topology = graph->topology();
   size_t numTriangles_local = 0;
-  for (auto it_v : graph->edges(n)) {
-    auto v = *graph->GetEdgeDest(it_v);
+  auto [n_begin, n_end] = EdgeDestRange(topology, n);
+  for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+    auto v = *it_v;
     if (v > n) {
       break;
     }
-    PropertyGraph::edge_iterator it_n = graph->edges(n).begin();
-
-    for (auto it_vv : graph->edges(v)) {
-      auto vv = *graph->GetEdgeDest(it_vv);
-      if (vv > v) {
-        break;
-      }
-      while (*graph->GetEdgeDest(it_n) < vv) {
-        it_n++;
-      }
-      if (vv == *graph->GetEdgeDest(it_n)) {
-        numTriangles_local += 1;
-      }
-    }
+    // Count the neighbors vv <= v of v that are also neighbors of n
+    auto [v_begin, v_end] = EdgeDestRange(topology, v);
+    numTriangles_local += CountSortedIntersection(
+        v_begin, std::upper_bound(v_begin, v_end, v), n_begin,
+        std::upper_bound(n_begin, n_end, v));
   }
   numTriangles += numTriangles_local;
 }
@@ -208,11 +133,43 @@ OrderedCountAlgo(PropertyGraph* graph) {
       katana::iterate(*graph),
       [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
       katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::edge_balanced(*graph),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
   return numTriangles.reduce();
 }
 
+/**
+ * Ordered count over the orientation of the graph by degree: each triangle
+ * is counted once, from its lowest ranked node, by intersecting the
+ * out-neighbors of that node with those of each of its out-neighbors. This
+ * is the ordered count of a graph relabeled by degree without copying or
+ * permuting the graph.
+ */
+size_t
+DegreeOrderedDagAlgo(const katana::DegreeOrderedDag& dag) {
+  katana::GAccumulator<size_t> numTriangles;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, dag.num_nodes()),
+      [&](uint64_t n) {
+        auto [n_begin, n_end] = dag.OutNeighbors(n);
+        size_t numTriangles_local = 0;
+        for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+          auto [v_begin, v_end] = dag.OutNeighbors(*it_v);
+          numTriangles_local +=
+              CountSortedIntersection(v_begin, v_end, n_begin, n_end);
+        }
+        numTriangles += numTriangles_local;
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::edge_balanced_by([&dag](uint64_t n) {
+        return n > 0 ? dag.out_indices[n - 1] : uint64_t{0};
+      }),
+      katana::loopname("TriangleCount_DegreeOrderedDagAlgo"));
+
+  return numTriangles.reduce();
+}
+
 /**
  * Edge Iterator algorithm for counting triangles.
  * <code>
@@ -227,58 +184,276 @@ OrderedCountAlgo(PropertyGraph* graph) {
  * Thesis. Universitat Karlsruhe. 2007.
  */
 size_t
-EdgeIteratingAlgo(PropertyGraph* graph) {
-  struct WorkItem {
-    Node src;
-    Node dst;
-    WorkItem(const Node& a1, const Node& a2) : src(a1), dst(a2) {}
+EdgeIteratingAlgo(
+    const katana::GraphTopology& topology,
+    const katana::HilbertEdgeList& list) {
+  katana::GAccumulator<size_t> numTriangles;
+
+  // Going over the edges along the Hilbert curve keeps the neighbors of
+  // both ends of the edges of nearby blocks in cache
+  katana::ForEachEdgeBlock(
+      list,
+      [&](uint64_t, uint64_t begin, uint64_t end) {
+        size_t count = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          Node src = list.sources[i];
+          Node dst = list.dests[i];
+          if (src >= dst) {
+            continue;
+          }
+          // Compute intersection of range (src, dst) in neighbors of src
+          // and dst
+          auto [abegin, aend] = EdgeDestRange(topology, src);
+          auto [bbegin, bend] = EdgeDestRange(topology, dst);
+
+          const uint32_t* aa = std::upper_bound(abegin, aend, src);
+          const uint32_t* ea = std::lower_bound(aa, aend, dst);
+          const uint32_t* bb = std::upper_bound(bbegin, bend, src);
+          const uint32_t* eb = std::lower_bound(bb, bend, dst);
+
+          count += CountSortedIntersection(aa, ea, bb, eb);
+        }
+        numTriangles += count;
+      },
+      katana::loopname("TriangleCount_EdgeIteratingAlgo"), katana::steal());
+
+  return numTriangles.reduce();
+}
+
+/**
+ * DOULION: keep each undirected edge with probability p, count the
+ * triangles of the sparsified graph exactly and scale by 1 / p^3. Both
+ * directions of an edge get the same coin because the coin is a hash of the
+ * endpoints.
+ *
+ * The variance of the estimate is T (1 - p^3) / p^3 + K (1 - p) / p, where
+ * K is the number of ordered pairs of triangles that share an edge. K is
+ * estimated from the per-edge triangle counts s_e of the sparsified graph,
+ * whose sum of s_e (s_e - 1) has expectation K p^5.
+ */
+TriangleCountEstimate
+EdgeSamplingAlgo(PropertyGraph* graph, double p, uint64_t seed) {
+  const katana::GraphTopology& topology = graph->topology();
+  uint64_t num_nodes = graph->num_nodes();
+  // Compare coins against p scaled to the range of the hash; 2^64 itself is
+  // not representable, so p = 1 keeps every edge explicitly
+  auto threshold = static_cast<uint64_t>(std::ldexp(p, 64));
+  auto keep = [&](uint32_t a, uint32_t b) {
+    if (p >= 1) {
+      return true;
+    }
+    uint64_t lo = std::min(a, b);
+    uint64_t hi = std::max(a, b);
+    return SampleSeed(seed, (hi << 32) | lo) < threshold;
   };
 
-  katana::InsertBag<WorkItem> items;
-  katana::GAccumulator<size_t> numTriangles;
+  // Build the kept edges as a CSR, in the same (sorted) order
+  katana::LargeArray<uint64_t> indices;
+  indices.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const Node& n) {
+        auto [begin, end] = EdgeDestRange(topology, n);
+        indices[n] = std::count_if(
+            begin, end, [&](uint32_t dest) { return keep(n, dest); });
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      indices.begin(), indices.end(), indices.begin());
+  uint64_t num_kept = num_nodes > 0 ? indices[num_nodes - 1] : 0;
 
+  katana::LargeArray<uint32_t> dests;
+  dests.allocateBlocked(num_kept);
   katana::do_all(
       katana::iterate(*graph),
-      [&](Node n) {
-        for (auto edge : graph->edges(n)) {
-          auto dest = graph->GetEdgeDest(edge);
-          if (n < *dest) {
-            items.push(WorkItem(n, *dest));
+      [&](const Node& n) {
+        auto [begin, end] = EdgeDestRange(topology, n);
+        uint64_t out = n > 0 ? indices[n - 1] : 0;
+        for (const uint32_t* it = begin; it != end; ++it) {
+          if (keep(n, *it)) {
+            dests[out++] = *it;
           }
         }
       },
-      katana::loopname("TriangleCount_Initialize"));
+      katana::steal(), katana::no_stats());
 
+  auto kept_range = [&](uint32_t n) {
+    const uint32_t* base = dests.data();
+    return std::make_pair(
+        base + (n > 0 ? indices[n - 1] : 0), base + indices[n]);
+  };
+
+  // Count, for each kept edge (n, v) with v < n, the triangles it is part
+  // of; each triangle is counted by its three edges
+  katana::GAccumulator<uint64_t> edge_triangles;
+  katana::GAccumulator<uint64_t> shared_pairs;
   katana::do_all(
-      katana::iterate(items),
-      [&](const WorkItem& w) {
-        // Compute intersection of range (w.src, w.dst) in neighbors of
-        // w.src and w.dst
-        PropertyGraph::edge_iterator abegin = graph->edges(w.src).begin();
-        PropertyGraph::edge_iterator aend = graph->edges(w.src).end();
-        PropertyGraph::edge_iterator bbegin = graph->edges(w.dst).begin();
-        PropertyGraph::edge_iterator bend = graph->edges(w.dst).end();
-
-        PropertyGraph::edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<PropertyGraph>(*graph, w.src));
-        PropertyGraph::edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<PropertyGraph>(*graph, w.dst));
-        PropertyGraph::edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<PropertyGraph>(*graph, w.src));
-        PropertyGraph::edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<PropertyGraph>(*graph, w.dst));
-
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+      katana::iterate(*graph),
+      [&](const Node& n) {
+        auto [n_begin, n_end] = kept_range(n);
+        for (const uint32_t* it_v = n_begin; it_v != n_end; ++it_v) {
+          if (*it_v >= n) {
+            break;
+          }
+          auto [v_begin, v_end] = kept_range(*it_v);
+          uint64_t s = CountSortedIntersection(v_begin, v_end, n_begin, n_end);
+          edge_triangles += s;
+          shared_pairs += s > 0 ? s * (s - 1) : 0;
+        }
       },
-      katana::loopname("TriangleCount_EdgeIteratingAlgo"),
-      katana::chunk_size<kChunkSize>(), katana::steal());
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("TriangleCount_EdgeSamplingAlgo"));
 
-  return numTriangles.reduce();
+  double p3 = p * p * p;
+  double triangles = edge_triangles.reduce() / 3.0 / p3;
+  double shared = shared_pairs.reduce() / (p3 * p * p);
+  double variance = triangles * (1 - p3) / p3 + shared * (1 - p) / p;
+  return TriangleCountEstimate{triangles, variance, num_kept / 2};
+}
+
+/**
+ * Wedge sampling: draw wedges uniformly at random and scale the fraction
+ * that are closed. A uniform wedge is a node drawn with probability
+ * proportional to its number of wedges, and then two of its neighbors. With
+ * W wedges of which a fraction c is closed, there are c W / 3 triangles.
+ *
+ * Samples are drawn in rounds of fixed size. Each round is split into tasks
+ * with generators seeded from the plan seed, the round and the task, so the
+ * result does not depend on the number of threads.
+ */
+TriangleCountEstimate
+WedgeSamplingAlgo(
+    PropertyGraph* graph, double relative_error, double time_budget_seconds,
+    uint64_t seed) {
+  constexpr uint64_t kSamplesPerTask = 1024;
+  constexpr uint64_t kTasksPerRound = 1024;
+  constexpr uint64_t kMinSamples = 16 * kSamplesPerTask;
+
+  const katana::GraphTopology& topology = graph->topology();
+  uint64_t num_nodes = graph->num_nodes();
+
+  katana::LargeArray<uint64_t> wedge_ends;
+  wedge_ends.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const Node& n) { wedge_ends[n] = NumWedges(graph->edges(n).size()); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      wedge_ends.begin(), wedge_ends.end(), wedge_ends.begin());
+  uint64_t num_wedges = num_nodes > 0 ? wedge_ends[num_nodes - 1] : 0;
+  if (num_wedges == 0) {
+    return TriangleCountEstimate{0, 0, 0};
+  }
+
+  // Budgets beyond a year are as good as none and would overflow the clock
+  auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(std::min(time_budget_seconds, 3.2e7)));
+  auto deadline = std::chrono::steady_clock::now() + budget;
+
+  uint64_t num_samples = 0;
+  uint64_t num_closed = 0;
+  double scale = num_wedges / 3.0;
+  for (uint64_t round = 0;; ++round) {
+    katana::GAccumulator<uint64_t> closed;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kTasksPerRound),
+        [&](uint64_t task) {
+          std::mt19937_64 gen(SampleSeed(seed, round * kTasksPerRound + task));
+          std::uniform_int_distribution<uint64_t> pick(0, num_wedges - 1);
+          uint64_t local = 0;
+          for (uint64_t i = 0; i < kSamplesPerTask; ++i) {
+            uint64_t w = pick(gen);
+            auto node = std::upper_bound(
+                            wedge_ends.begin(), wedge_ends.end(), w) -
+                        wedge_ends.begin();
+            local += SampleWedge(topology, node, &gen);
+          }
+          closed += local;
+        },
+        katana::no_stats());
+    num_closed += closed.reduce();
+    num_samples += kSamplesPerTask * kTasksPerRound;
+
+    if (num_samples < kMinSamples) {
+      continue;
+    }
+    double c = static_cast<double>(num_closed) / num_samples;
+    double error = std::sqrt((1 - c) / (c * num_samples));
+    if (num_closed > 0 && error <= relative_error) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+
+  double c = static_cast<double>(num_closed) / num_samples;
+  return TriangleCountEstimate{
+      c * scale, scale * scale * c * (1 - c) / num_samples, num_samples};
+}
+
+katana::Result<TriangleCountEstimate>
+SampleTriangles(PropertyGraph* pg, TriangleCountPlan plan) {
+  std::unique_ptr<katana::PropertyGraph> mutable_pfg;
+  if (!plan.edges_sorted()) {
+    // Copy the graph so we don't mutate the users graph.
+    auto mutable_pfg_result = pg->Copy({}, {});
+    if (!mutable_pfg_result) {
+      return mutable_pfg_result.error();
+    }
+    mutable_pfg = std::move(mutable_pfg_result.value());
+    pg = mutable_pfg.get();
+    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
+      return r.error();
+    }
+  }
+
+  katana::ReportParam(
+      "TriangleCount", "IntersectionKernel", SortedIntersectionKernel());
+
+  TriangleCountEstimate estimate{};
+  katana::StatTimer execTime("TriangleCount", "TriangleCount");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kEdgeSampling:
+    if (!(plan.edge_probability() > 0 && plan.edge_probability() <= 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge probability {} is not in (0, 1]", plan.edge_probability());
+    }
+    estimate = EdgeSamplingAlgo(pg, plan.edge_probability(), plan.seed());
+    break;
+  case TriangleCountPlan::kWedgeSampling:
+    if (!(plan.relative_error() > 0)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "relative error {} is not positive", plan.relative_error());
+    }
+    estimate = WedgeSamplingAlgo(
+        pg, plan.relative_error(), plan.time_budget_seconds(), plan.seed());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  katana::ReportStatSingle(
+      "TriangleCount", "NumSamples", estimate.num_samples);
+  return estimate;
 }
 
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  katana::parameter::ProfileScope profile(plan.profile_parallelism());
+  if (plan.is_approximate()) {
+    auto estimate_result = SampleTriangles(pg, plan);
+    if (!estimate_result) {
+      return estimate_result.error();
+    }
+    return std::llround(estimate_result.value().triangles);
+  }
+
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
@@ -301,7 +476,19 @@ katana::analytics::TriangleCount(
   }
 
   std::unique_ptr<katana::PropertyGraph> mutable_pfg;
-  if (relabel || !plan.edges_sorted()) {
+  std::shared_ptr<const katana::DegreeOrderedDag> dag;
+  if (relabel && plan.algorithm() == TriangleCountPlan::kOrderedCount) {
+    // The orientation by degree stands in for a relabeled copy and is kept
+    // with the users graph for the next analytic
+    katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
+    timer_relabel.start();
+    auto dag_result = pg->OrientByDegree();
+    if (!dag_result) {
+      return dag_result.error();
+    }
+    dag = std::move(dag_result.value());
+    timer_relabel.stop();
+  } else if (relabel || !plan.edges_sorted()) {
     // Copy the graph so we don't mutate the users graph.
     auto mutable_pfg_result = pg->Copy({}, {});
     if (!mutable_pfg_result) {
@@ -309,28 +496,38 @@ katana::analytics::TriangleCount(
     }
     mutable_pfg = std::move(mutable_pfg_result.value());
     pg = mutable_pfg.get();
-  }
 
-  if (relabel) {
-    katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
-    timer_relabel.start();
-    if (auto r = katana::SortNodesByDegree(pg); !r) {
-      return r.error();
+    if (relabel) {
+      katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
+      timer_relabel.start();
+      if (auto r = katana::SortNodesByDegree(pg); !r) {
+        return r.error();
+      }
+      timer_relabel.stop();
     }
-    timer_relabel.stop();
-  }
 
-  // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
+    // If we relabel we must also sort. Relabeling will break the sorting.
     if (auto r = katana::SortAllEdgesByDest(pg); !r) {
       return r.error();
     }
   }
 
+  std::shared_ptr<const katana::HilbertEdgeList> hilbert_edges;
+  if (plan.algorithm() == TriangleCountPlan::kEdgeIteration) {
+    // Kept with the graph like the orientation by degree
+    auto edges_result = pg->OrderEdgesAlongHilbertCurve();
+    if (!edges_result) {
+      return edges_result.error();
+    }
+    hilbert_edges = std::move(edges_result.value());
+  }
+
   timer_graph_read.stop();
 
   katana::Prealloc(1, 16 * (pg->num_nodes() + pg->num_edges()));
   katana::reportPageAlloc("TriangleCount_MeminfoPre");
+  katana::ReportParam(
+      "TriangleCount", "IntersectionKernel", SortedIntersectionKernel());
 
   size_t total_count;
   katana::StatTimer execTime("TriangleCount", "TriangleCount");
@@ -340,10 +537,10 @@ katana::analytics::TriangleCount(
     total_count = NodeIteratingAlgo(pg);
     break;
   case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(pg);
+    total_count = EdgeIteratingAlgo(pg->topology(), *hilbert_edges);
     break;
   case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(pg);
+    total_count = dag ? DegreeOrderedDagAlgo(*dag) : OrderedCountAlgo(pg);
     break;
   default:
     return katana::ErrorCode::InvalidArgument;
@@ -354,3 +551,40 @@ katana::analytics::TriangleCount(
 
   return total_count;
 }
+
+katana::Result<TriangleCountEstimate>
+katana::analytics::EstimateTriangleCount(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (plan.is_approximate()) {
+    return SampleTriangles(pg, plan);
+  }
+  auto count_result = TriangleCount(pg, plan);
+  if (!count_result) {
+    return count_result.error();
+  }
+  return TriangleCountEstimate{
+      static_cast<double>(count_result.value()), 0, 0};
+}
+
+double
+katana::analytics::TriangleCountEstimate::standard_error() const {
+  return std::sqrt(variance);
+}
+
+double
+katana::analytics::TriangleCountEstimate::ConfidenceInterval(
+    double confidence) const {
+  // Find z with P(|Z| < z) = erf(z / sqrt(2)) = confidence for a standard
+  // normal Z by bisection
+  double lo = 0;
+  double hi = 10;
+  for (int i = 0; i < 100; ++i) {
+    double mid = (lo + hi) / 2;
+    if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return hi * standard_error();
+}
@@ -0,0 +1,150 @@
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/Workspace.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using katana::analytics::AnalyticsWorkspace;
+using katana::analytics::BfsPlan;
+using katana::analytics::SsspPlan;
+
+/// Make a random graph with uint32 weights in the edge property "weight"
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> weight_dist(1, 20);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+      weights.emplace_back(weight_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  auto weight_array = katana::BuildArray(weights);
+  auto add_result = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", weight_array->type())}),
+      {weight_array}));
+  KATANA_LOG_VASSERT(add_result, "{}", add_result.error());
+  return g;
+}
+
+template <typename ArrowArray>
+void
+AssertSameValues(
+    const katana::PropertyGraph& g, const std::string& expected,
+    const std::string& actual) {
+  auto e = std::static_pointer_cast<ArrowArray>(
+      g.GetNodeProperty(expected)->chunk(0));
+  auto a =
+      std::static_pointer_cast<ArrowArray>(g.GetNodeProperty(actual)->chunk(0));
+  for (uint32_t n = 0; n < g.num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        e->Value(n) == a->Value(n), "node {}: expected {} found {}", n,
+        e->Value(n), a->Value(n));
+  }
+}
+
+void
+TestBfs(katana::PropertyGraph* g) {
+  AnalyticsWorkspace workspace(g);
+  for (const BfsPlan& plan :
+       {BfsPlan::Asynchronous(), BfsPlan::Synchronous(),
+        BfsPlan::SynchronousTile(), BfsPlan::SynchronousDirectOpt()}) {
+    for (uint32_t source :
+         {0U, 7U, static_cast<uint32_t>(g->num_nodes() - 1)}) {
+      auto r = katana::analytics::Bfs(g, source, "expected", plan);
+      KATANA_LOG_VASSERT(r, "{}", r.error());
+      r = katana::analytics::Bfs(g, source, "actual", &workspace, plan);
+      KATANA_LOG_VASSERT(r, "{}", r.error());
+      // Reused columns are handed out again
+      KATANA_LOG_ASSERT(workspace.released_bytes() == 0);
+
+      AssertSameValues<arrow::UInt32Array>(*g, "expected", "actual");
+
+      KATANA_LOG_ASSERT(g->RemoveNodeProperty("expected"));
+      KATANA_LOG_ASSERT(workspace.ReleaseNodeProperty("actual"));
+      KATANA_LOG_ASSERT(workspace.released_bytes() > 0);
+    }
+  }
+}
+
+void
+TestSssp(katana::PropertyGraph* g) {
+  AnalyticsWorkspace workspace(g);
+  for (const SsspPlan& plan :
+       {SsspPlan::DeltaStep(2), SsspPlan::DeltaTile(2, 4),
+        SsspPlan::Dijkstra(), SsspPlan::Topological()}) {
+    for (uint32_t source :
+         {0U, 7U, static_cast<uint32_t>(g->num_nodes() - 1)}) {
+      auto r = katana::analytics::Sssp(g, source, "weight", "expected", plan);
+      KATANA_LOG_VASSERT(r, "{}", r.error());
+      r = katana::analytics::Sssp(
+          g, source, "weight", "actual", &workspace, plan);
+      KATANA_LOG_VASSERT(r, "{}", r.error());
+
+      AssertSameValues<arrow::UInt32Array>(*g, "expected", "actual");
+
+      KATANA_LOG_ASSERT(g->RemoveNodeProperty("expected"));
+      KATANA_LOG_ASSERT(workspace.ReleaseNodeProperty("actual"));
+    }
+  }
+}
+
+void
+TestHeldColumnIsNotReused(katana::PropertyGraph* g) {
+  AnalyticsWorkspace workspace(g);
+  auto r = katana::analytics::Bfs(g, 0, "actual", &workspace);
+  KATANA_LOG_VASSERT(r, "{}", r.error());
+
+  auto held = g->GetNodeProperty("actual");
+  KATANA_LOG_ASSERT(held);
+  KATANA_LOG_ASSERT(workspace.ReleaseNodeProperty("actual"));
+  KATANA_LOG_ASSERT(workspace.released_bytes() == 0);
+  KATANA_LOG_ASSERT(!workspace.HasNodeProperty("actual"));
+
+  // A workspace only serves its own graph
+  katana::PropertyGraph other;
+  KATANA_LOG_ASSERT(!katana::analytics::Bfs(&other, 0, "actual", &workspace));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  for (uint32_t max_degree : {2, 8}) {
+    auto g = MakeRandomGraph(1000, max_degree, &gen);
+    TestBfs(g.get());
+    TestSssp(g.get());
+    TestHeldColumnIsNotReused(g.get());
+  }
+
+  return 0;
+}
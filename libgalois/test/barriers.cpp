@@ -19,11 +19,13 @@
 
 #include <unistd.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 
 #include "katana/Barrier.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 #include "katana/Timer.h"
 
 unsigned iter = 0;
@@ -31,6 +33,25 @@ unsigned numThreads = 0;
 
 char bname[100];
 
+/// Check that no thread leaves a round before every thread has entered it
+struct check {
+  katana::Barrier& b;
+  std::atomic<unsigned>& arrived;
+  unsigned M;
+
+  template <typename T, typename C>
+  void operator()(const T&, const C&) {
+    for (unsigned i = 0; i < 100; ++i) {
+      ++arrived;
+      b.Wait();
+      unsigned n = arrived;
+      KATANA_LOG_VASSERT(
+          n >= (i + 1) * M && n <= (i + 2) * M, "{} left round {} early",
+          b.name(), i);
+    }
+  }
+};
+
 struct emp {
   katana::Barrier& b;
 
@@ -64,6 +85,8 @@ test(std::unique_ptr<katana::Barrier> b) {
   while (M) {
     katana::setActiveThreads(M);
     b->Reinit(M);
+    std::atomic<unsigned> arrived{0};
+    katana::on_each(check{*b.get(), arrived, M});
     katana::Timer t;
     t.start();
     emp e{*b.get()};
@@ -93,5 +116,7 @@ main(int argc, char** argv) {
   test(CreateMCSBarrier(1));
   test(CreateTopoBarrier(1));
   test(CreateDisseminationBarrier(1));
+  test(CreateHierarchicalBarrier(1));
+  test(CreateBarrier(1));
   return 0;
 }
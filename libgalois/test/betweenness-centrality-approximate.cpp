@@ -0,0 +1,84 @@
+#include <cmath>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+namespace {
+
+using katana::analytics::BetweennessCentrality;
+using katana::analytics::BetweennessCentralityPlan;
+
+constexpr size_t kNumNodes = 1000;
+constexpr double kEpsilon = 0.01;
+
+std::shared_ptr<arrow::FloatArray>
+GetCentrality(katana::PropertyGraph* g, const std::string& name) {
+  auto result = g->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  return result.value();
+}
+
+void
+TestApproximate(katana::PropertyGraph* g) {
+  auto exact_result = BetweennessCentrality(
+      g, "exact", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Level());
+  KATANA_LOG_VASSERT(exact_result, "{}", exact_result.error());
+
+  auto plan = BetweennessCentralityPlan::Approximate(kEpsilon);
+  auto approximate_result = BetweennessCentrality(
+      g, "approximate", katana::analytics::kBetweennessCentralityAllNodes,
+      plan);
+  KATANA_LOG_VASSERT(approximate_result, "{}", approximate_result.error());
+
+  auto exact = GetCentrality(g, "exact");
+  auto approximate = GetCentrality(g, "approximate");
+  // The bound holds with probability 1 - delta; the samples depend only on
+  // the seed, so the test is not flaky
+  double bound = kEpsilon * kNumNodes * (kNumNodes - 1);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(approximate->Value(n) - exact->Value(n)) <= bound,
+        "node {}: estimate {} exact {}", n, approximate->Value(n),
+        exact->Value(n));
+  }
+
+  // The same seed gives the same estimates
+  auto again_result = BetweennessCentrality(
+      g, "again", katana::analytics::kBetweennessCentralityAllNodes, plan);
+  KATANA_LOG_VASSERT(again_result, "{}", again_result.error());
+  auto again = GetCentrality(g, "again");
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(again->Value(n) == approximate->Value(n));
+  }
+}
+
+void
+TestInvalid(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      g, "zero-epsilon", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Approximate(0)));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      g, "one-delta", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Approximate(kEpsilon, 1)));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      g, "some-sources", uint32_t{10},
+      BetweennessCentralityPlan::Approximate()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  TestApproximate(g.get());
+  TestInvalid(g.get());
+
+  return 0;
+}
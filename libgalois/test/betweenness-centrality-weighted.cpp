@@ -0,0 +1,201 @@
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+namespace {
+
+using katana::analytics::BetweennessCentrality;
+using katana::analytics::BetweennessCentralityPlan;
+
+constexpr size_t kNumNodes = 300;
+
+/// Give g unit weights, integer weights in [1, 4], the same integer weights
+/// halved as doubles, and integer weights with a zero, and return the integer
+/// weights by edge
+std::vector<int64_t>
+AddWeights(katana::PropertyGraph* g) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> int_dist(1, 4);
+  std::vector<uint32_t> ones(g->num_edges(), 1);
+  std::vector<int64_t> int_weights(g->num_edges());
+  std::vector<double> real_weights(g->num_edges());
+  for (size_t e = 0; e < g->num_edges(); ++e) {
+    int_weights[e] = int_dist(gen);
+    real_weights[e] = int_weights[e] * 0.5;
+  }
+  std::vector<int64_t> zero_weights = int_weights;
+  zero_weights[g->num_edges() / 2] = 0;
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("one", arrow::uint32()),
+           arrow::field("int_weight", arrow::int64()),
+           arrow::field("real_weight", arrow::float64()),
+           arrow::field("zero_weight", arrow::int64())}),
+      {katana::BuildArray(ones), katana::BuildArray(int_weights),
+       katana::BuildArray(real_weights), katana::BuildArray(zero_weights)})));
+  return int_weights;
+}
+
+/// Serial Dijkstra and Brandes from each of sources
+std::vector<double>
+ReferenceBC(
+    const katana::PropertyGraph& g, const std::vector<int64_t>& weights,
+    const std::vector<uint32_t>& sources) {
+  const auto& topology = g.topology();
+  size_t num_nodes = topology.num_nodes();
+  std::vector<double> bc(num_nodes, 0);
+  for (uint32_t source : sources) {
+    std::vector<int64_t> dist(num_nodes, std::numeric_limits<int64_t>::max());
+    std::vector<double> sigma(num_nodes, 0);
+    std::vector<double> delta(num_nodes, 0);
+    std::vector<uint32_t> order;
+
+    using Item = std::pair<int64_t, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    dist[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty()) {
+      auto [d, n] = queue.top();
+      queue.pop();
+      if (d > dist[n]) {
+        continue;
+      }
+      order.emplace_back(n);
+      for (auto e : topology.edges(n)) {
+        uint32_t dest = topology.edge_dest(e);
+        if (d + weights[e] < dist[dest]) {
+          dist[dest] = d + weights[e];
+          queue.emplace(dist[dest], dest);
+        }
+      }
+    }
+
+    sigma[source] = 1;
+    for (uint32_t n : order) {
+      for (auto e : topology.edges(n)) {
+        uint32_t dest = topology.edge_dest(e);
+        if (dist[n] + weights[e] == dist[dest]) {
+          sigma[dest] += sigma[n];
+        }
+      }
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      uint32_t n = *it;
+      for (auto e : topology.edges(n)) {
+        uint32_t dest = topology.edge_dest(e);
+        if (dist[n] + weights[e] == dist[dest]) {
+          delta[n] += sigma[n] / sigma[dest] * (1 + delta[dest]);
+        }
+      }
+      if (n != source) {
+        bc[n] += delta[n];
+      }
+    }
+  }
+  return bc;
+}
+
+std::shared_ptr<arrow::FloatArray>
+GetCentrality(katana::PropertyGraph* g, const std::string& name) {
+  auto result = g->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  return result.value();
+}
+
+void
+AssertClose(
+    const std::vector<double>& expected,
+    const std::shared_ptr<arrow::FloatArray>& actual) {
+  for (size_t n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(actual->Value(n) - expected[n]) <=
+            1e-3 * std::max(1.0, expected[n]),
+        "node {}: got {} expected {}", n, actual->Value(n), expected[n]);
+  }
+}
+
+void
+TestWeighted(katana::PropertyGraph* g, const std::vector<int64_t>& weights) {
+  std::vector<uint32_t> all(g->num_nodes());
+  std::iota(all.begin(), all.end(), 0);
+  std::vector<double> expected = ReferenceBC(*g, weights, all);
+
+  for (const std::string& property : {"int_weight", "real_weight"}) {
+    // A small step exercises many delta-stepping buckets
+    for (unsigned step_shift : {0u, 13u}) {
+      std::string output = property + "-" + std::to_string(step_shift);
+      auto result = BetweennessCentrality(
+          g, output, katana::analytics::kBetweennessCentralityAllNodes,
+          BetweennessCentralityPlan::Weighted(property, step_shift));
+      KATANA_LOG_VASSERT(result, "{}", result.error());
+      AssertClose(expected, GetCentrality(g, output));
+    }
+  }
+
+  std::vector<uint32_t> some{0, 7, 42, 99};
+  auto result = BetweennessCentrality(
+      g, "some-sources", some,
+      BetweennessCentralityPlan::Weighted("int_weight"));
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  AssertClose(ReferenceBC(*g, weights, some), GetCentrality(g, "some-sources"));
+}
+
+/// With unit weights the centralities are those of the unweighted algorithm
+void
+TestUnitWeights(katana::PropertyGraph* g) {
+  auto level_result = BetweennessCentrality(
+      g, "level", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Level());
+  KATANA_LOG_VASSERT(level_result, "{}", level_result.error());
+  auto unit_result = BetweennessCentrality(
+      g, "unit", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Weighted("one"));
+  KATANA_LOG_VASSERT(unit_result, "{}", unit_result.error());
+
+  auto level = GetCentrality(g, "level");
+  std::vector<double> expected(g->num_nodes());
+  for (size_t n = 0; n < expected.size(); ++n) {
+    expected[n] = level->Value(n);
+  }
+  AssertClose(expected, GetCentrality(g, "unit"));
+}
+
+void
+TestInvalid(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      g, "zero", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Weighted("zero_weight")));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      g, "missing", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Weighted("no_such_weight")));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::vector<int64_t> weights = AddWeights(g.get());
+
+  TestWeighted(g.get(), weights);
+  TestUnitWeights(g.get());
+  TestInvalid(g.get());
+
+  return 0;
+}
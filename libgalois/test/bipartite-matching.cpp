@@ -0,0 +1,151 @@
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+namespace {
+
+using katana::analytics::BipartiteMatchingPlan;
+using katana::analytics::BipartiteMatchingStatistics;
+
+constexpr uint32_t kNumLeft = 1 << 14;
+constexpr uint32_t kNumRight = 1 << 13;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    const std::vector<std::vector<uint32_t>>& neighbors,
+    std::vector<double> weights) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& n : neighbors) {
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::float64())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+/// Three left nodes and three right nodes where matching the first edge of
+/// every left node in turn leaves one unmatched
+std::unique_ptr<katana::PropertyGraph>
+MakeSmallGraph() {
+  return MakeGraph(
+      {{3, 4}, {3}, {4, 5}, {}, {}, {}}, {1.0, 1.0, 1.0, 1.0, 1.0});
+}
+
+/// Make a random bipartite graph with more left nodes than right nodes, many
+/// left nodes of degree one and some parallel edges
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> right(
+      kNumLeft, kNumLeft + kNumRight - 1);
+  std::uniform_int_distribution<uint32_t> degree(0, 4);
+  std::uniform_real_distribution<double> weight(-0.25, 1.0);
+
+  std::vector<std::vector<uint32_t>> neighbors(kNumLeft + kNumRight);
+  std::vector<double> weights;
+  for (uint32_t n = 0; n < kNumLeft; ++n) {
+    uint32_t d = n % 3 == 0 ? 1 : degree(gen);
+    for (uint32_t i = 0; i < d; ++i) {
+      neighbors[n].emplace_back(right(gen));
+      weights.emplace_back(weight(gen));
+    }
+    if (n % 64 == 1 && d > 0) {
+      neighbors[n].emplace_back(neighbors[n].front());
+      weights.emplace_back(weight(gen));
+    }
+  }
+  return MakeGraph(neighbors, weights);
+}
+
+/// Run every cardinality plan on g and check that they all find a maximum
+/// matching; return its size
+uint64_t
+TestBipartiteMatching(katana::PropertyGraph* g) {
+  std::vector<uint64_t> sizes;
+  for (const auto& plan :
+       {BipartiteMatchingPlan::PothenFan(),
+        BipartiteMatchingPlan::PothenFan(false)}) {
+    auto result = katana::analytics::BipartiteMatching(g, "matched", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    auto valid_result =
+        katana::analytics::BipartiteMatchingAssertValid(g, "matched");
+    KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+    auto stats_result = BipartiteMatchingStatistics::Compute(g, "matched");
+    KATANA_LOG_ASSERT(stats_result);
+    sizes.emplace_back(stats_result.value().matching_size);
+
+    KATANA_LOG_ASSERT(g->RemoveEdgeProperty("matched"));
+  }
+
+  for (uint64_t size : sizes) {
+    KATANA_LOG_VASSERT(
+        size == sizes[0], "matching size {} expected {}", size, sizes[0]);
+  }
+  return sizes[0];
+}
+
+void
+TestWeightedBipartiteMatching(katana::PropertyGraph* g) {
+  auto result =
+      katana::analytics::WeightedBipartiteMatching(g, "weight", "matched");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid_result = katana::analytics::WeightedBipartiteMatchingAssertValid(
+      g, "weight", "matched");
+  KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+  KATANA_LOG_ASSERT(g->RemoveEdgeProperty("matched"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> small = MakeSmallGraph();
+  std::unique_ptr<katana::PropertyGraph> random = MakeRandomGraph();
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+
+    uint64_t size = TestBipartiteMatching(small.get());
+    KATANA_LOG_VASSERT(size == 3, "matching size {} expected 3", size);
+    TestBipartiteMatching(random.get());
+
+    TestWeightedBipartiteMatching(small.get());
+    TestWeightedBipartiteMatching(random.get());
+  }
+
+  // Plans are specific to the cardinality or the weighted matching
+  KATANA_LOG_ASSERT(!katana::analytics::BipartiteMatching(
+      random.get(), "matched", BipartiteMatchingPlan::Suitor()));
+  KATANA_LOG_ASSERT(!katana::analytics::WeightedBipartiteMatching(
+      random.get(), "weight", "matched", BipartiteMatchingPlan::PothenFan()));
+
+  // An edge into a node with out-edges
+  std::unique_ptr<katana::PropertyGraph> not_bipartite =
+      MakeGraph({{1}, {2}, {}}, {1.0, 1.0});
+  KATANA_LOG_ASSERT(
+      !katana::analytics::BipartiteMatching(not_bipartite.get(), "matched"));
+
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include <cmath>
+#include <queue>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/closeness_centrality/closeness_centrality.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::ClosenessCentralityPlan;
+
+/// Node i has edges to i + 1 and i + step (mod num_nodes) and node
+/// num_nodes has none, so it is not reached and reaches nothing.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(Node num_nodes, Node step) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (Node n = 0; n < num_nodes; ++n) {
+    dests.emplace_back((n + 1) % num_nodes);
+    dests.emplace_back((n + step) % num_nodes);
+    indices.emplace_back(dests.size());
+  }
+  indices.emplace_back(dests.size());
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  return g;
+}
+
+/// Closeness and harmonic centrality from a BFS from every node
+void
+Reference(
+    const katana::PropertyGraph& g, std::vector<double>* closeness,
+    std::vector<double>* harmonic) {
+  const katana::GraphTopology& topology = g.topology();
+  size_t num_nodes = g.num_nodes();
+  std::vector<uint64_t> reached(num_nodes);
+  std::vector<uint64_t> distances(num_nodes);
+  harmonic->assign(num_nodes, 0);
+  for (Node src = 0; src < num_nodes; ++src) {
+    std::vector<uint64_t> dist(num_nodes, UINT64_MAX);
+    std::queue<Node> queue;
+    dist[src] = 0;
+    queue.push(src);
+    while (!queue.empty()) {
+      Node n = queue.front();
+      queue.pop();
+      if (n != src) {
+        reached[n] += 1;
+        distances[n] += dist[n];
+        (*harmonic)[n] += 1.0 / dist[n];
+      }
+      for (auto e : topology.edges(n)) {
+        Node dest = topology.edge_dest(e);
+        if (dist[dest] == UINT64_MAX) {
+          dist[dest] = dist[n] + 1;
+          queue.push(dest);
+        }
+      }
+    }
+  }
+  closeness->assign(num_nodes, 0);
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (distances[n] != 0) {
+      double r = reached[n];
+      (*closeness)[n] = r / distances[n] * r / (num_nodes - 1);
+    }
+  }
+}
+
+std::vector<double>
+Values(const katana::PropertyGraph& g, const std::string& name) {
+  auto values_res = g.GetNodePropertyTyped<double>(name);
+  KATANA_LOG_VASSERT(values_res, "{}", values_res.error());
+  auto values = values_res.value();
+  return {values->raw_values(), values->raw_values() + values->length()};
+}
+
+void
+TestExact() {
+  // More than one batch of sources
+  auto g = MakeGraph(100, 7);
+  std::vector<double> closeness;
+  std::vector<double> harmonic;
+  Reference(*g, &closeness, &harmonic);
+
+  KATANA_LOG_ASSERT(katana::analytics::ClosenessCentrality(g.get(), "c"));
+  KATANA_LOG_ASSERT(katana::analytics::HarmonicCentrality(g.get(), "h"));
+  std::vector<double> c = Values(*g, "c");
+  std::vector<double> h = Values(*g, "h");
+  for (Node n = 0; n < g->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(c[n] - closeness[n]) < 1e-9, "node {}: {} not {}", n, c[n],
+        closeness[n]);
+    KATANA_LOG_VASSERT(
+        std::abs(h[n] - harmonic[n]) < 1e-9, "node {}: {} not {}", n, h[n],
+        harmonic[n]);
+  }
+  KATANA_LOG_ASSERT(c.back() == 0 && h.back() == 0);
+
+  auto stats_res =
+      katana::analytics::ClosenessCentralityStatistics::Compute(g.get(), "c");
+  KATANA_LOG_ASSERT(stats_res);
+  KATANA_LOG_ASSERT(stats_res.value().min_centrality == 0);
+
+  // The output property may not exist yet
+  KATANA_LOG_ASSERT(!katana::analytics::ClosenessCentrality(g.get(), "c"));
+}
+
+void
+TestSampled() {
+  auto g = MakeGraph(1000, 31);
+  std::vector<double> closeness;
+  std::vector<double> harmonic;
+  Reference(*g, &closeness, &harmonic);
+
+  auto plan = ClosenessCentralityPlan::Sampled(0.2);
+  KATANA_LOG_ASSERT(katana::analytics::ClosenessCentrality(g.get(), "c", plan));
+  KATANA_LOG_ASSERT(katana::analytics::HarmonicCentrality(g.get(), "h", plan));
+  std::vector<double> c = Values(*g, "c");
+  std::vector<double> h = Values(*g, "h");
+  for (Node n = 0; n + 1 < g->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(c[n] - closeness[n]) < 0.3 * closeness[n],
+        "node {}: {} not {}", n, c[n], closeness[n]);
+    KATANA_LOG_VASSERT(
+        std::abs(h[n] - harmonic[n]) < 0.3 * harmonic[n],
+        "node {}: {} not {}", n, h[n], harmonic[n]);
+  }
+
+  plan.set_deterministic(true);
+  KATANA_LOG_ASSERT(!katana::analytics::HarmonicCentrality(g.get(), "d", plan));
+  KATANA_LOG_ASSERT(!katana::analytics::HarmonicCentrality(
+      g.get(), "e", ClosenessCentralityPlan::Sampled(0)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestExact();
+  TestSampled();
+
+  return 0;
+}
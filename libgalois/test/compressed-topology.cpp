@@ -0,0 +1,104 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/CompressedGraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+
+void
+TestCodec(const katana::GraphTopology& topology) {
+  for (auto encoding :
+       {tsuba::TopologyEncoding::kVarint,
+        tsuba::TopologyEncoding::kBitPacked}) {
+    for (uint64_t nodes_per_block : {1, 16, 1000}) {
+      auto res = katana::CompressedGraphTopology::Make(
+          topology, encoding, nodes_per_block);
+      KATANA_LOG_ASSERT(res);
+      const katana::CompressedGraphTopology& compressed = res.value();
+
+      KATANA_LOG_ASSERT(compressed.num_nodes() == topology.num_nodes());
+      KATANA_LOG_ASSERT(compressed.num_edges() == topology.num_edges());
+
+      for (auto n : topology) {
+        auto edges = topology.edges(n);
+        KATANA_LOG_ASSERT(
+            compressed.edges(n).begin() == edges.begin() &&
+            compressed.edges(n).end() == edges.end());
+        auto e = edges.begin();
+        for (auto dest : compressed.OutDests(n)) {
+          KATANA_LOG_ASSERT(e != edges.end());
+          KATANA_LOG_VASSERT(
+              dest == topology.edge_dest(*e), "node {} edge {}", n, *e);
+          ++e;
+        }
+        KATANA_LOG_ASSERT(e == edges.end());
+      }
+
+      auto decompressed = compressed.Decompress();
+      KATANA_LOG_ASSERT(decompressed);
+      KATANA_LOG_ASSERT(decompressed.value().Equals(topology));
+    }
+  }
+}
+
+void
+TestRoundTrip() {
+  LinePolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+  g->set_topology_encoding(tsuba::TopologyEncoding::kBitPacked);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/compressedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, "compressed-topology"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_res) {
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+
+  KATANA_LOG_ASSERT(make_res.value()->topology().Equals(g->topology()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Sorted, short deltas; compresses well
+  LinePolicy line{8};
+  auto line_graph = MakeFileGraph<uint32_t>(kNumNodes, 1, &line);
+  TestCodec(line_graph->topology());
+
+  auto res = katana::CompressedGraphTopology::Make(
+      line_graph->topology(), tsuba::TopologyEncoding::kVarint);
+  KATANA_LOG_ASSERT(res);
+  uint64_t uncompressed_size = line_graph->num_nodes() * sizeof(uint64_t) +
+                               line_graph->num_edges() * sizeof(uint32_t);
+  KATANA_LOG_VASSERT(
+      res.value().size_bytes() < uncompressed_size, "compressed {} raw {}",
+      res.value().size_bytes(), uncompressed_size);
+
+  // Unsorted, with repeated destinations
+  RandomPolicy random{8};
+  auto random_graph = MakeFileGraph<uint32_t>(kNumNodes, 1, &random);
+  TestCodec(random_graph->topology());
+
+  TestRoundTrip();
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <functional>
+#include <map>
+
+#include "katana/ConcurrentHashMap.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 20;
+constexpr uint32_t kNumKeys = 5000;
+
+/// Keys are skewed towards small values, like the sizes of communities
+uint32_t
+KeyOf(uint64_t i) {
+  return (i * i) % kNumKeys;
+}
+
+std::map<uint32_t, uint64_t>
+ExpectedSums() {
+  std::map<uint32_t, uint64_t> expected;
+  for (uint64_t i = 0; i < kNumItems; ++i) {
+    expected[KeyOf(i)] += i;
+  }
+  return expected;
+}
+
+template <typename Map>
+void
+CheckSums(const Map& map, const std::map<uint32_t, uint64_t>& expected) {
+  KATANA_LOG_ASSERT(map.size() == expected.size());
+  for (const auto& [key, sum] : expected) {
+    auto value = map.Find(key);
+    KATANA_LOG_VASSERT(value && *value == sum, "key {}", key);
+  }
+  KATANA_LOG_ASSERT(!map.Find(kNumKeys));
+
+  uint64_t visited = 0;
+  map.ForEach(
+      [&](uint32_t key, uint64_t value) {
+        KATANA_LOG_ASSERT(expected.at(key) == value);
+        ++visited;
+      },
+      false);
+  KATANA_LOG_ASSERT(visited == expected.size());
+}
+
+void
+TestConcurrentHashMap() {
+  auto expected = ExpectedSums();
+  katana::ConcurrentHashMap<uint32_t, uint64_t> map(kNumKeys);
+  KATANA_LOG_ASSERT(map.capacity() >= 2 * kNumKeys);
+
+  katana::do_all(katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+    KATANA_LOG_ASSERT(map.Update(KeyOf(i), i, std::plus<uint64_t>()));
+  });
+  CheckSums(map, expected);
+
+  map.Clear();
+  KATANA_LOG_ASSERT(map.size() == 0 && !map.Find(0));
+
+  // A full map rejects new keys but still updates the ones it has
+  katana::ConcurrentHashMap<uint32_t, uint64_t> small(1);
+  for (uint32_t key = 0; key < small.capacity(); ++key) {
+    KATANA_LOG_ASSERT(small.Update(key, 1, std::plus<uint64_t>()));
+  }
+  KATANA_LOG_ASSERT(!small.Update(small.capacity(), 1, std::plus<uint64_t>()));
+  KATANA_LOG_ASSERT(small.Update(0, 1, std::plus<uint64_t>()));
+  KATANA_LOG_ASSERT(*small.Find(0) == 2);
+}
+
+void
+TestReducibleHashMap() {
+  auto expected = ExpectedSums();
+  katana::ReducibleHashMap<
+      uint32_t, uint64_t, std::plus<uint64_t>,
+      katana::identity_value_zero<uint64_t>>
+      sums(kNumKeys);
+  katana::do_all(katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+    sums.update(KeyOf(i), i);
+  });
+  CheckSums(sums.reduce(), expected);
+
+  sums.reset();
+  KATANA_LOG_ASSERT(sums.reduce().size() == 0);
+
+  katana::ReducibleHashMap<
+      uint32_t, uint64_t, katana::gmax<uint64_t>,
+      katana::identity_value_min<uint64_t>>
+      maxima(kNumKeys);
+  katana::do_all(katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+    maxima.update(KeyOf(i), i);
+  });
+  auto& reduced = maxima.reduce();
+  for (uint64_t i = kNumItems - kNumKeys; i < kNumItems; ++i) {
+    KATANA_LOG_ASSERT(*reduced.Find(KeyOf(i)) >= i);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(8);
+
+  TestConcurrentHashMap();
+  TestReducibleHashMap();
+
+  return 0;
+}
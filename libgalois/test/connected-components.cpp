@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+namespace {
+
+using katana::analytics::ConnectedComponentsPlan;
+using katana::analytics::IncrementalConnectedComponents;
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumNodes = 1 << 14;
+
+/// Make a symmetric graph with one large component, a few small ones and
+/// some isolated nodes, plus the edges extra in both directions
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Edges& extra = {}) {
+  std::mt19937 gen(0);
+  std::vector<std::vector<uint32_t>> neighbors(kNumNodes);
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    neighbors[a].emplace_back(b);
+    neighbors[b].emplace_back(a);
+  };
+  // Nodes with id % 16 == 0 are isolated; the others are joined within
+  // groups of their id % 4, with group 1 much denser than the rest
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes / 16 - 1);
+  for (uint32_t i = 0; i < kNumNodes * 2; ++i) {
+    uint32_t group = i % 4;
+    if (group != 1 && i % 64 != group) {
+      continue;
+    }
+    uint32_t a = node(gen) * 16 + 4 + group;
+    uint32_t b = node(gen) * 16 + 4 + group;
+    add_edge(a, b);
+  }
+  for (const auto& [a, b] : extra) {
+    add_edge(a, b);
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (auto& n : neighbors) {
+    std::sort(n.begin(), n.end());
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// The components of the graph, labeled by their smallest node
+std::vector<uint64_t>
+ReferenceComponents(const katana::PropertyGraph& g) {
+  std::vector<uint64_t> component(g.num_nodes(), g.num_nodes());
+  for (uint32_t root = 0; root < g.num_nodes(); ++root) {
+    if (component[root] != g.num_nodes()) {
+      continue;
+    }
+    std::vector<uint32_t> stack{root};
+    component[root] = root;
+    while (!stack.empty()) {
+      uint32_t n = stack.back();
+      stack.pop_back();
+      for (auto e : g.topology().edges(n)) {
+        uint32_t dest = g.topology().edge_dest(e);
+        if (component[dest] == g.num_nodes()) {
+          component[dest] = root;
+          stack.emplace_back(dest);
+        }
+      }
+    }
+  }
+  return component;
+}
+
+void
+TestAfforest() {
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+  std::vector<uint64_t> expected = ReferenceComponents(*g);
+
+  for (const auto& plan :
+       {ConnectedComponentsPlan::Afforest(),
+        ConnectedComponentsPlan::EdgeAfforest(),
+        ConnectedComponentsPlan::EdgeTiledAfforest(16)}) {
+    auto result = katana::analytics::ConnectedComponents(g.get(), "cc", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    KATANA_LOG_ASSERT(
+        katana::analytics::ConnectedComponentsAssertValid(g.get(), "cc"));
+
+    // The Afforest algorithms label each component by its smallest node
+    auto column = g->GetNodeProperty("cc");
+    KATANA_LOG_ASSERT(column->num_chunks() == 1);
+    const auto& labels =
+        static_cast<const arrow::UInt64Array&>(*column->chunk(0));
+    for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          labels.Value(n) == expected[n], "node {}: {} != {}", n,
+          labels.Value(n), expected[n]);
+    }
+
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("cc"));
+  }
+}
+
+/// The values of node property name
+const arrow::UInt64Array&
+Labels(const katana::PropertyGraph& g, const std::string& name) {
+  auto column = g.GetNodeProperty(name);
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  return static_cast<const arrow::UInt64Array&>(*column->chunk(0));
+}
+
+void
+TestIncremental() {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::vector<Edges> batches(3);
+  Edges all;
+  for (auto& batch : batches) {
+    for (int i = 0; i < 20; ++i) {
+      batch.emplace_back(node(gen), node(gen));
+    }
+    all.insert(all.end(), batch.begin(), batch.end());
+  }
+
+  for (const auto& plan :
+       {ConnectedComponentsPlan::Afforest(),
+        ConnectedComponentsPlan::Asynchronous()}) {
+    std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+    auto make_res = IncrementalConnectedComponents::Make(g.get(), "cc", plan);
+    KATANA_LOG_VASSERT(make_res, "{}", make_res.error());
+    IncrementalConnectedComponents& components = make_res.value();
+    KATANA_LOG_ASSERT(components.compressed());
+
+    Edges inserted;
+    for (const auto& batch : batches) {
+      KATANA_LOG_ASSERT(components.InsertEdges(batch));
+      inserted.insert(inserted.end(), batch.begin(), batch.end());
+      std::vector<uint64_t> expected =
+          ReferenceComponents(*MakeGraph(inserted));
+      for (uint32_t n = 0; n < kNumNodes; n += 97) {
+        KATANA_LOG_ASSERT(components.Component(n) == expected[n]);
+      }
+
+      components.Compress();
+      KATANA_LOG_ASSERT(components.compressed());
+      const auto& labels = Labels(*g, "cc");
+      for (uint32_t n = 0; n < kNumNodes; ++n) {
+        KATANA_LOG_VASSERT(
+            labels.Value(n) == expected[n], "node {}: {} != {}", n,
+            labels.Value(n), expected[n]);
+      }
+    }
+
+    // An uncompressed forest is picked up again as it is
+    KATANA_LOG_ASSERT(components.InsertEdges({{0, kNumNodes - 1}}));
+    auto again_res = IncrementalConnectedComponents::Make(g.get(), "cc");
+    KATANA_LOG_VASSERT(again_res, "{}", again_res.error());
+    KATANA_LOG_ASSERT(
+        again_res.value().Component(kNumNodes - 1) ==
+        components.Component(0));
+
+    KATANA_LOG_ASSERT(!components.InsertEdges({{0, kNumNodes}}));
+  }
+
+  // Labels that are not nodes cannot be a forest
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(
+      g.get(), "cc", ConnectedComponentsPlan::Asynchronous()));
+  KATANA_LOG_ASSERT(!IncrementalConnectedComponents::Make(g.get(), "cc"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestAfforest();
+  TestIncremental();
+
+  return 0;
+}
@@ -0,0 +1,200 @@
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "katana/analytics/contraction_hierarchy/contraction_hierarchy.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+using Node = katana::GraphTopology::Node;
+using katana::analytics::ContractionHierarchy;
+
+constexpr Node kSide = 20;
+constexpr Node kNumNodes = kSide * kSide + 1;
+
+/// A kSide x kSide grid whose horizontal edges go both ways and whose
+/// vertical edges only go down in even columns, plus a node that is not
+/// connected. Edge "weight"s are pseudo-random in [1, 100].
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    Node row = n / kSide;
+    Node col = n % kSide;
+    if (row < kSide) {
+      std::vector<Node> neighbors;
+      if (col > 0) {
+        neighbors.emplace_back(n - 1);
+      }
+      if (col + 1 < kSide) {
+        neighbors.emplace_back(n + 1);
+      }
+      if (row > 0 && col % 2 == 1) {
+        neighbors.emplace_back(n - kSide);
+      }
+      if (row + 1 < kSide) {
+        neighbors.emplace_back(n + kSide);
+      }
+      for (Node d : neighbors) {
+        dests.emplace_back(d);
+        weights.emplace_back((n * 7919 + d * 104729) % 100 + 1);
+      }
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+/// Dijkstra from source over all edges
+std::vector<double>
+Reference(const katana::PropertyGraph& g, Node source) {
+  const katana::GraphTopology& topology = g.topology();
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      g.GetEdgeProperty("weight")->chunk(0));
+  std::vector<double> distance(g.num_nodes(), ContractionHierarchy::kInfinity);
+  using Entry = std::pair<double, Node>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+  distance[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > distance[n]) {
+      continue;
+    }
+    for (auto e : topology.edges(n)) {
+      Node dest = topology.edge_dest(e);
+      if (d + weights->Value(e) < distance[dest]) {
+        distance[dest] = d + weights->Value(e);
+        queue.emplace(distance[dest], dest);
+      }
+    }
+  }
+  return distance;
+}
+
+/// The weight of the path if its consecutive nodes are joined by edges
+double
+PathWeight(const katana::PropertyGraph& g, const std::vector<uint32_t>& path) {
+  const katana::GraphTopology& topology = g.topology();
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      g.GetEdgeProperty("weight")->chunk(0));
+  double weight = 0;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    double lightest = ContractionHierarchy::kInfinity;
+    for (auto e : topology.edges(path[i])) {
+      if (topology.edge_dest(e) == path[i + 1]) {
+        lightest = std::min<double>(lightest, weights->Value(e));
+      }
+    }
+    KATANA_LOG_VASSERT(
+        lightest != ContractionHierarchy::kInfinity, "no edge {} -> {}",
+        path[i], path[i + 1]);
+    weight += lightest;
+  }
+  return weight;
+}
+
+void
+CheckQueries(const katana::PropertyGraph& g, const ContractionHierarchy& ch) {
+  ContractionHierarchy::Query query(ch);
+  for (Node source = 0; source < kNumNodes; source += 13) {
+    std::vector<double> expected = Reference(g, source);
+    for (Node target = 0; target < kNumNodes; ++target) {
+      double distance = ch.Distance(source, target, &query);
+      KATANA_LOG_VASSERT(
+          distance == expected[target], "{} -> {}: {} not {}", source, target,
+          distance, expected[target]);
+
+      auto path = ch.ShortestPath(source, target, &query);
+      KATANA_LOG_ASSERT(path.weight == expected[target]);
+      if (expected[target] == ContractionHierarchy::kInfinity) {
+        KATANA_LOG_ASSERT(path.nodes.empty());
+        continue;
+      }
+      KATANA_LOG_ASSERT(path.nodes.front() == source);
+      KATANA_LOG_ASSERT(path.nodes.back() == target);
+      KATANA_LOG_ASSERT(PathWeight(g, path.nodes) == expected[target]);
+    }
+  }
+}
+
+void
+TestQueries() {
+  auto g = MakeGraph();
+  for (uint32_t limit : {1U, 500U}) {
+    auto ch_res = ContractionHierarchy::Build(
+        g.get(), "weight",
+        katana::analytics::ContractionHierarchyPlan::IndependentSet(limit));
+    KATANA_LOG_VASSERT(ch_res, "{}", ch_res.error());
+    KATANA_LOG_ASSERT(ch_res.value().num_nodes() == kNumNodes);
+    CheckQueries(*g, ch_res.value());
+  }
+
+  KATANA_LOG_ASSERT(!ContractionHierarchy::Build(g.get(), "missing"));
+}
+
+void
+TestStore() {
+  auto g = MakeGraph();
+  auto ch_res = ContractionHierarchy::Build(g.get(), "weight");
+  KATANA_LOG_ASSERT(ch_res);
+  KATANA_LOG_ASSERT(ch_res.value().Store(g.get()));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/contraction-hierarchy");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, "contraction-hierarchy"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir);
+  if (!make_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_res.value());
+
+  // Must read while rdg_dir still exists
+  auto load_res = ContractionHierarchy::Load(*g2);
+  KATANA_LOG_ASSERT(!ContractionHierarchy::Load(*g2, "missing"));
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(load_res, "{}", load_res.error());
+  KATANA_LOG_ASSERT(load_res.value().num_edges() == ch_res.value().num_edges());
+  CheckQueries(*g2, load_res.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestQueries();
+  TestStore();
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Distribution.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+
+using Partitions = std::vector<std::unique_ptr<katana::PropertyGraph>>;
+
+template <typename ArrayType>
+std::shared_ptr<ArrayType>
+Chunk(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  KATANA_LOG_ASSERT(array && array->num_chunks() == 1);
+  return std::static_pointer_cast<ArrayType>(array->chunk(0));
+}
+
+/// A graph whose node_id and edge_id properties are the index of each node
+/// and edge
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::vector<uint64_t> node_ids(g->num_nodes());
+  std::iota(node_ids.begin(), node_ids.end(), 0);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("node_id", arrow::uint64())}),
+      {katana::BuildArray(node_ids)})));
+
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("edge_id", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)})));
+
+  return g;
+}
+
+/// Global IDs of the local nodes in ids
+std::vector<uint64_t>
+GlobalIds(
+    const katana::PropertyGraph& part,
+    const std::shared_ptr<arrow::ChunkedArray>& ids) {
+  auto l2g = Chunk<arrow::UInt64Array>(part.local_to_global_id());
+  auto local = Chunk<arrow::UInt32Array>(ids);
+  std::vector<uint64_t> global;
+  for (int64_t i = 0; i < local->length(); ++i) {
+    global.emplace_back(l2g->Value(local->Value(i)));
+  }
+  return global;
+}
+
+void
+CheckPartitions(
+    const katana::PropertyGraph& g, katana::PartitionPolicy policy,
+    const Partitions& parts) {
+  const katana::GraphTopology& topology = g.topology();
+  uint32_t num_hosts = parts.size();
+  std::vector<uint32_t> edge_count(g.num_edges());
+  uint64_t owned_begin = 0;
+
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    const katana::PropertyGraph& part = *parts[h];
+    const auto& meta = katana::Distribution::partition_metadata(part);
+    KATANA_LOG_ASSERT(meta.policy_id_ == static_cast<uint32_t>(policy));
+    KATANA_LOG_ASSERT(meta.num_global_nodes_ == g.num_nodes());
+    KATANA_LOG_ASSERT(meta.num_global_edges_ == g.num_edges());
+    KATANA_LOG_ASSERT(meta.num_nodes_ == part.num_nodes());
+    KATANA_LOG_ASSERT(meta.num_edges_ == part.num_edges());
+
+    // Masters are a block of nodes following those of the previous host and
+    // mirrors are not owned by this host
+    auto owned = Chunk<arrow::UInt64Array>(part.host_to_owned_global_ids());
+    KATANA_LOG_ASSERT(static_cast<uint32_t>(owned->length()) == 2 * num_hosts);
+    KATANA_LOG_ASSERT(owned->Value(2 * h) == owned_begin);
+    uint64_t owned_end = owned->Value(2 * h + 1);
+    KATANA_LOG_ASSERT(owned_end - owned_begin == meta.num_owned_);
+
+    auto l2g = Chunk<arrow::UInt64Array>(part.local_to_global_id());
+    auto node_ids = Chunk<arrow::UInt64Array>(part.GetNodeProperty("node_id"));
+    KATANA_LOG_ASSERT(
+        static_cast<uint64_t>(l2g->length()) == part.num_nodes());
+    for (uint64_t n = 0; n < part.num_nodes(); ++n) {
+      uint64_t global = l2g->Value(n);
+      bool is_master = global >= owned_begin && global < owned_end;
+      KATANA_LOG_VASSERT(
+          is_master == (n < meta.num_owned_), "host {} node {}", h, n);
+      if (n > 0 && n != meta.num_owned_) {
+        KATANA_LOG_ASSERT(l2g->Value(n - 1) < global);
+      }
+      KATANA_LOG_ASSERT(node_ids->Value(n) == global);
+    }
+
+    auto edge_ids = Chunk<arrow::UInt64Array>(part.GetEdgeProperty("edge_id"));
+    const katana::GraphTopology& local = part.topology();
+    for (auto n : local) {
+      for (auto e : local.edges(n)) {
+        uint64_t global_e = edge_ids->Value(e);
+        KATANA_LOG_ASSERT(global_e < g.num_edges());
+        edge_count[global_e] += 1;
+        KATANA_LOG_ASSERT(
+            topology.edge_dest(global_e) == l2g->Value(local.edge_dest(e)));
+        auto [begin, end] = topology.edge_range(l2g->Value(n));
+        KATANA_LOG_ASSERT(global_e >= begin && global_e < end);
+        if (policy == katana::PartitionPolicy::kOutgoingEdgeCut) {
+          KATANA_LOG_ASSERT(n < meta.num_owned_);
+        }
+      }
+    }
+
+    // The mirrors on h owned by h2 are the masters on h2 mirrored by h
+    const auto& mirror_nodes = katana::Distribution::mirror_nodes(part);
+    KATANA_LOG_ASSERT(mirror_nodes.size() == num_hosts);
+    uint64_t num_mirrors = 0;
+    for (uint32_t h2 = 0; h2 < num_hosts; ++h2) {
+      const auto& masters_on_h2 =
+          katana::Distribution::master_nodes(*parts[h2])[h];
+      KATANA_LOG_VASSERT(
+          GlobalIds(part, mirror_nodes[h2]) ==
+              GlobalIds(*parts[h2], masters_on_h2),
+          "hosts {} and {}", h, h2);
+      num_mirrors += mirror_nodes[h2]->length();
+    }
+    KATANA_LOG_ASSERT(num_mirrors == part.num_nodes() - meta.num_owned_);
+    KATANA_LOG_ASSERT(mirror_nodes[h]->length() == 0);
+
+    owned_begin = owned_end;
+  }
+  KATANA_LOG_ASSERT(owned_begin == g.num_nodes());
+
+  for (uint64_t e = 0; e < g.num_edges(); ++e) {
+    KATANA_LOG_VASSERT(edge_count[e] == 1, "edge {}", e);
+  }
+}
+
+void
+TestPartition(const katana::PropertyGraph& g, const std::string& rdg_dir) {
+  for (auto policy :
+       {katana::PartitionPolicy::kOutgoingEdgeCut,
+        katana::PartitionPolicy::kCartesianVertexCut}) {
+    for (uint32_t num_hosts : {1, 4, 6}) {
+      Partitions parts;
+      for (uint32_t h = 0; h < num_hosts; ++h) {
+        katana::PartitionOptions opts;
+        opts.policy = policy;
+        opts.num_hosts = num_hosts;
+        opts.host_id = h;
+        // Scan in many slices
+        opts.scan_size = 100;
+        auto res = katana::Distribution::MakePartition(rdg_dir, opts);
+        KATANA_LOG_VASSERT(res, "making partition: {}", res.error());
+        parts.emplace_back(std::move(res.value()));
+      }
+      CheckPartitions(g, policy, parts);
+    }
+  }
+
+  katana::PartitionOptions bad;
+  bad.num_hosts = 2;
+  bad.host_id = 2;
+  KATANA_LOG_ASSERT(!katana::Distribution::MakePartition(rdg_dir, bad));
+}
+
+void
+TestRoundTrip(const katana::PropertyGraph& g, const std::string& rdg_dir) {
+  std::vector<std::string> node_properties;
+  katana::PartitionOptions opts;
+  opts.node_properties = &node_properties;
+  auto part_res = katana::Distribution::MakePartition(rdg_dir, opts);
+  KATANA_LOG_ASSERT(part_res);
+  std::unique_ptr<katana::PropertyGraph> part = std::move(part_res.value());
+  KATANA_LOG_ASSERT(part->GetNodePropertyNum() == 0);
+  KATANA_LOG_ASSERT(part->topology().Equals(g.topology()));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/distribution");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string part_dir(uri_res.value().path());  // path() because local
+  if (auto res = part->Write(part_dir, "distribution"); !res) {
+    fs::remove_all(part_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_res =
+      katana::PropertyGraph::Make(part_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(part_dir);
+  if (!make_res) {
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+  const katana::PropertyGraph& loaded = *make_res.value();
+  KATANA_LOG_ASSERT(loaded.topology().Equals(g.topology()));
+  KATANA_LOG_ASSERT(
+      katana::Distribution::partition_metadata(loaded).num_owned_ ==
+      g.num_nodes());
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(loaded.local_to_global_id()->length()) ==
+      g.num_nodes());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto g = MakeGraph();
+  auto uri_res = katana::Uri::MakeRand("/tmp/distribution");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, "distribution"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  TestPartition(*g, rdg_dir);
+  TestRoundTrip(*g, rdg_dir);
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr size_t kNumBits = 100003;
+
+katana::DynamicBitset
+MakeBitset(const std::vector<bool>& bits) {
+  katana::DynamicBitset bitset;
+  bitset.resize(bits.size());
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (bits[i]) {
+      bitset.set(i);
+    }
+  }
+  return bitset;
+}
+
+std::vector<bool>
+RandomBits(std::mt19937* gen, double density) {
+  std::bernoulli_distribution dist(density);
+  std::vector<bool> bits(kNumBits);
+  for (size_t i = 0; i < kNumBits; ++i) {
+    bits[i] = dist(*gen);
+  }
+  return bits;
+}
+
+void
+CheckEqual(const katana::DynamicBitset& bitset, const std::vector<bool>& bits) {
+  KATANA_LOG_ASSERT(bitset.size() == bits.size());
+  size_t expected_count = 0;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    KATANA_LOG_ASSERT(bitset.test(i) == bits[i]);
+    expected_count += bits[i];
+  }
+  KATANA_LOG_ASSERT(bitset.count() == expected_count);
+}
+
+void
+TestBulkOperations(std::mt19937* gen) {
+  std::vector<bool> a = RandomBits(gen, 0.3);
+  std::vector<bool> b = RandomBits(gen, 0.6);
+
+  std::vector<bool> expected(kNumBits);
+  auto check = [&](auto op, auto fn) {
+    katana::DynamicBitset bitset = MakeBitset(a);
+    op(&bitset, MakeBitset(b));
+    for (size_t i = 0; i < kNumBits; ++i) {
+      expected[i] = fn(a[i], b[i]);
+    }
+    CheckEqual(bitset, expected);
+  };
+  check(
+      [](auto* x, const auto& y) { x->bitwise_or(y); },
+      [](bool x, bool y) { return x || y; });
+  check(
+      [](auto* x, const auto& y) { x->bitwise_and(y); },
+      [](bool x, bool y) { return x && y; });
+  check(
+      [](auto* x, const auto& y) { x->bitwise_andnot(y); },
+      [](bool x, bool y) { return x && !y; });
+  check(
+      [](auto* x, const auto& y) { x->bitwise_xor(y); },
+      [](bool x, bool y) { return x != y; });
+  check(
+      [](auto* x, const auto&) { x->bitwise_not(); },
+      [](bool x, bool) { return !x; });
+}
+
+void
+TestSetBits(std::mt19937* gen) {
+  for (double density : {0.0, 0.001, 0.5}) {
+    std::vector<bool> bits = RandomBits(gen, density);
+    katana::DynamicBitset bitset = MakeBitset(bits);
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < kNumBits; ++i) {
+      if (bits[i]) {
+        expected.emplace_back(i);
+      }
+    }
+
+    std::vector<size_t> serial;
+    for (size_t i : bitset.SetBits()) {
+      serial.emplace_back(i);
+    }
+    KATANA_LOG_ASSERT(serial == expected);
+
+    katana::InsertBag<size_t> parallel;
+    bitset.ForEachSetBit([&](size_t i) { parallel.push(i); });
+    std::vector<size_t> gathered(parallel.begin(), parallel.end());
+    std::sort(gathered.begin(), gathered.end());
+    KATANA_LOG_ASSERT(gathered == expected);
+
+    std::vector<uint64_t> offsets = bitset.GetOffsets<uint64_t>();
+    KATANA_LOG_ASSERT(std::equal(
+        offsets.begin(), offsets.end(), expected.begin(), expected.end()));
+  }
+
+  // Bits past the size of the bitset are never reported
+  katana::DynamicBitset bitset;
+  bitset.resize(70);
+  bitset.bitwise_not();
+  KATANA_LOG_ASSERT(bitset.count() == 70);
+  KATANA_LOG_ASSERT(bitset.FindNextSetBit(69) == 69);
+  KATANA_LOG_ASSERT(bitset.FindNextSetBit(70) == 70);
+}
+
+void
+TestArrow(std::mt19937* gen) {
+  std::vector<bool> bits = RandomBits(gen, 0.5);
+  katana::DynamicBitset bitset = MakeBitset(bits);
+
+  auto view = bitset.AsArrowView();
+  KATANA_LOG_ASSERT(view->length() == static_cast<int64_t>(kNumBits));
+  for (size_t i = 0; i < kNumBits; ++i) {
+    KATANA_LOG_ASSERT(view->Value(i) == bits[i]);
+  }
+  // The view shares memory with the bitset
+  bitset.set(0);
+  KATANA_LOG_ASSERT(view->Value(0));
+  bits[0] = true;
+
+  // Copying back from an unaligned slice with nulls
+  arrow::BooleanBuilder builder;
+  for (size_t i = 0; i < kNumBits; ++i) {
+    if (i % 7 == 0) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(bits[i]).ok());
+    }
+  }
+  std::shared_ptr<arrow::BooleanArray> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  constexpr size_t kOffset = 3;
+  auto slice = std::static_pointer_cast<arrow::BooleanArray>(
+      array->Slice(kOffset));
+
+  katana::DynamicBitset copy;
+  copy.CopyFromArrow(*slice);
+  std::vector<bool> expected(kNumBits - kOffset);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = (i + kOffset) % 7 != 0 && bits[i + kOffset];
+  }
+  CheckEqual(copy, expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  TestBulkOperations(&gen);
+  TestSetBits(&gen);
+  TestArrow(&gen);
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::DynamicGraph::Node;
+using Batch = std::vector<std::pair<Node, Node>>;
+using EdgeSet = std::set<std::pair<Node, Node>>;
+
+/// The edges of a graph with the interface of GraphTopology
+template <typename Graph>
+EdgeSet
+Edges(const Graph& g) {
+  EdgeSet edges;
+  for (auto n : g) {
+    for (auto e : g.edges(n)) {
+      edges.emplace(n, g.edge_dest(e));
+    }
+  }
+  return edges;
+}
+
+void
+CheckGraph(const katana::DynamicGraph& g, const EdgeSet& expected) {
+  KATANA_LOG_ASSERT(g.num_edges() == expected.size());
+  KATANA_LOG_ASSERT(Edges(g) == expected);
+  // Destinations increase, so there are no parallel edges
+  for (auto n : g) {
+    auto edges = g.edges(n);
+    for (auto e = edges.begin(); e != edges.end(); ++e) {
+      KATANA_LOG_ASSERT(
+          e == edges.begin() || g.edge_dest(*std::prev(e)) < g.edge_dest(*e));
+    }
+  }
+}
+
+Batch
+RandomBatch(std::mt19937* gen, uint64_t num_nodes, size_t size) {
+  // Few sources so that several edges of a batch share a node, including
+  // duplicates within the batch
+  std::uniform_int_distribution<Node> src(0, num_nodes / 10);
+  std::uniform_int_distribution<Node> dest(0, 199);
+  Batch batch;
+  for (size_t i = 0; i < size; ++i) {
+    batch.emplace_back(src(*gen), dest(*gen));
+  }
+  return batch;
+}
+
+void
+TestBatches() {
+  constexpr uint64_t kNumNodes = 5000;
+  std::mt19937 gen(1);
+  katana::DynamicGraph g(kNumNodes);
+  EdgeSet expected;
+
+  for (int round = 0; round < 10; ++round) {
+    Batch insert = RandomBatch(&gen, kNumNodes, 20000);
+    uint64_t num_new = 0;
+    for (const auto& edge : insert) {
+      num_new += expected.emplace(edge).second;
+    }
+    auto insert_res = g.InsertEdges(insert);
+    KATANA_LOG_ASSERT(insert_res && insert_res.value() == num_new);
+    CheckGraph(g, expected);
+
+    Batch remove = RandomBatch(&gen, kNumNodes, 10000);
+    uint64_t num_removed = 0;
+    for (const auto& edge : remove) {
+      num_removed += expected.erase(edge);
+    }
+    auto delete_res = g.DeleteEdges(remove);
+    KATANA_LOG_ASSERT(delete_res && delete_res.value() == num_removed);
+    CheckGraph(g, expected);
+  }
+
+  for (const auto& [src, dest] : expected) {
+    KATANA_LOG_ASSERT(g.HasEdge(src, dest));
+  }
+  KATANA_LOG_ASSERT(!g.HasEdge(kNumNodes - 1, 0));
+
+  // Nodes out of range leave the graph unchanged
+  KATANA_LOG_ASSERT(!g.InsertEdges({{0, 1}, {0, kNumNodes}}));
+  KATANA_LOG_ASSERT(!g.DeleteEdges({{kNumNodes, 0}}));
+  CheckGraph(g, expected);
+
+  g.AddNodes(1);
+  KATANA_LOG_ASSERT(g.num_nodes() == kNumNodes + 1);
+  KATANA_LOG_ASSERT(g.InsertEdges({{kNumNodes, 0}}).value() == 1);
+  expected.emplace(kNumNodes, 0);
+  CheckGraph(g, expected);
+}
+
+void
+TestConversion() {
+  RandomPolicy policy{8};
+  auto pg = MakeFileGraph<uint32_t>(10000, 0, &policy);
+  EdgeSet expected = Edges(pg->topology());
+
+  katana::DynamicGraph g = katana::DynamicGraph::FromTopology(pg->topology());
+  KATANA_LOG_ASSERT(g.num_nodes() == pg->num_nodes());
+  CheckGraph(g, expected);
+
+  KATANA_LOG_ASSERT(g.InsertEdges({{0, 1}, {9999, 0}}));
+  expected.emplace(0, 1);
+  expected.emplace(9999, 0);
+
+  auto pg_res = g.ToPropertyGraph();
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> round_trip =
+      std::move(pg_res.value());
+  KATANA_LOG_ASSERT(round_trip->num_nodes() == g.num_nodes());
+  KATANA_LOG_ASSERT(round_trip->num_edges() == g.num_edges());
+  KATANA_LOG_ASSERT(Edges(round_trip->topology()) == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestBatches();
+  TestConversion();
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/GraphHelpers.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr unsigned kNumThreads = 4;
+
+/// A graph whose degrees grow with the node id, plus hub_degree edges from
+/// node 0, so that blocks of the same number of nodes have very different
+/// numbers of edges
+katana::GraphTopology
+MakeSkewedTopology(Node num_nodes, uint64_t hub_degree) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (Node n = 0; n < num_nodes; ++n) {
+    uint64_t degree = n == 0 ? hub_degree : n / 8;
+    for (uint64_t i = 0; i < degree; ++i) {
+      dests.emplace_back((n + i) % num_nodes);
+    }
+    indices.emplace_back(dests.size());
+  }
+  return katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  };
+}
+
+uint64_t
+EdgesBefore(const katana::GraphTopology& topology, uint64_t n) {
+  return n > 0 ? topology.out_indices->Value(n - 1) : 0;
+}
+
+/// Blocks cover the range in order and none is much heavier than its share
+void
+TestBlocks(const katana::GraphTopology& topology, uint64_t max_degree) {
+  uint64_t num_nodes = topology.num_nodes();
+  for (size_t num_blocks : {1, 3, 7, 64}) {
+    auto blocks = katana::EdgeBalancedBlocks(
+        uint64_t{0}, num_nodes, num_blocks,
+        [&](uint64_t n) { return EdgesBefore(topology, n); });
+    KATANA_LOG_ASSERT(blocks.size() == num_blocks + 1);
+    KATANA_LOG_ASSERT(blocks.front() == 0 && blocks.back() == num_nodes);
+
+    uint64_t share = (topology.num_edges() + num_nodes) / num_blocks;
+    for (size_t i = 0; i < num_blocks; ++i) {
+      KATANA_LOG_ASSERT(blocks[i] <= blocks[i + 1]);
+      uint64_t weight = EdgesBefore(topology, blocks[i + 1]) -
+                        EdgesBefore(topology, blocks[i]) + blocks[i + 1] -
+                        blocks[i];
+      KATANA_LOG_VASSERT(
+          weight <= share + max_degree + 2, "block {} of {} has weight {}", i,
+          num_blocks, weight);
+    }
+  }
+}
+
+/// Every node is visited once, and without stealing the threads get about
+/// the same number of edges
+template <typename... Args>
+void
+TestDoAll(const katana::GraphTopology& topology, Args... args) {
+  std::vector<std::atomic<uint32_t>> visits(topology.num_nodes());
+  std::vector<std::atomic<uint64_t>> thread_edges(kNumThreads);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        visits[n] += 1;
+        thread_edges[katana::ThreadPool::getTID()] += topology.edges(n).size();
+      },
+      katana::edge_balanced(topology), args...);
+  for (const auto& v : visits) {
+    KATANA_LOG_ASSERT(v == 1);
+  }
+
+  if constexpr (sizeof...(args) == 0) {
+    uint64_t share =
+        (topology.num_edges() + topology.num_nodes()) / kNumThreads;
+    uint64_t max_degree = topology.num_nodes() / 8;
+    for (const auto& edges : thread_edges) {
+      KATANA_LOG_VASSERT(
+          edges <= share + max_degree + 2, "{} edges for a share of {}",
+          edges.load(), share);
+    }
+  }
+}
+
+/// Every edge is visited once, and the edges of the hub are split between
+/// threads
+void
+TestForEachEdgeBlock(const katana::GraphTopology& topology) {
+  std::vector<std::atomic<uint32_t>> edge_visits(topology.num_edges());
+  std::vector<std::atomic<uint32_t>> hub_parts(kNumThreads);
+  katana::ForEachEdgeBlock(topology, [&](Node n, uint64_t begin, uint64_t end) {
+    auto edges = topology.edges(n);
+    KATANA_LOG_ASSERT(begin < end);
+    KATANA_LOG_ASSERT(*edges.begin() <= begin && end <= *edges.end());
+    for (uint64_t e = begin; e < end; ++e) {
+      edge_visits[e] += 1;
+    }
+    if (n == 0) {
+      hub_parts[katana::ThreadPool::getTID()] += 1;
+    }
+  });
+  for (const auto& v : edge_visits) {
+    KATANA_LOG_ASSERT(v == 1);
+  }
+  uint32_t num_hub_parts = 0;
+  for (const auto& parts : hub_parts) {
+    KATANA_LOG_ASSERT(parts <= 1);
+    num_hub_parts += parts;
+  }
+  KATANA_LOG_ASSERT(num_hub_parts > 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(kNumThreads);
+
+  // The hub has about half of the edges of hub_topology
+  uint64_t hub_degree = 1000000;
+  katana::GraphTopology topology = MakeSkewedTopology(4000, 0);
+  katana::GraphTopology hub_topology = MakeSkewedTopology(4000, hub_degree);
+  TestBlocks(topology, 4000 / 8);
+  TestBlocks(hub_topology, hub_degree);
+  TestBlocks(MakeSkewedTopology(3, 0), 0);
+
+  TestDoAll(topology);
+  TestDoAll(hub_topology, katana::steal(), katana::chunk_size<16>());
+  TestDoAll(MakeSkewedTopology(2, 0));
+
+  TestForEachEdgeBlock(hub_topology);
+
+  return 0;
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeBlocks.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+using katana::analytics::TriangleCountPlan;
+
+/// Every node links to every node, so that every block has edges
+class CompletePolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(size_t, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      r.emplace_back(i);
+    }
+    return r;
+  }
+};
+
+/// Each node links to the nodes up to width away on either side, which is
+/// symmetric and has triangles
+class CirculantPolicy : public Policy {
+  size_t width_;
+
+public:
+  CirculantPolicy(size_t width) : width_(width) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    for (size_t i = 1; i <= width_; ++i) {
+      r.emplace_back((node_id + i) % num_nodes);
+      r.emplace_back((node_id + num_nodes - i) % num_nodes);
+    }
+    return r;
+  }
+};
+
+/// The list has the edges of the topology, grouped by block and in the order
+/// of the topology within each block, and an index of the blocks by column
+void
+CheckList(
+    const katana::GraphTopology& topology,
+    const katana::HilbertEdgeList& list) {
+  uint32_t bits = list.block_bits;
+  KATANA_LOG_ASSERT(list.num_nodes == topology.num_nodes());
+  KATANA_LOG_ASSERT(list.num_edges() == topology.num_edges());
+
+  std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> expected;
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    for (auto e : topology.edges(n)) {
+      expected.emplace_back(n, topology.edge_dest(e), e);
+    }
+  }
+  std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> actual;
+  std::vector<std::pair<uint64_t, uint64_t>> cells;
+  for (uint64_t b = 0; b < list.num_blocks(); ++b) {
+    auto [begin, end] = list.block_range(b);
+    KATANA_LOG_ASSERT(begin < end);
+    uint64_t row = list.sources[begin] >> bits;
+    uint64_t column = list.dests[begin] >> bits;
+    cells.emplace_back(row, column);
+    for (uint64_t i = begin; i < end; ++i) {
+      KATANA_LOG_ASSERT(list.sources[i] >> bits == row);
+      KATANA_LOG_ASSERT(list.dests[i] >> bits == column);
+      KATANA_LOG_ASSERT(i == begin || list.edges[i] > list.edges[i - 1]);
+      KATANA_LOG_ASSERT(topology.edge_dest(list.edges[i]) == list.dests[i]);
+      actual.emplace_back(list.sources[i], list.dests[i], list.edges[i]);
+    }
+  }
+  std::sort(actual.begin(), actual.end());
+  KATANA_LOG_ASSERT(actual == expected);
+  // Blocks are distinct
+  std::vector<std::pair<uint64_t, uint64_t>> sorted_cells = cells;
+  std::sort(sorted_cells.begin(), sorted_cells.end());
+  KATANA_LOG_ASSERT(
+      std::adjacent_find(sorted_cells.begin(), sorted_cells.end()) ==
+      sorted_cells.end());
+
+  uint64_t num_indexed = 0;
+  for (uint64_t c = 0; c < list.num_columns(); ++c) {
+    auto [begin, end] = list.column_range(c);
+    for (uint64_t j = begin; j < end; ++j) {
+      uint64_t block = list.column_blocks[j];
+      KATANA_LOG_ASSERT(cells[block].second == c);
+      KATANA_LOG_ASSERT(j == begin || block > list.column_blocks[j - 1]);
+      ++num_indexed;
+    }
+  }
+  KATANA_LOG_ASSERT(num_indexed == list.num_blocks());
+}
+
+void
+TestHilbertOrder() {
+  // 32 nodes in blocks of 4 make a complete 8 by 8 grid of blocks, along
+  // which the Hilbert curve moves one block at a time
+  CompletePolicy policy;
+  auto g = MakeFileGraph<uint32_t>(32, 0, &policy);
+  auto list_res = g->OrderEdgesAlongHilbertCurve(2);
+  KATANA_LOG_VASSERT(list_res, "{}", list_res.error());
+  const katana::HilbertEdgeList& list = *list_res.value();
+  CheckList(g->topology(), list);
+  KATANA_LOG_ASSERT(list.num_blocks() == 64);
+  for (uint64_t b = 1; b < list.num_blocks(); ++b) {
+    uint64_t prev = list.block_range(b - 1).first;
+    uint64_t next = list.block_range(b).first;
+    int64_t rows = std::abs(
+        int64_t{list.sources[next] >> 2} - int64_t{list.sources[prev] >> 2});
+    int64_t columns = std::abs(
+        int64_t{list.dests[next] >> 2} - int64_t{list.dests[prev] >> 2});
+    KATANA_LOG_VASSERT(rows + columns == 1, "blocks {} and {}", b - 1, b);
+  }
+  // The curve starts at the first block
+  KATANA_LOG_ASSERT(list.sources[0] < 4 && list.dests[0] < 4);
+
+  // The list is kept with the topology for the same block size
+  KATANA_LOG_ASSERT(g->topology().hilbert_edge_list == list_res.value());
+  KATANA_LOG_ASSERT(
+      g->OrderEdgesAlongHilbertCurve(2).value() == list_res.value());
+  KATANA_LOG_ASSERT(
+      g->OrderEdgesAlongHilbertCurve(3).value() != list_res.value());
+  KATANA_LOG_ASSERT(!g->OrderEdgesAlongHilbertCurve(33));
+}
+
+void
+TestAccumulate() {
+  RandomPolicy policy(5);
+  auto g = MakeFileGraph<uint32_t>(1000, 0, &policy);
+  const katana::GraphTopology& topology = g->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  std::vector<uint64_t> expected_degrees(num_nodes);
+  std::vector<uint64_t> expected_sums(num_nodes);
+  std::vector<uint32_t> expected_maxima(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      uint32_t dest = topology.edge_dest(e);
+      expected_degrees[dest] += 1;
+      expected_sums[dest] += n;
+      expected_maxima[dest] = std::max(expected_maxima[dest], n);
+    }
+  }
+
+  std::vector<double> first_weights;
+  for (uint32_t bits : {0u, 3u, 6u, 16u}) {
+    auto list_res = g->OrderEdgesAlongHilbertCurve(bits);
+    KATANA_LOG_VASSERT(list_res, "{}", list_res.error());
+    const katana::HilbertEdgeList& list = *list_res.value();
+    CheckList(topology, list);
+
+    for (unsigned threads : {1u, 4u}) {
+      katana::setActiveThreads(threads);
+      std::vector<uint64_t> degrees(num_nodes, 7);
+      katana::AccumulateEdgeBlocks<uint64_t>(
+          list, [](uint64_t) { return 1; }, degrees.data());
+      KATANA_LOG_ASSERT(degrees == expected_degrees);
+
+      std::vector<uint64_t> sums(num_nodes);
+      katana::AccumulateEdgeBlocks<uint64_t>(
+          list, [&](uint64_t i) { return list.sources[i]; }, sums.data());
+      KATANA_LOG_ASSERT(sums == expected_sums);
+
+      // Floating point sums come out the same whatever the threads
+      std::vector<double> weights(num_nodes);
+      katana::AccumulateEdgeBlocks<double>(
+          list, [&](uint64_t i) { return 1.0 / (list.sources[i] + 3); },
+          weights.data());
+      if (threads == 1) {
+        first_weights = weights;
+      }
+      KATANA_LOG_ASSERT(weights == first_weights);
+
+      // Other operations and identities
+      std::vector<uint32_t> maxima(num_nodes);
+      katana::AccumulateEdgeBlocks<uint32_t>(
+          list, [&](uint64_t i) { return list.sources[i]; }, maxima.data(),
+          uint32_t{0}, [](uint32_t a, uint32_t b) { return std::max(a, b); });
+      KATANA_LOG_ASSERT(maxima == expected_maxima);
+    }
+  }
+}
+
+void
+TestTriangleCount() {
+  CirculantPolicy policy(4);
+  auto g = MakeFileGraph<uint32_t>(2000, 0, &policy);
+  auto node_res = katana::analytics::TriangleCount(
+      g.get(), TriangleCountPlan::NodeIteration());
+  KATANA_LOG_VASSERT(node_res, "{}", node_res.error());
+  auto edge_res = katana::analytics::TriangleCount(
+      g.get(), TriangleCountPlan::EdgeIteration());
+  KATANA_LOG_VASSERT(edge_res, "{}", edge_res.error());
+  KATANA_LOG_ASSERT(node_res.value() > 0);
+  KATANA_LOG_ASSERT(node_res.value() == edge_res.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestHilbertOrder();
+  TestAccumulate();
+  TestTriangleCount();
+
+  return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeDelta.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edges = std::vector<std::pair<Node, Node>>;
+
+constexpr size_t kNumNodes = 1000;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  // Label each edge with its original id
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+  auto edge_table = arrow::Table::Make(
+      arrow::schema({arrow::field("edge_id", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)});
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(edge_table));
+
+  return g;
+}
+
+/// A few edges from every 7th node, including duplicates and self loops
+Edges
+MakeEdges(Node seed) {
+  Edges edges;
+  for (Node n = 0; n < kNumNodes; n += 7) {
+    for (Node i = 0; i < 3; ++i) {
+      edges.emplace_back(n, (n * (seed + i) + i) % kNumNodes);
+    }
+  }
+  return edges;
+}
+
+void
+AddAll(katana::EdgeDeltaBuilder* builder, const Edges& edges) {
+  katana::do_all(
+      katana::iterate(edges.begin(), edges.end()),
+      [&](const std::pair<Node, Node>& edge) {
+        builder->AddEdge(edge.first, edge.second);
+      });
+}
+
+/// Destinations of the added edges of each node, sorted
+std::vector<std::vector<Node>>
+Expected(const std::vector<Edges>& batches) {
+  std::vector<std::vector<Node>> expected(kNumNodes);
+  for (const Edges& batch : batches) {
+    for (const auto& [src, dest] : batch) {
+      expected[src].emplace_back(dest);
+    }
+  }
+  for (auto& dests : expected) {
+    std::sort(dests.begin(), dests.end());
+  }
+  return expected;
+}
+
+void
+CheckDelta(
+    const katana::EdgeDelta& delta,
+    const std::vector<std::vector<Node>>& expected) {
+  KATANA_LOG_ASSERT(delta.num_nodes() == kNumNodes);
+  uint64_t num_edges = 0;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    auto dests = delta.OutDests(n);
+    KATANA_LOG_VASSERT(
+        std::vector<Node>(dests.begin(), dests.end()) == expected[n],
+        "node {}", n);
+    num_edges += expected[n].size();
+  }
+  KATANA_LOG_ASSERT(delta.num_edges() == num_edges);
+}
+
+void
+TestBuild() {
+  auto g = MakeGraph();
+  const katana::GraphTopology& topology = g->topology();
+  katana::EdgeDeltaBuilder builder(g->num_nodes());
+
+  Edges first = MakeEdges(3);
+  AddAll(&builder, first);
+  auto delta_res = builder.Finish();
+  KATANA_LOG_ASSERT(delta_res);
+  CheckDelta(delta_res.value(), Expected({first}));
+
+  // Later batches are added to the previous delta
+  Edges second = MakeEdges(5);
+  AddAll(&builder, second);
+  auto merged_res = builder.Finish(delta_res.value());
+  KATANA_LOG_ASSERT(merged_res);
+  const katana::EdgeDelta& merged = merged_res.value();
+  auto expected = Expected({first, second});
+  CheckDelta(merged, expected);
+
+  for (Node n = 0; n < kNumNodes; ++n) {
+    std::vector<Node> dests;
+    merged.ForEachDest(topology, n, [&](Node d) { dests.emplace_back(d); });
+    KATANA_LOG_ASSERT(dests.size() == merged.degree(topology, n));
+    auto edges = topology.edges(n);
+    KATANA_LOG_ASSERT(dests.size() == edges.size() + expected[n].size());
+  }
+
+  // Finish empties the batches
+  auto again_res = builder.Finish(merged);
+  KATANA_LOG_ASSERT(again_res);
+  CheckDelta(again_res.value(), expected);
+}
+
+void
+TestOutOfRange() {
+  katana::EdgeDeltaBuilder builder(kNumNodes);
+  builder.AddEdge(0, kNumNodes);
+  KATANA_LOG_ASSERT(!builder.Finish());
+
+  auto empty_res = builder.Finish();
+  KATANA_LOG_ASSERT(empty_res && empty_res.value().empty());
+}
+
+void
+TestApply() {
+  auto original = MakeGraph();
+  auto copy_res = original->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+
+  katana::EdgeDeltaBuilder builder(g->num_nodes());
+  Edges edges = MakeEdges(11);
+  AddAll(&builder, edges);
+  auto delta_res = builder.Finish();
+  KATANA_LOG_ASSERT(delta_res);
+  const katana::EdgeDelta& delta = delta_res.value();
+  auto expected = Expected({edges});
+
+  KATANA_LOG_ASSERT(katana::ApplyEdgeDelta(g.get(), delta));
+
+  const katana::GraphTopology& before = original->topology();
+  const katana::GraphTopology& after = g->topology();
+  KATANA_LOG_ASSERT(after.num_nodes() == before.num_nodes());
+  KATANA_LOG_ASSERT(after.num_edges() == before.num_edges() + edges.size());
+
+  auto property = g->GetEdgeProperty("edge_id");
+  KATANA_LOG_ASSERT(property && property->num_chunks() == 1);
+  auto edge_ids =
+      std::static_pointer_cast<arrow::UInt64Array>(property->chunk(0));
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(edge_ids->length()) == after.num_edges());
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(edge_ids->null_count()) == edges.size());
+
+  for (Node n = 0; n < kNumNodes; ++n) {
+    auto old_edges = before.edges(n);
+    auto new_edges = after.edges(n);
+    KATANA_LOG_ASSERT(
+        new_edges.size() == old_edges.size() + expected[n].size());
+
+    auto e = *new_edges.begin();
+    for (auto old_e : old_edges) {
+      KATANA_LOG_VASSERT(edge_ids->IsValid(e), "edge {}", e);
+      KATANA_LOG_VASSERT(edge_ids->Value(e) == old_e, "edge {}", e);
+      KATANA_LOG_VASSERT(
+          after.edge_dest(e) == before.edge_dest(old_e), "edge {}", e);
+      ++e;
+    }
+    for (Node dest : expected[n]) {
+      KATANA_LOG_VASSERT(edge_ids->IsNull(e), "edge {}", e);
+      KATANA_LOG_VASSERT(after.edge_dest(e) == dest, "edge {}", e);
+      ++e;
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestBuild();
+  TestOutOfRange();
+  TestApply();
+
+  return 0;
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using AdjacencyList = std::vector<std::vector<Node>>;
+
+/// Every node gets a few random neighbors; every 100th node gets enough to
+/// be sorted by all threads together
+class MixedDegreePolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    RandomPolicy random{node_id % 100 == 0 ? 70000 : node_id % 7};
+    return random.GenerateNeighbors(node_id, num_nodes);
+  }
+};
+
+AdjacencyList
+ToAdjacencyList(const katana::GraphTopology& topology) {
+  AdjacencyList list(topology.num_nodes());
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      list[n].emplace_back(topology.edge_dest(e));
+    }
+  }
+  return list;
+}
+
+void
+TestSortAllEdgesByDest(katana::PropertyGraph* g) {
+  AdjacencyList before = ToAdjacencyList(g->topology());
+
+  auto sort_res = katana::SortAllEdgesByDest(g);
+  KATANA_LOG_ASSERT(sort_res);
+  std::shared_ptr<arrow::UInt64Array> permutation = sort_res.value();
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(permutation->length()) == g->num_edges());
+
+  const katana::GraphTopology& topology = g->topology();
+  for (auto n : topology) {
+    auto [begin, end] = topology.edge_range(n);
+    std::vector<Node> sorted = before[n];
+    std::stable_sort(sorted.begin(), sorted.end());
+    for (auto e = begin; e < end; ++e) {
+      KATANA_LOG_VASSERT(
+          topology.edge_dest(e) == sorted[e - begin], "node {} edge {}", n, e);
+      uint64_t old = permutation->Value(e);
+      KATANA_LOG_VASSERT(old >= begin && old < end, "edge {}", e);
+      KATANA_LOG_VASSERT(
+          before[n][old - begin] == topology.edge_dest(e), "edge {}", e);
+    }
+  }
+}
+
+void
+TestSortAllEdgesByType(katana::PropertyGraph* g) {
+  constexpr uint16_t kNumTypes = 5;
+  std::vector<uint16_t> types(g->num_edges());
+  for (size_t e = 0; e < types.size(); ++e) {
+    types[e] = (e * 7919) % kNumTypes;
+  }
+  auto add_res = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("type", arrow::uint16())}),
+      {katana::BuildArray(types)}));
+  KATANA_LOG_ASSERT(add_res);
+
+  // Expected destinations of each node by type
+  std::vector<AdjacencyList> expected(g->num_nodes(), AdjacencyList(kNumTypes));
+  for (auto n : g->topology()) {
+    for (auto e : g->topology().edges(n)) {
+      expected[n][types[e]].emplace_back(g->topology().edge_dest(e));
+    }
+    for (auto& dests : expected[n]) {
+      std::sort(dests.begin(), dests.end());
+    }
+  }
+
+  KATANA_LOG_ASSERT(!g->IndexEdgesByType("type"));
+  KATANA_LOG_ASSERT(!g->IndexEdgesByType("no such property"));
+
+  auto sort_res = katana::SortAllEdgesByType(g, "type");
+  KATANA_LOG_ASSERT(sort_res);
+  const katana::GraphTopology& topology = g->topology();
+  KATANA_LOG_ASSERT(topology.edge_type_index);
+
+  auto sorted_types = g->GetEdgeProperty("type");
+  auto permutation = sort_res.value();
+  for (auto n : topology) {
+    for (uint32_t t = 0; t < kNumTypes + 1; ++t) {
+      std::vector<Node> dests;
+      for (auto e : topology.edges(n, t)) {
+        dests.emplace_back(topology.edge_dest(e));
+        KATANA_LOG_VASSERT(types[permutation->Value(e)] == t, "edge {}", e);
+        auto type = sorted_types->GetScalar(e).ValueOrDie();
+        KATANA_LOG_VASSERT(
+            std::static_pointer_cast<arrow::UInt16Scalar>(type)->value == t,
+            "edge {}", e);
+      }
+      std::vector<Node> none;
+      KATANA_LOG_VASSERT(
+          dests == (t < kNumTypes ? expected[n][t] : none), "node {} type {}",
+          n, t);
+    }
+  }
+
+  // Edges already sorted by type are indexed without sorting
+  KATANA_LOG_ASSERT(g->IndexEdgesByType("type"));
+
+  // Changing the topology drops the index
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(g));
+  KATANA_LOG_ASSERT(!g->topology().edge_type_index);
+}
+
+void
+TestSortAllEdgesByTime(katana::PropertyGraph* g) {
+  constexpr int64_t kFirstTime = -20;
+  constexpr int64_t kNumTimes = 50;
+  std::vector<int64_t> times(g->num_edges());
+  for (size_t e = 0; e < times.size(); ++e) {
+    times[e] = kFirstTime + static_cast<int64_t>((e * 7919) % kNumTimes);
+  }
+  auto add_res = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("time", arrow::int64())}),
+      {katana::BuildArray(times)}));
+  KATANA_LOG_ASSERT(add_res);
+  AdjacencyList before = ToAdjacencyList(g->topology());
+
+  KATANA_LOG_ASSERT(!g->IndexEdgesByTime("time"));
+  KATANA_LOG_ASSERT(!g->IndexEdgesByTime("no such property"));
+
+  auto sort_res = katana::SortAllEdgesByTime(g, "time");
+  KATANA_LOG_ASSERT(sort_res);
+  const katana::GraphTopology& topology = g->topology();
+  KATANA_LOG_ASSERT(topology.edge_time_index);
+  KATANA_LOG_ASSERT(topology.edge_time_index->property == "time");
+
+  auto sorted_times = g->GetEdgeProperty("time");
+  auto permutation = sort_res.value();
+  std::vector<std::pair<int64_t, int64_t>> windows{
+      {kFirstTime, kFirstTime + kNumTimes},
+      {-100, kFirstTime},
+      {0, 1},
+      {-5, 17},
+      {10, 5},
+      {kFirstTime + kNumTimes - 1, 1000}};
+  for (auto n : topology) {
+    auto [begin, end] = topology.edge_range(n);
+    for (auto e = begin; e < end; ++e) {
+      uint64_t old = permutation->Value(e);
+      KATANA_LOG_VASSERT(
+          before[n][old - begin] == topology.edge_dest(e), "edge {}", e);
+      auto time = sorted_times->GetScalar(e).ValueOrDie();
+      KATANA_LOG_VASSERT(
+          std::static_pointer_cast<arrow::Int64Scalar>(time)->value ==
+              times[old],
+          "edge {}", e);
+    }
+    for (auto [begin_time, end_time] : windows) {
+      std::vector<Node> expected;
+      for (auto e = begin; e < end; ++e) {
+        int64_t t = times[permutation->Value(e)];
+        if (t >= begin_time && t < end_time) {
+          expected.emplace_back(topology.edge_dest(e));
+        }
+      }
+      std::vector<Node> dests;
+      int64_t last = begin_time;
+      for (auto e : topology.edges(n, begin_time, end_time)) {
+        int64_t t = times[permutation->Value(e)];
+        KATANA_LOG_VASSERT(t >= last, "edge {} is out of order", e);
+        last = t;
+        dests.emplace_back(topology.edge_dest(e));
+      }
+      KATANA_LOG_VASSERT(
+          dests == expected, "node {} window [{}, {})", n, begin_time,
+          end_time);
+    }
+  }
+
+  // Edges already sorted by time are indexed without sorting
+  KATANA_LOG_ASSERT(g->IndexEdgesByTime("time"));
+
+  // Changing the topology drops the index
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(g));
+  KATANA_LOG_ASSERT(!g->topology().edge_time_index);
+}
+
+void
+TestTranspose(katana::PropertyGraph* g) {
+  AdjacencyList expected(g->num_nodes());
+  for (auto n : g->topology()) {
+    for (auto e : g->topology().edges(n)) {
+      expected[g->topology().edge_dest(e)].emplace_back(n);
+    }
+  }
+
+  auto transpose_res = katana::CreateTransposeGraph(g);
+  KATANA_LOG_ASSERT(transpose_res);
+  KATANA_LOG_ASSERT(
+      ToAdjacencyList(transpose_res.value()->topology()) == expected);
+}
+
+void
+TestSymmetric(katana::PropertyGraph* g) {
+  AdjacencyList expected(g->num_nodes());
+  for (auto n : g->topology()) {
+    for (auto e : g->topology().edges(n)) {
+      Node dest = g->topology().edge_dest(e);
+      expected[n].emplace_back(dest);
+      if (dest != n) {
+        expected[dest].emplace_back(n);
+      }
+    }
+  }
+
+  auto symmetric_res = katana::CreateSymmetricGraph(g);
+  KATANA_LOG_ASSERT(symmetric_res);
+  AdjacencyList actual = ToAdjacencyList(symmetric_res.value()->topology());
+  KATANA_LOG_ASSERT(actual.size() == expected.size());
+  for (size_t n = 0; n < actual.size(); ++n) {
+    std::sort(actual[n].begin(), actual[n].end());
+    std::sort(expected[n].begin(), expected[n].end());
+    KATANA_LOG_VASSERT(actual[n] == expected[n], "node {}", n);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  MixedDegreePolicy policy;
+  auto g = MakeFileGraph<uint32_t>(1000, 1, &policy);
+
+  TestTranspose(g.get());
+  TestSymmetric(g.get());
+  TestSortAllEdgesByDest(g.get());
+  TestSortAllEdgesByType(g.get());
+  TestSortAllEdgesByTime(g.get());
+
+  return 0;
+}
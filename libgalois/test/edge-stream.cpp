@@ -0,0 +1,180 @@
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeStream.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "katana/analytics/SemiExternal.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using Node = katana::EdgeStream::Node;
+
+constexpr size_t kNumNodes = 1000;
+/// Small enough that the graph has many blocks
+constexpr uint64_t kBlockSize = 64;
+
+void
+TestBlocks(const katana::GraphTopology& topology, katana::EdgeStream* stream) {
+  KATANA_LOG_ASSERT(stream->num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(stream->num_edges() == topology.num_edges());
+  KATANA_LOG_ASSERT(stream->num_blocks() > 1);
+
+  Node next = 0;
+  auto res = stream->ForEachBlock([&](const katana::EdgeBlock& block) {
+    KATANA_LOG_ASSERT(block.node_begin() == next);
+    KATANA_LOG_ASSERT(block.node_end() > block.node_begin());
+    for (Node n = block.node_begin(); n < block.node_end(); ++n) {
+      auto [e, end] = topology.edge_range(n);
+      KATANA_LOG_ASSERT(stream->degree(n) == end - e);
+      for (Node dest : block.OutDests(n)) {
+        KATANA_LOG_ASSERT(dest == topology.edge_dest(e));
+        ++e;
+      }
+    }
+    next = block.node_end();
+  });
+  KATANA_LOG_VASSERT(res, "streaming: {}", res.error());
+  KATANA_LOG_ASSERT(next == topology.num_nodes());
+
+  // Only the blocks holding some node are read
+  constexpr Node kWanted = 500;
+  uint32_t num_read = 0;
+  res = stream->ForEachBlock(
+      [&](const katana::EdgeBlock& block) {
+        KATANA_LOG_ASSERT(
+            block.node_begin() <= kWanted && kWanted < block.node_end());
+        num_read += 1;
+      },
+      [&](Node begin, Node end) { return begin <= kWanted && kWanted < end; });
+  KATANA_LOG_VASSERT(res, "streaming: {}", res.error());
+  KATANA_LOG_ASSERT(num_read == 1);
+}
+
+void
+TestBfs(const katana::GraphTopology& topology, katana::EdgeStream* stream) {
+  std::vector<uint32_t> expected(
+      topology.num_nodes(), katana::analytics::kSemiExternalUnreached);
+  std::queue<Node> queue;
+  expected[0] = 0;
+  queue.push(0);
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop();
+    for (auto e : topology.edges(n)) {
+      Node dest = topology.edge_dest(e);
+      if (expected[dest] == katana::analytics::kSemiExternalUnreached) {
+        expected[dest] = expected[n] + 1;
+        queue.push(dest);
+      }
+    }
+  }
+
+  auto res = katana::analytics::SemiExternalBfs(stream, 0);
+  KATANA_LOG_VASSERT(res, "bfs: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == expected);
+
+  KATANA_LOG_ASSERT(
+      !katana::analytics::SemiExternalBfs(stream, topology.num_nodes()));
+}
+
+void
+TestConnectedComponents(
+    const katana::GraphTopology& topology, katana::EdgeStream* stream) {
+  std::vector<Node> expected(topology.num_nodes());
+  std::iota(expected.begin(), expected.end(), 0);
+  auto find = [&](Node n) {
+    while (expected[n] != n) {
+      n = expected[n];
+    }
+    return n;
+  };
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      Node a = find(n);
+      Node b = find(topology.edge_dest(e));
+      expected[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (auto n : topology) {
+    expected[n] = find(n);
+  }
+
+  auto res = katana::analytics::SemiExternalConnectedComponents(stream);
+  KATANA_LOG_VASSERT(res, "connected components: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == expected);
+}
+
+void
+TestPagerank(
+    const katana::GraphTopology& topology, katana::EdgeStream* stream) {
+  constexpr unsigned kIterations = 10;
+  constexpr float kAlpha = 0.85;
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<double> expected(num_nodes, 1.0 / num_nodes);
+  for (unsigned i = 0; i < kIterations; ++i) {
+    std::vector<double> sums(num_nodes);
+    for (auto n : topology) {
+      auto [begin, end] = topology.edge_range(n);
+      for (auto e = begin; e < end; ++e) {
+        sums[topology.edge_dest(e)] += expected[n] / (end - begin);
+      }
+    }
+    for (auto n : topology) {
+      expected[n] = sums[n] * kAlpha + (1 - kAlpha) / num_nodes;
+    }
+  }
+
+  katana::analytics::PagerankPlan plan(
+      katana::analytics::kCPU,
+      katana::analytics::PagerankPlan::kPushSynchronous, 0, kIterations,
+      kAlpha);
+  auto res = katana::analytics::SemiExternalPagerank(stream, plan);
+  KATANA_LOG_VASSERT(res, "pagerank: {}", res.error());
+  for (auto n : topology) {
+    KATANA_LOG_VASSERT(
+        std::fabs(res.value()[n] - expected[n]) < 1e-6, "node {}: {} != {}",
+        n, res.value()[n], expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  auto uri_res = katana::Uri::MakeRand("/tmp/edge-stream");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, "edge-stream"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto stream_res = katana::EdgeStream::Make(rdg_dir, kBlockSize);
+  if (!stream_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making stream: {}", stream_res.error());
+  }
+  katana::EdgeStream stream = std::move(stream_res.value());
+
+  TestBlocks(g->topology(), &stream);
+  TestBfs(g->topology(), &stream);
+  TestConnectedComponents(g->topology(), &stream);
+  TestPagerank(g->topology(), &stream);
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
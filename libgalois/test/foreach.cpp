@@ -18,10 +18,15 @@
  */
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "katana/Bag.h"
+#include "katana/Barrier.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/TerminationDetection.h"
+#include "katana/Timer.h"
 
 void
 function_pointer(int x, katana::UserContext<int>&) {
@@ -34,9 +39,70 @@ struct function_object {
   }
 };
 
+/// Run rounds of detection in which thread i works for i + 1 polls, checking
+/// that no thread stops while another has work, and print the mean
+/// detection latency
+void
+BenchTermination(std::unique_ptr<katana::TerminationDetection> term) {
+  constexpr unsigned kRounds = 1000;
+  unsigned num_threads = katana::getActiveThreads();
+  katana::Barrier& barrier = katana::GetBarrier(num_threads);
+  term->Reinit(num_threads);
+
+  katana::Timer timer;
+  timer.start();
+  for (unsigned round = 0; round < kRounds; ++round) {
+    katana::on_each([&](unsigned tid, unsigned total) {
+      term->InitializeThread();
+      barrier.Wait();
+      unsigned work = tid + 1;
+      do {
+        term->SignalWorked(work > 0);
+        if (work > 0) {
+          --work;
+        }
+        katana::asmPause();
+      } while (term->Working());
+      KATANA_LOG_VASSERT(work == 0, "{} of {} stopped early", tid, total);
+    });
+  }
+  timer.stop();
+
+  auto stats = term->GetDetectionStats();
+  KATANA_LOG_ASSERT(stats.detections == kRounds);
+  std::cout << term->name() << "," << num_threads << ","
+            << stats.total_ns / stats.detections << "ns," << stats.max_ns
+            << "ns," << timer.get() << "ms\n";
+}
+
+/// A loop that pushes a chain of items, which keeps one thread busy while the
+/// others look for work
+void
+ChainLoop() {
+  std::vector<int> v(katana::getActiveThreads(), 0);
+  std::atomic<int> count{0};
+  katana::for_each(
+      katana::iterate(v),
+      [&](int x, katana::UserContext<int>& ctx) {
+        ++count;
+        if (x < 1000) {
+          ctx.push(x + 1);
+        }
+      },
+      katana::loopname("chain"));
+  KATANA_LOG_ASSERT(count == 1001 * static_cast<int>(v.size()));
+}
+
 int
 main() {
   katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  BenchTermination(katana::CreateRingTerminationDetection());
+  BenchTermination(katana::CreateHierarchicalTerminationDetection());
+  BenchTermination(katana::CreateTerminationDetection());
+  ChainLoop();
+
   std::vector<int> v(10);
   katana::InsertBag<int> b;
 
@@ -0,0 +1,290 @@
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancel.h"
+#include "katana/Frontier.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint32_t kNumNodes = 1 << 16;
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+/// A chain 0 -> 1 -> ... with a hub in the middle of it that has an edge to
+/// every node, so that one round of BFS reaches the whole graph
+katana::GraphTopology
+MakeHubGraph() {
+  constexpr uint32_t kHub = kNumNodes / 2;
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (n == kHub) {
+      for (uint32_t d = 0; d < kNumNodes; ++d) {
+        dests.emplace_back(d);
+      }
+    } else if (n + 1 < kNumNodes) {
+      dests.emplace_back(n + 1);
+    }
+    indices.emplace_back(dests.size());
+  }
+  return katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  };
+}
+
+void
+TestRepresentation() {
+  katana::Frontier frontier(kNumNodes);
+  KATANA_LOG_ASSERT(!frontier.is_dense() && frontier.empty());
+
+  for (Node n = 0; n < 10; ++n) {
+    frontier.Push(n);
+  }
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.is_dense() && frontier.size() == 10);
+
+  katana::do_all(katana::iterate(Node{0}, kNumNodes), [&](Node n) {
+    frontier.Push(n % (kNumNodes / 2));
+  });
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes / 2);
+  KATANA_LOG_ASSERT(frontier.Contains(0) && !frontier.Contains(kNumNodes - 1));
+  KATANA_LOG_ASSERT(!frontier.Push(0));
+
+  frontier.Clear();
+  KATANA_LOG_ASSERT(frontier.is_dense() && frontier.empty());
+  frontier.Push(3);
+  frontier.Push(kNumNodes - 1);
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.is_dense() && frontier.size() == 2);
+
+  std::vector<std::atomic<uint32_t>> visits(kNumNodes);
+  frontier.ForEach([&](Node n) { visits[n] += 1; });
+  for (Node n = 0; n < kNumNodes; ++n) {
+    uint32_t expected = (n == 3 || n == kNumNodes - 1) ? 1 : 0;
+    KATANA_LOG_VASSERT(visits[n] == expected, "node {}", n);
+  }
+}
+
+void
+TestForEachFrontierEdge(const katana::GraphTopology& graph) {
+  katana::Frontier frontier(kNumNodes);
+  for (Node n : {Node{1}, kNumNodes / 2, kNumNodes - 1}) {
+    frontier.Push(n);
+  }
+
+  for (size_t tile_size : {size_t{1}, size_t{7}, size_t{kNumNodes}}) {
+    std::vector<std::atomic<uint32_t>> visits(graph.num_edges());
+    katana::ForEachFrontierEdge(
+        graph, frontier,
+        [&](Node src, Edge e) {
+          KATANA_LOG_ASSERT(
+              e >= *graph.edges(src).begin() && e < *graph.edges(src).end());
+          visits[e] += 1;
+        },
+        tile_size);
+    for (Edge e = 0; e < graph.num_edges(); ++e) {
+      bool in_frontier = (e == *graph.edges(1).begin()) ||
+                         (e >= *graph.edges(kNumNodes / 2).begin() &&
+                          e < *graph.edges(kNumNodes / 2).end());
+      KATANA_LOG_VASSERT(visits[e] == (in_frontier ? 1U : 0U), "edge {}", e);
+    }
+  }
+}
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& graph, Node source) {
+  std::vector<uint32_t> levels(graph.num_nodes(), kInfinity);
+  std::deque<Node> queue{source};
+  levels[source] = 0;
+  while (!queue.empty()) {
+    Node src = queue.front();
+    queue.pop_front();
+    for (Edge e : graph.edges(src)) {
+      Node dest = graph.edge_dest(e);
+      if (levels[dest] == kInfinity) {
+        levels[dest] = levels[src] + 1;
+        queue.push_back(dest);
+      }
+    }
+  }
+  return levels;
+}
+
+void
+TestSynchronousFrontierLoop(const katana::GraphTopology& graph) {
+  for (Node source : {Node{0}, Node{kNumNodes / 2 + 5}}) {
+    std::vector<std::atomic<uint32_t>> levels(graph.num_nodes());
+    for (auto& level : levels) {
+      level = kInfinity;
+    }
+    levels[source] = 0;
+
+    katana::Frontier frontier(graph.num_nodes());
+    frontier.Push(source);
+    uint64_t rounds = katana::SynchronousFrontierLoop(
+        graph, &frontier, [&](Node src, Edge e, katana::Frontier* next) {
+          Node dest = graph.edge_dest(e);
+          uint32_t expected = kInfinity;
+          if (levels[dest].compare_exchange_strong(
+                  expected, levels[src] + 1)) {
+            next->Push(dest);
+          }
+        });
+    KATANA_LOG_ASSERT(frontier.empty());
+
+    std::vector<uint32_t> expected = SerialBfs(graph, source);
+    uint32_t max_level = 0;
+    for (Node n = 0; n < graph.num_nodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          levels[n] == expected[n], "node {}: {} != {}", n, levels[n].load(),
+          expected[n]);
+      if (expected[n] != kInfinity) {
+        max_level = std::max(max_level, expected[n]);
+      }
+    }
+    KATANA_LOG_ASSERT(rounds == max_level + 1);
+  }
+}
+
+/// The transpose of graph, for pulling along in edges
+katana::GraphTopology
+MakeTranspose(const katana::GraphTopology& graph) {
+  std::vector<std::vector<uint32_t>> in_edges(graph.num_nodes());
+  for (Node src = 0; src < graph.num_nodes(); ++src) {
+    for (Edge e : graph.edges(src)) {
+      in_edges[graph.edge_dest(e)].emplace_back(src);
+    }
+  }
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& sources : in_edges) {
+    dests.insert(dests.end(), sources.begin(), sources.end());
+    indices.emplace_back(dests.size());
+  }
+  return katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  };
+}
+
+void
+TestSynchronousPushPullFrontierLoop(const katana::GraphTopology& graph) {
+  katana::GraphTopology transpose = MakeTranspose(graph);
+
+  for (Node source : {Node{0}, Node{kNumNodes / 2 + 5}}) {
+    std::vector<std::atomic<uint32_t>> levels(graph.num_nodes());
+    for (auto& level : levels) {
+      level = kInfinity;
+    }
+    levels[source] = 0;
+
+    std::atomic<uint64_t> pushes{0};
+    std::atomic<uint64_t> pulls{0};
+    katana::Frontier frontier(graph.num_nodes());
+    frontier.Push(source);
+    uint64_t rounds = katana::SynchronousPushPullFrontierLoop(
+        graph, &frontier,
+        [&](Node src, Edge e, katana::Frontier* next) {
+          pushes += 1;
+          Node dest = graph.edge_dest(e);
+          uint32_t expected = kInfinity;
+          if (levels[dest].compare_exchange_strong(
+                  expected, levels[src] + 1)) {
+            next->Push(dest);
+          }
+        },
+        [&](Node n, const katana::Frontier& curr, katana::Frontier* next) {
+          pulls += 1;
+          if (levels[n] != kInfinity) {
+            return;
+          }
+          for (Edge e : transpose.edges(n)) {
+            Node parent = transpose.edge_dest(e);
+            if (curr.Contains(parent)) {
+              levels[n] = levels[parent] + 1;
+              next->Push(n);
+              return;
+            }
+          }
+        });
+    KATANA_LOG_ASSERT(frontier.empty());
+    // Reaching the hub makes the frontier dense, which the chain past the
+    // hub never does
+    KATANA_LOG_ASSERT(pushes > 0);
+    KATANA_LOG_ASSERT((pulls > 0) == (source < kNumNodes / 2));
+    KATANA_LOG_ASSERT(pulls % graph.num_nodes() == 0);
+
+    std::vector<uint32_t> expected = SerialBfs(graph, source);
+    uint32_t max_level = 0;
+    for (Node n = 0; n < graph.num_nodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          levels[n] == expected[n], "node {}: {} != {}", n, levels[n].load(),
+          expected[n]);
+      if (expected[n] != kInfinity) {
+        max_level = std::max(max_level, expected[n]);
+      }
+    }
+    KATANA_LOG_ASSERT(rounds == max_level + 1);
+  }
+}
+
+/// A loop stops at the end of the round in which it was cancelled
+void
+TestCancel(const katana::GraphTopology& graph) {
+  katana::CancelFlag flag;
+  katana::CancelScope scope(&flag);
+  KATANA_LOG_ASSERT(!katana::CancelRequested());
+
+  katana::Frontier frontier(graph.num_nodes());
+  frontier.Push(0);
+  uint64_t rounds = katana::SynchronousFrontierLoop(
+      graph, &frontier, [&](Node, Edge e, katana::Frontier* next) {
+        flag.Cancel();
+        next->Push(graph.edge_dest(e));
+      });
+  KATANA_LOG_ASSERT(rounds == 1);
+  KATANA_LOG_ASSERT(katana::CancelRequested());
+
+  {
+    katana::CancelFlag inner;
+    katana::CancelScope inner_scope(&inner);
+    KATANA_LOG_ASSERT(!katana::CancelRequested());
+  }
+  KATANA_LOG_ASSERT(katana::CancelRequested());
+  flag.Reset();
+  KATANA_LOG_ASSERT(!katana::CancelRequested());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  katana::GraphTopology graph = MakeHubGraph();
+
+  TestRepresentation();
+  TestForEachFrontierEdge(graph);
+  TestSynchronousFrontierLoop(graph);
+  TestSynchronousPushPullFrontierLoop(graph);
+  TestCancel(graph);
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/FusedScan.h"
+
+namespace {
+
+using katana::analytics::FusedScan;
+
+using Neighbors = std::vector<std::set<uint32_t>>;
+
+constexpr uint32_t kNumNodes = 600;
+
+/// Make random clusters of densely connected nodes with a few edges between
+/// clusters, so that nodes have many triangles
+Neighbors
+MakeClusters(std::mt19937* gen) {
+  std::uniform_real_distribution<double> coin(0, 1);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  Neighbors neighbors(kNumNodes);
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    if (a != b) {
+      neighbors[a].emplace(b);
+      neighbors[b].emplace(a);
+    }
+  };
+  for (uint32_t a = 0; a < kNumNodes; ++a) {
+    uint32_t cluster_end = std::min(kNumNodes, (a / 20 + 1) * 20);
+    for (uint32_t b = a + 1; b < cluster_end; ++b) {
+      if (coin(*gen) < 0.5) {
+        add_edge(a, b);
+      }
+    }
+    add_edge(a, node(*gen));
+  }
+  return neighbors;
+}
+
+/// Make a symmetric graph of neighbors whose edges are in random order
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Neighbors& neighbors, std::mt19937* gen) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& node_neighbors : neighbors) {
+    std::vector<uint32_t> local(node_neighbors.begin(), node_neighbors.end());
+    std::shuffle(local.begin(), local.end(), *gen);
+    dests.insert(dests.end(), local.begin(), local.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+template <typename ArrayType>
+const ArrayType&
+Column(const katana::PropertyGraph& g, const std::string& name) {
+  auto column = g.GetNodeProperty(name);
+  KATANA_LOG_VASSERT(column, "no property {}", name);
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  return static_cast<const ArrayType&>(*column->chunk(0));
+}
+
+uint64_t
+CountShared(const std::set<uint32_t>& a, const std::set<uint32_t>& b) {
+  uint64_t shared = 0;
+  for (uint32_t node : a) {
+    shared += b.count(node);
+  }
+  return shared;
+}
+
+void
+TestAll(const Neighbors& neighbors, katana::PropertyGraph* g) {
+  const std::vector<uint32_t> compare_nodes{7, 311};
+  FusedScan scan;
+  scan.AddOutDegree("out")
+      .AddInDegree("in")
+      .AddJaccard(compare_nodes[0], "jaccard-0")
+      .AddJaccard(compare_nodes[1], "jaccard-1")
+      .AddTriangleCount("triangles")
+      .AddLocalClusteringCoefficient("lcc");
+  auto res = scan.Run(g);
+  KATANA_LOG_VASSERT(res, "running: {}", res.error());
+  const auto& summary = res.value();
+
+  const auto& out = Column<arrow::UInt64Array>(*g, "out");
+  const auto& in = Column<arrow::UInt64Array>(*g, "in");
+  const auto& triangles = Column<arrow::UInt64Array>(*g, "triangles");
+  const auto& lcc = Column<arrow::DoubleArray>(*g, "lcc");
+  uint64_t total_triangles = 0;
+  uint64_t max_degree = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint64_t degree = neighbors[n].size();
+    max_degree = std::max(max_degree, degree);
+    KATANA_LOG_ASSERT(out.Value(n) == degree);
+    KATANA_LOG_ASSERT(in.Value(n) == degree);
+
+    uint64_t expected = 0;
+    for (uint32_t v : neighbors[n]) {
+      expected += CountShared(neighbors[n], neighbors[v]);
+    }
+    expected /= 2;
+    total_triangles += expected;
+    KATANA_LOG_VASSERT(
+        triangles.Value(n) == expected, "node {}: {} triangles, not {}", n,
+        triangles.Value(n), expected);
+    double coefficient =
+        degree < 2 ? 0.0 : 2.0 * expected / (degree * (degree - 1));
+    KATANA_LOG_ASSERT(std::abs(lcc.Value(n) - coefficient) < 1e-12);
+  }
+
+  for (size_t k = 0; k < compare_nodes.size(); ++k) {
+    const auto& jaccard =
+        Column<arrow::DoubleArray>(*g, fmt::format("jaccard-{}", k));
+    const auto& compare = neighbors[compare_nodes[k]];
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      uint64_t shared = CountShared(neighbors[n], compare);
+      uint64_t union_size = neighbors[n].size() + compare.size() - shared;
+      double expected =
+          union_size > 0 ? static_cast<double>(shared) / union_size : 1;
+      KATANA_LOG_ASSERT(std::abs(jaccard.Value(n) - expected) < 1e-12);
+    }
+    KATANA_LOG_ASSERT(jaccard.Value(compare_nodes[k]) == 1);
+  }
+
+  KATANA_LOG_ASSERT(summary.num_triangles == total_triangles / 3);
+  KATANA_LOG_ASSERT(summary.out_degree && summary.in_degree);
+  KATANA_LOG_ASSERT(summary.out_degree->max == max_degree);
+  KATANA_LOG_ASSERT(summary.in_degree->max == max_degree);
+}
+
+void
+TestErrors(katana::PropertyGraph* g) {
+  // The properties of TestAll exist
+  KATANA_LOG_ASSERT(!FusedScan().AddOutDegree("out").Run(g));
+  KATANA_LOG_ASSERT(
+      !FusedScan().AddInDegree("twice").AddTriangleCount("twice").Run(g));
+  KATANA_LOG_ASSERT(!FusedScan().AddJaccard(kNumNodes, "far").Run(g));
+
+  // Running only some kernels leaves out the rest of the summary
+  auto res = FusedScan().AddInDegree("in-only").Run(g);
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(res.value().in_degree);
+  KATANA_LOG_ASSERT(!res.value().out_degree && !res.value().num_triangles);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  std::mt19937 gen(17);
+  auto neighbors = MakeClusters(&gen);
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    auto g = MakeGraph(neighbors, &gen);
+    TestAll(neighbors, g.get());
+    TestErrors(g.get());
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/independent_set/independent_set.h"
+
+namespace {
+
+using katana::analytics::GraphColoringPlan;
+
+constexpr uint32_t kNumNodes = 1 << 12;
+constexpr uint32_t kCliqueSize = 8;
+
+/// Make a symmetric random graph whose first kCliqueSize nodes form a clique,
+/// with a few self loops
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::mt19937 gen(0);
+  std::vector<std::vector<uint32_t>> neighbors(kNumNodes);
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    neighbors[a].emplace_back(b);
+    if (a != b) {
+      neighbors[b].emplace_back(a);
+    }
+  };
+  for (uint32_t a = 0; a < kCliqueSize; ++a) {
+    for (uint32_t b = a + 1; b < kCliqueSize; ++b) {
+      add_edge(a, b);
+    }
+  }
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  for (uint32_t i = 0; i < kNumNodes * 4; ++i) {
+    add_edge(node(gen), node(gen));
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (auto& n : neighbors) {
+    std::sort(n.begin(), n.end());
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+std::vector<uint32_t>
+Colors(const katana::PropertyGraph& g, const std::string& name) {
+  auto column = g.GetNodeProperty(name);
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  const auto& colors =
+      static_cast<const arrow::UInt32Array&>(*column->chunk(0));
+  return std::vector<uint32_t>(
+      colors.raw_values(), colors.raw_values() + colors.length());
+}
+
+void
+TestColoring() {
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+
+  for (const auto& plan :
+       {GraphColoringPlan::JonesPlassmann(),
+        GraphColoringPlan::Speculative()}) {
+    auto result = katana::analytics::GraphColoring(g.get(), "color", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    KATANA_LOG_ASSERT(
+        katana::analytics::GraphColoringAssertValid(g.get(), "color"));
+
+    auto stats_result =
+        katana::analytics::GraphColoringStatistics::Compute(g.get(), "color");
+    KATANA_LOG_ASSERT(stats_result);
+    KATANA_LOG_ASSERT(stats_result.value().num_colors >= kCliqueSize);
+
+    // The clique needs a color for each of its nodes
+    std::vector<uint32_t> colors = Colors(*g, "color");
+    std::vector<uint32_t> clique(colors.begin(), colors.begin() + kCliqueSize);
+    std::sort(clique.begin(), clique.end());
+    KATANA_LOG_ASSERT(
+        std::unique(clique.begin(), clique.end()) == clique.end());
+
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("color"));
+  }
+}
+
+/// Jones-Plassmann gives the same colors with any number of threads
+void
+TestDeterministic() {
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+
+  std::vector<std::vector<uint32_t>> results;
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    auto result = katana::analytics::GraphColoring(
+        g.get(), "color", GraphColoringPlan::JonesPlassmann());
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    results.emplace_back(Colors(*g, "color"));
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("color"));
+  }
+  KATANA_LOG_ASSERT(results[0] == results[1]);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestColoring();
+  TestDeterministic();
+
+  return 0;
+}
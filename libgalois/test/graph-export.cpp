@@ -0,0 +1,229 @@
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphExport.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+constexpr uint64_t kRowsPerShard = 300;
+
+/// A graph with the uint32 node property "value", the string node property
+/// "label", which sometimes needs quoting, the uint32 edge property "weight"
+/// and user IDs
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::vector<uint32_t> values;
+  std::vector<std::string> labels;
+  std::vector<uint64_t> user_ids;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    values.emplace_back(n * 3);
+    labels.emplace_back(
+        n % 3 == 0 ? fmt::format("node {}", n)
+                   : fmt::format("node, \"{}\"", n));
+    user_ids.emplace_back(uint64_t{n} * 10 + 7);
+  }
+  std::vector<uint32_t> weights;
+  for (uint64_t e = 0; e < g->topology().num_edges(); ++e) {
+    weights.emplace_back(e % 17);
+  }
+
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("value", arrow::uint32()),
+           arrow::field("label", arrow::utf8())}),
+      {katana::BuildArray(values), katana::BuildArray(labels)})));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+  g->set_local_to_user_id(
+      std::make_shared<arrow::ChunkedArray>(katana::BuildArray(user_ids)));
+  return g;
+}
+
+std::string
+LocalPath(const std::string& file) {
+  auto uri_res = katana::Uri::Make(file);
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().path();
+}
+
+std::vector<std::string>
+ReadLines(const std::vector<std::string>& files) {
+  std::vector<std::string> lines;
+  for (const auto& file : files) {
+    std::ifstream in(LocalPath(file));
+    KATANA_LOG_VASSERT(in, "cannot read {}", file);
+    for (std::string line; std::getline(in, line);) {
+      lines.emplace_back(line);
+    }
+  }
+  return lines;
+}
+
+std::shared_ptr<arrow::Table>
+ReadParquet(const std::vector<std::string>& files) {
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (const auto& file : files) {
+    auto reader_res = tsuba::ParquetReader::Make();
+    KATANA_LOG_ASSERT(reader_res);
+    auto uri_res = katana::Uri::Make(file);
+    KATANA_LOG_ASSERT(uri_res);
+    auto table_res = reader_res.value()->ReadFromUri(uri_res.value());
+    KATANA_LOG_VASSERT(table_res, "reading {}: {}", file, table_res.error());
+    KATANA_LOG_ASSERT(
+        table_res.value()->num_rows() <= static_cast<int64_t>(kRowsPerShard));
+    tables.emplace_back(table_res.value());
+  }
+  auto table_res = arrow::ConcatenateTables(tables);
+  KATANA_LOG_ASSERT(table_res.ok());
+  auto combined_res = table_res.ValueOrDie()->CombineChunks();
+  KATANA_LOG_ASSERT(combined_res.ok());
+  return combined_res.ValueOrDie();
+}
+
+template <typename ArrayType>
+const ArrayType&
+Column(const arrow::Table& table, const std::string& name) {
+  auto column = table.GetColumnByName(name);
+  KATANA_LOG_VASSERT(column, "no column {}", name);
+  return static_cast<const ArrayType&>(*column->chunk(0));
+}
+
+void
+TestParquet(const katana::PropertyGraph& g, const std::string& dir) {
+  katana::ExportOptions opts;
+  opts.rows_per_shard = kRowsPerShard;
+  auto res = katana::ExportGraph(g, dir, opts);
+  KATANA_LOG_VASSERT(res, "exporting: {}", res.error());
+  const katana::ExportManifest& manifest = res.value();
+  KATANA_LOG_ASSERT(
+      manifest.node_files.size() ==
+      (kNumNodes + kRowsPerShard - 1) / kRowsPerShard);
+
+  auto nodes = ReadParquet(manifest.node_files);
+  KATANA_LOG_ASSERT(nodes->num_rows() == static_cast<int64_t>(kNumNodes));
+  KATANA_LOG_ASSERT(
+      nodes->ColumnNames() ==
+      std::vector<std::string>({"id", "user_id", "value", "label"}));
+  const auto& ids = Column<arrow::UInt32Array>(*nodes, "id");
+  const auto& user_ids = Column<arrow::UInt64Array>(*nodes, "user_id");
+  const auto& values = Column<arrow::UInt32Array>(*nodes, "value");
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(ids.Value(n) == n);
+    KATANA_LOG_ASSERT(user_ids.Value(n) == uint64_t{n} * 10 + 7);
+    KATANA_LOG_ASSERT(values.Value(n) == n * 3);
+  }
+
+  const katana::GraphTopology& topology = g.topology();
+  auto edges = ReadParquet(manifest.edge_files);
+  KATANA_LOG_ASSERT(
+      edges->num_rows() == static_cast<int64_t>(topology.num_edges()));
+  KATANA_LOG_ASSERT(
+      edges->ColumnNames() ==
+      std::vector<std::string>({"src", "dst", "weight"}));
+  const auto& srcs = Column<arrow::UInt32Array>(*edges, "src");
+  const auto& dsts = Column<arrow::UInt32Array>(*edges, "dst");
+  const auto& weights = Column<arrow::UInt32Array>(*edges, "weight");
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      KATANA_LOG_ASSERT(srcs.Value(e) == n);
+      KATANA_LOG_ASSERT(dsts.Value(e) == topology.edge_dest(e));
+      KATANA_LOG_ASSERT(weights.Value(e) == e % 17);
+    }
+  }
+}
+
+void
+TestCsv(const katana::PropertyGraph& g, const std::string& dir) {
+  katana::ExportOptions opts;
+  opts.format = katana::ExportOptions::kCsv;
+  opts.rows_per_shard = kRowsPerShard;
+  auto res = katana::ExportGraph(g, dir, opts);
+  KATANA_LOG_VASSERT(res, "exporting: {}", res.error());
+
+  // Every shard starts with a header
+  auto node_lines = ReadLines(res.value().node_files);
+  std::vector<std::string> expected;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (n % kRowsPerShard == 0) {
+      expected.emplace_back("id,user_id,value,label");
+    }
+    expected.emplace_back(
+        n % 3 == 0
+            ? fmt::format("{},{},{},node {}", n, n * 10 + 7, n * 3, n)
+            : fmt::format(
+                  "{},{},{},\"node, \"\"{}\"\"\"", n, n * 10 + 7, n * 3, n));
+  }
+  KATANA_LOG_ASSERT(node_lines == expected);
+
+  const katana::GraphTopology& topology = g.topology();
+  auto edge_lines = ReadLines(res.value().edge_files);
+  expected.clear();
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      if (e % kRowsPerShard == 0) {
+        expected.emplace_back("src,dst,weight");
+      }
+      expected.emplace_back(
+          fmt::format("{},{},{}", n, topology.edge_dest(e), e % 17));
+    }
+  }
+  KATANA_LOG_ASSERT(edge_lines == expected);
+}
+
+void
+TestEdgeList(const katana::PropertyGraph& g, const std::string& dir) {
+  auto res = katana::ExportGraph(g, dir, katana::ExportOptions::EdgeList());
+  KATANA_LOG_VASSERT(res, "exporting: {}", res.error());
+  KATANA_LOG_ASSERT(res.value().node_files.empty());
+
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<std::string> expected;
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      expected.emplace_back(fmt::format("{} {}", n, topology.edge_dest(e)));
+    }
+  }
+  KATANA_LOG_ASSERT(ReadLines(res.value().edge_files) == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto g = MakeGraph();
+  auto uri_res = katana::Uri::MakeRand("/tmp/graph-export");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+
+  TestParquet(*g, dir + "/parquet");
+  TestCsv(*g, dir + "/csv");
+  TestEdgeList(*g, dir + "/edge-list");
+
+  katana::ExportOptions opts;
+  opts.rows_per_shard = 0;
+  KATANA_LOG_ASSERT(!katana::ExportGraph(*g, dir + "/invalid", opts));
+
+  fs::remove_all(dir);
+  return 0;
+}
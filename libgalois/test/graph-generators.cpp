@@ -0,0 +1,139 @@
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Generate =
+    std::function<katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+        const katana::GeneratorOptions&)>;
+
+std::unique_ptr<katana::PropertyGraph>
+Check(
+    katana::Result<std::unique_ptr<katana::PropertyGraph>> res,
+    uint64_t num_nodes) {
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(res.value()->num_nodes() == num_nodes);
+  return std::move(res.value());
+}
+
+/// Whether the edge src -> dest is in g
+bool
+HasEdge(const katana::GraphTopology& g, uint32_t src, uint32_t dest) {
+  for (auto e : g.edges(src)) {
+    if (g.edge_dest(e) == dest) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+TestGenerator(const Generate& generate, uint64_t num_nodes, uint64_t num_pairs) {
+  katana::GeneratorOptions options;
+  options.seed = 42;
+
+  // The same parameters give the same graph on any number of threads
+  katana::setActiveThreads(1);
+  auto one = Check(generate(options), num_nodes);
+  KATANA_LOG_ASSERT(one->num_edges() == num_pairs);
+  katana::setActiveThreads(4);
+  auto four = Check(generate(options), num_nodes);
+  KATANA_LOG_ASSERT(one->topology().Equals(four->topology()));
+
+  // Edges are sorted by destination
+  const katana::GraphTopology& topology = four->topology();
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      KATANA_LOG_ASSERT(
+          e == *topology.edges(n).begin() ||
+          topology.edge_dest(e - 1) <= topology.edge_dest(e));
+    }
+  }
+
+  options.seed = 43;
+  auto other = Check(generate(options), num_nodes);
+  KATANA_LOG_ASSERT(!one->topology().Equals(other->topology()));
+
+  options.symmetric = true;
+  options.remove_self_loops = true;
+  options.max_weight = 10;
+  auto symmetric = Check(generate(options), num_nodes);
+  const katana::GraphTopology& sym = symmetric->topology();
+  KATANA_LOG_ASSERT(sym.num_edges() <= 2 * num_pairs);
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      symmetric->GetEdgeProperty("weight")->chunk(0));
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : sym.edges(n)) {
+      uint32_t dest = sym.edge_dest(e);
+      KATANA_LOG_ASSERT(dest != n);
+      KATANA_LOG_ASSERT(HasEdge(sym, dest, n));
+      KATANA_LOG_ASSERT(weights->Value(e) >= 1 && weights->Value(e) <= 10);
+    }
+  }
+}
+
+void
+TestStochasticBlockModel() {
+  auto g = Check(
+      katana::GenerateStochasticBlockModel(
+          {100, 200, 300}, {{0.1, 0, 0}, {0, 0.05, 0.01}, {0, 0, 0.02}}),
+      600);
+  // 100 * 100 * 0.1 + 200 * 200 * 0.05 + 200 * 300 * 0.01 + 300 * 300 * 0.02
+  KATANA_LOG_ASSERT(g->num_edges() == 5400);
+
+  auto blocks = std::static_pointer_cast<arrow::UInt32Array>(
+      g->GetNodeProperty("block")->chunk(0));
+  KATANA_LOG_ASSERT(blocks->Value(0) == 0 && blocks->Value(99) == 0);
+  KATANA_LOG_ASSERT(blocks->Value(100) == 1 && blocks->Value(599) == 2);
+  const katana::GraphTopology& topology = g->topology();
+  for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+    for (auto e : topology.edges(n)) {
+      uint32_t from = blocks->Value(n);
+      uint32_t to = blocks->Value(topology.edge_dest(e));
+      KATANA_LOG_ASSERT(from == to || (from == 1 && to == 2));
+    }
+  }
+
+  KATANA_LOG_ASSERT(
+      !katana::GenerateStochasticBlockModel({10, 10}, {{0.5, 0.5}}));
+  KATANA_LOG_ASSERT(!katana::GenerateStochasticBlockModel({10}, {{1.5}}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestGenerator(
+      [](const katana::GeneratorOptions& options) {
+        return katana::GenerateRmat(10, 5000, {}, true, options);
+      },
+      1024, 5000);
+  TestGenerator(
+      [](const katana::GeneratorOptions& options) {
+        return katana::GenerateKronecker(9, 8, options);
+      },
+      512, 4096);
+  TestGenerator(
+      [](const katana::GeneratorOptions& options) {
+        return katana::GenerateErdosRenyi(1000, 3000, options);
+      },
+      1000, 3000);
+  TestStochasticBlockModel();
+
+  KATANA_LOG_ASSERT(!katana::GenerateRmat(33, 1));
+  KATANA_LOG_ASSERT(
+      !katana::GenerateRmat(4, 1, katana::RmatParameters{0.5, 0.5, 0.5}));
+
+  return 0;
+}
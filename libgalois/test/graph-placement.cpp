@@ -0,0 +1,95 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphPlacement.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/Uri.h"
+#include "tsuba/RDG.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+/// Check that g is unchanged after placing it with policy
+void
+TestPlacement(const katana::PropertyGraph& g, katana::MemoryPlacement policy) {
+  auto copy_res = g.Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> placed = std::move(copy_res.value());
+
+  KATANA_LOG_ASSERT(katana::PlaceGraph(placed.get(), policy));
+
+  KATANA_LOG_ASSERT(placed->topology().Equals(g.topology()));
+  KATANA_LOG_ASSERT(placed->node_schema()->Equals(*g.node_schema()));
+  KATANA_LOG_ASSERT(placed->edge_schema()->Equals(*g.edge_schema()));
+  for (int i = 0; i < g.node_schema()->num_fields(); ++i) {
+    KATANA_LOG_ASSERT(placed->GetNodeProperty(i)->Equals(g.GetNodeProperty(i)));
+  }
+  for (int i = 0; i < g.edge_schema()->num_fields(); ++i) {
+    KATANA_LOG_ASSERT(placed->GetEdgeProperty(i)->Equals(g.GetEdgeProperty(i)));
+  }
+}
+
+/// Check that loading the graph stored in rdg_dir with its topology filled
+/// by TopologyFiller(policy) loads the topology of g
+void
+TestFillTopology(
+    const std::string& rdg_dir, const katana::PropertyGraph& g,
+    katana::MemoryPlacement policy) {
+  tsuba::RDGLoadOptions opts;
+  opts.fill_topology = katana::TopologyFiller(policy);
+  KATANA_LOG_ASSERT(
+      static_cast<bool>(opts.fill_topology) ==
+      (policy != katana::MemoryPlacement::kFirstTouch));
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+
+  KATANA_LOG_ASSERT(make_res.value()->topology().Equals(g.topology()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy policy{5};
+  auto g = MakeFileGraph<int64_t>(10000, 2, &policy);
+
+  // A column that cannot be placed is kept as it is
+  arrow::StringBuilder builder;
+  for (size_t i = 0; i < g->num_nodes(); ++i) {
+    KATANA_LOG_ASSERT(builder.Append(std::to_string(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> names;
+  KATANA_LOG_ASSERT(builder.Finish(&names).ok());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("name", arrow::utf8())}), {names})));
+
+  TestPlacement(*g, katana::MemoryPlacement::kFirstTouch);
+  TestPlacement(*g, katana::MemoryPlacement::kBlocked);
+  TestPlacement(*g, katana::MemoryPlacement::kInterleaved);
+
+  // Large enough that both arrays span several pages of each thread
+  auto big = MakeFileGraph<int64_t>(1 << 18, 0, &policy);
+  auto uri_res = katana::Uri::MakeRand("/tmp/graphplacement");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = big->Write(rdg_dir, "graph-placement"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  TestFillTopology(rdg_dir, *big, katana::MemoryPlacement::kFirstTouch);
+  TestFillTopology(rdg_dir, *big, katana::MemoryPlacement::kBlocked);
+  TestFillTopology(rdg_dir, *big, katana::MemoryPlacement::kInterleaved);
+  fs::remove_all(rdg_dir);
+
+  return 0;
+}
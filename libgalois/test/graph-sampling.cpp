@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/GraphSampling.h"
+
+namespace {
+
+using katana::analytics::GraphSamplingPlan;
+
+constexpr uint32_t kNumNodes = 2000;
+
+/// Make a random symmetric graph without self loops whose edges may repeat
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetricGraph(uint32_t num_nodes, uint32_t num_edges, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+  std::vector<std::vector<uint32_t>> adjacency(num_nodes);
+  for (uint32_t i = 0; i < num_edges; ++i) {
+    uint32_t src = dist(*gen);
+    uint32_t dst = dist(*gen);
+    if (src != dst) {
+      adjacency[src].emplace_back(dst);
+      adjacency[dst].emplace_back(src);
+    }
+  }
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (auto& neighbors : adjacency) {
+    std::sort(neighbors.begin(), neighbors.end());
+    dests.insert(dests.end(), neighbors.begin(), neighbors.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// The original IDs of the nodes and edges of a sample
+struct Sample {
+  std::vector<uint32_t> nodes;
+  std::vector<uint64_t> edges;
+
+  bool operator==(const Sample& other) const {
+    return nodes == other.nodes && edges == other.edges;
+  }
+};
+
+Sample
+Draw(const katana::PropertyGraph& g, const GraphSamplingPlan& plan) {
+  auto res = katana::analytics::SampleSubgraph(g, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  const katana::Subgraph& subgraph = res.value();
+  Sample sample;
+  for (int64_t i = 0; i < subgraph.original_nodes->length(); ++i) {
+    sample.nodes.emplace_back(subgraph.original_nodes->Value(i));
+  }
+  for (int64_t i = 0; i < subgraph.original_edges->length(); ++i) {
+    sample.edges.emplace_back(subgraph.original_edges->Value(i));
+  }
+  KATANA_LOG_ASSERT(subgraph.graph->num_nodes() == sample.nodes.size());
+  KATANA_LOG_ASSERT(subgraph.graph->num_edges() == sample.edges.size());
+  return sample;
+}
+
+/// Check that the edges of sample connect sampled nodes, and that all of
+/// the edges among them are sampled if induced is set
+void
+CheckEdges(const katana::PropertyGraph& g, const Sample& sample, bool induced) {
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<bool> in_sample(g.num_nodes(), false);
+  for (uint32_t n : sample.nodes) {
+    in_sample[n] = true;
+  }
+  std::vector<bool> edge_in_sample(g.num_edges(), false);
+  for (uint64_t e : sample.edges) {
+    edge_in_sample[e] = true;
+  }
+  uint64_t num_induced = 0;
+  for (uint32_t n : sample.nodes) {
+    for (auto e : topology.edges(n)) {
+      bool among = in_sample[topology.edge_dest(e)];
+      num_induced += among;
+      KATANA_LOG_VASSERT(
+          among || !edge_in_sample[e], "edge {} leaves the sample", e);
+      KATANA_LOG_VASSERT(
+          !induced || !among || edge_in_sample[e], "edge {} is missing", e);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      sample.edges.size() <= num_induced, "{} sampled edges, {} induced",
+      sample.edges.size(), num_induced);
+}
+
+/// Check that count is within 5 standard deviations of a binomial count
+void
+CheckCount(uint64_t count, uint64_t trials, double p, const char* what) {
+  double mean = trials * p;
+  double bound = 5 * std::sqrt(trials * p * (1 - p));
+  KATANA_LOG_VASSERT(
+      std::abs(count - mean) <= bound, "{}: {} expected about {}", what, count,
+      mean);
+}
+
+/// Node and edge samplers do not depend on the number of threads
+Sample
+DrawOnThreads(const katana::PropertyGraph& g, const GraphSamplingPlan& plan) {
+  katana::setActiveThreads(1);
+  Sample serial = Draw(g, plan);
+  katana::setActiveThreads(4);
+  Sample parallel = Draw(g, plan);
+  KATANA_LOG_ASSERT(serial == parallel);
+  return parallel;
+}
+
+void
+TestNodeAndEdge(const katana::PropertyGraph& g) {
+  const katana::GraphTopology& topology = g.topology();
+
+  Sample nodes = DrawOnThreads(g, GraphSamplingPlan::RandomNode(0.3, 1));
+  CheckCount(nodes.nodes.size(), g.num_nodes(), 0.3, "random node");
+  CheckEdges(g, nodes, true);
+  KATANA_LOG_ASSERT(
+      !(Draw(g, GraphSamplingPlan::RandomNode(0.3, 2)) == nodes));
+
+  Sample edges = DrawOnThreads(g, GraphSamplingPlan::RandomEdge(0.2, 1));
+  CheckCount(edges.edges.size(), g.num_edges(), 0.2, "random edge");
+  CheckEdges(g, edges, false);
+  // Both directions of an edge are kept together, and every sampled node
+  // is the endpoint of a sampled edge
+  std::vector<bool> edge_in_sample(g.num_edges(), false);
+  for (uint64_t e : edges.edges) {
+    edge_in_sample[e] = true;
+  }
+  std::map<std::pair<uint32_t, uint32_t>, int> counts;
+  std::vector<bool> touched(g.num_nodes(), false);
+  for (uint32_t n : edges.nodes) {
+    for (auto e : topology.edges(n)) {
+      if (edge_in_sample[e]) {
+        uint32_t dst = topology.edge_dest(e);
+        ++counts[{n, dst}];
+        touched[n] = true;
+        touched[dst] = true;
+      }
+    }
+  }
+  for (const auto& [edge, count] : counts) {
+    auto reverse = counts.find({edge.second, edge.first});
+    KATANA_LOG_VASSERT(
+        reverse != counts.end() && reverse->second == count,
+        "edge ({}, {}) is not symmetric", edge.first, edge.second);
+  }
+  for (uint32_t n : edges.nodes) {
+    KATANA_LOG_VASSERT(touched[n], "node {} has no sampled edge", n);
+  }
+
+  Sample induced = DrawOnThreads(g, GraphSamplingPlan::InducedEdge(0.2, 1));
+  KATANA_LOG_ASSERT(induced.nodes == edges.nodes);
+  CheckEdges(g, induced, true);
+  KATANA_LOG_ASSERT(induced.edges.size() > edges.edges.size());
+
+  Sample all = Draw(g, GraphSamplingPlan::RandomNode(1));
+  KATANA_LOG_ASSERT(all.nodes.size() == g.num_nodes());
+  KATANA_LOG_ASSERT(all.edges.size() == g.num_edges());
+}
+
+void
+TestExploration(const katana::PropertyGraph& g) {
+  for (const auto& base :
+       {GraphSamplingPlan::ForestFire(0.25, 0.7, 1),
+        GraphSamplingPlan::Snowball(0.25, 2, 1),
+        GraphSamplingPlan::RandomWalk(0.25, 0.15, 1)}) {
+    uint64_t target = std::ceil(0.25 * g.num_nodes());
+
+    // Each thread stops at most one node past the target
+    katana::setActiveThreads(4);
+    Sample parallel = Draw(g, base);
+    KATANA_LOG_VASSERT(
+        parallel.nodes.size() >= target && parallel.nodes.size() <= target + 4,
+        "algorithm {}: {} nodes expected {}", base.algorithm(),
+        parallel.nodes.size(), target);
+    CheckEdges(g, parallel, true);
+
+    GraphSamplingPlan plan = base;
+    plan.set_deterministic(true);
+    Sample deterministic = Draw(g, plan);
+    KATANA_LOG_ASSERT(deterministic.nodes.size() == target);
+    CheckEdges(g, deterministic, true);
+    katana::setActiveThreads(1);
+    KATANA_LOG_ASSERT(Draw(g, plan) == deterministic);
+    katana::setActiveThreads(4);
+  }
+
+  // Exploring the whole graph visits every node, including isolated ones
+  for (const auto& plan :
+       {GraphSamplingPlan::ForestFire(1), GraphSamplingPlan::Snowball(1),
+        GraphSamplingPlan::RandomWalk(1)}) {
+    Sample all = Draw(g, plan);
+    KATANA_LOG_ASSERT(all.nodes.size() == g.num_nodes());
+    KATANA_LOG_ASSERT(all.edges.size() == g.num_edges());
+  }
+}
+
+void
+TestInvalid(const katana::PropertyGraph& g) {
+  using katana::analytics::SampleSubgraph;
+  KATANA_LOG_ASSERT(!SampleSubgraph(g, GraphSamplingPlan::RandomNode(0)));
+  KATANA_LOG_ASSERT(!SampleSubgraph(g, GraphSamplingPlan::RandomEdge(1.5)));
+  KATANA_LOG_ASSERT(!SampleSubgraph(g, GraphSamplingPlan::ForestFire(0.1, 1)));
+  KATANA_LOG_ASSERT(!SampleSubgraph(g, GraphSamplingPlan::Snowball(0.1, 0)));
+  KATANA_LOG_ASSERT(
+      !SampleSubgraph(g, GraphSamplingPlan::RandomWalk(0.1, -0.5)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  std::mt19937 gen(0);
+
+  auto g = MakeSymmetricGraph(kNumNodes, 4 * kNumNodes, &gen);
+  TestNodeAndEdge(*g);
+  TestExploration(*g);
+  TestInvalid(*g);
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include <cmath>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/GraphStats.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr Node kLayerSize = 100;
+constexpr Node kNumLayers = 4;
+
+/// Every node of a layer has an edge to every node of the next layer, so
+/// the diameter is kNumLayers - 1. Node n has property "value" n.
+std::unique_ptr<katana::PropertyGraph>
+MakeLayeredGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<int64_t> values;
+  for (Node n = 0; n < kLayerSize * kNumLayers; ++n) {
+    Node layer = n / kLayerSize;
+    if (layer + 1 < kNumLayers) {
+      for (Node d = 0; d < kLayerSize; ++d) {
+        dests.emplace_back((layer + 1) * kLayerSize + d);
+      }
+    }
+    indices.emplace_back(dests.size());
+    values.emplace_back(n);
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::int64())}),
+      {katana::BuildArray(values)})));
+  return g;
+}
+
+void
+TestDegrees() {
+  auto g = MakeLayeredGraph();
+  katana::analytics::GraphStatsOptions options;
+  options.estimate_diameter = false;
+  auto stats_res = katana::analytics::GraphStats::Compute(*g, options);
+  KATANA_LOG_VASSERT(stats_res, "{}", stats_res.error());
+  const katana::analytics::GraphStats& stats = stats_res.value();
+
+  KATANA_LOG_ASSERT(stats.num_nodes == kLayerSize * kNumLayers);
+  KATANA_LOG_ASSERT(stats.num_edges == kLayerSize * kLayerSize * 3);
+  KATANA_LOG_ASSERT(!stats.neighborhood);
+
+  const auto& out = stats.out_degree;
+  KATANA_LOG_ASSERT(out.min == 0 && out.max == kLayerSize);
+  KATANA_LOG_ASSERT(out.mean == 75);
+  KATANA_LOG_ASSERT(out.max_node == 0);
+  // Powers of two: 0, [1, 2), ..., [64, 128)
+  KATANA_LOG_ASSERT(out.counts.size() == 8 && out.bin_starts.size() == 8);
+  KATANA_LOG_ASSERT(out.bin_starts[7] == 64);
+  KATANA_LOG_ASSERT(out.counts[0] == kLayerSize);
+  KATANA_LOG_ASSERT(out.counts[7] == 3 * kLayerSize);
+
+  const auto& in = stats.in_degree;
+  KATANA_LOG_ASSERT(in.max == kLayerSize && in.max_node == kLayerSize);
+  KATANA_LOG_ASSERT(in.counts[0] == kLayerSize);
+
+  KATANA_LOG_ASSERT(stats.node_properties.size() == 1);
+  const auto& value = stats.node_properties[0];
+  KATANA_LOG_ASSERT(value.name == "value" && value.type == "int64");
+  KATANA_LOG_ASSERT(value.stats.min == 0);
+  KATANA_LOG_ASSERT(value.stats.max == kLayerSize * kNumLayers - 1);
+
+  options.num_bins = 10;
+  auto binned_res = katana::analytics::GraphStats::Compute(*g, options);
+  KATANA_LOG_ASSERT(binned_res);
+  const auto& binned = binned_res.value().out_degree;
+  KATANA_LOG_ASSERT(binned.counts.size() == 10);
+  KATANA_LOG_ASSERT(binned.counts[0] == kLayerSize);
+  KATANA_LOG_ASSERT(binned.counts[9] == 3 * kLayerSize);
+
+  nlohmann::json j = stats_res.value();
+  KATANA_LOG_ASSERT(j["out_degree"]["max"] == kLayerSize);
+  KATANA_LOG_ASSERT(j["node_properties"][0]["name"] == "value");
+}
+
+void
+TestDiameter() {
+  auto g = MakeLayeredGraph();
+  katana::analytics::GraphStatsOptions options;
+  options.log2_registers = 10;
+  auto stats_res = katana::analytics::GraphStats::Compute(*g, options);
+  KATANA_LOG_VASSERT(stats_res, "{}", stats_res.error());
+  KATANA_LOG_ASSERT(stats_res.value().neighborhood);
+  const auto& neighborhood = *stats_res.value().neighborhood;
+
+  KATANA_LOG_ASSERT(neighborhood.diameter == kNumLayers - 1);
+  KATANA_LOG_ASSERT(!neighborhood.truncated);
+  KATANA_LOG_ASSERT(neighborhood.pairs.size() == kNumLayers);
+  // A node of layer l reaches itself and the kNumLayers - 1 - l layers after
+  double expected = 0;
+  for (Node l = 0; l < kNumLayers; ++l) {
+    expected += kLayerSize * (1 + kLayerSize * (kNumLayers - 1 - l));
+  }
+  double estimate = neighborhood.pairs.back();
+  KATANA_LOG_VASSERT(
+      std::abs(estimate - expected) < 0.15 * expected, "{} pairs, not {}",
+      estimate, expected);
+  KATANA_LOG_ASSERT(
+      neighborhood.effective_diameter > 2 &&
+      neighborhood.effective_diameter <= 3);
+
+  options.max_hops = 1;
+  auto truncated_res = katana::analytics::GraphStats::Compute(*g, options);
+  KATANA_LOG_ASSERT(truncated_res);
+  KATANA_LOG_ASSERT(truncated_res.value().neighborhood->truncated);
+
+  options.log2_registers = 2;
+  KATANA_LOG_ASSERT(!katana::analytics::GraphStats::Compute(*g, options));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestDegrees();
+  TestDiameter();
+
+  return 0;
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/HubSplitting.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace {
+
+using katana::analytics::PagerankPlan;
+
+constexpr size_t kNumNodes = 500;
+constexpr uint64_t kMaxDegree = 16;
+constexpr float kTolerance = 1.0e-7;
+
+/// Node 0 links to every node, every node links to node 1 and the rest have
+/// a few edges, so that there is one out-hub and one in-hub
+class SkewedPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id == 0) {
+      for (size_t i = 1; i < num_nodes; ++i) {
+        r.emplace_back(i);
+      }
+      return r;
+    }
+    r.emplace_back(1);
+    for (size_t i = 0; i < node_id % 5; ++i) {
+      r.emplace_back((node_id * 31 + i * 97) % num_nodes);
+    }
+    return r;
+  }
+};
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  SkewedPolicy policy;
+  return MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+}
+
+std::vector<uint64_t>
+InDegrees(const katana::GraphTopology& topology) {
+  std::vector<uint64_t> in_degrees(topology.num_nodes());
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    in_degrees[topology.edge_dest(e)] += 1;
+  }
+  return in_degrees;
+}
+
+void
+TestView() {
+  auto g = MakeGraph();
+  KATANA_LOG_ASSERT(!g->SplitHubs(0));
+
+  auto view_result = g->SplitHubs(kMaxDegree);
+  KATANA_LOG_VASSERT(view_result, "{}", view_result.error());
+  std::shared_ptr<const katana::HubSplitView> view = view_result.value();
+
+  const katana::GraphTopology& topology = g->topology();
+  std::vector<uint64_t> in_degrees = InDegrees(topology);
+  KATANA_LOG_ASSERT(view->num_nodes() == topology.num_nodes());
+
+  std::vector<uint32_t> hubs;
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    auto [v_begin, v_end] = view->virtual_nodes(n);
+    uint64_t count = v_end - v_begin;
+    uint64_t degree = std::max<uint64_t>(
+        topology.edges(n).size(), in_degrees[n]);
+    KATANA_LOG_VASSERT(
+        count >= 1 && count * kMaxDegree >= degree,
+        "node {}: {} virtual nodes for degree {}", n, count, degree);
+    if (count > 1) {
+      hubs.emplace_back(n);
+    }
+
+    // The virtual nodes cover the out-edges of n in order
+    uint64_t edge = *topology.edges(n).begin();
+    for (uint64_t v = v_begin; v < v_end; ++v) {
+      KATANA_LOG_ASSERT(view->node(v) == n);
+      auto [e_begin, e_end] = view->edge_range(v);
+      KATANA_LOG_ASSERT(e_begin == edge);
+      KATANA_LOG_ASSERT(e_end - e_begin <= kMaxDegree);
+      edge = e_end;
+
+      uint64_t target = view->PushTarget(n, v);
+      KATANA_LOG_ASSERT(target >= v_begin && target < v_end);
+    }
+    KATANA_LOG_ASSERT(edge == *topology.edges(n).end());
+  }
+  KATANA_LOG_ASSERT(std::equal(
+      hubs.begin(), hubs.end(), view->hubs.begin(), view->hubs.end()));
+  KATANA_LOG_ASSERT(hubs.size() >= 2 && hubs[0] == 0 && hubs[1] == 1);
+
+  // Each edge is visited once and each replica of each hub once
+  std::vector<std::atomic<uint64_t>> visits(topology.num_edges());
+  katana::ForEachVirtualNode(
+      *view, [&](uint64_t, uint64_t begin, uint64_t end) {
+        KATANA_LOG_ASSERT(end - begin <= kMaxDegree);
+        for (uint64_t e = begin; e < end; ++e) {
+          visits[e].fetch_add(1);
+        }
+      });
+  for (const auto& count : visits) {
+    KATANA_LOG_ASSERT(count.load() == 1);
+  }
+  std::vector<std::atomic<uint64_t>> replicas(view->num_virtual_nodes());
+  katana::ForEachHubReplica(*view, [&](uint32_t hub, uint64_t v) {
+    KATANA_LOG_ASSERT(view->node(v) == hub);
+    replicas[v].fetch_add(1);
+  });
+  for (uint64_t v = 0; v < view->num_virtual_nodes(); ++v) {
+    bool is_hub = std::binary_search(hubs.begin(), hubs.end(), view->node(v));
+    KATANA_LOG_ASSERT(replicas[v].load() == (is_hub ? 1 : 0));
+  }
+
+  // The view is kept until the topology changes
+  auto again = g->SplitHubs(kMaxDegree);
+  KATANA_LOG_ASSERT(again && again.value() == view);
+  KATANA_LOG_ASSERT(topology.hub_split_view == view);
+}
+
+const float*
+Ranks(const katana::PropertyGraph& g) {
+  auto array = g.GetNodeProperty("rank");
+  KATANA_LOG_ASSERT(array && array->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::FloatArray>(array->chunk(0))
+      ->raw_values();
+}
+
+/// Splitting hubs does not change the ranks of PushSynchronous
+void
+TestPagerank() {
+  auto expected = MakeGraph();
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(
+      expected.get(), "rank", PagerankPlan::PushSynchronous(kTolerance)));
+
+  for (uint64_t hub_degree : {uint64_t{1}, kMaxDegree}) {
+    auto g = MakeGraph();
+    auto plan = PagerankPlan::PushSynchronous(
+        kTolerance, PagerankPlan::kDefaultMaxIterations,
+        PagerankPlan::kDefaultAlpha, hub_degree);
+    auto result = katana::analytics::Pagerank(g.get(), "rank", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+
+    const float* actual_ranks = Ranks(*g);
+    const float* expected_ranks = Ranks(*expected);
+    for (size_t n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::fabs(actual_ranks[n] - expected_ranks[n]) <=
+              1.0e-3 * expected_ranks[n] + 1.0e-6,
+          "node {}: {} != {}", n, actual_ranks[n], expected_ranks[n]);
+    }
+  }
+}
+
+void
+TestSplitHubNodes() {
+  auto g = MakeGraph();
+  const katana::GraphTopology& original = g->topology();
+  std::vector<uint64_t> out_degrees(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    out_degrees[n] = original.edges(n).size();
+  }
+  std::vector<uint64_t> original_in_degrees = InDegrees(original);
+  uint64_t num_edges = g->num_edges();
+  uint64_t num_virtual = g->SplitHubs(kMaxDegree).value()->num_virtual_nodes();
+
+  auto result = katana::SplitHubNodes(g.get(), kMaxDegree, "parent");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  KATANA_LOG_ASSERT(g->num_nodes() == num_virtual);
+  KATANA_LOG_ASSERT(g->num_edges() == num_edges);
+  KATANA_LOG_ASSERT(!katana::SplitHubNodes(g.get(), kMaxDegree, "parent"));
+
+  auto parents_result = g->GetNodePropertyTyped<uint32_t>("parent");
+  KATANA_LOG_VASSERT(parents_result, "{}", parents_result.error());
+  auto parents = parents_result.value();
+  KATANA_LOG_ASSERT(
+      g->node_schema()->num_fields() == 2 &&
+      g->GetNodeProperty(0)->length() == static_cast<int64_t>(num_virtual));
+
+  const katana::GraphTopology& topology = g->topology();
+  std::vector<uint64_t> in_degrees = InDegrees(topology);
+  std::vector<uint64_t> parent_out_degrees(kNumNodes);
+  std::vector<uint64_t> parent_in_degrees(kNumNodes);
+  for (uint32_t v = 0; v < topology.num_nodes(); ++v) {
+    KATANA_LOG_ASSERT(topology.edges(v).size() <= kMaxDegree);
+    KATANA_LOG_ASSERT(v == 0 || parents->Value(v - 1) <= parents->Value(v));
+    parent_out_degrees[parents->Value(v)] += topology.edges(v).size();
+    parent_in_degrees[parents->Value(v)] += in_degrees[v];
+  }
+  KATANA_LOG_ASSERT(parent_out_degrees == out_degrees);
+  KATANA_LOG_ASSERT(parent_in_degrees == original_in_degrees);
+  // The edges into the in-hub are spread over its virtual nodes
+  KATANA_LOG_ASSERT(
+      *std::max_element(in_degrees.begin(), in_degrees.end()) <
+      original_in_degrees[1]);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestView();
+  TestPagerank();
+  TestSplitHubNodes();
+
+  return 0;
+}
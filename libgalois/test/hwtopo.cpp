@@ -19,7 +19,14 @@
 
 #include "katana/HWTopo.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <string>
 
 #include "katana/gIO.h"
 
@@ -61,6 +68,106 @@ test(
   }
 }
 
+std::vector<int>
+osContexts(const katana::HWTopoInfo& t) {
+  std::vector<int> contexts;
+  for (auto& c : t.threadTopoInfo) {
+    contexts.push_back(c.osContext);
+  }
+  return contexts;
+}
+
+std::vector<int>
+sorted(std::vector<int> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+void
+testPlacement() {
+  using namespace katana;
+
+  SetThreadPlacement(ThreadPlacement::kPhysicalCoresFirst);
+  auto physical = getHWTopo();
+  auto all = sorted(osContexts(physical));
+
+  SetThreadPlacement(ThreadPlacement::kCompact);
+  auto compact = getHWTopo();
+  test("compact uses all contexts", sorted(osContexts(compact)), all);
+  for (unsigned i = 1; i < compact.threadTopoInfo.size(); ++i) {
+    auto& prev = compact.threadTopoInfo[i - 1];
+    auto& cur = compact.threadTopoInfo[i];
+    test(
+        "compact fills sockets in order",
+        std::vector<int>{cur.socket == prev.socket ||
+                         cur.socket == prev.socket + 1},
+        std::vector<int>{1});
+  }
+
+  SetThreadPlacement(ThreadPlacement::kScatter);
+  auto scatter = getHWTopo();
+  test("scatter uses all contexts", sorted(osContexts(scatter)), all);
+  test(
+      "scatter alternates sockets",
+      std::vector<int>{scatter.threadTopoInfo.size() < 2 ||
+                       scatter.machineTopoInfo.maxSockets < 2 ||
+                       scatter.threadTopoInfo[1].socket == 1},
+      std::vector<int>{1});
+
+  std::vector<int> list{all.back(), all.front(), all.back()};
+  SetThreadPlacement(ThreadPlacement::kList, list);
+  auto listed = getHWTopo();
+  list.pop_back();
+  if (all.size() == 1) {
+    list.pop_back();
+  }
+  test("list uses listed contexts", osContexts(listed), list);
+  test(
+      "list renumbers sockets",
+      std::vector<int>{(int)listed.threadTopoInfo[0].socket},
+      std::vector<int>{0});
+
+  SetThreadPlacement(ThreadPlacement::kList, {-1});
+  test(
+      "list outside of cpuset", osContexts(getHWTopo()),
+      osContexts(physical));
+
+  SetThreadPlacement(ThreadPlacement::kPhysicalCoresFirst);
+  test(
+      "physical order is stable", osContexts(getHWTopo()),
+      osContexts(physical));
+}
+
+void
+testCache() {
+  using namespace katana;
+
+  SetThreadPlacement(ThreadPlacement::kPhysicalCoresFirst);
+  auto parsed = osContexts(getHWTopo());
+
+  std::string path = "/tmp/hwtopo-cache-" + std::to_string(getpid());
+  setenv("KATANA_HWTOPO_CACHE", path.c_str(), 1);
+  // Changing the placement makes getHWTopo read the topology again: the
+  // first time it writes the cache and the second time it reads it
+  SetThreadPlacement(ThreadPlacement::kCompact);
+  getHWTopo();
+  test(
+      "cache is written", std::vector<int>{std::ifstream(path).good()},
+      std::vector<int>{1});
+  SetThreadPlacement(ThreadPlacement::kPhysicalCoresFirst);
+  test("cache is read", osContexts(getHWTopo()), parsed);
+
+  // A cache from another machine is ignored and replaced
+  std::ofstream(path) << "katana-hwtopo 1 elsewhere 1\n0 0 1 0 1 0\n";
+  SetThreadPlacement(ThreadPlacement::kCompact);
+  getHWTopo();
+  SetThreadPlacement(ThreadPlacement::kPhysicalCoresFirst);
+  test("foreign cache is ignored", osContexts(getHWTopo()), parsed);
+
+  unsetenv("KATANA_HWTOPO_CACHE");
+  std::remove(path.c_str());
+}
+
 int
 main() {
   printMyTopo();
@@ -82,5 +189,8 @@ main() {
       "parse range", parseCPUList("     0-4   \n"),
       std::vector<int>{0, 1, 2, 3, 4});
 
+  testPlacement();
+  testCache();
+
   return 0;
 }
@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/HyperGraph.h"
+#include "katana/Logging.h"
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  constexpr uint32_t kHedges = 1000;
+  constexpr uint32_t kHnodes = 5000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint32_t> hedge(0, kHedges - 1);
+  std::uniform_int_distribution<uint32_t> hnode(0, kHnodes - 1);
+
+  // Hyperedge 0 has no pins
+  std::vector<std::pair<uint32_t, uint32_t>> pins;
+  std::vector<std::vector<uint32_t>> expected(kHedges);
+  for (int i = 0; i < 20000; ++i) {
+    uint32_t h = hedge(gen);
+    if (h == 0) {
+      continue;
+    }
+    pins.emplace_back(h, hnode(gen));
+    expected[h].emplace_back(kHedges + pins.back().second);
+  }
+
+  katana::HyperGraph<uint32_t> graph;
+  graph.constructFromPins(kHedges, kHnodes, pins);
+  KATANA_LOG_ASSERT(graph.GetHedges() == kHedges);
+  KATANA_LOG_ASSERT(graph.GetHnodes() == kHnodes);
+  KATANA_LOG_ASSERT(graph.size() == kHedges + kHnodes);
+  KATANA_LOG_ASSERT(graph.sizeEdges() == pins.size());
+
+  // The nodes of each hyperedge in the order of the pins
+  for (uint32_t h = 0; h < kHedges; ++h) {
+    std::vector<uint32_t> dsts;
+    for (auto e : graph.edges(h)) {
+      dsts.emplace_back(graph.getEdgeDst(e));
+    }
+    KATANA_LOG_ASSERT(dsts == expected[h]);
+  }
+  for (uint32_t n = kHedges; n < kHedges + kHnodes; ++n) {
+    KATANA_LOG_ASSERT(graph.edge_begin(n) == graph.edge_end(n));
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+
+namespace {
+
+using katana::analytics::HypergraphPartitionPlan;
+using katana::analytics::HypergraphPartitionStatistics;
+
+constexpr uint32_t kNumNodes = 1 << 13;
+constexpr uint32_t kHyperedgeSize = 3;
+
+/// The bipartite form of a ring hypergraph: hyperedge i, which is node i of
+/// the graph, contains ring nodes i to i + kHyperedgeSize - 1, and ring node
+/// j is node kNumNodes + j of the graph
+class RingHypergraphPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, [[maybe_unused]] size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id >= kNumNodes) {
+      return r;
+    }
+    for (size_t i = 0; i < kHyperedgeSize; ++i) {
+      r.emplace_back(kNumNodes + (node_id + i) % kNumNodes);
+    }
+    return r;
+  }
+};
+
+std::vector<std::pair<uint32_t, uint32_t>>
+RingPins() {
+  std::vector<std::pair<uint32_t, uint32_t>> pins;
+  for (uint32_t h = 0; h < kNumNodes; ++h) {
+    for (uint32_t i = 0; i < kHyperedgeSize; ++i) {
+      pins.emplace_back(h, (h + i) % kNumNodes);
+    }
+  }
+  return pins;
+}
+
+/// Partition g and check the partition is valid, balanced and cuts far
+/// fewer hyperedges than assigning nodes round robin
+void
+TestHypergraphPartition(katana::PropertyGraph* g, uint32_t num_partitions) {
+  auto result =
+      katana::analytics::HypergraphPartition(g, num_partitions, "part");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid_result = katana::analytics::HypergraphPartitionAssertValid(
+      g, num_partitions, "part");
+  KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+  auto stats_result =
+      HypergraphPartitionStatistics::Compute(g, num_partitions, "part");
+  KATANA_LOG_ASSERT(stats_result);
+  HypergraphPartitionStatistics stats = stats_result.value();
+  stats.Print();
+
+  KATANA_LOG_VASSERT(
+      stats.node_imbalance < 1.3, "imbalance {}", stats.node_imbalance);
+  KATANA_LOG_VASSERT(
+      stats.cut_hyperedges * 10 < kNumNodes, "{} of {} hyperedges cut",
+      stats.cut_hyperedges, kNumNodes);
+  KATANA_LOG_ASSERT(stats.connectivity >= stats.cut_hyperedges);
+
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("part"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RingHypergraphPolicy policy;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(2 * kNumNodes, 0, &policy);
+
+  for (uint32_t num_partitions : {2, 3, 8}) {
+    TestHypergraphPartition(g.get(), num_partitions);
+  }
+
+  // Every node in one partition cuts nothing
+  KATANA_LOG_ASSERT(katana::analytics::HypergraphPartition(g.get(), 1, "part"));
+  auto stats = HypergraphPartitionStatistics::Compute(g.get(), 1, "part");
+  KATANA_LOG_ASSERT(stats && stats.value().cut_hyperedges == 0);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::HypergraphPartitionAssertValid(g.get(), 0, "part"));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("part"));
+
+  KATANA_LOG_ASSERT(
+      !katana::analytics::HypergraphPartition(g.get(), 0, "part"));
+
+  // Nodes joined to nodes are not the bipartite form of a hypergraph
+  LinePolicy line{2};
+  std::unique_ptr<katana::PropertyGraph> ring =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &line);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::HypergraphPartition(ring.get(), 2, "part"));
+
+  // Deterministic plans give the same partition for any number of threads
+  HypergraphPartitionPlan plan = HypergraphPartitionPlan::BiPart(
+      HypergraphPartitionPlan::kDefaultMatchingPolicy,
+      HypergraphPartitionPlan::kDefaultMaxCoarseningLevels, true);
+  std::vector<std::vector<uint32_t>> parts;
+  for (uint32_t threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    auto parts_result = katana::analytics::HypergraphPartition(
+        kNumNodes, kNumNodes, RingPins(), 4, plan);
+    KATANA_LOG_VASSERT(parts_result, "{}", parts_result.error());
+    KATANA_LOG_ASSERT(parts_result.value().size() == kNumNodes);
+    parts.emplace_back(std::move(parts_result.value()));
+  }
+  KATANA_LOG_ASSERT(parts[0] == parts[1]);
+
+  // Pins out of range are rejected
+  KATANA_LOG_ASSERT(!katana::analytics::HypergraphPartition(
+      1, 1, {{0, 0}, {0, 1}}, 2, plan));
+
+  return 0;
+}
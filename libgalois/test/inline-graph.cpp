@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/LC_InlineEdge_Graph.h"
+#include "katana/LC_Linear_Graph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ReadGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+uint32_t
+Weight(uint64_t edge) {
+  return (edge * 7919) % 100 + 1;
+}
+
+/// Shortest distances from node 0, written only against the interface that
+/// the LC graphs share
+template <typename Graph>
+std::vector<uint32_t>
+ShortestPaths(Graph& g, const std::vector<typename Graph::GraphNode>& nodes) {
+  using Item = std::pair<uint32_t, typename Graph::GraphNode>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
+  for (auto n : g) {
+    g.getData(n) = kInfinity;
+  }
+  g.getData(nodes[0]) = 0;
+  queue.emplace(0, nodes[0]);
+  while (!queue.empty()) {
+    auto [dist, n] = queue.top();
+    queue.pop();
+    if (dist > g.getData(n)) {
+      continue;
+    }
+    for (auto e : g.edges(n)) {
+      auto dst = g.getEdgeDst(e);
+      uint32_t new_dist = dist + g.getEdgeData(e);
+      if (new_dist < g.getData(dst)) {
+        g.getData(dst) = new_dist;
+        queue.emplace(new_dist, dst);
+      }
+    }
+  }
+
+  std::vector<uint32_t> dists;
+  for (auto n : nodes) {
+    dists.emplace_back(g.getData(n));
+  }
+  return dists;
+}
+
+/// Check that g has the topology of pg with the weights of the edges
+template <typename Graph>
+void
+TestGraph(const katana::PropertyGraph& pg) {
+  Graph g;
+  auto res = katana::readPropertyGraph(g, pg, "weight");
+  KATANA_LOG_ASSERT(res);
+  const katana::GraphTopology& topology = pg.topology();
+  KATANA_LOG_ASSERT(g.size() == topology.num_nodes());
+  KATANA_LOG_ASSERT(g.sizeEdges() == topology.num_edges());
+
+  std::vector<typename Graph::GraphNode> nodes;
+  std::unordered_map<typename Graph::GraphNode, Node> ids;
+  for (auto n : g) {
+    ids.emplace(n, nodes.size());
+    nodes.emplace_back(n);
+  }
+  KATANA_LOG_ASSERT(nodes.size() == topology.num_nodes());
+
+  for (auto n : topology) {
+    auto e = g.edge_begin(nodes[n]);
+    for (auto edge : topology.edges(n)) {
+      KATANA_LOG_ASSERT(e != g.edge_end(nodes[n]));
+      KATANA_LOG_ASSERT(ids.at(g.getEdgeDst(e)) == topology.edge_dest(edge));
+      KATANA_LOG_ASSERT(g.getEdgeData(e) == Weight(edge));
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == g.edge_end(nodes[n]));
+  }
+
+  // Against the same search over the topology
+  std::vector<uint32_t> expected(topology.num_nodes(), kInfinity);
+  using Item = std::pair<uint32_t, Node>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  expected[0] = 0;
+  queue.emplace(0, 0);
+  while (!queue.empty()) {
+    auto [dist, n] = queue.top();
+    queue.pop();
+    if (dist > expected[n]) {
+      continue;
+    }
+    for (auto edge : topology.edges(n)) {
+      Node dst = topology.edge_dest(edge);
+      if (dist + Weight(edge) < expected[dst]) {
+        expected[dst] = dist + Weight(edge);
+        queue.emplace(expected[dst], dst);
+      }
+    }
+  }
+  KATANA_LOG_ASSERT(ShortestPaths(g, nodes) == expected);
+}
+
+void
+TestErrors(const katana::PropertyGraph& pg) {
+  katana::LC_InlineEdge_Graph<uint32_t, uint32_t> g;
+  KATANA_LOG_ASSERT(!katana::readPropertyGraph(g, pg, "no such property"));
+
+  katana::LC_InlineEdge_Graph<uint32_t, uint64_t> wrong_type;
+  auto res = katana::readPropertyGraph(wrong_type, pg, "weight");
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::TypeError);
+
+  katana::LC_Linear_Graph<uint32_t, void> no_data;
+  KATANA_LOG_ASSERT(!katana::readPropertyGraph(no_data, pg, "weight"));
+
+  // Without a property, edge values are default constructed
+  KATANA_LOG_ASSERT(katana::readPropertyGraph(no_data, pg));
+  KATANA_LOG_ASSERT(no_data.sizeEdges() == pg.topology().num_edges());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy policy{4};
+  auto pg = MakeFileGraph<uint32_t>(10000, 0, &policy);
+  std::vector<uint32_t> weights(pg->num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = Weight(e);
+  }
+  auto add_res = pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)}));
+  KATANA_LOG_ASSERT(add_res);
+
+  using InlineGraph = katana::LC_InlineEdge_Graph<uint32_t, uint32_t>;
+  TestGraph<InlineGraph>(*pg);
+  TestGraph<InlineGraph::with_compressed_node_ptr<true>::type>(*pg);
+  TestGraph<InlineGraph::with_numa_alloc<true>::type>(*pg);
+  using LinearGraph = katana::LC_Linear_Graph<uint32_t, uint32_t>;
+  TestGraph<LinearGraph>(*pg);
+  TestGraph<LinearGraph::with_numa_alloc<true>::type>(*pg);
+  TestErrors(*pg);
+
+  return 0;
+}
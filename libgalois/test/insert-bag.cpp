@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1 << 20;
+constexpr size_t kChunkSize = 64;
+
+void
+CheckFlatten(const katana::InsertBag<uint32_t>& bag) {
+  KATANA_LOG_ASSERT(bag.size() == kNumItems);
+
+  katana::LargeArray<uint32_t> flat = bag.Flatten();
+  KATANA_LOG_ASSERT(flat.size() == kNumItems);
+  KATANA_LOG_ASSERT(std::equal(flat.begin(), flat.end(), bag.begin()));
+
+  std::sort(flat.begin(), flat.end());
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_ASSERT(flat[i] == i);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  katana::InsertBag<uint32_t> bag;
+  KATANA_LOG_ASSERT(bag.size() == 0);
+  KATANA_LOG_ASSERT(bag.Flatten().size() == 0);
+  KATANA_LOG_ASSERT(bag.Chunks().empty());
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumItems), [&](uint32_t i) { bag.push(i); },
+      katana::steal());
+  CheckFlatten(bag);
+
+  // Lists pushed by threads that are no longer active are still copied
+  katana::setActiveThreads(1);
+  CheckFlatten(bag);
+  katana::setActiveThreads(4);
+
+  auto chunks = bag.Chunks(kChunkSize);
+  KATANA_LOG_ASSERT(chunks.size() >= kNumItems / kChunkSize);
+  katana::GAccumulator<uint64_t> sum;
+  katana::GAccumulator<uint64_t> count;
+  katana::do_all(
+      katana::iterate(chunks),
+      [&](const auto& chunk) {
+        KATANA_LOG_ASSERT(chunk.size() > 0 && chunk.size() <= kChunkSize);
+        for (uint32_t v : chunk) {
+          sum += v;
+          count += 1;
+        }
+      },
+      katana::steal());
+  KATANA_LOG_ASSERT(count.reduce() == kNumItems);
+  KATANA_LOG_ASSERT(
+      sum.reduce() == uint64_t{kNumItems} * (kNumItems - 1) / 2);
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "katana/Interleave.h"
+
+#include <atomic>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// A task that takes item % 7 + 1 steps and counts them
+auto
+CountingTask(
+    uint32_t item, std::vector<std::atomic<uint32_t>>* steps,
+    std::vector<std::atomic<uint32_t>>* finished) {
+  return [=, left = item % 7]() mutable {
+    (*steps)[item] += 1;
+    if (left == 0) {
+      (*finished)[item] += 1;
+      return false;
+    }
+    --left;
+    return true;
+  };
+}
+
+void
+Check(
+    const std::vector<std::atomic<uint32_t>>& steps,
+    const std::vector<std::atomic<uint32_t>>& finished) {
+  for (uint32_t i = 0; i < steps.size(); ++i) {
+    KATANA_LOG_VASSERT(steps[i] == i % 7 + 1, "item {}", i);
+    KATANA_LOG_VASSERT(finished[i] == 1, "item {}", i);
+  }
+}
+
+/// Every task runs all of its steps and finishes once
+template <unsigned Width>
+void
+TestInterleaveTasks(uint32_t num_items) {
+  std::vector<std::atomic<uint32_t>> steps(num_items);
+  std::vector<std::atomic<uint32_t>> finished(num_items);
+  katana::InterleaveTasks<Width>(
+      boost::counting_iterator<uint32_t>(0),
+      boost::counting_iterator<uint32_t>(num_items),
+      [&](uint32_t i) { return CountingTask(i, &steps, &finished); });
+  Check(steps, finished);
+}
+
+/// Tasks of different items take turns, so that Width are in flight
+void
+TestTurns() {
+  std::vector<uint32_t> order;
+  katana::InterleaveTasks<2>(
+      boost::counting_iterator<uint32_t>(0),
+      boost::counting_iterator<uint32_t>(3), [&](uint32_t i) {
+        return [&order, i, left = 1]() mutable {
+          order.emplace_back(i);
+          return left-- > 0;
+        };
+      });
+  std::vector<uint32_t> expected{0, 1, 0, 1, 2, 2};
+  KATANA_LOG_ASSERT(order == expected);
+}
+
+/// do_all with an interleave option runs a task for every item once
+template <typename... Args>
+void
+TestDoAllInterleave(uint32_t num_items, Args... args) {
+  std::vector<std::atomic<uint32_t>> steps(num_items);
+  std::vector<std::atomic<uint32_t>> finished(num_items);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i) { return CountingTask(i, &steps, &finished); },
+      katana::interleave<4>(), args...);
+  Check(steps, finished);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestInterleaveTasks<1>(100);
+  TestInterleaveTasks<8>(0);
+  TestInterleaveTasks<8>(5);
+  TestInterleaveTasks<8>(1000);
+  TestTurns();
+
+  TestDoAllInterleave(3);
+  TestDoAllInterleave(10000);
+  TestDoAllInterleave(10000, katana::steal());
+  TestDoAllInterleave(
+      10000, katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("InterleaveSteal"));
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/analytics/Intersection.h"
+
+namespace {
+
+std::vector<uint32_t>
+MakeSortedSet(std::mt19937* gen, size_t size, uint32_t max) {
+  std::uniform_int_distribution<uint32_t> dist(0, max);
+  std::set<uint32_t> values;
+  while (values.size() < size) {
+    values.emplace(dist(*gen));
+  }
+  return std::vector<uint32_t>(values.begin(), values.end());
+}
+
+void
+TestIntersection(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  const uint32_t* a_begin = a.data();
+  const uint32_t* a_end = a.data() + a.size();
+  const uint32_t* b_begin = b.data();
+  const uint32_t* b_end = b.data() + b.size();
+
+  uint64_t count = katana::analytics::CountSortedIntersection(
+      a_begin, a_end, b_begin, b_end);
+  KATANA_LOG_VASSERT(
+      count == expected.size(), "{}: count {} expected {}",
+      katana::analytics::SortedIntersectionKernel(), count, expected.size());
+
+  std::vector<uint32_t> out(std::min(a.size(), b.size()));
+  size_t num = katana::analytics::SortedIntersection(
+      a_begin, a_end, b_begin, b_end, out.data());
+  out.resize(num);
+  KATANA_LOG_VASSERT(
+      out == expected, "{}: intersection differs",
+      katana::analytics::SortedIntersectionKernel());
+}
+
+}  // namespace
+
+int
+main() {
+  std::mt19937 gen(0);
+
+  TestIntersection({}, {});
+  TestIntersection({1, 2, 3}, {});
+
+  // Sizes around the block sizes of the vector kernels, with dense and
+  // sparse overlaps
+  for (size_t a_size : {1, 7, 8, 9, 15, 16, 17, 100, 127, 128, 129, 1000}) {
+    for (size_t b_size : {1, 8, 16, 33, 128, 300, 2000}) {
+      for (uint32_t max : {2500, 100000}) {
+        auto a = MakeSortedSet(&gen, a_size, max);
+        auto b = MakeSortedSet(&gen, b_size, max);
+        TestIntersection(a, b);
+        TestIntersection(b, a);
+        TestIntersection(a, a);
+      }
+    }
+  }
+
+  return 0;
+}
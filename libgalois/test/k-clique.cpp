@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/k_clique/k_clique.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+using katana::analytics::LocalClusteringCoefficientPlan;
+using katana::analytics::TriangleCountPlan;
+
+using Neighbors = std::vector<std::set<uint32_t>>;
+
+/// Make random clusters of densely connected nodes with a few edges between
+/// clusters
+Neighbors
+MakeClusters(uint32_t num_nodes, uint32_t cluster_size, std::mt19937* gen) {
+  std::uniform_real_distribution<double> coin(0, 1);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  Neighbors neighbors(num_nodes);
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    if (a != b) {
+      neighbors[a].emplace(b);
+      neighbors[b].emplace(a);
+    }
+  };
+  for (uint32_t a = 0; a < num_nodes; ++a) {
+    uint32_t cluster_end =
+        std::min(num_nodes, (a / cluster_size + 1) * cluster_size);
+    for (uint32_t b = a + 1; b < cluster_end; ++b) {
+      if (coin(*gen) < 0.6) {
+        add_edge(a, b);
+      }
+    }
+    add_edge(a, node(*gen));
+  }
+  return neighbors;
+}
+
+/// Make a graph of neighbors whose edges are in random order. If repeats is
+/// set, every third node also gets a self loop and repeats its first edge.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Neighbors& neighbors, bool repeats, std::mt19937* gen) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < neighbors.size(); ++n) {
+    std::vector<uint32_t> local(neighbors[n].begin(), neighbors[n].end());
+    if (repeats && n % 3 == 0 && !local.empty()) {
+      local.emplace_back(n);
+      local.emplace_back(local.front());
+    }
+    std::shuffle(local.begin(), local.end(), *gen);
+    dests.insert(dests.end(), local.begin(), local.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// Count the cliques that extend clique by k more nodes of higher id
+uint64_t
+SerialCliques(
+    const Neighbors& neighbors, std::vector<uint32_t>* clique, uint32_t k) {
+  if (k == 0) {
+    return 1;
+  }
+  uint64_t count = 0;
+  uint32_t first = clique->empty() ? 0 : clique->back() + 1;
+  for (uint32_t n = first; n < neighbors.size(); ++n) {
+    bool adjacent = true;
+    for (uint32_t c : *clique) {
+      adjacent = adjacent && neighbors[c].count(n) > 0;
+    }
+    if (adjacent) {
+      clique->emplace_back(n);
+      count += SerialCliques(neighbors, clique, k - 1);
+      clique->pop_back();
+    }
+  }
+  return count;
+}
+
+void
+TestOrientation(katana::PropertyGraph* g, const Neighbors& neighbors) {
+  auto dag_result = g->OrientByDegree();
+  KATANA_LOG_VASSERT(dag_result, "{}", dag_result.error());
+  const katana::DegreeOrderedDag& dag = *dag_result.value();
+
+  // Each edge points from lower to higher (degree, id) exactly once
+  auto rank = [&](uint32_t n) {
+    return std::make_pair(g->topology().edges(n).size(), n);
+  };
+  uint64_t num_edges = 0;
+  for (uint32_t n = 0; n < neighbors.size(); ++n) {
+    auto [begin, end] = dag.OutNeighbors(n);
+    std::vector<uint32_t> expected;
+    for (uint32_t v : neighbors[n]) {
+      if (rank(n) < rank(v)) {
+        expected.emplace_back(v);
+      }
+    }
+    KATANA_LOG_ASSERT(std::vector<uint32_t>(begin, end) == expected);
+    KATANA_LOG_ASSERT(expected.size() <= dag.max_out_degree);
+    num_edges += neighbors[n].size();
+  }
+  KATANA_LOG_ASSERT(dag.num_edges() * 2 == num_edges);
+
+  // The orientation is built once
+  auto again = g->OrientByDegree();
+  KATANA_LOG_ASSERT(again && again.value() == dag_result.value());
+}
+
+void
+TestCliques(katana::PropertyGraph* g, const Neighbors& neighbors) {
+  for (uint32_t k = 1; k <= 5; ++k) {
+    std::vector<uint32_t> clique;
+    uint64_t expected = SerialCliques(neighbors, &clique, k);
+    auto count = katana::analytics::KCliqueCount(g, k);
+    KATANA_LOG_VASSERT(count, "{}", count.error());
+    KATANA_LOG_VASSERT(
+        count.value() == expected, "k {}: {} expected {}", k, count.value(),
+        expected);
+  }
+  KATANA_LOG_ASSERT(!katana::analytics::KCliqueCount(g, 0));
+}
+
+/// Assert that cliques holds each clique of k nodes once
+void
+AssertAllCliques(
+    const Neighbors& neighbors, const std::vector<std::vector<uint32_t>>& all,
+    uint32_t k) {
+  std::set<std::vector<uint32_t>> unique;
+  for (std::vector<uint32_t> clique : all) {
+    KATANA_LOG_ASSERT(clique.size() == k);
+    for (size_t i = 0; i < k; ++i) {
+      for (size_t j = i + 1; j < k; ++j) {
+        KATANA_LOG_ASSERT(neighbors[clique[i]].count(clique[j]) > 0);
+      }
+    }
+    std::sort(clique.begin(), clique.end());
+    unique.emplace(clique);
+  }
+  std::vector<uint32_t> clique;
+  uint64_t expected = SerialCliques(neighbors, &clique, k);
+  KATANA_LOG_VASSERT(
+      unique.size() == all.size() && all.size() == expected,
+      "k {}: {} unique of {} expected {}", k, unique.size(), all.size(),
+      expected);
+}
+
+void
+TestListing(katana::PropertyGraph* g, const Neighbors& neighbors) {
+  for (uint32_t k = 1; k <= 4; ++k) {
+    std::mutex mutex;
+    std::vector<std::vector<uint32_t>> all;
+    auto count = katana::analytics::KCliqueList(g, k, [&](const uint32_t* n) {
+      std::lock_guard<std::mutex> lock(mutex);
+      all.emplace_back(n, n + k);
+    });
+    KATANA_LOG_VASSERT(count, "{}", count.error());
+    KATANA_LOG_ASSERT(count.value() == all.size());
+    AssertAllCliques(neighbors, all, k);
+  }
+
+  // Small batches so that every thread hands over full and partial batches
+  constexpr size_t kBatchRows = 7;
+  for (uint32_t k = 3; k <= 4; ++k) {
+    std::mutex mutex;
+    std::vector<std::vector<uint32_t>> all;
+    auto count = katana::analytics::KCliqueListBatches(
+        g, k,
+        [&](const std::shared_ptr<arrow::RecordBatch>& batch)
+            -> katana::Result<void> {
+          KATANA_LOG_ASSERT(batch->num_columns() == static_cast<int>(k));
+          KATANA_LOG_ASSERT(
+              batch->num_rows() > 0 &&
+              batch->num_rows() <= static_cast<int64_t>(kBatchRows));
+          std::lock_guard<std::mutex> lock(mutex);
+          for (int64_t row = 0; row < batch->num_rows(); ++row) {
+            std::vector<uint32_t> clique;
+            for (uint32_t i = 0; i < k; ++i) {
+              clique.emplace_back(
+                  std::static_pointer_cast<arrow::UInt32Array>(
+                      batch->column(i))
+                      ->Value(row));
+            }
+            all.emplace_back(clique);
+          }
+          return katana::ResultSuccess();
+        },
+        kBatchRows);
+    KATANA_LOG_VASSERT(count, "{}", count.error());
+    KATANA_LOG_ASSERT(count.value() == all.size());
+    AssertAllCliques(neighbors, all, k);
+  }
+
+  // A failing consumer stops the listing
+  auto failed = katana::analytics::KCliqueListBatches(
+      g, 3,
+      [](const std::shared_ptr<arrow::RecordBatch>&) -> katana::Result<void> {
+        return katana::ErrorCode::NotImplemented;
+      },
+      kBatchRows);
+  KATANA_LOG_ASSERT(!failed);
+  KATANA_LOG_ASSERT(failed.error() == katana::ErrorCode::NotImplemented);
+  KATANA_LOG_ASSERT(!katana::analytics::KCliqueListBatches(
+      g, 3,
+      [](const std::shared_ptr<arrow::RecordBatch>&) {
+        return katana::ResultSuccess();
+      },
+      0));
+}
+
+/// Relabeling counts over the cached orientation and must agree with the
+/// counts over the node ids, which need a graph without repeated edges
+void
+TestSharedOrientation(katana::PropertyGraph* g, const Neighbors& neighbors) {
+  std::vector<uint32_t> clique;
+  uint64_t expected = SerialCliques(neighbors, &clique, 3);
+  for (auto relabeling :
+       {TriangleCountPlan::kRelabel, TriangleCountPlan::kNoRelabel}) {
+    auto count = katana::analytics::TriangleCount(
+        g, TriangleCountPlan::OrderedCount(false, relabeling));
+    KATANA_LOG_VASSERT(count, "{}", count.error());
+    KATANA_LOG_ASSERT(count.value() == expected);
+  }
+
+  for (auto relabeling :
+       {LocalClusteringCoefficientPlan::kRelabel,
+        LocalClusteringCoefficientPlan::kNoRelabel}) {
+    bool relabel = relabeling == LocalClusteringCoefficientPlan::kRelabel;
+    for (auto plan :
+         {LocalClusteringCoefficientPlan::LocalClusteringCoefficientAtomics(
+              false, relabeling),
+          LocalClusteringCoefficientPlan::LocalClusteringCoefficientPerThread(
+              false, relabeling)}) {
+      std::string name = "lcc" + std::to_string(plan.algorithm()) +
+                         (relabel ? "-relabel" : "");
+      auto result =
+          katana::analytics::LocalClusteringCoefficient(g, name, plan);
+      KATANA_LOG_VASSERT(result, "{}", result.error());
+      auto lcc = g->GetNodePropertyTyped<double>(name);
+      KATANA_LOG_VASSERT(lcc, "{}", lcc.error());
+      for (uint32_t n = 0; n < neighbors.size(); ++n) {
+        uint64_t closed = 0;
+        for (uint32_t a : neighbors[n]) {
+          for (uint32_t b : neighbors[n]) {
+            closed += neighbors[a].count(b);
+          }
+        }
+        double degree = neighbors[n].size();
+        double value = lcc.value()->Value(n);
+        if (degree > 1) {
+          KATANA_LOG_VASSERT(
+              std::abs(value - closed / (degree * (degree - 1))) < 1e-12,
+              "{} node {}: {}", name, n, value);
+        }
+      }
+    }
+  }
+
+  // Changing the topology drops the orientation
+  KATANA_LOG_ASSERT(g->topology().degree_ordered_dag);
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = g->topology().out_indices,
+      .out_dests = g->topology().out_dests,
+  }));
+  KATANA_LOG_ASSERT(!g->topology().degree_ordered_dag);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  Neighbors neighbors = MakeClusters(300, 20, &gen);
+  auto g = MakeGraph(neighbors, true, &gen);
+  TestOrientation(g.get(), neighbors);
+  TestCliques(g.get(), neighbors);
+  TestListing(g.get(), neighbors);
+
+  auto simple = MakeGraph(neighbors, false, &gen);
+  TestSharedOrientation(simple.get(), neighbors);
+
+  return 0;
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/KHop.h"
+
+namespace {
+
+using katana::analytics::EgoNetwork;
+using katana::analytics::KHopExpander;
+using katana::analytics::KHopNeighborhoods;
+using katana::analytics::KHopPlan;
+
+constexpr size_t kNumNodes = 2000;
+
+/// The nodes of the neighborhood of query, hop by hop, found by a plain
+/// breadth-first search
+std::vector<uint32_t>
+ExpectedNodes(
+    const katana::GraphTopology& topology, const KHopPlan& plan,
+    uint32_t query, std::vector<uint32_t>* hop_sizes) {
+  uint64_t max_nodes = plan.max_nodes() ? plan.max_nodes() : kNumNodes;
+  std::vector<uint32_t> nodes{query};
+  std::set<uint32_t> seen{query};
+  hop_sizes->assign(1, 1);
+  uint64_t frontier = 0;
+  for (uint32_t hop = 1; hop <= plan.hops(); ++hop) {
+    uint64_t end = nodes.size();
+    std::set<uint32_t> next;
+    for (uint64_t i = frontier; i < end; ++i) {
+      uint64_t followed = 0;
+      for (auto e : topology.edges(nodes[i])) {
+        if (plan.max_fanout() && followed++ == plan.max_fanout()) {
+          break;
+        }
+        uint32_t dest = topology.edge_dest(e);
+        if (seen.insert(dest).second) {
+          next.insert(dest);
+        }
+      }
+    }
+    for (uint32_t node : next) {
+      if (nodes.size() < max_nodes) {
+        nodes.emplace_back(node);
+      }
+    }
+    frontier = end;
+    hop_sizes->emplace_back(nodes.size());
+    if (nodes.size() == max_nodes) {
+      seen.insert(next.begin(), next.end());
+      frontier = nodes.size();
+    }
+  }
+  return nodes;
+}
+
+std::vector<uint32_t>
+Queries() {
+  std::vector<uint32_t> queries;
+  for (uint32_t q = 0; q < kNumNodes; q += 7) {
+    queries.emplace_back(q);
+  }
+  // Queries may repeat
+  queries.emplace_back(0);
+  return queries;
+}
+
+void
+CheckNeighborhoods(
+    const katana::PropertyGraph& g, const KHopPlan& plan,
+    const std::vector<uint32_t>& queries,
+    const KHopNeighborhoods& neighborhoods) {
+  const auto& nodes = *neighborhoods.nodes;
+  const auto& distances = *neighborhoods.distances;
+  KATANA_LOG_ASSERT(nodes.length() == static_cast<int64_t>(queries.size()));
+  const auto& node_values =
+      static_cast<const arrow::UInt32Array&>(*nodes.values());
+  const auto& distance_values =
+      static_cast<const arrow::UInt8Array&>(*distances.values());
+  for (size_t q = 0; q < queries.size(); ++q) {
+    std::vector<uint32_t> hop_sizes;
+    auto expected = ExpectedNodes(g.topology(), plan, queries[q], &hop_sizes);
+    int64_t begin = nodes.value_offset(q);
+    KATANA_LOG_VASSERT(
+        nodes.value_length(q) == static_cast<int64_t>(expected.size()),
+        "query {}: {} nodes, expected {}", queries[q], nodes.value_length(q),
+        expected.size());
+    KATANA_LOG_ASSERT(distances.value_offset(q) == begin);
+    uint32_t hop = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+      while (i >= hop_sizes[hop]) {
+        ++hop;
+      }
+      KATANA_LOG_ASSERT(node_values.Value(begin + i) == expected[i]);
+      KATANA_LOG_ASSERT(distance_values.Value(begin + i) == hop);
+    }
+  }
+}
+
+void
+CheckEgoNetworks(
+    const katana::PropertyGraph& g, const KHopPlan& plan,
+    const std::vector<uint32_t>& queries,
+    const std::vector<EgoNetwork>& networks) {
+  const katana::GraphTopology& topology = g.topology();
+  KATANA_LOG_ASSERT(networks.size() == queries.size());
+  for (size_t q = 0; q < queries.size(); ++q) {
+    const EgoNetwork& network = networks[q];
+    std::vector<uint32_t> hop_sizes;
+    auto expected = ExpectedNodes(topology, plan, queries[q], &hop_sizes);
+    KATANA_LOG_ASSERT(network.hop_sizes == hop_sizes);
+    KATANA_LOG_ASSERT(
+        network.nodes->length() == static_cast<int64_t>(expected.size()));
+    std::map<uint32_t, uint32_t> local;
+    for (size_t i = 0; i < expected.size(); ++i) {
+      KATANA_LOG_ASSERT(network.nodes->Value(i) == expected[i]);
+      local[expected[i]] = i;
+    }
+
+    const katana::GraphTopology& ego = network.topology;
+    KATANA_LOG_ASSERT(ego.num_nodes() == expected.size());
+    KATANA_LOG_ASSERT(
+        network.edges->length() == static_cast<int64_t>(ego.num_edges()));
+    for (uint32_t n = 0; n < expected.size(); ++n) {
+      std::vector<uint64_t> expected_edges;
+      uint64_t followed = 0;
+      for (auto e : topology.edges(expected[n])) {
+        if (plan.max_fanout() && followed++ == plan.max_fanout()) {
+          break;
+        }
+        if (local.count(topology.edge_dest(e)) > 0) {
+          expected_edges.emplace_back(e);
+        }
+      }
+      auto edges = ego.edges(n);
+      KATANA_LOG_ASSERT(edges.size() == expected_edges.size());
+      size_t i = 0;
+      for (auto e : edges) {
+        uint64_t graph_edge = network.edges->Value(e);
+        KATANA_LOG_ASSERT(graph_edge == expected_edges[i++]);
+        KATANA_LOG_ASSERT(
+            expected[ego.edge_dest(e)] == topology.edge_dest(graph_edge));
+      }
+    }
+  }
+}
+
+void
+TestPlan(const katana::PropertyGraph& g, const KHopPlan& plan) {
+  std::vector<uint32_t> queries = Queries();
+  std::shared_ptr<arrow::Array> first_nodes;
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    auto expander_res = KHopExpander::Make(&g, plan);
+    KATANA_LOG_VASSERT(expander_res, "{}", expander_res.error());
+    KHopExpander& expander = *expander_res.value();
+
+    // Twice, so that the second batch reuses the workspaces
+    for (int round = 0; round < 2; ++round) {
+      auto neighborhoods_res = expander.Neighborhoods(queries);
+      KATANA_LOG_VASSERT(neighborhoods_res, "{}", neighborhoods_res.error());
+      CheckNeighborhoods(g, plan, queries, neighborhoods_res.value());
+      if (!first_nodes) {
+        first_nodes = neighborhoods_res.value().nodes;
+      }
+      KATANA_LOG_ASSERT(neighborhoods_res.value().nodes->Equals(*first_nodes));
+
+      auto networks_res = expander.EgoNetworks(queries);
+      KATANA_LOG_VASSERT(networks_res, "{}", networks_res.error());
+      CheckEgoNetworks(g, plan, queries, networks_res.value());
+    }
+
+    // A smaller batch after a larger one
+    std::vector<uint32_t> few(queries.begin(), queries.begin() + 3);
+    auto few_res = expander.Neighborhoods(few);
+    KATANA_LOG_VASSERT(few_res, "{}", few_res.error());
+    CheckNeighborhoods(g, plan, few, few_res.value());
+
+    KATANA_LOG_ASSERT(!expander.Neighborhoods({kNumNodes}));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  TestPlan(*g, KHopPlan());
+  TestPlan(*g, KHopPlan::Hashed(3, 2));
+  TestPlan(*g, KHopPlan::Hashed(2, 0, 10));
+  TestPlan(*g, KHopPlan::Hashed(0));
+
+  KATANA_LOG_ASSERT(!KHopExpander::Make(g.get(), KHopPlan::Hashed(256)));
+
+  return 0;
+}
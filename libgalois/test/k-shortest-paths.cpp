@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace {
+
+using katana::analytics::KShortestPathsPlan;
+using katana::analytics::PathQuery;
+using katana::analytics::WeightedPath;
+
+constexpr size_t kNumNodes = 12;
+constexpr uint32_t kNumPaths = 6;
+
+/// Give g an integer weight property with weights in [min_weight, 4] and a
+/// floating point one, and return the integer weights by edge
+std::vector<int64_t>
+AddWeights(katana::PropertyGraph* g, int64_t min_weight) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> int_dist(min_weight, 4);
+  std::vector<int64_t> int_weights(g->num_edges());
+  std::vector<double> real_weights(g->num_edges());
+  for (size_t e = 0; e < g->num_edges(); ++e) {
+    int_weights[e] = int_dist(gen);
+    real_weights[e] = int_weights[e] * 0.5;
+  }
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("int_weight", arrow::int64()),
+           arrow::field("real_weight", arrow::float64())}),
+      {katana::BuildArray(int_weights), katana::BuildArray(real_weights)})));
+  return int_weights;
+}
+
+std::vector<PathQuery>
+AllPairs() {
+  std::vector<PathQuery> queries;
+  for (uint32_t s = 0; s < kNumNodes; ++s) {
+    for (uint32_t t = 0; t < kNumNodes; ++t) {
+      queries.emplace_back(s, t);
+    }
+  }
+  return queries;
+}
+
+/// The lightest edge from n to m, or -1 if there is none
+int64_t
+LightestEdge(
+    const katana::PropertyGraph& g, const std::vector<int64_t>& weights,
+    uint32_t n, uint32_t m) {
+  int64_t lightest = -1;
+  for (auto e : g.topology().edges(n)) {
+    if (g.topology().edge_dest(e) == m &&
+        (lightest < 0 || weights[e] < lightest)) {
+      lightest = weights[e];
+    }
+  }
+  return lightest;
+}
+
+/// Check that the weights of paths are the first of sorted expected weights,
+/// with integer weights scaled by scale
+void
+CheckWeights(
+    const std::vector<WeightedPath>& paths,
+    const std::vector<int64_t>& expected, double scale) {
+  KATANA_LOG_VASSERT(
+      paths.size() == std::min<size_t>(expected.size(), kNumPaths),
+      "found {} paths, expected {}", paths.size(), expected.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        std::abs(paths[i].weight - expected[i] * scale) < 1e-9,
+        "path {} weighs {}, expected {}", i, paths[i].weight,
+        expected[i] * scale);
+  }
+}
+
+/// Compare KShortestSimplePaths with enumerating every simple path on a
+/// random graph with zero weight edges, self loops and parallel edges
+void
+TestSimplePaths() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::vector<int64_t> weights = AddWeights(g.get(), 0);
+  std::vector<PathQuery> queries = AllPairs();
+
+  for (const auto& [name, scale] :
+       {std::make_pair("int_weight", 1.0),
+        std::make_pair("real_weight", 0.5)}) {
+    for (const auto& plan :
+         {KShortestPathsPlan::DeltaStep(), KShortestPathsPlan::DeltaStep(0)}) {
+      auto result = katana::analytics::KShortestSimplePaths(
+          g.get(), name, queries, kNumPaths, plan);
+      KATANA_LOG_VASSERT(result, "{}", result.error());
+
+      for (size_t q = 0; q < queries.size(); ++q) {
+        auto [source, target] = queries[q];
+        std::vector<int64_t> expected;
+        std::vector<bool> visited(kNumNodes);
+        std::function<void(uint32_t, int64_t)> visit = [&](uint32_t n,
+                                                           int64_t weight) {
+          if (n == target) {
+            expected.emplace_back(weight);
+            return;
+          }
+          visited[n] = true;
+          for (uint32_t m = 0; m < kNumNodes; ++m) {
+            int64_t w = LightestEdge(*g, weights, n, m);
+            if (w >= 0 && !visited[m]) {
+              visit(m, weight + w);
+            }
+          }
+          visited[n] = false;
+        };
+        visit(source, 0);
+        std::sort(expected.begin(), expected.end());
+
+        const auto& paths = result.value()[q];
+        CheckWeights(paths, expected, scale);
+        for (const auto& path : paths) {
+          KATANA_LOG_ASSERT(path.nodes.front() == source);
+          KATANA_LOG_ASSERT(path.nodes.back() == target);
+          std::vector<uint32_t> sorted = path.nodes;
+          std::sort(sorted.begin(), sorted.end());
+          KATANA_LOG_ASSERT(
+              std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+          int64_t weight = 0;
+          for (size_t i = 0; i + 1 < path.nodes.size(); ++i) {
+            int64_t w =
+                LightestEdge(*g, weights, path.nodes[i], path.nodes[i + 1]);
+            KATANA_LOG_ASSERT(w >= 0);
+            weight += w;
+          }
+          KATANA_LOG_ASSERT(std::abs(path.weight - weight * scale) < 1e-9);
+        }
+        for (size_t i = 1; i < paths.size(); ++i) {
+          for (size_t j = 0; j < i; ++j) {
+            KATANA_LOG_ASSERT(paths[i].nodes != paths[j].nodes);
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Compare KShortestPaths with enumerating walks on a ring, where every pair
+/// of nodes has infinitely many walks
+void
+TestPaths() {
+  LinePolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::vector<int64_t> weights = AddWeights(g.get(), 1);
+  std::vector<PathQuery> queries = AllPairs();
+
+  for (const auto& [name, scale] :
+       {std::make_pair("int_weight", 1.0),
+        std::make_pair("real_weight", 0.5)}) {
+    auto result =
+        katana::analytics::KShortestPaths(g.get(), name, queries, kNumPaths);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+
+    for (size_t q = 0; q < queries.size(); ++q) {
+      auto [source, target] = queries[q];
+      const auto& paths = result.value()[q];
+      KATANA_LOG_ASSERT(paths.size() == kNumPaths);
+
+      // Every walk in the result weighs at most the last one
+      auto bound = std::llround(paths.back().weight / scale);
+      std::vector<int64_t> expected;
+      std::function<void(uint32_t, int64_t)> visit = [&](uint32_t n,
+                                                         int64_t weight) {
+        if (n == target) {
+          expected.emplace_back(weight);
+        }
+        for (auto e : g->topology().edges(n)) {
+          if (weight + weights[e] <= bound) {
+            visit(g->topology().edge_dest(e), weight + weights[e]);
+          }
+        }
+      };
+      visit(source, 0);
+      std::sort(expected.begin(), expected.end());
+      CheckWeights(paths, expected, scale);
+
+      for (const auto& path : paths) {
+        KATANA_LOG_ASSERT(path.nodes.front() == source);
+        KATANA_LOG_ASSERT(path.nodes.back() == target);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSimplePaths();
+  TestPaths();
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  AddWeights(g.get(), 0);
+  KATANA_LOG_ASSERT(!katana::analytics::KShortestPaths(
+      g.get(), "no_such_weight", {{0, 1}}, kNumPaths));
+  KATANA_LOG_ASSERT(!katana::analytics::KShortestSimplePaths(
+      g.get(), "int_weight", {{0, kNumNodes}}, kNumPaths));
+  auto empty = katana::analytics::KShortestSimplePaths(
+      g.get(), "int_weight", {{0, 1}}, 0);
+  KATANA_LOG_ASSERT(empty && empty.value()[0].empty());
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+namespace {
+
+using katana::analytics::LabelPropagationPlan;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kCliqueSize = 40;
+constexpr uint32_t kNumCliques = 8;
+
+/// Cliques joined in a ring by one edge between consecutive cliques, with
+/// the edges of each node sorted by destination
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  uint32_t num_nodes = kCliqueSize * kNumCliques;
+  std::vector<std::vector<Node>> adj(num_nodes);
+  for (uint32_t c = 0; c < kNumCliques; ++c) {
+    Node base = c * kCliqueSize;
+    for (Node a = base; a < base + kCliqueSize; ++a) {
+      for (Node b = base; b < base + kCliqueSize; ++b) {
+        if (a != b) {
+          adj[a].emplace_back(b);
+        }
+      }
+    }
+    Node next = ((c + 1) % kNumCliques) * kCliqueSize;
+    adj[base].emplace_back(next + 1);
+    adj[next + 1].emplace_back(base);
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (auto& edges : adj) {
+    std::sort(edges.begin(), edges.end());
+    dests.insert(dests.end(), edges.begin(), edges.end());
+    indices.emplace_back(dests.size());
+  }
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  return g;
+}
+
+std::shared_ptr<arrow::UInt32Array>
+RunLabelPropagation(
+    katana::PropertyGraph* g, const LabelPropagationPlan& plan) {
+  auto result = katana::analytics::LabelPropagation(g, "label", plan);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid = katana::analytics::LabelPropagationAssertValid(g, "label");
+  KATANA_LOG_VASSERT(valid, "{}", valid.error());
+
+  auto column = g->GetNodeProperty("label");
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  auto labels = std::static_pointer_cast<arrow::UInt32Array>(column->chunk(0));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("label"));
+  return labels;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  auto g = MakeGraph();
+
+  katana::setActiveThreads(4);
+  auto labels = RunLabelPropagation(g.get(), LabelPropagationPlan());
+
+  // Each clique becomes one community
+  for (uint32_t c = 0; c < kNumCliques; ++c) {
+    Node base = c * kCliqueSize;
+    for (Node n = base; n < base + kCliqueSize; ++n) {
+      KATANA_LOG_ASSERT(labels->Value(n) == labels->Value(base + 2));
+    }
+    Node next = ((c + 1) % kNumCliques) * kCliqueSize;
+    KATANA_LOG_ASSERT(labels->Value(base + 2) != labels->Value(next + 2));
+  }
+
+  KATANA_LOG_ASSERT(
+      katana::analytics::LabelPropagation(g.get(), "label", {}));
+  auto stats_result =
+      katana::analytics::LabelPropagationStatistics::Compute(g.get(), "label");
+  KATANA_LOG_ASSERT(stats_result);
+  auto stats = stats_result.value();
+  KATANA_LOG_ASSERT(stats.n_communities == kNumCliques);
+  KATANA_LOG_ASSERT(stats.n_non_trivial_communities == kNumCliques);
+  KATANA_LOG_ASSERT(stats.largest_community_size == kCliqueSize);
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("label"));
+
+  // The result does not depend on the number of threads or on which nodes
+  // count their votes in parallel
+  katana::setActiveThreads(1);
+  KATANA_LOG_ASSERT(
+      RunLabelPropagation(g.get(), LabelPropagationPlan())->Equals(*labels));
+  katana::setActiveThreads(4);
+  auto all_heavy = LabelPropagationPlan::Synchronous(
+      LabelPropagationPlan::kDefaultMaxIterations,
+      LabelPropagationPlan::kDefaultSeed, 1);
+  KATANA_LOG_ASSERT(RunLabelPropagation(g.get(), all_heavy)->Equals(*labels));
+
+  // Stopping after one round leaves the cliques unsettled
+  auto one_round =
+      RunLabelPropagation(g.get(), LabelPropagationPlan::Synchronous(1));
+  KATANA_LOG_ASSERT(!one_round->Equals(*labels));
+
+  return 0;
+}
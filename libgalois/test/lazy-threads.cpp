@@ -0,0 +1,42 @@
+#include <cstdlib>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SharedMemSys.h"
+
+int
+main() {
+  // Must be set before the thread pool is created
+  setenv("KATANA_LAZY_THREADS", "1", 1);
+  katana::SharedMemSys sys;
+  katana::ThreadPool& pool = katana::GetThreadPool();
+  unsigned max_threads = pool.getMaxThreads();
+  KATANA_LOG_ASSERT(pool.getStartedThreads() == 1);
+
+  // Storage allocated before threads start is theirs once they do
+  katana::PerThreadStorage<uint64_t> counts;
+  auto count = [&](unsigned num_threads) {
+    katana::setActiveThreads(num_threads);
+    katana::on_each([&](unsigned, unsigned) { *counts.getLocal() += 1; });
+    uint64_t total = 0;
+    for (unsigned i = 0; i < max_threads; ++i) {
+      total += *counts.getRemote(i);
+    }
+    return total;
+  };
+
+  unsigned some = std::min(2U, max_threads);
+  KATANA_LOG_ASSERT(count(some) == some);
+  KATANA_LOG_ASSERT(pool.getStartedThreads() == some);
+
+  // A sequential loop starts no threads
+  katana::setActiveThreads(1);
+  katana::do_all(katana::iterate(0, 10), [](int) {});
+  KATANA_LOG_ASSERT(pool.getStartedThreads() == some);
+
+  KATANA_LOG_ASSERT(count(max_threads) == some + max_threads);
+  KATANA_LOG_ASSERT(pool.getStartedThreads() == max_threads);
+
+  return 0;
+}
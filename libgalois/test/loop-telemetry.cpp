@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/HardwareCounters.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/LoopTelemetry.h"
+#include "katana/Uri.h"
+
+namespace {
+
+std::vector<nlohmann::json>
+ReadRecords(const std::string& path) {
+  std::vector<nlohmann::json> records;
+  std::ifstream in(path);
+  for (std::string line; std::getline(in, line);) {
+    auto record = katana::JsonParse<nlohmann::json>(line);
+    KATANA_LOG_ASSERT(record);
+    records.emplace_back(record.value());
+  }
+  return records;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(4);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/looptelemetry");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+
+  katana::SetLoopTelemetryFile(path);
+  KATANA_LOG_ASSERT(katana::IsLoopTelemetryEnabled());
+
+  constexpr uint64_t kNum = 1000;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), [](uint64_t) {}, katana::steal(),
+      katana::loopname("Telemetry-DoAll"));
+
+  // Unnamed loops are not reported
+  katana::do_all(katana::iterate(uint64_t{0}, kNum), [](uint64_t) {});
+
+  katana::for_each(
+      katana::iterate({uint64_t{0}}),
+      [](uint64_t i, katana::UserContext<uint64_t>& ctx) {
+        if (i + 1 < kNum) {
+          ctx.push(i + 1);
+        }
+      },
+      katana::loopname("Telemetry-ForEach"));
+
+  katana::SetLoopTelemetryFile("");
+  KATANA_LOG_ASSERT(!katana::IsLoopTelemetryEnabled());
+
+  std::vector<nlohmann::json> records = ReadRecords(path);
+  std::remove(path.c_str());
+
+  KATANA_LOG_ASSERT(records.size() == 2);
+
+  const auto& do_all = records[0];
+  KATANA_LOG_ASSERT(do_all["name"] == "Telemetry-DoAll");
+  KATANA_LOG_ASSERT(do_all["kind"] == "do_all");
+  KATANA_LOG_ASSERT(do_all["iterations"] == kNum);
+  KATANA_LOG_ASSERT(
+      do_all["per_thread_iterations"].size() == katana::getActiveThreads());
+  KATANA_LOG_ASSERT(do_all["imbalance"] >= 1.0);
+
+  const auto& for_each = records[1];
+  KATANA_LOG_ASSERT(for_each["name"] == "Telemetry-ForEach");
+  KATANA_LOG_ASSERT(for_each["kind"] == "for_each");
+  KATANA_LOG_ASSERT(for_each["iterations"] == kNum);
+  KATANA_LOG_ASSERT(for_each["pushes"] == kNum - 1);
+  KATANA_LOG_ASSERT(!for_each.contains("hardware_counters"));
+
+  // Counting is not permitted in every environment
+  if (auto res = katana::EnableLoopHardwareCounters(); !res) {
+    KATANA_LOG_WARN("skipping hardware counters: {}", res.error());
+    return 0;
+  }
+  KATANA_LOG_ASSERT(katana::IsLoopHardwareCountersEnabled());
+
+  katana::SetLoopTelemetryFile(path);
+  std::atomic<uint64_t> sum{0};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), [&](uint64_t i) { sum += i; },
+      katana::loopname("Telemetry-Counters"));
+  katana::SetLoopTelemetryFile("");
+  katana::DisableLoopHardwareCounters();
+  KATANA_LOG_ASSERT(!katana::IsLoopHardwareCountersEnabled());
+
+  records = ReadRecords(path);
+  std::remove(path.c_str());
+  KATANA_LOG_ASSERT(records.size() == 1);
+  const auto& counters = records[0]["hardware_counters"];
+  KATANA_LOG_ASSERT(counters.contains("cycles"));
+  KATANA_LOG_ASSERT(counters["cycles"] > 0);
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+namespace {
+
+using katana::analytics::MatrixCompletionPlan;
+using katana::analytics::MatrixCompletionStatistics;
+
+constexpr uint32_t kNumLeft = 2000;
+constexpr uint32_t kNumRight = 500;
+constexpr uint32_t kRatingsPerLeft = 20;
+constexpr uint32_t kRank = 4;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    const std::vector<std::vector<uint32_t>>& neighbors,
+    std::vector<float> ratings) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& n : neighbors) {
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("rating", arrow::float32())}),
+      {katana::BuildArray(ratings)})));
+  return g;
+}
+
+/// Make a bipartite graph whose ratings are the products of random rank
+/// kRank factors plus a little noise
+std::unique_ptr<katana::PropertyGraph>
+MakeLowRankGraph() {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> factor(0.0, 1.0);
+  std::uniform_real_distribution<float> noise(-0.05, 0.05);
+  std::uniform_int_distribution<uint32_t> right(
+      kNumLeft, kNumLeft + kNumRight - 1);
+
+  std::vector<std::vector<float>> factors(kNumLeft + kNumRight);
+  for (auto& f : factors) {
+    for (uint32_t i = 0; i < kRank; ++i) {
+      f.emplace_back(factor(gen));
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> neighbors(kNumLeft + kNumRight);
+  std::vector<float> ratings;
+  for (uint32_t n = 0; n < kNumLeft; ++n) {
+    for (uint32_t i = 0; i < kRatingsPerLeft; ++i) {
+      uint32_t dest = right(gen);
+      float rating = noise(gen);
+      for (uint32_t j = 0; j < kRank; ++j) {
+        rating += factors[n][j] * factors[dest][j];
+      }
+      neighbors[n].emplace_back(dest);
+      ratings.emplace_back(rating);
+    }
+  }
+  return MakeGraph(neighbors, ratings);
+}
+
+/// Run plan on g, check the result and return the root mean square error
+double
+TestMatrixCompletion(
+    katana::PropertyGraph* g, const MatrixCompletionPlan& plan) {
+  auto result =
+      katana::analytics::MatrixCompletion(g, "rating", "latent", plan);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid_result =
+      katana::analytics::MatrixCompletionAssertValid(g, "rating", "latent");
+  KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+  auto stats_result =
+      MatrixCompletionStatistics::Compute(g, "rating", "latent");
+  KATANA_LOG_ASSERT(stats_result);
+  return stats_result.value().rmse;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeLowRankGraph();
+
+  std::shared_ptr<arrow::ChunkedArray> als_latent;
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+
+    // One epoch from the initial vectors is worse than many
+    double sgd_start = TestMatrixCompletion(
+        g.get(), MatrixCompletionPlan::Sgd(8, 0.05, 0.015, 0.01, 1));
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("latent"));
+    double sgd = TestMatrixCompletion(
+        g.get(), MatrixCompletionPlan::Sgd(8, 0.05, 0.015, 0.01, 50));
+    KATANA_LOG_VASSERT(sgd < sgd_start, "rmse {} after {}", sgd, sgd_start);
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("latent"));
+
+    double als =
+        TestMatrixCompletion(g.get(), MatrixCompletionPlan::Als(8, 0.01));
+    KATANA_LOG_VASSERT(als < 0.2, "rmse {} expected < 0.2", als);
+
+    // The result of ALS does not depend on the number of threads
+    std::shared_ptr<arrow::ChunkedArray> latent = g->GetNodeProperty("latent");
+    if (als_latent) {
+      KATANA_LOG_ASSERT(latent->Equals(als_latent));
+    }
+    als_latent = latent;
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("latent"));
+  }
+
+  // The output property must not exist
+  KATANA_LOG_ASSERT(
+      katana::analytics::MatrixCompletion(g.get(), "rating", "latent"));
+  KATANA_LOG_ASSERT(
+      !katana::analytics::MatrixCompletion(g.get(), "rating", "latent"));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("latent"));
+
+  // SGD has no deterministic mode
+  MatrixCompletionPlan deterministic = MatrixCompletionPlan::Sgd();
+  deterministic.set_deterministic(true);
+  KATANA_LOG_ASSERT(!katana::analytics::MatrixCompletion(
+      g.get(), "rating", "latent", deterministic));
+
+  // An edge into a node with out-edges
+  std::unique_ptr<katana::PropertyGraph> not_bipartite =
+      MakeGraph({{1}, {2}, {}}, {1.0f, 1.0f});
+  KATANA_LOG_ASSERT(!katana::analytics::MatrixCompletion(
+      not_bipartite.get(), "rating", "latent"));
+
+  return 0;
+}
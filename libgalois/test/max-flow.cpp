@@ -0,0 +1,125 @@
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+namespace {
+
+using katana::analytics::MaxFlowPlan;
+using katana::analytics::MaxFlowStatistics;
+
+constexpr size_t kNumNodes = 1 << 12;
+
+/// The network of Figure 26.1 of Cormen et al., Introduction to Algorithms,
+/// whose maximum flow from node 0 to node 5 is 23
+std::unique_ptr<katana::PropertyGraph>
+MakeTextbookGraph() {
+  std::vector<uint64_t> indices{2, 3, 5, 7, 9, 9};
+  std::vector<uint32_t> dests{1, 2, 3, 1, 4, 2, 5, 3, 5};
+  std::vector<uint32_t> capacities{16, 13, 12, 4, 14, 9, 20, 7, 4};
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("capacity", arrow::uint32())}),
+      {katana::BuildArray(capacities)})));
+  return g;
+}
+
+/// Make a random graph with integer capacities, some of them zero, and a
+/// floating point property that is not a valid capacity
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(0, 100);
+  std::vector<int64_t> capacities(g->num_edges());
+  std::vector<double> real_capacities(g->num_edges());
+  for (size_t e = 0; e < g->num_edges(); ++e) {
+    capacities[e] = dist(gen);
+    real_capacities[e] = capacities[e];
+  }
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("capacity", arrow::int64()),
+           arrow::field("real_capacity", arrow::float64())}),
+      {katana::BuildArray(capacities),
+       katana::BuildArray(real_capacities)})));
+  return g;
+}
+
+/// Run every plan on g and check that they all find a valid flow of the
+/// same value; return that value
+uint64_t
+TestMaxFlow(katana::PropertyGraph* g, uint32_t source, uint32_t sink) {
+  std::vector<uint64_t> values;
+  for (const auto& plan :
+       {MaxFlowPlan::PushRelabel(), MaxFlowPlan::PushRelabel(1),
+        MaxFlowPlan::PushRelabel(1000)}) {
+    auto result =
+        katana::analytics::MaxFlow(g, source, sink, "capacity", "flow", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    auto valid_result = katana::analytics::MaxFlowAssertValid(
+        g, source, sink, "capacity", "flow");
+    KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+    auto stats_result =
+        MaxFlowStatistics::Compute(g, source, "capacity", "flow");
+    KATANA_LOG_ASSERT(stats_result);
+    auto stats = stats_result.value();
+    KATANA_LOG_ASSERT(stats.n_saturated_edges <= stats.n_flow_edges);
+    values.emplace_back(stats.flow_value);
+
+    KATANA_LOG_ASSERT(g->RemoveEdgeProperty("flow"));
+  }
+
+  for (uint64_t v : values) {
+    KATANA_LOG_VASSERT(v == values[0], "flow {} expected {}", v, values[0]);
+  }
+  return values[0];
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> textbook = MakeTextbookGraph();
+  std::unique_ptr<katana::PropertyGraph> random = MakeRandomGraph();
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+
+    uint64_t value = TestMaxFlow(textbook.get(), 0, 5);
+    KATANA_LOG_VASSERT(value == 23, "flow {} expected 23", value);
+
+    TestMaxFlow(random.get(), 0, kNumNodes - 1);
+  }
+
+  KATANA_LOG_ASSERT(!katana::analytics::MaxFlow(
+      random.get(), 0, 0, "capacity", "flow"));
+  KATANA_LOG_ASSERT(!katana::analytics::MaxFlow(
+      random.get(), 0, kNumNodes, "capacity", "flow"));
+  KATANA_LOG_ASSERT(!katana::analytics::MaxFlow(
+      random.get(), 0, 1, "real_capacity", "flow"));
+  KATANA_LOG_ASSERT(!katana::analytics::MaxFlow(
+      random.get(), 0, 1, "no_such_capacity", "flow"));
+
+  return 0;
+}
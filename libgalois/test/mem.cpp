@@ -19,7 +19,11 @@
 
 #include "katana/Mem.h"
 
+#include <numeric>
+#include <vector>
+
 #include "katana/Galois.h"
+#include "katana/PageAlloc.h"
 #include "katana/gIO.h"
 
 using namespace katana;
@@ -70,5 +74,56 @@ main() {
     KATANA_LOG_ASSERT(allocated);
   }
 
+  ArenaHeapTy arena;
+  arena.allocate(1);
+  ArenaHeapTy::Mark mark = arena.mark();
+  void* after_mark = arena.allocate(24);
+  KATANA_LOG_ASSERT(
+      reinterpret_cast<uintptr_t>(after_mark) % alignof(std::max_align_t) ==
+      0);
+  // Larger than a block, so it comes from malloc
+  arena.allocate(baseAllocSize);
+  for (int i = 0; i < 3; ++i) {
+    arena.allocate(baseAllocSize / 2);
+  }
+  arena.rewind(mark);
+  KATANA_LOG_ASSERT(arena.allocate(24) == after_mark);
+
+  PerThreadArena per_thread_arena;
+  katana::do_all(katana::iterate(0U, 1000U), [&](unsigned n) {
+    ArenaScope scope{per_thread_arena};
+    std::vector<unsigned, ArenaAllocator<unsigned>> values(
+        scope.allocator<unsigned>());
+    for (unsigned i = 0; i < n; ++i) {
+      values.push_back(i);
+    }
+    KATANA_LOG_ASSERT(
+        std::accumulate(values.begin(), values.end(), 0U) == n * (n - 1) / 2);
+  });
+
+  // Every mode must succeed, falling back to regular pages if needed
+  for (auto mode :
+       {HugePageMode::kOff, HugePageMode::kTransparent,
+        HugePageMode::kExplicit}) {
+    SetHugePageMode(mode);
+    PageAllocCounts before = GetPageAllocCounts();
+    void* pages = allocPages(2, true);
+    KATANA_LOG_ASSERT(pages);
+    KATANA_LOG_ASSERT(
+        reinterpret_cast<uintptr_t>(pages) % allocSize() == 0 ||
+        mode != HugePageMode::kTransparent);
+    static_cast<char*>(pages)[2 * allocSize() - 1] = 1;
+    freePages(pages, 2);
+
+    PageAllocCounts after = GetPageAllocCounts();
+    uint64_t added = (after.explicit_huge - before.explicit_huge) +
+                     (after.transparent_huge - before.transparent_huge) +
+                     (after.regular - before.regular);
+    KATANA_LOG_ASSERT(added == 2);
+    if (mode == HugePageMode::kOff) {
+      KATANA_LOG_ASSERT(after.regular - before.regular == 2);
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,93 @@
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+namespace {
+
+using katana::analytics::MinimumSpanningForestPlan;
+
+constexpr size_t kNumNodes = 1 << 14;
+
+/// Make a random graph with an integer weight property, whose few distinct
+/// values give many ties, and a floating point one
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> int_dist(0, 16);
+  std::uniform_real_distribution<double> real_dist(0, 1);
+  std::vector<int64_t> int_weights(g->num_edges());
+  std::vector<double> real_weights(g->num_edges());
+  for (size_t e = 0; e < g->num_edges(); ++e) {
+    int_weights[e] = int_dist(gen);
+    real_weights[e] = real_dist(gen);
+  }
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("int_weight", arrow::int64()),
+           arrow::field("real_weight", arrow::float64())}),
+      {katana::BuildArray(int_weights), katana::BuildArray(real_weights)})));
+  return g;
+}
+
+void
+TestMinimumSpanningForest(
+    katana::PropertyGraph* g, const std::string& weight_name) {
+  std::vector<std::shared_ptr<arrow::Array>> forests;
+  for (const auto& plan :
+       {MinimumSpanningForestPlan::Boruvka(),
+        MinimumSpanningForestPlan::FilterKruskal(),
+        MinimumSpanningForestPlan::FilterKruskal(0)}) {
+    auto result = katana::analytics::MinimumSpanningForest(
+        g, weight_name, "forest", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    auto valid_result = katana::analytics::MinimumSpanningForestAssertValid(
+        g, weight_name, "forest");
+    KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+    auto stats_result =
+        katana::analytics::MinimumSpanningForestStatistics::Compute(
+            g, weight_name, "forest");
+    KATANA_LOG_ASSERT(stats_result);
+    auto stats = stats_result.value();
+    KATANA_LOG_ASSERT(stats.forest_edges + stats.trees == g->num_nodes());
+
+    auto column = g->GetEdgeProperty("forest");
+    KATANA_LOG_ASSERT(column->num_chunks() == 1);
+    forests.emplace_back(column->chunk(0));
+    KATANA_LOG_ASSERT(g->RemoveEdgeProperty("forest"));
+  }
+
+  // Ties are broken by edge id, so every plan finds the same forest
+  for (size_t i = 1; i < forests.size(); ++i) {
+    KATANA_LOG_ASSERT(forests[i]->Equals(*forests[0]));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+  TestMinimumSpanningForest(g.get(), "int_weight");
+  TestMinimumSpanningForest(g.get(), "real_weight");
+
+  KATANA_LOG_ASSERT(!katana::analytics::MinimumSpanningForest(
+      g.get(), "no_such_weight", "forest"));
+
+  return 0;
+}
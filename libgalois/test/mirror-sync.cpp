@@ -0,0 +1,185 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Distribution.h"
+#include "katana/Logging.h"
+#include "katana/MirrorSync.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TcpCommBackend.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+constexpr uint32_t kNumHosts = 4;
+
+void
+WriteGraph(const std::string& rdg_dir) {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  if (auto res = g->Write(rdg_dir, "mirror-sync"); !res) {
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+}
+
+/// Check that every mirror has the value of its master
+template <typename T>
+void
+CheckConsistent(katana::MirrorSync* sync, std::vector<T>* values) {
+  katana::DynamicBitset all;
+  all.resize(values->size());
+  for (size_t n = 0; n < values->size(); ++n) {
+    all.set(n);
+  }
+  auto res = sync->Reduce(values->data(), &all, [](T& master, const T& mirror) {
+    KATANA_LOG_ASSERT(master == mirror);
+    return false;
+  });
+  KATANA_LOG_VASSERT(res, "checking: {}", res.error());
+}
+
+void
+RunHost(
+    katana::CommBackend* comm, const std::string& rdg_dir,
+    katana::PartitionPolicy policy) {
+  katana::SharedMemSys sys;
+  if (comm->ID == 0) {
+    WriteGraph(rdg_dir);
+  }
+  comm->Barrier();
+
+  katana::PartitionOptions opts;
+  opts.policy = policy;
+  opts.num_hosts = comm->Num;
+  opts.host_id = comm->ID;
+  auto part_res = katana::Distribution::MakePartition(rdg_dir, opts);
+  KATANA_LOG_VASSERT(part_res, "making partition: {}", part_res.error());
+  const katana::PropertyGraph& part = *part_res.value();
+  uint64_t num_owned =
+      katana::Distribution::partition_metadata(part).num_owned_;
+  auto l2g = std::static_pointer_cast<arrow::UInt64Array>(
+      part.local_to_global_id()->chunk(0));
+
+  auto sync_res = katana::MirrorSync::Make(part, comm);
+  KATANA_LOG_VASSERT(sync_res, "making sync: {}", sync_res.error());
+  katana::MirrorSync sync = std::move(sync_res.value());
+
+  // Count every copy of the nodes whose global ID is a multiple of 3
+  std::vector<uint64_t> counts(part.num_nodes(), 1);
+  katana::DynamicBitset dirty;
+  dirty.resize(part.num_nodes());
+  for (uint64_t n = 0; n < part.num_nodes(); ++n) {
+    if (l2g->Value(n) % 3 == 0) {
+      dirty.set(n);
+    }
+  }
+  auto sum_res = sync.Sync(
+      counts.data(), &dirty,
+      [](uint64_t& master, uint64_t mirror) {
+        master += mirror;
+        return mirror != 0;
+      },
+      std::optional<uint64_t>(0));
+  KATANA_LOG_VASSERT(sum_res, "summing: {}", sum_res.error());
+
+  const auto& master_nodes = katana::Distribution::master_nodes(part);
+  for (uint64_t n = 0; n < num_owned; ++n) {
+    uint64_t expected = 1;
+    if (l2g->Value(n) % 3 == 0) {
+      for (const auto& masters : master_nodes) {
+        auto ids = std::static_pointer_cast<arrow::UInt32Array>(
+            masters->chunk(0));
+        const uint32_t* begin = ids->raw_values();
+        expected += std::binary_search(begin, begin + ids->length(), n);
+      }
+    }
+    KATANA_LOG_VASSERT(
+        counts[n] == expected, "node {}: {} != {}", l2g->Value(n), counts[n],
+        expected);
+  }
+  CheckConsistent(&sync, &counts);
+
+  // Find the largest host ID with a copy of each node
+  std::vector<uint32_t> hosts(part.num_nodes(), comm->ID);
+  for (uint64_t n = 0; n < part.num_nodes(); ++n) {
+    dirty.set(n);
+  }
+  auto max_res =
+      sync.Sync(hosts.data(), &dirty, [](uint32_t& master, uint32_t mirror) {
+        if (mirror > master) {
+          master = mirror;
+          return true;
+        }
+        return false;
+      });
+  KATANA_LOG_VASSERT(max_res, "finding max: {}", max_res.error());
+  for (uint64_t n = 0; n < num_owned; ++n) {
+    KATANA_LOG_ASSERT(hosts[n] >= comm->ID);
+  }
+  CheckConsistent(&sync, &hosts);
+  KATANA_LOG_ASSERT(kNumHosts == 1 || sync.bytes_sent() > 0);
+
+  comm->Barrier();
+}
+
+void
+TestSync(katana::PartitionPolicy policy) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/mirror-sync");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  // Listen before forking so that every host knows all addresses
+  std::vector<std::unique_ptr<katana::TcpCommBackend>> comms;
+  std::vector<std::string> addresses;
+  for (uint32_t h = 0; h < kNumHosts; ++h) {
+    auto res = katana::TcpCommBackend::Listen("127.0.0.1:0");
+    KATANA_LOG_VASSERT(res, "listening: {}", res.error());
+    addresses.emplace_back(res.value()->address());
+    comms.emplace_back(std::move(res.value()));
+  }
+
+  // Each host is a process because the runtime is not shared between hosts
+  std::vector<pid_t> children;
+  for (uint32_t h = 0; h < kNumHosts; ++h) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      if (auto res = comms[h]->Connect(addresses, h); !res) {
+        KATANA_LOG_FATAL("connecting: {}", res.error());
+      }
+      RunHost(comms[h].get(), rdg_dir, policy);
+      _exit(0);
+    }
+    children.emplace_back(pid);
+  }
+
+  comms.clear();
+  bool ok = true;
+  for (pid_t pid : children) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(ok);
+}
+
+}  // namespace
+
+int
+main() {
+  TestSync(katana::PartitionPolicy::kOutgoingEdgeCut);
+  TestSync(katana::PartitionPolicy::kCartesianVertexCut);
+  return 0;
+}
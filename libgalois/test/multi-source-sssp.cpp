@@ -0,0 +1,172 @@
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using katana::analytics::MultiSourceSssp;
+using katana::analytics::MultiSourceSsspPlan;
+
+constexpr uint32_t kNumNodes = 1500;
+
+/// Make a random graph with integer weights in [0, 20] in the uint32 edge
+/// property "weight" and the same weights plus a quarter in the double
+/// edge property "fractional"
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, 6);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> weight_dist(0, 20);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  std::vector<double> fractional;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+      weights.emplace_back(weight_dist(*gen));
+      fractional.emplace_back(weights.back() + 0.25);
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("weight", arrow::uint32()),
+           arrow::field("fractional", arrow::float64())}),
+      {katana::BuildArray(weights), katana::BuildArray(fractional)})));
+  return g;
+}
+
+/// Dijkstra from source with the weights of edge e given by weight(e)
+template <typename Distance, typename WeightFn>
+std::vector<Distance>
+Dijkstra(
+    const katana::GraphTopology& topology, uint32_t source,
+    Distance infinity, const WeightFn& weight) {
+  std::vector<Distance> distances(topology.num_nodes(), infinity);
+  using Item = std::pair<Distance, uint32_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  distances[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > distances[n]) {
+      continue;
+    }
+    for (auto e : topology.edges(n)) {
+      uint32_t dest = topology.edge_dest(e);
+      Distance nd = d + weight(e);
+      if (nd < distances[dest]) {
+        distances[dest] = nd;
+        queue.emplace(nd, dest);
+      }
+    }
+  }
+  return distances;
+}
+
+template <typename ArrowArray, typename Distance, typename WeightFn>
+void
+CheckDistances(
+    katana::PropertyGraph* g, const std::vector<uint32_t>& sources,
+    const std::string& property_name, Distance infinity,
+    const WeightFn& weight) {
+  auto property = g->GetNodeProperty(property_name);
+  KATANA_LOG_ASSERT(property && property->num_chunks() == 1);
+  const auto& lists =
+      static_cast<const arrow::FixedSizeListArray&>(*property->chunk(0));
+  KATANA_LOG_ASSERT(lists.value_length() == static_cast<int>(sources.size()));
+  const auto& values = static_cast<const ArrowArray&>(*lists.values());
+  for (size_t s = 0; s < sources.size(); ++s) {
+    auto expected = Dijkstra(g->topology(), sources[s], infinity, weight);
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_VASSERT(
+          values.Value(n * sources.size() + s) == expected[n],
+          "source {} node {}: {} != {}", sources[s], n,
+          values.Value(n * sources.size() + s), expected[n]);
+    }
+  }
+}
+
+void
+TestMultiSourceSssp() {
+  std::mt19937 gen(7);
+  auto g = MakeRandomGraph(&gen);
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      g->GetEdgeProperty("weight")->chunk(0));
+  auto fractional = std::static_pointer_cast<arrow::DoubleArray>(
+      g->GetEdgeProperty("fractional")->chunk(0));
+
+  // More sources than fit a batch, one of them twice
+  std::vector<uint32_t> sources;
+  std::uniform_int_distribution<uint32_t> node_dist(0, kNumNodes - 1);
+  for (int i = 0; i < 70; ++i) {
+    sources.emplace_back(node_dist(gen));
+  }
+  sources.emplace_back(sources.front());
+
+  int run = 0;
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    for (uint32_t batch_size : {1U, 16U, 64U}) {
+      for (unsigned delta : {0U, 4U}) {
+        auto plan = MultiSourceSsspPlan::DeltaStep(delta, batch_size);
+        std::string name = fmt::format("distances{}", run++);
+        auto res = MultiSourceSssp(g.get(), sources, "weight", name, plan);
+        KATANA_LOG_VASSERT(res, "{}", res.error());
+        CheckDistances<arrow::UInt64Array, uint64_t>(
+            g.get(), sources, name, std::numeric_limits<uint64_t>::max(),
+            [&](uint64_t e) { return weights->Value(e); });
+      }
+    }
+  }
+
+  auto res =
+      MultiSourceSssp(g.get(), sources, "fractional", "fractional_distances");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  CheckDistances<arrow::DoubleArray, double>(
+      g.get(), sources, "fractional_distances",
+      std::numeric_limits<double>::infinity(),
+      [&](uint64_t e) { return fractional->Value(e); });
+
+  KATANA_LOG_ASSERT(!MultiSourceSssp(g.get(), sources, "weight", "distances0"));
+  KATANA_LOG_ASSERT(!MultiSourceSssp(g.get(), {}, "weight", "empty"));
+  KATANA_LOG_ASSERT(
+      !MultiSourceSssp(g.get(), {kNumNodes}, "weight", "out_of_range"));
+  KATANA_LOG_ASSERT(!MultiSourceSssp(g.get(), sources, "missing", "missing"));
+  KATANA_LOG_ASSERT(!MultiSourceSssp(
+      g.get(), sources, "weight", "too_wide",
+      MultiSourceSsspPlan::DeltaStep(4, 65)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMultiSourceSssp();
+
+  return 0;
+}
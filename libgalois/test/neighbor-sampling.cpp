@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/NeighborSampling.h"
+
+namespace {
+
+using katana::analytics::MinibatchLoader;
+using katana::analytics::NeighborSampler;
+using katana::analytics::NeighborSamplingPlan;
+using katana::analytics::SampledMinibatch;
+
+constexpr size_t kNumNodes = 3000;
+constexpr uint32_t kWidth = 4;
+
+/// Degrees from 0 to 12, so that some nodes have fewer edges than the fanout
+class VaryingDegreePolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::mt19937 gen(node_id);
+    std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+    std::vector<uint32_t> r(node_id % 13);
+    for (auto& n : r) {
+      n = dist(gen);
+    }
+    return r;
+  }
+};
+
+/// Give each node n an embedding of kWidth floats n * kWidth + i and a label
+/// 3 * n
+void
+AddFeatures(katana::PropertyGraph* g) {
+  std::vector<float> embedding_values;
+  std::vector<int64_t> labels;
+  for (size_t n = 0; n < g->num_nodes(); ++n) {
+    for (uint32_t i = 0; i < kWidth; ++i) {
+      embedding_values.emplace_back(n * kWidth + i);
+    }
+    labels.emplace_back(3 * n);
+  }
+  auto embeddings = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::float32(), kWidth), g->num_nodes(),
+      katana::BuildArray(embedding_values));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("embedding", embeddings->type()),
+           arrow::field("label", arrow::int64())}),
+      {embeddings, katana::BuildArray(labels)})));
+}
+
+std::vector<uint32_t>
+Seeds(size_t count) {
+  std::vector<uint32_t> seeds(kNumNodes);
+  std::iota(seeds.begin(), seeds.end(), 0);
+  std::shuffle(seeds.begin(), seeds.end(), std::mt19937(0));
+  seeds.resize(count);
+  return seeds;
+}
+
+void
+CheckMinibatch(
+    const katana::PropertyGraph& g, const NeighborSamplingPlan& plan,
+    const std::vector<uint32_t>& seeds, const SampledMinibatch& batch) {
+  const katana::GraphTopology& topology = g.topology();
+  const auto& nodes = *batch.nodes;
+  KATANA_LOG_ASSERT(batch.hop_sizes.size() == plan.fanouts().size() + 1);
+  KATANA_LOG_ASSERT(batch.hop_sizes.front() == seeds.size());
+  KATANA_LOG_ASSERT(batch.hop_sizes.back() == nodes.length());
+  for (size_t i = 0; i < seeds.size(); ++i) {
+    KATANA_LOG_ASSERT(nodes.Value(i) == seeds[i]);
+  }
+  std::set<uint32_t> distinct(
+      nodes.raw_values(), nodes.raw_values() + nodes.length());
+  KATANA_LOG_ASSERT(distinct.size() == static_cast<size_t>(nodes.length()));
+
+  for (size_t hop = 0; hop < batch.blocks.size(); ++hop) {
+    const auto& block = batch.blocks[hop];
+    uint32_t fanout = plan.fanouts()[hop];
+    std::vector<std::vector<uint64_t>> sampled(batch.hop_sizes[hop]);
+    for (int64_t i = 0; i < block.edges->length(); ++i) {
+      uint32_t dest = block.destinations->Value(i);
+      uint32_t source = block.sources->Value(i);
+      uint64_t edge = block.edges->Value(i);
+      KATANA_LOG_ASSERT(dest < batch.hop_sizes[hop]);
+      KATANA_LOG_ASSERT(source < batch.hop_sizes[hop + 1]);
+      auto [begin, end] = topology.edge_range(nodes.Value(dest));
+      KATANA_LOG_VASSERT(
+          edge >= begin && edge < end, "edge {} is not one of node {}", edge,
+          nodes.Value(dest));
+      KATANA_LOG_ASSERT(topology.edge_dest(edge) == nodes.Value(source));
+      sampled[dest].emplace_back(edge);
+    }
+    // Without replacement every node keeps min(degree, fanout) distinct
+    // edges
+    for (uint32_t dest = 0; dest < sampled.size(); ++dest) {
+      auto& edges = sampled[dest];
+      uint64_t degree = topology.edges(nodes.Value(dest)).size();
+      KATANA_LOG_ASSERT(edges.size() == std::min<uint64_t>(degree, fanout));
+      std::sort(edges.begin(), edges.end());
+      KATANA_LOG_ASSERT(
+          std::adjacent_find(edges.begin(), edges.end()) == edges.end());
+    }
+  }
+
+  KATANA_LOG_ASSERT(batch.features.size() == 2);
+  auto embeddings =
+      std::static_pointer_cast<arrow::FixedSizeListArray>(batch.features[0]);
+  auto labels = std::static_pointer_cast<arrow::Int64Array>(batch.features[1]);
+  const float* values =
+      std::static_pointer_cast<arrow::FloatArray>(embeddings->values())
+          ->raw_values();
+  for (int64_t i = 0; i < nodes.length(); ++i) {
+    for (uint32_t j = 0; j < kWidth; ++j) {
+      KATANA_LOG_ASSERT(values[i * kWidth + j] == nodes.Value(i) * kWidth + j);
+    }
+    KATANA_LOG_ASSERT(labels->Value(i) == 3 * nodes.Value(i));
+  }
+}
+
+void
+TestSample(katana::PropertyGraph* g) {
+  NeighborSamplingPlan plan = NeighborSamplingPlan::Uniform({5, 3});
+  std::vector<uint32_t> seeds = Seeds(200);
+
+  std::vector<std::shared_ptr<arrow::Array>> first_nodes;
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+    auto sampler_res =
+        NeighborSampler::Make(g, plan, {"embedding", "label"});
+    KATANA_LOG_VASSERT(sampler_res, "{}", sampler_res.error());
+    auto& sampler = sampler_res.value();
+
+    for (size_t b = 0; b < 3; ++b) {
+      auto batch_res = sampler->Sample(seeds);
+      KATANA_LOG_VASSERT(batch_res, "{}", batch_res.error());
+      CheckMinibatch(*g, plan, seeds, batch_res.value());
+      // Batches do not depend on the number of threads
+      if (threads == 1) {
+        first_nodes.emplace_back(batch_res.value().nodes);
+      } else {
+        KATANA_LOG_ASSERT(batch_res.value().nodes->Equals(first_nodes[b]));
+      }
+    }
+  }
+
+  // Sampling with replacement keeps fanout edges of each node with edges
+  auto replace_res = NeighborSampler::Make(
+      g, NeighborSamplingPlan::Uniform({20}, true));
+  KATANA_LOG_ASSERT(replace_res);
+  auto batch_res = replace_res.value()->Sample(seeds);
+  KATANA_LOG_ASSERT(batch_res);
+  uint64_t expected = 0;
+  for (uint32_t seed : seeds) {
+    expected += g->topology().edges(seed).size() > 0 ? 20 : 0;
+  }
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(batch_res.value().blocks[0].edges->length()) ==
+      expected);
+}
+
+void
+TestLoader(katana::PropertyGraph* g) {
+  NeighborSamplingPlan plan = NeighborSamplingPlan::Uniform({4, 4}, false, 7);
+  std::vector<uint32_t> seeds = Seeds(1000);
+
+  auto sampler_res = NeighborSampler::Make(g, plan, {"embedding", "label"});
+  KATANA_LOG_ASSERT(sampler_res);
+  std::vector<SampledMinibatch> batches;
+  MinibatchLoader loader(sampler_res.value().get(), seeds, 300);
+  KATANA_LOG_ASSERT(loader.num_batches() == 4);
+  while (!loader.done()) {
+    auto batch_res = loader.Next();
+    KATANA_LOG_VASSERT(batch_res, "{}", batch_res.error());
+    batches.emplace_back(std::move(batch_res.value()));
+  }
+  KATANA_LOG_ASSERT(batches.size() == 4);
+
+  // The loader returns the batches Sample returns for the same seeds. The
+  // loader is done, so no batch is being sampled in the background.
+  auto reference_res = NeighborSampler::Make(g, plan, {"embedding", "label"});
+  KATANA_LOG_ASSERT(reference_res);
+  for (size_t b = 0; b < batches.size(); ++b) {
+    std::vector<uint32_t> batch_seeds(
+        seeds.begin() + b * 300,
+        seeds.begin() + std::min<size_t>((b + 1) * 300, seeds.size()));
+    CheckMinibatch(*g, plan, batch_seeds, batches[b]);
+    auto reference = reference_res.value()->Sample(batch_seeds);
+    KATANA_LOG_ASSERT(reference);
+    KATANA_LOG_ASSERT(batches[b].nodes->Equals(reference.value().nodes));
+  }
+  KATANA_LOG_ASSERT(loader.done());
+  KATANA_LOG_ASSERT(!loader.Next());
+}
+
+void
+TestErrors(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(
+      !NeighborSampler::Make(g, NeighborSamplingPlan::Uniform({})));
+  KATANA_LOG_ASSERT(
+      !NeighborSampler::Make(g, NeighborSamplingPlan::Uniform({3, 0})));
+  KATANA_LOG_ASSERT(!NeighborSampler::Make(g, {}, {"missing"}));
+
+  auto sampler_res = NeighborSampler::Make(g);
+  KATANA_LOG_ASSERT(sampler_res);
+  auto& sampler = sampler_res.value();
+  KATANA_LOG_ASSERT(!sampler->Sample({1, 2, 1}));
+  KATANA_LOG_ASSERT(!sampler->Sample({kNumNodes}));
+  // A failed batch leaves no state behind
+  KATANA_LOG_ASSERT(sampler->Sample({1, 2}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  VaryingDegreePolicy policy;
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  AddFeatures(g.get());
+
+  TestSample(g.get());
+  TestLoader(g.get());
+  TestErrors(g.get());
+
+  return 0;
+}
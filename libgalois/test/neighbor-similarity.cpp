@@ -0,0 +1,114 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/VectorSimilarity.h"
+#include "katana/analytics/neighbor_similarity/neighbor_similarity.h"
+
+namespace {
+
+constexpr int32_t kWidth = 128;
+
+void
+TestDotProduct(std::mt19937* gen) {
+  std::uniform_real_distribution<float> dist(-1, 1);
+  // Sizes around the block sizes of the vector kernels
+  for (size_t n : {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 100, 128, 129}) {
+    std::vector<float> a(n);
+    std::vector<float> b(n);
+    double expected = 0;
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = dist(*gen);
+      b[i] = dist(*gen);
+      expected += double{a[i]} * b[i];
+    }
+    float dot = katana::analytics::DotProduct(a.data(), b.data(), n);
+    KATANA_LOG_VASSERT(
+        std::abs(dot - expected) < 1e-4, "{}: n {} dot {} expected {}",
+        katana::analytics::VectorSimilarityKernel(), n, dot, expected);
+    if (n > 0) {
+      float cosine =
+          katana::analytics::CosineSimilarity(a.data(), a.data(), n);
+      KATANA_LOG_VASSERT(std::abs(cosine - 1) < 1e-5, "n {}", n);
+    }
+  }
+
+  std::vector<float> zero(kWidth);
+  KATANA_LOG_ASSERT(
+      katana::analytics::CosineSimilarity(zero.data(), zero.data(), kWidth) ==
+      0);
+}
+
+void
+TestNeighborSimilarity(std::mt19937* gen) {
+  constexpr size_t kNumNodes = 1000;
+  LinePolicy policy{5};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+
+  std::uniform_real_distribution<float> dist(-1, 1);
+  arrow::FixedSizeListBuilder builder(
+      arrow::default_memory_pool(), std::make_shared<arrow::FloatBuilder>(),
+      kWidth);
+  auto* values = static_cast<arrow::FloatBuilder*>(builder.value_builder());
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    if (n % 100 == 0) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+      continue;
+    }
+    KATANA_LOG_ASSERT(builder.Append().ok());
+    for (int32_t i = 0; i < kWidth; ++i) {
+      KATANA_LOG_ASSERT(values->Append(dist(*gen)).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> embeddings;
+  KATANA_LOG_ASSERT(builder.Finish(&embeddings).ok());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("embedding", embeddings->type())}),
+      {embeddings});
+  if (auto r = g->AddNodeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+
+  using Plan = katana::analytics::NeighborSimilarityPlan;
+  for (auto plan : {Plan::Cosine(), Plan::DotProduct()}) {
+    std::string output =
+        plan.metric() == Plan::kCosine ? "cosine" : "dot-product";
+    if (auto r = katana::analytics::NeighborSimilarity(
+            g.get(), "embedding", output, plan);
+        !r) {
+      KATANA_LOG_FATAL("computing {}: {}", output, r.error());
+    }
+    if (auto r = katana::analytics::NeighborSimilarityAssertValid(
+            g.get(), "embedding", output, plan);
+        !r) {
+      KATANA_LOG_FATAL("checking {}: {}", output, r.error());
+    }
+  }
+
+  auto stats_result =
+      katana::analytics::NeighborSimilarityStatistics::Compute(
+          g.get(), "cosine");
+  KATANA_LOG_ASSERT(stats_result);
+  auto stats = stats_result.value();
+  KATANA_LOG_ASSERT(stats.min_similarity >= -1 - 1e-5);
+  KATANA_LOG_ASSERT(stats.max_similarity <= 1 + 1e-5);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  std::mt19937 gen(0);
+
+  TestDotProduct(&gen);
+  TestNeighborSimilarity(&gen);
+
+  return 0;
+}
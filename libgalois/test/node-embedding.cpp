@@ -0,0 +1,123 @@
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/VectorSimilarity.h"
+#include "katana/analytics/random_walks/node_embedding.h"
+
+namespace {
+
+using katana::analytics::NodeEmbedding;
+using katana::analytics::NodeEmbeddingPlan;
+
+constexpr uint32_t kClusterSize = 30;
+constexpr uint32_t kDimensions = 16;
+
+/// Make two cliques of kClusterSize nodes joined by a single symmetric edge
+/// and one isolated node
+std::unique_ptr<katana::PropertyGraph>
+MakeTwoClusterGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < 2 * kClusterSize; ++n) {
+    uint32_t first = n < kClusterSize ? 0 : kClusterSize;
+    for (uint32_t m = first; m < first + kClusterSize; ++m) {
+      if (m != n) {
+        dests.emplace_back(m);
+      }
+    }
+    if (n == 0) {
+      dests.emplace_back(kClusterSize);
+    } else if (n == kClusterSize) {
+      dests.emplace_back(0);
+    }
+    indices.emplace_back(dests.size());
+  }
+  indices.emplace_back(dests.size());
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+void
+TestClusters(katana::PropertyGraph* g) {
+  auto result = NodeEmbedding(
+      g, "embedding", NodeEmbeddingPlan::SkipGram(kDimensions, 20, 10, 5));
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+
+  auto property = g->GetNodeProperty("embedding");
+  KATANA_LOG_ASSERT(property->type()->Equals(
+      arrow::fixed_size_list(arrow::float32(), kDimensions)));
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(property->length()) == g->num_nodes());
+  auto array = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      property->chunk(0));
+  const float* values =
+      std::static_pointer_cast<arrow::FloatArray>(array->values())
+          ->raw_values();
+
+  // Nodes of the same clique are on the same walks far more often than
+  // nodes of different cliques
+  double within = 0;
+  double across = 0;
+  uint64_t num_within = 0;
+  uint64_t num_across = 0;
+  for (uint32_t a = 0; a < 2 * kClusterSize; ++a) {
+    for (uint32_t b = a + 1; b < 2 * kClusterSize; ++b) {
+      float similarity = katana::analytics::CosineSimilarity(
+          values + a * kDimensions, values + b * kDimensions, kDimensions);
+      if ((a < kClusterSize) == (b < kClusterSize)) {
+        within += similarity;
+        ++num_within;
+      } else {
+        across += similarity;
+        ++num_across;
+      }
+    }
+  }
+  within /= num_within;
+  across /= num_across;
+  KATANA_LOG_VASSERT(
+      within > across + 0.2, "similarity within clusters {} across {}",
+      within, across);
+
+  // The output property must not exist
+  KATANA_LOG_ASSERT(!NodeEmbedding(g, "embedding"));
+}
+
+void
+TestInvalidPlans(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(
+      !NodeEmbedding(g, "bad", NodeEmbeddingPlan::SkipGram(0)));
+  KATANA_LOG_ASSERT(
+      !NodeEmbedding(g, "bad", NodeEmbeddingPlan::SkipGram(8, 10, 1, 0)));
+
+  NodeEmbeddingPlan deterministic;
+  deterministic.set_deterministic(true);
+  KATANA_LOG_ASSERT(!NodeEmbedding(g, "bad", deterministic));
+  KATANA_LOG_ASSERT(g->node_schema()->GetFieldIndex("bad") < 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeTwoClusterGraph();
+  TestClusters(g.get());
+  TestInvalidPlans(g.get());
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include "katana/NumaMemoryPool.h"
+
+#include <cstring>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+void
+TestPolicy(katana::NumaMemoryPool::Policy policy) {
+  katana::NumaMemoryPool pool(policy);
+  pool.AttachToThreadPool();
+
+  // Large buffers are huge page aligned and accounted by the pool
+  int64_t large = 3 * katana::allocSize() + 1;
+  uint8_t* data{};
+  KATANA_LOG_ASSERT(pool.Allocate(large, &data).ok());
+  KATANA_LOG_ASSERT(
+      reinterpret_cast<uintptr_t>(data) % katana::allocSize() == 0);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() >= large);
+  std::memset(data, 1, large);
+
+  // Growing keeps the contents
+  KATANA_LOG_ASSERT(pool.Reallocate(large, 2 * large, &data).ok());
+  KATANA_LOG_ASSERT(data[0] == 1 && data[large - 1] == 1);
+
+  // Shrinking below a huge page moves the buffer to the small pool
+  KATANA_LOG_ASSERT(pool.Reallocate(2 * large, 64, &data).ok());
+  KATANA_LOG_ASSERT(data[63] == 1);
+  pool.Free(data, 64);
+
+  KATANA_LOG_ASSERT(pool.Allocate(64, &data).ok());
+  pool.Free(data, 64);
+
+  pool.DetachFromThreadPool();
+}
+
+void
+TestForeignBuffers() {
+  // Buffers of the default pool can be freed through the NUMA pool
+  katana::NumaMemoryPool pool(katana::NumaMemoryPool::Policy::kLocal);
+  int64_t large = katana::allocSize();
+  uint8_t* data{};
+  KATANA_LOG_ASSERT(arrow::default_memory_pool()->Allocate(large, &data).ok());
+  pool.Free(data, large);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestPolicy(katana::NumaMemoryPool::Policy::kBlocked);
+  TestPolicy(katana::NumaMemoryPool::Policy::kInterleaved);
+  TestPolicy(katana::NumaMemoryPool::Policy::kLocal);
+  TestForeignBuffers();
+
+  // The runtime installs the pool for budgeted allocations
+  uint8_t* data{};
+  int64_t large = katana::allocSize();
+  int64_t before = katana::GetNumaMemoryPool()->bytes_allocated();
+  KATANA_LOG_ASSERT(katana::BudgetedMemoryPool()->Allocate(large, &data).ok());
+  KATANA_LOG_ASSERT(
+      katana::GetNumaMemoryPool()->bytes_allocated() >= before + large);
+  katana::BudgetedMemoryPool()->Free(data, large);
+
+  return 0;
+}
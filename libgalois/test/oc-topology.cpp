@@ -0,0 +1,104 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/OCTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+/// Check that segment i of oc has the edges of g
+void
+CheckSegment(
+    katana::OCTopology* oc, size_t i, const katana::GraphTopology& g) {
+  auto bind_res = oc->Bind(i);
+  KATANA_LOG_ASSERT(bind_res);
+  const katana::OCTopology::Binding& binding = bind_res.value();
+  for (auto n : binding.nodes()) {
+    KATANA_LOG_ASSERT(oc->SegmentOf(n) == i);
+    KATANA_LOG_ASSERT(*binding.edges(n).begin() == *g.edges(n).begin());
+    KATANA_LOG_ASSERT(*binding.edges(n).end() == *g.edges(n).end());
+    for (auto e : binding.edges(n)) {
+      KATANA_LOG_ASSERT(binding.edge_dest(e) == g.edge_dest(e));
+    }
+  }
+}
+
+void
+TestSegments(
+    const std::string& rdg_dir, const katana::GraphTopology& g,
+    const katana::OCTopologyOptions& opts) {
+  auto make_res = katana::OCTopology::Make(rdg_dir, opts);
+  if (!make_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making topology: {}", make_res.error());
+  }
+  std::unique_ptr<katana::OCTopology> oc = std::move(make_res.value());
+  KATANA_LOG_ASSERT(oc->num_nodes() == g.num_nodes());
+  KATANA_LOG_ASSERT(oc->num_edges() == g.num_edges());
+
+  // Segments cover the nodes and edges in order
+  const auto& segments = oc->segments();
+  KATANA_LOG_ASSERT(segments.size() > 2);
+  KATANA_LOG_ASSERT(segments.front().node_begin == 0);
+  KATANA_LOG_ASSERT(segments.back().node_end == g.num_nodes());
+  KATANA_LOG_ASSERT(segments.back().edge_end == g.num_edges());
+  for (size_t i = 1; i < segments.size(); ++i) {
+    KATANA_LOG_ASSERT(segments[i].node_begin == segments[i - 1].node_end);
+    KATANA_LOG_ASSERT(segments[i].edge_begin == segments[i - 1].edge_end);
+  }
+
+  // In order, backwards, and from several threads at once
+  for (size_t i = 0; i < segments.size(); ++i) {
+    CheckSegment(oc.get(), i, g);
+  }
+  for (size_t i = segments.size(); i > 0; --i) {
+    CheckSegment(oc.get(), i - 1, g);
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, segments.size()),
+      [&](size_t i) { CheckSegment(oc.get(), i, g); }, katana::no_stats());
+
+  katana::OCTopologyStats stats = oc->stats();
+  KATANA_LOG_ASSERT(stats.hits + stats.misses == 3 * segments.size());
+  KATANA_LOG_ASSERT(stats.evictions > 0);
+  KATANA_LOG_ASSERT((stats.prefetches > 0) == opts.prefetch);
+  // Nothing is bound anymore
+  KATANA_LOG_ASSERT(oc->resident_bytes() <= opts.memory_budget);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Large enough for segments of several pages of the topology file
+  RandomPolicy policy{5};
+  auto g = MakeFileGraph<int64_t>(1 << 20, 0, &policy);
+  auto uri_res = katana::Uri::MakeRand("/tmp/octopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, "oc-topology"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  katana::OCTopologyOptions opts;
+  opts.segment_edges = UINT64_C(1) << 19;
+  opts.memory_budget = UINT64_C(4) << 20;
+  TestSegments(rdg_dir, g->topology(), opts);
+  opts.prefetch = false;
+  TestSegments(rdg_dir, g->topology(), opts);
+
+  fs::remove_all(rdg_dir);
+
+  return 0;
+}
@@ -77,6 +77,33 @@ TestString() {
   TestSliced<ViewType>(vec, array, 1, vec.size() - 6);
 }
 
+void
+TestDictionaryString() {
+  using VecType = std::vector<std::optional<std::string>>;
+  using ViewType = katana::DictionaryStringReadOnlyProperty::ViewType;
+  VecType vec{"a", "b", std::nullopt, "a", std::nullopt, std::nullopt,
+              "c", "b", "a",          "c", std::nullopt};
+  arrow::StringDictionary32Builder builder;
+  for (const auto& v : vec) {
+    KATANA_LOG_ASSERT(v ? builder.Append(*v).ok() : builder.AppendNull().ok());
+  }
+  std::shared_ptr<arrow::Array> finished;
+  KATANA_LOG_ASSERT(builder.Finish(&finished).ok());
+  auto array = std::static_pointer_cast<arrow::DictionaryArray>(finished);
+  TestSliced<ViewType>(vec, array, 0, vec.size());
+  TestSliced<ViewType>(vec, array, 3, vec.size() - 3);
+  TestSliced<ViewType>(vec, array, 1, vec.size() - 6);
+
+  auto view_res = ViewType::Make(*array);
+  KATANA_LOG_ASSERT(view_res);
+  const auto& view = view_res.value();
+  int32_t a = view.FindCode("a");
+  KATANA_LOG_ASSERT(a >= 0 && view.FindCode("d") == -1);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    KATANA_LOG_ASSERT(!vec[i] || (view.GetCode(i) == a) == (*vec[i] == "a"));
+  }
+}
+
 void
 TestBool() {
   using VecType = std::vector<std::optional<bool>>;
@@ -102,6 +129,7 @@ main() {
   TestPOD<float>();
   TestPOD<double>();
   TestString();
+  TestDictionaryString();
   TestBool();
   KATANA_LOG_VERBOSE("success");
   return 0;
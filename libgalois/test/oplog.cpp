@@ -0,0 +1,268 @@
+#include <optional>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/Oplog.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+using Node = katana::GraphTopology::Node;
+
+constexpr Node kNumNodes = 10;
+
+katana::ImportData
+Int(int64_t v) {
+  katana::ImportData data(katana::ImportDataType::kInt64, false);
+  data.value = v;
+  return data;
+}
+
+katana::ImportData
+Double(double v) {
+  katana::ImportData data(katana::ImportDataType::kDouble, false);
+  data.value = v;
+  return data;
+}
+
+/// Node i has edges to i + 1 and i + 2 (mod kNumNodes), property "value" i
+/// and "other" -i. Edge e has "weight" e.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<int64_t> values;
+  std::vector<int64_t> others;
+  std::vector<double> weights;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (Node d : {(n + 1) % kNumNodes, (n + 2) % kNumNodes}) {
+      weights.emplace_back(dests.size());
+      dests.emplace_back(d);
+    }
+    indices.emplace_back(dests.size());
+    values.emplace_back(n);
+    others.emplace_back(-static_cast<int64_t>(n));
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("value", arrow::int64()),
+           arrow::field("other", arrow::int64())}),
+      {katana::BuildArray(values), katana::BuildArray(others)})));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::float64())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+template <typename ArrayType>
+std::optional<typename ArrayType::value_type>
+Get(const std::shared_ptr<arrow::ChunkedArray>& column, uint64_t row) {
+  KATANA_LOG_ASSERT(column);
+  for (const auto& chunk : column->chunks()) {
+    if (row < static_cast<uint64_t>(chunk->length())) {
+      if (chunk->IsNull(row)) {
+        return std::nullopt;
+      }
+      return std::static_pointer_cast<ArrayType>(chunk)->Value(row);
+    }
+    row -= chunk->length();
+  }
+  KATANA_LOG_FATAL("row out of range");
+}
+
+std::optional<int64_t>
+NodeValue(const katana::PropertyGraph& g, Node n) {
+  return Get<arrow::Int64Array>(g.GetNodeProperty("value"), n);
+}
+
+std::optional<double>
+Weight(const katana::PropertyGraph& g, uint64_t e) {
+  return Get<arrow::DoubleArray>(g.GetEdgeProperty("weight"), e);
+}
+
+std::vector<Node>
+Dests(const katana::GraphTopology& topology, Node n) {
+  std::vector<Node> dests;
+  for (auto e : topology.edges(n)) {
+    dests.emplace_back(topology.edge_dest(e));
+  }
+  return dests;
+}
+
+/// Setting properties replaces only their columns
+void
+TestProperties() {
+  auto g = MakeGraph();
+  const arrow::UInt32Array* dests = g->topology().out_dests.get();
+  const arrow::ChunkedArray* other = g->GetNodeProperty("other").get();
+
+  katana::OplogBatch batch;
+  batch.UpsertNode(3, {{"value", Int(30)}});
+  batch.UpsertNode(4, {{"value", Int(40)}});
+  batch.UpsertNode(4, {{"value", Int(41)}, {"label", Int(7)}});
+  batch.UpsertEdge(3, 4, {{"weight", Double(0.5)}});
+  auto res = katana::ApplyOplogBatch(g.get(), batch);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  KATANA_LOG_ASSERT(g->topology().out_dests.get() == dests);
+  KATANA_LOG_ASSERT(g->GetNodeProperty("other").get() == other);
+  KATANA_LOG_ASSERT(g->num_nodes() == kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    int64_t expected = n == 3 ? 30 : n == 4 ? 41 : n;
+    KATANA_LOG_ASSERT(NodeValue(*g, n) == expected);
+    auto label = Get<arrow::Int64Array>(g->GetNodeProperty("label"), n);
+    KATANA_LOG_ASSERT(label.has_value() == (n == 4));
+    KATANA_LOG_ASSERT(n != 4 || *label == 7);
+  }
+  for (uint64_t e = 0; e < g->num_edges(); ++e) {
+    KATANA_LOG_ASSERT(Weight(*g, e) == (e == 6 ? 0.5 : e));
+  }
+}
+
+/// Adding and removing edges and nodes replaces the topology
+void
+TestStructure() {
+  auto g = MakeGraph();
+  const arrow::ChunkedArray* other = g->GetNodeProperty("other").get();
+
+  katana::OplogBatch batch;
+  batch.DeleteEdge(0, 1);
+  batch.UpsertEdge(0, 5, {{"weight", Double(-1)}});
+  batch.UpsertEdge(1, 2, {{"weight", Double(-2)}});
+  // Edges inserted before a node is deleted are deleted with it
+  batch.UpsertEdge(3, 7);
+  batch.DeleteNode(7);
+  batch.UpsertNode(7, {{"value", Int(70)}});
+  batch.UpsertEdge(7, 1, {{"weight", Double(-3)}});
+  batch.UpsertNode(kNumNodes, {{"value", Int(100)}});
+  batch.UpsertEdge(kNumNodes, 0);
+  auto res = katana::ApplyOplogBatch(g.get(), batch);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  const katana::GraphTopology& topology = g->topology();
+  KATANA_LOG_ASSERT(g->num_nodes() == kNumNodes + 1);
+  KATANA_LOG_ASSERT(g->GetNodeProperty("other").get() != other);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    std::vector<Node> expected;
+    for (Node d : {(n + 1) % kNumNodes, (n + 2) % kNumNodes}) {
+      if (n != 7 && d != 7 && !(n == 0 && d == 1)) {
+        expected.emplace_back(d);
+      }
+    }
+    if (n == 0) {
+      expected.emplace_back(5);
+    } else if (n == 7) {
+      expected.emplace_back(1);
+    }
+    KATANA_LOG_VASSERT(Dests(topology, n) == expected, "node {}", n);
+
+    // Remaining edges keep their weights
+    for (auto e : topology.edges(n)) {
+      Node d = topology.edge_dest(e);
+      std::optional<double> weight = Weight(*g, e);
+      if (n == 0 && d == 5) {
+        KATANA_LOG_ASSERT(weight == -1.0);
+      } else if (n == 1 && d == 2) {
+        KATANA_LOG_ASSERT(weight == -2.0);
+      } else if (n == 7) {
+        KATANA_LOG_ASSERT(weight == -3.0);
+      } else {
+        double old = 2 * n + (d == (n + 1) % kNumNodes ? 0 : 1);
+        KATANA_LOG_ASSERT(weight == old);
+      }
+    }
+
+    std::optional<int64_t> other_value =
+        Get<arrow::Int64Array>(g->GetNodeProperty("other"), n);
+    KATANA_LOG_ASSERT(NodeValue(*g, n) == (n == 7 ? 70 : n));
+    KATANA_LOG_ASSERT(other_value.has_value() == (n != 7));
+  }
+  KATANA_LOG_ASSERT(Dests(topology, kNumNodes) == std::vector<Node>{0});
+  KATANA_LOG_ASSERT(!Weight(*g, *topology.edges(kNumNodes).begin()));
+  KATANA_LOG_ASSERT(NodeValue(*g, kNumNodes) == 100);
+}
+
+/// Invalid batches fail without changing the graph
+void
+TestErrors() {
+  auto g = MakeGraph();
+  const katana::PropertyGraph& graph = *g;
+  auto expect_failure = [&](const katana::OplogBatch& batch) {
+    KATANA_LOG_ASSERT(!katana::ApplyOplogBatch(g.get(), batch));
+    KATANA_LOG_ASSERT(g->num_nodes() == kNumNodes);
+    KATANA_LOG_ASSERT(NodeValue(graph, 0) == 0);
+  };
+
+  katana::OplogBatch batch;
+  batch.UpsertNode(0, {{"value", Int(5)}});
+  batch.UpsertEdge(0, kNumNodes);
+  expect_failure(batch);
+
+  batch.clear();
+  batch.UpsertNode(0, {{"value", Double(5)}});
+  expect_failure(batch);
+
+  batch.clear();
+  batch.UpsertNode(0, {{"new", Int(1)}});
+  batch.UpsertNode(1, {{"new", Double(1)}});
+  expect_failure(batch);
+}
+
+/// Committing writes the batch as a new version of the RDG
+void
+TestCommit() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/oplog");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  KATANA_LOG_ASSERT(MakeGraph()->Write(rdg_dir, "oplog"));
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir);
+  KATANA_LOG_ASSERT(make_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(make_res.value());
+
+  katana::OplogBatch batch;
+  batch.UpsertNode(2, {{"value", Int(20)}});
+  batch.DeleteEdge(2, 3);
+  KATANA_LOG_ASSERT(katana::ApplyOplogBatch(g.get(), batch));
+  if (auto res = g->Commit("oplog"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", res.error());
+  }
+
+  auto reload_res = katana::PropertyGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(reload_res);
+  const katana::PropertyGraph& reloaded = *reload_res.value();
+  KATANA_LOG_ASSERT(NodeValue(reloaded, 2) == 20);
+  KATANA_LOG_ASSERT(Dests(reloaded.topology(), 2) == std::vector<Node>{4});
+  KATANA_LOG_ASSERT(reloaded.num_edges() == 2 * kNumNodes - 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestProperties();
+  TestStructure();
+  TestErrors();
+  TestCommit();
+
+  return 0;
+}
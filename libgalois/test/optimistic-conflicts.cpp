@@ -0,0 +1,84 @@
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Writers keep a and b equal, but not atomically
+struct Pair : public katana::Lockable {
+  int a{0};
+  int b{0};
+};
+
+struct Observation : public katana::Lockable {
+  bool torn{false};
+};
+
+constexpr int kNumPairs = 8;
+constexpr int kNumItems = 1 << 16;
+
+void
+Delay() {
+  for (volatile int i = 0; i < 64; i = i + 1) {
+  }
+}
+
+/// Half the iterations write a pair and the others read one optimistically
+/// and record whether it was torn. Reads of a pair that is being written
+/// must be aborted by validation rather than committed.
+template <typename... Args>
+void
+TestTornReads(Args&&... args) {
+  std::vector<Pair> pairs(kNumPairs);
+  std::vector<Observation> observations(kNumItems);
+
+  katana::for_each(
+      katana::iterate(0, kNumItems),
+      [&](int item, auto& ctx) {
+        Pair& pair = pairs[(item / 2) % kNumPairs];
+        if (item % 2 == 0) {
+          katana::acquire(&pair, katana::MethodFlag::WRITE);
+          ctx.cautiousPoint();
+          pair.a += 1;
+          Delay();
+          pair.b += 1;
+          return;
+        }
+
+        Observation& observation = observations[item];
+        katana::acquire(&pair, katana::MethodFlag::READ);
+        katana::acquire(&observation, katana::MethodFlag::WRITE);
+        int a = pair.a;
+        Delay();
+        int b = pair.b;
+        ctx.cautiousPoint();
+        observation.torn = a != b;
+      },
+      std::forward<Args>(args)...);
+
+  int writes = 0;
+  for (const Pair& pair : pairs) {
+    KATANA_LOG_ASSERT(pair.a == pair.b);
+    writes += pair.a;
+  }
+  KATANA_LOG_ASSERT(writes == kNumItems / 2);
+  for (const Observation& observation : observations) {
+    KATANA_LOG_ASSERT(!observation.torn);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestTornReads(katana::loopname("pessimistic"));
+  TestTornReads(
+      katana::loopname("optimistic"),
+      katana::optimistic_conflict_detection());
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::PersonalizedPagerankPlan;
+using katana::analytics::PersonalizedRanks;
+
+constexpr Node kNumNodes = 200;
+
+/// Node i has edges to 2i + 1 and 3i + 2 (mod kNumNodes), except every 10th
+/// node, which has none
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    if (n % 10 != 9) {
+      dests.emplace_back((2 * n + 1) % kNumNodes);
+      dests.emplace_back((3 * n + 2) % kNumNodes);
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  return g;
+}
+
+/// Personalized Page Rank of every node by power iteration
+std::vector<double>
+Reference(const katana::PropertyGraph& g, Node seed, double alpha) {
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<double> rank(g.num_nodes(), 0);
+  rank[seed] = 1;
+  for (int round = 0; round < 200; ++round) {
+    std::vector<double> next(g.num_nodes(), 0);
+    next[seed] = 1 - alpha;
+    for (Node n = 0; n < g.num_nodes(); ++n) {
+      auto edges = topology.edges(n);
+      if (edges.size() == 0) {
+        next[seed] += alpha * rank[n];
+        continue;
+      }
+      for (auto e : edges) {
+        next[topology.edge_dest(e)] += alpha * rank[n] / edges.size();
+      }
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+/// Check that ranks is sorted and within tolerance(n) of reference
+template <typename Tolerance>
+void
+CheckRanks(
+    const PersonalizedRanks& ranks, const std::vector<double>& reference,
+    const Tolerance& tolerance) {
+  std::vector<double> dense(reference.size(), 0);
+  for (size_t i = 0; i < ranks.size(); ++i) {
+    KATANA_LOG_ASSERT(i == 0 || ranks[i - 1].second >= ranks[i].second);
+    dense[ranks[i].first] = ranks[i].second;
+  }
+  for (Node n = 0; n < reference.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(dense[n] - reference[n]) <= tolerance(n), "node {}: {} not {}",
+        n, dense[n], reference[n]);
+  }
+}
+
+void
+TestForwardPush() {
+  auto g = MakeGraph();
+  std::vector<uint32_t> seeds{0, 9, 17, 17};
+  double epsilon = 1e-7;
+  auto plan = PersonalizedPagerankPlan::ForwardPush(epsilon);
+  auto res = katana::analytics::PersonalizedPagerank(g.get(), seeds, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(res.value().size() == seeds.size());
+
+  for (size_t q = 0; q < seeds.size(); ++q) {
+    auto reference = Reference(*g, seeds[q], plan.alpha());
+    // The residual left over is below epsilon per edge or edgeless node
+    double tolerance = epsilon * (g->num_edges() + kNumNodes);
+    CheckRanks(
+        res.value()[q], reference, [&](Node) { return tolerance; });
+  }
+  KATANA_LOG_ASSERT(res.value()[2] == res.value()[3]);
+
+  auto top_res = katana::analytics::PersonalizedPagerank(
+      g.get(), seeds, PersonalizedPagerankPlan::ForwardPush(epsilon, 0.85, 3));
+  KATANA_LOG_ASSERT(top_res);
+  for (size_t q = 0; q < seeds.size(); ++q) {
+    const auto& top = top_res.value()[q];
+    KATANA_LOG_ASSERT(top.size() == 3);
+    KATANA_LOG_ASSERT(std::equal(
+        top.begin(), top.end(), res.value()[q].begin(),
+        [](const auto& a, const auto& b) { return a.first == b.first; }));
+  }
+}
+
+void
+TestMonteCarlo() {
+  auto g = MakeGraph();
+  std::vector<uint32_t> seeds{0, 9};
+  auto plan = PersonalizedPagerankPlan::MonteCarlo(200000);
+  auto res = katana::analytics::PersonalizedPagerank(g.get(), seeds, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  for (size_t q = 0; q < seeds.size(); ++q) {
+    auto reference = Reference(*g, seeds[q], plan.alpha());
+    CheckRanks(res.value()[q], reference, [](Node) { return 0.01; });
+  }
+
+  auto again = katana::analytics::PersonalizedPagerank(g.get(), seeds, plan);
+  KATANA_LOG_ASSERT(again && again.value() == res.value());
+}
+
+void
+TestInvalid() {
+  auto g = MakeGraph();
+  KATANA_LOG_ASSERT(
+      !katana::analytics::PersonalizedPagerank(g.get(), {kNumNodes}));
+  KATANA_LOG_ASSERT(!katana::analytics::PersonalizedPagerank(
+      g.get(), {0}, PersonalizedPagerankPlan::ForwardPush(0)));
+  KATANA_LOG_ASSERT(!katana::analytics::PersonalizedPagerank(
+      g.get(), {0}, PersonalizedPagerankPlan::MonteCarlo(100, 1)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestForwardPush();
+  TestMonteCarlo();
+  TestInvalid();
+
+  return 0;
+}
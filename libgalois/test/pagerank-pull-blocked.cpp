@@ -0,0 +1,85 @@
+#include <cmath>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace {
+
+using katana::analytics::PagerankPlan;
+
+constexpr size_t kNumNodes = 1000;
+constexpr float kTolerance = 1.0e-7;
+
+/// Neighbors in no particular order, with degrees from 0 to 40 so that the
+/// gather kernels see both full vectors and remainders
+class UnsortedPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    size_t degree = (node_id * 11) % 41;
+    for (size_t i = 0; i < degree; ++i) {
+      r.emplace_back((node_id * 31 + (degree - i) * 97) % num_nodes);
+    }
+    return r;
+  }
+};
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  UnsortedPolicy policy;
+  return MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+}
+
+const float*
+Ranks(const katana::PropertyGraph& g) {
+  auto array = g.GetNodeProperty("rank");
+  KATANA_LOG_ASSERT(array && array->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::FloatArray>(array->chunk(0))
+      ->raw_values();
+}
+
+/// Compare the ranks of PullBlocked with those of PullTopological
+void
+TestBlocked(bool sort, uint32_t block_nodes) {
+  auto expected = MakeGraph();
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(
+      expected.get(), "rank", PagerankPlan::PullTopological(kTolerance)));
+
+  auto g = MakeGraph();
+  if (sort) {
+    KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(g.get()));
+  }
+  auto plan = PagerankPlan::PullBlocked(
+      kTolerance, PagerankPlan::kDefaultMaxIterations,
+      PagerankPlan::kDefaultAlpha, block_nodes);
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(g.get(), "rank", plan));
+
+  const float* actual_ranks = Ranks(*g);
+  const float* expected_ranks = Ranks(*expected);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(actual_ranks[n] - expected_ranks[n]) <=
+            1.0e-3 * expected_ranks[n] + 1.0e-7,
+        "node {}: {} != {}", n, actual_ranks[n], expected_ranks[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Unsorted edges are gathered without blocking
+  TestBlocked(false, 64);
+  TestBlocked(true, 64);
+  TestBlocked(true, 1);
+  TestBlocked(true, PagerankPlan::kDefaultBlockNodes);
+
+  return 0;
+}
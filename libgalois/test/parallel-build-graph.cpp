@@ -0,0 +1,153 @@
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumNodes = 1000;
+constexpr uint32_t kNumGhosts = 10;
+
+uint32_t
+Next(uint32_t i) {
+  return (i * 7 + 1) % kNumNodes;
+}
+
+struct Built {
+  katana::GraphComponents graph;
+  std::vector<uint32_t> index_of;
+};
+
+/// Nodes n0, n1, ... with their number as a property and a label on even
+/// ones. Node i has an edge to Next(i) and one to a ghost node that is never
+/// added; the edges are added before the nodes.
+Built
+Build() {
+  katana::ParallelPropertyGraphBuilder builder;
+  size_t value = builder
+                     .AddBuilder(katana::PropertyKey(
+                         "value", true, false, "value",
+                         katana::ImportDataType::kInt64, false))
+                     .value();
+  size_t weight = builder
+                      .AddBuilder(katana::PropertyKey(
+                          "weight", false, true, "weight",
+                          katana::ImportDataType::kDouble, false))
+                      .value();
+  size_t even =
+      builder.AddLabelBuilder(katana::LabelRule("Even", true, false, "Even"));
+  size_t link =
+      builder.AddLabelBuilder(katana::LabelRule("Link", false, true, "Link"));
+  KATANA_LOG_ASSERT(!builder.AddBuilder(katana::PropertyKey(
+      "list", true, false, "list", katana::ImportDataType::kInt64, true)));
+
+  katana::do_all(katana::iterate(uint32_t{0}, kNumNodes), [&](uint32_t i) {
+    std::string id = "n" + std::to_string(i);
+    katana::ImportData w(katana::ImportDataType::kDouble, false);
+    w.value = i + 0.5;
+    builder.AddEdge(id, "n" + std::to_string(Next(i)), {{weight, w}}, {link});
+    w.value = -static_cast<double>(i);
+    builder.AddEdge(
+        id, "ghost" + std::to_string(i % kNumGhosts), {{weight, w}});
+  });
+  katana::do_all(katana::iterate(uint32_t{0}, kNumNodes), [&](uint32_t i) {
+    katana::ImportData v(katana::ImportDataType::kInt64, false);
+    v.value = static_cast<int64_t>(i);
+    katana::ParallelPropertyGraphBuilder::Labels labels;
+    if (i % 2 == 0) {
+      labels.emplace_back(even);
+    }
+    KATANA_LOG_ASSERT(
+        builder.AddNode("n" + std::to_string(i), {{value, v}}, labels));
+  });
+  KATANA_LOG_ASSERT(!builder.AddNode("n0"));
+  KATANA_LOG_ASSERT(builder.GetNodes() == kNumNodes);
+  KATANA_LOG_ASSERT(builder.GetEdges() == 2 * kNumNodes);
+
+  auto result = builder.Finish();
+  KATANA_LOG_ASSERT(result);
+  KATANA_LOG_ASSERT(builder.GetNodes() == 0);
+
+  Built built{std::move(result.value()), {}};
+  const auto& nodes = built.graph.nodes;
+  KATANA_LOG_ASSERT(nodes.properties->num_rows() == kNumNodes + kNumGhosts);
+  KATANA_LOG_ASSERT(nodes.labels->num_rows() == kNumNodes + kNumGhosts);
+
+  auto values = std::static_pointer_cast<arrow::Int64Array>(
+      nodes.properties->GetColumnByName("value")->chunk(0));
+  built.index_of.resize(kNumNodes);
+  for (int64_t n = 0; n < values->length(); ++n) {
+    if (values->IsValid(n)) {
+      built.index_of[values->Value(n)] = n;
+    }
+  }
+  KATANA_LOG_ASSERT(values->null_count() == kNumGhosts);
+  return built;
+}
+
+void
+TestGraph(const Built& built) {
+  const katana::GraphTopology& topology = *built.graph.topology;
+  KATANA_LOG_ASSERT(topology.num_nodes() == kNumNodes + kNumGhosts);
+  KATANA_LOG_ASSERT(topology.num_edges() == 2 * kNumNodes);
+
+  auto even = std::static_pointer_cast<arrow::BooleanArray>(
+      built.graph.nodes.labels->GetColumnByName("Even")->chunk(0));
+  auto weights = std::static_pointer_cast<arrow::DoubleArray>(
+      built.graph.edges.properties->GetColumnByName("weight")->chunk(0));
+  auto links = std::static_pointer_cast<arrow::BooleanArray>(
+      built.graph.edges.labels->GetColumnByName("Link")->chunk(0));
+
+  std::vector<uint32_t> ghost_degree(topology.num_nodes());
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    uint32_t n = built.index_of[i];
+    KATANA_LOG_ASSERT(even->Value(n) == (i % 2 == 0));
+
+    // The edge to Next(i) was added first
+    auto edges = topology.edges(n);
+    KATANA_LOG_ASSERT(edges.size() == 2);
+    auto e = *edges.begin();
+    KATANA_LOG_ASSERT(topology.edge_dest(e) == built.index_of[Next(i)]);
+    KATANA_LOG_ASSERT(weights->Value(e) == i + 0.5 && links->Value(e));
+    ++e;
+    ghost_degree[topology.edge_dest(e)] += 1;
+    KATANA_LOG_ASSERT(weights->Value(e) == -static_cast<double>(i));
+    KATANA_LOG_ASSERT(!links->Value(e));
+  }
+
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    uint32_t expected = 0;
+    if (built.graph.nodes.properties->column(0)->chunk(0)->IsNull(n)) {
+      expected = kNumNodes / kNumGhosts;
+      KATANA_LOG_ASSERT(topology.edges(n).empty());
+    }
+    KATANA_LOG_VASSERT(ghost_degree[n] == expected, "node {}", n);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // With one thread, nodes are numbered in order of addition and ghosts
+  // follow them
+  katana::setActiveThreads(1);
+  Built serial = Build();
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_ASSERT(serial.index_of[i] == i);
+  }
+  TestGraph(serial);
+
+  for (unsigned threads : {2u, 4u, 8u}) {
+    katana::setActiveThreads(threads);
+    TestGraph(Build());
+  }
+
+  return 0;
+}
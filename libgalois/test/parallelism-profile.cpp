@@ -0,0 +1,104 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParaMeter.h"
+
+namespace {
+
+/// Each of the two initial items pushes a chain of kLength items, so every
+/// step has two items of work
+constexpr int kLength = 10;
+
+void
+RunChain(std::atomic<int>* count) {
+  std::vector<int> initial{0, 0};
+  katana::for_each(
+      katana::iterate(initial),
+      [count](int x, katana::UserContext<int>& ctx) {
+        ++*count;
+        if (x < kLength) {
+          ctx.push(x + 1);
+        }
+      },
+      katana::disable_conflict_detection(), katana::loopname("chain"));
+}
+
+void
+TestForEach() {
+  std::atomic<int> count{0};
+  katana::parameter::ProfileScope scope;
+  RunChain(&count);
+  KATANA_LOG_ASSERT(count == 2 * (kLength + 1));
+
+  KATANA_LOG_ASSERT(scope.profiles().size() == 1);
+  const auto& profile = scope.profiles()[0];
+  KATANA_LOG_ASSERT(profile.loopname == "chain");
+  KATANA_LOG_ASSERT(profile.steps.size() == kLength + 1);
+  for (const auto& step : profile.steps) {
+    KATANA_LOG_ASSERT(step.work == 2 && step.committed == 2);
+  }
+  KATANA_LOG_ASSERT(profile.TotalWork() == 2 * (kLength + 1));
+  KATANA_LOG_ASSERT(profile.MaxParallelism() == 2);
+  KATANA_LOG_ASSERT(profile.MeanParallelism() == 2.0);
+  KATANA_LOG_ASSERT(profile.ConflictRatio() == 0.0);
+}
+
+void
+TestDoAll() {
+  katana::parameter::ProfileScope scope;
+  std::atomic<int> count{0};
+  for (int round = 1; round <= 3; ++round) {
+    katana::do_all(
+        katana::iterate(0, 100 * round), [&](int) { ++count; },
+        katana::loopname("rounds"));
+  }
+  // Unnamed loops are not profiled
+  katana::do_all(katana::iterate(0, 10), [&](int) { ++count; });
+  KATANA_LOG_ASSERT(count == 610);
+
+  KATANA_LOG_ASSERT(scope.profiles().size() == 1);
+  const auto& profile = scope.profiles()[0];
+  KATANA_LOG_ASSERT(profile.steps.size() == 3);
+  KATANA_LOG_ASSERT(profile.TotalWork() == 600);
+  KATANA_LOG_ASSERT(profile.MaxParallelism() == 300);
+}
+
+void
+TestDisabled() {
+  katana::parameter::ProfileScope outer;
+  {
+    // A disabled scope does not hide the enclosing one
+    katana::parameter::ProfileScope inner(false);
+    KATANA_LOG_ASSERT(katana::parameter::CurrentProfileScope() == &outer);
+    std::atomic<int> count{0};
+    RunChain(&count);
+  }
+  KATANA_LOG_ASSERT(outer.profiles().size() == 1);
+
+  katana::parameter::ProfileScope nested;
+  std::atomic<int> count{0};
+  RunChain(&count);
+  KATANA_LOG_ASSERT(nested.profiles().size() == 1);
+  KATANA_LOG_ASSERT(outer.profiles()[0].steps.size() == kLength + 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestForEach();
+  TestDoAll();
+  TestDisabled();
+
+  KATANA_LOG_ASSERT(!katana::parameter::IsProfiling());
+  std::atomic<int> count{0};
+  RunChain(&count);
+  KATANA_LOG_ASSERT(count == 2 * (kLength + 1));
+
+  return 0;
+}
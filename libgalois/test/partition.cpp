@@ -0,0 +1,81 @@
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/partition/partition.h"
+
+namespace {
+
+using katana::analytics::PartitionObjective;
+using katana::analytics::PartitionStatistics;
+
+constexpr size_t kNumNodes = 1 << 14;
+
+/// Partition g and check the partition is valid, balanced and cuts far
+/// fewer edges than assigning nodes round robin
+void
+TestPartition(
+    katana::PropertyGraph* g, uint32_t num_partitions,
+    PartitionObjective objective) {
+  auto result =
+      katana::analytics::Partition(g, num_partitions, "part", objective);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid_result =
+      katana::analytics::PartitionAssertValid(g, num_partitions, "part");
+  KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+  auto stats_result =
+      PartitionStatistics::Compute(g, num_partitions, "part");
+  KATANA_LOG_ASSERT(stats_result);
+  PartitionStatistics stats = stats_result.value();
+  stats.Print();
+
+  double imbalance = objective == PartitionObjective::kNodeBalancedCut
+                         ? stats.node_imbalance
+                         : stats.edge_imbalance;
+  KATANA_LOG_VASSERT(imbalance < 1.2, "imbalance {}", imbalance);
+
+  // Round robin cuts every edge between nodes less than num_partitions
+  // apart, which is almost all of them
+  KATANA_LOG_VASSERT(
+      stats.cut_edges * 10 < g->num_edges(), "{} of {} edges cut",
+      stats.cut_edges, g->num_edges());
+  KATANA_LOG_ASSERT(stats.communication_volume <= stats.cut_edges);
+
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("part"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // A ring where every node is joined to the next 3 nodes
+  LinePolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  for (uint32_t num_partitions : {2, 7, 16}) {
+    TestPartition(
+        g.get(), num_partitions, PartitionObjective::kNodeBalancedCut);
+    TestPartition(
+        g.get(), num_partitions, PartitionObjective::kEdgeBalancedCut);
+  }
+
+  // Every node in one partition cuts nothing
+  KATANA_LOG_ASSERT(katana::analytics::Partition(g.get(), 1, "part"));
+  auto stats = PartitionStatistics::Compute(g.get(), 1, "part");
+  KATANA_LOG_ASSERT(stats && stats.value().cut_edges == 0);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::PartitionAssertValid(g.get(), 0, "part"));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("part"));
+
+  KATANA_LOG_ASSERT(!katana::analytics::Partition(g.get(), 0, "part"));
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Pipeline.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// Every value pushed by several producers is popped exactly once by several
+/// consumers
+void
+TestQueue() {
+  constexpr uint32_t kProducers = 4;
+  constexpr uint32_t kConsumers = 4;
+  constexpr uint32_t kValuesPerProducer = 20000;
+  katana::MPMCQueue<uint32_t> queue(8);
+  KATANA_LOG_ASSERT(queue.capacity() == 8);
+
+  std::vector<std::atomic<uint32_t>> seen(kProducers * kValuesPerProducer);
+  std::vector<std::thread> threads;
+  for (uint32_t p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&, p] {
+      for (uint32_t i = 0; i < kValuesPerProducer; ++i) {
+        KATANA_LOG_ASSERT(queue.Push(p * kValuesPerProducer + i));
+      }
+    });
+  }
+  std::atomic<uint32_t> popped{0};
+  std::vector<std::thread> consumers;
+  for (uint32_t c = 0; c < kConsumers; ++c) {
+    consumers.emplace_back([&] {
+      while (auto value = queue.Pop()) {
+        seen[*value].fetch_add(1);
+        popped.fetch_add(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  queue.Close();
+  for (auto& thread : consumers) {
+    thread.join();
+  }
+  KATANA_LOG_ASSERT(popped.load() == seen.size());
+  for (const auto& count : seen) {
+    KATANA_LOG_ASSERT(count.load() == 1);
+  }
+  KATANA_LOG_ASSERT(!queue.Push(0));
+}
+
+/// A full queue refuses values, and values left in a queue are destroyed
+/// with it
+void
+TestBounds() {
+  auto counter = std::make_shared<int>(0);
+  {
+    katana::MPMCQueue<std::shared_ptr<int>> queue(3);
+    KATANA_LOG_ASSERT(queue.capacity() == 4);
+    for (int i = 0; i < 4; ++i) {
+      KATANA_LOG_ASSERT(queue.TryPush(std::shared_ptr<int>(counter)));
+    }
+    auto extra = counter;
+    KATANA_LOG_ASSERT(!queue.TryPush(std::move(extra)));
+    KATANA_LOG_ASSERT(extra == counter);
+    KATANA_LOG_ASSERT(queue.TryPop().value() == counter);
+    KATANA_LOG_ASSERT(counter.use_count() == 5);
+  }
+  KATANA_LOG_ASSERT(counter.use_count() == 1);
+}
+
+void
+TestPipeline() {
+  constexpr uint64_t kNumValues = 10000;
+  // A small queue so that stages are held back by those after them
+  katana::Pipeline pipeline("PipelineTest", 4);
+  std::atomic<uint64_t> next{0};
+  auto numbers = pipeline.AddSource<uint64_t>(
+      "Generate", 2,
+      [&](katana::PipelineEmitter<uint64_t>& emit) -> katana::Result<void> {
+        for (uint64_t n = next++; n < kNumValues; n = next++) {
+          if (!emit(n)) {
+            break;
+          }
+        }
+        return katana::ResultSuccess();
+      });
+  auto squares = pipeline.AddStage<uint64_t, uint64_t>(
+      "Square", numbers, 3,
+      [](uint64_t n,
+         katana::PipelineEmitter<uint64_t>& emit) -> katana::Result<void> {
+        emit(n * n);
+        return katana::ResultSuccess();
+      });
+  std::atomic<uint64_t> sum{0};
+  pipeline.AddSink<uint64_t>(
+      "Sum", squares, 2, [&](uint64_t square) -> katana::Result<void> {
+        sum += square;
+        return katana::ResultSuccess();
+      });
+
+  auto res = pipeline.Run();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  uint64_t expected = 0;
+  for (uint64_t n = 0; n < kNumValues; ++n) {
+    expected += n * n;
+  }
+  KATANA_LOG_ASSERT(sum.load() == expected);
+
+  auto stats = pipeline.stats();
+  KATANA_LOG_ASSERT(stats.size() == 3);
+  KATANA_LOG_ASSERT(stats[0].name == "Generate" && stats[0].threads == 2);
+  for (const auto& stage : stats) {
+    KATANA_LOG_VASSERT(stage.items == kNumValues, "{}", stage.name);
+  }
+  KATANA_LOG_ASSERT(!pipeline.Run());
+}
+
+/// The first error stops every stage, including a source that would
+/// otherwise never return
+void
+TestFailure() {
+  katana::Pipeline pipeline("PipelineFailureTest", 2, false);
+  auto numbers = pipeline.AddSource<uint64_t>(
+      "Generate", 1,
+      [](katana::PipelineEmitter<uint64_t>& emit) -> katana::Result<void> {
+        for (uint64_t n = 0;; ++n) {
+          if (!emit(n)) {
+            return katana::ResultSuccess();
+          }
+        }
+      });
+  pipeline.AddSink<uint64_t>(
+      "Check", numbers, 2, [](uint64_t n) -> katana::Result<void> {
+        if (n == 100) {
+          return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "bad value");
+        }
+        return katana::ResultSuccess();
+      });
+
+  auto res = pipeline.Run();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::InvalidArgument);
+
+  katana::Pipeline empty("PipelineEmptyTest");
+  empty.AddSource<int>(
+      "Nothing", 0, [](katana::PipelineEmitter<int>&) -> katana::Result<void> {
+        return katana::ResultSuccess();
+      });
+  KATANA_LOG_ASSERT(!empty.Run());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestQueue();
+  TestBounds();
+  TestPipeline();
+  TestFailure();
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/PlanTuner.h"
+
+namespace {
+
+using katana::analytics::PlanCandidate;
+
+constexpr size_t kNumNodes = 1000;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(size_t width) {
+  RandomPolicy policy{width};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("edge_id", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)})));
+  return g;
+}
+
+void
+TestProfile() {
+  auto g = MakeGraph(4);
+  auto copy_res = g->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+
+  auto profile = katana::analytics::GraphProfile::Compute(*g);
+  KATANA_LOG_ASSERT(profile.num_nodes == g->num_nodes());
+  KATANA_LOG_ASSERT(profile.num_edges == g->num_edges());
+  KATANA_LOG_ASSERT(
+      profile.sampled_median_degree <= profile.sampled_max_degree);
+  KATANA_LOG_ASSERT(
+      katana::analytics::GraphProfile::Compute(*copy_res.value()).fingerprint ==
+      profile.fingerprint);
+  KATANA_LOG_ASSERT(
+      katana::analytics::GraphProfile::Compute(*MakeGraph(5)).fingerprint !=
+      profile.fingerprint);
+}
+
+void
+TestSample() {
+  auto g = MakeGraph(4);
+
+  auto sample_res = katana::analytics::SampleGraph(*g, 100, {"edge_id"});
+  KATANA_LOG_ASSERT(sample_res);
+  std::unique_ptr<katana::PropertyGraph> sample =
+      std::move(sample_res.value());
+  KATANA_LOG_ASSERT(sample->num_nodes() == 100);
+  KATANA_LOG_ASSERT(!sample->edges(0).empty());
+
+  auto edge_ids = std::static_pointer_cast<arrow::UInt64Array>(
+      sample->GetEdgeProperty("edge_id")->chunk(0));
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(edge_ids->length()) == sample->num_edges());
+  std::unordered_set<uint64_t> seen;
+  for (int64_t i = 0; i < edge_ids->length(); ++i) {
+    KATANA_LOG_ASSERT(edge_ids->Value(i) < g->num_edges());
+    KATANA_LOG_ASSERT(seen.emplace(edge_ids->Value(i)).second);
+  }
+
+  // A sample at least as large as the graph has all of it
+  auto all_res = katana::analytics::SampleGraph(*g, 2 * kNumNodes);
+  KATANA_LOG_ASSERT(all_res);
+  KATANA_LOG_ASSERT(all_res.value()->num_nodes() == g->num_nodes());
+  KATANA_LOG_ASSERT(all_res.value()->num_edges() == g->num_edges());
+
+  KATANA_LOG_ASSERT(!katana::analytics::SampleGraph(*g, 100, {"missing"}));
+}
+
+void
+TestTune() {
+  auto g = MakeGraph(4);
+  katana::analytics::PlanCache::Get().Clear();
+
+  // Plans are how long a run takes in milliseconds, or negative to fail
+  std::vector<PlanCandidate<int>> candidates{
+      {"slow", 20},
+      {"failing", -1},
+      {"fast", 1},
+  };
+  int runs = 0;
+  auto run = [&](katana::PropertyGraph*,
+                 const int& plan) -> katana::Result<void> {
+    ++runs;
+    if (plan < 0) {
+      return katana::ErrorCode::InvalidArgument;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(plan));
+    return katana::ResultSuccess();
+  };
+  katana::analytics::TunerOptions opts;
+  opts.sample_nodes = 100;
+
+  auto res = katana::analytics::TunePlan("Test", *g, candidates, run, {}, opts);
+  KATANA_LOG_ASSERT(res && res.value() == 1);
+  KATANA_LOG_ASSERT(runs == 2 * 2 + 1);
+
+  // The choice is reused without running anything
+  runs = 0;
+  res = katana::analytics::TunePlan("Test", *g, candidates, run, {}, opts);
+  KATANA_LOG_ASSERT(res && res.value() == 1 && runs == 0);
+
+  opts.refresh = true;
+  res = katana::analytics::TunePlan("Test", *g, candidates, run, {}, opts);
+  KATANA_LOG_ASSERT(res && res.value() == 1 && runs > 0);
+
+  std::vector<PlanCandidate<int>> failing{{"failing", -1}};
+  KATANA_LOG_ASSERT(!katana::analytics::TunePlan("Fail", *g, failing, run));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestProfile();
+  TestSample();
+  TestTune();
+
+  return 0;
+}
@@ -0,0 +1,281 @@
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/point_to_point/goal_directed.h"
+#include "katana/analytics/point_to_point/point_to_point.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::GoalDirectedSearch;
+using katana::analytics::PathQuery;
+using katana::analytics::PointToPointSearch;
+
+/// Make a random graph with uint32 weights in [0, 20] in the edge property
+/// "weight"
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> weight_dist(0, 20);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+      weights.emplace_back(weight_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+/// Make a random graph of nodes at random points in the plane, with the
+/// coordinates in the node properties "x" and "y". Edges go to nearby nodes
+/// and weigh at least their length, in the uint32 edge property "weight".
+std::unique_ptr<katana::PropertyGraph>
+MakeGeometricGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_real_distribution<double> coordinate_dist(0, 100);
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<int32_t> offset_dist(-20, 20);
+  std::uniform_int_distribution<uint32_t> detour_dist(0, 5);
+  std::vector<double> xs;
+  std::vector<double> ys;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    xs.emplace_back(coordinate_dist(*gen));
+    ys.emplace_back(coordinate_dist(*gen));
+  }
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      uint32_t dest = (n + num_nodes + offset_dist(*gen)) % num_nodes;
+      double length = std::hypot(xs[dest] - xs[n], ys[dest] - ys[n]);
+      dests.emplace_back(dest);
+      weights.emplace_back(
+          static_cast<uint32_t>(std::ceil(length)) + detour_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("x", arrow::float64()),
+           arrow::field("y", arrow::float64())}),
+      {katana::BuildArray(xs), katana::BuildArray(ys)})));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+/// Dijkstra from source over all edges, each weighing 1 if !weighted
+std::vector<double>
+Reference(const katana::PropertyGraph& g, Node source, bool weighted) {
+  const katana::GraphTopology& topology = g.topology();
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      g.GetEdgeProperty("weight")->chunk(0));
+  std::vector<double> distance(g.num_nodes(), PointToPointSearch::kInfinity);
+  using Entry = std::pair<double, Node>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+  distance[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > distance[n]) {
+      continue;
+    }
+    for (auto e : topology.edges(n)) {
+      Node dest = topology.edge_dest(e);
+      double next = d + (weighted ? weights->Value(e) : 1);
+      if (next < distance[dest]) {
+        distance[dest] = next;
+        queue.emplace(next, dest);
+      }
+    }
+  }
+  return distance;
+}
+
+/// The weight of the path if its consecutive nodes are joined by edges
+double
+PathWeight(const katana::PropertyGraph& g, const std::vector<uint32_t>& path) {
+  const katana::GraphTopology& topology = g.topology();
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      g.GetEdgeProperty("weight")->chunk(0));
+  double weight = 0;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    double lightest = PointToPointSearch::kInfinity;
+    for (auto e : topology.edges(path[i])) {
+      if (topology.edge_dest(e) == path[i + 1]) {
+        lightest = std::min<double>(lightest, weights->Value(e));
+      }
+    }
+    KATANA_LOG_VASSERT(
+        lightest != PointToPointSearch::kInfinity, "no edge {} -> {}",
+        path[i], path[i + 1]);
+    weight += lightest;
+  }
+  return weight;
+}
+
+void
+TestQueries(katana::PropertyGraph* g) {
+  auto weighted_res = PointToPointSearch::Make(g, "weight");
+  KATANA_LOG_VASSERT(weighted_res, "{}", weighted_res.error());
+  const PointToPointSearch& weighted = weighted_res.value();
+  auto unweighted_res = PointToPointSearch::Make(g);
+  KATANA_LOG_VASSERT(unweighted_res, "{}", unweighted_res.error());
+  const PointToPointSearch& unweighted = unweighted_res.value();
+
+  PointToPointSearch::Query query;
+  std::vector<PathQuery> queries;
+  std::vector<double> expected_distances;
+  std::vector<uint32_t> expected_hops;
+  for (Node source = 0; source < g->num_nodes(); source += 37) {
+    std::vector<double> expected = Reference(*g, source, true);
+    std::vector<double> expected_unit = Reference(*g, source, false);
+    for (Node target = 0; target < g->num_nodes(); ++target) {
+      uint32_t hops = expected_unit[target] == PointToPointSearch::kInfinity
+                          ? PointToPointSearch::kUnreachable
+                          : static_cast<uint32_t>(expected_unit[target]);
+      KATANA_LOG_VASSERT(
+          weighted.Hops(source, target, &query) == hops,
+          "{} -> {}: {} hops not {}", source, target,
+          weighted.Hops(source, target, &query), hops);
+      KATANA_LOG_ASSERT(
+          unweighted.Distance(source, target, &query) ==
+          expected_unit[target]);
+
+      double distance = weighted.Distance(source, target, &query);
+      KATANA_LOG_VASSERT(
+          distance == expected[target], "{} -> {}: {} not {}", source, target,
+          distance, expected[target]);
+
+      auto path = weighted.ShortestPath(source, target, &query);
+      KATANA_LOG_ASSERT(path.weight == expected[target]);
+      if (expected[target] == PointToPointSearch::kInfinity) {
+        KATANA_LOG_ASSERT(path.nodes.empty());
+      } else {
+        KATANA_LOG_ASSERT(path.nodes.front() == source);
+        KATANA_LOG_ASSERT(path.nodes.back() == target);
+        KATANA_LOG_ASSERT(PathWeight(*g, path.nodes) == expected[target]);
+      }
+
+      queries.emplace_back(source, target);
+      expected_distances.emplace_back(expected[target]);
+      expected_hops.emplace_back(hops);
+    }
+  }
+
+  KATANA_LOG_ASSERT(weighted.Distances(queries) == expected_distances);
+  KATANA_LOG_ASSERT(unweighted.Hops(queries) == expected_hops);
+
+  KATANA_LOG_ASSERT(!PointToPointSearch::Make(g, "missing"));
+}
+
+void
+TestGoalDirected(katana::PropertyGraph* g) {
+  auto landmarks_res =
+      katana::analytics::ComputeLandmarks(g, "weight", "landmarks", 4, 0);
+  KATANA_LOG_VASSERT(landmarks_res, "{}", landmarks_res.error());
+  KATANA_LOG_ASSERT(!landmarks_res.value().empty());
+  KATANA_LOG_ASSERT(landmarks_res.value().size() <= 4);
+  KATANA_LOG_ASSERT(landmarks_res.value()[0] == 0);
+  // Choosing again would overwrite the distances
+  KATANA_LOG_ASSERT(
+      !katana::analytics::ComputeLandmarks(g, "weight", "landmarks", 4, 0));
+
+  auto a_star_res = GoalDirectedSearch::MakeAStar(g, "weight", "x", "y");
+  KATANA_LOG_VASSERT(a_star_res, "{}", a_star_res.error());
+  auto alt_res = GoalDirectedSearch::MakeAlt(g, "weight", "landmarks");
+  KATANA_LOG_VASSERT(alt_res, "{}", alt_res.error());
+  GoalDirectedSearch* searches[] = {&a_star_res.value(), &alt_res.value()};
+
+  for (Node source = 0; source < g->num_nodes(); source += 53) {
+    std::vector<double> expected = Reference(*g, source, true);
+    for (Node target = 0; target < g->num_nodes(); target += 7) {
+      for (GoalDirectedSearch* search : searches) {
+        // Bounds never overestimate
+        KATANA_LOG_ASSERT(
+            search->LowerBound(source, target) <= expected[target]);
+
+        double distance = search->Distance(source, target);
+        KATANA_LOG_VASSERT(
+            distance == expected[target], "{} -> {}: {} not {}", source,
+            target, distance, expected[target]);
+        KATANA_LOG_ASSERT(search->num_reached() <= g->num_nodes());
+
+        auto path = search->ShortestPath(source, target);
+        KATANA_LOG_ASSERT(path.weight == expected[target]);
+        if (expected[target] == GoalDirectedSearch::kInfinity) {
+          KATANA_LOG_ASSERT(path.nodes.empty());
+        } else {
+          KATANA_LOG_ASSERT(path.nodes.front() == source);
+          KATANA_LOG_ASSERT(path.nodes.back() == target);
+          KATANA_LOG_ASSERT(PathWeight(*g, path.nodes) == expected[target]);
+        }
+      }
+    }
+  }
+
+  KATANA_LOG_ASSERT(!GoalDirectedSearch::MakeAStar(g, "weight", "x", "z"));
+  KATANA_LOG_ASSERT(!GoalDirectedSearch::MakeAlt(g, "weight", "x"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  for (uint32_t max_degree : {1, 3, 8}) {
+    auto g = MakeRandomGraph(500, max_degree, &gen);
+    TestQueries(g.get());
+  }
+
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+    for (uint32_t max_degree : {2, 6}) {
+      auto g = MakeGeometricGraph(500, max_degree, &gen);
+      TestGoalDirected(g.get());
+    }
+  }
+
+  return 0;
+}
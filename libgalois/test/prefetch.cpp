@@ -0,0 +1,102 @@
+#include "katana/Prefetch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+struct Field0 {
+  using ViewType = katana::PODPropertyView<int64_t>;
+  using ArrowType = arrow::CTypeTraits<int64_t>::ArrowType;
+};
+
+using Graph = katana::TypedPropertyGraph<std::tuple<Field0>, std::tuple<>>;
+
+/// Prefetching edge ranges visit the edges of plain ones and prefetch each
+/// of them once before visiting it
+template <unsigned Distance>
+void
+TestPrefetchEdges(size_t num_nodes, size_t width) {
+  RandomPolicy policy{width};
+  auto g = MakeFileGraph<int64_t>(num_nodes, 1, &policy);
+  auto r = Graph::Make(g.get(), {"0"}, {});
+  KATANA_LOG_ASSERT(r);
+  Graph graph = r.value();
+
+  for (auto n : graph) {
+    std::vector<uint64_t> prefetched;
+    std::vector<uint64_t> visited;
+    auto record = [&](uint64_t e) { prefetched.emplace_back(e); };
+    for (auto e : katana::PrefetchEdges<Distance>(graph.edges(n), record)) {
+      // Everything up to Distance edges ahead has been prefetched
+      uint64_t ahead = std::min<uint64_t>(e + Distance, *graph.edge_end(n));
+      KATANA_LOG_VASSERT(
+          prefetched.size() == ahead - *graph.edge_begin(n), "{} != {}",
+          prefetched.size(), ahead - *graph.edge_begin(n));
+      visited.emplace_back(e);
+    }
+
+    std::vector<uint64_t> expected(
+        graph.edges(n).begin(), graph.edges(n).end());
+    KATANA_LOG_ASSERT(visited == expected);
+    KATANA_LOG_ASSERT(prefetched == expected);
+
+    std::vector<uint32_t> dests;
+    for (auto e : katana::PrefetchEdges<Distance>(
+             graph.edges(n),
+             katana::PrefetchDestinations<Field0>(&graph, true))) {
+      dests.emplace_back(*graph.GetEdgeDest(e));
+    }
+    KATANA_LOG_ASSERT(dests.size() == expected.size());
+    for (size_t i = 0; i < dests.size(); ++i) {
+      KATANA_LOG_ASSERT(dests[i] == *graph.GetEdgeDest(expected[i]));
+    }
+  }
+}
+
+/// do_all with a prefetch option processes and prefetches every item once
+template <typename... Args>
+void
+TestDoAllPrefetch(uint32_t num_items, Args... args) {
+  std::vector<std::atomic<uint32_t>> processed(num_items);
+  std::vector<std::atomic<uint32_t>> prefetched(num_items);
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i) { processed[i] += 1; },
+      katana::prefetch<4>([&](uint32_t i) { prefetched[i] += 1; }),
+      args...);
+
+  for (uint32_t i = 0; i < num_items; ++i) {
+    KATANA_LOG_VASSERT(processed[i] == 1, "item {}", i);
+    KATANA_LOG_VASSERT(prefetched[i] == 1, "item {}", i);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPrefetchEdges<1>(100, 10);
+  TestPrefetchEdges<8>(100, 10);
+  TestPrefetchEdges<64>(100, 10);
+
+  TestDoAllPrefetch(3);
+  TestDoAllPrefetch(10000);
+  TestDoAllPrefetch(10000, katana::steal());
+  TestDoAllPrefetch(
+      10000, katana::steal(), katana::chunk_size<3>(),
+      katana::loopname("PrefetchSteal"));
+
+  return 0;
+}
@@ -0,0 +1,212 @@
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr uint32_t kNumNodes = 10;
+
+/// A ring of kNumNodes nodes with int64 node property "a" n and "b" 2n
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<int64_t> a;
+  std::vector<int64_t> b;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    dests.emplace_back((n + 1) % kNumNodes);
+    indices.emplace_back(dests.size());
+    a.emplace_back(n);
+    b.emplace_back(2 * n);
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("a", arrow::int64()),
+           arrow::field("b", arrow::int64())}),
+      {katana::BuildArray(a), katana::BuildArray(b)})));
+  return g;
+}
+
+std::shared_ptr<arrow::Table>
+Column(const std::string& name, const std::vector<int64_t>& values) {
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}),
+      {katana::BuildArray(values)});
+}
+
+std::vector<int64_t>
+Constant(int64_t value) {
+  return std::vector<int64_t>(kNumNodes, value);
+}
+
+int64_t
+NodeValue(const katana::PropertyGraph& g, const std::string& name, uint32_t n) {
+  auto array = g.GetNodePropertyTyped<int64_t>(name);
+  KATANA_LOG_VASSERT(array, "{}", array.error());
+  return array.value()->Value(n);
+}
+
+int64_t*
+MutableValues(const katana::PropertyGraph& g, const std::string& name) {
+  auto column = g.GetNodeProperty(name);
+  KATANA_LOG_ASSERT(column && column->num_chunks() == 1);
+  return reinterpret_cast<int64_t*>(
+      column->chunk(0)->data()->buffers[1]->mutable_data());
+}
+
+void
+TestUpdate() {
+  auto g = MakeGraph();
+
+  katana::PropertyBatch batch;
+  KATANA_LOG_ASSERT(batch.empty());
+  batch.Add(Column("c", Constant(3)));
+  batch.Add(Column("d", Constant(4)));
+  batch.Remove("a");
+  batch.Replace("b", katana::BuildArray(Constant(5)));
+  KATANA_LOG_ASSERT(!batch.empty());
+  auto res = g->UpdateNodeProperties(batch);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  KATANA_LOG_ASSERT(
+      (g->node_schema()->field_names() ==
+       std::vector<std::string>{"b", "c", "d"}));
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(NodeValue(*g, "b", n) == 5);
+    KATANA_LOG_ASSERT(NodeValue(*g, "c", n) == 3);
+    KATANA_LOG_ASSERT(NodeValue(*g, "d", n) == 4);
+  }
+
+  // A batch that fails changes nothing
+  auto expect_unchanged = [&](const katana::PropertyBatch& bad) {
+    KATANA_LOG_ASSERT(!g->UpdateNodeProperties(bad));
+    KATANA_LOG_ASSERT(g->node_schema()->num_fields() == 3);
+    KATANA_LOG_ASSERT(NodeValue(*g, "b", 1) == 5);
+  };
+  katana::PropertyBatch missing;
+  missing.Remove("b");
+  missing.Remove("a");
+  expect_unchanged(missing);
+  katana::PropertyBatch twice;
+  twice.Remove("b");
+  twice.Remove("b");
+  expect_unchanged(twice);
+  katana::PropertyBatch wrong_type;
+  wrong_type.Remove("c");
+  wrong_type.Replace(
+      "b", katana::BuildArray(std::vector<double>(kNumNodes, 1.5)));
+  expect_unchanged(wrong_type);
+  katana::PropertyBatch duplicate;
+  duplicate.Remove("c");
+  duplicate.Add(Column("d", Constant(6)));
+  expect_unchanged(duplicate);
+  katana::PropertyBatch short_column;
+  short_column.Add(Column("e", std::vector<int64_t>(kNumNodes - 1, 0)));
+  expect_unchanged(short_column);
+
+  // Removing a property frees its name for a property added with it
+  katana::PropertyBatch rename;
+  rename.Remove("c");
+  rename.Add(Column("c", Constant(7)));
+  KATANA_LOG_ASSERT(g->UpdateNodeProperties(rename));
+  KATANA_LOG_ASSERT(
+      (g->node_schema()->field_names() ==
+       std::vector<std::string>{"b", "d", "c"}));
+  KATANA_LOG_ASSERT(NodeValue(*g, "c", 0) == 7);
+}
+
+void
+TestOverwrite() {
+  auto g = MakeGraph();
+
+  auto missing_res = g->PrepareNodePropertyOverwrite("x", arrow::int64());
+  KATANA_LOG_ASSERT(missing_res && !missing_res.value());
+
+  const int64_t* values = MutableValues(*g, "a");
+  auto reuse_res = g->PrepareNodePropertyOverwrite("a", arrow::int64());
+  KATANA_LOG_ASSERT(reuse_res && reuse_res.value());
+  KATANA_LOG_ASSERT(MutableValues(*g, "a") == values);
+
+  // A property of another type is removed for the caller to add anew
+  auto type_res = g->PrepareNodePropertyOverwrite("b", arrow::float64());
+  KATANA_LOG_ASSERT(type_res && !type_res.value());
+  KATANA_LOG_ASSERT(g->node_schema()->GetFieldIndex("b") < 0);
+
+  // Properties shared with a copy are read-only
+  auto copy_res = g->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  auto shared_res = g->PrepareNodePropertyOverwrite("a", arrow::int64());
+  KATANA_LOG_ASSERT(shared_res && !shared_res.value());
+  KATANA_LOG_ASSERT(NodeValue(*copy_res.value(), "a", 3) == 3);
+}
+
+/// Replaced and overwritten properties are written again when the graph is
+/// stored
+void
+TestCommit() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/property-batch");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  KATANA_LOG_ASSERT(MakeGraph()->Write(rdg_dir, "property-batch"));
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir);
+  KATANA_LOG_ASSERT(make_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(make_res.value());
+  katana::PropertyBatch batch;
+  batch.Replace("b", katana::BuildArray(Constant(8)));
+  KATANA_LOG_ASSERT(g->UpdateNodeProperties(batch));
+  auto reuse_res = g->PrepareNodePropertyOverwrite("a", arrow::int64());
+  KATANA_LOG_ASSERT(reuse_res);
+  if (reuse_res.value()) {
+    int64_t* values = MutableValues(*g, "a");
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      values[n] = 9;
+    }
+  } else {
+    KATANA_LOG_ASSERT(g->AddNodeProperties(Column("a", Constant(9))));
+  }
+  if (auto res = g->Commit("property-batch"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", res.error());
+  }
+
+  auto reload_res = katana::PropertyGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(reload_res);
+  const katana::PropertyGraph& reloaded = *reload_res.value();
+  KATANA_LOG_ASSERT(reloaded.node_schema()->num_fields() == 2);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(NodeValue(reloaded, "a", n) == 9);
+    KATANA_LOG_ASSERT(NodeValue(reloaded, "b", n) == 8);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestUpdate();
+  TestOverwrite();
+  TestCommit();
+
+  return 0;
+}
@@ -1,11 +1,21 @@
+#include <fstream>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
+#include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Uri.h"
+#include "tsuba/ArrowIpc.h"
+#include "tsuba/Checksum.h"
+#include "tsuba/FaultTest.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/PropertyStats.h"
 
 namespace {
 
@@ -240,6 +250,531 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestReadOnlyTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.map_topology_read_only = true;
+  opts.populate_topology = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  KATANA_LOG_ASSERT(
+      !g2->topology().out_dests->data()->buffers[1]->is_mutable());
+
+  // In-place topology updates must work on a copy of the mapped topology
+  auto sort_result = katana::SortAllEdgesByDest(g2.get());
+  KATANA_LOG_ASSERT(sort_result);
+  KATANA_LOG_ASSERT(g2->topology().out_dests->data()->buffers[1]->is_mutable());
+  KATANA_LOG_ASSERT(g2->num_edges() == g->num_edges());
+}
+
+void
+TestLazyProperties() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 2, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // Schemas are complete up front but columns are placeholders
+  KATANA_LOG_ASSERT(
+      g2->GetNodePropertyNames().size() == g->GetNodePropertyNames().size());
+  KATANA_LOG_ASSERT(g2->node_properties()->column(0)->type()->id() ==
+                    arrow::Type::NA);
+  KATANA_LOG_ASSERT(g2->node_properties()->num_rows() ==
+                    static_cast<int64_t>(g2->num_nodes()));
+
+  g2->PrefetchEdgeProperties(g2->GetEdgePropertyNames());
+
+  // Must read while rdg_dir still exists
+  KATANA_LOG_ASSERT(g2->Equals(g.get()));
+  KATANA_LOG_ASSERT(g2->node_properties()->column(0)->type()->id() !=
+                    arrow::Type::NA);
+  fs::remove_all(rdg_dir);
+}
+
+void
+TestComputePropertyStats() {
+  constexpr int64_t kBlock = tsuba::kPropertyRowGroupLength;
+  katana::TableBuilder builder{kBlock + 10};
+  katana::ColumnOptions options;
+  options.chunk_size = 1000;
+  options.ascending_values = true;
+  builder.AddColumn<int64_t>(options);
+  tsuba::PropertyStats stats =
+      tsuba::ComputePropertyStats(*builder.Finish()->column(0));
+
+  KATANA_LOG_ASSERT(stats.column.length == kBlock + 10);
+  KATANA_LOG_ASSERT(stats.column.null_count == 0);
+  KATANA_LOG_ASSERT(stats.column.min == 0.0);
+  KATANA_LOG_ASSERT(stats.column.max == kBlock + 9);
+  int64_t distinct = stats.column.distinct_count.value();
+  KATANA_LOG_VASSERT(
+      distinct > kBlock * 0.8 && distinct < kBlock * 1.2,
+      "distinct estimate {}", distinct);
+
+  KATANA_LOG_ASSERT(stats.blocks.size() == 2);
+  KATANA_LOG_ASSERT(stats.blocks[0].max == kBlock - 1);
+  KATANA_LOG_ASSERT(stats.blocks[1].offset == kBlock);
+  KATANA_LOG_ASSERT(stats.blocks[1].length == 10);
+  KATANA_LOG_ASSERT(stats.blocks[1].min == kBlock);
+  KATANA_LOG_ASSERT(stats.blocks[1].distinct_count == 10);
+
+  auto ranges = stats.RowRangesMayContain(kBlock + 5, 1e18);
+  KATANA_LOG_ASSERT(ranges.size() == 1);
+  KATANA_LOG_ASSERT(ranges[0].first == kBlock);
+  KATANA_LOG_ASSERT(ranges[0].second == kBlock + 10);
+  KATANA_LOG_ASSERT(stats.RowRangesMayContain(-10, -1).empty());
+  KATANA_LOG_ASSERT(stats.RowRangesMayContain(0, 1e18).size() == 1);
+}
+
+void
+TestStoredPropertyStats() {
+  constexpr int64_t kNumNodes = 10;
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProps<int64_t>("ts", kNumNodes)));
+
+  // Properties that were never written have their statistics computed
+  auto computed = g->GetNodePropertyStats("ts");
+  KATANA_LOG_VASSERT(computed, "{}", computed.error());
+  KATANA_LOG_ASSERT(computed.value().column.max == kNumNodes - 1);
+  KATANA_LOG_ASSERT(!g->GetNodePropertyStats("no such property"));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // Stored statistics are read with the metadata, not the property
+  auto stored = g2->GetNodePropertyStats("ts");
+  KATANA_LOG_VASSERT(stored, "{}", stored.error());
+  int i = g2->node_schema()->GetFieldIndex("ts");
+  KATANA_LOG_ASSERT(
+      g2->node_properties()->column(i)->type()->id() == arrow::Type::NA);
+
+  const tsuba::ColumnStats& column = stored.value().column;
+  KATANA_LOG_ASSERT(column.length == kNumNodes);
+  KATANA_LOG_ASSERT(column.null_count == 0);
+  KATANA_LOG_ASSERT(column.distinct_count == kNumNodes);
+  KATANA_LOG_ASSERT(column.min == 0.0 && column.max == kNumNodes - 1);
+  KATANA_LOG_ASSERT(stored.value().blocks.size() == 1);
+  KATANA_LOG_ASSERT(!column.MayContain(kNumNodes, 1e18));
+}
+
+void
+TestAuxTopology() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy);
+  auto transpose_res = katana::CreateTransposeGraph(g.get());
+  KATANA_LOG_ASSERT(transpose_res);
+  std::unique_ptr<katana::PropertyGraph> transpose =
+      std::move(transpose_res.value());
+  KATANA_LOG_ASSERT(g->AddAuxTopology("transpose", transpose->topology()));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->HasAuxTopology("transpose"));
+  KATANA_LOG_ASSERT(!g2->HasAuxTopology("symmetric"));
+  KATANA_LOG_ASSERT(!g2->LoadAuxTopology("symmetric"));
+
+  // Must read while rdg_dir still exists
+  auto aux_res = g2->LoadAuxTopology("transpose");
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(aux_res, "{}", aux_res.error());
+  KATANA_LOG_ASSERT(aux_res.value().Equals(transpose->topology()));
+
+  // Auxiliary topologies are dropped with the topology they came from
+  KATANA_LOG_ASSERT(g2->SetTopology(transpose->topology()));
+  KATANA_LOG_ASSERT(!g2->HasAuxTopology("transpose"));
+}
+
+size_t
+CountFiles(const std::string& dir) {
+  return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+}
+
+void
+TestIncrementalCommit() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 2, &policy);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->AddNodeProperties(MakeProps<uint64_t>("rank", 10)));
+  KATANA_LOG_ASSERT(g2->MarkNodePropertiesPersistent({"", "", "rank"}));
+
+  // Only the new property, the partition header and the version metadata
+  // are written; everything else is referenced
+  size_t num_files = CountFiles(rdg_dir);
+  if (auto res = g2->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+  size_t num_new_files = CountFiles(rdg_dir) - num_files;
+
+  auto reload_result = katana::PropertyGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(num_new_files == 3, "{} new files", num_new_files);
+  if (!reload_result) {
+    KATANA_LOG_FATAL("making result: {}", reload_result.error());
+  }
+  KATANA_LOG_ASSERT(reload_result.value()->Equals(g2.get()));
+  KATANA_LOG_ASSERT(reload_result.value()->GetNodePropertyNames().size() == 3);
+}
+
+void
+TestParquetWriteOptions() {
+  constexpr int64_t kNumRows = 1 << 16;
+  arrow::Int64Builder ints;
+  arrow::DoubleBuilder doubles;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_LOG_ASSERT(ints.Append(i % 7).ok());
+    KATANA_LOG_ASSERT(doubles.Append(static_cast<double>(i) / 3).ok());
+  }
+  std::shared_ptr<arrow::Array> int_array = ints.Finish().ValueOrDie();
+  std::shared_ptr<arrow::Array> double_array = doubles.Finish().ValueOrDie();
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("few", arrow::int64()),
+           arrow::field("many", arrow::float64())}),
+      {int_array, double_array});
+
+  tsuba::ParquetWriteOptions opts;
+  if (arrow::util::Codec::IsAvailable(arrow::Compression::ZSTD)) {
+    opts.defaults.compression = arrow::Compression::ZSTD;
+  }
+  opts.auto_tune = true;
+  opts.row_group_length = kNumRows / 4;
+
+  tsuba::ColumnWriteOptions few = tsuba::ParquetWriteOptions::TuneColumn(
+      *arrow::int64(), tsuba::ComputePropertyStats(*table->column(0)),
+      opts.defaults);
+  KATANA_LOG_ASSERT(few.dictionary && !few.byte_stream_split);
+  tsuba::ColumnWriteOptions many = tsuba::ParquetWriteOptions::TuneColumn(
+      *arrow::float64(), tsuba::ComputePropertyStats(*table->column(1)),
+      opts.defaults);
+  KATANA_LOG_ASSERT(!many.dictionary && many.byte_stream_split);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquetwriter");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::Uri uri = uri_res.value();
+
+  tsuba::ParquetWriteStats before = tsuba::GetParquetWriteStats();
+  auto writer_res = tsuba::ParquetWriter::Make(table, opts);
+  KATANA_LOG_ASSERT(writer_res);
+  auto write_res = writer_res.value()->WriteToUri(uri);
+  KATANA_LOG_VASSERT(write_res, "{}", write_res.error());
+  tsuba::ParquetWriteStats after = tsuba::GetParquetWriteStats();
+  KATANA_LOG_ASSERT(after.num_files == before.num_files + 1);
+  KATANA_LOG_ASSERT(after.encoded_bytes > before.encoded_bytes);
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  auto read_res = reader_res.value()->ReadFromUri(uri);
+  fs::remove(uri.path());
+  KATANA_LOG_VASSERT(read_res, "{}", read_res.error());
+  KATANA_LOG_ASSERT(read_res.value()->Equals(*table));
+}
+
+void
+TestDictionaryStrings() {
+  constexpr int64_t kNumRows = 1 << 16;
+  const char* kLabels[] = {"Person", "Place", "Thing"};
+  arrow::StringDictionary32Builder labels;
+  arrow::StringBuilder plain_labels;
+  arrow::StringBuilder names;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_LOG_ASSERT(
+        i % 11 == 0 ? labels.AppendNull().ok()
+                    : labels.Append(kLabels[i % 3]).ok());
+    KATANA_LOG_ASSERT(plain_labels.Append(kLabels[i % 3]).ok());
+    KATANA_LOG_ASSERT(names.Append(fmt::format("name{}", i)).ok());
+  }
+  std::shared_ptr<arrow::Array> label_array = labels.Finish().ValueOrDie();
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("label", label_array->type()),
+           arrow::field("plain_label", arrow::utf8()),
+           arrow::field("name", arrow::utf8())}),
+      {label_array, plain_labels.Finish().ValueOrDie(),
+       names.Finish().ValueOrDie()});
+
+  // Dictionary columns keep their dictionaries
+  KATANA_LOG_ASSERT(tsuba::ParquetWriteOptions::TuneColumn(
+                        *label_array->type(),
+                        tsuba::ComputePropertyStats(*table->column(0)),
+                        tsuba::ColumnWriteOptions{.dictionary = false})
+                        .dictionary);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquetdictionary");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::Uri uri = uri_res.value();
+  tsuba::ParquetWriteOptions opts;
+  opts.row_group_length = kNumRows / 4;
+  auto writer_res = tsuba::ParquetWriter::Make(table, opts);
+  KATANA_LOG_ASSERT(writer_res);
+  auto write_res = writer_res.value()->WriteToUri(uri);
+  KATANA_LOG_VASSERT(write_res, "{}", write_res.error());
+
+  for (bool dictionary_strings : {true, false}) {
+    auto reader_res = tsuba::ParquetReader::Make(tsuba::ParquetReader::ReadOpts{
+        .dictionary_strings = dictionary_strings});
+    KATANA_LOG_ASSERT(reader_res);
+    auto read_res = reader_res.value()->ReadFromUri(uri);
+    KATANA_LOG_VASSERT(read_res, "{}", read_res.error());
+    std::shared_ptr<arrow::Table> out = read_res.value();
+
+    // Low cardinality strings stay dictionaries with one dictionary for all
+    // row groups, and others are decoded
+    for (int i : {0, 1}) {
+      KATANA_LOG_ASSERT(out->column(i)->num_chunks() == 1);
+      if (!dictionary_strings) {
+        KATANA_LOG_ASSERT(out->column(i)->type()->Equals(arrow::large_utf8()));
+        continue;
+      }
+      auto dict_array = std::static_pointer_cast<arrow::DictionaryArray>(
+          out->column(i)->chunk(0));
+      KATANA_LOG_ASSERT(dict_array->dictionary()->length() == 3);
+      auto view_res =
+          katana::DictionaryStringPropertyReadOnlyView::Make(*dict_array);
+      KATANA_LOG_VASSERT(view_res, "{}", view_res.error());
+      const auto& view = view_res.value();
+      int32_t person = view.FindCode("Person");
+      for (int64_t row = 0; row < kNumRows; ++row) {
+        if (i == 0 && row % 11 == 0) {
+          KATANA_LOG_ASSERT(!view.IsValid(row));
+          continue;
+        }
+        KATANA_LOG_ASSERT(view.GetView(row) == kLabels[row % 3]);
+        KATANA_LOG_ASSERT((view.GetCode(row) == person) == (row % 3 == 0));
+      }
+    }
+    KATANA_LOG_ASSERT(out->column(2)->type()->Equals(arrow::large_utf8()));
+  }
+  fs::remove(uri.path());
+}
+
+void
+TestArrowIpcProperties() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 2, &policy);
+  g->MarkAllPropertiesPersistent();
+  std::string name = g->GetNodePropertyNames().at(1);
+  KATANA_LOG_ASSERT(g->SetNodePropertyFileFormat(
+      name, tsuba::PropertyFileFormat::kArrowIpc));
+  KATANA_LOG_ASSERT(!g->SetNodePropertyFileFormat(
+      "missing", tsuba::PropertyFileFormat::kArrowIpc));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  size_t num_ipc_files = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (tsuba::PropertyFileFormatOf(entry.path().string()) ==
+        tsuba::PropertyFileFormat::kArrowIpc) {
+      ++num_ipc_files;
+    }
+  }
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(num_ipc_files == 1);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->Equals(g.get()));
+
+  // The column points into the mapped file rather than into a copy
+  auto column = g2->GetNodeProperty(name);
+  KATANA_LOG_ASSERT(!katana::IsMutable(*column->chunk(0)->data()));
+}
+
+void
+TestChecksums() {
+  // Blocks are checked independently, the last one may be short
+  std::vector<uint8_t> data(2 * tsuba::FileChecksum::kBlockSize + 5, 1);
+  tsuba::FileChecksum checksum =
+      tsuba::FileChecksum::Compute(data.data(), data.size());
+  KATANA_LOG_ASSERT(checksum.crcs.size() == 3);
+  KATANA_LOG_ASSERT(checksum.VerifyAll(data.data()));
+  data.back() = 2;
+  KATANA_LOG_ASSERT(
+      checksum.Verify(data.data(), 0, 2 * tsuba::FileChecksum::kBlockSize));
+  auto verify_res = checksum.VerifyAll(data.data());
+  KATANA_LOG_ASSERT(!verify_res);
+  KATANA_LOG_ASSERT(verify_res.error() == tsuba::ErrorCode::ChecksumMismatch);
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 2, &policy);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  auto make_result = katana::PropertyGraph::Make(rdg_dir);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(make_result.value()->Equals(g.get()));
+
+  // Flip a byte in the middle of the topology
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("topology", 0) != 0) {
+      continue;
+    }
+    std::fstream file(
+        entry.path().string(),
+        std::ios::in | std::ios::out | std::ios::binary);
+    std::streamoff middle = fs::file_size(entry.path()) / 2;
+    file.seekg(middle);
+    char byte = static_cast<char>(file.get() ^ 0xff);
+    file.seekp(middle);
+    file.put(byte);
+  }
+
+  tsuba::RDGLoadOptions opts;
+  auto corrupt_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  opts.map_topology_read_only = true;
+  auto corrupt_mapped_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  opts.verify_checksums = false;
+  auto unverified_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+
+  KATANA_LOG_ASSERT(!corrupt_result);
+  KATANA_LOG_VASSERT(
+      corrupt_result.error() == tsuba::ErrorCode::ChecksumMismatch, "{}",
+      corrupt_result.error());
+  KATANA_LOG_ASSERT(!corrupt_mapped_result);
+  KATANA_LOG_ASSERT(
+      corrupt_mapped_result.error() == tsuba::ErrorCode::ChecksumMismatch);
+  // Without verification the corruption is not detected as such
+  KATANA_LOG_ASSERT(
+      unverified_result ||
+      unverified_result.error() != tsuba::ErrorCode::ChecksumMismatch);
+}
+
+void
+TestIoFaults() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  constexpr uint64_t kLatencyUs = 2000;
+  tsuba::internal::IoFaultTestInit({.latency_us = kLatencyUs});
+  KATANA_LOG_ASSERT(tsuba::internal::IoFaultTestActive());
+  auto make_result = katana::PropertyGraph::Make(rdg_dir);
+  tsuba::internal::IoFaultStats stats = tsuba::internal::IoFaultTestStats();
+  tsuba::internal::IoFaultTestInit();
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  // Every storage operation of the load was held back, and the results are
+  // unchanged
+  KATANA_LOG_ASSERT(!tsuba::internal::IoFaultTestActive());
+  KATANA_LOG_ASSERT(stats.num_ops > 0 && stats.num_spikes == 0);
+  KATANA_LOG_VASSERT(
+      stats.delay_us >= stats.num_ops * kLatencyUs, "{} ops delayed {} us",
+      stats.num_ops, stats.delay_us);
+  KATANA_LOG_ASSERT(make_result.value()->Equals(g.get()));
+}
+
 }  // namespace
 
 int
@@ -258,6 +793,17 @@ main(int argc, char** argv) {
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
+  TestReadOnlyTopology();
+  TestLazyProperties();
+  TestComputePropertyStats();
+  TestStoredPropertyStats();
+  TestAuxTopology();
+  TestIncrementalCommit();
+  TestParquetWriteOptions();
+  TestDictionaryStrings();
+  TestArrowIpcProperties();
+  TestChecksums();
+  TestIoFaults();
 
   return 0;
 }
@@ -0,0 +1,183 @@
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+using Node = katana::GraphTopology::Node;
+
+constexpr Node kNumNodes = 10;
+
+struct Value : public katana::PODProperty<int64_t> {};
+struct Weight : public katana::PODProperty<double> {};
+
+/// Node i has edges to i + 2 and i + 1 (mod kNumNodes), in that order, and
+/// property "value" i. Edge e has "weight" e.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<int64_t> values;
+  std::vector<double> weights;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (Node d : {(n + 2) % kNumNodes, (n + 1) % kNumNodes}) {
+      weights.emplace_back(dests.size());
+      dests.emplace_back(d);
+    }
+    indices.emplace_back(dests.size());
+    values.emplace_back(n);
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::int64())}),
+      {katana::BuildArray(values)})));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::float64())}),
+      {katana::BuildArray(weights)})));
+  return g;
+}
+
+const uint8_t*
+Values(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  KATANA_LOG_ASSERT(column && column->num_chunks() == 1);
+  return column->chunk(0)->data()->buffers[1]->data();
+}
+
+int64_t
+NodeValue(const katana::PropertyGraph& g, Node n) {
+  auto column = g.GetNodeProperty("value");
+  return std::static_pointer_cast<arrow::Int64Array>(column->chunk(0))
+      ->Value(n);
+}
+
+/// A copy shares the buffers of the original until one of them writes
+void
+TestShare() {
+  auto original = MakeGraph();
+  auto copy_res = original->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+
+  KATANA_LOG_ASSERT(g->Equals(original.get()));
+  KATANA_LOG_ASSERT(
+      g->topology().out_dests->raw_values() ==
+      original->topology().out_dests->raw_values());
+  KATANA_LOG_ASSERT(
+      Values(g->GetNodeProperty("value")) ==
+      Values(original->GetNodeProperty("value")));
+
+  // Writing through a typed view copies only the properties it can write
+  using Graph = katana::TypedPropertyGraph<std::tuple<Value>, std::tuple<>>;
+  auto typed_res = Graph::Make(g.get(), {"value"}, {});
+  KATANA_LOG_VASSERT(typed_res, "{}", typed_res.error());
+  Graph typed = std::move(typed_res.value());
+  for (Node n : typed) {
+    typed.GetData<Value>(n) = -static_cast<int64_t>(n);
+  }
+  KATANA_LOG_ASSERT(
+      Values(g->GetNodeProperty("value")) !=
+      Values(original->GetNodeProperty("value")));
+  KATANA_LOG_ASSERT(
+      Values(g->GetEdgeProperty("weight")) ==
+      Values(original->GetEdgeProperty("weight")));
+  for (Node n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(NodeValue(*g, n) == -static_cast<int64_t>(n));
+    KATANA_LOG_ASSERT(NodeValue(*original, n) == n);
+  }
+
+  // So does sorting the topology of either graph
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(g.get()));
+  const katana::GraphTopology& topology = original->topology();
+  for (Node n = 0; n < kNumNodes; ++n) {
+    auto e = *topology.edges(n).begin();
+    KATANA_LOG_ASSERT(topology.edge_dest(e) == (n + 2) % kNumNodes);
+  }
+
+  // The original can still be written to through views as well
+  using EdgeGraph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<Weight>>;
+  auto original_res = EdgeGraph::Make(original.get(), {}, {"weight"});
+  KATANA_LOG_VASSERT(original_res, "{}", original_res.error());
+  EdgeGraph original_typed = std::move(original_res.value());
+  original_typed.GetEdgeData<Weight>(original_typed.edges(0).begin()) = -1;
+  auto weights = std::static_pointer_cast<arrow::DoubleArray>(
+      g->GetEdgeProperty("weight")->chunk(0));
+  KATANA_LOG_ASSERT(weights->Value(0) == 0);
+}
+
+/// Copying a subset of the properties leaves the others out of the copy only
+void
+TestSubset() {
+  auto original = MakeGraph();
+  auto copy_res = original->Copy({"value"}, {});
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+
+  KATANA_LOG_ASSERT(g->node_schema()->num_fields() == 1);
+  KATANA_LOG_ASSERT(g->edge_schema()->num_fields() == 0);
+  KATANA_LOG_ASSERT(original->edge_schema()->num_fields() == 1);
+  KATANA_LOG_ASSERT(g->num_edges() == original->num_edges());
+
+  KATANA_LOG_ASSERT(!original->Copy({"missing"}, {}));
+}
+
+/// Committing a copy of a stored graph keeps the files it shares
+void
+TestCommit() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/property-graph-copy");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  KATANA_LOG_ASSERT(MakeGraph()->Write(rdg_dir, "property-graph-copy"));
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir);
+  KATANA_LOG_ASSERT(make_res);
+  auto copy_res = make_res.value()->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+
+  std::vector<int64_t> labels(kNumNodes, 7);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("label", arrow::int64())}),
+      {katana::BuildArray(labels)})));
+  if (auto res = g->Commit("property-graph-copy"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", res.error());
+  }
+
+  auto reload_res = katana::PropertyGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(reload_res);
+  const katana::PropertyGraph& reloaded = *reload_res.value();
+  KATANA_LOG_ASSERT(reloaded.node_schema()->num_fields() == 2);
+  KATANA_LOG_ASSERT(reloaded.num_edges() == 2 * kNumNodes);
+  KATANA_LOG_ASSERT(NodeValue(reloaded, 3) == 3);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestShare();
+  TestSubset();
+  TestCommit();
+
+  return 0;
+}
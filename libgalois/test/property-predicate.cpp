@@ -0,0 +1,176 @@
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyPredicate.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using P = katana::PropertyPredicate;
+
+// Several blocks of rows, and not a multiple of a word
+constexpr size_t kNumNodes = 10000 + 37;
+
+/// The properties of a node, for evaluating predicates serially
+struct Row {
+  std::optional<int64_t> age;
+  double score;
+  std::string country;
+};
+
+std::vector<Row>
+AddProperties(katana::PropertyGraph* g) {
+  std::vector<Row> rows;
+  arrow::Int64Builder ages;
+  arrow::DoubleBuilder scores;
+  arrow::StringBuilder countries;
+  // The countries again, dictionary encoded
+  arrow::StringDictionary32Builder labels;
+  const char* kCountries[] = {"US", "DE", "IN", "BR"};
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    Row row;
+    // Ages increase with the node ID, so that comparisons select ranges
+    if (n % 7 != 0) {
+      row.age = n / 100;
+    }
+    row.score = (n % 1000) / 10.0;
+    row.country = kCountries[(n * 13) % 4];
+    KATANA_LOG_ASSERT(
+        row.age ? ages.Append(*row.age).ok() : ages.AppendNull().ok());
+    KATANA_LOG_ASSERT(scores.Append(row.score).ok());
+    KATANA_LOG_ASSERT(countries.Append(row.country).ok());
+    KATANA_LOG_ASSERT(labels.Append(row.country).ok());
+    rows.emplace_back(row);
+  }
+  std::shared_ptr<arrow::Array> age_array;
+  std::shared_ptr<arrow::Array> score_array;
+  std::shared_ptr<arrow::Array> country_array;
+  std::shared_ptr<arrow::Array> label_array;
+  KATANA_LOG_ASSERT(ages.Finish(&age_array).ok());
+  KATANA_LOG_ASSERT(scores.Finish(&score_array).ok());
+  KATANA_LOG_ASSERT(countries.Finish(&country_array).ok());
+  KATANA_LOG_ASSERT(labels.Finish(&label_array).ok());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("age", arrow::int64()),
+           arrow::field("score", arrow::float64()),
+           arrow::field("country", arrow::utf8()),
+           arrow::field("label", label_array->type())}),
+      {age_array, score_array, country_array, label_array})));
+  return rows;
+}
+
+void
+Check(
+    const katana::PropertyGraph& g, const std::vector<Row>& rows,
+    const P& predicate, const std::function<bool(const Row&)>& expected) {
+  katana::DynamicBitset mask;
+  auto res = katana::EvaluateNodePredicate(g, predicate, &mask);
+  KATANA_LOG_VASSERT(res, "{}: {}", predicate.ToString(), res.error());
+  KATANA_LOG_ASSERT(mask.size() == rows.size());
+  size_t count = 0;
+  for (size_t n = 0; n < rows.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        mask.test(n) == expected(rows[n]), "{}: node {}",
+        predicate.ToString(), n);
+    count += expected(rows[n]);
+  }
+  KATANA_LOG_ASSERT(mask.count() == count);
+}
+
+void
+TestEvaluate(const katana::PropertyGraph& g, const std::vector<Row>& rows) {
+  auto age_over_30 = P::Compare("age", P::kGreater, int64_t{30});
+  auto us = P::Compare("country", P::kEqual, std::string("US"));
+  auto high_score = P::Compare("score", P::kGreaterEqual, 50.5);
+
+  Check(g, rows, age_over_30, [](const Row& r) { return r.age > 30; });
+  Check(g, rows, P::Compare("age", P::kLessEqual, 12.5), [](const Row& r) {
+    return r.age && *r.age <= 12.5;
+  });
+  Check(g, rows, P::Compare("age", P::kNotEqual, int64_t{4}), [](auto& r) {
+    return r.age && *r.age != 4;
+  });
+  Check(g, rows, us, [](const Row& r) { return r.country == "US"; });
+  Check(
+      g, rows, P::Compare("country", P::kLess, std::string("E")),
+      [](const Row& r) { return r.country < "E"; });
+  Check(
+      g, rows, P::Compare("label", P::kEqual, std::string("US")),
+      [](const Row& r) { return r.country == "US"; });
+  Check(
+      g, rows, P::Compare("label", P::kGreaterEqual, std::string("DE")),
+      [](const Row& r) { return r.country >= "DE"; });
+  Check(g, rows, high_score, [](const Row& r) { return r.score >= 50.5; });
+  Check(g, rows, P::IsNull("age"), [](const Row& r) { return !r.age; });
+
+  // Not holds for nulls
+  Check(g, rows, !age_over_30, [](const Row& r) { return !(r.age > 30); });
+  Check(g, rows, age_over_30 && us, [](const Row& r) {
+    return r.age > 30 && r.country == "US";
+  });
+  Check(g, rows, age_over_30 && us && high_score, [](const Row& r) {
+    return r.age > 30 && r.country == "US" && r.score >= 50.5;
+  });
+  Check(g, rows, age_over_30 || !us, [](const Row& r) {
+    return r.age > 30 || r.country != "US";
+  });
+  Check(g, rows, !(P::IsNull("age") || high_score), [](const Row& r) {
+    return !(!r.age || r.score >= 50.5);
+  });
+  // Nothing or everything
+  Check(g, rows, P::Compare("age", P::kGreater, int64_t{1000}), [](auto&) {
+    return false;
+  });
+  Check(g, rows, high_score || !high_score, [](auto&) { return true; });
+}
+
+void
+TestErrors(const katana::PropertyGraph& g) {
+  katana::DynamicBitset mask;
+  auto missing = katana::EvaluateNodePredicate(
+      g, P::Compare("missing", P::kEqual, int64_t{1}), &mask);
+  KATANA_LOG_ASSERT(!missing);
+  KATANA_LOG_ASSERT(missing.error() == katana::ErrorCode::PropertyNotFound);
+
+  auto mistyped = katana::EvaluateNodePredicate(
+      g, P::Compare("country", P::kEqual, int64_t{1}), &mask);
+  KATANA_LOG_ASSERT(!mistyped);
+  KATANA_LOG_ASSERT(mistyped.error() == katana::ErrorCode::TypeError);
+
+  // Errors in nested operands are reported too
+  auto nested = katana::EvaluateNodePredicate(
+      g,
+      P::Compare("age", P::kGreater, int64_t{0}) ||
+          P::Compare("score", P::kEqual, std::string("x")),
+      &mask);
+  KATANA_LOG_ASSERT(!nested);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::vector<Row> rows = AddProperties(g.get());
+
+  for (unsigned threads : {1u, 4u}) {
+    katana::setActiveThreads(threads);
+    TestEvaluate(*g, rows);
+  }
+  TestErrors(*g);
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyViews.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+/// Large enough that the chunks of a property are copied in several blocks
+constexpr size_t kNumNodes = 1 << 19;
+constexpr size_t kSplit = 300000;
+constexpr int32_t kWidth = 4;
+
+struct Rank : public katana::PODProperty<uint32_t> {};
+
+struct Embedding : public katana::FixedSizeListProperty<float> {};
+
+bool
+IsNullRank(size_t i) {
+  return i >= kSplit && i % 7 == 0;
+}
+
+/// Make ranks [begin, end) as a chunk that starts at an offset into its
+/// buffers
+std::shared_ptr<arrow::Array>
+MakeRanks(size_t begin, size_t end) {
+  constexpr int64_t kSkip = 5;
+  arrow::UInt32Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendNulls(kSkip).ok());
+  for (size_t i = begin; i < end; ++i) {
+    if (IsNullRank(i)) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(static_cast<uint32_t>(i)).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array->Slice(kSkip);
+}
+
+std::shared_ptr<arrow::Array>
+MakeEmbeddings(size_t begin, size_t end) {
+  arrow::FixedSizeListBuilder builder(
+      arrow::default_memory_pool(), std::make_shared<arrow::FloatBuilder>(),
+      kWidth);
+  auto* values = static_cast<arrow::FloatBuilder*>(builder.value_builder());
+  for (size_t i = begin; i < end; ++i) {
+    KATANA_LOG_ASSERT(builder.Append().ok());
+    for (int32_t k = 0; k < kWidth; ++k) {
+      KATANA_LOG_ASSERT(values->Append(i * kWidth + k).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeChunkedGraph() {
+  LinePolicy policy{1};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+
+  auto ranks = std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{
+      MakeRanks(0, kSplit), MakeRanks(kSplit, kSplit),
+      MakeRanks(kSplit, kNumNodes)});
+  auto embeddings = std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{
+      MakeEmbeddings(0, 1000), MakeEmbeddings(1000, kNumNodes)});
+
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("rank", ranks->type()),
+           arrow::field("embedding", embeddings->type())}),
+      {ranks, embeddings});
+  if (auto r = g->AddNodeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add node properties: {}", r.error());
+  }
+  return g;
+}
+
+void
+TestCoalesce() {
+  std::unique_ptr<katana::PropertyGraph> g = MakeChunkedGraph();
+
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<Rank, Embedding>, std::tuple<>>;
+  auto r = Graph::Make(g.get(), {"rank", "embedding"}, {});
+  if (!r) {
+    KATANA_LOG_FATAL("could not make property graph: {}", r.error());
+  }
+  const Graph& graph = r.value();
+
+  KATANA_LOG_ASSERT(g->GetNodeProperty("rank")->num_chunks() == 1);
+  KATANA_LOG_ASSERT(g->GetNodeProperty("embedding")->num_chunks() == 1);
+
+  const auto& ranks = graph.GetNodePropertyView<Rank>();
+  KATANA_LOG_ASSERT(ranks.size() == kNumNodes);
+  const uint32_t* rank_data = ranks.data();
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_VASSERT(ranks.IsValid(i) == !IsNullRank(i), "node {}", i);
+    if (!IsNullRank(i)) {
+      KATANA_LOG_VASSERT(rank_data[i] == i, "node {}", i);
+      KATANA_LOG_ASSERT(graph.GetData<Rank>(i) == i);
+    }
+  }
+
+  const auto& embeddings = graph.GetNodePropertyView<Embedding>();
+  KATANA_LOG_ASSERT(embeddings.size() == kNumNodes);
+  KATANA_LOG_ASSERT(embeddings.width() == static_cast<size_t>(kWidth));
+  const float* embedding_data = embeddings.data();
+  for (size_t i = 0; i < kNumNodes * kWidth; ++i) {
+    KATANA_LOG_VASSERT(embedding_data[i] == i, "element {}", i);
+  }
+  KATANA_LOG_ASSERT(graph.GetData<Embedding>(1000)[1] == 1000 * kWidth + 1);
+  KATANA_LOG_ASSERT(embeddings.IsValid(1000));
+}
+
+void
+TestCoalesceStrings() {
+  arrow::StringBuilder builder;
+  KATANA_LOG_ASSERT(builder.Append("a").ok());
+  KATANA_LOG_ASSERT(builder.Append("bc").ok());
+  std::shared_ptr<arrow::Array> chunk;
+  KATANA_LOG_ASSERT(builder.Finish(&chunk).ok());
+
+  arrow::ChunkedArray chunked({chunk, chunk->Slice(1)});
+  auto res = katana::CoalesceChunks(chunked);
+  KATANA_LOG_ASSERT(res);
+  const auto& strings = static_cast<const arrow::StringArray&>(*res.value());
+  KATANA_LOG_ASSERT(strings.length() == 3);
+  KATANA_LOG_ASSERT(strings.GetString(2) == "bc");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestCoalesce();
+  TestCoalesceStrings();
+
+  return 0;
+}
@@ -0,0 +1,306 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/QueryServer.h"
+
+namespace {
+
+using json = nlohmann::json;
+using katana::analytics::QueryServer;
+
+constexpr size_t kNumNodes = 1 << 10;
+
+/// Runs leave only the properties they are asked to keep
+void
+TestScratchProperties() {
+  LinePolicy policy{2};
+  QueryServer server;
+  KATANA_LOG_ASSERT(
+      server.AddGraph("ring", MakeFileGraph<uint32_t>(kNumNodes, 1, &policy)));
+
+  json response = server.Handle(json{{"op", "list"}});
+  KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+  json graph = response["graphs"][0];
+  KATANA_LOG_ASSERT(graph["name"] == "ring");
+  KATANA_LOG_ASSERT(graph["num_nodes"] == kNumNodes);
+  auto node_properties = graph["node_properties"];
+
+  response = server.Handle(json{
+      {"op", "run"},
+      {"graph", "ring"},
+      {"analytic", "bfs"},
+      {"args", {{"source", 0}}}});
+  KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+  KATANA_LOG_ASSERT(response["result"]["n_reached_nodes"] == kNumNodes);
+  KATANA_LOG_ASSERT(response["result"]["max_distance"] == kNumNodes / 2);
+  response = server.Handle(json{{"op", "list"}});
+  KATANA_LOG_ASSERT(
+      response["graphs"][0]["node_properties"] == node_properties);
+
+  response = server.Handle(json{
+      {"op", "run"},
+      {"graph", "ring"},
+      {"analytic", "connected_components"},
+      {"output_property", "component"},
+      {"threads", 2}});
+  KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+  KATANA_LOG_ASSERT(response["result"]["total_components"] == 1);
+  response = server.Handle(json{{"op", "list"}});
+  KATANA_LOG_ASSERT(
+      response["graphs"][0]["node_properties"].size() ==
+      node_properties.size() + 1);
+
+  // A failed run reports its error and leaves the graph as it was
+  response = server.Handle(json{
+      {"op", "run"},
+      {"graph", "ring"},
+      {"analytic", "bfs"},
+      {"output_property", "component"},
+      {"args", {{"source", 0}}}});
+  KATANA_LOG_ASSERT(!response["ok"].get<bool>());
+  for (const json& request :
+       {json{{"op", "run"}, {"graph", "ring"}, {"analytic", "no_such"}},
+        json{{"op", "run"}, {"graph", "no_such"}, {"analytic", "bfs"}},
+        json{{"op", "run"}, {"graph", "ring"}, {"analytic", "bfs"}},
+        json{{"op", "no_such"}}, json{{"op", "unload"}, {"graph", "no_such"}},
+        json::array()}) {
+    response = server.Handle(request);
+    KATANA_LOG_VASSERT(!response["ok"].get<bool>(), "{}", request.dump());
+    KATANA_LOG_ASSERT(response["error"].is_string());
+  }
+
+  response = server.Handle(json{{"op", "unload"}, {"graph", "ring"}});
+  KATANA_LOG_ASSERT(response["ok"].get<bool>());
+  response = server.Handle(json{{"op", "list"}});
+  KATANA_LOG_ASSERT(response["graphs"].empty());
+}
+
+/// Memoized runs reuse the results of identical earlier runs
+void
+TestMemoize() {
+  LinePolicy policy{2};
+  QueryServer server;
+  KATANA_LOG_ASSERT(
+      server.AddGraph("ring", MakeFileGraph<uint32_t>(kNumNodes, 1, &policy)));
+
+  auto bfs = [&](uint32_t source, const char* output) {
+    json request{
+        {"op", "run"},
+        {"graph", "ring"},
+        {"analytic", "bfs"},
+        {"memoize", true},
+        {"args", {{"source", source}}}};
+    if (output) {
+      request["output_property"] = output;
+    }
+    json response = server.Handle(request);
+    KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+    return response;
+  };
+
+  json first = bfs(1, nullptr);
+  KATANA_LOG_ASSERT(!first["memoized"].get<bool>());
+  json second = bfs(1, "distance");
+  KATANA_LOG_ASSERT(second["memoized"].get<bool>());
+  KATANA_LOG_ASSERT(second["result"] == first["result"]);
+  KATANA_LOG_ASSERT(second["parallel_loops"] == 0);
+  json list = server.Handle(json{{"op", "list"}});
+  const json& names = list["graphs"][0]["node_properties"];
+  KATANA_LOG_ASSERT(
+      std::find(names.begin(), names.end(), "distance") != names.end());
+
+  // Other args and unmemoized runs run the analytic
+  KATANA_LOG_ASSERT(!bfs(2, nullptr)["memoized"].get<bool>());
+  json unmemoized = server.Handle(json{
+      {"op", "run"},
+      {"graph", "ring"},
+      {"analytic", "bfs"},
+      {"args", {{"source", 1}}}});
+  KATANA_LOG_ASSERT(!unmemoized["memoized"].get<bool>());
+
+  // Unloading a graph forgets its results
+  json unload = server.Handle(json{{"op", "unload"}, {"graph", "ring"}});
+  KATANA_LOG_ASSERT(unload["ok"].get<bool>());
+  KATANA_LOG_ASSERT(
+      server.AddGraph("ring", MakeFileGraph<uint32_t>(kNumNodes, 1, &policy)));
+  KATANA_LOG_ASSERT(!bfs(1, nullptr)["memoized"].get<bool>());
+}
+
+/// Serve on this thread while another sends requests over the socket
+void
+TestServe() {
+  LinePolicy policy{2};
+  QueryServer server;
+  KATANA_LOG_ASSERT(
+      server.AddGraph("ring", MakeFileGraph<uint32_t>(kNumNodes, 1, &policy)));
+
+  std::string socket_path =
+      "/tmp/katana-query-server-test-" + std::to_string(getpid());
+  std::thread client([&]() {
+    auto call = [&](const json& request) {
+      // The server may not be listening yet
+      for (int tries = 0;; ++tries) {
+        auto response =
+            katana::analytics::QueryServerCall(socket_path, request);
+        if (response || tries == 100) {
+          KATANA_LOG_VASSERT(response, "{}", response.error());
+          return response.value();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      }
+    };
+
+    for (int i = 0; i < 3; ++i) {
+      json response = call(json{
+          {"op", "run"},
+          {"graph", "ring"},
+          {"analytic", "bfs"},
+          {"args", {{"source", i}}}});
+      KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+      KATANA_LOG_ASSERT(response["result"]["source_node"] == i);
+    }
+    KATANA_LOG_ASSERT(call(json{{"op", "shutdown"}})["ok"].get<bool>());
+  });
+
+  auto r = server.Serve(socket_path);
+  client.join();
+  KATANA_LOG_VASSERT(r, "{}", r.error());
+  KATANA_LOG_ASSERT(access(socket_path.c_str(), F_OK) != 0);
+}
+
+/// Fetch rows of the resident graph over the socket, in parallel partitions
+void
+TestFetch() {
+  LinePolicy policy{2};
+  QueryServer server;
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+  // The server only reads the graph while it serves
+  const katana::PropertyGraph& graph = *g;
+  std::string property = graph.GetNodePropertyNames().front();
+  std::string edge_property = graph.GetEdgePropertyNames().front();
+  KATANA_LOG_ASSERT(server.AddGraph("ring", std::move(g)));
+
+  // Describing rows needs no socket
+  json response = server.Handle(json{
+      {"op", "fetch"}, {"graph", "ring"}, {"node_range", {10, 20}}});
+  KATANA_LOG_VASSERT(response["ok"].get<bool>(), "{}", response.dump());
+  KATANA_LOG_ASSERT(response["num_rows"] == 10);
+  KATANA_LOG_ASSERT(response["columns"] == json({"id", property}));
+
+  std::string socket_path =
+      "/tmp/katana-query-server-fetch-test-" + std::to_string(getpid());
+  std::thread client([&]() {
+    // The server may not be listening yet
+    for (int tries = 0;; ++tries) {
+      auto response = katana::analytics::QueryServerCall(
+          socket_path, json{{"op", "list"}});
+      if (response || tries == 100) {
+        KATANA_LOG_VASSERT(response, "{}", response.error());
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    auto nodes_res = katana::analytics::QueryServerFetch(
+        socket_path, json{{"graph", "ring"}, {"batch_rows", 100}}, 3);
+    KATANA_LOG_VASSERT(nodes_res, "{}", nodes_res.error());
+    auto nodes = nodes_res.value();
+    KATANA_LOG_ASSERT(nodes->num_rows() == static_cast<int64_t>(kNumNodes));
+    auto ids_res = nodes->GetColumnByName("id");
+    KATANA_LOG_ASSERT(ids_res);
+    uint32_t expected_id = 0;
+    for (const auto& chunk : ids_res->chunks()) {
+      const auto& ids = static_cast<const arrow::UInt32Array&>(*chunk);
+      for (int64_t i = 0; i < ids.length(); ++i) {
+        KATANA_LOG_ASSERT(ids.Value(i) == expected_id++);
+      }
+    }
+    KATANA_LOG_ASSERT(
+        nodes->GetColumnByName(property)->Equals(
+            *graph.GetNodeProperty(property)));
+
+    const katana::GraphTopology& topology = graph.topology();
+    auto edges_res = katana::analytics::QueryServerFetch(
+        socket_path,
+        json{{"graph", "ring"}, {"table", "edges"}, {"node_range", {10, 20}}},
+        2);
+    KATANA_LOG_VASSERT(edges_res, "{}", edges_res.error());
+    auto edges_combined = edges_res.value()->CombineChunks();
+    KATANA_LOG_ASSERT(edges_combined.ok());
+    auto edges = edges_combined.ValueOrDie();
+    KATANA_LOG_ASSERT(
+        edges->ColumnNames() ==
+        std::vector<std::string>({"src", "dst", edge_property}));
+    const auto& srcs =
+        static_cast<const arrow::UInt32Array&>(*edges->column(0)->chunk(0));
+    const auto& dsts =
+        static_cast<const arrow::UInt32Array&>(*edges->column(1)->chunk(0));
+    int64_t row = 0;
+    for (uint32_t n = 10; n < 20; ++n) {
+      for (auto e : topology.edges(n)) {
+        KATANA_LOG_ASSERT(srcs.Value(row) == n);
+        KATANA_LOG_ASSERT(dsts.Value(row) == topology.edge_dest(e));
+        ++row;
+      }
+    }
+    KATANA_LOG_ASSERT(row == edges->num_rows());
+
+    auto subset_res = katana::analytics::QueryServerFetch(
+        socket_path,
+        json{
+            {"graph", "ring"},
+            {"nodes", {5, 3, 5}},
+            {"properties", json::array()}});
+    KATANA_LOG_VASSERT(subset_res, "{}", subset_res.error());
+    KATANA_LOG_ASSERT(subset_res.value()->num_columns() == 1);
+    const auto& subset = static_cast<const arrow::UInt32Array&>(
+        *subset_res.value()->column(0)->chunk(0));
+    KATANA_LOG_ASSERT(
+        subset.length() == 3 && subset.Value(0) == 5 &&
+        subset.Value(1) == 3 && subset.Value(2) == 5);
+
+    for (const json& request :
+         {json{{"graph", "ring"}, {"properties", json::array({"no_such"})}},
+          json{{"graph", "ring"}, {"node_range", {20, 10}}},
+          json{{"graph", "ring"}, {"table", "no_such"}},
+          json{{"graph", "no_such"}}}) {
+      KATANA_LOG_VASSERT(
+          !katana::analytics::QueryServerFetch(socket_path, request),
+          "{}", request.dump());
+    }
+
+    KATANA_LOG_ASSERT(katana::analytics::QueryServerCall(
+                          socket_path, json{{"op", "shutdown"}})
+                          .value()["ok"]
+                          .get<bool>());
+  });
+
+  auto r = server.Serve(socket_path);
+  client.join();
+  KATANA_LOG_VASSERT(r, "{}", r.error());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestScratchProperties();
+  TestMemoize();
+  TestServe();
+  TestFetch();
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <string>
+
+#include <arrow/api.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/Snapshot.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+const std::string kCommandLine = "rdg-snapshot";
+
+std::shared_ptr<arrow::Table>
+MakeProps(const std::string& name, size_t size) {
+  katana::TableBuilder builder{size};
+  katana::ColumnOptions options;
+  options.name = name;
+  options.ascending_values = true;
+  builder.AddColumn<uint64_t>(options);
+  return builder.Finish();
+}
+
+size_t
+CountFiles(const std::string& dir) {
+  return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+}
+
+/// Whether a file of dir starts with prefix
+bool
+HasFileStartingWith(const std::string& dir, const std::string& prefix) {
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    if (boost::starts_with(entry.path().filename().string(), prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+HasNodeProperty(const katana::PropertyGraph& g, const std::string& name) {
+  auto names = g.GetNodePropertyNames();
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+void
+Commit(katana::PropertyGraph* g, const std::string& rdg_dir) {
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Commit(kCommandLine); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", res.error());
+  }
+}
+
+void
+TestSnapshots() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 2, &policy);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/rdgsnapshot");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, kCommandLine); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing: {}", res.error());
+  }
+
+  auto snapshot_res = tsuba::Snapshot::Make(rdg_dir);
+  KATANA_LOG_VASSERT(snapshot_res, "{}", snapshot_res.error());
+  tsuba::Snapshot snapshot = std::move(snapshot_res.value());
+  KATANA_LOG_ASSERT(snapshot.pinned());
+  uint64_t first_version = snapshot.version();
+
+  // A writer commits a version with a property, then one without it
+  auto writer_res = katana::PropertyGraph::Make(rdg_dir);
+  KATANA_LOG_VASSERT(writer_res, "{}", writer_res.error());
+  std::unique_ptr<katana::PropertyGraph> writer = std::move(writer_res.value());
+  KATANA_LOG_ASSERT(writer->AddNodeProperties(MakeProps("first", 10)));
+  Commit(writer.get(), rdg_dir);
+  KATANA_LOG_ASSERT(writer->RemoveNodeProperty("first"));
+  KATANA_LOG_ASSERT(writer->AddNodeProperties(MakeProps("second", 10)));
+  Commit(writer.get(), rdg_dir);
+  uint64_t middle_version = first_version + 1;
+  uint64_t last_version = first_version + 2;
+
+  // The middle version goes, but the pinned one stays
+  size_t num_files = CountFiles(rdg_dir);
+  auto gc_res = tsuba::CollectGarbage(rdg_dir);
+  KATANA_LOG_VASSERT(gc_res, "{}", gc_res.error());
+  const tsuba::GarbageCollectionStats& stats = gc_res.value();
+  auto collected = [&](uint64_t version) {
+    return std::count(
+               stats.collected_versions.begin(), stats.collected_versions.end(),
+               version) > 0;
+  };
+  KATANA_LOG_ASSERT(collected(middle_version));
+  KATANA_LOG_ASSERT(!collected(first_version));
+  KATANA_LOG_ASSERT(!collected(last_version));
+  KATANA_LOG_ASSERT(
+      stats.pinned_versions == std::vector<uint64_t>{first_version});
+  KATANA_LOG_ASSERT(CountFiles(rdg_dir) + stats.deleted_files == num_files);
+  // The property of the middle version was only referred to by it
+  KATANA_LOG_ASSERT(!HasFileStartingWith(rdg_dir, "first"));
+  KATANA_LOG_ASSERT(!tsuba::Open(rdg_dir, middle_version, tsuba::kReadOnly));
+  KATANA_LOG_ASSERT(!tsuba::Snapshot::Make(rdg_dir, middle_version));
+
+  auto reader_res = katana::PropertyGraph::Make(snapshot);
+  KATANA_LOG_VASSERT(reader_res, "{}", reader_res.error());
+  KATANA_LOG_ASSERT(reader_res.value()->Equals(g.get()));
+
+  // Moving to the latest version releases the first one
+  auto refresh_res = snapshot.Refresh();
+  KATANA_LOG_VASSERT(refresh_res, "{}", refresh_res.error());
+  KATANA_LOG_ASSERT(refresh_res.value());
+  KATANA_LOG_ASSERT(snapshot.version() == last_version);
+  refresh_res = snapshot.Refresh();
+  KATANA_LOG_ASSERT(refresh_res && !refresh_res.value());
+
+  // Everything of the first version is shared with the latest one, except
+  // its metadata and partition header
+  gc_res = tsuba::CollectGarbage(rdg_dir);
+  KATANA_LOG_VASSERT(gc_res, "{}", gc_res.error());
+  KATANA_LOG_ASSERT(
+      gc_res.value().collected_versions ==
+      std::vector<uint64_t>{first_version});
+  KATANA_LOG_ASSERT(gc_res.value().deleted_files == 2);
+
+  reader_res = katana::PropertyGraph::Make(snapshot);
+  KATANA_LOG_VASSERT(reader_res, "{}", reader_res.error());
+  KATANA_LOG_ASSERT(reader_res.value()->Equals(writer.get()));
+  KATANA_LOG_ASSERT(HasNodeProperty(*reader_res.value(), "second"));
+  KATANA_LOG_ASSERT(!HasNodeProperty(*reader_res.value(), "first"));
+
+  // Pins whose lease ran out are deleted
+  std::string expired_pin =
+      fmt::format("{}/pin_{}-expired", rdg_dir, last_version);
+  std::string contents = fmt::format(
+      "{{\"version\": {}, \"expires\": 1}}\n", last_version);
+  KATANA_LOG_ASSERT(tsuba::FileStore(
+      expired_pin, reinterpret_cast<const uint8_t*>(contents.data()),
+      contents.size()));
+  gc_res = tsuba::CollectGarbage(rdg_dir);
+  KATANA_LOG_VASSERT(gc_res, "{}", gc_res.error());
+  KATANA_LOG_ASSERT(gc_res.value().expired_pins == 1);
+  KATANA_LOG_ASSERT(gc_res.value().collected_versions.empty());
+  KATANA_LOG_ASSERT(!fs::exists(expired_pin));
+
+  // Releasing deletes the pin
+  KATANA_LOG_ASSERT(HasFileStartingWith(rdg_dir, "pin_"));
+  KATANA_LOG_ASSERT(snapshot.Release());
+  KATANA_LOG_ASSERT(!snapshot.pinned());
+  KATANA_LOG_ASSERT(!HasFileStartingWith(rdg_dir, "pin_"));
+  KATANA_LOG_ASSERT(!tsuba::CollectGarbage(rdg_dir, 0));
+
+  fs::remove_all(rdg_dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestSnapshots();
+
+  return 0;
+}
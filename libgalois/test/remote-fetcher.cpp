@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/RemoteFetcher.h"
+
+namespace {
+
+constexpr uint64_t kPartSize = UINT64_C(1) << 20;
+
+/// A remote file in memory that records how it is read
+class FakeRemote {
+public:
+  explicit FakeRemote(uint64_t size) : data_(size) {
+    for (uint64_t i = 0; i < size; ++i) {
+      data_[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+  }
+
+  tsuba::RemoteFetcher::GetRangeFunc Func() {
+    return [this](
+               const std::string&, uint64_t start, uint64_t size,
+               uint8_t* buf) -> katana::Result<void> {
+      uint64_t bytes = bytes_in_flight_ += size;
+      uint64_t max_bytes = max_bytes_in_flight_;
+      while (bytes > max_bytes &&
+             !max_bytes_in_flight_.compare_exchange_weak(max_bytes, bytes)) {
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return open_; });
+        sizes_.emplace_back(size);
+      }
+      bytes_in_flight_ -= size;
+      if (start <= fail_at_ && fail_at_ < start + size) {
+        return tsuba::ErrorCode::NotFound;
+      }
+      std::memcpy(buf, data_.data() + start, size);
+      return katana::ResultSuccess();
+    };
+  }
+
+  /// Make reads wait until Open
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = false;
+  }
+  void Open() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  void FailAt(uint64_t offset) { fail_at_ = offset; }
+
+  /// Wait until a read has started
+  void WaitBusy() const {
+    while (bytes_in_flight_ == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  const std::vector<uint8_t>& data() const { return data_; }
+  std::vector<uint64_t> sizes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sizes_;
+  }
+  uint64_t max_bytes_in_flight() const { return max_bytes_in_flight_; }
+
+private:
+  std::vector<uint8_t> data_;
+  std::atomic<uint64_t> bytes_in_flight_{0};
+  std::atomic<uint64_t> max_bytes_in_flight_{0};
+  std::atomic<uint64_t> fail_at_{UINT64_MAX};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool open_{true};
+  std::vector<uint64_t> sizes_;
+};
+
+void
+TestSplit() {
+  uint64_t size = 10 * kPartSize + 123;
+  FakeRemote remote(size);
+  tsuba::RemoteFetchOptions opts;
+  opts.part_size = kPartSize;
+  opts.concurrency = 4;
+  opts.max_bytes_in_flight = 2 * kPartSize;
+  tsuba::RemoteFetcher fetcher(remote.Func(), opts);
+
+  std::vector<uint8_t> buf(size);
+  auto res = fetcher.Fetch("file", 0, size, buf.data()).get();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(buf == remote.data());
+
+  std::vector<uint64_t> sizes = remote.sizes();
+  KATANA_LOG_ASSERT(sizes.size() == 11 && fetcher.num_requests() == 11);
+  KATANA_LOG_ASSERT(*std::max_element(sizes.begin(), sizes.end()) == kPartSize);
+  KATANA_LOG_VASSERT(
+      remote.max_bytes_in_flight() <= opts.max_bytes_in_flight,
+      "{} bytes in flight", remote.max_bytes_in_flight());
+}
+
+void
+TestCoalesce() {
+  constexpr uint64_t kPage = kPartSize / 16;
+  uint64_t size = 2 * kPartSize;
+  FakeRemote remote(size);
+  tsuba::RemoteFetchOptions opts;
+  opts.part_size = kPartSize;
+  opts.concurrency = 1;
+  tsuba::RemoteFetcher fetcher(remote.Func(), opts);
+
+  // Hold the only thread on the first page while the other pages are queued
+  std::vector<uint8_t> buf(size);
+  remote.Close();
+  std::vector<std::future<katana::Result<void>>> futures;
+  futures.emplace_back(fetcher.Fetch("file", 0, kPage, buf.data()));
+  remote.WaitBusy();
+  for (uint64_t offset = kPage; offset < size; offset += kPage) {
+    futures.emplace_back(
+        fetcher.Fetch("file", offset, kPage, buf.data() + offset));
+  }
+  remote.Open();
+  for (auto& future : futures) {
+    auto res = future.get();
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+  }
+  KATANA_LOG_ASSERT(buf == remote.data());
+
+  // The first page, then the other pages in parts of at most kPartSize
+  std::vector<uint64_t> sizes = remote.sizes();
+  KATANA_LOG_VASSERT(sizes.size() == 3, "{} requests", sizes.size());
+  KATANA_LOG_ASSERT(sizes[0] == kPage && sizes[1] == kPartSize);
+  KATANA_LOG_ASSERT(sizes[2] == kPartSize - kPage);
+
+  // Ranges next to each other in the file but not in memory are not merged
+  std::vector<uint8_t> other(kPage);
+  remote.Close();
+  auto first = fetcher.Fetch("file", 0, kPage, buf.data());
+  auto second = fetcher.Fetch("file", kPage, kPage, other.data());
+  remote.Open();
+  KATANA_LOG_ASSERT(first.get() && second.get());
+  KATANA_LOG_ASSERT(remote.sizes().size() == sizes.size() + 2);
+}
+
+void
+TestError() {
+  uint64_t size = 4 * kPartSize;
+  FakeRemote remote(size);
+  remote.FailAt(2 * kPartSize + 5);
+  tsuba::RemoteFetchOptions opts;
+  opts.part_size = kPartSize;
+  tsuba::RemoteFetcher fetcher(remote.Func(), opts);
+
+  std::vector<uint8_t> buf(size);
+  auto res = fetcher.Fetch("file", 0, size, buf.data()).get();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == tsuba::ErrorCode::NotFound);
+
+  auto empty_res = fetcher.Fetch("file", 0, 0, nullptr).get();
+  KATANA_LOG_ASSERT(empty_res);
+}
+
+}  // namespace
+
+int
+main() {
+  TestSplit();
+  TestCoalesce();
+  TestError();
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include <numeric>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/NodeReordering.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+
+  // Label each node and edge with its original id
+  std::vector<uint64_t> node_ids(g->num_nodes());
+  std::iota(node_ids.begin(), node_ids.end(), 0);
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+
+  auto node_table = arrow::Table::Make(
+      arrow::schema({arrow::field("node_id", arrow::uint64())}),
+      {katana::BuildArray(node_ids)});
+  auto edge_table = arrow::Table::Make(
+      arrow::schema({arrow::field("edge_id", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)});
+  KATANA_LOG_ASSERT(g->AddNodeProperties(node_table));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(edge_table));
+
+  return g;
+}
+
+const uint64_t*
+Values(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  KATANA_LOG_ASSERT(array && array->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::UInt64Array>(array->chunk(0))
+      ->raw_values();
+}
+
+/// Check that reordered is original with its nodes relabeled by new_to_old
+void
+CheckReordered(
+    const katana::PropertyGraph& original,
+    const katana::PropertyGraph& reordered, const uint64_t* new_to_old) {
+  const katana::GraphTopology& before = original.topology();
+  const katana::GraphTopology& after = reordered.topology();
+  KATANA_LOG_ASSERT(after.num_nodes() == before.num_nodes());
+  KATANA_LOG_ASSERT(after.num_edges() == before.num_edges());
+
+  const uint64_t* node_ids = Values(reordered.GetNodeProperty("node_id"));
+  const uint64_t* edge_ids = Values(reordered.GetEdgeProperty("edge_id"));
+  const uint64_t* user_ids = Values(reordered.local_to_user_id());
+
+  for (auto n : after) {
+    uint64_t old = new_to_old[n];
+    KATANA_LOG_VASSERT(node_ids[n] == old, "node {}", n);
+    KATANA_LOG_VASSERT(user_ids[n] == old, "node {}", n);
+
+    auto old_edges = before.edges(old);
+    auto new_edges = after.edges(n);
+    KATANA_LOG_ASSERT(new_edges.size() == old_edges.size());
+    auto old_e = old_edges.begin();
+    for (auto e : new_edges) {
+      KATANA_LOG_VASSERT(edge_ids[e] == *old_e, "edge {}", e);
+      KATANA_LOG_VASSERT(
+          new_to_old[after.edge_dest(e)] == before.edge_dest(*old_e),
+          "edge {}", e);
+      ++old_e;
+    }
+  }
+}
+
+void
+TestStrategy(katana::ReorderStrategy strategy) {
+  auto original = MakeGraph();
+  auto copy_res = original->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+
+  auto order_res = katana::ComputeNodeOrder(g->topology(), strategy);
+  KATANA_LOG_ASSERT(order_res);
+  std::shared_ptr<arrow::UInt64Array> order = order_res.value();
+  KATANA_LOG_ASSERT(static_cast<size_t>(order->length()) == kNumNodes);
+
+  std::vector<bool> seen(kNumNodes);
+  for (int64_t i = 0; i < order->length(); ++i) {
+    KATANA_LOG_ASSERT(order->Value(i) < kNumNodes);
+    KATANA_LOG_ASSERT(!seen[order->Value(i)]);
+    seen[order->Value(i)] = true;
+  }
+
+  KATANA_LOG_ASSERT(katana::ReorderNodes(g.get(), strategy));
+  CheckReordered(*original, *g, order->raw_values());
+}
+
+void
+TestDegreeOrder() {
+  auto g = MakeGraph();
+  KATANA_LOG_ASSERT(
+      katana::ReorderNodes(g.get(), katana::ReorderStrategy::kDegree));
+  for (size_t n = 1; n < g->num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(
+        g->topology().edges(n - 1).size() >= g->topology().edges(n).size());
+  }
+}
+
+void
+TestRoundTrip() {
+  auto original = MakeGraph();
+  auto copy_res = original->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> g = std::move(copy_res.value());
+  KATANA_LOG_ASSERT(katana::ReorderNodes(
+      g.get(), katana::ReorderStrategy::kReverseCuthillMcKee));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/reordernodes");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, "reorder-nodes"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_res) {
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+
+  std::unique_ptr<katana::PropertyGraph> loaded = std::move(make_res.value());
+  KATANA_LOG_ASSERT(loaded->topology().Equals(g->topology()));
+  CheckReordered(*original, *loaded, Values(g->local_to_user_id()));
+
+  // Reordering again composes with the stored permutation
+  KATANA_LOG_ASSERT(
+      katana::ReorderNodes(loaded.get(), katana::ReorderStrategy::kGorder));
+  CheckReordered(*original, *loaded, Values(loaded->local_to_user_id()));
+}
+
+/// The external permutation gives the same graph as the in-memory one, even
+/// with a budget small enough for many buckets and writes
+void
+TestExternal() {
+  auto original = MakeGraph();
+  auto order_res = katana::ComputeNodeOrder(
+      original->topology(), katana::ReorderStrategy::kBFS);
+  KATANA_LOG_ASSERT(order_res);
+  std::shared_ptr<arrow::UInt64Array> order = order_res.value();
+
+  auto copy_res = original->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> in_memory =
+      std::move(copy_res.value());
+  KATANA_LOG_ASSERT(katana::PermuteNodes(in_memory.get(), order));
+
+  for (uint64_t budget : {uint64_t{1} << 12, uint64_t{1} << 30}) {
+    auto external_res = original->Copy();
+    KATANA_LOG_ASSERT(external_res);
+    std::unique_ptr<katana::PropertyGraph> g = std::move(external_res.value());
+
+    katana::ExternalPermuteOptions options;
+    options.memory_budget = budget;
+    auto res = katana::PermuteNodesExternal(g.get(), order, options);
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+    CheckReordered(*original, *g, order->raw_values());
+    KATANA_LOG_ASSERT(g->topology().Equals(in_memory->topology()));
+  }
+}
+
+void
+TestNotPermutation() {
+  auto g = MakeGraph();
+  std::vector<uint64_t> bad(g->num_nodes(), 0);
+  auto res = katana::PermuteNodes(
+      g.get(),
+      std::static_pointer_cast<arrow::UInt64Array>(katana::BuildArray(bad)));
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(!katana::PermuteNodesExternal(
+      g.get(),
+      std::static_pointer_cast<arrow::UInt64Array>(katana::BuildArray(bad))));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto strategy :
+       {katana::ReorderStrategy::kDegree, katana::ReorderStrategy::kBFS,
+        katana::ReorderStrategy::kReverseCuthillMcKee,
+        katana::ReorderStrategy::kGorder,
+        katana::ReorderStrategy::kHubCluster}) {
+    TestStrategy(strategy);
+  }
+
+  TestDegreeOrder();
+  TestRoundTrip();
+  TestExternal();
+  TestNotPermutation();
+
+  return 0;
+}
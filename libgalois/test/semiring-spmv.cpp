@@ -0,0 +1,287 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/SpMV.h"
+
+namespace {
+
+using katana::analytics::MinPlus;
+using katana::analytics::OrAnd;
+using katana::analytics::PlusTimes;
+using katana::analytics::SemiringMatrix;
+using katana::analytics::SparseVector;
+using katana::analytics::SpMVKernel;
+using katana::analytics::SpMVMask;
+
+/// Bins of 2^4 nodes, so that the test graphs span many bins
+constexpr uint32_t kBinBits = 4;
+
+constexpr SpMVKernel kDenseKernels[] = {
+    SpMVKernel::kAuto, SpMVKernel::kPull, SpMVKernel::kPush,
+    SpMVKernel::kBlockedPush};
+
+/// Make a random graph whose edges may repeat
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes - 1);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// A weight that depends only on the endpoints, so push and pull agree
+struct EndpointWeight {
+  uint64_t operator()(uint32_t src, uint32_t dst, uint64_t) const {
+    return 1 + (src * 7 + dst) % 5;
+  }
+};
+
+/// The product computed one edge at a time
+template <typename Semiring, typename Weight>
+std::vector<typename Semiring::value_type>
+SerialMultiply(
+    const katana::GraphTopology& out,
+    const std::vector<typename Semiring::value_type>& x, const Weight& weight) {
+  std::vector<typename Semiring::value_type> y(
+      out.num_nodes(), Semiring::Zero());
+  for (auto src : out) {
+    for (auto e : out.edges(src)) {
+      uint32_t dst = out.edge_dest(e);
+      y[dst] = Semiring::Add(
+          y[dst], Semiring::Multiply(x[src], weight(src, dst, e)));
+    }
+  }
+  return y;
+}
+
+void
+TestPathCounts(const katana::PropertyGraph& g, const katana::PropertyGraph& t) {
+  using Semiring = PlusTimes<uint64_t>;
+  SemiringMatrix<Semiring, EndpointWeight> matrix(
+      g.topology(), &t.topology(), EndpointWeight{}, kBinBits);
+
+  std::vector<uint64_t> x(g.num_nodes());
+  for (size_t n = 0; n < x.size(); ++n) {
+    x[n] = n % 3;
+  }
+  std::vector<uint64_t> expected =
+      SerialMultiply<Semiring>(g.topology(), x, EndpointWeight{});
+
+  for (SpMVKernel kernel : kDenseKernels) {
+    std::vector<uint64_t> y(g.num_nodes(), 12345);
+    matrix.Multiply(x.data(), y.data(), {}, kernel);
+    KATANA_LOG_VASSERT(y == expected, "kernel {}", static_cast<int>(kernel));
+  }
+
+  // Masked out nodes keep their values
+  katana::DynamicBitset odd;
+  odd.resize(g.num_nodes());
+  for (size_t n = 1; n < g.num_nodes(); n += 2) {
+    odd.set(n);
+  }
+  for (bool complement : {false, true}) {
+    for (SpMVKernel kernel : kDenseKernels) {
+      std::vector<uint64_t> y(g.num_nodes(), 12345);
+      matrix.Multiply(x.data(), y.data(), SpMVMask{&odd, complement}, kernel);
+      for (size_t n = 0; n < g.num_nodes(); ++n) {
+        bool allowed = odd.test(n) != complement;
+        KATANA_LOG_ASSERT(y[n] == (allowed ? expected[n] : 12345));
+      }
+    }
+  }
+}
+
+/// The per-node weights of PageRank: each node spreads its rank evenly over
+/// its out edges
+struct InverseDegree {
+  const std::vector<double>* inverse_degree;
+
+  double operator()(uint32_t src, uint32_t, uint64_t) const {
+    return (*inverse_degree)[src];
+  }
+};
+
+void
+TestPageRank(katana::PropertyGraph* g, const katana::PropertyGraph& t) {
+  constexpr double kAlpha = 0.85;
+  constexpr int kIterations = 10;
+  uint64_t num_nodes = g->num_nodes();
+  std::vector<double> inverse_degree(num_nodes);
+  for (auto n : g->topology()) {
+    auto [begin, end] = g->topology().edge_range(n);
+    inverse_degree[n] = begin == end ? 0 : 1.0 / (end - begin);
+  }
+  InverseDegree weight{&inverse_degree};
+
+  std::vector<double> expected(num_nodes, 1.0 / num_nodes);
+  for (int i = 0; i < kIterations; ++i) {
+    expected =
+        SerialMultiply<PlusTimes<double>>(g->topology(), expected, weight);
+    for (double& r : expected) {
+      r = (1 - kAlpha) / num_nodes + kAlpha * r;
+    }
+  }
+
+  for (SpMVKernel kernel : kDenseKernels) {
+    SemiringMatrix<PlusTimes<double>, InverseDegree> matrix(
+        g->topology(), &t.topology(), weight, kBinBits);
+    auto view_result =
+        katana::analytics::AddNodeVectorProperty<double>(g, "rank");
+    KATANA_LOG_VASSERT(view_result, "{}", view_result.error());
+    double* rank = view_result.value().data();
+
+    std::vector<double> x(num_nodes, 1.0 / num_nodes);
+    for (int i = 0; i < kIterations; ++i) {
+      matrix.Multiply(x.data(), rank, {}, kernel);
+      for (uint64_t n = 0; n < num_nodes; ++n) {
+        x[n] = (1 - kAlpha) / num_nodes + kAlpha * rank[n];
+      }
+    }
+    std::copy(x.begin(), x.end(), rank);
+
+    auto property = g->GetNodePropertyTyped<double>("rank");
+    KATANA_LOG_VASSERT(property, "{}", property.error());
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(property.value()->Value(n) - expected[n]) < 1e-12,
+          "kernel {} node {}: {} expected {}", static_cast<int>(kernel), n,
+          property.value()->Value(n), expected[n]);
+    }
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("rank"));
+  }
+}
+
+/// BFS levels from node 0 computed one node at a time
+std::vector<uint32_t>
+SerialLevels(const katana::GraphTopology& topology) {
+  constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> levels(topology.num_nodes(), kInfinity);
+  std::vector<uint32_t> frontier{0};
+  levels[0] = 0;
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    std::vector<uint32_t> next;
+    for (uint32_t n : frontier) {
+      for (auto e : topology.edges(n)) {
+        uint32_t dst = topology.edge_dest(e);
+        if (levels[dst] == kInfinity) {
+          levels[dst] = level;
+          next.emplace_back(dst);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return levels;
+}
+
+void
+TestBfs(const katana::PropertyGraph& g, const katana::PropertyGraph& t) {
+  std::vector<uint32_t> expected = SerialLevels(g.topology());
+  uint64_t num_nodes = g.num_nodes();
+
+  // Sparse push over (min, +) with the visited nodes masked out
+  {
+    SemiringMatrix<MinPlus<uint32_t>> matrix(g.topology());
+    katana::DynamicBitset visited;
+    visited.resize(num_nodes);
+    visited.set(0);
+    std::vector<uint32_t> levels(
+        num_nodes, std::numeric_limits<uint32_t>::max());
+    levels[0] = 0;
+    SparseVector<uint32_t> frontier{{0}, {0}};
+    SparseVector<uint32_t> next;
+    while (frontier.size() > 0) {
+      matrix.Multiply(frontier, &next, SpMVMask{&visited, true});
+      for (size_t i = 0; i < next.size(); ++i) {
+        KATANA_LOG_ASSERT(i == 0 || next.indices[i - 1] < next.indices[i]);
+        levels[next.indices[i]] = next.values[i];
+        visited.set(next.indices[i]);
+      }
+      std::swap(frontier, next);
+    }
+    KATANA_LOG_ASSERT(levels == expected);
+  }
+
+  // Dense pull over (or, and), which stops at the first visited in-neighbor
+  for (SpMVKernel kernel : kDenseKernels) {
+    SemiringMatrix<OrAnd<>> matrix(g.topology(), &t.topology(), {}, kBinBits);
+    katana::DynamicBitset visited;
+    visited.resize(num_nodes);
+    visited.set(0);
+    std::vector<uint32_t> levels(
+        num_nodes, std::numeric_limits<uint32_t>::max());
+    levels[0] = 0;
+    std::vector<uint8_t> frontier(num_nodes, 0);
+    std::vector<uint8_t> next(num_nodes, 0);
+    frontier[0] = 1;
+    for (uint32_t level = 1;; ++level) {
+      matrix.Multiply(
+          frontier.data(), next.data(), SpMVMask{&visited, true}, kernel);
+      bool any = false;
+      for (uint64_t n = 0; n < num_nodes; ++n) {
+        if (!visited.test(n) && next[n]) {
+          levels[n] = level;
+          visited.set(n);
+          any = true;
+        } else {
+          next[n] = 0;
+        }
+      }
+      if (!any) {
+        break;
+      }
+      std::swap(frontier, next);
+    }
+    KATANA_LOG_VASSERT(
+        levels == expected, "kernel {}", static_cast<int>(kernel));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  for (uint32_t max_degree : {2, 8, 100}) {
+    auto g = MakeRandomGraph(500, max_degree, &gen);
+    auto t_result = katana::CreateTransposeGraph(g.get());
+    KATANA_LOG_VASSERT(t_result, "{}", t_result.error());
+    auto t = std::move(t_result.value());
+
+    TestPathCounts(*g, *t);
+    TestPageRank(g.get(), *t);
+    TestBfs(*g, *t);
+  }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "katana/SharedGraph.h"
+
+#include <unistd.h>
+
+#include <string>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+
+std::string
+SharedName(const std::string& what) {
+  return fmt::format("/katana-shared-graph-test-{}-{}", getpid(), what);
+}
+
+void
+TestRoundTrip() {
+  RandomPolicy policy{8};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 2, &policy);
+  std::string name = SharedName("round-trip");
+
+  auto publish_res = katana::PublishSharedGraph(*g, name);
+  KATANA_LOG_VASSERT(publish_res, "publishing: {}", publish_res.error());
+  // Names are not reused
+  auto again_res = katana::PublishSharedGraph(*g, name);
+  KATANA_LOG_ASSERT(
+      !again_res && again_res.error() == katana::ErrorCode::AlreadyExists);
+
+  auto attach_res = katana::AttachSharedGraph(name);
+  KATANA_LOG_VASSERT(attach_res, "attaching: {}", attach_res.error());
+  std::unique_ptr<katana::PropertyGraph> attached =
+      std::move(attach_res.value());
+  KATANA_LOG_ASSERT(attached->Equals(g.get()));
+
+  // Shared data is read-only
+  const auto& dests = attached->topology().out_dests;
+  KATANA_LOG_ASSERT(!katana::IsMutable(*dests->data()));
+  for (const auto& column : attached->node_properties()->columns()) {
+    for (const auto& chunk : column->chunks()) {
+      KATANA_LOG_ASSERT(!katana::IsMutable(*chunk->data()));
+    }
+  }
+
+  // Attached graphs outlive both the name and the publisher
+  auto unpublish_res = katana::UnpublishSharedGraph(name);
+  KATANA_LOG_VASSERT(unpublish_res, "unpublishing: {}", unpublish_res.error());
+  auto expected = g->Copy();
+  KATANA_LOG_ASSERT(expected);
+  g.reset();
+  KATANA_LOG_ASSERT(attached->Equals(expected.value().get()));
+
+  auto gone_res = katana::AttachSharedGraph(name);
+  KATANA_LOG_ASSERT(
+      !gone_res && gone_res.error() == katana::ErrorCode::NotFound);
+}
+
+/// Graphs without properties or edges
+void
+TestEmpty() {
+  LinePolicy policy{0};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::string name = SharedName("empty");
+  KATANA_LOG_ASSERT(katana::PublishSharedGraph(*g, name));
+  auto attach_res = katana::AttachSharedGraph(name);
+  KATANA_LOG_ASSERT(katana::UnpublishSharedGraph(name));
+  KATANA_LOG_VASSERT(attach_res, "attaching: {}", attach_res.error());
+  KATANA_LOG_ASSERT(attach_res.value()->num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(attach_res.value()->num_edges() == 0);
+  KATANA_LOG_ASSERT(attach_res.value()->topology().Equals(g->topology()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRoundTrip();
+  TestEmpty();
+
+  return 0;
+}
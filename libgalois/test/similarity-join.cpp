@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/similarity_join/similarity_join.h"
+
+namespace {
+
+using katana::analytics::SimilarityJoinPlan;
+using katana::analytics::SimilarNode;
+using SimilarNodeLists = std::vector<std::vector<SimilarNode>>;
+
+/// Make a random graph whose edges are not sorted and may repeat; a tenth of
+/// the nodes have no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  // Draw destinations from a small range so that nodes share neighbors
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes / 4);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    if (n % 10 != 0) {
+      uint32_t degree = degree_dist(*gen);
+      for (uint32_t i = 0; i < degree; ++i) {
+        dests.emplace_back(dest_dist(*gen));
+      }
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// Compare every pair of nodes
+SimilarNodeLists
+BruteForce(const katana::PropertyGraph& g, const SimilarityJoinPlan& plan) {
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<std::set<uint32_t>> sets(topology.num_nodes());
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      sets[n].emplace(topology.edge_dest(e));
+    }
+  }
+
+  SimilarNodeLists result(topology.num_nodes());
+  for (auto n : topology) {
+    for (auto other : topology) {
+      if (n == other) {
+        continue;
+      }
+      std::vector<uint32_t> common;
+      std::set_intersection(
+          sets[n].begin(), sets[n].end(), sets[other].begin(),
+          sets[other].end(), std::back_inserter(common));
+      if (common.empty()) {
+        continue;
+      }
+      double similarity =
+          static_cast<double>(common.size()) /
+          static_cast<double>(
+              sets[n].size() + sets[other].size() - common.size());
+      if (similarity >= plan.threshold()) {
+        result[n].emplace_back(SimilarNode{other, similarity});
+      }
+    }
+    std::sort(
+        result[n].begin(), result[n].end(),
+        [](const SimilarNode& a, const SimilarNode& b) {
+          return a.similarity > b.similarity ||
+                 (a.similarity == b.similarity && a.node < b.node);
+        });
+    if (plan.mode() == SimilarityJoinPlan::kTopK &&
+        result[n].size() > plan.k()) {
+      result[n].resize(plan.k());
+    }
+  }
+  return result;
+}
+
+void
+TestSimilarityJoin(katana::PropertyGraph* g) {
+  for (const auto& plan :
+       {SimilarityJoinPlan::Threshold(1), SimilarityJoinPlan::Threshold(0.5),
+        SimilarityJoinPlan::Threshold(0.1), SimilarityJoinPlan::TopK(1),
+        SimilarityJoinPlan::TopK(5), SimilarityJoinPlan::TopK(5, 0.2),
+        SimilarityJoinPlan::TopK(1000)}) {
+    auto result = katana::analytics::SimilarityJoin(g, plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    SimilarNodeLists expected = BruteForce(*g, plan);
+    KATANA_LOG_ASSERT(result.value().size() == expected.size());
+    for (size_t n = 0; n < expected.size(); ++n) {
+      KATANA_LOG_VASSERT(
+          result.value()[n] == expected[n],
+          "node {}, threshold {}, k {}: {} similar nodes, expected {}", n,
+          plan.threshold(), plan.k(), result.value()[n].size(),
+          expected[n].size());
+    }
+  }
+}
+
+void
+TestInvalidPlans(katana::PropertyGraph* g) {
+  for (const auto& plan :
+       {SimilarityJoinPlan::Threshold(0), SimilarityJoinPlan::Threshold(1.5),
+        SimilarityJoinPlan::TopK(0), SimilarityJoinPlan::TopK(1, -1)}) {
+    KATANA_LOG_ASSERT(!katana::analytics::SimilarityJoin(g, plan));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  auto sparse = MakeRandomGraph(1000, 8, &gen);
+  TestSimilarityJoin(sparse.get());
+  TestInvalidPlans(sparse.get());
+
+  auto dense = MakeRandomGraph(300, 40, &gen);
+  TestSimilarityJoin(dense.get());
+
+  return 0;
+}
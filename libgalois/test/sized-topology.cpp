@@ -0,0 +1,132 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/SizedGraphTopology.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 1000;
+
+/// A kernel compiled for each topology width: the sum over edges of their
+/// destinations
+template <typename Topology>
+uint64_t
+SumDests(const Topology& topology) {
+  uint64_t sum = 0;
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      sum += topology.edge_dest(e);
+    }
+  }
+  return sum;
+}
+
+template <typename Topology>
+void
+TestLayout(const katana::GraphTopology& topology) {
+  auto res = Topology::Make(topology);
+  KATANA_LOG_ASSERT(res);
+  const Topology& sized = res.value();
+
+  KATANA_LOG_ASSERT(sized.num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(sized.num_edges() == topology.num_edges());
+  for (uint64_t n = 0; n < topology.num_nodes(); ++n) {
+    auto edges = topology.edges(n);
+    auto sized_edges = sized.edges(n);
+    KATANA_LOG_ASSERT(*edges.begin() == *sized_edges.begin());
+    KATANA_LOG_ASSERT(*edges.end() == *sized_edges.end());
+    KATANA_LOG_ASSERT(sized.degree(n) == edges.size());
+    auto [begin, end] = sized.OutNeighbors(n);
+    for (auto e : edges) {
+      KATANA_LOG_ASSERT(sized.edge_dest(e) == topology.edge_dest(e));
+      KATANA_LOG_ASSERT(*begin++ == topology.edge_dest(e));
+    }
+    KATANA_LOG_ASSERT(begin == end);
+  }
+  KATANA_LOG_ASSERT(SumDests(sized) == SumDests(topology));
+
+  auto back = sized.ToGraphTopology();
+  KATANA_LOG_ASSERT(back);
+  KATANA_LOG_ASSERT(back.value().Equals(topology));
+
+  // The file contents pick the same layout
+  bool visited = false;
+  auto visit_res = katana::VisitSizedGraphTopology(
+      sized.buffer(), [&](const auto& visited_topology) {
+        using Visited = std::decay_t<decltype(visited_topology)>;
+        KATANA_LOG_ASSERT(Visited::kVersion == Topology::kVersion);
+        KATANA_LOG_ASSERT(SumDests(visited_topology) == SumDests(topology));
+        visited = true;
+      });
+  KATANA_LOG_ASSERT(visit_res);
+  KATANA_LOG_ASSERT(visited);
+}
+
+void
+TestSizes(const katana::GraphTopology& topology) {
+  auto compact = katana::CompactGraphTopology::Make(topology);
+  auto wide = katana::WideGraphTopology::Make(topology);
+  KATANA_LOG_ASSERT(compact && wide);
+  uint64_t default_size = topology.num_nodes() * sizeof(uint64_t) +
+                          topology.num_edges() * sizeof(uint32_t);
+  KATANA_LOG_VASSERT(
+      compact.value().size_bytes() < default_size, "compact {} default {}",
+      compact.value().size_bytes(), default_size);
+  KATANA_LOG_VASSERT(
+      wide.value().size_bytes() > default_size, "wide {} default {}",
+      wide.value().size_bytes(), default_size);
+
+  // A file of one layout is not taken for another
+  KATANA_LOG_ASSERT(!katana::CompactGraphTopology::Make(wide.value().buffer()));
+  KATANA_LOG_ASSERT(!katana::WideGraphTopology::Make(compact.value().buffer()));
+}
+
+void
+TestRoundTrip() {
+  RandomPolicy policy{8};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+  g->set_compact_topology(true);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/sizedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, "sized-topology"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_res) {
+    KATANA_LOG_FATAL("making result: {}", make_res.error());
+  }
+
+  KATANA_LOG_ASSERT(make_res.value()->topology().Equals(g->topology()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy random{8};
+  auto random_graph = MakeFileGraph<uint32_t>(kNumNodes, 1, &random);
+  const katana::GraphTopology& topology = random_graph->topology();
+
+  TestLayout<katana::CompactGraphTopology>(topology);
+  TestLayout<katana::WideGraphTopology>(topology);
+  TestLayout<katana::SizedGraphTopology<uint64_t, uint32_t>>(topology);
+  TestSizes(topology);
+
+  TestRoundTrip();
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include "katana/SmallHashMap.h"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Mem.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Map = katana::SmallHashMap<uint64_t, double>;
+using Reference = std::unordered_map<uint64_t, double>;
+
+template <typename M>
+void
+CheckEqual(const M& map, const Reference& expected) {
+  KATANA_LOG_VASSERT(
+      map.size() == expected.size(), "{} != {}", map.size(), expected.size());
+  size_t visited = 0;
+  for (const auto& [key, value] : map) {
+    auto it = expected.find(key);
+    KATANA_LOG_VASSERT(it != expected.end(), "unexpected key {}", key);
+    KATANA_LOG_ASSERT(it->second == value);
+    ++visited;
+  }
+  KATANA_LOG_ASSERT(visited == expected.size());
+  for (const auto& [key, value] : expected) {
+    auto it = map.find(key);
+    KATANA_LOG_VASSERT(it != map.end(), "missing key {}", key);
+    KATANA_LOG_ASSERT(it->second == value);
+    KATANA_LOG_ASSERT(map.contains(key));
+  }
+}
+
+/// Random accumulations and erasures over num_keys keys, so that the map
+/// stays inline for few keys, grows for many and fills with tombstones
+void
+TestRandomOps(uint64_t num_keys) {
+  std::mt19937_64 gen(num_keys);
+  Map map;
+  Reference expected;
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t key = gen() % num_keys;
+    if (gen() % 3 != 0) {
+      map[key] += 1;
+      expected[key] += 1;
+    } else {
+      KATANA_LOG_ASSERT(map.erase(key) == expected.erase(key));
+    }
+    if (i % 1000 == 0) {
+      CheckEqual(map, expected);
+    }
+  }
+  CheckEqual(map, expected);
+
+  Map copy = map;
+  CheckEqual(copy, expected);
+  Map moved = std::move(copy);
+  CheckEqual(moved, expected);
+  KATANA_LOG_ASSERT(copy.empty());
+  copy = moved;
+  CheckEqual(copy, expected);
+
+  map.clear();
+  KATANA_LOG_ASSERT(map.empty());
+  KATANA_LOG_ASSERT(map.begin() == map.end());
+  KATANA_LOG_ASSERT(!map.contains(0));
+}
+
+void
+TestInsert() {
+  Map map;
+  auto [it, inserted] = map.try_emplace(7, 1.5);
+  KATANA_LOG_ASSERT(inserted && it->first == 7 && it->second == 1.5);
+  std::tie(it, inserted) = map.insert(std::make_pair(7, 2.5));
+  KATANA_LOG_ASSERT(!inserted && it->second == 1.5);
+  KATANA_LOG_ASSERT(map.count(7) == 1 && map.count(8) == 0);
+
+  // A few elements stay in the inline slots
+  size_t inline_capacity = map.capacity();
+  for (uint64_t i = 0; i < 8; ++i) {
+    map[i * 1000] = i;
+  }
+  KATANA_LOG_ASSERT(map.capacity() == inline_capacity);
+
+  map.reserve(1000);
+  size_t reserved = map.capacity();
+  KATANA_LOG_ASSERT(reserved > inline_capacity);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    map[i] += 1;
+  }
+  KATANA_LOG_ASSERT(map.capacity() == reserved);
+}
+
+/// Maps allocated from per-thread arenas, as in clustering
+void
+TestArena() {
+  using ArenaMap = katana::SmallHashMap<
+      uint64_t, uint64_t, 16, std::hash<uint64_t>,
+      katana::ArenaAllocator<std::pair<uint64_t, uint64_t>>>;
+
+  katana::PerThreadArena arena;
+  katana::do_all(katana::iterate(uint64_t{0}, uint64_t{1000}), [&](uint64_t n) {
+    katana::ArenaScope scope{arena};
+    ArenaMap map(scope.allocator<ArenaMap::value_type>());
+    for (uint64_t i = 0; i < n; ++i) {
+      map[i % (n / 2 + 1)] += i;
+    }
+    uint64_t total = 0;
+    for (const auto& [key, value] : map) {
+      total += value;
+    }
+    KATANA_LOG_ASSERT(total == n * (n - 1) / 2);
+    KATANA_LOG_ASSERT(map.size() == std::min(n, n / 2 + 1));
+  });
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestInsert();
+  for (uint64_t num_keys : {4, 14, 15, 100, 10000}) {
+    TestRandomOps(num_keys);
+  }
+  TestArena();
+
+  return 0;
+}
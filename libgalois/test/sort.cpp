@@ -164,6 +164,126 @@ do_accumulate() {
   return 0;
 }
 
+//! Runs the parallel and the STL version of an algorithm on the same random
+//! input, after prepare, for each number of threads, and checks that they
+//! agree. parallel and serial take the input and return the result.
+template <typename Parallel, typename Serial, typename Prepare>
+int
+compare(const char* name, Parallel parallel, Serial serial, Prepare prepare) {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << name << ":\n";
+
+  while (M) {
+    katana::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    std::vector<unsigned> V(vectorSize);
+    std::generate(V.begin(), V.end(), RandomNumber);
+    prepare(V);
+    std::vector<unsigned> C = V;
+
+    katana::Timer t;
+    t.start();
+    auto r1 = parallel(V);
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    auto r2 = serial(C);
+    t2.stop();
+
+    bool eq = r1 == r2;
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq) {
+      return 1;
+    }
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+template <typename Parallel, typename Serial>
+int
+compare(const char* name, Parallel parallel, Serial serial) {
+  return compare(name, parallel, serial, [](std::vector<unsigned>&) {});
+}
+
+int
+do_radix_sort() {
+  return compare(
+      "radix_sort",
+      [](std::vector<unsigned>& V) {
+        katana::ParallelSTL::radix_sort(V.begin(), V.end());
+        return std::move(V);
+      },
+      [](std::vector<unsigned>& C) {
+        std::sort(C.begin(), C.end());
+        return std::move(C);
+      });
+}
+
+int
+do_exclusive_scan() {
+  return compare(
+      "exclusive_scan",
+      [](std::vector<unsigned>& V) {
+        std::vector<uint64_t> R(V.size());
+        katana::ParallelSTL::exclusive_scan(
+            V.begin(), V.end(), R.begin(), uint64_t{0});
+        return R;
+      },
+      [](std::vector<unsigned>& C) {
+        std::vector<uint64_t> R(C.size());
+        uint64_t sum = 0;
+        for (size_t i = 0; i < C.size(); ++i) {
+          R[i] = sum;
+          sum += C[i];
+        }
+        return R;
+      });
+}
+
+int
+do_stable_partition() {
+  return compare(
+      "stable_partition",
+      [](std::vector<unsigned>& V) {
+        auto mid = katana::ParallelSTL::stable_partition(
+            V.begin(), V.end(), IsOddS());
+        return std::make_pair(mid - V.begin(), std::move(V));
+      },
+      [](std::vector<unsigned>& C) {
+        auto mid = std::stable_partition(C.begin(), C.end(), IsOddS());
+        return std::make_pair(mid - C.begin(), std::move(C));
+      });
+}
+
+int
+do_merge() {
+  // Merge the sorted halves of the input
+  return compare(
+      "merge",
+      [](std::vector<unsigned>& V) {
+        auto mid = V.begin() + V.size() / 2;
+        std::vector<unsigned> R(V.size());
+        katana::ParallelSTL::merge(V.begin(), mid, mid, V.end(), R.begin());
+        return R;
+      },
+      [](std::vector<unsigned>& C) {
+        auto mid = C.begin() + C.size() / 2;
+        std::vector<unsigned> R(C.size());
+        std::merge(C.begin(), mid, mid, C.end(), R.begin());
+        return R;
+      },
+      [](std::vector<unsigned>& V) {
+        auto mid = V.begin() + V.size() / 2;
+        std::sort(V.begin(), mid);
+        std::sort(mid, V.end());
+      });
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys Katana_runtime;
@@ -176,5 +296,9 @@ main(int argc, char** argv) {
   //  ret |= do_sort();
   //  ret |= do_count_if();
   ret |= do_accumulate();
+  ret |= do_radix_sort();
+  ret |= do_exclusive_scan();
+  ret |= do_stable_partition();
+  ret |= do_merge();
   return ret;
 }
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/SparseBitset.h"
+
+namespace {
+
+constexpr uint32_t kMaxBit = 1 << 20;
+
+/// Random bits clustered in a few regions, as points-to sets tend to be
+std::set<uint32_t>
+RandomBits(std::mt19937* gen, size_t num_bits) {
+  std::uniform_int_distribution<uint32_t> region(0, 15);
+  std::uniform_int_distribution<uint32_t> offset(0, 999);
+  std::set<uint32_t> bits;
+  while (bits.size() < num_bits) {
+    bits.insert(region(*gen) * (kMaxBit / 16) + offset(*gen));
+  }
+  return bits;
+}
+
+katana::SparseBitset
+MakeBitset(const std::set<uint32_t>& bits) {
+  katana::SparseBitset bitset;
+  for (uint32_t i : bits) {
+    KATANA_LOG_ASSERT(bitset.set(i));
+    KATANA_LOG_ASSERT(!bitset.set(i));
+  }
+  return bitset;
+}
+
+void
+CheckEqual(const katana::SparseBitset& bitset, const std::set<uint32_t>& bits) {
+  std::vector<uint32_t> expected(bits.begin(), bits.end());
+  KATANA_LOG_ASSERT(bitset.ToVector() == expected);
+  KATANA_LOG_ASSERT(bitset.count() == bits.size());
+  KATANA_LOG_ASSERT(bitset.empty() == bits.empty());
+  for (uint32_t i : bits) {
+    KATANA_LOG_ASSERT(bitset.test(i));
+    KATANA_LOG_ASSERT(!bitset.test(i + 1) || bits.count(i + 1));
+  }
+}
+
+void
+TestSetOperations(std::mt19937* gen) {
+  for (size_t size : {0, 1, 100, 3000}) {
+    std::set<uint32_t> a = RandomBits(gen, size);
+    std::set<uint32_t> b = RandomBits(gen, 2 * size);
+    katana::SparseBitset bitset_a = MakeBitset(a);
+    katana::SparseBitset bitset_b = MakeBitset(b);
+    CheckEqual(bitset_a, a);
+
+    std::set<uint32_t> both = a;
+    both.insert(b.begin(), b.end());
+    katana::SparseBitset u = bitset_a;
+    KATANA_LOG_ASSERT(u.UnionWith(bitset_b) == (both != a));
+    CheckEqual(u, both);
+    // Union with a subset changes nothing
+    KATANA_LOG_ASSERT(!u.UnionWith(bitset_a));
+    KATANA_LOG_ASSERT(!u.UnionWith(u));
+    CheckEqual(u, both);
+
+    KATANA_LOG_ASSERT(bitset_a.IsSubsetOf(u));
+    KATANA_LOG_ASSERT(bitset_b.IsSubsetOf(u));
+    KATANA_LOG_ASSERT(u.IsSubsetOf(bitset_a) == (both == a));
+
+    std::set<uint32_t> only_a;
+    std::set_difference(
+        a.begin(), a.end(), b.begin(), b.end(),
+        std::inserter(only_a, only_a.end()));
+    katana::SparseBitset d = bitset_a;
+    KATANA_LOG_ASSERT(d.DifferenceWith(bitset_b) == (only_a != a));
+    CheckEqual(d, only_a);
+
+    // Equality and hashes do not depend on how a set was built
+    katana::SparseBitset v = bitset_b;
+    v.UnionWith(bitset_a);
+    KATANA_LOG_ASSERT(u == v);
+    KATANA_LOG_ASSERT(u.Hash() == v.Hash());
+    KATANA_LOG_ASSERT((u == bitset_a) == (both == a));
+  }
+}
+
+void
+TestPool(std::mt19937* gen) {
+  katana::SparseBitsetPool pool;
+  std::set<uint32_t> a = RandomBits(gen, 500);
+  std::set<uint32_t> b = RandomBits(gen, 500);
+
+  auto handle_a = pool.Intern(MakeBitset(a));
+  auto handle_b = pool.Intern(MakeBitset(b));
+  KATANA_LOG_ASSERT(pool.Intern(MakeBitset(a)) == handle_a);
+  KATANA_LOG_ASSERT(pool.size() == 3);
+
+  auto handle_u = pool.Union(handle_a, handle_b);
+  KATANA_LOG_ASSERT(pool.Union(handle_b, handle_a) == handle_u);
+  KATANA_LOG_ASSERT(pool.Union(handle_u, handle_a) == handle_u);
+  KATANA_LOG_ASSERT(pool.Union(pool.Empty(), handle_a) == handle_a);
+  std::set<uint32_t> both = a;
+  both.insert(b.begin(), b.end());
+  CheckEqual(*handle_u, both);
+
+  uint32_t missing = *both.rbegin() + 1;
+  auto handle_s = pool.Set(handle_u, missing);
+  KATANA_LOG_ASSERT(pool.Set(handle_s, missing) == handle_s);
+  both.insert(missing);
+  CheckEqual(*handle_s, both);
+
+  // Concurrent unions of the same sets agree on the result
+  constexpr size_t kNumSets = 64;
+  std::vector<katana::SparseBitsetPool::Handle> sets;
+  for (size_t i = 0; i < kNumSets; ++i) {
+    sets.emplace_back(pool.Intern(MakeBitset(RandomBits(gen, 50))));
+  }
+  katana::LargeArray<katana::SparseBitsetPool::Handle> unions;
+  unions.allocateBlocked(kNumSets * kNumSets);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumSets * kNumSets), [&](size_t i) {
+        unions[i] = pool.Union(sets[i / kNumSets], sets[i % kNumSets]);
+      });
+  for (size_t i = 0; i < kNumSets; ++i) {
+    for (size_t j = 0; j < kNumSets; ++j) {
+      auto u = unions[i * kNumSets + j];
+      KATANA_LOG_ASSERT(u == unions[j * kNumSets + i]);
+      katana::SparseBitset expected = *sets[i];
+      expected.UnionWith(*sets[j]);
+      KATANA_LOG_ASSERT(*u == expected);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  TestSetOperations(&gen);
+  TestPool(&gen);
+
+  return 0;
+}
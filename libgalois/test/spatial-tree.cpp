@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SpatialTree.h"
+
+namespace {
+
+struct Point {
+  uint32_t id;
+  double x;
+  double y;
+};
+
+using Tree = katana::SpatialTree2d<Point>;
+
+std::pair<double, double>
+Coords(const Point& p) {
+  return {p.x, p.y};
+}
+
+std::vector<Point>
+MakePoints(size_t size, std::mt19937* gen) {
+  // Clustered in one corner, so that the tree is not balanced by chance
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<Point> points;
+  for (uint32_t i = 0; i < size; ++i) {
+    double x = dist(*gen);
+    double y = dist(*gen);
+    points.emplace_back(Point{i, 100.0 * x * x * x, 100.0 * y * y * y});
+  }
+  // Some duplicates
+  for (uint32_t i = 0; i < size / 100; ++i) {
+    points.emplace_back(Point{uint32_t(points.size()), 1.0, 1.0});
+  }
+  return points;
+}
+
+std::vector<uint32_t>
+Ids(const std::vector<Point*>& found) {
+  std::vector<uint32_t> ids;
+  for (const Point* p : found) {
+    ids.emplace_back(p->id);
+  }
+  return ids;
+}
+
+double
+Dist2(const Point& p, double x, double y) {
+  return (p.x - x) * (p.x - x) + (p.y - y) * (p.y - y);
+}
+
+void
+TestQueries(Tree& tree, const std::vector<Point>& points, std::mt19937* gen) {
+  std::uniform_real_distribution<double> dist(-10.0, 110.0);
+
+  std::vector<Tree::Box2d> boxes;
+  std::vector<std::pair<double, double>> queries;
+  for (int i = 0; i < 200; ++i) {
+    double x0 = dist(*gen);
+    double y0 = dist(*gen);
+    boxes.emplace_back(Tree::Box2d{x0, y0, x0 + dist(*gen) / 4, y0 + 20.0});
+    queries.emplace_back(dist(*gen), dist(*gen));
+  }
+  // The whole tree
+  boxes.emplace_back(Tree::Box2d{-1.0, -1.0, 101.0, 101.0});
+
+  std::vector<std::vector<Point*>> in_range;
+  tree.findInRange(boxes, &in_range);
+  KATANA_LOG_ASSERT(in_range.size() == boxes.size());
+  KATANA_LOG_ASSERT(in_range.back().size() == points.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    std::vector<uint32_t> expected;
+    for (const Point& p : points) {
+      if (boxes[i].contains(p.x, p.y)) {
+        expected.emplace_back(p.id);
+      }
+    }
+    std::vector<uint32_t> found = Ids(in_range[i]);
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_ASSERT(found == expected);
+  }
+
+  constexpr size_t kK = 10;
+  std::vector<std::vector<Point*>> nearest;
+  tree.findNearest(queries, kK, &nearest);
+  KATANA_LOG_ASSERT(nearest.size() == queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    auto [x, y] = queries[i];
+    std::vector<double> expected;
+    for (const Point& p : points) {
+      expected.emplace_back(Dist2(p, x, y));
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(std::min(kK, expected.size()));
+
+    // Compare distances, since points at the same distance may be returned
+    // in any order
+    std::vector<double> found;
+    for (const Point* p : nearest[i]) {
+      found.emplace_back(Dist2(*p, x, y));
+    }
+    KATANA_LOG_ASSERT(found == expected);
+
+    // find is an approximation of the closest
+    KATANA_LOG_ASSERT(Dist2(*tree.find(x, y), x, y) >= expected[0]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(42);
+
+  std::vector<Point> points = MakePoints(20000, &gen);
+  {
+    Tree tree(0.0, 0.0, 100.0, 100.0);
+    tree.bulkInsert(points.begin(), points.end(), Coords);
+    TestQueries(tree, points, &gen);
+  }
+
+  // Bulk inserts into a tree with elements and against inserts
+  {
+    Tree tree(0.0, 0.0, 100.0, 100.0);
+    size_t half = points.size() / 2;
+    katana::do_all(
+        katana::iterate(points.begin(), points.begin() + half),
+        [&](const Point& p) { tree.insert(p.x, p.y, p); });
+    tree.bulkInsert(points.begin() + half, points.end(), Coords);
+    TestQueries(tree, points, &gen);
+  }
+
+  // Fewer elements than k and an empty tree
+  {
+    Tree tree(0.0, 0.0, 100.0, 100.0);
+    std::vector<Point> few(points.begin(), points.begin() + 3);
+    std::vector<Point*> found;
+    tree.bulkInsert(few.begin(), few.begin(), Coords);
+    tree.findNearest(50.0, 50.0, 5, &found);
+    KATANA_LOG_ASSERT(found.empty());
+
+    tree.bulkInsert(few.begin(), few.end(), Coords);
+    TestQueries(tree, few, &gen);
+  }
+
+  return 0;
+}
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/spectral_centrality/spectral_centrality.h"
+
+namespace {
+
+using katana::analytics::EigenvectorCentralityPlan;
+using katana::analytics::HitsPlan;
+using katana::analytics::KatzCentralityPlan;
+using katana::analytics::SpectralCentralityPlan;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const std::vector<uint64_t>& indices, std::vector<uint32_t> dests) {
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// Make a random graph whose edges may repeat
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes - 1);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+  return MakeGraph(indices, dests);
+}
+
+std::vector<double>
+GetValues(katana::PropertyGraph* g, const std::string& name, bool float32) {
+  std::vector<double> values(g->num_nodes());
+  if (float32) {
+    auto array = g->GetNodePropertyTyped<float>(name);
+    KATANA_LOG_VASSERT(array, "{}", array.error());
+    for (size_t n = 0; n < values.size(); ++n) {
+      values[n] = array.value()->Value(n);
+    }
+  } else {
+    auto array = g->GetNodePropertyTyped<double>(name);
+    KATANA_LOG_VASSERT(array, "{}", array.error());
+    for (size_t n = 0; n < values.size(); ++n) {
+      values[n] = array.value()->Value(n);
+    }
+  }
+  return values;
+}
+
+/// y = A^T x, or y = A x if transpose is set
+std::vector<double>
+Multiply(
+    const katana::GraphTopology& topology, const std::vector<double>& x,
+    bool transpose) {
+  std::vector<double> y(x.size(), 0);
+  for (auto src : topology) {
+    for (auto e : topology.edges(src)) {
+      uint32_t dst = topology.edge_dest(e);
+      if (transpose) {
+        y[src] += x[dst];
+      } else {
+        y[dst] += x[src];
+      }
+    }
+  }
+  return y;
+}
+
+void
+Normalize(std::vector<double>* x, double norm) {
+  if (norm > 0) {
+    for (double& v : *x) {
+      v /= norm;
+    }
+  }
+}
+
+double
+L2Norm(const std::vector<double>& x) {
+  double sum = 0;
+  for (double v : x) {
+    sum += v * v;
+  }
+  return std::sqrt(sum);
+}
+
+double
+Change(const std::vector<double>& a, const std::vector<double>& b) {
+  double sum = 0;
+  for (size_t n = 0; n < a.size(); ++n) {
+    sum += std::abs(a[n] - b[n]);
+  }
+  return sum;
+}
+
+std::vector<double>
+SerialEigenvector(
+    const katana::GraphTopology& topology,
+    const EigenvectorCentralityPlan& plan) {
+  uint64_t n = topology.num_nodes();
+  std::vector<double> x(n, 1.0 / n);
+  for (unsigned i = 0; i < plan.max_iterations(); ++i) {
+    std::vector<double> y = Multiply(topology, x, false);
+    for (size_t v = 0; v < n; ++v) {
+      y[v] += x[v];
+    }
+    Normalize(&y, L2Norm(y));
+    double change = Change(x, y);
+    x = y;
+    if (change < n * plan.tolerance()) {
+      break;
+    }
+  }
+  return x;
+}
+
+std::vector<double>
+SerialKatz(
+    const katana::GraphTopology& topology, const KatzCentralityPlan& plan) {
+  uint64_t n = topology.num_nodes();
+  std::vector<double> x(n, 0);
+  for (unsigned i = 0; i < plan.max_iterations(); ++i) {
+    std::vector<double> y = Multiply(topology, x, false);
+    for (double& v : y) {
+      v = plan.alpha() * v + plan.beta();
+    }
+    double change = Change(x, y);
+    x = y;
+    if (change < n * plan.tolerance()) {
+      break;
+    }
+  }
+  if (plan.normalized()) {
+    Normalize(&x, L2Norm(x));
+  }
+  return x;
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+SerialHits(const katana::GraphTopology& topology, const HitsPlan& plan) {
+  uint64_t n = topology.num_nodes();
+  std::vector<double> hub(n, 1.0 / n);
+  for (unsigned i = 0; i < plan.max_iterations(); ++i) {
+    std::vector<double> authority = Multiply(topology, hub, false);
+    std::vector<double> next = Multiply(topology, authority, true);
+    Normalize(&next, *std::max_element(next.begin(), next.end()));
+    double change = Change(hub, next);
+    hub = next;
+    if (change < n * plan.tolerance()) {
+      break;
+    }
+  }
+  std::vector<double> authority = Multiply(topology, hub, false);
+  Normalize(&hub, std::accumulate(hub.begin(), hub.end(), 0.0));
+  Normalize(
+      &authority, std::accumulate(authority.begin(), authority.end(), 0.0));
+  return {hub, authority};
+}
+
+void
+AssertNear(
+    const std::vector<double>& actual, const std::vector<double>& expected,
+    double bound, const char* what) {
+  KATANA_LOG_ASSERT(actual.size() == expected.size());
+  for (size_t n = 0; n < actual.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(actual[n] - expected[n]) <= bound,
+        "{} node {}: {} expected {}", what, n, actual[n], expected[n]);
+  }
+}
+
+void
+TestRandom(katana::PropertyGraph* g) {
+  const katana::GraphTopology& topology = g->topology();
+  for (auto precision :
+       {SpectralCentralityPlan::kFloat64, SpectralCentralityPlan::kFloat32}) {
+    bool float32 = precision == SpectralCentralityPlan::kFloat32;
+    double bound = float32 ? 1e-4 : 1e-9;
+
+    auto eigenvector_plan =
+        EigenvectorCentralityPlan::PowerIteration(1e-7, 100, precision);
+    auto eigenvector_result = katana::analytics::EigenvectorCentrality(
+        g, "eigenvector", eigenvector_plan);
+    KATANA_LOG_VASSERT(eigenvector_result, "{}", eigenvector_result.error());
+    AssertNear(
+        GetValues(g, "eigenvector", float32),
+        SerialEigenvector(topology, eigenvector_plan), bound, "eigenvector");
+
+    for (bool normalized : {true, false}) {
+      auto katz_plan = KatzCentralityPlan::PowerIteration(
+          0.05, 1, normalized, 1e-9, 100, precision);
+      auto katz_result =
+          katana::analytics::KatzCentrality(g, "katz", katz_plan);
+      KATANA_LOG_VASSERT(katz_result, "{}", katz_result.error());
+      AssertNear(
+          GetValues(g, "katz", float32), SerialKatz(topology, katz_plan),
+          normalized ? bound : bound * 10, "katz");
+      KATANA_LOG_ASSERT(g->RemoveNodeProperty("katz"));
+    }
+
+    auto hits_plan = HitsPlan::PowerIteration(1e-9, 100, precision);
+    auto hits_result =
+        katana::analytics::Hits(g, "hub", "authority", hits_plan);
+    KATANA_LOG_VASSERT(hits_result, "{}", hits_result.error());
+    auto [hub, authority] = SerialHits(topology, hits_plan);
+    AssertNear(GetValues(g, "hub", float32), hub, bound, "hub");
+    AssertNear(
+        GetValues(g, "authority", float32), authority, bound, "authority");
+
+    for (const char* name : {"eigenvector", "hub", "authority"}) {
+      KATANA_LOG_ASSERT(g->RemoveNodeProperty(name));
+    }
+  }
+}
+
+/// Check known values on small graphs
+void
+TestExact() {
+  // A symmetric star whose center 0 has 4 leaves: the principal eigenvalue
+  // is 2 and the center is twice as central as each leaf
+  auto star = MakeGraph({4, 5, 6, 7, 8}, {1, 2, 3, 4, 0, 0, 0, 0});
+  auto eigenvector_result = katana::analytics::EigenvectorCentrality(
+      star.get(), "eigenvector",
+      EigenvectorCentralityPlan::PowerIteration(1e-12));
+  KATANA_LOG_VASSERT(eigenvector_result, "{}", eigenvector_result.error());
+  std::vector<double> leaf(4, 1 / std::sqrt(8.0));
+  std::vector<double> expected{1 / std::sqrt(2.0)};
+  expected.insert(expected.end(), leaf.begin(), leaf.end());
+  AssertNear(
+      GetValues(star.get(), "eigenvector", false), expected, 1e-9, "star");
+
+  // On the path 0 -> 1 -> 2, node i is reached by walks of length 0 to i
+  auto path = MakeGraph({1, 2, 2}, {1, 2});
+  auto katz_result = katana::analytics::KatzCentrality(
+      path.get(), "katz",
+      KatzCentralityPlan::PowerIteration(0.5, 1, false, 0));
+  KATANA_LOG_VASSERT(katz_result, "{}", katz_result.error());
+  AssertNear(
+      GetValues(path.get(), "katz", false), {1, 1.5, 1.75}, 1e-12, "path");
+
+  // 0 and 1 both point to 2, and 1 also points to 3: 1 is the best hub and
+  // 2 the best authority
+  auto bipartite = MakeGraph({1, 3, 3, 3}, {2, 2, 3});
+  auto hits_result = katana::analytics::Hits(
+      bipartite.get(), "hub", "authority", HitsPlan::PowerIteration(1e-12));
+  KATANA_LOG_VASSERT(hits_result, "{}", hits_result.error());
+  // The hubs are the principal eigenvector of A A^T = [[1, 1], [1, 2]] and
+  // the authorities that of A^T A = [[2, 1], [1, 1]]
+  double golden = (1 + std::sqrt(5.0)) / 2;
+  AssertNear(
+      GetValues(bipartite.get(), "hub", false),
+      {1 / (1 + golden), golden / (1 + golden), 0, 0}, 1e-9, "hub");
+  AssertNear(
+      GetValues(bipartite.get(), "authority", false),
+      {0, 0, golden / (1 + golden), 1 / (1 + golden)}, 1e-9, "authority");
+}
+
+void
+TestInvalid(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(!katana::analytics::EigenvectorCentrality(
+      g, "negative-tolerance", EigenvectorCentralityPlan::PowerIteration(-1)));
+  KATANA_LOG_ASSERT(!katana::analytics::KatzCentrality(
+      g, "zero-alpha", KatzCentralityPlan::PowerIteration(0)));
+  KATANA_LOG_ASSERT(!katana::analytics::Hits(g, "same", "same"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  auto g = MakeRandomGraph(1000, 10, &gen);
+  TestRandom(g.get());
+  TestInvalid(g.get());
+  TestExact();
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <map>
+#include <string>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/StatCounter.h"
+
+namespace {
+
+using Totals = std::map<std::pair<std::string, std::string>, uint64_t>;
+
+/// Drain the counters and return the totals by region and category
+Totals
+Drain() {
+  Totals totals;
+  katana::internal::DrainStatCounters(
+      [&](const std::string& region, const std::string& category,
+          unsigned tid, uint64_t value) {
+        KATANA_LOG_ASSERT(tid < katana::getActiveThreads());
+        totals[{region, category}] += value;
+      });
+  return totals;
+}
+
+void
+TestCount() {
+  katana::StatCounter pushes("StatCounterTest", "Pushes");
+  katana::StatCounter edges("StatCounterTest", "Edges");
+  KATANA_LOG_ASSERT(pushes.id() != edges.id());
+
+  katana::do_all(
+      katana::iterate(0U, 10000U),
+      [&](unsigned i) {
+        pushes.Add();
+        edges.Add(i % 3);
+      },
+      katana::steal());
+  KATANA_LOG_ASSERT(pushes.Total() == 10000);
+  KATANA_LOG_ASSERT(edges.Total() == 9999);
+
+  // Counters with the same name share their slots
+  katana::StatCounter same("StatCounterTest", "Pushes");
+  KATANA_LOG_ASSERT(same.id() == pushes.id());
+  same.Add(5);
+  KATANA_LOG_ASSERT(pushes.Total() == 10005);
+
+  Totals totals = Drain();
+  KATANA_LOG_ASSERT(totals.size() == 2);
+  KATANA_LOG_ASSERT((totals[{"StatCounterTest", "Pushes"}] == 10005));
+  KATANA_LOG_ASSERT((totals[{"StatCounterTest", "Edges"}] == 9999));
+  KATANA_LOG_ASSERT(pushes.Total() == 0);
+  KATANA_LOG_ASSERT(Drain().empty());
+}
+
+void
+TestDisabled() {
+  katana::StatCounter counter("StatCounterTest", "Disabled");
+  katana::SetStatCountersEnabled(false);
+  KATANA_LOG_ASSERT(!katana::AreStatCountersEnabled());
+  katana::do_all(
+      katana::iterate(0U, 1000U), [&](unsigned) { counter.Add(); });
+  KATANA_LOG_ASSERT(counter.Total() == 0);
+
+  katana::SetStatCountersEnabled(true);
+  counter.Add(2);
+  KATANA_LOG_ASSERT(counter.Total() == 2);
+  Drain();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestCount();
+  TestDisabled();
+
+  // Counters that are not drained are reported with the other statistics
+  katana::StatCounter reported("StatCounterTest", "Reported");
+  reported.Add(3);
+
+  return 0;
+}
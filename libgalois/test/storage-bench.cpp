@@ -0,0 +1,397 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/RDG.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+// Throughput of storing and loading RDGs, broken down into the time spent
+// waiting for file data (fetch), decoding parquet (decode) and converting
+// and combining the decoded columns (copy).
+//
+// Graphs are stored under /tmp and under each of the comma separated
+// directories in KATANA_STORAGE_BENCH_URIS, e.g., s3://bucket/bench, so
+// every storage backend that tsuba supports can be measured.
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+std::vector<std::string> storage_prefixes;
+
+/// Delete the graph rdg_name, whichever storage it is on
+void
+RemoveRDG(const std::string& rdg_name) {
+  auto uri_res = katana::Uri::Make(rdg_name);
+  KATANA_LOG_ASSERT(uri_res);
+  if (uri_res.value().scheme() == katana::Uri::kFileScheme) {
+    fs::remove_all(uri_res.value().path());
+    return;
+  }
+  std::vector<std::string> files;
+  if (auto res = tsuba::FileListAsync(rdg_name, &files).get(); !res) {
+    KATANA_LOG_WARN("listing {}: {}", rdg_name, res.error());
+    return;
+  }
+  std::unordered_set<std::string> to_delete(files.begin(), files.end());
+  if (auto res = tsuba::FileDelete(rdg_name, to_delete); !res) {
+    KATANA_LOG_WARN("deleting {}: {}", rdg_name, res.error());
+  }
+}
+
+std::string
+TempRDGName(const std::string& prefix) {
+  auto uri_res = katana::Uri::MakeRand(prefix);
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().string();
+}
+
+/// Drop the files of a local graph from the page cache so that the next load
+/// reads them from the device. Graphs on other storage are left alone; their
+/// loads are only as cold as the backend and its local cache make them.
+void
+EvictRDG(const std::string& rdg_name) {
+  auto uri_res = katana::Uri::Make(rdg_name);
+  KATANA_LOG_ASSERT(uri_res);
+  if (uri_res.value().scheme() != katana::Uri::kFileScheme) {
+    return;
+  }
+  for (const auto& entry :
+       fs::recursive_directory_iterator(uri_res.value().path())) {
+    if (!fs::is_regular_file(entry.path())) {
+      continue;
+    }
+    int fd = open(entry.path().c_str(), O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    // Dirty pages are not dropped
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+/// A graph stored for the length of a benchmark
+template <typename ValueType>
+class StoredGraph {
+public:
+  StoredGraph(
+      size_t num_nodes, size_t num_properties, const std::string& prefix)
+      : rdg_name_(TempRDGName(prefix)) {
+    RandomPolicy policy{4};
+    std::unique_ptr<katana::PropertyGraph> g =
+        MakeFileGraph<ValueType>(num_nodes, num_properties, &policy);
+    if (num_properties > 0) {
+      node_property_ = g->node_schema()->field(0)->name();
+    }
+    if (auto res = g->Write(rdg_name_, "storage-bench"); !res) {
+      RemoveRDG(rdg_name_);
+      KATANA_LOG_FATAL("writing graph: {}", res.error());
+    }
+  }
+
+  ~StoredGraph() { RemoveRDG(rdg_name_); }
+
+  StoredGraph(const StoredGraph&) = delete;
+  StoredGraph& operator=(const StoredGraph&) = delete;
+
+  const std::string& rdg_name() const { return rdg_name_; }
+
+  /// The name of one node property, or empty if there are none
+  const std::string& node_property() const { return node_property_; }
+
+private:
+  std::string rdg_name_;
+  std::string node_property_;
+};
+
+/// Time during which at least one file was being read
+uint64_t
+FileBusyUs(std::vector<tsuba::FileLoadTime> timeline) {
+  std::sort(timeline.begin(), timeline.end(), [](const auto& a, const auto& b) {
+    return a.start_us < b.start_us;
+  });
+  uint64_t busy = 0;
+  uint64_t end = 0;
+  for (const tsuba::FileLoadTime& load : timeline) {
+    uint64_t start = std::max(load.start_us, end);
+    if (load.end_us > start) {
+      busy += load.end_us - start;
+      end = load.end_us;
+    }
+  }
+  return busy;
+}
+
+/// Accumulates the breakdown of the loads of a benchmark
+class LoadBreakdown {
+public:
+  LoadBreakdown() : begin_(tsuba::GetParquetReadStats()) {}
+
+  void AddTimeline(const std::vector<tsuba::FileLoadTime>& timeline) {
+    file_busy_us_ += FileBusyUs(timeline);
+  }
+
+  void Report(benchmark::State& state) const {
+    tsuba::ParquetReadStats end = tsuba::GetParquetReadStats();
+    auto per_iteration_ms = [&](uint64_t us) {
+      return benchmark::Counter(
+          us / 1000.0, benchmark::Counter::kAvgIterations);
+    };
+    state.counters["files"] = benchmark::Counter(
+        end.num_files - begin_.num_files, benchmark::Counter::kAvgIterations);
+    state.counters["file_busy_ms"] = per_iteration_ms(file_busy_us_);
+    state.counters["fetch_ms"] =
+        per_iteration_ms(end.fetch_us - begin_.fetch_us);
+    state.counters["decode_ms"] =
+        per_iteration_ms(end.decode_us - begin_.decode_us);
+    state.counters["copy_ms"] = per_iteration_ms(end.copy_us - begin_.copy_us);
+  }
+
+private:
+  tsuba::ParquetReadStats begin_;
+  uint64_t file_busy_us_{0};
+};
+
+void
+SetLabel(benchmark::State& state) {
+  auto uri_res = katana::Uri::Make(storage_prefixes[state.range(2)]);
+  KATANA_LOG_ASSERT(uri_res);
+  state.SetLabel(uri_res.value().scheme());
+}
+
+template <typename ValueType>
+void
+StoreRDG(benchmark::State& state) {
+  auto num_nodes = state.range(0);
+  auto num_properties = state.range(1);
+  const std::string& prefix = storage_prefixes[state.range(2)];
+  RandomPolicy policy{4};
+
+  tsuba::ParquetWriteStats begin = tsuba::GetParquetWriteStats();
+  for (auto _ : state) {
+    // A new graph each time; a graph that was written before only writes
+    // what changed since
+    state.PauseTiming();
+    std::unique_ptr<katana::PropertyGraph> g =
+        MakeFileGraph<ValueType>(num_nodes, num_properties, &policy);
+    std::string rdg_name = TempRDGName(prefix);
+    state.ResumeTiming();
+
+    auto res = g->Write(rdg_name, "storage-bench");
+
+    state.PauseTiming();
+    RemoveRDG(rdg_name);
+    if (!res) {
+      KATANA_LOG_FATAL("writing graph: {}", res.error());
+    }
+    state.ResumeTiming();
+  }
+
+  tsuba::ParquetWriteStats end = tsuba::GetParquetWriteStats();
+  state.SetBytesProcessed(end.encoded_bytes - begin.encoded_bytes);
+  state.counters["encode_ms"] = benchmark::Counter(
+      (end.encode_us - begin.encode_us) / 1000.0,
+      benchmark::Counter::kAvgIterations);
+  state.counters["compression_ratio"] =
+      static_cast<double>(end.arrow_bytes - begin.arrow_bytes) /
+      std::max<uint64_t>(end.encoded_bytes - begin.encoded_bytes, 1);
+  SetLabel(state);
+}
+
+/// Load the whole graph, or only its topology and one node property if
+/// property_only, evicting it from the page cache first if cold
+template <typename ValueType>
+void
+LoadRDG(benchmark::State& state, bool cold, bool property_only) {
+  StoredGraph<ValueType> stored(
+      state.range(0), state.range(1), storage_prefixes[state.range(2)]);
+
+  std::vector<std::string> node_properties{stored.node_property()};
+  std::vector<std::string> no_properties;
+  tsuba::RDGLoadOptions opts;
+  if (property_only) {
+    if (stored.node_property().empty()) {
+      state.SkipWithError("no properties to load");
+      return;
+    }
+    opts.node_properties = &node_properties;
+    opts.edge_properties = &no_properties;
+  }
+
+  LoadBreakdown breakdown;
+  for (auto _ : state) {
+    if (cold) {
+      state.PauseTiming();
+      EvictRDG(stored.rdg_name());
+      state.ResumeTiming();
+    }
+
+    auto handle_res = tsuba::Open(stored.rdg_name(), tsuba::kReadOnly);
+    if (!handle_res) {
+      KATANA_LOG_FATAL("opening graph: {}", handle_res.error());
+    }
+    auto rdg_res = tsuba::RDG::Make(handle_res.value(), opts);
+    if (!rdg_res) {
+      KATANA_LOG_FATAL("loading graph: {}", rdg_res.error());
+    }
+    benchmark::DoNotOptimize(rdg_res.value());
+
+    state.PauseTiming();
+    breakdown.AddTimeline(rdg_res.value().load_timeline());
+    if (auto res = tsuba::Close(handle_res.value()); !res) {
+      KATANA_LOG_FATAL("closing graph: {}", res.error());
+    }
+    state.ResumeTiming();
+  }
+  breakdown.Report(state);
+  SetLabel(state);
+}
+
+template <typename ValueType>
+void
+LoadRDGWarm(benchmark::State& state) {
+  LoadRDG<ValueType>(state, false, false);
+}
+
+template <typename ValueType>
+void
+LoadRDGCold(benchmark::State& state) {
+  LoadRDG<ValueType>(state, true, false);
+}
+
+template <typename ValueType>
+void
+LoadRDGProperty(benchmark::State& state) {
+  LoadRDG<ValueType>(state, false, true);
+}
+
+/// Load the middle half of the nodes with their edges and properties
+template <typename ValueType>
+void
+LoadRDGSlice(benchmark::State& state) {
+  StoredGraph<ValueType> stored(
+      state.range(0), state.range(1), storage_prefixes[state.range(2)]);
+
+  auto handle_res = tsuba::Open(stored.rdg_name(), tsuba::kReadOnly);
+  if (!handle_res) {
+    KATANA_LOG_FATAL("opening graph: {}", handle_res.error());
+  }
+  tsuba::RDGHandle handle = handle_res.value();
+  auto prefix_res = tsuba::RDGPrefix::Make(handle);
+  if (!prefix_res) {
+    KATANA_LOG_FATAL("loading graph prefix: {}", prefix_res.error());
+  }
+  const tsuba::RDGPrefix& prefix = prefix_res.value();
+  auto edge_begin = [&](uint64_t n) {
+    return n > 0 ? prefix.out_indexes()[n - 1] : 0;
+  };
+  uint64_t begin = prefix.num_nodes() / 4;
+  uint64_t end = prefix.num_nodes() - begin;
+  tsuba::RDGSlice::SliceArg arg{
+      .node_range = {begin, end},
+      .edge_range = {edge_begin(begin), edge_begin(end)},
+      .topo_off = prefix.view_offset() + edge_begin(begin) * sizeof(uint32_t),
+      .topo_size = (edge_begin(end) - edge_begin(begin)) * sizeof(uint32_t),
+  };
+
+  LoadBreakdown breakdown;
+  for (auto _ : state) {
+    auto slice_res = tsuba::RDGSlice::Make(handle, arg);
+    if (!slice_res) {
+      KATANA_LOG_FATAL("loading slice: {}", slice_res.error());
+    }
+    benchmark::DoNotOptimize(slice_res.value());
+
+    state.PauseTiming();
+    breakdown.AddTimeline(slice_res.value().load_timeline());
+    state.ResumeTiming();
+  }
+  breakdown.Report(state);
+  SetLabel(state);
+
+  if (auto res = tsuba::Close(handle); !res) {
+    KATANA_LOG_FATAL("closing graph: {}", res.error());
+  }
+}
+
+/// Two sizes and two property mixes on every storage backend
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_nodes : {1L << 16, 1L << 20}) {
+    for (long num_properties : {1L, 8L}) {
+      for (long s = 0; s < static_cast<long>(storage_prefixes.size()); ++s) {
+        b->Args({num_nodes, num_properties, s});
+      }
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <typename ValueType>
+void
+RegisterBenchmarks(const std::string& type_name) {
+  auto name = [&](const char* op) {
+    return std::string(op) + "<" + type_name + ">";
+  };
+  benchmark::RegisterBenchmark(name("StoreRDG").c_str(), StoreRDG<ValueType>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark(
+      name("LoadRDGWarm").c_str(), LoadRDGWarm<ValueType>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark(
+      name("LoadRDGCold").c_str(), LoadRDGCold<ValueType>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark(
+      name("LoadRDGSlice").c_str(), LoadRDGSlice<ValueType>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark(
+      name("LoadRDGProperty").c_str(), LoadRDGProperty<ValueType>)
+      ->Apply(MakeArguments);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+
+  storage_prefixes.emplace_back("/tmp/storagebench");
+  std::string uris;
+  if (katana::GetEnv("KATANA_STORAGE_BENCH_URIS", &uris)) {
+    std::vector<std::string> split;
+    boost::split(split, uris, boost::is_any_of(","));
+    for (const std::string& uri : split) {
+      if (!uri.empty()) {
+        storage_prefixes.emplace_back(uri);
+      }
+    }
+  }
+
+  // Narrow and wide integer columns, and floating point columns
+  RegisterBenchmarks<int32_t>("int32_t");
+  RegisterBenchmarks<int64_t>("int64_t");
+  RegisterBenchmarks<double>("double");
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/FaultTest.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+struct Profile {
+  const char* name;
+  tsuba::internal::IoFaultProfile profile;
+};
+
+const Profile kProfiles[] = {
+    {"none", {}},
+    // Round trips to object storage
+    {"latency", {.latency_us = 5000}},
+    {"bandwidth", {.bandwidth = UINT64_C(100) << 20}},
+    // Mostly fast, but one operation in a hundred stalls
+    {"spikes",
+     {.latency_us = 1000, .spike_prob = 0.01f, .spike_us = 200000}},
+};
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_nodes : {1L << 14, 1L << 20}) {
+    for (long p = 0; p < static_cast<long>(std::size(kProfiles)); ++p) {
+      b->Args({num_nodes, p});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+std::string
+TempRDGName() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/storagefaultbench");
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().path();  // path() because local
+}
+
+/// Report the delay the profile added per iteration
+void
+ReportDelay(benchmark::State& state, const Profile& profile) {
+  tsuba::internal::IoFaultStats stats = tsuba::internal::IoFaultTestStats();
+  state.SetLabel(profile.name);
+  state.counters["io_ops"] = benchmark::Counter(
+      stats.num_ops, benchmark::Counter::kAvgIterations);
+  state.counters["io_delay_ms"] = benchmark::Counter(
+      stats.delay_us / 1000.0, benchmark::Counter::kAvgIterations);
+  tsuba::internal::IoFaultTestInit();
+}
+
+void
+StoreGraph(benchmark::State& state) {
+  auto [num_nodes, p] = std::make_tuple(state.range(0), state.range(1));
+  const Profile& profile = kProfiles[p];
+  RandomPolicy policy{4};
+
+  tsuba::internal::IoFaultTestInit(profile.profile);
+  for (auto _ : state) {
+    // A new graph each time; a graph that was written before only writes
+    // what changed since
+    state.PauseTiming();
+    std::unique_ptr<katana::PropertyGraph> g =
+        MakeFileGraph<int64_t>(num_nodes, 2, &policy);
+    std::string rdg_name = TempRDGName();
+    state.ResumeTiming();
+
+    auto res = g->Write(rdg_name, "storage-fault-bench");
+
+    state.PauseTiming();
+    fs::remove_all(rdg_name);
+    if (!res) {
+      KATANA_LOG_FATAL("writing graph: {}", res.error());
+    }
+    state.ResumeTiming();
+  }
+  ReportDelay(state, profile);
+}
+
+void
+MakeGraph(benchmark::State& state) {
+  auto [num_nodes, p] = std::make_tuple(state.range(0), state.range(1));
+  const Profile& profile = kProfiles[p];
+  RandomPolicy policy{4};
+
+  std::string rdg_name = TempRDGName();
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 2, &policy);
+  if (auto res = g->Write(rdg_name, "storage-fault-bench"); !res) {
+    fs::remove_all(rdg_name);
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+
+  tsuba::internal::IoFaultTestInit(profile.profile);
+  for (auto _ : state) {
+    auto make_res = katana::PropertyGraph::Make(rdg_name);
+    if (!make_res) {
+      fs::remove_all(rdg_name);
+      KATANA_LOG_FATAL("making graph: {}", make_res.error());
+    }
+    benchmark::DoNotOptimize(make_res.value());
+  }
+  ReportDelay(state, profile);
+  fs::remove_all(rdg_name);
+}
+
+BENCHMARK(StoreGraph)->Apply(MakeArguments);
+BENCHMARK(MakeGraph)->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+namespace {
+
+using katana::analytics::StronglyConnectedComponentsPlan;
+
+// Large enough that the parallel phases run before the serial fallback
+constexpr uint32_t kNumNodes = 1 << 18;
+
+/// Make a directed graph with one large component over the first half of the
+/// nodes and small cycles and single nodes over the rest, joined by edges
+/// that only lead to higher groups so that no components merge
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::mt19937 gen(0);
+  std::vector<std::vector<uint32_t>> neighbors(kNumNodes);
+  constexpr uint32_t kLarge = kNumNodes / 2;
+
+  std::uniform_int_distribution<uint32_t> large_node(0, kLarge - 1);
+  for (uint32_t n = 0; n < kLarge; ++n) {
+    neighbors[n].emplace_back((n + 1) % kLarge);
+    neighbors[n].emplace_back(large_node(gen));
+  }
+
+  // Groups of 1 to 8 consecutive nodes; groups of more than one node are
+  // cycles and some single nodes have self loops
+  std::vector<uint32_t> group_end(kNumNodes);
+  for (uint32_t begin = kLarge, size = 1; begin < kNumNodes;
+       begin += size, size = size % 8 + 1) {
+    uint32_t end = std::min(begin + size, kNumNodes);
+    for (uint32_t n = begin; n < end; ++n) {
+      group_end[n] = end;
+      if (end - begin > 1 || n % 3 == 0) {
+        neighbors[n].emplace_back(n + 1 < end ? n + 1 : begin);
+      }
+    }
+  }
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    uint32_t src = i < kLarge ? large_node(gen) : i;
+    uint32_t begin = src < kLarge ? kLarge : group_end[src];
+    if (begin >= kNumNodes) {
+      continue;
+    }
+    std::uniform_int_distribution<uint32_t> later(begin, kNumNodes - 1);
+    neighbors[src].emplace_back(later(gen));
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (auto& n : neighbors) {
+    std::sort(n.begin(), n.end());
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+/// The components of the graph by Kosaraju's algorithm, labeled in the
+/// order they are found
+std::vector<uint32_t>
+ReferenceComponents(const katana::GraphTopology& topology) {
+  uint32_t num_nodes = topology.num_nodes();
+  std::vector<std::vector<uint32_t>> in(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      in[topology.edge_dest(e)].emplace_back(n);
+    }
+  }
+
+  // Order nodes by finishing time of a depth first search
+  std::vector<uint32_t> order;
+  std::vector<bool> visited(num_nodes);
+  std::vector<std::pair<uint32_t, uint64_t>> stack;
+  for (uint32_t root = 0; root < num_nodes; ++root) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = true;
+    stack.emplace_back(root, *topology.edges(root).begin());
+    while (!stack.empty()) {
+      auto& [n, next] = stack.back();
+      if (next == *topology.edges(n).end()) {
+        order.emplace_back(n);
+        stack.pop_back();
+        continue;
+      }
+      uint32_t dest = topology.edge_dest(next++);
+      if (!visited[dest]) {
+        visited[dest] = true;
+        stack.emplace_back(dest, *topology.edges(dest).begin());
+      }
+    }
+  }
+
+  constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> component(num_nodes, kNone);
+  uint32_t num_components = 0;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    if (component[*it] != kNone) {
+      continue;
+    }
+    std::vector<uint32_t> dfs{*it};
+    component[*it] = num_components;
+    while (!dfs.empty()) {
+      uint32_t n = dfs.back();
+      dfs.pop_back();
+      for (uint32_t src : in[n]) {
+        if (component[src] == kNone) {
+          component[src] = num_components;
+          dfs.emplace_back(src);
+        }
+      }
+    }
+    num_components += 1;
+  }
+  return component;
+}
+
+void
+TestStronglyConnectedComponents() {
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+  std::vector<uint32_t> expected = ReferenceComponents(g->topology());
+
+  for (const auto& plan :
+       {StronglyConnectedComponentsPlan::Multistep(),
+        StronglyConnectedComponentsPlan::Multistep(0),
+        StronglyConnectedComponentsPlan::Coloring()}) {
+    auto result =
+        katana::analytics::StronglyConnectedComponents(g.get(), "scc", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    auto valid_result =
+        katana::analytics::StronglyConnectedComponentsAssertValid(
+            g.get(), "scc");
+    KATANA_LOG_VASSERT(valid_result, "{}", valid_result.error());
+
+    // The labels must partition the nodes exactly as the reference does
+    auto column = g->GetNodeProperty("scc");
+    KATANA_LOG_ASSERT(column->num_chunks() == 1);
+    const auto& labels =
+        static_cast<const arrow::UInt64Array&>(*column->chunk(0));
+    std::unordered_map<uint64_t, uint32_t> to_expected;
+    std::unordered_map<uint32_t, uint64_t> to_label;
+    for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+      auto [label_it, label_inserted] =
+          to_expected.emplace(labels.Value(n), expected[n]);
+      auto [expected_it, expected_inserted] =
+          to_label.emplace(expected[n], labels.Value(n));
+      KATANA_LOG_VASSERT(
+          label_it->second == expected[n] &&
+              expected_it->second == labels.Value(n),
+          "node {} has label {}", n, labels.Value(n));
+    }
+
+    auto stats_result =
+        katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+            g.get(), "scc");
+    KATANA_LOG_VASSERT(stats_result, "{}", stats_result.error());
+    KATANA_LOG_ASSERT(stats_result.value().total_components == to_label.size());
+    KATANA_LOG_ASSERT(
+        stats_result.value().largest_component_size == kNumNodes / 2);
+
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("scc"));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestStronglyConnectedComponents();
+
+  return 0;
+}
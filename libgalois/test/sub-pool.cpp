@@ -0,0 +1,121 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/SubPool.h"
+
+namespace {
+
+constexpr uint64_t kNumSmall = 1000;
+constexpr uint64_t kNumLarge = 1 << 20;
+
+struct Indexer {
+  uint64_t operator()(uint64_t n) const { return n / 64; }
+};
+
+using OBIM = katana::OrderedByIntegerMetric<
+    Indexer, katana::PerSocketChunkFIFO<8>>::with_barrier<true>::type;
+
+/// The small query: loops on the sub-pool that check they only see its
+/// threads
+void
+SmallQuery(unsigned num_threads) {
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == num_threads);
+  KATANA_LOG_ASSERT(
+      katana::GetThreadPool().getMaxUsableThreads() == num_threads);
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::GReduceLogicalOr outside;
+  katana::do_all(katana::iterate(uint64_t{0}, kNumSmall), [&](uint64_t n) {
+    sum += n;
+    outside.update(katana::ThreadPool::getTID() >= num_threads);
+  });
+  KATANA_LOG_ASSERT(sum.reduce() == kNumSmall * (kNumSmall - 1) / 2);
+  KATANA_LOG_ASSERT(!outside.reduce());
+
+  // Each n pushes n - 1, so the loop visits n + 1 items for each initial n
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate(uint64_t{0}, kNumSmall),
+      [&](uint64_t n, auto& ctx) {
+        visited += 1;
+        outside.update(katana::ThreadPool::getTID() >= num_threads);
+        if (n > 0) {
+          ctx.push(n - 1);
+        }
+      },
+      katana::wl<OBIM>(), katana::disable_conflict_detection());
+  KATANA_LOG_ASSERT(visited.reduce() == kNumSmall * (kNumSmall + 1) / 2);
+  KATANA_LOG_ASSERT(!outside.reduce());
+}
+
+/// Run the small query on a sub-pool while the main pool runs a loop that
+/// cannot finish until the small query has
+void
+TestConcurrent(katana::SubPool* pool) {
+  std::atomic<bool> small_done{false};
+  std::thread client([&]() {
+    pool->Run([&]() { SmallQuery(pool->num_threads()); });
+    small_done = true;
+  });
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(katana::iterate(uint64_t{0}, kNumLarge), [&](uint64_t n) {
+    if (n == 0) {
+      auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::minutes(1);
+      while (!small_done && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+    }
+    sum += n;
+  });
+  client.join();
+
+  KATANA_LOG_VASSERT(small_done, "sub-pool did not run beside the main pool");
+  KATANA_LOG_ASSERT(sum.reduce() == kNumLarge * (kNumLarge - 1) / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  auto& tp = katana::GetThreadPool();
+  unsigned usable = tp.getMaxUsableThreads();
+  katana::setActiveThreads(usable);
+
+  KATANA_LOG_ASSERT(!katana::SubPool::Make(0));
+  KATANA_LOG_ASSERT(!katana::SubPool::Make(usable));
+  if (usable < 2) {
+    return 0;
+  }
+
+  {
+    unsigned num_threads = usable / 2;
+    auto pool = katana::SubPool::Make(num_threads);
+    KATANA_LOG_VASSERT(pool, "{}", pool.error());
+    KATANA_LOG_ASSERT(tp.getMaxUsableThreads() == usable - num_threads);
+    katana::setActiveThreads(usable);
+    KATANA_LOG_ASSERT(katana::getActiveThreads() == usable - num_threads);
+
+    TestConcurrent(pool.value().get());
+    // Jobs may run one after another on the same sub-pool
+    TestConcurrent(pool.value().get());
+
+    bool threw = false;
+    try {
+      pool.value()->Run([]() { throw std::runtime_error("job failed"); });
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    KATANA_LOG_ASSERT(threw);
+  }
+  KATANA_LOG_ASSERT(tp.getMaxUsableThreads() == usable);
+
+  return 0;
+}
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/subgraph_matching/subgraph_matching.h"
+
+namespace {
+
+using katana::analytics::Pattern;
+using katana::analytics::PatternMatchPlan;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 24;
+constexpr uint32_t kNumTypes = 2;
+constexpr int64_t kNumLabels = 2;
+
+using AdjacencySets = std::vector<std::set<Node>>;
+
+uint32_t
+EdgeType(Node a, Node b) {
+  return (std::min(a, b) * 7 + std::max(a, b)) % kNumTypes;
+}
+
+int64_t
+NodeLabel(Node n) {
+  return n % kNumLabels;
+}
+
+/// A random symmetric graph with a hub node connected to every other node
+AdjacencySets
+RandomGraph() {
+  std::mt19937 gen(0);
+  std::bernoulli_distribution coin(0.25);
+  AdjacencySets adj(kNumNodes);
+  for (Node a = 0; a < kNumNodes; ++a) {
+    for (Node b = a + 1; b < kNumNodes; ++b) {
+      if (a == 0 || coin(gen)) {
+        adj[a].emplace(b);
+        adj[b].emplace(a);
+      }
+    }
+  }
+  return adj;
+}
+
+/// A graph with the edges of adj sorted by destination, with an edge type
+/// property "type" and a node label property "label"
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const AdjacencySets& adj) {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> types;
+  for (Node a = 0; a < adj.size(); ++a) {
+    for (Node b : adj[a]) {
+      dests.emplace_back(b);
+      types.emplace_back(EdgeType(a, b));
+    }
+    indices.emplace_back(dests.size());
+  }
+  std::vector<int64_t> labels(adj.size());
+  for (Node n = 0; n < adj.size(); ++n) {
+    labels[n] = NodeLabel(n);
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("type", arrow::uint32())}),
+      {katana::BuildArray(types)})));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("label", arrow::int64())}),
+      {katana::BuildArray(labels)})));
+  return g;
+}
+
+/// Whether the one-to-one map from the nodes of pattern to nodes (of
+/// either the graph or the pattern) preserves its edges, types and labels
+bool
+Preserves(
+    const Pattern& pattern, const std::vector<Node>& map,
+    const std::function<bool(Node, Node, const Pattern::Edge&)>& has_edge,
+    const std::function<std::optional<int64_t>(Node)>& label) {
+  for (uint32_t a = 0; a < pattern.num_nodes; ++a) {
+    if (!pattern.node_labels.empty() && pattern.node_labels[a] &&
+        label(map[a]) != pattern.node_labels[a]) {
+      return false;
+    }
+  }
+  for (const Pattern::Edge& edge : pattern.edges) {
+    if (!has_edge(map[edge.a], map[edge.b], edge)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Count the matches of pattern by trying every map, divided by the
+/// number of automorphisms of the pattern
+uint64_t
+BruteForceCount(const AdjacencySets& adj, const Pattern& pattern) {
+  auto graph_edge = [&](Node a, Node b, const Pattern::Edge& edge) {
+    return adj[a].count(b) > 0 && (!edge.type || EdgeType(a, b) == *edge.type);
+  };
+  auto pattern_edge = [&](Node a, Node b, const Pattern::Edge& edge) {
+    for (const Pattern::Edge& other : pattern.edges) {
+      if (((other.a == a && other.b == b) || (other.a == b && other.b == a)) &&
+          other.type == edge.type) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto pattern_label = [&](Node a) -> std::optional<int64_t> {
+    return pattern.node_labels.empty() ? std::nullopt : pattern.node_labels[a];
+  };
+
+  std::vector<Node> perm(pattern.num_nodes);
+  std::iota(perm.begin(), perm.end(), 0);
+  uint64_t automorphisms = 0;
+  do {
+    automorphisms += Preserves(pattern, perm, pattern_edge, pattern_label);
+  } while (std::next_permutation(perm.begin(), perm.end()));
+
+  uint64_t embeddings = 0;
+  std::vector<Node> map(pattern.num_nodes);
+  std::function<void(uint32_t)> search = [&](uint32_t a) {
+    if (a == pattern.num_nodes) {
+      embeddings += Preserves(pattern, map, graph_edge, NodeLabel);
+      return;
+    }
+    for (Node n = 0; n < kNumNodes; ++n) {
+      if (std::find(map.begin(), map.begin() + a, n) == map.begin() + a) {
+        map[a] = n;
+        search(a + 1);
+      }
+    }
+  };
+  search(0);
+  return embeddings / automorphisms;
+}
+
+void
+TestPattern(
+    katana::PropertyGraph* g, const AdjacencySets& adj, const Pattern& pattern,
+    const char* name) {
+  uint64_t expected = BruteForceCount(adj, pattern);
+
+  for (uint32_t split_degree : {1U, PatternMatchPlan::kDefaultSplitDegree}) {
+    PatternMatchPlan plan = PatternMatchPlan::GenericJoin(split_degree);
+    auto count_res = katana::analytics::CountPatternMatches(g, pattern, plan);
+    KATANA_LOG_VASSERT(count_res, "{}: {}", name, count_res.error());
+    KATANA_LOG_VASSERT(
+        count_res.value() == expected, "{}: {} matches, expected {}", name,
+        count_res.value(), expected);
+  }
+
+  std::atomic<uint64_t> found{0};
+  std::mutex lock;
+  std::set<std::vector<Node>> distinct;
+  auto find_res = katana::analytics::FindPatternMatches(
+      g, pattern, [&](const uint32_t* match) {
+        std::vector<Node> map(match, match + pattern.num_nodes);
+        auto has_edge = [&](Node a, Node b, const Pattern::Edge& edge) {
+          return adj[a].count(b) > 0 &&
+                 (!edge.type || EdgeType(a, b) == *edge.type);
+        };
+        KATANA_LOG_ASSERT(Preserves(pattern, map, has_edge, NodeLabel));
+        std::sort(map.begin(), map.end());
+        KATANA_LOG_ASSERT(
+            std::adjacent_find(map.begin(), map.end()) == map.end());
+        std::lock_guard<std::mutex> guard(lock);
+        distinct.emplace(match, match + pattern.num_nodes);
+        ++found;
+      });
+  KATANA_LOG_VASSERT(find_res, "{}: {}", name, find_res.error());
+  KATANA_LOG_VASSERT(found == expected, "{}: found {}", name, found.load());
+  KATANA_LOG_VASSERT(distinct.size() == expected, "{}", name);
+}
+
+Pattern
+WithTypes(Pattern pattern) {
+  for (Pattern::Edge& edge : pattern.edges) {
+    edge.type = (edge.a + edge.b) % kNumTypes;
+  }
+  return pattern;
+}
+
+Pattern
+WithLabels(Pattern pattern) {
+  pattern.node_label_property = "label";
+  pattern.node_labels.resize(pattern.num_nodes);
+  pattern.node_labels[0] = 1;
+  return pattern;
+}
+
+void
+TestInvalidPatterns(katana::PropertyGraph* g) {
+  Pattern disconnected;
+  disconnected.num_nodes = 3;
+  disconnected.edges = {{0, 1, std::nullopt}};
+  KATANA_LOG_ASSERT(!katana::analytics::CountPatternMatches(g, disconnected));
+
+  Pattern self_loop;
+  self_loop.num_nodes = 2;
+  self_loop.edges = {{0, 1, std::nullopt}, {1, 1, std::nullopt}};
+  KATANA_LOG_ASSERT(!katana::analytics::CountPatternMatches(g, self_loop));
+
+  KATANA_LOG_ASSERT(!katana::analytics::CountPatternMatches(
+      g, Pattern::Path(Pattern::kMaxNodes + 1)));
+
+  // Typed patterns need the graph to be indexed by type
+  KATANA_LOG_ASSERT(!katana::analytics::CountPatternMatches(
+      g, WithTypes(Pattern::Path(3))));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  AdjacencySets adj = RandomGraph();
+  auto g = MakeGraph(adj);
+
+  TestInvalidPatterns(g.get());
+
+  TestPattern(g.get(), adj, Pattern::Path(1), "node");
+  TestPattern(g.get(), adj, Pattern::Path(2), "edge");
+  TestPattern(g.get(), adj, Pattern::Path(4), "path");
+  TestPattern(g.get(), adj, Pattern::Star(3), "star");
+  TestPattern(g.get(), adj, Pattern::Cycle(3), "triangle");
+  TestPattern(g.get(), adj, Pattern::Cycle(4), "cycle");
+  TestPattern(g.get(), adj, Pattern::Clique(4), "clique");
+  TestPattern(g.get(), adj, WithLabels(Pattern::Star(2)), "labeled star");
+  TestPattern(g.get(), adj, WithLabels(Pattern::Cycle(4)), "labeled cycle");
+
+  auto sort_res = katana::SortAllEdgesByType(g.get(), "type");
+  KATANA_LOG_ASSERT(sort_res);
+  KATANA_LOG_ASSERT(!katana::analytics::CountPatternMatches(
+      g.get(), Pattern::Path(3)));
+  TestPattern(g.get(), adj, WithTypes(Pattern::Path(3)), "typed path");
+  TestPattern(g.get(), adj, WithTypes(Pattern::Cycle(3)), "typed triangle");
+  TestPattern(
+      g.get(), adj, WithLabels(WithTypes(Pattern::Clique(4))),
+      "typed labeled clique");
+
+  return 0;
+}
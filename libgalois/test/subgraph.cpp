@@ -0,0 +1,136 @@
+#include <numeric>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Subgraph.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr size_t kNumNodes = 1000;
+
+/// A graph whose nodes and edges are labeled with their ids
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::vector<uint32_t> node_ids(g->num_nodes());
+  std::iota(node_ids.begin(), node_ids.end(), 0);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("node_id", arrow::uint32())}),
+      {katana::BuildArray(node_ids)})));
+
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("edge_id", arrow::uint64()),
+           arrow::field("weight", arrow::uint64())}),
+      {katana::BuildArray(edge_ids), katana::BuildArray(edge_ids)})));
+
+  return g;
+}
+
+void
+TestExtract(const katana::PropertyGraph& g) {
+  // Every node but multiples of 3, made with bitwise_not so that the bits
+  // past the end of the mask are set
+  katana::DynamicBitset node_mask;
+  node_mask.resize(g.num_nodes());
+  for (Node n = 0; n < g.num_nodes(); n += 3) {
+    node_mask.set(n);
+  }
+  node_mask.bitwise_not();
+
+  katana::DynamicBitset edge_mask;
+  edge_mask.resize(g.num_edges());
+  for (uint64_t e = 0; e < g.num_edges(); e += 2) {
+    edge_mask.set(e);
+  }
+
+  std::vector<std::string> edge_props{"edge_id"};
+  katana::SubgraphProperties props;
+  props.edge_properties = &edge_props;
+  auto res = katana::ExtractSubgraph(g, node_mask, &edge_mask, props);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  katana::Subgraph& sub = res.value();
+  katana::PropertyGraph& s = *sub.graph;
+
+  // Serial reference
+  std::vector<Node> new_id(g.num_nodes(), ~Node{0});
+  std::vector<Node> kept;
+  for (Node n = 0; n < g.num_nodes(); ++n) {
+    if (n % 3 != 0) {
+      new_id[n] = kept.size();
+      kept.emplace_back(n);
+    }
+  }
+  KATANA_LOG_ASSERT(s.num_nodes() == kept.size());
+  KATANA_LOG_ASSERT(sub.original_nodes->length() == int64_t(kept.size()));
+
+  auto node_ids = s.GetNodePropertyTyped<uint32_t>("node_id");
+  KATANA_LOG_ASSERT(node_ids);
+  auto edge_ids = s.GetEdgePropertyTyped<uint64_t>("edge_id");
+  KATANA_LOG_ASSERT(edge_ids);
+  KATANA_LOG_ASSERT(!s.GetEdgeProperty("weight"));
+
+  uint64_t out = 0;
+  for (Node i = 0; i < kept.size(); ++i) {
+    KATANA_LOG_ASSERT(sub.original_nodes->Value(i) == kept[i]);
+    KATANA_LOG_ASSERT(node_ids.value()->Value(i) == kept[i]);
+    auto edges = s.edges(i);
+    auto e = edges.begin();
+    for (auto orig : g.edges(kept[i])) {
+      Node dest = g.topology().edge_dest(orig);
+      if (orig % 2 != 0 || dest % 3 == 0) {
+        continue;
+      }
+      KATANA_LOG_ASSERT(e != edges.end());
+      KATANA_LOG_ASSERT(s.topology().edge_dest(*e) == new_id[dest]);
+      KATANA_LOG_ASSERT(sub.original_edges->Value(*e) == orig);
+      KATANA_LOG_ASSERT(edge_ids.value()->Value(*e) == orig);
+      ++e;
+      ++out;
+    }
+    KATANA_LOG_ASSERT(e == edges.end());
+  }
+  KATANA_LOG_ASSERT(s.num_edges() == out);
+}
+
+void
+TestErrors(const katana::PropertyGraph& g) {
+  katana::DynamicBitset node_mask;
+  node_mask.resize(g.num_nodes() + 1);
+  KATANA_LOG_ASSERT(!katana::ExtractSubgraph(g, node_mask));
+
+  node_mask.resize(g.num_nodes());
+  std::vector<std::string> missing{"missing"};
+  katana::SubgraphProperties props;
+  props.node_properties = &missing;
+  KATANA_LOG_ASSERT(!katana::ExtractSubgraph(g, node_mask, nullptr, props));
+
+  // An empty mask extracts an empty graph
+  auto res = katana::ExtractSubgraph(g, node_mask);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(res.value().graph->num_nodes() == 0);
+  KATANA_LOG_ASSERT(res.value().graph->num_edges() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto g = MakeGraph();
+  TestExtract(*g);
+  TestErrors(*g);
+
+  return 0;
+}
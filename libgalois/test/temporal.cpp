@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/temporal/temporal.h"
+
+namespace {
+
+using katana::analytics::EarliestArrivalPlan;
+using katana::analytics::PagerankPlan;
+
+constexpr int64_t kNumTimes = 100;
+
+/// Make a random graph whose edges have random times in [0, kNumTimes)
+std::unique_ptr<katana::PropertyGraph>
+MakeTemporalGraph(uint32_t num_nodes, uint32_t max_degree, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> degree_dist(0, max_degree);
+  std::uniform_int_distribution<uint32_t> dest_dist(0, num_nodes - 1);
+  std::uniform_int_distribution<int64_t> time_dist(0, kNumTimes - 1);
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<int64_t> times;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t degree = degree_dist(*gen);
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(dest_dist(*gen));
+      times.emplace_back(time_dist(*gen));
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  auto add_result = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("time", arrow::int64())}),
+      {katana::BuildArray(times)}));
+  KATANA_LOG_ASSERT(add_result);
+  return g;
+}
+
+std::vector<int64_t>
+GetTimes(const katana::PropertyGraph& g) {
+  auto array = g.GetEdgePropertyTyped<int64_t>("time");
+  KATANA_LOG_VASSERT(array, "{}", array.error());
+  std::vector<int64_t> times(g.num_edges());
+  for (size_t e = 0; e < times.size(); ++e) {
+    times[e] = array.value()->Value(e);
+  }
+  return times;
+}
+
+/// Relax every edge in the window until no arrival improves
+std::vector<int64_t>
+SerialEarliestArrival(
+    const katana::PropertyGraph& g, uint32_t source, int64_t begin_time,
+    int64_t end_time) {
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<int64_t> times = GetTimes(g);
+  std::vector<int64_t> arrival(
+      g.num_nodes(), EarliestArrivalPlan::kUnreachable);
+  arrival[source] = begin_time;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto n : topology) {
+      for (auto e : topology.edges(n)) {
+        int64_t t = times[e];
+        uint32_t dest = topology.edge_dest(e);
+        if (t >= begin_time && t < end_time && arrival[n] <= t &&
+            t < arrival[dest]) {
+          arrival[dest] = t;
+          changed = true;
+        }
+      }
+    }
+  }
+  return arrival;
+}
+
+/// Power iteration of the unnormalized Page Rank over the window edges
+std::vector<double>
+SerialPagerank(
+    const katana::PropertyGraph& g, int64_t begin_time, int64_t end_time,
+    double alpha) {
+  const katana::GraphTopology& topology = g.topology();
+  std::vector<int64_t> times = GetTimes(g);
+  auto in_window = [&](uint64_t e) {
+    return times[e] >= begin_time && times[e] < end_time;
+  };
+  std::vector<uint64_t> degree(g.num_nodes(), 0);
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      degree[n] += in_window(e);
+    }
+  }
+  std::vector<double> rank(g.num_nodes(), 1 - alpha);
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<double> next(g.num_nodes(), 1 - alpha);
+    for (auto n : topology) {
+      for (auto e : topology.edges(n)) {
+        if (in_window(e)) {
+          next[topology.edge_dest(e)] += alpha * rank[n] / degree[n];
+        }
+      }
+    }
+    double change = 0;
+    for (size_t n = 0; n < rank.size(); ++n) {
+      change = std::max(change, std::abs(next[n] - rank[n]));
+    }
+    rank = next;
+    if (change < 1e-10) {
+      break;
+    }
+  }
+  return rank;
+}
+
+/// Return the values of node property name and remove it
+template <typename T>
+std::vector<T>
+GetValues(katana::PropertyGraph* g, const std::string& name) {
+  auto array = g->GetNodePropertyTyped<T>(name);
+  KATANA_LOG_VASSERT(array, "{}", array.error());
+  std::vector<T> values(g->num_nodes());
+  for (size_t n = 0; n < values.size(); ++n) {
+    values[n] = array.value()->Value(n);
+  }
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty(name));
+  return values;
+}
+
+void
+TestEarliestArrival(katana::PropertyGraph* g) {
+  for (uint32_t source : {0U, 17U, 123U}) {
+    for (auto [begin_time, end_time] :
+         std::vector<std::pair<int64_t, int64_t>>{
+             {0, kNumTimes}, {20, 60}, {-50, 10}, {50, 50}}) {
+      auto result = katana::analytics::EarliestArrival(
+          g, source, "time", begin_time, end_time, "arrival");
+      KATANA_LOG_VASSERT(result, "{}", result.error());
+      std::vector<int64_t> actual = GetValues<int64_t>(g, "arrival");
+      std::vector<int64_t> expected =
+          SerialEarliestArrival(*g, source, begin_time, end_time);
+      for (size_t n = 0; n < expected.size(); ++n) {
+        KATANA_LOG_VASSERT(
+            actual[n] == expected[n],
+            "source {} window [{}, {}) node {}: {} expected {}", source,
+            begin_time, end_time, n, actual[n], expected[n]);
+      }
+    }
+  }
+}
+
+void
+TestTemporalPagerank(katana::PropertyGraph* g) {
+  auto plan = PagerankPlan::PushSynchronous(1e-6);
+  for (auto [begin_time, end_time] : std::vector<std::pair<int64_t, int64_t>>{
+           {0, kNumTimes}, {30, 70}, {90, 1000}}) {
+    auto result = katana::analytics::TemporalPagerank(
+        g, "time", begin_time, end_time, "rank", plan);
+    KATANA_LOG_VASSERT(result, "{}", result.error());
+    std::vector<float> actual = GetValues<float>(g, "rank");
+    std::vector<double> expected =
+        SerialPagerank(*g, begin_time, end_time, plan.alpha());
+    for (size_t n = 0; n < expected.size(); ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(actual[n] - expected[n]) < 1e-4,
+          "window [{}, {}) node {}: {} expected {}", begin_time, end_time, n,
+          actual[n], expected[n]);
+    }
+  }
+
+  // Over all of time, the ranks are those of the whole graph
+  auto temporal_result = katana::analytics::TemporalPagerank(
+      g, "time", 0, kNumTimes, "temporal", plan);
+  KATANA_LOG_VASSERT(temporal_result, "{}", temporal_result.error());
+  auto result = katana::analytics::Pagerank(g, "static", plan);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  std::vector<float> temporal = GetValues<float>(g, "temporal");
+  std::vector<float> ranks = GetValues<float>(g, "static");
+  for (size_t n = 0; n < ranks.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(temporal[n] - ranks[n]) < 1e-4, "node {}: {} expected {}",
+        n, temporal[n], ranks[n]);
+  }
+}
+
+void
+TestInvalid(katana::PropertyGraph* g) {
+  KATANA_LOG_ASSERT(!katana::analytics::EarliestArrival(
+      g, g->num_nodes(), "time", 0, kNumTimes, "bad-source"));
+  KATANA_LOG_ASSERT(
+      !katana::analytics::EarliestArrival(g, 0, "time", 10, 5, "bad-window"));
+  KATANA_LOG_ASSERT(!katana::analytics::TemporalPagerank(
+      g, "no such property", 0, kNumTimes, "bad-property"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+  std::mt19937 gen(0);
+
+  auto g = MakeTemporalGraph(1000, 8, &gen);
+
+  // Edges must be sorted by time before they can be indexed
+  KATANA_LOG_ASSERT(!katana::analytics::EarliestArrival(
+      g.get(), 0, "time", 0, kNumTimes, "unsorted"));
+  auto sort_result = katana::SortAllEdgesByTime(g.get(), "time");
+  KATANA_LOG_VASSERT(sort_result, "{}", sort_result.error());
+
+  TestEarliestArrival(g.get());
+  TestTemporalPagerank(g.get());
+  TestInvalid(g.get());
+
+  return 0;
+}
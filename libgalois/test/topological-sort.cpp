@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/topological_sort/topological_sort.h"
+
+namespace {
+
+using katana::analytics::DagCriticalPath;
+using katana::analytics::DagLongestPath;
+using katana::analytics::TopologicalSort;
+using katana::analytics::TopologicalSortAssertValid;
+
+constexpr size_t kNumNodes = 2000;
+
+/// Edges only go to smaller node ids, so every node id order reversed is a
+/// topological order but the order by level is not
+class DagPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id == 0) {
+      return r;
+    }
+    std::mt19937 gen(node_id);
+    std::uniform_int_distribution<size_t> dist(0, node_id - 1);
+    size_t degree = (node_id * 7) % std::min<size_t>(num_nodes, 6);
+    for (size_t i = 0; i < degree; ++i) {
+      r.emplace_back(dist(gen));
+    }
+    return r;
+  }
+};
+
+/// Give g integer weights in [-3, 9] and the same weights halved as doubles,
+/// and return the integer weights by edge
+std::vector<int64_t>
+AddWeights(katana::PropertyGraph* g) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(-3, 9);
+  std::vector<int64_t> int_weights(g->num_edges());
+  std::vector<double> real_weights(g->num_edges());
+  for (size_t e = 0; e < g->num_edges(); ++e) {
+    int_weights[e] = dist(gen);
+    real_weights[e] = int_weights[e] * 0.5;
+  }
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("int_weight", arrow::int64()),
+           arrow::field("real_weight", arrow::float64())}),
+      {katana::BuildArray(int_weights), katana::BuildArray(real_weights)})));
+  return int_weights;
+}
+
+/// The longest paths ending at and starting from each node, computed in
+/// decreasing and increasing id order respectively
+struct Reference {
+  std::vector<int64_t> ending_at;
+  std::vector<int64_t> starting_at;
+  int64_t longest{0};
+};
+
+Reference
+ReferenceLongestPaths(
+    const katana::GraphTopology& topology,
+    const std::vector<int64_t>& weights) {
+  size_t num_nodes = topology.num_nodes();
+  Reference ref;
+  ref.ending_at.assign(num_nodes, 0);
+  ref.starting_at.assign(num_nodes, 0);
+  for (size_t n = num_nodes; n-- > 0;) {
+    for (auto e : topology.edges(n)) {
+      uint32_t dest = topology.edge_dest(e);
+      ref.ending_at[dest] =
+          std::max(ref.ending_at[dest], ref.ending_at[n] + weights[e]);
+    }
+  }
+  for (size_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      int64_t through = weights[e] + ref.starting_at[topology.edge_dest(e)];
+      ref.starting_at[n] = std::max(ref.starting_at[n], through);
+    }
+    ref.longest = std::max(ref.longest, ref.starting_at[n]);
+  }
+  return ref;
+}
+
+template <typename T>
+std::shared_ptr<arrow::NumericArray<typename arrow::CTypeTraits<T>::ArrowType>>
+GetProperty(katana::PropertyGraph* g, const std::string& name) {
+  auto result = g->GetNodePropertyTyped<T>(name);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  return result.value();
+}
+
+void
+TestTopologicalSort(katana::PropertyGraph* g) {
+  auto result = TopologicalSort(g, "order");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto valid = TopologicalSortAssertValid(g, "order");
+  KATANA_LOG_VASSERT(valid, "{}", valid.error());
+
+  // Nodes are ordered by level, then by id
+  std::vector<int64_t> ones(g->num_edges(), 1);
+  Reference levels = ReferenceLongestPaths(g->topology(), ones);
+  auto order = GetProperty<uint64_t>(g, "order");
+  std::vector<uint32_t> by_position(g->num_nodes());
+  for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+    by_position[order->Value(n)] = n;
+  }
+  for (size_t i = 1; i < by_position.size(); ++i) {
+    uint32_t a = by_position[i - 1];
+    uint32_t b = by_position[i];
+    KATANA_LOG_VASSERT(
+        levels.ending_at[a] < levels.ending_at[b] ||
+            (levels.ending_at[a] == levels.ending_at[b] && a < b),
+        "nodes {} and {} are out of order", a, b);
+  }
+
+  // Unit weights give the levels
+  auto unit_result = DagLongestPath(g, "", "level");
+  KATANA_LOG_VASSERT(unit_result, "{}", unit_result.error());
+  auto level = GetProperty<uint32_t>(g, "level");
+  for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(level->Value(n) == levels.ending_at[n]);
+  }
+}
+
+void
+TestLongestPath(katana::PropertyGraph* g, const std::vector<int64_t>& weights) {
+  Reference ref = ReferenceLongestPaths(g->topology(), weights);
+
+  auto result = DagLongestPath(g, "int_weight", "int_length", "int_slack");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  auto length = GetProperty<int64_t>(g, "int_length");
+  auto slack = GetProperty<int64_t>(g, "int_slack");
+  for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        length->Value(n) == ref.ending_at[n], "node {}: got {} expected {}", n,
+        length->Value(n), ref.ending_at[n]);
+    KATANA_LOG_ASSERT(
+        slack->Value(n) ==
+        ref.longest - ref.ending_at[n] - ref.starting_at[n]);
+  }
+
+  auto real_result = DagLongestPath(g, "real_weight", "real_length");
+  KATANA_LOG_VASSERT(real_result, "{}", real_result.error());
+  auto real_length = GetProperty<double>(g, "real_length");
+  for (uint32_t n = 0; n < g->num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(
+        std::abs(real_length->Value(n) - ref.ending_at[n] * 0.5) < 1e-9);
+  }
+}
+
+void
+TestCriticalPath(
+    katana::PropertyGraph* g, const std::vector<int64_t>& weights) {
+  Reference ref = ReferenceLongestPaths(g->topology(), weights);
+  auto result = DagCriticalPath(g, "int_weight");
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  const std::vector<uint32_t>& path = result.value();
+  KATANA_LOG_ASSERT(!path.empty());
+
+  // The path follows edges and its length is the longest
+  const katana::GraphTopology& topology = g->topology();
+  int64_t total = 0;
+  for (size_t i = 1; i < path.size(); ++i) {
+    int64_t best = std::numeric_limits<int64_t>::min();
+    for (auto e : topology.edges(path[i - 1])) {
+      if (topology.edge_dest(e) == path[i]) {
+        best = std::max(best, weights[e]);
+      }
+    }
+    KATANA_LOG_VASSERT(
+        best != std::numeric_limits<int64_t>::min(), "no edge {} -> {}",
+        path[i - 1], path[i]);
+    total += best;
+  }
+  KATANA_LOG_VASSERT(
+      total == ref.longest, "path length {} expected {}", total, ref.longest);
+}
+
+void
+TestCycle() {
+  LinePolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(100, 0, &policy);
+  KATANA_LOG_ASSERT(!TopologicalSort(g.get(), "order"));
+  KATANA_LOG_ASSERT(g->node_schema()->GetFieldIndex("order") < 0);
+  KATANA_LOG_ASSERT(!DagLongestPath(g.get(), "", "length"));
+  KATANA_LOG_ASSERT(!DagCriticalPath(g.get(), ""));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  DagPolicy policy;
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  std::vector<int64_t> weights = AddWeights(g.get());
+
+  TestTopologicalSort(g.get());
+  TestLongestPath(g.get(), weights);
+  TestCriticalPath(g.get(), weights);
+  TestCycle();
+
+  return 0;
+}
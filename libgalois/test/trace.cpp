@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Trace.h"
+#include "katana/Uri.h"
+
+namespace {
+
+nlohmann::json
+ReadTrace(const std::string& path) {
+  std::ifstream in(path);
+  std::string text(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  nlohmann::json trace;
+  KATANA_LOG_ASSERT(katana::JsonParse(text, &trace));
+  return trace;
+}
+
+/// The tids of the complete events named name
+std::set<uint64_t>
+Threads(const nlohmann::json& trace, const std::string& name) {
+  std::set<uint64_t> tids;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "X" && event["name"] == name) {
+      KATANA_LOG_ASSERT(event["dur"] >= 0.0);
+      tids.emplace(event["tid"].get<uint64_t>());
+    }
+  }
+  return tids;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  unsigned num_threads = katana::setActiveThreads(4);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/trace");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+
+  // Not recorded, since tracing is off
+  { katana::TraceSpan span("Before", "test"); }
+
+  katana::SetTraceFile(path);
+  KATANA_LOG_ASSERT(katana::IsTraceEnabled());
+
+  constexpr uint64_t kNum = 100000;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), [](uint64_t) {}, katana::steal(),
+      katana::loopname("Trace-DoAll"));
+  katana::for_each(
+      katana::iterate({uint64_t{0}}),
+      [](uint64_t i, katana::UserContext<uint64_t>& ctx) {
+        if (i + 1 < 1000) {
+          ctx.push(i + 1);
+        }
+      },
+      katana::loopname("Trace-ForEach"));
+  { katana::TraceSpan span("Main", "test"); }
+
+  KATANA_LOG_ASSERT(katana::WriteTrace());
+  nlohmann::json trace = ReadTrace(path);
+
+  // Every thread runs its share of each loop and waits at the barrier at
+  // its end
+  KATANA_LOG_ASSERT(Threads(trace, "Trace-DoAll").size() == num_threads);
+  KATANA_LOG_ASSERT(Threads(trace, "Trace-ForEach").size() == num_threads);
+  KATANA_LOG_ASSERT(Threads(trace, "barrier").size() == num_threads);
+  KATANA_LOG_ASSERT(Threads(trace, "Main").size() == 1);
+  KATANA_LOG_ASSERT(Threads(trace, "Before").empty());
+
+  size_t num_named = 0;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "M") {
+      KATANA_LOG_ASSERT(event["name"] == "thread_name");
+      num_named += event["args"]["name"].get<std::string>().rfind(
+                       "worker ", 0) == 0;
+    }
+  }
+  KATANA_LOG_ASSERT(num_named >= num_threads);
+
+  // Threads keep the most recent events once their buffer is full
+  constexpr int kNumSpans = 100000;
+  for (int i = 0; i < kNumSpans; ++i) {
+    katana::TraceSpan span(i % 2 ? "Odd" : "Even", "test");
+  }
+  katana::SetTraceFile("");
+  KATANA_LOG_ASSERT(!katana::IsTraceEnabled());
+  { katana::TraceSpan span("After", "test"); }
+
+  trace = ReadTrace(path);
+  std::remove(path.c_str());
+  KATANA_LOG_ASSERT(Threads(trace, "After").empty());
+  KATANA_LOG_ASSERT(Threads(trace, "Main").empty());
+  uint64_t main_tid = *Threads(trace, "Odd").begin();
+  double last_ts = -1e300;
+  int num_spans = 0;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] != "X" || event["tid"] != main_tid) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(event["ts"] >= last_ts);
+    last_ts = event["ts"].get<double>();
+    num_spans += 1;
+  }
+  KATANA_LOG_ASSERT(num_spans == 1 << 16);
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+using katana::analytics::LocalClusteringCoefficientPlan;
+using katana::analytics::TriangleCountPlan;
+
+/// Make a symmetric graph of clusters of densely connected nodes with a few
+/// edges between clusters, so that it has many triangles
+std::unique_ptr<katana::PropertyGraph>
+MakeClusteredGraph(uint32_t num_nodes, uint32_t cluster_size) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> coin(0, 1);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::vector<std::set<uint32_t>> neighbors(num_nodes);
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    if (a != b) {
+      neighbors[a].emplace(b);
+      neighbors[b].emplace(a);
+    }
+  };
+  for (uint32_t a = 0; a < num_nodes; ++a) {
+    uint32_t cluster_end =
+        std::min(num_nodes, (a / cluster_size + 1) * cluster_size);
+    for (uint32_t b = a + 1; b < cluster_end; ++b) {
+      if (coin(gen) < 0.5) {
+        add_edge(a, b);
+      }
+    }
+    add_edge(a, node(gen));
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& n : neighbors) {
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+  return g;
+}
+
+void
+TestTriangleCount(katana::PropertyGraph* g) {
+  auto exact_result = katana::analytics::TriangleCount(g);
+  KATANA_LOG_ASSERT(exact_result);
+  double exact = exact_result.value();
+  KATANA_LOG_ASSERT(exact > 0);
+
+  // Keeping every edge counts exactly
+  auto all_edges = katana::analytics::EstimateTriangleCount(
+      g, TriangleCountPlan::EdgeSampling(1));
+  KATANA_LOG_ASSERT(all_edges);
+  KATANA_LOG_VASSERT(
+      all_edges.value().triangles == exact, "{} != {}",
+      all_edges.value().triangles, exact);
+  KATANA_LOG_ASSERT(all_edges.value().variance == 0);
+
+  // Estimates should be within a few standard errors of the exact count
+  for (auto plan :
+       {TriangleCountPlan::EdgeSampling(0.5),
+        TriangleCountPlan::WedgeSampling(0.01)}) {
+    auto estimate_result = katana::analytics::EstimateTriangleCount(g, plan);
+    KATANA_LOG_ASSERT(estimate_result);
+    const auto& estimate = estimate_result.value();
+    KATANA_LOG_ASSERT(estimate.num_samples > 0);
+    KATANA_LOG_VASSERT(
+        std::abs(estimate.triangles - exact) <=
+            estimate.ConfidenceInterval(0.9999),
+        "algorithm {}: estimate {} stderr {} exact {}", plan.algorithm(),
+        estimate.triangles, estimate.standard_error(), exact);
+  }
+
+  auto bad_plan = katana::analytics::EstimateTriangleCount(
+      g, TriangleCountPlan::EdgeSampling(0));
+  KATANA_LOG_ASSERT(!bad_plan);
+}
+
+void
+TestLocalClusteringCoefficient(katana::PropertyGraph* g) {
+  // The edges are sorted already
+  auto exact_result = katana::analytics::LocalClusteringCoefficient(
+      g, "exact",
+      LocalClusteringCoefficientPlan::LocalClusteringCoefficientPerThread(
+          true, LocalClusteringCoefficientPlan::kNoRelabel));
+  KATANA_LOG_ASSERT(exact_result);
+
+  // With enough samples every node is computed exactly; with few, nodes
+  // are estimated within a few times the bound on the standard error
+  constexpr uint32_t kFewSamples = 256;
+  constexpr double kFewSamplesError = 5 / (2 * 16.0);
+  for (uint32_t samples : {1U << 20, kFewSamples}) {
+    std::string name = "sampled" + std::to_string(samples);
+    auto sampled_result = katana::analytics::LocalClusteringCoefficient(
+        g, name, LocalClusteringCoefficientPlan::WedgeSampling(samples));
+    KATANA_LOG_ASSERT(sampled_result);
+
+    auto exact = g->GetNodePropertyTyped<double>("exact").value();
+    auto sampled = g->GetNodePropertyTyped<double>(name).value();
+    for (int64_t i = 0; i < exact->length(); ++i) {
+      double e = exact->Value(i);
+      double s = sampled->Value(i);
+      if (std::isnan(e)) {
+        KATANA_LOG_ASSERT(std::isnan(s));
+      } else if (samples == kFewSamples) {
+        KATANA_LOG_VASSERT(
+            std::abs(e - s) <= kFewSamplesError, "node {}: {} {}", i, e, s);
+      } else {
+        KATANA_LOG_VASSERT(std::abs(e - s) < 1e-9, "node {}: {} {}", i, e, s);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeClusteredGraph(4000, 100);
+  TestTriangleCount(g.get());
+  TestLocalClusteringCoefficient(g.get());
+
+  return 0;
+}
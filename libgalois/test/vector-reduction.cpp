@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/VectorReduction.h"
+
+namespace {
+
+/// Add i % size to element (i * stride) % size for i in [0, num_updates)
+/// and check the result against a serial reduction, over a few rounds so
+/// that dense copies are reused
+void
+TestAccumulate(size_t size, uint64_t num_updates, uint64_t stride) {
+  katana::GVectorAccumulator<uint64_t> accum(size);
+  for (int round = 0; round < 3; ++round) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_updates),
+        [&](uint64_t i) { accum.update((i * stride) % size, i % size); },
+        katana::no_stats());
+
+    std::vector<uint64_t> expected(size);
+    for (uint64_t i = 0; i < num_updates; ++i) {
+      expected[(i * stride) % size] += i % size;
+    }
+    KATANA_LOG_ASSERT(accum.reduce() == expected);
+  }
+}
+
+void
+TestMax() {
+  constexpr size_t kSize = 1000;
+  auto max = katana::make_vector_reducible(
+      kSize, [](int64_t a, int64_t b) { return std::max(a, b); },
+      []() { return int64_t{-1}; });
+  katana::do_all(
+      katana::iterate(int64_t{0}, int64_t{100000}),
+      [&](int64_t i) { max.update(i % 10, i); }, katana::no_stats());
+
+  const std::vector<int64_t>& result = max.reduce();
+  for (size_t i = 0; i < kSize; ++i) {
+    KATANA_LOG_ASSERT(result[i] == (i < 10 ? 99990 + int64_t(i) : -1));
+  }
+
+  // Values are discarded by reduce
+  KATANA_LOG_ASSERT(max.reduce()[0] == -1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Few elements updated by each thread, which stay sparse
+  TestAccumulate(1 << 20, 1000, 7919);
+  // Every element updated by every thread, which promotes to dense
+  TestAccumulate(1 << 12, 1 << 20, 1);
+  // A histogram smaller than the sparse limit of a single element
+  TestAccumulate(8, 1 << 16, 3);
+  TestMax();
+
+  // With fewer threads than updated before
+  katana::GVectorAccumulator<int> accum(100);
+  katana::do_all(
+      katana::iterate(0, 100), [&](int i) { accum.update(i, 1); },
+      katana::no_stats());
+  katana::setActiveThreads(1);
+  const std::vector<int>& result = accum.reduce();
+  for (int i = 0; i < 100; ++i) {
+    KATANA_LOG_ASSERT(result[i] == 1);
+  }
+
+  return 0;
+}
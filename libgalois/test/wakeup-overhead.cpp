@@ -41,6 +41,11 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
+static cll::opt<unsigned> spin(
+    "spin",
+    cll::desc("microseconds threads poll for work before sleeping in "
+              "DoAllSpin"),
+    cll::init(100));
 
 void
 runDoAllBurn(int num) {
@@ -64,6 +69,17 @@ runDoAll(int num) {
   }
 }
 
+void
+runDoAllSpin(int num) {
+  auto& tp = katana::GetThreadPool();
+  auto previous = tp.getSpinWait();
+  tp.setSpinWait(std::chrono::microseconds(spin));
+
+  runDoAll(num);
+
+  tp.setSpinWait(previous);
+}
+
 void
 runExplicitThread(int num) {
   katana::Barrier& barrier = katana::GetBarrier(katana::getActiveThreads());
@@ -111,6 +127,7 @@ main(int argc, char* argv[]) {
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
+    run(runDoAllSpin, "DoAllSpin");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
@@ -118,6 +135,11 @@ main(int argc, char* argv[]) {
   std::cout << "threads: " << katana::getActiveThreads() << " usable threads: "
             << katana::GetThreadPool().getMaxUsableThreads()
             << " rounds: " << rounds << " size: " << size << "\n";
+  auto stats = katana::GetThreadPool().getDispatchStats();
+  if (stats.runs) {
+    std::cout << "mean dispatch latency: " << stats.total_ns / stats.runs
+              << "ns max: " << stats.max_ns << "ns\n";
+  }
 
   return 0;
 }
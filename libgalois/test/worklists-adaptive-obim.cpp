@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+constexpr uint32_t kDepth = 16;
+
+struct Item {
+  int priority;
+  uint32_t depth;
+};
+
+struct Indexer {
+  int operator()(const Item& item) const { return item.priority; }
+};
+
+using WL = katana::AdaptiveOrderedByIntegerMetric<Indexer>;
+using SerialWL = WL::retype<Item>::rethread<false>;
+
+/// Pop everything from wl and check that each of the num_items items pushed
+/// comes out exactly once
+void
+PopAll(SerialWL* wl, size_t num_items) {
+  std::vector<bool> seen(num_items);
+  size_t popped = 0;
+  while (auto item = wl->pop()) {
+    KATANA_LOG_ASSERT(item->depth < num_items && !seen[item->depth]);
+    seen[item->depth] = true;
+    ++popped;
+  }
+  KATANA_LOG_VASSERT(
+      popped == num_items, "popped {} expected {}", popped, num_items);
+}
+
+/// Buckets holding one item each are merged
+void
+TestMerge() {
+  SerialWL wl;
+  constexpr uint32_t kNumItems = 10000;
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    wl.push(Item{static_cast<int>(i), i});
+  }
+  PopAll(&wl, kNumItems);
+
+  KATANA_LOG_VASSERT(wl.shift() > 0, "shift {}", wl.shift());
+  KATANA_LOG_ASSERT(wl.num_merges() == wl.shift());
+  KATANA_LOG_ASSERT(wl.num_splits() == 0);
+  KATANA_LOG_ASSERT(wl.num_buckets() == kNumItems);
+}
+
+/// Buckets holding many items each are split
+void
+TestSplit() {
+  constexpr unsigned kShift = 20;
+  constexpr uint32_t kNumBuckets = 64;
+  constexpr uint32_t kItemsPerBucket = 2 * SerialWL::kMaxWorkPerVisit;
+
+  SerialWL wl(Indexer(), kShift);
+  for (uint32_t i = 0; i < kNumBuckets * kItemsPerBucket; ++i) {
+    int priority = ((i / kItemsPerBucket) << kShift) | (i % kItemsPerBucket);
+    wl.push(Item{priority, i});
+  }
+  KATANA_LOG_ASSERT(wl.num_buckets() == kNumBuckets);
+  PopAll(&wl, kNumBuckets * kItemsPerBucket);
+
+  KATANA_LOG_VASSERT(wl.shift() < kShift, "shift {}", wl.shift());
+  KATANA_LOG_ASSERT(wl.num_splits() == kShift - wl.shift());
+  KATANA_LOG_ASSERT(wl.num_merges() == 0);
+}
+
+/// Expand a binary tree whose items have integer priorities; every item must
+/// be processed exactly once whatever the bucket width does meanwhile.
+void
+TestTree(unsigned initial_shift) {
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate({Item{0, 0}}),
+      [&](const Item& item, katana::UserContext<Item>& ctx) {
+        visited += 1;
+        if (item.depth + 1 < kDepth) {
+          int p = item.priority;
+          ctx.push(Item{p + 1, item.depth + 1});
+          ctx.push(Item{p + (1 << (kDepth - item.depth)), item.depth + 1});
+        }
+      },
+      katana::wl<WL>(Indexer(), initial_shift, "AdaptiveOBIM-Tree"),
+      katana::loopname("Tree"), katana::disable_conflict_detection());
+
+  uint64_t expected = (uint64_t{1} << kDepth) - 1;
+  KATANA_LOG_VASSERT(
+      visited.reduce() == expected, "visited {} expected {}", visited.reduce(),
+      expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  TestMerge();
+  TestSplit();
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    katana::setActiveThreads(threads);
+    TestTree(0);
+    TestTree(20);
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/WorkList.h"
+
+// Throughput, scaling and priority inversions of the worklists under
+// synthetic workloads. Run with --benchmark_format=json (or
+// --benchmark_out=<file> --benchmark_out_format=json) for JSON output.
+
+namespace {
+
+/// A work item. Children have larger priorities than their parents, as in
+/// label-correcting searches like SSSP.
+struct Item {
+  uint32_t priority;
+  uint32_t depth;
+  uint64_t id;
+};
+
+enum Workload {
+  /// Many initial items that push nothing: pop throughput
+  kFlat,
+  /// Few initial items that push two children each until a depth: push and
+  /// pop throughput, with work appearing where the threads are
+  kTree,
+};
+
+constexpr uint32_t kFlatItems = 1 << 20;
+constexpr uint32_t kTreeRoots = 1 << 10;
+constexpr uint32_t kTreeDepth = 10;
+constexpr uint32_t kFanout = 2;
+/// Spins of busy work per item, to stand in for an operator
+constexpr uint32_t kWorkPerItem = 16;
+
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+struct PriorityIndexer {
+  uint32_t operator()(const Item& item) const { return item.priority >> 3; }
+};
+
+/// Spread items over threads by id
+struct OwnerIndexer {
+  uint32_t operator()(const Item& item) const {
+    return Mix(item.id) % katana::getActiveThreads();
+  }
+};
+
+std::vector<Item>
+InitialItems(Workload workload) {
+  uint32_t num_items = workload == kFlat ? kFlatItems : kTreeRoots;
+  uint32_t depth = workload == kFlat ? 0 : kTreeDepth;
+  std::vector<Item> items;
+  items.reserve(num_items);
+  for (uint32_t i = 0; i < num_items; ++i) {
+    items.emplace_back(
+        Item{static_cast<uint32_t>(Mix(i) % 64), depth, uint64_t{i}});
+  }
+  return items;
+}
+
+template <typename WL>
+void
+RunWorklist(benchmark::State& state) {
+  auto num_threads = static_cast<unsigned>(state.range(0));
+  auto workload = static_cast<Workload>(state.range(1));
+  katana::setActiveThreads(num_threads);
+  std::vector<Item> initial = InitialItems(workload);
+
+  uint64_t items = 0;
+  uint64_t inversions = 0;
+  for (auto _ : state) {
+    katana::GAccumulator<uint64_t> processed;
+    katana::GAccumulator<uint64_t> inverted;
+    // The largest priority processed so far; processing a smaller one
+    // afterwards is a priority inversion
+    std::atomic<uint32_t> max_priority{0};
+
+    katana::for_each(
+        katana::iterate(initial),
+        [&](const Item& item, auto& ctx) {
+          processed += 1;
+          uint32_t seen = max_priority.load(std::memory_order_relaxed);
+          if (item.priority < seen) {
+            inverted += 1;
+          }
+          while (item.priority > seen &&
+                 !max_priority.compare_exchange_weak(
+                     seen, item.priority, std::memory_order_relaxed)) {
+          }
+          for (uint32_t i = 0; i < kWorkPerItem; ++i) {
+            katana::compilerBarrier();
+          }
+          if (item.depth == 0) {
+            return;
+          }
+          for (uint32_t c = 0; c < kFanout; ++c) {
+            uint64_t id = item.id * kFanout + c + 1;
+            ctx.push(Item{
+                item.priority + 1 + static_cast<uint32_t>(Mix(id) % 8),
+                item.depth - 1, id});
+          }
+        },
+        katana::wl<WL>(), katana::disable_conflict_detection(),
+        katana::no_stats(), katana::loopname("WorklistBench"));
+
+    items += processed.reduce();
+    inversions += inverted.reduce();
+  }
+
+  state.counters["threads"] = katana::getActiveThreads();
+  state.counters["items_per_second"] =
+      benchmark::Counter(items, benchmark::Counter::kIsRate);
+  state.counters["inversion_rate"] =
+      items > 0 ? static_cast<double>(inversions) / items : 0;
+  state.SetLabel(workload == kFlat ? "flat" : "tree");
+}
+
+/// Both workloads on 1, 2, 4, ... threads up to the number of hardware
+/// threads
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  long max_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (long workload : {kFlat, kTree}) {
+    for (long t = 1;; t *= 2) {
+      b->Args({std::min(t, max_threads), workload});
+      if (t >= max_threads) {
+        break;
+      }
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+using PerSocketChunkFIFO = katana::PerSocketChunkFIFO<64>;
+using PerSocketChunkLIFO = katana::PerSocketChunkLIFO<64>;
+using OrderedByIntegerMetric =
+    katana::OrderedByIntegerMetric<PriorityIndexer, PerSocketChunkFIFO>;
+using BulkSynchronous = katana::BulkSynchronous<PerSocketChunkFIFO>;
+using OwnerComputes =
+    katana::OwnerComputes<OwnerIndexer, katana::ChunkFIFO<64>>;
+using LocalQueue = katana::LocalQueue<PerSocketChunkFIFO>;
+using StableIterator = katana::StableIterator<true, PerSocketChunkFIFO>;
+
+BENCHMARK_TEMPLATE(RunWorklist, PerSocketChunkFIFO)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, PerSocketChunkLIFO)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, OrderedByIntegerMetric)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, BulkSynchronous)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, OwnerComputes)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, LocalQueue)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(RunWorklist, StableIterator)->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+constexpr uint32_t kDepth = 16;
+
+struct Item {
+  float priority;
+  uint32_t depth;
+
+  friend bool operator<(const Item& a, const Item& b) {
+    return a.priority < b.priority;
+  }
+};
+
+/// Expand a binary tree whose items have random floating-point priorities;
+/// every item must be processed exactly once.
+void
+TestTree() {
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate({Item{0.0f, 0}}),
+      [&](const Item& item, katana::UserContext<Item>& ctx) {
+        visited += 1;
+        if (item.depth + 1 < kDepth) {
+          float p = item.priority;
+          ctx.push(Item{p + 0.5f / (item.depth + 1), item.depth + 1});
+          ctx.push(Item{p + 1.0f / (item.depth + 1), item.depth + 1});
+        }
+      },
+      katana::wl<katana::MultiQueue<>>(), katana::loopname("Tree"),
+      katana::disable_conflict_detection());
+
+  uint64_t expected = (uint64_t{1} << kDepth) - 1;
+  KATANA_LOG_VASSERT(
+      visited.reduce() == expected, "visited {} expected {}", visited.reduce(),
+      expected);
+}
+
+/// With a single heap, items come out in exact order, including items still
+/// in the push buffer.
+void
+TestSerialOrder() {
+  using WL = katana::MultiQueue<std::greater<>, 1, 8, double, false>;
+  WL wl;
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<double> items(1000);
+  for (auto& v : items) {
+    v = dist(gen);
+  }
+
+  wl.push(items.begin(), items.begin() + 500);
+  for (auto it = items.begin() + 500; it != items.end(); ++it) {
+    wl.push(*it);
+  }
+
+  std::sort(items.begin(), items.end(), std::greater<>());
+  for (double expected : items) {
+    auto v = wl.pop();
+    KATANA_LOG_ASSERT(v && *v == expected);
+  }
+  KATANA_LOG_ASSERT(!wl.pop());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  TestSerialOrder();
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    katana::setActiveThreads(threads);
+    TestTree();
+  }
+
+  return 0;
+}
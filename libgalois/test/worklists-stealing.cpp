@@ -0,0 +1,49 @@
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+constexpr uint32_t kDepth = 16;
+
+/// Expand a binary tree from its root through a single thread's worklist so
+/// that all other threads only get work by stealing.
+template <typename WL>
+void
+TestTree() {
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate({uint32_t{0}}),
+      [&](uint32_t depth, katana::UserContext<uint32_t>& ctx) {
+        visited += 1;
+        if (depth + 1 < kDepth) {
+          ctx.push(depth + 1);
+          ctx.push(depth + 1);
+        }
+      },
+      katana::wl<WL>(), katana::loopname("Tree"),
+      katana::disable_conflict_detection());
+
+  uint64_t expected = (uint64_t{1} << kDepth) - 1;
+  KATANA_LOG_VASSERT(
+      visited.reduce() == expected, "visited {} expected {}", visited.reduce(),
+      expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    katana::setActiveThreads(threads);
+    TestTree<katana::PerThreadChunkDeque<>>();
+    TestTree<katana::PerThreadChunkDeque<1>>();
+  }
+
+  return 0;
+}
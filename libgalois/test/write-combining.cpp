@@ -0,0 +1,89 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/WriteCombining.h"
+
+namespace {
+
+constexpr uint32_t kNumTargets = 5000;
+constexpr uint64_t kNumAdds = 1000000;
+
+/// Additions are skewed towards small indices, so that the same counter
+/// often appears several times in a batch
+uint32_t
+TargetOf(uint64_t i) {
+  return i % 2 == 0 ? i % 7 : (i * 2654435761U) % kNumTargets;
+}
+
+/// Add 1 for each addition in parallel and check that every counter gets
+/// its additions exactly once and that applied reports each batched sum
+template <typename T>
+void
+TestCounts(uint32_t num_blocks, uint32_t block_capacity) {
+  katana::LargeArray<std::atomic<T>> counters;
+  katana::LargeArray<std::atomic<T>> applied_sums;
+  counters.allocateBlocked(kNumTargets);
+  applied_sums.allocateBlocked(kNumTargets);
+  for (uint32_t i = 0; i < kNumTargets; ++i) {
+    counters.constructAt(i, 0);
+    applied_sums.constructAt(i, 0);
+  }
+
+  auto target = [&](uint32_t i) -> std::atomic<T>& { return counters[i]; };
+  using Buffer = katana::WriteCombiningBuffer<T, decltype(target)>;
+  katana::PerThreadStorage<Buffer> buffers(
+      target, kNumTargets, num_blocks, block_capacity);
+  auto applied = [&](uint32_t index, T, T sum) {
+    KATANA_LOG_ASSERT(sum > 0);
+    katana::atomicAdd(applied_sums[index], sum);
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumAdds),
+      [&](uint64_t i) { buffers.getLocal()->Add(TargetOf(i), 1, applied); },
+      katana::no_stats());
+  katana::on_each(
+      [&](unsigned, unsigned) { buffers.getLocal()->Flush(applied); });
+
+  std::vector<uint64_t> expected(kNumTargets);
+  for (uint64_t i = 0; i < kNumAdds; ++i) {
+    ++expected[TargetOf(i)];
+  }
+  for (uint32_t i = 0; i < kNumTargets; ++i) {
+    KATANA_LOG_VASSERT(
+        counters[i].load() == static_cast<T>(expected[i]),
+        "counter {}: {} != {}", i, counters[i].load(), expected[i]);
+    KATANA_LOG_ASSERT(applied_sums[i].load() == counters[i].load());
+  }
+
+  // Flushing again applies nothing
+  katana::on_each([&](unsigned, unsigned) {
+    buffers.getLocal()->Flush(
+        [](uint32_t, T, T) { KATANA_LOG_FATAL("nothing is pending"); });
+  });
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    // Counts stay below 2^24, so float sums are exact
+    TestCounts<float>(256, 32);
+    TestCounts<double>(3, 5);
+    TestCounts<uint64_t>(1, 1);
+    TestCounts<uint32_t>(100000, 64);
+  }
+
+  return 0;
+}
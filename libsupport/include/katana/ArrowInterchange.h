@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 #define KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <arrow/stl.h>
 #include <arrow/type_traits.h>
 
@@ -286,6 +290,47 @@ KATANA_EXPORT std::shared_ptr<arrow::ChunkedArray> Shuffle(
 KATANA_EXPORT std::shared_ptr<arrow::ChunkedArray> EmptyChunkedArray(
     const std::shared_ptr<arrow::DataType>& type, int64_t length);
 
+/// ShareReadOnly returns an array with the values of original whose buffers
+/// are read-only views of the buffers of original. Nothing is copied, but
+/// code that writes to arrays in place must copy them first, e.g., with
+/// CopyChunks, so that neither array sees the writes made to the other.
+KATANA_EXPORT std::shared_ptr<arrow::ArrayData> ShareReadOnly(
+    const std::shared_ptr<arrow::ArrayData>& original);
+KATANA_EXPORT std::shared_ptr<arrow::ChunkedArray> ShareReadOnly(
+    const std::shared_ptr<arrow::ChunkedArray>& original);
+
+/// \returns true if every buffer of data, including those of its children,
+/// can be written to in place
+KATANA_EXPORT bool IsMutable(const arrow::ArrayData& data);
+
+////////////////////////////////////////////
+// Sharing tables between processes
+
+/// Publish \param tables as the POSIX shared memory object \param name,
+/// e.g., "/katana-graph", so that other processes on this machine can map
+/// them with MapSharedTables without copying them. The tables are stored as
+/// Arrow IPC streams, which, unlike the Arrow C data interface, hold offsets
+/// rather than pointers and so can be read at any address.
+///
+/// \returns AlreadyExists if name is already published
+KATANA_EXPORT Result<void> PublishSharedTables(
+    const std::string& name,
+    const std::vector<std::shared_ptr<arrow::Table>>& tables);
+
+/// Map the tables published as \param name read-only. Their buffers point
+/// into the shared mapping, which is unmapped once the last buffer of this
+/// process that refers to it is destroyed. Columns keep the chunks they
+/// were published with.
+///
+/// \returns NotFound if name is not published
+KATANA_EXPORT Result<std::vector<std::shared_ptr<arrow::Table>>>
+MapSharedTables(const std::string& name);
+
+/// Remove the name of tables published with PublishSharedTables. Processes
+/// that mapped them can keep using them; the memory is freed when the last
+/// of them unmaps it.
+KATANA_EXPORT Result<void> UnlinkSharedTables(const std::string& name);
+
 }  // namespace katana
 
 #endif
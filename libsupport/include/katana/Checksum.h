@@ -0,0 +1,22 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_CHECKSUM_H_
+#define KATANA_LIBSUPPORT_KATANA_CHECKSUM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// \returns the CRC-32C (Castagnoli) of \param size bytes at \param data.
+/// Passing the result of an earlier call as \param crc extends that checksum,
+/// so the checksum of a buffer may be computed piece by piece.
+///
+/// Uses the SSE 4.2 crc32 instruction when the processor has it, which
+/// checksums several GB/s per thread, and a table otherwise.
+KATANA_EXPORT uint32_t
+Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace katana
+
+#endif
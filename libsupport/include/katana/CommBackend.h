@@ -1,8 +1,14 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 #define KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <arrow/buffer.h>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,6 +16,57 @@
 
 namespace katana {
 
+/// The element types of CommBackend::AllReduce
+enum class CommDataType { kInt32, kUInt32, kInt64, kUInt64, kFloat, kDouble };
+
+/// The ways CommBackend::AllReduce can combine elements
+enum class ReduceOp { kSum, kMin, kMax };
+
+/// The collectives of a CommBackend that keep CollectiveStats
+enum class Collective { kAllReduce, kAllGather, kAllToAllv, kNumCollectives };
+
+/// What this task spent on one kind of collective
+struct CollectiveStats {
+  uint64_t calls{0};
+  uint64_t bytes_sent{0};
+  uint64_t bytes_received{0};
+  std::chrono::nanoseconds time{0};
+};
+
+namespace internal {
+
+template <typename T>
+struct CommDataTypeOf;
+template <>
+struct CommDataTypeOf<int32_t> {
+  static constexpr CommDataType value = CommDataType::kInt32;
+};
+template <>
+struct CommDataTypeOf<uint32_t> {
+  static constexpr CommDataType value = CommDataType::kUInt32;
+};
+template <>
+struct CommDataTypeOf<int64_t> {
+  static constexpr CommDataType value = CommDataType::kInt64;
+};
+template <>
+struct CommDataTypeOf<uint64_t> {
+  static constexpr CommDataType value = CommDataType::kUInt64;
+};
+template <>
+struct CommDataTypeOf<float> {
+  static constexpr CommDataType value = CommDataType::kFloat;
+};
+template <>
+struct CommDataTypeOf<double> {
+  static constexpr CommDataType value = CommDataType::kDouble;
+};
+
+}  // namespace internal
+
+/// \returns the size of an element of type
+KATANA_EXPORT size_t CommDataTypeSize(CommDataType type);
+
 class KATANA_EXPORT CommBackend {
 public:
   CommBackend() = default;
@@ -28,6 +85,60 @@ public:
       uint32_t root, const std::string& val, uint64_t max_size) = 0;
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
+  /// Send outgoing[i] to task i and return the messages received, where
+  /// element i is the one from task i. All tasks must call this together.
+  ///
+  /// The default implementation only supports a single task.
+  virtual Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> outgoing);
+
+  using Buffers = std::vector<std::shared_ptr<arrow::Buffer>>;
+
+  /// Send outgoing[i] to task i and return the buffers received, where
+  /// element i is the one from task i. Buffers are sent as they are, with
+  /// no serialization or intermediate copies; the buffer from this task is
+  /// returned as it is. All tasks must call this together.
+  Result<Buffers> AllToAllv(const Buffers& outgoing);
+
+  /// \returns the buffers that the tasks pass, where element i is the one
+  /// from task i. All tasks must call this together.
+  Result<Buffers> AllGather(const std::shared_ptr<arrow::Buffer>& buffer);
+
+  /// Combine the elements of type in values of every task with op, e.g.,
+  /// sum them elementwise. All tasks must call this together with the same
+  /// number of elements.
+  Result<std::shared_ptr<arrow::Buffer>> AllReduce(
+      const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+      ReduceOp op);
+
+  /// AllReduce of the elements of values
+  template <typename T>
+  Result<std::vector<T>> AllReduce(const std::vector<T>& values, ReduceOp op) {
+    auto view = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(values.data()),
+        values.size() * sizeof(T));
+    auto res = AllReduce(view, internal::CommDataTypeOf<T>::value, op);
+    if (!res) {
+      return res.error();
+    }
+    const auto* reduced = reinterpret_cast<const T*>(res.value()->data());
+    return std::vector<T>(reduced, reduced + values.size());
+  }
+
+  /// AllReduce of a single value
+  template <typename T>
+  Result<T> AllReduce(T value, ReduceOp op) {
+    auto res = AllReduce(std::vector<T>{value}, op);
+    if (!res) {
+      return res.error();
+    }
+    return res.value()[0];
+  }
+
+  /// The calls, bytes and time this task spent on a collective
+  const CollectiveStats& stats(Collective collective) const {
+    return stats_[static_cast<size_t>(collective)];
+  }
 
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
@@ -37,6 +148,29 @@ public:
   uint32_t Num{1};
   /// The id number of this task
   uint32_t ID{0};
+
+protected:
+  /// Allocate a mutable buffer of size bytes for received data
+  static Result<std::shared_ptr<arrow::Buffer>> AllocateBuffer(uint64_t size);
+
+  /// Implements AllToAllv. The default implementation only supports a
+  /// single task.
+  virtual Result<Buffers> DoAllToAllv(const Buffers& outgoing);
+
+  /// Implements AllGather. The default implementation sends buffer to every
+  /// task with DoAllToAllv.
+  virtual Result<Buffers> DoAllGather(
+      const std::shared_ptr<arrow::Buffer>& buffer);
+
+  /// Implements AllReduce. The default implementation gathers every
+  /// task's values with DoAllGather and combines them locally.
+  virtual Result<std::shared_ptr<arrow::Buffer>> DoAllReduce(
+      const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+      ReduceOp op);
+
+private:
+  std::array<CollectiveStats, static_cast<size_t>(Collective::kNumCollectives)>
+      stats_{};
 };
 
 class KATANA_EXPORT NullCommBackend : public CommBackend {
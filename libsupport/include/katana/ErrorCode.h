@@ -65,6 +65,8 @@ enum class ErrorCode {
   TypeError = 11,
   AssertionFailed = 12,
   GraphUpdateFailed = 13,
+  Cancelled = 14,
+  OutOfMemory = 15,
 };
 
 }  // namespace katana
@@ -105,6 +107,10 @@ public:
       return "assertion failed";
     case ErrorCode::GraphUpdateFailed:
       return "graph update failed";
+    case ErrorCode::Cancelled:
+      return "cancelled";
+    case ErrorCode::OutOfMemory:
+      return "out of memory";
     default:
       return "unknown error";
     }
@@ -130,6 +136,10 @@ public:
       return make_error_condition(std::errc::no_such_file_or_directory);
     case ErrorCode::HttpError:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
+    case ErrorCode::OutOfMemory:
+      return make_error_condition(std::errc::not_enough_memory);
     default:
       return std::error_condition(c, *this);
     }
@@ -1,9 +1,16 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_HTTP_H_
 #define KATANA_LIBSUPPORT_KATANA_HTTP_H_
 
+#include <cstdint>
+
 #include "katana/JSON.h"
 #include "katana/Result.h"
 
+/// Except for HttpGetRange, requests are performed by one client shared by
+/// all threads that keeps connections open for later requests and
+/// multiplexes concurrent requests to a host over HTTP/2 where it can.
+/// KATANA_HTTP_MAX_HOST_CONNECTIONS limits the connections to each host.
+
 namespace katana {
 
 KATANA_EXPORT Result<void> HttpInit();
@@ -12,6 +19,21 @@ KATANA_EXPORT Result<void> HttpInit();
 KATANA_EXPORT Result<void> HttpGet(
     const std::string& url, std::vector<char>* response);
 
+/// Perform an HTTP range request for size bytes at begin of url and write them
+/// to buffer. received is set to the number of bytes received, which is less
+/// than size if the range extends past the end of the resource.
+///
+/// Each thread keeps its connections open between calls, so repeated range
+/// requests to one server do not pay for a TCP and TLS handshake each.
+KATANA_EXPORT Result<void> HttpGetRange(
+    const std::string& url, uint64_t begin, uint64_t size, uint8_t* buffer,
+    uint64_t* received);
+
+/// Perform an HTTP head request on url and return the size of the resource
+/// and its version, i.e., its ETag or, if it has none, its modification time
+KATANA_EXPORT Result<void> HttpHead(
+    const std::string& url, uint64_t* size, std::string* version);
+
 /// Perform an HTTP post request on url and send the contents of buffer
 KATANA_EXPORT Result<void> HttpPost(
     const std::string& url, const std::string& data,
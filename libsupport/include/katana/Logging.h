@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_LOGGING_H_
 #define KATANA_LIBSUPPORT_KATANA_LOGGING_H_
 
+#include <cstdint>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -38,11 +39,56 @@ enum class LogLevel {
   Error = 4,
 };
 
+/// How log messages are written
+enum class LogFormat {
+  /// "LEVEL: file:line: message"
+  kText,
+  /// One JSON object per line with the fields time_ns (since the epoch),
+  /// thread (the order in which the thread first logged), level, file, line
+  /// and message
+  kJson,
+};
+
+/// Write log messages from a background thread rather than from the thread
+/// that logs them. Each thread appends its messages to a ring buffer of its
+/// own without taking a lock, and the background thread periodically writes
+/// the messages of all threads in time order, so threads that log in
+/// parallel loops do not serialize on the output stream. A thread whose
+/// buffer is full drops its messages rather than wait, and the number of
+/// dropped messages is logged.
+///
+/// Errors are always written synchronously, after the queued messages, so
+/// that they are not lost if the application aborts.
+///
+/// Asynchronous logging is initially configured from the environment
+/// variable KATANA_LOG_ASYNC.
+KATANA_EXPORT void SetAsyncLogging(bool enabled);
+
+/// Return true if messages are written by a background thread.
+KATANA_EXPORT bool IsAsyncLoggingEnabled();
+
+/// Write all queued messages and return once they are written.
+KATANA_EXPORT void FlushLog();
+
+/// Log at most per_second messages other than errors per second from each
+/// thread and drop the rest; 0, the default, does not limit. The number of
+/// dropped messages is logged. Initially configured from the environment
+/// variable KATANA_LOG_RATE_LIMIT.
+KATANA_EXPORT void SetLogRateLimit(uint32_t per_second);
+
+/// Initially configured from the environment variable KATANA_LOG_FORMAT,
+/// "text" (the default) or "json".
+KATANA_EXPORT void SetLogFormat(LogFormat format);
+
 namespace internal {
 
 KATANA_EXPORT void LogString(LogLevel level, const std::string& s);
 
-}
+/// Log s as a message from line line_no of file_name
+KATANA_EXPORT void LogLineString(
+    LogLevel level, const char* file_name, int line_no, const std::string& s);
+
+}  // namespace internal
 
 /// Log at a specific LogLevel.
 ///
@@ -71,8 +117,7 @@ LogLine(
     LogLevel level, const char* file_name, int line_no, F fmt_string,
     Args&&... args) {
   std::string s = fmt::format(fmt_string, std::forward<Args>(args)...);
-  std::string with_line = fmt::format("{}:{}: {}", file_name, line_no, s);
-  internal::LogString(level, with_line);
+  internal::LogLineString(level, file_name, line_no, s);
 }
 
 KATANA_EXPORT void AbortApplication [[noreturn]] ();
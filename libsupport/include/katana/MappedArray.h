@@ -0,0 +1,264 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MAPPEDARRAY_H_
+#define KATANA_LIBSUPPORT_KATANA_MAPPEDARRAY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <arrow/buffer.h>
+
+#include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Map \param bytes of zeroed anonymous memory. Pages are committed when they
+/// are first touched rather than when they are mapped.
+KATANA_EXPORT Result<void*> MapAnonymous(size_t bytes);
+
+/// Resize the anonymous mapping of \param old_bytes at \param ptr to
+/// \param new_bytes, keeping its contents. Pages are moved rather than
+/// copied, so this takes time in the number of pages rather than bytes and
+/// never holds the old and new mappings at once. Memory past old_bytes is
+/// zero.
+///
+/// \returns the address of the mapping, which may have moved
+KATANA_EXPORT Result<void*> RemapAnonymous(
+    void* ptr, size_t old_bytes, size_t new_bytes);
+
+/// Unmap the anonymous mapping of \param bytes at \param ptr
+KATANA_EXPORT Result<void> UnmapAnonymous(void* ptr, size_t bytes);
+
+/// \returns the size that anonymous mappings are rounded up to
+KATANA_EXPORT size_t MappingGranularity();
+
+/// \returns a buffer of the first \param size bytes of the anonymous mapping
+/// of \param capacity bytes at \param ptr. The buffer takes over the
+/// mapping: it unmaps it and releases capacity bytes charged to
+/// \param subsystem when it is destroyed.
+KATANA_EXPORT std::shared_ptr<arrow::MutableBuffer> MakeMappedBuffer(
+    void* ptr, size_t size, size_t capacity, MemorySubsystem subsystem);
+
+/// A growable array of trivially copyable elements in anonymous memory.
+///
+/// std::vector and PODResizeableArray grow by allocating a larger buffer,
+/// copying into it and freeing the old one, so growing a buffer of n bytes
+/// copies n bytes and needs 2n bytes at the peak. MappedArray grows its
+/// mapping with RemapAnonymous instead, which moves no data and maps no
+/// more than the new capacity, and its pages are only committed when they
+/// are written, so reserving generously costs address space but not memory.
+///
+/// Elements added by resize are zero. The mapping is charged to a
+/// MemorySubsystem of the memory budget, kLargeArray unless given, and can
+/// be handed to Arrow without a copy with ToBuffer.
+template <typename T>
+class MappedArray {
+  static_assert(
+      std::is_trivially_copyable_v<T>,
+      "MappedArray elements are moved as bytes");
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  explicit MappedArray(
+      MemorySubsystem subsystem = MemorySubsystem::kLargeArray)
+      : subsystem_(subsystem) {}
+
+  explicit MappedArray(
+      size_t n, MemorySubsystem subsystem = MemorySubsystem::kLargeArray)
+      : subsystem_(subsystem) {
+    resize(n);
+  }
+
+  MappedArray(const MappedArray&) = delete;
+  MappedArray& operator=(const MappedArray&) = delete;
+
+  MappedArray(MappedArray&& other) noexcept
+      : subsystem_(other.subsystem_),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        mapped_bytes_(std::exchange(other.mapped_bytes_, 0)),
+        written_(std::exchange(other.written_, 0)) {}
+
+  MappedArray& operator=(MappedArray&& other) noexcept {
+    if (this != &other) {
+      Unmap();
+      subsystem_ = other.subsystem_;
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      capacity_ = std::exchange(other.capacity_, 0);
+      mapped_bytes_ = std::exchange(other.mapped_bytes_, 0);
+      written_ = std::exchange(other.written_, 0);
+    }
+    return *this;
+  }
+
+  ~MappedArray() { Unmap(); }
+
+  iterator begin() { return data_; }
+  const_iterator begin() const { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator end() const { return data_ + size_; }
+
+  pointer data() { return data_; }
+  const_pointer data() const { return data_; }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  reference operator[](size_t i) {
+    KATANA_LOG_DEBUG_ASSERT(i < size_);
+    return data_[i];
+  }
+  const_reference operator[](size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < size_);
+    return data_[i];
+  }
+
+  reference front() { return data_[0]; }
+  const_reference front() const { return data_[0]; }
+  reference back() { return data_[size_ - 1]; }
+  const_reference back() const { return data_[size_ - 1]; }
+
+  /// Make room for \param n elements without growing again
+  void reserve(size_t n) {
+    if (n > capacity_) {
+      Remap(n);
+    }
+  }
+
+  /// Resize to \param n elements; added elements are zero
+  void resize(size_t n) {
+    if (n > capacity_) {
+      Remap(std::max(n, 2 * capacity_));
+    }
+    if (n > size_) {
+      // Memory that was never written is still zero
+      size_t dirty_end = std::min(n, written_);
+      if (dirty_end > size_) {
+        std::memset(
+            static_cast<void*>(data_ + size_), 0,
+            (dirty_end - size_) * sizeof(T));
+      }
+    } else {
+      written_ = std::max(written_, size_);
+    }
+    size_ = n;
+  }
+
+  /// Resize to \param n elements; added elements are \param value
+  void resize(size_t n, const T& value) {
+    size_t old_size = size_;
+    resize(n);
+    if (n > old_size) {
+      std::fill(data_ + old_size, data_ + n, value);
+    }
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (size_ == capacity_) {
+      Remap(std::max<size_t>(1, 2 * capacity_));
+    }
+    T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  void clear() { resize(0); }
+
+  /// Return the pages past size() to the system
+  void shrink_to_fit() {
+    written_ = std::max(written_, size_);
+    Remap(size_);
+  }
+
+  /// \returns an Arrow buffer of the elements that takes over the mapping
+  /// without copying it, leaving this array empty
+  std::shared_ptr<arrow::MutableBuffer> ToBuffer() && {
+    auto buffer = MakeMappedBuffer(
+        data_, size_ * sizeof(T), mapped_bytes_, subsystem_);
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    mapped_bytes_ = 0;
+    written_ = 0;
+    return buffer;
+  }
+
+private:
+  /// Map exactly enough whole pages for \param n elements
+  void Remap(size_t n) {
+    size_t granularity = MappingGranularity();
+    size_t bytes =
+        (n * sizeof(T) + granularity - 1) / granularity * granularity;
+    if (bytes == mapped_bytes_) {
+      return;
+    }
+    if (bytes == 0) {
+      Unmap();
+      return;
+    }
+    if (bytes > mapped_bytes_) {
+      ChargeMemory(subsystem_, bytes - mapped_bytes_);
+    }
+    auto res = data_ ? RemapAnonymous(data_, mapped_bytes_, bytes)
+                     : MapAnonymous(bytes);
+    if (!res) {
+      KATANA_LOG_FATAL("mapping {} bytes: {}", bytes, res.error());
+    }
+    if (bytes < mapped_bytes_) {
+      ReleaseMemory(subsystem_, mapped_bytes_ - bytes);
+    }
+    data_ = static_cast<T*>(res.value());
+    mapped_bytes_ = bytes;
+    capacity_ = bytes / sizeof(T);
+    written_ = std::min(written_, capacity_);
+  }
+
+  void Unmap() {
+    if (data_ == nullptr) {
+      return;
+    }
+    if (auto res = UnmapAnonymous(data_, mapped_bytes_); !res) {
+      KATANA_LOG_ERROR("unmapping array: {}", res.error());
+    }
+    ReleaseMemory(subsystem_, mapped_bytes_);
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    mapped_bytes_ = 0;
+    written_ = 0;
+  }
+
+  MemorySubsystem subsystem_;
+  T* data_{nullptr};
+  size_t size_{0};
+  size_t capacity_{0};
+  size_t mapped_bytes_{0};
+  /// Elements at or past this index have not been written since they were
+  /// mapped, so they are still zero
+  size_t written_{0};
+};
+
+}  // namespace katana
+
+#endif
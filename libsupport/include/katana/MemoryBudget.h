@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MEMORYBUDGET_H_
+#define KATANA_LIBSUPPORT_KATANA_MEMORYBUDGET_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The parts of the library whose memory is accounted against the memory
+/// budget
+enum class MemorySubsystem {
+  /// Pages of the page pool (see pagePoolAlloc)
+  kPagePool,
+  /// Large allocations, e.g., of LargeArray (see largeMallocLocal)
+  kLargeArray,
+  /// Buffers of the default Arrow memory pool, e.g., loaded properties
+  kArrow,
+  /// Pages of files fetched into tsuba::FileView, e.g., topologies
+  kFileView,
+  /// Buffers of tsuba::FileFrame
+  kFileFrame,
+  kNumSubsystems,
+};
+
+KATANA_EXPORT const char* MemorySubsystemName(MemorySubsystem subsystem);
+
+/// Limit the memory of all subsystems together to \param bytes; 0 means
+/// unlimited. The budget is initially the value of the environment variable
+/// KATANA_MEMORY_BUDGET, or unlimited if it is not set.
+///
+/// The budget is soft: memory that cannot be refused, like pages of the page
+/// pool, is charged even when it exceeds the budget, which is then logged
+/// once as a warning. Loads from storage reserve their memory first and fail
+/// with ErrorCode::OutOfMemory if the budget has no room for them after
+/// memory reclaimers (see AddMemoryReclaimer) ran. Whenever usage passes 90%
+/// of the budget, the reclaimers are asked to bring it back below.
+KATANA_EXPORT void SetMemoryBudget(uint64_t bytes);
+KATANA_EXPORT uint64_t GetMemoryBudget();
+
+/// \returns the bytes in use by \param subsystem
+KATANA_EXPORT uint64_t GetMemoryUsage(MemorySubsystem subsystem);
+
+/// \returns the bytes in use by all subsystems
+KATANA_EXPORT uint64_t GetMemoryUsage();
+
+/// \returns the usage of each subsystem, e.g., for error messages
+KATANA_EXPORT std::string MemoryUsageSummary();
+
+/// Account for \param bytes allocated by \param subsystem. Arrow memory is
+/// read from the Arrow memory pool and need not be charged.
+KATANA_EXPORT void ChargeMemory(MemorySubsystem subsystem, uint64_t bytes);
+
+/// Account for \param bytes charged to \param subsystem being freed
+KATANA_EXPORT void ReleaseMemory(MemorySubsystem subsystem, uint64_t bytes);
+
+/// Make room for \param bytes in the budget (see MakeMemoryAvailable) and
+/// charge them to \param subsystem
+KATANA_EXPORT Result<void> ReserveMemory(
+    MemorySubsystem subsystem, uint64_t bytes);
+
+/// Run memory reclaimers until \param bytes more fit in the budget.
+/// \returns ErrorCode::OutOfMemory if they do not. Concurrent calls may
+/// together exceed the budget.
+KATANA_EXPORT Result<void> MakeMemoryAvailable(uint64_t bytes);
+
+/// A MemoryReclaimer is asked to free at least the given number of bytes,
+/// e.g., by evicting what can be read again from storage. It is called on
+/// whichever thread is short of memory, which may hold locks of the caller
+/// of ReserveMemory, so it should only try to take its own locks and give up
+/// if they are held. It must not block on other reclaimers.
+using MemoryReclaimer = std::function<void(uint64_t bytes)>;
+
+/// Register \param reclaimer; reclaimers run in the order they were added.
+/// \returns an id for RemoveMemoryReclaimer
+KATANA_EXPORT uint64_t AddMemoryReclaimer(MemoryReclaimer reclaimer);
+
+/// Unregister a reclaimer, waiting for it if it is running
+KATANA_EXPORT void RemoveMemoryReclaimer(uint64_t id);
+
+/// \returns an Arrow memory pool that allocates from the default pool (see
+/// SetArrowMemoryPool) but first makes room for each allocation in the memory
+/// budget, failing with arrow::Status::OutOfMemory if there is none. Loads
+/// from storage read into it so that loads that do not fit are refused
+/// instead of exhausting the memory of the machine.
+KATANA_EXPORT arrow::MemoryPool* BudgetedMemoryPool();
+
+/// Make BudgetedMemoryPool allocate from \param pool instead of the default
+/// Arrow pool, e.g., to place buffers on NUMA nodes (see
+/// katana::NumaMemoryPool). Buffers are returned to the pool in use when they
+/// are freed, so \param pool must pass buffers it did not allocate on to the
+/// pool it replaces, and it must live until the end of the process.
+KATANA_EXPORT void SetArrowMemoryPool(arrow::MemoryPool* pool);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend over MPI_COMM_WORLD. Only built when KATANA_ENABLE_MPI is
+/// set.
+///
+/// MPI is initialized by the constructor unless the application already did
+/// so, in which case the application must also finalize it.
+class KATANA_EXPORT MpiCommBackend : public CommBackend {
+public:
+  MpiCommBackend();
+  ~MpiCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  /// Abort all tasks with MPI_Abort
+  void NotifyFailure() override;
+  Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> outgoing) override;
+
+protected:
+  /// Point-to-point messages between the buffers of every pair of tasks
+  Result<Buffers> DoAllToAllv(const Buffers& outgoing) override;
+  /// MPI_Allgatherv into one buffer that the results are slices of
+  Result<Buffers> DoAllGather(
+      const std::shared_ptr<arrow::Buffer>& buffer) override;
+  /// MPI_Allreduce
+  Result<std::shared_ptr<arrow::Buffer>> DoAllReduce(
+      const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+      ReduceOp op) override;
+
+private:
+  bool initialized_mpi_{false};
+};
+
+}  // namespace katana
+
+#endif
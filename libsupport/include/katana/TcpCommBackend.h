@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend whose tasks talk over TCP, with one connection between each
+/// pair of tasks.
+///
+/// Each task first calls Listen and then Connect with the addresses of all
+/// tasks in order of their IDs. Addresses are of the form host:port.
+///
+/// Barrier and Broadcast cannot report errors, so they abort if a connection
+/// fails.
+class KATANA_EXPORT TcpCommBackend : public CommBackend {
+public:
+  /// Listen for the connections of other tasks at address. If its port is 0,
+  /// a free port is chosen; see address().
+  static Result<std::unique_ptr<TcpCommBackend>> Listen(
+      const std::string& address);
+
+  ~TcpCommBackend() override;
+
+  /// Connect to the other tasks, becoming task id of addresses.size(). Tasks
+  /// that have not started listening yet are retried until timeout.
+  Result<void> Connect(
+      const std::vector<std::string>& addresses, uint32_t id,
+      std::chrono::milliseconds timeout = std::chrono::seconds(60));
+
+  /// The address this task listens at
+  const std::string& address() const { return address_; }
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  /// Shut down all connections, so that operations of the other tasks fail
+  void NotifyFailure() override;
+  Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> outgoing) override;
+
+protected:
+  /// Exchange buffers with every peer at once over the connections; AllGather
+  /// and AllReduce are built on it
+  Result<Buffers> DoAllToAllv(const Buffers& outgoing) override;
+
+private:
+  TcpCommBackend(int listen_fd, std::string address)
+      : listen_fd_(listen_fd), address_(std::move(address)) {}
+
+  int listen_fd_;
+  std::string address_;
+  /// Socket connected to each task, or -1 for this task
+  std::vector<int> peers_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TRACE_H_
+#define KATANA_LIBSUPPORT_KATANA_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Record a timeline of what each thread does and write it to path as a
+/// Chrome trace, the JSON format that chrome://tracing and Perfetto load. An
+/// empty path turns tracing off.
+///
+/// While tracing is on, each thread records the begin and end of every
+/// TraceSpan it runs into a ring buffer of its own, which keeps the most
+/// recent KATANA_TRACE_EVENTS (default 65536) events of the thread, so the
+/// cost of an event is two clock reads and an uncontended lock. The library
+/// records the share of each thread in named parallel loops, barrier waits,
+/// termination detection and waits for storage I/O, so load imbalance and
+/// stalls show up as gaps and long waits on the timeline.
+///
+/// The trace is written by WriteTrace, when the trace file changes and when
+/// the program exits. Tracing is initially configured from the environment
+/// variable KATANA_TRACE.
+KATANA_EXPORT void SetTraceFile(const std::string& path);
+
+/// Write the events in the ring buffers to the trace file, replacing what it
+/// held. Threads may record events while the trace is written.
+KATANA_EXPORT Result<void> WriteTrace();
+
+/// Name the calling thread in traces; threads are otherwise numbered in the
+/// order in which they first record an event.
+KATANA_EXPORT void SetTraceThreadName(const std::string& name);
+
+namespace internal {
+
+KATANA_EXPORT extern std::atomic<bool> trace_enabled;
+
+/// name and category must outlive the trace, e.g., string literals
+KATANA_EXPORT void RecordTraceEvent(
+    const char* name, const char* category, uint64_t begin_ns,
+    uint64_t end_ns);
+
+inline uint64_t
+TraceNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace internal
+
+/// Return true if events are being recorded.
+inline bool
+IsTraceEnabled() {
+  return internal::trace_enabled.load(std::memory_order_relaxed);
+}
+
+/// TraceSpan records an event on the timeline of the calling thread from its
+/// construction to its destruction, if tracing is on when it is constructed.
+/// A null name records nothing. name and category must outlive the trace,
+/// e.g., string literals.
+///
+///   {
+///     katana::TraceSpan span("Flush", "io");
+///     Flush();
+///   }
+class TraceSpan {
+  const char* name_{};
+  const char* category_{};
+  uint64_t begin_ns_{};
+
+public:
+  TraceSpan(const char* name, const char* category) {
+    if (name && IsTraceEnabled()) {
+      name_ = name;
+      category_ = category;
+      begin_ns_ = internal::TraceNowNs();
+    }
+  }
+
+  ~TraceSpan() {
+    if (name_) {
+      internal::RecordTraceEvent(
+          name_, category_, begin_ns_, internal::TraceNowNs());
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+  TraceSpan(TraceSpan&&) = delete;
+  TraceSpan& operator=(TraceSpan&&) = delete;
+};
+
+/// TraceInterval records the intervals between Begin and End on the
+/// timeline of the calling thread, e.g., the stretches in which a thread
+/// polls for work and finds none, without an event for every poll. Begin
+/// while an interval is open and End while none is open do nothing; an open
+/// interval ends at destruction.
+class TraceInterval {
+  const char* name_;
+  const char* category_;
+  uint64_t begin_ns_{};
+  bool open_{};
+
+public:
+  TraceInterval(const char* name, const char* category)
+      : name_(name), category_(category) {}
+
+  ~TraceInterval() { End(); }
+
+  void Begin() {
+    if (!open_ && IsTraceEnabled()) {
+      open_ = true;
+      begin_ns_ = internal::TraceNowNs();
+    }
+  }
+
+  void End() {
+    if (open_) {
+      open_ = false;
+      internal::RecordTraceEvent(
+          name_, category_, begin_ns_, internal::TraceNowNs());
+    }
+  }
+
+  TraceInterval(const TraceInterval&) = delete;
+  TraceInterval& operator=(const TraceInterval&) = delete;
+  TraceInterval(TraceInterval&&) = delete;
+  TraceInterval& operator=(TraceInterval&&) = delete;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,10 +1,108 @@
 #include "katana/ArrowInterchange.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <numeric>
 
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
 #include "katana/Random.h"
 
 namespace {
+
+/// Identifies shared table segments, "KTSHTBL1" in little endian
+constexpr uint64_t kSharedTablesMagic = UINT64_C(0x314c424854485354);
+/// Streams start at multiples of this so that their buffers keep the
+/// alignment Arrow writes them with
+constexpr uint64_t kSharedTablesAlignment = 64;
+
+/// The start of a shared table segment. It is followed by the extent of
+/// each table's stream.
+struct SharedTablesHeader {
+  uint64_t magic;
+  uint64_t num_tables;
+};
+
+struct SharedTableExtent {
+  uint64_t offset;
+  uint64_t size;
+};
+
+uint64_t
+AlignShared(uint64_t n) {
+  return (n + kSharedTablesAlignment - 1) / kSharedTablesAlignment *
+         kSharedTablesAlignment;
+}
+
+/// A read-only shared mapping as a buffer that unmaps it when destroyed
+class SharedMappingBuffer : public arrow::Buffer {
+public:
+  SharedMappingBuffer(const void* ptr, size_t size)
+      : arrow::Buffer(
+            static_cast<const uint8_t*>(ptr), static_cast<int64_t>(size)) {}
+
+  ~SharedMappingBuffer() override {
+    if (munmap(const_cast<uint8_t*>(data_), size_) != 0) {
+      KATANA_LOG_ERROR(
+          "unmapping shared tables: {}", katana::ResultErrno().message());
+    }
+  }
+};
+
+/// Write table as an IPC stream to out
+katana::Result<void>
+WriteStream(const arrow::Table& table, arrow::io::OutputStream* out) {
+  auto writer_res = arrow::ipc::MakeStreamWriter(out, table.schema());
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "making stream writer: {}",
+        writer_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      writer_res.ValueOrDie();
+  if (auto status = writer->WriteTable(table); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "writing table: {}", status);
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "closing stream: {}", status);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadStream(const std::shared_ptr<arrow::Buffer>& stream) {
+  arrow::io::BufferReader input(stream);
+  auto reader_res = arrow::ipc::RecordBatchStreamReader::Open(&input);
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "opening stream: {}",
+        reader_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchStreamReader> reader =
+      reader_res.ValueOrDie();
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  if (auto status = reader->ReadAll(&batches); !status.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "reading stream: {}", status);
+  }
+  auto table_res = arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!table_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "making table: {}",
+        table_res.status());
+  }
+  return table_res.ValueOrDie();
+}
+
 std::shared_ptr<arrow::ChunkedArray>
 IndexedTake(
     const std::shared_ptr<arrow::ChunkedArray>& original,
@@ -70,3 +168,187 @@ katana::EmptyChunkedArray(
   std::vector<std::shared_ptr<arrow::Array>> chunks{maybe_array.ValueOrDie()};
   return std::make_shared<arrow::ChunkedArray>(chunks);
 }
+
+std::shared_ptr<arrow::ArrayData>
+katana::ShareReadOnly(const std::shared_ptr<arrow::ArrayData>& original) {
+  std::shared_ptr<arrow::ArrayData> shared = original->Copy();
+  for (auto& buffer : shared->buffers) {
+    if (buffer && buffer->is_mutable()) {
+      buffer = arrow::SliceBuffer(buffer, 0, buffer->size());
+    }
+  }
+  for (auto& child : shared->child_data) {
+    child = ShareReadOnly(child);
+  }
+  return shared;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::ShareReadOnly(const std::shared_ptr<arrow::ChunkedArray>& original) {
+  arrow::ArrayVector chunks;
+  for (const auto& chunk : original->chunks()) {
+    chunks.emplace_back(arrow::MakeArray(ShareReadOnly(chunk->data())));
+  }
+  return std::make_shared<arrow::ChunkedArray>(
+      std::move(chunks), original->type());
+}
+
+bool
+katana::IsMutable(const arrow::ArrayData& data) {
+  for (const auto& buffer : data.buffers) {
+    if (buffer && !buffer->is_mutable()) {
+      return false;
+    }
+  }
+  for (const auto& child : data.child_data) {
+    if (!IsMutable(*child)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+katana::Result<void>
+katana::PublishSharedTables(
+    const std::string& name,
+    const std::vector<std::shared_ptr<arrow::Table>>& tables) {
+  // Size the streams first so that they can be written straight into the
+  // shared mapping
+  std::vector<SharedTableExtent> extents(tables.size());
+  uint64_t size = AlignShared(
+      sizeof(SharedTablesHeader) + tables.size() * sizeof(SharedTableExtent));
+  for (size_t i = 0; i < tables.size(); ++i) {
+    arrow::io::MockOutputStream counter;
+    if (auto res = WriteStream(*tables[i], &counter); !res) {
+      return res.error().WithContext("sizing table {}", i);
+    }
+    extents[i] = SharedTableExtent{
+        .offset = size,
+        .size = static_cast<uint64_t>(counter.GetExtentBytesWritten()),
+    };
+    size = AlignShared(size + extents[i].size);
+  }
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    if (errno == EEXIST) {
+      return KATANA_ERROR(
+          ErrorCode::AlreadyExists, "shared tables {} already exist", name);
+    }
+    return KATANA_ERROR(ResultErrno(), "creating shared tables {}", name);
+  }
+  if (ftruncate(fd, size) != 0) {
+    auto error = KATANA_ERROR(ResultErrno(), "sizing shared tables {}", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return error;
+  }
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    auto error = KATANA_ERROR(ResultErrno(), "mapping shared tables {}", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return error;
+  }
+  close(fd);
+
+  auto* base = static_cast<uint8_t*>(ptr);
+  SharedTablesHeader header{
+      .magic = kSharedTablesMagic, .num_tables = tables.size()};
+  std::memcpy(base, &header, sizeof(header));
+  std::memcpy(
+      base + sizeof(header), extents.data(),
+      extents.size() * sizeof(SharedTableExtent));
+  for (size_t i = 0; i < tables.size(); ++i) {
+    auto out = std::make_shared<arrow::MutableBuffer>(
+        base + extents[i].offset, extents[i].size);
+    arrow::io::FixedSizeBufferWriter writer(out);
+    if (auto res = WriteStream(*tables[i], &writer); !res) {
+      munmap(ptr, size);
+      shm_unlink(name.c_str());
+      return res.error().WithContext("writing table {}", i);
+    }
+  }
+
+  if (munmap(ptr, size) != 0) {
+    auto error =
+        KATANA_ERROR(ResultErrno(), "unmapping shared tables {}", name);
+    shm_unlink(name.c_str());
+    return error;
+  }
+  return ResultSuccess();
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Table>>>
+katana::MapSharedTables(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "no shared tables named {}", name);
+    }
+    return KATANA_ERROR(ResultErrno(), "opening shared tables {}", name);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto error = KATANA_ERROR(ResultErrno(), "sizing shared tables {}", name);
+    close(fd);
+    return error;
+  }
+  auto size = static_cast<uint64_t>(st.st_size);
+  if (size < sizeof(SharedTablesHeader)) {
+    close(fd);
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} is not a shared table segment", name);
+  }
+  void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    auto error = KATANA_ERROR(ResultErrno(), "mapping shared tables {}", name);
+    close(fd);
+    return error;
+  }
+  close(fd);
+  auto mapping = std::make_shared<SharedMappingBuffer>(ptr, size);
+
+  SharedTablesHeader header;
+  std::memcpy(&header, mapping->data(), sizeof(header));
+  if (header.magic != kSharedTablesMagic ||
+      header.num_tables >
+          (size - sizeof(header)) / sizeof(SharedTableExtent)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} is not a shared table segment", name);
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (uint64_t i = 0; i < header.num_tables; ++i) {
+    SharedTableExtent extent;
+    std::memcpy(
+        &extent, mapping->data() + sizeof(header) + i * sizeof(extent),
+        sizeof(extent));
+    if (extent.offset > size || extent.size > size - extent.offset) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "table {} of {} is out of bounds", i,
+          name);
+    }
+    // Slices keep the mapping alive
+    auto table_res =
+        ReadStream(arrow::SliceBuffer(mapping, extent.offset, extent.size));
+    if (!table_res) {
+      return table_res.error().WithContext("reading table {} of {}", i, name);
+    }
+    tables.emplace_back(std::move(table_res.value()));
+  }
+  return tables;
+}
+
+katana::Result<void>
+katana::UnlinkSharedTables(const std::string& name) {
+  if (shm_unlink(name.c_str()) != 0) {
+    if (errno == ENOENT) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "no shared tables named {}", name);
+    }
+    return KATANA_ERROR(ResultErrno(), "unlinking shared tables {}", name);
+  }
+  return ResultSuccess();
+}
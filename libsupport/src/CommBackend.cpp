@@ -1,8 +1,228 @@
 #include "katana/CommBackend.h"
 
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+uint64_t
+TotalSize(const katana::CommBackend::Buffers& buffers) {
+  uint64_t total = 0;
+  for (const auto& buffer : buffers) {
+    total += buffer->size();
+  }
+  return total;
+}
+
+template <typename T>
+void
+Reduce(T* acc, const T* other, size_t num, katana::ReduceOp op) {
+  switch (op) {
+  case katana::ReduceOp::kSum:
+    for (size_t i = 0; i < num; ++i) {
+      acc[i] += other[i];
+    }
+    return;
+  case katana::ReduceOp::kMin:
+    for (size_t i = 0; i < num; ++i) {
+      acc[i] = std::min(acc[i], other[i]);
+    }
+    return;
+  case katana::ReduceOp::kMax:
+    for (size_t i = 0; i < num; ++i) {
+      acc[i] = std::max(acc[i], other[i]);
+    }
+    return;
+  }
+}
+
+template <typename T>
+void
+ReduceAll(
+    const katana::CommBackend::Buffers& buffers, katana::ReduceOp op,
+    arrow::Buffer* out) {
+  auto* acc = reinterpret_cast<T*>(out->mutable_data());
+  size_t num = out->size() / sizeof(T);
+  std::copy_n(reinterpret_cast<const T*>(buffers[0]->data()), num, acc);
+  for (size_t i = 1; i < buffers.size(); ++i) {
+    Reduce(acc, reinterpret_cast<const T*>(buffers[i]->data()), num, op);
+  }
+}
+
+/// Counts a call of a collective and the time until it goes out of scope
+class CollectiveTimer {
+public:
+  explicit CollectiveTimer(katana::CollectiveStats* stats)
+      : stats_(stats), start_(std::chrono::steady_clock::now()) {
+    ++stats_->calls;
+  }
+  ~CollectiveTimer() {
+    stats_->time += std::chrono::steady_clock::now() - start_;
+  }
+
+  CollectiveTimer(const CollectiveTimer&) = delete;
+  CollectiveTimer& operator=(const CollectiveTimer&) = delete;
+
+private:
+  katana::CollectiveStats* stats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace
+
+size_t
+katana::CommDataTypeSize(CommDataType type) {
+  switch (type) {
+  case CommDataType::kInt32:
+  case CommDataType::kUInt32:
+  case CommDataType::kFloat:
+    return 4;
+  case CommDataType::kInt64:
+  case CommDataType::kUInt64:
+  case CommDataType::kDouble:
+    return 8;
+  }
+  KATANA_LOG_FATAL("unknown CommDataType");
+}
+
 // Anchor vtables
 
 katana::CommBackend::~CommBackend() = default;
 
+katana::Result<std::vector<std::string>>
+katana::CommBackend::AllToAll(std::vector<std::string> outgoing) {
+  if (outgoing.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} messages found {}", Num,
+        outgoing.size());
+  }
+  if (Num != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "AllToAll between {} tasks", Num);
+  }
+  return outgoing;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::CommBackend::AllToAllv(const Buffers& outgoing) {
+  if (outgoing.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} buffers found {}", Num,
+        outgoing.size());
+  }
+  auto& stats = stats_[static_cast<size_t>(Collective::kAllToAllv)];
+  CollectiveTimer timer(&stats);
+  auto res = DoAllToAllv(outgoing);
+  if (res) {
+    stats.bytes_sent += TotalSize(outgoing) - outgoing[ID]->size();
+    stats.bytes_received += TotalSize(res.value()) - res.value()[ID]->size();
+  }
+  return res;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::CommBackend::AllGather(const std::shared_ptr<arrow::Buffer>& buffer) {
+  auto& stats = stats_[static_cast<size_t>(Collective::kAllGather)];
+  CollectiveTimer timer(&stats);
+  auto res = DoAllGather(buffer);
+  if (res) {
+    stats.bytes_sent += buffer->size() * (Num - 1);
+    stats.bytes_received += TotalSize(res.value()) - buffer->size();
+  }
+  return res;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::CommBackend::AllReduce(
+    const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+    ReduceOp op) {
+  if (values->size() % CommDataTypeSize(type) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "buffer of {} bytes is not a whole number of elements",
+        values->size());
+  }
+  auto& stats = stats_[static_cast<size_t>(Collective::kAllReduce)];
+  CollectiveTimer timer(&stats);
+  auto res = DoAllReduce(values, type, op);
+  if (res) {
+    stats.bytes_sent += values->size() * (Num - 1);
+    stats.bytes_received += values->size() * (Num - 1);
+  }
+  return res;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::CommBackend::AllocateBuffer(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating {} bytes: {}", size, res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::CommBackend::DoAllToAllv(const Buffers& outgoing) {
+  if (Num != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "AllToAllv between {} tasks", Num);
+  }
+  return outgoing;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::CommBackend::DoAllGather(const std::shared_ptr<arrow::Buffer>& buffer) {
+  // Only the pointers are repeated; every task is sent the same bytes
+  return DoAllToAllv(Buffers(Num, buffer));
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::CommBackend::DoAllReduce(
+    const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+    ReduceOp op) {
+  auto gathered_res = DoAllGather(values);
+  if (!gathered_res) {
+    return gathered_res.error();
+  }
+  const Buffers& gathered = gathered_res.value();
+  for (const auto& buffer : gathered) {
+    if (buffer->size() != values->size()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "AllReduce of {} bytes with a task that has {}", values->size(),
+          buffer->size());
+    }
+  }
+
+  auto out_res = AllocateBuffer(values->size());
+  if (!out_res) {
+    return out_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> out = std::move(out_res.value());
+  switch (type) {
+  case CommDataType::kInt32:
+    ReduceAll<int32_t>(gathered, op, out.get());
+    break;
+  case CommDataType::kUInt32:
+    ReduceAll<uint32_t>(gathered, op, out.get());
+    break;
+  case CommDataType::kInt64:
+    ReduceAll<int64_t>(gathered, op, out.get());
+    break;
+  case CommDataType::kUInt64:
+    ReduceAll<uint64_t>(gathered, op, out.get());
+    break;
+  case CommDataType::kFloat:
+    ReduceAll<float>(gathered, op, out.get());
+    break;
+  case CommDataType::kDouble:
+    ReduceAll<double>(gathered, op, out.get());
+    break;
+  }
+  return out;
+}
+
 void
 katana::NullCommBackend::NotifyFailure() {}
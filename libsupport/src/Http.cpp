@@ -1,16 +1,188 @@
 #include "katana/Http.h"
 
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 #include <curl/curl.h>
 
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 
 namespace {
 
+constexpr long kDefaultMaxHostConnections = 8;
+/// Connections kept open for later requests, across all hosts
+constexpr long kMaxCachedConnections = 64;
+constexpr int kPollTimeoutMs = 1000;
+
+/// HttpClient performs the requests of every thread on one curl multi
+/// handle, so that they share its cache of open connections. A request to
+/// a host that was talked to recently reuses a connection instead of paying
+/// for TCP and TLS setup again, and concurrent requests to a host that
+/// speaks HTTP/2 are multiplexed on one connection. Each host gets at most
+/// KATANA_HTTP_MAX_HOST_CONNECTIONS connections (default 8); requests beyond
+/// that wait for one to be free.
+class HttpClient {
+  struct Transfer {
+    CURL* handle;
+    CURLcode result{CURLE_OK};
+    bool done{false};
+  };
+
+  CURLM* multi_{};
+  /// A pipe written to wake the thread driving multi_ from curl_multi_poll
+  int wake_fds_[2]{-1, -1};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Transfer*> pending_;
+  bool stopping_{false};
+  std::thread thread_;
+
+  HttpClient() {
+    if (pipe2(wake_fds_, O_NONBLOCK | O_CLOEXEC) != 0) {
+      KATANA_LOG_WARN("not pooling HTTP connections: pipe failed");
+      return;
+    }
+    multi_ = curl_multi_init();
+    if (multi_ == nullptr) {
+      KATANA_LOG_WARN("not pooling HTTP connections: curl_multi_init failed");
+      return;
+    }
+    long max_host_connections = kDefaultMaxHostConnections;
+    if (int value{};
+        katana::GetEnv("KATANA_HTTP_MAX_HOST_CONNECTIONS", &value) &&
+        value > 0) {
+      max_host_connections = value;
+    }
+    curl_multi_setopt(
+        multi_, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+    curl_multi_setopt(
+        multi_, CURLMOPT_MAX_HOST_CONNECTIONS, max_host_connections);
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, kMaxCachedConnections);
+    thread_ = std::thread([this] { Run(); });
+  }
+
+  void Wake() {
+    char byte = 0;
+    if (write(wake_fds_[1], &byte, 1) < 0 && errno != EAGAIN) {
+      KATANA_LOG_WARN("waking HTTP client: {}", std::strerror(errno));
+    }
+  }
+
+  /// Drive the transfers of multi_ until the client is destroyed
+  void Run() {
+    int running = 0;
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+          return;
+        }
+        for (Transfer* transfer : pending_) {
+          curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, transfer);
+          if (curl_multi_add_handle(multi_, transfer->handle) != CURLM_OK) {
+            transfer->result = CURLE_FAILED_INIT;
+            transfer->done = true;
+          }
+        }
+        pending_.clear();
+      }
+      cv_.notify_all();
+
+      curl_multi_perform(multi_, &running);
+      int left = 0;
+      while (CURLMsg* msg = curl_multi_info_read(multi_, &left)) {
+        if (msg->msg != CURLMSG_DONE) {
+          continue;
+        }
+        CURL* handle = msg->easy_handle;
+        CURLcode result = msg->data.result;
+        Transfer* transfer{};
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &transfer);
+        curl_multi_remove_handle(multi_, handle);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          transfer->result = result;
+          transfer->done = true;
+        }
+        cv_.notify_all();
+      }
+
+      curl_waitfd wake{wake_fds_[0], CURL_WAIT_POLLIN, 0};
+      curl_multi_poll(multi_, &wake, 1, kPollTimeoutMs, nullptr);
+      if (wake.revents != 0) {
+        char bytes[64];
+        while (read(wake_fds_[0], bytes, sizeof(bytes)) > 0) {
+        }
+      }
+    }
+  }
+
+public:
+  HttpClient(const HttpClient& no_copy) = delete;
+  HttpClient& operator=(const HttpClient& no_copy) = delete;
+
+  ~HttpClient() {
+    if (thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      Wake();
+      thread_.join();
+    }
+    if (multi_ != nullptr) {
+      curl_multi_cleanup(multi_);
+    }
+    for (int fd : wake_fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  static HttpClient& Get() {
+    static HttpClient client;
+    return client;
+  }
+
+  /// Perform the request of handle and wait for it to finish
+  CURLcode Perform(CURL* handle) {
+    if (multi_ == nullptr) {
+      return curl_easy_perform(handle);
+    }
+    Transfer transfer{handle};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.emplace_back(&transfer);
+    }
+    Wake();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&transfer] { return transfer.done; });
+    return transfer.result;
+  }
+};
+
 class CurlHandle {
   CURL* handle_{};
   struct curl_slist* headers_{};
+  /// False for the handles kept by each thread, see Reuse. Owned handles
+  /// are performed by the HttpClient.
+  bool owned_{true};
 
   CurlHandle(CURL* handle) : handle_(handle) {}
 
@@ -29,10 +201,12 @@ public:
   CurlHandle(CurlHandle&& other) noexcept {
     std::swap(handle_, other.handle_);
     std::swap(headers_, other.headers_);
+    std::swap(owned_, other.owned_);
   }
   CurlHandle& operator=(CurlHandle&& other) noexcept {
     std::swap(handle_, other.handle_);
     std::swap(headers_, other.headers_);
+    std::swap(owned_, other.owned_);
     return *this;
   }
 
@@ -53,6 +227,32 @@ public:
         !res) {
       return res.error();
     }
+    // Wait for a connection that can multiplex rather than open another one
+    if (auto res = handle.SetOpt(CURLOPT_PIPEWAIT, 1L); !res) {
+      return res.error();
+    }
+    return CurlHandle(std::move(handle));
+  }
+
+  /// Borrow the handle of this thread. Its options are reset, but it keeps
+  /// its open connections, so requests to a server it has talked to before
+  /// skip connecting.
+  static katana::Result<CurlHandle> Reuse(const std::string& url) {
+    thread_local std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> cached(
+        nullptr, curl_easy_cleanup);
+    if (cached) {
+      curl_easy_reset(cached.get());
+    } else {
+      cached.reset(curl_easy_init());
+      if (!cached) {
+        return katana::ErrorCode::HttpError;
+      }
+    }
+    CurlHandle handle(cached.get());
+    handle.owned_ = false;
+    if (auto res = handle.SetOpt(CURLOPT_URL, url.c_str()); !res) {
+      return res.error();
+    }
     return CurlHandle(std::move(handle));
   }
 
@@ -61,7 +261,7 @@ public:
     if (headers_ != nullptr) {
       curl_slist_free_all(headers_);
     }
-    if (handle_ != nullptr) {
+    if (handle_ != nullptr && owned_) {
       curl_easy_cleanup(handle_);
     }
   }
@@ -85,7 +285,10 @@ public:
         return res.error();
       }
     }
-    CURLcode request_res = curl_easy_perform(handle_);
+    // A thread's own handle keeps its own connections; the others share
+    // those of the HttpClient
+    CURLcode request_res = owned_ ? HttpClient::Get().Perform(handle_)
+                                  : curl_easy_perform(handle_);
     if (request_res != CURLE_OK) {
       KATANA_LOG_ERROR("CURL error: {}", curl_easy_strerror(request_res));
       return katana::ErrorCode::HttpError;
@@ -95,6 +298,7 @@ public:
     curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &response_code);
     switch (response_code) {
     case 200:
+    case 206:
       return katana::ResultSuccess();
     case 404:
       return katana::ErrorCode::NotFound;
@@ -110,6 +314,51 @@ public:
   }
 };
 
+/// Where HttpGetRange writes the body of its response
+struct RangeSink {
+  CURL* handle;
+  uint64_t begin;
+  uint8_t* buffer;
+  uint64_t size;
+  uint64_t received;
+};
+
+size_t
+WriteDataToRangeCB(char* ptr, size_t size, size_t nmemb, void* user_data) {
+  size_t real_size = size * nmemb;
+  auto* sink = static_cast<RangeSink*>(user_data);
+  if (sink->received == 0 && sink->begin != 0) {
+    // A server that does not support ranges sends the whole resource
+    int64_t response_code{};
+    curl_easy_getinfo(sink->handle, CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code == 200) {
+      return 0;
+    }
+  }
+  uint64_t copied = std::min<uint64_t>(real_size, sink->size - sink->received);
+  std::memcpy(sink->buffer + sink->received, ptr, copied);
+  sink->received += copied;
+  return real_size;
+}
+
+size_t
+FindETagCB(char* ptr, size_t size, size_t nitems, void* user_data) {
+  size_t real_size = size * nitems;
+  constexpr std::string_view kName = "etag:";
+  std::string_view line(ptr, real_size);
+  if (line.size() > kName.size() &&
+      strncasecmp(line.data(), kName.data(), kName.size()) == 0) {
+    line.remove_prefix(kName.size());
+    size_t first = line.find_first_not_of(" \t");
+    size_t last = line.find_last_not_of(" \t\r\n");
+    if (first != std::string_view::npos) {
+      *static_cast<std::string*>(user_data) =
+          std::string(line.substr(first, last - first + 1));
+    }
+  }
+  return real_size;
+}
+
 katana::Result<void>
 HttpUploadCommon(CurlHandle&& holder, const std::string& data) {
   if (auto res = holder.SetOpt(CURLOPT_POSTFIELDS, data.c_str()); !res) {
@@ -143,6 +392,83 @@ katana::HttpGet(const std::string& url, std::vector<char>* response) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::HttpGetRange(
+    const std::string& url, uint64_t begin, uint64_t size, uint8_t* buffer,
+    uint64_t* received) {
+  *received = 0;
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  auto curl_res = CurlHandle::Reuse(url);
+  if (!curl_res) {
+    return curl_res.error();
+  }
+  CurlHandle curl(std::move(curl_res.value()));
+
+  RangeSink sink{curl.handle(), begin, buffer, size, 0};
+  std::string range = fmt::format("{}-{}", begin, begin + size - 1);
+  if (auto res = curl.SetOpt(CURLOPT_RANGE, range.c_str()); !res) {
+    return res.error();
+  }
+  if (auto res = curl.SetOpt(CURLOPT_WRITEDATA, &sink); !res) {
+    return res.error();
+  }
+  if (auto res = curl.SetOpt(CURLOPT_WRITEFUNCTION, WriteDataToRangeCB);
+      !res) {
+    return res.error();
+  }
+  if (auto res = curl.Perform(); !res) {
+    KATANA_LOG_DEBUG("GET of range {} failed for url: {}", range, url);
+    return res;
+  }
+  *received = sink.received;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::HttpHead(
+    const std::string& url, uint64_t* size, std::string* version) {
+  std::vector<char> no_body;
+  auto curl_res = CurlHandle::Make(url, &no_body);
+  if (!curl_res) {
+    return curl_res.error();
+  }
+  CurlHandle curl(std::move(curl_res.value()));
+
+  std::string etag;
+  if (auto res = curl.SetOpt(CURLOPT_NOBODY, 1L); !res) {
+    return res.error();
+  }
+  if (auto res = curl.SetOpt(CURLOPT_FILETIME, 1L); !res) {
+    return res.error();
+  }
+  if (auto res = curl.SetOpt(CURLOPT_HEADERDATA, &etag); !res) {
+    return res.error();
+  }
+  if (auto res = curl.SetOpt(CURLOPT_HEADERFUNCTION, FindETagCB); !res) {
+    return res.error();
+  }
+  if (auto res = curl.Perform(); !res) {
+    KATANA_LOG_DEBUG("HEAD failed for url: {}", url);
+    return res;
+  }
+
+  curl_off_t length = -1;
+  curl_easy_getinfo(curl.handle(), CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+  if (length < 0) {
+    return KATANA_ERROR(ErrorCode::HttpError, "no content length: {}", url);
+  }
+  *size = length;
+  if (etag.empty()) {
+    curl_off_t filetime = -1;
+    curl_easy_getinfo(curl.handle(), CURLINFO_FILETIME_T, &filetime);
+    etag = std::to_string(filetime);
+  }
+  *version = std::move(etag);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::HttpPost(
     const std::string& url, const std::string& data,
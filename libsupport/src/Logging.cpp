@@ -1,55 +1,377 @@
 #include "katana/Logging.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
 
 #include "katana/Env.h"
 
 namespace {
 
-void
-PrintString(
-    bool error, bool flush, const std::string& prefix, const std::string& s) {
-  static std::mutex lock;
-  std::lock_guard<std::mutex> lg(lock);
+/// The number of messages each thread can queue for the background writer
+constexpr uint64_t kRingCapacity = 4096;
+
+/// How often the background writer writes queued messages
+constexpr std::chrono::milliseconds kFlushInterval{10};
+
+constexpr uint64_t kNsPerSecond = 1000000000;
+
+struct Record {
+  katana::LogLevel level;
+  uint64_t time_ns;
+  uint32_t thread;
+  // Null for messages without source code information
+  const char* file;
+  int line;
+  std::string message;
+};
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+const char*
+LevelName(katana::LogLevel level) {
+  switch (level) {
+  case katana::LogLevel::Debug:
+    return "DEBUG";
+  case katana::LogLevel::Verbose:
+    return "VERBOSE";
+  case katana::LogLevel::Warning:
+    return "WARNING";
+  case katana::LogLevel::Error:
+    return "ERROR";
+  default:
+    return "UNKNOWN LOG LEVEL";
+  }
+}
+
+/// ThreadLog holds the state of one thread that logs. Its records form a
+/// ring buffer with a single producer, the thread, and a single consumer,
+/// whoever holds Logger::write_mutex_.
+struct ThreadLog {
+  explicit ThreadLog(uint32_t t) : thread(t), records(kRingCapacity) {}
+
+  const uint32_t thread;
+  std::vector<Record> records;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+
+  // The rate limiting window; only used by the thread
+  uint64_t window_start_ns{0};
+  uint32_t window_count{0};
 
-  std::ostream& o = error ? std::cerr : std::cout;
-  if (!prefix.empty()) {
-    o << prefix << ": ";
+  /// Return true if a message at time now_ns is within the rate limit
+  bool Admit(uint64_t now_ns, uint32_t limit) {
+    if (limit == 0) {
+      return true;
+    }
+    if (now_ns - window_start_ns >= kNsPerSecond) {
+      window_start_ns = now_ns;
+      window_count = 0;
+    }
+    if (window_count >= limit) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    ++window_count;
+    return true;
   }
-  o << s << "\n";
-  if (flush) {
-    o.flush();
+
+  void Push(Record&& record) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= kRingCapacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    records[h % kRingCapacity] = std::move(record);
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  /// Move the queued records to out along with a record of the number of
+  /// messages dropped since the last call, if any
+  void Drain(std::vector<Record>* out) {
+    uint64_t h = head.load(std::memory_order_acquire);
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    for (; t < h; ++t) {
+      out->emplace_back(std::move(records[t % kRingCapacity]));
+    }
+    tail.store(h, std::memory_order_release);
+    DrainDropped(out);
+  }
+
+  void DrainDropped(std::vector<Record>* out) {
+    if (uint64_t n = dropped.exchange(0, std::memory_order_relaxed); n > 0) {
+      out->emplace_back(Record{
+          .level = katana::LogLevel::Warning,
+          .time_ns = NowNs(),
+          .thread = thread,
+          .file = nullptr,
+          .line = 0,
+          .message = fmt::format("dropped {} log messages", n),
+      });
+    }
   }
+};
+
+class Logger {
+public:
+  Logger() {
+    int rate_limit = 0;
+    if (katana::GetEnv("KATANA_LOG_RATE_LIMIT", &rate_limit) &&
+        rate_limit > 0) {
+      rate_limit_ = rate_limit;
+    }
+    std::string format;
+    if (katana::GetEnv("KATANA_LOG_FORMAT", &format) && format == "json") {
+      format_ = katana::LogFormat::kJson;
+    }
+    bool async = false;
+    if (katana::GetEnv("KATANA_LOG_ASYNC", &async) && async) {
+      SetAsync(true);
+    }
+  }
+
+  ThreadLog* Register() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_logs_.emplace_back(
+        std::make_unique<ThreadLog>(thread_logs_.size()));
+    return thread_logs_.back().get();
+  }
+
+  void Log(ThreadLog* thread_log, Record&& record) {
+    bool error = record.level >= katana::LogLevel::Error;
+    if (!error && !thread_log->Admit(record.time_ns, rate_limit_)) {
+      return;
+    }
+    if (!error && async_.load(std::memory_order_relaxed)) {
+      thread_log->Push(std::move(record));
+      return;
+    }
+
+    std::vector<Record> batch;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (error) {
+      // Write what was queued before the error
+      DrainAll(&batch);
+    } else {
+      thread_log->DrainDropped(&batch);
+    }
+    batch.emplace_back(std::move(record));
+    Write(batch);
+  }
+
+  void Flush() {
+    std::vector<Record> batch;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    DrainAll(&batch);
+    Write(batch);
+  }
+
+  void SetAsync(bool enabled) {
+    std::thread stopped;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      async_ = enabled;
+      if (enabled && !writer_.joinable()) {
+        stopping_ = false;
+        writer_ = std::thread([this] { WriteQueued(); });
+      } else if (!enabled && writer_.joinable()) {
+        stopping_ = true;
+        stopped = std::move(writer_);
+      }
+    }
+    if (stopped.joinable()) {
+      cv_.notify_all();
+      stopped.join();
+    }
+    Flush();
+  }
+
+  bool async() const { return async_.load(std::memory_order_relaxed); }
+
+  void set_rate_limit(uint32_t per_second) { rate_limit_ = per_second; }
+
+  void set_format(katana::LogFormat format) { format_ = format; }
+
+private:
+  /// The loop of the background writer
+  void WriteQueued() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      cv_.wait_for(lock, kFlushInterval);
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  }
+
+  /// Move the queued records of all threads to out in time order. Must hold
+  /// write_mutex_.
+  void DrainAll(std::vector<Record>* out) {
+    std::vector<ThreadLog*> thread_logs;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& thread_log : thread_logs_) {
+        thread_logs.emplace_back(thread_log.get());
+      }
+    }
+    for (ThreadLog* thread_log : thread_logs) {
+      thread_log->Drain(out);
+    }
+    std::stable_sort(
+        out->begin(), out->end(), [](const Record& a, const Record& b) {
+          return a.time_ns < b.time_ns;
+        });
+  }
+
+  /// Must hold write_mutex_
+  void Write(const std::vector<Record>& records) {
+    katana::LogFormat format = format_;
+    for (const Record& record : records) {
+      if (format == katana::LogFormat::kJson) {
+        nlohmann::json j = {
+            {"time_ns", record.time_ns},
+            {"thread", record.thread},
+            {"level", LevelName(record.level)},
+            {"message", record.message},
+        };
+        if (record.file) {
+          j["file"] = record.file;
+          j["line"] = record.line;
+        }
+        std::cerr << j.dump(
+                         -1, ' ', false,
+                         nlohmann::json::error_handler_t::replace)
+                  << "\n";
+      } else if (record.file) {
+        std::cerr << LevelName(record.level) << ": " << record.file << ":"
+                  << record.line << ": " << record.message << "\n";
+      } else {
+        std::cerr << LevelName(record.level) << ": " << record.message << "\n";
+      }
+    }
+  }
+
+  // Guards thread_logs_ and the background writer
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadLog>> thread_logs_;
+  std::thread writer_;
+  std::condition_variable cv_;
+  bool stopping_{false};
+
+  // Serializes output and the consumers of the ring buffers
+  std::mutex write_mutex_;
+
+  std::atomic<bool> async_{false};
+  std::atomic<uint32_t> rate_limit_{0};
+  std::atomic<katana::LogFormat> format_{katana::LogFormat::kText};
+};
+
+Logger&
+GetLogger() {
+  // Never destroyed so that threads that outlive main can still log
+  static Logger* logger = new Logger();
+  return *logger;
 }
 
-}  // end unnamed namespace
+ThreadLog*
+GetThreadLog() {
+  thread_local ThreadLog* thread_log = GetLogger().Register();
+  return thread_log;
+}
 
+/// Stop the background writer, which writes what is queued
 void
-katana::internal::LogString(katana::LogLevel level, const std::string& s) {
-  int env_log_level = static_cast<int32_t>(LogLevel::Debug);
-  GetEnv("KATANA_LOG_LEVEL", &env_log_level);
+StopAtExit() {
+  GetLogger().SetAsync(false);
+}
+
+// Read the configuration before main so that a background writer started
+// by KATANA_LOG_ASYNC is stopped at exit
+[[maybe_unused]] const bool kLoggerInitialized = [] {
+  GetLogger();
+  std::atexit(StopAtExit);
+  return true;
+}();
+
+void
+LogRecord(
+    katana::LogLevel level, const char* file, int line, const std::string& s) {
+  int env_log_level = static_cast<int32_t>(katana::LogLevel::Debug);
+  katana::GetEnv("KATANA_LOG_LEVEL", &env_log_level);
   // Only log KATANA_LOG_LEVEL and above (default, log everything)
   if (static_cast<int32_t>(level) < env_log_level) {
     return;
   }
 
-  switch (level) {
-  case LogLevel::Debug:
-    return PrintString(true, false, "DEBUG", s);
-  case LogLevel::Verbose:
-    return PrintString(true, false, "VERBOSE", s);
-  case LogLevel::Warning:
-    return PrintString(true, false, "WARNING", s);
-  case LogLevel::Error:
-    return PrintString(true, false, "ERROR", s);
-  default:
-    return PrintString(true, false, "UNKNOWN LOG LEVEL", s);
-  }
+  ThreadLog* thread_log = GetThreadLog();
+  GetLogger().Log(
+      thread_log, Record{
+                      .level = level,
+                      .time_ns = NowNs(),
+                      .thread = thread_log->thread,
+                      .file = file,
+                      .line = line,
+                      .message = s,
+                  });
+}
+
+}  // end unnamed namespace
+
+void
+katana::internal::LogString(katana::LogLevel level, const std::string& s) {
+  LogRecord(level, nullptr, 0, s);
+}
+
+void
+katana::internal::LogLineString(
+    katana::LogLevel level, const char* file_name, int line_no,
+    const std::string& s) {
+  LogRecord(level, file_name, line_no, s);
+}
+
+void
+katana::SetAsyncLogging(bool enabled) {
+  GetLogger().SetAsync(enabled);
+}
+
+bool
+katana::IsAsyncLoggingEnabled() {
+  return GetLogger().async();
+}
+
+void
+katana::FlushLog() {
+  GetLogger().Flush();
+}
+
+void
+katana::SetLogRateLimit(uint32_t per_second) {
+  GetLogger().set_rate_limit(per_second);
+}
+
+void
+katana::SetLogFormat(LogFormat format) {
+  GetLogger().set_format(format);
 }
 
 void
 katana::AbortApplication() {
+  FlushLog();
   // TODO(amp): Replace this with an exception throw that can be caught in
   //  language wrappers to avoid low-level aborting the language runtime.
   std::abort();
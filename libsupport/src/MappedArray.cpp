@@ -0,0 +1,92 @@
+#include "katana/MappedArray.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// A buffer over an anonymous mapping that it unmaps when destroyed
+class MappedBuffer : public arrow::MutableBuffer {
+public:
+  MappedBuffer(
+      void* ptr, size_t size, size_t capacity,
+      katana::MemorySubsystem subsystem)
+      : arrow::MutableBuffer(
+            static_cast<uint8_t*>(ptr), static_cast<int64_t>(size)),
+        mapped_bytes_(capacity),
+        subsystem_(subsystem) {
+    capacity_ = static_cast<int64_t>(capacity);
+  }
+
+  ~MappedBuffer() override {
+    if (mutable_data_ == nullptr) {
+      return;
+    }
+    if (auto res = katana::UnmapAnonymous(mutable_data_, mapped_bytes_); !res) {
+      KATANA_LOG_ERROR("unmapping buffer: {}", res.error());
+    }
+    katana::ReleaseMemory(subsystem_, mapped_bytes_);
+  }
+
+private:
+  size_t mapped_bytes_;
+  katana::MemorySubsystem subsystem_;
+};
+
+}  // namespace
+
+katana::Result<void*>
+katana::MapAnonymous(size_t bytes) {
+  void* ptr = mmap(
+      nullptr, bytes, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1,
+      0);
+  if (ptr == MAP_FAILED) {
+    return KATANA_ERROR(ResultErrno(), "mapping {} bytes", bytes);
+  }
+  return ptr;
+}
+
+katana::Result<void*>
+katana::RemapAnonymous(void* ptr, size_t old_bytes, size_t new_bytes) {
+#ifdef MREMAP_MAYMOVE
+  void* new_ptr = mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+  if (new_ptr == MAP_FAILED) {
+    return KATANA_ERROR(
+        ResultErrno(), "remapping {} bytes to {} bytes", old_bytes, new_bytes);
+  }
+  return new_ptr;
+#else
+  // Without mremap, map anew and copy
+  auto map_res = MapAnonymous(new_bytes);
+  if (!map_res) {
+    return map_res.error();
+  }
+  std::memcpy(map_res.value(), ptr, std::min(old_bytes, new_bytes));
+  if (auto res = UnmapAnonymous(ptr, old_bytes); !res) {
+    return res.error();
+  }
+  return map_res.value();
+#endif
+}
+
+katana::Result<void>
+katana::UnmapAnonymous(void* ptr, size_t bytes) {
+  if (munmap(ptr, bytes) != 0) {
+    return KATANA_ERROR(ResultErrno(), "unmapping {} bytes", bytes);
+  }
+  return ResultSuccess();
+}
+
+size_t
+katana::MappingGranularity() {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+std::shared_ptr<arrow::MutableBuffer>
+katana::MakeMappedBuffer(
+    void* ptr, size_t size, size_t capacity, MemorySubsystem subsystem) {
+  return std::make_shared<MappedBuffer>(ptr, size, capacity, subsystem);
+}
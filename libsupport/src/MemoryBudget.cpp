@@ -0,0 +1,333 @@
+#include "katana/MemoryBudget.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Time.h"
+
+namespace {
+
+constexpr size_t kNumSubsystems =
+    static_cast<size_t>(katana::MemorySubsystem::kNumSubsystems);
+
+/// Usage above this share of the budget makes the reclaimers run
+constexpr double kReclaimThreshold = 0.9;
+
+uint64_t
+BudgetFromEnv() {
+  std::string value;
+  if (!katana::GetEnv("KATANA_MEMORY_BUDGET", &value)) {
+    return 0;
+  }
+  try {
+    return std::stoull(value);
+  } catch (const std::exception&) {
+    KATANA_LOG_WARN("KATANA_MEMORY_BUDGET is not a number of bytes: {}", value);
+    return 0;
+  }
+}
+
+/// Set while a thread runs reclaimers, so that memory charged or reserved by
+/// a reclaimer does not run them again
+thread_local bool reclaiming = false;
+
+class MemoryBudget {
+public:
+  uint64_t budget() const { return budget_.load(std::memory_order_relaxed); }
+
+  void set_budget(uint64_t bytes) {
+    budget_.store(bytes, std::memory_order_relaxed);
+    warned_ = false;
+  }
+
+  uint64_t Usage(katana::MemorySubsystem subsystem) const {
+    if (subsystem == katana::MemorySubsystem::kArrow) {
+      return arrow::default_memory_pool()->bytes_allocated();
+    }
+    return usage_[static_cast<size_t>(subsystem)].load(
+        std::memory_order_relaxed);
+  }
+
+  uint64_t Usage() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < kNumSubsystems; ++i) {
+      total += Usage(static_cast<katana::MemorySubsystem>(i));
+    }
+    return total;
+  }
+
+  void Charge(katana::MemorySubsystem subsystem, uint64_t bytes) {
+    usage_[static_cast<size_t>(subsystem)].fetch_add(
+        bytes, std::memory_order_relaxed);
+    Check();
+  }
+
+  void Release(katana::MemorySubsystem subsystem, uint64_t bytes) {
+    usage_[static_cast<size_t>(subsystem)].fetch_sub(
+        bytes, std::memory_order_relaxed);
+  }
+
+  katana::Result<void> MakeAvailable(uint64_t bytes) {
+    uint64_t limit = budget();
+    if (limit == 0) {
+      return katana::ResultSuccess();
+    }
+    if (Usage() + bytes > limit) {
+      Reclaim(bytes, limit);
+    }
+    if (uint64_t usage = Usage(); usage + bytes > limit) {
+      return KATANA_ERROR(
+          katana::ErrorCode::OutOfMemory,
+          "{} more would exceed the memory budget of {} ({} in use: {})",
+          katana::BytesToStr("{:.1f}{}", bytes),
+          katana::BytesToStr("{:.1f}{}", limit),
+          katana::BytesToStr("{:.1f}{}", usage), Summary());
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Run the reclaimers if usage is close to the budget and warn if it is
+  /// over
+  void Check() {
+    uint64_t limit = budget();
+    if (limit == 0) {
+      return;
+    }
+    uint64_t usage = Usage();
+    auto threshold = static_cast<uint64_t>(limit * kReclaimThreshold);
+    if (usage > threshold) {
+      Reclaim(0, threshold);
+      usage = Usage();
+    }
+    if (usage <= limit) {
+      warned_ = false;
+    } else if (!warned_.exchange(true)) {
+      KATANA_LOG_WARN(
+          "memory budget of {} exceeded: {} in use ({})",
+          katana::BytesToStr("{:.1f}{}", limit),
+          katana::BytesToStr("{:.1f}{}", usage), Summary());
+    }
+  }
+
+  std::string Summary() const {
+    std::string summary;
+    for (size_t i = 0; i < kNumSubsystems; ++i) {
+      auto subsystem = static_cast<katana::MemorySubsystem>(i);
+      if (i > 0) {
+        summary += ", ";
+      }
+      summary += fmt::format(
+          "{} {}", katana::MemorySubsystemName(subsystem),
+          katana::BytesToStr("{:.1f}{}", Usage(subsystem)));
+    }
+    return summary;
+  }
+
+  uint64_t AddReclaimer(katana::MemoryReclaimer reclaimer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = ++next_id_;
+    reclaimers_.emplace_back(id, std::move(reclaimer));
+    return id;
+  }
+
+  void RemoveReclaimer(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = reclaimers_.begin(); it != reclaimers_.end(); ++it) {
+      if (it->first == id) {
+        reclaimers_.erase(it);
+        return;
+      }
+    }
+  }
+
+private:
+  /// Run reclaimers until bytes more fit under target
+  void Reclaim(uint64_t bytes, uint64_t target) {
+    if (reclaiming) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    reclaiming = true;
+    for (const auto& [id, reclaimer] : reclaimers_) {
+      uint64_t usage = Usage();
+      if (usage + bytes <= target) {
+        break;
+      }
+      reclaimer(usage + bytes - target);
+    }
+    reclaiming = false;
+  }
+
+  std::atomic<uint64_t> budget_{BudgetFromEnv()};
+  std::array<std::atomic<uint64_t>, kNumSubsystems> usage_{};
+  std::atomic<bool> warned_{false};
+
+  // Guards reclaimers_ and serializes reclaiming
+  std::mutex mutex_;
+  std::vector<std::pair<uint64_t, katana::MemoryReclaimer>> reclaimers_;
+  uint64_t next_id_{0};
+};
+
+MemoryBudget&
+GetMemoryBudget() {
+  // Never destroyed so that memory freed at exit can still be released
+  static MemoryBudget* budget = new MemoryBudget();
+  return *budget;
+}
+
+/// BudgetedPool allocates from the default Arrow memory pool, whose usage is
+/// that of MemorySubsystem::kArrow, after making room in the budget
+class BudgetedPool : public arrow::MemoryPool {
+public:
+  arrow::Status Allocate(int64_t size, uint8_t** out) override {
+    if (auto res = GetMemoryBudget().MakeAvailable(size); !res) {
+      return arrow::Status::OutOfMemory(res.error());
+    }
+    auto status = pool()->Allocate(size, out);
+    GetMemoryBudget().Check();
+    return status;
+  }
+
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override {
+    if (new_size > old_size) {
+      if (auto res = GetMemoryBudget().MakeAvailable(new_size - old_size);
+          !res) {
+        return arrow::Status::OutOfMemory(res.error());
+      }
+    }
+    auto status = pool()->Reallocate(old_size, new_size, ptr);
+    GetMemoryBudget().Check();
+    return status;
+  }
+
+  void Free(uint8_t* buffer, int64_t size) override {
+    pool()->Free(buffer, size);
+  }
+
+  int64_t bytes_allocated() const override { return pool()->bytes_allocated(); }
+
+  int64_t max_memory() const override { return pool()->max_memory(); }
+
+  std::string backend_name() const override { return pool()->backend_name(); }
+
+  void set_pool(arrow::MemoryPool* pool) {
+    pool_.store(
+        pool ? pool : arrow::default_memory_pool(), std::memory_order_release);
+  }
+
+private:
+  arrow::MemoryPool* pool() const {
+    return pool_.load(std::memory_order_acquire);
+  }
+
+  std::atomic<arrow::MemoryPool*> pool_{arrow::default_memory_pool()};
+};
+
+}  // namespace
+
+const char*
+katana::MemorySubsystemName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+  case MemorySubsystem::kPagePool:
+    return "PagePool";
+  case MemorySubsystem::kLargeArray:
+    return "LargeArray";
+  case MemorySubsystem::kArrow:
+    return "Arrow";
+  case MemorySubsystem::kFileView:
+    return "FileView";
+  case MemorySubsystem::kFileFrame:
+    return "FileFrame";
+  default:
+    return "Unknown";
+  }
+}
+
+void
+katana::SetMemoryBudget(uint64_t bytes) {
+  GetMemoryBudget().set_budget(bytes);
+}
+
+uint64_t
+katana::GetMemoryBudget() {
+  return ::GetMemoryBudget().budget();
+}
+
+uint64_t
+katana::GetMemoryUsage(MemorySubsystem subsystem) {
+  return ::GetMemoryBudget().Usage(subsystem);
+}
+
+uint64_t
+katana::GetMemoryUsage() {
+  return ::GetMemoryBudget().Usage();
+}
+
+std::string
+katana::MemoryUsageSummary() {
+  return ::GetMemoryBudget().Summary();
+}
+
+void
+katana::ChargeMemory(MemorySubsystem subsystem, uint64_t bytes) {
+  ::GetMemoryBudget().Charge(subsystem, bytes);
+}
+
+void
+katana::ReleaseMemory(MemorySubsystem subsystem, uint64_t bytes) {
+  ::GetMemoryBudget().Release(subsystem, bytes);
+}
+
+katana::Result<void>
+katana::ReserveMemory(MemorySubsystem subsystem, uint64_t bytes) {
+  if (auto res = MakeMemoryAvailable(bytes); !res) {
+    return res.error().WithContext(
+        "reserving memory for {}", MemorySubsystemName(subsystem));
+  }
+  ChargeMemory(subsystem, bytes);
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::MakeMemoryAvailable(uint64_t bytes) {
+  return ::GetMemoryBudget().MakeAvailable(bytes);
+}
+
+uint64_t
+katana::AddMemoryReclaimer(MemoryReclaimer reclaimer) {
+  return ::GetMemoryBudget().AddReclaimer(std::move(reclaimer));
+}
+
+void
+katana::RemoveMemoryReclaimer(uint64_t id) {
+  ::GetMemoryBudget().RemoveReclaimer(id);
+}
+
+namespace {
+
+BudgetedPool*
+GetBudgetedPool() {
+  static BudgetedPool* pool = new BudgetedPool();
+  return pool;
+}
+
+}  // namespace
+
+arrow::MemoryPool*
+katana::BudgetedMemoryPool() {
+  return GetBudgetedPool();
+}
+
+void
+katana::SetArrowMemoryPool(arrow::MemoryPool* pool) {
+  GetBudgetedPool()->set_pool(pool);
+}
@@ -0,0 +1,280 @@
+#include "katana/MpiCommBackend.h"
+
+#include <mpi.h>
+
+#include <limits>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+// MPI counts and displacements are ints
+constexpr uint64_t kMaxCount = std::numeric_limits<int>::max();
+
+MPI_Datatype
+MpiType(katana::CommDataType type) {
+  switch (type) {
+  case katana::CommDataType::kInt32:
+    return MPI_INT32_T;
+  case katana::CommDataType::kUInt32:
+    return MPI_UINT32_T;
+  case katana::CommDataType::kInt64:
+    return MPI_INT64_T;
+  case katana::CommDataType::kUInt64:
+    return MPI_UINT64_T;
+  case katana::CommDataType::kFloat:
+    return MPI_FLOAT;
+  case katana::CommDataType::kDouble:
+    return MPI_DOUBLE;
+  }
+  KATANA_LOG_FATAL("unknown CommDataType");
+}
+
+MPI_Op
+MpiOp(katana::ReduceOp op) {
+  switch (op) {
+  case katana::ReduceOp::kSum:
+    return MPI_SUM;
+  case katana::ReduceOp::kMin:
+    return MPI_MIN;
+  case katana::ReduceOp::kMax:
+    return MPI_MAX;
+  }
+  KATANA_LOG_FATAL("unknown ReduceOp");
+}
+
+}  // namespace
+
+katana::MpiCommBackend::MpiCommBackend() {
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+    int provided = 0;
+    if (MPI_Init_thread(nullptr, nullptr, MPI_THREAD_SERIALIZED, &provided) !=
+        MPI_SUCCESS) {
+      KATANA_LOG_FATAL("initializing MPI");
+    }
+    initialized_mpi_ = true;
+  }
+
+  int rank = 0;
+  int size = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  ID = rank;
+  Num = size;
+}
+
+katana::MpiCommBackend::~MpiCommBackend() {
+  if (initialized_mpi_) {
+    MPI_Finalize();
+  }
+}
+
+void
+katana::MpiCommBackend::Barrier() {
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+bool
+katana::MpiCommBackend::Broadcast(uint32_t root, bool val) {
+  int buf = val ? 1 : 0;
+  MPI_Bcast(&buf, 1, MPI_INT, root, MPI_COMM_WORLD);
+  return buf != 0;
+}
+
+std::string
+katana::MpiCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  uint64_t size = std::min<uint64_t>(val.size(), max_size);
+  MPI_Bcast(&size, 1, MPI_UINT64_T, root, MPI_COMM_WORLD);
+  if (size > std::numeric_limits<int>::max()) {
+    KATANA_LOG_FATAL("broadcast of {} bytes is too large for MPI", size);
+  }
+  std::string buf = ID == root ? val.substr(0, size) : std::string(size, '\0');
+  MPI_Bcast(buf.data(), size, MPI_CHAR, root, MPI_COMM_WORLD);
+  return buf;
+}
+
+void
+katana::MpiCommBackend::NotifyFailure() {
+  MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+}
+
+katana::Result<std::vector<std::string>>
+katana::MpiCommBackend::AllToAll(std::vector<std::string> outgoing) {
+  if (outgoing.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} messages found {}", Num,
+        outgoing.size());
+  }
+
+  // MPI counts and displacements are ints
+  constexpr uint64_t kMax = std::numeric_limits<int>::max();
+  std::vector<int> send_counts(Num);
+  std::vector<int> send_displs(Num);
+  std::string send_buf;
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (send_buf.size() + outgoing[i].size() > kMax) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "AllToAll is too large for MPI");
+    }
+    send_counts[i] = outgoing[i].size();
+    send_displs[i] = send_buf.size();
+    send_buf += outgoing[i];
+    outgoing[i] = std::string();
+  }
+
+  std::vector<int> recv_counts(Num);
+  if (MPI_Alltoall(
+          send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+          MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Alltoall failed");
+  }
+  std::vector<int> recv_displs(Num);
+  uint64_t recv_size = 0;
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (recv_size + recv_counts[i] > kMax) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "AllToAll is too large for MPI");
+    }
+    recv_displs[i] = recv_size;
+    recv_size += recv_counts[i];
+  }
+
+  std::string recv_buf(recv_size, '\0');
+  if (MPI_Alltoallv(
+          send_buf.data(), send_counts.data(), send_displs.data(), MPI_CHAR,
+          recv_buf.data(), recv_counts.data(), recv_displs.data(), MPI_CHAR,
+          MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Alltoallv failed");
+  }
+
+  std::vector<std::string> incoming(Num);
+  for (uint32_t i = 0; i < Num; ++i) {
+    incoming[i] = recv_buf.substr(recv_displs[i], recv_counts[i]);
+  }
+  return incoming;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::MpiCommBackend::DoAllToAllv(const Buffers& outgoing) {
+  std::vector<uint64_t> send_sizes(Num);
+  for (uint32_t i = 0; i < Num; ++i) {
+    send_sizes[i] = outgoing[i]->size();
+  }
+  std::vector<uint64_t> recv_sizes(Num);
+  if (MPI_Alltoall(
+          send_sizes.data(), 1, MPI_UINT64_T, recv_sizes.data(), 1,
+          MPI_UINT64_T, MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Alltoall failed");
+  }
+
+  Buffers incoming(Num);
+  incoming[ID] = outgoing[ID];
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (i == ID) {
+      continue;
+    }
+    auto res = AllocateBuffer(recv_sizes[i]);
+    if (!res) {
+      return res.error();
+    }
+    incoming[i] = std::move(res.value());
+  }
+
+  // Messages larger than an int count are sent in pieces, which arrive in
+  // order because MPI does not reorder messages between a pair of tasks
+  std::vector<MPI_Request> requests;
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (i == ID) {
+      continue;
+    }
+    uint8_t* recv_data = incoming[i]->mutable_data();
+    for (uint64_t off = 0; off < recv_sizes[i]; off += kMaxCount) {
+      int count = std::min(kMaxCount, recv_sizes[i] - off);
+      MPI_Irecv(
+          recv_data + off, count, MPI_BYTE, i, 0, MPI_COMM_WORLD,
+          &requests.emplace_back());
+    }
+    // MPI_Isend takes a non-const pointer in MPI 2
+    auto* send_data = const_cast<uint8_t*>(outgoing[i]->data());
+    for (uint64_t off = 0; off < send_sizes[i]; off += kMaxCount) {
+      int count = std::min(kMaxCount, send_sizes[i] - off);
+      MPI_Isend(
+          send_data + off, count, MPI_BYTE, i, 0, MPI_COMM_WORLD,
+          &requests.emplace_back());
+    }
+  }
+  if (MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE) !=
+      MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Waitall failed");
+  }
+  return incoming;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::MpiCommBackend::DoAllGather(
+    const std::shared_ptr<arrow::Buffer>& buffer) {
+  if (static_cast<uint64_t>(buffer->size()) > kMaxCount) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "AllGather is too large for MPI");
+  }
+  int send_count = buffer->size();
+  std::vector<int> recv_counts(Num);
+  if (MPI_Allgather(
+          &send_count, 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+          MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Allgather failed");
+  }
+  std::vector<int> recv_displs(Num);
+  uint64_t recv_size = 0;
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (recv_size + recv_counts[i] > kMaxCount) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "AllGather is too large for MPI");
+    }
+    recv_displs[i] = recv_size;
+    recv_size += recv_counts[i];
+  }
+
+  auto recv_res = AllocateBuffer(recv_size);
+  if (!recv_res) {
+    return recv_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> recv_buf = std::move(recv_res.value());
+  if (MPI_Allgatherv(
+          buffer->data(), send_count, MPI_BYTE, recv_buf->mutable_data(),
+          recv_counts.data(), recv_displs.data(), MPI_BYTE,
+          MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Allgatherv failed");
+  }
+
+  Buffers gathered(Num);
+  for (uint32_t i = 0; i < Num; ++i) {
+    gathered[i] = arrow::SliceBuffer(recv_buf, recv_displs[i], recv_counts[i]);
+  }
+  return gathered;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::MpiCommBackend::DoAllReduce(
+    const std::shared_ptr<arrow::Buffer>& values, CommDataType type,
+    ReduceOp op) {
+  uint64_t count = values->size() / CommDataTypeSize(type);
+  if (count > kMaxCount) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "AllReduce is too large for MPI");
+  }
+  auto out_res = AllocateBuffer(values->size());
+  if (!out_res) {
+    return out_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> out = std::move(out_res.value());
+  if (MPI_Allreduce(
+          values->data(), out->mutable_data(), count, MpiType(type),
+          MpiOp(op), MPI_COMM_WORLD) != MPI_SUCCESS) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "MPI_Allreduce failed");
+  }
+  return out;
+}
@@ -0,0 +1,462 @@
+#include "katana/TcpCommBackend.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <thread>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr auto kRetryInterval = std::chrono::milliseconds(100);
+
+struct AddrInfoDeleter {
+  void operator()(addrinfo* info) const { freeaddrinfo(info); }
+};
+
+using AddrInfo = std::unique_ptr<addrinfo, AddrInfoDeleter>;
+
+/// Split host:port
+katana::Result<std::pair<std::string, std::string>>
+SplitAddress(const std::string& address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos || colon == 0 ||
+      colon + 1 == address.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "address {} is not host:port",
+        address);
+  }
+  return std::make_pair(address.substr(0, colon), address.substr(colon + 1));
+}
+
+katana::Result<AddrInfo>
+Resolve(const std::string& address, bool passive) {
+  auto split_res = SplitAddress(address);
+  if (!split_res) {
+    return split_res.error();
+  }
+  auto [host, port] = split_res.value();
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  addrinfo* info = nullptr;
+  if (int ret = getaddrinfo(host.c_str(), port.c_str(), &hints, &info);
+      ret != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "resolving {}: {}", address,
+        gai_strerror(ret));
+  }
+  return AddrInfo(info);
+}
+
+katana::Result<void>
+SendAll(int fd, const void* buf, size_t size) {
+  const auto* ptr = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t ret = send(fd, ptr, size, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "sending");
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+RecvAll(int fd, void* buf, size_t size) {
+  auto* ptr = static_cast<char*>(buf);
+  while (size > 0) {
+    ssize_t ret = recv(fd, ptr, size, 0);
+    if (ret == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "connection closed by peer");
+    }
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "receiving");
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Connect to address, retrying until deadline while nobody listens there
+katana::Result<int>
+ConnectTo(
+    const std::string& address,
+    std::chrono::steady_clock::time_point deadline) {
+  auto info_res = Resolve(address, false);
+  if (!info_res) {
+    return info_res.error();
+  }
+  const addrinfo* info = info_res.value().get();
+
+  while (true) {
+    int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "creating socket");
+    }
+    if (connect(fd, info->ai_addr, info->ai_addrlen) == 0) {
+      return fd;
+    }
+    int err = errno;
+    close(fd);
+    if (err != ECONNREFUSED || std::chrono::steady_clock::now() > deadline) {
+      return KATANA_ERROR(
+          std::error_code(err, std::system_category()), "connecting to {}",
+          address);
+    }
+    std::this_thread::sleep_for(kRetryInterval);
+  }
+}
+
+/// The state of the messages to and from one peer during AllToAllv. Each
+/// message is preceded by its size. Messages are sent from and received into
+/// their buffers directly.
+struct Transfer {
+  int fd;
+  const uint8_t* send_data;
+  uint64_t send_size;
+  std::array<uint8_t, sizeof(uint64_t)> send_header;
+  uint64_t sent{0};
+  /// Allocated once the size of the message is received
+  std::shared_ptr<arrow::Buffer> recv_buffer;
+  std::array<uint8_t, sizeof(uint64_t)> recv_header;
+  uint64_t received{0};
+
+  bool sending() const { return sent < send_header.size() + send_size; }
+
+  bool receiving() const {
+    return !recv_buffer || received < recv_header.size() + recv_buffer->size();
+  }
+
+  katana::Result<void> Send() {
+    const uint8_t* ptr = nullptr;
+    size_t size = 0;
+    if (sent < send_header.size()) {
+      ptr = send_header.data() + sent;
+      size = send_header.size() - sent;
+    } else {
+      ptr = send_data + (sent - send_header.size());
+      size = send_size - (sent - send_header.size());
+    }
+    ssize_t ret = send(fd, ptr, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+        return katana::ResultSuccess();
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "sending");
+    }
+    sent += ret;
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Receive() {
+    uint8_t* ptr = nullptr;
+    size_t size = 0;
+    if (received < recv_header.size()) {
+      ptr = recv_header.data() + received;
+      size = recv_header.size() - received;
+    } else {
+      ptr = recv_buffer->mutable_data() + (received - recv_header.size());
+      size = recv_buffer->size() - (received - recv_header.size());
+    }
+    ssize_t ret = recv(fd, ptr, size, MSG_DONTWAIT);
+    if (ret == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "connection closed by peer");
+    }
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+        return katana::ResultSuccess();
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "receiving");
+    }
+    received += ret;
+    if (received == recv_header.size()) {
+      uint64_t message_size{};
+      std::memcpy(&message_size, recv_header.data(), sizeof(message_size));
+      auto res = arrow::AllocateBuffer(message_size);
+      if (!res.ok()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::ArrowError, "allocating {} bytes: {}",
+            message_size, res.status());
+      }
+      recv_buffer = std::move(res.ValueOrDie());
+    }
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::TcpCommBackend>>
+katana::TcpCommBackend::Listen(const std::string& address) {
+  auto info_res = Resolve(address, true);
+  if (!info_res) {
+    return info_res.error();
+  }
+  const addrinfo* info = info_res.value().get();
+
+  int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating socket");
+  }
+  int one = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+      bind(fd, info->ai_addr, info->ai_addrlen) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    auto err = ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "listening at {}", address);
+  }
+
+  sockaddr_storage bound{};
+  socklen_t bound_len = sizeof(bound);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &bound_len) != 0) {
+    auto err = ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "finding port of {}", address);
+  }
+  uint16_t port = bound.ss_family == AF_INET6
+                      ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                      : reinterpret_cast<sockaddr_in*>(&bound)->sin_port;
+
+  std::string host = SplitAddress(address).value().first;
+  return std::unique_ptr<TcpCommBackend>(new TcpCommBackend(
+      fd, fmt::format("{}:{}", host, ntohs(port))));
+}
+
+katana::TcpCommBackend::~TcpCommBackend() {
+  for (int fd : peers_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  close(listen_fd_);
+}
+
+katana::Result<void>
+katana::TcpCommBackend::Connect(
+    const std::vector<std::string>& addresses, uint32_t id,
+    std::chrono::milliseconds timeout) {
+  if (!peers_.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "already connected");
+  }
+  uint32_t num = addresses.size();
+  if (id >= num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "task {} is not one of {} tasks", id, num);
+  }
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  std::vector<int> peers(num, -1);
+  auto close_peers = [&]() {
+    for (int fd : peers) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  };
+
+  // Connect to tasks with smaller IDs and accept connections from the others
+  for (uint32_t i = 0; i < id; ++i) {
+    auto fd_res = ConnectTo(addresses[i], deadline);
+    if (!fd_res) {
+      close_peers();
+      return fd_res.error().WithContext("task {}", i);
+    }
+    peers[i] = fd_res.value();
+    if (auto res = SendAll(peers[i], &id, sizeof(id)); !res) {
+      close_peers();
+      return res.error().WithContext("task {}", i);
+    }
+  }
+  for (uint32_t accepted = id + 1; accepted < num;) {
+    pollfd pfd{.fd = listen_fd_, .events = POLLIN, .revents = 0};
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    int ret = poll(&pfd, 1, std::max<int64_t>(remaining.count(), 0));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      close_peers();
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "waiting for {} more tasks to connect",
+          num - accepted);
+    }
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      close_peers();
+      return KATANA_ERROR(ResultErrno(), "accepting connection");
+    }
+    uint32_t peer{};
+    if (auto res = RecvAll(fd, &peer, sizeof(peer)); !res) {
+      close(fd);
+      close_peers();
+      return res.error();
+    }
+    if (peer <= id || peer >= num || peers[peer] >= 0) {
+      close(fd);
+      close_peers();
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "unexpected connection from task {}",
+          peer);
+    }
+    peers[peer] = fd;
+    ++accepted;
+  }
+
+  int one = 1;
+  for (int fd : peers) {
+    if (fd >= 0) {
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+  }
+  peers_ = std::move(peers);
+  Num = num;
+  ID = id;
+  return ResultSuccess();
+}
+
+katana::Result<std::vector<std::string>>
+katana::TcpCommBackend::AllToAll(std::vector<std::string> outgoing) {
+  if (outgoing.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} messages found {}", Num,
+        outgoing.size());
+  }
+  Buffers buffers;
+  for (auto& message : outgoing) {
+    buffers.emplace_back(arrow::Buffer::FromString(std::move(message)));
+  }
+  auto res = DoAllToAllv(buffers);
+  if (!res) {
+    return res.error();
+  }
+  std::vector<std::string> incoming;
+  for (const auto& buffer : res.value()) {
+    incoming.emplace_back(buffer->ToString());
+  }
+  return incoming;
+}
+
+katana::Result<katana::CommBackend::Buffers>
+katana::TcpCommBackend::DoAllToAllv(const Buffers& outgoing) {
+  Buffers incoming(Num);
+  incoming[ID] = outgoing[ID];
+
+  std::vector<Transfer> transfers;
+  for (uint32_t i = 0; i < Num; ++i) {
+    if (i == ID) {
+      continue;
+    }
+    Transfer& t = transfers.emplace_back();
+    t.fd = peers_[i];
+    t.send_data = outgoing[i]->data();
+    t.send_size = outgoing[i]->size();
+    std::memcpy(t.send_header.data(), &t.send_size, sizeof(t.send_size));
+  }
+
+  // Send and receive with every peer at once, so that large messages in
+  // both directions cannot deadlock
+  std::vector<pollfd> pfds;
+  std::vector<Transfer*> polled;
+  while (true) {
+    pfds.clear();
+    polled.clear();
+    for (Transfer& t : transfers) {
+      short events = (t.sending() ? POLLOUT : 0) | (t.receiving() ? POLLIN : 0);
+      if (events != 0) {
+        pfds.emplace_back(pollfd{.fd = t.fd, .events = events, .revents = 0});
+        polled.emplace_back(&t);
+      }
+    }
+    if (pfds.empty()) {
+      break;
+    }
+    if (poll(pfds.data(), pfds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(ResultErrno(), "waiting for peers");
+    }
+    for (size_t i = 0; i < pfds.size(); ++i) {
+      short revents = pfds[i].revents;
+      if ((revents & (POLLIN | POLLERR | POLLHUP)) != 0 &&
+          polled[i]->receiving()) {
+        if (auto res = polled[i]->Receive(); !res) {
+          return res.error();
+        }
+      }
+      if ((revents & (POLLOUT | POLLERR)) != 0 && polled[i]->sending()) {
+        if (auto res = polled[i]->Send(); !res) {
+          return res.error();
+        }
+      }
+      if ((revents & POLLNVAL) != 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "connection was shut down");
+      }
+    }
+  }
+
+  for (uint32_t i = 0, t = 0; i < Num; ++i) {
+    if (i != ID) {
+      incoming[i] = std::move(transfers[t++].recv_buffer);
+    }
+  }
+  return incoming;
+}
+
+void
+katana::TcpCommBackend::Barrier() {
+  if (auto res = AllToAll(std::vector<std::string>(Num)); !res) {
+    KATANA_LOG_FATAL("barrier: {}", res.error());
+  }
+}
+
+bool
+katana::TcpCommBackend::Broadcast(uint32_t root, bool val) {
+  return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+}
+
+std::string
+katana::TcpCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  std::vector<std::string> outgoing(Num);
+  if (ID == root) {
+    outgoing.assign(Num, val.substr(0, max_size));
+  }
+  auto res = AllToAll(std::move(outgoing));
+  if (!res) {
+    KATANA_LOG_FATAL("broadcast: {}", res.error());
+  }
+  return std::move(res.value()[root]);
+}
+
+void
+katana::TcpCommBackend::NotifyFailure() {
+  for (int fd : peers_) {
+    if (fd >= 0) {
+      shutdown(fd, SHUT_RDWR);
+    }
+  }
+}
@@ -0,0 +1,211 @@
+#include "katana/Trace.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+
+std::atomic<bool> katana::internal::trace_enabled{false};
+
+namespace {
+
+constexpr size_t kDefaultCapacity = 1 << 16;
+
+struct Event {
+  const char* name;
+  const char* category;
+  uint64_t begin_ns;
+  uint64_t end_ns;
+};
+
+/// The events of one thread. Writers take the lock of the buffer so that the
+/// trace can be written while threads run; it is otherwise uncontended.
+struct ThreadBuffer {
+  std::mutex mutex;
+  uint64_t tid{};
+  std::string name;
+  /// Grows up to the capacity and is then a ring whose oldest event is at
+  /// next
+  std::vector<Event> events;
+  size_t next{};
+};
+
+class Tracer {
+  std::mutex mutex_;
+  std::string path_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  size_t capacity_{kDefaultCapacity};
+  uint64_t start_ns_{katana::internal::TraceNowNs()};
+
+  /// Write the trace to path_; requires mutex_
+  katana::Result<void> WriteLocked();
+
+public:
+  Tracer() {
+    int capacity = 0;
+    if (katana::GetEnv("KATANA_TRACE_EVENTS", &capacity) && capacity > 0) {
+      capacity_ = capacity;
+    }
+    std::string path;
+    if (katana::GetEnv("KATANA_TRACE", &path)) {
+      Open(path);
+    }
+  }
+
+  void Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!path_.empty()) {
+      if (auto res = WriteLocked(); !res) {
+        KATANA_LOG_ERROR("{}", res.error());
+      }
+    }
+    path_ = path;
+    katana::internal::trace_enabled = !path_.empty();
+  }
+
+  katana::Result<void> Write() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty()) {
+      return katana::ResultSuccess();
+    }
+    return WriteLocked();
+  }
+
+  ThreadBuffer* Register() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = buffers_.size();
+    buffers_.emplace_back(std::move(buffer));
+    return buffers_.back().get();
+  }
+
+  void Record(ThreadBuffer* buffer, const Event& event) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->events.size() < capacity_) {
+      buffer->events.emplace_back(event);
+      return;
+    }
+    buffer->events[buffer->next] = event;
+    buffer->next = (buffer->next + 1) % buffer->events.size();
+  }
+};
+
+katana::Result<void>
+Tracer::WriteLocked() {
+  int pid = getpid();
+  nlohmann::json events = nlohmann::json::array();
+  auto micros = [this](uint64_t ns) {
+    return (static_cast<double>(ns) - static_cast<double>(start_ns_)) / 1e3;
+  };
+
+  for (const auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    std::string name = buffer->name.empty()
+                           ? fmt::format("thread {}", buffer->tid)
+                           : buffer->name;
+    events.push_back({
+        {"name", "thread_name"},
+        {"ph", "M"},
+        {"pid", pid},
+        {"tid", buffer->tid},
+        {"args", {{"name", name}}},
+    });
+
+    size_t size = buffer->events.size();
+    for (size_t i = 0; i < size; ++i) {
+      const Event& e = buffer->events[(buffer->next + i) % size];
+      events.push_back({
+          {"name", e.name},
+          {"cat", e.category},
+          {"ph", "X"},
+          {"ts", micros(e.begin_ns)},
+          {"dur", static_cast<double>(e.end_ns - e.begin_ns) / 1e3},
+          {"pid", pid},
+          {"tid", buffer->tid},
+      });
+    }
+  }
+
+  auto dump = katana::JsonDump(nlohmann::json{
+      {"traceEvents", std::move(events)},
+      {"displayTimeUnit", "ns"},
+  });
+  if (!dump) {
+    return dump.error().WithContext("writing trace file {}", path_);
+  }
+
+  std::ofstream out(path_, std::ios::trunc);
+  if (!out) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening trace file {}", path_);
+  }
+  out << dump.value();
+  out.close();
+  if (!out) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "writing trace file {}", path_);
+  }
+  return katana::ResultSuccess();
+}
+
+Tracer&
+GetTracer() {
+  // Never destroyed so that threads that outlive main can still record
+  static Tracer* tracer = new Tracer();
+  return *tracer;
+}
+
+ThreadBuffer*
+GetThreadBuffer() {
+  thread_local ThreadBuffer* buffer = GetTracer().Register();
+  return buffer;
+}
+
+void
+WriteAtExit() {
+  if (auto res = GetTracer().Write(); !res) {
+    KATANA_LOG_ERROR("{}", res.error());
+  }
+}
+
+// Read KATANA_TRACE before main rather than at the first event, since
+// IsTraceEnabled does not touch the tracer
+[[maybe_unused]] const bool kTracerInitialized = [] {
+  GetTracer();
+  std::atexit(WriteAtExit);
+  return true;
+}();
+
+}  // namespace
+
+void
+katana::SetTraceFile(const std::string& path) {
+  GetTracer().Open(path);
+}
+
+katana::Result<void>
+katana::WriteTrace() {
+  return GetTracer().Write();
+}
+
+void
+katana::SetTraceThreadName(const std::string& name) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->name = name;
+}
+
+void
+katana::internal::RecordTraceEvent(
+    const char* name, const char* category, uint64_t begin_ns,
+    uint64_t end_ns) {
+  GetTracer().Record(
+      GetThreadBuffer(), Event{name, category, begin_ns, end_ns});
+}
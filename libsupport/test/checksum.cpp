@@ -0,0 +1,33 @@
+#include "katana/Checksum.h"
+
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+
+int
+main() {
+  std::string check = "123456789";
+  KATANA_LOG_ASSERT(katana::Crc32c(check.data(), check.size()) == 0xe3069283);
+  KATANA_LOG_ASSERT(katana::Crc32c(nullptr, 0) == 0);
+
+  std::vector<uint8_t> zeros(32, 0);
+  KATANA_LOG_ASSERT(katana::Crc32c(zeros.data(), zeros.size()) == 0x8a9136aa);
+
+  // Checksums extend piece by piece, at any alignment
+  std::vector<uint8_t> buf(1000);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+  uint32_t whole = katana::Crc32c(buf.data(), buf.size());
+  for (size_t split : {0, 1, 7, 8, 13, 500, 999, 1000}) {
+    uint32_t crc = katana::Crc32c(buf.data(), split);
+    crc = katana::Crc32c(buf.data() + split, buf.size() - split, crc);
+    KATANA_LOG_VASSERT(crc == whole, "split at {}", split);
+  }
+
+  buf[123] ^= 1;
+  KATANA_LOG_ASSERT(katana::Crc32c(buf.data(), buf.size()) != whole);
+
+  return 0;
+}
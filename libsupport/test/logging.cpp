@@ -1,6 +1,8 @@
 #include "katana/Logging.h"
 
 #include <system_error>
+#include <thread>
+#include <vector>
 
 int
 main() {
@@ -18,5 +20,32 @@ main() {
   KATANA_LOG_DEBUG("this will only be printed in debug builds");
   KATANA_LOG_ASSERT(1 == 1);
 
+  katana::SetAsyncLogging(true);
+  KATANA_LOG_ASSERT(katana::IsAsyncLoggingEnabled());
+  katana::SetLogFormat(katana::LogFormat::kJson);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < 3; ++i) {
+        KATANA_LOG_WARN("async thread {} message {}", t, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  KATANA_LOG_ERROR("errors are written after queued messages");
+  katana::SetLogFormat(katana::LogFormat::kText);
+
+  // All but the first two messages are dropped and counted
+  katana::SetLogRateLimit(2);
+  for (int i = 0; i < 10; ++i) {
+    KATANA_LOG_WARN("rate limited message {}", i);
+  }
+  katana::FlushLog();
+  katana::SetLogRateLimit(0);
+  katana::SetAsyncLogging(false);
+  KATANA_LOG_ASSERT(!katana::IsAsyncLoggingEnabled());
+
   return 0;
 }
@@ -0,0 +1,113 @@
+#include "katana/MappedArray.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
+
+namespace {
+
+constexpr auto kSubsystem = katana::MemorySubsystem::kLargeArray;
+
+void
+TestGrow() {
+  katana::MappedArray<uint64_t> array;
+  std::vector<uint64_t> expected;
+  for (uint64_t i = 0; i < 1000000; ++i) {
+    array.emplace_back(i * 7);
+    expected.emplace_back(i * 7);
+  }
+  KATANA_LOG_ASSERT(array.size() == expected.size());
+  KATANA_LOG_ASSERT(array.capacity() >= array.size());
+  KATANA_LOG_ASSERT(std::equal(array.begin(), array.end(), expected.begin()));
+}
+
+void
+TestResizeZeroes() {
+  katana::MappedArray<uint32_t> array(100);
+  for (uint32_t i = 0; i < 100; ++i) {
+    KATANA_LOG_ASSERT(array[i] == 0);
+    array[i] = i + 1;
+  }
+
+  // Elements that were written before and are added again are zeroed
+  array.resize(10);
+  array.resize(50);
+  for (uint32_t i = 0; i < 10; ++i) {
+    KATANA_LOG_ASSERT(array[i] == i + 1);
+  }
+  for (uint32_t i = 10; i < 50; ++i) {
+    KATANA_LOG_ASSERT(array[i] == 0);
+  }
+
+  array.clear();
+  array.resize(200, 3);
+  for (uint32_t i = 0; i < 200; ++i) {
+    KATANA_LOG_ASSERT(array[i] == 3);
+  }
+
+  array.resize(5);
+  array.shrink_to_fit();
+  array.resize(100000);
+  for (uint32_t i = 5; i < 100000; ++i) {
+    KATANA_LOG_ASSERT(array[i] == 0);
+  }
+}
+
+void
+TestAccounting() {
+  uint64_t before = katana::GetMemoryUsage(kSubsystem);
+  {
+    katana::MappedArray<uint8_t> array(1 << 20);
+    KATANA_LOG_ASSERT(katana::GetMemoryUsage(kSubsystem) >= before + (1 << 20));
+
+    katana::MappedArray<uint8_t> moved(std::move(array));
+    KATANA_LOG_ASSERT(array.empty());
+    KATANA_LOG_ASSERT(moved.size() == 1 << 20);
+
+    moved.clear();
+    moved.shrink_to_fit();
+    KATANA_LOG_ASSERT(katana::GetMemoryUsage(kSubsystem) == before);
+    moved.resize(10);
+  }
+  KATANA_LOG_ASSERT(katana::GetMemoryUsage(kSubsystem) == before);
+}
+
+void
+TestToBuffer() {
+  uint64_t before = katana::GetMemoryUsage(kSubsystem);
+  katana::MappedArray<int32_t> array;
+  for (int32_t i = 0; i < 5000; ++i) {
+    array.emplace_back(-i);
+  }
+  const int32_t* data = array.data();
+
+  std::shared_ptr<arrow::MutableBuffer> buffer = std::move(array).ToBuffer();
+  KATANA_LOG_ASSERT(array.empty());
+  KATANA_LOG_ASSERT(buffer->size() == 5000 * sizeof(int32_t));
+  KATANA_LOG_ASSERT(buffer->is_mutable());
+  // Not copied
+  KATANA_LOG_ASSERT(buffer->data() == reinterpret_cast<const uint8_t*>(data));
+  for (int32_t i = 0; i < 5000; ++i) {
+    KATANA_LOG_ASSERT(data[i] == -i);
+  }
+
+  buffer.reset();
+  KATANA_LOG_ASSERT(katana::GetMemoryUsage(kSubsystem) == before);
+
+  auto empty = katana::MappedArray<int32_t>().ToBuffer();
+  KATANA_LOG_ASSERT(empty->size() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  TestGrow();
+  TestResizeZeroes();
+  TestAccounting();
+  TestToBuffer();
+  return 0;
+}
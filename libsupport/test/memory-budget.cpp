@@ -0,0 +1,74 @@
+#include "katana/MemoryBudget.h"
+
+#include <arrow/memory_pool.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint64_t kBudget = UINT64_C(1) << 20;
+
+void
+TestAccounting() {
+  uint64_t before = katana::GetMemoryUsage(katana::MemorySubsystem::kFileView);
+  katana::ChargeMemory(katana::MemorySubsystem::kFileView, 4096);
+  KATANA_LOG_ASSERT(
+      katana::GetMemoryUsage(katana::MemorySubsystem::kFileView) ==
+      before + 4096);
+  katana::ReleaseMemory(katana::MemorySubsystem::kFileView, 4096);
+  KATANA_LOG_ASSERT(
+      katana::GetMemoryUsage(katana::MemorySubsystem::kFileView) == before);
+}
+
+void
+TestRefuse() {
+  katana::SetMemoryBudget(kBudget);
+
+  auto res =
+      katana::ReserveMemory(katana::MemorySubsystem::kFileFrame, 2 * kBudget);
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::OutOfMemory);
+
+  uint8_t* data{};
+  KATANA_LOG_ASSERT(
+      katana::BudgetedMemoryPool()->Allocate(2 * kBudget, &data).IsOutOfMemory());
+
+  katana::SetMemoryBudget(0);
+}
+
+void
+TestReclaim() {
+  katana::SetMemoryBudget(kBudget);
+
+  // A cache holding most of the budget that gives its memory back on request
+  uint64_t cached = kBudget / 2;
+  katana::ChargeMemory(katana::MemorySubsystem::kFileView, cached);
+  uint64_t requested = 0;
+  uint64_t id = katana::AddMemoryReclaimer([&](uint64_t bytes) {
+    requested += bytes;
+    katana::ReleaseMemory(katana::MemorySubsystem::kFileView, cached);
+    cached = 0;
+  });
+
+  auto res =
+      katana::ReserveMemory(katana::MemorySubsystem::kFileFrame, kBudget * 3 / 4);
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(requested > 0);
+  KATANA_LOG_ASSERT(cached == 0);
+
+  katana::ReleaseMemory(katana::MemorySubsystem::kFileFrame, kBudget * 3 / 4);
+  katana::RemoveMemoryReclaimer(id);
+  katana::SetMemoryBudget(0);
+}
+
+}  // namespace
+
+int
+main() {
+  TestAccounting();
+  TestRefuse();
+  TestReclaim();
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/TcpCommBackend.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 3;
+
+void
+RunTask(katana::CommBackend* comm) {
+  uint32_t id = comm->ID;
+
+  // Messages of different sizes, including empty ones and ones larger than
+  // socket buffers
+  std::vector<std::string> outgoing;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    outgoing.emplace_back(std::string((id + i) * (1 << 20), 'a' + id));
+  }
+  auto res = comm->AllToAll(outgoing);
+  KATANA_LOG_VASSERT(res, "AllToAll: {}", res.error());
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    KATANA_LOG_ASSERT(
+        res.value()[i] == std::string((id + i) * (1 << 20), 'a' + i));
+  }
+
+  KATANA_LOG_ASSERT(!comm->AllToAll(std::vector<std::string>(1)));
+
+  for (uint32_t root = 0; root < kNumTasks; ++root) {
+    std::string val = comm->Broadcast(root, fmt::format("from {}", id), 6);
+    KATANA_LOG_ASSERT(val == fmt::format("from {}", root));
+    KATANA_LOG_ASSERT(comm->Broadcast(root, id == 1) == (root == 1));
+  }
+
+  comm->Barrier();
+}
+
+/// Typed collectives on Arrow buffers and their stats
+void
+RunCollectives(katana::CommBackend* comm) {
+  uint32_t id = comm->ID;
+
+  katana::CommBackend::Buffers outgoing;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    std::vector<uint64_t> values((id + i) * (1 << 17));
+    std::iota(values.begin(), values.end(), id * kNumTasks + i);
+    outgoing.emplace_back(arrow::Buffer::FromVector(std::move(values)));
+  }
+  auto incoming_res = comm->AllToAllv(outgoing);
+  KATANA_LOG_VASSERT(incoming_res, "AllToAllv: {}", incoming_res.error());
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    const auto& buffer = incoming_res.value()[i];
+    KATANA_LOG_ASSERT(
+        static_cast<uint64_t>(buffer->size()) ==
+        (id + i) * (1 << 17) * sizeof(uint64_t));
+    const auto* values = reinterpret_cast<const uint64_t*>(buffer->data());
+    for (uint64_t j = 0; j < (id + i) * (1 << 17); ++j) {
+      KATANA_LOG_ASSERT(values[j] == i * kNumTasks + id + j);
+    }
+  }
+  KATANA_LOG_ASSERT(!comm->AllToAllv(katana::CommBackend::Buffers(1)));
+
+  auto gathered_res =
+      comm->AllGather(arrow::Buffer::FromString(std::string(id, 'a')));
+  KATANA_LOG_VASSERT(gathered_res, "AllGather: {}", gathered_res.error());
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    KATANA_LOG_ASSERT(
+        gathered_res.value()[i]->ToString() == std::string(i, 'a'));
+  }
+
+  auto sum_res =
+      comm->AllReduce(std::vector<int64_t>{id, -1}, katana::ReduceOp::kSum);
+  KATANA_LOG_VASSERT(sum_res, "AllReduce: {}", sum_res.error());
+  std::vector<int64_t> expected_sum{0 + 1 + 2, -int64_t{kNumTasks}};
+  KATANA_LOG_ASSERT(sum_res.value() == expected_sum);
+  auto min_res = comm->AllReduce(id + 0.5, katana::ReduceOp::kMin);
+  KATANA_LOG_ASSERT(min_res && min_res.value() == 0.5);
+  auto max_res = comm->AllReduce(uint32_t{id}, katana::ReduceOp::kMax);
+  KATANA_LOG_ASSERT(max_res && max_res.value() == kNumTasks - 1);
+  KATANA_LOG_ASSERT(!comm->AllReduce(
+      arrow::Buffer::FromString("abc"), katana::CommDataType::kInt32,
+      katana::ReduceOp::kSum));
+
+  const auto& stats = comm->stats(katana::Collective::kAllReduce);
+  // The malformed call is rejected before it is counted
+  KATANA_LOG_ASSERT(stats.calls == 3);
+  KATANA_LOG_ASSERT(stats.bytes_received == (16 + 8 + 4) * (kNumTasks - 1));
+  KATANA_LOG_ASSERT(comm->stats(katana::Collective::kAllGather).calls == 1);
+  KATANA_LOG_ASSERT(
+      comm->stats(katana::Collective::kAllToAllv).bytes_received > 0);
+}
+
+}  // namespace
+
+int
+main() {
+  // Listen before forking so that every task knows all addresses
+  std::vector<std::unique_ptr<katana::TcpCommBackend>> comms;
+  std::vector<std::string> addresses;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    auto res = katana::TcpCommBackend::Listen("127.0.0.1:0");
+    KATANA_LOG_VASSERT(res, "listening: {}", res.error());
+    addresses.emplace_back(res.value()->address());
+    comms.emplace_back(std::move(res.value()));
+  }
+
+  std::vector<pid_t> children;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      katana::TcpCommBackend* comm = comms[i].get();
+      if (auto res = comm->Connect(addresses, i); !res) {
+        KATANA_LOG_FATAL("connecting: {}", res.error());
+      }
+      RunTask(comm);
+      RunCollectives(comm);
+      comm->Barrier();
+      _exit(0);
+    }
+    children.emplace_back(pid);
+  }
+
+  comms.clear();
+  for (pid_t pid : children) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    KATANA_LOG_VASSERT(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "task failed with status {}", status);
+  }
+
+  return 0;
+}
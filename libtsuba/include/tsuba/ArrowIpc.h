@@ -0,0 +1,49 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_ARROWIPC_H_
+#define KATANA_LIBTSUBA_TSUBA_ARROWIPC_H_
+
+#include <memory>
+#include <string_view>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/Uri.h"
+#include "tsuba/Checksum.h"
+#include "tsuba/WriteGroup.h"
+
+namespace tsuba {
+
+/// The formats of property files
+enum class PropertyFileFormat {
+  /// Encoded and possibly compressed; read by decoding into new buffers
+  kParquet,
+  /// The Arrow IPC file format (Feather v2), uncompressed. Columns are used
+  /// where they lie in the file, so loading one from local storage only maps
+  /// it; they are paged in as they are read.
+  kArrowIpc,
+};
+
+/// The names of Arrow IPC files end in this; property files are identified
+/// by their names so that part headers need not record formats
+constexpr std::string_view kArrowIpcSuffix = ".arrow";
+
+KATANA_EXPORT PropertyFileFormat PropertyFileFormatOf(std::string_view path);
+
+/// Write \param table to \param uri in the Arrow IPC file format. If
+/// \param group is null the write is synchronous; otherwise the table is
+/// serialized in the background, so it must not change until group finishes.
+KATANA_EXPORT katana::Result<void> WriteArrowIpc(
+    const std::shared_ptr<arrow::Table>& table, const katana::Uri& uri,
+    WriteGroup* group = nullptr);
+
+/// Read the Arrow IPC file at \param uri. Local files are mapped read-only
+/// and the columns point into the mapping, which lives as long as they do.
+/// Files in other storage are read into memory first. If \param checksum is
+/// not null, the file is checked against it.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> ReadArrowIpc(
+    const katana::Uri& uri,
+    std::shared_ptr<const FileChecksum> checksum = nullptr);
+
+}  // namespace tsuba
+
+#endif
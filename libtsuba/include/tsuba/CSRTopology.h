@@ -11,6 +11,21 @@ namespace tsuba {
 /// files used to have the file extension .gr (a name tradition continued here)
 /// The structs in this file describe how these GR files are laid out
 
+/// Versions of the CSR file format. The version decides the widths of the
+/// out index and destination entries:
+///
+///   kCSRTopologyVersion: 64 bit out indexes and 32 bit destinations, the
+///     layout of GraphTopology in memory
+///   kWideCSRTopologyVersion: 64 bit out indexes and destinations, for graphs
+///     with more than 2^32 nodes
+///   kCompactCSRTopologyVersion: 32 bit out indexes and destinations, for
+///     graphs with fewer than 2^32 edges
+///
+/// Version 3 is the compressed format (see CompressedCSRTopology.h).
+constexpr uint64_t kCSRTopologyVersion = 1;
+constexpr uint64_t kWideCSRTopologyVersion = 2;
+constexpr uint64_t kCompactCSRTopologyVersion = 4;
+
 /// The metadata block at the head of every CSR file
 struct CSRTopologyHeader {
   uint64_t version{0};
@@ -19,19 +34,57 @@ struct CSRTopologyHeader {
   uint64_t num_edges{0};
 };
 
-/// The header and out index array of every CSR file. The length of out_indexes
-/// depends on the number of nodes.
+/// The header and out index array of every CSR file with 64 bit out indexes.
+/// The length of out_indexes depends on the number of nodes.
 struct CSRTopologyPrefix {
   CSRTopologyHeader header;
   uint64_t out_indexes[];  // NOLINT needed for layout
 };
 
+/// The size in bytes of an out index entry in a CSR file of \param version
+constexpr uint64_t
+CSRTopologyIndexSize(uint64_t version) {
+  return version == kCompactCSRTopologyVersion ? sizeof(uint32_t)
+                                               : sizeof(uint64_t);
+}
+
+/// The size in bytes of a destination entry in a CSR file of \param version
+constexpr uint64_t
+CSRTopologyDestSize(uint64_t version) {
+  return version == kCSRTopologyVersion ||
+                 version == kCompactCSRTopologyVersion
+             ? sizeof(uint32_t)
+             : sizeof(uint64_t);
+}
+
+/// The narrowest uncompressed version that can hold a graph of
+/// \param num_nodes nodes and \param num_edges edges
+constexpr uint64_t
+CSRTopologyVersionFor(uint64_t num_nodes, uint64_t num_edges) {
+  // Node ids are less than num_nodes and out indexes are at most num_edges
+  if (num_nodes > (uint64_t{1} << 32)) {
+    return kWideCSRTopologyVersion;
+  }
+  if (num_edges < (uint64_t{1} << 32)) {
+    return kCompactCSRTopologyVersion;
+  }
+  return kCSRTopologyVersion;
+}
+
+/// The offset in a CSR file of the destination array; the out index array
+/// is padded to a multiple of 8 bytes
+constexpr uint64_t
+CSRTopologyDestsOffset(const CSRTopologyHeader& header) {
+  return sizeof(header) +
+         katana::AlignUp<uint64_t>(
+             header.num_nodes * CSRTopologyIndexSize(header.version));
+}
+
 constexpr uint64_t
 CSRTopologyFileSize(const CSRTopologyHeader& header) {
-  uint64_t edge_size =
-      header.version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
-  return sizeof(header) + ((header.num_nodes) * sizeof(uint64_t)) +
-         katana::AlignUp<uint64_t>(header.num_edges * edge_size) +
+  return CSRTopologyDestsOffset(header) +
+         katana::AlignUp<uint64_t>(
+             header.num_edges * CSRTopologyDestSize(header.version)) +
          (header.num_edges * header.edge_type_size);
 }
 
@@ -0,0 +1,41 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_CHECKSUM_H_
+#define KATANA_LIBTSUBA_TSUBA_CHECKSUM_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// The CRC-32C of each block of a file. Blocks are checked independently, so
+/// the parts of a file that are read can be verified as they arrive without
+/// reading the rest.
+struct KATANA_EXPORT FileChecksum {
+  /// The size of the pages FileView fetches, so that every fetch covers
+  /// whole blocks
+  static constexpr uint64_t kBlockSize = UINT64_C(1) << 20;
+
+  uint64_t block_size{kBlockSize};
+  /// The size of the file; its last block may be shorter than block_size
+  uint64_t size{0};
+  std::vector<uint32_t> crcs;
+
+  static FileChecksum Compute(
+      const uint8_t* data, uint64_t size, uint64_t block_size = kBlockSize);
+
+  /// Check the blocks that lie entirely within [\param begin, \param end) of
+  /// the file whose contents start at \param file. The last block of the
+  /// file counts as entirely within ranges that end at the end of the file.
+  katana::Result<void> Verify(
+      const uint8_t* file, uint64_t begin, uint64_t end) const;
+
+  /// Check every block of the file whose contents start at \param file,
+  /// with up to one thread per hardware thread
+  katana::Result<void> VerifyAll(const uint8_t* file) const;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_COMPRESSEDCSRTOPOLOGY_H_
+#define KATANA_LIBTSUBA_TSUBA_COMPRESSEDCSRTOPOLOGY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/CSRTopology.h"
+
+namespace tsuba {
+
+class FileFrame;
+
+/// Compressed CSR topology files start with the same CSRTopologyHeader and
+/// out index array as plain CSR files, so anything that only reads the
+/// prefix (e.g., RDGPrefix) works with either. The version field tells them
+/// apart. The destination array is replaced by:
+///
+///   CompressedCSRTopologyInfo info
+///   uint64_t[num_blocks] block_offsets: offset in data of the first node of
+///     each block of info.nodes_per_block nodes
+///   uint8_t[info.data_size] data: encoded neighbor lists in node order
+///
+/// Each neighbor list is stored as zigzag encoded deltas: the first
+/// destination relative to the node itself and every other destination
+/// relative to the one before it. Lists sorted by destination therefore
+/// encode best, but any order round trips. The degree of a node comes from
+/// the out index array, so empty lists take no space.
+///
+/// To find a node, a reader jumps to the start of its block and skips the
+/// lists before it.
+constexpr uint64_t kCompressedCSRTopologyVersion = 3;
+
+enum class TopologyEncoding : uint64_t {
+  /// Each delta is an LEB128 varint
+  kVarint = 1,
+  /// Each list starts with a byte holding the width in bits of its widest
+  /// delta, followed by all the deltas packed at that width
+  kBitPacked = 2,
+};
+
+constexpr uint64_t kDefaultNodesPerBlock = 16;
+
+/// Bytes at the end of the data section so that bit-packed lists can be
+/// decoded with unaligned 8 byte loads
+constexpr uint64_t kCompressedCSRTopologyPadding = 8;
+
+struct CompressedCSRTopologyInfo {
+  uint64_t encoding{0};
+  uint64_t nodes_per_block{0};
+  uint64_t data_size{0};
+};
+
+namespace internal {
+
+inline uint64_t
+ZigZagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t
+ZigZagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+}  // namespace internal
+
+/// Iterates over the destinations of one node of a compressed topology,
+/// decoding them as it goes.
+class CompressedDestIterator {
+  const uint8_t* data_{nullptr};
+  uint64_t remaining_{0};
+  uint64_t bit_{0};
+  uint32_t value_{0};
+  uint8_t width_{0};
+  TopologyEncoding encoding_{TopologyEncoding::kVarint};
+
+  uint64_t NextDelta() {
+    if (encoding_ == TopologyEncoding::kVarint) {
+      uint64_t v = 0;
+      uint8_t byte{};
+      for (int shift = 0;; shift += 7) {
+        byte = *data_++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+          break;
+        }
+      }
+      return v;
+    }
+
+    uint64_t word{};
+    std::memcpy(&word, data_ + (bit_ >> 3), sizeof(word));
+    uint64_t v = (word >> (bit_ & 7)) & ((uint64_t{1} << width_) - 1);
+    bit_ += width_;
+    return v;
+  }
+
+  void Decode() {
+    value_ = static_cast<uint32_t>(
+        static_cast<int64_t>(value_) + internal::ZigZagDecode(NextDelta()));
+  }
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = uint32_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const uint32_t*;
+  using reference = const uint32_t&;
+
+  CompressedDestIterator() = default;
+
+  /// \param data start of the encoded list of node
+  /// \param degree number of destinations of node
+  CompressedDestIterator(
+      const uint8_t* data, uint64_t degree, uint32_t node,
+      TopologyEncoding encoding)
+      : data_(data), remaining_(degree), value_(node), encoding_(encoding) {
+    if (remaining_ == 0) {
+      return;
+    }
+    if (encoding_ == TopologyEncoding::kBitPacked) {
+      width_ = *data_++;
+    }
+    Decode();
+  }
+
+  reference operator*() const { return value_; }
+  pointer operator->() const { return &value_; }
+
+  CompressedDestIterator& operator++() {
+    if (--remaining_ > 0) {
+      Decode();
+    }
+    return *this;
+  }
+
+  CompressedDestIterator operator++(int) {
+    CompressedDestIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  /// Only iterators over the same list may be compared
+  bool operator==(const CompressedDestIterator& other) const {
+    return remaining_ == other.remaining_;
+  }
+  bool operator!=(const CompressedDestIterator& other) const {
+    return !(*this == other);
+  }
+};
+
+/// A read-only view of a compressed CSR topology file in memory. The view
+/// does not own the memory.
+class KATANA_EXPORT CompressedCSRTopologyView {
+public:
+  using Node = uint32_t;
+  using Edge = uint64_t;
+
+  CompressedCSRTopologyView() = default;
+
+  /// Check that the size bytes at ptr hold a compressed CSR topology and
+  /// make a view of it
+  static katana::Result<CompressedCSRTopologyView> Make(
+      const void* ptr, uint64_t size);
+
+  uint64_t num_nodes() const { return header_->num_nodes; }
+  uint64_t num_edges() const { return header_->num_edges; }
+  TopologyEncoding encoding() const {
+    return static_cast<TopologyEncoding>(info_->encoding);
+  }
+  const uint64_t* out_indexes() const { return out_indexes_; }
+
+  /// Return the first edge of node and one past its last edge
+  std::pair<Edge, Edge> edge_range(Node node) const {
+    return std::make_pair(
+        node > 0 ? out_indexes_[node - 1] : 0, out_indexes_[node]);
+  }
+
+  uint64_t degree(Node node) const {
+    auto [begin, end] = edge_range(node);
+    return end - begin;
+  }
+
+  /// Return begin and end iterators over the destinations of node
+  std::pair<CompressedDestIterator, CompressedDestIterator> dests(
+      Node node) const {
+    return std::make_pair(
+        CompressedDestIterator(
+            FindList(node), degree(node), node, encoding()),
+        CompressedDestIterator());
+  }
+
+private:
+  const CSRTopologyHeader* header_{nullptr};
+  const uint64_t* out_indexes_{nullptr};
+  const CompressedCSRTopologyInfo* info_{nullptr};
+  const uint64_t* block_offsets_{nullptr};
+  const uint8_t* data_{nullptr};
+
+  const uint8_t* FindList(Node node) const;
+};
+
+/// Encode a topology in the compressed CSR format and append it to ff.
+///
+/// \param out_indexes one past the last edge of each node
+/// \param out_dests destination of each edge
+KATANA_EXPORT katana::Result<void> WriteCompressedCSRTopology(
+    FileFrame* ff, uint64_t num_nodes, uint64_t num_edges,
+    const uint64_t* out_indexes, const uint32_t* out_dests,
+    TopologyEncoding encoding,
+    uint64_t nodes_per_block = kDefaultNodesPerBlock);
+
+}  // namespace tsuba
+
+#endif
@@ -27,6 +27,7 @@ enum class ErrorCode {
   MpiError = 15,
   BadVersion = 16,
   GSError = 17,
+  ChecksumMismatch = 18,
 };
 
 KATANA_EXPORT ErrorCode ArrowToTsuba(arrow::StatusCode);
@@ -73,6 +74,8 @@ public:
       return "some MPI process reported an error";
     case ErrorCode::GSError:
       return "Google storage error";
+    case ErrorCode::ChecksumMismatch:
+      return "data do not match their checksum";
     default:
       return "unknown error";
     }
@@ -98,6 +101,7 @@ public:
     case ErrorCode::AzureError:
     case ErrorCode::MpiError:
     case ErrorCode::GSError:
+    case ErrorCode::ChecksumMismatch:
       return make_error_condition(std::errc::io_error);
     default:
       return std::error_condition(c, *this);
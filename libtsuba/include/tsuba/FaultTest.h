@@ -22,6 +22,49 @@ KATANA_EXPORT void FaultTestInit(
 // LOG_VERBOSE stats
 KATANA_EXPORT void FaultTestReport();
 
+/// Slowdowns injected into the storage operations of tsuba/file.h, to
+/// measure loads and stores against slow storage
+struct KATANA_EXPORT IoFaultProfile {
+  /// Added to every operation
+  uint64_t latency_us{UINT64_C(0)};
+  /// Bytes per second that all reads and writes together may move; 0 is
+  /// unlimited
+  uint64_t bandwidth{UINT64_C(0)};
+  /// Probability that an operation takes spike_us longer, to model tail
+  /// latency
+  float spike_prob{0.0f};
+  uint64_t spike_us{UINT64_C(0)};
+
+  bool active() const {
+    return latency_us != 0 || bandwidth != 0 ||
+           (spike_prob > 0.0f && spike_us != 0);
+  }
+
+  /// No slowdowns, overridden by KATANA_IO_FAULT_LATENCY_US,
+  /// KATANA_IO_FAULT_BANDWIDTH, KATANA_IO_FAULT_SPIKE_PROB and
+  /// KATANA_IO_FAULT_SPIKE_US
+  static IoFaultProfile FromEnv();
+};
+
+/// Counters of the slowdowns injected since IoFaultTestInit
+struct IoFaultStats {
+  uint64_t num_ops{UINT64_C(0)};
+  uint64_t num_spikes{UINT64_C(0)};
+  /// Total time operations were held back
+  uint64_t delay_us{UINT64_C(0)};
+};
+
+/// Slow down storage operations from now on according to profile; the
+/// default profile turns slowdowns off
+KATANA_EXPORT void IoFaultTestInit(const IoFaultProfile& profile = {});
+KATANA_EXPORT bool IoFaultTestActive();
+KATANA_EXPORT IoFaultStats IoFaultTestStats();
+
+/// Block the calling thread as long as the profile adds to an operation that
+/// moves bytes. Transfers of concurrent operations queue for the bandwidth
+/// one after the other.
+KATANA_EXPORT void IoDelay(uint64_t bytes);
+
 // PullThePlug (virtually) Compile this out if NDEBUG?
 #define TSUBA_PTP(...)                                                         \
   do {                                                                         \
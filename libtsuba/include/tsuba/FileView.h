@@ -2,21 +2,62 @@
 #define KATANA_LIBTSUBA_TSUBA_FILEVIEW_H_
 
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <future>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <parquet/arrow/reader.h>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/Checksum.h"
 
 namespace tsuba {
 
+/// How a FileView will be read, see FileView::Advise
+enum class AccessPattern {
+  /// After each read, fetch a little more than its size past its end
+  kNormal,
+  /// Keep several ranges past the last read in flight
+  kSequential,
+  /// Only fetch what is read or hinted with FileView::WillNeed
+  kRandom,
+};
+
+struct ReadaheadOptions {
+  /// Maximum number of fetches in flight at once
+  uint32_t max_in_flight{8};
+  /// Size of each fetch started by readahead or WillNeed
+  uint64_t range_size{UINT64_C(8) << 20};
+  /// Maximum number of bytes in flight or, for sequential reads, fetched past
+  /// the last read
+  uint64_t max_bytes{UINT64_C(128) << 20};
+};
+
+struct FileViewStats {
+  /// Bytes fetched ahead of the reads that needed them
+  uint64_t prefetched_bytes{0};
+  /// Number of reads that had to wait for a fetch to finish
+  uint64_t stalls{0};
+  /// Total time reads waited for fetches
+  uint64_t stall_time_us{0};
+};
+
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
+public:
+  /// See SetPlacement
+  using PlaceFunc =
+      std::function<void(uint8_t* mem, uint64_t offset, uint64_t size)>;
+
+private:
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
+    uint64_t size;
     std::future<katana::Result<void>> work;
   };
 
@@ -27,8 +68,21 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   int64_t mem_start_{0};
   std::string filename_;
   bool valid_{false};
+  bool read_only_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  AccessPattern pattern_{AccessPattern::kNormal};
+  ReadaheadOptions readahead_;
+  /// End of the ranges fetched by sequential readahead
+  uint64_t readahead_end_{0};
+  /// Ranges given to WillNeed that have not been fetched yet
+  std::deque<std::pair<uint64_t, uint64_t>> hinted_;
+  FileViewStats stats_;
+  std::shared_ptr<const FileChecksum> checksum_;
+  PlaceFunc place_;
+  /// Bytes of fetched pages charged to the memory budget. Pages mapped by
+  /// BindReadOnly are backed by the file and not charged.
+  uint64_t charged_{0};
 
 public:
   FileView() = default;
@@ -43,9 +97,19 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
+        read_only_(other.read_only_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        pattern_(other.pattern_),
+        readahead_(other.readahead_),
+        readahead_end_(other.readahead_end_),
+        hinted_(std::move(other.hinted_)),
+        stats_(other.stats_),
+        checksum_(std::move(other.checksum_)),
+        place_(std::move(other.place_)),
+        charged_(other.charged_) {
     other.valid_ = false;
+    other.charged_ = 0;
   }
 
   FileView& operator=(FileView&& other) noexcept {
@@ -60,10 +124,20 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       valid_ = other.valid_;
+      read_only_ = other.read_only_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      pattern_ = other.pattern_;
+      readahead_ = other.readahead_;
+      readahead_end_ = other.readahead_end_;
+      hinted_ = std::move(other.hinted_);
+      stats_ = other.stats_;
+      checksum_ = std::move(other.checksum_);
+      place_ = std::move(other.place_);
+      charged_ = other.charged_;
       other.valid_ = false;
+      other.charged_ = 0;
     }
     return *this;
   }
@@ -90,10 +164,69 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Map the whole file directly into memory (MAP_SHARED, PROT_READ) rather
+  /// than reserving an anonymous region and copying file contents into it.
+  /// This avoids holding two copies of the file (page cache and anonymous
+  /// memory) for large, read-mostly files like topologies.
+  ///
+  /// Only files on local storage can be mapped; for other storage backends
+  /// this falls back to Bind(filename, true) and read_only() is false.
+  ///
+  /// \param filename path to the file to map
+  /// \param populate if true, prefault the mapping (MAP_POPULATE) so that
+  /// later accesses do not take page faults
+  katana::Result<void> BindReadOnly(std::string_view filename, bool populate);
+
+  /// Fetch the pages of [begin, end) that have not been fetched yet. If
+  /// \param resolve, wait until all of the range, including pages fetched
+  /// earlier in the background, can be read. Fetched pages are reserved in
+  /// the memory budget (see katana::ReserveMemory) first, and fills that do
+  /// not fit fail with katana::ErrorCode::OutOfMemory.
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Tell this view how it will be read so that Read can fetch data before
+  /// it is needed. The pattern lasts across calls to Bind.
+  void Advise(AccessPattern pattern, const ReadaheadOptions& opts = {}) {
+    pattern_ = pattern;
+    readahead_ = opts;
+  }
+
+  /// Hint that [begin, end) will be read soon. The range is fetched in
+  /// pieces of ReadaheadOptions::range_size, some now and the rest by later
+  /// reads as earlier fetches finish. Hints are fetched in the order given.
+  katana::Result<void> WillNeed(uint64_t begin, uint64_t end);
+
+  /// Release the memory of the pages that lie entirely within [begin, end).
+  /// They are fetched again when they are read or filled later, so the
+  /// memory returned by ptr() for them must not be used until then. Fetches
+  /// in flight to the pages are waited for first.
+  katana::Result<void> Evict(uint64_t begin, uint64_t end);
+
+  /// Check the file bound next against \param checksum until it is
+  /// unbound. Fetched data are checked in the background as they arrive, and
+  /// reads of data that do not match fail with ErrorCode::ChecksumMismatch.
+  /// Files mapped by BindReadOnly are checked whole when they are bound,
+  /// which reads all of them.
+  void ExpectChecksum(std::shared_ptr<const FileChecksum> checksum) {
+    checksum_ = std::move(checksum);
+  }
+
+  /// Call \param place with the memory of each range that Fill is about to
+  /// fetch, [offset, offset + size) of the file at mem, once it is writable
+  /// and before the fetch writes to it; e.g., to fault its pages in from the
+  /// threads whose NUMA nodes they should be on. place must not change the
+  /// contents of the memory. The function lasts until it is replaced; an
+  /// empty one turns placement off.
+  void SetPlacement(PlaceFunc place) { place_ = std::move(place); }
+
+  const FileViewStats& stats() const { return stats_; }
+
   bool Valid() const { return valid_; }
 
+  /// \returns true if this view maps the underlying file directly. The memory
+  /// returned by ptr() must not be written to in this case.
+  bool read_only() const { return read_only_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -169,6 +302,24 @@ private:
   // Start asynchronously fetching data that we think we might need from storage
   // @start and @size give the location and range of the previous read
   katana::Result<void> PreFetch(int64_t start, int64_t size);
+
+  // Forget fetches that have finished
+  katana::Result<void> Reap();
+
+  // Wrap fetch of [begin, begin + size) to check it against checksum_ once
+  // it has arrived
+  std::future<katana::Result<void>> VerifyWhenFetched(
+      std::future<katana::Result<void>> fetch, uint64_t begin, uint64_t size);
+
+  // Name the file and range of failed fetch when res has no context
+  katana::Result<void> FetchResult(
+      const FillingRange& fetch, katana::Result<void> res) const;
+
+  // Whether another fetch may start without exceeding readahead_
+  bool CanFetch() const;
+
+  // Start fetching hinted ranges while CanFetch
+  katana::Result<void> FetchHinted();
 };
 }  // namespace tsuba
 
@@ -1,15 +1,39 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETREADER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETREADER_H_
 
+#include <functional>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <arrow/api.h>
 
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/Checksum.h"
+
+namespace parquet {
+class RowGroupMetaData;
+}  // namespace parquet
 
 namespace tsuba {
 
+/// Counters of the parquet files read by ParquetReader, summed over the
+/// process. A read waits for the file data to arrive (fetch), decodes the
+/// row groups into arrow tables (decode) and then fixes up and combines
+/// their columns (copy).
+struct ParquetReadStats {
+  uint64_t num_files{UINT64_C(0)};
+  /// Time reads waited for file data, summed over the readers
+  uint64_t fetch_us{UINT64_C(0)};
+  /// Time spent decoding, not counting the time waiting for data
+  uint64_t decode_us{UINT64_C(0)};
+  /// Time spent converting and combining the decoded columns
+  uint64_t copy_us{UINT64_C(0)};
+};
+
+KATANA_EXPORT ParquetReadStats GetParquetReadStats();
+
 class KATANA_EXPORT ParquetReader {
 public:
   struct Slice {
@@ -17,22 +41,61 @@ public:
     int64_t length;
   };
 
+  /// A RowGroupFilter returns false for row groups that can be skipped
+  /// entirely, typically by inspecting their column statistics
+  using RowGroupFilter = std::function<bool(const parquet::RowGroupMetaData&)>;
+
+  struct ReadOpts {
+    /// Read only this range of rows
+    std::optional<Slice> slice;
+    /// Read only these columns; nullopt means all columns
+    std::optional<std::vector<std::string>> columns;
+    /// Skip the row groups rejected by this filter. The rows of skipped row
+    /// groups are absent from the result, so this cannot be combined with a
+    /// slice.
+    RowGroupFilter row_group_filter;
+    /// Decode row groups in parallel on arrow's CPU thread pool
+    bool use_threads{true};
+    /// Keep string columns that were written with parquet dictionaries
+    /// dictionary encoded, as arrow::DictionaryArrays of int32 indices into
+    /// a string dictionary, when at most half of their values are distinct.
+    /// Other string columns are read as large strings.
+    bool dictionary_strings{true};
+    /// Check the data read against this checksum, if any, as they arrive
+    std::shared_ptr<const FileChecksum> checksum;
+  };
+
   /// \returns a Reader that will read a table from storage location optionally
   /// reading only part of the table defined by \param slice
   static katana::Result<std::unique_ptr<ParquetReader>> Make(
       std::optional<Slice> slice = std::nullopt);
 
+  /// \returns a Reader that will read a table from storage location as
+  /// described by \param opts
+  static katana::Result<std::unique_ptr<ParquetReader>> Make(
+      const ReadOpts& opts);
+
+  /// \returns a RowGroupFilter that keeps the row groups whose statistics for
+  /// leaf column \param column may contain values in [\param min, \param max].
+  /// Row groups without statistics for the column, or whose column is not an
+  /// integer type, are always kept.
+  static RowGroupFilter MakeRangeFilter(int column, int64_t min, int64_t max);
+
   /// read table from \param uri
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUri(
       const katana::Uri& uri);
 
+  /// \returns the number of rows in the table stored at \param uri; only the
+  /// file footer is read
+  static katana::Result<int64_t> NumRows(const katana::Uri& uri);
+
 private:
-  ParquetReader(std::optional<Slice> slice) : slice_(slice) {}
+  ParquetReader(const ReadOpts& opts) : opts_(opts) {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
 
-  std::optional<Slice> slice_;
+  ReadOpts opts_;
 };
 
 }  // namespace tsuba
@@ -1,36 +1,106 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/PropertyStats.h"
 #include "tsuba/WriteGroup.h"
 
 namespace tsuba {
 
+/// How one column is encoded
+struct ColumnWriteOptions {
+  arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+  /// Codec specific level; the codec default if absent
+  std::optional<int> compression_level;
+  /// Store each distinct value once and the column as indices into them,
+  /// which pays off when few values are distinct
+  bool dictionary{true};
+  /// Store the bytes of floating point values grouped by their position in
+  /// the value, which compresses better; ignored for other types
+  bool byte_stream_split{false};
+};
+
+struct ParquetWriteOptions {
+  /// The options of the columns without an entry in columns
+  ColumnWriteOptions defaults;
+  /// Options by column name
+  std::unordered_map<std::string, ColumnWriteOptions> columns;
+  /// Readers decode row groups in parallel and skip those a filter excludes
+  int64_t row_group_length{kPropertyRowGroupLength};
+  /// Choose the encodings of the columns without an entry in columns from
+  /// their statistics (see TuneColumn); the compression stays that of
+  /// defaults
+  bool auto_tune{false};
+
+  /// The defaults, overridden by KATANA_PARQUET_COMPRESSION (uncompressed,
+  /// snappy, lz4 or zstd), KATANA_PARQUET_COMPRESSION_LEVEL,
+  /// KATANA_PARQUET_ROW_GROUP_LENGTH and KATANA_PARQUET_AUTO_TUNE
+  static ParquetWriteOptions FromEnv();
+
+  /// \returns base with the encodings for a column of type whose values have
+  /// stats: a dictionary only when at most half of the values are distinct,
+  /// or always for dictionary arrays, and byte stream split for floating
+  /// point values that are not dictionary encoded
+  static ColumnWriteOptions TuneColumn(
+      const arrow::DataType& type, const PropertyStats& stats,
+      const ColumnWriteOptions& base);
+};
+
+/// Counters of the parquet files encoded by ParquetWriter, summed over the
+/// process
+struct ParquetWriteStats {
+  uint64_t num_files{UINT64_C(0)};
+  /// Size of the arrow buffers that were encoded
+  uint64_t arrow_bytes{UINT64_C(0)};
+  /// Size of the files they were encoded to
+  uint64_t encoded_bytes{UINT64_C(0)};
+  /// Time spent encoding, summed over the threads that encoded
+  uint64_t encode_us{UINT64_C(0)};
+
+  double compression_ratio() const {
+    return encoded_bytes == 0 ? 1.0
+                              : static_cast<double>(arrow_bytes) /
+                                    static_cast<double>(encoded_bytes);
+  }
+};
+
+KATANA_EXPORT ParquetWriteStats GetParquetWriteStats();
+
 class KATANA_EXPORT ParquetWriter {
 public:
   /// \returns a Writer that will write a table consisting of a single column
   /// \param array named \param name to a storage location
   static katana::Result<std::unique_ptr<ParquetWriter>> Make(
-      std::shared_ptr<arrow::ChunkedArray> array, const std::string& name);
+      std::shared_ptr<arrow::ChunkedArray> array, const std::string& name,
+      const ParquetWriteOptions& opts = ParquetWriteOptions::FromEnv());
 
   /// \returns a Writer that will write \param table to a storage location
   static katana::Result<std::unique_ptr<ParquetWriter>> Make(
-      std::shared_ptr<arrow::Table> table);
+      std::shared_ptr<arrow::Table> table,
+      const ParquetWriteOptions& opts = ParquetWriteOptions::FromEnv());
 
   /// write table out to a storage location \param uri If \param group is null,
   /// the write is synchronous, if not an asynchronous write is started to be
-  /// managed by group
+  /// managed by group. Asynchronous writes also encode the table in the
+  /// background, so the table must not change until group finishes; encoding
+  /// errors are reported by WriteGroup::Finish.
   katana::Result<void> WriteToUri(
       const katana::Uri& uri, WriteGroup* group = nullptr);
 
 private:
-  ParquetWriter(std::shared_ptr<arrow::Table> table)
-      : table_(std::move(table)) {}
+  ParquetWriter(std::shared_ptr<arrow::Table> table, ParquetWriteOptions opts)
+      : table_(std::move(table)), opts_(std::move(opts)) {}
 
   std::shared_ptr<arrow::Table> table_;
+  ParquetWriteOptions opts_;
 };
 
 }  // namespace tsuba
@@ -0,0 +1,70 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_PROPERTYSTATS_H_
+#define KATANA_LIBTSUBA_TSUBA_PROPERTYSTATS_H_
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// Property files are split into row groups of this many rows so that readers
+/// can decode them in parallel and slices can skip what they do not need.
+/// Property statistics are kept for blocks of the same rows.
+constexpr int64_t kPropertyRowGroupLength = 1 << 22;
+
+/// Statistics of a range of rows of a property
+struct KATANA_EXPORT ColumnStats {
+  int64_t offset{0};
+  int64_t length{0};
+  int64_t null_count{0};
+  /// Estimate of the number of distinct non-null values; absent for types
+  /// without an estimate (e.g., lists)
+  std::optional<int64_t> distinct_count;
+  /// Bounds of the non-null values, converted to double and rounded outward;
+  /// absent if unknown, e.g., for non-numeric types. Timestamps, dates and
+  /// times are bounded by their integer representation.
+  std::optional<double> min;
+  std::optional<double> max;
+
+  /// \returns false if no value in these rows lies in [lo, hi]
+  bool MayContain(double lo, double hi) const {
+    if (length == null_count) {
+      return false;
+    }
+    return min.value_or(-std::numeric_limits<double>::infinity()) <= hi &&
+           lo <= max.value_or(std::numeric_limits<double>::infinity());
+  }
+};
+
+/// Statistics of a property: those of all of its rows and, as a zone map,
+/// those of each block of kPropertyRowGroupLength rows
+struct KATANA_EXPORT PropertyStats {
+  ColumnStats column;
+  std::vector<ColumnStats> blocks;
+
+  /// \returns the [begin, end) ranges of rows that may hold values in
+  /// [lo, hi]; rows outside of them certainly do not
+  std::vector<std::pair<int64_t, int64_t>> RowRangesMayContain(
+      double lo, double hi) const;
+};
+
+/// Compute the statistics of every row of array
+KATANA_EXPORT PropertyStats ComputePropertyStats(
+    const arrow::ChunkedArray& array);
+
+KATANA_EXPORT void to_json(nlohmann::json& j, const ColumnStats& stats);
+KATANA_EXPORT void from_json(const nlohmann::json& j, ColumnStats& stats);
+
+KATANA_EXPORT void to_json(nlohmann::json& j, const PropertyStats& stats);
+KATANA_EXPORT void from_json(const nlohmann::json& j, PropertyStats& stats);
+
+}  // namespace tsuba
+
+#endif
@@ -2,8 +2,11 @@
 #define KATANA_LIBTSUBA_TSUBA_RDG_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -12,12 +15,15 @@
 #include "katana/Result.h"
 #include "katana/Uri.h"
 #include "katana/config.h"
+#include "tsuba/ArrowIpc.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
 #include "tsuba/PartitionMetadata.h"
+#include "tsuba/PropertyStats.h"
 #include "tsuba/RDGLineage.h"
 #include "tsuba/WriteGroup.h"
+#include "tsuba/file.h"
 #include "tsuba/tsuba.h"
 
 namespace tsuba {
@@ -26,6 +32,21 @@ class RDGMeta;
 class RDGCore;
 struct PropStorageInfo;
 
+/// A batch of changes to the node or edge properties of an RDG, applied by
+/// RDG::UpdateNodeProperties or UpdateEdgeProperties with a single rebuild
+/// of the property table instead of one per change
+struct KATANA_EXPORT PropertyUpdate {
+  /// The indices of the properties to remove
+  std::vector<uint32_t> removed;
+  /// New values for properties, by index, each of the type of the values it
+  /// replaces. A replaced property keeps its position and is written to
+  /// storage again the next time the RDG is stored.
+  std::vector<std::pair<uint32_t, std::shared_ptr<arrow::ChunkedArray>>>
+      replaced;
+  /// Properties to append after the remaining ones; may be null
+  std::shared_ptr<arrow::Table> added;
+};
+
 struct KATANA_EXPORT RDGLoadOptions {
   /// Which partition of the RDG on storage should be loaded
   /// nullopt means the partition associated with the current host's ID will be
@@ -37,6 +58,39 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   const std::vector<std::string>* edge_properties{nullptr};
+  /// Map the topology file directly into memory read-only instead of copying
+  /// it into anonymous memory. Only applies to local storage; other storage
+  /// backends always copy. Topologies loaded this way are immutable and
+  /// operations that rewrite the topology in place will first make a copy.
+  bool map_topology_read_only{false};
+  /// When mapping the topology read-only, prefault all of its pages during
+  /// load rather than on first access
+  bool populate_topology{false};
+  /// If set, read the topology by binding its file without reading any of it
+  /// and calling this, e.g., to fill it range by range with
+  /// FileView::SetPlacement so that its pages land on the NUMA nodes of the
+  /// threads that will use them (see katana::TopologyFiller). Whatever it
+  /// leaves unfilled is read afterwards. Ignored when mapping the topology
+  /// read-only.
+  std::function<katana::Result<void>(FileView*)> fill_topology;
+  /// Defer reading node and edge properties from storage until they are first
+  /// used (see RDG::EnsureNodePropertyLoaded). Until a property is loaded, its
+  /// column in the property tables is a placeholder of type null with the
+  /// correct number of rows.
+  bool lazy_properties{false};
+  /// With lazy_properties, drop loaded properties again when the memory
+  /// budget runs short (see katana::SetMemoryBudget) and read them from
+  /// storage the next time they are used. Only properties that have not
+  /// changed since they were stored and that are not referenced outside of
+  /// the property tables are dropped. Properties may be dropped by whichever
+  /// thread needs memory, so the property tables must only be read through
+  /// LoadNodeProperty and LoadEdgeProperty while other threads load data.
+  bool evict_lazy_properties{false};
+  /// Check the topology and property files against the checksums recorded
+  /// when they were stored, as their data arrive. Loads of corrupt files
+  /// fail with ErrorCode::ChecksumMismatch. Files stored by older versions
+  /// have no checksums and are not checked.
+  bool verify_checksums{true};
 };
 
 class KATANA_EXPORT RDG {
@@ -58,6 +112,12 @@ public:
   /// Store this RDG at \param handle; if \param ff is not null, it is persisted
   /// as the topology for this RDG. Add \param command_line to metadata to aid
   /// in tracking lineage
+  ///
+  /// Storing into the directory the RDG was loaded from writes only the
+  /// properties and partition arrays that are not in storage yet, i.e., those
+  /// added or renamed since; the new version references the files of the
+  /// others. The version becomes visible only once every file of it is
+  /// written, so a failed store leaves the previous version intact.
   katana::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
       std::unique_ptr<FileFrame> ff = nullptr);
@@ -71,6 +131,53 @@ public:
   katana::Result<void> RemoveNodeProperty(uint32_t i);
   katana::Result<void> RemoveEdgeProperty(uint32_t i);
 
+  /// Apply \param update to the node properties. Either every change is
+  /// applied or, on error, none is.
+  katana::Result<void> UpdateNodeProperties(const PropertyUpdate& update);
+  katana::Result<void> UpdateEdgeProperties(const PropertyUpdate& update);
+
+  /// Read node property \param i from storage if its load was deferred by
+  /// RDGLoadOptions::lazy_properties; otherwise do nothing. Loading does not
+  /// change the logical contents of the RDG, so these are const. Loads are
+  /// serialized internally, but they must not race with calls that add or
+  /// remove properties.
+  katana::Result<void> EnsureNodePropertyLoaded(uint32_t i) const;
+  katana::Result<void> EnsureEdgePropertyLoaded(uint32_t i) const;
+
+  /// Like EnsureNodePropertyLoaded, but also return the column of node
+  /// property \param i, which is read under the same lock so that it cannot
+  /// be evicted in between (see RDGLoadOptions::evict_lazy_properties)
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> LoadNodeProperty(
+      uint32_t i) const;
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> LoadEdgeProperty(
+      uint32_t i) const;
+
+  /// Replace the in-memory column of loaded node property \param i with the
+  /// single column of \param props, e.g., to store it in fewer chunks. The
+  /// property keeps its storage location, so the new column must hold the
+  /// same values as the old one.
+  katana::Result<void> ReplaceNodeProperty(
+      uint32_t i, const std::shared_ptr<arrow::Table>& props);
+  katana::Result<void> ReplaceEdgeProperty(
+      uint32_t i, const std::shared_ptr<arrow::Table>& props);
+
+  /// \returns false if node property \param i is a deferred placeholder
+  bool IsNodePropertyLoaded(uint32_t i) const;
+  bool IsEdgePropertyLoaded(uint32_t i) const;
+
+  /// \returns the statistics recorded when node property \param i was
+  /// written to storage, or null if there are none, e.g., because the
+  /// property was added since. They are available without loading the
+  /// property.
+  const PropertyStats* NodePropertyStats(uint32_t i) const;
+  const PropertyStats* EdgePropertyStats(uint32_t i) const;
+
+  /// Start reading a deferred node property in the background. A later call
+  /// to EnsureNodePropertyLoaded waits for this read instead of issuing a new
+  /// one.
+  void PrefetchNodeProperty(uint32_t i) const;
+  void PrefetchEdgeProperty(uint32_t i) const;
+
   void MarkAllPropertiesPersistent();
 
   katana::Result<void> MarkNodePropertiesPersistent(
@@ -78,12 +185,39 @@ public:
   katana::Result<void> MarkEdgePropertiesPersistent(
       const std::vector<std::string>& persist_edge_props);
 
+  /// Store node property \param i in \param format from now on. A property
+  /// already stored in another format is rewritten by the next Store.
+  katana::Result<void> SetNodePropertyFileFormat(
+      uint32_t i, PropertyFileFormat format);
+  katana::Result<void> SetEdgePropertyFileFormat(
+      uint32_t i, PropertyFileFormat format);
+
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
+  /// Record where the next stored version comes from (see
+  /// RDGLineage::provenance). The entries are cleared once that version is
+  /// committed, so each version only describes its own derivation.
+  void AddProvenance(const std::string& key, const std::string& value);
+
   /// Load the RDG described by the metadata in handle into memory.
   static katana::Result<RDG> Make(RDGHandle handle, const RDGLoadOptions& opts);
 
+  /// Make an RDG with node properties \param node_props and edge properties
+  /// \param edge_props of this one that shares their columns and the
+  /// topology file storage instead of copying them. Deferred properties are
+  /// loaded first. The shared columns get read-only buffers in both RDGs, so
+  /// neither can write to the memory of the other in place; see
+  /// katana::ShareReadOnly. Properties keep their storage locations, so
+  /// storing the copy into the directory of this RDG rewrites only what
+  /// changed. Like loading, this must not race with calls that add or remove
+  /// properties.
+  katana::Result<RDG> Copy(
+      const std::vector<std::string>& node_props,
+      const std::vector<std::string>& edge_props) const;
+
+  /// Unbind the topology from its file, e.g., because it is about to be
+  /// replaced. Auxiliary topologies derived from it are dropped.
   katana::Result<void> UnbindTopologyFileStorage();
 
   /// Inform this RDG that it's topology is in storage at this location
@@ -91,12 +225,31 @@ public:
   /// the correct directory for this RDG
   katana::Result<void> SetTopologyFile(const katana::Uri& new_top);
 
+  /// Store \param ff, a topology derived from the topology of this RDG such
+  /// as its transpose, as the auxiliary topology \param name the next time
+  /// this RDG is stored. It replaces any auxiliary topology with the same
+  /// name. Auxiliary topologies are tied to the topology file they were
+  /// derived from and are ignored once the RDG is stored with another one.
+  void AddAuxTopology(const std::string& name, std::unique_ptr<FileFrame> ff);
+
+  /// \returns true if auxiliary topology \param name of the current topology
+  /// is in storage
+  bool HasAuxTopology(const std::string& name) const;
+
+  /// Read auxiliary topology \param name from storage on first use, mapping
+  /// it read-only where storage allows. The view lives as long as this RDG
+  /// or until UnbindTopologyFileStorage.
+  katana::Result<const FileView*> LoadAuxTopology(
+      const std::string& name) const;
+
   void AddMirrorNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     mirror_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   void AddMasterNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     master_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   //
@@ -121,6 +274,7 @@ public:
   }
   void set_master_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     master_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
@@ -129,6 +283,7 @@ public:
   }
   void set_mirror_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     mirror_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_ids() const {
@@ -136,6 +291,7 @@ public:
   }
   void set_host_to_owned_global_ids(std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_user_id() const {
@@ -143,6 +299,7 @@ public:
   }
   void set_local_to_user_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_user_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_global_id() const {
@@ -150,6 +307,7 @@ public:
   }
   void set_local_to_global_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_global_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const PartitionMetadata& part_metadata() const;
@@ -157,12 +315,25 @@ public:
 
   const FileView& topology_file_storage() const;
 
+  /// When each file was read while loading, i.e., every property file read
+  /// by Make and the topology, in no particular order
+  const std::vector<FileLoadTime>& load_timeline() const;
+
 private:
+  struct LazyProperties;
+  struct AuxTopologies;
+
   RDG(std::unique_ptr<RDGCore>&& core);
 
+  katana::Result<void> AddLazyProperties(
+      const katana::Uri& metadata_dir, bool node);
+
+  katana::Result<void> LoadAllLazyProperties();
+
   void InitEmptyTables();
 
-  katana::Result<void> DoMake(const katana::Uri& metadata_dir);
+  katana::Result<void> DoMake(
+      const katana::Uri& metadata_dir, const RDGLoadOptions& opts);
 
   static katana::Result<RDG> Make(
       const RDGMeta& meta, const RDGLoadOptions& opts);
@@ -177,12 +348,26 @@ private:
       RDGHandle handle, const std::string& command_line,
       std::unique_ptr<WriteGroup> desc);
 
+  /// \returns the checksum to check the file at \param path against, or
+  /// null if there is none or checksums are not verified
+  std::shared_ptr<const FileChecksum> ChecksumToVerify(
+      const std::string& path) const;
+
   //
   // Data
   //
 
+  // Bookkeeping for properties whose loads were deferred; null unless the RDG
+  // was made with RDGLoadOptions::lazy_properties. It may evict properties
+  // from core_, so it is declared first to be replaced before core_ on move
+  // assignment, and ~RDG destroys it first.
+  std::unique_ptr<LazyProperties> lazy_;
+
   std::unique_ptr<RDGCore> core_;
 
+  // Auxiliary topologies waiting to be stored and those read from storage
+  std::unique_ptr<AuxTopologies> aux_;
+
   std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes_;
   std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes_;
   // Called while constructing to put these arrays into a usable state for Distribution
@@ -190,6 +375,11 @@ private:
   std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_ids_;
   std::shared_ptr<arrow::ChunkedArray> local_to_user_id_;
   std::shared_ptr<arrow::ChunkedArray> local_to_global_id_;
+  // False while the partition arrays above are the ones in the files listed
+  // by the part header, which a store then references instead of rewriting
+  bool part_arrays_dirty_{true};
+  // See RDGLoadOptions::verify_checksums
+  bool verify_checksums_{true};
 
   /// name of the graph that was used to load this RDG
   katana::Uri rdg_dir_;
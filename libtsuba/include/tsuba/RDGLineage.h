@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_RDGLINEAGE_H_
 #define KATANA_LIBTSUBA_TSUBA_RDGLINEAGE_H_
 
+#include <map>
 #include <string>
 
 #include "katana/JSON.h"
@@ -9,10 +10,20 @@ namespace tsuba {
 
 class RDGLineage {
   std::string command_line_{};
+  std::map<std::string, std::string> provenance_{};
 
 public:
   const std::string& command_line() { return command_line_; }
   void AddCommandLine(const std::string& cmd);
+
+  /// Key/value pairs describing the input a version was derived from, e.g.,
+  /// the change log batch applied to the previous version
+  const std::map<std::string, std::string>& provenance() const {
+    return provenance_;
+  }
+  void AddProvenance(const std::string& key, const std::string& value);
+  void ClearProvenance();
+
   void ClearLineage();
 
   friend void to_json(nlohmann::json& j, const RDGLineage& lineage);
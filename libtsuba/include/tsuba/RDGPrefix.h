@@ -2,8 +2,10 @@
 #define KATANA_LIBTSUBA_TSUBA_RDGPREFIX_H_
 
 #include <cstdint>
+#include <string>
 
 #include "tsuba/CSRTopology.h"
+#include "tsuba/Checksum.h"
 #include "tsuba/FileView.h"
 #include "tsuba/tsuba.h"
 
@@ -22,7 +24,16 @@ public:
   uint64_t num_edges() const { return prefix_->header.num_edges; }
   uint64_t version() const { return prefix_->header.version; }
   uint64_t view_offset() const { return view_offset_; }
+  /// The file holding the topology; the destinations of the edges start at
+  /// view_offset()
+  const std::string& topology_path() const { return topology_path_; }
+  /// The checksum of the topology file, or null if it has none
+  const std::shared_ptr<const FileChecksum>& topology_checksum() const {
+    return topology_checksum_;
+  }
 
+  /// The out indexes of the nodes. Only files whose versions have 64 bit out
+  /// indexes (see CSRTopologyIndexSize) have them; check version() first.
   const uint64_t* out_indexes() const {
     return static_cast<const uint64_t*>(prefix_->out_indexes);
   }
@@ -38,15 +49,22 @@ public:
   }
 
 private:
-  RDGPrefix(FileView&& prefix_storage, uint64_t view_offset)
+  RDGPrefix(
+      FileView&& prefix_storage, uint64_t view_offset,
+      std::string topology_path,
+      std::shared_ptr<const FileChecksum> topology_checksum)
       : prefix_storage_(std::move(prefix_storage)),
         view_offset_(view_offset),
+        topology_path_(std::move(topology_path)),
+        topology_checksum_(std::move(topology_checksum)),
         prefix_(prefix_storage_.ptr<CSRTopologyPrefix>()) {}
 
   RDGPrefix() = default;
 
   FileView prefix_storage_;
   uint64_t view_offset_;
+  std::string topology_path_;
+  std::shared_ptr<const FileChecksum> topology_checksum_;
   const CSRTopologyPrefix* prefix_{nullptr};
 
   static katana::Result<RDGPrefix> DoMakePrefix(const RDGMeta& meta);
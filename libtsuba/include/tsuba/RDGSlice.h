@@ -10,6 +10,7 @@
 #include "katana/Uri.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
+#include "tsuba/file.h"
 #include "tsuba/tsuba.h"
 
 namespace tsuba {
@@ -48,6 +49,10 @@ public:
   const std::shared_ptr<arrow::Table>& edge_properties() const;
   const FileView& topology_file_storage() const;
 
+  /// When each file was read while loading, i.e., every property file read
+  /// by Make and the topology, in no particular order
+  const std::vector<FileLoadTime>& load_timeline() const;
+
 private:
   static katana::Result<RDGSlice> Make(
       const RDGMeta& meta, const std::vector<std::string>* node_props,
@@ -0,0 +1,100 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_REMOTEFETCHER_H_
+#define KATANA_LIBTSUBA_TSUBA_REMOTEFETCHER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+struct RemoteFetchOptions {
+  /// Ranges larger than this are fetched in parts of this size, and
+  /// adjacent ranges are merged up to this size
+  uint64_t part_size{UINT64_C(16) << 20};
+  /// Number of parts fetched at once
+  uint32_t concurrency{16};
+  /// Maximum number of bytes of the parts being fetched at once. A part
+  /// larger than this is still fetched, alone.
+  uint64_t max_bytes_in_flight{UINT64_C(512) << 20};
+
+  /// The defaults, overridden by KATANA_REMOTE_PART_SIZE,
+  /// KATANA_REMOTE_CONCURRENCY and KATANA_REMOTE_MAX_BYTES_IN_FLIGHT
+  static RemoteFetchOptions FromEnv();
+};
+
+/// Schedule the range reads of a remote storage backend. A single request
+/// to an object store is limited by the throughput of one connection, so
+/// RemoteFetcher splits large ranges into parts that are fetched in
+/// parallel. Small ranges, e.g., the pages FileView fills one at a time, are
+/// merged with the queued ranges next to them in the same file and buffer,
+/// so they cost one request instead of many.
+///
+/// Parts are fetched by a pool of threads that start with the first fetch.
+/// Backends that keep a connection per thread (see katana::HttpGetRange)
+/// thereby reuse concurrency connections.
+class KATANA_EXPORT RemoteFetcher {
+public:
+  /// Read exactly size bytes at start of uri into buf
+  using GetRangeFunc = std::function<katana::Result<void>(
+      const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf)>;
+
+  RemoteFetcher(GetRangeFunc get_range, const RemoteFetchOptions& opts)
+      : get_range_(std::move(get_range)), opts_(opts) {}
+  RemoteFetcher(const RemoteFetcher& no_copy) = delete;
+  RemoteFetcher& operator=(const RemoteFetcher& no_copy) = delete;
+  ~RemoteFetcher();
+
+  /// Read size bytes at start of uri into buf. buf must stay valid until the
+  /// future is ready.
+  std::future<katana::Result<void>> Fetch(
+      const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf);
+
+  const RemoteFetchOptions& options() const { return opts_; }
+
+  /// Number of requests made to the backend so far
+  uint64_t num_requests() const;
+
+private:
+  struct Request;
+  struct Part {
+    std::string uri;
+    uint64_t start;
+    uint64_t size;
+    uint8_t* buf;
+    /// The requests that this part is all or some of
+    std::vector<std::shared_ptr<Request>> requests;
+  };
+
+  /// Extend a queued part that ends where [start, start + size) begins with
+  /// this range. Returns false if there is none.
+  bool Merge(
+      const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf,
+      const std::shared_ptr<Request>& request);
+
+  void Work();
+
+  GetRangeFunc get_range_;
+  RemoteFetchOptions opts_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Part> queue_;
+  uint64_t bytes_in_flight_{0};
+  uint64_t num_requests_{0};
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace tsuba
+
+#endif
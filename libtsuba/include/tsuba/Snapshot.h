@@ -0,0 +1,124 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_SNAPSHOT_H_
+#define KATANA_LIBTSUBA_TSUBA_SNAPSHOT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/Uri.h"
+#include "katana/config.h"
+#include "tsuba/tsuba.h"
+
+namespace tsuba {
+
+class RDGMeta;
+
+/// A Snapshot pins one version of an RDG so that CollectGarbage keeps its
+/// files while writers commit newer versions.
+///
+/// The files of a version are never changed once it is committed: a commit
+/// writes new partition headers named by the new version, and new files for
+/// the properties and topologies that changed, and refers to the files of
+/// the previous version for everything else. So a reader of a pinned
+/// version is isolated from writers without any coordination beyond the
+/// pin, which is a small file in the RDG directory that any process can
+/// see.
+///
+/// A pin may have a lease, after which CollectGarbage ignores it, so that
+/// the versions of readers that crashed are eventually collected; a reader
+/// with a lease must Renew it before it runs out.
+class KATANA_EXPORT Snapshot {
+public:
+  /// Pin the latest version of the RDG named rdg_name. A zero lease pins it
+  /// until Release.
+  static katana::Result<Snapshot> Make(
+      const std::string& rdg_name,
+      std::chrono::seconds lease = std::chrono::seconds(0));
+
+  /// Pin the given version of the RDG named rdg_name, which must not have
+  /// been collected
+  static katana::Result<Snapshot> Make(
+      const std::string& rdg_name, uint64_t version,
+      std::chrono::seconds lease = std::chrono::seconds(0));
+
+  Snapshot();
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+  Snapshot(Snapshot&& other) noexcept;
+  Snapshot& operator=(Snapshot&& other) noexcept;
+
+  /// Releases the pin, logging failures
+  ~Snapshot();
+
+  /// Open a read-only handle of the pinned version
+  katana::Result<RDGHandle> Open() const;
+
+  /// Pin the latest version if it is newer than the pinned one, releasing
+  /// the old pin once the new one is in place
+  ///
+  /// \returns whether the pinned version changed
+  katana::Result<bool> Refresh();
+
+  /// Extend the lease of the pin by the lease it was made with
+  katana::Result<void> Renew();
+
+  /// Unpin the version, after which it may be collected
+  katana::Result<void> Release();
+
+  bool pinned() const { return !pin_name_.empty(); }
+  const katana::Uri& dir() const { return dir_; }
+  uint64_t version() const { return version_; }
+
+private:
+  /// Write a pin of version and read its meta file, replacing the pinned
+  /// version if the meta file still exists once the pin does
+  ///
+  /// \returns whether the version was pinned
+  katana::Result<bool> TryPin(uint64_t version);
+
+  katana::Result<void> WritePin(
+      const std::string& pin_name, uint64_t version) const;
+
+  katana::Uri dir_;
+  uint64_t version_{0};
+  /// The meta file of the pinned version, which is kept in memory because
+  /// it may be deleted once the version is pinned
+  std::unique_ptr<RDGMeta> meta_;
+  /// The name of the pin file in dir_, or empty if there is no pin
+  std::string pin_name_;
+  std::chrono::seconds lease_{0};
+};
+
+/// What CollectGarbage did
+struct KATANA_EXPORT GarbageCollectionStats {
+  /// The versions whose files were deleted
+  std::vector<uint64_t> collected_versions;
+  /// The older versions kept because they are pinned
+  std::vector<uint64_t> pinned_versions;
+  uint64_t deleted_files{0};
+  uint64_t expired_pins{0};
+};
+
+/// Delete the versions of the RDG named rdg_name other than the keep_latest
+/// latest versions and those pinned by a Snapshot, along with the files
+/// they refer to that no remaining version refers to. Pins whose lease ran
+/// out are deleted too.
+///
+/// Files that no version refers to are left alone, since they may belong to
+/// a commit in progress. A writer shares the files of the version it opened
+/// with the version it commits, so a writer that takes long enough for
+/// other commits to overtake it should hold a Snapshot of the version it
+/// opened.
+///
+/// A version is first made unopenable by deleting its meta file; a reader
+/// that pinned it in the meantime keeps its files. keep_latest must be at
+/// least 1. This is not a collective operation; call it from one host.
+KATANA_EXPORT katana::Result<GarbageCollectionStats> CollectGarbage(
+    const std::string& rdg_name, uint64_t keep_latest = 1);
+
+}  // namespace tsuba
+
+#endif
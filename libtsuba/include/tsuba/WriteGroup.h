@@ -1,28 +1,39 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_WRITEGROUP_H_
 #define KATANA_LIBTSUBA_TSUBA_WRITEGROUP_H_
 
+#include <functional>
 #include <future>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "katana/Result.h"
+#include "tsuba/Checksum.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/file.h"
 
 namespace tsuba {
 
 /// Track multiple, outstanding async writes and provide a mechanism to ensure
-/// that they have all completed
+/// that they have all completed. The checksum of every file is computed as
+/// it is stored (see TakeChecksums).
 class WriteGroup {
   struct AsyncOp {
     std::future<katana::Result<void>> result;
     std::string location;
     uint64_t accounted_size;
+    bool builds_frame;
   };
 
   std::string tag_;
+  // Ops record checksums until they finish, so these must outlive
+  // pending_ops_
+  std::mutex checksums_mutex_;
+  std::unordered_map<std::string, FileChecksum> checksums_;
   std::list<AsyncOp> pending_ops_;
   uint64_t outstanding_size_{0};
+  uint64_t pending_builds_{0};
   uint64_t errors_{0};
   uint64_t total_{0};
   katana::Result<void> last_error_{katana::ResultSuccess()};
@@ -34,12 +45,19 @@ class WriteGroup {
   /// frame that we are responsible for, note the size
   void AddOp(
       std::future<katana::Result<void>> future, std::string file,
-      uint64_t accounted_size = 0);
+      uint64_t accounted_size = 0, bool builds_frame = false);
 
   /// Wait for the next op if there is one, account errors. Returns true if
   /// there was a next op
   bool Drain();
 
+  /// Wait for ops until one of accounted_size and, if builds_frame, one more
+  /// frame build fit within the limits
+  void MakeRoom(uint64_t accounted_size, bool builds_frame);
+
+  void RecordChecksum(
+      const std::string& file, const uint8_t* data, uint64_t size);
+
 public:
   static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
 
@@ -50,16 +68,30 @@ public:
   /// Return a random tag that uniquely identifies this op
   const std::string& tag() const { return tag_; }
 
-  /// Wait until all operations this descriptor knows about have completed
+  /// Wait until all operations this descriptor knows about have completed.
+  /// Operations may be started again afterwards.
   katana::Result<void> Finish();
 
+  /// \returns the checksums of the files whose stores have finished, by
+  /// file name, and forgets them. After Finish, these are the checksums of
+  /// every file stored since the last call.
+  std::unordered_map<std::string, FileChecksum> TakeChecksums();
+
   /// Start async store op, we hold onto the data until op finishes
   void StartStore(std::shared_ptr<FileFrame> ff);
 
+  /// Start async op that builds a file frame with make_frame, e.g., by
+  /// encoding a table, and then stores it. Frames are built concurrently with
+  /// earlier stores and with each other, up to one build per hardware thread.
+  /// estimated_size is accounted against kMaxOutstandingSize until the store
+  /// finishes, so it should be an upper bound on the size of the frame.
+  void StartStore(
+      std::string file,
+      std::function<katana::Result<std::shared_ptr<FileFrame>>()> make_frame,
+      uint64_t estimated_size);
+
   /// Start async store op, caller responsible for keeping buffer live
-  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size) {
-    AddOp(FileStoreAsync(file, buf, size), file);
-  }
+  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size);
 };
 
 }  // namespace tsuba
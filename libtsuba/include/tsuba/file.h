@@ -29,6 +29,9 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// An opaque identifier of the contents of the file, e.g., an ETag or a
+  /// modification time, or empty if the backend does not provide one
+  std::string version;
 };
 
 // Returns an error file filename does not exist
@@ -94,6 +97,29 @@ KATANA_EXPORT std::future<katana::Result<void>> FileListAsync(
 KATANA_EXPORT katana::Result<void> FileDelete(
     const std::string& directory, const std::unordered_set<std::string>& files);
 
+/// Counters of the local caches of remote storage backends (see
+/// KATANA_STORAGE_CACHE_DIR), summed over all backends
+struct FileCacheStats {
+  /// Blocks read from a cache
+  uint64_t hits{UINT64_C(0)};
+  /// Blocks read from a backend
+  uint64_t misses{UINT64_C(0)};
+  uint64_t evictions{UINT64_C(0)};
+  /// Bytes currently held by the caches
+  uint64_t cached_bytes{UINT64_C(0)};
+};
+
+KATANA_EXPORT FileCacheStats GetFileCacheStats();
+
+/// When one file was read while loading an RDG (see RDG::load_timeline)
+struct FileLoadTime {
+  /// The name of the file within the RDG directory
+  std::string file;
+  /// Microseconds from the start of the load to the start and end of the read
+  uint64_t start_us{UINT64_C(0)};
+  uint64_t end_us{UINT64_C(0)};
+};
+
 }  // namespace tsuba
 
 #endif
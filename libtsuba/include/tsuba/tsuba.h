@@ -49,6 +49,10 @@ OpenFlagsValid(uint32_t flags) {
 KATANA_EXPORT katana::Result<RDGHandle> Open(
     const std::string& rdg_name, uint32_t flags);
 
+/// Open the given version of rdg_name rather than the latest one. Versions
+/// other than the latest should be opened kReadOnly, since storing from one
+/// would write over the versions after it. See also Snapshot, which keeps a
+/// version from being garbage collected while it is open.
 KATANA_EXPORT katana::Result<RDGHandle> Open(
     const std::string& rdg_name, uint64_t version, uint32_t flags);
 
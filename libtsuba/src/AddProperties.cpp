@@ -1,8 +1,11 @@
 #include "AddProperties.h"
 
+#include <algorithm>
+
 #include <arrow/chunked_array.h>
 
 #include "katana/Result.h"
+#include "tsuba/ArrowIpc.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 #include "tsuba/ParquetReader.h"
@@ -12,20 +15,36 @@ namespace {
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
-    std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-  auto reader_res = tsuba::ParquetReader::Make(slice);
-  if (!reader_res) {
-    return reader_res.error().WithContext("loading property");
-  }
-  std::unique_ptr<tsuba::ParquetReader> reader = std::move(reader_res.value());
+    std::optional<tsuba::ParquetReader::Slice> slice,
+    std::shared_ptr<const tsuba::FileChecksum> checksum) {
+  std::shared_ptr<arrow::Table> out;
+  if (tsuba::PropertyFileFormatOf(file_path.path()) ==
+      tsuba::PropertyFileFormat::kArrowIpc) {
+    auto out_res = tsuba::ReadArrowIpc(file_path, std::move(checksum));
+    if (!out_res) {
+      return out_res.error().WithContext("loading property");
+    }
+    out = std::move(out_res.value());
+    if (slice) {
+      out = out->Slice(slice->offset, slice->length);
+    }
+  } else {
+    auto reader_res = tsuba::ParquetReader::Make(
+        tsuba::ParquetReader::ReadOpts{
+            .slice = slice, .checksum = std::move(checksum)});
+    if (!reader_res) {
+      return reader_res.error().WithContext("loading property");
+    }
+    std::unique_ptr<tsuba::ParquetReader> reader =
+        std::move(reader_res.value());
 
-  auto out_res = reader->ReadFromUri(file_path);
-  if (!out_res) {
-    return out_res.error().WithContext("loading property");
+    auto out_res = reader->ReadFromUri(file_path);
+    if (!out_res) {
+      return out_res.error().WithContext("loading property");
+    }
+    out = std::move(out_res.value());
   }
 
-  std::shared_ptr<arrow::Table> out = std::move(out_res.value());
-
   std::shared_ptr<arrow::Schema> schema = out->schema();
   if (schema->num_fields() != 1) {
     return KATANA_ERROR(
@@ -45,9 +64,11 @@ DoLoadProperties(
 
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path) {
+    const std::string& expected_name, const katana::Uri& file_path,
+    std::shared_ptr<const FileChecksum> checksum) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(
+        expected_name, file_path, std::nullopt, std::move(checksum));
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -57,13 +78,92 @@ tsuba::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length,
+    std::shared_ptr<const FileChecksum> checksum) {
   try {
     return DoLoadProperties(
         expected_name, file_path,
-        ParquetReader::Slice{.offset = offset, .length = length});
+        ParquetReader::Slice{.offset = offset, .length = length},
+        std::move(checksum));
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow exception: {}", exp.what());
   }
 }
+
+tsuba::PropertyLoader::PropertyLoader(std::vector<File> files)
+    : start_(std::chrono::steady_clock::now()), loads_(files.size()) {
+  for (size_t i = 0; i < files.size(); ++i) {
+    loads_[i].file = std::move(files[i]);
+    loads_[i].done = loads_[i].promise.get_future().share();
+  }
+  size_t num_workers = std::min<size_t>(loads_.size(), kMaxConcurrentLoads);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this] { Work(); });
+  }
+}
+
+tsuba::PropertyLoader::~PropertyLoader() {
+  stopping_ = true;
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+uint64_t
+tsuba::PropertyLoader::ElapsedUs() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start_)
+      .count();
+}
+
+void
+tsuba::PropertyLoader::Work() {
+  while (!stopping_) {
+    size_t i = next_++;
+    if (i >= loads_.size()) {
+      return;
+    }
+    Load& load = loads_[i];
+    load.start_us = ElapsedUs();
+    auto res = load.file.slice
+                   ? LoadPropertySlice(
+                         load.file.name, load.file.path,
+                         load.file.slice->offset, load.file.slice->length,
+                         load.file.checksum)
+                   : LoadProperties(
+                         load.file.name, load.file.path, load.file.checksum);
+    load.end_us = ElapsedUs();
+    if (res) {
+      load.table = std::move(res.value());
+    } else {
+      load.error = res.error().error_code();
+      load.error_message = fmt::format("{}", res.error());
+    }
+    load.promise.set_value();
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+tsuba::PropertyLoader::Get(size_t i) {
+  Load& load = loads_[i];
+  load.done.wait();
+  if (load.error) {
+    return KATANA_ERROR(
+        load.error, "loading {}: {}", load.file.path, load.error_message);
+  }
+  return load.table;
+}
+
+std::vector<tsuba::FileLoadTime>
+tsuba::PropertyLoader::Timeline() const {
+  std::vector<FileLoadTime> timeline;
+  for (const Load& load : loads_) {
+    if (load.done.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      timeline.emplace_back(FileLoadTime{
+          load.file.path.BaseName(), load.start_us, load.end_us});
+    }
+  }
+  return timeline;
+}
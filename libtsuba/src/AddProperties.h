@@ -1,70 +1,93 @@
 #ifndef KATANA_LIBTSUBA_ADDPROPERTIES_H_
 #define KATANA_LIBTSUBA_ADDPROPERTIES_H_
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/Checksum.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/file.h"
 
 namespace tsuba {
 
+/// Read the property expected_name from file_path, checking the data read
+/// against checksum if it is not null
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path);
+    const std::string& expected_name, const katana::Uri& file_path,
+    std::shared_ptr<const FileChecksum> checksum = nullptr);
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
-
-template <typename AddFn>
-katana::Result<void>
-AddProperties(
-    const katana::Uri& uri,
-    const std::vector<tsuba::PropStorageInfo>& properties, AddFn add_fn) {
-  for (const tsuba::PropStorageInfo& properties : properties) {
-    auto p_path = uri.Join(properties.path);
-
-    auto load_result = LoadProperties(properties.name, p_path);
-    if (!load_result) {
-      return load_result.error().WithContext("error loading {}", p_path);
-    }
-
-    std::shared_ptr<arrow::Table> props = load_result.value();
-
-    auto add_result = add_fn(props);
-    if (!add_result) {
-      return add_result.error();
-    }
-  }
-
-  return katana::ResultSuccess();
-}
-
-template <typename AddFn>
-katana::Result<void>
-AddPropertySlice(
-    const katana::Uri& dir,
-    const std::vector<tsuba::PropStorageInfo>& properties,
-    std::pair<uint64_t, uint64_t> range, AddFn add_fn) {
-  for (const tsuba::PropStorageInfo& properties : properties) {
-    katana::Uri p_path = dir.Join(properties.path);
-
-    auto load_result = LoadPropertySlice(
-        properties.name, p_path, range.first, range.second - range.first);
-    if (!load_result) {
-      return load_result.error();
-    }
-
-    std::shared_ptr<arrow::Table> props = load_result.value();
-
-    auto add_result = add_fn(props);
-    if (!add_result) {
-      return add_result.error();
-    }
-  }
-
-  return katana::ResultSuccess();
-}
+    int64_t offset, int64_t length,
+    std::shared_ptr<const FileChecksum> checksum = nullptr);
+
+/// PropertyLoader reads property files in the background, in the order
+/// given, with up to kMaxConcurrentLoads threads. Their fetches overlap each
+/// other and whatever the caller does meanwhile, e.g., binding the topology,
+/// and each file is decoded by the thread that read it as soon as its data
+/// have arrived.
+class PropertyLoader {
+public:
+  struct File {
+    std::string name;
+    katana::Uri path;
+    /// The rows to read, or nullopt to read all of them
+    std::optional<ParquetReader::Slice> slice;
+    /// The checksum to check the data read against, if any
+    std::shared_ptr<const FileChecksum> checksum;
+  };
+
+  static constexpr uint32_t kMaxConcurrentLoads = 16;
+
+  explicit PropertyLoader(std::vector<File> files);
+  PropertyLoader(const PropertyLoader& no_copy) = delete;
+  PropertyLoader& operator=(const PropertyLoader& no_copy) = delete;
+  /// Reads that have not started are abandoned
+  ~PropertyLoader();
+
+  /// Wait for file i and return its table
+  katana::Result<std::shared_ptr<arrow::Table>> Get(size_t i);
+
+  /// Microseconds since the loader was made, to place other reads in the
+  /// same timeline
+  uint64_t ElapsedUs() const;
+
+  /// When each file that has been read was read
+  std::vector<FileLoadTime> Timeline() const;
+
+private:
+  struct Load {
+    File file;
+    std::promise<void> promise;
+    std::shared_future<void> done;
+    std::shared_ptr<arrow::Table> table;
+    /// Errors are kept as a code and a message because error context is
+    /// local to the thread that creates it
+    std::error_code error;
+    std::string error_message;
+    uint64_t start_us{0};
+    uint64_t end_us{0};
+  };
+
+  void Work();
+
+  std::chrono::steady_clock::time_point start_;
+  std::vector<Load> loads_;
+  std::atomic<size_t> next_{0};
+  std::atomic<bool> stopping_{false};
+  std::vector<std::thread> workers_;
+};
 
 }  // namespace tsuba
 
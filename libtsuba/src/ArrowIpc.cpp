@@ -0,0 +1,149 @@
+#include "tsuba/ArrowIpc.h"
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
+#include "tsuba/PropertyStats.h"
+
+namespace {
+
+/// The contents of a bound FileView as an arrow::Buffer that keeps the view,
+/// and so its mapping, alive
+class FileViewBuffer : public arrow::Buffer {
+public:
+  explicit FileViewBuffer(std::shared_ptr<tsuba::FileView> fv)
+      : arrow::Buffer(fv->ptr<uint8_t>(), fv->size()), fv_(std::move(fv)) {}
+
+private:
+  std::shared_ptr<tsuba::FileView> fv_;
+};
+
+/// An upper bound on the size of the IPC file of table: its buffers, each
+/// padded to 64 bytes, and the metadata of each record batch
+uint64_t
+EstimateEncodedSize(const arrow::Table& table) {
+  uint64_t size = UINT64_C(1) << 16;
+  for (const auto& column : table.columns()) {
+    for (const auto& chunk : column->chunks()) {
+      for (const auto& buffer : chunk->data()->buffers) {
+        if (buffer) {
+          size += buffer->size() + 64;
+        }
+      }
+      size += UINT64_C(1) << 10;
+    }
+  }
+  return size;
+}
+
+katana::Result<std::shared_ptr<tsuba::FileFrame>>
+EncodeArrowIpc(const arrow::Table& table) {
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error().WithContext("creating output buffer");
+  }
+
+  auto writer_res = arrow::ipc::MakeFileWriter(ff.get(), table.schema());
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", writer_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      writer_res.ValueOrDie();
+  // Record batches of the row group length of parquet files, so that the
+  // chunks of loaded columns are the same for either format
+  if (auto status = writer->WriteTable(table, tsuba::kPropertyRowGroupLength);
+      !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", status);
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", status);
+  }
+  return ff;
+}
+
+}  // namespace
+
+tsuba::PropertyFileFormat
+tsuba::PropertyFileFormatOf(std::string_view path) {
+  if (path.size() >= kArrowIpcSuffix.size() &&
+      path.substr(path.size() - kArrowIpcSuffix.size()) == kArrowIpcSuffix) {
+    return PropertyFileFormat::kArrowIpc;
+  }
+  return PropertyFileFormat::kParquet;
+}
+
+katana::Result<void>
+tsuba::WriteArrowIpc(
+    const std::shared_ptr<arrow::Table>& table, const katana::Uri& uri,
+    WriteGroup* group) {
+  TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+  if (group) {
+    group->StartStore(
+        uri.string(),
+        [table, path = uri.string()]()
+            -> katana::Result<std::shared_ptr<FileFrame>> {
+          auto ff_res = EncodeArrowIpc(*table);
+          if (!ff_res) {
+            return ff_res.error().WithContext("encoding {}", path);
+          }
+          ff_res.value()->Bind(path);
+          return ff_res;
+        },
+        EstimateEncodedSize(*table));
+    return katana::ResultSuccess();
+  }
+
+  auto ff_res = EncodeArrowIpc(*table);
+  if (!ff_res) {
+    return ff_res.error();
+  }
+  ff_res.value()->Bind(uri.string());
+  return ff_res.value()->Persist();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+tsuba::ReadArrowIpc(
+    const katana::Uri& uri, std::shared_ptr<const FileChecksum> checksum) {
+  auto fv = std::make_shared<FileView>();
+  fv->ExpectChecksum(std::move(checksum));
+  if (auto res = fv->BindReadOnly(uri.string(), false); !res) {
+    return res.error().WithContext("opening {}", uri);
+  }
+
+  arrow::io::BufferReader reader(std::make_shared<FileViewBuffer>(fv));
+  auto file_reader_res = arrow::ipc::RecordBatchFileReader::Open(&reader);
+  if (!file_reader_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "reading {}: {}", uri,
+        file_reader_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> file_reader =
+      file_reader_res.ValueOrDie();
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = file_reader->num_record_batches(); i < n; ++i) {
+    auto batch_res = file_reader->ReadRecordBatch(i);
+    if (!batch_res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "reading {}: {}", uri, batch_res.status());
+    }
+    batches.emplace_back(batch_res.ValueOrDie());
+  }
+
+  auto table_res =
+      arrow::Table::FromRecordBatches(file_reader->schema(), batches);
+  if (!table_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "reading {}: {}", uri, table_res.status());
+  }
+  return table_res.ValueOrDie();
+}
@@ -0,0 +1,382 @@
+#include "AsyncIO.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Trace.h"
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define KATANA_TSUBA_HAVE_IO_URING 1
+#endif
+
+namespace {
+
+/// The number of threads that serve requests when io_uring is not available
+constexpr uint32_t kNumWorkers = 8;
+
+/// user_data of the request that stops the thread that reaps completions
+constexpr uint64_t kStopReaper = 0;
+
+}  // namespace
+
+struct tsuba::AsyncIO::Transfer {
+  Request request;
+  std::atomic<uint64_t> pending_chunks{0};
+  std::atomic<uint64_t> transferred{0};
+  std::mutex error_mutex;
+  std::error_code error;
+};
+
+struct tsuba::AsyncIO::Chunk {
+  Transfer* transfer;
+  /// The part of the request of this chunk
+  uint64_t offset;
+  uint64_t size;
+  /// The bytes of this chunk transferred so far
+  uint64_t done;
+  /// The remainder of the chunk, while it is submitted to the ring
+  struct iovec iov;
+};
+
+#ifdef KATANA_TSUBA_HAVE_IO_URING
+
+/// An io_uring set up with raw system calls, so as not to depend on liburing
+struct tsuba::AsyncIO::Ring {
+  int fd{-1};
+  void* sq_ring{MAP_FAILED};
+  size_t sq_ring_size{0};
+  void* cq_ring{MAP_FAILED};
+  size_t cq_ring_size{0};
+  io_uring_sqe* sqes{static_cast<io_uring_sqe*>(MAP_FAILED)};
+  size_t sqes_size{0};
+
+  unsigned* sq_tail{};
+  unsigned* sq_mask{};
+  unsigned* sq_array{};
+  unsigned* cq_head{};
+  unsigned* cq_tail{};
+  unsigned* cq_mask{};
+  io_uring_cqe* cqes{};
+
+  /// Serializes submitters, who share the tail of the submission queue
+  std::mutex submit_mutex;
+
+  /// Set up a ring of entries entries, or return nullptr if the kernel does
+  /// not allow it, e.g., because it is too old or a seccomp filter forbids
+  /// io_uring
+  static std::unique_ptr<Ring> Make(uint32_t entries) {
+    io_uring_params params{};
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      KATANA_LOG_DEBUG("io_uring_setup: {}", std::strerror(errno));
+      return nullptr;
+    }
+    auto ring = std::make_unique<Ring>();
+    ring->fd = fd;
+
+    ring->sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      ring->sq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+    }
+    ring->sq_ring = mmap(
+        nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+      return nullptr;
+    }
+    if (!single_mmap) {
+      ring->cq_ring = mmap(
+          nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (ring->cq_ring == MAP_FAILED) {
+        return nullptr;
+      }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(mmap(
+        nullptr, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+      return nullptr;
+    }
+
+    auto* sq = static_cast<uint8_t*>(ring->sq_ring);
+    auto* cq = single_mmap ? sq : static_cast<uint8_t*>(ring->cq_ring);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return ring;
+  }
+
+  ~Ring() {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_size);
+    }
+    if (cq_ring != MAP_FAILED) {
+      munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring != MAP_FAILED) {
+      munmap(sq_ring, sq_ring_size);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  /// Submit one operation. The queue never fills up because there are
+  /// never more than kQueueDepth chunks and one stop request in flight.
+  void Push(
+      uint8_t opcode, int file, const struct iovec* iov, uint64_t offset,
+      uint64_t user_data) {
+    std::lock_guard<std::mutex> lock(submit_mutex);
+    unsigned tail = *sq_tail;
+    unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = file;
+    sqe->addr = reinterpret_cast<uint64_t>(iov);
+    sqe->len = iov != nullptr ? 1 : 0;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    while (syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0) {
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        // The entry stays in the queue and goes with the next submission
+        KATANA_LOG_WARN("io_uring_enter: {}", std::strerror(errno));
+        break;
+      }
+    }
+  }
+
+  /// Wait for completions and call fn(user_data, res) for each until fn
+  /// returns false
+  template <typename Fn>
+  void Reap(const Fn& fn) {
+    while (true) {
+      unsigned head = *cq_head;
+      unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        syscall(
+            __NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & *cq_mask];
+        uint64_t user_data = cqe.user_data;
+        int32_t res = cqe.res;
+        // Release the entry before handling it, which may submit again
+        __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+        if (!fn(user_data, res)) {
+          return;
+        }
+      }
+    }
+  }
+};
+
+#else
+
+struct tsuba::AsyncIO::Ring {
+  static std::unique_ptr<Ring> Make(uint32_t) { return nullptr; }
+  void Push(uint8_t, int, const struct iovec*, uint64_t, uint64_t) {}
+  template <typename Fn>
+  void Reap(const Fn&) {}
+};
+
+#endif
+
+tsuba::AsyncIO&
+tsuba::AsyncIO::Get() {
+  static AsyncIO instance([] {
+    bool use_io_uring = true;
+    katana::GetEnv("KATANA_IO_URING", &use_io_uring);
+    return use_io_uring;
+  }());
+  return instance;
+}
+
+tsuba::AsyncIO::AsyncIO(bool try_io_uring) {
+  if (try_io_uring) {
+    ring_ = Ring::Make(2 * kQueueDepth);
+  }
+  if (ring_) {
+    reaper_ = std::thread([this] { ReapCompletions(); });
+    return;
+  }
+  for (uint32_t i = 0; i < kNumWorkers; ++i) {
+    workers_.emplace_back([this] { Work(); });
+  }
+}
+
+tsuba::AsyncIO::~AsyncIO() {
+  {
+    std::unique_lock<std::mutex> lock(slots_mutex_);
+    slots_cv_.wait(lock, [this] { return in_flight_ == 0; });
+  }
+  if (ring_) {
+#ifdef KATANA_TSUBA_HAVE_IO_URING
+    ring_->Push(IORING_OP_NOP, -1, nullptr, 0, kStopReaper);
+#endif
+    reaper_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void
+tsuba::AsyncIO::AcquireSlot() {
+  katana::TraceSpan span("AsyncIO queue full", "io");
+  std::unique_lock<std::mutex> lock(slots_mutex_);
+  slots_cv_.wait(lock, [this] { return in_flight_ < kQueueDepth; });
+  ++in_flight_;
+}
+
+void
+tsuba::AsyncIO::ReleaseSlot() {
+  {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    --in_flight_;
+  }
+  slots_cv_.notify_all();
+}
+
+void
+tsuba::AsyncIO::Submit(Request request) {
+  uint64_t num_chunks =
+      std::max<uint64_t>(1, (request.size + kMaxChunkSize - 1) / kMaxChunkSize);
+  auto* transfer = new Transfer{};
+  transfer->request = std::move(request);
+  transfer->pending_chunks = num_chunks;
+
+  uint64_t size = transfer->request.size;
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    AcquireSlot();
+    uint64_t offset = i * kMaxChunkSize;
+    Start(new Chunk{
+        transfer, offset, std::min(kMaxChunkSize, size - offset), 0, {}});
+  }
+}
+
+void
+tsuba::AsyncIO::Start(Chunk* chunk) {
+  const Request& request = chunk->transfer->request;
+  uint64_t position = chunk->offset + chunk->done;
+  if (ring_) {
+#ifdef KATANA_TSUBA_HAVE_IO_URING
+    chunk->iov.iov_base = request.buf + position;
+    chunk->iov.iov_len = chunk->size - chunk->done;
+    ring_->Push(
+        request.kind == Request::kRead ? IORING_OP_READV : IORING_OP_WRITEV,
+        request.fd, &chunk->iov, request.offset + position,
+        reinterpret_cast<uint64_t>(chunk));
+#endif
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.emplace_back(chunk);
+  }
+  queue_cv_.notify_one();
+}
+
+void
+tsuba::AsyncIO::Complete(Chunk* chunk, int64_t res) {
+  Transfer* transfer = chunk->transfer;
+  if (res == -EINTR || res == -EAGAIN) {
+    Start(chunk);
+    return;
+  }
+  if (res < 0 || (res == 0 && chunk->done < chunk->size &&
+                  transfer->request.kind == Request::kWrite)) {
+    std::lock_guard<std::mutex> lock(transfer->error_mutex);
+    if (!transfer->error) {
+      transfer->error =
+          std::error_code(res < 0 ? -res : EIO, std::system_category());
+    }
+    Finish(chunk);
+    return;
+  }
+  chunk->done += res;
+  // A read of 0 bytes is the end of the file
+  if (res == 0 || chunk->done == chunk->size) {
+    Finish(chunk);
+    return;
+  }
+  Start(chunk);
+}
+
+void
+tsuba::AsyncIO::Finish(Chunk* chunk) {
+  Transfer* transfer = chunk->transfer;
+  transfer->transferred += chunk->done;
+  delete chunk;
+  ReleaseSlot();
+
+  if (transfer->pending_chunks.fetch_sub(1) == 1) {
+    transfer->request.done(transfer->error, transfer->transferred);
+    delete transfer;
+  }
+}
+
+void
+tsuba::AsyncIO::ReapCompletions() {
+  ring_->Reap([this](uint64_t user_data, int32_t res) {
+    if (user_data == kStopReaper) {
+      return false;
+    }
+    Complete(reinterpret_cast<Chunk*>(user_data), res);
+    return true;
+  });
+}
+
+void
+tsuba::AsyncIO::Work() {
+  while (true) {
+    Chunk* chunk = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      chunk = queue_.front();
+      queue_.pop_front();
+    }
+
+    const Request& request = chunk->transfer->request;
+    uint64_t position = chunk->offset + chunk->done;
+    uint8_t* buf = request.buf + position;
+    uint64_t size = chunk->size - chunk->done;
+    off_t offset = request.offset + position;
+    ssize_t res = request.kind == Request::kRead
+                      ? pread(request.fd, buf, size, offset)
+                      : pwrite(request.fd, buf, size, offset);
+    Complete(chunk, res < 0 ? -errno : res);
+  }
+}
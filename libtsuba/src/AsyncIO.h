@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBTSUBA_ASYNCIO_H_
+#define KATANA_LIBTSUBA_ASYNCIO_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace tsuba {
+
+/// AsyncIO reads and writes local files without a thread per request. It
+/// submits them to the kernel through an io_uring when the kernel allows it
+/// and otherwise hands them to a small pool of threads that call pread and
+/// pwrite.
+///
+/// Requests are split into chunks of at most kMaxChunkSize bytes, which are
+/// in flight concurrently. At most kQueueDepth chunks are in flight in the
+/// whole process; Submit blocks until there is room, so that FileView fills
+/// and WriteGroup stores share one bounded queue instead of each adding
+/// threads.
+class AsyncIO {
+public:
+  static constexpr uint32_t kQueueDepth = 64;
+  static constexpr uint64_t kMaxChunkSize = UINT64_C(8) << 20;
+
+  struct Request {
+    enum Kind { kRead, kWrite };
+    Kind kind;
+    int fd;
+    uint8_t* buf;
+    uint64_t size;
+    uint64_t offset;
+    /// Called once from an internal thread when every chunk is done, with
+    /// the first error and the number of bytes transferred. Reads stop
+    /// early at the end of the file, so they may transfer less than size.
+    std::function<void(std::error_code, uint64_t)> done;
+  };
+
+  /// The process-wide instance. Setting KATANA_IO_URING=false in the
+  /// environment disables io_uring.
+  static AsyncIO& Get();
+
+  AsyncIO(const AsyncIO& no_copy) = delete;
+  AsyncIO& operator=(const AsyncIO& no_copy) = delete;
+  ~AsyncIO();
+
+  /// Start request. Its buffer and file descriptor must stay valid until
+  /// done is called.
+  void Submit(Request request);
+
+  bool uses_io_uring() const { return ring_ != nullptr; }
+
+private:
+  struct Transfer;
+  struct Chunk;
+  struct Ring;
+
+  explicit AsyncIO(bool try_io_uring);
+
+  /// Wait for a free slot in the queue
+  void AcquireSlot();
+  void ReleaseSlot();
+
+  void Start(Chunk* chunk);
+  /// Account res, the result of a read or write of chunk, and restart the
+  /// chunk if it is not done
+  void Complete(Chunk* chunk, int64_t res);
+  void Finish(Chunk* chunk);
+
+  void ReapCompletions();
+  void Work();
+
+  std::mutex slots_mutex_;
+  std::condition_variable slots_cv_;
+  uint32_t in_flight_{0};
+
+  std::unique_ptr<Ring> ring_;
+  std::thread reaper_;
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<Chunk*> queue_;
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace tsuba
+
+#endif
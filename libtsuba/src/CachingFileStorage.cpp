@@ -0,0 +1,329 @@
+#include "CachingFileStorage.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr std::string_view kTmpSuffix = ".tmp";
+
+/// Blocks are stored as the length of their key, the key and the data
+using KeyLength = uint32_t;
+
+std::string
+BlockKey(const std::string& uri, const tsuba::StatBuf& stat, uint64_t block) {
+  return fmt::format("{}\n{}\n{}\n{}", uri, stat.size, stat.version, block);
+}
+
+bool
+ReadAll(int fd, uint8_t* buf, uint64_t size, uint64_t offset) {
+  while (size > 0) {
+    ssize_t ret = pread(fd, buf, size, offset);
+    if (ret <= 0) {
+      return false;
+    }
+    buf += ret;
+    size -= ret;
+    offset += ret;
+  }
+  return true;
+}
+
+bool
+WriteAll(int fd, const uint8_t* buf, uint64_t size) {
+  while (size > 0) {
+    ssize_t ret = write(fd, buf, size);
+    if (ret <= 0) {
+      return false;
+    }
+    buf += ret;
+    size -= ret;
+  }
+  return true;
+}
+
+/// Read the key of the block file at path, or return false if it is not a
+/// complete block file
+bool
+ReadKey(int fd, uint64_t file_size, std::string* key) {
+  KeyLength len{};
+  if (file_size < sizeof(len) ||
+      !ReadAll(fd, reinterpret_cast<uint8_t*>(&len), sizeof(len), 0) ||
+      file_size < sizeof(len) + len) {
+    return false;
+  }
+  key->resize(len);
+  return ReadAll(
+      fd, reinterpret_cast<uint8_t*>(key->data()), len, sizeof(len));
+}
+
+}  // namespace
+
+std::string
+tsuba::CachingFileStorage::BlockPath(const std::string& key) const {
+  return fmt::format("{}/{:016x}", cache_dir_, std::hash<std::string>{}(key));
+}
+
+katana::Result<void>
+tsuba::CachingFileStorage::Init() {
+  if (auto res = backend_->Init(); !res) {
+    return res.error();
+  }
+  return LoadIndex();
+}
+
+katana::Result<void>
+tsuba::CachingFileStorage::LoadIndex() {
+  if (boost::system::error_code err;
+      !fs::create_directories(cache_dir_, err) && err) {
+    return KATANA_ERROR(
+        std::error_code(err.value(), err.category()),
+        "creating cache directory {}", cache_dir_);
+  }
+
+  DIR* dirp = opendir(cache_dir_.c_str());
+  if (dirp == nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening cache directory {}: {}",
+        cache_dir_, katana::ResultErrno().message());
+  }
+
+  struct Found {
+    std::string path;
+    std::string key;
+    uint64_t size;
+    time_t mtime;
+  };
+  std::vector<Found> found;
+  while (struct dirent* dp = readdir(dirp)) {
+    std::string name = dp->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    std::string path = cache_dir_ + "/" + name;
+    if (name.size() >= kTmpSuffix.size() &&
+        name.compare(
+            name.size() - kTmpSuffix.size(), kTmpSuffix.size(), kTmpSuffix) ==
+            0) {
+      // Left by a process that stopped while filling a block
+      unlink(path.c_str());
+      continue;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    struct stat stat_buf;
+    std::string key;
+    bool valid = fstat(fd, &stat_buf) == 0 && S_ISREG(stat_buf.st_mode) &&
+                 ReadKey(fd, stat_buf.st_size, &key);
+    close(fd);
+    if (!valid || BlockPath(key) != path) {
+      KATANA_LOG_DEBUG("removing unrecognized cache file {}", path);
+      unlink(path.c_str());
+      continue;
+    }
+    found.emplace_back(Found{
+        .path = std::move(path),
+        .key = key,
+        .size = stat_buf.st_size - sizeof(KeyLength) - key.size(),
+        .mtime = stat_buf.st_mtime,
+    });
+  }
+  closedir(dirp);
+
+  // Blocks are touched when they are read, so their modification times give
+  // the LRU order of earlier runs
+  std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+    return a.mtime < b.mtime;
+  });
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Found& f : found) {
+    Insert(f.path, f.key, f.size);
+  }
+  return katana::ResultSuccess();
+}
+
+void
+tsuba::CachingFileStorage::Insert(
+    const std::string& path, const std::string& key, uint64_t size) {
+  Erase(path);
+  while (!lru_.empty() && cached_size_ + size > capacity_) {
+    std::string victim = lru_.back();
+    Erase(victim);
+    unlink(victim.c_str());
+    evictions_ += 1;
+  }
+  lru_.push_front(path);
+  entries_.emplace(path, Entry{key, size, lru_.begin()});
+  cached_size_ += size;
+}
+
+void
+tsuba::CachingFileStorage::Erase(const std::string& path) {
+  auto it = entries_.find(path);
+  if (it == entries_.end()) {
+    return;
+  }
+  cached_size_ -= it->second.size;
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
+
+bool
+tsuba::CachingFileStorage::ReadCachedBlock(
+    const std::string& key, uint64_t offset, uint64_t size, uint8_t* buf) {
+  std::string path = BlockPath(key);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end() || it->second.key != key ||
+        offset + size > it->second.size) {
+      return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  }
+
+  int fd = open(path.c_str(), O_RDONLY);
+  bool ok = fd >= 0 &&
+            ReadAll(fd, buf, size, sizeof(KeyLength) + key.size() + offset);
+  if (fd >= 0) {
+    futimens(fd, nullptr);
+    close(fd);
+  }
+  if (!ok) {
+    // e.g., evicted by another process sharing the cache directory
+    std::lock_guard<std::mutex> lock(mutex_);
+    Erase(path);
+  }
+  return ok;
+}
+
+void
+tsuba::CachingFileStorage::InsertBlock(
+    const std::string& key, const uint8_t* data, uint64_t size) {
+  if (size > capacity_) {
+    return;
+  }
+  std::string path = BlockPath(key);
+  // Concurrent fills of the same block each write their own file and the
+  // last rename wins
+  std::string tmp_path = fmt::format(
+      "{}.{}.{}{}", path, getpid(),
+      std::hash<std::thread::id>{}(std::this_thread::get_id()), kTmpSuffix);
+
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    KATANA_LOG_DEBUG(
+        "cannot create cache file {}: {}", tmp_path,
+        katana::ResultErrno().message());
+    return;
+  }
+  KeyLength len = key.size();
+  bool ok =
+      WriteAll(fd, reinterpret_cast<const uint8_t*>(&len), sizeof(len)) &&
+      WriteAll(fd, reinterpret_cast<const uint8_t*>(key.data()), len) &&
+      WriteAll(fd, data, size);
+  ok = close(fd) == 0 && ok;
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    KATANA_LOG_DEBUG(
+        "cannot write cache file {}: {}", path,
+        katana::ResultErrno().message());
+    unlink(tmp_path.c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Insert(path, key, size);
+}
+
+katana::Result<void>
+tsuba::CachingFileStorage::ReadBlock(
+    const std::string& uri, const StatBuf& stat, uint64_t block,
+    uint64_t offset, uint64_t size, uint8_t* buf) {
+  std::string key = BlockKey(uri, stat, block);
+  if (ReadCachedBlock(key, offset, size, buf)) {
+    hits_ += 1;
+    return katana::ResultSuccess();
+  }
+  misses_ += 1;
+
+  uint64_t block_begin = block * kCacheBlockSize;
+  uint64_t block_size = std::min(kCacheBlockSize, stat.size - block_begin);
+  std::vector<uint8_t> data(block_size);
+  if (auto res =
+          backend_->GetMultiSync(uri, block_begin, block_size, data.data());
+      !res) {
+    return res.error();
+  }
+  std::copy_n(data.begin() + offset, size, buf);
+  InsertBlock(key, data.data(), block_size);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::CachingFileStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  StatBuf stat;
+  if (auto res = backend_->Stat(uri, &stat); !res) {
+    return res.error().WithContext("validating cached {}", uri);
+  }
+  if (start > stat.size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "read at {} past the end of {} ({})",
+        start, uri, stat.size);
+  }
+
+  // Like the backends, tolerate reads that extend past the end of the file
+  uint64_t end = std::min(start + size, stat.size);
+  for (uint64_t block = start / kCacheBlockSize;
+       block * kCacheBlockSize < end; ++block) {
+    uint64_t block_begin = block * kCacheBlockSize;
+    uint64_t copy_begin = std::max(start, block_begin);
+    uint64_t copy_end = std::min(end, block_begin + kCacheBlockSize);
+    if (auto res = ReadBlock(
+            uri, stat, block, copy_begin - block_begin, copy_end - copy_begin,
+            result_buf + (copy_begin - start));
+        !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::Result<void>>
+tsuba::CachingFileStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  return std::async(std::launch::async, [=]() {
+    return GetMultiSync(uri, start, size, result_buf);
+  });
+}
+
+tsuba::FileCacheStats
+tsuba::CachingFileStorage::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return FileCacheStats{
+      .hits = hits_,
+      .misses = misses_,
+      .evictions = evictions_,
+      .cached_bytes = cached_size_,
+  };
+}
@@ -0,0 +1,129 @@
+#ifndef KATANA_LIBTSUBA_CACHINGFILESTORAGE_H_
+#define KATANA_LIBTSUBA_CACHINGFILESTORAGE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace tsuba {
+
+/// Wrap another storage backend with a cache of the data read from it, kept
+/// in a directory of the local file system (e.g., on an SSD).
+///
+/// Reads are served in blocks of kCacheBlockSize bytes. A cached block is
+/// identified by the URI, size and version (see StatBuf) of its file, so
+/// blocks of a file that changed after they were cached are never used. To
+/// check this, every read asks the backend for the Stat of its file. When
+/// the cache grows beyond its capacity, the least recently used blocks are
+/// evicted. The cache directory outlives the process, so later jobs that read
+/// the same files start with a warm cache.
+///
+/// Writes, listings, copies and deletes go directly to the backend.
+class CachingFileStorage : public FileStorage {
+  struct Entry {
+    std::string key;
+    uint64_t size;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  FileStorage* backend_;
+  std::string cache_dir_;
+  uint64_t capacity_;
+
+  std::mutex mutex_;
+  /// Paths of cached blocks, most recently used first
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t cached_size_{0};
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+
+  std::string BlockPath(const std::string& key) const;
+
+  /// Scan the cache directory for blocks left by earlier processes
+  katana::Result<void> LoadIndex();
+
+  /// Read size bytes at offset of the cached block key into buf. Returns
+  /// false if the block is not cached.
+  bool ReadCachedBlock(
+      const std::string& key, uint64_t offset, uint64_t size, uint8_t* buf);
+
+  /// Add a block to the cache, evicting others if needed
+  void InsertBlock(const std::string& key, const uint8_t* data, uint64_t size);
+
+  void Insert(const std::string& path, const std::string& key, uint64_t size);
+  void Erase(const std::string& path);
+
+  katana::Result<void> ReadBlock(
+      const std::string& uri, const StatBuf& stat, uint64_t block,
+      uint64_t offset, uint64_t size, uint8_t* buf);
+
+public:
+  static constexpr uint64_t kCacheBlockSize = UINT64_C(16) << 20;
+
+  CachingFileStorage(
+      FileStorage* backend, std::string cache_dir, uint64_t capacity)
+      : FileStorage(backend->uri_scheme()),
+        backend_(backend),
+        cache_dir_(std::move(cache_dir)),
+        capacity_(capacity) {}
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override { return backend_->Fini(); }
+  katana::Result<void> Stat(const std::string& uri, StatBuf* size) override {
+    return backend_->Stat(uri, size);
+  }
+
+  uint32_t Priority() const override { return backend_->Priority(); }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return backend_->PutMultiSync(uri, data, size);
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override {
+    return backend_->RemoteCopy(source_uri, dest_uri, begin, size);
+  }
+
+  std::future<katana::Result<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return backend_->PutAsync(uri, data, size);
+  }
+  std::future<katana::Result<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+  std::future<katana::Result<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override {
+    return backend_->ListAsync(directory, list, size);
+  }
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override {
+    return backend_->Delete(directory, files);
+  }
+
+  FileCacheStats stats();
+};
+
+}  // namespace tsuba
+
+#endif
@@ -0,0 +1,81 @@
+#include "tsuba/Checksum.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+#include "katana/Checksum.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+/// Blocks checked by each thread of VerifyAll, at least
+constexpr uint64_t kMinBlocksPerThread = 16;
+
+}  // namespace
+
+tsuba::FileChecksum
+tsuba::FileChecksum::Compute(
+    const uint8_t* data, uint64_t size, uint64_t block_size) {
+  FileChecksum checksum;
+  checksum.block_size = block_size;
+  checksum.size = size;
+  checksum.crcs.reserve((size + block_size - 1) / block_size);
+  for (uint64_t off = 0; off < size; off += block_size) {
+    checksum.crcs.emplace_back(
+        katana::Crc32c(data + off, std::min(block_size, size - off)));
+  }
+  return checksum;
+}
+
+katana::Result<void>
+tsuba::FileChecksum::Verify(
+    const uint8_t* file, uint64_t begin, uint64_t end) const {
+  end = std::min(end, size);
+  uint64_t first = (begin + block_size - 1) / block_size;
+  uint64_t last = end == size ? crcs.size() : end / block_size;
+  for (uint64_t i = first; i < last; ++i) {
+    uint64_t off = i * block_size;
+    uint64_t len = std::min(block_size, size - off);
+    if (katana::Crc32c(file + off, len) != crcs[i]) {
+      return KATANA_ERROR(
+          ErrorCode::ChecksumMismatch, "block at offset {} of {} bytes", off,
+          len);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::FileChecksum::VerifyAll(const uint8_t* file) const {
+  uint64_t num_blocks = crcs.size();
+  uint64_t num_threads = std::clamp<uint64_t>(
+      num_blocks / kMinBlocksPerThread, 1,
+      std::max(1U, std::thread::hardware_concurrency()));
+  uint64_t per_thread =
+      (num_blocks + num_threads - 1) / num_threads * block_size;
+
+  // Errors are returned as codes because error context is local to the
+  // thread that creates it
+  std::vector<std::future<std::error_code>> futures;
+  for (uint64_t begin = per_thread; begin < size; begin += per_thread) {
+    futures.emplace_back(std::async(std::launch::async, [=]() {
+      auto res = Verify(file, begin, begin + per_thread);
+      return res ? std::error_code() : res.error().error_code();
+    }));
+  }
+  auto res = Verify(file, 0, std::min(per_thread, size));
+  std::error_code thread_error;
+  for (auto& future : futures) {
+    if (std::error_code ec = future.get(); ec && !thread_error) {
+      thread_error = ec;
+    }
+  }
+  if (!res) {
+    return res.error();
+  }
+  if (thread_error) {
+    return KATANA_ERROR(thread_error, "verifying {} blocks", num_blocks);
+  }
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,228 @@
+#include "tsuba/CompressedCSRTopology.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+
+namespace {
+
+uint64_t
+NumBlocks(uint64_t num_nodes, uint64_t nodes_per_block) {
+  return (num_nodes + nodes_per_block - 1) / nodes_per_block;
+}
+
+void
+AppendVarint(uint64_t v, std::vector<uint8_t>* data) {
+  while (v >= 0x80) {
+    data->emplace_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  data->emplace_back(static_cast<uint8_t>(v));
+}
+
+uint8_t
+BitWidth(uint64_t v) {
+  uint8_t width = 0;
+  while (v) {
+    ++width;
+    v >>= 1;
+  }
+  return width;
+}
+
+/// Append the deltas of one list to data, packed width bits each
+void
+AppendBitPacked(
+    const std::vector<uint64_t>& deltas, uint8_t width,
+    std::vector<uint8_t>* data) {
+  data->emplace_back(width);
+  size_t start = data->size();
+  data->resize(start + (deltas.size() * width + 7) / 8);
+  uint64_t bit = 0;
+  for (uint64_t delta : deltas) {
+    for (uint8_t i = 0; i < width; ++i, ++bit) {
+      if (delta & (uint64_t{1} << i)) {
+        (*data)[start + bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+katana::Result<tsuba::CompressedCSRTopologyView>
+tsuba::CompressedCSRTopologyView::Make(const void* ptr, uint64_t size) {
+  const auto* base = static_cast<const uint8_t*>(ptr);
+  uint64_t offset = sizeof(CSRTopologyHeader);
+  if (size < offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology too small: {}", size);
+  }
+
+  CompressedCSRTopologyView view;
+  view.header_ = reinterpret_cast<const CSRTopologyHeader*>(base);
+  if (view.header_->version != kCompressedCSRTopologyVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "not a compressed topology: version {}",
+        view.header_->version);
+  }
+
+  uint64_t num_nodes = view.header_->num_nodes;
+  view.out_indexes_ = reinterpret_cast<const uint64_t*>(base + offset);
+  offset += num_nodes * sizeof(uint64_t);
+
+  view.info_ =
+      reinterpret_cast<const CompressedCSRTopologyInfo*>(base + offset);
+  offset += sizeof(CompressedCSRTopologyInfo);
+  if (size < offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "compressed topology truncated: size {} expected at least {}", size,
+        offset);
+  }
+
+  auto encoding = static_cast<TopologyEncoding>(view.info_->encoding);
+  if (encoding != TopologyEncoding::kVarint &&
+      encoding != TopologyEncoding::kBitPacked) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown topology encoding {}",
+        view.info_->encoding);
+  }
+  if (view.info_->nodes_per_block == 0 ||
+      view.info_->data_size < kCompressedCSRTopologyPadding) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "malformed compressed topology info");
+  }
+
+  view.block_offsets_ = reinterpret_cast<const uint64_t*>(base + offset);
+  offset += NumBlocks(num_nodes, view.info_->nodes_per_block) *
+            sizeof(uint64_t);
+  view.data_ = base + offset;
+  offset += view.info_->data_size;
+  if (size < offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "compressed topology truncated: size {} expected {}", size, offset);
+  }
+
+  if (num_nodes > 0 &&
+      view.out_indexes_[num_nodes - 1] != view.header_->num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "compressed topology has {} edges but its indexes end at {}",
+        view.header_->num_edges, view.out_indexes_[num_nodes - 1]);
+  }
+
+  return view;
+}
+
+const uint8_t*
+tsuba::CompressedCSRTopologyView::FindList(Node node) const {
+  uint64_t nodes_per_block = info_->nodes_per_block;
+  Node first = node - node % nodes_per_block;
+  const uint8_t* p = data_ + block_offsets_[node / nodes_per_block];
+
+  for (Node n = first; n < node; ++n) {
+    uint64_t num = degree(n);
+    if (num == 0) {
+      continue;
+    }
+    if (encoding() == TopologyEncoding::kVarint) {
+      // Every varint ends with the only byte that has its high bit clear
+      for (; num > 0; ++p) {
+        num -= !(*p & 0x80);
+      }
+    } else {
+      uint8_t width = *p;
+      p += 1 + (num * width + 7) / 8;
+    }
+  }
+  return p;
+}
+
+katana::Result<void>
+tsuba::WriteCompressedCSRTopology(
+    FileFrame* ff, uint64_t num_nodes, uint64_t num_edges,
+    const uint64_t* out_indexes, const uint32_t* out_dests,
+    TopologyEncoding encoding, uint64_t nodes_per_block) {
+  if (nodes_per_block == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "nodes_per_block must be positive");
+  }
+
+  std::vector<uint64_t> block_offsets;
+  block_offsets.reserve(NumBlocks(num_nodes, nodes_per_block));
+  std::vector<uint8_t> data;
+  std::vector<uint64_t> deltas;
+
+  uint64_t begin = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    if (n % nodes_per_block == 0) {
+      block_offsets.emplace_back(data.size());
+    }
+
+    uint64_t end = out_indexes[n];
+    deltas.clear();
+    int64_t prev = static_cast<int64_t>(n);
+    for (uint64_t e = begin; e < end; ++e) {
+      int64_t dest = out_dests[e];
+      deltas.emplace_back(internal::ZigZagEncode(dest - prev));
+      prev = dest;
+    }
+    begin = end;
+
+    if (deltas.empty()) {
+      continue;
+    }
+    if (encoding == TopologyEncoding::kVarint) {
+      for (uint64_t delta : deltas) {
+        AppendVarint(delta, &data);
+      }
+    } else {
+      uint64_t max = 0;
+      for (uint64_t delta : deltas) {
+        max = std::max(max, delta);
+      }
+      AppendBitPacked(deltas, BitWidth(max), &data);
+    }
+  }
+  if (begin != num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "topology has {} edges but its indexes end at {}", num_edges, begin);
+  }
+  data.resize(data.size() + kCompressedCSRTopologyPadding);
+
+  CSRTopologyHeader header{
+      .version = kCompressedCSRTopologyVersion,
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = num_edges,
+  };
+  CompressedCSRTopologyInfo info{
+      .encoding = static_cast<uint64_t>(encoding),
+      .nodes_per_block = nodes_per_block,
+      .data_size = data.size(),
+  };
+
+  std::pair<const void*, uint64_t> parts[] = {
+      {&header, sizeof(header)},
+      {out_indexes, num_nodes * sizeof(uint64_t)},
+      {&info, sizeof(info)},
+      {block_offsets.data(), block_offsets.size() * sizeof(uint64_t)},
+      {data.data(), data.size()},
+  };
+  for (const auto& [ptr, size] : parts) {
+    if (size == 0) {
+      continue;
+    }
+    arrow::Status aro_sts = ff->Write(ptr, size);
+    if (!aro_sts.ok()) {
+      return ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return katana::ResultSuccess();
+}
@@ -1,8 +1,16 @@
 // FaultTest: support for injecting faults into Katana's storage layer in order
-//  to test our crash recovery and transaction implementation
+//  to test our crash recovery and transaction implementation, and slowdowns
+//  to measure its performance against slow storage
 
 #include "tsuba/FaultTest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Random.h"
 
@@ -19,9 +27,104 @@ static const std::unordered_map<tsuba::internal::FaultMode, std::string>
         {tsuba::internal::FaultMode::UniformOverRun, "UniformOverRun"},
     };
 
+static std::mutex io_mutex_;
+static std::atomic<bool> io_active_{false};
+static tsuba::internal::IoFaultProfile io_profile_;
+static tsuba::internal::IoFaultStats io_stats_;
+/// When the transfers admitted so far will have used up the bandwidth
+static std::chrono::steady_clock::time_point io_free_at_;
+
 void
 tsuba::internal::FaultTestReport() {
   fmt::print("PtP count: {:d}\n", ptp_count_);
+  if (io_active_) {
+    IoFaultStats stats = IoFaultTestStats();
+    fmt::print(
+        "IoDelay ops: {:d} spikes: {:d} delay: {:d} us\n", stats.num_ops,
+        stats.num_spikes, stats.delay_us);
+  }
+}
+
+tsuba::internal::IoFaultProfile
+tsuba::internal::IoFaultProfile::FromEnv() {
+  IoFaultProfile profile;
+  if (int v = 0; katana::GetEnv("KATANA_IO_FAULT_LATENCY_US", &v) && v > 0) {
+    profile.latency_us = v;
+  }
+  if (double v = 0; katana::GetEnv("KATANA_IO_FAULT_BANDWIDTH", &v) && v > 0) {
+    profile.bandwidth = static_cast<uint64_t>(v);
+  }
+  if (double v = 0; katana::GetEnv("KATANA_IO_FAULT_SPIKE_PROB", &v)) {
+    profile.spike_prob = static_cast<float>(std::clamp(v, 0.0, 1.0));
+  }
+  if (int v = 0; katana::GetEnv("KATANA_IO_FAULT_SPIKE_US", &v) && v > 0) {
+    profile.spike_us = v;
+  }
+  return profile;
+}
+
+void
+tsuba::internal::IoFaultTestInit(const IoFaultProfile& profile) {
+  KATANA_LOG_VASSERT(
+      profile.spike_prob >= 0.0f && profile.spike_prob <= 1.0f,
+      "Spike probability must be between 0.0f and 1.0f");
+  std::lock_guard<std::mutex> lock(io_mutex_);
+  io_profile_ = profile;
+  io_stats_ = IoFaultStats{};
+  io_free_at_ = std::chrono::steady_clock::now();
+  io_active_ = profile.active();
+  if (io_active_) {
+    fmt::print(
+        "IoFaultTest latency {:d} us bandwidth {:d} B/s spikes {:f} x {:d} "
+        "us\n",
+        profile.latency_us, profile.bandwidth, profile.spike_prob,
+        profile.spike_us);
+  }
+}
+
+bool
+tsuba::internal::IoFaultTestActive() {
+  return io_active_;
+}
+
+tsuba::internal::IoFaultStats
+tsuba::internal::IoFaultTestStats() {
+  std::lock_guard<std::mutex> lock(io_mutex_);
+  return io_stats_;
+}
+
+void
+tsuba::internal::IoDelay(uint64_t bytes) {
+  if (!io_active_) {
+    return;
+  }
+  using std::chrono::microseconds;
+
+  auto now = std::chrono::steady_clock::now();
+  auto until = now;
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    if (io_profile_.bandwidth != 0 && bytes != 0) {
+      auto transfer = std::chrono::duration_cast<microseconds>(
+          std::chrono::duration<double>(
+              static_cast<double>(bytes) /
+              static_cast<double>(io_profile_.bandwidth)));
+      io_free_at_ = std::max(now, io_free_at_) + transfer;
+      until = io_free_at_;
+    }
+    until += microseconds(io_profile_.latency_us);
+    if (io_profile_.spike_prob > 0.0f && io_profile_.spike_us != 0) {
+      std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+      if (dist(katana::GetGenerator()) < io_profile_.spike_prob) {
+        until += microseconds(io_profile_.spike_us);
+        io_stats_.num_spikes++;
+      }
+    }
+    io_stats_.num_ops++;
+    io_stats_.delay_us +=
+        std::chrono::duration_cast<microseconds>(until - now).count();
+  }
+  std::this_thread::sleep_until(until);
 }
 
 void
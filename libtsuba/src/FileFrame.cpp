@@ -3,6 +3,8 @@
 #include <sys/mman.h>
 
 #include "katana/Logging.h"
+#include "katana/MappedArray.h"
+#include "katana/MemoryBudget.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -20,6 +22,7 @@ katana::Result<void>
 FileFrame::Destroy() {
   if (valid_) {
     int err = munmap(map_start_, map_size_);
+    katana::ReleaseMemory(katana::MemorySubsystem::kFileFrame, map_size_);
     valid_ = false;
     if (err) {
       return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
@@ -32,10 +35,16 @@ katana::Result<void>
 FileFrame::Init(uint64_t reserved_size) {
   size_t size_to_reserve = reserved_size <= 0 ? 1 : reserved_size;
   uint64_t map_size = tsuba::RoundUpToBlock(size_to_reserve);
+  if (auto res =
+          katana::ReserveMemory(katana::MemorySubsystem::kFileFrame, map_size);
+      !res) {
+    return res.error();
+  }
   void* ptr = katana::MmapPopulate(
       nullptr, map_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
       -1, 0);
   if (ptr == MAP_FAILED) {
+    katana::ReleaseMemory(katana::MemorySubsystem::kFileFrame, map_size);
     return KATANA_ERROR(katana::ResultErrno(), "mapping buffer");
   }
   if (auto res = Destroy(); !res) {
@@ -62,35 +71,20 @@ FileFrame::GrowBuffer(int64_t accomodate) {
   while (cursor_ + accomodate > new_size) {
     new_size *= 2;
   }
-  void* ptr = katana::MmapPopulate(
-      map_start_ + map_size_, new_size - map_size_, PROT_READ | PROT_WRITE,
-      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-  if (ptr != map_start_ + map_size_) {
-    if (ptr != MAP_FAILED) {
-      // Mapping succeeded, but not where we wanted it
-      int err = munmap(ptr, new_size - map_size_);
-      if (err) {
-        return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
-      }
-    } else {
-      return KATANA_ERROR(
-          katana::ResultErrno(), "mapping new memory to extend buffer");
-    }
-    // Just allocate a brand new buffer :(
-    ptr = nullptr;
-    ptr = katana::MmapPopulate(
-        nullptr, new_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
-        -1, 0);
-    if (ptr == MAP_FAILED) {
-      return KATANA_ERROR(katana::ResultErrno(), "mapping new buffer");
-    }
-    memcpy(ptr, map_start_, cursor_);
-    int err = munmap(map_start_, map_size_);
-    if (err) {
-      return KATANA_ERROR(katana::ResultErrno(), "unmapping old buffer");
-    }
-    map_start_ = static_cast<uint8_t*>(ptr);
+  if (auto res = katana::ReserveMemory(
+          katana::MemorySubsystem::kFileFrame, new_size - map_size_);
+      !res) {
+    return res.error();
+  }
+  // Move the pages rather than copying them; the new ones are committed as
+  // they are written
+  auto remap_res = katana::RemapAnonymous(map_start_, map_size_, new_size);
+  if (!remap_res) {
+    katana::ReleaseMemory(
+        katana::MemorySubsystem::kFileFrame, new_size - map_size_);
+    return remap_res.error().WithContext("extending buffer");
   }
+  map_start_ = static_cast<uint8_t*>(remap_res.value());
   map_size_ = new_size;
   return katana::ResultSuccess();
 }
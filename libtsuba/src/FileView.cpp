@@ -1,14 +1,20 @@
 #include "tsuba/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <string>
 
+#include "GlobalState.h"
+#include "LocalStorage.h"
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
 #include "katana/Result.h"
+#include "katana/Trace.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
 
@@ -52,7 +58,12 @@ FileView::Unbind() {
       }
     }
     valid_ = false;
+    read_only_ = false;
+    checksum_.reset();
   }
+  // Pages may have been fetched by a Bind that failed
+  katana::ReleaseMemory(katana::MemorySubsystem::kFileView, charged_);
+  charged_ = 0;
   return katana::ResultSuccess();
 }
 
@@ -64,6 +75,11 @@ FileView::Bind(
   if (auto res = FileStat(filename_, &buf); !res) {
     return res.error().WithContext("getting file size");
   }
+  if (checksum_ && checksum_->size != buf.size) {
+    return KATANA_ERROR(
+        ErrorCode::ChecksumMismatch, "{} is {} bytes, expected {}", filename,
+        buf.size, checksum_->size);
+  }
   uint64_t in_end = std::min<uint64_t>(end, static_cast<uint64_t>(buf.size));
   if (in_end < begin) {
     return KATANA_ERROR(
@@ -85,15 +101,20 @@ FileView::Bind(
     return KATANA_ERROR(katana::ResultErrno(), "reserving contiguous range");
   }
 
+  // The checksum is that of the file being bound, not the one unbound
+  std::shared_ptr<const FileChecksum> checksum = std::move(checksum_);
   if (auto res = Unbind(); !res) {
     return res.error().WithContext("resetting for new content");
   }
+  checksum_ = std::move(checksum);
 
   map_start_ = static_cast<uint8_t*>(tmp);
   mem_start_ = -1;
   filling_.resize(page_number(buf.size) / 64 + 1, 0);
   file_size_ = buf.size;
   fetches_ = std::make_unique<std::vector<FillingRange>>();
+  readahead_end_ = 0;
+  hinted_.clear();
   if (auto res = Fill(begin, in_end, resolve); !res) {
     return res.error().WithContext("reading content");
   }
@@ -103,6 +124,80 @@ FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+FileView::BindReadOnly(std::string_view filename, bool populate) {
+  std::string local_path(filename);
+  auto* local_storage = dynamic_cast<LocalStorage*>(FS(local_path));
+  if (local_storage == nullptr) {
+    // Only local files can be mapped directly; everything else needs to be
+    // copied in from storage
+    return Bind(filename, true);
+  }
+  local_storage->CleanUri(&local_path);
+
+  StatBuf buf;
+  if (auto res = FileStat(local_path, &buf); !res) {
+    return res.error().WithContext("getting file size");
+  }
+  if (buf.size == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot map empty file {}", filename);
+  }
+  if (checksum_ && checksum_->size != buf.size) {
+    return KATANA_ERROR(
+        ErrorCode::ChecksumMismatch, "{} is {} bytes, expected {}", filename,
+        buf.size, checksum_->size);
+  }
+
+  int fd = open(local_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", local_path);
+  }
+
+  int flags = MAP_SHARED;
+  if (populate) {
+    flags |= MAP_POPULATE;
+  }
+  void* tmp = mmap(nullptr, buf.size, PROT_READ, flags, fd, 0);
+  // The mapping holds its own reference to the file
+  close(fd);
+  if (tmp == MAP_FAILED) {
+    return KATANA_ERROR(katana::ResultErrno(), "mapping {}", local_path);
+  }
+
+#ifdef MADV_HUGEPAGE
+  // Advisory only; not all file systems support huge pages for file mappings
+  madvise(tmp, buf.size, MADV_HUGEPAGE);
+#endif
+
+  if (checksum_) {
+    if (auto res = checksum_->VerifyAll(static_cast<uint8_t*>(tmp)); !res) {
+      munmap(tmp, buf.size);
+      return res.error().WithContext("verifying {}", filename);
+    }
+  }
+
+  std::shared_ptr<const FileChecksum> checksum = std::move(checksum_);
+  if (auto res = Unbind(); !res) {
+    munmap(tmp, buf.size);
+    return res.error().WithContext("resetting for new content");
+  }
+  checksum_ = std::move(checksum);
+
+  filename_ = filename;
+  map_start_ = static_cast<uint8_t*>(tmp);
+  mem_start_ = 0;
+  file_size_ = buf.size;
+  filling_.clear();
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  readahead_end_ = 0;
+  hinted_.clear();
+  cursor_ = 0;
+  read_only_ = true;
+  valid_ = true;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
@@ -117,6 +212,10 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  // The whole file is already mapped; nothing to fetch
+  if (read_only_) {
+    return katana::ResultSuccess();
+  }
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
@@ -131,31 +230,52 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
         (last_page + 1) * (1UL << page_shift_) - file_off,
         file_size_ - file_off);
     if (found_empty) {
+      // The range may span pages fetched before, but no more than the file
+      // can be resident
+      uint64_t charge = std::min<uint64_t>(map_size, file_size_ - charged_);
+      if (auto res = katana::ReserveMemory(
+              katana::MemorySubsystem::kFileView, charge);
+          !res) {
+        return res.error().WithContext("fetching {}", filename_);
+      }
+      charged_ += charge;
       // Get physical pages for the region we are about to write
       int err =
           mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
       if (err == -1) {
         return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
       }
+      if (place_) {
+        place_(map_start_ + file_off, file_off, map_size);
+      }
 
       auto peek_fut =
           FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
       KATANA_LOG_ASSERT(peek_fut.valid());
-      FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
+      if (checksum_) {
+        peek_fut = VerifyWhenFetched(std::move(peek_fut), file_off, map_size);
+      }
+      FillingRange fetch = {
+          first_page, last_page, map_size, std::move(peek_fut)};
       fetches_->push_back(std::move(fetch));
+      if (!resolve) {
+        stats_.prefetched_bytes += map_size;
+      }
       if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
         return res.error().WithContext("updating bookkeeping data");
       }
-      if (resolve) {
-        if (auto res = Resolve(file_off, map_size); !res) {
-          return res.error().WithContext("resolving fill");
-        }
-      }
       int64_t signed_begin = static_cast<int64_t>(in_begin);
       if (mem_start_ < 0 || signed_begin < mem_start_) {
         mem_start_ = signed_begin;
       }
     }
+    // Wait for earlier fetches of the range, too, so that all of it can be
+    // read when this returns
+    if (resolve) {
+      if (auto res = Resolve(in_begin, in_end - in_begin); !res) {
+        return res.error().WithContext("resolving fill");
+      }
+    }
   }
   return katana::ResultSuccess();
 }
@@ -231,7 +351,7 @@ FileView::Read(int64_t nbytes) {
   }
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
+    return arrow::Status::IOError("FileView::Fill: ", res.error());
   }
   // resolve outstanding relevant fetches
   if (auto res = Resolve(cursor_, nbytes_internal); !res) {
@@ -266,7 +386,7 @@ FileView::Read(int64_t nbytes, void* out) {
   }
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
+    return arrow::Status::IOError("FileView::Fill: ", res.error());
   }
   // resolve outstanding relevant fetches
   if (auto res = Resolve(cursor_, nbytes_internal); !res) {
@@ -403,7 +523,7 @@ FileView::MustFill(uint64_t* bitmap, uint64_t begin, uint64_t end) {
   // searching backward
   if (found_first && !found_last) {
     // search backward for last page, skip end_block
-    for (uint64_t i = end_block - 1; i > begin_block && !found_last; ++i) {
+    for (uint64_t i = end_block - 1; i > begin_block && !found_last; --i) {
       if (~bitmap[i]) {
         last_page = LastPage(bitmap, i, 0, 63);
         found_last = true;
@@ -457,12 +577,26 @@ FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
-        if (auto res = fetch->work.get(); !res) {
-          return res.error();
+        katana::Result<void> res = katana::ResultSuccess();
+        if (fetch->work.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready) {
+          res = fetch->work.get();
+        } else {
+          katana::TraceSpan span("FileView stall", "io");
+          auto stall_begin = std::chrono::steady_clock::now();
+          res = fetch->work.get();
+          stats_.stalls += 1;
+          stats_.stall_time_us +=
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - stall_begin)
+                  .count();
+        }
+        if (!res) {
+          return FetchResult(*fetch, std::move(res));
         }
       } else {
         KATANA_LOG_DEBUG("bad future in FileView::Resolve {} {}", start, size);
@@ -475,20 +609,183 @@ FileView::Resolve(int64_t start, int64_t size) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+FileView::Reap() {
+  for (auto it = fetches_->begin(); it != fetches_->end();) {
+    if (it->work.valid() && it->work.wait_for(std::chrono::seconds(0)) !=
+                                std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    if (it->work.valid()) {
+      if (auto res = it->work.get(); !res) {
+        return FetchResult(*it, std::move(res));
+      }
+    }
+    it = fetches_->erase(it);
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::Result<void>>
+FileView::VerifyWhenFetched(
+    std::future<katana::Result<void>> fetch, uint64_t begin, uint64_t size) {
+  return std::async(
+      std::launch::async,
+      [fetch = std::move(fetch), checksum = checksum_, file = map_start_,
+       begin, size]() mutable -> katana::Result<void> {
+        // Errors are returned as codes because error context is local to
+        // the thread that creates it
+        if (auto res = fetch.get(); !res) {
+          return katana::ErrorInfo(res.error().error_code());
+        }
+        if (auto res = checksum->Verify(file, begin, begin + size); !res) {
+          return katana::ErrorInfo(res.error().error_code());
+        }
+        return katana::ResultSuccess();
+      });
+}
+
+katana::Result<void>
+FileView::FetchResult(
+    const FillingRange& fetch, katana::Result<void> res) const {
+  if (!res && res.error() == ErrorCode::ChecksumMismatch) {
+    return KATANA_ERROR(
+        ErrorCode::ChecksumMismatch, "{} in pages {} to {}", filename_,
+        fetch.first_page, fetch.last_page);
+  }
+  return res;
+}
+
+bool
+FileView::CanFetch() const {
+  uint64_t in_flight = 0;
+  for (const FillingRange& fetch : *fetches_) {
+    in_flight += fetch.size;
+  }
+  return fetches_->size() < readahead_.max_in_flight &&
+         in_flight < readahead_.max_bytes;
+}
+
+katana::Result<void>
+FileView::FetchHinted() {
+  while (!hinted_.empty() && CanFetch()) {
+    auto [begin, end] = hinted_.front();
+    hinted_.pop_front();
+    if (auto res = Fill(begin, end, false); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+FileView::WillNeed(uint64_t begin, uint64_t end) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  if (read_only_) {
+    return katana::ResultSuccess();
+  }
+  uint64_t range_size = std::max<uint64_t>(readahead_.range_size, 1);
+  end = std::min<uint64_t>(end, file_size_);
+  for (uint64_t b = begin; b < end; b += range_size) {
+    hinted_.emplace_back(b, std::min(b + range_size, end));
+  }
+  if (auto res = Reap(); !res) {
+    return res.error();
+  }
+  return FetchHinted();
+}
+
+katana::Result<void>
+FileView::Evict(uint64_t begin, uint64_t end) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  end = std::min<uint64_t>(end, file_size_);
+  uint64_t page_size = UINT64_C(1) << page_shift_;
+  uint64_t first_page = (begin + page_size - 1) >> page_shift_;
+  // The last page may be short
+  uint64_t end_page = end == static_cast<uint64_t>(file_size_)
+                          ? (end + page_size - 1) >> page_shift_
+                          : end >> page_shift_;
+  if (first_page >= end_page) {
+    return katana::ResultSuccess();
+  }
+  uint64_t offset = first_page << page_shift_;
+  uint64_t size = std::min<uint64_t>(end_page << page_shift_, file_size_) -
+                  offset;
+
+  if (read_only_) {
+    // The pages are backed by the file and read again when touched
+    if (madvise(map_start_ + offset, size, MADV_DONTNEED) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "evicting pages");
+    }
+    return katana::ResultSuccess();
+  }
+
+  // Fetches must not write to the pages after they are released
+  if (auto res = Resolve(offset, size); !res) {
+    return res.error();
+  }
+  if (madvise(map_start_ + offset, size, MADV_DONTNEED) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "evicting pages");
+  }
+  if (mprotect(map_start_ + offset, size, PROT_NONE) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+  }
+  uint64_t released = std::min(size, charged_);
+  katana::ReleaseMemory(katana::MemorySubsystem::kFileView, released);
+  charged_ -= released;
+  for (uint64_t page = first_page; page < end_page; ++page) {
+    filling_[page / 64] &= ~(UINT64_C(1) << (63 - page % 64));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
-  // Make sure we haven't overflown
-  KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
-  uint64_t begin = static_cast<uint64_t>(start + size);
-  uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
-  if (auto res = Fill(begin, end, false); !res) {
+  if (read_only_) {
+    return katana::ResultSuccess();
+  }
+  if (auto res = Reap(); !res) {
     return res.error();
   }
+  if (auto res = FetchHinted(); !res) {
+    return res.error();
+  }
+
+  uint64_t read_end = static_cast<uint64_t>(start + size);
+  switch (pattern_) {
+  case AccessPattern::kNormal: {
+    // Our highly sophisticated prefetching algorithm is to crudely
+    // approximate the size of the last read plus 10%. This is largely
+    // motivated by parquet files, which consecutively read row groups that
+    // are (in theory) approximately the same size.
+    int64_t fetch_size = (size / 10) * 11;
+    // Make sure we haven't overflown
+    KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
+    return Fill(read_end, read_end + fetch_size, false);
+  }
+  case AccessPattern::kSequential: {
+    // Keep up to max_bytes past the last read fetched or in flight
+    uint64_t range_size = std::max<uint64_t>(readahead_.range_size, 1);
+    uint64_t file_size = file_size_;
+    readahead_end_ = std::max(readahead_end_, read_end);
+    while (readahead_end_ < file_size &&
+           readahead_end_ - read_end < readahead_.max_bytes && CanFetch()) {
+      uint64_t end = std::min(readahead_end_ + range_size, file_size);
+      if (auto res = Fill(readahead_end_, end, false); !res) {
+        return res.error();
+      }
+      readahead_end_ = end;
+    }
+    return katana::ResultSuccess();
+  }
+  case AccessPattern::kRandom:
+    return katana::ResultSuccess();
+  }
   return katana::ResultSuccess();
 }
 }  // namespace tsuba
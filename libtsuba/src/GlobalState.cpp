@@ -5,9 +5,12 @@
 
 #include "FileStorage_internal.h"
 #include "MemoryNameServerClient.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/Uri.h"
 #include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
 
 namespace {
 
@@ -16,6 +19,23 @@ GetMemoryClient() {
   return std::make_unique<tsuba::MemoryNameServerClient>();
 }
 
+constexpr uint64_t kDefaultCacheCapacity = UINT64_C(64) << 30;
+
+uint64_t
+CacheCapacity() {
+  std::string value;
+  if (!katana::GetEnv("KATANA_STORAGE_CACHE_SIZE", &value)) {
+    return kDefaultCacheCapacity;
+  }
+  try {
+    return std::stoull(value);
+  } catch (const std::exception&) {
+    KATANA_LOG_WARN(
+        "KATANA_STORAGE_CACHE_SIZE is not a number of bytes: {}", value);
+    return kDefaultCacheCapacity;
+  }
+}
+
 }  // namespace
 
 std::unique_ptr<tsuba::GlobalState> tsuba::GlobalState::ref_ = nullptr;
@@ -45,6 +65,19 @@ tsuba::GlobalState::FS(std::string_view uri) const {
   return GetDefaultFS();
 }
 
+tsuba::FileCacheStats
+tsuba::GlobalState::CacheStats() const {
+  FileCacheStats total;
+  for (const auto& cache : caches_) {
+    FileCacheStats stats = cache->stats();
+    total.hits += stats.hits;
+    total.misses += stats.misses;
+    total.evictions += stats.evictions;
+    total.cached_bytes += stats.cached_bytes;
+  }
+  return total;
+}
+
 tsuba::NameServerClient*
 tsuba::GlobalState::NS() const {
   return name_server_client_;
@@ -69,6 +102,27 @@ tsuba::GlobalState::Init(
   }
   registered.clear();
 
+  // Remote backends may be wrapped with a local cache; the local file system
+  // is never cached
+  if (std::string cache_dir;
+      katana::GetEnv("KATANA_STORAGE_CACHE_DIR", &cache_dir)) {
+    uint64_t capacity = CacheCapacity();
+    for (FileStorage*& fs : global_state->file_stores_) {
+      if (fs == &global_state->local_storage_) {
+        continue;
+      }
+      std::string scheme(fs->uri_scheme());
+      scheme = scheme.substr(0, scheme.find(':'));
+      global_state->caches_.emplace_back(std::make_unique<CachingFileStorage>(
+          fs, katana::Uri::JoinPath(cache_dir, scheme), capacity));
+      fs = global_state->caches_.back().get();
+    }
+  }
+
+  if (auto profile = internal::IoFaultProfile::FromEnv(); profile.active()) {
+    internal::IoFaultTestInit(profile);
+  }
+
   std::sort(
       global_state->file_stores_.begin(), global_state->file_stores_.end(),
       [](const FileStorage* lhs, const FileStorage* rhs) {
@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector>
 
+#include "CachingFileStorage.h"
+#include "HttpStorage.h"
 #include "LocalStorage.h"
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
@@ -24,10 +26,15 @@ class GlobalState {
   tsuba::NameServerClient* name_server_client_;
 
   tsuba::LocalStorage local_storage_;
+  tsuba::HttpStorage http_storage_{"http://"};
+  tsuba::HttpStorage https_storage_{"https://"};
+  std::vector<std::unique_ptr<CachingFileStorage>> caches_;
 
   GlobalState(katana::CommBackend* comm, tsuba::NameServerClient* ns)
       : comm_(comm), name_server_client_(ns) {
     file_stores_.emplace_back(&local_storage_);
+    file_stores_.emplace_back(&http_storage_);
+    file_stores_.emplace_back(&https_storage_);
   }
 
   FileStorage* GetDefaultFS() const;
@@ -53,6 +60,8 @@ public:
   /// {no scheme} -> LocalStore
   FileStorage* FS(std::string_view uri) const;
 
+  FileCacheStats CacheStats() const;
+
   static katana::Result<void> Init(
       katana::CommBackend* comm, tsuba::NameServerClient* ns);
   static katana::Result<void> Fini();
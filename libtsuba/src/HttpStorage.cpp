@@ -0,0 +1,86 @@
+#include "HttpStorage.h"
+
+#include "katana/Http.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+
+namespace {
+
+std::future<katana::Result<void>>
+NotImplementedAsync(const char* operation, const std::string& uri) {
+  return std::async(
+      std::launch::deferred,
+      [operation, uri]() -> katana::Result<void> {
+        return KATANA_ERROR(
+            tsuba::ErrorCode::NotImplemented, "{} over HTTP: {}", operation,
+            uri);
+      });
+}
+
+}  // namespace
+
+katana::Result<void>
+tsuba::HttpStorage::GetRange(
+    const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf) {
+  uint64_t received = 0;
+  if (auto res = katana::HttpGetRange(uri, start, size, buf, &received);
+      !res) {
+    return res.error();
+  }
+  if (received != size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} bytes at {} of {}: received {}", size,
+        start, uri, received);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::HttpStorage::Init() {
+  return katana::HttpInit();
+}
+
+katana::Result<void>
+tsuba::HttpStorage::Stat(const std::string& uri, StatBuf* s_buf) {
+  if (auto res = katana::HttpHead(uri, &s_buf->size, &s_buf->version); !res) {
+    if (res.error() == katana::ErrorCode::NotFound) {
+      return ErrorCode::NotFound;
+    }
+    return res.error().WithContext("stat {}", uri);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::HttpStorage::PutMultiSync(
+    const std::string& uri, const uint8_t*, uint64_t) {
+  return KATANA_ERROR(ErrorCode::NotImplemented, "put over HTTP: {}", uri);
+}
+
+katana::Result<void>
+tsuba::HttpStorage::RemoteCopy(
+    const std::string& source_uri, const std::string&, uint64_t, uint64_t) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "copy over HTTP: {}", source_uri);
+}
+
+std::future<katana::Result<void>>
+tsuba::HttpStorage::PutAsync(
+    const std::string& uri, const uint8_t*, uint64_t) {
+  return NotImplementedAsync("put", uri);
+}
+
+std::future<katana::Result<void>>
+tsuba::HttpStorage::ListAsync(
+    const std::string& directory, std::vector<std::string>*,
+    std::vector<uint64_t>*) {
+  return NotImplementedAsync("list", directory);
+}
+
+katana::Result<void>
+tsuba::HttpStorage::Delete(
+    const std::string& directory, const std::unordered_set<std::string>&) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "delete over HTTP: {}", directory);
+}
@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBTSUBA_HTTPSTORAGE_H_
+#define KATANA_LIBTSUBA_HTTPSTORAGE_H_
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/RemoteFetcher.h"
+
+namespace tsuba {
+
+/// Read files served over HTTP(S), e.g., objects of a public bucket or
+/// presigned object store URLs, with range requests scheduled by a
+/// RemoteFetcher. HTTP offers no portable way to write, list or delete, so
+/// those operations return NotImplemented.
+class HttpStorage : public FileStorage {
+  RemoteFetcher fetcher_;
+
+  static katana::Result<void> GetRange(
+      const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf);
+
+public:
+  /// \param uri_scheme "http://" or "https://"
+  explicit HttpStorage(std::string_view uri_scheme)
+      : FileStorage(uri_scheme),
+        fetcher_(GetRange, RemoteFetchOptions::FromEnv()) {}
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return GetAsync(uri, start, size, result_buf).get();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override;
+
+  std::future<katana::Result<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+  std::future<katana::Result<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return fetcher_.Fetch(uri, start, size, result_buf);
+  }
+  std::future<katana::Result<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override;
+
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override;
+};
+
+}  // namespace tsuba
+
+#endif
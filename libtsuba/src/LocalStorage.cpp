@@ -8,11 +8,13 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <iterator>
 #include <system_error>
 
 #include <boost/filesystem.hpp>
 
+#include "AsyncIO.h"
 #include "GlobalState.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -22,6 +24,50 @@
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+/// Reads at least this large bypass the page cache when they are aligned;
+/// they are usually whole topologies or property files read once
+constexpr uint64_t kDirectIOMinSize = UINT64_C(4) << 20;
+
+/// Open path to read size bytes at start into buf, with O_DIRECT if the read
+/// is large and every part of it is aligned to a block. Returns -1 and sets
+/// errno on failure.
+int
+OpenForRead(
+    const std::string& path, uint64_t start, uint64_t size,
+    const uint8_t* buf) {
+  uint64_t alignment = reinterpret_cast<uintptr_t>(buf) | start | size;
+  if (size >= kDirectIOMinSize && alignment % tsuba::kBlockSize == 0) {
+    // Not every file system supports O_DIRECT
+    if (int fd = open(path.c_str(), O_RDONLY | O_DIRECT); fd >= 0) {
+      return fd;
+    }
+  }
+  return open(path.c_str(), O_RDONLY);
+}
+
+/// Create path and its parent directories, or truncate it if it exists, and
+/// open it for writing
+katana::Result<int>
+CreateFile(const std::string& path) {
+  fs::path dir = fs::path{path}.parent_path();
+  if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent diretories");
+    }
+  }
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+  return fd;
+}
+
+}  // namespace
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -34,23 +80,28 @@ katana::Result<void>
 tsuba::LocalStorage::WriteFile(
     std::string uri, const uint8_t* data, uint64_t size) {
   CleanUri(&uri);
-  fs::path m_path{uri};
-  fs::path dir = m_path.parent_path();
-  if (boost::system::error_code err; !fs::create_directories(dir, err)) {
-    if (err) {
-      return KATANA_ERROR(
-          std::error_code(err.value(), err.category()),
-          "creating parent diretories");
-    }
+  auto fd_res = CreateFile(uri);
+  if (!fd_res) {
+    return fd_res.error();
   }
-
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "opening file");
+  int fd = fd_res.value();
+  uint64_t written = 0;
+  while (written < size) {
+    ssize_t res = pwrite(fd, data + written, size - written, written);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      std::error_code ec = res < 0
+                               ? katana::ResultErrno()
+                               : make_error_code(ErrorCode::LocalStorageError);
+      close(fd);
+      return KATANA_ERROR(ec, "writing {}", uri);
+    }
+    written += res;
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  if (close(fd) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "closing {}", uri);
   }
   return katana::ResultSuccess();
 }
@@ -85,26 +136,118 @@ katana::Result<void>
 tsuba::LocalStorage::ReadFile(
     std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
   CleanUri(&uri);
-  std::ifstream ifile(uri);
-
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to seek");
+  int fd = OpenForRead(uri, start, size, data);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", uri);
   }
-
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  uint64_t read_size = 0;
+  while (read_size < size) {
+    ssize_t res =
+        pread(fd, data + read_size, size - read_size, start + read_size);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res < 0) {
+      std::error_code ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(ec, "reading {}", uri);
+    }
+    if (res == 0) {
+      break;
+    }
+    read_size += res;
   }
+  close(fd);
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
+  if (size - read_size > kBlockSize) {
     return ErrorCode::LocalStorageError;
   }
   return katana::ResultSuccess();
 }
 
+std::future<katana::Result<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  std::string path = uri;
+  CleanUri(&path);
+  auto fd_res = CreateFile(path);
+  if (!fd_res) {
+    return std::async(
+        std::launch::deferred,
+        [err = fd_res.error()]() -> katana::Result<void> { return err; });
+  }
+  int fd = fd_res.value();
+
+  auto promise = std::make_shared<std::promise<katana::Result<void>>>();
+  auto future = promise->get_future();
+  AsyncIO::Get().Submit(AsyncIO::Request{
+      .kind = AsyncIO::Request::kWrite,
+      .fd = fd,
+      // AsyncIO shares the buffer type between reads and writes
+      .buf = const_cast<uint8_t*>(data),  // NOLINT
+      .size = size,
+      .offset = 0,
+      .done =
+          [fd, promise](std::error_code ec, uint64_t) {
+            if (close(fd) != 0 && !ec) {
+              ec = katana::ResultErrno();
+            }
+            if (ec) {
+              promise->set_value(ec);
+              return;
+            }
+            promise->set_value(katana::ResultSuccess());
+          },
+  });
+  return future;
+}
+
+std::future<katana::Result<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string path = uri;
+  CleanUri(&path);
+  int fd = OpenForRead(path, start, size, result_buf);
+  if (fd < 0) {
+    std::error_code ec = katana::ResultErrno();
+    return std::async(
+        std::launch::deferred, [ec, path]() -> katana::Result<void> {
+          return KATANA_ERROR(ec, "opening {}", path);
+        });
+  }
+
+  // The callback runs on an AsyncIO thread, so it reports plain error codes
+  // rather than building error context in another thread's error state
+  auto promise = std::make_shared<std::promise<katana::Result<void>>>();
+  auto future = promise->get_future();
+  AsyncIO::Get().Submit(AsyncIO::Request{
+      .kind = AsyncIO::Request::kRead,
+      .fd = fd,
+      .buf = result_buf,
+      .size = size,
+      .offset = start,
+      .done =
+          [fd, size, promise](std::error_code ec, uint64_t read_size) {
+            close(fd);
+            if (ec) {
+              promise->set_value(ec);
+              return;
+            }
+            // As in ReadFile, a short read within the last block is fine
+            if (size - read_size > kBlockSize) {
+              promise->set_value(
+                  make_error_code(ErrorCode::LocalStorageError));
+              return;
+            }
+            promise->set_value(katana::ResultSuccess());
+          },
+  });
+  return future;
+}
+
 katana::Result<void>
 tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string filename = uri;
@@ -115,6 +258,8 @@ tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
     return katana::ResultErrno();
   }
   s_buf->size = local_s_buf.st_size;
+  s_buf->version = fmt::format(
+      "{}.{:09}", local_s_buf.st_mtim.tv_sec, local_s_buf.st_mtim.tv_nsec);
   return katana::ResultSuccess();
 }
 
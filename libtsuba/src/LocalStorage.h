@@ -6,17 +6,14 @@
 #include <cstdint>
 #include <future>
 #include <string>
-#include <thread>
 
 #include "katana/Result.h"
 #include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
 class LocalStorage : public FileStorage {
-  void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
   katana::Result<void> ReadFile(
@@ -28,6 +25,9 @@ class LocalStorage : public FileStorage {
 public:
   LocalStorage() : FileStorage("file://") {}
 
+  /// Strip the URI scheme, if any, leaving a path in the local file system
+  void CleanUri(std::string* uri);
+
   katana::Result<void> Init() override { return katana::ResultSuccess(); }
   katana::Result<void> Fini() override { return katana::ResultSuccess(); }
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
@@ -51,28 +51,14 @@ public:
     return RemoteCopyFile(source_uri, dest_uri, begin, size);
   }
 
-  // get on future can potentially block (bulk synchronous parallel)
+  /// PutAsync and GetAsync go through AsyncIO, so they do not need a thread
+  /// each and large transfers are split into concurrent chunks. The buffer
+  /// must stay valid until the future is ready.
   std::future<katana::Result<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return write_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::Result<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return read_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::Result<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
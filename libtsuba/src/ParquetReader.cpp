@@ -1,5 +1,18 @@
 #include "tsuba/ParquetReader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include <arrow/array.h>
+#include <arrow/util/parallel.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
+
+#include "katana/MemoryBudget.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 
@@ -8,6 +21,38 @@ using Result = katana::Result<T>;
 
 namespace {
 
+struct {
+  std::atomic<uint64_t> num_files{0};
+  std::atomic<uint64_t> fetch_us{0};
+  std::atomic<uint64_t> decode_us{0};
+  std::atomic<uint64_t> copy_us{0};
+} read_stats;
+
+uint64_t
+MicrosecondsBetween(
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+      .count();
+}
+
+/// Count a read of fv that started at begin, finished decoding at decoded
+/// and finished at end. Fetches are started ahead of the reads, so the time
+/// reads stalled on fv is the time spent fetching that decoding could not
+/// hide.
+void
+RecordRead(
+    const tsuba::FileView& fv, std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point decoded,
+    std::chrono::steady_clock::time_point end) {
+  uint64_t fetch_us = fv.stats().stall_time_us;
+  uint64_t read_us = MicrosecondsBetween(begin, decoded);
+  read_stats.num_files += 1;
+  read_stats.fetch_us += fetch_us;
+  read_stats.decode_us += read_us > fetch_us ? read_us - fetch_us : 0;
+  read_stats.copy_us += MicrosecondsBetween(decoded, end);
+}
+
 Result<std::shared_ptr<arrow::ChunkedArray>>
 ChunkedStringToLargeString(const std::shared_ptr<arrow::ChunkedArray>& arr) {
   arrow::LargeStringBuilder builder;
@@ -64,22 +109,328 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   }
 }
 
+Result<std::shared_ptr<arrow::ChunkedArray>>
+ChunkedDictionaryToLargeString(const arrow::ChunkedArray& arr) {
+  arrow::LargeStringBuilder builder;
+  for (const auto& chunk : arr.chunks()) {
+    const auto& dict_array = static_cast<const arrow::DictionaryArray&>(*chunk);
+    const auto& dictionary =
+        static_cast<const arrow::StringArray&>(*dict_array.dictionary());
+    for (int64_t i = 0, size = dict_array.length(); i < size; ++i) {
+      arrow::Status status = dict_array.IsValid(i)
+                                 ? builder.Append(dictionary.GetView(
+                                       dict_array.GetValueIndex(i)))
+                                 : builder.AppendNull();
+      if (!status.ok()) {
+        return KATANA_ERROR(
+            tsuba::ErrorCode::ArrowError, "appending to array: {}", status);
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::Array> new_arr;
+  if (auto status = builder.Finish(&new_arr); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "finishing array: {}", status);
+  }
+  return std::make_shared<arrow::ChunkedArray>(new_arr);
+}
+
+/// Dictionary columns come from string columns read with their parquet
+/// dictionaries. Row groups each have their own dictionary, so the chunks
+/// are given one shared dictionary, which lets them be combined. Columns
+/// with many distinct values do not save memory as dictionaries and are
+/// decoded into large strings like other string columns.
+Result<std::shared_ptr<arrow::ChunkedArray>>
+HandleDictionaryColumn(std::shared_ptr<arrow::ChunkedArray> array) {
+  if (array->type()->id() != arrow::Type::DICTIONARY) {
+    return array;
+  }
+  auto unified_res = arrow::DictionaryUnifier::UnifyChunkedArray(
+      array, katana::BudgetedMemoryPool());
+  if (!unified_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "unifying dictionaries: {}",
+        unified_res.status());
+  }
+  std::shared_ptr<arrow::ChunkedArray> unified = unified_res.ValueOrDie();
+  int64_t num_values = unified->length() - unified->null_count();
+  int64_t num_distinct =
+      unified->num_chunks() == 0
+          ? 0
+          : static_cast<const arrow::DictionaryArray&>(*unified->chunk(0))
+                .dictionary()
+                ->length();
+  if (num_distinct * 2 > num_values) {
+    return ChunkedDictionaryToLargeString(*unified);
+  }
+  return unified;
+}
+
+Result<std::shared_ptr<arrow::Table>>
+HandleDictionaryColumns(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  bool changed = false;
+  for (int i = 0, n = table->num_columns(); i < n; ++i) {
+    auto column_res = HandleDictionaryColumn(table->column(i));
+    if (!column_res) {
+      return column_res.error();
+    }
+    changed |= column_res.value() != table->column(i);
+    fields.emplace_back(
+        arrow::field(table->field(i)->name(), column_res.value()->type()));
+    columns.emplace_back(std::move(column_res.value()));
+  }
+  if (!changed) {
+    return table;
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/// \returns reader properties that read the string columns among columns
+/// with their dictionaries, if every chunk of them in row_groups is
+/// dictionary encoded
+parquet::ArrowReaderProperties
+ReaderProperties(
+    const parquet::FileMetaData& metadata, const std::vector<int>& row_groups,
+    const std::vector<int>& columns, bool dictionary_strings) {
+  parquet::ArrowReaderProperties props;
+  if (!dictionary_strings || row_groups.empty()) {
+    return props;
+  }
+  for (int column : columns) {
+    const parquet::ColumnDescriptor* leaf = metadata.schema()->Column(column);
+    if (leaf->physical_type() != parquet::Type::BYTE_ARRAY ||
+        !leaf->logical_type()->is_string() ||
+        leaf->max_repetition_level() != 0) {
+      continue;
+    }
+    bool all_dictionary =
+        std::all_of(row_groups.begin(), row_groups.end(), [&](int rg) {
+          return metadata.RowGroup(rg)
+              ->ColumnChunk(column)
+              ->has_dictionary_page();
+        });
+    if (all_dictionary) {
+      props.set_read_dictionary(column, true);
+    }
+  }
+  return props;
+}
+
+void
+CollectLeafColumns(
+    const parquet::arrow::SchemaField& field, std::vector<int>* leaves) {
+  if (field.column_index >= 0) {
+    leaves->emplace_back(field.column_index);
+  }
+  for (const auto& child : field.children) {
+    CollectLeafColumns(child, leaves);
+  }
+}
+
+/// \returns the leaf column indices that hold the named top level columns, or
+/// all leaf columns if names is nullopt
+Result<std::vector<int>>
+ProjectColumns(
+    parquet::arrow::FileReader* reader,
+    const std::optional<std::vector<std::string>>& names) {
+  std::vector<int> leaves;
+  if (!names) {
+    int num_columns = reader->parquet_reader()->metadata()->num_columns();
+    for (int i = 0; i < num_columns; ++i) {
+      leaves.emplace_back(i);
+    }
+    return leaves;
+  }
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (auto status = reader->GetSchema(&schema); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "reading schema: {}", status);
+  }
+  for (const auto& name : names.value()) {
+    int field_index = schema->GetFieldIndex(name);
+    if (field_index < 0) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument, "no column named {}", name);
+    }
+    CollectLeafColumns(
+        reader->manifest().schema_fields[field_index], &leaves);
+  }
+  return leaves;
+}
+
+/// Hint fv with the column chunks that reading columns of row_groups will
+/// decode, so that they are fetched several at a time rather than one read
+/// at a time. Anything else that is read is fetched when it is read.
+Result<void>
+HintColumnChunks(
+    tsuba::FileView* fv, const parquet::FileMetaData& metadata,
+    const std::vector<int>& row_groups, const std::vector<int>& columns) {
+  fv->Advise(tsuba::AccessPattern::kRandom);
+  for (int rg : row_groups) {
+    std::unique_ptr<parquet::RowGroupMetaData> rg_md = metadata.RowGroup(rg);
+    for (int column : columns) {
+      std::unique_ptr<parquet::ColumnChunkMetaData> chunk =
+          rg_md->ColumnChunk(column);
+      int64_t begin = chunk->has_dictionary_page()
+                          ? chunk->dictionary_page_offset()
+                          : chunk->data_page_offset();
+      if (auto res =
+              fv->WillNeed(begin, begin + chunk->total_compressed_size());
+          !res) {
+        return res.error();
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Read row_groups of the file of reader as props say. When use_threads is
+/// set, each row group is decoded by a separate task with its own parquet
+/// reader, since readers are not safe to share between threads; fv
+/// serializes the underlying reads.
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroups(
+    const std::shared_ptr<tsuba::FileView>& fv,
+    parquet::arrow::FileReader* reader, const std::vector<int>& row_groups,
+    const std::vector<int>& columns,
+    const parquet::ArrowReaderProperties& props, bool use_threads) {
+  std::shared_ptr<parquet::FileMetaData> metadata =
+      reader->parquet_reader()->metadata();
+  auto make_reader = [&](std::unique_ptr<parquet::arrow::FileReader>* out) {
+    return parquet::arrow::FileReader::Make(
+        katana::BudgetedMemoryPool(),
+        parquet::ParquetFileReader::Open(
+            fv, parquet::default_reader_properties(), metadata),
+        props, out);
+  };
+
+  std::shared_ptr<arrow::Table> out;
+  if (!use_threads || row_groups.size() < 2) {
+    std::unique_ptr<parquet::arrow::FileReader> props_reader;
+    auto read_result = make_reader(&props_reader);
+    if (read_result.ok()) {
+      read_result = props_reader->ReadRowGroups(row_groups, columns, &out);
+    }
+    if (!read_result.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "arrow error: {}", read_result);
+    }
+    return out;
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> tables(row_groups.size());
+  auto read_result = arrow::internal::ParallelFor(
+      static_cast<int>(row_groups.size()), [&](int i) -> arrow::Status {
+        // Exceptions must not escape into the thread pool
+        try {
+          std::unique_ptr<parquet::arrow::FileReader> rg_reader;
+          ARROW_RETURN_NOT_OK(make_reader(&rg_reader));
+          return rg_reader->ReadRowGroup(row_groups[i], columns, &tables[i]);
+        } catch (const std::exception& exp) {
+          return arrow::Status::IOError(exp.what());
+        }
+      });
+  if (!read_result.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", read_result);
+  }
+
+  auto concat_result = arrow::ConcatenateTables(tables);
+  if (!concat_result.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}",
+        concat_result.status());
+  }
+  return concat_result.ValueOrDie();
+}
+
 }  // namespace
 
+tsuba::ParquetReadStats
+tsuba::GetParquetReadStats() {
+  ParquetReadStats stats;
+  stats.num_files = read_stats.num_files;
+  stats.fetch_us = read_stats.fetch_us;
+  stats.decode_us = read_stats.decode_us;
+  stats.copy_us = read_stats.copy_us;
+  return stats;
+}
+
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(std::optional<Slice> slice) {
-  return std::unique_ptr<ParquetReader>(new ParquetReader(slice));
+  return Make(ReadOpts{.slice = slice});
+}
+
+Result<std::unique_ptr<tsuba::ParquetReader>>
+tsuba::ParquetReader::Make(const ReadOpts& opts) {
+  if (opts.slice && opts.row_group_filter) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument,
+        "row group filters cannot be combined with slices");
+  }
+  return std::unique_ptr<ParquetReader>(new ParquetReader(opts));
+}
+
+tsuba::ParquetReader::RowGroupFilter
+tsuba::ParquetReader::MakeRangeFilter(int column, int64_t min, int64_t max) {
+  return [column, min, max](const parquet::RowGroupMetaData& rg_md) {
+    if (column < 0 || column >= rg_md.num_columns()) {
+      return true;
+    }
+    std::shared_ptr<parquet::Statistics> stats =
+        rg_md.ColumnChunk(column)->statistics();
+    if (!stats || !stats->HasMinMax()) {
+      return true;
+    }
+    switch (stats->physical_type()) {
+    case parquet::Type::INT32: {
+      auto typed = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+      return typed->max() >= min && typed->min() <= max;
+    }
+    case parquet::Type::INT64: {
+      auto typed = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+      return typed->max() >= min && typed->min() <= max;
+    }
+    default:
+      return true;
+    }
+  };
+}
+
+Result<int64_t>
+tsuba::ParquetReader::NumRows(const katana::Uri& uri) {
+  auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
+  // Bind without filling anything; the parquet reader only touches the footer
+  if (auto res = fv->Bind(uri.string(), 0, 0, false); !res) {
+    return res.error();
+  }
+
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  auto open_file_result =
+      parquet::arrow::OpenFile(fv, katana::BudgetedMemoryPool(), &reader);
+  if (!open_file_result.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", open_file_result);
+  }
+
+  return reader->parquet_reader()->metadata()->num_rows();
 }
 
-// Internal use only, invoke iff slice_ has a value
+// Internal use only, invoke iff opts_.slice has a value
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
-  auto slice = slice_.value();
+  auto slice = opts_.slice.value();
   if (slice.offset < 0 || slice.length < 0) {
     return tsuba::ErrorCode::InvalidArgument;
   }
 
+  auto begin = std::chrono::steady_clock::now();
   auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
+  fv->ExpectChecksum(opts_.checksum);
   if (auto res = fv->Bind(uri.string(), 0, 0, false); !res) {
     return res.error();
   }
@@ -87,7 +438,7 @@ tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
   std::unique_ptr<parquet::arrow::FileReader> reader;
 
   auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
+      parquet::arrow::OpenFile(fv, katana::BudgetedMemoryPool(), &reader);
   if (!open_file_result.ok()) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow error: {}", open_file_result);
@@ -97,74 +448,121 @@ tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
   int64_t last_row = slice.offset + slice.length;
   for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
     auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
     int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
     if (slice.offset < cumulative_rows + new_rows) {
       if (row_groups.empty()) {
         row_offset = slice.offset - cumulative_rows;
-        file_offset = cumulative_bytes;
       }
       row_groups.push_back(i);
     }
     cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
+  auto columns_res = ProjectColumns(reader.get(), opts_.columns);
+  if (!columns_res) {
+    return columns_res.error();
+  }
+
+  if (auto res = HintColumnChunks(
+          fv.get(), *reader->parquet_reader()->metadata(), row_groups,
+          columns_res.value());
+      !res) {
     return res.error();
   }
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadRowGroups(row_groups, &out);
-  if (!read_result.ok()) {
-    return KATANA_ERROR(
-        tsuba::ErrorCode::ArrowError, "arrow error: {}", read_result);
+  auto read_res = ReadRowGroups(
+      fv, reader.get(), row_groups, columns_res.value(),
+      ReaderProperties(
+          *reader->parquet_reader()->metadata(), row_groups,
+          columns_res.value(), opts_.dictionary_strings),
+      opts_.use_threads);
+  if (!read_res) {
+    return read_res.error();
   }
 
-  out = out->Slice(row_offset, slice.length);
+  auto decoded = std::chrono::steady_clock::now();
+  auto dict_res = HandleDictionaryColumns(
+      read_res.value()->Slice(row_offset, slice.length));
+  if (!dict_res) {
+    return dict_res.error();
+  }
+  std::shared_ptr<arrow::Table> out = std::move(dict_res.value());
 
-  auto combine_result = out->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = out->CombineChunks(katana::BudgetedMemoryPool());
   if (!combine_result.ok()) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow error: {}",
         combine_result.status());
   }
+  RecordRead(*fv, begin, decoded, std::chrono::steady_clock::now());
   return combine_result.ValueOrDie();
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadFromUri(const katana::Uri& uri) {
-  if (slice_) {
+  if (opts_.slice) {
     // logic for a sliced read is different enough not to bother trying
     // to DRY these out
     return ReadFromUriSliced(uri);
   }
 
+  auto begin = std::chrono::steady_clock::now();
+  // Bind without filling anything; only the chunks of the columns and row
+  // groups that are read need to be fetched
   auto fv = std::make_shared<tsuba::FileView>();
-  if (auto res = fv->Bind(uri.string(), false); !res) {
+  fv->ExpectChecksum(opts_.checksum);
+  if (auto res = fv->Bind(uri.string(), 0, 0, false); !res) {
     return res.error().WithContext("preparing read buffer");
   }
 
   std::unique_ptr<parquet::arrow::FileReader> reader;
 
   auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
+      parquet::arrow::OpenFile(fv, katana::BudgetedMemoryPool(), &reader);
   if (!open_file_result.ok()) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow error: {}", open_file_result);
   }
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadTable(&out);
-  if (!read_result.ok()) {
-    return KATANA_ERROR(
-        tsuba::ErrorCode::ArrowError, "arrow error: {}", read_result);
+  std::vector<int> row_groups;
+  std::shared_ptr<parquet::FileMetaData> metadata =
+      reader->parquet_reader()->metadata();
+  for (int i = 0, rg_count = reader->num_row_groups(); i < rg_count; ++i) {
+    if (!opts_.row_group_filter ||
+        opts_.row_group_filter(*metadata->RowGroup(i))) {
+      row_groups.push_back(i);
+    }
+  }
+
+  auto columns_res = ProjectColumns(reader.get(), opts_.columns);
+  if (!columns_res) {
+    return columns_res.error();
+  }
+
+  if (auto res = HintColumnChunks(
+          fv.get(), *metadata, row_groups, columns_res.value());
+      !res) {
+    return res.error();
+  }
+
+  auto read_res = ReadRowGroups(
+      fv, reader.get(), row_groups, columns_res.value(),
+      ReaderProperties(
+          *metadata, row_groups, columns_res.value(),
+          opts_.dictionary_strings),
+      opts_.use_threads);
+  if (!read_res) {
+    return read_res.error();
+  }
+  auto decoded = std::chrono::steady_clock::now();
+  auto dict_res = HandleDictionaryColumns(read_res.value());
+  if (!dict_res) {
+    return dict_res.error();
   }
+  std::shared_ptr<arrow::Table> out = std::move(dict_res.value());
 
   std::vector<std::shared_ptr<arrow::ChunkedArray>> new_columns;
   arrow::SchemaBuilder schema_builder;
@@ -198,12 +596,13 @@ tsuba::ParquetReader::ReadFromUri(const katana::Uri& uri) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  auto combine_result = out->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = out->CombineChunks(katana::BudgetedMemoryPool());
   if (!combine_result.ok()) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow error: {}",
         combine_result.status());
   }
 
+  RecordRead(*fv, begin, decoded, std::chrono::steady_clock::now());
   return combine_result.ValueOrDie();
 }
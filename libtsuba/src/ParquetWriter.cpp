@@ -1,11 +1,21 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+
 #include <arrow/array/array_binary.h>
 #include <arrow/chunked_array.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/schema.h>
 
+#include "katana/Env.h"
+#include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
+#include "tsuba/PropertyStats.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -15,15 +25,86 @@ namespace {
 // constant taken directly from the arrow docs
 constexpr uint64_t kMaxStringChunkSize = 0x7FFFFFFE;
 
-std::shared_ptr<parquet::WriterProperties>
-StandardWriterProperties() {
+struct {
+  std::atomic<uint64_t> num_files{0};
+  std::atomic<uint64_t> arrow_bytes{0};
+  std::atomic<uint64_t> encoded_bytes{0};
+  std::atomic<uint64_t> encode_us{0};
+} write_stats;
+
+bool
+IsFloatingPoint(const arrow::DataType& type) {
+  switch (type.id()) {
+  case arrow::Type::HALF_FLOAT:
+  case arrow::Type::FLOAT:
+  case arrow::Type::DOUBLE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// \returns the writer properties for table. Options are given by column
+/// name, but parquet takes them by leaf column, i.e., per field of nested
+/// types, so they are set for every leaf of the column.
+katana::Result<std::shared_ptr<parquet::WriterProperties>>
+MakeWriterProperties(
+    const arrow::Table& table, const tsuba::ParquetWriteOptions& opts) {
   // int64 timestamps with nanosecond resolution requires Parquet version 2.0.
   // In Arrow to Parquet version 1.0, nanosecond timestamps will get truncated
   // to milliseconds.
-  return parquet::WriterProperties::Builder()
-      .version(parquet::ParquetVersion::PARQUET_2_0)
-      ->data_page_version(parquet::ParquetDataPageVersion::V2)
-      ->build();
+  parquet::WriterProperties::Builder builder;
+  builder.version(parquet::ParquetVersion::PARQUET_2_0)
+      ->data_page_version(parquet::ParquetDataPageVersion::V2);
+
+  std::shared_ptr<parquet::SchemaDescriptor> parquet_schema;
+  auto schema_status = parquet::arrow::ToParquetSchema(
+      table.schema().get(), *builder.build(),
+      *parquet::default_arrow_writer_properties(), &parquet_schema);
+  if (!schema_status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "converting schema: {}", schema_status);
+  }
+
+  std::unordered_map<std::string, tsuba::ColumnWriteOptions> column_opts;
+  for (int i = 0, n = table.num_columns(); i < n; ++i) {
+    const std::string& name = table.field(i)->name();
+    if (auto it = opts.columns.find(name); it != opts.columns.end()) {
+      column_opts.emplace(name, it->second);
+    } else if (opts.auto_tune) {
+      column_opts.emplace(
+          name, tsuba::ParquetWriteOptions::TuneColumn(
+                    *table.field(i)->type(),
+                    tsuba::ComputePropertyStats(*table.column(i)),
+                    opts.defaults));
+    } else {
+      column_opts.emplace(name, opts.defaults);
+    }
+  }
+
+  for (int i = 0, n = parquet_schema->num_columns(); i < n; ++i) {
+    const parquet::ColumnDescriptor* leaf = parquet_schema->Column(i);
+    std::shared_ptr<parquet::schema::ColumnPath> path = leaf->path();
+    const tsuba::ColumnWriteOptions& column =
+        column_opts.at(path->ToDotVector().front());
+
+    builder.compression(path, column.compression);
+    if (column.compression_level) {
+      builder.compression_level(path, *column.compression_level);
+    }
+    if (column.dictionary) {
+      builder.enable_dictionary(path);
+    } else {
+      builder.disable_dictionary(path);
+    }
+    parquet::Type::type physical_type = leaf->physical_type();
+    if (column.byte_stream_split && !column.dictionary &&
+        (physical_type == parquet::Type::FLOAT ||
+         physical_type == parquet::Type::DOUBLE)) {
+      builder.encoding(path, parquet::Encoding::BYTE_STREAM_SPLIT);
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -31,34 +112,92 @@ StandardArrowProperties() {
   return parquet::ArrowWriterProperties::Builder().build();
 }
 
-/// Store the arrow table in a file
-katana::Result<void>
-StoreParquet(
-    const arrow::Table& table, const katana::Uri& uri,
-    tsuba::WriteGroup* desc) {
+/// An estimate of the size of the parquet encoding of table. Encoded
+/// columns are rarely larger than their arrow buffers.
+uint64_t
+EstimateEncodedSize(const arrow::Table& table) {
+  uint64_t size = 0;
+  for (const auto& column : table.columns()) {
+    for (const auto& chunk : column->chunks()) {
+      for (const auto& buffer : chunk->data()->buffers) {
+        if (buffer) {
+          size += buffer->size();
+        }
+      }
+    }
+  }
+  return size;
+}
+
+/// Encode the arrow table as a parquet file in memory
+katana::Result<std::shared_ptr<tsuba::FileFrame>>
+EncodeParquet(
+    const arrow::Table& table, const tsuba::ParquetWriteOptions& opts) {
+  auto start = std::chrono::steady_clock::now();
+
   auto ff = std::make_shared<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error().WithContext("creating output buffer");
   }
 
-  auto write_result = parquet::arrow::WriteTable(
-      table, arrow::default_memory_pool(), ff,
-      std::numeric_limits<int64_t>::max(), StandardWriterProperties(),
-      StandardArrowProperties());
-
-  if (!write_result.ok()) {
+  try {
+    auto props_res = MakeWriterProperties(table, opts);
+    if (!props_res) {
+      return props_res.error();
+    }
+    auto write_result = parquet::arrow::WriteTable(
+        table, arrow::default_memory_pool(), ff,
+        std::max<int64_t>(opts.row_group_length, 1), props_res.value(),
+        StandardArrowProperties());
+    if (!write_result.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "arrow error: {}", write_result);
+    }
+  } catch (const std::exception& exp) {
     return KATANA_ERROR(
-        tsuba::ErrorCode::ArrowError, "arrow error: {}", write_result);
+        tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
   }
 
-  ff->Bind(uri.string());
+  write_stats.num_files += 1;
+  write_stats.arrow_bytes += EstimateEncodedSize(table);
+  write_stats.encoded_bytes += ff->Tell().ValueOr(0);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  write_stats.encode_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  return ff;
+}
+
+/// Store the arrow table in a file. With a write group, the table is encoded
+/// asynchronously, so that several tables can be encoded in parallel while
+/// earlier ones are being written.
+katana::Result<void>
+StoreParquet(
+    const std::shared_ptr<arrow::Table>& table,
+    const tsuba::ParquetWriteOptions& opts, const katana::Uri& uri,
+    tsuba::WriteGroup* desc) {
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
-  if (!desc) {
-    return ff->Persist();
+  if (desc) {
+    desc->StartStore(
+        uri.string(),
+        [table, opts, path = uri.string()]()
+            -> katana::Result<std::shared_ptr<tsuba::FileFrame>> {
+          auto ff_res = EncodeParquet(*table, opts);
+          if (!ff_res) {
+            return ff_res.error().WithContext("encoding {}", path);
+          }
+          ff_res.value()->Bind(path);
+          return ff_res;
+        },
+        EstimateEncodedSize(*table));
+    return katana::ResultSuccess();
   }
 
-  desc->StartStore(std::move(ff));
-  return katana::ResultSuccess();
+  auto ff_res = EncodeParquet(*table, opts);
+  if (!ff_res) {
+    return ff_res.error();
+  }
+  ff_res.value()->Bind(uri.string());
+  return ff_res.value()->Persist();
 }
 
 katana::Result<std::vector<std::shared_ptr<arrow::Array>>>
@@ -165,9 +304,68 @@ HandleBadParquetTypes(const std::shared_ptr<arrow::Table>& old_table) {
 
 }  // namespace
 
+tsuba::ParquetWriteOptions
+tsuba::ParquetWriteOptions::FromEnv() {
+  ParquetWriteOptions opts;
+  if (std::string name;
+      katana::GetEnv("KATANA_PARQUET_COMPRESSION", &name)) {
+    auto codec_res = arrow::util::Codec::GetCompressionType(name);
+    if (!codec_res.ok()) {
+      KATANA_LOG_WARN("unknown KATANA_PARQUET_COMPRESSION: {}", name);
+    } else if (!arrow::util::Codec::IsAvailable(*codec_res)) {
+      KATANA_LOG_WARN("compression {} is not available", name);
+    } else {
+      opts.defaults.compression = *codec_res;
+    }
+  }
+  if (int level{}; katana::GetEnv("KATANA_PARQUET_COMPRESSION_LEVEL", &level)) {
+    opts.defaults.compression_level = level;
+  }
+  if (int length{};
+      katana::GetEnv("KATANA_PARQUET_ROW_GROUP_LENGTH", &length)) {
+    if (length > 0) {
+      opts.row_group_length = length;
+    } else {
+      KATANA_LOG_WARN("KATANA_PARQUET_ROW_GROUP_LENGTH must be positive");
+    }
+  }
+  katana::GetEnv("KATANA_PARQUET_AUTO_TUNE", &opts.auto_tune);
+  return opts;
+}
+
+tsuba::ColumnWriteOptions
+tsuba::ParquetWriteOptions::TuneColumn(
+    const arrow::DataType& type, const PropertyStats& stats,
+    const ColumnWriteOptions& base) {
+  ColumnWriteOptions opts = base;
+  const ColumnStats& column = stats.column;
+  int64_t num_values = column.length - column.null_count;
+  if (column.distinct_count && num_values > 0) {
+    opts.dictionary = *column.distinct_count * 2 <= num_values;
+  }
+  // Dictionary arrays are read back as dictionaries only from dictionary
+  // pages
+  if (type.id() == arrow::Type::DICTIONARY) {
+    opts.dictionary = true;
+  }
+  opts.byte_stream_split = IsFloatingPoint(type) && !opts.dictionary;
+  return opts;
+}
+
+tsuba::ParquetWriteStats
+tsuba::GetParquetWriteStats() {
+  ParquetWriteStats stats;
+  stats.num_files = write_stats.num_files;
+  stats.arrow_bytes = write_stats.arrow_bytes;
+  stats.encoded_bytes = write_stats.encoded_bytes;
+  stats.encode_us = write_stats.encode_us;
+  return stats;
+}
+
 Result<std::unique_ptr<tsuba::ParquetWriter>>
 tsuba::ParquetWriter::Make(
-    std::shared_ptr<arrow::ChunkedArray> array, const std::string& name) {
+    std::shared_ptr<arrow::ChunkedArray> array, const std::string& name,
+    const ParquetWriteOptions& opts) {
   auto res = HandleBadParquetTypes(array);
   if (!res) {
     return res.error().WithContext("conversion from arrow to parquet mismatch");
@@ -176,25 +374,21 @@ tsuba::ParquetWriter::Make(
 
   std::shared_ptr<arrow::Table> column = arrow::Table::Make(
       arrow::schema({arrow::field(name, array->type())}), {array});
-  return std::unique_ptr<ParquetWriter>(new ParquetWriter(column));
+  return std::unique_ptr<ParquetWriter>(new ParquetWriter(column, opts));
 }
 
 Result<std::unique_ptr<tsuba::ParquetWriter>>
-tsuba::ParquetWriter::Make(std::shared_ptr<arrow::Table> table) {
+tsuba::ParquetWriter::Make(
+    std::shared_ptr<arrow::Table> table, const ParquetWriteOptions& opts) {
   auto res = HandleBadParquetTypes(table);
   if (!res) {
     return res.error().WithContext("conversion from arrow to parquet mismatch");
   }
   table = std::move(res.value());
-  return std::unique_ptr<ParquetWriter>(new ParquetWriter(table));
+  return std::unique_ptr<ParquetWriter>(new ParquetWriter(table, opts));
 }
 
 katana::Result<void>
 tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
-  try {
-    return StoreParquet(*table_, uri, group);
-  } catch (const std::exception& exp) {
-    return KATANA_ERROR(
-        tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
-  }
+  return StoreParquet(table_, opts_, uri, group);
 }
@@ -0,0 +1,444 @@
+#include "tsuba/PropertyStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+/// Hashes kept by a DistinctSketch
+constexpr size_t kSketchSize = 1024;
+
+/// The splitmix64 finalizer, which spreads the bits of x over all 64 bits
+uint64_t
+Mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/// A k minimum values sketch: the kSketchSize smallest hashes of the values
+/// seen. If the hashes are uniform, the largest of them is about
+/// kSketchSize / n of the hash range after n distinct values.
+class DistinctSketch {
+public:
+  void Add(uint64_t hash) {
+    if (hashes_.size() == kSketchSize && hash >= *hashes_.rbegin()) {
+      return;
+    }
+    if (hashes_.insert(hash).second && hashes_.size() > kSketchSize) {
+      hashes_.erase(std::prev(hashes_.end()));
+    }
+  }
+
+  void Merge(const DistinctSketch& other) {
+    for (uint64_t hash : other.hashes_) {
+      Add(hash);
+    }
+  }
+
+  int64_t Estimate() const {
+    if (hashes_.size() < kSketchSize) {
+      return hashes_.size();
+    }
+    double fraction = std::ldexp(static_cast<double>(*hashes_.rbegin()), -64);
+    return std::llround((kSketchSize - 1) / fraction);
+  }
+
+private:
+  std::set<uint64_t> hashes_;
+};
+
+/// What can be computed for a type
+struct StatsKind {
+  bool bounds{false};
+  bool distinct{false};
+};
+
+StatsKind
+KindOf(const arrow::DataType& type) {
+  switch (type.id()) {
+  case arrow::Type::BOOL:
+  case arrow::Type::UINT8:
+  case arrow::Type::INT8:
+  case arrow::Type::UINT16:
+  case arrow::Type::INT16:
+  case arrow::Type::UINT32:
+  case arrow::Type::INT32:
+  case arrow::Type::UINT64:
+  case arrow::Type::INT64:
+  case arrow::Type::FLOAT:
+  case arrow::Type::DOUBLE:
+  case arrow::Type::DATE32:
+  case arrow::Type::DATE64:
+  case arrow::Type::TIMESTAMP:
+  case arrow::Type::TIME32:
+  case arrow::Type::TIME64:
+  case arrow::Type::DURATION:
+    return StatsKind{.bounds = true, .distinct = true};
+  case arrow::Type::STRING:
+  case arrow::Type::LARGE_STRING:
+  case arrow::Type::BINARY:
+  case arrow::Type::LARGE_BINARY:
+    return StatsKind{.bounds = false, .distinct = true};
+  case arrow::Type::DICTIONARY:
+    // Only dictionaries of strings, whose hashes match those of AddBinary
+    switch (
+        static_cast<const arrow::DictionaryType&>(type).value_type()->id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY:
+      return StatsKind{.bounds = false, .distinct = true};
+    default:
+      return StatsKind{};
+    }
+  default:
+    return StatsKind{};
+  }
+}
+
+/// Statistics of the rows of one block seen so far
+struct Accumulator {
+  int64_t length{0};
+  int64_t null_count{0};
+  double min{std::numeric_limits<double>::infinity()};
+  double max{-std::numeric_limits<double>::infinity()};
+  DistinctSketch sketch;
+
+  void Merge(const Accumulator& other) {
+    length += other.length;
+    null_count += other.null_count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sketch.Merge(other.sketch);
+  }
+
+  tsuba::ColumnStats Finish(int64_t offset, StatsKind kind) const {
+    tsuba::ColumnStats stats{
+        .offset = offset,
+        .length = length,
+        .null_count = null_count,
+    };
+    if (kind.distinct) {
+      stats.distinct_count = sketch.Estimate();
+    }
+    if (kind.bounds && min <= max) {
+      stats.min = min;
+      stats.max = max;
+    }
+    return stats;
+  }
+};
+
+/// Convert v to double, rounding toward direction, which is -infinity or
+/// +infinity. Conversions of 64-bit integers may be inexact.
+template <typename T>
+double
+RoundTo(T v, double direction) {
+  double d = static_cast<double>(v);
+  if constexpr (std::is_integral_v<T>) {
+    auto exact = static_cast<long double>(v);
+    if ((direction < 0 && static_cast<long double>(d) > exact) ||
+        (direction > 0 && static_cast<long double>(d) < exact)) {
+      d = std::nextafter(d, direction);
+    }
+  }
+  return d;
+}
+
+template <typename T>
+uint64_t
+HashValue(T v) {
+  if constexpr (std::is_floating_point_v<T>) {
+    // -0.0 == 0.0
+    double d = v == 0 ? 0.0 : static_cast<double>(v);
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return Mix(bits);
+  } else {
+    return Mix(static_cast<uint64_t>(v));
+  }
+}
+
+template <typename ArrayType>
+void
+AddNumeric(
+    const arrow::Array& chunk, int64_t begin, int64_t end, Accumulator* acc) {
+  const auto& array = static_cast<const ArrayType&>(chunk);
+  using T = std::decay_t<decltype(array.Value(0))>;
+  bool has_nulls = array.null_count() > 0;
+  bool any = false;
+  T lo{};
+  T hi{};
+  for (int64_t i = begin; i < end; ++i) {
+    if (has_nulls && array.IsNull(i)) {
+      continue;
+    }
+    T v = array.Value(i);
+    acc->sketch.Add(HashValue(v));
+    if constexpr (std::is_floating_point_v<T>) {
+      if (std::isnan(v)) {
+        continue;
+      }
+    }
+    if (!any || v < lo) {
+      lo = v;
+    }
+    if (!any || hi < v) {
+      hi = v;
+    }
+    any = true;
+  }
+  if (any) {
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    acc->min = std::min(acc->min, RoundTo(lo, -kInf));
+    acc->max = std::max(acc->max, RoundTo(hi, kInf));
+  }
+}
+
+/// The hash of value i of a binary or string array
+template <typename ArrayType>
+uint64_t
+HashBinary(const ArrayType& array, int64_t i) {
+  auto view = array.GetView(i);
+  return Mix(std::hash<std::string_view>{}(
+      std::string_view(view.data(), view.size())));
+}
+
+template <typename ArrayType>
+void
+AddBinary(
+    const arrow::Array& chunk, int64_t begin, int64_t end, Accumulator* acc) {
+  const auto& array = static_cast<const ArrayType&>(chunk);
+  bool has_nulls = array.null_count() > 0;
+  for (int64_t i = begin; i < end; ++i) {
+    if (has_nulls && array.IsNull(i)) {
+      continue;
+    }
+    acc->sketch.Add(HashBinary(array, i));
+  }
+}
+
+/// Dictionary arrays are counted by their values, since chunks may have
+/// different dictionaries. Each value is hashed once per chunk.
+template <typename DictionaryType>
+void
+AddDictionary(
+    const arrow::Array& chunk, int64_t begin, int64_t end, Accumulator* acc) {
+  const auto& array = static_cast<const arrow::DictionaryArray&>(chunk);
+  const auto& dictionary =
+      static_cast<const DictionaryType&>(*array.dictionary());
+  std::vector<std::optional<uint64_t>> hashes(dictionary.length());
+  bool has_nulls = array.null_count() > 0;
+  for (int64_t i = begin; i < end; ++i) {
+    if (has_nulls && array.IsNull(i)) {
+      continue;
+    }
+    int64_t code = array.GetValueIndex(i);
+    if (!hashes[code]) {
+      hashes[code] = HashBinary(dictionary, code);
+    }
+    acc->sketch.Add(*hashes[code]);
+  }
+}
+
+int64_t
+CountNulls(const arrow::Array& chunk, int64_t begin, int64_t end) {
+  if (chunk.type_id() == arrow::Type::NA) {
+    return end - begin;
+  }
+  if (chunk.null_count() == 0) {
+    return 0;
+  }
+  int64_t nulls = 0;
+  for (int64_t i = begin; i < end; ++i) {
+    nulls += chunk.IsNull(i);
+  }
+  return nulls;
+}
+
+/// Add rows [begin, end) of chunk to acc
+void
+AddRows(
+    const arrow::Array& chunk, int64_t begin, int64_t end, Accumulator* acc) {
+  acc->length += end - begin;
+  acc->null_count += CountNulls(chunk, begin, end);
+
+  switch (chunk.type_id()) {
+  case arrow::Type::BOOL:
+    return AddNumeric<arrow::BooleanArray>(chunk, begin, end, acc);
+  case arrow::Type::UINT8:
+    return AddNumeric<arrow::UInt8Array>(chunk, begin, end, acc);
+  case arrow::Type::INT8:
+    return AddNumeric<arrow::Int8Array>(chunk, begin, end, acc);
+  case arrow::Type::UINT16:
+    return AddNumeric<arrow::UInt16Array>(chunk, begin, end, acc);
+  case arrow::Type::INT16:
+    return AddNumeric<arrow::Int16Array>(chunk, begin, end, acc);
+  case arrow::Type::UINT32:
+    return AddNumeric<arrow::UInt32Array>(chunk, begin, end, acc);
+  case arrow::Type::INT32:
+    return AddNumeric<arrow::Int32Array>(chunk, begin, end, acc);
+  case arrow::Type::UINT64:
+    return AddNumeric<arrow::UInt64Array>(chunk, begin, end, acc);
+  case arrow::Type::INT64:
+    return AddNumeric<arrow::Int64Array>(chunk, begin, end, acc);
+  case arrow::Type::FLOAT:
+    return AddNumeric<arrow::FloatArray>(chunk, begin, end, acc);
+  case arrow::Type::DOUBLE:
+    return AddNumeric<arrow::DoubleArray>(chunk, begin, end, acc);
+  case arrow::Type::DATE32:
+    return AddNumeric<arrow::Date32Array>(chunk, begin, end, acc);
+  case arrow::Type::DATE64:
+    return AddNumeric<arrow::Date64Array>(chunk, begin, end, acc);
+  case arrow::Type::TIMESTAMP:
+    return AddNumeric<arrow::TimestampArray>(chunk, begin, end, acc);
+  case arrow::Type::TIME32:
+    return AddNumeric<arrow::Time32Array>(chunk, begin, end, acc);
+  case arrow::Type::TIME64:
+    return AddNumeric<arrow::Time64Array>(chunk, begin, end, acc);
+  case arrow::Type::DURATION:
+    return AddNumeric<arrow::DurationArray>(chunk, begin, end, acc);
+  case arrow::Type::STRING:
+    return AddBinary<arrow::StringArray>(chunk, begin, end, acc);
+  case arrow::Type::LARGE_STRING:
+    return AddBinary<arrow::LargeStringArray>(chunk, begin, end, acc);
+  case arrow::Type::BINARY:
+    return AddBinary<arrow::BinaryArray>(chunk, begin, end, acc);
+  case arrow::Type::LARGE_BINARY:
+    return AddBinary<arrow::LargeBinaryArray>(chunk, begin, end, acc);
+  case arrow::Type::DICTIONARY:
+    switch (static_cast<const arrow::DictionaryType&>(*chunk.type())
+                .value_type()
+                ->id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:
+      return AddDictionary<arrow::BinaryArray>(chunk, begin, end, acc);
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY:
+      return AddDictionary<arrow::LargeBinaryArray>(chunk, begin, end, acc);
+    default:
+      return;
+    }
+  default:
+    return;
+  }
+}
+
+}  // namespace
+
+std::vector<std::pair<int64_t, int64_t>>
+tsuba::PropertyStats::RowRangesMayContain(double lo, double hi) const {
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  if (blocks.empty()) {
+    if (column.MayContain(lo, hi)) {
+      ranges.emplace_back(column.offset, column.offset + column.length);
+    }
+    return ranges;
+  }
+  for (const ColumnStats& block : blocks) {
+    if (!block.MayContain(lo, hi)) {
+      continue;
+    }
+    int64_t end = block.offset + block.length;
+    if (!ranges.empty() && ranges.back().second == block.offset) {
+      ranges.back().second = end;
+    } else {
+      ranges.emplace_back(block.offset, end);
+    }
+  }
+  return ranges;
+}
+
+tsuba::PropertyStats
+tsuba::ComputePropertyStats(const arrow::ChunkedArray& array) {
+  StatsKind kind = KindOf(*array.type());
+
+  std::vector<Accumulator> blocks(
+      (array.length() + kPropertyRowGroupLength - 1) /
+      kPropertyRowGroupLength);
+  int64_t offset = 0;
+  for (const auto& chunk : array.chunks()) {
+    for (int64_t begin = 0; begin < chunk->length();) {
+      int64_t row = offset + begin;
+      int64_t block = row / kPropertyRowGroupLength;
+      int64_t block_end = (block + 1) * kPropertyRowGroupLength;
+      int64_t end = std::min(chunk->length(), begin + block_end - row);
+      AddRows(*chunk, begin, end, &blocks[block]);
+      begin = end;
+    }
+    offset += chunk->length();
+  }
+
+  PropertyStats stats;
+  Accumulator total;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    stats.blocks.emplace_back(
+        blocks[i].Finish(i * kPropertyRowGroupLength, kind));
+    total.Merge(blocks[i]);
+  }
+  stats.column = total.Finish(0, kind);
+  return stats;
+}
+
+void
+tsuba::to_json(json& j, const tsuba::ColumnStats& stats) {
+  j = json{
+      {"offset", stats.offset},
+      {"length", stats.length},
+      {"null_count", stats.null_count},
+  };
+  if (stats.distinct_count) {
+    j["distinct_count"] = *stats.distinct_count;
+  }
+  // JSON has no infinities; an unbounded side is left out
+  if (stats.min && std::isfinite(*stats.min)) {
+    j["min"] = *stats.min;
+  }
+  if (stats.max && std::isfinite(*stats.max)) {
+    j["max"] = *stats.max;
+  }
+}
+
+void
+tsuba::from_json(const json& j, tsuba::ColumnStats& stats) {
+  j.at("offset").get_to(stats.offset);
+  j.at("length").get_to(stats.length);
+  j.at("null_count").get_to(stats.null_count);
+  if (auto it = j.find("distinct_count"); it != j.end()) {
+    stats.distinct_count = it->get<int64_t>();
+  }
+  if (auto it = j.find("min"); it != j.end()) {
+    stats.min = it->get<double>();
+  }
+  if (auto it = j.find("max"); it != j.end()) {
+    stats.max = it->get<double>();
+  }
+}
+
+void
+tsuba::to_json(json& j, const tsuba::PropertyStats& stats) {
+  j = json{
+      {"column", stats.column},
+      {"blocks", stats.blocks},
+  };
+}
+
+void
+tsuba::from_json(const json& j, tsuba::PropertyStats& stats) {
+  j.at("column").get_to(stats.column);
+  j.at("blocks").get_to(stats.blocks);
+}
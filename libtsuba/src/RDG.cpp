@@ -1,10 +1,14 @@
 #include "tsuba/RDG.h"
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <arrow/chunked_array.h>
@@ -27,11 +31,16 @@
 #include "katana/Backtrace.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
+#include "katana/MemoryBudget.h"
 #include "katana/Result.h"
+#include "katana/Time.h"
 #include "katana/Uri.h"
+#include "tsuba/ArrowIpc.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
+#include "tsuba/ParquetReader.h"
 #include "tsuba/ParquetWriter.h"
+#include "tsuba/PropertyStats.h"
 #include "tsuba/file.h"
 #include "tsuba/tsuba.h"
 
@@ -61,7 +70,23 @@ MasterPropName(unsigned i) {
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
+    const std::string& name, tsuba::WriteGroup* desc,
+    tsuba::PropertyFileFormat format = tsuba::PropertyFileFormat::kParquet) {
+  if (format == tsuba::PropertyFileFormat::kArrowIpc) {
+    auto path_res = katana::Uri::Make(
+        dir.RandFile(name).string() + std::string(tsuba::kArrowIpcSuffix));
+    if (!path_res) {
+      return path_res.error();
+    }
+    katana::Uri new_path = std::move(path_res.value());
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(name, array->type())}), {array});
+    if (auto res = tsuba::WriteArrowIpc(table, new_path, desc); !res) {
+      return res.error().WithContext("writing arrow ipc file");
+    }
+    return new_path.BaseName();
+  }
+
   auto writer_res = tsuba::ParquetWriter::Make(array, name);
   if (!writer_res) {
     return writer_res.error().WithContext("making property writer");
@@ -83,17 +108,20 @@ WriteProperties(
   const auto& schema = props.schema();
 
   std::vector<std::string> next_paths;
+  std::vector<tsuba::PropertyStats> next_stats;
   for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
     if (!prop_info[i].persist || !prop_info[i].path.empty()) {
       continue;
     }
     auto name = prop_info[i].name.empty() ? schema->field(i)->name()
                                           : prop_info[i].name;
-    auto name_res = StoreArrowArrayAtName(props.column(i), dir, name, desc);
+    auto name_res = StoreArrowArrayAtName(
+        props.column(i), dir, name, desc, prop_info[i].format);
     if (!name_res) {
       return name_res.error().WithContext("storing arrow array");
     }
     next_paths.emplace_back(name_res.value());
+    next_stats.emplace_back(tsuba::ComputePropertyStats(*props.column(i)));
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
@@ -102,16 +130,147 @@ WriteProperties(
   }
 
   std::vector<tsuba::PropStorageInfo> next_properties = prop_info;
-  auto it = next_paths.begin();
+  auto path_it = next_paths.begin();
+  auto stats_it = next_stats.begin();
   for (auto& v : next_properties) {
     if (v.persist && v.path.empty()) {
-      v.path = *it++;
+      v.path = *path_it++;
+      v.stats = std::move(*stats_it++);
     }
   }
 
   return next_properties;
 }
 
+using PropertyLoadFuture =
+    std::shared_future<katana::Result<std::shared_ptr<arrow::Table>>>;
+
+/// Deferred properties of one kind (node or edge), keyed by property name
+struct LazyPropertySet {
+  std::unordered_set<std::string> unloaded;
+  std::unordered_map<std::string, PropertyLoadFuture> pending;
+};
+
+/// LoadDeferred reads the property described by info if it has not been read
+/// yet, preferring the result of an earlier prefetch.
+///
+/// \returns the property table or nullptr if the property is already loaded
+katana::Result<std::shared_ptr<arrow::Table>>
+LoadDeferred(
+    const katana::Uri& dir, const tsuba::PropStorageInfo& info,
+    std::shared_ptr<const tsuba::FileChecksum> checksum,
+    LazyPropertySet* set) {
+  if (set->unloaded.count(info.name) == 0) {
+    return std::shared_ptr<arrow::Table>();
+  }
+
+  katana::Result<std::shared_ptr<arrow::Table>> load_result =
+      std::shared_ptr<arrow::Table>();
+  if (auto it = set->pending.find(info.name); it != set->pending.end()) {
+    load_result = it->second.get();
+    set->pending.erase(it);
+  } else {
+    load_result = tsuba::LoadProperties(
+        info.name, dir.Join(info.path), std::move(checksum));
+  }
+  if (!load_result) {
+    return load_result.error().WithContext(
+        "loading deferred property {}", info.name);
+  }
+
+  set->unloaded.erase(info.name);
+  return load_result.value();
+}
+
+void
+PrefetchDeferred(
+    const katana::Uri& dir, const tsuba::PropStorageInfo& info,
+    std::shared_ptr<const tsuba::FileChecksum> checksum,
+    LazyPropertySet* set) {
+  if (set->unloaded.count(info.name) == 0 || set->pending.count(info.name)) {
+    return;
+  }
+  set->pending.emplace(
+      info.name,
+      std::async(
+          std::launch::async,
+          [name = info.name, path = dir.Join(info.path),
+           checksum = std::move(checksum)]() {
+            return tsuba::LoadProperties(name, path, checksum);
+          })
+          .share());
+}
+
+uint64_t
+ArrayDataBytes(const arrow::ArrayData& data) {
+  uint64_t bytes = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer) {
+      bytes += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    bytes += ArrayDataBytes(*child);
+  }
+  if (data.dictionary) {
+    bytes += ArrayDataBytes(*data.dictionary);
+  }
+  return bytes;
+}
+
+/// EvictDeferred turns loaded properties of table back into placeholders,
+/// using replace, until at least bytes are freed. Only properties that can be
+/// read from storage again and whose data is not referenced outside of table
+/// are evicted.
+///
+/// \returns the bytes freed
+template <typename Replace>
+uint64_t
+EvictDeferred(
+    uint64_t bytes, const std::vector<tsuba::PropStorageInfo>& info_list,
+    const std::shared_ptr<arrow::Table>& table, Replace replace,
+    LazyPropertySet* set) {
+  uint64_t freed = 0;
+  for (size_t i = 0, n = info_list.size(); i < n && freed < bytes; ++i) {
+    const tsuba::PropStorageInfo& info = info_list[i];
+    // Properties without a path changed since they were stored
+    if (info.path.empty() || set->unloaded.count(info.name) ||
+        set->pending.count(info.name)) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> column = table->column(i);
+    // Placeholders have nothing to free. One reference is held by table and
+    // one by column.
+    if (column->type()->id() == arrow::Type::NA || column.use_count() > 2) {
+      continue;
+    }
+    uint64_t column_bytes = 0;
+    bool shared = false;
+    for (const auto& chunk : column->chunks()) {
+      if (chunk.use_count() > 1 || chunk->data().use_count() > 1) {
+        shared = true;
+        break;
+      }
+      column_bytes += ArrayDataBytes(*chunk->data());
+    }
+    if (shared) {
+      continue;
+    }
+    int64_t num_rows = column->length();
+    column.reset();
+    auto placeholder = arrow::Table::Make(
+        arrow::schema({arrow::field(info.name, arrow::null())}),
+        {std::make_shared<arrow::NullArray>(num_rows)}, num_rows);
+    if (auto res = replace(i, placeholder); !res) {
+      KATANA_LOG_WARN("evicting property {}: {}", info.name, res.error());
+      continue;
+    }
+    set->unloaded.insert(info.name);
+    freed += column_bytes;
+  }
+  return freed;
+}
+
 katana::Result<void>
 CommitRDG(
     tsuba::RDGHandle handle, uint32_t policy_id, bool transposed,
@@ -162,8 +321,72 @@ CommitRDG(
   return ret;
 }
 
+/// ShareColumns returns the named columns of table with read-only buffers
+/// (see katana::ShareReadOnly) and puts them into the RDG of table with
+/// replace, unless they are read-only already, e.g., because they were
+/// shared before
+template <typename EnsureLoaded, typename Replace>
+katana::Result<std::shared_ptr<arrow::Table>>
+ShareColumns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& names, EnsureLoaded ensure_loaded,
+    Replace replace) {
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    int i = table->schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::PropertyNotFound, "property {} not found", name);
+    }
+    if (auto res = ensure_loaded(i); !res) {
+      return res.error();
+    }
+    // Loading may have replaced the column
+    std::shared_ptr<arrow::ChunkedArray> column = table->column(i);
+    const arrow::ArrayVector& chunks = column->chunks();
+    if (std::any_of(chunks.begin(), chunks.end(), [](const auto& chunk) {
+          return katana::IsMutable(*chunk->data());
+        })) {
+      column = katana::ShareReadOnly(column);
+      auto res = replace(
+          i, arrow::Table::Make(
+                 arrow::schema({table->schema()->field(i)}), {column}));
+      if (!res) {
+        return res.error();
+      }
+    }
+    fields.emplace_back(table->schema()->field(i));
+    columns.emplace_back(std::move(column));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
 }  // namespace
 
+struct tsuba::RDG::LazyProperties {
+  ~LazyProperties() {
+    if (reclaimer_id != 0) {
+      katana::RemoveMemoryReclaimer(reclaimer_id);
+    }
+  }
+
+  katana::Uri dir;
+  // Recursive, since loads under the lock may need memory and run the
+  // reclaimer of this RDG on the same thread
+  std::recursive_mutex mutex;
+  LazyPropertySet node;
+  LazyPropertySet edge;
+  // Nonzero if RDGLoadOptions::evict_lazy_properties registered a reclaimer
+  uint64_t reclaimer_id{0};
+};
+
+struct tsuba::RDG::AuxTopologies {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::unique_ptr<FileFrame>> pending;
+  std::unordered_map<std::string, std::unique_ptr<FileView>> loaded;
+};
+
 katana::Result<void>
 tsuba::RDG::AddPartitionMetadataArray(
     const std::shared_ptr<arrow::Table>& props) {
@@ -196,6 +419,11 @@ tsuba::RDG::AddLineage(const std::string& command_line) {
   lineage_.AddCommandLine(command_line);
 }
 
+void
+tsuba::RDG::AddProvenance(const std::string& key, const std::string& value) {
+  lineage_.AddProvenance(key, value);
+}
+
 tsuba::RDGFile::~RDGFile() {
   auto result = Close(handle_);
   if (!result) {
@@ -303,6 +531,23 @@ tsuba::RDG::DoStore(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
+  // Auxiliary topologies were derived from the topology in memory, which is
+  // the one just written if any was
+  for (auto& [name, ff] : aux_->pending) {
+    katana::Uri aux_path =
+        handle.impl_->rdg_meta().dir().RandFile("aux_topology");
+    ff->Bind(aux_path.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    write_group->StartStore(std::move(ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().AddAuxTopology(tsuba::AuxTopologyInfo{
+        .name = name,
+        .path = aux_path.BaseName(),
+        .base_topology_path = core_->part_header().topology_path(),
+    });
+  }
+  aux_->pending.clear();
+
   auto node_write_result = WriteProperties(
       *core_->node_properties(), core_->part_header().node_prop_info_list(),
       handle.impl_->rdg_meta().dir(), write_group.get());
@@ -327,14 +572,31 @@ tsuba::RDG::DoStore(
   core_->part_header().set_edge_prop_info_list(
       std::move(edge_write_result.value()));
 
-  auto part_write_result =
-      WritePartArrays(handle.impl_->rdg_meta().dir(), write_group.get());
+  // Unchanged partition arrays are referenced where they are, like
+  // unchanged properties
+  const auto& part_prop_info_list = core_->part_header().part_prop_info_list();
+  if (part_arrays_dirty_ || part_prop_info_list.empty() ||
+      std::any_of(
+          part_prop_info_list.begin(), part_prop_info_list.end(),
+          [](const PropStorageInfo& info) { return info.path.empty(); })) {
+    auto part_write_result =
+        WritePartArrays(handle.impl_->rdg_meta().dir(), write_group.get());
+
+    if (!part_write_result) {
+      return part_write_result.error().WithContext(
+          "failed to write part arrays");
+    }
+    core_->part_header().set_part_properties(
+        std::move(part_write_result.value()));
+  }
 
-  if (!part_write_result) {
-    return part_write_result.error().WithContext("failed to write part arrays");
+  // The header records the checksums of the files it refers to, so it is
+  // written after them. This also keeps it from referring to files whose
+  // writes failed.
+  if (auto res = write_group->Finish(); !res) {
+    return res.error().WithContext("at least one async write failed");
   }
-  core_->part_header().set_part_properties(
-      std::move(part_write_result.value()));
+  core_->part_header().AddChecksums(write_group->TakeChecksums());
 
   if (auto write_result = core_->part_header().Write(handle, write_group.get());
       !write_result) {
@@ -350,46 +612,155 @@ tsuba::RDG::DoStore(
       !res) {
     return res.error().WithContext("failed to finalize RDG");
   }
+  lineage_.ClearProvenance();
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
-tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
-  auto node_result = AddProperties(
-      metadata_dir, core_->part_header().node_prop_info_list(),
-      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-        return rdg->core_->AddNodeProperties(props);
-      });
-  if (!node_result) {
-    return node_result.error();
+tsuba::RDG::DoMake(
+    const katana::Uri& metadata_dir, const RDGLoadOptions& opts) {
+  const RDGPartHeader& part_header = core_->part_header();
+  const std::vector<PropStorageInfo>& part_prop_info_list =
+      part_header.part_prop_info_list();
+
+  verify_checksums_ = opts.verify_checksums;
+
+  // Start reading every property file before binding the topology, so that
+  // the reads overlap instead of each waiting for the one before
+  std::vector<PropertyLoader::File> files;
+  auto add_files = [&](const std::vector<PropStorageInfo>& info_list) {
+    for (const PropStorageInfo& info : info_list) {
+      files.emplace_back(PropertyLoader::File{
+          info.name, metadata_dir.Join(info.path), std::nullopt,
+          ChecksumToVerify(info.path)});
+    }
+  };
+  size_t num_node_files = 0;
+  size_t num_edge_files = 0;
+  if (!opts.lazy_properties) {
+    num_node_files = part_header.node_prop_info_list().size();
+    num_edge_files = part_header.edge_prop_info_list().size();
+    add_files(part_header.node_prop_info_list());
+    add_files(part_header.edge_prop_info_list());
+  }
+  add_files(part_prop_info_list);
+  size_t num_files = files.size();
+  PropertyLoader loader(std::move(files));
+
+  if (opts.lazy_properties) {
+    lazy_ = std::make_unique<LazyProperties>();
+    lazy_->dir = metadata_dir;
+    if (auto res = AddLazyProperties(metadata_dir, true); !res) {
+      return res.error();
+    }
+    if (auto res = AddLazyProperties(metadata_dir, false); !res) {
+      return res.error();
+    }
+    if (opts.evict_lazy_properties) {
+      // Both objects stay where they are when the RDG moves, and lazy_ is
+      // destroyed before core_
+      LazyProperties* lazy = lazy_.get();
+      RDGCore* core = core_.get();
+      auto reclaim = [lazy, core](uint64_t bytes) {
+        std::unique_lock<std::recursive_mutex> lock(
+            lazy->mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+          return;
+        }
+        uint64_t freed = EvictDeferred(
+            bytes, core->part_header().node_prop_info_list(),
+            core->node_properties(),
+            [core](uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+              return core->ReplaceNodeProperty(i, props);
+            },
+            &lazy->node);
+        if (freed < bytes) {
+          freed += EvictDeferred(
+              bytes - freed, core->part_header().edge_prop_info_list(),
+              core->edge_properties(),
+              [core](uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+                return core->ReplaceEdgeProperty(i, props);
+              },
+              &lazy->edge);
+        }
+        if (freed > 0) {
+          KATANA_LOG_DEBUG(
+              "evicted {} of properties", katana::BytesToStr("{:.1f}{}", freed));
+        }
+      };
+      lazy_->reclaimer_id = katana::AddMemoryReclaimer(std::move(reclaim));
+    }
   }
 
-  auto edge_result = AddProperties(
-      metadata_dir, core_->part_header().edge_prop_info_list(),
-      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-        return rdg->core_->AddEdgeProperties(props);
-      });
-  if (!edge_result) {
-    return edge_result.error();
+  katana::Uri t_path = metadata_dir.Join(part_header.topology_path());
+  uint64_t topology_start_us = loader.ElapsedUs();
+  core_->topology_file_storage().ExpectChecksum(
+      ChecksumToVerify(part_header.topology_path()));
+  if (opts.map_topology_read_only) {
+    if (auto res = core_->topology_file_storage().BindReadOnly(
+            t_path.string(), opts.populate_topology);
+        !res) {
+      return res.error();
+    }
+  } else if (opts.fill_topology) {
+    FileView* view = &core_->topology_file_storage();
+    if (auto res = view->Bind(t_path.string(), 0, 0, false); !res) {
+      return res.error();
+    }
+    if (auto res = opts.fill_topology(view); !res) {
+      return res.error().WithContext("filling topology {}", t_path);
+    }
+    if (auto res = view->Fill(0, view->size(), true); !res) {
+      return res.error();
+    }
+  } else if (auto res =
+                 core_->topology_file_storage().Bind(t_path.string(), true);
+             !res) {
+    return res.error();
+  }
+  uint64_t topology_end_us = loader.ElapsedUs();
+
+  // Add the properties in storage order as they arrive
+  size_t next_file = 0;
+  for (; next_file < num_node_files; ++next_file) {
+    auto load_res = loader.Get(next_file);
+    if (!load_res) {
+      return load_res.error();
+    }
+    if (auto res = core_->AddNodeProperties(load_res.value()); !res) {
+      return res.error();
+    }
+  }
+  for (; next_file < num_node_files + num_edge_files; ++next_file) {
+    auto load_res = loader.Get(next_file);
+    if (!load_res) {
+      return load_res.error();
+    }
+    if (auto res = core_->AddEdgeProperties(load_res.value()); !res) {
+      return res.error();
+    }
   }
 
-  const std::vector<PropStorageInfo>& part_prop_info_list =
-      core_->part_header().part_prop_info_list();
   if (!part_prop_info_list.empty()) {
-    auto part_result = AddProperties(
-        metadata_dir, part_prop_info_list,
-        [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-          return rdg->AddPartitionMetadataArray(props);
-        });
-    if (!part_result) {
-      return part_result.error();
+    for (; next_file < num_files; ++next_file) {
+      auto load_res = loader.Get(next_file);
+      if (!load_res) {
+        return load_res.error();
+      }
+      if (auto res = AddPartitionMetadataArray(load_res.value()); !res) {
+        return res.error();
+      }
     }
 
     if (local_to_user_id_->length() == 0) {
       // for backward compatibility
       // NB: this is a zero-copy slice, so the underlying data is shared
       set_local_to_user_id(local_to_global_id_->Slice(0));
-    } else if (local_to_user_id_->length() != local_to_global_id_->length()) {
+    } else if (
+        // Unpartitioned graphs may have user ids (e.g., the original ids of
+        // reordered nodes) without global ids
+        local_to_global_id_->length() != 0 &&
+        local_to_user_id_->length() != local_to_global_id_->length()) {
       KATANA_LOG_DEBUG(
           "Number of User Node IDs {} do not match number of Global Node "
           "IDs "
@@ -397,6 +768,9 @@ tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
           local_to_user_id_->length(), local_to_global_id_->length());
       return tsuba::ErrorCode::InvalidArgument;
     }
+    // The backward compatible user ids are derived again on every load, so
+    // they need not be stored
+    part_arrays_dirty_ = false;
 
     KATANA_LOG_DEBUG(
         "ReadPartMetadata master sz: {} mirrors sz: {} h2owned sz: {} l2u sz: "
@@ -409,16 +783,253 @@ tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
         local_to_global_id_ == nullptr ? 0 : local_to_global_id_->length());
   }
 
-  katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-  if (auto res = core_->topology_file_storage().Bind(t_path.string(), true);
-      !res) {
-    return res.error();
-  }
+  std::vector<FileLoadTime> timeline = loader.Timeline();
+  timeline.emplace_back(FileLoadTime{
+      t_path.BaseName(), topology_start_us, topology_end_us});
+  core_->set_load_timeline(std::move(timeline));
 
   rdg_dir_ = metadata_dir;
   return katana::ResultSuccess();
 }
 
+std::shared_ptr<const tsuba::FileChecksum>
+tsuba::RDG::ChecksumToVerify(const std::string& path) const {
+  if (!verify_checksums_) {
+    return nullptr;
+  }
+  return core_->part_header().checksum(path);
+}
+
+katana::Result<void>
+tsuba::RDG::AddLazyProperties(const katana::Uri& metadata_dir, bool node) {
+  const std::vector<PropStorageInfo>& info_list =
+      node ? core_->part_header().node_prop_info_list()
+           : core_->part_header().edge_prop_info_list();
+  if (info_list.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  // All properties of a kind have the same number of rows, so one footer read
+  // is enough to size every placeholder
+  auto rows_res =
+      ParquetReader::NumRows(metadata_dir.Join(info_list.front().path));
+  if (!rows_res) {
+    return rows_res.error().WithContext("sizing deferred properties");
+  }
+  int64_t num_rows = rows_res.value();
+
+  LazyPropertySet& set = node ? lazy_->node : lazy_->edge;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (const PropStorageInfo& info : info_list) {
+    fields.emplace_back(arrow::field(info.name, arrow::null()));
+    columns.emplace_back(std::make_shared<arrow::NullArray>(num_rows));
+    set.unloaded.insert(info.name);
+  }
+
+  auto table = arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+  if (node) {
+    return core_->AddNodeProperties(table);
+  }
+  return core_->AddEdgeProperties(table);
+}
+
+katana::Result<void>
+tsuba::RDG::LoadAllLazyProperties() {
+  if (!lazy_) {
+    return katana::ResultSuccess();
+  }
+  for (uint32_t i = 0, n = core_->part_header().node_prop_info_list().size();
+       i < n; ++i) {
+    if (auto res = EnsureNodePropertyLoaded(i); !res) {
+      return res.error();
+    }
+  }
+  for (uint32_t i = 0, n = core_->part_header().edge_prop_info_list().size();
+       i < n; ++i) {
+    if (auto res = EnsureEdgePropertyLoaded(i); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureNodePropertyLoaded(uint32_t i) const {
+  if (!lazy_) {
+    return katana::ResultSuccess();
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+
+  const auto& info_list = core_->part_header().node_prop_info_list();
+  if (i >= info_list.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no node property at index {}", i);
+  }
+  auto load_res = LoadDeferred(
+      lazy_->dir, info_list[i], ChecksumToVerify(info_list[i].path),
+      &lazy_->node);
+  if (!load_res) {
+    return load_res.error();
+  }
+  if (!load_res.value()) {
+    return katana::ResultSuccess();
+  }
+  return core_->ReplaceNodeProperty(i, load_res.value());
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureEdgePropertyLoaded(uint32_t i) const {
+  if (!lazy_) {
+    return katana::ResultSuccess();
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+
+  const auto& info_list = core_->part_header().edge_prop_info_list();
+  if (i >= info_list.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no edge property at index {}", i);
+  }
+  auto load_res = LoadDeferred(
+      lazy_->dir, info_list[i], ChecksumToVerify(info_list[i].path),
+      &lazy_->edge);
+  if (!load_res) {
+    return load_res.error();
+  }
+  if (!load_res.value()) {
+    return katana::ResultSuccess();
+  }
+  return core_->ReplaceEdgeProperty(i, load_res.value());
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+tsuba::RDG::LoadNodeProperty(uint32_t i) const {
+  std::unique_lock<std::recursive_mutex> lock;
+  if (lazy_) {
+    lock = std::unique_lock<std::recursive_mutex>(lazy_->mutex);
+  }
+  if (auto res = EnsureNodePropertyLoaded(i); !res) {
+    return res.error();
+  }
+  if (i >= static_cast<uint32_t>(node_properties()->num_columns())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no node property at index {}", i);
+  }
+  return node_properties()->column(i);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+tsuba::RDG::LoadEdgeProperty(uint32_t i) const {
+  std::unique_lock<std::recursive_mutex> lock;
+  if (lazy_) {
+    lock = std::unique_lock<std::recursive_mutex>(lazy_->mutex);
+  }
+  if (auto res = EnsureEdgePropertyLoaded(i); !res) {
+    return res.error();
+  }
+  if (i >= static_cast<uint32_t>(edge_properties()->num_columns())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no edge property at index {}", i);
+  }
+  return edge_properties()->column(i);
+}
+
+katana::Result<void>
+tsuba::RDG::ReplaceNodeProperty(
+    uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+  if (i >= static_cast<uint32_t>(node_properties()->num_columns())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no node property at index {}", i);
+  }
+  if (!IsNodePropertyLoaded(i)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node property {} is not loaded", i);
+  }
+  return core_->ReplaceNodeProperty(i, props);
+}
+
+katana::Result<void>
+tsuba::RDG::ReplaceEdgeProperty(
+    uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+  if (i >= static_cast<uint32_t>(edge_properties()->num_columns())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no edge property at index {}", i);
+  }
+  if (!IsEdgePropertyLoaded(i)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge property {} is not loaded", i);
+  }
+  return core_->ReplaceEdgeProperty(i, props);
+}
+
+bool
+tsuba::RDG::IsNodePropertyLoaded(uint32_t i) const {
+  if (!lazy_) {
+    return true;
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+  const auto& info_list = core_->part_header().node_prop_info_list();
+  return i >= info_list.size() ||
+         lazy_->node.unloaded.count(info_list[i].name) == 0;
+}
+
+bool
+tsuba::RDG::IsEdgePropertyLoaded(uint32_t i) const {
+  if (!lazy_) {
+    return true;
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+  const auto& info_list = core_->part_header().edge_prop_info_list();
+  return i >= info_list.size() ||
+         lazy_->edge.unloaded.count(info_list[i].name) == 0;
+}
+
+const tsuba::PropertyStats*
+tsuba::RDG::NodePropertyStats(uint32_t i) const {
+  const auto& info_list = core_->part_header().node_prop_info_list();
+  if (i >= info_list.size() || !info_list[i].stats) {
+    return nullptr;
+  }
+  return &info_list[i].stats.value();
+}
+
+const tsuba::PropertyStats*
+tsuba::RDG::EdgePropertyStats(uint32_t i) const {
+  const auto& info_list = core_->part_header().edge_prop_info_list();
+  if (i >= info_list.size() || !info_list[i].stats) {
+    return nullptr;
+  }
+  return &info_list[i].stats.value();
+}
+
+void
+tsuba::RDG::PrefetchNodeProperty(uint32_t i) const {
+  if (!lazy_) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+  const auto& info_list = core_->part_header().node_prop_info_list();
+  if (i < info_list.size()) {
+    PrefetchDeferred(
+        lazy_->dir, info_list[i], ChecksumToVerify(info_list[i].path),
+        &lazy_->node);
+  }
+}
+
+void
+tsuba::RDG::PrefetchEdgeProperty(uint32_t i) const {
+  if (!lazy_) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+  const auto& info_list = core_->part_header().edge_prop_info_list();
+  if (i < info_list.size()) {
+    PrefetchDeferred(
+        lazy_->dir, info_list[i], ChecksumToVerify(info_list[i].path),
+        &lazy_->edge);
+  }
+}
+
 katana::Result<tsuba::RDG>
 tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
   uint32_t partition_id_to_load =
@@ -439,7 +1050,7 @@ tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
     return res.error();
   }
 
-  if (auto res = rdg.DoMake(meta.dir()); !res) {
+  if (auto res = rdg.DoMake(meta.dir(), opts); !res) {
     return res.error();
   }
 
@@ -448,6 +1059,52 @@ tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
   return RDG(std::move(rdg));
 }
 
+katana::Result<tsuba::RDG>
+tsuba::RDG::Copy(
+    const std::vector<std::string>& node_props,
+    const std::vector<std::string>& edge_props) const {
+  RDGPartHeader part_header = core_->part_header();
+  if (auto res = part_header.PrunePropsTo(&node_props, &edge_props); !res) {
+    return res.error();
+  }
+  RDG copy(std::make_unique<RDGCore>(std::move(part_header)));
+  copy.core_->ShareTopologyFileStorage(*core_);
+
+  auto node_res = ShareColumns(
+      node_properties(), node_props,
+      [this](uint32_t i) { return EnsureNodePropertyLoaded(i); },
+      [this](uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+        return core_->ReplaceNodeProperty(i, props);
+      });
+  if (!node_res) {
+    return node_res.error().WithContext("copying node properties");
+  }
+  auto edge_res = ShareColumns(
+      edge_properties(), edge_props,
+      [this](uint32_t i) { return EnsureEdgePropertyLoaded(i); },
+      [this](uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+        return core_->ReplaceEdgeProperty(i, props);
+      });
+  if (!edge_res) {
+    return edge_res.error().WithContext("copying edge properties");
+  }
+  copy.core_->set_node_properties(std::move(node_res.value()));
+  copy.core_->set_edge_properties(std::move(edge_res.value()));
+
+  copy.mirror_nodes_ = mirror_nodes_;
+  copy.master_nodes_ = master_nodes_;
+  copy.host_to_owned_global_ids_ = host_to_owned_global_ids_;
+  copy.local_to_user_id_ = local_to_user_id_;
+  copy.local_to_global_id_ = local_to_global_id_;
+  copy.part_arrays_dirty_ = part_arrays_dirty_;
+  copy.verify_checksums_ = verify_checksums_;
+  copy.rdg_dir_ = rdg_dir_;
+  copy.partition_id_ = partition_id_;
+  copy.lineage_ = lineage_;
+
+  return RDG(std::move(copy));
+}
+
 katana::Result<void>
 tsuba::RDG::Validate() const {
   if (auto res = core_->part_header().Validate(); !res) {
@@ -487,7 +1144,17 @@ tsuba::RDG::Store(
       handle.impl_->rdg_meta().policy_id(), tsuba::Comm()->Num,
       core_->part_header().metadata().policy_id_);
   if (handle.impl_->rdg_meta().dir() != rdg_dir_) {
+    // Properties are about to be rewritten from memory, so deferred ones
+    // must be read first
+    if (auto res = LoadAllLazyProperties(); !res) {
+      return res.error();
+    }
     core_->part_header().UnbindFromStorage();
+    if (lazy_) {
+      // Properties evicted from now on are read from where they are stored
+      std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+      lazy_->dir = handle.impl_->rdg_meta().dir();
+    }
   }
 
   auto desc_res = WriteGroup::Make();
@@ -512,16 +1179,66 @@ tsuba::RDG::Store(
 
 katana::Result<void>
 tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
-  if (auto res = core_->AddNodeProperties(props); !res) {
-    return res.error();
+  return UpdateNodeProperties(PropertyUpdate{.added = props});
+}
+
+katana::Result<void>
+tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
+  return UpdateEdgeProperties(PropertyUpdate{.added = props});
+}
+
+katana::Result<void>
+tsuba::RDG::RemoveNodeProperty(uint32_t i) {
+  if (lazy_) {
+    std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+    const auto& info_list = core_->part_header().node_prop_info_list();
+    if (i < info_list.size()) {
+      lazy_->node.unloaded.erase(info_list[i].name);
+      lazy_->node.pending.erase(info_list[i].name);
+    }
+  }
+  return core_->RemoveNodeProperty(i);
+}
+
+katana::Result<void>
+tsuba::RDG::RemoveEdgeProperty(uint32_t i) {
+  if (lazy_) {
+    std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+    const auto& info_list = core_->part_header().edge_prop_info_list();
+    if (i < info_list.size()) {
+      lazy_->edge.unloaded.erase(info_list[i].name);
+      lazy_->edge.pending.erase(info_list[i].name);
+    }
   }
+  return core_->RemoveEdgeProperty(i);
+}
 
-  const auto& schema = props->schema();
-  for (int i = 0, end = props->num_columns(); i < end; ++i) {
-    core_->part_header().AppendNodePropStorageInfo(tsuba::PropStorageInfo{
-        .name = schema->field(i)->name(),
-        .path = "",
-    });
+katana::Result<void>
+tsuba::RDG::UpdateNodeProperties(const PropertyUpdate& update) {
+  // Removed and replaced properties must not be loaded from storage later
+  std::vector<std::string> dropped;
+  if (lazy_) {
+    const auto& info_list = core_->part_header().node_prop_info_list();
+    for (uint32_t i : update.removed) {
+      if (i < info_list.size()) {
+        dropped.emplace_back(info_list[i].name);
+      }
+    }
+    for (const auto& replaced : update.replaced) {
+      if (replaced.first < info_list.size()) {
+        dropped.emplace_back(info_list[replaced.first].name);
+      }
+    }
+  }
+  if (auto res = core_->UpdateNodeProperties(update); !res) {
+    return res.error();
+  }
+  if (lazy_) {
+    std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+    for (const auto& name : dropped) {
+      lazy_->node.unloaded.erase(name);
+      lazy_->node.pending.erase(name);
+    }
   }
 
   KATANA_LOG_DEBUG_ASSERT(
@@ -532,17 +1249,30 @@ tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
 }
 
 katana::Result<void>
-tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
-  if (auto res = core_->AddEdgeProperties(props); !res) {
+tsuba::RDG::UpdateEdgeProperties(const PropertyUpdate& update) {
+  std::vector<std::string> dropped;
+  if (lazy_) {
+    const auto& info_list = core_->part_header().edge_prop_info_list();
+    for (uint32_t i : update.removed) {
+      if (i < info_list.size()) {
+        dropped.emplace_back(info_list[i].name);
+      }
+    }
+    for (const auto& replaced : update.replaced) {
+      if (replaced.first < info_list.size()) {
+        dropped.emplace_back(info_list[replaced.first].name);
+      }
+    }
+  }
+  if (auto res = core_->UpdateEdgeProperties(update); !res) {
     return res.error();
   }
-
-  const auto& schema = props->schema();
-  for (int i = 0, end = props->num_columns(); i < end; ++i) {
-    core_->part_header().AppendEdgePropStorageInfo(tsuba::PropStorageInfo{
-        .name = schema->field(i)->name(),
-        .path = "",
-    });
+  if (lazy_) {
+    std::lock_guard<std::recursive_mutex> lock(lazy_->mutex);
+    for (const auto& name : dropped) {
+      lazy_->edge.unloaded.erase(name);
+      lazy_->edge.pending.erase(name);
+    }
   }
 
   KATANA_LOG_DEBUG_ASSERT(
@@ -552,16 +1282,6 @@ tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
-tsuba::RDG::RemoveNodeProperty(uint32_t i) {
-  return core_->RemoveNodeProperty(i);
-}
-
-katana::Result<void>
-tsuba::RDG::RemoveEdgeProperty(uint32_t i) {
-  return core_->RemoveEdgeProperty(i);
-}
-
 void
 tsuba::RDG::MarkAllPropertiesPersistent() {
   core_->part_header().MarkAllPropertiesPersistent();
@@ -579,6 +1299,33 @@ tsuba::RDG::MarkEdgePropertiesPersistent(
   return core_->part_header().MarkEdgePropertiesPersistent(persist_edge_props);
 }
 
+katana::Result<void>
+tsuba::RDG::SetNodePropertyFileFormat(uint32_t i, PropertyFileFormat format) {
+  if (i >= core_->part_header().node_prop_info_list().size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no node property at index {}", i);
+  }
+  // Rewriting the property needs its column
+  if (auto res = EnsureNodePropertyLoaded(i); !res) {
+    return res.error();
+  }
+  core_->part_header().SetNodePropertyFileFormat(i, format);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::SetEdgePropertyFileFormat(uint32_t i, PropertyFileFormat format) {
+  if (i >= core_->part_header().edge_prop_info_list().size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no edge property at index {}", i);
+  }
+  if (auto res = EnsureEdgePropertyLoaded(i); !res) {
+    return res.error();
+  }
+  core_->part_header().SetEdgePropertyFileFormat(i, format);
+  return katana::ResultSuccess();
+}
+
 const tsuba::PartitionMetadata&
 tsuba::RDG::part_metadata() const {
   return core_->part_header().metadata();
@@ -604,9 +1351,52 @@ tsuba::RDG::topology_file_storage() const {
   return core_->topology_file_storage();
 }
 
+const std::vector<tsuba::FileLoadTime>&
+tsuba::RDG::load_timeline() const {
+  return core_->load_timeline();
+}
+
 katana::Result<void>
 tsuba::RDG::UnbindTopologyFileStorage() {
-  return core_->topology_file_storage().Unbind();
+  aux_->pending.clear();
+  aux_->loaded.clear();
+  core_->part_header().ClearAuxTopologies();
+  return core_->UnbindTopologyFileStorage();
+}
+
+void
+tsuba::RDG::AddAuxTopology(
+    const std::string& name, std::unique_ptr<FileFrame> ff) {
+  aux_->pending[name] = std::move(ff);
+}
+
+bool
+tsuba::RDG::HasAuxTopology(const std::string& name) const {
+  return core_->part_header().FindAuxTopology(name) != nullptr;
+}
+
+katana::Result<const tsuba::FileView*>
+tsuba::RDG::LoadAuxTopology(const std::string& name) const {
+  const AuxTopologyInfo* info = core_->part_header().FindAuxTopology(name);
+  if (!info) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no auxiliary topology {} in {}", name,
+        rdg_dir_);
+  }
+
+  std::lock_guard<std::mutex> lock(aux_->mutex);
+  std::unique_ptr<FileView>& view = aux_->loaded[name];
+  if (!view) {
+    auto new_view = std::make_unique<FileView>();
+    new_view->ExpectChecksum(ChecksumToVerify(info->path));
+    katana::Uri path = rdg_dir_.Join(info->path);
+    if (auto res = new_view->BindReadOnly(path.string(), false); !res) {
+      aux_->loaded.erase(name);
+      return res.error().WithContext("loading auxiliary topology {}", name);
+    }
+    view = std::move(new_view);
+  }
+  return view.get();
 }
 
 katana::Result<void>
@@ -628,12 +1418,20 @@ tsuba::RDG::InitArrowVectors() {
   local_to_global_id_ = katana::EmptyChunkedArray(arrow::uint64(), 0);
 }
 
-tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {
+tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core)
+    : core_(std::move(core)), aux_(std::make_unique<AuxTopologies>()) {
   InitArrowVectors();
 }
 
-tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) { InitArrowVectors(); }
+tsuba::RDG::RDG()
+    : core_(std::make_unique<RDGCore>()),
+      aux_(std::make_unique<AuxTopologies>()) {
+  InitArrowVectors();
+}
 
-tsuba::RDG::~RDG() = default;
+tsuba::RDG::~RDG() {
+  // Unregister the reclaimer of lazy_ before core_ goes away
+  lazy_.reset();
+}
 tsuba::RDG::RDG(tsuba::RDG&& other) noexcept = default;
 tsuba::RDG& tsuba::RDG::operator=(tsuba::RDG&& other) noexcept = default;
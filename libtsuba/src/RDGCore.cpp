@@ -1,48 +1,152 @@
 #include "RDGCore.h"
 
 #include "RDGPartHeader.h"
+#include "katana/Logging.h"
 #include "tsuba/Errors.h"
 
 namespace {
 
+/// UpdateProperties applies update to the table at to_update and, if
+/// info_list is not null, to the storage info of its properties. The new
+/// table is built once from the columns of the old one, so the cost does not
+/// grow with the number of changes in update beyond their own.
+katana::Result<void>
+UpdateProperties(
+    const tsuba::PropertyUpdate& update,
+    std::shared_ptr<arrow::Table>* to_update,
+    std::vector<tsuba::PropStorageInfo>* info_list) {
+  const std::shared_ptr<arrow::Table>& current = *to_update;
+  int num_columns = current->num_columns();
+  KATANA_LOG_DEBUG_ASSERT(
+      !info_list || info_list->size() == static_cast<size_t>(num_columns));
+
+  std::vector<bool> removed(num_columns, false);
+  for (uint32_t i : update.removed) {
+    if (i >= static_cast<uint32_t>(num_columns) || removed[i]) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "cannot remove property {} of {}", i, num_columns);
+    }
+    removed[i] = true;
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns =
+      current->columns();
+  std::vector<bool> replaced(num_columns, false);
+  for (const auto& [i, values] : update.replaced) {
+    if (i >= static_cast<uint32_t>(num_columns) || removed[i] || replaced[i]) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "cannot replace property {} of {}", i, num_columns);
+    }
+    if (!values->type()->Equals(current->schema()->field(i)->type())) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "property {} has type {} not {}", current->schema()->field(i)->name(),
+          current->schema()->field(i)->type()->ToString(),
+          values->type()->ToString());
+    }
+    if (values->length() != current->num_rows()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "expected {} rows found {} instead", current->num_rows(),
+          values->length());
+    }
+    replaced[i] = true;
+    columns[i] = values;
+  }
+
+  int64_t num_rows = current->num_rows();
+  const std::shared_ptr<arrow::Table>& added = update.added;
+  if (added && added->num_columns() > 0) {
+    if (num_columns > 0 && num_rows != added->num_rows()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "expected {} rows found {} instead", num_rows, added->num_rows());
+    }
+    if (num_columns == 0 && num_rows == 0) {
+      num_rows = added->num_rows();
+    }
+  }
+
+  arrow::FieldVector next_fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> next_columns;
+  std::vector<tsuba::PropStorageInfo> next_info;
+  for (int i = 0; i < num_columns; ++i) {
+    if (removed[i]) {
+      continue;
+    }
+    next_fields.emplace_back(current->schema()->field(i));
+    next_columns.emplace_back(std::move(columns[i]));
+    if (info_list) {
+      tsuba::PropStorageInfo info = (*info_list)[i];
+      if (replaced[i]) {
+        // The stored file has the old values
+        info.path = "";
+        info.stats.reset();
+      }
+      next_info.emplace_back(std::move(info));
+    }
+  }
+  if (added) {
+    for (int i = 0, n = added->num_columns(); i < n; ++i) {
+      next_fields.emplace_back(added->schema()->field(i));
+      next_columns.emplace_back(added->column(i));
+      if (info_list) {
+        next_info.emplace_back(tsuba::PropStorageInfo{
+            .name = added->schema()->field(i)->name(),
+            .path = "",
+        });
+      }
+    }
+  }
+
+  auto next_schema = arrow::schema(next_fields);
+  if (!next_schema->HasDistinctFieldNames()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::Exists, "column names are not distinct");
+  }
+
+  *to_update = arrow::Table::Make(next_schema, next_columns, num_rows);
+  if (info_list) {
+    *info_list = std::move(next_info);
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 AddProperties(
     const std::shared_ptr<arrow::Table>& props,
     std::shared_ptr<arrow::Table>* to_update) {
+  return UpdateProperties(
+      tsuba::PropertyUpdate{.added = props}, to_update, nullptr);
+}
+
+katana::Result<void>
+ReplaceProperty(
+    uint32_t i, const std::shared_ptr<arrow::Table>& props,
+    std::shared_ptr<arrow::Table>* to_update) {
   std::shared_ptr<arrow::Table> current = *to_update;
 
-  if (current->num_columns() > 0 && current->num_rows() != props->num_rows()) {
+  if (props->num_columns() != 1) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument, "expected 1 column found {}",
+        props->num_columns());
+  }
+  if (current->num_rows() != props->num_rows()) {
     return KATANA_ERROR(
         tsuba::ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         current->num_rows(), props->num_rows());
   }
 
-  std::shared_ptr<arrow::Table> next = current;
-
-  if (current->num_columns() == 0 && current->num_rows() == 0) {
-    next = props;
-  } else {
-    const auto& schema = props->schema();
-    int last = current->num_columns();
-
-    for (int i = 0, n = schema->num_fields(); i < n; i++) {
-      auto result =
-          next->AddColumn(last + i, schema->field(i), props->column(i));
-      if (!result.ok()) {
-        return KATANA_ERROR(
-            tsuba::ErrorCode::ArrowError, "arrow error: {}", result.status());
-      }
-
-      next = result.ValueOrDie();
-    }
-  }
-
-  if (!next->schema()->HasDistinctFieldNames()) {
+  auto result = current->SetColumn(i, props->field(0), props->column(0));
+  if (!result.ok()) {
     return KATANA_ERROR(
-        tsuba::ErrorCode::Exists, "column names are not distinct");
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", result.status());
   }
 
-  *to_update = next;
+  *to_update = result.ValueOrDie();
 
   return katana::ResultSuccess();
 }
@@ -61,6 +165,40 @@ RDGCore::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
   return AddProperties(props, &edge_properties_);
 }
 
+katana::Result<void>
+RDGCore::ReplaceNodeProperty(
+    uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+  return ReplaceProperty(i, props, &node_properties_);
+}
+
+katana::Result<void>
+RDGCore::ReplaceEdgeProperty(
+    uint32_t i, const std::shared_ptr<arrow::Table>& props) {
+  return ReplaceProperty(i, props, &edge_properties_);
+}
+
+katana::Result<void>
+RDGCore::UpdateNodeProperties(const PropertyUpdate& update) {
+  std::vector<PropStorageInfo> info_list = part_header_.node_prop_info_list();
+  if (auto res = UpdateProperties(update, &node_properties_, &info_list);
+      !res) {
+    return res.error();
+  }
+  part_header_.set_node_prop_info_list(std::move(info_list));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+RDGCore::UpdateEdgeProperties(const PropertyUpdate& update) {
+  std::vector<PropStorageInfo> info_list = part_header_.edge_prop_info_list();
+  if (auto res = UpdateProperties(update, &edge_properties_, &info_list);
+      !res) {
+    return res.error();
+  }
+  part_header_.set_edge_prop_info_list(std::move(info_list));
+  return katana::ResultSuccess();
+}
+
 void
 RDGCore::InitEmptyProperties() {
   std::vector<std::shared_ptr<arrow::Array>> empty;
@@ -71,11 +209,12 @@ RDGCore::InitEmptyProperties() {
 bool
 RDGCore::Equals(const RDGCore& other) const {
   // Assumption: t_f_s and other.t_f_s are both fully loaded into memory
-  return topology_file_storage_.size() == other.topology_file_storage_.size() &&
+  const FileView& topology = *topology_file_storage_;
+  const FileView& other_topology = *other.topology_file_storage_;
+  return topology.size() == other_topology.size() &&
          !memcmp(
-             topology_file_storage_.ptr<uint8_t>(),
-             other.topology_file_storage_.ptr<uint8_t>(),
-             topology_file_storage_.size()) &&
+             topology.ptr<uint8_t>(), other_topology.ptr<uint8_t>(),
+             topology.size()) &&
          node_properties_->Equals(*other.node_properties_, true) &&
          edge_properties_->Equals(*other.edge_properties_, true);
 }
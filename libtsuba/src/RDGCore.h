@@ -2,12 +2,15 @@
 #define KATANA_LIBTSUBA_RDGCORE_H_
 
 #include <memory>
+#include <vector>
 
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
+#include "tsuba/RDG.h"
+#include "tsuba/file.h"
 
 namespace tsuba {
 
@@ -31,6 +34,20 @@ public:
 
   katana::Result<void> RemoveEdgeProperty(uint32_t i);
 
+  /// Apply \param update to the node properties and their storage info with
+  /// one rebuild of the property table
+  katana::Result<void> UpdateNodeProperties(const PropertyUpdate& update);
+
+  katana::Result<void> UpdateEdgeProperties(const PropertyUpdate& update);
+
+  /// Replace the column of node property \param i with the single column of
+  /// \param props, e.g., when a deferred property is finally read
+  katana::Result<void> ReplaceNodeProperty(
+      uint32_t i, const std::shared_ptr<arrow::Table>& props);
+
+  katana::Result<void> ReplaceEdgeProperty(
+      uint32_t i, const std::shared_ptr<arrow::Table>& props);
+
   //
   // Accessors and Mutators
   //
@@ -50,11 +67,28 @@ public:
   }
 
   const FileView& topology_file_storage() const {
-    return topology_file_storage_;
+    return *topology_file_storage_;
   }
-  FileView& topology_file_storage() { return topology_file_storage_; }
+  FileView& topology_file_storage() { return *topology_file_storage_; }
   void set_topology_file_storage(FileView&& topology_file_storage) {
-    topology_file_storage_ = std::move(topology_file_storage);
+    topology_file_storage_ =
+        std::make_shared<FileView>(std::move(topology_file_storage));
+  }
+
+  /// Share the topology file storage of \param other, e.g., in a copy of its
+  /// RDG, instead of mapping the file again
+  void ShareTopologyFileStorage(const RDGCore& other) {
+    topology_file_storage_ = other.topology_file_storage_;
+  }
+
+  /// Unbind the topology file storage. Storage shared with another core is
+  /// left bound for that core.
+  katana::Result<void> UnbindTopologyFileStorage() {
+    if (topology_file_storage_.use_count() > 1) {
+      topology_file_storage_ = std::make_shared<FileView>();
+      return katana::ResultSuccess();
+    }
+    return topology_file_storage_->Unbind();
   }
 
   const RDGPartHeader& part_header() const { return part_header_; }
@@ -63,9 +97,17 @@ public:
     part_header_ = std::move(part_header);
   }
 
+  /// When each file was read by the load that made this core
+  const std::vector<FileLoadTime>& load_timeline() const {
+    return load_timeline_;
+  }
+  void set_load_timeline(std::vector<FileLoadTime>&& load_timeline) {
+    load_timeline_ = std::move(load_timeline);
+  }
+
   katana::Result<void> RegisterTopologyFile(const std::string& new_top) {
     part_header_.set_topology_path(new_top);
-    return topology_file_storage_.Unbind();
+    return UnbindTopologyFileStorage();
   }
 
 private:
@@ -78,9 +120,13 @@ private:
   std::shared_ptr<arrow::Table> node_properties_;
   std::shared_ptr<arrow::Table> edge_properties_;
 
-  FileView topology_file_storage_;
+  // Shared with copies of the RDG; see RDG::Copy
+  std::shared_ptr<FileView> topology_file_storage_{
+      std::make_shared<FileView>()};
 
   RDGPartHeader part_header_;
+
+  std::vector<FileLoadTime> load_timeline_;
 };
 
 }  // namespace tsuba
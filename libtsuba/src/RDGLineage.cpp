@@ -15,9 +15,20 @@ RDGLineage::AddCommandLine(const std::string& cmd) {
   command_line_ = cmd;
 }
 
+void
+RDGLineage::AddProvenance(const std::string& key, const std::string& value) {
+  provenance_[key] = value;
+}
+
+void
+RDGLineage::ClearProvenance() {
+  provenance_.clear();
+}
+
 void
 RDGLineage::ClearLineage() {
   command_line_.clear();
+  provenance_.clear();
 }
 
 }  // namespace tsuba
@@ -25,9 +36,15 @@ RDGLineage::ClearLineage() {
 void
 tsuba::to_json(json& j, const tsuba::RDGLineage& lineage) {
   j = json{{"command_line", lineage.command_line_}};
+  if (!lineage.provenance_.empty()) {
+    j["provenance"] = lineage.provenance_;
+  }
 }
 
 void
 tsuba::from_json(const json& j, tsuba::RDGLineage& lineage) {
   j.at("command_line").get_to(lineage.command_line_);
+  if (auto it = j.find("provenance"); it != j.end()) {
+    it->get_to(lineage.provenance_);
+  }
 }
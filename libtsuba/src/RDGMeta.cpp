@@ -127,13 +127,18 @@ Result<std::set<std::string>>
 RDGMeta::FileNames() {
   std::set<std::string> fnames{};
   fnames.emplace(FileName().BaseName());
+  std::vector<katana::Uri> partition_paths;
+  for (auto i = 0U; i < num_hosts(); ++i) {
+    partition_paths.emplace_back(PartitionFileName(dir(), i, version()));
+  }
+  std::vector<Result<RDGPartHeader>> headers =
+      RDGPartHeader::MakeAll(partition_paths);
   for (auto i = 0U; i < num_hosts(); ++i) {
     // All other file names are directory-local, so we pass an empty
     // directory instead of handle.impl_->rdg_meta.path for the partition files
     fnames.emplace(PartitionFileName(i, version()));
 
-    auto header_res =
-        RDGPartHeader::Make(PartitionFileName(dir(), i, version()));
+    auto& header_res = headers[i];
 
     if (!header_res) {
       KATANA_LOG_DEBUG(
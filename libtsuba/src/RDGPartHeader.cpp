@@ -1,8 +1,16 @@
 #include "RDGPartHeader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+
 #include "Constants.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -27,6 +35,8 @@ const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
+const char* kAuxTopologyKey = "kg.v1.aux_topology";
+const char* kChecksumsKey = "kg.v1.checksums";
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
 //constexpr std::string_view  master_nodes_prop_name = "master_nodes";
@@ -58,6 +68,7 @@ MakeProperties(std::vector<std::string>&& values) {
     prop_info_list.emplace_back(tsuba::PropStorageInfo{
         .name = name,
         .path = path,
+        .persist = true,
     });
   }
 
@@ -66,6 +77,87 @@ MakeProperties(std::vector<std::string>&& values) {
   return prop_info_list;
 }
 
+void
+SetFileFormat(tsuba::PropStorageInfo* info, tsuba::PropertyFileFormat format) {
+  info->format = format;
+  if (!info->path.empty() &&
+      tsuba::PropertyFileFormatOf(info->path) != format) {
+    info->path = "";
+    info->stats.reset();
+  }
+}
+
+/// The largest number of headers MakeAll fetches at once
+constexpr size_t kMaxConcurrentHeaderFetches = 16;
+
+/// Least recently used cache of parsed headers by partition file URI
+class HeaderCache {
+public:
+  static HeaderCache& Get() {
+    static HeaderCache cache;
+    return cache;
+  }
+
+  std::optional<tsuba::RDGPartHeader> Find(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(path);
+    if (it == index_.end()) {
+      return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  void Insert(const std::string& path, const tsuba::RDGPartHeader& header) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.find(path) != index_.end()) {
+      return;
+    }
+    entries_.emplace_front(path, header);
+    index_.emplace(path, entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  void Evict(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(path); it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+  /// Forget the headers whose paths start with prefix
+  void EvictPrefix(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->first.compare(0, prefix.size(), prefix) == 0) {
+        index_.erase(it->first);
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+private:
+  HeaderCache() {
+    int capacity = 0;
+    if (katana::GetEnv("KATANA_RDG_HEADER_CACHE", &capacity)) {
+      capacity_ = std::max(capacity, 0);
+    }
+  }
+
+  using Entry = std::pair<std::string, tsuba::RDGPartHeader>;
+
+  std::mutex mutex_;
+  size_t capacity_{256};
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
 }  // namespace
 
 namespace tsuba {
@@ -189,20 +281,65 @@ RDGPartHeader::MakeJson(const katana::Uri& partition_path) {
 
 katana::Result<RDGPartHeader>
 RDGPartHeader::Make(const katana::Uri& partition_path) {
+  HeaderCache& cache = HeaderCache::Get();
+  if (std::optional<RDGPartHeader> cached = cache.Find(partition_path.string());
+      cached) {
+    return std::move(cached.value());
+  }
+
   katana::Result<RDGPartHeader> res = MakeJson(partition_path);
-  if (res) {
-    return res;
+  if (!res) {
+    KATANA_LOG_WARN("failed to parse JSON RDGPartHeader: {}", res.error());
+    KATANA_LOG_WARN("falling back on Parquet (deprecated)");
+
+    try {
+      res = MakeParquet(partition_path);
+    } catch (const std::exception& exp) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+    }
+    if (!res) {
+      return res.error();
+    }
   }
 
-  KATANA_LOG_WARN("failed to parse JSON RDGPartHeader: {}", res.error());
-  KATANA_LOG_WARN("falling back on Parquet (deprecated)");
+  cache.Insert(partition_path.string(), res.value());
+  return res;
+}
 
-  try {
-    return MakeParquet(partition_path);
-  } catch (const std::exception& exp) {
-    return KATANA_ERROR(
-        ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+std::vector<katana::Result<RDGPartHeader>>
+RDGPartHeader::MakeAll(const std::vector<katana::Uri>& partition_paths) {
+  std::vector<std::optional<katana::Result<RDGPartHeader>>> results(
+      partition_paths.size());
+  std::atomic<size_t> next{0};
+  auto fetch = [&]() {
+    for (size_t i = next++; i < partition_paths.size(); i = next++) {
+      results[i] = Make(partition_paths[i]);
+    }
+  };
+
+  std::vector<std::future<void>> workers;
+  size_t num_workers =
+      std::min(partition_paths.size(), kMaxConcurrentHeaderFetches);
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, fetch));
+  }
+  fetch();
+  for (auto& worker : workers) {
+    worker.get();
   }
+
+  std::vector<katana::Result<RDGPartHeader>> headers;
+  headers.reserve(results.size());
+  for (auto& result : results) {
+    headers.emplace_back(std::move(result.value()));
+  }
+  return headers;
+}
+
+void
+RDGPartHeader::EvictCached(const katana::Uri& dir) {
+  HeaderCache::Get().EvictPrefix(dir.StripSep().string() + "/");
 }
 
 katana::Result<void>
@@ -226,10 +363,13 @@ RDGPartHeader::Write(RDGHandle handle, WriteGroup* writes) const {
     return KATANA_ERROR(ArrowToTsuba(res.code()), "arrow error: {}", res);
   }
 
-  ff->Bind(RDGMeta::PartitionFileName(
-               handle.impl_->rdg_meta().dir(), Comm()->ID,
-               handle.impl_->rdg_meta().version() + 1)
-               .string());
+  std::string path = RDGMeta::PartitionFileName(
+                         handle.impl_->rdg_meta().dir(), Comm()->ID,
+                         handle.impl_->rdg_meta().version() + 1)
+                         .string();
+  // A failed store may leave a file of the same version to be written again
+  HeaderCache::Get().Evict(path);
+  ff->Bind(path);
 
   writes->StartStore(std::move(ff));
   TSUBA_PTP(internal::FaultSensitivity::Normal);
@@ -306,9 +446,53 @@ RDGPartHeader::Validate() const {
         ErrorCode::InvalidArgument,
         "topology_path doesn't contain a slash (/): {}", topology_path_);
   }
+  for (const auto& info : aux_topology_info_list_) {
+    if (info.path.find('/') != std::string::npos) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "aux_topology path doesn't contain a slash (/): {}", info.path);
+    }
+  }
   return katana::ResultSuccess();
 }
 
+void
+RDGPartHeader::AddAuxTopology(AuxTopologyInfo&& info) {
+  auto& p = aux_topology_info_list_;
+  auto same_name = [&](const AuxTopologyInfo& other) {
+    return other.name == info.name;
+  };
+  p.erase(std::remove_if(p.begin(), p.end(), same_name), p.end());
+  p.emplace_back(std::move(info));
+}
+
+const AuxTopologyInfo*
+RDGPartHeader::FindAuxTopology(const std::string& name) const {
+  for (const auto& info : aux_topology_info_list_) {
+    if (info.name == name && info.base_topology_path == topology_path_) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const FileChecksum>
+RDGPartHeader::checksum(const std::string& path) const {
+  if (auto it = checksums_.find(path); it != checksums_.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+void
+RDGPartHeader::AddChecksums(
+    std::unordered_map<std::string, FileChecksum>&& checksums) {
+  for (auto& [file, checksum] : checksums) {
+    checksums_[file.substr(file.rfind('/') + 1)] =
+        std::make_shared<const FileChecksum>(std::move(checksum));
+  }
+}
+
 void
 RDGPartHeader::MarkAllPropertiesPersistent() {
   std::for_each(
@@ -331,10 +515,15 @@ RDGPartHeader::MarkNodePropertiesPersistent(
   }
   for (uint32_t i = 0; i < persist_node_props.size(); ++i) {
     if (!persist_node_props[i].empty()) {
-      node_prop_info_list_[i].name = persist_node_props[i];
-      node_prop_info_list_[i].path = "";
-      node_prop_info_list_[i].persist = true;
-      KATANA_LOG_DEBUG("node persist {}", node_prop_info_list_[i].name);
+      PropStorageInfo& info = node_prop_info_list_[i];
+      // The stored file names the column, so a renamed property is rewritten
+      if (info.name != persist_node_props[i]) {
+        info.name = persist_node_props[i];
+        info.path = "";
+        info.stats.reset();
+      }
+      info.persist = true;
+      KATANA_LOG_DEBUG("node persist {}", info.name);
     }
   }
   return katana::ResultSuccess();
@@ -351,15 +540,34 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
   }
   for (uint32_t i = 0; i < persist_edge_props.size(); ++i) {
     if (!persist_edge_props[i].empty()) {
-      edge_prop_info_list_[i].name = persist_edge_props[i];
-      edge_prop_info_list_[i].path = "";
-      edge_prop_info_list_[i].persist = true;
-      KATANA_LOG_DEBUG("edge persist {}", edge_prop_info_list_[i].name);
+      PropStorageInfo& info = edge_prop_info_list_[i];
+      // The stored file names the column, so a renamed property is rewritten
+      if (info.name != persist_edge_props[i]) {
+        info.name = persist_edge_props[i];
+        info.path = "";
+        info.stats.reset();
+      }
+      info.persist = true;
+      KATANA_LOG_DEBUG("edge persist {}", info.name);
     }
   }
   return katana::ResultSuccess();
 }
 
+void
+RDGPartHeader::SetNodePropertyFileFormat(
+    uint32_t i, PropertyFileFormat format) {
+  KATANA_LOG_DEBUG_ASSERT(i < node_prop_info_list_.size());
+  SetFileFormat(&node_prop_info_list_[i], format);
+}
+
+void
+RDGPartHeader::SetEdgePropertyFileFormat(
+    uint32_t i, PropertyFileFormat format) {
+  KATANA_LOG_DEBUG_ASSERT(i < edge_prop_info_list_.size());
+  SetFileFormat(&edge_prop_info_list_[i], format);
+}
+
 void
 RDGPartHeader::UnbindFromStorage() {
   for (PropStorageInfo& prop : node_prop_info_list_) {
@@ -372,6 +580,9 @@ RDGPartHeader::UnbindFromStorage() {
     prop.path = "";
   }
   topology_path_ = "";
+  // Auxiliary topologies are not copied to the new location
+  aux_topology_info_list_.clear();
+  checksums_.clear();
 }
 
 }  // namespace tsuba
@@ -396,6 +607,45 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+
+  // Only auxiliary topologies of the current topology are worth keeping
+  json aux = json::array();
+  for (const auto& info : header.aux_topology_info_list_) {
+    if (info.base_topology_path == header.topology_path_) {
+      aux.push_back(info);
+    }
+  }
+  if (!aux.empty()) {
+    j[kAuxTopologyKey] = std::move(aux);
+  }
+
+  // Checksums are keyed by file so that older readers, which ignore this
+  // key, can still read the header
+  json checksums = json::object();
+  auto add_checksum = [&](const std::string& path) {
+    if (auto it = header.checksums_.find(path);
+        it != header.checksums_.end()) {
+      checksums[path] = *it->second;
+    }
+  };
+  add_checksum(header.topology_path_);
+  for (const auto* list :
+       {&header.node_prop_info_list_, &header.edge_prop_info_list_,
+        &header.part_prop_info_list_}) {
+    for (const auto& info : *list) {
+      if (info.persist) {
+        add_checksum(info.path);
+      }
+    }
+  }
+  for (const auto& info : header.aux_topology_info_list_) {
+    if (info.base_topology_path == header.topology_path_) {
+      add_checksum(info.path);
+    }
+  }
+  if (!checksums.empty()) {
+    j[kChecksumsKey] = std::move(checksums);
+  }
 }
 
 void
@@ -405,6 +655,60 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  if (auto it = j.find(kAuxTopologyKey); it != j.end()) {
+    it->get_to(header.aux_topology_info_list_);
+  }
+  if (auto it = j.find(kChecksumsKey); it != j.end()) {
+    for (const auto& [path, checksum] : it->items()) {
+      header.checksums_[path] =
+          std::make_shared<const FileChecksum>(checksum.get<FileChecksum>());
+    }
+  }
+}
+
+void
+tsuba::to_json(json& j, const tsuba::AuxTopologyInfo& info) {
+  j = json{info.name, info.path, info.base_topology_path};
+}
+
+void
+tsuba::from_json(const json& j, tsuba::AuxTopologyInfo& info) {
+  j.at(0).get_to(info.name);
+  j.at(1).get_to(info.path);
+  j.at(2).get_to(info.base_topology_path);
+}
+
+// The CRCs are stored as one string of 8 hex digits each, which is about
+// half the size of a JSON array of them
+void
+tsuba::to_json(json& j, const tsuba::FileChecksum& checksum) {
+  std::string crcs;
+  crcs.reserve(checksum.crcs.size() * 8);
+  for (uint32_t crc : checksum.crcs) {
+    crcs += fmt::format("{:08x}", crc);
+  }
+  j = json{
+      {"block_size", checksum.block_size},
+      {"size", checksum.size},
+      {"crc32c", std::move(crcs)},
+  };
+}
+
+void
+tsuba::from_json(const json& j, tsuba::FileChecksum& checksum) {
+  j.at("block_size").get_to(checksum.block_size);
+  j.at("size").get_to(checksum.size);
+  std::string crcs = j.at("crc32c").get<std::string>();
+  if (checksum.block_size == 0 ||
+      crcs.size() != (checksum.size + checksum.block_size - 1) /
+                         checksum.block_size * 8) {
+    // nlohmann::json reports errors using exceptions
+    throw std::runtime_error("checksum does not match file size");
+  }
+  checksum.crcs.clear();
+  for (size_t i = 0; i < crcs.size(); i += 8) {
+    checksum.crcs.emplace_back(std::stoul(crcs.substr(i, 8), nullptr, 16));
+  }
 }
 
 void
@@ -455,12 +759,22 @@ void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name);
   j.at(1).get_to(propmd.path);
+  // A stored property stays in later versions unless it is removed
+  propmd.persist = true;
+  propmd.format = tsuba::PropertyFileFormatOf(propmd.path);
+  // Statistics were added later; older readers ignore them
+  if (j.size() > 2) {
+    propmd.stats = j.at(2).get<tsuba::PropertyStats>();
+  }
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   if (propmd.persist) {
     j = json{propmd.name, propmd.path};
+    if (propmd.stats) {
+      j.push_back(*propmd.stats);
+    }
   }
   // creates a null value if property wasn't supposed to be persisted
 }
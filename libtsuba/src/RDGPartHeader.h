@@ -2,6 +2,8 @@
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
 #include <cassert>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/api.h>
@@ -9,7 +11,10 @@
 #include "katana/JSON.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/ArrowIpc.h"
+#include "tsuba/Checksum.h"
 #include "tsuba/PartitionMetadata.h"
+#include "tsuba/PropertyStats.h"
 #include "tsuba/WriteGroup.h"
 #include "tsuba/tsuba.h"
 
@@ -19,12 +24,43 @@ struct PropStorageInfo {
   std::string name;
   std::string path;
   bool persist{false};
+  /// Statistics of the property in the file at path; absent if it was
+  /// written by an older version
+  std::optional<PropertyStats> stats;
+  /// The format of the file at path or, if there is none yet, of the file
+  /// the property is to be written to
+  PropertyFileFormat format{PropertyFileFormat::kParquet};
+};
+
+/// A topology derived from the topology of a partition, e.g., its
+/// transpose, that is stored with it so that it need not be recomputed
+struct AuxTopologyInfo {
+  std::string name;
+  std::string path;
+  /// The topology_path of the topology it was derived from; it is stale
+  /// once the partition has another topology
+  std::string base_topology_path;
 };
 
 class KATANA_EXPORT RDGPartHeader {
 public:
+  /// Read the header in the partition file at \param partition_path.
+  ///
+  /// Partition files are named by version and not changed once written, so
+  /// parsed headers are cached by path and opening the same version again
+  /// does not fetch or parse it. The environment variable
+  /// KATANA_RDG_HEADER_CACHE sets the number of cached headers (default
+  /// 256; 0 disables the cache).
   static katana::Result<RDGPartHeader> Make(const katana::Uri& partition_path);
 
+  /// Read the headers in \param partition_paths concurrently
+  static std::vector<katana::Result<RDGPartHeader>> MakeAll(
+      const std::vector<katana::Uri>& partition_paths);
+
+  /// Drop the cached headers of the partition files in \param dir, e.g.,
+  /// because an RDG is created anew there and its versions start over
+  static void EvictCached(const katana::Uri& dir);
+
   katana::Result<void> Validate() const;
 
   katana::Result<void> PrunePropsTo(
@@ -59,6 +95,33 @@ public:
     p.erase(p.begin() + i);
   }
 
+  //
+  // Auxiliary topologies
+  //
+
+  /// Record an auxiliary topology, replacing any with the same name
+  void AddAuxTopology(AuxTopologyInfo&& info);
+
+  /// \returns the auxiliary topology called name that was derived from the
+  /// current topology, or null if there is none
+  const AuxTopologyInfo* FindAuxTopology(const std::string& name) const;
+
+  void ClearAuxTopologies() { aux_topology_info_list_.clear(); }
+
+  //
+  // Checksums
+  //
+
+  /// \returns the checksum of the file at \param path, relative to the
+  /// partition directory, or null if none was recorded, e.g., because the
+  /// file was written by an older version
+  std::shared_ptr<const FileChecksum> checksum(const std::string& path) const;
+
+  /// Record the checksums of files, by URI or name; only the last component
+  /// of each URI is kept. Checksums of files that the header no longer
+  /// refers to are dropped when it is written.
+  void AddChecksums(std::unordered_map<std::string, FileChecksum>&& checksums);
+
   //
   // Property persistence
   //
@@ -71,6 +134,11 @@ public:
   katana::Result<void> MarkEdgePropertiesPersistent(
       const std::vector<std::string>& persist_edge_props);
 
+  /// Write property \param i in \param format from now on. A property
+  /// stored in another format is rewritten by the next store.
+  void SetNodePropertyFileFormat(uint32_t i, PropertyFileFormat format);
+  void SetEdgePropertyFileFormat(uint32_t i, PropertyFileFormat format);
+
   //
   // Accessors/Mutators
   //
@@ -101,6 +169,10 @@ public:
     part_prop_info_list_ = std::move(part_prop_info_list);
   }
 
+  const std::vector<AuxTopologyInfo>& aux_topology_info_list() const {
+    return aux_topology_info_list_;
+  }
+
   const PartitionMetadata& metadata() const { return metadata_; }
   void set_metadata(const PartitionMetadata& metadata) { metadata_ = metadata; }
 
@@ -121,6 +193,11 @@ private:
   PartitionMetadata metadata_;
 
   std::string topology_path_;
+
+  std::vector<AuxTopologyInfo> aux_topology_info_list_;
+
+  std::unordered_map<std::string, std::shared_ptr<const FileChecksum>>
+      checksums_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
@@ -129,6 +206,12 @@ void from_json(const nlohmann::json& j, RDGPartHeader& header);
 void to_json(nlohmann::json& j, const PropStorageInfo& propmd);
 void from_json(const nlohmann::json& j, PropStorageInfo& propmd);
 
+void to_json(nlohmann::json& j, const AuxTopologyInfo& info);
+void from_json(const nlohmann::json& j, AuxTopologyInfo& info);
+
+void to_json(nlohmann::json& j, const FileChecksum& checksum);
+void from_json(const nlohmann::json& j, FileChecksum& checksum);
+
 void to_json(nlohmann::json& j, const PartitionMetadata& propmd);
 void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 
@@ -27,17 +27,17 @@ RDGPrefix::DoMakePrefix(const tsuba::RDGMeta& meta) {
     return res.error().WithContext(
         "file get failed: {}: sz: {}", t_path, sizeof(gr_header));
   }
+  std::shared_ptr<const FileChecksum> checksum =
+      part_header.checksum(part_header.topology_path());
+  uint64_t prefix_size = CSRTopologyDestsOffset(gr_header);
   FileView fv;
-  if (auto res = fv.Bind(
-          t_path.string(),
-          sizeof(gr_header) + (gr_header.num_nodes * sizeof(uint64_t)), true);
-      !res) {
+  fv.ExpectChecksum(checksum);
+  if (auto res = fv.Bind(t_path.string(), prefix_size, true); !res) {
     return res.error().WithContext("failed to bind {}", t_path);
   }
 
   return RDGPrefix(
-      std::move(fv),
-      sizeof(gr_header) + (gr_header.num_nodes * sizeof(uint64_t)));
+      std::move(fv), prefix_size, t_path.string(), std::move(checksum));
 }
 
 katana::Result<tsuba::RDGPrefix>
@@ -9,35 +9,60 @@
 katana::Result<void>
 tsuba::RDGSlice::DoMake(
     const katana::Uri& metadata_dir, const SliceArg& slice) {
-  katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-
+  const RDGPartHeader& part_header = core_->part_header();
+  const std::vector<PropStorageInfo>& node_info_list =
+      part_header.node_prop_info_list();
+  const std::vector<PropStorageInfo>& edge_info_list =
+      part_header.edge_prop_info_list();
+
+  // Start reading the property slices before binding the topology, so that
+  // the reads overlap
+  std::vector<PropertyLoader::File> files;
+  auto add_files = [&](const std::vector<PropStorageInfo>& info_list,
+                       std::pair<uint64_t, uint64_t> range) {
+    for (const PropStorageInfo& info : info_list) {
+      files.emplace_back(PropertyLoader::File{
+          info.name, metadata_dir.Join(info.path),
+          ParquetReader::Slice{
+              .offset = static_cast<int64_t>(range.first),
+              .length = static_cast<int64_t>(range.second - range.first)},
+          part_header.checksum(info.path)});
+    }
+  };
+  add_files(node_info_list, slice.node_range);
+  add_files(edge_info_list, slice.edge_range);
+  PropertyLoader loader(std::move(files));
+
+  katana::Uri t_path = metadata_dir.Join(part_header.topology_path());
+  uint64_t topology_start_us = loader.ElapsedUs();
+  // Only the blocks of the topology in the slice are read and checked
+  core_->topology_file_storage().ExpectChecksum(
+      part_header.checksum(part_header.topology_path()));
   if (auto res = core_->topology_file_storage().Bind(
           t_path.string(), slice.topo_off, slice.topo_off + slice.topo_size,
           true);
       !res) {
     return res.error();
   }
-
-  auto node_result = AddPropertySlice(
-      metadata_dir, core_->part_header().node_prop_info_list(),
-      slice.node_range,
-      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-        return rdg->core_->AddNodeProperties(props);
-      });
-  if (!node_result) {
-    return node_result.error();
-  }
-
-  auto edge_result = AddPropertySlice(
-      metadata_dir, core_->part_header().edge_prop_info_list(),
-      slice.edge_range,
-      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-        return rdg->core_->AddEdgeProperties(props);
-      });
-  if (!edge_result) {
-    return edge_result.error();
+  uint64_t topology_end_us = loader.ElapsedUs();
+
+  for (size_t i = 0; i < node_info_list.size() + edge_info_list.size(); ++i) {
+    auto load_res = loader.Get(i);
+    if (!load_res) {
+      return load_res.error();
+    }
+    auto res = i < node_info_list.size()
+                   ? core_->AddNodeProperties(load_res.value())
+                   : core_->AddEdgeProperties(load_res.value());
+    if (!res) {
+      return res.error();
+    }
   }
 
+  std::vector<FileLoadTime> timeline = loader.Timeline();
+  timeline.emplace_back(FileLoadTime{
+      t_path.BaseName(), topology_start_us, topology_end_us});
+  core_->set_load_timeline(std::move(timeline));
   return katana::ResultSuccess();
 }
 
@@ -91,6 +116,11 @@ tsuba::RDGSlice::topology_file_storage() const {
   return core_->topology_file_storage();
 }
 
+const std::vector<tsuba::FileLoadTime>&
+tsuba::RDGSlice::load_timeline() const {
+  return core_->load_timeline();
+}
+
 tsuba::RDGSlice::RDGSlice(std::unique_ptr<RDGCore>&& core)
     : core_(std::move(core)) {}
 
@@ -0,0 +1,177 @@
+#include "tsuba/RemoteFetcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Number of queued parts, from the back, considered for merging. Ranges
+/// that are next to each other are usually fetched one after the other.
+constexpr size_t kMergeWindow = 64;
+
+void
+GetSizeEnv(const std::string& var_name, uint64_t* value) {
+  std::string str;
+  if (!katana::GetEnv(var_name, &str)) {
+    return;
+  }
+  try {
+    *value = std::stoull(str);
+  } catch (const std::exception&) {
+    KATANA_LOG_WARN("{} is not a number of bytes: {}", var_name, str);
+  }
+}
+
+}  // namespace
+
+struct tsuba::RemoteFetcher::Request {
+  std::promise<katana::Result<void>> promise;
+  std::atomic<uint64_t> pending_parts{0};
+  std::mutex error_mutex;
+  std::error_code error;
+
+  /// Called by the thread that fetched one of the parts of this request. It
+  /// resolves the promise with a plain error code because error context is
+  /// local to the thread that creates it.
+  void PartDone(std::error_code ec) {
+    if (ec) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = ec;
+      }
+    }
+    if (pending_parts.fetch_sub(1) != 1) {
+      return;
+    }
+    if (error) {
+      promise.set_value(error);
+      return;
+    }
+    promise.set_value(katana::ResultSuccess());
+  }
+};
+
+tsuba::RemoteFetchOptions
+tsuba::RemoteFetchOptions::FromEnv() {
+  RemoteFetchOptions opts;
+  GetSizeEnv("KATANA_REMOTE_PART_SIZE", &opts.part_size);
+  GetSizeEnv("KATANA_REMOTE_MAX_BYTES_IN_FLIGHT", &opts.max_bytes_in_flight);
+  if (int concurrency{};
+      katana::GetEnv("KATANA_REMOTE_CONCURRENCY", &concurrency)) {
+    if (concurrency > 0) {
+      opts.concurrency = concurrency;
+    } else {
+      KATANA_LOG_WARN("KATANA_REMOTE_CONCURRENCY must be positive");
+    }
+  }
+  opts.part_size = std::max<uint64_t>(opts.part_size, 1);
+  return opts;
+}
+
+tsuba::RemoteFetcher::~RemoteFetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+uint64_t
+tsuba::RemoteFetcher::num_requests() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_requests_;
+}
+
+bool
+tsuba::RemoteFetcher::Merge(
+    const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf,
+    const std::shared_ptr<Request>& request) {
+  size_t window = std::min(queue_.size(), kMergeWindow);
+  for (auto it = queue_.rbegin(); it != queue_.rbegin() + window; ++it) {
+    Part& part = *it;
+    if (part.start + part.size == start && part.buf + part.size == buf &&
+        part.size + size <= opts_.part_size && part.uri == uri) {
+      part.size += size;
+      part.requests.emplace_back(request);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::future<katana::Result<void>>
+tsuba::RemoteFetcher::Fetch(
+    const std::string& uri, uint64_t start, uint64_t size, uint8_t* buf) {
+  auto request = std::make_shared<Request>();
+  auto future = request->promise.get_future();
+  if (size == 0) {
+    request->promise.set_value(katana::ResultSuccess());
+    return future;
+  }
+
+  uint64_t num_parts = (size + opts_.part_size - 1) / opts_.part_size;
+  request->pending_parts = num_parts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (workers_.empty()) {
+      for (uint32_t i = 0; i < std::max<uint32_t>(opts_.concurrency, 1); ++i) {
+        workers_.emplace_back([this] { Work(); });
+      }
+    }
+    for (uint64_t offset = 0; offset < size; offset += opts_.part_size) {
+      uint64_t part_size = std::min(opts_.part_size, size - offset);
+      if (Merge(uri, start + offset, part_size, buf + offset, request)) {
+        continue;
+      }
+      queue_.emplace_back(
+          Part{uri, start + offset, part_size, buf + offset, {request}});
+    }
+  }
+  cv_.notify_all();
+  return future;
+}
+
+void
+tsuba::RemoteFetcher::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] {
+      if (queue_.empty()) {
+        return stopping_;
+      }
+      return bytes_in_flight_ == 0 || bytes_in_flight_ + queue_.front().size <=
+                                          opts_.max_bytes_in_flight;
+    });
+    if (queue_.empty()) {
+      return;
+    }
+    Part part = std::move(queue_.front());
+    queue_.pop_front();
+    bytes_in_flight_ += part.size;
+    ++num_requests_;
+    lock.unlock();
+
+    std::error_code ec;
+    if (auto res = get_range_(part.uri, part.start, part.size, part.buf);
+        !res) {
+      KATANA_LOG_DEBUG(
+          "fetching {} bytes at {} of {}: {}", part.size, part.start, part.uri,
+          res.error());
+      ec = res.error().error_code();
+    }
+    for (const std::shared_ptr<Request>& request : part.requests) {
+      request->PartDone(ec);
+    }
+
+    lock.lock();
+    bytes_in_flight_ -= part.size;
+    cv_.notify_all();
+  }
+}
@@ -0,0 +1,522 @@
+#include "tsuba/Snapshot.h"
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <regex>
+#include <set>
+#include <unordered_set>
+
+#include "RDGHandleImpl.h"
+#include "RDGMeta.h"
+#include "RDGPartHeader.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileView.h"
+#include "tsuba/file.h"
+
+template <typename T>
+using Result = katana::Result<T>;
+
+namespace {
+
+/// Readers retry pinning the latest version this many times when it is
+/// collected under them
+constexpr int kMaxPinAttempts = 8;
+
+// pin files look like `pin_N-xxxxxxxxxxxx` where `N` is the pinned version
+const std::regex kPinName("pin_([0-9]+)-[0-9A-Za-z]+");
+// partition headers look like `meta_H_N` where `N` is their version
+const std::regex kPartitionName("meta_[0-9]+_([0-9]+)");
+
+/// The contents of a pin file
+struct PinRecord {
+  uint64_t version{0};
+  /// Seconds since the epoch after which the pin is ignored, or 0 if it
+  /// never expires
+  int64_t expires{0};
+};
+
+void
+to_json(nlohmann::json& j, const PinRecord& pin) {
+  j = nlohmann::json{
+      {"version", pin.version},
+      {"expires", pin.expires},
+  };
+}
+
+void
+from_json(const nlohmann::json& j, PinRecord& pin) {
+  j.at("version").get_to(pin.version);
+  j.at("expires").get_to(pin.expires);
+}
+
+int64_t
+SecondsSinceEpoch() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t
+ParseNumber(const std::string& str) {
+  return std::strtoull(str.c_str(), nullptr, 10);
+}
+
+/// The files of an RDG directory, by what they are
+struct Listing {
+  /// The meta files of the committed versions
+  std::map<uint64_t, std::vector<std::string>> meta_files;
+  /// The partition headers of each version, committed or not
+  std::map<uint64_t, std::vector<std::string>> partition_files;
+  std::vector<std::string> pin_files;
+};
+
+Result<Listing>
+ListRDG(const katana::Uri& dir) {
+  std::vector<std::string> files;
+  if (auto res = tsuba::FileListAsync(dir.string(), &files).get(); !res) {
+    return res.error().WithContext("listing {}", dir);
+  }
+  Listing listing;
+  std::smatch match;
+  for (const std::string& file : files) {
+    if (std::regex_match(file, match, kPartitionName)) {
+      listing.partition_files[ParseNumber(match[1])].emplace_back(file);
+    } else if (std::regex_match(file, match, kPinName)) {
+      listing.pin_files.emplace_back(file);
+    } else if (auto res = tsuba::RDGMeta::ParseVersionFromName(file); res) {
+      listing.meta_files[res.value()].emplace_back(file);
+    }
+  }
+  return listing;
+}
+
+Result<uint64_t>
+LatestVersion(const katana::Uri& dir) {
+  auto listing_res = ListRDG(dir);
+  if (!listing_res) {
+    return listing_res.error();
+  }
+  const Listing& listing = listing_res.value();
+  if (listing.meta_files.empty()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::NotFound, "no versions of an RDG in {}", dir);
+  }
+  return listing.meta_files.rbegin()->first;
+}
+
+/// The versions pinned by the pins in pin_files. Expired pins are deleted
+/// and counted in *expired.
+std::set<uint64_t>
+PinnedVersions(
+    const katana::Uri& dir, const std::vector<std::string>& pin_files,
+    uint64_t* expired) {
+  int64_t now = SecondsSinceEpoch();
+  std::set<uint64_t> pinned;
+  std::unordered_set<std::string> expired_files;
+  std::smatch match;
+  for (const std::string& file : pin_files) {
+    std::regex_match(file, match, kPinName);
+    uint64_t version = ParseNumber(match[1]);
+
+    // The name is enough to pin the version; the contents only say when the
+    // pin expires. A pin that cannot be read is in the middle of being
+    // written or renewed, unless it has been released.
+    std::string path = dir.Join(file).string();
+    tsuba::FileView fv;
+    PinRecord pin;
+    if (auto res = fv.Bind(path, true);
+        !res || !katana::JsonParse<PinRecord>(fv, &pin)) {
+      tsuba::StatBuf stat;
+      if (tsuba::FileStat(path, &stat)) {
+        pinned.emplace(version);
+      }
+      continue;
+    }
+    if (pin.expires != 0 && pin.expires < now) {
+      expired_files.emplace(file);
+      continue;
+    }
+    pinned.emplace(version);
+  }
+
+  if (!expired_files.empty()) {
+    if (auto res = tsuba::FileDelete(dir.string(), expired_files); !res) {
+      KATANA_LOG_WARN("deleting expired pins of {}: {}", dir, res.error());
+    }
+    *expired += expired_files.size();
+  }
+  return pinned;
+}
+
+/// Add the names of the files that header refers to to *files
+void
+AddReferencedFiles(
+    const tsuba::RDGPartHeader& header,
+    std::unordered_set<std::string>* files) {
+  auto add = [&](const std::string& path) {
+    if (!path.empty()) {
+      files->emplace(path);
+    }
+  };
+  for (const auto& info : header.node_prop_info_list()) {
+    add(info.path);
+  }
+  for (const auto& info : header.edge_prop_info_list()) {
+    add(info.path);
+  }
+  for (const auto& info : header.part_prop_info_list()) {
+    add(info.path);
+  }
+  for (const auto& info : header.aux_topology_info_list()) {
+    add(info.path);
+  }
+  add(header.topology_path());
+}
+
+}  // namespace
+
+Result<tsuba::Snapshot>
+tsuba::Snapshot::Make(const std::string& rdg_name, std::chrono::seconds lease) {
+  auto uri_res = katana::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  if (RDGMeta::IsMetaUri(uri_res.value())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} names a meta file, not an RDG",
+        uri_res.value());
+  }
+
+  Result<Snapshot> snapshot_res = Snapshot();
+  Snapshot& snapshot = snapshot_res.value();
+  snapshot.dir_ = std::move(uri_res.value());
+  snapshot.lease_ = lease;
+  // The latest version can only be collected once a newer one is
+  // committed, which makes the newer one worth pinning anyway
+  for (int attempt = 0; attempt < kMaxPinAttempts; ++attempt) {
+    auto version_res = LatestVersion(snapshot.dir_);
+    if (!version_res) {
+      return version_res.error();
+    }
+    auto pinned_res = snapshot.TryPin(version_res.value());
+    if (!pinned_res) {
+      return pinned_res.error();
+    }
+    if (pinned_res.value()) {
+      return snapshot_res;
+    }
+  }
+  return KATANA_ERROR(
+      ErrorCode::NotFound,
+      "every version of {} was collected before it could be pinned",
+      snapshot.dir_);
+}
+
+Result<tsuba::Snapshot>
+tsuba::Snapshot::Make(
+    const std::string& rdg_name, uint64_t version,
+    std::chrono::seconds lease) {
+  auto uri_res = katana::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  if (RDGMeta::IsMetaUri(uri_res.value())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} names a meta file, not an RDG",
+        uri_res.value());
+  }
+
+  Result<Snapshot> snapshot_res = Snapshot();
+  Snapshot& snapshot = snapshot_res.value();
+  snapshot.dir_ = std::move(uri_res.value());
+  snapshot.lease_ = lease;
+  auto pinned_res = snapshot.TryPin(version);
+  if (!pinned_res) {
+    return pinned_res.error();
+  }
+  if (!pinned_res.value()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "version {} of {} does not exist", version,
+        snapshot.dir_);
+  }
+  return snapshot_res;
+}
+
+tsuba::Snapshot::Snapshot() = default;
+
+tsuba::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : dir_(std::move(other.dir_)),
+      version_(other.version_),
+      meta_(std::move(other.meta_)),
+      pin_name_(std::move(other.pin_name_)),
+      lease_(other.lease_) {
+  other.pin_name_.clear();
+}
+
+tsuba::Snapshot&
+tsuba::Snapshot::operator=(Snapshot&& other) noexcept {
+  if (this != &other) {
+    if (auto res = Release(); !res) {
+      KATANA_LOG_WARN("releasing pin of {}: {}", dir_, res.error());
+    }
+    dir_ = std::move(other.dir_);
+    version_ = other.version_;
+    meta_ = std::move(other.meta_);
+    pin_name_ = std::move(other.pin_name_);
+    lease_ = other.lease_;
+    other.pin_name_.clear();
+  }
+  return *this;
+}
+
+tsuba::Snapshot::~Snapshot() {
+  if (auto res = Release(); !res) {
+    KATANA_LOG_WARN("releasing pin of {}: {}", dir_, res.error());
+  }
+}
+
+Result<tsuba::RDGHandle>
+tsuba::Snapshot::Open() const {
+  if (!pinned()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "snapshot is not pinned");
+  }
+  return RDGHandle{.impl_ = new RDGHandleImpl(kReadOnly, RDGMeta(*meta_))};
+}
+
+Result<bool>
+tsuba::Snapshot::Refresh() {
+  if (!pinned()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "snapshot is not pinned");
+  }
+  for (int attempt = 0; attempt < kMaxPinAttempts; ++attempt) {
+    auto version_res = LatestVersion(dir_);
+    if (!version_res) {
+      return version_res.error();
+    }
+    if (version_res.value() <= version_) {
+      return false;
+    }
+    auto pinned_res = TryPin(version_res.value());
+    if (!pinned_res) {
+      return pinned_res.error();
+    }
+    if (pinned_res.value()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Result<void>
+tsuba::Snapshot::Renew() {
+  if (!pinned()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "snapshot is not pinned");
+  }
+  return WritePin(pin_name_, version_);
+}
+
+Result<void>
+tsuba::Snapshot::Release() {
+  if (!pinned()) {
+    return katana::ResultSuccess();
+  }
+  std::string pin_name = std::move(pin_name_);
+  pin_name_.clear();
+  if (auto res = FileDelete(dir_.string(), {pin_name}); !res) {
+    return res.error().WithContext("deleting pin {}", pin_name);
+  }
+  return katana::ResultSuccess();
+}
+
+Result<bool>
+tsuba::Snapshot::TryPin(uint64_t version) {
+  std::string pin_name = fmt::format(
+      "pin_{}-{}", version, katana::RandomAlphanumericString(12));
+  if (auto res = WritePin(pin_name, version); !res) {
+    return res.error();
+  }
+
+  // CollectGarbage deletes the meta file of a version before anything else
+  // and then keeps the files of the versions pinned by then, so the version
+  // is safe if its meta file outlived the pin being written
+  auto meta_res = RDGMeta::Make(dir_, version);
+  if (!meta_res) {
+    if (auto res = FileDelete(dir_.string(), {pin_name}); !res) {
+      KATANA_LOG_WARN("deleting pin {}: {}", pin_name, res.error());
+    }
+    KATANA_LOG_DEBUG(
+        "version {} of {} is gone: {}", version, dir_, meta_res.error());
+    return false;
+  }
+
+  if (auto res = Release(); !res) {
+    KATANA_LOG_WARN(
+        "releasing pin of version {} of {}: {}", version_, dir_, res.error());
+  }
+  pin_name_ = std::move(pin_name);
+  version_ = version;
+  meta_ = std::make_unique<RDGMeta>(std::move(meta_res.value()));
+  return true;
+}
+
+Result<void>
+tsuba::Snapshot::WritePin(const std::string& pin_name, uint64_t version) const {
+  PinRecord pin{.version = version};
+  if (lease_.count() > 0) {
+    pin.expires = SecondsSinceEpoch() + lease_.count();
+  }
+  auto json_res = katana::JsonDump(pin);
+  if (!json_res) {
+    return json_res.error();
+  }
+  // POSIX files end with newlines
+  std::string contents = json_res.value() + "\n";
+  if (auto res = FileStore(
+          dir_.Join(pin_name).string(),
+          reinterpret_cast<const uint8_t*>(contents.data()), contents.size());
+      !res) {
+    return res.error().WithContext("writing pin {}", pin_name);
+  }
+  return katana::ResultSuccess();
+}
+
+Result<tsuba::GarbageCollectionStats>
+tsuba::CollectGarbage(const std::string& rdg_name, uint64_t keep_latest) {
+  if (keep_latest == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "the latest version must be kept");
+  }
+  auto uri_res = katana::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  katana::Uri dir = std::move(uri_res.value());
+  if (RDGMeta::IsMetaUri(dir)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} names a meta file, not an RDG", dir);
+  }
+
+  auto listing_res = ListRDG(dir);
+  if (!listing_res) {
+    return listing_res.error();
+  }
+  Listing listing = std::move(listing_res.value());
+  GarbageCollectionStats stats;
+  if (listing.meta_files.empty()) {
+    return stats;
+  }
+
+  std::set<uint64_t> kept;
+  for (auto it = listing.meta_files.rbegin();
+       it != listing.meta_files.rend() && kept.size() < keep_latest; ++it) {
+    kept.emplace(it->first);
+  }
+  // Partition headers newer than the latest meta file belong to a commit in
+  // progress
+  uint64_t latest = *kept.rbegin();
+  std::set<uint64_t> pinned =
+      PinnedVersions(dir, listing.pin_files, &stats.expired_pins);
+
+  std::set<uint64_t> victims;
+  auto consider = [&](uint64_t version) {
+    if (version <= latest && kept.count(version) == 0 &&
+        pinned.count(version) == 0) {
+      victims.emplace(version);
+    }
+  };
+  for (const auto& [version, files] : listing.meta_files) {
+    consider(version);
+  }
+  for (const auto& [version, files] : listing.partition_files) {
+    consider(version);
+  }
+
+  // Make the victims unopenable, and then spare those that readers pinned
+  // before that
+  std::unordered_set<std::string> meta_files;
+  for (uint64_t version : victims) {
+    auto it = listing.meta_files.find(version);
+    if (it != listing.meta_files.end()) {
+      meta_files.insert(it->second.begin(), it->second.end());
+    }
+  }
+  if (!meta_files.empty()) {
+    if (auto res = FileDelete(dir.string(), meta_files); !res) {
+      return res.error().WithContext("deleting meta files of {}", dir);
+    }
+    stats.deleted_files += meta_files.size();
+
+    auto relisting_res = ListRDG(dir);
+    if (!relisting_res) {
+      return relisting_res.error();
+    }
+    for (uint64_t version : PinnedVersions(
+             dir, relisting_res.value().pin_files, &stats.expired_pins)) {
+      pinned.emplace(version);
+      victims.erase(version);
+    }
+  }
+  for (uint64_t version : pinned) {
+    if (version < latest && kept.count(version) == 0) {
+      stats.pinned_versions.emplace_back(version);
+    }
+  }
+
+  // Every file that a remaining version refers to stays
+  std::vector<katana::Uri> live_paths;
+  std::vector<katana::Uri> victim_paths;
+  std::unordered_set<std::string> to_delete;
+  for (const auto& [version, files] : listing.partition_files) {
+    if (version > latest) {
+      continue;
+    }
+    bool victim = victims.count(version) > 0;
+    for (const std::string& file : files) {
+      (victim ? victim_paths : live_paths).emplace_back(dir.Join(file));
+      if (victim) {
+        to_delete.emplace(file);
+      }
+    }
+  }
+  std::unordered_set<std::string> live_files;
+  std::vector<Result<RDGPartHeader>> live_headers =
+      RDGPartHeader::MakeAll(live_paths);
+  for (size_t i = 0; i < live_headers.size(); ++i) {
+    if (!live_headers[i]) {
+      // Without the header there is no telling which files are still used
+      return live_headers[i].error().WithContext(
+          "reading {}; nothing else was collected", live_paths[i]);
+    }
+    AddReferencedFiles(live_headers[i].value(), &live_files);
+  }
+  std::unordered_set<std::string> victim_files;
+  std::vector<Result<RDGPartHeader>> victim_headers =
+      RDGPartHeader::MakeAll(victim_paths);
+  for (size_t i = 0; i < victim_headers.size(); ++i) {
+    if (!victim_headers[i]) {
+      KATANA_LOG_DEBUG(
+          "reading {}: {}; only the header is collected", victim_paths[i],
+          victim_headers[i].error());
+      continue;
+    }
+    AddReferencedFiles(victim_headers[i].value(), &victim_files);
+  }
+  for (const std::string& file : victim_files) {
+    if (live_files.count(file) == 0) {
+      to_delete.emplace(file);
+    }
+  }
+
+  if (!to_delete.empty()) {
+    if (auto res = FileDelete(dir.string(), to_delete); !res) {
+      return res.error().WithContext("deleting files of {}", dir);
+    }
+    stats.deleted_files += to_delete.size();
+  }
+  stats.collected_versions.assign(victims.begin(), victims.end());
+  return stats;
+}
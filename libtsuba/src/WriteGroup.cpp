@@ -1,7 +1,11 @@
 #include "tsuba/WriteGroup.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "GlobalState.h"
 #include "katana/Random.h"
+#include "katana/Trace.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -10,6 +14,11 @@ namespace {
 
 constexpr uint32_t kTagLen = 12;
 
+uint64_t
+MaxPendingBuilds() {
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
 }  // namespace
 
 namespace tsuba {
@@ -31,6 +40,7 @@ WriteGroup::Drain() {
   if (op_it == pending_ops_.end()) {
     return false;
   }
+  katana::TraceSpan span("WriteGroup drain", "io");
   auto res = op_it->result.get();
   if (!res) {
     KATANA_LOG_DEBUG(
@@ -39,10 +49,29 @@ WriteGroup::Drain() {
     last_error_ = res.error();
   }
   outstanding_size_ -= op_it->accounted_size;
+  if (op_it->builds_frame) {
+    pending_builds_ -= 1;
+  }
   pending_ops_.erase(op_it);
   return true;
 }
 
+void
+WriteGroup::RecordChecksum(
+    const std::string& file, const uint8_t* data, uint64_t size) {
+  FileChecksum checksum = FileChecksum::Compute(data, size);
+  std::lock_guard<std::mutex> lock(checksums_mutex_);
+  checksums_[file] = std::move(checksum);
+}
+
+std::unordered_map<std::string, FileChecksum>
+WriteGroup::TakeChecksums() {
+  std::unordered_map<std::string, FileChecksum> checksums;
+  std::lock_guard<std::mutex> lock(checksums_mutex_);
+  checksums.swap(checksums_);
+  return checksums;
+}
+
 Result<void>
 WriteGroup::Finish() {
   while (Drain()) {
@@ -60,27 +89,31 @@ WriteGroup::Finish() {
 void
 WriteGroup::AddOp(
     std::future<katana::Result<void>> future, std::string file,
-    uint64_t accounted_size) {
-  if (accounted_size > kMaxOutstandingSize) {
-    accounted_size = kMaxOutstandingSize;
-  }
-  if (accounted_size > 0) {
-    while (outstanding_size_ + accounted_size > kMaxOutstandingSize) {
-      if (!Drain()) {
-        KATANA_LOG_ERROR(
-            "outstanding_size should be zero if we couldn't drain");
-        break;
-      }
-    }
-  }
+    uint64_t accounted_size, bool builds_frame) {
+  accounted_size = std::min(accounted_size, kMaxOutstandingSize);
+  MakeRoom(accounted_size, builds_frame);
   pending_ops_.emplace_back(AsyncOp{
       .result = std::move(future),
       .location = std::move(file),
       .accounted_size = accounted_size,
+      .builds_frame = builds_frame,
   });
+  outstanding_size_ += accounted_size;
+  pending_builds_ += builds_frame ? 1 : 0;
   total_ += 1;
 }
 
+void
+WriteGroup::MakeRoom(uint64_t accounted_size, bool builds_frame) {
+  while (outstanding_size_ + accounted_size > kMaxOutstandingSize ||
+         (builds_frame && pending_builds_ >= MaxPendingBuilds())) {
+    if (!Drain()) {
+      KATANA_LOG_ERROR("outstanding_size should be zero if we couldn't drain");
+      break;
+    }
+  }
+}
+
 // shared pointer because FileFrames are often held that way due do the way
 // they're used with arrow
 void
@@ -89,10 +122,52 @@ WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
   uint64_t size = ff->map_size();
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
+  auto future =
+      std::async(std::launch::async, [this, ff = std::move(ff)]() mutable {
+        auto persist = ff->PersistAsync();
+        RecordChecksum(
+            ff->path(), ff->ptr<uint8_t>().value(), ff->Tell().ValueOrDie());
+        return persist.get();
+      });
   AddOp(std::move(future), file, size);
 }
 
+void
+WriteGroup::StartStore(
+    std::string file,
+    std::function<katana::Result<std::shared_ptr<FileFrame>>()> make_frame,
+    uint64_t estimated_size) {
+  estimated_size = std::min(estimated_size, kMaxOutstandingSize);
+  // Wait before starting the build so that the memory it needs is bounded
+  MakeRoom(estimated_size, true);
+
+  auto future = std::async(
+      std::launch::async,
+      [this, make_frame = std::move(make_frame)]() -> katana::Result<void> {
+        auto ff_res = make_frame();
+        if (!ff_res) {
+          return ff_res.error();
+        }
+        std::shared_ptr<FileFrame> ff = std::move(ff_res.value());
+        auto persist = ff->PersistAsync();
+        RecordChecksum(
+            ff->path(), ff->ptr<uint8_t>().value(), ff->Tell().ValueOrDie());
+        return persist.get();
+      });
+  AddOp(std::move(future), std::move(file), estimated_size, true);
+}
+
+void
+WriteGroup::StartStore(
+    const std::string& file, const uint8_t* buf, uint64_t size) {
+  // The checksum is computed while the data are written
+  auto future = std::async(
+      std::launch::async, [this, file, buf, size]() -> katana::Result<void> {
+        auto store = FileStoreAsync(file, buf, size);
+        RecordChecksum(file, buf, size);
+        return store.get();
+      });
+  AddOp(std::move(future), file);
+}
+
 }  // namespace tsuba
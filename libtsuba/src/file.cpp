@@ -19,22 +19,45 @@
 #include "katana/Platform.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
+
+namespace {
+
+/// Run op after the delay that the IoFaultProfile adds to an operation that
+/// moves bytes. Asynchronous operations are delayed in the background so
+/// that they still return right away.
+template <typename Op>
+std::future<katana::Result<void>>
+DelayAsync(uint64_t bytes, Op op) {
+  if (!tsuba::internal::IoFaultTestActive()) {
+    return op();
+  }
+  return std::async(std::launch::async, [bytes, op = std::move(op)]() {
+    tsuba::internal::IoDelay(bytes);
+    return op().get();
+  });
+}
+
+}  // namespace
 
 katana::Result<void>
 tsuba::FileStore(const std::string& uri, const uint8_t* data, uint64_t size) {
+  tsuba::internal::IoDelay(size);
   return FS(uri)->PutMultiSync(uri, data, size);
 }
 
 std::future<katana::Result<void>>
 tsuba::FileStoreAsync(
     const std::string& uri, const uint8_t* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, data, size);
+  return DelayAsync(
+      size, [=]() { return FS(uri)->PutAsync(uri, data, size); });
 }
 
 katana::Result<void>
 tsuba::FileGet(
     const std::string& uri, uint8_t* result_buffer, uint64_t begin,
     uint64_t size) {
+  tsuba::internal::IoDelay(size);
   return FS(uri)->GetMultiSync(uri, begin, size, result_buffer);
 }
 
@@ -42,7 +65,9 @@ std::future<katana::Result<void>>
 tsuba::FileGetAsync(
     const std::string& uri, uint8_t* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(uri, begin, size, result_buffer);
+  return DelayAsync(size, [=]() {
+    return FS(uri)->GetAsync(uri, begin, size, result_buffer);
+  });
 }
 
 katana::Result<void>
@@ -57,11 +82,13 @@ tsuba::FileRemoteCopy(
     return ErrorCode::NotImplemented;
   }
 
+  tsuba::internal::IoDelay(size);
   return dest_fs->RemoteCopy(source_uri, dest_uri, begin, size);
 }
 
 katana::Result<void>
 tsuba::FileStat(const std::string& uri, StatBuf* s_buf) {
+  tsuba::internal::IoDelay(0);
   return FS(uri)->Stat(uri, s_buf);
 }
 
@@ -69,12 +96,19 @@ std::future<katana::Result<void>>
 tsuba::FileListAsync(
     const std::string& directory, std::vector<std::string>* list,
     std::vector<uint64_t>* size) {
-  return FS(directory)->ListAsync(directory, list, size);
+  return DelayAsync(
+      0, [=]() { return FS(directory)->ListAsync(directory, list, size); });
 }
 
 katana::Result<void>
 tsuba::FileDelete(
     const std::string& directory,
     const std::unordered_set<std::string>& files) {
+  tsuba::internal::IoDelay(0);
   return FS(directory)->Delete(directory, files);
 }
+
+tsuba::FileCacheStats
+tsuba::GetFileCacheStats() {
+  return GlobalState::Get().CacheStats();
+}
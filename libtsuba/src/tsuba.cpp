@@ -2,6 +2,7 @@
 
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
+#include "RDGPartHeader.h"
 #include "katana/Backtrace.h"
 #include "katana/CommBackend.h"
 #include "katana/Env.h"
@@ -108,6 +109,36 @@ tsuba::Open(const std::string& rdg_name, uint32_t flags) {
       .impl_ = new RDGHandleImpl(flags, std::move(meta_res.value()))};
 }
 
+katana::Result<tsuba::RDGHandle>
+tsuba::Open(const std::string& rdg_name, uint64_t version, uint32_t flags) {
+  if (!OpenFlagsValid(flags)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "invalid value for flags ({:#x})", flags);
+  }
+
+  auto uri_res = katana::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  katana::Uri uri = std::move(uri_res.value());
+
+  if (RDGMeta::IsMetaUri(uri)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "failed: {} is probably a literal rdg file and not suited for open",
+        uri);
+  }
+
+  auto meta_res = tsuba::RDGMeta::Make(uri, version);
+  if (!meta_res) {
+    return meta_res.error().WithContext(
+        "cannot open version {} of {}", version, uri);
+  }
+
+  return RDGHandle{
+      .impl_ = new RDGHandleImpl(flags, std::move(meta_res.value()))};
+}
+
 katana::Result<void>
 tsuba::Close(RDGHandle handle) {
   delete handle.impl_;
@@ -125,6 +156,8 @@ tsuba::Create(const std::string& name) {
   KATANA_LOG_DEBUG_ASSERT(!RDGMeta::IsMetaUri(uri));
   // the default construction is the empty RDG
   tsuba::RDGMeta meta{};
+  // Versions start over, so cached headers of an earlier RDG here are stale
+  RDGPartHeader::EvictCached(uri);
 
   katana::CommBackend* comm = Comm();
   if (comm->ID == 0) {
@@ -0,0 +1,350 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Analytics.h"
+#include "katana/Version.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Katana Benchmark Suite";
+
+static const char* desc =
+    "Runs BFS, SSSP, PageRank, connected components, betweenness centrality "
+    "and triangle counting from katana::analytics over a fixed set of inputs "
+    "and reports timings as JSON";
+
+static cll::opt<std::string> manifestFile(
+    "manifest",
+    cll::desc("JSON file listing the inputs to run (default value is the "
+              "manifest in the source tree)"),
+    cll::init(KATANA_BENCH_MANIFEST));
+static cll::opt<std::string> inputDir(
+    "inputDir",
+    cll::desc("Directory containing the inputs named in the manifest "
+              "(default value is the build's input directory)"),
+    cll::init(KATANA_BENCH_INPUT_DIR));
+static cll::opt<std::string> algorithms(
+    "algorithms",
+    cll::desc("Comma separated list of algorithms to run from bfs, sssp, "
+              "pagerank, cc, bc and tc (default value all)"),
+    cll::init("bfs,sssp,pagerank,cc,bc,tc"));
+static cll::opt<unsigned> numWarmup(
+    "warmup",
+    cll::desc("Number of untimed runs before the timed trials "
+              "(default value 1)"),
+    cll::init(1));
+static cll::opt<unsigned> numTrials(
+    "trials", cll::desc("Number of timed trials (default value 5)"),
+    cll::init(5));
+static cll::opt<std::string> threadSweep(
+    "threadSweep",
+    cll::desc("Whitespace separated list of thread counts to run with "
+              "(default value is powers of 2 up to -t)"));
+static cll::opt<std::string> jsonOutput(
+    "jsonOutput",
+    cll::desc("File to write results to (default value katana-bench.json)"),
+    cll::init("katana-bench.json"));
+
+namespace {
+
+constexpr const char* kOutputProperty = "katana-bench-output";
+
+struct BenchInput {
+  std::string name;
+  std::unique_ptr<katana::PropertyGraph> graph;
+  std::unique_ptr<katana::PropertyGraph> symmetric_graph;
+  std::string edge_weight_property;
+  std::vector<uint32_t> sources;
+};
+
+/// A benchmark runs an algorithm once on an input. The trial number picks the
+/// source node for single source algorithms.
+using Benchmark =
+    std::function<katana::Result<void>(BenchInput* input, unsigned trial)>;
+
+katana::Result<void>
+RemoveOutput(katana::PropertyGraph* pg) {
+  if (pg->node_schema()->GetFieldIndex(kOutputProperty) < 0) {
+    return katana::ResultSuccess();
+  }
+  return pg->RemoveNodeProperty(kOutputProperty);
+}
+
+uint32_t
+Source(const BenchInput& input, unsigned trial) {
+  return input.sources[trial % input.sources.size()];
+}
+
+const std::map<std::string, Benchmark>&
+Benchmarks() {
+  static const std::map<std::string, Benchmark> benchmarks{
+      {"bfs",
+       [](BenchInput* input, unsigned trial) {
+         return Bfs(
+             input->graph.get(), Source(*input, trial), kOutputProperty);
+       }},
+      {"sssp",
+       [](BenchInput* input, unsigned trial) {
+         return Sssp(
+             input->graph.get(), Source(*input, trial),
+             input->edge_weight_property, kOutputProperty);
+       }},
+      {"pagerank",
+       [](BenchInput* input, unsigned) {
+         return Pagerank(input->graph.get(), kOutputProperty);
+       }},
+      {"cc",
+       [](BenchInput* input, unsigned) {
+         return ConnectedComponents(
+             input->symmetric_graph.get(), kOutputProperty);
+       }},
+      {"bc",
+       [](BenchInput* input, unsigned) {
+         return BetweennessCentrality(
+             input->graph.get(), kOutputProperty, input->sources);
+       }},
+      {"tc",
+       [](BenchInput* input, unsigned) -> katana::Result<void> {
+         if (auto r = TriangleCount(input->symmetric_graph.get()); !r) {
+           return r.error();
+         }
+         return katana::ResultSuccess();
+       }},
+  };
+  return benchmarks;
+}
+
+std::vector<std::string>
+Split(const std::string& str, char sep) {
+  std::vector<std::string> ret;
+  std::istringstream in(str);
+  for (std::string item; std::getline(in, item, sep);) {
+    if (!item.empty()) {
+      ret.emplace_back(item);
+    }
+  }
+  return ret;
+}
+
+std::vector<unsigned>
+ThreadCounts(unsigned max_threads) {
+  std::vector<unsigned> threads;
+  if (!threadSweep.empty()) {
+    std::istringstream in(threadSweep);
+    threads.insert(
+        threads.end(), std::istream_iterator<unsigned>{in},
+        std::istream_iterator<unsigned>{});
+    return threads;
+  }
+  for (unsigned t = 1; t < max_threads; t *= 2) {
+    threads.emplace_back(t);
+  }
+  threads.emplace_back(max_threads);
+  return threads;
+}
+
+nlohmann::json
+ReadManifest(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    KATANA_LOG_FATAL("cannot open manifest: {}", path);
+  }
+  nlohmann::json manifest;
+  try {
+    in >> manifest;
+  } catch (const nlohmann::json::exception& exp) {
+    KATANA_LOG_FATAL("cannot parse manifest {}: {}", path, exp.what());
+  }
+
+  // The input directory is marked with the version it was extracted from;
+  // numbers gathered on different inputs are not comparable
+  std::string version = manifest.at("input_version");
+  std::string marker = inputDir + "/current-" + version;
+  if (!std::ifstream(marker)) {
+    KATANA_LOG_WARN(
+        "{} not found; inputs may not match manifest version {}", marker,
+        version);
+  }
+  return manifest;
+}
+
+BenchInput
+LoadInput(const nlohmann::json& entry) {
+  BenchInput input;
+  input.name = entry.at("name");
+  input.edge_weight_property = entry.value("edge_weight_property", "");
+  input.sources = entry.value("sources", std::vector<uint32_t>{0});
+  if (input.sources.empty()) {
+    input.sources.emplace_back(0);
+  }
+
+  std::string path = inputDir + "/" + entry.at("path").get<std::string>();
+  input.graph = MakeFileGraph(path, input.edge_weight_property);
+
+  if (entry.contains("symmetric_path")) {
+    std::string sym_path =
+        inputDir + "/" + entry.at("symmetric_path").get<std::string>();
+    input.symmetric_graph = MakeFileGraph(sym_path, "");
+  }
+  return input;
+}
+
+double
+Median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  size_t mid = v.size() / 2;
+  return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2;
+}
+
+/// Run benchmark on input for warmup and trials, returning the trial times in
+/// milliseconds
+std::vector<double>
+RunTrials(
+    const std::string& algo, const Benchmark& benchmark, BenchInput* input) {
+  std::vector<double> times;
+  for (unsigned i = 0; i < numWarmup + numTrials; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    auto r = benchmark(input, i);
+    auto end = std::chrono::steady_clock::now();
+    if (!r) {
+      KATANA_LOG_FATAL("{} on {} failed: {}", algo, input->name, r.error());
+    }
+    if (i >= numWarmup) {
+      times.emplace_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    for (auto* pg : {input->graph.get(), input->symmetric_graph.get()}) {
+      if (!pg) {
+        continue;
+      }
+      if (auto res = RemoveOutput(pg); !res) {
+        KATANA_LOG_FATAL("cannot remove output: {}", res.error());
+      }
+    }
+  }
+  return times;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, nullptr, nullptr);
+
+  if (numTrials == 0) {
+    KATANA_LOG_FATAL("-trials must be at least 1");
+  }
+
+  std::vector<std::string> algos = Split(algorithms, ',');
+  for (const auto& algo : algos) {
+    if (Benchmarks().count(algo) == 0) {
+      KATANA_LOG_FATAL("unknown algorithm: {}", algo);
+    }
+  }
+
+  nlohmann::json manifest = ReadManifest(manifestFile);
+  katana::ReportParam("katana-bench", "Manifest", manifestFile.getValue());
+  std::vector<unsigned> threads = ThreadCounts(numThreads);
+
+  nlohmann::json results = nlohmann::json::array();
+  for (const auto& entry : manifest.at("inputs")) {
+    BenchInput input = LoadInput(entry);
+    std::cout << "Read " << input.name << ": "
+              << input.graph->topology().num_nodes() << " nodes, "
+              << input.graph->topology().num_edges() << " edges\n";
+
+    for (const auto& algo : algos) {
+      if ((algo == "cc" || algo == "tc") && !input.symmetric_graph) {
+        std::cout << "Skipping " << algo << " on " << input.name
+                  << ": no symmetric_path\n";
+        continue;
+      }
+      if (algo == "sssp" && input.edge_weight_property.empty()) {
+        std::cout << "Skipping sssp on " << input.name
+                  << ": no edge_weight_property\n";
+        continue;
+      }
+
+      for (unsigned t : threads) {
+        katana::setActiveThreads(t);
+        std::vector<double> times =
+            RunTrials(algo, Benchmarks().at(algo), &input);
+
+        double min = *std::min_element(times.begin(), times.end());
+        double mean =
+            std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        double median = Median(times);
+
+        std::string stat_prefix = input.name + "." + algo + ".threads=" +
+                                  std::to_string(t) + ".";
+        katana::ReportStatSingle("katana-bench", stat_prefix + "MinMs", min);
+        katana::ReportStatSingle(
+            "katana-bench", stat_prefix + "MedianMs", median);
+
+        std::cout << input.name << " " << algo << " threads=" << t
+                  << " median=" << median << "ms min=" << min << "ms\n";
+
+        results.push_back({
+            {"input", input.name},
+            {"algorithm", algo},
+            {"threads", t},
+            {"warmup", numWarmup.getValue()},
+            {"trials_ms", times},
+            {"min_ms", min},
+            {"median_ms", median},
+            {"mean_ms", mean},
+        });
+      }
+    }
+  }
+  katana::setActiveThreads(numThreads);
+
+  nlohmann::json report{
+      {"version", katana::getVersion()},
+      {"revision", katana::getRevision()},
+      {"input_version", manifest.at("input_version")},
+      {"results", results},
+  };
+
+  std::ofstream out(jsonOutput);
+  if (!out) {
+    KATANA_LOG_FATAL("cannot write results to {}", jsonOutput);
+  }
+  out << report.dump(2) << "\n";
+  std::cout << "Wrote results to " << jsonOutput << "\n";
+
+  return 0;
+}
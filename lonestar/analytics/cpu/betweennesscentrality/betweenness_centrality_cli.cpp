@@ -63,16 +63,40 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kMultiSource, "MultiSource",
+            "Bit-parallel multi-source BFS over batches of 64 sources"),
+        clEnumValN(
+            BetweennessCentralityPlan::kApproximate, "Approximate",
+            "Adaptive sampling of shortest paths; ignores the source options"),
+        clEnumValN(
+            BetweennessCentralityPlan::kWeighted, "Weighted",
+            "Delta-stepping Brandes on the weights of -edgePropertyName")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("Error bound of -algo=Approximate, relative to the number of "
+              "ordered pairs of nodes (default 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<double> delta(
+    "delta",
+    cll::desc("Probability that -algo=Approximate misses its error bound "
+              "(default 0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultDelta));
+static cll::opt<unsigned> stepShift(
+    "stepShift",
+    cll::desc("Shift value for the deltastep of -algo=Weighted (default 13)"),
+    cll::init(BetweennessCentralityPlan::kDefaultStepShift));
 
 ////////////////////////////////////////////////////////////////////////////////
 
 static const char* name = "Betweenness Centrality";
 static const char* desc =
-    "Computes betweenness centrality in an unweighted graph";
+    "Computes betweenness centrality in an unweighted graph, or in a "
+    "weighted graph with -algo=Weighted";
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -91,11 +115,19 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    plan = BetweennessCentralityPlan::Approximate(epsilon, delta);
+  } else if (algo == BetweennessCentralityPlan::kWeighted) {
+    if (edge_property_name.empty()) {
+      KATANA_LOG_FATAL("-algo=Weighted requires -edgePropertyName");
+    }
+    plan = BetweennessCentralityPlan::Weighted(edge_property_name, stepShift);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
 
-  if (!allSources) {
+  if (!allSources && algo != BetweennessCentralityPlan::kApproximate) {
     if (!startNodesFile.getValue().empty()) {
       std::ifstream file(startNodesFile);
       if (!file.good()) {
@@ -62,6 +62,17 @@ static cll::opt<bool> persistAllDistances(
         "distances for the last source are persisted (default value false)"),
     cll::init(false));
 
+static cll::opt<uint32_t> alpha(
+    "alpha",
+    cll::desc("alpha value to change direction in direction-optimization "
+              "(default value 15)"),
+    cll::init(BfsPlan::kDefaultAlpha));
+static cll::opt<uint32_t> beta(
+    "beta",
+    cll::desc("beta value to change direction in direction-optimization "
+              "(default value 18)"),
+    cll::init(BfsPlan::kDefaultBeta));
+
 static cll::opt<BfsPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value SyncTile):"),
     cll::values(
@@ -69,7 +80,10 @@ static cll::opt<BfsPlan::Algorithm> algo(
             BfsPlan::kAsynchronousTile, "AsyncTile", "Asynchronous tiled"),
         clEnumValN(BfsPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(BfsPlan::kSynchronousTile, "SyncTile", "Synchronous tiled"),
-        clEnumValN(BfsPlan::kSynchronous, "Sync", "Synchronous")),
+        clEnumValN(BfsPlan::kSynchronous, "Sync", "Synchronous"),
+        clEnumValN(
+            BfsPlan::kSynchronousDirectOpt, "SyncDO",
+            "Synchronous direction-optimizing")),
     cll::init(BfsPlan::kSynchronousTile));
 
 std::string
@@ -83,6 +97,8 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "SyncTile";
   case BfsPlan::kSynchronous:
     return "Sync";
+  case BfsPlan::kSynchronousDirectOpt:
+    return "SyncDO";
   default:
     return "Unknown";
   }
@@ -143,6 +159,9 @@ main(int argc, char** argv) {
   case BfsPlan::kSynchronousTile:
     plan = BfsPlan::SynchronousTile();
     break;
+  case BfsPlan::kSynchronousDirectOpt:
+    plan = BfsPlan::SynchronousDirectOpt(alpha, beta);
+    break;
   }
 
   for (auto startNode : startNodes) {
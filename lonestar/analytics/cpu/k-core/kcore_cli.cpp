@@ -58,6 +58,12 @@ static cll::opt<uint32_t> kCoreNumber(
               "kCoreNumber value (default value 10)"),
     cll::init(10));
 
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the core number of every node instead of a single "
+              "k-core (default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KCorePlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -70,6 +76,43 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
   }
 }
 
+void
+RunDecomposition(katana::PropertyGraph* pg, const KCorePlan& plan) {
+  std::cout << "Running " << AlgorithmName(plan.algorithm())
+            << " decomposition\n";
+
+  katana::reportPageAlloc("MeminfoPre");
+  if (auto r = KCoreDecomposition(pg, "core-number", plan); !r) {
+    KATANA_LOG_FATAL("Failed to compute k-core decomposition: {}", r.error());
+  }
+  katana::reportPageAlloc("MeminfoPost");
+
+  auto stats_result = KCoreDecompositionStatistics::Compute(pg, "core-number");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute KCoreDecomposition statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (KCoreDecompositionAssertValid(pg, "core-number")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("core-number");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -92,10 +135,6 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  std::cout << "Running " << AlgorithmName(algo) << "\n";
-
-  katana::reportPageAlloc("MeminfoPre");
-
   KCorePlan plan = KCorePlan();
   switch (algo) {
   case KCorePlan::kSynchronous:
@@ -108,6 +147,16 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
+  if (decomposition) {
+    RunDecomposition(pg.get(), plan);
+    total_timer.stop();
+    return 0;
+  }
+
+  std::cout << "Running " << AlgorithmName(algo) << "\n";
+
+  katana::reportPageAlloc("MeminfoPre");
+
   if (auto r = KCore(pg.get(), kCoreNumber, "node-in-core", plan); !r) {
     KATANA_LOG_FATAL("Failed to compute k-core: {}", r.error());
   }
@@ -0,0 +1,69 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Yen k Simple Shortest Paths";
+static const char* desc =
+    "Computes the k shortest simple paths from a source to a sink node in a "
+    "directed graph";
+static const char* url = "yen_k_simple_shortest_paths";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<unsigned int> startNode(
+    "startNode", cll::desc("Node to start search from (default value 0)"),
+    cll::init(0));
+static cll::opt<unsigned int> reportNode(
+    "reportNode", cll::desc("Node to report paths to (default value 1)"),
+    cll::init(1));
+static cll::opt<unsigned int> stepShift(
+    "delta", cll::desc("Shift value for the deltastep (default value 13)"),
+    cll::init(KShortestPathsPlan::kDefaultDeltaShift));
+static cll::opt<unsigned int> numPaths(
+    "numPaths",
+    cll::desc("Number of paths to compute from source to report node (default "
+              "value 10)"),
+    cll::init(10));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  katana::reportPageAlloc("MeminfoPre");
+  auto result = KShortestSimplePaths(
+      pg.get(), edge_property_name, {{startNode, reportNode}}, numPaths,
+      KShortestPathsPlan::DeltaStep(stepShift));
+  if (!result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute k shortest simple paths: {}", result.error());
+  }
+  katana::reportPageAlloc("MeminfoPost");
+
+  std::cout << "Node " << reportNode << " has these k paths:\n";
+  for (const WeightedPath& path : result.value()[0]) {
+    for (uint32_t n : path.nodes) {
+      std::cout << " " << n;
+    }
+    std::cout << "\nWeight: " << path.weight << "\n";
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
@@ -46,12 +46,20 @@ static cll::opt<KTrussPlan::Algorithm> algo(
         clEnumValN(
             KTrussPlan::kBspJacobi, "BspJacobi",
             "Bulk-synchronous parallel with separated edge removal"),
-        clEnumValN(
-            KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel (default)"),
+        clEnumValN(KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel"),
         clEnumValN(
             KTrussPlan::kBspCoreThenTruss, "BspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
-    cll::init(KTrussPlan::kBsp));
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            KTrussPlan::kPeeling, "Peeling",
+            "Count support once and peel unsupported edges (default)")),
+    cll::init(KTrussPlan::kPeeling));
+
+static cll::opt<bool> decomposition(
+    "decomposition",
+    cll::desc("Compute the truss number of every edge instead of a single "
+              "k-truss (default value false)"),
+    cll::init(false));
 
 std::string
 AlgorithmName(KTrussPlan::Algorithm algorithm) {
@@ -62,11 +70,50 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
     return "BspJacobi";
   case KTrussPlan::kBspCoreThenTruss:
     return "BspCoreThenTruss";
+  case KTrussPlan::kPeeling:
+    return "Peeling";
   default:
     return "Unknown";
   }
 }
 
+void
+RunDecomposition(katana::PropertyGraph* pg) {
+  std::cout << "Running decomposition\n";
+
+  katana::reportPageAlloc("MeminfoPre");
+  if (auto r = KTrussDecomposition(pg, "truss-number"); !r) {
+    KATANA_LOG_FATAL("Failed to compute k-truss decomposition: {}", r.error());
+  }
+  katana::reportPageAlloc("MeminfoPost");
+
+  auto stats_result =
+      KTrussDecompositionStatistics::Compute(pg, "truss-number");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute KTrussDecomposition statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (KTrussDecompositionAssertValid(pg, "truss-number")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint32_t>("truss-number");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -93,6 +140,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (decomposition) {
+    RunDecomposition(pg.get());
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   katana::reportPageAlloc("MeminfoPre");
@@ -108,6 +161,9 @@ main(int argc, char** argv) {
   case KTrussPlan::kBspCoreThenTruss:
     plan = KTrussPlan::BspCoreThenTruss();
     break;
+  case KTrussPlan::kPeeling:
+    plan = KTrussPlan::Peeling();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
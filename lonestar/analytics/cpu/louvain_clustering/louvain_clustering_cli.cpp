@@ -42,6 +42,11 @@ static cll::opt<bool> enable_vf(
     "enable_vf", cll::desc("Flag to enable vertex following optimization."),
     cll::init(false));
 
+static cll::opt<bool> enable_pruning(
+    "enable_pruning",
+    cll::desc("Flag to only revisit nodes whose neighbors changed clusters."),
+    cll::init(false));
+
 static cll::opt<double> modularity_threshold_per_round(
     "modularity_threshold_per_round",
     cll::desc("Threshold for modularity gain"), cll::init(0.01));
@@ -105,7 +110,7 @@ main(int argc, char** argv) {
   case LouvainClusteringPlan::kDoAll:
     plan = LouvainClusteringPlan::DoAll(
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
-        max_iterations, min_graph_size);
+        max_iterations, min_graph_size, enable_pruning);
     break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
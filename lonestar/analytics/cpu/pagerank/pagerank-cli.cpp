@@ -46,10 +46,17 @@ static cll::opt<PagerankPlan::Algorithm> algo(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
+        clEnumValN(PagerankPlan::kPullBlocked, "PullBlocked", "PullBlocked"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<uint32_t> blockNodes(
+    "blockNodes",
+    cll::desc("Number of nodes whose ranks are read together, applies "
+              "PullBlocked only"),
+    cll::init(PagerankPlan::kDefaultBlockNodes));
+
 //! Flag that forces user to be aware that they should be passing in a
 //! transposed graph.
 static cll::opt<bool> transposedGraph(
@@ -62,7 +69,8 @@ main(int argc, char** argv) {
       LonestarStart(argc, argv, name, desc, url, &inputFile);
 
   if ((algo == PagerankPlan::kPullResidual ||
-       algo == PagerankPlan::kPullTopological) &&
+       algo == PagerankPlan::kPullTopological ||
+       algo == PagerankPlan::kPullBlocked) &&
       !transposedGraph) {
     KATANA_DIE(
         "This application requires a transposed graph input;"
@@ -85,7 +93,14 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
+  if (algo == PagerankPlan::kPullBlocked) {
+    // Blocking needs the in-neighbors of each node sorted
+    if (auto r = katana::SortAllEdgesByDest(pg.get()); !r) {
+      KATANA_LOG_FATAL("Failed to sort edges {}", r.error());
+    }
+  }
+
+  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha, blockNodes};
 
   if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
     KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
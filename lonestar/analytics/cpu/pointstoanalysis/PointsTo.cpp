@@ -17,13 +17,18 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include <deque>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 #include "Lonestar/BoilerPlate.h"
-#include "SparseBitVector.h"
+#include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/Reduction.h"
+#include "katana/SparseBitset.h"
 #include "llvm/Support/CommandLine.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,12 +44,6 @@ const char* desc =
 
 static cll::opt<std::string> inputFile(
     cll::Positional, cll::desc("<input file>"), cll::Required);
-static cll::opt<bool> useSerial(
-    "serial",
-    cll::desc("Runs serial version of the algorithm "
-              "(i.e. 1 thread, no katana::for_each) "
-              "(default false)"),
-    cll::init(false));
 
 static cll::opt<bool> printAnswer(
     "printAnswer",
@@ -52,21 +51,6 @@ static cll::opt<bool> printAnswer(
               "at the end"),
     cll::init(false));
 
-static cll::opt<bool> useCycleDetection(
-    "ocd",
-    cll::desc("If set, online cycle detection is"
-              " used in algorithm (serial only) "
-              "(default false)"),
-    cll::init(false));
-
-static cll::opt<unsigned> THRESHOLD_LS(
-    "lsThreshold",
-    cll::desc("Determines how many constraints to "
-              "process before load/store constraints "
-              "are reprocessed (serial only) "
-              "(default 500000)"),
-    cll::init(500000));
-
 ////////////////////////////////////////////////////////////////////////////////
 // Declaration of strutures, types, and variables
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,406 +110,364 @@ public:
 };
 
 /**
- * Points to analysis runner base class. Does not have a run method itself.
+ * Inclusion-based points-to analysis by wave propagation:
+ *
+ *   Fernando Magno Quintao Pereira and Daniel Berlin. Wave Propagation and
+ *   Deep Propagation for Pointer Analysis. CGO 2009.
+ *
+ * An edge from a to b in the constraint graph means b is a copy of a, so
+ * everything a points to b points to as well. Each round
+ *
+ *   1. collapses every cycle of the graph into one representative node,
+ *      since all nodes of a cycle end up pointing to the same things,
+ *   2. propagates points-to sets along the edges of the now acyclic graph
+ *      in topological order, in parallel over the nodes of a level, and
+ *   3. adds the edges implied by the load and store constraints for the
+ *      pointees found since the previous round, in parallel.
  *
- * @tparam IsConcurrent if set to true, the data structures used for points
- * to results and outgoing edges will be thread safe
+ * The analysis ends after the first round that adds no edge.
+ *
+ * Points-to sets are hash-consed in a SparseBitsetPool: nodes with equal
+ * points-to sets, which are common, share one copy, and the union of two
+ * sets is memoized, so propagating a set that has not changed is cheap.
  */
-template <bool IsConcurrent>
-class PTABase {
-  // sparse bit vector is concurrent or serial based on template parameter
-  using SparseBitVector = katana::SparseBitVector<IsConcurrent>;
-
+class PTA {
+  using Handle = katana::SparseBitsetPool::Handle;
   using PointsToConstraints = std::vector<PtsToCons>;
-  using PointsToInfo = std::vector<SparseBitVector>;
-  using EdgeVector = std::vector<SparseBitVector>;
-
-  using NodeAllocator =
-      katana::FixedSizeAllocator<typename SparseBitVector::Node>;
-
-protected:
-  PointsToInfo pointsToResult;  // pointsTo results for nodes
-  EdgeVector outgoingEdges;     // holds outgoing edges of a node
 
   PointsToConstraints addressCopyConstraints;
   PointsToConstraints loadStoreConstraints;
 
   size_t numNodes = 0;
 
-  ////////////////////////////////////////////////////////////////////////////////
+  katana::SparseBitsetPool pool;
+
+  //! The representative of each node, which a representative is of itself;
+  //! always at most one step away
+  std::vector<unsigned> representative;
+  //! The points-to set of each representative
+  std::vector<Handle> pointsTo;
+  //! The destinations of the edges from each representative
+  std::vector<katana::SparseBitset> outgoingEdges;
+  //! Nodes that must propagate their whole set along their edges, because
+  //! the set or the edges changed since the last propagation; a char rather
+  //! than a bool so that nodes can be updated in parallel
+  std::vector<char> dirty;
+  //! pointsTo of each node at the end of the last propagation
+  std::vector<Handle> propagated;
+  //! For each load/store constraint, the points-to set it was last
+  //! processed with
+  std::vector<Handle> processed;
+
+  // Scratch space of a round: the graph of representatives in compressed
+  // sparse row form, forwards and backwards
+  std::vector<uint64_t> succBegin;
+  std::vector<unsigned> succ;
+  std::vector<uint64_t> predBegin;
+  std::vector<unsigned> pred;
+
+  size_t numRounds = 0;
+  size_t numCollapsed = 0;
+
+  bool isRepresentative(unsigned n) const { return representative[n] == n; }
+
   /**
-   * Online Cycle Detection and elimination structure + functions.
+   * Rewrite the edges of every representative in terms of representatives,
+   * dropping self loops.
    */
-  struct OnlineCycleDetection {
-  private:
-    PTABase<IsConcurrent>&
-        outerPTA;  // reference to outer PTA instance to get runtime info
-
-    katana::gstl::Vector<unsigned>
-        ancestors;                       // TODO find better representation
-    katana::gstl::Vector<bool> visited;  // TODO use better representation
-    katana::gstl::Vector<unsigned> representative;
-
-    unsigned NoRepresentative;  // "constant" that represents no representative
-
-    /**
-     * @returns true of the nodeid is an ancestor node
-     * FIXME find better way to do this instead of linear scan
-     */
-    bool isAncestor(unsigned nodeid) {
-      for (unsigned ii : ancestors) {
-        if (ii == nodeid) {
-          return true;
-        }
-      }
-      return false;
-    }
-
-    /**
-     * Depth first recursion of the nodeid to see if it eventually
-     * reaches an ancestor, in which case there is a cycle. The cycle is
-     * then collapsed, i.e. all nodes in the cycle have their representative
-     * changed to the representative of the node where the cycle starts.
-     *
-     * Note it is okay not to detect all cycles as it is only an efficiency
-     * concern.
-     *
-     * @param nodeid nodeid to check the existance of a cycle
-     * @param cyclenode This is used as OUTPUT parameter; if a node is
-     * detected to be an ancestor, it is returned via this variable.
-     * @returns true if a cycle has been detected (i.e. a node has a path
-     * to an ancestor), false otherwise
-     */
-    bool cycleDetect(unsigned nodeID, unsigned& cycleNode) {
-      unsigned nodeRep = getFinalRepresentative(nodeID);
-
-      // if the node is an ancestor, that means there's a path from the ancestor
-      // to the ancestor (i.e. cycle)
-      if (isAncestor(nodeRep)) {
-        cycleNode = nodeRep;
-        return true;
-      }
+  void normalizeEdges() {
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t n) {
+          if (!isRepresentative(n)) {
+            return;
+          }
+          bool normal = true;
+          outgoingEdges[n].ForEach([&](unsigned dst) {
+            normal &= isRepresentative(dst) && dst != n;
+          });
+          if (normal) {
+            return;
+          }
+          katana::SparseBitset edges;
+          outgoingEdges[n].ForEach([&](unsigned dst) {
+            unsigned dstRepr = representative[dst];
+            if (dstRepr != n) {
+              edges.set(dstRepr);
+            }
+          });
+          outgoingEdges[n] = std::move(edges);
+        },
+        katana::steal(), katana::no_stats());
+  }
 
-      if (visited[nodeRep]) {
-        return false;
+  /**
+   * Build succBegin and succ from outgoingEdges, and predBegin and pred from
+   * those.
+   */
+  void buildAdjacency() {
+    succBegin.assign(numNodes + 1, 0);
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t n) { succBegin[n + 1] = outgoingEdges[n].count(); },
+        katana::no_stats());
+    std::partial_sum(succBegin.begin(), succBegin.end(), succBegin.begin());
+
+    succ.resize(succBegin[numNodes]);
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t n) {
+          uint64_t i = succBegin[n];
+          outgoingEdges[n].ForEach([&](unsigned dst) { succ[i++] = dst; });
+        },
+        katana::steal(), katana::no_stats());
+
+    predBegin.assign(numNodes + 1, 0);
+    for (unsigned dst : succ) {
+      ++predBegin[dst + 1];
+    }
+    std::partial_sum(predBegin.begin(), predBegin.end(), predBegin.begin());
+    pred.resize(succ.size());
+    std::vector<uint64_t> cursor(predBegin.begin(), predBegin.end() - 1);
+    for (size_t n = 0; n < numNodes; ++n) {
+      for (uint64_t e = succBegin[n]; e != succBegin[n + 1]; ++e) {
+        pred[cursor[succ[e]]++] = n;
       }
+    }
+  }
 
-      visited[nodeRep] = true;
-
-      // keep track of the current depth first search path
-      ancestors.push_back(nodeRep);
-
-      // don't use an iterator here because outgoing edges might get updated
-      // during this loop
-      std::vector<unsigned> repOutgoingEdges =
-          outerPTA.outgoingEdges[nodeRep].getAllSetBits();
+  /**
+   * Merge node into repr, which becomes its representative.
+   */
+  void merge(unsigned node, unsigned repr) {
+    representative[node] = repr;
+    pointsTo[repr] = pool.Union(pointsTo[repr], pointsTo[node]);
+    outgoingEdges[repr].UnionWith(outgoingEdges[node]);
+    outgoingEdges[node] = katana::SparseBitset();
+    pointsTo[node] = pool.Empty();
+    dirty[repr] = true;
+    ++numCollapsed;
+  }
 
-      for (auto dst : repOutgoingEdges) {
-        // recursive depth first cycle detection; if a cycle is found,
-        // collapse the path
-        if (cycleDetect(dst, cycleNode)) {
-          cycleCollapse(cycleNode);
-        }
+  /**
+   * Collapse the strongly connected components of the graph of
+   * representatives with Tarjan's algorithm, iteratively to bound the stack.
+   *
+   * @returns the representatives in topological order
+   */
+  std::vector<unsigned> collapseCycles() {
+    constexpr unsigned kUnvisited = ~0U;
+    std::vector<unsigned> index(numNodes, kUnvisited);
+    std::vector<unsigned> lowLink(numNodes);
+    std::vector<char> onStack(numNodes, false);
+    std::vector<unsigned> sccStack;
+    std::vector<std::pair<unsigned, uint64_t>> callStack;
+    std::vector<unsigned> order;
+    unsigned nextIndex = 0;
+
+    for (unsigned root = 0; root < numNodes; ++root) {
+      if (!isRepresentative(root) || index[root] != kUnvisited) {
+        continue;
       }
-      ancestors.pop_back();
-
-      return false;
-    }
-
-    /**
-     * Make all nodes that are a part of some detected cycle starting at
-     * repr have their representatives changed to the representative of
-     * repr (thereby "collapsing" the cycle).
-     *
-     * @param repr The node at which the cycle begins
-     */
-    void cycleCollapse(unsigned repr) {
-      // assert(repr is present in ancestors).
-      unsigned repToChangeTo = getFinalRepresentative(repr);
-
-      for (auto ii = ancestors.begin(); ii != ancestors.end(); ++ii) {
-        if (*ii == repr) {
-          katana::gDebug("collapsing cycle for ", repr);
-          // cycle exists between nodes ancestors[*ii..end].
-          for (auto jj = ii; jj != ancestors.end(); ++jj) {
-            // jjRepr has no representative.
-            unsigned jjRepr = getFinalRepresentative(*jj);
-            makeRepr(jjRepr, repToChangeTo);
+      callStack.emplace_back(root, succBegin[root]);
+      index[root] = lowLink[root] = nextIndex++;
+      sccStack.push_back(root);
+      onStack[root] = true;
+
+      while (!callStack.empty()) {
+        auto& [node, e] = callStack.back();
+        if (e != succBegin[node + 1]) {
+          unsigned dst = succ[e++];
+          if (index[dst] == kUnvisited) {
+            index[dst] = lowLink[dst] = nextIndex++;
+            sccStack.push_back(dst);
+            onStack[dst] = true;
+            callStack.emplace_back(dst, succBegin[dst]);
+          } else if (onStack[dst]) {
+            lowLink[node] = std::min(lowLink[node], index[dst]);
           }
-
-          break;
+          continue;
         }
-      }
-    }
 
-    /**
-     * Make repr the representative of nodeID.
-     *
-     * @param nodeID node to change the representative of
-     * @param repr nodeID will have its representative changed to this
-     */
-    void makeRepr(unsigned nodeID, unsigned repr) {
-      if (repr != nodeID) {
-        katana::gDebug("change repr[", nodeID, "] = ", repr);
-
-        representative[nodeID] = repr;
-
-        // the representative needs to have all of the items that the nodes
-        // it is representing has, so if the node has more than the rep,
-        // unify
-        if (!outerPTA.pointsToResult[nodeID].isSubsetEq(
-                outerPTA.pointsToResult[repr])) {
-          outerPTA.pointsToResult[repr].unify(outerPTA.pointsToResult[nodeID]);
+        unsigned finished = node;
+        callStack.pop_back();
+        if (!callStack.empty()) {
+          unsigned parent = callStack.back().first;
+          lowLink[parent] = std::min(lowLink[parent], lowLink[finished]);
         }
-
-        // unify edges as well if necessary since rep represents it now
-        if (!outerPTA.outgoingEdges[nodeID].isSubsetEq(
-                outerPTA.outgoingEdges[repr])) {
-          outerPTA.outgoingEdges[repr].unify(outerPTA.outgoingEdges[nodeID]);
+        if (lowLink[finished] != index[finished]) {
+          continue;
         }
+        // finished is the root of a component: the nodes above it on the
+        // stack
+        unsigned member;
+        do {
+          member = sccStack.back();
+          sccStack.pop_back();
+          onStack[member] = false;
+          if (member != finished) {
+            merge(member, finished);
+          }
+        } while (member != finished);
+        order.push_back(finished);
       }
     }
 
-  public:
-    OnlineCycleDetection(PTABase<IsConcurrent>& o) : outerPTA(o) {}
-
-    /**
-     * Init fields (outerPTA needs to have numNodes set).
-     */
-    void init() {
-      NoRepresentative = outerPTA.numNodes;
-      visited.resize(outerPTA.numNodes);
-      representative.resize(outerPTA.numNodes);
+    // Components finish after all components they reach
+    std::reverse(order.begin(), order.end());
 
-      for (unsigned ii = 0; ii < outerPTA.numNodes; ++ii) {
-        representative[ii] = NoRepresentative;
-      }
+    // Nodes merged in earlier rounds may point to nodes merged now
+    for (unsigned n = 0; n < numNodes; ++n) {
+      representative[n] = representative[representative[n]];
     }
+    return order;
+  }
 
-    /**
-     * Given a node id, find its representative. Also, do path compression
-     * of the path to the representative.
-     *
-     * @param nodeid Node id to get the representative of
-     * @returns The representative of nodeid
-     */
-    unsigned getFinalRepresentative(unsigned nodeid) {
-      unsigned finalRep = nodeid;
-
-      // follow chain of representatives until a "root" is reached
-      while (representative[finalRep] != NoRepresentative) {
-        finalRep = representative[finalRep];
-      }
-
-      // path compression; make all things along path to final representative
-      // point to the final representative
-      unsigned curRep = representative[nodeid];
-
-      while (curRep != NoRepresentative) {
-        representative[nodeid] = finalRep;
-        nodeid = curRep;
-        curRep = representative[nodeid];
+  /**
+   * Propagate points-to sets along all edges, a level of the acyclic graph
+   * of representatives at a time. A node pulls the sets of its dirty
+   * predecessors; the sets of the other predecessors are already included.
+   */
+  void propagate(const std::vector<unsigned>& order) {
+    // The level of a node is the length of the longest path to it, so its
+    // predecessors are all at lower levels
+    std::vector<unsigned> level(numNodes, 0);
+    unsigned numLevels = 0;
+    for (unsigned n : order) {
+      numLevels = std::max(numLevels, level[n] + 1);
+      for (uint64_t e = succBegin[n]; e != succBegin[n + 1]; ++e) {
+        level[succ[e]] = std::max(level[succ[e]], level[n] + 1);
       }
-
-      return finalRep;
     }
-
-    /**
-     * Go over all sources of new edges to see if there are cycles in them.
-     * If so, collapse the cycles.
-     *
-     * @param updates vector of nodes that are sources of new edges.
-     */
-    template <typename VecType>
-    void process(VecType& updates) {
-      if (!useCycleDetection) {
-        return;
-      }
-
-      // TODO this can probably be made more efficient (fill?)
-      for (unsigned ii = 0; ii < outerPTA.numNodes; ++ii) {
-        visited[ii] = false;
-      }
-
-      unsigned cycleNode = NoRepresentative;  // set to invalid id.
-
-      for (unsigned update : updates) {
-        katana::gDebug("cycle process ", update);
-
-        if (cycleDetect(update, cycleNode)) {
-          cycleCollapse(cycleNode);
-        }
-      }
+    std::vector<uint64_t> levelBegin(numLevels + 1, 0);
+    for (unsigned n : order) {
+      ++levelBegin[level[n] + 1];
+    }
+    std::partial_sum(levelBegin.begin(), levelBegin.end(), levelBegin.begin());
+    std::vector<unsigned> byLevel(order.size());
+    std::vector<uint64_t> cursor(levelBegin.begin(), levelBegin.end() - 1);
+    for (unsigned n : order) {
+      byLevel[cursor[level[n]]++] = n;
     }
-  };  // end struct OnlineCycleDetection
-  ////////////////////////////////////////////////////////////////////////////////
-
-  OnlineCycleDetection ocd;  // cycle detector/squasher; only works with serial
-
-  /**
-   * Adds edges to the graph based on load/store constraints.
-   *
-   * A load from src -> dst means anything that src points to must also
-   * point to dst.
-   *
-   * A store from src -> dst means src must point to anything
-   * that dst points to.
-   *
-   * Any updated nodes are returned in the updates vector.
-   *
-   * @tparam LoopInvoker Functor that will run the loop
-   * @tparam VecType object that supports a push_back function that represents
-   * nodes to be worked on
-   *
-   * @param constraints Load/store constraints to use to add edges
-   * @param updates output variable that will have updated nodes added to it
-   */
-  template <typename LoopInvoker, typename VecType>
-  void processLoadStore(
-      const PointsToConstraints& constraints, VecType& updates) {
-    LoopInvoker()(katana::iterate(constraints), [&](auto constraint) {
-      unsigned src;
-      unsigned dst;
-      std::tie(src, dst) = constraint.getSrcDst();
-
-      unsigned srcRepr = ocd.getFinalRepresentative(src);
-      unsigned dstRepr = ocd.getFinalRepresentative(dst);
-
-      if (constraint.getType() == PtsToCons::Load) {
-        for (auto pointee = pointsToResult[srcRepr].begin();
-             pointee != pointsToResult[srcRepr].end(); pointee++) {
-          unsigned pointeeRepr = ocd.getFinalRepresentative(*pointee);
-
-          // add edge from pointee to dst if it doesn't already exist
-          if (pointeeRepr != dstRepr &&
-              !outgoingEdges[pointeeRepr].test(dstRepr)) {
-            outgoingEdges[pointeeRepr].set(dstRepr);
-
-            updates.push_back(pointeeRepr);
-          }
-        }
-      } else {  // store whatever src has into whatever dst points to
-        bool newEdgeAdded = false;
-
-        for (auto pointee = pointsToResult[dstRepr].begin();
-             pointee != pointsToResult[dstRepr].end(); pointee++) {
-          unsigned pointeeRepr = ocd.getFinalRepresentative(*pointee);
-
-          // add edge from src -> pointee if it doesn't exist
-          if (srcRepr != pointeeRepr &&
-              !outgoingEdges[srcRepr].test(pointeeRepr)) {
-            outgoingEdges[srcRepr].set(pointeeRepr);
 
-            newEdgeAdded = true;
-          }
-        }
+    for (unsigned l = 0; l < numLevels; ++l) {
+      katana::do_all(
+          katana::iterate(
+              byLevel.begin() + levelBegin[l],
+              byLevel.begin() + levelBegin[l + 1]),
+          [&](unsigned n) {
+            Handle set = pointsTo[n];
+            for (uint64_t e = predBegin[n]; e != predBegin[n + 1]; ++e) {
+              if (dirty[pred[e]]) {
+                set = pool.Union(set, pointsTo[pred[e]]);
+              }
+            }
+            pointsTo[n] = set;
+            if (set != propagated[n]) {
+              dirty[n] = true;
+            }
+          },
+          katana::steal(), katana::loopname("PointsToPropagate"));
+    }
 
-        if (newEdgeAdded) {
-          updates.push_back(srcRepr);
-        }
-      }
-    });
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t n) {
+          propagated[n] = pointsTo[n];
+          dirty[n] = false;
+        },
+        katana::no_stats());
   }
 
   /**
-   * Processes the AddressOf, Copy constraints.
-   *
-   * Sets the bitvector for AddressOf constraints, i.e. a set bit means
-   * that you point to whatever that bit represents.
+   * Add the edges implied by the load/store constraints for the pointees
+   * found since each constraint was last processed.
    *
-   * Creates edges for Copy constraints, i.e. edge from a to b indicates
-   * b is a copy of a.
+   * A load from src to dst means dst is a copy of anything src points to.
    *
-   * @tparam LoopInvoker Functor that will run the loop
-   * @tparam VecType object that supports a push_back function as well
-   * as iteration over pushed objects
-   *
-   * @param constraints vector of AddressOf and Copy constraints
-   * @returns vector of UpdatesRequests from all sources with new edges
-   * added by the Copy constraint
-   */
-  template <typename LoopInvoker, typename VecType>
-  VecType processAddressOfCopy(const PointsToConstraints& constraints) {
-    VecType updates;
-
-    LoopInvoker()(katana::iterate(constraints), [&](auto ii) {
-      unsigned src;
-      unsigned dst;
-
-      std::tie(src, dst) = ii.getSrcDst();
-
-      if (ii.getType() == PtsToCons::AddressOf) {  // addressof; save point info
-        pointsToResult[dst].set(src);
-      } else if (src != dst) {  // copy constraint; add an edge
-        outgoingEdges[src].set(dst);
-        updates.push_back(src);
-      }
-    });
-
-    return updates;
-  }
-
-  /**
-   * If an edge exists from src to dst, then dst is a copy of src.
-   * Propogate any points to information from source to dest.
+   * A store from src to dst means anything dst points to is a copy of src.
    *
-   * @param src Source node in graph
-   * @param dst Dest node in graph
-   * @returns non-negative value if any bitvector has changed
+   * @returns true if an edge was added
    */
-  unsigned propagate(unsigned src, unsigned dst) {
-    unsigned newPtsTo = 0;
-
-    if (src != dst) {
-      unsigned srcRepr = ocd.getFinalRepresentative(src);
-      unsigned dstRepr = ocd.getFinalRepresentative(dst);
-
-      // if src is a not subset of dst... (i.e. src has more), then
-      // propogate src's points to info to dst
-      if (srcRepr != dstRepr &&
-          !pointsToResult[srcRepr].isSubsetEq(pointsToResult[dstRepr])) {
-        // katana::gDebug("unifying ", dstRepr, " by ", srcRepr);
-        // newPtsTo is positive if changes are made
-        newPtsTo += pointsToResult[dstRepr].unify(pointsToResult[srcRepr]);
+  bool processLoadStore() {
+    katana::InsertBag<std::pair<unsigned, unsigned>> newEdges;
+    katana::do_all(
+        katana::iterate(size_t{0}, loadStoreConstraints.size()),
+        [&](size_t c) {
+          const PtsToCons& constraint = loadStoreConstraints[c];
+          auto [src, dst] = constraint.getSrcDst();
+          unsigned srcRepr = representative[src];
+          unsigned dstRepr = representative[dst];
+          bool isLoad = constraint.getType() == PtsToCons::Load;
+
+          Handle current = pointsTo[isLoad ? srcRepr : dstRepr];
+          if (current == processed[c]) {
+            return;
+          }
+          katana::SparseBitset pointees = *current;
+          pointees.DifferenceWith(*processed[c]);
+          processed[c] = current;
+
+          pointees.ForEach([&](unsigned pointee) {
+            unsigned pointeeRepr = representative[pointee];
+            if (isLoad) {
+              if (pointeeRepr != dstRepr &&
+                  !outgoingEdges[pointeeRepr].test(dstRepr)) {
+                newEdges.push(std::make_pair(pointeeRepr, dstRepr));
+              }
+            } else if (
+                pointeeRepr != srcRepr &&
+                !outgoingEdges[srcRepr].test(pointeeRepr)) {
+              newEdges.push(std::make_pair(srcRepr, pointeeRepr));
+            }
+          });
+        },
+        katana::steal(), katana::loopname("PointsToLoadStore"));
+
+    bool added = false;
+    for (auto [src, dst] : newEdges) {
+      if (outgoingEdges[src].set(dst)) {
+        dirty[src] = true;
+        added = true;
       }
     }
-
-    return newPtsTo;
+    return added;
   }
 
 public:
-  PTABase() : ocd(*this) {}
-
   /**
    * Given the number of nodes in the constraint graph, initialize the
-   * structures needed for the points-to algorithm.
+   * points-to sets and edges from the address-of and copy constraints.
    *
    * @param n Number of nodes in the constraint graph
-   * @param nodeAllocator galois allocator object to allocate nodes in the
-   * sparse bit vector
    */
-  void initialize(size_t n, NodeAllocator& nodeAllocator) {
+  void initialize(size_t n) {
     numNodes = n;
 
-    // initialize different constructs based on which version is being run
-    pointsToResult.resize(numNodes);
+    representative.resize(numNodes);
+    for (unsigned i = 0; i < numNodes; ++i) {
+      representative[i] = i;
+    }
     outgoingEdges.resize(numNodes);
-
-    // initialize vectors
-    for (unsigned i = 0; i < numNodes; i++) {
-      pointsToResult[i].init(&nodeAllocator);
-      outgoingEdges[i].init(&nodeAllocator);
+    dirty.assign(numNodes, true);
+    propagated.assign(numNodes, pool.Empty());
+    processed.assign(loadStoreConstraints.size(), pool.Empty());
+
+    std::vector<katana::SparseBitset> addressOf(numNodes);
+    for (const PtsToCons& constraint : addressCopyConstraints) {
+      auto [src, dst] = constraint.getSrcDst();
+      if (constraint.getType() == PtsToCons::AddressOf) {
+        addressOf[dst].set(src);
+      } else if (src != dst) {
+        outgoingEdges[src].set(dst);
+      }
     }
 
-    ocd.init();
-  }
-
-  //! frees memory allocated by the node allocator
-  void freeNodeAllocatorMemory() {
-    for (unsigned i = 0; i < numNodes; i++) {
-      pointsToResult[i].freeAll();
-      outgoingEdges[i].freeAll();
-    }
+    pointsTo.resize(numNodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t i) { pointsTo[i] = pool.Intern(std::move(addressOf[i])); },
+        katana::steal(), katana::no_stats());
   }
 
   /**
@@ -591,6 +533,36 @@ public:
     return numNodes;
   }
 
+  /**
+   * Run rounds of cycle collapsing, propagation and load/store processing
+   * until no edge is added.
+   */
+  void run() {
+    katana::gDebug(
+        "no of addr+copy constraints = ", addressCopyConstraints.size(),
+        ", no of load+store constraints = ", loadStoreConstraints.size());
+    katana::gDebug("no of nodes = ", numNodes);
+
+    do {
+      ++numRounds;
+      normalizeEdges();
+      buildAdjacency();
+      size_t collapsedBefore = numCollapsed;
+      std::vector<unsigned> order = collapseCycles();
+      if (numCollapsed != collapsedBefore) {
+        normalizeEdges();
+        buildAdjacency();
+      }
+      propagate(order);
+      katana::gDebug("No of points-to facts computed = ", countPointsToFacts());
+    } while (processLoadStore());
+
+    katana::ReportStatSingle("PointsTo", "Rounds", numRounds);
+    katana::ReportStatSingle("PointsTo", "CollapsedNodes", numCollapsed);
+    katana::ReportStatSingle("PointsTo", "DistinctPointsToSets", pool.size());
+    katana::ReportStatSingle("PointsTo", "PointsToBlocks", pool.num_blocks());
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   // Debugging/output functions
   //////////////////////////////////////////////////////////////////////////////
@@ -607,51 +579,59 @@ public:
   }
 
   /**
-   * Checks to make sure that all representative point to at LEAST
-   * what the nodes that it represents are pointing to. Necessary but not
-   * sufficient check for correctness.
+   * Checks that the points-to sets satisfy every constraint.
    */
-  void checkReprPointsTo() {
-    for (unsigned ii = 0; ii < pointsToResult.size(); ++ii) {
-      unsigned repr = ocd.getFinalRepresentative(ii);
-      if (repr != ii && !pointsToResult[ii].isSubsetEq(pointsToResult[repr])) {
-        katana::gError(
-            "pointsto(", ii,
-            ") is not less than its "
-            "representative pointsto(",
-            repr, ").");
-      }
-    }
-  }
+  void checkSolution() {
+    auto pts = [&](unsigned n) -> const katana::SparseBitset& {
+      return *pointsTo[representative[n]];
+    };
+    katana::GAccumulator<size_t> violations;
+
+    katana::do_all(
+        katana::iterate(addressCopyConstraints),
+        [&](const PtsToCons& constraint) {
+          auto [src, dst] = constraint.getSrcDst();
+          if (constraint.getType() == PtsToCons::AddressOf
+                  ? !pts(dst).test(src)
+                  : !pts(src).IsSubsetOf(pts(dst))) {
+            violations += 1;
+          }
+        },
+        katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(loadStoreConstraints),
+        [&](const PtsToCons& constraint) {
+          auto [src, dst] = constraint.getSrcDst();
+          if (constraint.getType() == PtsToCons::Load) {
+            pts(src).ForEach([&](unsigned pointee) {
+              if (!pts(pointee).IsSubsetOf(pts(dst))) {
+                violations += 1;
+              }
+            });
+          } else {
+            pts(dst).ForEach([&](unsigned pointee) {
+              if (!pts(src).IsSubsetOf(pts(pointee))) {
+                violations += 1;
+              }
+            });
+          }
+        },
+        katana::steal(), katana::no_stats());
 
-  /**
-   * Makes sure that the representative of a set of nodes has all of the
-   * edges that the nodes it is representing has.
-   */
-  void checkReprEdges() {
-    for (unsigned ii = 0; ii < outgoingEdges.size(); ++ii) {
-      unsigned repr = ocd.getFinalRepresentative(ii);
-      if (repr != ii && !outgoingEdges[ii].isSubsetEq(outgoingEdges[repr])) {
-        katana::gError(
-            "edges(", ii,
-            ") is not less than its "
-            "representative edges(",
-            repr, ").");
-      }
+    if (violations.reduce() != 0) {
+      katana::gError(violations.reduce(), " constraints are not satisfied.");
     }
   }
 
   /**
    * @returns The total number of points to facts in the system.
    */
-  unsigned countPointsToFacts() {
-    unsigned count = 0;
-
-    for (auto ii = pointsToResult.begin(); ii != pointsToResult.end(); ++ii) {
-      unsigned repr = ocd.getFinalRepresentative(ii - pointsToResult.begin());
-      count += pointsToResult[repr].count();
+  size_t countPointsToFacts() {
+    size_t count = 0;
+    for (unsigned n = 0; n < numNodes; ++n) {
+      count += pointsTo[representative[n]]->count();
     }
-
     return count;
   }
 
@@ -661,124 +641,29 @@ public:
   void printPointsToInfo() {
     std::string prefix = "v";
 
-    for (auto ii = pointsToResult.begin(); ii != pointsToResult.end(); ++ii) {
-      std::cerr << prefix << ii - pointsToResult.begin() << ": ";
-      unsigned repr = ocd.getFinalRepresentative(ii - pointsToResult.begin());
-      pointsToResult[repr].print(std::cerr, prefix);
+    for (unsigned n = 0; n < numNodes; ++n) {
+      const katana::SparseBitset& set = *pointsTo[representative[n]];
+      std::cerr << prefix << n << ": ";
+      std::cerr << "Elements(" << set.count() << "): ";
+      set.ForEach([&](unsigned pointee) {
+        std::cerr << prefix << pointee << ", ";
+      });
+      std::cerr << "\n";
     }
   }
 };  // end class PTA
 
-/**
- * Serial points to executor.
- */
-class PTASerial : public PTABase<false> {
-public:
-  /**
-   * Run points-to-analysis on a single thread.
-   */
-  void run() {
-    katana::gDebug(
-        "no of addr+copy constraints = ", addressCopyConstraints.size(),
-        ", no of load+store constraints = ", loadStoreConstraints.size());
-    katana::gDebug("no of nodes = ", numNodes);
-
-    std::deque<unsigned> updates;
-    updates = processAddressOfCopy<katana::StdForEach, std::deque<unsigned>>(
-        addressCopyConstraints);
-    processLoadStore<katana::StdForEach>(loadStoreConstraints, updates);
-
-    unsigned numUps = 0;
-
-    // FIFO
-    while (!updates.empty()) {
-      unsigned src = updates.front();
-      updates.pop_front();
-
-      for (auto dst = outgoingEdges[src].begin();
-           dst != outgoingEdges[src].end(); dst++) {
-        unsigned newPtsTo = propagate(src, *dst);
-
-        if (newPtsTo) {  // newPtsTo is positive if dst changed
-          updates.push_back(ocd.getFinalRepresentative(*dst));
-        }
-
-        numUps++;
-      }
-
-      if (updates.empty() || numUps >= THRESHOLD_LS) {
-        katana::gDebug(
-            "No of points-to facts computed = ", countPointsToFacts());
-        numUps = 0;
-
-        // After propagating all constraints, see if load/store
-        // constraints need to be added in since graph was potentially updated
-        processLoadStore<katana::StdForEach>(loadStoreConstraints, updates);
-
-        // do cycle squashing
-        ocd.process(updates);
-      }
-    }
-  }
-};
-
-/**
- * Concurrent points to executor.
- */
-class PTAConcurrent : public PTABase<true> {
-public:
-  /**
-   * Run points-to-analysis using katana::for_each as the main loop.
-   */
-  void run() {
-    katana::gDebug(
-        "no of addr+copy constraints = ", addressCopyConstraints.size(),
-        ", no of load+store constraints = ", loadStoreConstraints.size());
-    katana::gDebug("no of nodes = ", numNodes);
-
-    katana::InsertBag<unsigned> updates;
-    updates = processAddressOfCopy<katana::DoAll, katana::InsertBag<unsigned>>(
-        addressCopyConstraints);
-    processLoadStore<katana::DoAll>(loadStoreConstraints, updates);
-
-    while (!updates.empty()) {
-      katana::for_each(
-          katana::iterate(updates),
-          [this](unsigned req, auto& ctx) {
-            for (auto dst = this->outgoingEdges[req].begin();
-                 dst != this->outgoingEdges[req].end(); dst++) {
-              unsigned newPtsTo = this->propagate(req, *dst);
-
-              if (newPtsTo)
-                ctx.push(this->ocd.getFinalRepresentative(*dst));
-            }
-          },
-          katana::loopname("PointsToMainUpdateLoop"),
-          katana::disable_conflict_detection(),
-          katana::wl<katana::PerSocketChunkFIFO<8>>());
-
-      katana::gDebug("No of points-to facts computed = ", countPointsToFacts());
-
-      updates.clear();
-
-      // After propagating all constraints, see if load/store constraints need
-      // to be added in since graph was potentially updated
-      processLoadStore<katana::DoAll>(loadStoreConstraints, updates);
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
 
-      // do cycle squashing
-      // ocd.process(updates); // TODO have parallel OCD, if possible
-    }
-  }
-};
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
 
-/**
- * Method from running PTA.
- */
-template <typename PTAClass, typename Alloc>
-void
-runPTA(PTAClass& pta, Alloc& nodeAllocator) {
+  PTA pta;
   size_t numNodes = pta.readConstraints(inputFile.c_str());
-  pta.initialize(numNodes, nodeAllocator);
+  pta.initialize(numNodes);
 
   katana::StatTimer execTime("Timer_0");
 
@@ -790,51 +675,13 @@ runPTA(PTAClass& pta, Alloc& nodeAllocator) {
 
   if (!skipVerify) {
     katana::gInfo("Doing verification step");
-    pta.checkReprPointsTo();
-    pta.checkReprEdges();
+    pta.checkSolution();
   }
 
   if (printAnswer) {
     pta.printPointsToInfo();
   }
 
-  // free everything nodeallocator allocated
-  pta.freeNodeAllocatorMemory();
-}
-
-int
-main(int argc, char** argv) {
-  std::unique_ptr<katana::SharedMemSys> G =
-      LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
-
-  katana::StatTimer totalTime("TimerTotal");
-  totalTime.start();
-
-  // depending on serial or concurrent, create the correct class and pass it
-  // into the run harness which takes care of the rest
-  if (!useSerial) {
-    katana::gInfo(
-        "-------- Parallel version: ", katana::getActiveThreads(), " threads.");
-    katana::gInfo(
-        "Note correctness of this version is relative to the serial "
-        "version.");
-
-    PTAConcurrent p;
-    katana::FixedSizeAllocator<typename katana::SparseBitVector<true>::Node>
-        nodeAllocator;
-    runPTA(p, nodeAllocator);
-  } else {
-    katana::gInfo("-------- Sequential version.");
-    katana::gInfo(
-        "The load store threshold (-lsThreshold) may need tweaking for "
-        "best performance; its current setting may not be the best for "
-        "your input and may actually degrade performance.");
-    PTASerial p;
-    katana::FixedSizeAllocator<typename katana::SparseBitVector<false>::Node>
-        nodeAllocator;
-    runPTA(p, nodeAllocator);
-  }
-
   totalTime.stop();
 
   return 0;
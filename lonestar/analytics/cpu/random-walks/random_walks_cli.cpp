@@ -69,6 +69,12 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<uint64_t> secondOrderTableBytes(
+    "secondOrderTableBytes",
+    cll::desc("Memory budget in bytes for precomputed second-order sampling "
+              "tables (only for Node2Vec)"),
+    cll::init(RandomWalksPlan::kDefaultSecondOrderTableBytes));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -125,7 +131,8 @@ main(int argc, char** argv) {
   switch (algo) {
   case RandomWalksPlan::kNode2Vec:
     plan = RandomWalksPlan::Node2Vec(
-        walkLength, numberOfWalks, backwardProbability, forwardProbability);
+        walkLength, numberOfWalks, backwardProbability, forwardProbability,
+        secondOrderTableBytes);
     break;
   case RandomWalksPlan::kEdge2Vec:
     plan = RandomWalksPlan::Edge2Vec(
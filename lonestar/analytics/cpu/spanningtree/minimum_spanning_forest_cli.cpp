@@ -0,0 +1,114 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Minimum Spanning Forest";
+static const char* desc = "Computes the minimum spanning forest of a graph";
+static const char* url = "mst";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<MinimumSpanningForestPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            MinimumSpanningForestPlan::kBoruvka, "Boruvka",
+            "Boruvka's algorithm"),
+        clEnumValN(
+            MinimumSpanningForestPlan::kFilterKruskal, "FilterKruskal",
+            "Filter-Kruskal (default)")),
+    cll::init(MinimumSpanningForestPlan::kFilterKruskal));
+
+static cll::opt<uint32_t> kruskalThreshold(
+    "kruskalThreshold",
+    cll::desc("Number of edges under which FilterKruskal sorts instead of "
+              "partitioning (default value 65536)"),
+    cll::init(MinimumSpanningForestPlan::kDefaultKruskalThreshold));
+
+std::string
+AlgorithmName(MinimumSpanningForestPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    return "Boruvka";
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    return "FilterKruskal";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << "\n";
+
+  MinimumSpanningForestPlan plan;
+  switch (algo) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    plan = MinimumSpanningForestPlan::Boruvka();
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    plan = MinimumSpanningForestPlan::FilterKruskal(kruskalThreshold);
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  katana::reportPageAlloc("MeminfoPre");
+  if (auto r = MinimumSpanningForest(
+          pg.get(), edge_property_name, "in-forest", plan);
+      !r) {
+    KATANA_LOG_FATAL(
+        "Failed to compute minimum spanning forest: {}", r.error());
+  }
+  katana::reportPageAlloc("MeminfoPost");
+
+  auto stats_result = MinimumSpanningForestStatistics::Compute(
+      pg.get(), edge_property_name, "in-forest");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute MinimumSpanningForest statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (MinimumSpanningForestAssertValid(
+            pg.get(), edge_property_name, "in-forest")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint8_t>("in-forest");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
@@ -82,7 +82,13 @@ cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(SsspPlan::kTopologicalTile, "TopoTile", "Topological tiled"),
         clEnumValN(
             SsspPlan::kAutomatic, "Automatic",
-            "Automatic: choose among the algorithms automatically")),
+            "Automatic: choose among the algorithms automatically"),
+        clEnumValN(
+            SsspPlan::kDeltaStepAdaptive, "DeltaStepAdaptive",
+            "Delta stepping with a self-tuning delta"),
+        clEnumValN(
+            SsspPlan::kMultiQueue, "MultiQueue",
+            "Dijkstra's algorithm on a relaxed concurrent priority queue")),
     cll::init(SsspPlan::kAutomatic));
 
 //TODO (gill) Remove snippets from documentation
@@ -112,6 +118,10 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "TopologicalTile";
   case SsspPlan::kAutomatic:
     return "Automatic";
+  case SsspPlan::kDeltaStepAdaptive:
+    return "DeltaStepAdaptive";
+  case SsspPlan::kMultiQueue:
+    return "MultiQueue";
   default:
     return "Unknown";
   }
@@ -218,6 +228,12 @@ main(int argc, char** argv) {
   case SsspPlan::kAutomatic:
     plan = SsspPlan();
     break;
+  case SsspPlan::kDeltaStepAdaptive:
+    plan = SsspPlan::DeltaStepAdaptive();
+    break;
+  case SsspPlan::kMultiQueue:
+    plan = SsspPlan::MultiQueue();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm selected");
   }
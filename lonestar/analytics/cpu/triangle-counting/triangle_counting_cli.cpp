@@ -40,7 +40,13 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kEdgeSampling, "edgeSampling",
+            "Estimate by counting on a sample of edges"),
+        clEnumValN(
+            TriangleCountPlan::kWedgeSampling, "wedgeSampling",
+            "Estimate by sampling wedges")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
 static cll::opt<bool> relabel(
@@ -48,6 +54,25 @@ static cll::opt<bool> relabel(
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<double> edgeProbability(
+    "edgeProbability",
+    cll::desc("Probability of keeping an edge for edgeSampling"),
+    cll::init(TriangleCountPlan::kDefaultEdgeProbability));
+
+static cll::opt<double> relativeError(
+    "relativeError",
+    cll::desc("Target relative standard error for wedgeSampling"),
+    cll::init(TriangleCountPlan::kDefaultRelativeError));
+
+static cll::opt<double> timeBudget(
+    "timeBudget", cll::desc("Maximum seconds to sample for wedgeSampling"),
+    cll::init(TriangleCountPlan::kDefaultTimeBudgetSeconds));
+
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed for the sampling algorithms"),
+    cll::init(TriangleCountPlan::kDefaultSeed));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -85,10 +110,33 @@ main(int argc, char** argv) {
     plan = TriangleCountPlan::OrderedCount(relabeling_flag);
     break;
 
+  case TriangleCountPlan::kEdgeSampling:
+    plan = TriangleCountPlan::EdgeSampling(
+        edgeProbability, TriangleCountPlan::kDefaultEdgeSorted, seed);
+    break;
+
+  case TriangleCountPlan::kWedgeSampling:
+    plan = TriangleCountPlan::WedgeSampling(
+        relativeError, timeBudget, TriangleCountPlan::kDefaultEdgeSorted, seed);
+    break;
+
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
 
+  if (plan.is_approximate()) {
+    auto estimate_result = EstimateTriangleCount(pg.get(), plan);
+    if (!estimate_result) {
+      KATANA_LOG_FATAL("failed to run algorithm: {}", estimate_result.error());
+    }
+    const TriangleCountEstimate& estimate = estimate_result.value();
+    std::cout << "EstimatedTriangles: " << estimate.triangles << "\n";
+    std::cout << "StandardError: " << estimate.standard_error() << "\n";
+    std::cout << "NumSamples: " << estimate.num_samples << "\n";
+    totalTime.stop();
+    return 0;
+  }
+
   auto num_triangles_result = TriangleCount(pg.get(), plan);
   if (!num_triangles_result) {
     KATANA_LOG_FATAL(
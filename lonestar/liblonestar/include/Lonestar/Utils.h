@@ -28,6 +28,14 @@
 #include "katana/analytics/Utils.h"
 #include "tsuba/RDG.h"
 
+/// Have graphs loaded with opts read their topology into the memory
+/// placement chosen with -numaPlacement
+void PlaceInputTopology(tsuba::RDGLoadOptions* opts);
+
+/// Move the properties of pg into the memory placement chosen with
+/// -numaPlacement; its topology is placed as it loads (PlaceInputTopology)
+void PlaceInputGraph(katana::PropertyGraph* pg);
+
 inline std::unique_ptr<katana::PropertyGraph>
 MakeFileGraph(
     const std::string& rdg_name, const std::string& edge_property_name) {
@@ -40,10 +48,12 @@ MakeFileGraph(
   tsuba::RDGLoadOptions opts;
   opts.node_properties = &node_properties;
   opts.edge_properties = &edge_properties;
+  PlaceInputTopology(&opts);
   auto pfg_result = katana::PropertyGraph::Make(rdg_name, opts);
   if (!pfg_result) {
     KATANA_LOG_FATAL("cannot make graph: {}", pfg_result.error());
   }
+  PlaceInputGraph(pfg_result.value().get());
   return std::move(pfg_result.value());
 }
 
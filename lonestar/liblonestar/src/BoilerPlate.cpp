@@ -21,7 +21,11 @@
 
 #include <sstream>
 
+#include "katana/GraphPlacement.h"
+#include "katana/HWTopo.h"
+#include "katana/LoopTelemetry.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Trace.h"
 
 //! standard global options to the benchmarks
 llvm::cl::opt<bool> skipVerify(
@@ -34,6 +38,17 @@ llvm::cl::opt<std::string> statFile(
     "statFile",
     llvm::cl::desc("ouput file to print stats to (default value empty)"),
     llvm::cl::init(""));
+llvm::cl::opt<std::string> loopTelemetryFile(
+    "loopTelemetry",
+    llvm::cl::desc("output file to stream per-loop JSON records to as loops "
+                   "finish (default value empty)"),
+    llvm::cl::init(""));
+llvm::cl::opt<std::string> traceFile(
+    "trace",
+    llvm::cl::desc("output file to write a Chrome trace of the time each "
+                   "thread spends in loops and waits to (default value "
+                   "empty)"),
+    llvm::cl::init(""));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! symmetric graph.
@@ -56,6 +71,59 @@ llvm::cl::opt<bool> output(
     "output", llvm::cl::desc("Write result (default false)"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<katana::MemoryPlacement> numaPlacement(
+    "numaPlacement",
+    llvm::cl::desc("How to place the input graph in memory (default value "
+                   "firstTouch):"),
+    llvm::cl::values(
+        clEnumValN(
+            katana::MemoryPlacement::kFirstTouch, "firstTouch",
+            "Leave memory where it was first touched"),
+        clEnumValN(
+            katana::MemoryPlacement::kBlocked, "blocked",
+            "Place each block of nodes on the socket of the thread that "
+            "processes it"),
+        clEnumValN(
+            katana::MemoryPlacement::kInterleaved, "interleaved",
+            "Interleave pages across sockets")),
+    llvm::cl::init(katana::MemoryPlacement::kFirstTouch));
+
+static llvm::cl::opt<katana::ThreadPlacement> threadPlacement(
+    "threadPlacement",
+    llvm::cl::desc("How to bind threads to cpus (default value physical, or "
+                   "the value of KATANA_THREAD_PLACEMENT):"),
+    llvm::cl::values(
+        clEnumValN(
+            katana::ThreadPlacement::kPhysicalCoresFirst, "physical",
+            "Use physical cores socket by socket before SMT siblings"),
+        clEnumValN(
+            katana::ThreadPlacement::kCompact, "compact",
+            "Fill each core and each socket before the next one"),
+        clEnumValN(
+            katana::ThreadPlacement::kScatter, "scatter",
+            "Spread threads round-robin across sockets"),
+        clEnumValN(
+            katana::ThreadPlacement::kList, "list",
+            "Use the cpus given by -threadCPUs in order")),
+    llvm::cl::init(katana::ThreadPlacement::kPhysicalCoresFirst));
+static llvm::cl::opt<std::string> threadCPUs(
+    "threadCPUs",
+    llvm::cl::desc("cpus to bind threads to with -threadPlacement=list, "
+                   "e.g., 0-3,8"),
+    llvm::cl::init(""));
+
+void
+PlaceInputTopology(tsuba::RDGLoadOptions* opts) {
+  opts->fill_topology = katana::TopologyFiller(numaPlacement);
+}
+
+void
+PlaceInputGraph(katana::PropertyGraph* pg) {
+  if (auto res = katana::PlaceGraph(pg, numaPlacement, false); !res) {
+    KATANA_LOG_FATAL("cannot place graph: {}", res.error());
+  }
+}
+
 static void
 LonestarPrintVersion(llvm::raw_ostream& out) {
   out << "LoneStar Benchmark Suite v" << katana::getVersion() << " ("
@@ -77,11 +145,22 @@ LonestarStart(
   llvm::cl::SetVersionPrinter(LonestarPrintVersion);
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
+  if (threadPlacement.getNumOccurrences() > 0) {
+    katana::SetThreadPlacement(
+        threadPlacement, katana::parseCPUList(threadCPUs));
+  }
+
   auto shared_mem_sys = std::make_unique<katana::SharedMemSys>();
 
   numThreads = katana::setActiveThreads(numThreads);
 
   katana::SetStatFile(statFile);
+  if (!loopTelemetryFile.empty()) {
+    katana::SetLoopTelemetryFile(loopTelemetryFile);
+  }
+  if (!traceFile.empty()) {
+    katana::SetTraceFile(traceFile);
+  }
 
   LonestarPrintVersion(llvm::outs());
   llvm::outs() << "Copyright (C) " << katana::getCopyrightYear()
@@ -108,6 +187,7 @@ LonestarStart(
 
   katana::ReportParam("(NULL)", "CommandLine", cmdout.str());
   katana::ReportParam("(NULL)", "Threads", numThreads);
+  katana::reportThreadPlacement();
   katana::ReportParam("(NULL)", "Hosts", 1);
   if (input) {
     katana::ReportParam("(NULL)", "Input", input->getValue());
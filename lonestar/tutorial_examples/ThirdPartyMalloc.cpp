@@ -19,6 +19,8 @@
 
 // This example shows how to use katana::ExternalHeapAllocator
 // to wrap up 3rd-party allocators and use the wrapped heap for STL containers.
+// To replace malloc itself with jemalloc, with an arena per socket, build with
+// -DKATANA_ENABLE_JEMALLOC=ON instead (see katana/SocketArenas.h).
 #include <iostream>
 
 #include "katana/Galois.h"
@@ -26,20 +26,50 @@ Algorithms
 
 .. automodule:: katana.analytics._bfs
 
+.. automodule:: katana.analytics._bipartite_matching
+
 .. automodule:: katana.analytics._connected_components
 
+.. automodule:: katana.analytics._hypergraph_partition
+
 .. automodule:: katana.analytics._independent_set
 
 .. automodule:: katana.analytics._jaccard
 
+.. automodule:: katana.analytics._k_clique
+
 .. automodule:: katana.analytics._k_core
 
+.. automodule:: katana.analytics._k_hop
+
 .. automodule:: katana.analytics._k_truss
 
+.. automodule:: katana.analytics._label_propagation
+
+.. automodule:: katana.analytics._leiden_clustering
+
+.. automodule:: katana.analytics._matrix_completion
+
+.. automodule:: katana.analytics._max_flow
+
+.. automodule:: katana.analytics._minimum_spanning_forest
+
+.. automodule:: katana.analytics._neighbor_sampling
+
 .. automodule:: katana.analytics._pagerank
 
+.. automodule:: katana.analytics._partition
+
+.. automodule:: katana.analytics._spectral_centrality
+
 .. automodule:: katana.analytics._sssp
 
+.. automodule:: katana.analytics._strongly_connected_components
+
+.. automodule:: katana.analytics._temporal
+
+.. automodule:: katana.analytics._topological_sort
+
 .. automodule:: katana.analytics._triangle_count
 
 .. automodule:: katana.analytics._wrappers
@@ -53,13 +83,28 @@ from katana.analytics._betweenness_centrality import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
 )
-from katana.analytics._bfs import bfs, bfs_assert_valid, BfsPlan, BfsStatistics
+from katana.analytics._bfs import bfs, bfs_assert_valid, multi_source_bfs, BfsPlan, BfsStatistics
+from katana.analytics._bipartite_matching import (
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+    weighted_bipartite_matching,
+    weighted_bipartite_matching_assert_valid,
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+)
 from katana.analytics._connected_components import (
     connected_components,
     connected_components_assert_valid,
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
 )
+from katana.analytics._hypergraph_partition import (
+    hypergraph_partition,
+    hypergraph_partition_assert_valid,
+    HypergraphPartitionPlan,
+    HypergraphPartitionStatistics,
+    HYPEREDGE_CUT,
+)
 from katana.analytics._independent_set import (
     independent_set,
     independent_set_assert_valid,
@@ -67,10 +112,101 @@ from katana.analytics._independent_set import (
     IndependentSetStatistics,
 )
 from katana.analytics._jaccard import jaccard, jaccard_assert_valid, JaccardPlan, JaccardStatistics
-from katana.analytics._k_core import k_core, k_core_assert_valid, KCorePlan, KCoreStatistics
-from katana.analytics._k_truss import k_truss, k_truss_assert_valid, KTrussPlan, KTrussStatistics
+from katana.analytics._k_clique import k_clique_count, KCliquePlan
+from katana.analytics._k_core import (
+    k_core,
+    k_core_assert_valid,
+    k_core_decomposition,
+    k_core_decomposition_assert_valid,
+    KCoreDecompositionStatistics,
+    KCorePlan,
+    KCoreStatistics,
+)
+from katana.analytics._k_hop import EgoNetwork, KHopExpander, KHopPlan
+from katana.analytics._k_truss import (
+    k_truss,
+    k_truss_assert_valid,
+    k_truss_decomposition,
+    k_truss_decomposition_assert_valid,
+    KTrussDecompositionStatistics,
+    KTrussPlan,
+    KTrussStatistics,
+)
+from katana.analytics._label_propagation import (
+    label_propagation,
+    label_propagation_assert_valid,
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+)
+from katana.analytics._leiden_clustering import (
+    leiden_clustering,
+    leiden_clustering_assert_valid,
+    LeidenClusteringPlan,
+    LeidenClusteringStatistics,
+)
+from katana.analytics._matrix_completion import (
+    matrix_completion,
+    matrix_completion_assert_valid,
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+)
+from katana.analytics._max_flow import max_flow, max_flow_assert_valid, MaxFlowPlan, MaxFlowStatistics
+from katana.analytics._minimum_spanning_forest import (
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+)
+from katana.analytics._neighbor_sampling import (
+    Minibatch,
+    MinibatchLoader,
+    NeighborSampler,
+    NeighborSamplingPlan,
+)
 from katana.analytics._pagerank import pagerank, pagerank_assert_valid, PagerankPlan, PagerankStatistics
-from katana.analytics._sssp import sssp, sssp_assert_valid, SsspPlan, SsspStatistics
+from katana.analytics._partition import (
+    partition,
+    partition_assert_valid,
+    PartitionObjective,
+    PartitionPlan,
+    PartitionStatistics,
+)
+from katana.analytics._spectral_centrality import (
+    eigenvector_centrality,
+    hits,
+    katz_centrality,
+    EigenvectorCentralityPlan,
+    HitsPlan,
+    KatzCentralityPlan,
+)
+from katana.analytics._sssp import (
+    multi_source_sssp,
+    MultiSourceSsspPlan,
+    sssp,
+    sssp_assert_valid,
+    sssp_quantize_edge_weights,
+    SsspPlan,
+    SsspStatistics,
+)
+from katana.analytics._strongly_connected_components import (
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+)
+from katana.analytics._temporal import earliest_arrival, temporal_pagerank, EarliestArrivalPlan
+from katana.analytics._topological_sort import (
+    dag_critical_path,
+    dag_longest_path,
+    topological_sort,
+    topological_sort_assert_valid,
+    TopologicalSortPlan,
+)
 from katana.analytics._triangle_count import triangle_count, TriangleCountPlan
-from katana.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
+from katana.analytics._wrappers import (
+    find_edge_sorted_by_dest,
+    sort_all_edges_by_dest,
+    sort_all_edges_by_time,
+    sort_nodes_by_degree,
+)
 from katana.analytics.plan import Architecture, Plan, Statistics
@@ -18,7 +18,7 @@ Betweenness Centrality
 
 from libcpp.string cimport string
 from libcpp.vector cimport vector
-from libc.stdint cimport uint32_t
+from libc.stdint cimport uint32_t, uint64_t
 
 from katana.analytics.plan cimport Plan, _Plan
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -37,8 +37,16 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kMultiSource "katana::analytics::BetweennessCentralityPlan::kMultiSource"
+            kApproximate "katana::analytics::BetweennessCentralityPlan::kApproximate"
+            kWeighted "katana::analytics::BetweennessCentralityPlan::kWeighted"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double epsilon() const
+        double delta() const
+        uint64_t seed() const
+        const string& edge_weight_property_name() const
+        unsigned step_shift() const
 
         BetweennessCentralityPlan()
 
@@ -47,6 +55,12 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan MultiSource()
+        @staticmethod
+        _BetweennessCentralityPlan Approximate(double epsilon, double delta, uint64_t seed)
+        @staticmethod
+        _BetweennessCentralityPlan Weighted(const string& edge_weight_property_name, unsigned step_shift)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -87,9 +101,18 @@ class _BetweennessCentralityAlgorithm(Enum):
         Parallelize outermost iteration
     Level
         Process levels in parallel
+    MultiSource
+        Process batches of 64 sources with one bit-parallel BFS
+    Approximate
+        Estimate from random shortest paths until an (epsilon, delta) bound holds
+    Weighted
+        Delta-stepping Brandes on positive edge weights
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    MultiSource = _BetweennessCentralityPlan.Algorithm.kMultiSource
+    Approximate = _BetweennessCentralityPlan.Algorithm.kApproximate
+    Weighted = _BetweennessCentralityPlan.Algorithm.kWeighted
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -116,6 +139,26 @@ cdef class BetweennessCentralityPlan(Plan):
     def algorithm(self) -> _BetweennessCentralityAlgorithm:
         return _BetweennessCentralityAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def delta(self) -> float:
+        return self.underlying_.delta()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @property
+    def edge_weight_property_name(self) -> str:
+        return bytes(self.underlying_.edge_weight_property_name()).decode("utf-8")
+
+    @property
+    def step_shift(self) -> int:
+        return self.underlying_.step_shift()
+
     @staticmethod
     def outer():
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Outer())
@@ -124,6 +167,29 @@ cdef class BetweennessCentralityPlan(Plan):
     def level():
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def multi_source():
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.MultiSource())
+
+    @staticmethod
+    def approximate(double epsilon = 0.01, double delta = 0.1, uint64_t seed = 0):
+        """
+        Estimate the centrality of every node from uniformly random shortest paths between random pairs of nodes
+        (KADABRA). Sampling stops once, with probability at least 1 - delta, every estimate is within epsilon times the
+        number of ordered pairs of nodes of the exact centrality. All nodes must be used as sources.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Approximate(epsilon, delta, seed))
+
+    @staticmethod
+    def weighted(str edge_weight_property_name, unsigned step_shift = 13):
+        """
+        Brandes' algorithm on the positive weights in the edge property edge_weight_property_name, finding the
+        distances from each source with delta-stepping (buckets of width 2^step_shift) and accumulating path counts
+        and dependencies in parallel over buckets of nodes at close distances.
+        """
+        return BetweennessCentralityPlan.make(
+            _BetweennessCentralityPlan.Weighted(bytes(edge_weight_property_name, "utf-8"), step_shift))
+
 
 def betweenness_centrality(PropertyGraph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
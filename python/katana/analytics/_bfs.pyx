@@ -11,6 +11,8 @@ Breadth-first Search
 
 .. autofunction:: katana.analytics.bfs
 
+.. autofunction:: katana.analytics.multi_source_bfs
+
 .. autoclass:: katana.analytics.BfsStatistics
     :members:
     :undoc-members:
@@ -21,6 +23,7 @@ Breadth-first Search
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint64_t, uint32_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana.analytics.plan cimport _Plan, Plan
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -37,9 +40,12 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
             kAsynchronous "katana::analytics::BfsPlan::kAsynchronous"
             kSynchronousTile "katana::analytics::BfsPlan::kSynchronousTile"
             kSynchronous "katana::analytics::BfsPlan::kSynchronous"
+            kSynchronousDirectOpt "katana::analytics::BfsPlan::kSynchronousDirectOpt"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
+        uint32_t alpha() const
+        uint32_t beta() const
 
         @staticmethod
         _BfsPlan AsynchronousTile(ptrdiff_t edge_tile_size)
@@ -53,13 +59,22 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         @staticmethod
         _BfsPlan Synchronous()
 
+        @staticmethod
+        _BfsPlan SynchronousDirectOpt(uint32_t alpha, uint32_t beta)
+
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::BfsPlan::kDefaultEdgeTileSize"
+    uint32_t kDefaultAlpha "katana::analytics::BfsPlan::kDefaultAlpha"
+    uint32_t kDefaultBeta "katana::analytics::BfsPlan::kDefaultBeta"
 
     Result[void] Bfs(_PropertyGraph * pg,
                      size_t start_node,
                      string output_property_name,
                      _BfsPlan algo)
 
+    Result[void] MultiSourceBfs(_PropertyGraph* pg,
+                                const vector[uint32_t]& sources,
+                                const vector[string]& output_property_names)
+
     Result[void] BfsAssertValid(_PropertyGraph* pg,
                                 string property_name);
 
@@ -92,11 +107,16 @@ class _BfsAlgorithm(Enum):
 
         Bulk-synchronous tiled
 
+    .. py:attribute:: SynchronousDirectOpt
+
+        Bulk-synchronous direction-optimizing (switches between push and pull)
+
     """
     Asynchronous = _BfsPlan.Algorithm.kAsynchronous
     AsynchronousTile = _BfsPlan.Algorithm.kAsynchronousTile
     Synchronous = _BfsPlan.Algorithm.kSynchronous
     SynchronousTile = _BfsPlan.Algorithm.kSynchronousTile
+    SynchronousDirectOpt = _BfsPlan.Algorithm.kSynchronousDirectOpt
 
 
 cdef class BfsPlan(Plan):
@@ -131,6 +151,20 @@ cdef class BfsPlan(Plan):
         """
         return self.underlying_.edge_tile_size()
 
+    @property
+    def alpha(self) -> int:
+        """
+        The push to pull switching threshold of direction-optimizing BFS.
+        """
+        return self.underlying_.alpha()
+
+    @property
+    def beta(self) -> int:
+        """
+        The pull to push switching threshold of direction-optimizing BFS.
+        """
+        return self.underlying_.beta()
+
     @staticmethod
     def asynchronous_tile(edge_tile_size=kDefaultEdgeTileSize):
         return BfsPlan.make(_BfsPlan.AsynchronousTile(edge_tile_size))
@@ -147,6 +181,10 @@ cdef class BfsPlan(Plan):
     def synchronous():
         return BfsPlan.make(_BfsPlan.Synchronous())
 
+    @staticmethod
+    def synchronous_direct_opt(alpha=kDefaultAlpha, beta=kDefaultBeta):
+        return BfsPlan.make(_BfsPlan.SynchronousDirectOpt(alpha, beta))
+
 
 def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan plan = BfsPlan()):
     """
@@ -167,6 +205,26 @@ def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan p
     with nogil:
         handle_result_void(Bfs(pg.underlying.get(), start_node, output_property_name_cstr, plan.underlying_))
 
+
+def multi_source_bfs(PropertyGraph pg, sources, output_property_names):
+    """
+    Compute the Breadth-First Search levels on `pg` from each node in `sources`. The levels from ``sources[i]`` are
+    written to the property ``output_property_names[i]``. Batches of 64 sources share a single traversal of the graph,
+    which is much faster than calling :py:func:`bfs` for each source.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type sources: List[int]
+    :param sources: The source nodes.
+    :type output_property_names: List[str]
+    :param output_property_names: The output properties to write path lengths into, one per source. These properties
+        must not already exist.
+    """
+    cdef vector[uint32_t] c_sources = sources
+    cdef vector[string] c_names = [bytes(name, "utf-8") for name in output_property_names]
+    with nogil:
+        handle_result_void(MultiSourceBfs(pg.underlying.get(), c_sources, c_names))
+
 def bfs_assert_valid(PropertyGraph pg, str property_name):
     """
     Raise an exception if the BFS results in `pg` appear to be incorrect. This is not an
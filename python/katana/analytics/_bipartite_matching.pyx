@@ -0,0 +1,242 @@
+"""
+Bipartite Matching
+------------------
+
+A matching is a set of edges no two of which share a node. These routines match the left nodes of a graph, which
+have out-edges, with its right nodes, which have in-edges; no node may have both.
+
+.. autoclass:: katana.analytics.BipartiteMatchingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._bipartite_matching._BipartiteMatchingPlanAlgorithm
+
+.. autofunction:: katana.analytics.bipartite_matching
+
+.. autofunction:: katana.analytics.weighted_bipartite_matching
+
+.. autoclass:: katana.analytics.BipartiteMatchingStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.bipartite_matching_assert_valid
+
+.. autofunction:: katana.analytics.weighted_bipartite_matching_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kPothenFan "katana::analytics::BipartiteMatchingPlan::kPothenFan"
+            kSuitor "katana::analytics::BipartiteMatchingPlan::kSuitor"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+        bool karp_sipser_initialization() const
+
+        BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PothenFan(bool karp_sipser_initialization)
+        @staticmethod
+        _BipartiteMatchingPlan Suitor()
+
+    Result[void] BipartiteMatching(_PropertyGraph* pg, string output_property_name, _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, string property_name)
+
+    Result[void] WeightedBipartiteMatching(_PropertyGraph* pg, string edge_weight_property_name,
+                                           string output_property_name, _BipartiteMatchingPlan plan)
+
+    Result[void] WeightedBipartiteMatchingAssertValid(_PropertyGraph* pg, string edge_weight_property_name,
+                                                      string property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t matching_size
+        uint64_t n_left_nodes
+        uint64_t n_right_nodes
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(_PropertyGraph* pg, string property_name)
+
+
+class _BipartiteMatchingPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: PothenFan
+
+        Maximum cardinality matching by parallel depth-first searches for vertex-disjoint augmenting paths. For
+        :py:func:`bipartite_matching`.
+
+    .. py:attribute:: Suitor
+
+        Half-approximate maximum weight matching in which left nodes propose to right nodes. For
+        :py:func:`weighted_bipartite_matching`.
+    """
+    PothenFan = _BipartiteMatchingPlan.Algorithm.kPothenFan
+    Suitor = _BipartiteMatchingPlan.Algorithm.kSuitor
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for bipartite matching.
+
+    Static methods construct BipartiteMatchingPlans.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingPlanAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> BipartiteMatchingPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def karp_sipser_initialization(self) -> bool:
+        return self.underlying_.karp_sipser_initialization()
+
+    @staticmethod
+    def pothen_fan(bool karp_sipser_initialization = True) -> BipartiteMatchingPlan:
+        """
+        :param karp_sipser_initialization: Start from a greedy Karp-Sipser matching instead of an empty one.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PothenFan(karp_sipser_initialization))
+
+    @staticmethod
+    def suitor() -> BipartiteMatchingPlan:
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.Suitor())
+
+
+def bipartite_matching(
+    PropertyGraph pg, str output_property_name, BipartiteMatchingPlan plan = BipartiteMatchingPlan()
+):
+    """
+    Compute a maximum cardinality matching of pg, whose edges must all go from left nodes to right nodes.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output edge property, 1 for matched edges and 0 otherwise. This property must
+        not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use; a :py:meth:`BipartiteMatchingPlan.pothen_fan` plan.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(BipartiteMatching(pg.underlying.get(), output_property_name_str, plan.underlying_))
+    return v
+
+
+def bipartite_matching_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if the edges in `pg` are not a maximum cardinality matching.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(BipartiteMatchingAssertValid(pg.underlying.get(), property_name_str))
+
+
+def weighted_bipartite_matching(
+    PropertyGraph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan.suitor()
+):
+    """
+    Compute a matching of pg with at least half the maximum weight. The edges of pg must all go from left nodes to
+    right nodes. Edges whose weight is not positive are never matched.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The integer or floating point edge property holding the weight of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output edge property, 1 for matched edges and 0 otherwise. This property must
+        not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use; a :py:meth:`BipartiteMatchingPlan.suitor` plan.
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(WeightedBipartiteMatching(
+            pg.underlying.get(), edge_weight_property_name_str, output_property_name_str, plan.underlying_))
+    return v
+
+
+def weighted_bipartite_matching_assert_valid(PropertyGraph pg, str edge_weight_property_name, str property_name):
+    """
+    Raise an exception if the edges in `pg` are not a matching in which every edge of positive weight shares a node
+    with a matched edge at least as heavy.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(WeightedBipartiteMatchingAssertValid(
+            pg.underlying.get(), edge_weight_property_name_str, property_name_str))
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(
+    Result[_BipartiteMatchingStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics:
+    """
+    Compute the :ref:`statistics` of a bipartite matching.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                pg.underlying.get(), property_name_str))
+
+    @property
+    def matching_size(self) -> uint64_t:
+        return self.underlying.matching_size
+
+    @property
+    def n_left_nodes(self) -> uint64_t:
+        return self.underlying.n_left_nodes
+
+    @property
+    def n_right_nodes(self) -> uint64_t:
+        return self.underlying.n_right_nodes
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,244 @@
+"""
+Hypergraph Partition
+--------------------
+
+Divide the nodes of a hypergraph into balanced partitions so that few hyperedges have nodes in more than one
+partition, for example to place data that is queried together on the same host.
+
+.. autoclass:: katana.analytics.HypergraphPartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._hypergraph_partition._HypergraphPartitionPlanAlgorithm
+
+.. autoclass:: katana.analytics._hypergraph_partition._HypergraphPartitionPlanMatchingPolicy
+
+.. autofunction:: katana.analytics.hypergraph_partition
+
+.. autoclass:: katana.analytics.HypergraphPartitionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.hypergraph_partition_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/hypergraph_partition/hypergraph_partition.h" namespace "katana::analytics" nogil:
+    cppclass _HypergraphPartitionPlan "katana::analytics::HypergraphPartitionPlan" (_Plan):
+        enum Algorithm:
+            kBiPart "katana::analytics::HypergraphPartitionPlan::kBiPart"
+
+        enum MatchingPolicy:
+            kHigherDegree "katana::analytics::HypergraphPartitionPlan::kHigherDegree"
+            kLowerDegree "katana::analytics::HypergraphPartitionPlan::kLowerDegree"
+            kHigherWeight "katana::analytics::HypergraphPartitionPlan::kHigherWeight"
+            kLowerWeight "katana::analytics::HypergraphPartitionPlan::kLowerWeight"
+            kRandom "katana::analytics::HypergraphPartitionPlan::kRandom"
+
+        _HypergraphPartitionPlan.Algorithm algorithm() const
+        _HypergraphPartitionPlan.MatchingPolicy matching_policy() const
+        uint32_t max_coarsening_levels() const
+        bool deterministic() const
+
+        HypergraphPartitionPlan()
+
+        @staticmethod
+        _HypergraphPartitionPlan BiPart(
+            _HypergraphPartitionPlan.MatchingPolicy matching_policy, uint32_t max_coarsening_levels,
+            bool deterministic)
+
+    uint32_t kDefaultMaxCoarseningLevels "katana::analytics::HypergraphPartitionPlan::kDefaultMaxCoarseningLevels"
+    bool kDefaultDeterministic "katana::analytics::HypergraphPartitionPlan::kDefaultDeterministic"
+    uint32_t kHyperedgeCut "katana::analytics::kHyperedgeCut"
+
+    Result[void] HypergraphPartition(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name,
+                                     _HypergraphPartitionPlan plan)
+
+    Result[void] HypergraphPartitionAssertValid(_PropertyGraph* pg, uint32_t num_partitions, string property_name)
+
+    cppclass _HypergraphPartitionStatistics "katana::analytics::HypergraphPartitionStatistics":
+        uint32_t num_partitions
+        uint64_t cut_hyperedges
+        uint64_t connectivity
+        double node_imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_HypergraphPartitionStatistics] Compute(
+            _PropertyGraph* pg, uint32_t num_partitions, string property_name)
+
+
+HYPEREDGE_CUT = kHyperedgeCut
+
+
+class _HypergraphPartitionPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: BiPart
+
+        Coarsen the hypergraph by merging the nodes of hyperedges, bisect the coarsest hypergraph and refine the
+        bisection while projecting it back; k-way partitions are made by recursive bisection.
+    """
+    BiPart = _HypergraphPartitionPlan.Algorithm.kBiPart
+
+
+class _HypergraphPartitionPlanMatchingPolicy(Enum):
+    """
+    Which hyperedges merge their nodes first during coarsening.
+    """
+    HigherDegree = _HypergraphPartitionPlan.MatchingPolicy.kHigherDegree
+    LowerDegree = _HypergraphPartitionPlan.MatchingPolicy.kLowerDegree
+    HigherWeight = _HypergraphPartitionPlan.MatchingPolicy.kHigherWeight
+    LowerWeight = _HypergraphPartitionPlan.MatchingPolicy.kLowerWeight
+    Random = _HypergraphPartitionPlan.MatchingPolicy.kRandom
+
+
+cdef class HypergraphPartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for hypergraph partition.
+
+    Static methods construct HypergraphPartitionPlans.
+    """
+    cdef:
+        _HypergraphPartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _HypergraphPartitionPlanAlgorithm
+    MatchingPolicy = _HypergraphPartitionPlanMatchingPolicy
+
+    @staticmethod
+    cdef HypergraphPartitionPlan make(_HypergraphPartitionPlan u):
+        f = <HypergraphPartitionPlan>HypergraphPartitionPlan.__new__(HypergraphPartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> HypergraphPartitionPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def matching_policy(self) -> HypergraphPartitionPlan.MatchingPolicy:
+        return _HypergraphPartitionPlanMatchingPolicy(self.underlying_.matching_policy())
+
+    @property
+    def max_coarsening_levels(self) -> int:
+        return self.underlying_.max_coarsening_levels()
+
+    @property
+    def deterministic(self) -> bool:
+        return self.underlying_.deterministic()
+
+    @staticmethod
+    def bipart(
+        matching_policy = _HypergraphPartitionPlanMatchingPolicy.HigherDegree,
+        uint32_t max_coarsening_levels = kDefaultMaxCoarseningLevels,
+        bool deterministic = kDefaultDeterministic
+    ) -> HypergraphPartitionPlan:
+        """
+        :param matching_policy: Which hyperedges merge their nodes first during coarsening.
+        :param max_coarsening_levels: The maximum number of times a hypergraph is coarsened before it is bisected.
+        :param deterministic: Order nodes with (nearly) equal gains exactly, so the partition does not depend on the
+            number of threads.
+        """
+        cdef _HypergraphPartitionPlan.MatchingPolicy policy_value = <_HypergraphPartitionPlan.MatchingPolicy><int>(
+            _HypergraphPartitionPlanMatchingPolicy(matching_policy).value)
+        return HypergraphPartitionPlan.make(
+            _HypergraphPartitionPlan.BiPart(policy_value, max_coarsening_levels, deterministic))
+
+
+def hypergraph_partition(
+    PropertyGraph pg,
+    uint32_t num_partitions,
+    str output_property_name,
+    HypergraphPartitionPlan plan = HypergraphPartitionPlan()
+) -> int:
+    """
+    Divide the nodes of the hypergraph pg into `num_partitions` partitions so that few hyperedges have nodes in more
+    than one partition and the partitions have about the same number of nodes.
+
+    pg is the bipartite form of the hypergraph: the nodes with outgoing edges are hyperedges and their edges go to
+    the nodes they contain.
+
+    :type pg: PropertyGraph
+    :param pg: The hypergraph to analyze.
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the partition of each node, from 0 to
+        num_partitions - 1. A hyperedge holds the partition of its nodes, or `HYPEREDGE_CUT` if they are in more
+        than one partition. This property must not already exist.
+    :type plan: HypergraphPartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(HypergraphPartition(
+            pg.underlying.get(), num_partitions, output_property_name_str, plan.underlying_))
+    return v
+
+
+def hypergraph_partition_assert_valid(PropertyGraph pg, uint32_t num_partitions, str property_name):
+    """
+    Raise an exception if some node in `pg` is not in one of `num_partitions` partitions or some hyperedge is not in
+    the partition of its nodes.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(HypergraphPartitionAssertValid(pg.underlying.get(), num_partitions, property_name_str))
+
+
+cdef _HypergraphPartitionStatistics handle_result_HypergraphPartitionStatistics(
+        Result[_HypergraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HypergraphPartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a hypergraph partition.
+    """
+    cdef _HypergraphPartitionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, uint32_t num_partitions, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_HypergraphPartitionStatistics(_HypergraphPartitionStatistics.Compute(
+                pg.underlying.get(), num_partitions, property_name_str))
+
+    @property
+    def num_partitions(self) -> uint32_t:
+        return self.underlying.num_partitions
+
+    @property
+    def cut_hyperedges(self) -> uint64_t:
+        return self.underlying.cut_hyperedges
+
+    @property
+    def connectivity(self) -> uint64_t:
+        return self.underlying.connectivity
+
+    @property
+    def node_imbalance(self) -> float:
+        return self.underlying.node_imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
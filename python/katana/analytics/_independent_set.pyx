@@ -38,6 +38,7 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
             kPull "katana::analytics::IndependentSetPlan::kPull"
             kPriority "katana::analytics::IndependentSetPlan::kPriority"
             kEdgeTiledPriority "katana::analytics::IndependentSetPlan::kEdgeTiledPriority"
+            kOrderedPriority "katana::analytics::IndependentSetPlan::kOrderedPriority"
 
         # unsigned int kChunkSize
 
@@ -56,6 +57,8 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
         _IndependentSetPlan Priority()
         @staticmethod
         _IndependentSetPlan EdgeTiledPriority()
+        @staticmethod
+        _IndependentSetPlan OrderedPriority()
 
     Result[void] IndependentSet(_PropertyGraph* pg, string output_property_name, _IndependentSetPlan plan)
 
@@ -75,6 +78,7 @@ class _IndependentSetPlanAlgorithm(Enum):
     Pull = _IndependentSetPlan.Algorithm.kPull
     Priority = _IndependentSetPlan.Algorithm.kPriority
     EdgeTiledPriority = _IndependentSetPlan.Algorithm.kEdgeTiledPriority
+    OrderedPriority = _IndependentSetPlan.Algorithm.kOrderedPriority
 
 
 cdef class IndependentSetPlan(Plan):
@@ -117,6 +121,14 @@ cdef class IndependentSetPlan(Plan):
     def edge_tiled_priority():
         return IndependentSetPlan.make(_IndependentSetPlan.EdgeTiledPriority())
 
+    @staticmethod
+    def ordered_priority():
+        """
+        The greedy independent set of the nodes taken in a fixed pseudo-random order. Nodes are decided as soon as
+        all of their earlier neighbors are, so the result does not depend on the schedule.
+        """
+        return IndependentSetPlan.make(_IndependentSetPlan.OrderedPriority())
+
 
 def independent_set(PropertyGraph pg, str output_property_name,
              IndependentSetPlan plan = IndependentSetPlan()):
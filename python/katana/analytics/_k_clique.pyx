@@ -0,0 +1,103 @@
+"""
+k-Clique Counting
+-----------------
+
+.. autoclass:: katana.analytics.KCliquePlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._k_clique._KCliquePlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.k_clique_count
+"""
+from libc.stdint cimport uint32_t, uint64_t
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/k_clique/k_clique.h" namespace "katana::analytics" nogil:
+    cppclass _KCliquePlan "katana::analytics::KCliquePlan" (_Plan):
+        enum Algorithm:
+            kOrientedListing "katana::analytics::KCliquePlan::kOrientedListing"
+
+        _KCliquePlan.Algorithm algorithm() const
+
+        KCliquePlan()
+
+        @staticmethod
+        _KCliquePlan OrientedListing()
+
+    Result[uint64_t] KCliqueCount(_PropertyGraph* pg, uint32_t k, _KCliquePlan plan)
+
+
+class _KCliquePlanAlgorithm(Enum):
+    """
+    OrientedListing
+        List the cliques of the orientation of the graph by degree
+    """
+    OrientedListing = _KCliquePlan.Algorithm.kOrientedListing
+
+
+cdef class KCliquePlan(Plan):
+    """
+    A computational :ref:`Plan` for k-Clique Counting.
+
+    Static methods construct KCliquePlans.
+    """
+    cdef:
+        _KCliquePlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KCliquePlanAlgorithm
+
+    @staticmethod
+    cdef KCliquePlan make(_KCliquePlan u):
+        f = <KCliquePlan>KCliquePlan.__new__(KCliquePlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _KCliquePlanAlgorithm:
+        return _KCliquePlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def oriented_listing() -> KCliquePlan:
+        """
+        List the cliques of the orientation of the graph by degree, so that each clique is found once from its lowest
+        ranked node. The orientation is kept with the graph and shared with triangle counting.
+        """
+        return KCliquePlan.make(_KCliquePlan.OrientedListing())
+
+
+cdef uint64_t handle_result_int(Result[uint64_t] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def k_clique_count(PropertyGraph pg, uint32_t k, KCliquePlan plan = KCliquePlan()) -> int:
+    """
+    Count the cliques of `k` nodes in `pg`, which must be symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type k: int
+    :param k: The number of nodes of each clique.
+    :type plan: KCliquePlan
+    :param plan: The execution plan to use.
+    :return: The number of cliques found.
+    """
+    with nogil:
+        v = handle_result_int(KCliqueCount(pg.underlying.get(), k, plan.underlying_))
+    return v
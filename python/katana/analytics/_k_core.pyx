@@ -16,6 +16,14 @@ k-Core
     :undoc-members:
 
 .. autofunction:: katana.analytics.k_core_assert_valid
+
+.. autofunction:: katana.analytics.k_core_decomposition
+
+.. autoclass:: katana.analytics.KCoreDecompositionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.k_core_decomposition_assert_valid
 """
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
@@ -57,6 +65,19 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         @staticmethod
         Result[_KCoreStatistics] Compute(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
+    Result[void] KCoreDecomposition(_PropertyGraph* pg, string output_property_name, _KCorePlan plan)
+
+    Result[void] KCoreDecompositionAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _KCoreDecompositionStatistics "katana::analytics::KCoreDecompositionStatistics":
+        uint32_t max_core_number
+        uint64_t nodes_in_max_core
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_KCoreDecompositionStatistics] Compute(_PropertyGraph* pg, string property_name)
+
 
 class _KCorePlanAlgorithm(Enum):
     """
@@ -158,3 +179,69 @@ cdef class KCoreStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+def k_core_decomposition(PropertyGraph pg, str output_property_name, KCorePlan plan = KCorePlan()) -> int:
+    """
+    Compute the core number of every node of pg: the largest k such that the node is in the k-core. The pg must be
+    symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the core number of each node.
+        This property must not already exist.
+    :type plan: KCorePlan
+    :param plan: The execution plan to use. The synchronous plan peels one core number at a time; the asynchronous
+        plan refines an estimate of the core number of each node, lowest estimates first.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KCoreDecomposition(pg.underlying.get(), output_property_name_str, plan.underlying_))
+    return v
+
+
+def k_core_decomposition_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if the core numbers in `pg` are not those computed by a serial decomposition.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(KCoreDecompositionAssertValid(pg.underlying.get(), property_name_str))
+
+
+cdef _KCoreDecompositionStatistics handle_result_KCoreDecompositionStatistics(
+    Result[_KCoreDecompositionStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class KCoreDecompositionStatistics:
+    """
+    Compute the :ref:`statistics` of a k-core decomposition result.
+    """
+    cdef _KCoreDecompositionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_KCoreDecompositionStatistics(_KCoreDecompositionStatistics.Compute(
+                pg.underlying.get(), property_name_str))
+
+    @property
+    def max_core_number(self) -> uint32_t:
+        return self.underlying.max_core_number
+
+    @property
+    def nodes_in_max_core(self) -> uint64_t:
+        return self.underlying.nodes_in_max_core
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,225 @@
+"""
+K-Hop Neighborhoods
+-------------------
+
+Expand batches of query nodes into their k-hop neighborhoods and ego networks, e.g., to compute features of many
+nodes online. The queries of a batch are expanded concurrently, each by one thread, so a query costs time
+proportional to its neighborhood rather than to the graph.
+
+.. autoclass:: katana.analytics.KHopPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._k_hop._KHopPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.analytics.KHopExpander
+    :members:
+    :special-members: __init__
+
+.. autoclass:: katana.analytics.EgoNetwork
+    :members:
+"""
+from collections import namedtuple
+
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr, static_pointer_cast, unique_ptr
+from libcpp.vector cimport vector
+
+from pyarrow.lib cimport CArray, CLargeListArray, CUInt32Array, CUInt64Array, pyarrow_wrap_array, to_shared
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph, GraphTopology
+from katana.cpp.libsupport.result cimport raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+from katana.property_graph import ArrayView
+
+
+cdef extern from "katana/analytics/KHop.h" namespace "katana::analytics" nogil:
+    cppclass _KHopPlan "katana::analytics::KHopPlan" (_Plan):
+        enum Algorithm:
+            kHashed "katana::analytics::KHopPlan::kHashed"
+
+        _KHopPlan.Algorithm algorithm() const
+        uint32_t hops() const
+        uint32_t max_fanout() const
+        uint32_t max_nodes() const
+
+        KHopPlan()
+
+        @staticmethod
+        _KHopPlan Hashed(uint32_t hops, uint32_t max_fanout, uint32_t max_nodes)
+
+    cppclass _KHopNeighborhoods "katana::analytics::KHopNeighborhoods":
+        shared_ptr[CLargeListArray] nodes
+        shared_ptr[CLargeListArray] distances
+
+    cppclass _EgoNetwork "katana::analytics::EgoNetwork":
+        shared_ptr[CUInt32Array] nodes
+        vector[uint32_t] hop_sizes
+        GraphTopology topology
+        shared_ptr[CUInt64Array] edges
+
+    cppclass _KHopExpander "katana::analytics::KHopExpander":
+        @staticmethod
+        Result[unique_ptr[_KHopExpander]] Make(const _PropertyGraph* pg, _KHopPlan plan)
+
+        Result[_KHopNeighborhoods] Neighborhoods(const vector[uint32_t]& queries)
+
+        Result[vector[_EgoNetwork]] EgoNetworks(const vector[uint32_t]& queries)
+
+
+cdef shared_ptr[_KHopExpander] handle_result_expander(Result[unique_ptr[_KHopExpander]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef _KHopNeighborhoods handle_result_neighborhoods(Result[_KHopNeighborhoods] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef vector[_EgoNetwork] handle_result_ego_networks(Result[vector[_EgoNetwork]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+class _KHopPlanAlgorithm(Enum):
+    """
+    Hashed
+        Expand each query on one thread, deduplicating the nodes it reaches with a hash map that the thread reuses
+        for its next query
+    """
+    Hashed = _KHopPlan.Algorithm.kHashed
+
+
+cdef class KHopPlan(Plan):
+    """
+    A computational :ref:`Plan` for k-hop expansion.
+
+    Static methods construct KHopPlans.
+    """
+    cdef:
+        _KHopPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KHopPlanAlgorithm
+
+    @staticmethod
+    cdef KHopPlan make(_KHopPlan u):
+        f = <KHopPlan>KHopPlan.__new__(KHopPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _KHopPlanAlgorithm:
+        return _KHopPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def hops(self) -> int:
+        return self.underlying_.hops()
+
+    @property
+    def max_fanout(self) -> int:
+        return self.underlying_.max_fanout()
+
+    @property
+    def max_nodes(self) -> int:
+        return self.underlying_.max_nodes()
+
+    @staticmethod
+    def hashed(uint32_t hops = 2, uint32_t max_fanout = 0, uint32_t max_nodes = 0) -> KHopPlan:
+        """
+        Expand queries by `hops` hops along out-edges, following the first `max_fanout` out-edges of each node (all
+        of them if 0), and stop a query once it has reached `max_nodes` nodes (no limit if 0). The hop that reaches
+        the limit keeps the nodes with the smallest IDs.
+        """
+        return KHopPlan.make(_KHopPlan.Hashed(hops, max_fanout, max_nodes))
+
+
+EgoNetwork = namedtuple("EgoNetwork", ["nodes", "hop_sizes", "indices", "dests", "edges"])
+EgoNetwork.__doc__ = """
+The subgraph induced by the k-hop neighborhood of a query, in CSR format with local node indices. `nodes` is an
+`ArrayView` of the IDs of its nodes, the query first, then the nodes at distance 1 in increasing order of ID, and so
+on; entry `h` of `hop_sizes` is the number of nodes at most `h` hops from the query. `indices[n]` is the end in
+`dests` of the edges of node `n`, and `edges` holds the ID of each edge in the graph. Only the edges the fanout cap of
+the plan lets the expansion follow are included.
+"""
+
+
+cdef _view(shared_ptr[CArray] array):
+    return ArrayView.from_arrow(pyarrow_wrap_array(array))
+
+
+cdef class KHopExpander:
+    """
+    Expands batches of query nodes into their k-hop neighborhoods along out-edges. Expansion releases the GIL.
+
+    An expander keeps per-thread workspaces that are reused by later queries, so one expander should serve all the
+    queries of a graph.
+    """
+    cdef:
+        shared_ptr[_KHopExpander] underlying
+        readonly PropertyGraph graph
+
+    def __init__(self, PropertyGraph pg, KHopPlan plan = KHopPlan()):
+        """
+        :type pg: PropertyGraph
+        :param pg: The graph to expand queries in.
+        :type plan: KHopPlan
+        :param plan: The number of hops and the caps of the expansion.
+        """
+        self.graph = pg
+        with nogil:
+            self.underlying = handle_result_expander(_KHopExpander.Make(pg.underlying.get(), plan.underlying_))
+
+    def neighborhoods(self, queries):
+        """
+        Return the neighborhoods of `queries`, which are node IDs and may repeat, as a pair of `pyarrow.LargeListArray`
+        objects with one entry per query. The first lists the IDs of the nodes of the neighborhood: the query, then
+        the nodes at distance 1 in increasing order of ID, and so on. The second lists their distances as uint8
+        values.
+        """
+        cdef vector[uint32_t] queries_vec = queries
+        cdef _KHopNeighborhoods result
+        with nogil:
+            result = handle_result_neighborhoods(self.underlying.get().Neighborhoods(queries_vec))
+        return (
+            pyarrow_wrap_array(static_pointer_cast[CArray, CLargeListArray](result.nodes)),
+            pyarrow_wrap_array(static_pointer_cast[CArray, CLargeListArray](result.distances)),
+        )
+
+    def ego_networks(self, queries) -> list:
+        """
+        Return the `EgoNetwork` of each of `queries`, which are node IDs and may repeat.
+        """
+        cdef vector[uint32_t] queries_vec = queries
+        cdef vector[_EgoNetwork] networks
+        cdef size_t q
+        with nogil:
+            networks = handle_result_ego_networks(self.underlying.get().EgoNetworks(queries_vec))
+        result = []
+        for q in range(networks.size()):
+            result.append(
+                EgoNetwork(
+                    _view(static_pointer_cast[CArray, CUInt32Array](networks[q].nodes)),
+                    list(networks[q].hop_sizes),
+                    _view(static_pointer_cast[CArray, CUInt64Array](networks[q].topology.out_indices)),
+                    _view(static_pointer_cast[CArray, CUInt32Array](networks[q].topology.out_dests)),
+                    _view(static_pointer_cast[CArray, CUInt64Array](networks[q].edges)),
+                )
+            )
+        return result
@@ -18,6 +18,14 @@ The k-Truss is a maximal connected subgraph in which all edges are part of at le
     :undoc-members:
 
 .. autofunction:: katana.analytics.k_truss_assert_valid
+
+.. autofunction:: katana.analytics.k_truss_decomposition
+
+.. autoclass:: katana.analytics.KTrussDecompositionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.k_truss_decomposition_assert_valid
 """
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
@@ -37,6 +45,7 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
             kBsp "katana::analytics::KTrussPlan::kBsp"
             kBspJacobi "katana::analytics::KTrussPlan::kBspJacobi"
             kBspCoreThenTruss "katana::analytics::KTrussPlan::kBspCoreThenTruss"
+            kPeeling "katana::analytics::KTrussPlan::kPeeling"
 
         _KTrussPlan.Algorithm algorithm() const
 
@@ -48,6 +57,8 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         _KTrussPlan BspJacobi()
         @staticmethod
         _KTrussPlan BspCoreThenTruss()
+        @staticmethod
+        _KTrussPlan Peeling()
 
     Result[void] KTruss(_PropertyGraph* pg, uint32_t k_truss_number,string output_property_name, _KTrussPlan plan)
 
@@ -63,6 +74,19 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         Result[_KTrussStatistics] Compute(_PropertyGraph* pg, uint32_t k_truss_number,
                                           string output_property_name)
 
+    Result[void] KTrussDecomposition(_PropertyGraph* pg, string output_property_name)
+
+    Result[void] KTrussDecompositionAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _KTrussDecompositionStatistics "katana::analytics::KTrussDecompositionStatistics":
+        uint32_t max_truss_number
+        uint64_t edges_in_max_truss
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_KTrussDecompositionStatistics] Compute(_PropertyGraph* pg, string property_name)
+
 
 class _KTrussPlanAlgorithm(Enum):
     """
@@ -78,10 +102,16 @@ class _KTrussPlanAlgorithm(Enum):
 
         Compute k-1 core and then k-truss algorithm.
 
+    .. py:attribute:: Peeling
+
+        Count the support of every edge once, then remove edges with too little support and update only the edges
+        that shared a triangle with them.
+
     """
     Bsp = _KTrussPlan.Algorithm.kBsp
     BspJacobi = _KTrussPlan.Algorithm.kBspJacobi
     BspCoreThenTruss = _KTrussPlan.Algorithm.kBspCoreThenTruss
+    Peeling = _KTrussPlan.Algorithm.kPeeling
 
 
 cdef class KTrussPlan(Plan):
@@ -117,6 +147,9 @@ cdef class KTrussPlan(Plan):
     @staticmethod
     def bsp_core_then_truss() -> KTrussPlan:
         return KTrussPlan.make(_KTrussPlan.BspCoreThenTruss())
+    @staticmethod
+    def peeling() -> KTrussPlan:
+        return KTrussPlan.make(_KTrussPlan.Peeling())
 
 
 def k_truss(PropertyGraph pg, uint32_t k_truss_number, str output_property_name, KTrussPlan plan = KTrussPlan()) -> int:
@@ -176,3 +209,66 @@ cdef class KTrussStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+def k_truss_decomposition(PropertyGraph pg, str output_property_name) -> int:
+    """
+    Compute the truss number of every edge of pg: the largest k such that the edge is in the k-truss. The pg must be
+    symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the truss number of each edge.
+        This property must not already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KTrussDecomposition(pg.underlying.get(), output_property_name_str))
+    return v
+
+
+def k_truss_decomposition_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if the truss numbers in `pg` are not those computed by a serial decomposition.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(KTrussDecompositionAssertValid(pg.underlying.get(), property_name_str))
+
+
+cdef _KTrussDecompositionStatistics handle_result_KTrussDecompositionStatistics(
+    Result[_KTrussDecompositionStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class KTrussDecompositionStatistics:
+    """
+    Compute the :ref:`statistics` of a k-truss decomposition result.
+    """
+    cdef _KTrussDecompositionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_KTrussDecompositionStatistics(_KTrussDecompositionStatistics.Compute(
+                pg.underlying.get(), property_name_str))
+
+    @property
+    def max_truss_number(self) -> uint32_t:
+        return self.underlying.max_truss_number
+
+    @property
+    def edges_in_max_truss(self) -> uint64_t:
+        return self.underlying.edges_in_max_truss
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
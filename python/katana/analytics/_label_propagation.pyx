@@ -0,0 +1,202 @@
+"""
+Label Propagation
+-----------------
+
+Label propagation finds communities by having every node repeatedly adopt the most frequent label among its
+neighbors.
+
+.. autoclass:: katana.analytics.LabelPropagationPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._label_propagation._LabelPropagationPlanAlgorithm
+
+.. autofunction:: katana.analytics.label_propagation
+
+.. autoclass:: katana.analytics.LabelPropagationStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.label_propagation_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/label_propagation/label_propagation.h" namespace "katana::analytics" nogil:
+    cppclass _LabelPropagationPlan "katana::analytics::LabelPropagationPlan" (_Plan):
+        enum Algorithm:
+            kSynchronous "katana::analytics::LabelPropagationPlan::kSynchronous"
+
+        _LabelPropagationPlan.Algorithm algorithm() const
+        uint32_t max_iterations() const
+        uint32_t heavy_degree() const
+        uint64_t seed() const
+
+        LabelPropagationPlan()
+
+        @staticmethod
+        _LabelPropagationPlan Synchronous(uint32_t max_iterations, uint64_t seed, uint32_t heavy_degree)
+
+    uint32_t kDefaultMaxIterations "katana::analytics::LabelPropagationPlan::kDefaultMaxIterations"
+    uint32_t kDefaultHeavyDegree "katana::analytics::LabelPropagationPlan::kDefaultHeavyDegree"
+    uint64_t kDefaultSeed "katana::analytics::LabelPropagationPlan::kDefaultSeed"
+
+    Result[void] LabelPropagation(_PropertyGraph* pg, string output_property_name, _LabelPropagationPlan plan)
+
+    Result[void] LabelPropagationAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _LabelPropagationStatistics "katana::analytics::LabelPropagationStatistics":
+        uint64_t n_communities
+        uint64_t n_non_trivial_communities
+        uint64_t largest_community_size
+        double largest_community_proportion
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_LabelPropagationStatistics] Compute(_PropertyGraph* pg, string property_name)
+
+
+class _LabelPropagationPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: Synchronous
+
+        Every node in the frontier adopts the most frequent label among its neighbors, all reading the labels of the
+        previous round.
+    """
+    Synchronous = _LabelPropagationPlan.Algorithm.kSynchronous
+
+
+cdef class LabelPropagationPlan(Plan):
+    """
+    A computational :ref:`Plan` for label propagation.
+
+    Static methods construct LabelPropagationPlans.
+    """
+    cdef:
+        _LabelPropagationPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _LabelPropagationPlanAlgorithm
+
+    @staticmethod
+    cdef LabelPropagationPlan make(_LabelPropagationPlan u):
+        f = <LabelPropagationPlan>LabelPropagationPlan.__new__(LabelPropagationPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> LabelPropagationPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def heavy_degree(self) -> int:
+        return self.underlying_.heavy_degree()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @staticmethod
+    def synchronous(
+        uint32_t max_iterations = kDefaultMaxIterations,
+        uint64_t seed = kDefaultSeed,
+        uint32_t heavy_degree = kDefaultHeavyDegree
+    ) -> LabelPropagationPlan:
+        """
+        :param max_iterations: The number of rounds after which propagation stops even if labels are still changing.
+        :param seed: Seeds the order in which tied labels are preferred.
+        :param heavy_degree: Nodes with at least this many edges count their neighbors' labels with a parallel sort.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Synchronous(max_iterations, seed, heavy_degree))
+
+
+def label_propagation(
+    PropertyGraph pg, str output_property_name, LabelPropagationPlan plan = LabelPropagationPlan()
+) -> int:
+    """
+    Find communities of pg by label propagation. Ties between labels are broken by an order derived from the seed of
+    the plan, so the result is the same for any number of threads. The graph must be symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output node property, the label of each node, which is the ID of some node. This
+        property must not already exist.
+    :type plan: LabelPropagationPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(LabelPropagation(pg.underlying.get(), output_property_name_str, plan.underlying_))
+    return v
+
+
+def label_propagation_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if a label in `pg` is not a node ID.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(LabelPropagationAssertValid(pg.underlying.get(), property_name_str))
+
+
+cdef _LabelPropagationStatistics handle_result_LabelPropagationStatistics(
+    Result[_LabelPropagationStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class LabelPropagationStatistics:
+    """
+    Compute the :ref:`statistics` of the communities found by label propagation.
+    """
+    cdef _LabelPropagationStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_LabelPropagationStatistics(
+                _LabelPropagationStatistics.Compute(pg.underlying.get(), property_name_str))
+
+    @property
+    def n_communities(self) -> uint64_t:
+        return self.underlying.n_communities
+
+    @property
+    def n_non_trivial_communities(self) -> uint64_t:
+        return self.underlying.n_non_trivial_communities
+
+    @property
+    def largest_community_size(self) -> uint64_t:
+        return self.underlying.largest_community_size
+
+    @property
+    def largest_community_proportion(self) -> float:
+        return self.underlying.largest_community_proportion
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
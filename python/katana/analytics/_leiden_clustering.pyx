@@ -0,0 +1,226 @@
+"""
+Leiden Clustering
+-----------------
+
+.. autoclass:: katana.analytics.LeidenClusteringPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. [TRAAG] Traag, V. A., Waltman, L., and van Eck, N. J. From Louvain to
+    Leiden: guaranteeing well-connected communities. Scientific Reports 9,
+    5233 (2019).
+
+.. autoclass:: katana.analytics._leiden_clustering._LeidenClusteringPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.leiden_clustering
+
+.. autoclass:: katana.analytics.LeidenClusteringStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.leiden_clustering_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostringstream, ostream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/leiden_clustering/leiden_clustering.h" namespace "katana::analytics" nogil:
+    cppclass _LeidenClusteringPlan "katana::analytics::LeidenClusteringPlan" (_Plan):
+        enum Algorithm:
+            kDoAll "katana::analytics::LeidenClusteringPlan::kDoAll"
+
+        _LeidenClusteringPlan.Algorithm algorithm() const
+        bool is_enable_vf() const
+        double modularity_threshold_per_round() const
+        double modularity_threshold_total() const
+        uint32_t max_iterations() const
+        uint32_t min_graph_size() const
+
+        LeidenClusteringPlan()
+
+        @staticmethod
+        _LeidenClusteringPlan DoAll(
+            bool enable_vf, double modularity_threshold_per_round, double modularity_threshold_total,
+            uint32_t max_iterations, uint32_t min_graph_size)
+
+    bool kEnableVF "katana::analytics::LeidenClusteringPlan::kEnableVF"
+    double kModularityThresholdPerRound "katana::analytics::LeidenClusteringPlan::kModularityThresholdPerRound"
+    double kModularityThresholdTotal "katana::analytics::LeidenClusteringPlan::kModularityThresholdTotal"
+    uint32_t kMaxIterations "katana::analytics::LeidenClusteringPlan::kMaxIterations"
+    uint32_t kMinGraphSize "katana::analytics::LeidenClusteringPlan::kMinGraphSize"
+
+    Result[void] LeidenClustering(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name, _LeidenClusteringPlan plan)
+
+    Result[void] LeidenClusteringAssertValid(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+    cppclass _LeidenClusteringStatistics "katana::analytics::LeidenClusteringStatistics":
+        uint64_t n_clusters
+        uint64_t n_non_trivial_clusters
+        uint64_t largest_cluster_size
+        double largest_cluster_proportion
+        double modularity
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_LeidenClusteringStatistics] Compute(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+
+class _LeidenClusteringPlanAlgorithm(Enum):
+    DoAll = _LeidenClusteringPlan.Algorithm.kDoAll
+
+
+cdef class LeidenClusteringPlan(Plan):
+    """
+    A computational :ref:`Plan` for Leiden Clustering.
+
+    Static methods construct LeidenClusteringPlans.
+    """
+    cdef:
+        _LeidenClusteringPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _LeidenClusteringPlanAlgorithm
+
+    @staticmethod
+    cdef LeidenClusteringPlan make(_LeidenClusteringPlan u):
+        f = <LeidenClusteringPlan>LeidenClusteringPlan.__new__(LeidenClusteringPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _LeidenClusteringPlanAlgorithm:
+        return _LeidenClusteringPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def is_enable_vf(self) -> bool:
+        return self.underlying_.is_enable_vf()
+
+    @property
+    def modularity_threshold_per_round(self) -> float:
+        return self.underlying_.modularity_threshold_per_round()
+
+    @property
+    def modularity_threshold_total(self) -> float:
+        return self.underlying_.modularity_threshold_total()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def min_graph_size(self) -> int:
+        return self.underlying_.min_graph_size()
+
+    @staticmethod
+    def do_all(
+        bool enable_vf = kEnableVF,
+        double modularity_threshold_per_round = kModularityThresholdPerRound,
+        double modularity_threshold_total = kModularityThresholdTotal,
+        uint32_t max_iterations = kMaxIterations,
+        uint32_t min_graph_size = kMinGraphSize,
+    ) -> LeidenClusteringPlan:
+        """
+        Move nodes between clusters in parallel rounds, then refine each cluster into well-connected sub-clusters
+        before coarsening the graph [TRAAG]_.
+
+        With enable_vf, isolated and degree-one nodes are first merged into the clusters of their neighbors.
+        """
+        return LeidenClusteringPlan.make(_LeidenClusteringPlan.DoAll(
+            enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size))
+
+
+def leiden_clustering(PropertyGraph pg, str edge_weight_property_name, str output_property_name, LeidenClusteringPlan plan = LeidenClusteringPlan()):
+    """
+    Compute the Leiden Clustering for pg. `pg` must be symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The edge property holding the weights (any integer or floating point type).
+    :type output_property_name: str
+    :param output_property_name: The output property to store the cluster of each node. This property must not already
+        exist.
+    :type plan: LeidenClusteringPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(LeidenClustering(
+            pg.underlying.get(), edge_weight_property_name_str, output_property_name_str, plan.underlying_))
+
+
+def leiden_clustering_assert_valid(PropertyGraph pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the Leiden Clustering results in `pg` are invalid. This is not an exhaustive check, just a
+    sanity check.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(LeidenClusteringAssertValid(
+            pg.underlying.get(), edge_weight_property_name_str, output_property_name_str))
+
+
+cdef _LeidenClusteringStatistics handle_result_LeidenClusteringStatistics(
+        Result[_LeidenClusteringStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class LeidenClusteringStatistics:
+    """
+    Compute the :ref:`statistics` of a Leiden Clustering result.
+    """
+    cdef _LeidenClusteringStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str edge_weight_property_name, str output_property_name):
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_LeidenClusteringStatistics(_LeidenClusteringStatistics.Compute(
+                pg.underlying.get(), edge_weight_property_name_str, output_property_name_str))
+
+    @property
+    def n_clusters(self) -> int:
+        return self.underlying.n_clusters
+
+    @property
+    def n_non_trivial_clusters(self) -> int:
+        return self.underlying.n_non_trivial_clusters
+
+    @property
+    def largest_cluster_size(self) -> int:
+        return self.underlying.largest_cluster_size
+
+    @property
+    def largest_cluster_proportion(self) -> float:
+        return self.underlying.largest_cluster_proportion
+
+    @property
+    def modularity(self) -> float:
+        return self.underlying.modularity
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
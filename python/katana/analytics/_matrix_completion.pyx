@@ -0,0 +1,271 @@
+"""
+Matrix Completion
+-----------------
+
+Factor a sparse ratings matrix into latent vectors. The left nodes of the graph, which have out-edges, are the rows
+of the matrix and its right nodes, which have in-edges, are the columns; no node may have both. Every node gets a
+latent vector, and the rating of an edge is predicted by the dot product of the latent vectors of its endpoints.
+
+.. autoclass:: katana.analytics.MatrixCompletionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._matrix_completion._MatrixCompletionPlanAlgorithm
+
+.. autofunction:: katana.analytics.matrix_completion
+
+.. autoclass:: katana.analytics.MatrixCompletionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.matrix_completion_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/matrix_completion/matrix_completion.h" namespace "katana::analytics" nogil:
+    cppclass _MatrixCompletionPlan "katana::analytics::MatrixCompletionPlan" (_Plan):
+        enum Algorithm:
+            kSgd "katana::analytics::MatrixCompletionPlan::kSgd"
+            kAls "katana::analytics::MatrixCompletionPlan::kAls"
+
+        _MatrixCompletionPlan.Algorithm algorithm() const
+        uint32_t latent_vector_size() const
+        double lambda_ "lambda"() const
+        double learning_rate() const
+        double decay_rate() const
+        uint32_t max_iterations() const
+        double tolerance() const
+        uint32_t blocks_per_thread() const
+
+        MatrixCompletionPlan()
+
+        @staticmethod
+        _MatrixCompletionPlan Sgd(uint32_t latent_vector_size, double learning_rate, double decay_rate,
+                                  double lambda_, uint32_t max_iterations, double tolerance,
+                                  uint32_t blocks_per_thread)
+        @staticmethod
+        _MatrixCompletionPlan Als(uint32_t latent_vector_size, double lambda_, uint32_t max_iterations,
+                                  double tolerance)
+
+    uint32_t kDefaultLatentVectorSize "katana::analytics::MatrixCompletionPlan::kDefaultLatentVectorSize"
+    double kDefaultLambda "katana::analytics::MatrixCompletionPlan::kDefaultLambda"
+    double kDefaultLearningRate "katana::analytics::MatrixCompletionPlan::kDefaultLearningRate"
+    double kDefaultDecayRate "katana::analytics::MatrixCompletionPlan::kDefaultDecayRate"
+    uint32_t kDefaultMaxIterations "katana::analytics::MatrixCompletionPlan::kDefaultMaxIterations"
+    double kDefaultTolerance "katana::analytics::MatrixCompletionPlan::kDefaultTolerance"
+    uint32_t kDefaultBlocksPerThread "katana::analytics::MatrixCompletionPlan::kDefaultBlocksPerThread"
+
+    Result[void] MatrixCompletion(_PropertyGraph* pg, string rating_property_name, string output_property_name,
+                                  _MatrixCompletionPlan plan)
+
+    Result[void] MatrixCompletionAssertValid(_PropertyGraph* pg, string rating_property_name, string property_name)
+
+    cppclass _MatrixCompletionStatistics "katana::analytics::MatrixCompletionStatistics":
+        double rmse
+        uint64_t num_ratings
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MatrixCompletionStatistics] Compute(_PropertyGraph* pg, string rating_property_name,
+                                                    string property_name)
+
+
+class _MatrixCompletionPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: Sgd
+
+        Stochastic gradient descent over tiles of the ratings matrix.
+
+    .. py:attribute:: Als
+
+        Alternating least squares.
+    """
+    Sgd = _MatrixCompletionPlan.Algorithm.kSgd
+    Als = _MatrixCompletionPlan.Algorithm.kAls
+
+
+cdef class MatrixCompletionPlan(Plan):
+    """
+    A computational :ref:`Plan` for matrix completion.
+
+    Static methods construct MatrixCompletionPlans.
+    """
+    cdef:
+        _MatrixCompletionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MatrixCompletionPlanAlgorithm
+
+    @staticmethod
+    cdef MatrixCompletionPlan make(_MatrixCompletionPlan u):
+        f = <MatrixCompletionPlan>MatrixCompletionPlan.__new__(MatrixCompletionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MatrixCompletionPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def latent_vector_size(self) -> int:
+        return self.underlying_.latent_vector_size()
+
+    @property
+    def lambda_(self) -> float:
+        return self.underlying_.lambda_()
+
+    @property
+    def learning_rate(self) -> float:
+        return self.underlying_.learning_rate()
+
+    @property
+    def decay_rate(self) -> float:
+        return self.underlying_.decay_rate()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def blocks_per_thread(self) -> int:
+        return self.underlying_.blocks_per_thread()
+
+    @staticmethod
+    def sgd(
+        latent_vector_size = kDefaultLatentVectorSize,
+        learning_rate = kDefaultLearningRate,
+        decay_rate = kDefaultDecayRate,
+        lambda_ = kDefaultLambda,
+        max_iterations = kDefaultMaxIterations,
+        tolerance = kDefaultTolerance,
+        blocks_per_thread = kDefaultBlocksPerThread,
+    ) -> MatrixCompletionPlan:
+        """
+        Stochastic gradient descent whose step size decays over epochs. The ratings are split into tiles that
+        threads process in parallel without locks. This algorithm has no deterministic mode.
+
+        :param latent_vector_size: The number of elements of each latent vector.
+        :param learning_rate: The base step size.
+        :param decay_rate: How fast the step size decays over epochs.
+        :param lambda_: The weight of the L2 regularization of the latent vectors.
+        :param max_iterations: The maximum number of epochs.
+        :param tolerance: Stop once an epoch improves the root mean square error by less than this fraction.
+        :param blocks_per_thread: The number of row blocks and of column blocks per thread.
+        """
+        return MatrixCompletionPlan.make(_MatrixCompletionPlan.Sgd(
+            latent_vector_size, learning_rate, decay_rate, lambda_, max_iterations, tolerance, blocks_per_thread))
+
+    @staticmethod
+    def als(
+        latent_vector_size = kDefaultLatentVectorSize,
+        lambda_ = kDefaultLambda,
+        max_iterations = kDefaultMaxIterations,
+        tolerance = kDefaultTolerance,
+    ) -> MatrixCompletionPlan:
+        """
+        Alternating least squares with weighted-lambda regularization. The result does not depend on the number of
+        threads.
+
+        :param latent_vector_size: The number of elements of each latent vector.
+        :param lambda_: The weight of the L2 regularization of the latent vectors.
+        :param max_iterations: The maximum number of alternations.
+        :param tolerance: Stop once an alternation improves the root mean square error by less than this fraction.
+        """
+        return MatrixCompletionPlan.make(_MatrixCompletionPlan.Als(
+            latent_vector_size, lambda_, max_iterations, tolerance))
+
+
+def matrix_completion(
+    PropertyGraph pg,
+    str rating_property_name,
+    str output_property_name,
+    MatrixCompletionPlan plan = MatrixCompletionPlan()
+):
+    """
+    Compute latent vectors for the nodes of pg that predict the ratings on its edges. The edges of pg must all go
+    from left nodes to right nodes.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type rating_property_name: str
+    :param rating_property_name: The integer or floating point edge property holding the rating of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output node property, a fixed size list of floats. This property must not
+        already exist.
+    :type plan: MatrixCompletionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string rating_property_name_str = rating_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(MatrixCompletion(
+            pg.underlying.get(), rating_property_name_str, output_property_name_str, plan.underlying_))
+    return v
+
+
+def matrix_completion_assert_valid(PropertyGraph pg, str rating_property_name, str property_name):
+    """
+    Raise an exception if the latent vectors in `pg` are not finite or predict the ratings no better than
+    predicting 0 for all of them.
+
+    :raises: AssertionError
+    """
+    cdef string rating_property_name_str = rating_property_name.encode("utf-8")
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MatrixCompletionAssertValid(
+            pg.underlying.get(), rating_property_name_str, property_name_str))
+
+
+cdef _MatrixCompletionStatistics handle_result_MatrixCompletionStatistics(
+    Result[_MatrixCompletionStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MatrixCompletionStatistics:
+    """
+    Compute the :ref:`statistics` of latent vectors.
+    """
+    cdef _MatrixCompletionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str rating_property_name, str property_name):
+        cdef string rating_property_name_str = rating_property_name.encode("utf-8")
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MatrixCompletionStatistics(_MatrixCompletionStatistics.Compute(
+                pg.underlying.get(), rating_property_name_str, property_name_str))
+
+    @property
+    def rmse(self) -> float:
+        return self.underlying.rmse
+
+    @property
+    def num_ratings(self) -> uint64_t:
+        return self.underlying.num_ratings
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,199 @@
+"""
+Max Flow
+--------
+
+A maximum flow sends as much flow as possible from a source node to a sink node without exceeding the capacity of
+any edge.
+
+.. autoclass:: katana.analytics.MaxFlowPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._max_flow._MaxFlowPlanAlgorithm
+
+.. autofunction:: katana.analytics.max_flow
+
+.. autoclass:: katana.analytics.MaxFlowStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.max_flow_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPushRelabel "katana::analytics::MaxFlowPlan::kPushRelabel"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        uint32_t global_relabel_alpha() const
+
+        MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PushRelabel(uint32_t global_relabel_alpha)
+
+    uint32_t kDefaultGlobalRelabelAlpha "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelAlpha"
+
+    Result[void] MaxFlow(_PropertyGraph* pg, uint32_t source, uint32_t sink, string capacity_property_name,
+                         string output_property_name, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(_PropertyGraph* pg, uint32_t source, uint32_t sink,
+                                    string capacity_property_name, string property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        uint64_t flow_value
+        uint64_t n_flow_edges
+        uint64_t n_saturated_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(_PropertyGraph* pg, uint32_t source, string capacity_property_name,
+                                           string property_name)
+
+
+class _MaxFlowPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: PushRelabel
+
+        Parallel push-relabel, discharging the highest nodes first, with global relabeling and gap detection.
+    """
+    PushRelabel = _MaxFlowPlan.Algorithm.kPushRelabel
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for max flow.
+
+    Static methods construct MaxFlowPlans.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowPlanAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MaxFlowPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def global_relabel_alpha(self) -> int:
+        return self.underlying_.global_relabel_alpha()
+
+    @staticmethod
+    def push_relabel(uint32_t global_relabel_alpha = kDefaultGlobalRelabelAlpha) -> MaxFlowPlan:
+        """
+        :param global_relabel_alpha: Heights are recomputed from scratch after about
+            global_relabel_alpha * num_nodes + num_edges / 3 units of work.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PushRelabel(global_relabel_alpha))
+
+
+def max_flow(
+    PropertyGraph pg,
+    uint32_t source,
+    uint32_t sink,
+    str capacity_property_name,
+    str output_property_name,
+    MaxFlowPlan plan = MaxFlowPlan()
+):
+    """
+    Compute a maximum flow from source to sink in pg. Parallel and antiparallel edges are separate arcs of the
+    network.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type source: int
+    :param source: The node the flow leaves.
+    :type sink: int
+    :param sink: The node the flow arrives at.
+    :type capacity_property_name: str
+    :param capacity_property_name: The non-negative integer edge property holding the capacity of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output edge property, of the same type as the capacities, holding the flow on
+        each edge. This property must not already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string capacity_property_name_str = capacity_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(MaxFlow(
+            pg.underlying.get(), source, sink, capacity_property_name_str, output_property_name_str,
+            plan.underlying_))
+    return v
+
+
+def max_flow_assert_valid(
+    PropertyGraph pg, uint32_t source, uint32_t sink, str capacity_property_name, str property_name
+):
+    """
+    Raise an exception if the flow in `pg` is not a maximum flow from source to sink.
+
+    :raises: AssertionError
+    """
+    cdef string capacity_property_name_str = capacity_property_name.encode("utf-8")
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MaxFlowAssertValid(
+            pg.underlying.get(), source, sink, capacity_property_name_str, property_name_str))
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics:
+    """
+    Compute the :ref:`statistics` of a flow.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, PropertyGraph pg, uint32_t source, str capacity_property_name, str property_name):
+        cdef string capacity_property_name_str = capacity_property_name.encode("utf-8")
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                pg.underlying.get(), source, capacity_property_name_str, property_name_str))
+
+    @property
+    def flow_value(self) -> uint64_t:
+        return self.underlying.flow_value
+
+    @property
+    def n_flow_edges(self) -> uint64_t:
+        return self.underlying.n_flow_edges
+
+    @property
+    def n_saturated_edges(self) -> uint64_t:
+        return self.underlying.n_saturated_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,203 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+A minimum spanning forest contains a minimum weight spanning tree of every connected component of the graph.
+
+.. autoclass:: katana.analytics.MinimumSpanningForestPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._minimum_spanning_forest._MinimumSpanningForestPlanAlgorithm
+
+.. autofunction:: katana.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.analytics.MinimumSpanningForestStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.minimum_spanning_forest_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint32_t kruskal_threshold() const
+
+        MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint32_t kruskal_threshold)
+
+    uint32_t kDefaultKruskalThreshold "katana::analytics::MinimumSpanningForestPlan::kDefaultKruskalThreshold"
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, string edge_weight_property_name,
+                                       string output_property_name, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, string edge_weight_property_name,
+                                                  string property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t forest_edges
+        uint64_t trees
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, string edge_weight_property_name,
+                                                        string property_name)
+
+
+class _MinimumSpanningForestPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: Boruvka
+
+        Every component picks its lightest outgoing edge and the components are merged along them, in rounds.
+
+    .. py:attribute:: FilterKruskal
+
+        Kruskal's algorithm on edges partitioned around pivots, dropping the edges inside a component before
+        sorting them.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for minimum spanning forest.
+
+    Static methods construct MinimumSpanningForestPlans.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestPlanAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MinimumSpanningForestPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def kruskal_threshold(self) -> int:
+        return self.underlying_.kruskal_threshold()
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(uint32_t kruskal_threshold = kDefaultKruskalThreshold) -> MinimumSpanningForestPlan:
+        """
+        :param kruskal_threshold: The number of edges at or under which partitioning stops and the edges are sorted.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(kruskal_threshold))
+
+
+def minimum_spanning_forest(
+    PropertyGraph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan()
+) -> int:
+    """
+    Compute a minimum spanning forest of pg, treating its edges as undirected. Edges of equal weight are ordered by
+    edge id, so every plan finds the same forest.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The integer or floating point edge property holding the weight of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output edge property, 1 for the edges in the forest and 0 otherwise. Of the two
+        copies of an edge in a symmetric graph, at most one is in the forest. This property must not already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(MinimumSpanningForest(
+            pg.underlying.get(), edge_weight_property_name_str, output_property_name_str, plan.underlying_))
+    return v
+
+
+def minimum_spanning_forest_assert_valid(PropertyGraph pg, str edge_weight_property_name, str property_name):
+    """
+    Raise an exception if the forest in `pg` is not a minimum spanning forest.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(
+            pg.underlying.get(), edge_weight_property_name_str, property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+    Result[_MinimumSpanningForestStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics:
+    """
+    Compute the :ref:`statistics` of a minimum spanning forest.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str edge_weight_property_name, str property_name):
+        cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                pg.underlying.get(), edge_weight_property_name_str, property_name_str))
+
+    @property
+    def forest_edges(self) -> uint64_t:
+        return self.underlying.forest_edges
+
+    @property
+    def trees(self) -> uint64_t:
+        return self.underlying.trees
+
+    @property
+    def total_weight(self) -> float:
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
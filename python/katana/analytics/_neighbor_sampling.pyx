@@ -0,0 +1,293 @@
+"""
+Neighbor Sampling
+-----------------
+
+Sample minibatches for training graph neural networks: the k-hop neighborhoods of seed nodes with a fanout per hop,
+and the features of the sampled nodes gathered into contiguous buffers. The arrays of a minibatch are
+:py:class:`~katana.property_graph.ArrayView` objects, which support DLPack, so ``torch.from_dlpack`` turns them into
+tensors without copying.
+
+.. autoclass:: katana.analytics.NeighborSamplingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._neighbor_sampling._NeighborSamplingPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.analytics.NeighborSampler
+    :members:
+    :special-members: __init__
+
+.. autoclass:: katana.analytics.Minibatch
+    :members:
+
+.. autoclass:: katana.analytics.MinibatchLoader
+    :members:
+"""
+from collections import namedtuple
+
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.memory cimport shared_ptr, static_pointer_cast, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from pyarrow.lib cimport CArray, CUInt32Array, CUInt64Array, pyarrow_wrap_array, to_shared
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+from katana.property_graph import ArrayView
+
+
+cdef extern from "katana/analytics/NeighborSampling.h" namespace "katana::analytics" nogil:
+    cppclass _NeighborSamplingPlan "katana::analytics::NeighborSamplingPlan" (_Plan):
+        enum Algorithm:
+            kUniform "katana::analytics::NeighborSamplingPlan::kUniform"
+
+        _NeighborSamplingPlan.Algorithm algorithm() const
+        const vector[uint32_t]& fanouts() const
+        bool replace() const
+        uint64_t seed() const
+
+        NeighborSamplingPlan()
+
+        @staticmethod
+        _NeighborSamplingPlan Uniform(vector[uint32_t] fanouts, bool replace, uint64_t seed)
+
+    cppclass _SampledBlock "katana::analytics::SampledBlock":
+        shared_ptr[CUInt32Array] sources
+        shared_ptr[CUInt32Array] destinations
+        shared_ptr[CUInt64Array] edges
+
+    cppclass _SampledMinibatch "katana::analytics::SampledMinibatch":
+        shared_ptr[CUInt32Array] nodes
+        vector[uint32_t] hop_sizes
+        vector[_SampledBlock] blocks
+        vector[shared_ptr[CArray]] features
+
+    cppclass _NeighborSampler "katana::analytics::NeighborSampler":
+        @staticmethod
+        Result[unique_ptr[_NeighborSampler]] Make(
+            const _PropertyGraph* pg, _NeighborSamplingPlan plan, const vector[string]& feature_properties
+        )
+
+        Result[_SampledMinibatch] Sample(const vector[uint32_t]& seeds)
+
+    cppclass _MinibatchLoader "katana::analytics::MinibatchLoader":
+        _MinibatchLoader(_NeighborSampler* sampler, vector[uint32_t] seeds, uint32_t batch_size)
+
+        uint64_t num_batches() const
+        bool done() const
+        Result[_SampledMinibatch] Next()
+
+
+cdef shared_ptr[_NeighborSampler] handle_result_sampler(Result[unique_ptr[_NeighborSampler]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+cdef _SampledMinibatch handle_result_minibatch(Result[_SampledMinibatch] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+class _NeighborSamplingPlanAlgorithm(Enum):
+    """
+    Uniform
+        Sample out-edges uniformly at random
+    """
+    Uniform = _NeighborSamplingPlan.Algorithm.kUniform
+
+
+cdef class NeighborSamplingPlan(Plan):
+    """
+    A computational :ref:`Plan` for neighbor sampling.
+
+    Static methods construct NeighborSamplingPlans. Random choices are drawn from streams seeded by the seed of the
+    plan and the number of the minibatch, so a sampler returns the same minibatches for any number of threads.
+    """
+    cdef:
+        _NeighborSamplingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _NeighborSamplingPlanAlgorithm
+
+    @staticmethod
+    cdef NeighborSamplingPlan make(_NeighborSamplingPlan u):
+        f = <NeighborSamplingPlan>NeighborSamplingPlan.__new__(NeighborSamplingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _NeighborSamplingPlanAlgorithm:
+        return _NeighborSamplingPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def fanouts(self) -> list:
+        return list(self.underlying_.fanouts())
+
+    @property
+    def replace(self) -> bool:
+        return self.underlying_.replace()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @staticmethod
+    def uniform(fanouts, bool replace = False, uint64_t seed = 0) -> NeighborSamplingPlan:
+        """
+        Sample `fanouts[h]` out-edges of each node at hop `h` uniformly at random, with the seeds at hop 0. Without
+        replacement, nodes with fewer out-edges than the fanout keep all of them.
+        """
+        return NeighborSamplingPlan.make(_NeighborSamplingPlan.Uniform(fanouts, replace, seed))
+
+
+Block = namedtuple("Block", ["sources", "destinations", "edges"])
+Block.__doc__ = """
+The edges sampled at one hop of a `Minibatch`, as `ArrayView` objects. Edge `i` was sampled for the node at index
+`destinations[i]` of the minibatch and leads to the node at index `sources[i]`; `edges[i]` is its ID in the graph.
+"""
+
+
+class Minibatch:
+    """
+    The sampled neighborhood of a minibatch of seed nodes.
+
+    :ivar nodes: An `ArrayView` of the IDs of the sampled nodes. The seeds come first, in the order given, followed by
+        the nodes first reached at hop 1, and so on.
+    :ivar hop_sizes: Entry `h` is the number of nodes at most `h` hops from the seeds.
+    :ivar blocks: Entry `h` is the `Block` of edges sampled for the first `hop_sizes[h]` nodes. A GNN of `k` layers
+        applies its first layer to `blocks[k - 1]` and its last to `blocks[0]`.
+    :ivar features: A dict from the name of each feature property to an `ArrayView` of its rows for `nodes`; fixed
+        size lists give two dimensional views.
+    """
+
+    def __init__(self, nodes, hop_sizes, blocks, features):
+        self.nodes = nodes
+        self.hop_sizes = hop_sizes
+        self.blocks = blocks
+        self.features = features
+
+
+cdef _view(shared_ptr[CArray] array):
+    return ArrayView.from_arrow(pyarrow_wrap_array(array))
+
+
+cdef _wrap_minibatch(_SampledMinibatch& batch, feature_properties):
+    cdef size_t h
+    blocks = []
+    for h in range(batch.blocks.size()):
+        blocks.append(
+            Block(
+                _view(static_pointer_cast[CArray, CUInt32Array](batch.blocks[h].sources)),
+                _view(static_pointer_cast[CArray, CUInt32Array](batch.blocks[h].destinations)),
+                _view(static_pointer_cast[CArray, CUInt64Array](batch.blocks[h].edges)),
+            )
+        )
+    features = {}
+    for i, name in enumerate(feature_properties):
+        features[name] = _view(batch.features[i])
+    return Minibatch(
+        _view(static_pointer_cast[CArray, CUInt32Array](batch.nodes)), list(batch.hop_sizes), blocks, features
+    )
+
+
+cdef class NeighborSampler:
+    """
+    Samples minibatches of a graph for training GNNs. Sampling releases the GIL; `loader` samples the next batch in
+    the background while the trainer consumes the current one.
+
+    A sampler keeps per node state for deduplicating neighbors, so one sampler should be reused for all the batches
+    of a graph.
+    """
+    cdef:
+        shared_ptr[_NeighborSampler] underlying
+        readonly PropertyGraph graph
+        readonly list feature_properties
+
+    def __init__(
+        self, PropertyGraph pg, NeighborSamplingPlan plan = NeighborSamplingPlan(), feature_properties = ()
+    ):
+        """
+        :type pg: PropertyGraph
+        :param pg: The graph to sample.
+        :type plan: NeighborSamplingPlan
+        :param plan: The fanouts and the seed of the sampler.
+        :param feature_properties: The names of node properties to gather for the sampled nodes. They must hold
+            integers, floating point numbers or fixed size lists of them without nulls.
+        """
+        cdef vector[string] names = [bytes(n, "utf-8") for n in feature_properties]
+        self.graph = pg
+        self.feature_properties = list(feature_properties)
+        with nogil:
+            self.underlying = handle_result_sampler(_NeighborSampler.Make(pg.underlying.get(), plan.underlying_, names))
+
+    def sample(self, seeds) -> Minibatch:
+        """
+        Sample the neighborhood of `seeds`, which must be distinct node IDs. Each call draws from the next random
+        streams of the plan.
+        """
+        cdef vector[uint32_t] seeds_vec = seeds
+        cdef _SampledMinibatch batch
+        with nogil:
+            batch = handle_result_minibatch(self.underlying.get().Sample(seeds_vec))
+        return _wrap_minibatch(batch, self.feature_properties)
+
+    def loader(self, seeds, uint32_t batch_size) -> MinibatchLoader:
+        """
+        Return an iterator over the minibatches of `seeds` split into batches of `batch_size`, in order. The sampler
+        must not be used in any other way, and no other Katana analytics may run, until the iterator is exhausted or
+        deleted.
+        """
+        return MinibatchLoader(self, seeds, batch_size)
+
+
+cdef class MinibatchLoader:
+    """
+    An iterator over the minibatches of a list of seeds, which samples batch N + 1 in the background while the
+    trainer consumes batch N. Made by :py:meth:`NeighborSampler.loader`.
+    """
+    cdef:
+        unique_ptr[_MinibatchLoader] underlying
+        readonly NeighborSampler sampler
+
+    def __init__(self, NeighborSampler sampler, seeds, uint32_t batch_size):
+        cdef vector[uint32_t] seeds_vec = seeds
+        if batch_size == 0:
+            raise ValueError("batch_size must be positive")
+        self.sampler = sampler
+        with nogil:
+            self.underlying.reset(new _MinibatchLoader(sampler.underlying.get(), seeds_vec, batch_size))
+
+    def __len__(self):
+        return self.underlying.get().num_batches()
+
+    def __iter__(self):
+        return self
+
+    def __next__(self) -> Minibatch:
+        cdef _SampledMinibatch batch
+        if self.underlying.get().done():
+            raise StopIteration
+        with nogil:
+            batch = handle_result_minibatch(self.underlying.get().Next())
+        return _wrap_minibatch(batch, self.sampler.feature_properties)
+
+    def __dealloc__(self):
+        # Waits for the batch in flight without holding the GIL
+        with nogil:
+            self.underlying.reset()
@@ -23,6 +23,7 @@ Page Rank
 
 .. autofunction:: katana.analytics.pagerank_assert_valid
 """
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
 
 from katana.analytics.plan cimport Plan, _Plan
@@ -41,6 +42,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPullBlocked "katana::analytics::PagerankPlan::kPullBlocked"
 
         # unsigned int kChunkSize
 
@@ -49,6 +51,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         unsigned int max_iterations() const
         float alpha() const
         float initial_residual() const
+        uint32_t block_nodes() const
+        uint64_t hub_degree() const
 
         PagerankPlan()
 
@@ -59,11 +63,15 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
-        _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
+        _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha, uint64_t hub_degree)
+        @staticmethod
+        _PagerankPlan PullBlocked(float tolerance, unsigned int max_iterations, float alpha, uint32_t block_nodes)
 
     double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
     double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
+    uint32_t kDefaultBlockNodes "katana::analytics::PagerankPlan::kDefaultBlockNodes"
+    uint64_t kDefaultHubDegree "katana::analytics::PagerankPlan::kDefaultHubDegree"
 
     Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan)
 
@@ -85,6 +93,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PullBlocked = _PagerankPlan.Algorithm.kPullBlocked
 
 
 cdef class PagerankPlan(Plan):
@@ -127,6 +136,14 @@ cdef class PagerankPlan(Plan):
     def initial_residual(self) -> float:
         return self.underlying_.initial_residual()
 
+    @property
+    def block_nodes(self) -> int:
+        return self.underlying_.block_nodes()
+
+    @property
+    def hub_degree(self) -> int:
+        return self.underlying_.hub_degree()
+
     @staticmethod
     def pull_topological(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
         """
@@ -145,6 +162,18 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullResidual(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_blocked(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha, uint32_t block_nodes = kDefaultBlockNodes):
+        """
+        Cache-blocked topological pull algorithm with vectorized gathers
+
+        Contributions of in-neighbors are summed in blocks of block_nodes
+        nodes when the edges of each node are sorted by destination.
+
+        The graph must be transposed to use this algorithm.
+        """
+        return PagerankPlan.make(_PagerankPlan.PullBlocked(tolerance, max_iterations, alpha, block_nodes))
+
     @staticmethod
     def push_asynchronous(float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha):
         """
@@ -157,14 +186,18 @@ cdef class PagerankPlan(Plan):
         return PagerankPlan.make(_PagerankPlan.PushAsynchronous(tolerance, alpha))
 
     @staticmethod
-    def push_synchronous(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+    def push_synchronous(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha, uint64_t hub_degree = kDefaultHubDegree):
         """
         Synchronous push algorithm
 
         This implementation is based on the Push-based PageRank computation
         (Algorithm 4) as described in the PageRank Europar 2015 paper [WHANG]_.
+
+        If hub_degree is not 0, pushes into nodes with more than hub_degree
+        in or out-edges are spread over several slots and merged after each
+        round, which reduces contention on skewed graphs.
         """
-        return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha))
+        return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha, hub_degree))
 
 
 def pagerank(PropertyGraph pg, str output_property_name, PagerankPlan plan = PagerankPlan()):
@@ -0,0 +1,237 @@
+"""
+Partition
+---------
+
+Divide the nodes of a graph into balanced partitions with few edges between them, for example to shard a graph among
+hosts.
+
+.. autoclass:: katana.analytics.PartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._partition._PartitionPlanAlgorithm
+
+.. autoclass:: katana.analytics.PartitionObjective
+
+.. autofunction:: katana.analytics.partition
+
+.. autoclass:: katana.analytics.PartitionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.partition_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/partition/partition.h" namespace "katana::analytics" nogil:
+    enum _PartitionObjective "katana::analytics::PartitionObjective":
+        kNodeBalancedCut "katana::analytics::PartitionObjective::kNodeBalancedCut"
+        kEdgeBalancedCut "katana::analytics::PartitionObjective::kEdgeBalancedCut"
+
+    cppclass _PartitionPlan "katana::analytics::PartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::PartitionPlan::kMultilevel"
+
+        _PartitionPlan.Algorithm algorithm() const
+        uint32_t coarse_nodes_per_partition() const
+        double imbalance() const
+        uint32_t refinement_rounds() const
+
+        PartitionPlan()
+
+        @staticmethod
+        _PartitionPlan Multilevel(uint32_t coarse_nodes_per_partition, double imbalance, uint32_t refinement_rounds)
+
+    uint32_t kDefaultCoarseNodesPerPartition "katana::analytics::PartitionPlan::kDefaultCoarseNodesPerPartition"
+    double kDefaultImbalance "katana::analytics::PartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultRefinementRounds "katana::analytics::PartitionPlan::kDefaultRefinementRounds"
+
+    Result[void] Partition(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name,
+                           _PartitionObjective objective, _PartitionPlan plan)
+
+    Result[void] PartitionAssertValid(_PropertyGraph* pg, uint32_t num_partitions, string property_name)
+
+    cppclass _PartitionStatistics "katana::analytics::PartitionStatistics":
+        uint32_t num_partitions
+        uint64_t cut_edges
+        uint64_t communication_volume
+        double node_imbalance
+        double edge_imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_PartitionStatistics] Compute(_PropertyGraph* pg, uint32_t num_partitions, string property_name)
+
+
+class PartitionObjective(Enum):
+    """
+    What a partition keeps balanced while it minimizes the number of edges between partitions.
+
+    .. py:attribute:: NodeBalancedCut
+
+        Every partition has about the same number of nodes.
+
+    .. py:attribute:: EdgeBalancedCut
+
+        Every partition has about the same number of nodes plus outgoing edges.
+    """
+    NodeBalancedCut = _PartitionObjective.kNodeBalancedCut
+    EdgeBalancedCut = _PartitionObjective.kEdgeBalancedCut
+
+
+class _PartitionPlanAlgorithm(Enum):
+    """
+    .. py:attribute:: Multilevel
+
+        Coarsen the graph by heavy edge matching, bisect the coarsest graph recursively, and move boundary nodes to
+        better partitions while projecting the partition back to the original graph.
+    """
+    Multilevel = _PartitionPlan.Algorithm.kMultilevel
+
+
+cdef class PartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for partition.
+
+    Static methods construct PartitionPlans.
+    """
+    cdef:
+        _PartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PartitionPlanAlgorithm
+
+    @staticmethod
+    cdef PartitionPlan make(_PartitionPlan u):
+        f = <PartitionPlan>PartitionPlan.__new__(PartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> PartitionPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def coarse_nodes_per_partition(self) -> int:
+        return self.underlying_.coarse_nodes_per_partition()
+
+    @property
+    def imbalance(self) -> float:
+        return self.underlying_.imbalance()
+
+    @property
+    def refinement_rounds(self) -> int:
+        return self.underlying_.refinement_rounds()
+
+    @staticmethod
+    def multilevel(
+        uint32_t coarse_nodes_per_partition = kDefaultCoarseNodesPerPartition,
+        double imbalance = kDefaultImbalance,
+        uint32_t refinement_rounds = kDefaultRefinementRounds
+    ) -> PartitionPlan:
+        """
+        :param coarse_nodes_per_partition: Coarsening stops once the graph has at most this many nodes per partition.
+        :param imbalance: How much heavier than the average a partition may be, as a fraction of the average.
+        :param refinement_rounds: The maximum number of rounds of boundary node moves at each level.
+        """
+        return PartitionPlan.make(_PartitionPlan.Multilevel(coarse_nodes_per_partition, imbalance, refinement_rounds))
+
+
+def partition(
+    PropertyGraph pg,
+    uint32_t num_partitions,
+    str output_property_name,
+    objective = PartitionObjective.NodeBalancedCut,
+    PartitionPlan plan = PartitionPlan()
+) -> int:
+    """
+    Divide the nodes of pg into `num_partitions` partitions, treating its edges as undirected, so that few edges join
+    different partitions and the partitions are balanced as `objective` asks.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output node property holding the partition of each node, from 0 to
+        num_partitions - 1. This property must not already exist.
+    :type objective: PartitionObjective
+    :param objective: What the partitions keep balanced.
+    :type plan: PartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    cdef _PartitionObjective objective_value = <_PartitionObjective><int>PartitionObjective(objective).value
+    with nogil:
+        v = handle_result_void(Partition(
+            pg.underlying.get(), num_partitions, output_property_name_str, objective_value, plan.underlying_))
+    return v
+
+
+def partition_assert_valid(PropertyGraph pg, uint32_t num_partitions, str property_name):
+    """
+    Raise an exception if some node in `pg` is not in one of `num_partitions` partitions.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(PartitionAssertValid(pg.underlying.get(), num_partitions, property_name_str))
+
+
+cdef _PartitionStatistics handle_result_PartitionStatistics(Result[_PartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class PartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a partition.
+    """
+    cdef _PartitionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, uint32_t num_partitions, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_PartitionStatistics(_PartitionStatistics.Compute(
+                pg.underlying.get(), num_partitions, property_name_str))
+
+    @property
+    def num_partitions(self) -> uint32_t:
+        return self.underlying.num_partitions
+
+    @property
+    def cut_edges(self) -> uint64_t:
+        return self.underlying.cut_edges
+
+    @property
+    def communication_volume(self) -> uint64_t:
+        return self.underlying.communication_volume
+
+    @property
+    def node_imbalance(self) -> float:
+        return self.underlying.node_imbalance
+
+    @property
+    def edge_imbalance(self) -> float:
+        return self.underlying.edge_imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,349 @@
+"""
+Spectral Centrality
+-------------------
+
+Eigenvector, Katz and HITS centrality are computed by power iteration, pulling along the in-edges of each node from
+a transposed copy of the graph.
+
+.. autoclass:: katana.analytics.EigenvectorCentralityPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autofunction:: katana.analytics.eigenvector_centrality
+
+.. autoclass:: katana.analytics.KatzCentralityPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autofunction:: katana.analytics.katz_centrality
+
+.. autoclass:: katana.analytics.HitsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autofunction:: katana.analytics.hits
+
+.. autoclass:: katana.analytics._spectral_centrality._SpectralCentralityPlanPrecision
+    :members:
+    :undoc-members:
+"""
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport handle_result_void, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/spectral_centrality/spectral_centrality.h" namespace "katana::analytics" nogil:
+    cppclass _SpectralCentralityPlan "katana::analytics::SpectralCentralityPlan" (_Plan):
+        enum Precision:
+            kFloat32 "katana::analytics::SpectralCentralityPlan::kFloat32"
+            kFloat64 "katana::analytics::SpectralCentralityPlan::kFloat64"
+
+    double kDefaultTolerance "katana::analytics::SpectralCentralityPlan::kDefaultTolerance"
+    unsigned int kDefaultMaxIterations "katana::analytics::SpectralCentralityPlan::kDefaultMaxIterations"
+
+    cppclass _EigenvectorCentralityPlan "katana::analytics::EigenvectorCentralityPlan" (_Plan):
+        double tolerance() const
+        unsigned int max_iterations() const
+        _SpectralCentralityPlan.Precision precision() const
+
+        EigenvectorCentralityPlan()
+
+        @staticmethod
+        _EigenvectorCentralityPlan PowerIteration(
+            double tolerance, unsigned int max_iterations, _SpectralCentralityPlan.Precision precision)
+
+    cppclass _KatzCentralityPlan "katana::analytics::KatzCentralityPlan" (_Plan):
+        double tolerance() const
+        unsigned int max_iterations() const
+        _SpectralCentralityPlan.Precision precision() const
+        double alpha() const
+        double beta() const
+        bool normalized() const
+
+        KatzCentralityPlan()
+
+        @staticmethod
+        _KatzCentralityPlan PowerIteration(
+            double alpha, double beta, bool normalized, double tolerance, unsigned int max_iterations,
+            _SpectralCentralityPlan.Precision precision)
+
+    double kDefaultAlpha "katana::analytics::KatzCentralityPlan::kDefaultAlpha"
+    double kDefaultBeta "katana::analytics::KatzCentralityPlan::kDefaultBeta"
+    bool kDefaultNormalized "katana::analytics::KatzCentralityPlan::kDefaultNormalized"
+
+    cppclass _HitsPlan "katana::analytics::HitsPlan" (_Plan):
+        double tolerance() const
+        unsigned int max_iterations() const
+        _SpectralCentralityPlan.Precision precision() const
+
+        HitsPlan()
+
+        @staticmethod
+        _HitsPlan PowerIteration(
+            double tolerance, unsigned int max_iterations, _SpectralCentralityPlan.Precision precision)
+
+    Result[void] EigenvectorCentrality(_PropertyGraph* pg, string output_property_name,
+                                       _EigenvectorCentralityPlan plan)
+
+    Result[void] KatzCentrality(_PropertyGraph* pg, string output_property_name, _KatzCentralityPlan plan)
+
+    Result[void] Hits(_PropertyGraph* pg, string hub_property_name, string authority_property_name, _HitsPlan plan)
+
+
+class _SpectralCentralityPlanPrecision(Enum):
+    """
+    The type of the values computed and of the output properties.
+
+    .. py:attribute:: Float32
+
+        float32 values.
+
+    .. py:attribute:: Float64
+
+        float64 values.
+    """
+    Float32 = _SpectralCentralityPlan.Precision.kFloat32
+    Float64 = _SpectralCentralityPlan.Precision.kFloat64
+
+
+cdef _SpectralCentralityPlan.Precision to_precision(precision):
+    return <_SpectralCentralityPlan.Precision><int>_SpectralCentralityPlanPrecision(precision).value
+
+
+cdef class EigenvectorCentralityPlan(Plan):
+    """
+    A computational :ref:`Plan` for eigenvector centrality.
+
+    Static methods construct EigenvectorCentralityPlans.
+    """
+    cdef:
+        _EigenvectorCentralityPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Precision = _SpectralCentralityPlanPrecision
+
+    @staticmethod
+    cdef EigenvectorCentralityPlan make(_EigenvectorCentralityPlan u):
+        f = <EigenvectorCentralityPlan>EigenvectorCentralityPlan.__new__(EigenvectorCentralityPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def precision(self) -> _SpectralCentralityPlanPrecision:
+        return _SpectralCentralityPlanPrecision(self.underlying_.precision())
+
+    @staticmethod
+    def power_iteration(
+        double tolerance = kDefaultTolerance,
+        unsigned int max_iterations = kDefaultMaxIterations,
+        precision = _SpectralCentralityPlanPrecision.Float64,
+    ) -> EigenvectorCentralityPlan:
+        """
+        Power iteration of the transposed adjacency matrix plus the identity, normalized to unit length after every
+        iteration.
+
+        :param tolerance: Stop once the values of all nodes change by less than num_nodes * tolerance in total.
+        :param max_iterations: Stop after this many iterations.
+        :param precision: The type of the values computed and of the output property.
+        """
+        return EigenvectorCentralityPlan.make(_EigenvectorCentralityPlan.PowerIteration(
+            tolerance, max_iterations, to_precision(precision)))
+
+
+cdef class KatzCentralityPlan(Plan):
+    """
+    A computational :ref:`Plan` for Katz centrality.
+
+    Static methods construct KatzCentralityPlans.
+    """
+    cdef:
+        _KatzCentralityPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Precision = _SpectralCentralityPlanPrecision
+
+    @staticmethod
+    cdef KatzCentralityPlan make(_KatzCentralityPlan u):
+        f = <KatzCentralityPlan>KatzCentralityPlan.__new__(KatzCentralityPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def precision(self) -> _SpectralCentralityPlanPrecision:
+        return _SpectralCentralityPlanPrecision(self.underlying_.precision())
+
+    @property
+    def alpha(self) -> float:
+        return self.underlying_.alpha()
+
+    @property
+    def beta(self) -> float:
+        return self.underlying_.beta()
+
+    @property
+    def normalized(self) -> bool:
+        return self.underlying_.normalized()
+
+    @staticmethod
+    def power_iteration(
+        double alpha = kDefaultAlpha,
+        double beta = kDefaultBeta,
+        bool normalized = kDefaultNormalized,
+        double tolerance = kDefaultTolerance,
+        unsigned int max_iterations = kDefaultMaxIterations,
+        precision = _SpectralCentralityPlanPrecision.Float64,
+    ) -> KatzCentralityPlan:
+        """
+        Iterate x = alpha A^T x + beta from x = 0.
+
+        :param alpha: The attenuation of each step of a walk. The iteration converges only if alpha is below the
+            inverse of the largest eigenvalue of the adjacency matrix.
+        :param beta: The centrality every node has regardless of its in-neighbors.
+        :param normalized: Scale the result to unit length.
+        :param tolerance: Stop once the values of all nodes change by less than num_nodes * tolerance in total.
+        :param max_iterations: Stop after this many iterations.
+        :param precision: The type of the values computed and of the output property.
+        """
+        return KatzCentralityPlan.make(_KatzCentralityPlan.PowerIteration(
+            alpha, beta, normalized, tolerance, max_iterations, to_precision(precision)))
+
+
+cdef class HitsPlan(Plan):
+    """
+    A computational :ref:`Plan` for HITS hub and authority scores.
+
+    Static methods construct HitsPlans.
+    """
+    cdef:
+        _HitsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Precision = _SpectralCentralityPlanPrecision
+
+    @staticmethod
+    cdef HitsPlan make(_HitsPlan u):
+        f = <HitsPlan>HitsPlan.__new__(HitsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def precision(self) -> _SpectralCentralityPlanPrecision:
+        return _SpectralCentralityPlanPrecision(self.underlying_.precision())
+
+    @staticmethod
+    def power_iteration(
+        double tolerance = kDefaultTolerance,
+        unsigned int max_iterations = kDefaultMaxIterations,
+        precision = _SpectralCentralityPlanPrecision.Float64,
+    ) -> HitsPlan:
+        """
+        Alternate authority = A^T hub and hub = A authority, scaling both to a largest value of 1 after every
+        iteration and to a sum of 1 at the end.
+
+        :param tolerance: Stop once the hubs of all nodes change by less than num_nodes * tolerance in total.
+        :param max_iterations: Stop after this many iterations.
+        :param precision: The type of the values computed and of the output properties.
+        """
+        return HitsPlan.make(_HitsPlan.PowerIteration(
+            tolerance, max_iterations, to_precision(precision)))
+
+
+def eigenvector_centrality(
+    PropertyGraph pg, str output_property_name, EigenvectorCentralityPlan plan = EigenvectorCentralityPlan()
+):
+    """
+    Compute the eigenvector centrality of each node in the graph: the entry of the principal eigenvector of the
+    transposed adjacency matrix, so a node is central if its in-neighbors are.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to store the centrality. This property must not already exist.
+    :type plan: EigenvectorCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(EigenvectorCentrality(pg.underlying.get(), output_property_name_cstr, plan.underlying_))
+
+
+def katz_centrality(PropertyGraph pg, str output_property_name, KatzCentralityPlan plan = KatzCentralityPlan()):
+    """
+    Compute the Katz centrality of each node in the graph: beta times the number of walks that end at the node, each
+    attenuated by alpha per step.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to store the centrality. This property must not already exist.
+    :type plan: KatzCentralityPlan
+    :param plan: The execution plan to use.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(KatzCentrality(pg.underlying.get(), output_property_name_cstr, plan.underlying_))
+
+
+def hits(PropertyGraph pg, str hub_property_name, str authority_property_name, HitsPlan plan = HitsPlan()):
+    """
+    Compute the hub and authority scores of each node in the graph. A node is a good authority if good hubs point to
+    it and a good hub if it points to good authorities.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type hub_property_name: str
+    :param hub_property_name: The output property to store the hub scores. This property must not already exist.
+    :type authority_property_name: str
+    :param authority_property_name: The output property to store the authority scores. This property must not
+        already exist.
+    :type plan: HitsPlan
+    :param plan: The execution plan to use.
+    """
+    hub_property_name_bytes = bytes(hub_property_name, "utf-8")
+    hub_property_name_cstr = <string>hub_property_name_bytes
+    authority_property_name_bytes = bytes(authority_property_name, "utf-8")
+    authority_property_name_cstr = <string>authority_property_name_bytes
+    with nogil:
+        handle_result_void(Hits(pg.underlying.get(), hub_property_name_cstr, authority_property_name_cstr,
+                                plan.underlying_))
@@ -11,6 +11,13 @@ Single-Source Shortest Path
 
 .. autofunction:: katana.analytics.sssp
 
+.. autofunction:: katana.analytics.sssp_quantize_edge_weights
+
+.. autoclass:: katana.analytics.MultiSourceSsspPlan
+    :members:
+
+.. autofunction:: katana.analytics.multi_source_sssp
+
 .. autoclass:: katana.analytics.SsspStatistics
     :members:
     :undoc-members:
@@ -22,6 +29,7 @@ from enum import Enum
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana.analytics.plan cimport _Plan, Plan, Statistics
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -43,6 +51,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kTopological "katana::analytics::SsspPlan::kTopological"
             kTopologicalTile "katana::analytics::SsspPlan::kTopologicalTile"
             kAutomatic "katana::analytics::SsspPlan::kAutomatic"
+            kDeltaStepAdaptive "katana::analytics::SsspPlan::kDeltaStepAdaptive"
+            kMultiQueue "katana::analytics::SsspPlan::kMultiQueue"
 
         _SsspPlan()
         _SsspPlan(const _PropertyGraph * pg)
@@ -70,12 +80,35 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan TopologicalTile(ptrdiff_t edge_tile_size)
 
+        @staticmethod
+        _SsspPlan DeltaStepAdaptive()
+        @staticmethod
+        _SsspPlan MultiQueue()
+
     unsigned kDefaultDelta "katana::analytics::SsspPlan::kDefaultDelta"
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::SsspPlan::kDefaultEdgeTileSize"
 
     Result[void] Sssp(_PropertyGraph* pg, size_t start_node,
         const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
 
+    Result[double] SsspQuantizeEdgeWeights(_PropertyGraph* pg, const string& edge_weight_property_name,
+                                           const string& output_property_name, uint32_t bits)
+
+    cppclass _MultiSourceSsspPlan "katana::analytics::MultiSourceSsspPlan" (_Plan):
+        unsigned delta() const
+        uint32_t batch_size() const
+
+        _MultiSourceSsspPlan()
+
+        @staticmethod
+        _MultiSourceSsspPlan DeltaStep(unsigned delta, uint32_t batch_size)
+
+    uint32_t kDefaultMultiSourceBatchSize "katana::analytics::MultiSourceSsspPlan::kDefaultBatchSize"
+
+    Result[void] MultiSourceSssp(_PropertyGraph* pg, const vector[uint32_t]& sources,
+                                 const string& edge_weight_property_name, const string& output_property_name,
+                                 _MultiSourceSsspPlan plan)
+
     Result[void] SsspAssertValid(_PropertyGraph* pg, size_t start_node,
                                  const string& edge_weight_property_name, const string& output_property_name);
 
@@ -116,6 +149,10 @@ class _SsspAlgorithm(Enum):
         Topological tiled
     Automatic
         Choose an algorithm using heuristics
+    DeltaStepAdaptive
+        Delta stepping with a delta that is estimated up front and retuned during the run
+    MultiQueue
+        Dijkstra's algorithm on a relaxed concurrent priority queue, which needs no delta
     """
     DeltaTile = _SsspPlan.Algorithm.kDeltaTile
     DeltaStep = _SsspPlan.Algorithm.kDeltaStep
@@ -127,6 +164,8 @@ class _SsspAlgorithm(Enum):
     Topological = _SsspPlan.Algorithm.kTopological
     TopologicalTile = _SsspPlan.Algorithm.kTopologicalTile
     Automatic = _SsspPlan.Algorithm.kAutomatic
+    DeltaStepAdaptive = _SsspPlan.Algorithm.kDeltaStepAdaptive
+    MultiQueue = _SsspPlan.Algorithm.kMultiQueue
 
 
 cdef class SsspPlan(Plan):
@@ -208,6 +247,12 @@ cdef class SsspPlan(Plan):
     @staticmethod
     def topological_tile(ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         return SsspPlan.make(_SsspPlan.TopologicalTile(edge_tile_size))
+    @staticmethod
+    def delta_step_adaptive() -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.DeltaStepAdaptive())
+    @staticmethod
+    def multi_queue() -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.MultiQueue())
 
 
 def sssp(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
@@ -233,6 +278,95 @@ def sssp(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str
         handle_result_void(Sssp(pg.underlying.get(), start_node, edge_weight_property_name_str,
                                 output_property_name_str, plan.underlying_))
 
+cdef double handle_result_double(Result[double] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def sssp_quantize_edge_weights(PropertyGraph pg, str edge_weight_property_name, str output_property_name,
+                               uint32_t bits = 16) -> float:
+    """
+    Store the non-negative edge weights in `edge_weight_property_name` as `bits`-bit (8 or 16) unsigned ints in the
+    new edge property `output_property_name`, which `sssp` can then use as its weights.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to modify.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights.
+    :type output_property_name: str
+    :param output_property_name: The output property to write quantized weights into. This property must not already
+        exist.
+    :type bits: int
+    :param bits: The width of the quantized weights, 8 or 16.
+    :return: The scale of the quantized weights: path lengths computed from them times the scale approximate the
+        path lengths computed from the original weights. Integer weights that already fit are copied exactly and
+        have a scale of 1.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        v = handle_result_double(SsspQuantizeEdgeWeights(pg.underlying.get(), edge_weight_property_name_str,
+                                                         output_property_name_str, bits))
+    return v
+
+
+cdef class MultiSourceSsspPlan(Plan):
+    """
+    A computational :ref:`Plan` for multi-source shortest paths.
+    """
+
+    cdef:
+        _MultiSourceSsspPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    @staticmethod
+    cdef MultiSourceSsspPlan make(_MultiSourceSsspPlan u):
+        f = <MultiSourceSsspPlan>MultiSourceSsspPlan.__new__(MultiSourceSsspPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def delta(self) -> int:
+        """
+        The exponent of the delta step size (2 based).
+        """
+        return self.underlying_.delta()
+
+    @property
+    def batch_size(self) -> int:
+        """
+        The number of sources searched together, at most 64.
+        """
+        return self.underlying_.batch_size()
+
+    @staticmethod
+    def delta_step(unsigned delta = kDefaultDelta,
+                   uint32_t batch_size = kDefaultMultiSourceBatchSize) -> MultiSourceSsspPlan:
+        return MultiSourceSsspPlan.make(_MultiSourceSsspPlan.DeltaStep(delta, batch_size))
+
+
+def multi_source_sssp(PropertyGraph pg, sources, str edge_weight_property_name, str output_property_name,
+                      MultiSourceSsspPlan plan = MultiSourceSsspPlan.delta_step()):
+    """
+    Compute the shortest path lengths from each of `sources` to every node of `pg`. Batches of sources share one
+    traversal, which is much faster than calling `sssp` once per source.
+
+    The distances are written to the property `output_property_name`, which must not already exist, as a fixed size
+    list per node whose entry `i` is the distance from `sources[i]`. They are doubles for floating-point weights and
+    uint64 otherwise; nodes a source does not reach get infinity or the largest uint64 respectively.
+    """
+    cdef vector[uint32_t] sources_vec = sources
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MultiSourceSssp(pg.underlying.get(), sources_vec, edge_weight_property_name_str,
+                                           output_property_name_str, plan.underlying_))
+
+
 def sssp_assert_valid(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str output_property_name):
     """
     Raise an exception if the SSSP results in `pg` with the given parameters appear to be incorrect. This is not an
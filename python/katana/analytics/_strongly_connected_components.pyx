@@ -0,0 +1,186 @@
+"""
+Strongly Connected Components
+-----------------------------
+
+.. autoclass:: katana.analytics.StronglyConnectedComponentsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._strongly_connected_components._StronglyConnectedComponentsPlanAlgorithm
+
+.. autofunction:: katana.analytics.strongly_connected_components
+
+.. autoclass:: katana.analytics.StronglyConnectedComponentsStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.strongly_connected_components_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.analytics.plan cimport Plan, _Plan
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/strongly_connected_components/strongly_connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _StronglyConnectedComponentsPlan "katana::analytics::StronglyConnectedComponentsPlan" (_Plan):
+        enum Algorithm:
+            kMultistep "katana::analytics::StronglyConnectedComponentsPlan::kMultistep"
+            kColoring "katana::analytics::StronglyConnectedComponentsPlan::kColoring"
+
+        _StronglyConnectedComponentsPlan.Algorithm algorithm() const
+        uint32_t trim_rounds() const
+
+        StronglyConnectedComponentsPlan()
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Multistep(uint32_t trim_rounds)
+        @staticmethod
+        _StronglyConnectedComponentsPlan Coloring(uint32_t trim_rounds)
+
+    uint32_t kDefaultTrimRounds "katana::analytics::StronglyConnectedComponentsPlan::kDefaultTrimRounds"
+
+    Result[void] StronglyConnectedComponents(_PropertyGraph* pg, string output_property_name, _StronglyConnectedComponentsPlan plan)
+
+    Result[void] StronglyConnectedComponentsAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _StronglyConnectedComponentsStatistics "katana::analytics::StronglyConnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t total_non_trivial_components
+        uint64_t largest_component_size
+        double largest_component_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_StronglyConnectedComponentsStatistics] Compute(_PropertyGraph* pg, string property_name)
+
+
+class _StronglyConnectedComponentsPlanAlgorithm(Enum):
+    """
+    Multistep
+        Trimming, a forward-backward search for the largest component and coloring
+    Coloring
+        Trimming and coloring
+    """
+    Multistep = _StronglyConnectedComponentsPlan.Algorithm.kMultistep
+    Coloring = _StronglyConnectedComponentsPlan.Algorithm.kColoring
+
+
+cdef class StronglyConnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for Strongly Connected Components.
+
+    Static methods construct StronglyConnectedComponentsPlans.
+    """
+    cdef:
+        _StronglyConnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _StronglyConnectedComponentsPlanAlgorithm
+
+    @staticmethod
+    cdef StronglyConnectedComponentsPlan make(_StronglyConnectedComponentsPlan u):
+        f = <StronglyConnectedComponentsPlan>StronglyConnectedComponentsPlan.__new__(StronglyConnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> StronglyConnectedComponentsPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def trim_rounds(self) -> int:
+        return self.underlying_.trim_rounds()
+
+    @staticmethod
+    def multistep(uint32_t trim_rounds = kDefaultTrimRounds) -> StronglyConnectedComponentsPlan:
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Multistep(trim_rounds))
+
+    @staticmethod
+    def coloring(uint32_t trim_rounds = kDefaultTrimRounds) -> StronglyConnectedComponentsPlan:
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Coloring(trim_rounds))
+
+
+def strongly_connected_components(
+    PropertyGraph pg, str output_property_name, StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan()
+) -> int:
+    """
+    Compute the strongly connected components of pg, treating its edges as directed.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the id of a representative node of the component of
+        each node. This property must not already exist.
+    :type plan: StronglyConnectedComponentsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(StronglyConnectedComponents(pg.underlying.get(), output_property_name_str, plan.underlying_))
+    return v
+
+
+def strongly_connected_components_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if the strongly connected components results in `pg` are invalid.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(StronglyConnectedComponentsAssertValid(pg.underlying.get(), property_name_str))
+
+
+cdef _StronglyConnectedComponentsStatistics handle_result_StronglyConnectedComponentsStatistics(
+    Result[_StronglyConnectedComponentsStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class StronglyConnectedComponentsStatistics:
+    """
+    Compute the :ref:`statistics` of a Strongly Connected Components result.
+    """
+    cdef _StronglyConnectedComponentsStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_StronglyConnectedComponentsStatistics(
+                _StronglyConnectedComponentsStatistics.Compute(pg.underlying.get(), property_name_str)
+            )
+
+    @property
+    def total_components(self) -> uint64_t:
+        return self.underlying.total_components
+
+    @property
+    def total_non_trivial_components(self) -> uint64_t:
+        return self.underlying.total_non_trivial_components
+
+    @property
+    def largest_component_size(self) -> uint64_t:
+        return self.underlying.largest_component_size
+
+    @property
+    def largest_component_ratio(self) -> double:
+        return self.underlying.largest_component_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
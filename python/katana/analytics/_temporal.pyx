@@ -0,0 +1,194 @@
+"""
+Temporal Analytics
+------------------
+
+The edges of each node must be sorted by an integer or timestamp edge property, e.g., with
+:py:func:`~katana.analytics.sort_all_edges_by_time`. The analytics find the edges of a time window by binary search, so
+windows are analyzed without extracting them.
+
+.. autoclass:: katana.analytics.EarliestArrivalPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._temporal._EarliestArrivalPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.earliest_arrival
+
+.. autofunction:: katana.analytics.temporal_pagerank
+"""
+from libc.stdint cimport int64_t, uint32_t
+from libcpp.string cimport string
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport handle_result_void, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analytics" nogil:
+    cppclass _PagerankPlan "katana::analytics::PagerankPlan" (_Plan):
+        PagerankPlan()
+
+        @staticmethod
+        _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
+
+    double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
+    int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
+    double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
+
+
+cdef extern from "katana/analytics/temporal/temporal.h" namespace "katana::analytics" nogil:
+    cppclass _EarliestArrivalPlan "katana::analytics::EarliestArrivalPlan" (_Plan):
+        enum Algorithm:
+            kFrontier "katana::analytics::EarliestArrivalPlan::kFrontier"
+
+        _EarliestArrivalPlan.Algorithm algorithm() const
+
+        EarliestArrivalPlan()
+
+        @staticmethod
+        _EarliestArrivalPlan Frontier()
+
+    int64_t kUnreachable "katana::analytics::EarliestArrivalPlan::kUnreachable"
+
+    Result[void] EarliestArrival(_PropertyGraph* pg, uint32_t source, string time_property, int64_t begin_time,
+                                 int64_t end_time, string output_property_name, _EarliestArrivalPlan plan)
+
+    Result[void] TemporalPagerank(_PropertyGraph* pg, string time_property, int64_t begin_time, int64_t end_time,
+                                  string output_property_name, _PagerankPlan plan)
+
+
+class _EarliestArrivalPlanAlgorithm(Enum):
+    """
+    Frontier
+        Relax the out-edges of the nodes whose arrival improved, one frontier per round
+    """
+    Frontier = _EarliestArrivalPlan.Algorithm.kFrontier
+
+
+cdef class EarliestArrivalPlan(Plan):
+    """
+    A computational :ref:`Plan` for Earliest Arrival.
+
+    Static methods construct EarliestArrivalPlans.
+    """
+    cdef:
+        _EarliestArrivalPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _EarliestArrivalPlanAlgorithm
+
+    unreachable = kUnreachable
+
+    @staticmethod
+    cdef EarliestArrivalPlan make(_EarliestArrivalPlan u):
+        f = <EarliestArrivalPlan>EarliestArrivalPlan.__new__(EarliestArrivalPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _EarliestArrivalPlanAlgorithm:
+        return _EarliestArrivalPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def frontier() -> EarliestArrivalPlan:
+        """
+        Relax the out-edges of the nodes whose arrival improved, one frontier per round. A node only relaxes its edges
+        between its new arrival and the arrival it last relaxed from, so every edge is relaxed at most once.
+        """
+        return EarliestArrivalPlan.make(_EarliestArrivalPlan.Frontier())
+
+
+def earliest_arrival(
+    PropertyGraph pg,
+    uint32_t source,
+    str time_property,
+    int64_t begin_time,
+    int64_t end_time,
+    str output_property_name,
+    EarliestArrivalPlan plan = EarliestArrivalPlan(),
+):
+    """
+    Compute the earliest time at which each node can be reached from `source` by a path whose edges have times in
+    [`begin_time`, `end_time`) that do not decrease along the path. The source is reached at `begin_time`; nodes that
+    cannot be reached get :py:attr:`EarliestArrivalPlan.unreachable`.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze. Its edges must be sorted by `time_property`.
+    :type source: int
+    :param source: The node the paths start from.
+    :type time_property: str
+    :param time_property: The integer or timestamp edge property with the time of each edge.
+    :type begin_time: int
+    :param begin_time: The first time of the window, in the units of `time_property`.
+    :type end_time: int
+    :param end_time: The time just past the window.
+    :type output_property_name: str
+    :param output_property_name: The int64 node property to create with the arrival times.
+    :type plan: EarliestArrivalPlan
+    :param plan: The execution plan to use.
+    """
+    time_property_bytes = bytes(time_property, "utf-8")
+    time_property_cstr = <string>time_property_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(
+            EarliestArrival(
+                pg.underlying.get(),
+                source,
+                time_property_cstr,
+                begin_time,
+                end_time,
+                output_property_name_cstr,
+                plan.underlying_,
+            )
+        )
+
+
+def temporal_pagerank(
+    PropertyGraph pg,
+    str time_property,
+    int64_t begin_time,
+    int64_t end_time,
+    str output_property_name,
+    float tolerance = kDefaultTolerance,
+    unsigned int max_iterations = kDefaultMaxIterations,
+    float alpha = kDefaultAlpha,
+):
+    """
+    Compute the Page Rank of each node over the edges whose time is in [`begin_time`, `end_time`), as
+    :py:func:`~katana.analytics.pagerank` would on the subgraph of those edges, with the synchronous push algorithm.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze. Its edges must be sorted by `time_property`.
+    :type time_property: str
+    :param time_property: The integer or timestamp edge property with the time of each edge.
+    :type begin_time: int
+    :param begin_time: The first time of the window, in the units of `time_property`.
+    :type end_time: int
+    :param end_time: The time just past the window.
+    :type output_property_name: str
+    :param output_property_name: The float node property to create with the ranks.
+    :param tolerance: The residual below which a node stops pushing.
+    :param max_iterations: The largest number of rounds to run.
+    :param alpha: The damping factor.
+    """
+    cdef _PagerankPlan plan = _PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha)
+    time_property_bytes = bytes(time_property, "utf-8")
+    time_property_cstr = <string>time_property_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(
+            TemporalPagerank(
+                pg.underlying.get(), time_property_cstr, begin_time, end_time, output_property_name_cstr, plan
+            )
+        )
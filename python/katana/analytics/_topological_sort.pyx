@@ -0,0 +1,197 @@
+"""
+Topological Sort and DAG Longest Paths
+--------------------------------------
+
+.. autoclass:: katana.analytics.TopologicalSortPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._topological_sort._TopologicalSortPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.topological_sort
+
+.. autofunction:: katana.analytics.topological_sort_assert_valid
+
+.. autofunction:: katana.analytics.dag_longest_path
+
+.. autofunction:: katana.analytics.dag_critical_path
+"""
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport handle_result_void, handle_result_assert, raise_error_code, Result
+from katana.property_graph cimport PropertyGraph
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/topological_sort/topological_sort.h" namespace "katana::analytics" nogil:
+    cppclass _TopologicalSortPlan "katana::analytics::TopologicalSortPlan" (_Plan):
+        enum Algorithm:
+            kFrontier "katana::analytics::TopologicalSortPlan::kFrontier"
+
+        _TopologicalSortPlan.Algorithm algorithm() const
+
+        TopologicalSortPlan()
+
+        @staticmethod
+        _TopologicalSortPlan Frontier()
+
+    Result[void] TopologicalSort(_PropertyGraph* pg, string output_property_name, _TopologicalSortPlan plan)
+
+    Result[void] TopologicalSortAssertValid(_PropertyGraph* pg, string property_name)
+
+    Result[void] DagLongestPath(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name,
+                                string slack_property_name, _TopologicalSortPlan plan)
+
+    Result[vector[uint32_t]] DagCriticalPath(_PropertyGraph* pg, string edge_weight_property_name,
+                                             _TopologicalSortPlan plan)
+
+
+class _TopologicalSortPlanAlgorithm(Enum):
+    """
+    Frontier
+        Kahn's algorithm a level at a time
+    """
+    Frontier = _TopologicalSortPlan.Algorithm.kFrontier
+
+
+cdef class TopologicalSortPlan(Plan):
+    """
+    A computational :ref:`Plan` for Topological Sort and the DAG longest path analytics.
+
+    Static methods construct TopologicalSortPlans.
+    """
+    cdef:
+        _TopologicalSortPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _TopologicalSortPlanAlgorithm
+
+    @staticmethod
+    cdef TopologicalSortPlan make(_TopologicalSortPlan u):
+        f = <TopologicalSortPlan>TopologicalSortPlan.__new__(TopologicalSortPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _TopologicalSortPlanAlgorithm:
+        return _TopologicalSortPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def frontier() -> TopologicalSortPlan:
+        """
+        Kahn's algorithm a level at a time: every node whose in-edges all come from earlier levels forms the next
+        level, and the out-edges of a whole level are processed in parallel.
+        """
+        return TopologicalSortPlan.make(_TopologicalSortPlan.Frontier())
+
+
+def topological_sort(PropertyGraph pg, str output_property_name, TopologicalSortPlan plan = TopologicalSortPlan()):
+    """
+    Compute a topological order of `pg`, treating its edges as directed. Nodes are ordered by level and then by id.
+    Raises an exception if `pg` has a cycle.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The uint64 node property to create with the position of each node in the order.
+    :type plan: TopologicalSortPlan
+    :param plan: The execution plan to use.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(TopologicalSort(pg.underlying.get(), output_property_name_cstr, plan.underlying_))
+
+
+def topological_sort_assert_valid(PropertyGraph pg, str property_name):
+    """
+    Raise an exception if the positions in `property_name` are not a topological order of `pg`.
+
+    :raises: AssertionError
+    """
+    property_name_bytes = bytes(property_name, "utf-8")
+    property_name_cstr = <string>property_name_bytes
+    with nogil:
+        handle_result_assert(TopologicalSortAssertValid(pg.underlying.get(), property_name_cstr))
+
+
+def dag_longest_path(
+    PropertyGraph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    str slack_property_name = "",
+    TopologicalSortPlan plan = TopologicalSortPlan(),
+):
+    """
+    Compute the length of the longest path ending at each node of the DAG `pg`. Raises an exception if `pg` has a
+    cycle.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The integer or floating point edge property with the weights, or "" for weight
+        1 on every edge.
+    :type output_property_name: str
+    :param output_property_name: The node property to create with the lengths, of the type of the weights.
+    :type slack_property_name: str
+    :param slack_property_name: If not "", the node property to create with the slack of each node: the length of
+        the longest path minus that of the longest path through the node, which is 0 on critical paths.
+    :type plan: TopologicalSortPlan
+    :param plan: The execution plan to use.
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    slack_property_name_bytes = bytes(slack_property_name, "utf-8")
+    slack_property_name_cstr = <string>slack_property_name_bytes
+    with nogil:
+        handle_result_void(
+            DagLongestPath(
+                pg.underlying.get(),
+                edge_weight_property_name_cstr,
+                output_property_name_cstr,
+                slack_property_name_cstr,
+                plan.underlying_,
+            )
+        )
+
+
+cdef vector[uint32_t] handle_result_path(Result[vector[uint32_t]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def dag_critical_path(
+    PropertyGraph pg, str edge_weight_property_name, TopologicalSortPlan plan = TopologicalSortPlan()
+) -> list:
+    """
+    Return the nodes of a longest path of the DAG `pg`, in order, with the weights of
+    :py:func:`~katana.analytics.dag_longest_path`. Raises an exception if `pg` has a cycle.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The integer or floating point edge property with the weights, or "" for weight
+        1 on every edge.
+    :type plan: TopologicalSortPlan
+    :param plan: The execution plan to use.
+    """
+    cdef vector[uint32_t] path
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    with nogil:
+        path = handle_result_path(DagCriticalPath(pg.underlying.get(), edge_weight_property_name_cstr, plan.underlying_))
+    return list(path)
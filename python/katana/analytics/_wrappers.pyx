@@ -5,6 +5,7 @@ Trivial Algorithms
 """
 from libc.stdint cimport uint64_t, uint32_t
 from libcpp.memory cimport shared_ptr, static_pointer_cast
+from libcpp.string cimport string
 
 from pyarrow.lib cimport CArray, CUInt64Array, pyarrow_wrap_array
 
@@ -30,6 +31,8 @@ cdef shared_ptr[CUInt64Array] handle_result_shared_cuint64array(Result[shared_pt
 cdef extern from "katana/PropertyGraph.h" namespace "katana" nogil:
     Result[shared_ptr[CUInt64Array]] SortAllEdgesByDest(_PropertyGraph* pg);
 
+    Result[shared_ptr[CUInt64Array]] SortAllEdgesByTime(_PropertyGraph* pg, string time_property);
+
     uint64_t FindEdgeSortedByDest(const _PropertyGraph* graph, uint32_t node, uint32_t node_to_find);
 
     Result[void] SortNodesByDegree(_PropertyGraph* pg);
@@ -47,6 +50,21 @@ def sort_all_edges_by_dest(PropertyGraph pg):
     return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt64Array](res))
 
 
+def sort_all_edges_by_time(PropertyGraph pg, str time_property):
+    """
+    Sort the edges of each node by the integer or timestamp edge property `time_property` and then by the node ID of
+    the target, and index them by time. Edge properties are permuted along with the edges. This enables the temporal
+    analytics, e.g., :py:func:`~katana.analytics.earliest_arrival`, over `time_property`.
+
+    :return: The permutation vector (mapping from old indices to the new indices) which results due to the sorting.
+    """
+    time_property_bytes = bytes(time_property, "utf-8")
+    time_property_cstr = <string>time_property_bytes
+    with nogil:
+        res = handle_result_shared_cuint64array(SortAllEdgesByTime(pg.underlying.get(), time_property_cstr))
+    return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt64Array](res))
+
+
 def find_edge_sorted_by_dest(PropertyGraph pg, uint32_t node, uint32_t node_to_find):
     """
     Find an edge based on its incident nodes. The graph must have sorted edges.
@@ -6,6 +6,10 @@ cdef extern from "katana/analytics/Plan.h" namespace "katana::analytics" nogil:
 
     cppclass _Plan "katana::analytics::Plan":
         _Architecture architecture() const
+        bint deterministic() const
+        void set_deterministic(bint deterministic)
+        bint profile_parallelism() const
+        void set_profile_parallelism(bint profile_parallelism)
 
 
 cdef class Plan:
@@ -43,6 +43,34 @@ cdef class Plan:
         """
         return Architecture(self.underlying().architecture())
 
+    @property
+    def deterministic(self) -> bool:
+        """
+        Whether the algorithm must return the same result on every run on the same machine, for any number of threads.
+        Algorithms whose results otherwise depend on the schedule then reduce and break ties in a fixed order, which
+        costs some performance. Algorithms that cannot do so raise an error. False by default.
+        """
+        return self.underlying().deterministic()
+
+    @deterministic.setter
+    def deterministic(self, bint deterministic):
+        self.underlying().set_deterministic(deterministic)
+
+    @property
+    def profile_parallelism(self) -> bool:
+        """
+        Whether to measure the available parallelism of the algorithm rather than run it at full speed. The loops of
+        the algorithm then run step by step and report the work available in each step and the share of iterations that
+        conflicted as statistics, which tells whether more threads would speed the algorithm up on a graph. The result
+        is the same, but the algorithm runs much slower. Honored by bfs, sssp, connected_components, pagerank,
+        k_core and triangle_count. False by default.
+        """
+        return self.underlying().profile_parallelism()
+
+    @profile_parallelism.setter
+    def profile_parallelism(self, bint profile_parallelism):
+        self.underlying().set_profile_parallelism(profile_parallelism)
+
 
 cdef class Statistics:
     """
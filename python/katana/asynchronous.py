@@ -0,0 +1,115 @@
+"""
+Run analytics and graph loads in the background.
+
+Analytics and loads release the GIL while they run, so other Python threads keep running. `submit` runs any callable,
+such as ``katana.analytics.bfs``, on a background thread and returns a `KatanaFuture`; `run_async` awaits it from
+`asyncio`. Jobs run one at a time in the order they are submitted because they share the Katana thread pool.
+
+Cancelling a job that has not started removes it from the queue. Cancelling a running job asks its analytics to stop
+at the end of their current round (see `katana.galois.CancelFlag`). The job then fails with
+`concurrent.futures.CancelledError`, and the properties it added to the `PropertyGraph` arguments are removed.
+"""
+import asyncio
+import concurrent.futures
+import threading
+
+from katana.galois import CancelFlag
+from katana.property_graph import PropertyGraph
+
+__all__ = ["KatanaFuture", "submit", "run_async", "submit_load", "load_async"]
+
+_executor = None
+_executor_lock = threading.Lock()
+
+
+def _get_executor():
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = concurrent.futures.ThreadPoolExecutor(max_workers=1, thread_name_prefix="katana")
+        return _executor
+
+
+class KatanaFuture(concurrent.futures.Future):
+    """
+    The future of a job passed to `submit`.
+    """
+
+    def __init__(self):
+        super().__init__()
+        self.cancel_flag = CancelFlag()
+
+    def cancel(self):
+        """
+        Cancel the job. Return True if it had not started, or if it is running and was asked to stop; it then fails
+        with `concurrent.futures.CancelledError` once it stops. Return False if it already finished.
+        """
+        if super().cancel():
+            return True
+        if self.running():
+            self.cancel_flag.cancel()
+            return True
+        return False
+
+
+def _property_names(args):
+    return [
+        (g, set(g.node_schema().names), set(g.edge_schema().names)) for g in args if isinstance(g, PropertyGraph)
+    ]
+
+
+def _remove_new_properties(before):
+    for g, node_names, edge_names in before:
+        for name in set(g.node_schema().names) - node_names:
+            g.remove_node_property(name)
+        for name in set(g.edge_schema().names) - edge_names:
+            g.remove_edge_property(name)
+
+
+def _run(future, fn, args, kwargs):
+    if not future.set_running_or_notify_cancel():
+        return
+    before = _property_names(args + tuple(kwargs.values()))
+    try:
+        result = future.cancel_flag.run(fn, *args, **kwargs)
+    except BaseException as e:
+        if not future.cancel_flag.cancelled():
+            future.set_exception(e)
+            return
+    if future.cancel_flag.cancelled():
+        _remove_new_properties(before)
+        future.set_exception(concurrent.futures.CancelledError())
+    else:
+        future.set_result(result)
+
+
+def submit(fn, *args, **kwargs) -> KatanaFuture:
+    """
+    Run ``fn(*args, **kwargs)`` in the background and return its future.
+    """
+    future = KatanaFuture()
+    _get_executor().submit(_run, future, fn, args, kwargs)
+    return future
+
+
+async def run_async(fn, *args, **kwargs):
+    """
+    Run ``fn(*args, **kwargs)`` in the background and return its result. Cancelling the awaiting task cancels the
+    job.
+    """
+    return await asyncio.wrap_future(submit(fn, *args, **kwargs))
+
+
+def submit_load(path, **kwargs) -> KatanaFuture:
+    """
+    Load a `PropertyGraph` in the background; `kwargs` are passed to `PropertyGraph`. Loads only stop early if they
+    are cancelled before they start.
+    """
+    return submit(PropertyGraph, path, **kwargs)
+
+
+async def load_async(path, **kwargs) -> PropertyGraph:
+    """
+    Load a `PropertyGraph` in the background and return it; `kwargs` are passed to `PropertyGraph`.
+    """
+    return await run_async(PropertyGraph, path, **kwargs)
@@ -33,6 +33,17 @@ cdef extern from "katana/Galois.h" namespace "katana" nogil:
     cppclass disable_conflict_detection:
         disable_conflict_detection()
 
+cdef extern from "katana/Cancel.h" namespace "katana" nogil:
+    cppclass CancelFlag:
+        void Cancel()
+        void Reset()
+        bint IsCancelled()
+
+    cppclass CancelScope:
+        CancelScope(const CancelFlag*)
+
+    bint CancelRequested()
+
 cdef extern from "katana/MethodFlags.h" namespace "katana" nogil:
     cppclass MethodFlag:
         bint operator==(MethodFlag)
@@ -1,5 +1,7 @@
 from .cpp.libgalois.Galois cimport setActiveThreads as c_setActiveThreads
 from .cpp.libgalois.Galois cimport getVersion as c_getVersion
+from .cpp.libgalois.Galois cimport CancelFlag as _CancelFlag, CancelScope as _CancelScope
+from .cpp.libgalois.Galois cimport CancelRequested as c_CancelRequested
 
 
 _katana_runtime = _katana_runtime_wrapper()
@@ -10,3 +12,34 @@ def setActiveThreads(int n):
 def get_version():
     return c_getVersion()
 
+cdef class CancelFlag:
+    """
+    A flag that asks the analytics run through `run` to stop early. Analytics check the flag between rounds, so they
+    stop within one round of `cancel` and raise an error. The properties they were writing are then incomplete.
+    """
+    cdef _CancelFlag underlying
+
+    def cancel(self):
+        self.underlying.Cancel()
+
+    def cancelled(self):
+        return self.underlying.IsCancelled()
+
+    def run(self, fn, *args, **kwargs):
+        """
+        run(self, fn, *args, **kwargs)
+
+        Call ``fn(*args, **kwargs)`` on the calling thread with this flag installed for the analytics it runs.
+        """
+        cdef _CancelScope* scope = new _CancelScope(&self.underlying)
+        try:
+            return fn(*args, **kwargs)
+        finally:
+            del scope
+
+def cancel_requested():
+    """
+    Return True if the `CancelFlag` running the caller was cancelled.
+    """
+    return c_CancelRequested()
+
@@ -1,19 +1,20 @@
 import numpy as np
 import pyarrow
 
-from katana.loops import do_all, do_all_operator
+from katana.loops import do_all, do_all_range_operator
 from katana.property_graph import PropertyGraph
 from katana.timer import StatTimer
 from katana.galois import setActiveThreads
 
 
-@do_all_operator()
-def jaccard_operator(g, n1_neighbors, n1_size, output, n2):
+@do_all_range_operator()
+def jaccard_operator(out_indices, out_dests, n1_neighbors, n1_size, output, n2):
     intersection_size = 0
-    n2_size = len(g.edges(n2))
-    for e_iter in g.edges(n2):
-        ne = g.get_edge_dst(e_iter)
-        if n1_neighbors[ne]:
+    begin = out_indices[n2 - 1] if n2 > 0 else np.uint64(0)
+    end = out_indices[n2]
+    n2_size = np.int64(end - begin)
+    for e in range(begin, end):
+        if n1_neighbors[out_dests[e]]:
             intersection_size += 1
     union_size = n1_size + n2_size - intersection_size
     if union_size > 0:
@@ -32,7 +33,10 @@ def jaccard(g, key_node, property_name):
         key_neighbors[n] = True
 
     do_all(
-        g, jaccard_operator(g, key_neighbors, len(g.edges(key_node)), output), steal=True, loop_name="jaccard",
+        g,
+        jaccard_operator(g.out_indices(), g.out_dests(), key_neighbors, len(g.edges(key_node)), output),
+        steal=True,
+        loop_name="jaccard",
     )
 
     g.add_node_property(pyarrow.table({property_name: output}))
@@ -254,6 +254,10 @@ class UninstantiatedClosure:
         self.__name__ = self._builder.__name__
         self.__qualname__ = self._builder.__qualname__
 
+    @property
+    def builder(self):
+        return self._builder
+
     def instantiate(self, *unbound_argument_types):
         return self._builder.bind(self._args, unbound_argument_types)
 
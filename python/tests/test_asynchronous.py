@@ -0,0 +1,76 @@
+import asyncio
+import threading
+from concurrent.futures import CancelledError
+
+import pytest
+
+from katana.analytics import bfs, bfs_assert_valid
+from katana.asynchronous import load_async, run_async, submit, submit_load
+from katana.example_utils import get_input
+from katana.galois import cancel_requested
+
+
+def test_submit(property_graph):
+    num_node_properties = len(property_graph.node_schema())
+    future = submit(bfs, property_graph, 0, "level")
+    assert future.result() is None
+    bfs_assert_valid(property_graph, "level")
+    assert len(property_graph.node_schema()) == num_node_properties + 1
+
+
+def test_submit_exception(property_graph):
+    future = submit(bfs, property_graph, property_graph.num_nodes(), "level")
+    with pytest.raises(Exception):
+        future.result()
+
+
+def test_cancel_queued():
+    started = threading.Event()
+    release = threading.Event()
+
+    def block():
+        started.set()
+        release.wait()
+
+    blocker = submit(block)
+    started.wait()
+    queued = submit(lambda: 1)
+    assert queued.cancel()
+    release.set()
+    blocker.result()
+    assert queued.cancelled()
+
+
+def test_cancel_running(property_graph):
+    started = threading.Event()
+    release = threading.Event()
+
+    def job(g):
+        started.set()
+        release.wait()
+        assert cancel_requested()
+        bfs(g, 0, "level")
+
+    num_node_properties = len(property_graph.node_schema())
+    future = submit(job, property_graph)
+    started.wait()
+    assert future.cancel()
+    release.set()
+    with pytest.raises(CancelledError):
+        future.result()
+    assert len(property_graph.node_schema()) == num_node_properties
+
+
+def test_run_async(property_graph):
+    async def main():
+        await run_async(bfs, property_graph, 0, "level")
+        return await load_async(get_input("propertygraphs/ldbc_003"))
+
+    graph = asyncio.run(main())
+    bfs_assert_valid(property_graph, "level")
+    assert graph.num_nodes() == property_graph.num_nodes()
+
+
+def test_submit_load():
+    graph = submit_load(get_input("propertygraphs/ldbc_003")).result()
+    assert graph.num_nodes() == 29092
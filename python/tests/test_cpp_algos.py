@@ -1,11 +1,12 @@
 import numpy as np
-from pyarrow import Schema, table
+from pyarrow import FixedSizeListArray, Schema, table, uint16, uint32
 from pytest import approx, raises
 
 from katana import GaloisError
 from katana.analytics import *
 from katana.property_graph import PropertyGraph
 from katana.example_utils import get_input
+from katana.galois import setActiveThreads
 from katana.lonestar.analytics.bfs import verify_bfs
 from katana.lonestar.analytics.sssp import verify_sssp
 
@@ -82,6 +83,33 @@ def test_bfs(property_graph: PropertyGraph):
     verify_bfs(property_graph, start_node, new_property_id)
 
 
+def test_bfs_direct_opt(property_graph: PropertyGraph):
+    start_node = 0
+
+    bfs(property_graph, start_node, "Expected")
+    bfs(property_graph, start_node, "Actual", BfsPlan.synchronous_direct_opt())
+
+    bfs_assert_valid(property_graph, "Actual")
+    assert (
+        property_graph.get_node_property("Actual").to_pylist()
+        == property_graph.get_node_property("Expected").to_pylist()
+    )
+
+
+def test_multi_source_bfs(property_graph: PropertyGraph):
+    sources = list(range(0, 700, 7))
+    names = ["Actual{}".format(src) for src in sources]
+
+    multi_source_bfs(property_graph, sources, names)
+
+    for src, name in list(zip(sources, names))[::10]:
+        bfs(property_graph, src, "Expected{}".format(src))
+        assert (
+            property_graph.get_node_property(name).to_pylist()
+            == property_graph.get_node_property("Expected{}".format(src)).to_pylist()
+        )
+
+
 def test_sssp(property_graph: PropertyGraph):
     property_name = "NewProp"
     weight_name = "workFrom"
@@ -107,6 +135,87 @@ def test_sssp(property_graph: PropertyGraph):
     verify_sssp(property_graph, start_node, new_property_id)
 
 
+def test_multi_source_sssp(property_graph: PropertyGraph):
+    weight_name = "workFrom"
+    sources = [0, 5, 10]
+
+    multi_source_sssp(property_graph, sources, weight_name, "distances", MultiSourceSsspPlan.delta_step(batch_size=2))
+    distances = property_graph.get_node_property("distances")
+    assert distances.type.list_size == len(sources)
+    all_distances = np.asarray(distances.flatten()).reshape(-1, len(sources))
+
+    for i, source in enumerate(sources):
+        name = f"single{i}"
+        sssp(property_graph, source, weight_name, name)
+        single = property_graph.get_node_property(name).to_numpy()
+        reached = all_distances[:, i] != np.iinfo(np.uint64).max
+        assert all_distances[source, i] == 0
+        assert np.array_equal(all_distances[reached, i], single[reached])
+
+    with raises(GaloisError):
+        multi_source_sssp(property_graph, sources, weight_name, "distances")
+
+
+def test_sssp_adaptive(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    weight_name = "workFrom"
+    start_node = 0
+
+    sssp(property_graph, start_node, weight_name, property_name, SsspPlan.delta_step_adaptive())
+
+    sssp_assert_valid(property_graph, start_node, weight_name, property_name)
+
+    stats = SsspStatistics(property_graph, property_name)
+    assert stats.max_distance == 2011.0
+
+
+def test_sssp_multi_queue(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    weight_name = "workFrom"
+    start_node = 0
+
+    sssp(property_graph, start_node, weight_name, property_name, SsspPlan.multi_queue())
+
+    sssp_assert_valid(property_graph, start_node, weight_name, property_name)
+
+    stats = SsspStatistics(property_graph, property_name)
+    assert stats.max_distance == 2011.0
+
+
+def test_sssp_narrow_weights(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    weights = property_graph.get_edge_property("workFrom").cast(uint16())
+    property_graph.add_edge_property(table({"Weight16": weights}))
+
+    sssp(property_graph, start_node, "Weight16", property_name)
+
+    assert property_graph.get_node_property(property_name).type == uint32()
+    sssp_assert_valid(property_graph, start_node, "Weight16", property_name)
+
+    stats = SsspStatistics(property_graph, property_name)
+    assert stats.max_distance == 2011.0
+
+
+def test_sssp_quantized_weights(property_graph: PropertyGraph):
+    start_node = 0
+
+    scale = sssp_quantize_edge_weights(property_graph, "workFrom", "Quantized16")
+    assert scale == 1.0
+    sssp(property_graph, start_node, "Quantized16", "Exact")
+    assert SsspStatistics(property_graph, "Exact").max_distance == 2011.0
+
+    scale = sssp_quantize_edge_weights(property_graph, "workFrom", "Quantized8", 8)
+    assert scale > 1.0
+    sssp(property_graph, start_node, "Quantized8", "Approximate")
+    sssp_assert_valid(property_graph, start_node, "Quantized8", "Approximate")
+    assert SsspStatistics(property_graph, "Approximate").max_distance * scale == approx(2011.0, rel=0.1)
+
+    with raises(GaloisError):
+        sssp_quantize_edge_weights(property_graph, "workFrom", "Quantized4", 4)
+
+
 def test_jaccard(property_graph: PropertyGraph):
     property_name = "NewProp"
     compare_node = 0
@@ -201,6 +310,82 @@ def test_betweenness_centrality_level(property_graph: PropertyGraph):
     assert stats.average_centrality == approx(1.3645)
 
 
+def test_betweenness_centrality_multi_source(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    betweenness_centrality(property_graph, property_name, 16, BetweennessCentralityPlan.multi_source())
+
+    node_schema: Schema = property_graph.node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(8210.38)
+    assert stats.average_centrality == approx(1.3645)
+
+
+def test_betweenness_centrality_approximate(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    plan = BetweennessCentralityPlan.approximate(0.05)
+    assert plan.algorithm == BetweennessCentralityPlan.Algorithm.Approximate
+    assert plan.epsilon == approx(0.05)
+
+    betweenness_centrality(property_graph, property_name, None, plan)
+
+    node_schema: Schema = property_graph.node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality > 0
+
+
+def test_eigenvector_centrality(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    eigenvector_centrality(property_graph, property_name)
+
+    centrality = property_graph.get_node_property(property_name).to_numpy()
+    assert centrality.dtype == np.float64
+    assert (centrality >= 0).all()
+    assert np.linalg.norm(centrality) == approx(1)
+
+
+def test_katz_centrality(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    plan = KatzCentralityPlan.power_iteration(
+        alpha=0.001, normalized=False, precision=KatzCentralityPlan.Precision.Float32
+    )
+    assert plan.precision == KatzCentralityPlan.Precision.Float32
+
+    katz_centrality(property_graph, property_name, plan)
+
+    # Every node has at least beta, plus alpha for each in-edge
+    centrality = property_graph.get_node_property(property_name).to_numpy()
+    assert centrality.dtype == np.float32
+    assert (centrality >= 1).all()
+
+    with raises(GaloisError):
+        katz_centrality(property_graph, "zero-alpha", KatzCentralityPlan.power_iteration(alpha=0))
+
+
+def test_hits(property_graph: PropertyGraph):
+    hits(property_graph, "hub", "authority")
+
+    hub = property_graph.get_node_property("hub").to_numpy()
+    authority = property_graph.get_node_property("authority").to_numpy()
+    assert hub.sum() == approx(1)
+    assert authority.sum() == approx(1)
+    assert (hub >= 0).all()
+    assert (authority >= 0).all()
+
+
 def test_triangle_count():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [property_graph.get_edge_dst(e) for e in property_graph.edges(0)]
@@ -220,6 +405,49 @@ def test_triangle_count():
     assert n == 282617
 
 
+def test_k_clique_count():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    assert k_clique_count(property_graph, 1) == property_graph.num_nodes()
+    assert k_clique_count(property_graph, 3) == 282617
+    assert k_clique_count(property_graph, 3, KCliquePlan.oriented_listing()) == 282617
+    assert k_clique_count(property_graph, 4) > 0
+
+    # The orientation built above is shared with triangle counting
+    n = triangle_count(property_graph, TriangleCountPlan.ordered_count(relabeling=True))
+    assert n == 282617
+
+    with raises(GaloisError):
+        k_clique_count(property_graph, 0)
+
+
+def test_temporal(property_graph: PropertyGraph):
+    times = (np.arange(property_graph.num_edges()) * 7919) % 100
+    property_graph.add_edge_property(table({"time": times}))
+    sort_all_edges_by_time(property_graph, "time")
+    sorted_times = property_graph.get_edge_property("time").to_numpy()
+    for n in range(NODES_TO_SAMPLE):
+        node_times = [sorted_times[e] for e in property_graph.edges(n)]
+        assert node_times == sorted(node_times)
+
+    earliest_arrival(property_graph, 0, "time", 20, 80, "arrival")
+    arrival = property_graph.get_node_property("arrival").to_numpy()
+    assert arrival[0] == 20
+    # No edge in the window leads to an earlier arrival than the one found
+    for n in range(NODES_TO_SAMPLE):
+        if arrival[n] == EarliestArrivalPlan.unreachable:
+            continue
+        for e in property_graph.edges(n):
+            if arrival[n] <= sorted_times[e] < 80:
+                assert arrival[property_graph.get_edge_dst(e)] <= sorted_times[e]
+
+    temporal_pagerank(property_graph, "time", 20, 80, "rank")
+    rank = property_graph.get_node_property("rank").to_numpy()
+    assert (rank >= 1 - 0.85 - 1e-6).all()
+
+    with raises(GaloisError):
+        earliest_arrival(property_graph, 0, "time", 80, 20, "bad_window")
+
+
 def test_triangle_count_presorted():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     sort_nodes_by_degree(property_graph)
@@ -243,6 +471,17 @@ def test_independent_set():
 
     independent_set_assert_valid(property_graph, "output2")
 
+    independent_set(property_graph, "output3", IndependentSetPlan.ordered_priority())
+
+    independent_set_assert_valid(property_graph, "output3")
+
+    # The ordered algorithm does not depend on the number of threads
+    setActiveThreads(1)
+    independent_set(property_graph, "output4", IndependentSetPlan.ordered_priority())
+    assert np.array_equal(
+        property_graph.get_node_property("output3").to_numpy(), property_graph.get_node_property("output4").to_numpy()
+    )
+
 
 def test_connected_components():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
@@ -259,6 +498,151 @@ def test_connected_components():
     connected_components_assert_valid(property_graph, "output")
 
 
+def test_deterministic_plans():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    plan = ConnectedComponentsPlan()
+    assert not plan.deterministic
+    plan.deterministic = True
+    connected_components(property_graph, "output", plan)
+    components = property_graph.get_node_property("output").to_numpy()
+    for n in range(len(components)):
+        assert components[components[n]] == components[n]
+        assert components[n] <= n
+
+    plan = PagerankPlan.pull_topological()
+    plan.deterministic = True
+    pagerank(property_graph, "rank_4", plan)
+    setActiveThreads(1)
+    pagerank(property_graph, "rank_1", plan)
+    assert (
+        property_graph.get_node_property("rank_4").to_pylist()
+        == property_graph.get_node_property("rank_1").to_pylist()
+    )
+
+    plan = PagerankPlan.push_synchronous()
+    plan.deterministic = True
+    with raises(GaloisError):
+        pagerank(property_graph, "push", plan)
+
+
+def test_strongly_connected_components():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10"))
+
+    strongly_connected_components(property_graph, "multistep", StronglyConnectedComponentsPlan.multistep())
+    strongly_connected_components(property_graph, "coloring", StronglyConnectedComponentsPlan.coloring())
+
+    multistep_stats = StronglyConnectedComponentsStatistics(property_graph, "multistep")
+    coloring_stats = StronglyConnectedComponentsStatistics(property_graph, "coloring")
+
+    assert multistep_stats.total_components == coloring_stats.total_components
+    assert multistep_stats.largest_component_size == coloring_stats.largest_component_size
+
+    strongly_connected_components_assert_valid(property_graph, "multistep")
+    strongly_connected_components_assert_valid(property_graph, "coloring")
+
+
+def test_strongly_connected_components_symmetric():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    strongly_connected_components(property_graph, "output")
+
+    # The strongly connected components of a symmetric graph are its
+    # connected components
+    stats = StronglyConnectedComponentsStatistics(property_graph, "output")
+
+    assert stats.total_components == 69
+    assert stats.total_non_trivial_components == 1
+
+    strongly_connected_components_assert_valid(property_graph, "output")
+
+
+def test_topological_sort_cycles():
+    # Every edge of a symmetric graph is on a cycle
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    with raises(GaloisError):
+        topological_sort(property_graph, "order")
+    with raises(GaloisError):
+        dag_longest_path(property_graph, "", "length")
+    with raises(GaloisError):
+        dag_critical_path(property_graph, "")
+
+
+def test_neighbor_sampler():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+    num_nodes = property_graph.num_nodes()
+    embeddings = FixedSizeListArray.from_arrays(np.arange(num_nodes * 4, dtype=np.float32), 4)
+    property_graph.add_node_property(table({"embedding": embeddings, "label": np.arange(num_nodes) * 3}))
+
+    plan = NeighborSamplingPlan.uniform([5, 3], seed=1)
+    assert plan.fanouts == [5, 3]
+    sampler = NeighborSampler(property_graph, plan, ["embedding", "label"])
+    seeds = list(range(0, num_nodes, 7))
+
+    batch = sampler.sample(seeds)
+    nodes = np.asarray(batch.nodes)
+    assert list(nodes[: len(seeds)]) == seeds
+    assert batch.hop_sizes[0] == len(seeds) and batch.hop_sizes[-1] == len(nodes)
+    assert len(batch.blocks) == 2
+    dests = property_graph.out_dests_view().as_numpy()
+    for block in batch.blocks:
+        edges = np.asarray(block.edges)
+        assert np.array_equal(dests[edges], nodes[np.asarray(block.sources)])
+    embedding = batch.features["embedding"]
+    assert embedding.shape == (len(nodes), 4)
+    assert np.array_equal(np.asarray(embedding)[:, 0], nodes * 4)
+    if hasattr(np, "from_dlpack"):
+        assert np.array_equal(np.from_dlpack(embedding), np.asarray(embedding))
+    assert np.array_equal(np.asarray(batch.features["label"]), nodes * 3)
+
+    loader = sampler.loader(seeds, 50)
+    assert len(loader) == (len(seeds) + 49) // 50
+    batches = list(loader)
+    assert len(batches) == len(loader)
+    assert np.array_equal(np.concatenate([np.asarray(b.nodes)[: b.hop_sizes[0]] for b in batches]), seeds)
+
+    with raises(GaloisError):
+        sampler.sample([1, 1])
+    with raises(GaloisError):
+        NeighborSampler(property_graph, plan, ["missing"])
+
+
+def test_k_hop_expander():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+    indices = property_graph.out_indices_view().as_numpy()
+    dests = property_graph.out_dests_view().as_numpy()
+
+    def out_neighbors(n):
+        return dests[(indices[n - 1] if n > 0 else 0) : indices[n]]
+
+    plan = KHopPlan.hashed(2)
+    assert plan.hops == 2 and plan.max_fanout == 0
+    expander = KHopExpander(property_graph, plan)
+    queries = list(range(0, property_graph.num_nodes(), 97)) + [0]
+
+    nodes, distances = expander.neighborhoods(queries)
+    assert len(nodes) == len(queries)
+    for q, query in enumerate(queries):
+        hop1 = set(out_neighbors(query)) - {query}
+        hop2 = set(np.concatenate([out_neighbors(n) for n in hop1] or [[]]).astype(np.uint32)) - hop1 - {query}
+        assert nodes[q].as_py() == [query] + sorted(hop1) + sorted(hop2)
+        assert distances[q].as_py() == [0] + [1] * len(hop1) + [2] * len(hop2)
+
+    networks = expander.ego_networks(queries)
+    for q, network in enumerate(networks):
+        ego_nodes = np.asarray(network.nodes)
+        assert list(ego_nodes) == nodes[q].as_py()
+        assert network.hop_sizes[-1] == len(ego_nodes)
+        assert np.array_equal(dests[np.asarray(network.edges)], ego_nodes[np.asarray(network.dests)])
+
+    limited, _ = KHopExpander(property_graph, KHopPlan.hashed(3, max_nodes=5)).neighborhoods(queries)
+    assert all(len(n) <= 5 for n in limited.to_pylist())
+
+    with raises(GaloisError):
+        expander.neighborhoods([property_graph.num_nodes()])
+
+
 def test_k_core():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -271,6 +655,28 @@ def test_k_core():
     k_core_assert_valid(property_graph, 10, "output")
 
 
+def test_k_core_decomposition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_core_decomposition(property_graph, "output")
+
+    k_core_decomposition_assert_valid(property_graph, "output")
+
+    # The 10-core found by k_core is the set of nodes with core number at
+    # least 10
+    core_numbers = property_graph.get_node_property("output").to_numpy()
+    assert np.count_nonzero(core_numbers >= 10) == 438
+
+    stats = KCoreDecompositionStatistics(property_graph, "output")
+    assert stats.max_core_number == core_numbers.max()
+    assert stats.nodes_in_max_core == np.count_nonzero(core_numbers == core_numbers.max())
+
+    # Both plans find the same core numbers
+    k_core_decomposition(property_graph, "output_async", KCorePlan.asynchronous())
+    k_core_decomposition_assert_valid(property_graph, "output_async")
+    assert np.array_equal(property_graph.get_node_property("output_async").to_numpy(), core_numbers)
+
+
 def test_k_truss():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -283,6 +689,193 @@ def test_k_truss():
     k_truss_assert_valid(property_graph, 10, "output")
 
 
+def test_k_truss_peeling():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_truss(property_graph, 10, "output", KTrussPlan.peeling())
+
+    stats = KTrussStatistics(property_graph, 10, "output")
+
+    assert stats.number_of_edges_left == 13338
+
+
+def test_k_truss_decomposition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_truss_decomposition(property_graph, "output")
+
+    k_truss_decomposition_assert_valid(property_graph, "output")
+
+    # Both copies of each edge in the 10-truss found by k_truss have truss
+    # number at least 10
+    truss_numbers = property_graph.get_edge_property("output").to_numpy()
+    assert np.count_nonzero(truss_numbers >= 10) == 2 * 13338
+
+    stats = KTrussDecompositionStatistics(property_graph, "output")
+    assert stats.max_truss_number == truss_numbers.max()
+    assert 2 * stats.edges_in_max_truss == np.count_nonzero(truss_numbers == truss_numbers.max())
+
+
+def test_max_flow():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+    source = 0
+    sink = property_graph.num_nodes() - 1
+
+    max_flow(property_graph, source, sink, "value", "flow", MaxFlowPlan.push_relabel())
+
+    max_flow_assert_valid(property_graph, source, sink, "value", "flow")
+
+    flow = property_graph.get_edge_property("flow").to_numpy()
+    capacity = property_graph.get_edge_property("value").to_numpy()
+    assert (flow >= 0).all()
+    assert (flow <= capacity).all()
+
+    stats = MaxFlowStatistics(property_graph, source, "value", "flow")
+    assert stats.n_flow_edges == np.count_nonzero(flow)
+    assert stats.n_saturated_edges == np.count_nonzero((flow == capacity) & (capacity > 0))
+
+
+def test_minimum_spanning_forest():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    minimum_spanning_forest(property_graph, "value", "kruskal", MinimumSpanningForestPlan.filter_kruskal())
+    minimum_spanning_forest(property_graph, "value", "boruvka", MinimumSpanningForestPlan.boruvka())
+
+    minimum_spanning_forest_assert_valid(property_graph, "value", "kruskal")
+    minimum_spanning_forest_assert_valid(property_graph, "value", "boruvka")
+
+    # Ties are broken by edge id, so both plans find the same forest
+    kruskal = property_graph.get_edge_property("kruskal").to_numpy()
+    boruvka = property_graph.get_edge_property("boruvka").to_numpy()
+    assert (kruskal == boruvka).all()
+
+    # A spanning forest has one edge fewer than nodes per tree
+    stats = MinimumSpanningForestStatistics(property_graph, "value", "kruskal")
+    assert stats.forest_edges == np.count_nonzero(kruskal)
+    assert stats.forest_edges + stats.trees == property_graph.num_nodes()
+
+
+def test_partition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    partition(property_graph, 4, "output")
+
+    partition_assert_valid(property_graph, 4, "output")
+
+    parts = property_graph.get_node_property("output").to_numpy()
+    assert parts.max() < 4
+
+    stats = PartitionStatistics(property_graph, 4, "output")
+    assert stats.num_partitions == 4
+    assert stats.node_imbalance < 1.2
+    assert stats.communication_volume <= stats.cut_edges
+
+    # Hashing nodes to partitions cuts about 3/4 of the edges
+    assert stats.cut_edges < 0.75 * property_graph.num_edges()
+
+
+def test_partition_edge_balanced():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    partition(property_graph, 4, "output", PartitionObjective.EdgeBalancedCut, PartitionPlan.multilevel(imbalance=0.1))
+
+    partition_assert_valid(property_graph, 4, "output")
+
+    stats = PartitionStatistics(property_graph, 4, "output")
+    assert stats.edge_imbalance < 1.5
+
+
+
+def test_hypergraph_partition_fail():
+    # Every node of a symmetric graph with edges has out-edges to nodes with out-edges, so it is not the bipartite
+    # form of a hypergraph
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    with raises(GaloisError):
+        hypergraph_partition(property_graph, 4, "output")
+
+    with raises(GaloisError):
+        hypergraph_partition(property_graph, 4, "output2", HypergraphPartitionPlan.bipart(deterministic=True))
+
+def test_leiden_clustering():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    leiden_clustering(property_graph, "value", "output")
+
+    stats = LeidenClusteringStatistics(property_graph, "value", "output")
+
+    assert 0 < stats.n_clusters <= property_graph.num_nodes()
+    assert stats.n_non_trivial_clusters <= stats.n_clusters
+    assert 0 < stats.largest_cluster_proportion <= 1
+    assert stats.modularity > 0
+
+    leiden_clustering_assert_valid(property_graph, "value", "output")
+
+
+def test_leiden_clustering_vf():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    leiden_clustering(property_graph, "value", "output", LeidenClusteringPlan.do_all(enable_vf=True))
+
+    stats = LeidenClusteringStatistics(property_graph, "value", "output")
+
+    assert stats.modularity > 0
+
+    leiden_clustering_assert_valid(property_graph, "value", "output")
+
+
+def test_label_propagation():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    label_propagation(property_graph, "output")
+
+    label_propagation_assert_valid(property_graph, "output")
+
+    stats = LabelPropagationStatistics(property_graph, "output")
+
+    assert 0 < stats.n_communities <= property_graph.num_nodes()
+    assert stats.n_non_trivial_communities <= stats.n_communities
+    assert 0 < stats.largest_community_proportion <= 1
+
+    label_propagation(property_graph, "output_seeded", LabelPropagationPlan.synchronous(seed=7, heavy_degree=1))
+
+    label_propagation_assert_valid(property_graph, "output_seeded")
+
+
+def test_bipartite_matching_fail():
+    # Every node of a symmetric graph with edges has both in-edges and out-edges, so it is not directed from left
+    # nodes to right nodes
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    with raises(GaloisError):
+        bipartite_matching(property_graph, "output")
+
+    with raises(GaloisError):
+        weighted_bipartite_matching(property_graph, "value", "output2")
+
+    with raises(GaloisError):
+        bipartite_matching(property_graph, "output3", BipartiteMatchingPlan.suitor())
+
+    plan = BipartiteMatchingPlan.pothen_fan(karp_sipser_initialization=False)
+    assert not plan.karp_sipser_initialization
+
+
+def test_matrix_completion_fail():
+    # rmat10_symmetric is not directed from left nodes to right nodes
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    with raises(GaloisError):
+        matrix_completion(property_graph, "value", "output")
+
+    plan = MatrixCompletionPlan.sgd()
+    plan.deterministic = True
+    with raises(GaloisError):
+        matrix_completion(property_graph, "value", "output2", plan)
+
+    plan = MatrixCompletionPlan.als(latent_vector_size=4)
+    assert plan.latent_vector_size == 4
+
+
 def test_k_truss_fail():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -7,6 +7,7 @@ from numba import from_dtype
 
 from katana.loops import (
     do_all_operator,
+    do_all_range_operator,
     do_all,
     for_each_operator,
     for_each,
@@ -101,6 +102,35 @@ def test_do_all(modes):
     assert np.allclose(out, np.array(range(1, 11)))
 
 
+@pytest.mark.parametrize("modes", simple_modes)
+@pytest.mark.parametrize("chunk_size", [1, 3, 1024])
+def test_do_all_range_operator(modes, chunk_size):
+    @do_all_range_operator(chunk_size=chunk_size)
+    def f(out, i):
+        out[i] += i + 1
+
+    out = np.zeros(10, dtype=int)
+    do_all(range(10), f(out), **modes)
+    assert np.allclose(out, np.array(range(1, 11)))
+
+    do_all(range(5, 5), f(out), **modes)
+    assert np.allclose(out, np.array(range(1, 11)))
+
+
+def test_do_all_range_operator_unsupported_iterable():
+    from katana.datastructures import InsertBag
+
+    @do_all_range_operator()
+    def f(out, i):
+        out[i] = i + 1
+
+    out = np.zeros(10, dtype=int)
+    with pytest.raises(ValueError):
+        do_all(InsertBag[np.uint64](), f(out))
+    with pytest.raises(ValueError):
+        do_all(range(0, 10, 2), f(out))
+
+
 @pytest.mark.parametrize("modes", simple_modes)
 def test_do_all_opaque(modes):
     from katana.datastructures import InsertBag
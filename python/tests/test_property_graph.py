@@ -5,7 +5,7 @@ import numpy as np
 import pyarrow
 import pytest
 
-from katana.loops import do_all_operator, do_all
+from katana.loops import do_all_operator, do_all, map_property
 from katana.property_graph import PropertyGraph
 from katana import TsubaError
 
@@ -29,6 +29,44 @@ def test_reachable_from_10(property_graph):
     assert reachable == [2011, 1422, 1409, 4798, 9483]
 
 
+def test_out_indices_out_dests(property_graph):
+    out_indices = property_graph.out_indices()
+    out_dests = property_graph.out_dests()
+    assert len(out_indices) == property_graph.num_nodes()
+    assert len(out_dests) == property_graph.num_edges()
+    assert list(out_dests[out_indices[9] : out_indices[10]]) == [2011, 1422, 1409, 4798, 9483]
+
+
+def test_topology_views_keep_graph_alive():
+    from katana.example_utils import get_input
+
+    g = PropertyGraph(get_input("propertygraphs/ldbc_003"))
+    indices_view = g.out_indices_view()
+    dests = np.asarray(g.out_dests_view())
+    del g
+    indices = indices_view.as_numpy()
+    assert len(indices) == 29092
+    assert indices[-1] == 39283
+    assert list(dests[indices[9] : indices[10]]) == [2011, 1422, 1409, 4798, 9483]
+    assert not dests.flags.writeable
+
+
+def test_node_property_view(property_graph):
+    property_graph.add_node_property(pyarrow.table(dict(new_prop=range(property_graph.num_nodes()))))
+    view = property_graph.get_node_property_view("new_prop")
+    assert len(view) == property_graph.num_nodes()
+    assert np.array_equal(np.asarray(view), np.arange(property_graph.num_nodes()))
+    with pytest.raises(ValueError):
+        np.asarray(view)[0] = 1
+    if hasattr(np, "from_dlpack"):
+        assert np.array_equal(np.from_dlpack(view), np.arange(property_graph.num_nodes()))
+
+
+def test_edge_property_view_unsupported_type(property_graph):
+    with pytest.raises(TypeError):
+        property_graph.get_edge_property_view("IS_SUBCLASS_OF")
+
+
 def test_nodes_count_edges(property_graph):
     total = 0
     for nid in property_graph:
@@ -167,3 +205,34 @@ def test_simple_algorithm(property_graph):
     assert oprop[0].as_py() == 91
     assert oprop[4].as_py() == 239
     assert oprop[-1].as_py() == 0
+
+
+def test_map_property(property_graph):
+    g = property_graph
+    n = g.num_nodes()
+    g.add_node_property(pyarrow.table(dict(a=np.arange(n, dtype=np.int64), b=np.arange(n, dtype=np.float64) / 2)))
+
+    map_property(g, lambda a, b: a * b + 1, ["a", "b"], "c")
+    c = g.get_node_property("c")
+    assert c.type == pyarrow.float64()
+    assert np.array_equal(c.to_numpy(), np.arange(n) * (np.arange(n) / 2) + 1)
+
+    map_property(g, lambda a: a % 3 == 0, "a", "is_multiple", dtype=np.bool_)
+    assert g.get_node_property("is_multiple").to_pylist() == [i % 3 == 0 for i in range(n)]
+
+
+def test_map_property_edges(property_graph):
+    g = property_graph
+    m = g.num_edges()
+    g.add_edge_property(pyarrow.table(dict(w=np.arange(m, dtype=np.uint32))))
+    map_property(g, lambda w: w * 2, "w", "w2", edges=True, chunk_size=100)
+    assert np.array_equal(g.get_edge_property("w2").to_numpy(), np.arange(m) * 2)
+
+
+def test_map_property_nulls(property_graph):
+    g = property_graph
+    with pytest.raises(ValueError):
+        map_property(g, lambda length: length + 1, "length", "length_plus_one")
+    map_property(g, lambda length: length + 1, "length", "length_plus_one", fill_null=0)
+    expected = [(v if v is not None else 0) + 1 for v in g.get_node_property("length").to_pylist()]
+    assert g.get_node_property("length_plus_one").to_pylist() == expected
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/analytics/QueryServer.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> socketPath(
+    cll::Positional, cll::desc("<socket path>"), cll::Required);
+static cll::list<std::string> graphs(
+    "graph",
+    cll::desc("Load the RDG rdg under name before serving (name=rdg); may be "
+              "repeated"));
+static cll::opt<bool> mapTopology(
+    "mapTopology",
+    cll::desc("Map topology files read-only instead of copying them"),
+    cll::init(false));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+static cll::opt<unsigned> spinWait(
+    "spinWait",
+    cll::desc("Keep idle threads polling for the next loop for this many "
+              "microseconds before they sleep (default value from "
+              "KATANA_SPIN_WAIT_US, or 0)"),
+    cll::init(0));
+static cll::opt<std::string> request(
+    "request",
+    cll::desc("Instead of serving, send this JSON request to the server at "
+              "<socket path> and print its response"));
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  if (!request.empty()) {
+    std::string text = request;
+    auto parsed = katana::JsonParse<nlohmann::json>(text);
+    if (!parsed) {
+      KATANA_LOG_FATAL("request is not valid JSON: {}", parsed.error());
+    }
+    auto response =
+        katana::analytics::QueryServerCall(socketPath, parsed.value());
+    if (!response) {
+      KATANA_LOG_FATAL("request failed: {}", response.error());
+    }
+    std::cout << response.value().dump(2) << "\n";
+    return response.value().value("ok", false) ? 0 : 1;
+  }
+
+  katana::setActiveThreads(numThreads);
+  if (spinWait.getNumOccurrences()) {
+    katana::GetThreadPool().setSpinWait(std::chrono::microseconds(spinWait));
+  }
+
+  katana::analytics::QueryServer server;
+  for (const std::string& graph : graphs) {
+    size_t equals = graph.find('=');
+    if (equals == std::string::npos) {
+      KATANA_LOG_FATAL("--graph {} is not name=rdg", graph);
+    }
+    auto response = server.Handle(nlohmann::json{
+        {"op", "load"},
+        {"graph", graph.substr(0, equals)},
+        {"rdg", graph.substr(equals + 1)},
+        {"map_topology", mapTopology.getValue()}});
+    if (!response["ok"].get<bool>()) {
+      KATANA_LOG_FATAL(
+          "loading {}: {}", graph, response["error"].get<std::string>());
+    }
+    std::cout << "Loaded " << graph << " in " << response["seconds"] << "s\n";
+  }
+
+  std::cout << "Serving at " << socketPath << "\n";
+  if (auto r = server.Serve(socketPath); !r) {
+    KATANA_LOG_FATAL("serving: {}", r.error());
+  }
+
+  return 0;
+}
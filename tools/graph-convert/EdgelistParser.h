@@ -0,0 +1,408 @@
+#ifndef KATANA_TOOLS_GRAPHCONVERT_EDGELISTPARSER_H_
+#define KATANA_TOOLS_GRAPHCONVERT_EDGELISTPARSER_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/gIO.h"
+
+/// A read-only memory map of a whole file
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      KATANA_DIE("failed to open ", filename, ": ", std::strerror(errno));
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) != 0) {
+      KATANA_DIE("failed to stat ", filename, ": ", std::strerror(errno));
+    }
+    size_ = buf.st_size;
+    if (size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data_ == MAP_FAILED) {
+        KATANA_DIE("failed to map ", filename, ": ", std::strerror(errno));
+      }
+      madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (size_ > 0) {
+      munmap(data_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* begin() const { return static_cast<const char*>(data_); }
+  const char* end() const { return begin() + size_; }
+
+private:
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+/// Describes a text file with one edge per line: a source, a destination
+/// and, if the graph has edge data, a value.
+struct EdgelistFormat {
+  /// Fields are separated by this character, with optional whitespace around
+  /// it, instead of by whitespace alone
+  std::optional<char> delim;
+  /// If set, only lines whose first field is this are edges and other lines
+  /// are ignored (e.g., "a" in DIMACS files)
+  std::string line_tag;
+  /// Node IDs in the file start from this value
+  uint64_t index_base{0};
+  /// If nonzero, the number of nodes, and node IDs must be less than it;
+  /// otherwise the number of nodes is one more than the largest ID
+  uint64_t num_nodes{0};
+  /// Value of edges whose lines have no value; if unset, lines without a
+  /// value do not match the format
+  std::optional<double> default_value;
+};
+
+/// Builds the CSR of the graph in an edge list in parallel.
+///
+/// The text is split into chunks at line boundaries that threads parse
+/// independently with std::from_chars. A first pass counts the lines and
+/// edges of each chunk and finds the largest node ID, a second counts
+/// degrees with atomic increments, and after a prefix sum a third scatters
+/// edges to their place in the CSR. Threads append to the edges of a node in
+/// the order they claim positions, so the edges of a node that come from
+/// more than one chunk are put back in file order afterwards using the
+/// chunk each edge came from. The result is the same as reading the file
+/// front to back.
+template <typename EdgeTy>
+class EdgelistParser {
+  using EdgeData = katana::LargeArray<EdgeTy>;
+  using edge_value_type = typename EdgeData::value_type;
+
+public:
+  /// Approximate size of the text of a chunk
+  static constexpr size_t kChunkSize = size_t{16} << 20;
+
+  /// Scan the lines of [begin, end). Line numbers in diagnostics count from
+  /// first_line.
+  EdgelistParser(
+      const char* begin, const char* end, const EdgelistFormat& format,
+      uint64_t first_line = 1)
+      : format_(format), first_line_(first_line) {
+    uint64_t num_chunks = std::clamp<uint64_t>(
+        (end - begin) / kChunkSize, 1, std::numeric_limits<uint16_t>::max());
+    uint64_t size = end - begin;
+    const char* chunk_begin = begin;
+    for (uint64_t i = 1; i <= num_chunks; ++i) {
+      const char* chunk_end = end;
+      if (i < num_chunks) {
+        chunk_end = std::max(chunk_begin, begin + size * i / num_chunks);
+        const void* newline =
+            std::memchr(chunk_end, '\n', end - chunk_end);
+        chunk_end = newline ? static_cast<const char*>(newline) + 1 : end;
+      }
+      chunks_.emplace_back(Chunk{chunk_begin, chunk_end});
+      chunk_begin = chunk_end;
+    }
+    Scan();
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+
+  /// The first line that did not match the format, if any
+  std::optional<uint64_t> first_skipped_line() const {
+    return first_skipped_line_;
+  }
+
+  /// Fill in the CSR of the graph. out_indices[n] is one past the last edge
+  /// of node n.
+  template <typename Dest>
+  void Build(
+      katana::LargeArray<uint64_t>* out_indices,
+      katana::LargeArray<Dest>* out_dests, EdgeData* edge_data) {
+    katana::LargeArray<std::atomic<uint64_t>> cursors;
+    cursors.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { cursors.constructAt(n, 0); }, katana::no_stats());
+    ForEachEdge([&](uint64_t, uint64_t, const Edge& edge) {
+      cursors[edge.src].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    out_indices->allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { (*out_indices)[n] = cursors[n]; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        out_indices->begin(), out_indices->end(), out_indices->begin());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { cursors[n] = n > 0 ? (*out_indices)[n - 1] : 0; },
+        katana::no_stats());
+
+    out_dests->allocateBlocked(num_edges_);
+    edge_data->allocateBlocked(num_edges_);
+    katana::LargeArray<uint16_t> chunk_of;
+    chunk_of.allocateBlocked(num_edges_);
+    ForEachEdge([&](uint64_t chunk, uint64_t, const Edge& edge) {
+      uint64_t e = cursors[edge.src].fetch_add(1, std::memory_order_relaxed);
+      (*out_dests)[e] = edge.dst;
+      edge_data->set(e, edge.data);
+      chunk_of[e] = chunk;
+    });
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          uint64_t begin = n > 0 ? (*out_indices)[n - 1] : 0;
+          uint64_t end = (*out_indices)[n];
+          if (!std::is_sorted(
+                  chunk_of.begin() + begin, chunk_of.begin() + end)) {
+            RestoreFileOrder(begin, end, chunk_of, out_dests, edge_data);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+private:
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    uint64_t num_lines{0};
+    uint64_t num_edges{0};
+    uint64_t max_id{0};
+    std::optional<uint64_t> first_skipped_line{};
+  };
+
+  struct Edge {
+    uint64_t src;
+    uint64_t dst;
+    edge_value_type data{};
+  };
+
+  enum class LineKind { kEdge, kIgnored, kMalformed };
+
+  static const char* SkipSpace(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+      ++p;
+    }
+    return p;
+  }
+
+  /// Parse a number at p, returning the end of it or nullptr
+  template <typename T>
+  static const char* ParseNumber(const char* p, const char* end, T* out) {
+    if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+      auto [ptr, ec] = std::from_chars(p, end, *out);
+      return ec == std::errc() ? ptr : nullptr;
+#else
+      // Older standard libraries only convert integers; copy the number so
+      // that strtod cannot read past the end of the mapping
+      char buf[64];
+      size_t len = std::min<size_t>(end - p, sizeof(buf) - 1);
+      std::memcpy(buf, p, len);
+      buf[len] = '\0';
+      char* parsed;
+      *out = std::strtod(buf, &parsed);
+      return parsed == buf ? nullptr : p + (parsed - buf);
+#endif
+    } else {
+      if (p != end && *p == '+') {
+        ++p;
+      }
+      auto [ptr, ec] = std::from_chars(p, end, *out);
+      return ec == std::errc() ? ptr : nullptr;
+    }
+  }
+
+  /// Expect a delimiter, if the format has one, and skip the whitespace
+  /// around it
+  const char* SkipDelim(const char* p, const char* end) const {
+    p = SkipSpace(p, end);
+    if (format_.delim) {
+      if (p == end || *p != *format_.delim) {
+        return nullptr;
+      }
+      p = SkipSpace(p + 1, end);
+    }
+    return p;
+  }
+
+  LineKind ParseLine(const char* p, const char* end, Edge* edge) const {
+    p = SkipSpace(p, end);
+    if (p == end) {
+      return LineKind::kIgnored;
+    }
+    if (!format_.line_tag.empty()) {
+      const char* tag_end = p;
+      while (tag_end != end && *tag_end != ' ' && *tag_end != '\t') {
+        ++tag_end;
+      }
+      if (std::string_view(p, tag_end - p) != format_.line_tag) {
+        return LineKind::kIgnored;
+      }
+      p = SkipSpace(tag_end, end);
+    }
+
+    if (!(p = ParseNumber(p, end, &edge->src)) ||
+        !(p = SkipDelim(p, end)) || !(p = ParseNumber(p, end, &edge->dst))) {
+      return LineKind::kMalformed;
+    }
+    if (edge->src < format_.index_base || edge->dst < format_.index_base) {
+      KATANA_DIE(
+          "node id out of range: ", std::min(edge->src, edge->dst),
+          " with ids starting from ", format_.index_base);
+    }
+    edge->src -= format_.index_base;
+    edge->dst -= format_.index_base;
+
+    if constexpr (EdgeData::has_value) {
+      const char* value_begin = SkipDelim(p, end);
+      if (format_.default_value && SkipSpace(p, end) == end) {
+        edge->data = static_cast<edge_value_type>(*format_.default_value);
+      } else if (
+          !value_begin || !ParseNumber(value_begin, end, &edge->data)) {
+        return LineKind::kMalformed;
+      }
+    }
+    return LineKind::kEdge;
+  }
+
+  /// Call fn(chunk index, line index in chunk, line kind, edge) for each
+  /// line of chunk
+  template <typename F>
+  void ForEachLine(uint64_t chunk_index, F fn) const {
+    const Chunk& chunk = chunks_[chunk_index];
+    uint64_t line = 0;
+    for (const char* p = chunk.begin; p != chunk.end; ++line) {
+      const char* line_end = static_cast<const char*>(
+          std::memchr(p, '\n', chunk.end - p));
+      if (!line_end) {
+        line_end = chunk.end;
+      }
+      Edge edge;
+      fn(line, ParseLine(p, line_end, &edge), edge);
+      p = line_end == chunk.end ? line_end : line_end + 1;
+    }
+  }
+
+  /// Call fn(chunk index, line index in chunk, edge) for each edge, in
+  /// parallel
+  template <typename F>
+  void ForEachEdge(F fn) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{chunks_.size()}),
+        [&](uint64_t c) {
+          ForEachLine(c, [&](uint64_t line, LineKind kind, const Edge& edge) {
+            if (kind == LineKind::kEdge) {
+              fn(c, line, edge);
+            }
+          });
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  }
+
+  void Scan() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{chunks_.size()}),
+        [&](uint64_t c) {
+          Chunk& chunk = chunks_[c];
+          ForEachLine(c, [&](uint64_t line, LineKind kind, const Edge& edge) {
+            chunk.num_lines = line + 1;
+            if (kind == LineKind::kMalformed && !chunk.first_skipped_line) {
+              chunk.first_skipped_line = line;
+            }
+            if (kind == LineKind::kEdge) {
+              chunk.num_edges += 1;
+              chunk.max_id = std::max({chunk.max_id, edge.src, edge.dst});
+            }
+          });
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+
+    uint64_t lines = first_line_;
+    uint64_t max_id = 0;
+    for (const Chunk& chunk : chunks_) {
+      if (chunk.first_skipped_line && !first_skipped_line_) {
+        first_skipped_line_ = lines + *chunk.first_skipped_line;
+      }
+      lines += chunk.num_lines;
+      num_edges_ += chunk.num_edges;
+      max_id = std::max(max_id, chunk.max_id);
+    }
+
+    if (format_.num_nodes == 0) {
+      num_nodes_ = num_edges_ > 0 ? max_id + 1 : 0;
+    } else {
+      num_nodes_ = format_.num_nodes;
+      if (num_edges_ > 0 && max_id >= num_nodes_) {
+        KATANA_DIE(
+            "node id out of range: ", max_id + format_.index_base,
+            " with ", num_nodes_, " nodes");
+      }
+    }
+  }
+
+  template <typename Dest>
+  static void RestoreFileOrder(
+      uint64_t begin, uint64_t end,
+      const katana::LargeArray<uint16_t>& chunk_of,
+      katana::LargeArray<Dest>* out_dests, EdgeData* edge_data) {
+    // Edges from the same chunk are already in order, so a stable sort by
+    // chunk puts all of them in order
+    std::vector<uint64_t> order(end - begin);
+    std::iota(order.begin(), order.end(), begin);
+    std::stable_sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+      return chunk_of[a] < chunk_of[b];
+    });
+
+    std::vector<Dest> dests;
+    std::vector<edge_value_type> data;
+    for (uint64_t e : order) {
+      dests.emplace_back((*out_dests)[e]);
+      if constexpr (EdgeData::has_value) {
+        data.emplace_back((*edge_data)[e]);
+      }
+    }
+    for (uint64_t i = 0; i < order.size(); ++i) {
+      (*out_dests)[begin + i] = dests[i];
+      if constexpr (EdgeData::has_value) {
+        edge_data->set(begin + i, data[i]);
+      }
+    }
+  }
+
+  EdgelistFormat format_;
+  uint64_t first_line_;
+  std::vector<Chunk> chunks_;
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  std::optional<uint64_t> first_skipped_line_;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_IMPORTPIPELINE_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_IMPORTPIPELINE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace katana {
+
+/// A queue of batches between one producer and one consumer that holds at
+/// most max_bytes of batches, by the sizes given to Push. A batch larger
+/// than max_bytes is admitted when the queue is empty so that the pipeline
+/// always makes progress.
+template <typename Batch>
+class BoundedBatchQueue {
+public:
+  explicit BoundedBatchQueue(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /// Wait for room and add batch. Returns false, dropping batch, if the
+  /// queue was closed.
+  bool Push(Batch batch, size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&] {
+      return closed_ || queue_.empty() || bytes_ + bytes <= max_bytes_;
+    });
+    if (closed_) {
+      return false;
+    }
+    bytes_ += bytes;
+    queue_.emplace_back(std::move(batch), bytes);
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// Wait for a batch. Returns nullopt once the queue is closed and empty.
+  std::optional<Batch> Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [&] { return closed_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return std::nullopt;
+    }
+    auto [batch, bytes] = std::move(queue_.front());
+    queue_.pop_front();
+    bytes_ -= bytes;
+    not_full_.notify_one();
+    return std::move(batch);
+  }
+
+  /// No more batches will be pushed; pending ones can still be popped
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+private:
+  size_t max_bytes_;
+  size_t bytes_{0};
+  bool closed_{false};
+  std::deque<std::pair<Batch, size_t>> queue_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+/// Run produce(queue) on a reader thread while the calling thread passes
+/// each batch it pushes, in order, to consume(batch). At most max_bytes of
+/// batches wait between the two, so fetching input overlaps with building
+/// the graph without reading ahead of it without bound.
+///
+/// The producer should return when its input is exhausted or when Push
+/// returns false. An exception thrown by either side is rethrown on the
+/// calling thread once the reader has stopped.
+template <typename Batch, typename Produce, typename Consume>
+void
+StreamBatches(size_t max_bytes, Produce produce, Consume consume) {
+  BoundedBatchQueue<Batch> queue(max_bytes);
+  std::exception_ptr reader_error;
+  std::thread reader([&] {
+    try {
+      produce(&queue);
+    } catch (...) {
+      reader_error = std::current_exception();
+    }
+    queue.Close();
+  });
+
+  std::exception_ptr consumer_error;
+  try {
+    while (std::optional<Batch> batch = queue.Pop()) {
+      consume(std::move(*batch));
+    }
+  } catch (...) {
+    consumer_error = std::current_exception();
+    queue.Close();
+  }
+  reader.join();
+
+  if (consumer_error) {
+    std::rethrow_exception(consumer_error);
+  }
+  if (reader_error) {
+    std::rethrow_exception(reader_error);
+  }
+}
+
+}  // namespace katana
+
+#endif
@@ -18,28 +18,43 @@
  */
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
-#include <deque>
-#include <fstream>
-#include <ios>
-#include <iostream>
+#include <cstring>
+#include <future>
 #include <limits>
-#include <random>
-#include <regex>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
-#include <boost/mpl/if.hpp>
-
-#include "katana/FileGraph.h"
-#include "katana/LargeArray.h"
-#include "katana/OfflineGraph.h"
+#include "EdgelistParser.h"
+#include "katana/BitMath.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/Threads.h"
+#include "katana/gIO.h"
+#include "katana/gstl.h"
 #include "llvm/Support/CommandLine.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/RDG.h"
+#include "tsuba/tsuba.h"
 
 namespace cll = llvm::cl;
 
@@ -49,209 +64,701 @@ static cll::opt<std::string> outputFilename(
     cll::Positional, cll::desc("<output file>"), cll::Required);
 static cll::opt<bool> useSmallData(
     "32bitData", cll::desc("Use 32 bit data"), cll::init(false));
-static cll::opt<bool> edgesSorted(
-    "edgesSorted", cll::desc("Edges are sorted by the sourceIDs."),
-    cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<bool> writeRDG(
+    "rdg",
+    cll::desc("Write an RDG with the topology of the graph instead of a .gr "
+              "file; edge values are dropped"),
+    cll::init(false));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+static cll::opt<std::string> tempDir(
+    "tempDir",
+    cll::desc("Directory for the sorted runs of edges, ideally on an SSD "
+              "(default value /tmp)"),
+    cll::init("/tmp"));
+static cll::opt<uint64_t> memoryBudget(
+    "memoryBudget",
+    cll::desc("Megabytes of memory for buffering edges before they are "
+              "sorted and spilled to runs (default value 4096)"),
+    cll::init(4096));
+
+namespace {
+
+/// Approximate size of the text each thread parses at a time
+constexpr uint64_t kChunkSize = uint64_t{16} << 20;
+/// Fewest edges a thread buffers before it spills them
+constexpr uint64_t kMinRunEdges = uint64_t{1} << 16;
+/// Partitions of the merge per thread, so that threads can balance load
+constexpr uint64_t kPartitionsPerThread = 4;
 
-union dataTy {
-  int64_t ival;
-  double dval;
-  float fval;
-  int32_t i32val;
+/// An edge of the input. data holds the bits of the edge value, as a 32-bit
+/// value in the low half with -32bitData.
+struct EdgeRecord {
+  uint64_t src;
+  uint64_t dst;
+  uint64_t data;
 };
 
-void
-perEdge(
-    std::istream& is, std::function<void(uint64_t, uint64_t, dataTy)> fn,
-    std::function<void(uint64_t, uint64_t)> fnPreSize) {
-  std::string line;
-
-  uint64_t bytes = 0;
-  uint64_t counter = 0;
-  uint64_t totalBytes = 0;
-
-  const std::regex problemLine(
-      "^p[[:space:]]+[[:alpha:]]+[[:space:]]+([[:"
-      "digit:]]+)[[:space:]]+([[:digit:]]+)");
-  const std::regex noData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]*");
-  // const std::regex noData_nospace(
-  // "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)");
-  const std::regex intData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:"
-      "]]+)[[:space:]]+(-?[[:digit:]]+)");
-  const std::regex floatData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]+(-?[["
-      ":digit:]]+\\.[[:digit:]]+)");
-
-  auto timer = std::chrono::system_clock::now();
-  auto timerStart = timer;
-
-  std::smatch matches;
-  bool zeroBased = false;  // set to 1 if file is one-indexed
-  bool seenEdge = false;
-
-  while (std::getline(is, line)) {
-    auto t = line.size() + 1;
-    bytes += t;
-    totalBytes += t;
-    ++counter;
-
-    if (counter == 1024 * 128) {
-      counter = 0;
-      auto timer2 = std::chrono::system_clock::now();
-      std::cout << "Scan: "
-                << (double)bytes /
-                       std::chrono::duration_cast<std::chrono::microseconds>(
-                           timer2 - timer)
-                           .count()
-                << " MB/s\n";
-      timer = timer2;
-      bytes = 0;
+/// Reports the rate and progress of a phase about once a second
+class Progress {
+public:
+  Progress(std::string phase, std::string unit, uint64_t total)
+      : phase_(std::move(phase)),
+        unit_(std::move(unit)),
+        total_(total),
+        start_(Clock::now()) {}
+
+  void Add(uint64_t amount) {
+    uint64_t done = done_.fetch_add(amount, std::memory_order_relaxed) + amount;
+    int64_t now = Elapsed();
+    int64_t last = last_report_.load(std::memory_order_relaxed);
+    if (now - last >= kReportInterval &&
+        last_report_.compare_exchange_strong(last, now)) {
+      Report(done, now);
     }
+  }
 
-    dataTy data;
-    bool match = false;
-    if (std::regex_match(line, matches, floatData)) {
-      if (useSmallData)
-        data.fval = std::stof(matches[3].str());
-      else
-        data.dval = std::stod(matches[3].str());
-      match = true;
-    } else if (std::regex_match(line, matches, intData)) {
-      if (useSmallData)
-        data.i32val = std::stoul(matches[3].str());
-      else
-        data.ival = std::stoll(matches[3].str());
-      match = true;
-    } else if (std::regex_match(
-                   line, matches,
-                   noData)) {  // || std::regex_match(line, matches,
-                               // noData_nospace)) {
-      data.ival = 0;
-      match = true;
-    } else if (std::regex_match(line, matches, problemLine)) {
-      if (seenEdge) {
-        std::cerr << "Error: seeing a dimacs problem line after seeing edges\n";
-        abort();
-      }
-      zeroBased = true;  // dimacs files are 1-indexed
-      fnPreSize(std::stoull(matches[1].str()), std::stoull(matches[2].str()));
+  void Finish() { Report(done_.load(), Elapsed()); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int64_t kReportInterval = 1000000;
+
+  /// Microseconds since the start of the phase
+  int64_t Elapsed() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               Clock::now() - start_)
+        .count();
+  }
+
+  void Report(uint64_t done, int64_t elapsed) const {
+    double seconds = std::max<double>(elapsed, 1) / 1e6;
+    katana::gInfo(
+        phase_, ": ", done, " of ", total_, " ", unit_, " (",
+        total_ ? 100 * done / total_ : 100, "%) at ", done / seconds / 1e6,
+        " M", unit_, "/s");
+  }
+
+  std::string phase_;
+  std::string unit_;
+  uint64_t total_;
+  Clock::time_point start_;
+  std::atomic<uint64_t> done_{0};
+  std::atomic<int64_t> last_report_{0};
+};
+
+/// A shared mapping that is unmapped when this goes out of scope
+class Mapping {
+public:
+  Mapping() = default;
+  Mapping(int fd, uint64_t size, int prot) : size_(size) {
+    if (size_ == 0) {
+      return;
     }
-    if (match) {
-      seenEdge = true;
-      uint64_t src = std::stoull(matches[1].str());
-      uint64_t dst = std::stoull(matches[2].str());
-      if (zeroBased) {
-        if (src == 0 || dst == 0) {
-          std::cerr << "Error: node id 0 in a dimacs graph\n";
-          abort();
-        }
-        src -= 1;
-        dst -= 1;
+    data_ = mmap(nullptr, size_, prot, MAP_SHARED, fd, 0);
+    if (data_ == MAP_FAILED) {
+      KATANA_DIE("failed to map file: ", std::strerror(errno));
+    }
+  }
+  ~Mapping() {
+    if (size_ > 0) {
+      munmap(data_, size_);
+    }
+  }
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  template <typename T>
+  T* as() const {
+    return static_cast<T*>(data_);
+  }
+  uint64_t size() const { return size_; }
+
+private:
+  void* data_{nullptr};
+  uint64_t size_{0};
+};
+
+/// A sorted run of edges in an unlinked temporary file
+struct Run {
+  int fd{-1};
+  uint64_t num_edges{0};
+};
+
+int
+OpenTempFile() {
+  std::string path = tempDir + "/graph-convert-huge-XXXXXX";
+  int fd = mkstemp(path.data());
+  if (fd < 0) {
+    KATANA_DIE(
+        "failed to create a file in ", tempDir, ": ", std::strerror(errno));
+  }
+  unlink(path.c_str());
+  return fd;
+}
+
+std::error_code
+WriteAll(int fd, const void* data, uint64_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
       }
-      fn(src, dst, data);
+      return std::error_code(errno, std::system_category());
     }
+    bytes += written;
+    size -= written;
   }
-  auto timer2 = std::chrono::system_clock::now();
-  std::cout << "File Scan: "
-            << (double)totalBytes /
-                   std::chrono::duration_cast<std::chrono::microseconds>(
-                       timer2 - timerStart)
-                       .count()
-            << " MB/s\n";
+  return std::error_code();
 }
 
+/// Sort records by source with a stable least significant digit radix sort
+/// that only looks at the bytes the largest source needs. scratch is the
+/// second buffer of the sort.
 void
-go(std::istream& input) {
-  try {
-    std::deque<uint64_t> edgeCount;
-    perEdge(
-        input,
-        [&edgeCount](uint64_t src, uint64_t, dataTy) {
-          if (edgeCount.size() <= src)
-            edgeCount.resize(src + 1);
-          ++edgeCount[src];
-        },
-        [&edgeCount](uint64_t nodes, uint64_t) { edgeCount.resize(nodes); });
-    input.clear();
-    input.seekg(0, std::ios_base::beg);
-    katana::OfflineGraphWriter outFile(outputFilename, useSmallData);
-    outFile.setCounts(edgeCount);
-    perEdge(
-        input,
-        [&outFile, &edgeCount](uint64_t src, uint64_t dst, dataTy data) {
-          auto off = --edgeCount[src];
-          if (useSmallData)
-            outFile.setEdge(src, off, dst, data.i32val);
-          else
-            outFile.setEdge(src, off, dst, data.ival);
-        },
-        [](uint64_t, uint64_t) {});
-  } catch (const char* c) {
-    std::cerr << "Failed with: " << c << "\n";
-    abort();
+RadixSortBySource(
+    std::vector<EdgeRecord>* records, std::vector<EdgeRecord>* scratch) {
+  auto by_source = [](const EdgeRecord& a, const EdgeRecord& b) {
+    return a.src < b.src;
+  };
+  if (std::is_sorted(records->begin(), records->end(), by_source)) {
+    return;
+  }
+  uint64_t max_src =
+      std::max_element(records->begin(), records->end(), by_source)->src;
+  scratch->resize(records->size());
+  for (unsigned shift = 0; shift < 64 && (max_src >> shift) != 0;
+       shift += 8) {
+    std::array<uint64_t, 257> starts{};
+    for (const EdgeRecord& record : *records) {
+      ++starts[((record.src >> shift) & 0xff) + 1];
+    }
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    for (const EdgeRecord& record : *records) {
+      (*scratch)[starts[(record.src >> shift) & 0xff]++] = record;
+    }
+    records->swap(*scratch);
+  }
+}
+
+/// What a line of the input holds
+enum class LineKind { kEdge, kProblem, kIgnored };
+
+const char*
+SkipSpace(const char* p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
+  }
+  return p;
+}
+
+const char*
+ParseInteger(const char* p, const char* end, uint64_t* out) {
+  auto [ptr, ec] = std::from_chars(p, end, *out);
+  return ec == std::errc() ? ptr : nullptr;
+}
+
+/// Parse the value of an edge into the bits of data: a floating point number
+/// if it has a decimal point and an integer otherwise
+bool
+ParseValue(const char* p, const char* end, uint64_t* data) {
+  const char* value_end = p;
+  while (value_end != end && *value_end != ' ' && *value_end != '\t' &&
+         *value_end != '\r') {
+    ++value_end;
+  }
+  std::string_view text(p, value_end - p);
+  *data = 0;
+  if (text.find('.') != std::string_view::npos) {
+    // strtod needs a terminated string
+    std::string copy(text);
+    char* parsed;
+    double value = std::strtod(copy.c_str(), &parsed);
+    if (parsed == copy.c_str()) {
+      return false;
+    }
+    if (useSmallData) {
+      auto small = static_cast<float>(value);
+      std::memcpy(data, &small, sizeof(small));
+    } else {
+      std::memcpy(data, &value, sizeof(value));
+    }
+    return true;
+  }
+  int64_t value;
+  auto [ptr, ec] = std::from_chars(p, value_end, value);
+  if (ec != std::errc()) {
+    return false;
+  }
+  if (useSmallData) {
+    auto small = static_cast<int32_t>(value);
+    std::memcpy(data, &small, sizeof(small));
+  } else {
+    std::memcpy(data, &value, sizeof(value));
+  }
+  return true;
+}
+
+/// Parse a line: "p <kind> <nodes> <edges>" is a DIMACS problem line, whose
+/// node count is stored in problem_nodes, and "[a] <src> <dst> [<value>]" is
+/// an edge. Anything else, e.g., a comment, is ignored.
+LineKind
+ParseLine(
+    const char* p, const char* end, EdgeRecord* edge,
+    uint64_t* problem_nodes) {
+  p = SkipSpace(p, end);
+  if (p == end) {
+    return LineKind::kIgnored;
+  }
+  if (*p == 'p') {
+    p = SkipSpace(p + 1, end);
+    while (p != end && std::isalpha(static_cast<unsigned char>(*p))) {
+      ++p;
+    }
+    uint64_t num_edges;
+    if (!(p = ParseInteger(SkipSpace(p, end), end, problem_nodes)) ||
+        !ParseInteger(SkipSpace(p, end), end, &num_edges)) {
+      return LineKind::kIgnored;
+    }
+    return LineKind::kProblem;
+  }
+  if (*p == 'a') {
+    p = SkipSpace(p + 1, end);
   }
+  if (!(p = ParseInteger(p, end, &edge->src)) ||
+      !(p = ParseInteger(SkipSpace(p, end), end, &edge->dst))) {
+    return LineKind::kIgnored;
+  }
+  p = SkipSpace(p, end);
+  edge->data = 0;
+  if (p != end && !ParseValue(p, end, &edge->data)) {
+    return LineKind::kIgnored;
+  }
+  return LineKind::kEdge;
 }
 
+/// Call fn(line begin, line end) for each line of [begin, end)
+template <typename F>
 void
-go_edgesSorted(std::istream& input, uint64_t numNodes) {
-  try {
-    std::deque<uint64_t> edgeCount(numNodes, 0);
-    input.clear();
-    input.seekg(0, std::ios_base::beg);
-    katana::OfflineGraphWriter outFile(outputFilename, useSmallData, numNodes);
-    outFile.setCounts(edgeCount);
-    outFile.seekEdgesDstStart();
-    uint64_t curr_src = 0;
-    uint64_t curr_src_edgeCount = 0;
-    perEdge(
-        input,
-        [&outFile, &edgeCount, &curr_src, &curr_src_edgeCount](
-            uint64_t src, uint64_t dst, dataTy) {
-          if (src == curr_src) {
-            ++curr_src_edgeCount;
+ForEachLine(const char* begin, const char* end, F fn) {
+  for (const char* p = begin; p != end;) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!line_end) {
+      line_end = end;
+    }
+    fn(p, line_end);
+    p = line_end == end ? line_end : line_end + 1;
+  }
+}
+
+/// Split [begin, end) into chunks of about kChunkSize at line boundaries and
+/// return the start of each chunk followed by end
+std::vector<const char*>
+SplitChunks(const char* begin, const char* end) {
+  std::vector<const char*> bounds{begin};
+  while (bounds.back() != end) {
+    const char* p = bounds.back();
+    if (static_cast<uint64_t>(end - p) <= kChunkSize) {
+      bounds.emplace_back(end);
+      continue;
+    }
+    const void* newline =
+        std::memchr(p + kChunkSize, '\n', end - p - kChunkSize);
+    bounds.emplace_back(
+        newline ? static_cast<const char*>(newline) + 1 : end);
+  }
+  return bounds;
+}
+
+/// The header of a DIMACS file comes before its first edge. Return where
+/// that edge starts and, if there is a problem line, its node count. DIMACS
+/// node ids start from 1.
+std::pair<const char*, std::optional<uint64_t>>
+ScanHeader(const char* begin, const char* end) {
+  std::optional<uint64_t> problem_nodes;
+  const char* first_edge = end;
+  for (const char* p = begin; p != end && first_edge == end;) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!line_end) {
+      line_end = end;
+    }
+    EdgeRecord edge;
+    uint64_t nodes;
+    switch (ParseLine(p, line_end, &edge, &nodes)) {
+    case LineKind::kProblem:
+      problem_nodes = nodes;
+      break;
+    case LineKind::kEdge:
+      first_edge = p;
+      break;
+    case LineKind::kIgnored:
+      break;
+    }
+    p = line_end == end ? line_end : line_end + 1;
+  }
+  return {first_edge, problem_nodes};
+}
+
+/// The state of one thread while it generates runs
+struct RunGenerator {
+  std::vector<EdgeRecord> filling;
+  std::vector<EdgeRecord> scratch;
+  /// The records of the run being written in the background
+  std::vector<EdgeRecord> writing;
+  std::future<std::error_code> in_flight;
+  std::vector<Run> runs;
+  uint64_t max_id{0};
+  uint64_t num_edges{0};
+
+  void Wait() {
+    if (in_flight.valid()) {
+      if (std::error_code ec = in_flight.get(); ec) {
+        KATANA_DIE("failed to write run: ", ec.message());
+      }
+    }
+  }
+
+  /// Sort the filled records and write them to a new run in the background
+  void Spill() {
+    if (filling.empty()) {
+      return;
+    }
+    RadixSortBySource(&filling, &scratch);
+    Wait();
+    writing.swap(filling);
+    filling.clear();
+    int fd = OpenTempFile();
+    runs.emplace_back(Run{fd, writing.size()});
+    in_flight = std::async(std::launch::async, [this, fd]() {
+      return WriteAll(fd, writing.data(), writing.size() * sizeof(EdgeRecord));
+    });
+  }
+};
+
+/// Pass 1: parse the input in parallel. Each thread parses a contiguous
+/// range of chunks in order and spills its edges to runs sorted by source,
+/// so ordering runs by thread and then by time keeps edges with the same
+/// source in file order.
+std::vector<Run>
+GenerateRuns(
+    const char* begin, const char* end, bool one_based, uint64_t* max_id,
+    uint64_t* num_edges) {
+  std::vector<const char*> bounds = SplitChunks(begin, end);
+  uint64_t num_chunks = bounds.size() - 1;
+  uint64_t run_edges = std::max<uint64_t>(
+      kMinRunEdges, (memoryBudget << 20) /
+                        (3 * katana::getActiveThreads() * sizeof(EdgeRecord)));
+
+  katana::PerThreadStorage<RunGenerator> generators;
+  Progress progress("Parse", "B", end - begin);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    RunGenerator& gen = *generators.getLocal();
+    gen.filling.reserve(run_edges);
+    auto [first, last] = katana::block_range(
+        uint64_t{0}, num_chunks, tid, total);
+    for (uint64_t c = first; c < last; ++c) {
+      ForEachLine(bounds[c], bounds[c + 1], [&](const char* p, const char* e) {
+        EdgeRecord edge;
+        uint64_t nodes;
+        switch (ParseLine(p, e, &edge, &nodes)) {
+        case LineKind::kProblem:
+          KATANA_DIE("dimacs problem line after edges");
+        case LineKind::kIgnored:
+          return;
+        case LineKind::kEdge:
+          break;
+        }
+        if (one_based) {
+          if (edge.src == 0 || edge.dst == 0) {
+            KATANA_DIE("node id 0 in a dimacs graph");
+          }
+          edge.src -= 1;
+          edge.dst -= 1;
+        }
+        gen.max_id = std::max({gen.max_id, edge.src, edge.dst});
+        gen.num_edges += 1;
+        gen.filling.emplace_back(edge);
+        if (gen.filling.size() >= run_edges) {
+          gen.Spill();
+        }
+      });
+      progress.Add(bounds[c + 1] - bounds[c]);
+    }
+    gen.Spill();
+    gen.Wait();
+    std::vector<EdgeRecord>().swap(gen.filling);
+    std::vector<EdgeRecord>().swap(gen.scratch);
+    std::vector<EdgeRecord>().swap(gen.writing);
+  });
+  progress.Finish();
+
+  std::vector<Run> runs;
+  *max_id = 0;
+  *num_edges = 0;
+  for (unsigned i = 0; i < generators.size(); ++i) {
+    RunGenerator& gen = *generators.getRemote(i);
+    runs.insert(runs.end(), gen.runs.begin(), gen.runs.end());
+    *max_id = std::max(*max_id, gen.max_id);
+    *num_edges += gen.num_edges;
+  }
+  return runs;
+}
+
+/// The sorted runs of pass 1, mapped for the merge
+class MappedRuns {
+public:
+  explicit MappedRuns(const std::vector<Run>& runs) {
+    for (const Run& run : runs) {
+      maps_.emplace_back(std::make_unique<Mapping>(
+          run.fd, run.num_edges * sizeof(EdgeRecord), PROT_READ));
+      close(run.fd);
+      if (run.num_edges > 0) {
+        madvise(
+            maps_.back()->as<void>(), maps_.back()->size(), MADV_SEQUENTIAL);
+      }
+      runs_.emplace_back(
+          maps_.back()->as<const EdgeRecord>(), run.num_edges);
+    }
+  }
+
+  uint64_t size() const { return runs_.size(); }
+
+  const EdgeRecord* begin(uint64_t r) const { return runs_[r].first; }
+  const EdgeRecord* end(uint64_t r) const {
+    return runs_[r].first + runs_[r].second;
+  }
+
+  /// The first record of run r whose source is at least node
+  const EdgeRecord* LowerBound(uint64_t r, uint64_t node) const {
+    return std::lower_bound(
+        begin(r), end(r), node,
+        [](const EdgeRecord& record, uint64_t n) { return record.src < n; });
+  }
+
+  /// Number of edges whose source is less than node
+  uint64_t CountBefore(uint64_t node) const {
+    uint64_t count = 0;
+    for (uint64_t r = 0; r < size(); ++r) {
+      count += LowerBound(r, node) - begin(r);
+    }
+    return count;
+  }
+
+private:
+  std::vector<std::unique_ptr<Mapping>> maps_;
+  std::vector<std::pair<const EdgeRecord*, uint64_t>> runs_;
+};
+
+/// Split the nodes into num_partitions ranges with about the same number of
+/// edges and return the first node of each range followed by num_nodes
+std::vector<uint64_t>
+PartitionNodes(
+    const MappedRuns& runs, uint64_t num_nodes, uint64_t num_edges,
+    uint64_t num_partitions) {
+  std::vector<uint64_t> bounds(num_partitions + 1, num_nodes);
+  bounds[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{1}, num_partitions),
+      [&](uint64_t p) {
+        // The first node before which at least p / num_partitions of the
+        // edges are
+        uint64_t target = num_edges * p / num_partitions;
+        uint64_t lo = 0;
+        uint64_t hi = num_nodes;
+        while (lo < hi) {
+          uint64_t mid = lo + (hi - lo) / 2;
+          if (runs.CountBefore(mid) < target) {
+            lo = mid + 1;
           } else {
-            // std::cout << "CHANGES : " << src << " : " << curr_src << "
-            // COUNT : " << curr_src_edgeCount << "\n";
-            if (src < curr_src) {
-              std::cerr << " ERROR : File is not sorted\n";
-              abort();
-            }
-            edgeCount[curr_src] = curr_src_edgeCount;
-            curr_src = src;
-            curr_src_edgeCount = 1;
+            hi = mid;
           }
-          outFile.setEdgeSorted(dst);
-        },
-        [](uint64_t, uint64_t) {});
-    // To take care of the last src node ID.
-    edgeCount[curr_src] = curr_src_edgeCount;
-    outFile.setCounts(edgeCount);
-  } catch (const char* c) {
-    std::cerr << "Failed with: " << c << "\n";
-    abort();
+        }
+        bounds[p] = lo;
+      },
+      katana::no_stats());
+  return bounds;
+}
+
+/// Pass 2: merge the runs into the topology. Each partition of the nodes
+/// merges its slice of every run on its own, into the place of its edges in
+/// the output, which only depends on the number of edges before it.
+void
+MergeRuns(
+    const MappedRuns& runs, uint64_t num_nodes, uint64_t num_edges,
+    uint64_t* out_indices, uint32_t* out_dests, uint8_t* edge_data,
+    uint64_t edge_size) {
+  uint64_t num_partitions =
+      std::max<uint64_t>(
+          1, std::min<uint64_t>(
+                 num_nodes, katana::getActiveThreads() * kPartitionsPerThread));
+  std::vector<uint64_t> bounds =
+      PartitionNodes(runs, num_nodes, num_edges, num_partitions);
+
+  Progress progress("Merge", "edges", num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_partitions),
+      [&](uint64_t p) {
+        uint64_t lo = bounds[p];
+        uint64_t hi = bounds[p + 1];
+        if (lo == hi) {
+          return;
+        }
+
+        // (source, run) of the next record of each run; the run breaks ties
+        // so that edges keep the order of the input
+        using Head = std::pair<uint64_t, uint64_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        std::vector<const EdgeRecord*> cursors(runs.size());
+        std::vector<const EdgeRecord*> ends(runs.size());
+        uint64_t out = 0;
+        for (uint64_t r = 0; r < runs.size(); ++r) {
+          cursors[r] = runs.LowerBound(r, lo);
+          ends[r] = runs.LowerBound(r, hi);
+          out += cursors[r] - runs.begin(r);
+          if (cursors[r] != ends[r]) {
+            heads.emplace(cursors[r]->src, r);
+          }
+        }
+
+        uint64_t node = lo;
+        uint64_t merged = 0;
+        while (!heads.empty()) {
+          uint64_t r = heads.top().second;
+          heads.pop();
+          const EdgeRecord& record = *cursors[r]++;
+          if (cursors[r] != ends[r]) {
+            heads.emplace(cursors[r]->src, r);
+          }
+
+          for (; node < record.src; ++node) {
+            out_indices[node] = out;
+          }
+          out_dests[out] = record.dst;
+          if (edge_size > 0) {
+            std::memcpy(edge_data + out * edge_size, &record.data, edge_size);
+          }
+          ++out;
+          if (++merged == kMinRunEdges) {
+            progress.Add(merged);
+            merged = 0;
+          }
+        }
+        for (; node < hi; ++node) {
+          out_indices[node] = out;
+        }
+        progress.Add(merged);
+      },
+      katana::steal(), katana::no_stats());
+  progress.Finish();
+}
+
+/// Write the graph in runs to the topology file at path
+void
+WriteTopology(
+    const MappedRuns& runs, const std::string& path, uint64_t num_nodes,
+    uint64_t num_edges, uint64_t edge_size) {
+  tsuba::CSRTopologyHeader header{
+      .version = 1,
+      .edge_type_size = edge_size,
+      .num_nodes = num_nodes,
+      .num_edges = num_edges,
+  };
+  uint64_t size = tsuba::CSRTopologyFileSize(header);
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    KATANA_DIE("failed to open ", path, ": ", std::strerror(errno));
+  }
+  if (ftruncate(fd, size) != 0) {
+    KATANA_DIE("failed to size ", path, ": ", std::strerror(errno));
+  }
+  Mapping output(fd, size, PROT_READ | PROT_WRITE);
+  close(fd);
+
+  auto* prefix = output.as<tsuba::CSRTopologyPrefix>();
+  prefix->header = header;
+  auto* out_dests =
+      reinterpret_cast<uint32_t*>(prefix->out_indexes + num_nodes);
+  uint8_t* edge_data = reinterpret_cast<uint8_t*>(out_dests) +
+                       katana::AlignUp<uint64_t>(num_edges * sizeof(uint32_t));
+  MergeRuns(
+      runs, num_nodes, num_edges, prefix->out_indexes, out_dests, edge_data,
+      edge_size);
+
+  if (msync(output.as<void>(), size, MS_SYNC) != 0) {
+    KATANA_DIE("failed to write ", path, ": ", std::strerror(errno));
   }
 }
 
+}  // namespace
+
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
-  std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
+  katana::setActiveThreads(numThreads);
+  uint64_t edge_size = writeRDG ? 0 : (useSmallData ? 4 : 8);
+  katana::gInfo("Data will be ", edge_size, " Bytes");
+
+  MappedFile input(inputFilename);
+  auto [first_edge, problem_nodes] = ScanHeader(input.begin(), input.end());
+
+  uint64_t max_id;
+  uint64_t num_edges;
+  std::vector<Run> run_list = GenerateRuns(
+      first_edge, input.end(), problem_nodes.has_value(), &max_id,
+      &num_edges);
+  katana::gInfo(
+      "Sorted ", num_edges, " edges into ", run_list.size(), " runs");
 
-  std::ifstream infile(inputFilename, std::ios_base::in);
-  if (!infile) {
-    std::cout << "Failed to open " << inputFilename << "\n";
-    return 1;
+  uint64_t num_nodes = numNodes ? numNodes : problem_nodes.value_or(0);
+  if (num_nodes == 0) {
+    num_nodes = num_edges > 0 ? max_id + 1 : 0;
+  } else if (num_edges > 0 && max_id >= num_nodes) {
+    KATANA_DIE(
+        "node id out of range: ", max_id, " with ", num_nodes, " nodes");
+  }
+  if (num_nodes > uint64_t{std::numeric_limits<uint32_t>::max()} + 1) {
+    KATANA_DIE(
+        num_nodes, " nodes do not fit the 32-bit destinations of a topology");
   }
 
-  if (numNodes > 0 && edgesSorted) {
-    go_edgesSorted(infile, numNodes);
-  } else {
-    go(infile);
+  MappedRuns runs(run_list);
+  if (!writeRDG) {
+    WriteTopology(runs, outputFilename, num_nodes, num_edges, edge_size);
+    return 0;
+  }
+
+  // Merge straight into the topology file of a new RDG
+  std::string command_line = katana::Join(" ", argv, argv + argc);
+  if (auto res = tsuba::Create(outputFilename); !res) {
+    KATANA_LOG_FATAL("creating {}: {}", outputFilename, res.error());
   }
+  auto handle_res = tsuba::Open(outputFilename, tsuba::kReadWrite);
+  if (!handle_res) {
+    KATANA_LOG_FATAL("opening {}: {}", outputFilename, handle_res.error());
+  }
+  tsuba::RDGFile handle(std::move(handle_res.value()));
+  katana::Uri top_file_name = tsuba::MakeTopologyFileName(handle);
+  if (top_file_name.scheme() != katana::Uri::kFileScheme) {
+    KATANA_LOG_FATAL("-rdg needs a local output, not {}", outputFilename);
+  }
+  WriteTopology(runs, top_file_name.path(), num_nodes, num_edges, 0);
 
+  tsuba::RDG rdg;
+  rdg.set_rdg_dir(tsuba::GetRDGDir(handle));
+  if (auto res = rdg.SetTopologyFile(top_file_name); !res) {
+    KATANA_LOG_FATAL("adding topology: {}", res.error());
+  }
+  if (auto res = rdg.Store(handle, command_line); !res) {
+    KATANA_LOG_FATAL("storing {}: {}", outputFilename, res.error());
+  }
   return 0;
 }
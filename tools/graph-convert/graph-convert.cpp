@@ -22,17 +22,22 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/mpl/if.hpp>
 #include <llvm/Support/CommandLine.h>
 
+#include "EdgelistParser.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
@@ -49,7 +54,9 @@ enum ConvertMode {
   bipartitegr2sorteddegreegr,
   dimacs2gr,
   edgelist2gr,
+  edgelist2kg,
   csv2gr,
+  csv2kg,
   gr2biggr,
   gr2binarypbbs32,
   gr2binarypbbs64,
@@ -137,7 +144,9 @@ static cll::opt<ConvertMode> convertMode(
             "Sort nodes of bipartite binary gr by degree"),
         clEnumVal(dimacs2gr, "Convert dimacs to binary gr"),
         clEnumVal(edgelist2gr, "Convert edge list to binary gr"),
+        clEnumVal(edgelist2kg, "Convert edge list to property graph"),
         clEnumVal(csv2gr, "Convert csv to binary gr"),
+        clEnumVal(csv2kg, "Convert csv to property graph"),
         clEnumVal(
             gr2biggr,
             "Convert binary gr with little-endian edge data to "
@@ -378,208 +387,198 @@ skipLine(std::ifstream& infile) {
 }
 
 /**
- * Common parsing for edgelist style text files.
- *
- * src dst [weight]
- * ...
- *
- * If delim is set, this function expects that each entry is separated by delim
- * surrounded by optional whitespace.
+ * Return the line at *pos, without its newline, and advance *pos to the
+ * next line.
  */
-template <typename EdgeTy>
-void
-convertEdgelist(
-    const std::string& infilename, const std::string& outfilename,
-    const bool skipFirstLine, std::optional<char> delim) {
-  typedef katana::FileGraphWriter Writer;
-  typedef katana::LargeArray<EdgeTy> EdgeData;
-  typedef typename EdgeData::value_type edge_value_type;
-
-  Writer p;
-  EdgeData edgeData;
-  std::ifstream infile(infilename.c_str());
-
-  size_t numNodes = 0;
-  size_t numEdges = 0;
-  size_t lineNumber = 0;
+std::string_view
+nextLine(const char** pos, const char* end) {
+  const char* begin = *pos;
+  const char* newline =
+      static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+  *pos = newline ? newline + 1 : end;
+  return std::string_view(begin, (newline ? newline : end) - begin);
+}
 
-  if (skipFirstLine) {
-    katana::gWarn(
-        "first line is assumed to contain labels and will be ignored\n");
-    skipLine(infile);
-    ++lineNumber;
+std::vector<std::string>
+splitTokens(std::string_view line) {
+  std::istringstream iss{std::string(line)};
+  std::vector<std::string> tokens;
+  for (std::string tmp; iss >> tmp;) {
+    tokens.push_back(tmp);
   }
+  return tokens;
+}
 
-  const bool hasDelim = static_cast<bool>(delim);
-  std::optional<size_t> skippedLine;
-  std::string line;
-  char readDelim;
-
-  for (; std::getline(infile, line); ++lineNumber) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      skippedLine = lineNumber;
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      skippedLine = lineNumber;
-      continue;
-    }
-
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          skippedLine = lineNumber;
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
+//! A FileGraph made directly from CSR arrays
+class CSRFileGraph : public katana::FileGraph {
+public:
+  using FileGraph::fromArrays;
+};
 
-    if (infile) {
-      ++numEdges;
-      if (src > numNodes)
-        numNodes = src;
-      if (dst > numNodes)
-        numNodes = dst;
-    }
+/**
+ * This is Required gr to kg conversion to append edge data
+ * as the edge property.
+ */
+template <typename EdgeTy>
+katana::Result<void>
+AppendEdgeData(
+    katana::PropertyGraph* pg, const katana::LargeArray<EdgeTy>& edge_data) {
+  using Builder = typename arrow::CTypeTraits<EdgeTy>::BuilderType;
+  using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
+  Builder builder;
+  if (auto r = builder.AppendValues(edge_data.begin(), edge_data.end());
+      !r.ok()) {
+    KATANA_LOG_DEBUG("arrow error: {}", r);
+    return katana::ErrorCode::ArrowError;
   }
 
-  if (skippedLine) {
-    katana::gWarn(
-        "ignored at least one line (line ", *skippedLine,
-        ") because it did not match the expected format\n");
+  std::shared_ptr<arrow::Array> ret;
+  if (auto r = builder.Finish(&ret); !r.ok()) {
+    KATANA_LOG_DEBUG("arrow error: {}", r);
+    return katana::ErrorCode::ArrowError;
   }
-
-  numNodes++;
-  p.setNumNodes(numNodes);
-  p.setNumEdges(numEdges);
-  p.setSizeofEdgeData(EdgeData::size_of::value);
-  edgeData.create(numEdges);
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase1();
-
-  if (skipFirstLine) {
-    skipLine(infile);
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  fields.emplace_back(arrow::field(("value"), std::make_shared<ArrowType>()));
+  columns.emplace_back(ret);
+  auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
+  if (auto r = pg->AddEdgeProperties(edge_data_table); !r) {
+    KATANA_LOG_DEBUG("could not add edge property: {}", r.error());
+    return r;
   }
+  return katana::ResultSuccess();
+}
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
+template <>
+katana::Result<void>
+AppendEdgeData<void>(katana::PropertyGraph*, const katana::LargeArray<void>&) {
+  return katana::ResultSuccess();
+}
 
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
+/**
+ * Write the graph of a parsed edge list as a binary gr. Graphs with more
+ * than 2^32 nodes are written as version 2 files with 64 bit destinations.
+ */
+template <typename EdgeTy>
+void
+writeParsedGr(
+    EdgelistParser<EdgeTy>* parser, const std::string& outfilename) {
+  typedef katana::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
 
-    if (infile) {
-      p.incrementDegree(src);
-    }
+  katana::LargeArray<uint64_t> outIdx;
+  EdgeData edgeData;
+  CSRFileGraph graph;
+  void* rawEdgeData;
+  if (parser->num_nodes() <= std::numeric_limits<uint32_t>::max()) {
+    katana::LargeArray<uint32_t> outs;
+    parser->Build(&outIdx, &outs, &edgeData);
+    rawEdgeData = graph.fromArrays(
+        outIdx.data(), parser->num_nodes(), outs.data(), parser->num_edges(),
+        nullptr, EdgeData::size_of::value, 0, 0, false, 1);
+  } else {
+    katana::LargeArray<uint64_t> outs;
+    parser->Build(&outIdx, &outs, &edgeData);
+    rawEdgeData = graph.fromArrays(
+        outIdx.data(), parser->num_nodes(), outs.data(), parser->num_edges(),
+        nullptr, EdgeData::size_of::value, 0, 0, false, 2);
   }
 
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase2();
-
-  if (skipFirstLine) {
-    skipLine(infile);
+  if constexpr (EdgeData::has_value) {
+    std::uninitialized_copy(
+        edgeData.begin(), edgeData.end(),
+        static_cast<edge_value_type*>(rawEdgeData));
   }
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
+  graph.toFile(outfilename);
+}
 
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
+/**
+ * Write the graph of a parsed edge list as a property graph with the edge
+ * data, if any, in an edge property named "value", as gr2kg does.
+ */
+template <typename EdgeTy>
+void
+writeParsedKg(
+    EdgelistParser<EdgeTy>* parser, const std::string& outfilename) {
+  if (parser->num_nodes() > std::numeric_limits<uint32_t>::max()) {
+    KATANA_DIE("property graphs have at most 2^32 nodes");
+  }
 
-    if (infile) {
-      edgeData.set(p.addNeighbor(src, dst), data);
-    }
+  katana::LargeArray<uint64_t> out_indices;
+  katana::LargeArray<uint32_t> out_dests;
+  katana::LargeArray<EdgeTy> edge_data;
+  parser->Build(&out_indices, &out_dests, &edge_data);
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  auto set_result = pg->SetTopology(katana::GraphTopology{
+      .out_indices = std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
+          static_cast<int64_t>(parser->num_nodes()),
+          arrow::MutableBuffer::Wrap(
+              out_indices.data(), parser->num_nodes())),
+      .out_dests = std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
+          static_cast<int64_t>(parser->num_edges()),
+          arrow::MutableBuffer::Wrap(out_dests.data(), parser->num_edges())),
+  });
+  if (!set_result) {
+    KATANA_LOG_FATAL(
+        "Failed to set topology for property file graph: {}",
+        set_result.error());
   }
 
-  edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-  if (EdgeData::has_value)
-    std::uninitialized_copy(
-        std::make_move_iterator(edgeData.begin()),
-        std::make_move_iterator(edgeData.end()), rawEdgeData);
+  if (auto r = AppendEdgeData<EdgeTy>(pg.get(), edge_data); !r) {
+    KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+  }
 
-  p.toFile(outfilename);
-  printStatus(numNodes, numEdges);
+  pg->MarkAllPropertiesPersistent();
+  if (auto r = pg->Write(outfilename, kCommandLine); !r) {
+    KATANA_LOG_FATAL("Failed to write property file graph: {}", r.error());
+  }
 }
 
+/**
+ * Common parsing for edgelist style text files.
+ *
+ * src dst [weight]
+ * ...
+ *
+ * If delim is set, this function expects that each entry is separated by delim
+ * surrounded by optional whitespace. The file is parsed in parallel by
+ * EdgelistParser, and the graph is written as a binary gr or, if toKg is set,
+ * as a property graph.
+ */
 template <typename EdgeTy>
 void
 convertEdgelist(
     const std::string& infilename, const std::string& outfilename,
-    const bool skipFirstLine) {
-  convertEdgelist<EdgeTy>(
-      infilename, outfilename, skipFirstLine, std::optional<char>());
+    const bool skipFirstLine, std::optional<char> delim, bool toKg) {
+  MappedFile infile(infilename);
+  const char* begin = infile.begin();
+  uint64_t firstLine = 1;
+
+  if (skipFirstLine) {
+    katana::gWarn(
+        "first line is assumed to contain labels and will be ignored\n");
+    nextLine(&begin, infile.end());
+    ++firstLine;
+  }
+
+  EdgelistFormat format;
+  format.delim = delim;
+  EdgelistParser<EdgeTy> parser(begin, infile.end(), format, firstLine);
+
+  if (auto skippedLine = parser.first_skipped_line()) {
+    katana::gWarn(
+        "ignored at least one line (line ", *skippedLine,
+        ") because it did not match the expected format\n");
+  }
+
+  if (toKg) {
+    writeParsedKg(&parser, outfilename);
+  } else {
+    writeParsedGr(&parser, outfilename);
+  }
+  printStatus(parser.num_nodes(), parser.num_edges());
 }
 
 /**
@@ -590,7 +589,17 @@ convertEdgelist(
 struct CSV2Gr : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    convertEdgelist<EdgeTy>(infilename, outfilename, true, ',');
+    convertEdgelist<EdgeTy>(infilename, outfilename, true, ',', false);
+  }
+};
+
+/**
+ * Like CSV2Gr but writes a property graph
+ */
+struct CSV2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    convertEdgelist<EdgeTy>(infilename, outfilename, true, ',', true);
   }
 };
 
@@ -601,7 +610,19 @@ struct CSV2Gr : public Conversion {
 struct Edgelist2Gr : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    convertEdgelist<EdgeTy>(infilename, outfilename, false);
+    convertEdgelist<EdgeTy>(
+        infilename, outfilename, false, std::optional<char>(), false);
+  }
+};
+
+/**
+ * Like Edgelist2Gr but writes a property graph
+ */
+struct Edgelist2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    convertEdgelist<EdgeTy>(
+        infilename, outfilename, false, std::optional<char>(), true);
   }
 };
 
@@ -685,105 +706,45 @@ struct Edgelist2Binary : public Conversion {
 struct Mtx2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef katana::FileGraphWriter Writer;
-    typedef katana::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
-
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-      if (!infile) {
-        KATANA_DIE("failed to open input file");
-      }
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() != '%') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() != 3) {
-        KATANA_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[0]);
-      // nedges = std::stoull(tokens[2]);
-      nnodes = strtoull(tokens[0].c_str(), NULL, 0);
-      nedges = strtoull(tokens[2].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        if ((edge_num % (nedges / 500)) == 0) {
-          printf(
-              "Phase %d: current edge progress %lf%%\n", phase,
-              ((double)edge_num / nedges) * 100);
-        }
-        uint32_t cur_id, neighbor_id;
-        double weight = 1;
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          KATANA_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          KATANA_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(
-              p.addNeighbor(cur_id - 1, neighbor_id - 1),
-              static_cast<edge_value_type>(weight));
-        }
-
-        skipLine(infile);
-      }
-
-      infile.peek();
-      if (!infile.eof()) {
-        KATANA_DIE("additional lines in file");
-      }
-    }
-    // this is for the progress print
-
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(
-          std::make_move_iterator(edgeData.begin()),
-          std::make_move_iterator(edgeData.end()), rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    MappedFile infile(infilename);
+    const char* begin = infile.begin();
+    uint64_t lineNumber = 1;
+
+    // Skip comments
+    std::string_view header;
+    do {
+      if (begin == infile.end()) {
+        KATANA_DIE("missing problem specification line");
+      }
+      header = nextLine(&begin, infile.end());
+      ++lineNumber;
+    } while (!header.empty() && header[0] == '%');
+
+    // Read header
+    std::vector<std::string> tokens = splitTokens(header);
+    if (tokens.size() != 3) {
+      KATANA_DIE("unknown problem specification line: ", header);
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[0].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[2].c_str(), NULL, 0);
+
+    // Parse edges; src and dst are 1 indexed and weights default to 1
+    EdgelistFormat format;
+    format.index_base = 1;
+    format.num_nodes = nnodes;
+    format.default_value = 1;
+    EdgelistParser<EdgeTy> parser(begin, infile.end(), format, lineNumber);
+    if (auto skippedLine = parser.first_skipped_line()) {
+      KATANA_DIE("line ", *skippedLine, " is not an edge");
+    }
+    if (parser.num_edges() != nedges) {
+      KATANA_DIE(
+          "expected ", nedges, " edges but found ", parser.num_edges());
+    }
+
+    writeParsedGr(&parser, outfilename);
+    printStatus(parser.num_nodes(), parser.num_edges());
   }
 };
 
@@ -2256,103 +2217,46 @@ struct MakeUnsymmetric : public Conversion {
 struct Dimacs2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef katana::FileGraphWriter Writer;
-    typedef katana::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
-
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() == 'p') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
-        KATANA_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[tokens.size() - 2]);
-      // nedges = std::stoull(tokens[tokens.size() - 1]);
-      nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
-      nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        uint32_t cur_id;
-        uint32_t neighbor_id;
-        int32_t weight;
-        std::string tmp;
-        infile >> tmp;
-
-        if (tmp.compare("a") != 0) {
-          --edge_num;
-          skipLine(infile);
-          continue;
-        }
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          KATANA_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          KATANA_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(p.addNeighbor(cur_id - 1, neighbor_id - 1), weight);
-        }
-
-        skipLine(infile);
-      }
-
-      infile.peek();
-      if (!infile.eof()) {
-        KATANA_DIE("additional lines in file");
-      }
-    }
-
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(
-          std::make_move_iterator(edgeData.begin()),
-          std::make_move_iterator(edgeData.end()), rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    MappedFile infile(infilename);
+    const char* begin = infile.begin();
+    uint64_t lineNumber = 1;
+
+    // Skip comments
+    std::string_view header;
+    do {
+      if (begin == infile.end()) {
+        KATANA_DIE("missing problem specification line");
+      }
+      header = nextLine(&begin, infile.end());
+      ++lineNumber;
+    } while (header.empty() || header[0] != 'p');
+
+    // Read header
+    std::vector<std::string> tokens = splitTokens(header);
+    if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
+      KATANA_DIE("unknown problem specification line: ", header);
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
+
+    // Parse edges; only lines starting with "a" are edges and ids are 1
+    // indexed
+    EdgelistFormat format;
+    format.line_tag = "a";
+    format.index_base = 1;
+    format.num_nodes = nnodes;
+    EdgelistParser<EdgeTy> parser(begin, infile.end(), format, lineNumber);
+    if (auto skippedLine = parser.first_skipped_line()) {
+      KATANA_DIE("line ", *skippedLine, " is not an edge");
+    }
+    if (parser.num_edges() != nedges) {
+      KATANA_DIE(
+          "expected ", nedges, " edges but found ", parser.num_edges());
+    }
+
+    writeParsedGr(&parser, outfilename);
+    printStatus(parser.num_nodes(), parser.num_edges());
   }
 };
 
@@ -2823,46 +2727,6 @@ struct Gr2Neo4j : public Conversion {
   }
 };
 
-/**
- * This is Required gr to kg conversion to append edge data
- * as the edge property.
- */
-template <typename EdgeTy>
-katana::Result<void>
-AppendEdgeData(
-    katana::PropertyGraph* pg, const katana::LargeArray<EdgeTy>& edge_data) {
-  using Builder = typename arrow::CTypeTraits<EdgeTy>::BuilderType;
-  using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
-  Builder builder;
-  if (auto r = builder.AppendValues(edge_data.begin(), edge_data.end());
-      !r.ok()) {
-    KATANA_LOG_DEBUG("arrow error: {}", r);
-    return katana::ErrorCode::ArrowError;
-  }
-
-  std::shared_ptr<arrow::Array> ret;
-  if (auto r = builder.Finish(&ret); !r.ok()) {
-    KATANA_LOG_DEBUG("arrow error: {}", r);
-    return katana::ErrorCode::ArrowError;
-  }
-  std::vector<std::shared_ptr<arrow::Field>> fields;
-  std::vector<std::shared_ptr<arrow::Array>> columns;
-  fields.emplace_back(arrow::field(("value"), std::make_shared<ArrowType>()));
-  columns.emplace_back(ret);
-  auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
-  if (auto r = pg->AddEdgeProperties(edge_data_table); !r) {
-    KATANA_LOG_DEBUG("could not add edge property: {}", r.error());
-    return r;
-  }
-  return katana::ResultSuccess();
-}
-
-template <>
-katana::Result<void>
-AppendEdgeData<void>(katana::PropertyGraph*, const katana::LargeArray<void>&) {
-  return katana::ResultSuccess();
-}
-
 /**
  * Gr2Kg reads in the binary csr (.gr) files and produces
  * katana graph property graphs.
@@ -3293,9 +3157,15 @@ main(int argc, char** argv) {
   case edgelist2gr:
     convert<Edgelist2Gr>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg>();
+    break;
   case csv2gr:
     convert<CSV2Gr>();
     break;
+  case csv2kg:
+    convert<CSV2Kg>();
+    break;
   case gr2biggr:
     convert<ToBigEndian>();
     break;
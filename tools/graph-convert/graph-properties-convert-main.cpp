@@ -7,7 +7,9 @@
 #include "graph-properties-convert-schema.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
+#include "katana/HubSplitting.h"
 #include "katana/Logging.h"
+#include "katana/NodeReordering.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "tsuba/RDG.h"
@@ -56,6 +58,11 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<unsigned> import_buffer_mb(
+    "import-buffer-mb",
+    cll::desc("Maximum size in MiB of the documents or rows fetched from a "
+              "database ahead of the conversion (default 256)"),
+    cll::init(256));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -90,6 +97,38 @@ cll::opt<bool> export_graphml(
               "The file is created at the output destination specified\n"),
     cll::init(false));
 
+cll::opt<katana::ReorderStrategy> reorder_nodes(
+    "reorder-nodes",
+    cll::desc("Relabel the nodes of a Katana graph to improve locality; the "
+              "original node ids are kept as user ids"),
+    cll::values(
+        clEnumValN(
+            katana::ReorderStrategy::kDegree, "degree",
+            "sort nodes by decreasing degree"),
+        clEnumValN(
+            katana::ReorderStrategy::kBFS, "bfs", "breadth-first order"),
+        clEnumValN(
+            katana::ReorderStrategy::kReverseCuthillMcKee, "rcm",
+            "reverse Cuthill-McKee order"),
+        clEnumValN(
+            katana::ReorderStrategy::kGorder, "gorder",
+            "greedy window order that places related nodes together"),
+        clEnumValN(
+            katana::ReorderStrategy::kHubCluster, "hub-cluster",
+            "place high degree nodes first")));
+
+cll::opt<uint64_t> split_hubs(
+    "split-hubs",
+    cll::desc("Split each node of a Katana graph with more in or out-edges "
+              "than this into virtual nodes with at most this many edges"),
+    cll::init(0));
+
+cll::opt<std::string> hub_parent_property(
+    "hub-parent-property",
+    cll::desc("Node property that stores the original node of each virtual "
+              "node made by -split-hubs (default: hub_parent)"),
+    cll::init("hub_parent"));
+
 katana::PropertyGraph
 ConvertKatana(const std::string& rdg_file) {
   auto result = katana::PropertyGraph::Make(rdg_file, tsuba::RDGLoadOptions());
@@ -131,6 +170,20 @@ ConvertKatana(const std::string& rdg_file) {
 
   ApplyTransforms(graph.get(), transformers);
 
+  if (reorder_nodes.getNumOccurrences() > 0) {
+    if (auto res = katana::ReorderNodes(graph.get(), reorder_nodes); !res) {
+      KATANA_LOG_FATAL("failed to reorder nodes: {}", res.error());
+    }
+  }
+
+  if (split_hubs > 0) {
+    if (auto res = katana::SplitHubNodes(
+            graph.get(), split_hubs, hub_parent_property);
+        !res) {
+      KATANA_LOG_FATAL("failed to split hubs: {}", res.error());
+    }
+  }
+
   return katana::PropertyGraph(std::move(*graph));
 }
 
@@ -166,7 +219,9 @@ ParseMongoDB() {
     katana::GenerateMappingMongoDB(input_filename, output_directory);
   } else {
     katana::WritePropertyGraph(
-        katana::ConvertMongoDB(input_filename, mapping, chunk_size),
+        katana::ConvertMongoDB(
+            input_filename, mapping, chunk_size,
+            size_t{import_buffer_mb} << 20),
         output_directory);
   }
 #else
@@ -181,7 +236,9 @@ ParseMysql() {
     katana::GenerateMappingMysql(input_filename, output_directory, host, user);
   } else {
     katana::WritePropertyGraph(
-        katana::ConvertMysql(input_filename, mapping, chunk_size, host, user),
+        katana::ConvertMysql(
+            input_filename, mapping, chunk_size, host, user,
+            size_t{import_buffer_mb} << 20),
         output_directory);
   }
 #else
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -18,6 +19,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ImportPipeline.h"
 #include "graph-properties-convert-schema.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
@@ -545,29 +547,63 @@ GetCollectionNames(mongoc_database_t* database) {
   return coll_names;
 }
 
+struct BsonDeleter {
+  void operator()(bson_t* doc) const { bson_destroy(doc); }
+};
+
+/// Copies of documents fetched by a cursor
+using DocumentBatch = std::vector<std::unique_ptr<bson_t, BsonDeleter>>;
+
+/// Call document_op on each document of a collection, in order. A reader
+/// thread fetches batches of batch_size documents from the server while the
+/// calling thread handles earlier ones, with at most max_pending_bytes of
+/// fetched documents waiting.
 template <typename T>
 void
 QueryEntireCollection(
-    mongoc_database_t* database, const bson_t** document,
-    const std::string& coll_name, T document_op) {
-  bson_error_t error;
-  auto collection = mongoc_database_get_collection(database, coll_name.c_str());
-  bson_t filter;
-  bson_init(&filter);
-  auto cursor =
-      mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
-
-  while (mongoc_cursor_next(cursor, document)) {
-    document_op();
-  }
-  if (mongoc_cursor_error(cursor, &error)) {
-    KATANA_LOG_ERROR(
-        "An error occurred with a mongodb cursor: {}", error.message);
-  }
+    mongoc_database_t* database, const std::string& coll_name,
+    size_t batch_size, size_t max_pending_bytes, T document_op) {
+  auto fetch = [&](katana::BoundedBatchQueue<DocumentBatch>* queue) {
+    bson_error_t error;
+    auto collection =
+        mongoc_database_get_collection(database, coll_name.c_str());
+    bson_t filter;
+    bson_init(&filter);
+    auto cursor =
+        mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
+
+    const bson_t* document;
+    DocumentBatch batch;
+    size_t batch_bytes = 0;
+    bool open = true;
+    while (open && mongoc_cursor_next(cursor, &document)) {
+      batch.emplace_back(bson_copy(document));
+      batch_bytes += document->len;
+      if (batch.size() == batch_size) {
+        open = queue->Push(std::move(batch), batch_bytes);
+        batch = DocumentBatch{};
+        batch_bytes = 0;
+      }
+    }
+    if (mongoc_cursor_error(cursor, &error)) {
+      KATANA_LOG_ERROR(
+          "An error occurred with a mongodb cursor: {}", error.message);
+    }
+    if (open && !batch.empty()) {
+      queue->Push(std::move(batch), batch_bytes);
+    }
+
+    bson_destroy(&filter);
+    mongoc_cursor_destroy(cursor);
+    mongoc_collection_destroy(collection);
+  };
 
-  bson_destroy(&filter);
-  mongoc_cursor_destroy(cursor);
-  mongoc_collection_destroy(collection);
+  katana::StreamBatches<DocumentBatch>(
+      max_pending_bytes, fetch, [&](DocumentBatch batch) {
+        for (const auto& document : batch) {
+          document_op(document.get());
+        }
+      });
 }
 
 /***************************************/
@@ -1112,9 +1148,9 @@ katana::GenerateMappingMongoDB(
 
 katana::GraphComponents
 katana::ConvertMongoDB(
-    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+    const std::string& db_name, const std::string& mapping, size_t chunk_size,
+    size_t max_pending_bytes) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
 
   katana::PropertyGraphBuilder builder{chunk_size};
   katana::setActiveThreads(1000);
@@ -1141,15 +1177,19 @@ katana::ConvertMongoDB(
 
   // add all edges first
   for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryEntireCollection(
+        database, coll_name, chunk_size, max_pending_bytes,
+        [&](const bson_t* document) {
+          katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
   // then add all nodes
   for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryEntireCollection(
+        database, coll_name, chunk_size, max_pending_bytes,
+        [&](const bson_t* document) {
+          katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
 
   mongoc_cleanup();
@@ -15,9 +15,12 @@ void HandleEdgeDocumentMongoDB(
     PropertyGraphBuilder*, const bson_t* doc,
     const std::string& collection_name);
 
+/// Import the collections of a database. Documents are fetched on a reader
+/// thread while earlier ones are added to the graph, with at most
+/// max_pending_bytes of fetched documents waiting.
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size);
+    const size_t chunk_size, size_t max_pending_bytes);
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
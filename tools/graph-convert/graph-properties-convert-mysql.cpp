@@ -14,6 +14,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -21,6 +22,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ImportPipeline.h"
 #include "graph-properties-convert-schema.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
@@ -257,105 +259,158 @@ RunQuery(MYSQL* con, const std::string& query) {
 }
 
 void
-AddNodeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
-
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartNode();
-    builder->AddLabel(table_data.name);
+ExhaustResultSet(MysqlRes* res) {
+  while (mysql_fetch_row(res->res))
+    ;
+}
 
-    // if table has a primary key, add it as node's ID
-    auto primary_index = table_data.primary_key_index;
-    if (primary_index >= 0) {
-      std::string primary_key{row[primary_index], lengths[primary_index]};
-      builder->AddNodeId(table_data.name + primary_key);
-    }
+/// A copy of the fields of a row; null fields are nullopt
+using Row = std::vector<std::optional<std::string>>;
+using RowBatch = std::vector<Row>;
 
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
+/// Call row_op on each row of a table, in order. A reader thread fetches
+/// batches of batch_size rows from the server while the calling thread
+/// handles earlier ones, with at most max_pending_bytes of fetched rows
+/// waiting.
+template <typename T>
+void
+FetchTable(
+    MYSQL* con, const std::string& table_name, size_t batch_size,
+    size_t max_pending_bytes, T row_op) {
+  auto fetch = [&](katana::BoundedBatchQueue<RowBatch>* queue) {
+    mysql_thread_init();
+    MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_name));
+    unsigned int num_fields = mysql_num_fields(table.res);
+    MYSQL_ROW row;
+
+    RowBatch batch;
+    size_t batch_bytes = 0;
+    bool open = true;
+    while (open && (row = mysql_fetch_row(table.res))) {
+      auto lengths = mysql_fetch_lengths(table.res);
+      Row& copy = batch.emplace_back(num_fields);
+      for (unsigned int i = 0; i < num_fields; i++) {
+        if (row[i] != NULL) {
+          copy[i].emplace(row[i], lengths[i]);
+          batch_bytes += lengths[i];
+        }
       }
-    }
-
-    // if table has outgoing edges, add them
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      // if the target is null then do not add an edge
-      if (row[foreign_index] != NULL) {
-        std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-        std::string edge_id = relation.target_table + foreign_key;
-        builder->AddOutgoingEdge(edge_id, relation.label);
+      if (batch.size() == batch_size) {
+        open = queue->Push(std::move(batch), batch_bytes);
+        batch = RowBatch{};
+        batch_bytes = 0;
       }
     }
-    builder->FinishNode();
-  }
+    if (!open) {
+      // the result set must be read to the end before the next query
+      ExhaustResultSet(&table);
+    } else if (!batch.empty()) {
+      queue->Push(std::move(batch), batch_bytes);
+    }
+    mysql_thread_end();
+  };
+
+  katana::StreamBatches<RowBatch>(
+      max_pending_bytes, fetch, [&](RowBatch batch) {
+        for (const Row& row : batch) {
+          row_op(row);
+        }
+      });
 }
 
 void
-AddEdgeTable(
+AddNodeTable(
     katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
+    const TableData& table_data, size_t batch_size,
+    size_t max_pending_bytes) {
+  FetchTable(
+      con, table_data.name, batch_size, max_pending_bytes, [&](const Row& row) {
+        builder->StartNode();
+        builder->AddLabel(table_data.name);
+
+        // if table has a primary key, add it as node's ID
+        auto primary_index = table_data.primary_key_index;
+        if (primary_index >= 0) {
+          builder->AddNodeId(
+              table_data.name + row[primary_index].value_or(std::string()));
+        }
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartEdge();
-    builder->AddLabel(table_data.name);
-
-    bool adding_source = true;
-    // if the source or target is null then add a placeholder node
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-      std::string edge_id = relation.target_table + foreign_key;
-      if (adding_source) {
-        builder->AddEdgeSource(edge_id);
-        adding_source = false;
-      } else {
-        builder->AddEdgeTarget(edge_id);
-      }
-    }
+        // add data fields
+        for (size_t i = 0; i < table_data.field_names.size(); i++) {
+          auto index = table_data.field_indexes[i];
+          // if the data is null then do not add it
+          if (row[index]) {
+            const std::string& value = *row[index];
+
+            builder->AddValue(
+                table_data.field_names[i],
+                []() {
+                  return PropertyKey{
+                      "invalid", ImportDataType::kUnsupported, false};
+                },
+                [&value](ImportDataType type, bool is_list) {
+                  return ResolveValue(value, type, is_list);
+                });
+          }
+        }
 
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
-      }
-    }
-    builder->FinishEdge();
-  }
+        // if table has outgoing edges, add them
+        for (auto relation : table_data.out_references) {
+          auto foreign_index = relation.source_index;
+          // if the target is null then do not add an edge
+          if (row[foreign_index]) {
+            std::string edge_id = relation.target_table + *row[foreign_index];
+            builder->AddOutgoingEdge(edge_id, relation.label);
+          }
+        }
+        builder->FinishNode();
+      });
+}
+
+void
+AddEdgeTable(
+    katana::PropertyGraphBuilder* builder, MYSQL* con,
+    const TableData& table_data, size_t batch_size,
+    size_t max_pending_bytes) {
+  FetchTable(
+      con, table_data.name, batch_size, max_pending_bytes, [&](const Row& row) {
+        builder->StartEdge();
+        builder->AddLabel(table_data.name);
+
+        bool adding_source = true;
+        // if the source or target is null then add a placeholder node
+        for (auto relation : table_data.out_references) {
+          auto foreign_index = relation.source_index;
+          std::string edge_id = relation.target_table +
+                                row[foreign_index].value_or(std::string());
+          if (adding_source) {
+            builder->AddEdgeSource(edge_id);
+            adding_source = false;
+          } else {
+            builder->AddEdgeTarget(edge_id);
+          }
+        }
+
+        // add data fields
+        for (size_t i = 0; i < table_data.field_names.size(); i++) {
+          auto index = table_data.field_indexes[i];
+          // if the data is null then do not add it
+          if (row[index]) {
+            const std::string& value = *row[index];
+
+            builder->AddValue(
+                table_data.field_names[i],
+                []() {
+                  return PropertyKey{
+                      "invalid", ImportDataType::kUnsupported, false};
+                },
+                [&value](ImportDataType type, bool is_list) {
+                  return ResolveValue(value, type, is_list);
+                });
+          }
+        }
+        builder->FinishEdge();
+      });
 }
 
 /************************************/
@@ -500,12 +555,6 @@ GetUserInputForFields(
 /* Functions for preprocessing MySQL databases */
 /***********************************************/
 
-void
-ExhaustResultSet(MysqlRes* res) {
-  while (mysql_fetch_row(res->res))
-    ;
-}
-
 bool
 ContainsRelation(
     const std::vector<LabelRule>& rules, const std::string& label) {
@@ -859,7 +908,8 @@ GetMappingInput(
 GraphComponents
 katana::ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    size_t max_pending_bytes) {
   katana::PropertyGraphBuilder builder{chunk_size};
   std::string password{getpass("MySQL Password: ")};
 
@@ -886,15 +936,15 @@ katana::ConvertMysql(
 
   for (auto table : table_data) {
     if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
+      AddNodeTable(
+          &builder, con, table.second, chunk_size, max_pending_bytes);
     } else {
-      AddEdgeTable(&builder, con, table.second);
+      AddEdgeTable(
+          &builder, con, table.second, chunk_size, max_pending_bytes);
     }
   }
   mysql_close(con);
-  auto out = builder.Finish();
-  out.Dump();
-  return out;
+  return builder.Finish();
 }
 
 void
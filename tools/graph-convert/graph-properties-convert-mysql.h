@@ -5,9 +5,13 @@
 
 namespace katana {
 
+/// Import the tables of a database. Rows are fetched on a reader thread
+/// while earlier ones are added to the graph, with at most max_pending_bytes
+/// of fetched rows waiting.
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user);
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    size_t max_pending_bytes);
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
@@ -1,90 +1,121 @@
 #include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Oplog.h"
 
 constexpr uint64_t kNumNodes = 100;
+constexpr uint64_t kNumBatches = 3;
 
+/// Replays a log of node and edge insertions in parallel
 class LogPlay {
-  katana::PropertyGraphBuilder pgb;
+  katana::ParallelPropertyGraphBuilder pgb;
 
 public:
-  LogPlay() : pgb(25000) {}
-
-  bool StartNode(const std::string& id) { return pgb.StartNode(id); }
-  void FinishNode() { pgb.FinishNode(); }
-  bool StartEdge(const std::string& source, const std::string& target) {
-    return pgb.StartEdge(source, target);
+  size_t AddProperty(const katana::PropertyKey& key) {
+    auto res = pgb.AddBuilder(key);
+    KATANA_LOG_ASSERT(res);
+    return res.value();
   }
-  void FinishEdge() { pgb.FinishEdge(); }
-  void AddPropValue(
+  bool AddNode(
       const std::string& id,
-      std::function<katana::PropertyKey()> ProcessElement,
-      std::function<katana::ImportData(katana::ImportDataType, bool)>
-          ResolveValue) {
-    pgb.AddValue(id, ProcessElement, ResolveValue);
+      const katana::ParallelPropertyGraphBuilder::PropertyValues& values) {
+    return pgb.AddNode(id, values);
+  }
+  void AddEdge(
+      const std::string& source, const std::string& target,
+      const katana::ParallelPropertyGraphBuilder::PropertyValues& values) {
+    pgb.AddEdge(source, target, values);
   }
-  void CreateRDG() {
+  std::string CreateRDG() {
     auto uri_res = katana::Uri::MakeRand("/tmp/oplog");
     KATANA_LOG_ASSERT(uri_res);
     std::string dest_dir(uri_res.value().string());
-    WritePropertyGraph(pgb.Finish(), dest_dir);
+    auto graph_res = pgb.Finish();
+    KATANA_LOG_ASSERT(graph_res);
+    WritePropertyGraph(graph_res.value(), dest_dir);
     fmt::print("RDG written to {}\n", dest_dir);
+    return dest_dir;
   }
 };
 
+katana::ImportData
+Int64(int64_t value) {
+  katana::ImportData data(katana::ImportDataType::kInt64, false);
+  data.value = value;
+  return data;
+}
+
+/// Batch b of the log: node b joins, the edges of node b get new ranks, and
+/// the edges from node b + 1 to even nodes are removed
+katana::OplogBatch
+MakeBatch(uint64_t b) {
+  katana::OplogBatch batch;
+  auto node = static_cast<katana::OplogBatch::Node>(kNumNodes + b);
+  batch.UpsertNode(node, {{"n0", Int64(node)}});
+  batch.UpsertEdge(node, 0, {{"rank", Int64(0)}});
+  for (uint64_t j = 0; j < kNumNodes; ++j) {
+    batch.UpsertEdge(b, j, {{"rank", Int64(-static_cast<int64_t>(b * j))}});
+    if (j % 2 == 0) {
+      batch.DeleteEdge(b + 1, j);
+    }
+  }
+  return batch;
+}
+
+/// Apply each batch of the log to the RDG in rdg_dir as a new version
 void
+ReplayLog(const std::string& rdg_dir) {
+  auto pg_res = katana::PropertyGraph::Make(rdg_dir);
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  for (uint64_t b = 0; b < kNumBatches; ++b) {
+    katana::OplogBatch batch = MakeBatch(b);
+    auto apply_res = katana::ApplyOplogBatch(pg.get(), batch);
+    KATANA_LOG_VASSERT(apply_res, "batch {}: {}", b, apply_res.error());
+    pg->AddProvenance("oplog_batch", std::to_string(b));
+    auto commit_res = pg->Commit("oplog-rdg");
+    KATANA_LOG_VASSERT(commit_res, "batch {}: {}", b, commit_res.error());
+    fmt::print(
+        "batch {}: {} ops, {} nodes, {} edges\n", b, batch.size(),
+        pg->num_nodes(), pg->num_edges());
+  }
+}
+
+std::string
 ReadLog() {
   LogPlay lp;
 
   std::string prop_id = "n0";
-  {
-    katana::PropertyKey node_pk(
-        prop_id, true, false,
-        /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false);
-    for (uint64_t i = 0; i < kNumNodes; ++i) {
-      auto id = std::to_string(i);
-      bool start_ok = lp.StartNode(id);
-      KATANA_LOG_ASSERT(start_ok);
-      lp.AddPropValue(
-          prop_id, [&]() -> katana::PropertyKey { return node_pk; },
-          [i](katana::ImportDataType type, bool is_list) -> katana::ImportData {
-            (void)(type);
-            (void)(is_list);
-            katana::ImportData data(katana::ImportDataType::kInt64, false);
-            data.value = (int64_t)i;
-            return data;
-          });
-      lp.FinishNode();
-    }
-  }
+  size_t node_prop = lp.AddProperty(katana::PropertyKey(
+      prop_id, true, false,
+      /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false));
+  katana::do_all(katana::iterate(uint64_t{0}, kNumNodes), [&](uint64_t i) {
+    katana::ImportData data(katana::ImportDataType::kInt64, false);
+    data.value = (int64_t)i;
+    bool add_ok = lp.AddNode(std::to_string(i), {{node_prop, data}});
+    KATANA_LOG_ASSERT(add_ok);
+  });
 
   prop_id = "rank";
-  katana::PropertyKey edge_pk(
+  size_t edge_prop = lp.AddProperty(katana::PropertyKey(
       prop_id, false, true,
-      /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false);
-  for (uint64_t i = 0; i < kNumNodes; ++i) {
-    for (uint64_t j = 0; j < kNumNodes; ++j) {
-      bool start_ok = lp.StartEdge(std::to_string(i), std::to_string(j));
-      KATANA_LOG_ASSERT(start_ok);
-      lp.AddPropValue(
-          prop_id, [&]() -> katana::PropertyKey { return edge_pk; },
-          [i, j](
-              katana::ImportDataType type, bool is_list) -> katana::ImportData {
-            (void)(type);
-            (void)(is_list);
-            katana::ImportData data(katana::ImportDataType::kInt64, false);
-            data.value = (int64_t)(i * j);
-            return data;
-          });
-      lp.FinishEdge();
-    }
-  }
-  lp.CreateRDG();
+      /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumNodes * kNumNodes), [&](uint64_t e) {
+        uint64_t i = e / kNumNodes;
+        uint64_t j = e % kNumNodes;
+        katana::ImportData data(katana::ImportDataType::kInt64, false);
+        data.value = (int64_t)(i * j);
+        lp.AddEdge(std::to_string(i), std::to_string(j), {{edge_prop, data}});
+      });
+  return lp.CreateRDG();
 }
 
 int
 main() {  //int argc, char* argv[]) {
   katana::SharedMemSys sys;
 
-  ReadLog();
+  ReplayLog(ReadLog());
 
   return 0;
 }
@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/Threads.h"
+#include "katana/Timer.h"
+#include "katana/gIO.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+enum Generator { rmat, kronecker, er, sbm };
+
+static cll::opt<std::string> outputFile(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<Generator> generator(
+    cll::desc("Generator:"),
+    cll::values(
+        clEnumVal(rmat, "R-MAT with 2^scale nodes and -edges edges"),
+        clEnumVal(
+            kronecker,
+            "Graph500 Kronecker graph with 2^scale nodes and edgeFactor "
+            "edges per node"),
+        clEnumVal(er, "Erdos-Renyi G(n, m) with -nodes nodes and -edges edges"),
+        clEnumVal(
+            sbm,
+            "Stochastic block model with -blocks blocks of -nodes nodes each "
+            "and edge probabilities -pIn within and -pOut between blocks")),
+    cll::Required);
+static cll::opt<uint32_t> scale(
+    "scale", cll::desc("log2 of the number of nodes of rmat and kronecker"),
+    cll::init(20));
+static cll::opt<uint32_t> edgeFactor(
+    "edgeFactor", cll::desc("Edges per node of kronecker (default value 16)"),
+    cll::init(16));
+static cll::opt<uint32_t> numNodes(
+    "nodes", cll::desc("Nodes of er, or nodes per block of sbm"),
+    cll::init(1 << 20));
+static cll::opt<uint64_t> numEdges(
+    "edges", cll::desc("Edges of rmat and er"), cll::init(uint64_t{1} << 24));
+static cll::opt<double> rmatA(
+    "a", cll::desc("R-MAT probability a"), cll::init(0.57));
+static cll::opt<double> rmatB(
+    "b", cll::desc("R-MAT probability b"), cll::init(0.19));
+static cll::opt<double> rmatC(
+    "c", cll::desc("R-MAT probability c"), cll::init(0.19));
+static cll::opt<bool> noScramble(
+    "noScramble", cll::desc("Do not permute the node ids of rmat"),
+    cll::init(false));
+static cll::opt<uint32_t> numBlocks(
+    "blocks", cll::desc("Blocks of sbm"), cll::init(4));
+static cll::opt<double> pIn(
+    "pIn", cll::desc("Edge probability within a block of sbm"),
+    cll::init(1e-4));
+static cll::opt<double> pOut(
+    "pOut", cll::desc("Edge probability between blocks of sbm"),
+    cll::init(1e-6));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the generator (default value 0)"), cll::init(0));
+static cll::opt<bool> symmetric(
+    "symmetric", cll::desc("Add every edge in both directions"),
+    cll::init(false));
+static cll::opt<bool> removeSelfLoops(
+    "removeSelfLoops", cll::desc("Drop edges from a node to itself"),
+    cll::init(false));
+static cll::opt<uint32_t> maxWeight(
+    "maxWeight",
+    cll::desc("Add uint32 edge weights in [1, maxWeight] (default value 0, "
+              "no weights)"),
+    cll::init(0));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Generate() {
+  katana::GeneratorOptions options;
+  options.seed = seed;
+  options.symmetric = symmetric;
+  options.remove_self_loops = removeSelfLoops;
+  options.max_weight = maxWeight;
+
+  switch (generator) {
+  case rmat:
+    return katana::GenerateRmat(
+        scale, numEdges, katana::RmatParameters{rmatA, rmatB, rmatC},
+        !noScramble, options);
+  case kronecker:
+    return katana::GenerateKronecker(scale, edgeFactor, options);
+  case er:
+    return katana::GenerateErdosRenyi(numNodes, numEdges, options);
+  case sbm: {
+    std::vector<std::vector<double>> probabilities(
+        numBlocks, std::vector<double>(numBlocks, pOut));
+    for (uint32_t i = 0; i < numBlocks; ++i) {
+      probabilities[i][i] = pIn;
+    }
+    return katana::GenerateStochasticBlockModel(
+        std::vector<uint32_t>(numBlocks, numNodes), probabilities, "block",
+        options);
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
+
+  katana::gInfo("Generating graph");
+  katana::StatTimer generate_time("Generate", "graph-generate");
+  generate_time.start();
+  auto pg_res = Generate();
+  generate_time.stop();
+  if (!pg_res) {
+    KATANA_LOG_FATAL("generating graph: {}", pg_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  katana::gInfo(
+      "Generated ", pg->num_nodes(), " nodes and ", pg->num_edges(), " edges");
+
+  katana::gInfo("Writing graph");
+  if (auto res = pg->Write(outputFile, katana::Join(" ", argv, argv + argc));
+      !res) {
+    KATANA_LOG_FATAL("writing {}: {}", outputFile, res.error());
+  }
+
+  return 0;
+}
@@ -17,123 +17,94 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "katana/BufferedGraph.h"
-#include "katana/FileGraph.h"
-#include "katana/Galois.h"
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/NodeReordering.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/Threads.h"
+#include "katana/gIO.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
 
-static cll::opt<std::string> inputFilename(
-    cll::Positional, cll::desc("<input file>"), cll::Required);
-static cll::opt<std::string> mappingFilename(
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+static cll::opt<std::string> mappingFile(
     cll::Positional, cll::desc("<mapping file>"), cll::Required);
-static cll::opt<std::string> outputFilename(
-    cll::Positional, cll::desc("<output file>"), cll::Required);
-
-using Writer = katana::FileGraphWriter;
-
-/**
- * Create node map from file
- */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
-  katana::gInfo("Creating node map");
-  // read new mapping
-  std::ifstream mapFile(mappingFilename);
-  mapFile.seekg(0, std::ios_base::end);
-
-  int64_t endOfFile = mapFile.tellg();
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
+static cll::opt<std::string> outputFile(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+static cll::opt<std::string> tempDir(
+    "tempDir",
+    cll::desc("Directory for the temporary files (default value /tmp)"),
+    cll::init("/tmp"));
+static cll::opt<uint64_t> memoryBudget(
+    "memoryBudget",
+    cll::desc("Megabytes of memory the edges may use while they are "
+              "remapped (default value 1024)"),
+    cll::init(1024));
+
+/// Read the mapping: the node listed on line n becomes node n
+std::shared_ptr<arrow::UInt64Array>
+ReadMapping() {
+  katana::gInfo("Reading node map");
+  std::ifstream map_file(mappingFile);
+  if (!map_file) {
+    KATANA_LOG_FATAL("failed to open {}", mappingFile);
   }
 
-  mapFile.seekg(0, std::ios_base::beg);
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
+  std::vector<uint64_t> new_to_old;
+  uint64_t node_id;
+  while (map_file >> node_id) {
+    new_to_old.emplace_back(node_id);
   }
-
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
-  while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
-    uint64_t nodeID;
-    mapFile >> nodeID;
-    if (!mapFile) {
-      KATANA_DIE("failed to read file");
-    }
-    remapper[nodeID] = counter++;
+  if (!map_file.eof()) {
+    KATANA_LOG_FATAL(
+        "failed to read {} after {} nodes", mappingFile, new_to_old.size());
   }
+  katana::gInfo("Remapping ", new_to_old.size(), " nodes");
 
-  KATANA_LOG_ASSERT(remapper.size() == counter);
-  katana::gInfo("Remapping ", counter, " nodes");
-
-  katana::gInfo("Node map created");
-
-  return remapper;
+  return std::static_pointer_cast<arrow::UInt64Array>(
+      katana::BuildArray(new_to_old));
 }
 
 int
 main(int argc, char** argv) {
-  katana::SharedMemSys G;
+  katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
+  std::shared_ptr<arrow::UInt64Array> new_to_old = ReadMapping();
 
   katana::gInfo("Loading graph to remap");
-  katana::BufferedGraph<void> graphToRemap;
-  graphToRemap.loadGraph(inputFilename);
-  katana::gInfo("Graph loaded");
-
-  Writer graphWriter;
-  graphWriter.setNumNodes(remapper.size());
-  graphWriter.setNumEdges(graphToRemap.sizeEdges());
-
-  // phase 1: count degrees
-  graphWriter.phase1();
-  katana::gInfo("Starting degree counting");
-  size_t prevNumNodes = graphToRemap.size();
-  size_t nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        graphWriter.incrementDegree(nodeIDCounter);
-      }
-      nodeIDCounter++;
-    }
+  auto pg_res = katana::PropertyGraph::Make(inputFile, tsuba::RDGLoadOptions());
+  if (!pg_res) {
+    KATANA_LOG_FATAL("loading {}: {}", inputFile, pg_res.error());
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
-
-  // phase 2: edge construction
-  graphWriter.phase2();
-  katana::gInfo("Starting edge construction");
-  nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
-      }
-      nodeIDCounter++;
-    }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::ExternalPermuteOptions options;
+  options.temp_dir = tempDir;
+  options.memory_budget = memoryBudget * (uint64_t{1} << 20);
+  if (auto res = katana::PermuteNodesExternal(pg.get(), new_to_old, options);
+      !res) {
+    KATANA_LOG_FATAL("remapping: {}", res.error());
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
-
-  katana::gInfo("Finishing up: outputting graph shortly");
-
-  graphWriter.finish<void>();
-  graphWriter.toFile(outputFilename);
 
+  katana::gInfo("Writing remapped graph");
+  if (auto res = pg->Write(outputFile, katana::Join(" ", argv, argv + argc));
+      !res) {
+    KATANA_LOG_FATAL("writing {}: {}", outputFile, res.error());
+  }
   katana::gInfo(
-      "new size is ", graphWriter.size(), " num edges ",
-      graphWriter.sizeEdges());
+      "new size is ", pg->num_nodes(), " num edges ", pg->num_edges());
 
   return 0;
 }
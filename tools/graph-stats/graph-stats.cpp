@@ -17,288 +17,87 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <vector>
 
-#include "katana/Galois.h"
-#include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/GraphStats.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
 
-enum StatMode {
-  degreehist,
-  degrees,
-  maxDegreeNode,
-  dsthist,
-  indegreehist,
-  sortedlogoffsethist,
-  sparsityPattern,
-  summary
-};
-
-static cll::opt<std::string> inputfilename(
-    cll::Positional, cll::desc("<graph file>"), cll::Required);
-static cll::list<StatMode> statModeList(
-    cll::desc("Available stats:"),
-    cll::values(
-        clEnumVal(degreehist, "Histogram of degrees"),
-        clEnumVal(degrees, "Node degrees"),
-        clEnumVal(maxDegreeNode, "Max Degree Node"),
-        clEnumVal(dsthist, "Histogram of destinations"),
-        clEnumVal(indegreehist, "Histogram of indegrees"),
-        clEnumVal(
-            sortedlogoffsethist,
-            "Histogram of neighbor offsets with sorted edges"),
-        clEnumVal(
-            sparsityPattern,
-            "Pattern of non-zeros when graph is "
-            "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
-static cll::opt<int> numBins(
-    "numBins", cll::desc("Number of bins"), cll::init(-1));
-static cll::opt<int> columns(
-    "columns", cll::desc("Columns for sparsity"), cll::init(80));
-
-typedef katana::OfflineGraph Graph;
-typedef Graph::GraphNode GNode;
-
-void
-doSummary(Graph& graph) {
-  std::cout << "NumNodes: " << graph.size() << "\n";
-  std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
-  std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
-}
-
-void
-doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << graph.edges(n).size() << "\n";
-  }
-}
-
-void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeId = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeId;
-    }
-    ++nodeId;
-  }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
-}
-
-void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
-  auto max = hists.rbegin()->first;
-  if (numBins <= 0) {
-    std::cout << name << "Bin,Start,End,Count\n";
-    for (unsigned x = 0; x <= max; ++x) {
-      std::cout << x << ',' << x << ',' << x + 1 << ',';
-      if (hists.count(x)) {
-        std::cout << hists[x] << '\n';
-      } else {
-        std::cout << "0\n";
-      }
-    }
-  } else {
-    std::vector<uint64_t> bins(numBins);
-    auto bwidth = (max + 1) / numBins;
-    if ((max + 1) % numBins) {
-      ++bwidth;
-    }
-    // std::cerr << "* " << max << " " << numBins << " " << bwidth << "\n";
-    for (auto p : hists) {
-      bins.at(p.first / bwidth) += p.second;
-    }
-    std::cout << name << "Bin,Start,End,Count\n";
-    for (unsigned x = 0; x < bins.size(); ++x) {
-      std::cout << x << ',' << x * bwidth << ',' << (x * bwidth + bwidth) << ','
-                << bins[x] << '\n';
-    }
-  }
-}
-
-void
-doSparsityPattern(
-    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
-  unsigned blockSize = (graph.size() + columns - 1) / columns;
-
-  for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
-    for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
-    }
-  }
-}
-
-void
-doDegreeHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
-  }
-  printHistogram("Degree", hist);
-}
-
-void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
-  }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
-}
-
-struct EdgeComp {
-  typedef katana::EdgeSortValue<GNode, void> Edge;
-
-  bool operator()(const Edge& a, const Edge& b) const { return a.dst < b.dst; }
-};
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+static cll::opt<std::string> outputFile(
+    "output", cll::desc("Write the statistics to this file instead of stdout"));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
+static cll::opt<unsigned> numBins(
+    "numBins",
+    cll::desc("Number of bins of equal width of the degree histograms "
+              "(default value 0: bins are powers of two)"),
+    cll::init(0));
+static cll::opt<bool> diameter(
+    "diameter",
+    cll::desc("Estimate the neighborhood function and the diameter "
+              "(default value true)"),
+    cll::init(true));
+static cll::opt<unsigned> log2Registers(
+    "log2Registers",
+    cll::desc("Log2 of the number of registers of the HyperLogLog counter "
+              "of each node for the diameter estimate; more registers are "
+              "more accurate (default value 6)"),
+    cll::init(6));
+static cll::opt<unsigned> maxHops(
+    "maxHops",
+    cll::desc("Stop the diameter estimate after this many hops (default "
+              "value 1000)"),
+    cll::init(1000));
+static cll::opt<bool> properties(
+    "properties",
+    cll::desc("Include the statistics of each property (default value "
+              "true)"),
+    cll::init(true));
 
 int
-getLogIndex(ptrdiff_t x) {
-  int logvalue = 0;
-  int sign = x < 0 ? -1 : 1;
-
-  if (x < 0) {
-    x = -x;
-  }
-
-  while ((x >>= 1) != 0) {
-    ++logvalue;
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
+
+  // Properties are only loaded if their statistics were not stored
+  tsuba::RDGLoadOptions load_options;
+  load_options.lazy_properties = true;
+  auto pg_res = katana::PropertyGraph::Make(inputFile, load_options);
+  if (!pg_res) {
+    KATANA_LOG_FATAL("loading {}: {}", inputFile, pg_res.error());
   }
-  return sign * logvalue;
-}
-
-void
-doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
-  // Graph copy;
-  // {
-  //   // Original FileGraph is immutable because it is backed by a file
-  //   copy = graph;
-  // }
-
-  // std::vector<std::map<int, size_t> > hists;
-  // hists.emplace_back();
-  // auto hist = &hists.back();
-  // int curHist = 0;
-  // auto p = katana::block_range(
-  //     boost::counting_iterator<size_t>(0),
-  //     boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //     curHist,
-  //     numHist);
-  // for (auto ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-  //   copy.sortEdges<void>(*ii, EdgeComp());
-
-  //   GNode last = 0;
-  //   bool first = true;
-  //   for (auto jj = copy.edge_begin(*ii), ej = copy.edge_end(*ii); jj != ej;
-  //   ++jj) {
-  //     GNode dst = copy.getEdgeDst(jj);
-  //     ptrdiff_t diff = dst - (ptrdiff_t) last;
-
-  //     if (!first) {
-  //       int index = getLogIndex(diff);
-  //       ++(*hist)[index];
-  //     }
-  //     first = false;
-  //     last = dst;
-  //     if (++p.first == p.second) {
-  //       hists.emplace_back();
-  //       hist = &hists.back();
-  //       curHist += 1;
-  //       p = katana::block_range(
-  //           boost::counting_iterator<size_t>(0),
-  //           boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //           curHist,
-  //           numHist);
-  //     }
-  //   }
-  // }
-
-  // printHistogram("LogOffset", hists);
-}
 
-void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
-    }
+  katana::analytics::GraphStatsOptions options;
+  options.num_bins = numBins;
+  options.estimate_diameter = diameter;
+  options.log2_registers = log2Registers;
+  options.max_hops = maxHops;
+  options.summarize_properties = properties;
+  auto stats_res =
+      katana::analytics::GraphStats::Compute(*pg_res.value(), options);
+  if (!stats_res) {
+    KATANA_LOG_FATAL("computing statistics: {}", stats_res.error());
   }
-  printHistogram("DestinationBin", hist);
-}
 
-int
-main(int argc, char** argv) {
-  llvm::cl::ParseCommandLineOptions(argc, argv);
-  try {
-    Graph graph(inputfilename);
-    for (unsigned i = 0; i != statModeList.size(); ++i) {
-      switch (statModeList[i]) {
-      case degreehist:
-        doDegreeHistogram(graph);
-        break;
-      case degrees:
-        doDegrees(graph);
-        break;
-      case maxDegreeNode:
-        findMaxDegreeNode(graph);
-        break;
-      case dsthist:
-        doDestinationHistogram(graph);
-        break;
-      case indegreehist:
-        doInDegreeHistogram(graph);
-        break;
-      case sortedlogoffsethist:
-        doSortedLogOffsetHistogram(graph);
-        break;
-      case sparsityPattern: {
-        unsigned lastrow = ~0;
-        doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
-          if (y != lastrow) {
-            lastrow = y;
-            std::cout << '\n';
-          }
-          std::cout << (val ? 'x' : '.');
-        });
-        std::cout << '\n';
-        break;
-      }
-      case summary:
-        doSummary(graph);
-        break;
-      default:
-        std::cerr << "Unknown stat requested\n";
-        break;
-      }
+  nlohmann::json j = stats_res.value();
+  j["input"] = inputFile;
+  if (outputFile.empty()) {
+    std::cout << j.dump(2) << "\n";
+  } else {
+    std::ofstream out(outputFile);
+    out << j.dump(2) << "\n";
+    if (!out) {
+      KATANA_LOG_FATAL("writing {}", outputFile);
     }
-    return 0;
-  } catch (...) {
-    std::cerr << "failed\n";
-    return 1;
   }
+  return 0;
 }